@@ -0,0 +1,15 @@
+# Helper script invoked by the "run" target for host builds.
+# Reads GAMEARGS from the environment so it can be set at make-time:
+#   make run GAMEARGS=tests/gpu/triangle/triangle.exe
+
+if(DEFINED ENV{GAMEARGS})
+    set(GAMEARGS "$ENV{GAMEARGS}")
+endif()
+
+set(CMD ${HOST_CMD})
+if(NOT "${GAMEARGS}" STREQUAL "")
+    separate_arguments(_args UNIX_COMMAND "${GAMEARGS}")
+    list(APPEND CMD ${_args})
+endif()
+
+execute_process(COMMAND ${CMD} COMMAND_ERROR_IS_FATAL ANY)
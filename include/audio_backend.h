@@ -15,6 +15,18 @@ int Audio_Backend_Configure(int sample_rate, int bits, int channels, int volume)
 /* Submit audio samples for playback. */
 void Audio_Backend_Play(const int16_t *buffer, int size_bytes);
 
+/* Threaded output (audio_latency): from then on Audio_Backend_Play only
+ * copies into an AudioRing that a backend thread drains to the hardware.
+ * latency_frames is the fill the frame limiter aims for; the ring holds
+ * twice that.  Returns 0 on success, <0 if output stays synchronous. */
+int Audio_Backend_StartThread(int latency_frames);
+
+/* Frames queued ahead of the hardware, or -1 when output is synchronous. */
+int Audio_Backend_Queued(void);
+
+/* Cumulative underruns / overruns of the threaded output. */
+void Audio_Backend_GetStats(uint32_t *underruns, uint32_t *overruns);
+
 /* Shutdown platform audio subsystem. */
 void Audio_Backend_Shutdown(void);
 
@@ -0,0 +1,39 @@
+/**
+ * audio_ring.h — Lock-free stereo sample ring for threaded audio output
+ *
+ * Single producer (SPU_FlushAudio via Audio_Backend_Play on the emulator
+ * thread), single consumer (the backend's output thread).  Each index is
+ * written by one side only and both are free-running, so no lock is
+ * needed on the single-core EE / Allegrex.
+ */
+#ifndef AUDIO_RING_H
+#define AUDIO_RING_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    int16_t *buf;      /* capacity frames of interleaved L/R */
+    uint32_t capacity; /* frames, power of two */
+    volatile uint32_t wr, rd;
+    volatile uint32_t underruns; /* output ran dry (counted by the backend) */
+    volatile uint32_t overruns;  /* Write found no room, samples dropped */
+} AudioRing;
+
+/* Allocate room for at least min_frames.  Returns 0 on success. */
+int AudioRing_Init(AudioRing *r, uint32_t min_frames);
+void AudioRing_Free(AudioRing *r);
+
+static inline uint32_t AudioRing_Fill(const AudioRing *r)
+{
+    return r->wr - r->rd;
+}
+
+/* Producer: store up to frames, drop (and count) what does not fit.
+ * Returns frames stored. */
+int AudioRing_Write(AudioRing *r, const int16_t *src, int frames);
+
+/* Consumer: take up to frames.  Returns frames read. */
+int AudioRing_Read(AudioRing *r, int16_t *dst, int frames);
+
+#endif /* AUDIO_RING_H */
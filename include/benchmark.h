@@ -0,0 +1,31 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+
+/*
+ * Benchmark mode and pad input record / replay.
+ *
+ * bench_frames = N runs unthrottled (no frame limiter, no audio output,
+ * every frame drawn) and after N measured frames writes bench.json and
+ * exits.  input_record / input_play log and replay the pad responses
+ * SIO hands the game, keyed by VBlank, so two runs of the same build
+ * and settings see the same input on the same frames.
+ */
+
+extern int bench_active; /* 1 while bench_frames is running */
+
+void Bench_Init(void);  /* before Init_Dynarec: opens input files, unthrottles */
+void Bench_Frame(void); /* every VBlank */
+
+/* SIO pad exchange for port (0/1): on replay, fills resp / *len with
+ * the recorded response and returns 1; otherwise records what the host
+ * pad gave (Bench_PadRecord) and returns 0 */
+int Bench_PadReplay(int port, uint8_t *resp, int *len);
+void Bench_PadRecord(int port, const uint8_t *resp, int len);
+
+/* gpu_trace_bench.c: replay a GPU trace capture (gpu_trace_bench = file)
+ * through the renderer alone, write bench_gpu.json and exit */
+void Bench_GpuTrace(const char *path);
+
+#endif /* BENCHMARK_H */
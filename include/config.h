@@ -7,27 +7,106 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <stdint.h>
+
 #define CONFIG_FILENAME "superpsx.ini"
 #define BIOS_PATH_DEFAULT "bios/SCPH1001.BIN"
+#define CONFIG_GAME_MAX 16
+#define CONFIG_INTERP_MAX 16
+#define CONFIG_GAME_SETTINGS 512
+
+/* Per-game overrides ("<key>.<game ID> = value", or any key inside a
+ * "[<game ID>]" section), applied once the disc's game ID is known and
+ * before Init_Dynarec (config_apply_game) */
+typedef struct {
+    char id[16];              /* SYSTEM.CNF boot file name, e.g. SLUS_005.94 */
+    int  gte_accuracy;        /* GTE_TIER_* (-1 = not set) */
+    uint32_t interp_pcs[CONFIG_INTERP_MAX]; /* block PCs left to the interpreter */
+    int  interp_count;
+    char settings[CONFIG_GAME_SETTINGS]; /* [<game ID>] section: "key\0value\0" pairs */
+    int  settings_len;
+} PSXGameConfig;
 
 typedef struct {
     char bios_path[512];      /* default: BIOS_PATH_DEFAULT */
     int  boot_bios_only;      /* 1 = boot to BIOS shell, no ROM required */
     int  audio_enabled;       /* default 1 */
     int  controllers_enabled; /* default 1 */
+    int  pad_thread;          /* 1 = host pads polled by a worker thread once per host VBlank (default 0) */
     int  region_pal;          /* 0 = NTSC (default), 1 = PAL */
+    int  spu_reverb;          /* 0 = off, 1 = reduced taps, 2 = full PSX reverb (default 0) */
+    int  audio_rate;          /* output rate: 44100, 32000 or 22050 (default 44100) */
+    int  audio_latency;       /* ms queued to an audio output thread (0 = synchronous output, default 0) */
     int  disable_audio;       /* 1 = skip SPU processing (profiling) */
     int  disable_gpu;         /* 1 = skip GS rendering (profiling) */
+    int  gpu_reorder;         /* 1 = group non-overlapping polygons by texture/state, PS2 (default 0) */
+    int  gpu_replay;          /* 1 = replay captured GIF output of repeated DMA2 chains, PS2 (default 0) */
+    int  gpu_queue;           /* 1 = queue GP0 DMA chains, translate at the next sync point, PS2 (default 0) */
+    int  gpu_field_render;    /* 1 = in 480i draw only the lines of the next field, PS2 (default 0) */
+    int  gpu_dither_off;      /* 1 = ignore the GP0(E1h) dither bit, never dither (default 0) */
+    int  gpu_psp_kick;        /* 1 = send the GE list after each GP0 DMA chain instead of at frame end, PSP (default 0) */
+    int  gpu_psp_direct_tex;  /* 1 = draw T4/T8 rects of uncached pages straight from EDRAM, PSP (default 1) */
+    int  mdec_async;          /* 1 = decode MDEC DMA1 in scheduler slices, complete it when written (default 0) */
+    int  dma_timing;          /* 1 = CDROM/OTC DMA complete after their transfer time, not at once (default 0) */
+    int  hblank_lazy;         /* 1 = one HBlank event per frame (at VBlank) instead of every 32 scanlines (default 0) */
+    int  frameskip;           /* N = skip drawing up to N frames in a row when over budget (0 = off, default 0) */
     int  frame_limit;         /* 1 = cap at 60fps NTSC / 50fps PAL (default 1) */
+    int  fast_forward;        /* N = unthrottled, draw 1 frame in N, no audio output (0 = off, default 0) */
     int  gte_vu0;             /* 1 = use VU0 macro mode for RTPS/RTPT (default 1) */
+    int  gte_vu1_batch;       /* 1 = replay RTPS/RTPT/NCDS/NCCT runs as one batch, VU1 on PS2 (default 0) */
+    int  gte_lazy_flags;      /* 1 = skip FLAG bookkeeping when the next command resets it unread (default 0) */
+    int  gte_accuracy;        /* GTE_TIER_EXACT/FAST/ULTRA (-1 = follow gte_vu0, default -1) */
+    char gte_record[512];     /* GTE command-stream recording file ("" = off) */
+    int  gte_record_max;      /* commands recorded before the file is closed (default 20000) */
     int  show_fps;            /* 1 = show frame counter on OSD (default 0) */
     int  perf_report;         /* 1 = print JIT/EMU perf stats to stdout (default 0) */
     int  cdrom_fast;          /* 1 = minimal CDROM pending delays (default 0) */
+    int  cdrom_async;         /* 1 = read-ahead thread for disc sectors, 2 = also delay late sectors (default 0) */
+    int  cdrom_speed;         /* 0 = legacy timing, 1 = seek-distance model, 2/4/8 = model with faster data reads (default 0) */
+    int  cdrom_preload;       /* MB of RAM for the most read parts of the disc image (0 = off, default 0) */
     int  display_mode;        /* 0=4:3 aspect, 1=stretch fill, 2=integer (default 0) */
     int  display_filter;      /* 1 = bilinear filter (default 0 = nearest) */
     int  interpreter;         /* 1 = use interpreter instead of DRC (default 0) */
+    int  jit_tier_threshold;  /* dispatches before a quick block is recompiled with the tier-1 passes (0 = off, default 0) */
+    int  jit_ht_entries;      /* JR/JALR dispatch table entries, rounded to a power of 2 (default 8192) */
+    int  jit_ht_ways;         /* dispatch table associativity: 2 or 4 (default 2) */
+    int  jit_code_buffer;     /* MB of JIT code buffer, 1-16 (0 = sized by the memory plan, default 0) */
+    int  psx_tlb;             /* 1 = TLB fastmem for JIT RAM/BIOS accesses, PS2 only (default 0) */
+    int  jit_cache_frames;    /* frames before the JIT cache is saved to disk (0 = no disk cache, default 0) */
+    int  jit_spec_compile;    /* queued branch targets compiled per idle slice and per frame (0 = off, default 4) */
+    int  jit_sample_hz;       /* host PC samples per second for the JIT dump (ENABLE_JIT_DUMP, 0 = off) */
+    int  bios_hle;            /* 1 = native memcpy/strlen/malloc/TestEvent/critical section BIOS calls (default 0) */
+    int  cycle_model;         /* 1 = add RAM/BIOS/IO wait states to block costs (default 0) */
+    int  cycle_scale;         /* per-game block cost scale in percent (default 100) */
+    char cycle_calib[512];    /* reference trace for calibration mode ("" = off) */
+    int  jit_lazy_cycles;     /* 1 = budget check only at back-edges/IO exits (default 0) */
+    int  jit_shared_stubs;    /* 1 = slow paths, SMC calls and exits go through shared stubs (default 0) */
+    int  jit_const_links;     /* 1 = seed address bases all direct links agree on, guarded (default 0) */
+    int  jit_fast_irq;        /* 1 = block exits take IRQs in place and run on at the vector (default 0) */
+    int  jit_inline_caches;   /* targets cached inline at each JR/JALR, 1-4 (0 = hash dispatch only, default 0) */
+    int  jit_gp0_fifo;        /* 1 = const GP0 port stores are buffered, drained in blocks (default 0) */
+    int  jit_interp_smc;      /* opcode-change recompiles before a block is interpreted (0 = never, default 0) */
+    int  jit_idle_learn;      /* N = wait loops found N times are skipped on arrival, saved per game (0 = off, default 0) */
+    uint32_t jit_interp_pcs[CONFIG_INTERP_MAX]; /* block PCs never compiled (jit_interp + per-game list) */
+    int  jit_interp_count;
     char mcd1_path[512];      /* path to memory card 1 */
     char mcd2_path[512];      /* path to memory card 2 */
+    int  mcd_flush_frames;    /* N = write card sectors back after N VBlanks without a write (0 = at once, default 30) */
+    int  snapshot_frame;      /* N = save state snapshot at frame N (0 = off, default 0) */
+    int  snapshot_replay;     /* M = reload that snapshot every M frames after it (0 = never, default 0) */
+    int  rewind_buffer;       /* MB of rewind history, Select+L2 steps back (0 = off, default 0) */
+    int  boot_snapshot;       /* 1 = start from / save the machine at the BIOS exe-load hook (default 0) */
+    int  rewind_interval;     /* frames between rewind points (default 30) */
+    int  bench_frames;        /* N = benchmark: time N unthrottled frames, write bench.json, exit (0 = off) */
+    int  bench_warmup;        /* frames run before the benchmark starts timing (default 0) */
+    int  bench_vram_hash;     /* N = hash VRAM every N benchmark frames into the report (0 = off) */
+    char input_record[512];   /* record pad input to this file ("" = off) */
+    char input_play[512];     /* replay pad input from this file ("" = off) */
+    char gpu_trace_bench[512]; /* replay this GPU trace as a benchmark, then exit ("" = off) */
+    int  gpu_trace_bench_loops; /* times the trace is replayed (default 3) */
+    PSXGameConfig games[CONFIG_GAME_MAX];
+    int  game_count;
+    char game_id[16];         /* boot disc's game ID once known ("" = EXE or BIOS boot) */
 } PSXConfig;
 
 extern PSXConfig psx_config;
@@ -39,4 +118,10 @@ extern PSXConfig psx_config;
  */
 int load_config_file(void);
 
+/**
+ * Apply the per-game overrides whose ID matches game_id (case-insensitive).
+ * Returns 1 if an entry matched.
+ */
+int config_apply_game(const char *game_id);
+
 #endif /* CONFIG_H */
@@ -17,10 +17,20 @@
  * Usage:
  *   fast_copy_128(gif_ptr, &vram[row * 1024 + px], &vram[(row+1) * 1024 + px]);
  *   fast_copy_256(gif_ptr, &vram[row * 1024 + px], &vram[(row+1) * 1024 + px]);
+ *
+ * fast_copy_bulk() is the byte-count form for DMA block transfers
+ * (SPU RAM); it takes the 128-byte path when both ends are aligned.
+ *
+ * fast_stp_qw() converts PSX 15BPP pixels to GS CT16S on the way: bit 15
+ * (STP/alpha) is forced on for every non-zero pixel, 8 pixels per QW
+ * (MMI PCEQH/PNOR/PSLLH/POR on the EE, SSE2 on x86 hosts).
+ * fast_stp_clean() tells whether that fixup would leave a block as it is,
+ * so it can go to the GS without a converted copy.
  */
 #ifndef FAST_COPY_H
 #define FAST_COPY_H
 
+#include <stdint.h>
 #include <string.h> /* memcpy fallback */
 
 #ifdef _EE /* ═══ PS2 EE target — native 128-bit LQ/SQ ═══════════════════ */
@@ -112,6 +122,73 @@ static inline void fast_copy_256(void *dst, const void *src, const void *next_sr
     );
 }
 
+/**
+ * Copy n bytes.  Whole 128-byte chunks use LQ/SQ when src and dst are
+ * both 16-byte aligned; the rest (or an unaligned copy) is memcpy.
+ */
+static inline void fast_copy_bulk(void *dst, const void *src, uint32_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    if (!(((uintptr_t)d | (uintptr_t)s) & 15))
+    {
+        for (; n >= 128; n -= 128, d += 128, s += 128)
+            fast_copy_128(d, s, n >= 256 ? s + 128 : s);
+    }
+    memcpy(d, s, n);
+}
+
+/**
+ * STP fixup of qwc quadwords (8 pixels each): dst = src | (src != 0) << 15.
+ * Both pointers 16-byte aligned; dst may equal src.
+ */
+static inline void fast_stp_qw(void *dst, const void *src, int qwc)
+{
+    const uint8_t *s = (const uint8_t *)src;
+    uint8_t *d = (uint8_t *)dst;
+    for (int i = 0; i < qwc; i++, s += 16, d += 16)
+    {
+        __asm__ volatile (
+            "lq    $8, 0(%[s])\n"
+            "pceqh $9, $8, $0\n"  /* 0xFFFF where pixel == 0 */
+            "pnor  $9, $9, $0\n"  /* 0xFFFF where pixel != 0 */
+            "psllh $9, $9, 15\n"  /* 0x8000 where pixel != 0 */
+            "por   $8, $8, $9\n"
+            "sq    $8, 0(%[d])\n"
+            :
+            : [d] "r"(d), [s] "r"(s)
+            : "$8","$9","memory"
+        );
+    }
+}
+
+/**
+ * 1 if every pixel of the qwc quadwords at src is 0 or already has bit
+ * 15 set, i.e. fast_stp_qw() would not change them.  src 16-byte aligned.
+ */
+static inline int fast_stp_clean(const void *src, int qwc)
+{
+    const uint8_t *s = (const uint8_t *)src;
+    for (int i = 0; i < qwc; i++, s += 16)
+    {
+        uint64_t bad;
+        __asm__ volatile (
+            "lq     $8, 0(%[s])\n"
+            "pceqh  $9, $8, $0\n"  /* 0xFFFF where pixel == 0 */
+            "psrah  $8, $8, 15\n"  /* 0xFFFF where bit 15 set */
+            "pnor   $9, $9, $8\n"  /* 0xFFFF where the fixup would set it */
+            "pcpyud $8, $9, $9\n"
+            "or     %[b], $8, $9\n"
+            : [b] "=r"(bad)
+            : [s] "r"(s)
+            : "$8","$9"
+        );
+        if (bad)
+            return 0;
+    }
+    return 1;
+}
+
 #else /* ═══ Host / test builds — plain memcpy fallback ═══════════════════ */
 
 static inline void fast_copy_128(void *dst, const void *src, const void *next_src)
@@ -126,6 +203,58 @@ static inline void fast_copy_256(void *dst, const void *src, const void *next_sr
     memcpy(dst, src, 256);
 }
 
+static inline void fast_copy_bulk(void *dst, const void *src, uint32_t n)
+{
+    memcpy(dst, src, n);
+}
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+static inline void fast_stp_qw(void *dst, const void *src, int qwc)
+{
+    const __m128i stp = _mm_set1_epi16((short)0x8000);
+    const __m128i *s = (const __m128i *)src;
+    __m128i *d = (__m128i *)dst;
+    for (int i = 0; i < qwc; i++)
+    {
+        __m128i v = _mm_load_si128(&s[i]);
+        __m128i z = _mm_cmpeq_epi16(v, _mm_setzero_si128());
+        _mm_store_si128(&d[i], _mm_or_si128(v, _mm_andnot_si128(z, stp)));
+    }
+}
+
+static inline int fast_stp_clean(const void *src, int qwc)
+{
+    const __m128i *s = (const __m128i *)src;
+    for (int i = 0; i < qwc; i++)
+    {
+        __m128i v = _mm_load_si128(&s[i]);
+        __m128i ok = _mm_or_si128(_mm_cmpeq_epi16(v, _mm_setzero_si128()), _mm_srai_epi16(v, 15));
+        if (_mm_movemask_epi8(ok) != 0xFFFF)
+            return 0;
+    }
+    return 1;
+}
+#else
+static inline void fast_stp_qw(void *dst, const void *src, int qwc)
+{
+    const uint16_t *s = (const uint16_t *)src;
+    uint16_t *d = (uint16_t *)dst;
+    for (int i = 0; i < qwc * 8; i++)
+        d[i] = s[i] | ((-(s[i] != 0)) & 0x8000);
+}
+
+static inline int fast_stp_clean(const void *src, int qwc)
+{
+    const uint16_t *s = (const uint16_t *)src;
+    for (int i = 0; i < qwc * 8; i++)
+        if (s[i] && !(s[i] & 0x8000))
+            return 0;
+    return 1;
+}
+#endif
+
 #endif /* _EE */
 
 #endif /* FAST_COPY_H */
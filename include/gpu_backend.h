@@ -17,11 +17,28 @@ void GPU_Backend_UploadShadowVRAM(int x, int y, int w, int h);
 void GPU_Backend_UploadRegionFast(uint32_t coords, uint32_t dims,
                                   uint32_t *data_ptr, uint32_t word_count);
 void GPU_Backend_VRAMCopy(int sx, int sy, int dx, int dy, int w, int h);
+/* GP0(80h): copy inside the renderer's VRAM.  Returns 0 if the backend
+ * can't (the caller copies psx_vram_shadow and re-uploads the
+ * destination from it), 1 if the caller still copies the shadow, 2 if
+ * the backend left the shadow destination stale (see ShadowSync). */
+int GPU_Backend_VRAMCopyLocal(int sx, int sy, int dx, int dy, int w, int h);
+/* Bring psx_vram_shadow up to date over a region before the CPU reads
+ * it: fetches what only the renderer has written there. */
+void GPU_Backend_ShadowSync(int x, int y, int w, int h);
 
 void GPU_Backend_VRAMWrite(uint32_t word);
+/* count GPU_Backend_VRAMWrite words at once (DMA2 LoadImage data) */
+void GPU_Backend_VRAMWriteBlock(const uint32_t *words, uint32_t count);
 void GPU_Backend_VRAMFlush(void);
 
 void GPU_Backend_VRAMReadback(int x, int y, int w, int h);
+/* Complete a readback the backend deferred (gpu_readback_pending).
+ * Called before the data port is read and before anything can write
+ * VRAM again. */
+void GPU_Backend_VRAMReadbackResolve(void);
+/* Translate GP0 DMA chains the backend queued (gpu_queue_pending).
+ * Called wherever the CPU could observe the GPU. */
+void GPU_Backend_QueueDrain(void);
 
 /* ── Drawing environment ─────────────────────────────────────────── */
 void GPU_Backend_SetScissor(int x1, int y1, int x2, int y2);
@@ -31,6 +31,7 @@
 #define disp_hres368 ((gpu_stat >> 16) & 1)
 #define disp_hres ((gpu_stat >> 17) & 3)
 #define disp_vres ((gpu_stat >> 19) & 1)
+#define disp_24bit ((gpu_stat >> 21) & 1)
 #define disp_pal ((gpu_stat >> 20) & 1)
 #define disp_interlace ((gpu_stat >> 22) & 1)
 
@@ -42,6 +43,9 @@
 extern uint32_t gpu_stat;
 extern uint32_t gpu_read;
 extern volatile int gpu_pending_vblank_flush;
+extern int gpu_readback_pending; /* GP0(C0h) readback deferred to first use */
+extern int gpu_queue_pending;    /* GP0 DMA chains queued, not yet translated */
+extern int gpu_skip_frame;       /* frameskip: rasterising commands are dropped */
 
 /* GPU rendering cost estimation (accumulated pixel count for cycle accounting) */
 extern uint64_t gpu_estimated_pixels;
@@ -172,9 +176,26 @@ typedef struct {
     uint32_t clut_cache_hit;    /* CLUT cache hits (skip transform+dcache) */
     uint32_t clut_cache_miss;   /* CLUT cache misses (full transform) */
     uint32_t tex_key_change;    /* texture key changes (triggers setup) */
+    uint32_t tex_direct;        /* T4/T8 rects drawn from EDRAM (gpu_psp_direct_tex) */
+    uint32_t tex_direct_fallback; /* uncached T4/T8 rects that needed the tcache anyway */
     uint32_t vbatch_flushes;    /* vertex batch flushes (sceGuDrawArray calls) */
     uint32_t vbatch_verts;      /* total vertices submitted */
     uint32_t vram_readbacks;    /* VRAM->RAM readbacks (stalls) */
+    /* PS2 repeated-chain replay (gpu_replay) */
+    uint32_t replay_chains;     /* DMA2 chains served from a capture */
+    uint32_t replay_captures;   /* chains captured for later replay */
+    uint32_t replay_frames;     /* frames whose chains all came from captures */
+    /* Auto frameskip (frameskip = N) */
+    uint32_t skipped_prims;     /* draw commands dropped in skipped frames */
+    uint32_t skipped_frames;    /* frames whose drawing was skipped */
+    /* Draw commands that couldn't touch a pixel, dropped before the backend */
+    uint32_t culled_degenerate; /* zero-area polygons, zero-size rects */
+    uint32_t culled_offscreen;  /* entirely outside the drawing area */
+    /* PS2 GIF traffic */
+    uint32_t gif_qwords;        /* qwords queued to the GIF by Flush_GIF */
+    /* PS2 lazy GS state (gs_state) */
+    uint32_t gs_state_written;  /* state registers emitted (DTHE/ALPHA/TEX0/...) */
+    uint32_t gs_state_skipped;  /* state registers elided because gs_state matched */
 } gpu_frame_stats_t;
 extern gpu_frame_stats_t gpu_frame_stats;
 int Decode_TexPage_Cached(int tex_format,
@@ -202,5 +223,27 @@ void Prim_FlushBatch(void);
 extern const uint8_t gpu_cmd_size[256]; /* O(1) command size lookup */
 int GPU_GetCommandSize(uint32_t cmd);
 void GPU_ProcessDmaBlock(uint32_t *data_ptr, uint32_t word_count);
+int GPU_E1DitherOnly(uint32_t data); /* E1h word differs from the last only in bit 9 */
+
+/* GP0 write-combining FIFO (jit_gp0_fifo): const-address GP0 port
+ * stores from native code are appended here and reach the GPU through
+ * GPU_ProcessDmaBlock when it fills, before any other GPU access
+ * (GPU_GP0FifoSync) and when the chain exits */
+#define GPU_GP0_FIFO_WORDS 64
+typedef struct
+{
+    uint32_t count;
+    uint32_t words[GPU_GP0_FIFO_WORDS];
+} gpu_gp0_fifo_t;
+extern gpu_gp0_fifo_t gpu_gp0_fifo;
+void GPU_GP0FifoDrain(void);
+static inline void GPU_GP0FifoSync(void)
+{
+    if (gpu_gp0_fifo.count)
+        GPU_GP0FifoDrain();
+}
+int GPU_SkipDraw(const uint32_t *cmd);
+int GPU_CullDraw(const uint32_t *cmd);
+void GPU_SetFrameSkip(int skip);
 
 #endif /* GPU_STATE_H */
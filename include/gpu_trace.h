@@ -1,9 +1,11 @@
 /**
  * gpu_trace.h — GPU command stream ring buffer for offline analysis
  *
- * Records raw GP0 words into a 60-frame ring buffer. On trigger (button
- * combo), dumps the last 60 frames to a binary file for offline analysis
- * with tools/gpu_trace_analyze.py.
+ * Records raw GP0 words into a 60-frame ring buffer.  On trigger (button
+ * combo), snapshots VRAM and the drawing environment at the next frame
+ * boundary, then dumps the 60 frames that follow.  Analysed offline with
+ * tools/gpu_trace_analyze.py; replayed as a GPU benchmark with
+ * gpu_trace_bench = <file> (gpu_trace_bench.c).
  *
  * Compiled only when ENABLE_GPU_TRACE is defined (CMake option).
  */
@@ -17,12 +19,21 @@
 #define GPU_TRACE_FRAMES      60
 #define GPU_TRACE_MAX_WORDS   16384  /* per frame (~64KB) */
 
+#endif /* ENABLE_GPU_TRACE */
+
 /* Binary file format:
- *   Header:  magic("GPTD") | version(1) | frame_count | max_words
+ *   Header:  magic("GPTD") | version(2) | frame_count | max_words
+ *   Prelude: word_count(u32) | gp0_data[word_count]
+ *            (E1-E6 restoring the drawing environment at capture start)
+ *   VRAM:    1024 x 512 u16, as of capture start
  *   Per frame: frame_id(u32) | word_count(u32) | gp0_data[word_count]
+ * Version 1 files have no prelude and no VRAM.
  */
 #define GPU_TRACE_MAGIC   0x44545047  /* "GPTD" little-endian */
-#define GPU_TRACE_VERSION 1
+#define GPU_TRACE_VERSION 2
+#define GPU_TRACE_PRELUDE_WORDS 6
+
+#ifdef ENABLE_GPU_TRACE
 
 void gpu_trace_init(void);
 void gpu_trace_record(const uint32_t *data, uint32_t word_count);
@@ -8,8 +8,18 @@
  * otherwise returns RUN_RES_NORMAL. */
 int run_interpreter_chain(uint64_t deadline);
 
+/* Execute one basic block: up to and including the delay slot of the
+ * first branch, or until an exception.  Pending loads are committed
+ * before returning, so compiled code can take over.  Used for the
+ * blocks the JIT leaves to the interpreter (jit_interp_*). */
+void run_interpreter_block(void);
+
 /* Reset interpreter-internal state (branch pipeline).
  * Call before starting a new isolated execution context. */
 void interpreter_reset_state(void);
 
+/* Drop every decoded instruction.  Needed only when decode-time state
+ * changes (the cycle cost model); code writes are caught on fetch. */
+void interpreter_flush_cache(void);
+
 #endif /* INTERPRETER_H */
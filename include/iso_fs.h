@@ -14,15 +14,16 @@
 
 /*
  * Initialize the ISO 9660 filesystem parser.
- * Reads the Primary Volume Descriptor (PVD) at LBA 16 and caches
- * root directory information.
+ * Reads the Primary Volume Descriptor (PVD) at LBA 16, then walks the
+ * directory tree once to build the path index used by ISOFS_FindFile.
  * Returns 0 on success, < 0 on error.
  */
 int ISOFS_Init(void);
 
 /*
- * Find a file in the root directory by name.
+ * Find a file by path ("SYSTEM.CNF", "DIR/GAME.EXE;1", '\\' also accepted).
  * Handles ISO 9660 filename conventions (uppercase, ";1" version suffix).
+ * Served from the mount-time index without disc reads.
  * On success, returns 0 and fills lba_out and size_out.
  * Returns -1 if file not found.
  */
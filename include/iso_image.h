@@ -15,6 +15,7 @@
 #define RAW_SECTOR_SIZE     2352
 #define RAW_DATA_OFFSET     24   /* Sync(12) + Header(4) + Subheader(8) for Mode 2 Form 1 */
 #define RAW_MODE1_OFFSET    16   /* Sync(12) + Header(4) for Mode 1 */
+#define ISO_MODE2_SIZE      2336 /* Subheader(8) + form 1/2 payload, after the header */
 
 /*
  * Open an ISO image file.
@@ -25,8 +26,9 @@ int ISO_Open(const char *path);
 
 /*
  * Open a disc image from a CUE sheet.
- * Parses the CUE file to find the BIN filename, resolves its path
- * relative to the CUE file, and opens it via ISO_Open().
+ * Parses the CUE file's FILE / TRACK / INDEX / PREGAP lines, resolves the
+ * BIN paths relative to the CUE file, opens the first (data) one via
+ * ISO_Open() and keeps the track table for CD-DA.
  * Returns 0 on success, < 0 on error.
  */
 int ISO_OpenCue(const char *cue_path);
@@ -37,6 +39,84 @@ int ISO_OpenCue(const char *cue_path);
  */
 int ISO_ReadSector(uint32_t lba, uint8_t *buf);
 
+/*
+ * Read count consecutive 2048-byte sectors into buf.
+ * Returns the number of sectors read (stops at the first failure).
+ */
+int ISO_ReadSectors(uint32_t lba, uint32_t count, uint8_t *buf);
+
+/*
+ * Read the 2336 bytes after the sector header (subheader + payload) of a
+ * mode-2 raw image sector, as needed for XA audio.
+ * Returns -1 for 2048-byte / mode-1 images, on error or out-of-range.
+ */
+int ISO_ReadSectorRaw(uint32_t lba, uint8_t *buf);
+
+/*
+ * Track table.  From the CUE sheet (every TRACK at its INDEX 01, laid
+ * out across the sheet's FILEs, PREGAP sectors included); any other
+ * image is one data track.  LBAs are image LBAs as everywhere here
+ * (absolute disc LBA - 150); a track runs up to the next one's INDEX 01.
+ */
+#define ISO_MAX_TRACKS 99
+
+typedef struct
+{
+    uint32_t start;  /* INDEX 01 */
+    uint32_t length; /* sectors */
+    uint8_t audio;   /* 1 = CD-DA */
+} IsoTrack;
+
+int ISO_GetTrackCount(void);
+
+/* Track 1..ISO_GetTrackCount(), NULL if out of range */
+const IsoTrack *ISO_GetTrack(int track);
+
+/* Track holding lba, 0 past the end of the disc */
+int ISO_TrackAt(uint32_t lba);
+
+/* First LBA of the lead-out */
+uint32_t ISO_GetDiscEnd(void);
+
+/*
+ * Read up to count raw 2352-byte CD-DA sectors starting at lba, stopping
+ * at the end of the track or of a file.  Data and PREGAP sectors come
+ * back as silence.  Uses its own file descriptor: one caller at a time
+ * (the CDDA stream), no locking against the data reads.
+ * Returns the number of sectors stored, -1 on error or past the disc end.
+ */
+int ISO_ReadAudio(uint32_t lba, uint32_t count, uint8_t *buf);
+
+/*
+ * Read-ahead cache counters (chunk lookups and bytes fetched from the
+ * image file), reported and cleared by the profiler.
+ */
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t bytes_read;
+} IsoCacheStats;
+
+extern IsoCacheStats iso_cache_stats;
+
+/*
+ * Serialise sector reads from here on: call before a second thread
+ * (cdrom_io.c) starts reading.
+ */
+void ISO_EnableThreadedAccess(void);
+
+/*
+ * RAM preload (cdrom_preload): record which parts of the image the game
+ * reads and, from the next boot on, read the most used ones (or the whole
+ * image, if it fits) into up to budget bytes of RAM from a worker thread.
+ * Call once the emulator's own large allocations are done.
+ */
+void ISO_PreloadStart(uint32_t budget);
+
+/* Once per frame: saves the access map now and then */
+void ISO_PreloadFrame(void);
+
 /*
  * Returns 1 if an ISO image is currently loaded/mounted.
  */
@@ -0,0 +1,40 @@
+/**
+ * log_ring.h — Deferred DLOG / host log output
+ *
+ * With ENABLE_LOG_RING, DLOG, DLOG_RAW and host_log_printf/putc neither
+ * format nor write at the call site.  log_ring_printf stores a binary
+ * record: the format string's address, which serves as its ID, plus the
+ * raw arguments (%s copied, up to LOG_STR_MAX bytes).  log_ring_drain
+ * formats and writes the records at VBlank and at exit.  A call costs a
+ * walk of the format string and a few stores instead of vsnprintf and a
+ * synchronous host write, so debug logging can stay on in timing runs.
+ *
+ * Output keeps call order per destination but comes out up to a frame
+ * behind plain printf.  Formats must outlive the drain (string literals:
+ * DLOG pastes LOG_TAG onto one anyway).
+ *
+ * Compiled only when ENABLE_LOG_RING is defined (CMake option).
+ */
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdarg.h>
+
+enum {
+    LOG_DEST_STDOUT = 0, /* DLOG, DLOG_RAW */
+    LOG_DEST_HOST        /* host_log_fd (output.log) */
+};
+
+#ifdef ENABLE_LOG_RING
+
+void log_ring_printf(int dest, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+void log_ring_vprintf(int dest, const char *fmt, va_list ap);
+void log_ring_drain(void); /* every VBlank and at exit */
+
+#else
+
+static inline void log_ring_drain(void) {}
+
+#endif /* ENABLE_LOG_RING */
+#endif /* LOG_RING_H */
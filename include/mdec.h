@@ -11,9 +11,11 @@ uint32_t MDEC_ReadStatus(void);         /* 0x1F801824 read  */
 
 /* DMA channel handlers */
 void MDEC_DMA0(uint32_t madr, uint32_t bcr, uint32_t chcr); /* MDECin:  RAM→MDEC */
-void MDEC_DMA1(uint32_t madr, uint32_t bcr, uint32_t chcr); /* MDECout: MDEC→RAM */
+/* MDECout: MDEC→RAM.  Returns 1 when the decode was queued (mdec_async);
+ * the channel is then completed by MDEC_DMA1_Complete, not by dma.c. */
+int  MDEC_DMA1(uint32_t madr, uint32_t bcr, uint32_t chcr);
 
-/* Scheduler callback for deferred DMA1 completion */
+/* End of a queued DMA1: clears BUSY, completes DMA channel 1 */
 void MDEC_DMA1_Complete(void);
 
 #ifdef ENABLE_MDEC_IPU
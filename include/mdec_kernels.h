@@ -0,0 +1,40 @@
+#ifndef MDEC_KERNELS_H
+#define MDEC_KERNELS_H
+
+#include <stdint.h>
+
+/*
+ * MDEC inner kernels: AAN IDCT of one 8x8 block and YUV→RGB of one
+ * macroblock (6 IDCT'd blocks: Cr, Cb, Y1-Y4).  Every table gives the
+ * same output bit for bit as mdec_kernels_c; tools/mdec_kernel_check.c
+ * compares them on the host.
+ *
+ * blk must be 16-byte aligned (the SIMD kernels load whole rows).
+ */
+
+/* Fixed-point helpers shared with the RLE decoder in mdec.c */
+#define AAN_CONST_BITS 12
+#define SCALE(x, n)    ((x) >> (n))
+#define SCALER(x, n)   (((x) + ((1 << (n)) >> 1)) >> (n))
+
+typedef struct {
+    const char *name;
+    /* used_col: bit i = column i has AC rows, -1 = DC only (see rl2blk) */
+    void (*idct)(int *blk, int used_col);
+    /* stp = 0x8000 or 0, ORed into every pixel */
+    void (*yuv2rgb15)(const int *blk, uint16_t *image, uint16_t stp);
+    void (*yuv2rgb24)(const int *blk, uint8_t *image);
+} MdecKernels;
+
+extern const MdecKernels mdec_kernels_c;
+#if defined(_EE) || defined(MDEC_KERNEL_CHECK)
+extern const MdecKernels mdec_kernels_mmi;
+#endif
+#ifdef __SSE2__
+extern const MdecKernels mdec_kernels_sse2;
+#endif
+
+/* Fastest table for this build */
+const MdecKernels *MDEC_KernelsSelect(void);
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * mem_budget.h — Startup memory plan and per-subsystem arenas
+ *
+ * MemBudget_Init measures the heap once at boot, keeps a fixed reserve
+ * for ordinary malloc users (PSX RAM and BIOS, the VRAM shadow, JIT page
+ * tables, snapshot images, file buffers) and splits the rest between the
+ * big consumers in priority order: the JIT code buffer and its block
+ * tables, the PSP texture cache, the rewind ring, disc preload.  Each
+ * gets one aligned arena, carved with MemPool_Alloc, and the plan is
+ * printed as a memory map.
+ *
+ * The JIT is sized from what is left (jit_code_buffer = 0) or to a fixed
+ * size; the texture cache shrinks by halves; rewind_buffer and
+ * cdrom_preload are capped to what remains after those.
+ */
+#ifndef MEM_BUDGET_H
+#define MEM_BUDGET_H
+
+#include <stdint.h>
+
+typedef enum
+{
+    MEM_POOL_JIT,      /* code_buffer, block_node_pool, jit_ht */
+    MEM_POOL_TEXCACHE, /* PSP texture page slots (GS VRAM on PS2: empty) */
+    MEM_POOL_STATE,    /* Rewind ring */
+    MEM_POOL_CDROM,    /* Disc preload chunks */
+    MEM_POOL_COUNT
+} MemPoolId;
+
+/* Plan and allocate every pool (once; MemPool_* call it on first use) */
+void MemBudget_Init(void);
+
+/* JIT code buffer bytes the plan allows for */
+uint32_t MemBudget_CodeBufferSize(void);
+
+/* Bump allocation from a pool; NULL when it doesn't fit.  align is a
+ * power of 2. */
+void *MemPool_Alloc(MemPoolId pool, uint32_t size, uint32_t align);
+
+/* Bytes still free in a pool */
+uint32_t MemPool_Avail(MemPoolId pool);
+
+/* Give back everything allocated from a pool */
+void MemPool_Reset(MemPoolId pool);
+
+#endif /* MEM_BUDGET_H */
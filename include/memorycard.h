@@ -14,5 +14,7 @@ int MCD_IsIdle(int slot);
 int MCD_IsLoaded(int slot);
 int MCD_GetPhase(int slot);
 int MCD_InReadDataPhase(int slot);
+void MCD_Frame(void); /* VBlank: write back cards idle for mcd_flush_frames */
+void MCD_Flush(void); /* write back every dirty sector now */
 
 #endif /* MEMORYCARD_H */
@@ -0,0 +1,54 @@
+/**
+ * pad_snapshot.h — Host pad state published by a polling thread
+ *
+ * With pad_thread = 1 the host pad reads (libpad on PS2, sceCtrl on PSP)
+ * move off the emulator thread onto a worker that polls once per host
+ * VBlank and publishes the raw buttons here; the SIO pad exchange only
+ * copies them out.
+ *
+ * seq is odd while the worker writes.  A reader that saw it odd, or saw
+ * it change across its copy, copies again.  The worker runs above the
+ * emulator thread, so a write is never interrupted by a read and the
+ * retry only happens when a poll lands inside a copy.
+ */
+#ifndef PAD_SNAPSHOT_H
+#define PAD_SNAPSHOT_H
+
+#include <stdint.h>
+
+#define PAD_SNAPSHOT_MAX 8 /* 2 ports x 4 multitap slots */
+
+#define PAD_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+typedef struct
+{
+    volatile uint32_t seq;
+    uint16_t buttons[PAD_SNAPSHOT_MAX];
+} PadSnapshot;
+
+/* Worker side */
+static inline void pad_snapshot_publish(PadSnapshot *s, const uint16_t *buttons)
+{
+    s->seq++;
+    PAD_BARRIER();
+    for (int i = 0; i < PAD_SNAPSHOT_MAX; i++)
+        s->buttons[i] = buttons[i];
+    PAD_BARRIER();
+    s->seq++;
+}
+
+/* Emulator side: a consistent copy of every pad */
+static inline void pad_snapshot_read(const PadSnapshot *s, uint16_t *buttons)
+{
+    uint32_t seq;
+    do
+    {
+        seq = s->seq;
+        PAD_BARRIER();
+        for (int i = 0; i < PAD_SNAPSHOT_MAX; i++)
+            buttons[i] = s->buttons[i];
+        PAD_BARRIER();
+    } while ((seq & 1) || seq != s->seq);
+}
+
+#endif /* PAD_SNAPSHOT_H */
@@ -12,9 +12,30 @@ void Platform_Halt(void);
 /* Cache management */
 void Platform_FlushDCache(void *start, void *end);
 void Platform_FlushICache(void);
+/* Make code written to [start, end) executable: write back its D-cache
+ * lines and invalidate its I-cache lines, leaving the rest of both
+ * caches alone */
+void Platform_SyncCodeRange(void *start, void *end);
 
 /* Timing / Delay */
 uint64_t Platform_GetCycles(void);
 void Platform_Sleep(uint32_t ms);
 
+/* Statistical PC sampling: calls cb(interrupted host PC) hz times a
+ * second from interrupt context.  Returns < 0 where the platform has
+ * no timer interrupt that can see the PC (PSP user mode). */
+int Platform_SampleStart(uint32_t hz, void (*cb)(uintptr_t pc));
+void Platform_SampleStop(void);
+
+/* Worker threads: entry(arg) runs one priority above the calling thread,
+ * so it takes the CPU whenever it is runnable and the caller only runs
+ * while it blocks.  Returns a thread id, < 0 on failure. */
+int Platform_ThreadStart(const char *name, void (*entry)(void *), void *arg,
+                         int stack_size);
+
+/* Counting semaphores.  Create returns an id, < 0 on failure. */
+int Platform_SemaCreate(int init_count, int max_count);
+void Platform_SemaWait(int sema);
+void Platform_SemaSignal(int sema);
+
 #endif /* PLATFORM_H */
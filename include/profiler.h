@@ -38,18 +38,67 @@ extern int prof_disable_gpu_render;
 
 #include <time.h>
 #include <stdio.h>
+#include "timeline.h"
 
 extern const char *prof_category_names[PROF_NUM];
 
+/* ── Time source ─────────────────────────────────────────────────
+ * EE: COP0 Count, one tick per CPU cycle.  PSP user code can't read
+ * COP0, so the 1 us system timer there.  Anything else: clock().
+ * Marks are 32-bit and only ever subtracted, so a wrap between two
+ * reads is harmless (Count wraps every ~14.5 s; no interval timed
+ * here gets near that).
+ *
+ * The EE also counts I$ and D$ misses (PCR0 / PCR1) per category. */
+typedef uint32_t prof_tick_t;
+
+#if defined(PLATFORM_PS2)
+#define PROF_TICKS_PER_SEC 294912000.0
+#define PROF_HAVE_CACHE_COUNTERS 1
+static inline prof_tick_t prof_now(void)
+{
+    prof_tick_t c;
+    __asm__ volatile("mfc0 %0, $9" : "=r"(c));
+    return c;
+}
+#elif defined(PLATFORM_PSP)
+#include <pspthreadman.h>
+#define PROF_TICKS_PER_SEC 1000000.0
+static inline prof_tick_t prof_now(void) { return sceKernelGetSystemTimeLow(); }
+#else
+#define PROF_TICKS_PER_SEC ((double)CLOCKS_PER_SEC)
+static inline prof_tick_t prof_now(void) { return (prof_tick_t)clock(); }
+#endif
+
+/* Point in time a stack entry was entered / resumed */
+typedef struct {
+    prof_tick_t t;
+#ifdef PROF_HAVE_CACHE_COUNTERS
+    uint32_t imiss, dmiss;
+#endif
+} prof_mark_t;
+
+static inline void prof_mark(prof_mark_t *m)
+{
+    m->t = prof_now();
+#ifdef PROF_HAVE_CACHE_COUNTERS
+    __asm__ volatile("mfpc %0, 0" : "=r"(m->imiss));
+    __asm__ volatile("mfpc %0, 1" : "=r"(m->dmiss));
+#endif
+}
+
 /* ── Profiler state ──────────────────────────────────────────────── */
 typedef struct {
-    /* Exclusive-time accumulators (clock() ticks) */
-    clock_t ticks[PROF_NUM];
+    /* Exclusive-time accumulators (prof_now() ticks) */
+    uint64_t ticks[PROF_NUM];
     uint32_t calls[PROF_NUM];
+    /* Exclusive cache misses (EE only, zero elsewhere) */
+    uint64_t icache_miss[PROF_NUM];
+    uint64_t dcache_miss[PROF_NUM];
 
     /* Frame-level wall clock */
-    clock_t frame_start_tick;
-    clock_t total_wall_ticks;
+    prof_tick_t frame_start_tick;
+    uint64_t total_wall_ticks;
     uint32_t frames;
 
     /* Extra counters */
@@ -58,9 +107,15 @@ typedef struct {
     uint32_t jit_compiles;
     uint64_t gpu_pixels;
 
+    /* Cost of the profiler itself, measured by profiler_init: ticks an
+     * empty push/pop pair adds to its own category and to the one it
+     * interrupts.  Taken off every interval charged. */
+    prof_tick_t overhead_self;
+    prof_tick_t overhead_outer;
+
     /* Exclusive-time tracking stack */
     int      stack[8];
-    clock_t  stack_enter[8];
+    prof_mark_t stack_enter[8];
     int      stack_depth;
 } ProfState;
 
@@ -68,13 +123,26 @@ extern ProfState prof;
 
 /* ── Fast-path inline helpers ────────────────────────────────────── */
 
+/* Charge cat for the time since *from, less the profiler's own cost */
+static inline void prof_charge(int cat, const prof_mark_t *from,
+                               const prof_mark_t *now, prof_tick_t overhead)
+{
+    prof_tick_t delta = now->t - from->t;
+    prof.ticks[cat] += (delta > overhead) ? delta - overhead : 0;
+#ifdef PROF_HAVE_CACHE_COUNTERS
+    prof.icache_miss[cat] += now->imiss - from->imiss;
+    prof.dcache_miss[cat] += now->dmiss - from->dmiss;
+#endif
+}
+
 /**
  * Push a new profiler category onto the stack.
  * Pauses the currently-active outer category (if any).
  */
 static inline void prof_push(int cat)
 {
-    clock_t now = clock();
+    prof_mark_t now;
+    prof_mark(&now);
     int d = prof.stack_depth;
     if (d >= 8) {
         printf("[PROF BUG] stack overflow! depth=%d pushing cat=%d\n", d, cat);
@@ -82,18 +150,17 @@ static inline void prof_push(int cat)
     }
     if (d > 0) {
         /* Pause outer category: accumulate its time so far */
-        int outer = prof.stack[d - 1];
-        clock_t delta = now - prof.stack_enter[d - 1];
-        if (delta < 0) {
-            printf("[PROF BUG] push: negative delta=%ld cat=%d outer=%d\n",
-                   (long)delta, cat, outer);
-        }
-        prof.ticks[outer] += delta;
+        prof_charge(prof.stack[d - 1], &prof.stack_enter[d - 1], &now,
+                    prof.overhead_outer);
     }
     prof.stack[d] = cat;
-    prof.stack_enter[d] = now;
     prof.stack_depth = d + 1;
     prof.calls[cat]++;
+    /* Taken last so the bookkeeping above isn't charged to cat */
+    prof_mark(&prof.stack_enter[d]);
+#ifdef ENABLE_TIMELINE_TRACE
+    timeline_record(TL_BEGIN, cat, prof.stack_enter[d].t);
+#endif
 }
 
 /**
@@ -102,7 +169,8 @@ static inline void prof_push(int cat)
  */
 static inline void prof_pop(int cat)
 {
-    clock_t now = clock();
+    prof_mark_t now;
+    prof_mark(&now);
     int d = prof.stack_depth - 1;
     if (d < 0) {
         printf("[PROF BUG] stack underflow! popping cat=%d\n", cat);
@@ -112,11 +180,10 @@ static inline void prof_pop(int cat)
         printf("[PROF BUG] pop mismatch! expected cat=%d got stack[%d]=%d\n",
                cat, d, prof.stack[d]);
     }
-    clock_t delta = now - prof.stack_enter[d];
-    if (delta < 0) {
-        printf("[PROF BUG] pop: negative delta=%ld cat=%d\n", (long)delta, cat);
-    }
-    prof.ticks[cat] += delta;
+    prof_charge(cat, &prof.stack_enter[d], &now, prof.overhead_self);
+#ifdef ENABLE_TIMELINE_TRACE
+    timeline_record(TL_END, cat, now.t);
+#endif
     prof.stack_depth = d;
     if (d > 0) {
         /* Resume outer category */
@@ -133,6 +200,8 @@ static inline void prof_pop(int cat)
 
 void profiler_init(void);
 void profiler_frame_end(uint64_t psx_cycles_this_frame);
+/* Exclusive time per category since profiler_init, in ms */
+void profiler_get_totals(double ms[PROF_NUM]);
 
 #else /* !ENABLE_SUBSYSTEM_PROFILER */
 
@@ -145,6 +214,11 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame);
 
 static inline void profiler_init(void) {}
 static inline void profiler_frame_end(uint64_t c) { (void)c; }
+static inline void profiler_get_totals(double ms[PROF_NUM])
+{
+    for (int i = 0; i < PROF_NUM; i++)
+        ms[i] = 0.0;
+}
 
 #endif /* ENABLE_SUBSYSTEM_PROFILER */
 
@@ -9,4 +9,8 @@ void DMA_Write(uint32_t addr, uint32_t data);
 /* Returns non-zero when a deferred DMA is in progress (for idle-skip suppression). */
 int DMA_IsPending(void);
 
+/* Clear CHCR bit24 and raise the DICR flag/IRQ of a channel whose
+ * transfer finished later than the CHCR write (MDEC_DMA1_Complete). */
+void DMA_CompleteChannel(int ch);
+
 #endif
@@ -5,6 +5,7 @@
 
 uint32_t SIO_Read(uint32_t phys);
 void SIO_Write(uint32_t phys, uint32_t data);
+void SIO_VBlank(void); /* re-poll the controllers at the next pad exchange */
 
 /* Exposed for JIT inline fast paths */
 extern uint32_t sio_data;
@@ -16,5 +17,6 @@ extern int sio_selected;
 extern int sio_irq_pending;
 extern int sio_ack_latch;
 extern volatile uint64_t sio_irq_delay_cycle;
+extern uint16_t sio_host_buttons; /* pad 1 as of its last poll (host hotkeys) */
 
 #endif
@@ -8,4 +8,19 @@ void Timers_Write(uint32_t addr, uint32_t data);
 void Timer_RefreshDividerCache(void);
 void Timer_ScheduleAll(void);
 
+/* Counter read for the JIT, published after every sync of a free-running
+ * timer (no sync mode, sysclock or sysclock/8).  While
+ * (u32)now - base < window the counter reads value + ((now - base) >> shift)
+ * with no target, overflow or IRQ side effect pending; window 0 means
+ * call Timers_Read. */
+typedef struct
+{
+    uint32_t base; /* low word of last_sync_cycle */
+    uint32_t window;
+    uint32_t value;
+    uint32_t shift;
+} TimerFast;
+
+extern TimerFast timer_fast[3];
+
 #endif
@@ -0,0 +1,113 @@
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * In-memory save states.
+ *
+ * Every subsystem serialises its state through one X_State(StateIO *)
+ * function used for both directions: state_io() copies a variable into
+ * the arena on save and back out of it on load, so save and load can't
+ * drift apart.  A pass with no buffer only measures, which is how the
+ * arena is sized at Snapshot_Init; there is no allocation afterwards.
+ *
+ * Snapshots never leave the process, so host pointers (scheduler
+ * callbacks, MDEC read pointers into RAM) are stored as they are.
+ */
+typedef struct
+{
+    uint8_t *buf; /* NULL: sizing pass */
+    uint32_t pos;
+    uint32_t size;
+    int load;     /* 1 = arena -> emulator */
+    int delta;    /* save into an arena holding the previous state,
+                   * logging the bytes each changed span replaces */
+} StateIO;
+
+/* Rewind log: called by a delta save before [pos, pos+n) is overwritten */
+void state_undo(StateIO *io, uint32_t pos, uint32_t n);
+
+static inline void state_io(StateIO *io, void *p, uint32_t n)
+{
+    if (io->buf && io->pos + n <= io->size)
+    {
+        if (io->load)
+            memcpy(p, io->buf + io->pos, n);
+        else if (!io->delta)
+            memcpy(io->buf + io->pos, p, n);
+        else if (memcmp(io->buf + io->pos, p, n) != 0)
+        {
+            state_undo(io, io->pos, n);
+            memcpy(io->buf + io->pos, p, n);
+        }
+    }
+    io->pos += n;
+}
+
+/* Next n arena bytes, for sections that compare before they copy on
+ * load (NULL on the sizing pass).  Saves go through state_io so delta
+ * saves see every byte. */
+static inline uint8_t *state_ptr(StateIO *io, uint32_t n)
+{
+    uint8_t *p = (io->buf && io->pos + n <= io->size) ? io->buf + io->pos : NULL;
+    io->pos += n;
+    return p;
+}
+
+#define STATE_VAR(io, v) state_io((io), (void *)&(v), (uint32_t)sizeof(v))
+
+/* ---- Per-subsystem sections (one per source file that owns the state) ---- */
+void CPU_State(StateIO *io);       /* cpu.c: R3000 + GTE registers */
+void Memory_State(StateIO *io);    /* memory.c: RAM, scratchpad, memory control */
+void Hardware_State(StateIO *io);  /* hardware.c */
+void Sched_State(StateIO *io);     /* scheduler.c */
+void Dynarec_State(StateIO *io);   /* dynarec_run.c: HBlank / frame position */
+void Timers_State(StateIO *io);
+void DMA_State(StateIO *io);
+void CDROM_State(StateIO *io);
+void CDXA_State(StateIO *io);
+void SPU_State(StateIO *io);
+void MDEC_State(StateIO *io);
+void GTE_State(StateIO *io);
+void SIO_State(StateIO *io);
+void MCD_State(StateIO *io);
+void GPU_State(StateIO *io);       /* gpu_commands.c: GPU registers + VRAM */
+void HLE_State(StateIO *io);       /* bios_hle.c */
+
+/* ---- Snapshot arena (savestate.c) ----
+ * Slots are sized and allocated once.  Save / load run at the main
+ * loop's next safe point (between chains, after the scheduler), so
+ * Snapshot_Request* may be called from anywhere, scheduler callbacks
+ * included.  Returns < 0 when the arena can't be allocated / the slot
+ * was never saved. */
+int Snapshot_Init(int slots);
+void Snapshot_RequestSave(int slot);
+void Snapshot_RequestLoad(int slot);
+extern volatile int snapshot_pending; /* checked by the dispatch loop */
+void Snapshot_Service(void);
+int Snapshot_Save(int slot);
+int Snapshot_Load(int slot);
+
+/* ---- Boot snapshot (savestate.c) ----
+ * The machine at the BIOS exe-load hook, written to a file keyed by the
+ * BIOS hash so later boots (boot_snapshot = 1) skip the BIOS init.  The
+ * header ties the file to the build, memory layout and boot-relevant
+ * config that wrote it, since sections keep host pointers.  Return < 0
+ * when there is no usable file / it can't be written. */
+int BootSnapshot_Load(void);
+int BootSnapshot_Save(void);
+
+/* ---- Rewind (savestate.c) ----
+ * One full image of the last rewind point plus a ring of undo records:
+ * each point logs only the spans that changed since the one before it,
+ * at the granularity the sections save in (4 KB RAM pages, 64-pixel
+ * VRAM row segments, 1 KB of SPU RAM, card sectors).  Stepping back
+ * applies the newest record to the image and loads it.  Rewind_Frame
+ * runs once per VBlank: it captures every rewind_interval frames and
+ * steps back while Select + L2 are held on pad 1. */
+int Rewind_Init(uint32_t ring_bytes);
+void Rewind_Frame(void);
+
+#endif /* SAVESTATE_H */
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "psx_timing.h"
+#include "timeline.h"
 
 /*
  * SuperPSX Event-Driven Scheduler
@@ -24,7 +25,9 @@
 #define SCHED_EVENT_CDROM_PENDING 7  /* Pending (2nd) response delivery      */
 #define SCHED_EVENT_HBLANK 8         /* Per-scanline HBlank event           */
 #define SCHED_EVENT_DMA 9            /* Deferred DMA completion event        */
-#define SCHED_EVENT_COUNT 10
+#define SCHED_EVENT_SPU 10           /* SPU mixing in fixed sample blocks    */
+#define SCHED_EVENT_MDEC 11          /* Sliced MDEC decode / DMA1 completion */
+#define SCHED_EVENT_COUNT 12
 
 /* ---- Callback type ---- */
 /* ticks_late = how many cycles past the scheduled deadline the event fired. */
@@ -35,6 +38,13 @@ extern int sched_active[SCHED_EVENT_COUNT];
 extern uint64_t sched_deadline[SCHED_EVENT_COUNT];
 extern sched_callback_t sched_callback[SCHED_EVENT_COUNT];
 
+/* ---- Active events as a binary min-heap on (deadline, id) ----
+ * sched_heap[0] is the earliest event; sched_heap_pos[id] is where id sits
+ * in the heap (valid while sched_active[id]).  Add/Remove are O(log n). */
+extern uint8_t sched_heap[SCHED_EVENT_COUNT];
+extern uint8_t sched_heap_pos[SCHED_EVENT_COUNT];
+extern int sched_heap_size;
+
 /* ---- Shared state (defined in scheduler.c) ---- */
 extern uint64_t global_cycles;
 extern uint32_t partial_block_cycles;
@@ -50,73 +60,135 @@ void Sched_Init(void);
 
 /* ---- Inline helpers ---- */
 
+/* Equal deadlines fire in ID order */
+static inline int sched_before(int a, int b)
+{
+    return sched_deadline[a] < sched_deadline[b] ||
+           (sched_deadline[a] == sched_deadline[b] && a < b);
+}
+
+static inline void sched_heap_set(int pos, int event_id)
+{
+    sched_heap[pos] = (uint8_t)event_id;
+    sched_heap_pos[event_id] = (uint8_t)pos;
+}
+
+static inline void sched_sift_up(int pos)
+{
+    int id = sched_heap[pos];
+    while (pos > 0)
+    {
+        int parent = (pos - 1) >> 1;
+        if (!sched_before(id, sched_heap[parent]))
+            break;
+        sched_heap_set(pos, sched_heap[parent]);
+        pos = parent;
+    }
+    sched_heap_set(pos, id);
+}
+
+static inline void sched_sift_down(int pos)
+{
+    int id = sched_heap[pos];
+    for (;;)
+    {
+        int child = 2 * pos + 1;
+        if (child >= sched_heap_size)
+            break;
+        if (child + 1 < sched_heap_size && sched_before(sched_heap[child + 1], sched_heap[child]))
+            child++;
+        if (!sched_before(sched_heap[child], id))
+            break;
+        sched_heap_set(pos, sched_heap[child]);
+        pos = child;
+    }
+    sched_heap_set(pos, id);
+}
+
 static inline void sched_recompute_cached(void)
 {
-    uint64_t earliest = UINT64_MAX;
-    int earliest_id = -1;
-    int i;
-    for (i = 0; i < SCHED_EVENT_COUNT; i++)
+    if (sched_heap_size > 0)
     {
-        if (sched_active[i] && sched_deadline[i] < earliest)
-        {
-            earliest = sched_deadline[i];
-            earliest_id = i;
-        }
+        sched_earliest_id = sched_heap[0];
+        sched_cached_earliest = sched_deadline[sched_earliest_id];
+    }
+    else
+    {
+        sched_earliest_id = -1;
+        sched_cached_earliest = UINT64_MAX;
+    }
+}
+
+/* Take an active event out of the heap (sched_active is left to the caller) */
+static inline void sched_heap_remove(int event_id)
+{
+    int pos = sched_heap_pos[event_id];
+    int last = sched_heap[--sched_heap_size];
+    if (last != event_id)
+    {
+        sched_heap_set(pos, last);
+        sched_sift_up(pos);
+        sched_sift_down(sched_heap_pos[last]);
     }
-    sched_cached_earliest = earliest;
-    sched_earliest_id = earliest_id;
 }
 
 static inline void Sched_Add(int event_id, uint64_t absolute_cycle,
                                            sched_callback_t cb)
 {
-    int was_earliest = (event_id == sched_earliest_id);
+    uint64_t old = sched_deadline[event_id];
 
-    sched_active[event_id] = 1;
     sched_deadline[event_id] = absolute_cycle;
     sched_callback[event_id] = cb;
 
-    if (absolute_cycle <= sched_cached_earliest)
+    if (!sched_active[event_id])
     {
-        sched_cached_earliest = absolute_cycle;
-        sched_earliest_id = event_id;
-    }
-    else if (was_earliest)
-    {
-        /* We just pushed the earliest event further into the future;
-         * we must re-scan to find the new true earliest. */
-        sched_recompute_cached();
+        sched_active[event_id] = 1;
+        sched_heap_set(sched_heap_size++, event_id);
+        sched_sift_up(sched_heap_pos[event_id]);
     }
+    else if (absolute_cycle < old)
+        sched_sift_up(sched_heap_pos[event_id]);
+    else
+        sched_sift_down(sched_heap_pos[event_id]);
+
+    sched_recompute_cached();
 }
 
 static inline void Sched_Remove(int event_id)
 {
-    int was_earliest = (event_id == sched_earliest_id);
+    if (!sched_active[event_id])
+        return;
     sched_active[event_id] = 0;
-
-    if (was_earliest)
-        sched_recompute_cached();
+    sched_heap_remove(event_id);
+    sched_recompute_cached();
 }
 
+/*
+ * Fire every event due by current_cycle, earliest first.  At most
+ * SCHED_EVENT_COUNT callbacks per call, so an event that keeps
+ * rescheduling itself into the past can't spin here; what is still due
+ * stays at the heap top for the next call.
+ */
 static inline void Sched_Tick(uint64_t current_cycle)
 {
-    int i;
-    int needed_recompute = 0;
-    for (i = 0; i < SCHED_EVENT_COUNT; i++)
+    int n;
+    for (n = 0; n < SCHED_EVENT_COUNT && sched_heap_size > 0; n++)
     {
-        if (sched_active[i] && sched_deadline[i] <= current_cycle)
-        {
-            if (i == sched_earliest_id)
-                needed_recompute = 1;
+        int id = sched_heap[0];
+        if (sched_deadline[id] > current_cycle)
+            break;
 
-            int ticks_late = (int)(current_cycle - sched_deadline[i]);
-            sched_active[i] = 0;
-            if (sched_callback[i])
-                sched_callback[i](ticks_late);
+        int ticks_late = (int)(current_cycle - sched_deadline[id]);
+        sched_active[id] = 0;
+        sched_heap_remove(id);
+        sched_recompute_cached();
+        if (sched_callback[id])
+        {
+            TIMELINE_SCHED_BEGIN(id);
+            sched_callback[id](ticks_late);
+            TIMELINE_SCHED_END(id);
         }
     }
-    if (needed_recompute)
-        sched_recompute_cached();
 }
 
 #endif /* SCHEDULER_H */
@@ -18,6 +18,11 @@ void SPU_FlushAudio(void);
 void SPU_CatchUp(void);
 void SPU_FrameStart(void);
 int SPU_IsInitialized(void);
+int SPU_OutputRate(void); /* audio_rate: 44100, 32000 or 22050 */
+/* Threaded output (audio_latency): frames queued ahead of the hardware
+ * (-1 when output is synchronous) and underruns since startup */
+int SPU_OutputQueued(void);
+uint32_t SPU_OutputUnderruns(void);
 
 #ifdef __cplusplus
 }
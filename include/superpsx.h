@@ -7,7 +7,11 @@
 #include "scheduler.h"
 
 /*=== Debug logging macro ===*/
-#ifdef ENABLE_DEBUG_LOG
+#if defined(ENABLE_DEBUG_LOG) && defined(ENABLE_LOG_RING)
+#include "log_ring.h"
+#define DLOG(fmt, ...) log_ring_printf(LOG_DEST_STDOUT, "[" LOG_TAG "] " fmt, ##__VA_ARGS__)
+#define DLOG_RAW(fmt, ...) log_ring_printf(LOG_DEST_STDOUT, fmt, ##__VA_ARGS__)
+#elif defined(ENABLE_DEBUG_LOG)
 #define DLOG(fmt, ...) printf("[" LOG_TAG "] " fmt, ##__VA_ARGS__)
 #define DLOG_RAW(fmt, ...) printf(fmt, ##__VA_ARGS__)
 #else
@@ -93,10 +97,34 @@ extern R3000CPU cpu;
 extern uint8_t *psx_ram;
 extern uint8_t *psx_bios;
 extern uint8_t scratchpad_buf[];
-extern uint8_t **mem_lut;
 extern uint32_t psx_tlb_base; /* 0x20000000 if TLB active, 0 otherwise */
 
-#define MEM_LUT_SIZE 65536
+/* Memory map for host-side fast paths (interpreter fetch).  The segment
+ * bits are folded off like translate_addr, then one byte per 4 MB of
+ * physical space picks a region: RAM with its mirrors up to 8 MB, BIOS,
+ * or none (I/O, scratchpad, unmapped).  128 bytes plus three regions,
+ * filled by Init_MemoryLUT. */
+#define MEM_REGION_SHIFT 22
+#define MEM_REGION_SLOTS (0x20000000u >> MEM_REGION_SHIFT)
+
+typedef struct
+{
+    uint8_t *base;
+    uint32_t mask;  /* offset mask: the region's mirror size - 1 */
+    uint32_t limit; /* first offset in the 4 MB slot past the region */
+} MemRegion;
+
+extern uint8_t mem_region_map[MEM_REGION_SLOTS];
+extern MemRegion mem_regions[3];
+
+/* Host pointer for a RAM/BIOS address, NULL for anything else */
+static inline uint8_t *mem_host(uint32_t addr)
+{
+    uint32_t phys = addr & 0x1FFFFFFF;
+    const MemRegion *r = &mem_regions[mem_region_map[phys >> MEM_REGION_SHIFT]];
+    uint32_t off = phys & ((1u << MEM_REGION_SHIFT) - 1);
+    return off < r->limit ? r->base + (off & r->mask) : NULL;
+}
 
 void Init_Memory(void);
 void Init_MemoryLUT(void);
@@ -114,6 +142,12 @@ uint32_t ReadHardware(uint32_t phys);
 /* size: access width in bytes (1, 2, or 4).  Used by the SPU handler to
  * decide whether to write one or two consecutive 16-bit registers. */
 void WriteHardware(uint32_t phys, uint32_t data, int size);
+/* Per-register I/O handlers (table-driven, 16-byte granules) */
+typedef uint32_t (*HwReadFn)(uint32_t phys);
+typedef void (*HwWriteFn)(uint32_t phys, uint32_t data, int size);
+void Init_HardwareTable(void);
+HwReadFn hw_read_handler(uint32_t phys);   /* NULL outside 0x1F801000-0x1F801FFF */
+HwWriteFn hw_write_handler(uint32_t phys);
 void SignalInterrupt(uint32_t irq);
 void Init_Interrupts(void);
 static inline int CheckInterrupts(void)
@@ -133,13 +167,96 @@ uint32_t GTE_ReadCtrl(R3000CPU *cpu, int reg);
 void GTE_WriteCtrl(R3000CPU *cpu, int reg, uint32_t val);
 void GTE_VBlankUpdate(void);
 
+/* Cycle cost model (dynarec_cost.c), shared by the JIT and interpreter */
+extern uint32_t jit_cost_scale; /* cycle_scale in 1/256 units (256 = 100%) */
+uint32_t jit_cost_insn(uint32_t opcode, uint32_t psx_pc, int addr_known, uint32_t addr);
+void jit_cost_refresh(const uint32_t *mem_ctrl); /* words from 0x1F801000, NULL = reset */
+/* Apply jit_cost_scale, carrying the fraction in *frac */
+static inline uint32_t jit_cost_scaled(uint32_t cost, uint32_t *frac)
+{
+    uint32_t fx = cost * jit_cost_scale + *frac;
+    *frac = fx & 255;
+    return fx >> 8;
+}
+
+/* GTE accuracy tiers (gte_accuracy in superpsx.ini):
+ *   EXACT: gte.c semantics, full FLAG
+ *   FAST:  VU0/VFPU inline paths, FLAG left 0
+ *   ULTRA: FAST plus a float RTPS divide (no UNR rounding or h>=2*SZ3
+ *          overflow case) and no lm=0 IR saturation */
+#define GTE_TIER_EXACT 0
+#define GTE_TIER_FAST  1
+#define GTE_TIER_ULTRA 2
+
 /* VU0 fast-path state (flag-read detection) */
 extern int gte_flag_read_count;
 extern int gte_use_vu0;
+extern int gte_tier; /* GTE_TIER_*, refreshed every VBlank from psx_config */
+int GTE_ConfigTier(void);
 #ifdef PLATFORM_PSP
 extern int gte_use_vfpu;
 #endif
 
+/* GTE command stream (gte_record): a GTEStreamHeader, then one
+ * GTEStreamRecord per COP2 command until EOF.  Registers are the raw
+ * cp2_data/cp2_ctrl words before the command ran. */
+#define GTE_STREAM_MAGIC   0x52455447 /* "GTER" */
+#define GTE_STREAM_VERSION 1
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+} GTEStreamHeader;
+typedef struct
+{
+    uint32_t opcode;
+    uint32_t data[32];
+    uint32_t ctrl[32];
+} GTEStreamRecord;
+
+extern int gte_record_active; /* JIT emits a GTE_Record call per command */
+void GTE_RecordInit(void);
+void GTE_Record(R3000CPU *cpu, uint32_t opcode);
+GTEStreamRecord *GTE_StreamLoad(const char *path, int *count);
+
+/* Decoded GTE matrix cache: RT/LLM/LCM as int16 (row-major m11..m33) and
+ * TR/BK/FC as int32, shared by the C commands and, through their own
+ * refresh functions, the VU0 (PS2) and VFPU (PSP) float caches.
+ * CTC2 marks the touched matrix dirty in both byte lanes; each cache
+ * clears its own lane when it re-decodes.  Code that writes cp2_ctrl
+ * directly must set gte_matrix_dirty.all = GTE_MTX_DIRTY_ALL. */
+#define GTE_MTX_RT 0x01 /* ctrl 0-7: RT + TR */
+#define GTE_MTX_LL 0x02 /* ctrl 8-12 */
+#define GTE_MTX_BK 0x04 /* ctrl 13-15 */
+#define GTE_MTX_LC 0x08 /* ctrl 16-20 */
+#define GTE_MTX_FC 0x10 /* ctrl 21-23 */
+#define GTE_MTX_DIRTY_ALL 0x1F1F
+typedef union {
+    uint16_t all;
+    uint8_t lane[2]; /* [0] = C cache, [1] = VU0/VFPU float cache */
+} GTEMatrixDirty;
+extern GTEMatrixDirty gte_matrix_dirty;
+#define vu0_matrix_dirty (gte_matrix_dirty.lane[1])
+
+typedef struct {
+    int16_t m[3][9];  /* [0]=RT, [1]=LLM, [2]=LCM */
+    int32_t tr[3][3]; /* [0]=TR, [1]=BK, [2]=FC */
+} GTEMatrixCache;
+
+/* ctrl register -> GTE_MTX_* bit (0 for regs 24-31) */
+static inline uint8_t gte_ctrl_matrix_bit(int reg)
+{
+    if (reg <= 7)  return GTE_MTX_RT;
+    if (reg <= 12) return GTE_MTX_LL;
+    if (reg <= 15) return GTE_MTX_BK;
+    if (reg <= 20) return GTE_MTX_LC;
+    if (reg <= 23) return GTE_MTX_FC;
+    return 0;
+}
+const GTEMatrixCache *GTE_Matrices(R3000CPU *cpu);
+
 /* VU0 JIT cache: contiguous layout so LQC2 can use base+offset.
  * Populated by vu0_prepare_mvmva() before each VU0 matrix multiply.
  * All arrays are 16-byte aligned for LQC2/SQC2 compatibility. */
@@ -158,6 +275,8 @@ void vu0_prepare_mvmva(R3000CPU *cpu, uint32_t mx_cv);
 void GTE_Inline_RTPS(R3000CPU *cpu, int sf, int lm);
 void GTE_RTPS_Project(R3000CPU *cpu, int last); /* division + screen proj for JIT inline */
 extern const uint8_t gte_unr_table[0x101]; /* UNR division table for inline RTPS */
+#define GTE_UNR_RECIP_SIZE 0x800
+extern const uint32_t gte_unr_recip[GTE_UNR_RECIP_SIZE]; /* UNR reciprocals, SZ3 < 0x1000 */
 void GTE_Inline_NCLIP(R3000CPU *cpu);
 void GTE_Inline_OP(R3000CPU *cpu, int sf, int lm);
 void GTE_Inline_DPCS(R3000CPU *cpu, int sf, int lm);
@@ -179,6 +298,18 @@ void GTE_Inline_RTPT(R3000CPU *cpu, int sf, int lm);
 void GTE_Inline_GPF(R3000CPU *cpu, int sf, int lm);
 void GTE_Inline_GPL(R3000CPU *cpu, int sf, int lm);
 void GTE_Inline_NCCT(R3000CPU *cpu, int sf, int lm);
+void GTE_Inline_NoFlag(R3000CPU *cpu, uint32_t opcode);
+
+/* Batched command runs (gte_vu1_batch): the JIT queues RTPS/RTPT/NCDS/
+ * NCDT/NCCS/NCCT with their V0-V2/RGBC inputs, GTE_BatchFlush replays
+ * them in order before the next GTE read */
+#define GTE_BATCH_MAX 16
+typedef struct {
+    uint32_t opcode;
+    uint32_t in[7];   /* cp2_data[0..6] (VXY0..VZ2, RGBC) when queued */
+} GTEBatchEntry;
+extern GTEBatchEntry gte_batch[GTE_BATCH_MAX];
+void GTE_BatchFlush(R3000CPU *cpu, int count);
 
 /*=== CPU Helper Functions (called from dynarec) ===*/
 uint32_t Helper_LWL(uint32_t addr, uint32_t cur_rt);
@@ -193,6 +324,7 @@ void Init_CPU(void);
 void PSX_Exception(uint32_t cause_code);
 void Handle_Syscall(void);
 void Helper_Syscall_Exception(uint32_t pc);
+int Helper_Syscall_HLE(uint32_t pc); /* dynarec_insn.c, bios_hle only */
 void Helper_Break_Exception(uint32_t pc);
 void Helper_CU_Exception(uint32_t pc, uint32_t cop_num);
 void Helper_ADD(uint32_t rs_val, uint32_t rt_val, uint32_t rd, uint32_t pc);
@@ -216,6 +348,39 @@ void CDROM_Write(uint32_t addr, uint32_t data);
  * Checked inline in dynarec loop for cheap level-triggered re-assertion. */
 extern uint8_t cdrom_irq_active;
 
+/* XA-ADPCM streaming (cdrom_xa.c): sectors queued by the CD-ROM read
+ * path, decoded ahead and mixed as the SPU CD input */
+void CDXA_Reset(void);
+void CDXA_PushSector(const uint8_t *subheader);
+void CDXA_SetOutputRate(int rate);
+void CDXA_SetVolume(uint8_t ll, uint8_t lr, uint8_t rl, uint8_t rr);
+void CDXA_SetMute(int muted);
+void CDXA_Mix(int32_t *ml, int32_t *mr, int n, int32_t vol_l, int32_t vol_r);
+/* Attenuation matrix and mute folded with the SPU CD volume: 1.14 gains
+ * L->L, L->R, R->L, R->R (CD-DA mixes through them too) */
+void CDXA_Gains(int32_t vol_l, int32_t vol_r, int32_t *g);
+
+/* CD-DA playback (cdrom_cdda.c): raw audio sectors from image LBA on,
+ * read in large chunks by CDDA_Fill (the read-ahead thread, or CDDA_Mix
+ * without one) and mixed as the SPU CD input */
+void CDDA_Play(uint32_t lba);
+void CDDA_Stop(void);
+int CDDA_Fill(void); /* one chunk if the ring has room for it; 1 if read */
+void CDDA_SetOutputRate(int rate);
+void CDDA_Mix(int32_t *ml, int32_t *mr, int n, int32_t vol_l, int32_t vol_r);
+
+/* CD-ROM read-ahead thread (cdrom_io.c, cdrom_async): file LBAs are
+ * prefetched from CDIO_Seek on; the reads have the ISO_Read* contract and
+ * fall through to them while the thread isn't running */
+int CDIO_Start(void);
+int CDIO_Active(void);
+void CDIO_Seek(uint32_t lba);
+void CDIO_Stop(void);
+int CDIO_Ready(uint32_t lba);
+int CDIO_ReadSector(uint32_t lba, uint8_t *buf);
+int CDIO_ReadSectorRaw(uint32_t lba, uint8_t *buf);
+void CDIO_Wake(void); /* CDDA: ring space freed or a new stream */
+
 /* GPU (IRQ1) deferred interrupt support.
  * On real PSX hardware the GPU command FIFO is processed asynchronously:
  * writing GP0(1Fh) puts the "Interrupt Request" command in the FIFO, and the
@@ -238,6 +403,7 @@ void GPU_WriteGP1(uint32_t data);
 uint32_t GPU_Read(void);
 uint32_t GPU_ReadStatus(void);
 void GPU_VBlank(void);
+void GPU_OSDVBlank(void); /* FPS overlay accounting, main thread */
 void GPU_Flush(void);
 int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr);
 
@@ -0,0 +1,67 @@
+/**
+ * timeline.h — Per-event timeline ring buffer, exported as Chrome trace
+ *
+ * Records a begin/end event for every profiler category push/pop, every
+ * scheduler callback (by event ID) and a marker at each VBlank, so
+ * single-frame spikes show up where profile.log only has averages.
+ * Select + R2 on pad 1 writes the ring as Chrome-trace JSON (opens in
+ * Perfetto / chrome://tracing) at the end of the frame.
+ *
+ * Compiled only when ENABLE_TIMELINE_TRACE is defined (CMake option);
+ * timestamps come from the subsystem profiler's prof_now().
+ */
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <stdint.h>
+
+#ifdef ENABLE_TIMELINE_TRACE
+
+#ifndef ENABLE_SUBSYSTEM_PROFILER
+#error "ENABLE_TIMELINE_TRACE needs ENABLE_SUBSYSTEM_PROFILER"
+#endif
+
+#define TIMELINE_EVENTS (1 << 17) /* power of 2; 8 bytes each (1 MB) */
+
+enum {
+    TL_BEGIN = 0,  /* id = ProfCategory */
+    TL_END,
+    TL_SCHED_BEGIN, /* id = SCHED_EVENT_* */
+    TL_SCHED_END,
+    TL_VBLANK       /* id = frame number (low 16 bits) */
+};
+
+typedef struct {
+    uint32_t ts; /* prof_now() ticks */
+    uint16_t type;
+    uint16_t id;
+} TimelineEvent;
+
+extern TimelineEvent timeline_buf[TIMELINE_EVENTS];
+extern uint32_t timeline_pos; /* events ever recorded */
+
+static inline void timeline_record(int type, int id, uint32_t ts)
+{
+    TimelineEvent *e = &timeline_buf[timeline_pos++ & (TIMELINE_EVENTS - 1)];
+    e->ts = ts;
+    e->type = (uint16_t)type;
+    e->id = (uint16_t)id;
+}
+
+void timeline_sched(int type, int id); /* stamps with prof_now() */
+void timeline_frame(void);             /* every VBlank: marker, hotkey, deferred dump */
+void timeline_trigger_dump(const char *path);
+
+#define TIMELINE_SCHED_BEGIN(id) timeline_sched(TL_SCHED_BEGIN, (id))
+#define TIMELINE_SCHED_END(id)   timeline_sched(TL_SCHED_END, (id))
+
+#else
+
+#define TIMELINE_SCHED_BEGIN(id) ((void)0)
+#define TIMELINE_SCHED_END(id)   ((void)0)
+
+static inline void timeline_frame(void) {}
+static inline void timeline_trigger_dump(const char *p) { (void)p; }
+
+#endif /* ENABLE_TIMELINE_TRACE */
+#endif /* TIMELINE_H */
@@ -0,0 +1,80 @@
+/**
+ * audio_ring.c — SPSC sample ring shared by the audio backends
+ */
+#include "audio_ring.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Orders the sample copy against the index update that publishes it */
+#define RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+int AudioRing_Init(AudioRing *r, uint32_t min_frames)
+{
+    uint32_t cap = 256;
+    while (cap < min_frames)
+        cap <<= 1;
+    memset(r, 0, sizeof(*r));
+    r->buf = (int16_t *)malloc((size_t)cap * 2 * sizeof(int16_t));
+    if (!r->buf)
+        return -1;
+    r->capacity = cap;
+    return 0;
+}
+
+void AudioRing_Free(AudioRing *r)
+{
+    free(r->buf);
+    memset(r, 0, sizeof(*r));
+}
+
+/* Copy frames between the linear buffer and the ring at index pos */
+static void ring_copy(const AudioRing *r, uint32_t pos, int16_t *ring_side,
+                      int16_t *lin, int frames, int to_ring)
+{
+    uint32_t at = pos & (r->capacity - 1);
+    uint32_t first = r->capacity - at;
+    if (first > (uint32_t)frames)
+        first = (uint32_t)frames;
+    size_t b1 = (size_t)first * 2 * sizeof(int16_t);
+    size_t b2 = (size_t)(frames - (int)first) * 2 * sizeof(int16_t);
+    if (to_ring)
+    {
+        memcpy(ring_side + at * 2, lin, b1);
+        memcpy(ring_side, lin + first * 2, b2);
+    }
+    else
+    {
+        memcpy(lin, ring_side + at * 2, b1);
+        memcpy(lin + first * 2, ring_side, b2);
+    }
+}
+
+int AudioRing_Write(AudioRing *r, const int16_t *src, int frames)
+{
+    uint32_t room = r->capacity - AudioRing_Fill(r);
+    if ((uint32_t)frames > room)
+    {
+        r->overruns++;
+        frames = (int)room;
+    }
+    if (frames <= 0)
+        return 0;
+    ring_copy(r, r->wr, r->buf, (int16_t *)src, frames, 1);
+    RING_BARRIER();
+    r->wr += (uint32_t)frames;
+    return frames;
+}
+
+int AudioRing_Read(AudioRing *r, int16_t *dst, int frames)
+{
+    uint32_t fill = AudioRing_Fill(r);
+    if ((uint32_t)frames > fill)
+        frames = (int)fill;
+    if (frames <= 0)
+        return 0;
+    RING_BARRIER();
+    ring_copy(r, r->rd, r->buf, dst, frames, 0);
+    RING_BARRIER();
+    r->rd += (uint32_t)frames;
+    return frames;
+}
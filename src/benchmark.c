@@ -0,0 +1,302 @@
+/**
+ * benchmark.c — Deterministic benchmark runs and pad input replay
+ *
+ * Input files hold one record per change of a port's pad response:
+ * { uint32 frame, uint8 port, uint8 len, uint8 resp[20] } after an
+ * "SPXI" + version header.  Frames count VBlanks since boot, which is
+ * what makes a replay line up with the run that recorded it.
+ */
+#include "benchmark.h"
+#include "superpsx.h"
+#include "config.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include "memorycard.h"
+#include "gpu_backend.h"
+#include "dynarec.h" /* jit_compile_total */
+#undef LOG_TAG
+#include "gpu_state.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define INPUT_MAGIC "SPXI"
+#define INPUT_VERSION 1
+#define INPUT_RESP_MAX 20
+#define BENCH_REPORT "bench.json"
+#define BENCH_MAX_HASHES 256
+
+typedef struct
+{
+    uint32_t frame;
+    uint8_t port;
+    uint8_t len;
+    uint8_t resp[INPUT_RESP_MAX];
+} InputRecord; /* 26 bytes on disk, written field by field */
+
+int bench_active = 0;
+
+static uint32_t bench_frame = 0; /* VBlanks since boot */
+
+/* ---- Input record / replay ---- */
+static FILE *input_rec_file = NULL;
+static uint8_t input_rec_resp[2][INPUT_RESP_MAX];
+static int input_rec_len[2] = {-1, -1};
+
+static FILE *input_play_file = NULL;
+static InputRecord input_next; /* read ahead; frame = UINT32_MAX at EOF */
+static uint8_t input_play_resp[2][INPUT_RESP_MAX];
+static int input_play_len[2] = {0, 0};
+
+/* ---- Measurement ---- */
+static uint32_t *bench_us = NULL; /* per measured frame */
+static uint32_t bench_count = 0;
+static clock_t bench_start, bench_last;
+static uint64_t bench_start_cycles;
+static uint32_t bench_start_compiles;
+static double bench_start_prof[PROF_NUM];
+static struct
+{
+    uint32_t frame, hash;
+} bench_hash[BENCH_MAX_HASHES];
+static int bench_hash_count = 0;
+
+static int input_read(FILE *f, InputRecord *r)
+{
+    uint8_t b[6];
+    if (fread(b, 1, 6, f) != 6 || fread(r->resp, 1, INPUT_RESP_MAX, f) != INPUT_RESP_MAX)
+        return 0;
+    r->frame = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+    r->port = b[4];
+    r->len = b[5];
+    return r->port < 2 && r->len <= INPUT_RESP_MAX;
+}
+
+static void input_write(FILE *f, const InputRecord *r)
+{
+    uint8_t b[6] = {(uint8_t)r->frame, (uint8_t)(r->frame >> 8),
+                    (uint8_t)(r->frame >> 16), (uint8_t)(r->frame >> 24),
+                    r->port, r->len};
+    fwrite(b, 1, 6, f);
+    fwrite(r->resp, 1, INPUT_RESP_MAX, f);
+}
+
+static void input_advance(void)
+{
+    if (!input_read(input_play_file, &input_next))
+        input_next.frame = UINT32_MAX;
+}
+
+int Bench_PadReplay(int port, uint8_t *resp, int *len)
+{
+    if (!input_play_file)
+        return 0;
+    while (input_next.frame <= bench_frame)
+    {
+        memcpy(input_play_resp[input_next.port], input_next.resp, INPUT_RESP_MAX);
+        input_play_len[input_next.port] = input_next.len;
+        input_advance();
+    }
+    if (!input_play_len[port])
+        return 0; /* never recorded: the live pad */
+    memcpy(resp, input_play_resp[port], (size_t)input_play_len[port]);
+    *len = input_play_len[port];
+    return 1;
+}
+
+void Bench_PadRecord(int port, const uint8_t *resp, int len)
+{
+    if (!input_rec_file || len > INPUT_RESP_MAX)
+        return;
+    if (len == input_rec_len[port] && memcmp(resp, input_rec_resp[port], (size_t)len) == 0)
+        return;
+
+    InputRecord r;
+    memset(&r, 0, sizeof(r));
+    r.frame = bench_frame;
+    r.port = (uint8_t)port;
+    r.len = (uint8_t)len;
+    memcpy(r.resp, resp, (size_t)len);
+    input_write(input_rec_file, &r);
+    fflush(input_rec_file);
+
+    memcpy(input_rec_resp[port], resp, (size_t)len);
+    input_rec_len[port] = len;
+}
+
+void Bench_Init(void)
+{
+    if (psx_config.gpu_trace_bench[0])
+        Bench_GpuTrace(psx_config.gpu_trace_bench); /* does not return */
+
+    if (psx_config.input_play[0])
+    {
+        char magic[4];
+        uint8_t ver[4];
+        input_play_file = fopen(psx_config.input_play, "rb");
+        if (input_play_file &&
+            (fread(magic, 1, 4, input_play_file) != 4 || memcmp(magic, INPUT_MAGIC, 4) != 0 ||
+             fread(ver, 1, 4, input_play_file) != 4 || ver[0] != INPUT_VERSION))
+        {
+            fclose(input_play_file);
+            input_play_file = NULL;
+        }
+        if (input_play_file)
+        {
+            input_advance();
+            printf("[BENCH] Replaying input from %s\n", psx_config.input_play);
+        }
+        else
+            printf("[BENCH] Can't replay %s (missing or not an input file)\n", psx_config.input_play);
+    }
+    else if (psx_config.input_record[0])
+    {
+        static const uint8_t ver[4] = {INPUT_VERSION, 0, 0, 0};
+        input_rec_file = fopen(psx_config.input_record, "wb");
+        if (input_rec_file)
+        {
+            fwrite(INPUT_MAGIC, 1, 4, input_rec_file);
+            fwrite(ver, 1, 4, input_rec_file);
+            printf("[BENCH] Recording input to %s\n", psx_config.input_record);
+        }
+        else
+            printf("[BENCH] Can't create %s\n", psx_config.input_record);
+    }
+
+    if (psx_config.bench_frames <= 0)
+        return;
+    bench_us = (uint32_t *)malloc((size_t)psx_config.bench_frames * sizeof(uint32_t));
+    if (!bench_us)
+    {
+        printf("[BENCH] Out of memory for %d frame times\n", psx_config.bench_frames);
+        return;
+    }
+    bench_active = 1;
+    /* Unthrottled, every frame drawn, SPU mixed but not played */
+    sched_unlimited_speed = 1;
+    /* Late-sector delays depend on the host disc thread's timing */
+    if (psx_config.cdrom_async == 2)
+        psx_config.cdrom_async = 1;
+    printf("[BENCH] %d frames after %d warm-up frames\n",
+           psx_config.bench_frames, psx_config.bench_warmup);
+}
+
+/* FNV-1a over the whole shadow VRAM, synced with the renderer first */
+static uint32_t bench_vram_hash(void)
+{
+    uint32_t h = 2166136261u;
+
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
+    if (!psx_vram_shadow)
+        return 0;
+    GPU_Backend_VRAMReadback(0, 0, PSX_VRAM_WIDTH, PSX_VRAM_HEIGHT);
+    GPU_Backend_VRAMReadbackResolve();
+    const uint8_t *p = (const uint8_t *)psx_vram_shadow;
+    for (uint32_t i = 0; i < PSX_VRAM_WIDTH * PSX_VRAM_HEIGHT * 2; i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_report(void)
+{
+    clock_t end = clock();
+    double wall_ms = (double)(end - bench_start) * 1000.0 / CLOCKS_PER_SEC;
+    double prof_ms[PROF_NUM];
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < bench_count; i++)
+        sum += bench_us[i];
+    qsort(bench_us, bench_count, sizeof(uint32_t), cmp_u32);
+    profiler_get_totals(prof_ms);
+
+    FILE *f = fopen(BENCH_REPORT, "w");
+    if (!f)
+    {
+        printf("[BENCH] Can't write %s\n", BENCH_REPORT);
+        return;
+    }
+    fprintf(f, "{\n");
+    fprintf(f, "  \"frames\": %u,\n", (unsigned)bench_count);
+    fprintf(f, "  \"warmup\": %d,\n", psx_config.bench_warmup);
+    fprintf(f, "  \"input\": \"%s\",\n", input_play_file ? psx_config.input_play : "");
+    fprintf(f, "  \"wall_ms\": %.1f,\n", wall_ms);
+    fprintf(f, "  \"fps\": %.2f,\n", wall_ms > 0 ? bench_count * 1000.0 / wall_ms : 0.0);
+    fprintf(f, "  \"frame_ms\": {\"min\": %.3f, \"avg\": %.3f, \"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+            bench_us[0] / 1000.0, (double)sum / bench_count / 1000.0,
+            bench_us[bench_count / 2] / 1000.0,
+            bench_us[(uint32_t)((uint64_t)bench_count * 99 / 100)] / 1000.0,
+            bench_us[bench_count - 1] / 1000.0);
+    fprintf(f, "  \"psx_cycles_per_frame\": %.0f,\n",
+            (double)(global_cycles - bench_start_cycles) / bench_count);
+    fprintf(f, "  \"jit_compiles\": %u,\n", (unsigned)(jit_compile_total - bench_start_compiles));
+#ifdef ENABLE_SUBSYSTEM_PROFILER
+    fprintf(f, "  \"profile_ms\": {");
+    for (int i = 0; i < PROF_NUM; i++)
+        fprintf(f, "%s\n    \"%s\": %.1f", i ? "," : "", prof_category_names[i],
+                prof_ms[i] - bench_start_prof[i]);
+    fprintf(f, "\n  },\n");
+#endif
+    fprintf(f, "  \"vram_hash\": [");
+    for (int i = 0; i < bench_hash_count; i++)
+        fprintf(f, "%s\n    {\"frame\": %u, \"fnv1a\": \"%08x\"}", i ? "," : "",
+                (unsigned)bench_hash[i].frame, (unsigned)bench_hash[i].hash);
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+
+    printf("[BENCH] %u frames in %.0f ms (%.1f fps, p99 %.2f ms), report in %s\n",
+           (unsigned)bench_count, wall_ms, wall_ms > 0 ? bench_count * 1000.0 / wall_ms : 0.0,
+           bench_us[(uint32_t)((uint64_t)bench_count * 99 / 100)] / 1000.0, BENCH_REPORT);
+}
+
+void Bench_Frame(void)
+{
+    bench_frame++;
+    if (!bench_active)
+        return;
+
+    uint32_t warm = (uint32_t)psx_config.bench_warmup;
+    clock_t now = clock();
+    if (bench_frame == warm + 1)
+    {
+        bench_start = bench_last = now;
+        bench_start_cycles = global_cycles;
+        bench_start_compiles = jit_compile_total;
+        profiler_get_totals(bench_start_prof);
+        return;
+    }
+    if (bench_frame <= warm)
+        return;
+
+    bench_us[bench_count++] = (uint32_t)((uint64_t)(now - bench_last) * 1000000 / CLOCKS_PER_SEC);
+    bench_last = now;
+
+    int done = bench_count >= (uint32_t)psx_config.bench_frames;
+    int step = psx_config.bench_vram_hash;
+    if (step && (bench_count % (uint32_t)step == 0 || done))
+    {
+        if (bench_hash_count < BENCH_MAX_HASHES)
+        {
+            bench_hash[bench_hash_count].frame = bench_frame;
+            bench_hash[bench_hash_count].hash = bench_vram_hash();
+            bench_hash_count++;
+        }
+        /* The readback isn't part of the next frame */
+        bench_last = clock();
+    }
+    if (!done)
+        return;
+
+    bench_report();
+    MCD_Flush();
+    printf("=== Benchmark Ended ===\n");
+    fflush(stdout);
+    exit(0);
+}
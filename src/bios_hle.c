@@ -0,0 +1,533 @@
+/*
+ * bios_hle.c - High-level emulation of hot BIOS library calls
+ *
+ * The A(xx)/B(xx) library routines run byte-by-byte out of uncached ROM,
+ * so memcpy/bzero/strlen and the heap/event helpers show up as large
+ * BIOS-ROM hotspots.  BIOS_HLE_Library() replaces them with native C
+ * when psx_config.bios_hle is set.  It is called from the A0/B0 vector
+ * hooks (BIOS_HLE_A/B, injected by compile_block and the interpreter).
+ *
+ * Each handler keeps the BIOS register contract (arguments in a0..a3,
+ * result in v0, return via ra) and returns the approximate number of
+ * cycles the ROM routine would have taken, so emulated timing stays
+ * close to the real kernel.  A return of 0 means "not handled": the
+ * call falls through to the ROM implementation unchanged.  Anything
+ * outside main RAM, overlapping in a way the byte loop would smear, or
+ * touching state the BIOS owns (callback events, a heap set up before
+ * HLE was active) takes that path.
+ *
+ * BIOS_HLE_Syscall() does the same for SYSCALL(1)/SYSCALL(2), the
+ * Enter/ExitCriticalSection pair, as long as the RAM exception handler
+ * still hashes to what the BIOS installed.
+ */
+#include <string.h>
+#include "superpsx.h"
+#include "config.h"
+#include "dynarec.h"
+#include "savestate.h"
+
+#undef LOG_TAG
+#define LOG_TAG "HLE"
+
+/* ROM routine costs (psx-spx: memcpy ~160 cycles/byte, bzero ~105) */
+#define HLE_COST_CALL       20
+#define HLE_COST_COPY_BYTE  160
+#define HLE_COST_FILL_BYTE  105
+#define HLE_COST_SCAN_BYTE  105
+#define HLE_COST_RAND       60
+#define HLE_COST_HEAP_CALL  120
+#define HLE_COST_HEAP_BLOCK 40
+#define HLE_COST_EVENT      60
+#define HLE_COST_EVCB       30
+#define HLE_COST_SYSCALL    200 /* exception entry, register save/restore, RFE */
+
+#define EVCB_SIZE        0x1C
+#define EV_STATUS_BUSY   0x2000
+#define EV_STATUS_READY  0x4000
+#define EV_STATUS_OFF    0x1000
+#define EV_MODE_CALLBACK 0x1000
+#define EV_MODE_READY    0x2000
+
+/* rand(): handled only once the game seeds it through us, so the first
+ * values before srand() still come from the BIOS's own generator. */
+static uint32_t hle_rand_x;
+static int hle_rand_seeded;
+
+/* Heap: owned by HLE only when InitHeap() went through us */
+static int hle_heap_owned;
+static uint32_t hle_heap_seg; /* KUSEG/KSEG0/KSEG1 bits of the InitHeap address */
+static uint32_t hle_heap_lo, hle_heap_hi;
+
+/* Hash of the exception handler the BIOS left in RAM when it reached the
+ * shell (BIOS_HLE_KernelReady); 0 = not seen, syscalls stay on the BIOS */
+static uint32_t hle_exc_hash;
+
+void HLE_State(StateIO *io)
+{
+    STATE_VAR(io, hle_rand_x);
+    STATE_VAR(io, hle_rand_seeded);
+    STATE_VAR(io, hle_heap_owned);
+    STATE_VAR(io, hle_heap_seg);
+    STATE_VAR(io, hle_heap_lo);
+    STATE_VAR(io, hle_heap_hi);
+    STATE_VAR(io, hle_exc_hash);
+}
+
+/* Host pointer for [addr, addr+len) if it lies entirely in main RAM */
+static uint8_t *hle_ptr(uint32_t addr, uint32_t len)
+{
+    uint32_t phys = addr & 0x1FFFFFFF;
+    if (phys >= PSX_RAM_SIZE || len > PSX_RAM_SIZE - phys)
+        return NULL;
+    return psx_ram + phys;
+}
+
+static void hle_written(uint32_t addr, uint32_t len)
+{
+    uint32_t phys = addr & 0x1FFFFFFF;
+    if (len)
+        jit_smc_invalidate_range(phys, phys + len);
+}
+
+static inline uint32_t hle_rd32(uint32_t phys)
+{
+    uint32_t v;
+    memcpy(&v, psx_ram + phys, 4);
+    return v;
+}
+
+static inline void hle_wr32(uint32_t phys, uint32_t v)
+{
+    memcpy(psx_ram + phys, &v, 4);
+    jit_smc_invalidate_range(phys, phys + 4);
+}
+
+static uint32_t hle_return(uint32_t v0, uint32_t cycles)
+{
+    cpu.regs[2] = v0;
+    cpu.pc = cpu.regs[31];
+    return cycles;
+}
+
+static uint32_t hle_return_void(uint32_t cycles)
+{
+    cpu.pc = cpu.regs[31];
+    return cycles;
+}
+
+/* Length of the NUL-terminated string at addr, or -1 if it runs off RAM */
+static int32_t hle_strlen(uint32_t addr)
+{
+    const uint8_t *p = hle_ptr(addr, 1);
+    if (!p)
+        return -1;
+    uint32_t avail = PSX_RAM_SIZE - (uint32_t)(p - psx_ram);
+    const uint8_t *nul = memchr(p, 0, avail);
+    return nul ? (int32_t)(nul - p) : -1;
+}
+
+/* ---- A(xx): memory and string functions ---- */
+
+/* ret is the pointer the ROM both refuses on (when 0) and returns:
+ * dst for memcpy, src for bcopy */
+static uint32_t hle_memcpy(uint32_t dst, uint32_t src, uint32_t len, uint32_t ret)
+{
+    if (ret == 0 || len == 0 || len > 0x7FFFFFFF)
+        return hle_return(ret, HLE_COST_CALL);
+    uint8_t *d = hle_ptr(dst, len);
+    uint8_t *s = hle_ptr(src, len);
+    /* The ROM copies forward byte-by-byte; a destination inside the
+     * source would replicate a pattern that memmove does not. */
+    if (!d || !s || (d > s && d < s + len))
+        return 0;
+    memmove(d, s, len);
+    hle_written(dst, len);
+    return hle_return(ret, HLE_COST_CALL + len * HLE_COST_COPY_BYTE);
+}
+
+static uint32_t hle_memset(uint32_t dst, uint8_t fill, uint32_t len)
+{
+    if (dst == 0 || len == 0 || len > 0x7FFFFFFF)
+        return hle_return(0, HLE_COST_CALL);
+    uint8_t *d = hle_ptr(dst, len);
+    if (!d)
+        return 0;
+    memset(d, fill, len);
+    hle_written(dst, len);
+    return hle_return(dst, HLE_COST_CALL + len * HLE_COST_FILL_BYTE);
+}
+
+static uint32_t hle_strcpy(uint32_t dst, uint32_t src)
+{
+    if (dst == 0 || src == 0)
+        return hle_return(0, HLE_COST_CALL);
+    int32_t n = hle_strlen(src);
+    if (n < 0)
+        return 0;
+    uint32_t len = (uint32_t)n + 1;
+    uint8_t *d = hle_ptr(dst, len);
+    uint8_t *s = hle_ptr(src, len);
+    if (!d || (d > s && d < s + len))
+        return 0;
+    memmove(d, s, len);
+    hle_written(dst, len);
+    return hle_return(dst, HLE_COST_CALL + len * HLE_COST_COPY_BYTE);
+}
+
+static uint32_t hle_strlen_call(uint32_t src)
+{
+    if (src == 0)
+        return hle_return(0, HLE_COST_CALL);
+    int32_t n = hle_strlen(src);
+    if (n < 0)
+        return 0;
+    return hle_return((uint32_t)n, HLE_COST_CALL + ((uint32_t)n + 1) * HLE_COST_SCAN_BYTE);
+}
+
+/* ---- A(xx): heap ----
+ * Blocks are [header][data]; the header holds the data size (a multiple
+ * of 4) with bit 0 set when free, matching the BIOS free() convention of
+ * [buf-4] |= 1.  Allocation is first-fit, merging free neighbours on the
+ * way; the caller-visible addresses keep the segment InitHeap was given. */
+
+static uint32_t hle_heap_alloc(uint32_t size, uint32_t *walked)
+{
+    size = (size + 3) & ~3u;
+    if (size == 0)
+        size = 4;
+    uint32_t p = hle_heap_lo;
+    *walked = 0;
+    while (p + 4 <= hle_heap_hi)
+    {
+        uint32_t hdr = hle_rd32(p);
+        uint32_t bsz = hdr & ~3u;
+        (*walked)++;
+        if (p + 4 + bsz > hle_heap_hi)
+            return 0; /* Corrupted by the game: behave like a full heap */
+        if (hdr & 1)
+        {
+            uint32_t next = p + 4 + bsz;
+            while (next + 4 <= hle_heap_hi && (hle_rd32(next) & 1))
+            {
+                uint32_t nsz = hle_rd32(next) & ~3u;
+                if (next + 4 + nsz > hle_heap_hi)
+                    break;
+                bsz += 4 + nsz;
+                next = p + 4 + bsz;
+            }
+            if (bsz >= size)
+            {
+                if (bsz - size >= 8)
+                {
+                    hle_wr32(p + 4 + size, (bsz - size - 4) | 1);
+                    bsz = size;
+                }
+                hle_wr32(p, bsz);
+                return hle_heap_seg | (p + 4);
+            }
+            hle_wr32(p, bsz | 1);
+        }
+        p += 4 + bsz;
+    }
+    return 0;
+}
+
+static uint32_t hle_heap_size_of(uint32_t buf)
+{
+    uint32_t phys = (buf & 0x1FFFFFFF) - 4;
+    if (phys < hle_heap_lo || phys + 4 > hle_heap_hi)
+        return 0;
+    return hle_rd32(phys) & ~3u;
+}
+
+static uint32_t hle_free(uint32_t buf)
+{
+    /* Same as the ROM: no validation beyond staying inside RAM */
+    if (!hle_ptr(buf - 4, 4))
+        return 0;
+    uint32_t phys = (buf - 4) & 0x1FFFFFFF;
+    hle_wr32(phys, hle_rd32(phys) | 1);
+    return HLE_COST_CALL;
+}
+
+static uint32_t hle_heap_call(uint32_t func)
+{
+    uint32_t a0 = cpu.regs[4], a1 = cpu.regs[5];
+    uint32_t walked = 0, buf, cost;
+
+    if (func == 0x39) /* InitHeap(addr, size) */
+    {
+        uint32_t lo = ((a0 & 0x1FFFFFFF) + 3) & ~3u;
+        uint32_t hi = (a0 & 0x1FFFFFFF) + a1;
+        if (!hle_ptr(a0, a1) || hi < lo + 8)
+            return 0;
+        hle_heap_seg = a0 & 0xE0000000;
+        hle_heap_lo = lo;
+        hle_heap_hi = hi & ~3u;
+        hle_wr32(lo, (hle_heap_hi - lo - 4) | 1);
+        hle_heap_owned = 1;
+        return hle_return_void(HLE_COST_HEAP_CALL);
+    }
+    if (!hle_heap_owned)
+        return 0;
+
+    switch (func)
+    {
+    case 0x33: /* malloc(size) */
+        buf = hle_heap_alloc(a0, &walked);
+        return hle_return(buf, HLE_COST_HEAP_CALL + walked * HLE_COST_HEAP_BLOCK);
+    case 0x34: /* free(buf) */
+        cost = hle_free(a0);
+        return cost ? hle_return_void(cost) : 0;
+    case 0x37: /* calloc(sizx, sizy) */
+    {
+        uint32_t len = a0 * a1;
+        buf = hle_heap_alloc(len, &walked);
+        cost = HLE_COST_HEAP_CALL + walked * HLE_COST_HEAP_BLOCK;
+        if (buf)
+        {
+            memset(psx_ram + (buf & 0x1FFFFFFF), 0, len);
+            hle_written(buf, len);
+            cost += len * HLE_COST_FILL_BYTE;
+        }
+        return hle_return(buf, cost);
+    }
+    case 0x38: /* realloc(old_buf, new_size) */
+        if (a0 == 0)
+        {
+            buf = hle_heap_alloc(a1, &walked);
+            return hle_return(buf, HLE_COST_HEAP_CALL + walked * HLE_COST_HEAP_BLOCK);
+        }
+        if (a1 == 0)
+        {
+            cost = hle_free(a0);
+            return cost ? hle_return_void(cost) : 0;
+        }
+        else
+        {
+            uint32_t old_size = hle_heap_size_of(a0);
+            if (!old_size)
+                return 0;
+            buf = hle_heap_alloc(a1, &walked);
+            cost = HLE_COST_HEAP_CALL + walked * HLE_COST_HEAP_BLOCK;
+            if (buf)
+            {
+                /* The ROM copies new_size bytes (garbage past the old
+                 * block); only the old contents are meaningful. */
+                uint32_t n = old_size < a1 ? old_size : a1;
+                memmove(psx_ram + (buf & 0x1FFFFFFF), psx_ram + (a0 & 0x1FFFFFFF), n);
+                hle_written(buf, n);
+                hle_free(a0);
+                cost += a1 * HLE_COST_COPY_BYTE;
+            }
+            return hle_return(buf, cost);
+        }
+    }
+    return 0;
+}
+
+/* ---- B(xx): events ----
+ * EvCB table at [120h], size in bytes at [124h]; the handle is
+ * F10000xxh with the index in the low half (see psx-spx "BIOS Control
+ * Blocks").  Status lives at +04h, class/spec/mode at +00h/+08h/+0Ch. */
+
+static uint32_t hle_evcb(uint32_t event)
+{
+    uint32_t table = hle_rd32(0x120) & 0x1FFFFFFF;
+    uint32_t size = hle_rd32(0x124);
+    uint32_t off = (event & 0xFFFF) * EVCB_SIZE;
+    if ((event & 0xFFFF0000) != 0xF1000000 || off >= size || !hle_ptr(table + off, EVCB_SIZE))
+        return 0;
+    return table + off;
+}
+
+static uint32_t hle_event_call(uint32_t func)
+{
+    uint32_t a0 = cpu.regs[4];
+
+    if (func == 0x07) /* DeliverEvent(class, spec) */
+    {
+        uint32_t table = hle_rd32(0x120) & 0x1FFFFFFF;
+        uint32_t n = hle_rd32(0x124) / EVCB_SIZE;
+        if (!hle_ptr(table, n * EVCB_SIZE))
+            return 0;
+        /* Callback events need the BIOS to run PSX code: leave those
+         * deliveries to the ROM, before touching any status word. */
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint32_t ev = table + i * EVCB_SIZE;
+            if (hle_rd32(ev + 4) == EV_STATUS_BUSY && hle_rd32(ev) == a0 &&
+                hle_rd32(ev + 8) == cpu.regs[5] && hle_rd32(ev + 12) == EV_MODE_CALLBACK)
+                return 0;
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint32_t ev = table + i * EVCB_SIZE;
+            if (hle_rd32(ev + 4) == EV_STATUS_BUSY && hle_rd32(ev) == a0 &&
+                hle_rd32(ev + 8) == cpu.regs[5] && hle_rd32(ev + 12) == EV_MODE_READY)
+                hle_wr32(ev + 4, EV_STATUS_READY);
+        }
+        return hle_return_void(HLE_COST_EVENT + n * HLE_COST_EVCB);
+    }
+
+    uint32_t ev = hle_evcb(a0);
+    if (!ev)
+        return 0;
+    uint32_t status = hle_rd32(ev + 4);
+    switch (func)
+    {
+    case 0x0A: /* WaitEvent(event): only the non-blocking outcomes */
+        if (status == EV_STATUS_OFF)
+            return hle_return(0, HLE_COST_EVENT);
+        if (status != EV_STATUS_READY)
+            return 0; /* Let the ROM spin (the wait-loop skip catches it) */
+        /* fall through */
+    case 0x0B: /* TestEvent(event) */
+        if (status == EV_STATUS_READY)
+        {
+            hle_wr32(ev + 4, EV_STATUS_BUSY);
+            return hle_return(1, HLE_COST_EVENT);
+        }
+        return hle_return(0, HLE_COST_EVENT);
+    case 0x0C: /* EnableEvent(event) */
+        if (status != 0)
+            hle_wr32(ev + 4, EV_STATUS_BUSY);
+        return hle_return(1, HLE_COST_EVENT);
+    case 0x0D: /* DisableEvent(event) */
+        if (status != 0)
+            hle_wr32(ev + 4, EV_STATUS_OFF);
+        return hle_return(1, HLE_COST_EVENT);
+    }
+    return 0;
+}
+
+/* ---- SYSCALL: critical sections ---- */
+
+#define HLE_EXC_WORDS 64 /* handler words hashed after the vector stub */
+
+/* Hash of the vector at 0x80 and the start of the handler it jumps to,
+ * or 0 if the vector is not the kernel's lui/addiu k0 + jr k0 stub */
+static uint32_t hle_exc_handler_hash(void)
+{
+    uint32_t lui = hle_rd32(0x80), add = hle_rd32(0x84);
+    if (OP(lui) != 0x0F || RT(lui) != 26 || hle_rd32(0x88) != 0x03400008 || /* jr k0 */
+        (OP(add) != 0x09 && OP(add) != 0x0D) || RS(add) != 26 || RT(add) != 26)
+        return 0;
+    uint32_t target = (lui << 16) + (OP(add) == 0x09 ? (uint32_t)SIMM16(add) : IMM16(add));
+    uint32_t phys = target & 0x1FFFFFFF;
+    if ((phys & 3) || !hle_ptr(phys, HLE_EXC_WORDS * 4))
+        return 0;
+
+    uint32_t hash = 5381;
+    for (uint32_t a = 0x80; a < 0x90; a += 4)
+        hash = (hash << 5) + hash + hle_rd32(a);
+    for (uint32_t i = 0; i < HLE_EXC_WORDS; i++)
+        hash = (hash << 5) + hash + hle_rd32(phys + i * 4);
+    return hash ? hash : 1;
+}
+
+/* The BIOS reached the shell: its exception handler is the stock one */
+void BIOS_HLE_KernelReady(void)
+{
+    hle_exc_hash = hle_exc_handler_hash();
+}
+
+/*
+ * BIOS_HLE_Syscall: SYSCALL at pc with the function number in $a0.
+ * Returns the cycles to charge (cpu.pc = pc + 4) or 0 to raise the
+ * exception.  The stock handler saves the thread's registers, edits the
+ * IEp/IM2 bits of the saved SR (bits 2 and 10, moved back to IEc by the
+ * RFE) and returns through k0: EnterCriticalSection clears both and
+ * returns 1 in v0 if both were set, ExitCriticalSection sets both.
+ */
+uint32_t BIOS_HLE_Syscall(uint32_t pc)
+{
+    uint32_t func = cpu.regs[4];
+    uint32_t sr = cpu.cop0[PSX_COP0_SR];
+
+    if ((func != 1 && func != 2) || !hle_exc_hash || (sr & 0x00400000))
+        return 0;
+    /* In a branch delay slot the handler would resume at the target */
+    if (hle_ptr(pc - 4, 4))
+    {
+        uint32_t prev = hle_rd32((pc - 4) & 0x1FFFFFFF);
+        int op = OP(prev);
+        if ((op >= 0x01 && op <= 0x07) || (op == 0 && (FUNC(prev) == 0x08 || FUNC(prev) == 0x09)))
+            return 0;
+    }
+    if (hle_exc_handler_hash() != hle_exc_hash)
+        return 0;
+
+    cpu.cop0[PSX_COP0_EPC] = pc;
+    cpu.cop0[PSX_COP0_CAUSE] = (cpu.cop0[PSX_COP0_CAUSE] & 0x0000FF00) | (0x08 << 2);
+    if (func == 1)
+    {
+        cpu.regs[2] = (sr & 0x401) == 0x401;
+        sr &= ~0x401u;
+    }
+    else
+    {
+        sr |= 0x401;
+    }
+    cpu.cop0[PSX_COP0_SR] = sr;
+    cpu.irq_pending_fast = cpu.irq_pending & (sr & 1);
+    cpu.regs[26] = pc + 4; /* k0: the handler returns through jr k0 */
+    cpu.pc = pc + 4;
+    return HLE_COST_SYSCALL;
+}
+
+/*
+ * BIOS_HLE_Library: table is 0xA0 / 0xB0, func the number from $t1.
+ * Returns the cycles to charge (call handled, cpu.pc = $ra) or 0.
+ */
+uint32_t BIOS_HLE_Library(uint32_t table, uint32_t func)
+{
+    uint32_t a0 = cpu.regs[4], a1 = cpu.regs[5], a2 = cpu.regs[6];
+
+    if (table == 0xA0)
+    {
+        switch (func)
+        {
+        case 0x19: /* strcpy(dst, src) */
+            return hle_strcpy(a0, a1);
+        case 0x1B: /* strlen(src) */
+            return hle_strlen_call(a0);
+        case 0x27: /* bcopy(src, dst, len) */
+            return hle_memcpy(a1, a0, a2, a0);
+        case 0x28: /* bzero(dst, len) */
+            return hle_memset(a0, 0, a1);
+        case 0x2A: /* memcpy(dst, src, len) */
+            return hle_memcpy(a0, a1, a2, a0);
+        case 0x2B: /* memset(dst, fillbyte, len) */
+            return hle_memset(a0, (uint8_t)a1, a2);
+        case 0x2F: /* rand() */
+            if (!hle_rand_seeded)
+                return 0;
+            hle_rand_x = hle_rand_x * 0x41C64E6D + 0x3039;
+            return hle_return((hle_rand_x >> 16) & 0x7FFF, HLE_COST_RAND);
+        case 0x30: /* srand(seed) */
+            hle_rand_x = a0;
+            hle_rand_seeded = 1;
+            return hle_return_void(HLE_COST_CALL);
+        case 0x33:
+        case 0x34:
+        case 0x37:
+        case 0x38:
+        case 0x39:
+            return hle_heap_call(func);
+        }
+    }
+    else if (table == 0xB0)
+    {
+        switch (func)
+        {
+        case 0x07:
+        case 0x0A:
+        case 0x0B:
+        case 0x0C:
+        case 0x0D:
+            return hle_event_call(func);
+        }
+    }
+    return 0;
+}
@@ -2,8 +2,11 @@
  * SuperPSX - CD-ROM Controller Emulation
  *
  * Emulates the PSX CD-ROM controller with disc-present simulation.
- * Supports: GetStat, Setloc, SeekL, SeekP, ReadN, Pause, Init,
- *           Demute, SetMode, GetlocL, GetlocP, GetID, Test, ReadTOC.
+ * Supports: GetStat, Setloc, Play, SeekL, SeekP, ReadN, Pause, Init,
+ *           Demute, SetMode, GetlocL, GetlocP, GetTN, GetTD, GetID, Test,
+ *           ReadTOC.
+ * XA-ADPCM sectors are routed to cdrom_xa.c when SetMode bit 6 is set;
+ * Play streams the CUE sheet's audio tracks through cdrom_cdda.c.
  *
  * CD-ROM registers: 0x1F801800-0x1F801803
  * Register meanings vary based on the Index (bits 0-1 of 0x1F801800)
@@ -13,6 +16,7 @@
 #include "scheduler.h"
 #include "iso_image.h"
 #include "config.h"
+#include "savestate.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -38,6 +42,15 @@
 #define PENDING_DELAY_SEEKL 1000000U    /* ~30ms  — seek completion */
 #define PENDING_DELAY_READTOC 16000000U /* ~480ms — full TOC read */
 #define PENDING_DELAY_DEFAULT 200000U   /* ~6ms   — generic fallback */
+#define READ_DELAY_SEEK 10000000U       /* ~300ms — ReadN/ReadS seek, legacy timing */
+
+/* ---- Seek model (cdrom_speed >= 1) ----
+ * Within a couple of tracks the head only waits for the sector to come
+ * round; beyond that the sled moves, roughly linear in distance up to
+ * about 3/4 s over the whole disc. */
+#define SEEK_NEAR_SECTORS 64
+#define SEEK_MIN_CYCLES (PSX_CPU_FREQ / 30)      /* ~33ms  — settle + rotation */
+#define SEEK_FULL_CYCLES (PSX_CPU_FREQ / 4 * 3) /* ~750ms — added for a full stroke */
 
 /* ---- BCD helpers ---- */
 static uint8_t dec_to_bcd(int v) { return (uint8_t)(((v / 10) << 4) | (v % 10)); }
@@ -61,6 +74,13 @@ static void lba_to_bcd(uint32_t lba, uint8_t *mm, uint8_t *ss, uint8_t *ff)
     *mm = dec_to_bcd(lba);
 }
 
+/* Absolute LBA to image LBA.  The BIN/CUE file starts at the data area
+ * (Track 1 INDEX 01), absolute sector 150 (2-second pregap). */
+static uint32_t cdrom_file_lba(uint32_t lba)
+{
+    return (lba >= PREGAP_LBA) ? (lba - PREGAP_LBA) : 0;
+}
+
 /* ---- CD-ROM State ---- */
 static struct
 {
@@ -79,6 +99,11 @@ static struct
     uint8_t data_fifo[DATA_FIFO_SIZE];
     uint32_t data_pos;
     uint32_t data_len;
+    /* 1 = data_fifo doesn't hold the sector yet: it is read from file
+     * LBA data_lba by whatever drains the FIFO first, so a whole-sector
+     * DMA3 reads it straight into RAM */
+    uint8_t data_deferred;
+    uint32_t data_lba;
 
     /* Interrupt system */
     uint8_t int_enable; /* Interrupt Enable mask (5 bits) */
@@ -110,6 +135,15 @@ static struct
     uint64_t pending_deadline; /* Absolute cycle when pending response becomes ready */
     uint8_t seek_pending;      /* 1 = seek is in progress, waiting for scheduler */
     uint8_t location_changed;  /* 1 = SetLoc was issued, first sector gets extra delay */
+    uint8_t playing;           /* 1 = Play (CD-DA) in progress */
+    uint8_t play_track;        /* BCD track under the head while playing */
+
+    /* XA-ADPCM */
+    uint8_t filter_file;    /* SetFilter file, matched when mode bit 3 is set */
+    uint8_t filter_channel; /* SetFilter channel */
+    uint8_t cmd_muted;      /* Mute / Demute */
+    uint8_t adpcm_muted;    /* bit 0 of the "apply volume" register */
+    uint8_t atten[4];       /* written volumes L→L, L→R, R→L, R→R (applied on bit 5) */
 
     /* Deferred first response (INT3) — mimics real CD controller latency */
     uint8_t deferred_response[RESPONSE_FIFO_SIZE];
@@ -137,10 +171,64 @@ static void CDROM_PendingCallback(int ticks_late);
 static void CDROM_DeferredCallback(int ticks_late);
 static void CDROM_DeferredIRQActivate(int ticks_late);
 
-/* ---- Speed-aware read delay based on mode bit 7 ---- */
+/* ---- Speed-aware read delay based on mode bit 7 ----
+ * cdrom_speed > 1 shortens the sector time of data reads.  Not with
+ * XA-ADPCM enabled (mode bit 6): streamed audio has to arrive in real
+ * time. */
 static inline uint32_t cdrom_read_delay(void)
 {
-    return (cdrom.mode & 0x80) ? CDROM_READ_CYCLES_2X : CDROM_READ_CYCLES_1X;
+    uint32_t delay = (cdrom.mode & 0x80) ? CDROM_READ_CYCLES_2X : CDROM_READ_CYCLES_1X;
+    if (psx_config.cdrom_speed > 1 && !(cdrom.mode & 0x40))
+        delay /= (uint32_t)psx_config.cdrom_speed;
+    return delay;
+}
+
+/* ---- Seek time from the head position to lba ---- */
+static uint32_t cdrom_seek_delay(uint32_t lba, uint32_t legacy)
+{
+    if (psx_config.cdrom_speed == 0)
+        return legacy;
+
+    uint32_t dist = (lba > cdrom.cur_lba) ? lba - cdrom.cur_lba : cdrom.cur_lba - lba;
+    uint32_t delay = SEEK_MIN_CYCLES;
+    if (dist > SEEK_NEAR_SECTORS)
+        delay += (uint32_t)((uint64_t)dist * SEEK_FULL_CYCLES / DISC_MAX_LBA);
+    if (psx_config.cdrom_speed > 1)
+        delay /= (uint32_t)psx_config.cdrom_speed;
+    return delay;
+}
+
+/* ---- Track (BCD, 0xAA = lead-out) at absolute lba and the sectors
+ * since its INDEX 01.  Without an image: one data track up to
+ * LEADOUT_LBA. ---- */
+static uint8_t cdrom_track_at(uint32_t lba, uint32_t *rel)
+{
+    uint32_t file_lba = cdrom_file_lba(lba);
+
+    if (!ISO_IsLoaded())
+    {
+        *rel = file_lba;
+        return (lba >= LEADOUT_LBA) ? 0xAA : 0x01;
+    }
+    int t = ISO_TrackAt(file_lba);
+    if (!t)
+    {
+        *rel = file_lba - ISO_GetDiscEnd();
+        return 0xAA;
+    }
+    const IsoTrack *tr = ISO_GetTrack(t);
+    *rel = (file_lba >= tr->start) ? file_lba - tr->start : tr->start - file_lba;
+    return dec_to_bcd(t);
+}
+
+/* ---- End CD-DA playback ---- */
+static void cdrom_stop_play(void)
+{
+    if (cdrom.playing)
+    {
+        cdrom.playing = 0;
+        CDDA_Stop();
+    }
 }
 
 /* ---- Update stat preserving ShellOpen when no disc ---- */
@@ -158,6 +246,11 @@ void CDROM_Init(void)
     memset(&cdrom, 0, sizeof(cdrom));
     cdrom.disc_present = 0; /* No disc inserted */
     cdrom.stat = 0x10;      /* ShellOpen = no disc inserted */
+    cdrom.atten[0] = cdrom.atten[3] = 0x80;
+    CDXA_Reset();
+    CDXA_SetVolume(0x80, 0, 0, 0x80);
+    CDXA_SetMute(0);
+    CDDA_Stop();
     DLOG("Initialized (no disc)\n");
 }
 
@@ -166,6 +259,8 @@ void CDROM_InsertDisc(void)
 {
     cdrom.disc_present = 1;
     cdrom.stat = 0x02; /* Motor On, idle (no ShellOpen) */
+    if (psx_config.cdrom_async)
+        CDIO_Start();
     DLOG("Disc inserted\n");
 }
 
@@ -197,6 +292,8 @@ void CDROM_EjectDisc(void)
 {
     cdrom.disc_present = 0;
     cdrom.reading = 0;
+    CDIO_Stop();
+    cdrom_stop_play();
     cdrom.stat = 0x01; /* Error (no disc / shell open condition) */
 
     /* Send async INT5 (error) to notify the game */
@@ -229,12 +326,40 @@ void CDROM_CloseShell(void)
     DLOG("Shell closing — motor spinup\n");
 }
 
+/* ---- Read the deferred sector into dst (data_fifo or RAM) ---- */
+static void cdrom_read_deferred(uint8_t *dst)
+{
+    cdrom.data_deferred = 0;
+    if (CDIO_ReadSector(cdrom.data_lba, dst) < 0)
+    {
+        DLOG("Failed to read sector at file LBA %" PRIu32 "\n", cdrom.data_lba);
+        memset(dst, 0, ISO_SECTOR_SIZE);
+    }
+}
+
+/* Make data_fifo hold the delivered sector.  Called before the FIFO is
+ * read byte-wise and before anything moves the read-ahead ring past
+ * data_lba */
+static inline void cdrom_fill_fifo(void)
+{
+    if (cdrom.data_deferred)
+        cdrom_read_deferred(cdrom.data_fifo);
+}
+
 /* ---- Read data from the CD-ROM data FIFO (used by DMA3) ---- */
 uint32_t CDROM_ReadDataFIFO(uint8_t *dst, uint32_t count)
 {
     uint32_t avail = cdrom.data_len - cdrom.data_pos;
     if (count > avail)
         count = avail;
+    /* The whole sector in one go: no stop in data_fifo */
+    if (cdrom.data_deferred && cdrom.data_pos == 0 && count == cdrom.data_len)
+    {
+        cdrom_read_deferred(dst);
+        cdrom.data_pos = count;
+        return count;
+    }
+    cdrom_fill_fifo();
     if (count > 0)
     {
         memcpy(dst, &cdrom.data_fifo[cdrom.data_pos], count);
@@ -287,6 +412,7 @@ static void cdrom_execute_command(uint8_t cmd)
     uint8_t resp[16];
 
     cdrom.last_cmd = cmd;
+    cdrom_fill_fifo(); /* Setloc/ReadN/SeekL reposition the read-ahead ring */
 
     /* Progress heartbeat every 500 commands */
     if (++cdrom_cmd_count % 500 == 0)
@@ -314,30 +440,55 @@ static void cdrom_execute_command(uint8_t cmd)
         break;
     }
 
-    case 0x03: /* Play - CDDA audio playback (stub) */
+    case 0x03: /* Play - CD-DA from a track (param, optional), the Setloc
+                * target or where the head is */
     {
-        DLOG("Cmd 03h Play (stub)\n");
-        cdrom.cur_lba = cdrom.setloc_lba;
+        int track = (cdrom.param_count > 0) ? bcd_to_dec(cdrom.param_fifo[0]) : 0;
+        const IsoTrack *tr = track ? ISO_GetTrack(track) : NULL;
+        uint32_t lba = cdrom.cur_lba;
+        uint32_t rel;
+        if (tr)
+            lba = tr->start + PREGAP_LBA;
+        else if (cdrom.location_changed)
+            lba = cdrom.setloc_lba;
+        DLOG("Cmd 03h Play(track %d) from LBA %" PRIu32 "\n", track, lba);
+        uint32_t seek = cdrom_seek_delay(lba, PENDING_DELAY_SEEKL);
+        cdrom.reading = 0;
+        CDIO_Stop();
+        cdrom.cur_lba = lba;
+        cdrom.location_changed = 0;
+        cdrom.playing = 1;
+        cdrom.play_track = cdrom_track_at(lba, &rel);
+        cdrom.has_loc_header = 1;
+        cdrom.seek_error = 0;
+        cdrom.seek_pending = 1; /* the stream starts once the head is there */
         cdrom_set_stat(0x82); /* Playing + Motor On */
         resp[0] = cdrom.stat;
         cdrom_queue_response(resp, 1, 3); /* INT3 */
+        Sched_Add(SCHED_EVENT_CDROM,
+                                global_cycles + seek,
+                                CDROM_EventCallback);
         break;
     }
 
     case 0x06: /* ReadN - Read with retry */
     {
         DLOG("Cmd 06h ReadN from LBA %" PRIu32 "\n", cdrom.setloc_lba);
+        uint32_t seek = cdrom_seek_delay(cdrom.setloc_lba, READ_DELAY_SEEK);
+        cdrom_stop_play();
         cdrom.cur_lba = cdrom.setloc_lba;
         cdrom.reading = 1;
+        CDIO_Seek(cdrom_file_lba(cdrom.cur_lba));
+        CDXA_Reset();
         cdrom.has_loc_header = 1;
         cdrom.seek_error = 0;
         cdrom_set_stat(0x42); /* Seeking + Motor On */
         cdrom.seek_pending = 1;
         resp[0] = cdrom.stat;
         cdrom_queue_response(resp, 1, 3); /* INT3 acknowledge */
-        /* Schedule seek completion: ~300ms for initial seek */
+        /* Schedule seek completion */
         Sched_Add(SCHED_EVENT_CDROM,
-                                global_cycles + 10000000ULL,
+                                global_cycles + seek,
                                 CDROM_EventCallback);
         break;
     }
@@ -354,6 +505,8 @@ static void cdrom_execute_command(uint8_t cmd)
     case 0x08: /* Stop */
         DLOG("Cmd 08h Stop\n");
         cdrom.reading = 0;
+        CDIO_Stop();
+        cdrom_stop_play();
         cdrom_set_stat(0x00); /* Motor Off */
         resp[0] = cdrom.stat;
         cdrom_queue_response(resp, 1, 3); /* INT3 */
@@ -364,6 +517,8 @@ static void cdrom_execute_command(uint8_t cmd)
     case 0x09: /* Pause */
         DLOG("Cmd 09h Pause\n");
         cdrom.reading = 0;
+        CDIO_Stop();
+        cdrom_stop_play();
         cdrom_set_stat(0x02); /* Motor On, idle */
         resp[0] = cdrom.stat;
         cdrom_queue_response(resp, 1, 3); /* INT3 */
@@ -376,6 +531,8 @@ static void cdrom_execute_command(uint8_t cmd)
         DLOG("Cmd 0Ah Init\n");
         uint8_t had_header = cdrom.has_loc_header;
         cdrom.reading = 0;
+        CDIO_Stop();
+        cdrom_stop_play();
         cdrom.seek_error = 0;
         cdrom_set_stat(0x02); /* Motor On, idle (preserves ShellOpen if no disc) */
         if (had_header)
@@ -393,12 +550,16 @@ static void cdrom_execute_command(uint8_t cmd)
 
     case 0x0C: /* Demute */
         DLOG("Cmd 0Ch Demute\n");
+        cdrom.cmd_muted = 0;
+        CDXA_SetMute(cdrom.adpcm_muted);
         resp[0] = cdrom.stat;
         cdrom_queue_response(resp, 1, 3); /* INT3 */
         break;
 
     case 0x0B: /* Mute */
         DLOG("Cmd 0Bh Mute\n");
+        cdrom.cmd_muted = 1;
+        CDXA_SetMute(1);
         resp[0] = cdrom.stat;
         cdrom_queue_response(resp, 1, 3); /* INT3 */
         break;
@@ -408,8 +569,8 @@ static void cdrom_execute_command(uint8_t cmd)
         uint8_t file = (cdrom.param_count > 0) ? cdrom.param_fifo[0] : 0;
         uint8_t channel = (cdrom.param_count > 1) ? cdrom.param_fifo[1] : 0;
         DLOG("Cmd 0Dh SetFilter(file=%02X, channel=%02X)\n", file, channel);
-        (void)file;
-        (void)channel;
+        cdrom.filter_file = file;
+        cdrom.filter_channel = channel;
         resp[0] = cdrom.stat;
         cdrom_queue_response(resp, 1, 3); /* INT3 */
         break;
@@ -426,8 +587,8 @@ static void cdrom_execute_command(uint8_t cmd)
         DLOG("Cmd 0Fh GetParam\n");
         resp[0] = cdrom.stat;
         resp[1] = cdrom.mode;
-        resp[2] = 0x00;                   /* file */
-        resp[3] = 0x00;                   /* channel */
+        resp[2] = cdrom.filter_file;      /* file */
+        resp[3] = cdrom.filter_channel;   /* channel */
         resp[4] = 0x00;                   /* ci (match) */
         resp[5] = 0x00;                   /* ci (mask) */
         cdrom_queue_response(resp, 6, 3); /* INT3 */
@@ -473,23 +634,17 @@ static void cdrom_execute_command(uint8_t cmd)
             uint8_t rmm, rss, rff; /* relative */
             lba_to_bcd(cdrom.cur_lba, &amm, &ass, &aff);
 
-            /* Track number: 0xAA for lead-out, 0x01 for data */
-            uint8_t track = (cdrom.cur_lba >= LEADOUT_LBA) ? 0xAA : 0x01;
+            /* Track number from the image's track table (0xAA = lead-out),
+             * position relative to its start */
+            uint32_t rel;
+            uint8_t track = cdrom_track_at(cdrom.cur_lba, &rel);
             /* Index: 0x00 for pregap, 0x01 for data/lead-out */
             uint8_t index = (cdrom.cur_lba < PREGAP_LBA) ? 0x00 : 0x01;
 
-            /* Relative position within track */
-            if (cdrom.cur_lba >= PREGAP_LBA)
-            {
-                uint32_t rel = cdrom.cur_lba - PREGAP_LBA;
-                lba_to_bcd(rel, &rmm, &rss, &rff);
-            }
-            else
-            {
-                /* Pregap: count remaining frames to data start */
-                uint32_t rem = PREGAP_LBA - cdrom.cur_lba;
-                lba_to_bcd(rem, &rmm, &rss, &rff);
-            }
+            /* Pregap: count remaining frames to data start */
+            if (cdrom.cur_lba < PREGAP_LBA)
+                rel = PREGAP_LBA - cdrom.cur_lba;
+            lba_to_bcd(rel, &rmm, &rss, &rff);
 
             DLOG("Cmd 11h GetlocP -> T%02X I%02X [%02X:%02X:%02X] abs [%02X:%02X:%02X]\n",
                  track, index, rmm, rss, rff, amm, ass, aff);
@@ -506,33 +661,40 @@ static void cdrom_execute_command(uint8_t cmd)
         break;
 
     case 0x13: /* GetTN - Get first and last track numbers */
+    {
+        int last = ISO_GetTrackCount();
         DLOG("Cmd 13h GetTN\n");
         resp[0] = cdrom.stat;
-        resp[1] = 0x01;                   /* First track: 01 (BCD) */
-        resp[2] = 0x01;                   /* Last track: 01 (BCD) - single data track */
+        resp[1] = 0x01;                            /* First track: 01 (BCD) */
+        resp[2] = dec_to_bcd(last > 1 ? last : 1); /* Last track (BCD) */
         cdrom_queue_response(resp, 3, 3); /* INT3 */
         break;
+    }
 
     case 0x14: /* GetTD - Get track start position */
     {
         uint8_t track = (cdrom.param_count > 0) ? cdrom.param_fifo[0] : 0;
+        const IsoTrack *tr = ISO_GetTrack(bcd_to_dec(track));
         DLOG("Cmd 14h GetTD(track=%02X)\n", track);
         if (track == 0)
         {
             /* Track 0 = disc end (lead-out) */
             uint8_t mm, ss, ff;
-            lba_to_bcd(LEADOUT_LBA + PREGAP_LBA, &mm, &ss, &ff);
+            lba_to_bcd(ISO_IsLoaded() ? ISO_GetDiscEnd() + PREGAP_LBA : LEADOUT_LBA + PREGAP_LBA,
+                       &mm, &ss, &ff);
             resp[0] = cdrom.stat;
             resp[1] = mm;
             resp[2] = ss;
             cdrom_queue_response(resp, 3, 3); /* INT3 */
         }
-        else if (track == 1)
+        else if (tr || track == 1)
         {
-            /* Track 1 starts at 00:02:00 (pregap) */
+            /* INDEX 01 of the track (track 1: 00:02:00, after the pregap) */
+            uint8_t mm, ss, ff;
+            lba_to_bcd((tr ? tr->start : 0) + PREGAP_LBA, &mm, &ss, &ff);
             resp[0] = cdrom.stat;
-            resp[1] = 0x00;                   /* MM (BCD) */
-            resp[2] = 0x02;                   /* SS (BCD) */
+            resp[1] = mm;                     /* MM (BCD) */
+            resp[2] = ss;                     /* SS (BCD) */
             cdrom_queue_response(resp, 3, 3); /* INT3 */
         }
         else
@@ -549,6 +711,7 @@ static void cdrom_execute_command(uint8_t cmd)
     case 0x16: /* SeekP - Seek (audio mode) */
     {
         DLOG("Cmd %02Xh Seek to LBA %" PRIu32 "\n", cmd, cdrom.setloc_lba);
+        cdrom_stop_play();
         if (cdrom.setloc_lba >= DISC_MAX_LBA)
         {
             /* Out of range - seek error */
@@ -563,6 +726,7 @@ static void cdrom_execute_command(uint8_t cmd)
         else
         {
             /* Seek succeeds */
+            uint32_t seek = cdrom_seek_delay(cdrom.setloc_lba, PENDING_DELAY_SEEKL);
             cdrom.cur_lba = cdrom.setloc_lba;
             cdrom.has_loc_header = 1;
             cdrom.seek_error = 0;
@@ -570,7 +734,7 @@ static void cdrom_execute_command(uint8_t cmd)
             resp[0] = cdrom.stat;
             cdrom_queue_response(resp, 1, 3); /* INT3 */
             resp[0] = cdrom.stat;
-            cdrom_queue_pending(resp, 1, 2, PENDING_DELAY_SEEKL); /* INT2 complete */
+            cdrom_queue_pending(resp, 1, 2, seek); /* INT2 complete */
         }
         break;
     }
@@ -645,8 +809,12 @@ static void cdrom_execute_command(uint8_t cmd)
     case 0x1B: /* ReadS - Read without retry */
     {
         DLOG("Cmd 1Bh ReadS from LBA %" PRIu32 "\n", cdrom.setloc_lba);
+        uint32_t seek = cdrom_seek_delay(cdrom.setloc_lba, READ_DELAY_SEEK);
+        cdrom_stop_play();
         cdrom.cur_lba = cdrom.setloc_lba;
         cdrom.reading = 1;
+        CDIO_Seek(cdrom_file_lba(cdrom.cur_lba));
+        CDXA_Reset();
         cdrom.has_loc_header = 1;
         cdrom.seek_error = 0;
         cdrom_set_stat(0x42); /* Seeking + Motor On */
@@ -655,7 +823,7 @@ static void cdrom_execute_command(uint8_t cmd)
         cdrom_queue_response(resp, 1, 3); /* INT3 */
         /* Schedule seek completion */
         Sched_Add(SCHED_EVENT_CDROM,
-                                global_cycles + 10000000ULL,
+                                global_cycles + seek,
                                 CDROM_EventCallback);
         break;
     }
@@ -764,6 +932,7 @@ uint32_t CDROM_Read(uint32_t addr)
     case 2: /* 0x1F801802 - Data FIFO (all indices) */
         if (cdrom.data_pos < cdrom.data_len)
         {
+            cdrom_fill_fifo();
             result = cdrom.data_fifo[cdrom.data_pos++];
         }
         break;
@@ -789,11 +958,100 @@ uint32_t CDROM_Read(uint32_t addr)
 }
 
 /* ---- CD-ROM event callback (called by scheduler) ---- */
+/* Raw subheader + payload of the sector being read in XA-ADPCM mode */
+static uint8_t cdrom_xa_raw[ISO_MODE2_SIZE];
+static int cdrom_late_retries; /* cdrom_async = 2 delays of this sector */
+
+/* ---- Advance to the next sector and schedule its delivery ---- */
+static void cdrom_next_sector(void)
+{
+    cdrom.cur_lba++;
+
+    /* Speed-aware timing.  After a location change (SetLoc), the first
+     * sector takes 30× the normal read time to simulate the physical seek
+     * (the seek model already charged it in the ReadN/ReadS delay). */
+    uint32_t delay = cdrom_read_delay();
+    if (cdrom.location_changed)
+    {
+        if (psx_config.cdrom_speed == 0)
+            delay *= 30;
+        cdrom.location_changed = 0;
+    }
+    Sched_Add(SCHED_EVENT_CDROM,
+                            global_cycles + delay,
+                            CDROM_EventCallback);
+}
+
+/* ---- CD-DA: one sector time of Play ----
+ * The head moves at 1x; the audio itself comes from the CDDA stream,
+ * started once the seek completes.  Autopause (mode bit 1) stops at the
+ * end of the track, the lead-out always; both answer INT4.  Report mode
+ * (bit 2) sends the position as INT1 every 10 sectors, absolute and
+ * track-relative in turn, when nothing else is waiting. */
+static void cdrom_play_sector(void)
+{
+    uint8_t resp[8];
+    uint32_t rel;
+
+    if (cdrom.seek_pending)
+    {
+        cdrom.seek_pending = 0;
+        CDDA_Play(cdrom_file_lba(cdrom.cur_lba));
+    }
+    else
+        cdrom.cur_lba++;
+
+    uint8_t track = cdrom_track_at(cdrom.cur_lba, &rel);
+    if (track == 0xAA || ((cdrom.mode & 0x02) && track != cdrom.play_track))
+    {
+        DLOG("Play: end of %s\n", track == 0xAA ? "disc" : "track");
+        cdrom_stop_play();
+        cdrom_set_stat(0x02); /* Motor On, idle */
+        resp[0] = cdrom.stat;
+        cdrom_queue_response(resp, 1, 4); /* INT4 = data end */
+        return;
+    }
+    cdrom.play_track = track;
+
+    uint32_t frame = cdrom.cur_lba % 75;
+    if ((cdrom.mode & 0x04) && frame % 10 == 0 && cdrom.int_flag == 0 &&
+        !cdrom.has_pending && !cdrom.has_deferred)
+    {
+        uint8_t mm, ss, ff;
+        if (frame % 20 == 0)
+            lba_to_bcd(cdrom.cur_lba, &mm, &ss, &ff);
+        else
+        {
+            lba_to_bcd(rel, &mm, &ss, &ff);
+            ss |= 0x80; /* relative */
+        }
+        resp[0] = cdrom.stat;
+        resp[1] = track;
+        resp[2] = 0x01; /* index */
+        resp[3] = mm;
+        resp[4] = ss;
+        resp[5] = ff;
+        resp[6] = 0; /* peak level, not measured */
+        resp[7] = 0;
+        cdrom_queue_response(resp, 8, 1); /* INT1 report */
+    }
+    Sched_Add(SCHED_EVENT_CDROM,
+                            global_cycles + CDROM_READ_CYCLES_1X,
+                            CDROM_EventCallback);
+}
+
 static void CDROM_EventCallback(int ticks_late)
 {
     (void)ticks_late;
+    if (cdrom.playing)
+    {
+        cdrom_play_sector();
+        return;
+    }
     if (!cdrom.reading)
         return;
+    /* The ring is about to move on to the next sector */
+    cdrom_fill_fifo();
 
     /* Phase 1: Seek completion */
     if (cdrom.seek_pending)
@@ -807,6 +1065,36 @@ static void CDROM_EventCallback(int ticks_late)
         return;
     }
 
+    /* cdrom_async = 2: a sector the read-ahead thread hasn't delivered
+     * yet arrives a little later instead of stalling here (bounded, then
+     * the read below waits for it) */
+    if (psx_config.cdrom_async == 2 && ISO_IsLoaded() &&
+        !CDIO_Ready(cdrom_file_lba(cdrom.cur_lba)) && cdrom_late_retries < 8)
+    {
+        cdrom_late_retries++;
+        Sched_Add(SCHED_EVENT_CDROM,
+                                global_cycles + cdrom_read_delay() / 4,
+                                CDROM_EventCallback);
+        return;
+    }
+    cdrom_late_retries = 0;
+
+    /* XA-ADPCM enabled: audio sectors go to the XA decoder, not the CPU,
+     * and need no INT1 acknowledge */
+    if ((cdrom.mode & 0x40) && ISO_IsLoaded())
+    {
+        uint32_t file_lba = cdrom_file_lba(cdrom.cur_lba);
+        uint8_t *sub = cdrom_xa_raw;
+        if (CDIO_ReadSectorRaw(file_lba, sub) == 0 && (sub[2] & 0x24) == 0x24) /* Form 2 + Audio */
+        {
+            if (!(cdrom.mode & 0x08) ||
+                (sub[0] == cdrom.filter_file && sub[1] == cdrom.filter_channel))
+                CDXA_PushSector(sub);
+            cdrom_next_sector();
+            return;
+        }
+    }
+
     /* Phase 2: Sector delivery (INT1) */
     if (cdrom.int_flag != 0 || cdrom.has_pending)
     {
@@ -822,23 +1110,16 @@ static void CDROM_EventCallback(int ticks_late)
     /* Fill data FIFO with sector data */
     if (ISO_IsLoaded())
     {
-        /* Convert absolute LBA to file-relative LBA.
-         * The BIN/CUE file starts at the data area (Track 1 INDEX 01),
-         * which is at absolute sector 150 (2-second pregap).
-         * MSF addresses from Setloc are absolute, so we subtract 150. */
-        uint32_t file_lba = (cdrom.cur_lba >= PREGAP_LBA) ? (cdrom.cur_lba - PREGAP_LBA) : 0;
-
-        /* Read real sector data from mounted ISO */
-        if (ISO_ReadSector(file_lba, cdrom.data_fifo) < 0)
-        {
-            DLOG("Failed to read sector at LBA %" PRIu32 " (file LBA %" PRIu32 ")\n",
-                 cdrom.cur_lba, file_lba);
-            memset(cdrom.data_fifo, 0, ISO_SECTOR_SIZE);
-        }
+        /* MSF addresses from Setloc are absolute, the image starts at
+         * the data area.  The read itself waits for the FIFO's first
+         * reader (cdrom_read_deferred). */
+        cdrom.data_lba = cdrom_file_lba(cdrom.cur_lba);
+        cdrom.data_deferred = 1;
     }
     else
     {
         /* No disc image: fill with zeros */
+        cdrom.data_deferred = 0;
         memset(cdrom.data_fifo, 0, ISO_SECTOR_SIZE);
     }
     cdrom.data_pos = 0;
@@ -851,21 +1132,7 @@ static void CDROM_EventCallback(int ticks_late)
         cdrom_queue_response(resp, 1, 1); /* INT1 = data ready */
     }
 
-    /* Advance position */
-    cdrom.cur_lba++;
-
-    /* Schedule next sector with speed-aware timing.
-     * After a location change (SetLoc), the first sector takes 30×
-     * the normal read time to simulate the physical seek. */
-    uint32_t delay = cdrom_read_delay();
-    if (cdrom.location_changed)
-    {
-        delay *= 30;
-        cdrom.location_changed = 0;
-    }
-    Sched_Add(SCHED_EVENT_CDROM,
-                            global_cycles + delay,
-                            CDROM_EventCallback);
+    cdrom_next_sector();
 }
 
 /* ---- Pending response callback ---- */
@@ -879,10 +1146,10 @@ static void CDROM_PendingCallback(int ticks_late)
 /* ---- Schedule a CD-ROM event (public, called from dynarec) ---- */
 void CDROM_ScheduleEvent(void)
 {
-    if (cdrom.reading)
+    if (cdrom.reading || cdrom.playing)
     {
         Sched_Add(SCHED_EVENT_CDROM,
-                                global_cycles + cdrom_read_delay(),
+                                global_cycles + (cdrom.playing ? CDROM_READ_CYCLES_1X : cdrom_read_delay()),
                                 CDROM_EventCallback);
     }
 }
@@ -943,6 +1210,7 @@ void CDROM_Write(uint32_t addr, uint32_t data)
         case 2: /* Sound Map Coding Info */
             break;
         case 3: /* Audio Volume Right→Left */
+            cdrom.atten[2] = val;
             break;
         }
         break;
@@ -966,8 +1234,10 @@ void CDROM_Write(uint32_t addr, uint32_t data)
             }
             break;
         case 2: /* Audio Volume Left→Left */
+            cdrom.atten[0] = val;
             break;
         case 3: /* Audio Volume Right→Right */
+            cdrom.atten[3] = val;
             break;
         }
         break;
@@ -985,6 +1255,7 @@ void CDROM_Write(uint32_t addr, uint32_t data)
                 /* Clear data FIFO */
                 cdrom.data_pos = 0;
                 cdrom.data_len = 0;
+                cdrom.data_deferred = 0;
             }
             break;
         case 1: /* Interrupt Flag Register (acknowledge) */
@@ -1018,10 +1289,35 @@ void CDROM_Write(uint32_t addr, uint32_t data)
             break;
         }
         case 2: /* Audio Volume Left→Right */
+            cdrom.atten[1] = val;
             break;
         case 3: /* Apply Audio Volume changes */
+            cdrom.adpcm_muted = val & 0x01;
+            CDXA_SetMute(cdrom.cmd_muted || cdrom.adpcm_muted);
+            if (val & 0x20)
+                CDXA_SetVolume(cdrom.atten[0], cdrom.atten[1], cdrom.atten[2], cdrom.atten[3]);
             break;
         }
         break;
     }
 }
+
+/* ---- Save state: controller, FIFOs and head position.  A read in
+ * progress re-aims the read-ahead thread at the restored head, a Play
+ * restarts the CD-DA stream there. ---- */
+void CDROM_State(StateIO *io)
+{
+    STATE_VAR(io, cdrom);
+    STATE_VAR(io, cdrom_irq_active);
+    STATE_VAR(io, cdrom_late_retries);
+    if (io->load)
+        cdrom_fill_fifo();
+    if (io->load && cdrom.reading)
+        CDIO_Seek(cdrom_file_lba(cdrom.cur_lba));
+    if (io->load)
+    {
+        CDDA_Stop();
+        if (cdrom.playing && !cdrom.seek_pending)
+            CDDA_Play(cdrom_file_lba(cdrom.cur_lba));
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * SuperPSX - CD-ROM CD-DA Playback
+ *
+ * Play (command 03h) streams the raw 44.1 kHz stereo sectors of the
+ * CUE sheet's audio tracks into a ring of about a second and a half.
+ * The ring is filled CDDA_CHUNK sectors at a time with one
+ * ISO_ReadAudio call, by the read-ahead thread (cdrom_io.c) when it
+ * runs, else from CDDA_Mix, so music takes a few large sequential reads
+ * per second instead of one per sector.  CDDA_Mix resamples it to the
+ * SPU output rate and mixes it through the same attenuation matrix and
+ * SPU CD input volume as XA-ADPCM.
+ *
+ * One producer (CDDA_Fill) and one consumer (the emulator thread):
+ * cdda_wr is only written by the producer, cdda_rd only by the
+ * consumer.  A seek bumps cdda_gen; sectors of an older generation are
+ * dropped by the consumer (same scheme as cdrom_io.c).
+ */
+
+#include "superpsx.h"
+#include "iso_image.h"
+#include <string.h>
+
+#define LOG_TAG "CDDA"
+
+#define CDDA_FRAMES 588 /* stereo frames per 2352-byte sector */
+#define CDDA_CHUNK  16  /* sectors per read, ~0.2 s */
+#define CDDA_RING   96  /* sectors, multiple of CDDA_CHUNK */
+
+#define CDDA_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static int16_t cdda_ring[CDDA_RING][CDDA_FRAMES * 2] __attribute__((aligned(64)));
+static uint32_t cdda_slot_gen[CDDA_RING];
+static volatile uint32_t cdda_rd, cdda_wr; /* sectors, free-running */
+static volatile uint32_t cdda_gen;
+static volatile uint32_t cdda_req_lba;
+static volatile int cdda_active;
+
+/* Producer side */
+static uint32_t cdda_fill_gen, cdda_fill_lba;
+
+/* Consumer side: frame within the sector at cdda_rd, 16.16 step */
+static uint32_t cdda_frame, cdda_frac;
+static uint32_t cdda_step = 1u << 16;
+
+void CDDA_SetOutputRate(int rate)
+{
+    cdda_step = (44100u << 16) / (uint32_t)rate;
+}
+
+void CDDA_Play(uint32_t lba)
+{
+    cdda_rd = cdda_wr; /* a chunk still being read is dropped by its gen */
+    cdda_frame = cdda_frac = 0;
+    cdda_req_lba = lba;
+    CDDA_BARRIER();
+    cdda_gen++;
+    cdda_active = 1;
+    DLOG("Play from LBA %" PRIu32 "\n", lba);
+    CDIO_Wake();
+}
+
+void CDDA_Stop(void)
+{
+    cdda_active = 0;
+}
+
+int CDDA_Fill(void)
+{
+    if (!cdda_active)
+        return 0;
+
+    uint32_t gen = cdda_gen;
+    if (gen != cdda_fill_gen)
+    {
+        cdda_fill_gen = gen;
+        CDDA_BARRIER();
+        cdda_fill_lba = cdda_req_lba;
+    }
+
+    /* Up to the next chunk boundary, so reads stay chunk-sized and never
+     * wrap the ring */
+    uint32_t wr = cdda_wr, pos = wr % CDDA_RING;
+    uint32_t n = CDDA_CHUNK - pos % CDDA_CHUNK;
+    if (wr + n - cdda_rd > CDDA_RING || cdda_fill_lba >= ISO_GetDiscEnd())
+        return 0;
+
+    int got = ISO_ReadAudio(cdda_fill_lba, n, (uint8_t *)cdda_ring[pos]);
+    if (got <= 0)
+    {
+        /* Keep time with silence */
+        DLOG("Read failed at LBA %" PRIu32 "\n", cdda_fill_lba);
+        memset(cdda_ring[pos], 0, (size_t)n * sizeof(cdda_ring[0]));
+        got = (int)n;
+    }
+    for (int i = 0; i < got; i++)
+        cdda_slot_gen[pos + i] = gen;
+    CDDA_BARRIER();
+    cdda_wr = wr + (uint32_t)got;
+    cdda_fill_lba += (uint32_t)got;
+    return 1;
+}
+
+/* Sector at the ring head if it belongs to the current stream; drops
+ * stale ones on the way */
+static const int16_t *cdda_sector(void)
+{
+    while (cdda_rd != cdda_wr)
+    {
+        uint32_t slot = cdda_rd % CDDA_RING;
+        CDDA_BARRIER();
+        if (cdda_slot_gen[slot] == cdda_gen)
+            return cdda_ring[slot];
+        cdda_rd++;
+        cdda_frame = 0;
+    }
+    return NULL;
+}
+
+void CDDA_Mix(int32_t *ml, int32_t *mr, int n, int32_t vol_l, int32_t vol_r)
+{
+    if (!cdda_active)
+        return;
+    if (!CDIO_Active())
+        while (CDDA_Fill())
+            ;
+
+    int32_t g[4];
+    CDXA_Gains(vol_l, vol_r, g);
+
+    uint32_t rd = cdda_rd;
+    const int16_t *s = cdda_sector();
+    for (int i = 0; i < n && s; i++)
+    {
+        /* Linear between this frame and the next one of the sector */
+        const int16_t *a = s + cdda_frame * 2;
+        const int16_t *b = (cdda_frame + 1 < CDDA_FRAMES) ? a + 2 : a;
+        int32_t f = (int32_t)(cdda_frac >> 4);
+        int32_t l = a[0] + (((b[0] - a[0]) * f) >> 12);
+        int32_t r = a[1] + (((b[1] - a[1]) * f) >> 12);
+
+        ml[i] += (l * g[0] + r * g[2]) >> 14;
+        mr[i] += (l * g[1] + r * g[3]) >> 14;
+
+        cdda_frac += cdda_step;
+        cdda_frame += cdda_frac >> 16;
+        cdda_frac &= 0xFFFF;
+        if (cdda_frame >= CDDA_FRAMES)
+        {
+            cdda_frame -= CDDA_FRAMES;
+            cdda_rd++;
+            s = cdda_sector();
+        }
+    }
+    if (cdda_rd != rd)
+        CDIO_Wake(); /* room for another chunk, maybe */
+}
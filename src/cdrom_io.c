@@ -0,0 +1,216 @@
+/*
+ * SuperPSX - CD-ROM Read-Ahead Thread (cdrom_async)
+ *
+ * ReadN/ReadS hand the start LBA to CDIO_Seek; a worker thread then reads
+ * that sector and the ones after it into a ring of slots while the
+ * emulator runs, on the assumption that the game keeps reading
+ * sequentially.  The sector callback takes its data from the ring with
+ * CDIO_ReadSector / CDIO_ReadSectorRaw, which have the ISO_Read* contract
+ * and block until the worker delivers when it is still behind.
+ *
+ * While CD-DA plays the worker also refills its ring (CDDA_Fill), a
+ * chunk at a time, ahead of data sectors.
+ *
+ * One producer (the worker) and one consumer (the emulator thread):
+ * cdio_tail is only written by the worker, cdio_head only by the
+ * emulator.  A seek bumps cdio_gen; slots of an older generation are
+ * dropped by the consumer.
+ */
+
+#include "superpsx.h"
+#include "iso_image.h"
+#include "platform.h"
+#include <string.h>
+
+#define LOG_TAG "CDIO"
+
+#define CDIO_SLOTS      32 /* ~0.2 s of 2x-speed reading */
+#define CDIO_STACK_SIZE (16 * 1024)
+
+/* Orders the slot contents against the index update that publishes them */
+#define CDIO_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+typedef struct
+{
+    uint32_t lba; /* file LBA */
+    uint32_t gen;
+    uint8_t raw_ok;  /* buf holds ISO_ReadSectorRaw output */
+    uint8_t data_ok; /* user data readable (buf + 8 if raw_ok, else buf) */
+    uint8_t buf[ISO_MODE2_SIZE];
+} CdioSlot;
+
+static CdioSlot cdio_slots[CDIO_SLOTS];
+static volatile uint32_t cdio_head, cdio_tail; /* free-running */
+static volatile uint32_t cdio_gen;
+static volatile uint32_t cdio_req_lba;
+static volatile int cdio_req_active;
+static volatile uint32_t cdio_work_lba, cdio_work_gen; /* slot being read */
+static int cdio_thread = -1;
+static int cdio_wake = -1;   /* worker: a slot was freed, a seek issued or CDDA wants data */
+static int cdio_filled = -1; /* consumer: a slot was published */
+
+static void cdio_worker(void *arg)
+{
+    uint32_t gen = cdio_gen - 1, lba = 0;
+    (void)arg;
+
+    for (;;)
+    {
+        if (gen != cdio_gen)
+        {
+            gen = cdio_gen;
+            CDIO_BARRIER();
+            lba = cdio_req_lba;
+        }
+        if (CDDA_Fill())
+            continue;
+        if (!cdio_req_active || cdio_tail - cdio_head >= CDIO_SLOTS)
+        {
+            Platform_SemaWait(cdio_wake);
+            continue;
+        }
+
+        cdio_work_lba = lba;
+        CDIO_BARRIER();
+        cdio_work_gen = gen;
+
+        CdioSlot *s = &cdio_slots[cdio_tail % CDIO_SLOTS];
+        s->lba = lba;
+        s->gen = gen;
+        s->raw_ok = ISO_ReadSectorRaw(lba, s->buf) == 0;
+        s->data_ok = s->raw_ok || ISO_ReadSector(lba, s->buf) == 0;
+        CDIO_BARRIER();
+        cdio_tail++;
+        lba++;
+        Platform_SemaSignal(cdio_filled);
+    }
+}
+
+int CDIO_Start(void)
+{
+    if (cdio_thread >= 0)
+        return 0;
+
+    ISO_EnableThreadedAccess();
+    cdio_wake = Platform_SemaCreate(0, 1);
+    cdio_filled = Platform_SemaCreate(0, 1);
+    if (cdio_wake < 0 || cdio_filled < 0)
+        return -1;
+    cdio_thread = Platform_ThreadStart("cdrom_io", cdio_worker, NULL, CDIO_STACK_SIZE);
+    if (cdio_thread < 0)
+    {
+        printf("[CDIO] Worker thread failed, CD reads stay synchronous\n");
+        return -1;
+    }
+    printf("[CDIO] Read-ahead thread started (%d sectors)\n", CDIO_SLOTS);
+    return 0;
+}
+
+int CDIO_Active(void)
+{
+    return cdio_thread >= 0;
+}
+
+void CDIO_Wake(void)
+{
+    if (cdio_thread >= 0)
+        Platform_SemaSignal(cdio_wake);
+}
+
+/* Slot at the ring head if it is lba of the current generation; drops
+ * stale and passed-over slots on the way */
+static CdioSlot *cdio_find(uint32_t lba)
+{
+    while (cdio_head != cdio_tail)
+    {
+        CdioSlot *s = &cdio_slots[cdio_head % CDIO_SLOTS];
+        if (s->gen == cdio_gen)
+        {
+            if (s->lba == lba)
+                return s;
+            if (s->lba > lba)
+                return NULL; /* went backwards without a seek */
+        }
+        cdio_head++;
+        Platform_SemaSignal(cdio_wake);
+    }
+    return NULL;
+}
+
+void CDIO_Seek(uint32_t lba)
+{
+    if (cdio_thread < 0)
+        return;
+    cdio_req_active = 1;
+    if (!cdio_find(lba))
+    {
+        cdio_head = cdio_tail; /* a slot still being read is dropped by its gen */
+        cdio_req_lba = lba;
+        CDIO_BARRIER();
+        cdio_gen++;
+    }
+    Platform_SemaSignal(cdio_wake);
+}
+
+void CDIO_Stop(void)
+{
+    /* Prefetched slots stay valid for a ReadN that resumes here */
+    cdio_req_active = 0;
+}
+
+int CDIO_Ready(uint32_t lba)
+{
+    return cdio_thread < 0 || cdio_find(lba) != NULL;
+}
+
+/* 1 if the worker, as it stands, will still produce lba */
+static int cdio_reaches(uint32_t lba)
+{
+    if (!cdio_req_active || cdio_head != cdio_tail) /* head slot is past lba */
+        return 0;
+    if (cdio_work_gen != cdio_gen) /* seek not picked up yet */
+        return lba - cdio_req_lba < CDIO_SLOTS;
+    return lba - cdio_work_lba < CDIO_SLOTS;
+}
+
+/* Blocking fallback: wait for the worker to reach lba */
+static CdioSlot *cdio_wait(uint32_t lba)
+{
+    CdioSlot *s = cdio_find(lba);
+    if (s)
+        return s;
+    if (!cdio_reaches(lba))
+        CDIO_Seek(lba);
+    while (!(s = cdio_find(lba)))
+        Platform_SemaWait(cdio_filled);
+    return s;
+}
+
+int CDIO_ReadSector(uint32_t lba, uint8_t *buf)
+{
+    if (cdio_thread < 0)
+        return ISO_ReadSector(lba, buf);
+
+    const CdioSlot *s = cdio_wait(lba);
+    if (!s->data_ok)
+    {
+        memset(buf, 0, ISO_SECTOR_SIZE);
+        return -1;
+    }
+    /* A raw slot holds the subheader in front of the form-1 user data */
+    memcpy(buf, s->buf + (s->raw_ok ? RAW_DATA_OFFSET - RAW_MODE1_OFFSET : 0),
+           ISO_SECTOR_SIZE);
+    return 0;
+}
+
+int CDIO_ReadSectorRaw(uint32_t lba, uint8_t *buf)
+{
+    if (cdio_thread < 0)
+        return ISO_ReadSectorRaw(lba, buf);
+
+    const CdioSlot *s = cdio_wait(lba);
+    if (!s->raw_ok)
+        return -1;
+    memcpy(buf, s->buf, ISO_MODE2_SIZE);
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * SuperPSX - CD-ROM XA-ADPCM Audio Streaming
+ *
+ * With SetMode bit 6 set, ReadN/ReadS hand mode-2 form-2 sectors whose
+ * subheader carries the audio flag to CDXA_PushSector instead of the
+ * data FIFO.  The sector is only queued there: the ADPCM is decoded
+ * ahead on demand from SPU_GenerateChunk, one 128-byte sound group
+ * (4 or 8 units of 28 samples) at a time, so decode work is spread over
+ * the audio chunks of a frame instead of landing in the sector callback.
+ *
+ * Decoded samples (37.8 or 18.9 kHz) sit in a small ring, are resampled
+ * to the SPU output rate, sent through the CD-ROM attenuation matrix and mixed
+ * into the SPU buffers with the SPU CD input volume.
+ */
+
+#include "superpsx.h"
+#include "savestate.h"
+#include <string.h>
+
+#define LOG_TAG "CDXA"
+
+#define XA_QUEUE_SECTORS 8 /* sectors held ahead of the decoder */
+#define XA_GROUPS        18
+#define XA_GROUP_SIZE    128
+#define XA_UNIT_SAMPLES  28
+#define XA_RING          1024 /* decoded samples per channel, power of two */
+
+/* Source samples per output sample, 16.16 (SPU output rate, see
+ * CDXA_SetOutputRate) */
+static uint32_t xa_step_37k = (37800u << 16) / 44100u;
+static uint32_t xa_step_18k = (18900u << 16) / 44100u;
+
+static const int32_t xa_filter_pos[4] = {0, 60, 115, 98};
+static const int32_t xa_filter_neg[4] = {0, 0, -52, -55};
+
+typedef struct
+{
+    uint8_t coding; /* subheader coding info */
+    uint8_t data[XA_GROUPS * XA_GROUP_SIZE];
+} XASector;
+
+static XASector xa_queue[XA_QUEUE_SECTORS];
+static int xa_q_head, xa_q_count;
+static int xa_group; /* next sound group of the head sector */
+
+static int16_t xa_pcm_l[XA_RING], xa_pcm_r[XA_RING];
+static uint32_t xa_rd, xa_wr; /* free-running ring indices */
+static uint32_t xa_frac;      /* position between xa_rd and xa_rd + 1 */
+static uint32_t xa_step = (37800u << 16) / 44100u;
+static int32_t xa_hist[2][2]; /* per channel: previous, one before */
+
+/* Attenuation matrix (0x80 = unity): L→L, L→R, R→L, R→R */
+static int32_t xa_atten[4] = {0x80, 0, 0, 0x80};
+static int xa_muted;
+
+void CDXA_State(StateIO *io)
+{
+    STATE_VAR(io, xa_queue);
+    STATE_VAR(io, xa_q_head);
+    STATE_VAR(io, xa_q_count);
+    STATE_VAR(io, xa_group);
+    STATE_VAR(io, xa_pcm_l);
+    STATE_VAR(io, xa_pcm_r);
+    STATE_VAR(io, xa_rd);
+    STATE_VAR(io, xa_wr);
+    STATE_VAR(io, xa_frac);
+    STATE_VAR(io, xa_step);
+    STATE_VAR(io, xa_hist);
+    STATE_VAR(io, xa_atten);
+    STATE_VAR(io, xa_muted);
+}
+
+void CDXA_Reset(void)
+{
+    xa_q_head = xa_q_count = 0;
+    xa_group = 0;
+    xa_rd = xa_wr = 0;
+    xa_frac = 0;
+    memset(xa_hist, 0, sizeof(xa_hist));
+}
+
+void CDXA_SetOutputRate(int rate)
+{
+    xa_step_37k = (37800u << 16) / (uint32_t)rate;
+    xa_step_18k = (18900u << 16) / (uint32_t)rate;
+    xa_step = xa_step_37k;
+}
+
+void CDXA_SetVolume(uint8_t ll, uint8_t lr, uint8_t rl, uint8_t rr)
+{
+    xa_atten[0] = ll;
+    xa_atten[1] = lr;
+    xa_atten[2] = rl;
+    xa_atten[3] = rr;
+}
+
+void CDXA_SetMute(int muted)
+{
+    xa_muted = muted;
+}
+
+void CDXA_PushSector(const uint8_t *sub)
+{
+    if (xa_q_count == XA_QUEUE_SECTORS)
+    {
+        /* Decoder fell behind (unfiltered interleave): drop the oldest */
+        DLOG("Queue full, dropping sector\n");
+        xa_q_head = (xa_q_head + 1) % XA_QUEUE_SECTORS;
+        xa_q_count--;
+        xa_group = 0;
+    }
+    XASector *s = &xa_queue[(xa_q_head + xa_q_count) % XA_QUEUE_SECTORS];
+    s->coding = sub[3];
+    memcpy(s->data, sub + 8, sizeof(s->data));
+    xa_q_count++;
+}
+
+/* One 28-sample sound unit.  Extraction of the shifted samples has no
+ * dependency between samples; only the second pass carries the filter
+ * history (same split as the SPU block decoder). */
+static void xa_decode_unit(const uint8_t *grp, int unit, int eight_bit,
+                           int16_t *out, int32_t *hist)
+{
+    int32_t raw[XA_UNIT_SAMPLES];
+    uint8_t param = grp[4 + unit];
+    int shift = param & 0x0F;
+    int filter = (param >> 4) & 3;
+    const uint8_t *src = grp + 16;
+
+    if (shift > 12)
+        shift = 9;
+    if (eight_bit)
+    {
+        for (int j = 0; j < XA_UNIT_SAMPLES; j++)
+            raw[j] = (int32_t)(int16_t)(src[j * 4 + unit] << 8) >> shift;
+    }
+    else
+    {
+        int nshift = (unit & 1) ? 8 : 12;
+        for (int j = 0; j < XA_UNIT_SAMPLES; j++)
+            raw[j] = (int32_t)(int16_t)((src[j * 4 + (unit >> 1)] << nshift) & 0xF000) >> shift;
+    }
+
+    int32_t f0 = xa_filter_pos[filter], f1 = xa_filter_neg[filter];
+    int32_t s1 = hist[0], s2 = hist[1];
+    for (int j = 0; j < XA_UNIT_SAMPLES; j++)
+    {
+        int32_t s = raw[j] + ((s1 * f0 + s2 * f1 + 32) >> 6);
+        if (s > 32767)
+            s = 32767;
+        else if (s < -32768)
+            s = -32768;
+        out[j] = (int16_t)s;
+        s2 = s1;
+        s1 = s;
+    }
+    hist[0] = s1;
+    hist[1] = s2;
+}
+
+/* Decode the next sound group into the ring.  Returns 0 when the queue
+ * is empty. */
+static int xa_decode_group(void)
+{
+    if (!xa_q_count)
+        return 0;
+
+    const XASector *s = &xa_queue[xa_q_head];
+    const uint8_t *grp = s->data + xa_group * XA_GROUP_SIZE;
+    int stereo = (s->coding & 3) == 1;
+    int eight_bit = ((s->coding >> 4) & 3) == 1;
+    int units = eight_bit ? 4 : 8;
+    int16_t pcm[XA_UNIT_SAMPLES];
+
+    xa_step = (((s->coding >> 2) & 3) == 1) ? xa_step_18k : xa_step_37k;
+    for (int u = 0; u < units; u++)
+    {
+        int right = stereo && (u & 1);
+        uint32_t base = xa_wr + (uint32_t)(stereo ? (u >> 1) : u) * XA_UNIT_SAMPLES;
+        xa_decode_unit(grp, u, eight_bit, pcm, xa_hist[right]);
+        for (int j = 0; j < XA_UNIT_SAMPLES; j++)
+        {
+            uint32_t idx = (base + j) & (XA_RING - 1);
+            if (right)
+                xa_pcm_r[idx] = pcm[j];
+            else
+            {
+                xa_pcm_l[idx] = pcm[j];
+                if (!stereo)
+                    xa_pcm_r[idx] = pcm[j];
+            }
+        }
+    }
+    xa_wr += (uint32_t)(stereo ? units / 2 : units) * XA_UNIT_SAMPLES;
+
+    if (++xa_group == XA_GROUPS)
+    {
+        xa_group = 0;
+        xa_q_head = (xa_q_head + 1) % XA_QUEUE_SECTORS;
+        xa_q_count--;
+    }
+    return 1;
+}
+
+void CDXA_Gains(int32_t vol_l, int32_t vol_r, int32_t *g)
+{
+    /* Matrix and SPU CD volume folded into four 1.14 gains */
+    g[0] = g[1] = g[2] = g[3] = 0;
+    if (!xa_muted)
+    {
+        g[0] = (xa_atten[0] * vol_l) >> 8;
+        g[1] = (xa_atten[1] * vol_r) >> 8;
+        g[2] = (xa_atten[2] * vol_l) >> 8;
+        g[3] = (xa_atten[3] * vol_r) >> 8;
+    }
+}
+
+void CDXA_Mix(int32_t *ml, int32_t *mr, int n, int32_t vol_l, int32_t vol_r)
+{
+    if (xa_wr - xa_rd < 2 && !xa_q_count)
+        return;
+
+    int32_t g[4];
+    CDXA_Gains(vol_l, vol_r, g);
+
+    for (int i = 0; i < n; i++)
+    {
+        while (xa_wr - xa_rd < 2)
+        {
+            if (!xa_decode_group())
+                return; /* stream ran dry */
+        }
+
+        uint32_t a = xa_rd & (XA_RING - 1), b = (xa_rd + 1) & (XA_RING - 1);
+        int32_t f = (int32_t)(xa_frac >> 4);
+        int32_t l = xa_pcm_l[a] + (((xa_pcm_l[b] - xa_pcm_l[a]) * f) >> 12);
+        int32_t r = xa_pcm_r[a] + (((xa_pcm_r[b] - xa_pcm_r[a]) * f) >> 12);
+
+        ml[i] += (l * g[0] + r * g[2]) >> 14;
+        mr[i] += (l * g[1] + r * g[3]) >> 14;
+
+        xa_frac += xa_step;
+        xa_rd += xa_frac >> 16;
+        xa_frac &= 0xFFFF;
+    }
+}
@@ -35,27 +35,677 @@ static char *str_trim(char *buf)
     return buf;
 }
 
+/* "exact" / "fast" / "ultra" (or 0-2) -> GTE_TIER_*, -1 if unknown */
+static int parse_gte_tier(const char *val)
+{
+    if (strcasecmp(val, "exact") == 0 || strcmp(val, "0") == 0)
+        return GTE_TIER_EXACT;
+    if (strcasecmp(val, "fast") == 0 || strcmp(val, "1") == 0)
+        return GTE_TIER_FAST;
+    if (strcasecmp(val, "ultra") == 0 || strcasecmp(val, "ultra-fast") == 0 || strcmp(val, "2") == 0)
+        return GTE_TIER_ULTRA;
+    printf("CONFIG: unknown gte_accuracy '%s' (exact, fast, ultra)\n", val);
+    return -1;
+}
+
+/* Per-game entry for id, created on first use; NULL when the table is full */
+static PSXGameConfig *config_game(const char *id)
+{
+    for (int i = 0; i < psx_config.game_count; i++)
+    {
+        if (strcasecmp(psx_config.games[i].id, id) == 0)
+            return &psx_config.games[i];
+    }
+    if (psx_config.game_count >= CONFIG_GAME_MAX)
+        return NULL;
+    PSXGameConfig *g = &psx_config.games[psx_config.game_count++];
+    memset(g, 0, sizeof(*g));
+    strncpy(g->id, id, sizeof(g->id) - 1);
+    g->gte_accuracy = -1;
+    return g;
+}
+
+/* Comma/space separated hex PCs ("80012340, 0x80045678") appended to
+ * pcs; returns the new count */
+static int parse_pc_list(const char *val, uint32_t *pcs, int count)
+{
+    while (*val && count < CONFIG_INTERP_MAX)
+    {
+        char *end;
+        unsigned long pc = strtoul(val, &end, 16);
+        if (end == val)
+        {
+            val++;
+            continue;
+        }
+        if ((pc & 3) == 0)
+            pcs[count++] = (uint32_t)pc;
+        val = end;
+    }
+    return count;
+}
+
+/* One 'key = value' setting, from the global part of the file or, once
+ * the game ID is known, from that game's section */
+static void config_set(const char *key, const char *val)
+{
+    if (strcasecmp(key, "rom") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_exe_filename_buf, val, PSX_EXE_PATH_MAX - 1);
+        psx_exe_filename_buf[PSX_EXE_PATH_MAX - 1] = '\0';
+        psx_exe_filename = psx_exe_filename_buf;
+        printf("CONFIG: rom = %s\n", psx_exe_filename);
+    }
+    else if (strcasecmp(key, "boot") == 0)
+    {
+        if (strcasecmp(val, "bios") == 0)
+            psx_config.boot_bios_only = 1;
+        else
+            psx_config.boot_bios_only = 0;
+        printf("CONFIG: boot = %s\n", val);
+    }
+    else if (strcasecmp(key, "bios") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_config.bios_path, val, sizeof(psx_config.bios_path) - 1);
+        psx_config.bios_path[sizeof(psx_config.bios_path) - 1] = '\0';
+        printf("CONFIG: bios = %s\n", psx_config.bios_path);
+    }
+    else if (strcasecmp(key, "audio") == 0)
+    {
+        psx_config.audio_enabled = (strcasecmp(val, "disabled") != 0);
+        printf("CONFIG: audio = %s\n", psx_config.audio_enabled ? "enabled" : "disabled");
+    }
+    else if (strcasecmp(key, "spu_reverb") == 0)
+    {
+        if (strcasecmp(val, "full") == 0)
+            psx_config.spu_reverb = 2;
+        else if (strcasecmp(val, "fast") == 0)
+            psx_config.spu_reverb = 1;
+        else
+        {
+            psx_config.spu_reverb = atoi(val);
+            if (psx_config.spu_reverb < 0 || psx_config.spu_reverb > 2)
+                psx_config.spu_reverb = 0;
+        }
+        printf("CONFIG: spu_reverb = %d\n", psx_config.spu_reverb);
+    }
+    else if (strcasecmp(key, "audio_rate") == 0)
+    {
+        psx_config.audio_rate = atoi(val);
+        if (psx_config.audio_rate != 32000 && psx_config.audio_rate != 22050)
+            psx_config.audio_rate = 44100;
+        printf("CONFIG: audio_rate = %d\n", psx_config.audio_rate);
+    }
+    else if (strcasecmp(key, "audio_latency") == 0)
+    {
+        psx_config.audio_latency = atoi(val);
+        if (psx_config.audio_latency < 0 || psx_config.audio_latency > 500)
+            psx_config.audio_latency = 0;
+        else if (psx_config.audio_latency && psx_config.audio_latency < 20)
+            psx_config.audio_latency = 20;
+        printf("CONFIG: audio_latency = %d\n", psx_config.audio_latency);
+    }
+    else if (strcasecmp(key, "controllers") == 0)
+    {
+        psx_config.controllers_enabled = (strcasecmp(val, "disabled") != 0);
+        printf("CONFIG: controllers = %s\n", psx_config.controllers_enabled ? "enabled" : "disabled");
+    }
+    else if (strcasecmp(key, "pad_thread") == 0)
+    {
+        psx_config.pad_thread = (atoi(val) != 0 || strcasecmp(val, "true") == 0);
+        printf("CONFIG: pad_thread = %d\n", psx_config.pad_thread);
+    }
+    else if (strcasecmp(key, "region") == 0)
+    {
+        psx_config.region_pal = (strcasecmp(val, "pal") == 0);
+        printf("CONFIG: region = %s\n", psx_config.region_pal ? "pal" : "ntsc");
+    }
+    else if (strcasecmp(key, "disable_audio") == 0)
+    {
+        psx_config.disable_audio = (atoi(val) != 0 || strcasecmp(val, "true") == 0);
+        printf("CONFIG: disable_audio = %d\n", psx_config.disable_audio);
+    }
+    else if (strcasecmp(key, "disable_gpu") == 0)
+    {
+        psx_config.disable_gpu = (atoi(val) != 0 || strcasecmp(val, "true") == 0);
+        printf("CONFIG: disable_gpu = %d\n", psx_config.disable_gpu);
+    }
+    else if (strcasecmp(key, "gpu_reorder") == 0)
+    {
+        psx_config.gpu_reorder = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gpu_reorder = %d\n", psx_config.gpu_reorder);
+    }
+    else if (strcasecmp(key, "gpu_replay") == 0)
+    {
+        psx_config.gpu_replay = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gpu_replay = %d\n", psx_config.gpu_replay);
+    }
+    else if (strcasecmp(key, "gpu_queue") == 0)
+    {
+        psx_config.gpu_queue = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gpu_queue = %d\n", psx_config.gpu_queue);
+    }
+    else if (strcasecmp(key, "gpu_field_render") == 0)
+    {
+        psx_config.gpu_field_render = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gpu_field_render = %d\n", psx_config.gpu_field_render);
+    }
+    else if (strcasecmp(key, "gpu_dither_off") == 0)
+    {
+        psx_config.gpu_dither_off = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gpu_dither_off = %d\n", psx_config.gpu_dither_off);
+    }
+    else if (strcasecmp(key, "gpu_psp_kick") == 0)
+    {
+        psx_config.gpu_psp_kick = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gpu_psp_kick = %d\n", psx_config.gpu_psp_kick);
+    }
+    else if (strcasecmp(key, "gpu_psp_direct_tex") == 0)
+    {
+        psx_config.gpu_psp_direct_tex = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gpu_psp_direct_tex = %d\n", psx_config.gpu_psp_direct_tex);
+    }
+    else if (strcasecmp(key, "mdec_async") == 0)
+    {
+        psx_config.mdec_async = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: mdec_async = %d\n", psx_config.mdec_async);
+    }
+    else if (strcasecmp(key, "dma_timing") == 0)
+    {
+        psx_config.dma_timing = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: dma_timing = %d\n", psx_config.dma_timing);
+    }
+    else if (strcasecmp(key, "frameskip") == 0)
+    {
+        psx_config.frameskip = atoi(val);
+        if (psx_config.frameskip < 0 || psx_config.frameskip > 8)
+            psx_config.frameskip = 0;
+        printf("CONFIG: frameskip = %d\n", psx_config.frameskip);
+    }
+    else if (strcasecmp(key, "fast_forward") == 0)
+    {
+        psx_config.fast_forward = atoi(val);
+        if (psx_config.fast_forward < 0 || psx_config.fast_forward > 16)
+            psx_config.fast_forward = 0;
+        printf("CONFIG: fast_forward = %d\n", psx_config.fast_forward);
+    }
+    else if (strcasecmp(key, "hblank_lazy") == 0)
+    {
+        psx_config.hblank_lazy = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: hblank_lazy = %d\n", psx_config.hblank_lazy);
+    }
+    else if (strcasecmp(key, "frame_limit") == 0)
+    {
+        psx_config.frame_limit = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: frame_limit = %d\n", psx_config.frame_limit);
+    }
+    else if (strcasecmp(key, "gte_vu0") == 0)
+    {
+        psx_config.gte_vu0 = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gte_vu0 = %d\n", psx_config.gte_vu0);
+    }
+    else if (strcasecmp(key, "gte_vu1_batch") == 0)
+    {
+        psx_config.gte_vu1_batch = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gte_vu1_batch = %d\n", psx_config.gte_vu1_batch);
+    }
+    else if (strcasecmp(key, "gte_lazy_flags") == 0)
+    {
+        psx_config.gte_lazy_flags = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: gte_lazy_flags = %d\n", psx_config.gte_lazy_flags);
+    }
+    else if (strcasecmp(key, "gte_accuracy") == 0)
+    {
+        psx_config.gte_accuracy = parse_gte_tier(val);
+        printf("CONFIG: gte_accuracy = %d\n", psx_config.gte_accuracy);
+    }
+    else if (strncasecmp(key, "gte_accuracy.", 13) == 0 && key[13] != '\0')
+    {
+        int tier = parse_gte_tier(val);
+        PSXGameConfig *g = (tier >= 0) ? config_game(key + 13) : NULL;
+        if (g)
+        {
+            g->gte_accuracy = tier;
+            printf("CONFIG: gte_accuracy.%s = %d\n", g->id, tier);
+        }
+    }
+    else if (strcasecmp(key, "gte_record") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_config.gte_record, val, sizeof(psx_config.gte_record) - 1);
+        psx_config.gte_record[sizeof(psx_config.gte_record) - 1] = '\0';
+        /* Cached native code would skip the record hooks */
+        psx_config.jit_cache_frames = 0;
+        printf("CONFIG: gte_record = %s\n", psx_config.gte_record);
+    }
+    else if (strcasecmp(key, "gte_record_max") == 0)
+    {
+        psx_config.gte_record_max = atoi(val);
+        if (psx_config.gte_record_max <= 0)
+            psx_config.gte_record_max = 20000;
+        printf("CONFIG: gte_record_max = %d\n", psx_config.gte_record_max);
+    }
+    else if (strcasecmp(key, "show_fps") == 0)
+    {
+        psx_config.show_fps = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: show_fps = %d\n", psx_config.show_fps);
+    }
+    else if (strcasecmp(key, "perf_report") == 0)
+    {
+        psx_config.perf_report = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: perf_report = %d\n", psx_config.perf_report);
+    }
+    else if (strcasecmp(key, "cdrom_fast") == 0)
+    {
+        psx_config.cdrom_fast = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: cdrom_fast = %d\n", psx_config.cdrom_fast);
+    }
+    else if (strcasecmp(key, "cdrom_async") == 0)
+    {
+        psx_config.cdrom_async = atoi(val);
+        if (psx_config.cdrom_async < 0 || psx_config.cdrom_async > 2)
+            psx_config.cdrom_async = 0;
+        printf("CONFIG: cdrom_async = %d\n", psx_config.cdrom_async);
+    }
+    else if (strcasecmp(key, "cdrom_speed") == 0)
+    {
+        psx_config.cdrom_speed = atoi(val);
+        if (psx_config.cdrom_speed < 0 || psx_config.cdrom_speed > 8)
+            psx_config.cdrom_speed = 0;
+        printf("CONFIG: cdrom_speed = %d\n", psx_config.cdrom_speed);
+    }
+    else if (strcasecmp(key, "cdrom_preload") == 0)
+    {
+        psx_config.cdrom_preload = atoi(val);
+        if (psx_config.cdrom_preload < 0)
+            psx_config.cdrom_preload = 0;
+        if (psx_config.cdrom_preload > 24)
+            psx_config.cdrom_preload = 24;
+        printf("CONFIG: cdrom_preload = %d\n", psx_config.cdrom_preload);
+    }
+    else if (strcasecmp(key, "display_integer") == 0)
+    {
+        psx_config.display_mode = (atoi(val) != 0 && strcasecmp(val, "false") != 0) ? 2 : 0;
+        printf("CONFIG: display_mode = %d (via display_integer)\n", psx_config.display_mode);
+    }
+    else if (strcasecmp(key, "display_mode") == 0)
+    {
+        psx_config.display_mode = atoi(val);
+        if (psx_config.display_mode < 0 || psx_config.display_mode > 2)
+            psx_config.display_mode = 0;
+        printf("CONFIG: display_mode = %d\n", psx_config.display_mode);
+    }
+    else if (strcasecmp(key, "display_filter") == 0)
+    {
+        psx_config.display_filter = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: display_filter = %d\n", psx_config.display_filter);
+    }
+    else if (strcasecmp(key, "interpreter") == 0)
+    {
+        psx_config.interpreter = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+#ifdef PLATFORM_HOST
+        psx_config.interpreter = 1; /* No code generator for the host CPU */
+#endif
+        printf("CONFIG: interpreter = %d\n", psx_config.interpreter);
+    }
+    else if (strcasecmp(key, "jit_tier_threshold") == 0)
+    {
+        psx_config.jit_tier_threshold = atoi(val);
+        if (psx_config.jit_tier_threshold < 0 || psx_config.jit_tier_threshold > 65535)
+            psx_config.jit_tier_threshold = 0;
+        printf("CONFIG: jit_tier_threshold = %d\n", psx_config.jit_tier_threshold);
+    }
+    else if (strcasecmp(key, "jit_ht_entries") == 0)
+    {
+        psx_config.jit_ht_entries = atoi(val);
+        if (psx_config.jit_ht_entries < 512 || psx_config.jit_ht_entries > 262144)
+            psx_config.jit_ht_entries = 8192;
+        printf("CONFIG: jit_ht_entries = %d\n", psx_config.jit_ht_entries);
+    }
+    else if (strcasecmp(key, "jit_ht_ways") == 0)
+    {
+        psx_config.jit_ht_ways = (atoi(val) == 4) ? 4 : 2;
+        printf("CONFIG: jit_ht_ways = %d\n", psx_config.jit_ht_ways);
+    }
+    else if (strcasecmp(key, "jit_code_buffer") == 0)
+    {
+        psx_config.jit_code_buffer = atoi(val);
+        if (psx_config.jit_code_buffer < 0 || psx_config.jit_code_buffer > 16)
+            psx_config.jit_code_buffer = 0;
+        printf("CONFIG: jit_code_buffer = %d\n", psx_config.jit_code_buffer);
+    }
+    else if (strcasecmp(key, "psx_tlb") == 0)
+    {
+        psx_config.psx_tlb = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: psx_tlb = %d\n", psx_config.psx_tlb);
+    }
+    else if (strcasecmp(key, "jit_cache_frames") == 0)
+    {
+        psx_config.jit_cache_frames = atoi(val);
+        if (psx_config.jit_cache_frames < 0)
+            psx_config.jit_cache_frames = 0;
+        printf("CONFIG: jit_cache_frames = %d\n", psx_config.jit_cache_frames);
+    }
+    else if (strcasecmp(key, "jit_spec_compile") == 0)
+    {
+        psx_config.jit_spec_compile = atoi(val);
+        if (psx_config.jit_spec_compile < 0 || psx_config.jit_spec_compile > 64)
+            psx_config.jit_spec_compile = 4;
+        printf("CONFIG: jit_spec_compile = %d\n", psx_config.jit_spec_compile);
+    }
+    else if (strcasecmp(key, "jit_sample_hz") == 0)
+    {
+        psx_config.jit_sample_hz = atoi(val);
+        if (psx_config.jit_sample_hz < 0 || psx_config.jit_sample_hz > 20000)
+            psx_config.jit_sample_hz = 0;
+        printf("CONFIG: jit_sample_hz = %d\n", psx_config.jit_sample_hz);
+    }
+    else if (strcasecmp(key, "bios_hle") == 0)
+    {
+        psx_config.bios_hle = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: bios_hle = %d\n", psx_config.bios_hle);
+    }
+    else if (strcasecmp(key, "cycle_model") == 0)
+    {
+        psx_config.cycle_model = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: cycle_model = %d\n", psx_config.cycle_model);
+    }
+    else if (strcasecmp(key, "cycle_scale") == 0)
+    {
+        psx_config.cycle_scale = atoi(val);
+        if (psx_config.cycle_scale < 25 || psx_config.cycle_scale > 400)
+            psx_config.cycle_scale = 100;
+        printf("CONFIG: cycle_scale = %d\n", psx_config.cycle_scale);
+    }
+    else if (strcasecmp(key, "cycle_calib") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_config.cycle_calib, val, sizeof(psx_config.cycle_calib) - 1);
+        psx_config.cycle_calib[sizeof(psx_config.cycle_calib) - 1] = '\0';
+        /* Cached native code would skip the checkpoint hooks */
+        psx_config.jit_cache_frames = 0;
+        printf("CONFIG: cycle_calib = %s\n", psx_config.cycle_calib);
+    }
+    else if (strcasecmp(key, "jit_lazy_cycles") == 0)
+    {
+        psx_config.jit_lazy_cycles = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: jit_lazy_cycles = %d\n", psx_config.jit_lazy_cycles);
+    }
+    else if (strcasecmp(key, "jit_shared_stubs") == 0)
+    {
+        psx_config.jit_shared_stubs = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: jit_shared_stubs = %d\n", psx_config.jit_shared_stubs);
+    }
+    else if (strcasecmp(key, "jit_const_links") == 0)
+    {
+        psx_config.jit_const_links = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: jit_const_links = %d\n", psx_config.jit_const_links);
+    }
+    else if (strcasecmp(key, "jit_fast_irq") == 0)
+    {
+        psx_config.jit_fast_irq = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: jit_fast_irq = %d\n", psx_config.jit_fast_irq);
+    }
+    else if (strcasecmp(key, "jit_inline_caches") == 0)
+    {
+        psx_config.jit_inline_caches = atoi(val);
+        if (psx_config.jit_inline_caches < 0 || psx_config.jit_inline_caches > 4)
+            psx_config.jit_inline_caches = 0;
+        printf("CONFIG: jit_inline_caches = %d\n", psx_config.jit_inline_caches);
+    }
+    else if (strcasecmp(key, "jit_gp0_fifo") == 0)
+    {
+        psx_config.jit_gp0_fifo = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: jit_gp0_fifo = %d\n", psx_config.jit_gp0_fifo);
+    }
+    else if (strcasecmp(key, "jit_interp_smc") == 0)
+    {
+        psx_config.jit_interp_smc = atoi(val);
+        if (psx_config.jit_interp_smc < 0 || psx_config.jit_interp_smc > 255)
+            psx_config.jit_interp_smc = 0;
+        printf("CONFIG: jit_interp_smc = %d\n", psx_config.jit_interp_smc);
+    }
+    else if (strcasecmp(key, "jit_idle_learn") == 0)
+    {
+        psx_config.jit_idle_learn = atoi(val);
+        if (psx_config.jit_idle_learn < 0 || psx_config.jit_idle_learn > 255)
+            psx_config.jit_idle_learn = 0;
+        printf("CONFIG: jit_idle_learn = %d\n", psx_config.jit_idle_learn);
+    }
+    else if (strcasecmp(key, "jit_interp") == 0)
+    {
+        psx_config.jit_interp_count = parse_pc_list(val, psx_config.jit_interp_pcs,
+                                                    psx_config.jit_interp_count);
+        printf("CONFIG: jit_interp = %d blocks\n", psx_config.jit_interp_count);
+    }
+    else if (strncasecmp(key, "jit_interp.", 11) == 0 && key[11] != '\0')
+    {
+        PSXGameConfig *g = config_game(key + 11);
+        if (g)
+        {
+            g->interp_count = parse_pc_list(val, g->interp_pcs, g->interp_count);
+            printf("CONFIG: jit_interp.%s = %d blocks\n", g->id, g->interp_count);
+        }
+    }
+    else if (strcasecmp(key, "mcd1") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_config.mcd1_path, val, sizeof(psx_config.mcd1_path) - 1);
+        psx_config.mcd1_path[sizeof(psx_config.mcd1_path) - 1] = '\0';
+        printf("CONFIG: mcd1 = %s\n", psx_config.mcd1_path);
+    }
+    else if (strcasecmp(key, "mcd2") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_config.mcd2_path, val, sizeof(psx_config.mcd2_path) - 1);
+        psx_config.mcd2_path[sizeof(psx_config.mcd2_path) - 1] = '\0';
+        printf("CONFIG: mcd2 = %s\n", psx_config.mcd2_path);
+    }
+    else if (strcasecmp(key, "mcd_flush_frames") == 0)
+    {
+        psx_config.mcd_flush_frames = atoi(val);
+        if (psx_config.mcd_flush_frames < 0)
+            psx_config.mcd_flush_frames = 0;
+        printf("CONFIG: mcd_flush_frames = %d\n", psx_config.mcd_flush_frames);
+    }
+    else if (strcasecmp(key, "snapshot_frame") == 0)
+    {
+        psx_config.snapshot_frame = atoi(val);
+        if (psx_config.snapshot_frame < 0)
+            psx_config.snapshot_frame = 0;
+        printf("CONFIG: snapshot_frame = %d\n", psx_config.snapshot_frame);
+    }
+    else if (strcasecmp(key, "snapshot_replay") == 0)
+    {
+        psx_config.snapshot_replay = atoi(val);
+        if (psx_config.snapshot_replay < 0)
+            psx_config.snapshot_replay = 0;
+        printf("CONFIG: snapshot_replay = %d\n", psx_config.snapshot_replay);
+    }
+    else if (strcasecmp(key, "boot_snapshot") == 0)
+    {
+        psx_config.boot_snapshot = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
+        printf("CONFIG: boot_snapshot = %d\n", psx_config.boot_snapshot);
+    }
+    else if (strcasecmp(key, "rewind_buffer") == 0)
+    {
+        psx_config.rewind_buffer = atoi(val);
+        if (psx_config.rewind_buffer < 0)
+            psx_config.rewind_buffer = 0;
+        if (psx_config.rewind_buffer > 16)
+            psx_config.rewind_buffer = 16;
+        printf("CONFIG: rewind_buffer = %d\n", psx_config.rewind_buffer);
+    }
+    else if (strcasecmp(key, "rewind_interval") == 0)
+    {
+        psx_config.rewind_interval = atoi(val);
+        if (psx_config.rewind_interval < 1)
+            psx_config.rewind_interval = 1;
+        printf("CONFIG: rewind_interval = %d\n", psx_config.rewind_interval);
+    }
+    else if (strcasecmp(key, "bench_frames") == 0)
+    {
+        psx_config.bench_frames = atoi(val);
+        if (psx_config.bench_frames < 0)
+            psx_config.bench_frames = 0;
+        printf("CONFIG: bench_frames = %d\n", psx_config.bench_frames);
+    }
+    else if (strcasecmp(key, "bench_warmup") == 0)
+    {
+        psx_config.bench_warmup = atoi(val);
+        if (psx_config.bench_warmup < 0)
+            psx_config.bench_warmup = 0;
+        printf("CONFIG: bench_warmup = %d\n", psx_config.bench_warmup);
+    }
+    else if (strcasecmp(key, "bench_vram_hash") == 0)
+    {
+        psx_config.bench_vram_hash = atoi(val);
+        if (psx_config.bench_vram_hash < 0)
+            psx_config.bench_vram_hash = 0;
+        printf("CONFIG: bench_vram_hash = %d\n", psx_config.bench_vram_hash);
+    }
+    else if (strcasecmp(key, "input_record") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_config.input_record, val, sizeof(psx_config.input_record) - 1);
+        psx_config.input_record[sizeof(psx_config.input_record) - 1] = '\0';
+        printf("CONFIG: input_record = %s\n", psx_config.input_record);
+    }
+    else if (strcasecmp(key, "input_play") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_config.input_play, val, sizeof(psx_config.input_play) - 1);
+        psx_config.input_play[sizeof(psx_config.input_play) - 1] = '\0';
+        printf("CONFIG: input_play = %s\n", psx_config.input_play);
+    }
+    else if (strcasecmp(key, "gpu_trace_bench") == 0 && val[0] != '\0')
+    {
+        strncpy(psx_config.gpu_trace_bench, val, sizeof(psx_config.gpu_trace_bench) - 1);
+        psx_config.gpu_trace_bench[sizeof(psx_config.gpu_trace_bench) - 1] = '\0';
+        printf("CONFIG: gpu_trace_bench = %s\n", psx_config.gpu_trace_bench);
+    }
+    else if (strcasecmp(key, "gpu_trace_bench_loops") == 0)
+    {
+        psx_config.gpu_trace_bench_loops = atoi(val);
+        if (psx_config.gpu_trace_bench_loops < 1)
+            psx_config.gpu_trace_bench_loops = 1;
+        printf("CONFIG: gpu_trace_bench_loops = %d\n", psx_config.gpu_trace_bench_loops);
+    }
+}
+
+/* Keys read before the disc is: boot selection, psx_tlb, the memory
+ * plan (MemBudget_Init) and the CD-ROM / memory card setup */
+static const char *const config_global_only[] = {
+    "rom", "boot", "bios", "psx_tlb",
+    "jit_code_buffer", "rewind_buffer", "cdrom_preload", "cdrom_async",
+    "mcd1", "mcd2", "mcd_flush_frames",
+};
+
+/* Section lines are kept as "key\0value\0" pairs and go through
+ * config_set in file order when the game boots.  Keys in
+ * config_global_only are already used by then, so they stay global. */
+static void config_game_add(PSXGameConfig *g, const char *key, const char *val)
+{
+    size_t kl = strlen(key) + 1, vl = strlen(val) + 1;
+
+    for (size_t i = 0; i < sizeof(config_global_only) / sizeof(config_global_only[0]); i++)
+    {
+        if (strcasecmp(key, config_global_only[i]) == 0)
+        {
+            printf("CONFIG: Warning: [%s] %s is global only, ignored\n", g->id, key);
+            return;
+        }
+    }
+    if (g->settings_len + kl + vl > sizeof(g->settings))
+    {
+        printf("CONFIG: Warning: [%s] is full, %s ignored\n", g->id, key);
+        return;
+    }
+    memcpy(g->settings + g->settings_len, key, kl);
+    memcpy(g->settings + g->settings_len + kl, val, vl);
+    g->settings_len += (int)(kl + vl);
+    printf("CONFIG: [%s] %s = %s\n", g->id, key, val);
+}
+
 int load_config_file(void)
 {
     /* Apply defaults */
     psx_config.audio_enabled = 1;
     psx_config.controllers_enabled = 1;
+    psx_config.pad_thread = 0;
     psx_config.region_pal = 0;
     psx_config.boot_bios_only = 0;
     psx_config.disable_audio = 0;
+    psx_config.spu_reverb = 0;
+    psx_config.audio_rate = 44100;
+    psx_config.audio_latency = 0;
     psx_config.disable_gpu = 0;
+    psx_config.gpu_reorder = 0;
+    psx_config.gpu_replay = 0;
+    psx_config.gpu_queue = 0;
+    psx_config.gpu_field_render = 0;
+    psx_config.gpu_dither_off = 0;
+    psx_config.gpu_psp_kick = 0;
+    psx_config.gpu_psp_direct_tex = 1;
+    psx_config.mdec_async = 0;
+    psx_config.dma_timing = 0;
     psx_config.frame_limit = 1;
+    psx_config.frameskip = 0;
+    psx_config.fast_forward = 0;
+    psx_config.hblank_lazy = 0;
     psx_config.gte_vu0 = 1;
+    psx_config.gte_vu1_batch = 0;
+    psx_config.gte_lazy_flags = 0;
+    psx_config.gte_accuracy = -1;
+    psx_config.gte_record[0] = '\0';
+    psx_config.gte_record_max = 20000;
+    psx_config.game_count = 0;
+    psx_config.game_id[0] = '\0';
     psx_config.show_fps = 0;
     psx_config.perf_report = 0;
     psx_config.cdrom_fast = 0;
+    psx_config.cdrom_async = 0;
+    psx_config.cdrom_speed = 0;
+    psx_config.cdrom_preload = 0;
     psx_config.display_mode = 0;
     psx_config.display_filter = 0;
+#ifdef PLATFORM_HOST
+    psx_config.interpreter = 1;
+#else
     psx_config.interpreter = 0;
+#endif
+    psx_config.jit_tier_threshold = 0;
+    psx_config.jit_cache_frames = 0;
+    psx_config.jit_spec_compile = 4;
+    psx_config.jit_sample_hz = 0;
+    psx_config.bios_hle = 0;
+    psx_config.cycle_model = 0;
+    psx_config.cycle_scale = 100;
+    psx_config.cycle_calib[0] = '\0';
+    psx_config.jit_lazy_cycles = 0;
+    psx_config.jit_shared_stubs = 0;
+    psx_config.jit_const_links = 0;
+    psx_config.jit_fast_irq = 0;
+    psx_config.jit_inline_caches = 0;
+    psx_config.jit_gp0_fifo = 0;
+    psx_config.jit_interp_smc = 0;
+    psx_config.jit_idle_learn = 0;
+    psx_config.jit_interp_count = 0;
+    psx_config.jit_ht_entries = 8192;
+    psx_config.jit_ht_ways = 2;
+    psx_config.jit_code_buffer = 0;
+    psx_config.psx_tlb = 0;
     strncpy(psx_config.mcd1_path, "memcard1.mcd", sizeof(psx_config.mcd1_path) - 1);
     psx_config.mcd1_path[sizeof(psx_config.mcd1_path) - 1] = '\0';
     strncpy(psx_config.mcd2_path, "memcard2.mcd", sizeof(psx_config.mcd2_path) - 1);
     psx_config.mcd2_path[sizeof(psx_config.mcd2_path) - 1] = '\0';
+    psx_config.mcd_flush_frames = 30;
+    psx_config.snapshot_frame = 0;
+    psx_config.snapshot_replay = 0;
+    psx_config.rewind_buffer = 0;
+    psx_config.boot_snapshot = 0;
+    psx_config.rewind_interval = 30;
+    psx_config.bench_frames = 0;
+    psx_config.bench_warmup = 0;
+    psx_config.bench_vram_hash = 0;
+    psx_config.input_record[0] = '\0';
+    psx_config.input_play[0] = '\0';
+    psx_config.gpu_trace_bench[0] = '\0';
+    psx_config.gpu_trace_bench_loops = 3;
     strncpy(psx_config.bios_path, BIOS_PATH_DEFAULT, sizeof(psx_config.bios_path) - 1);
     psx_config.bios_path[sizeof(psx_config.bios_path) - 1] = '\0';
 
@@ -90,6 +740,7 @@ int load_config_file(void)
     }
     buf[rr] = '\0';
 
+    PSXGameConfig *section = NULL; /* inside a [GAME_ID] section */
     char *line = buf;
     while (line && *line)
     {
@@ -107,6 +758,23 @@ int load_config_file(void)
             continue;
         }
 
+        /* '[SLUS_005.94]' starts a game section, '[global]' or '[]' ends it */
+        size_t tl = strlen(trimmed);
+        if (trimmed[0] == '[' && trimmed[tl - 1] == ']')
+        {
+            trimmed[tl - 1] = '\0';
+            char *id = str_trim(trimmed + 1);
+            section = NULL;
+            if (id[0] != '\0' && strcasecmp(id, "global") != 0)
+            {
+                section = config_game(id);
+                if (!section)
+                    printf("CONFIG: Warning: no room for [%s], section ignored\n", id);
+            }
+            line = next;
+            continue;
+        }
+
         /* Look for 'key = value' */
         char *eq = strchr(trimmed, '=');
         if (!eq)
@@ -119,114 +787,46 @@ int load_config_file(void)
         char *key = str_trim(trimmed);
         char *val = str_trim(eq + 1);
 
-        if (strcasecmp(key, "rom") == 0 && val[0] != '\0')
-        {
-            strncpy(psx_exe_filename_buf, val, PSX_EXE_PATH_MAX - 1);
-            psx_exe_filename_buf[PSX_EXE_PATH_MAX - 1] = '\0';
-            psx_exe_filename = psx_exe_filename_buf;
-            printf("CONFIG: rom = %s\n", psx_exe_filename);
-        }
-        else if (strcasecmp(key, "boot") == 0)
-        {
-            if (strcasecmp(val, "bios") == 0)
-                psx_config.boot_bios_only = 1;
-            else
-                psx_config.boot_bios_only = 0;
-            printf("CONFIG: boot = %s\n", val);
-        }
-        else if (strcasecmp(key, "bios") == 0 && val[0] != '\0')
-        {
-            strncpy(psx_config.bios_path, val, sizeof(psx_config.bios_path) - 1);
-            psx_config.bios_path[sizeof(psx_config.bios_path) - 1] = '\0';
-            printf("CONFIG: bios = %s\n", psx_config.bios_path);
-        }
-        else if (strcasecmp(key, "audio") == 0)
-        {
-            psx_config.audio_enabled = (strcasecmp(val, "disabled") != 0);
-            printf("CONFIG: audio = %s\n", psx_config.audio_enabled ? "enabled" : "disabled");
-        }
-        else if (strcasecmp(key, "controllers") == 0)
-        {
-            psx_config.controllers_enabled = (strcasecmp(val, "disabled") != 0);
-            printf("CONFIG: controllers = %s\n", psx_config.controllers_enabled ? "enabled" : "disabled");
-        }
-        else if (strcasecmp(key, "region") == 0)
-        {
-            psx_config.region_pal = (strcasecmp(val, "pal") == 0);
-            printf("CONFIG: region = %s\n", psx_config.region_pal ? "pal" : "ntsc");
-        }
-        else if (strcasecmp(key, "disable_audio") == 0)
-        {
-            psx_config.disable_audio = (atoi(val) != 0 || strcasecmp(val, "true") == 0);
-            printf("CONFIG: disable_audio = %d\n", psx_config.disable_audio);
-        }
-        else if (strcasecmp(key, "disable_gpu") == 0)
-        {
-            psx_config.disable_gpu = (atoi(val) != 0 || strcasecmp(val, "true") == 0);
-            printf("CONFIG: disable_gpu = %d\n", psx_config.disable_gpu);
-        }
-        else if (strcasecmp(key, "frame_limit") == 0)
-        {
-            psx_config.frame_limit = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
-            printf("CONFIG: frame_limit = %d\n", psx_config.frame_limit);
-        }
-        else if (strcasecmp(key, "gte_vu0") == 0)
-        {
-            psx_config.gte_vu0 = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
-            printf("CONFIG: gte_vu0 = %d\n", psx_config.gte_vu0);
-        }
-        else if (strcasecmp(key, "show_fps") == 0)
-        {
-            psx_config.show_fps = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
-            printf("CONFIG: show_fps = %d\n", psx_config.show_fps);
-        }
-        else if (strcasecmp(key, "perf_report") == 0)
-        {
-            psx_config.perf_report = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
-            printf("CONFIG: perf_report = %d\n", psx_config.perf_report);
-        }
-        else if (strcasecmp(key, "cdrom_fast") == 0)
-        {
-            psx_config.cdrom_fast = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
-            printf("CONFIG: cdrom_fast = %d\n", psx_config.cdrom_fast);
-        }
-        else if (strcasecmp(key, "display_integer") == 0)
-        {
-            psx_config.display_mode = (atoi(val) != 0 && strcasecmp(val, "false") != 0) ? 2 : 0;
-            printf("CONFIG: display_mode = %d (via display_integer)\n", psx_config.display_mode);
-        }
-        else if (strcasecmp(key, "display_mode") == 0)
-        {
-            psx_config.display_mode = atoi(val);
-            if (psx_config.display_mode < 0 || psx_config.display_mode > 2)
-                psx_config.display_mode = 0;
-            printf("CONFIG: display_mode = %d\n", psx_config.display_mode);
-        }
-        else if (strcasecmp(key, "display_filter") == 0)
-        {
-            psx_config.display_filter = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
-            printf("CONFIG: display_filter = %d\n", psx_config.display_filter);
-        }
-        else if (strcasecmp(key, "interpreter") == 0)
-        {
-            psx_config.interpreter = (atoi(val) != 0 && strcasecmp(val, "false") != 0);
-            printf("CONFIG: interpreter = %d\n", psx_config.interpreter);
-        }
-        else if (strcasecmp(key, "mcd1") == 0 && val[0] != '\0')
-        {
-            strncpy(psx_config.mcd1_path, val, sizeof(psx_config.mcd1_path) - 1);
-            psx_config.mcd1_path[sizeof(psx_config.mcd1_path) - 1] = '\0';
-            printf("CONFIG: mcd1 = %s\n", psx_config.mcd1_path);
-        }
-        else if (strcasecmp(key, "mcd2") == 0 && val[0] != '\0')
-        {
-            strncpy(psx_config.mcd2_path, val, sizeof(psx_config.mcd2_path) - 1);
-            psx_config.mcd2_path[sizeof(psx_config.mcd2_path) - 1] = '\0';
-            printf("CONFIG: mcd2 = %s\n", psx_config.mcd2_path);
-        }
+        if (section)
+            config_game_add(section, key, val);
+        else
+            config_set(key, val);
         line = next;
     }
 
     /* buf is stack-allocated; no free required */
     return 1;
 }
+
+int config_apply_game(const char *game_id)
+{
+    int matched = 0;
+    strncpy(psx_config.game_id, game_id, sizeof(psx_config.game_id) - 1);
+    psx_config.game_id[sizeof(psx_config.game_id) - 1] = '\0';
+    for (int i = 0; i < psx_config.game_count; i++)
+    {
+        PSXGameConfig *g = &psx_config.games[i];
+        if (strcasecmp(g->id, game_id) != 0)
+            continue;
+        if (g->gte_accuracy >= 0)
+        {
+            psx_config.gte_accuracy = g->gte_accuracy;
+            printf("CONFIG: %s: gte_accuracy = %d\n", game_id, g->gte_accuracy);
+        }
+        for (int j = 0; j < g->interp_count && psx_config.jit_interp_count < CONFIG_INTERP_MAX; j++)
+            psx_config.jit_interp_pcs[psx_config.jit_interp_count++] = g->interp_pcs[j];
+        if (g->interp_count)
+            printf("CONFIG: %s: %d interpreted blocks\n", game_id, g->interp_count);
+        if (g->settings_len)
+            printf("CONFIG: %s: applying [%s] section\n", game_id, g->id);
+        for (int off = 0; off < g->settings_len;)
+        {
+            const char *key = g->settings + off;
+            const char *val = key + strlen(key) + 1;
+            config_set(key, val);
+            off = (int)(val + strlen(val) + 1 - g->settings);
+        }
+        matched = 1;
+    }
+    return matched;
+}
@@ -1,11 +1,13 @@
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #ifdef PLATFORM_PS2
 #include <kernel.h>
 #elif defined(PLATFORM_PSP)
 #include <pspthreadman.h>
 #endif
 #include "superpsx.h"
+#include "savestate.h"
 
 #define LOG_TAG "EXC"
 
@@ -283,10 +285,12 @@ static void __attribute__((unused)) EE_ExceptionHandler(int cause)
            (unsigned)cpu.regs[29], (unsigned)cpu.regs[31]);
 
     printf("Halting.\n");
-#ifdef PLATFORM_PSP
+#if defined(PLATFORM_PSP)
     sceKernelSleepThread();
-#else
+#elif defined(PLATFORM_PS2)
     SleepThread();
+#else
+    exit(1);
 #endif
 }
 
@@ -320,3 +324,10 @@ void Init_CPU(void)
     printf("CPU initialized.\n");
     fflush(stdout);
 }
+
+/* Save state: the whole register file, GTE included.  Taken between
+ * chains, where the dispatch fields are already flushed to cpu. */
+void CPU_State(StateIO *io)
+{
+    STATE_VAR(io, cpu);
+}
@@ -2,8 +2,10 @@
 #include "scheduler.h"
 #include "spu.h"
 #include "superpsx.h"
-#include "dynarec.h" /* for jit_invalidate_page */
+#include "dynarec.h" /* for jit_invalidate_page, jit_smc_invalidate_range */
 #include "mdec.h"
+#include "savestate.h"
+#include "config.h"
 #include <stdint.h>
 
 typedef struct
@@ -17,13 +19,19 @@ static DmaChannel dma_channels[7];
 static uint32_t dma_dpcr = 0x07654321;
 static uint32_t dma_dicr = 0;
 
-/* Pending deferred DMA completion: which channel and deadline */
-static int dma_pending_channel = -1;
-static uint64_t dma_pending_deadline = 0;
+/* Deferred completions: bit ch of dma_pending_mask is set while channel
+ * ch has moved its data but not yet cleared bit24 / raised its DICR flag.
+ * All of them share SCHED_EVENT_DMA, armed at the earliest deadline. */
+static uint32_t dma_pending_mask = 0;
+static uint64_t dma_deadline[7];
 
-/* Cycles per word for SPU DMA (NoCash: ~4 cycles/word at CPU clock).
- * We use a conservative 16 cycles/word so tests see non-zero transfer time. */
-#define SPU_DMA_CYCLES_PER_WORD 8U
+/* Completion time per transferred word, CPU cycles.  SPU (ch4): NoCash
+ * gives ~4, 8 keeps its transfers visible to polling tests.  CDROM (ch3)
+ * reads the drive's data FIFO through its bus delay, 24 is a rough
+ * figure for it.  OTC (ch6) fills a word a cycle.  Only ch4 is always
+ * deferred; ch3 and ch6 with dma_timing. */
+static const uint8_t dma_cycles_per_word[7] = {1, 1, 1, 24, 8, 1, 1};
+#define DMA_MIN_CYCLES 32U
 
 static void DMA_FireCompletion(int ticks_late);
 
@@ -41,35 +49,98 @@ static void dma_complete_channel(int ch)
   }
 }
 
+/* Effective cycles accounting for mid-block consumption in JIT */
+#define DMA_EFFECTIVE_CYCLES \
+  (global_cycles + (cpu.initial_cycles_left - cpu.cycles_left) + partial_block_cycles)
+
+static uint64_t dma_next_deadline(void)
+{
+  uint64_t next = UINT64_MAX;
+  for (int ch = 0; ch < 7; ch++)
+    if ((dma_pending_mask & (1u << ch)) && dma_deadline[ch] < next)
+      next = dma_deadline[ch];
+  return next;
+}
+
+/* Re-arm SCHED_EVENT_DMA at the earliest pending deadline, or drop it */
+static void dma_schedule(void)
+{
+  if (dma_pending_mask)
+    Sched_Add(SCHED_EVENT_DMA, dma_next_deadline(), DMA_FireCompletion);
+  else
+    Sched_Remove(SCHED_EVENT_DMA);
+}
+
+/* Complete every channel whose deadline is at or before now */
+static void dma_complete_due(uint64_t now)
+{
+  uint32_t done = 0;
+  for (int ch = 0; ch < 7; ch++)
+    if ((dma_pending_mask & (1u << ch)) && now >= dma_deadline[ch])
+      done |= 1u << ch;
+  if (!done)
+    return;
+  dma_pending_mask &= ~done;
+  for (int ch = 0; ch < 7; ch++)
+    if (done & (1u << ch))
+      dma_complete_channel(ch);
+  dma_schedule();
+}
+
+/* The event is due for the earliest deadline even if global_cycles
+ * (which lags EFFECTIVE_CYCLES inside a block) has not reached it */
 static void DMA_FireCompletion(int ticks_late)
 {
   (void)ticks_late;
-  int ch = dma_pending_channel;
-  if (ch >= 0 && ch < 7)
-    dma_complete_channel(ch);
-  dma_pending_channel = -1;
+  uint64_t first = dma_next_deadline();
+  dma_complete_due(global_cycles > first ? global_cycles : first);
 }
 
-/* Effective cycles accounting for mid-block consumption in JIT */
-#define DMA_EFFECTIVE_CYCLES \
-  (global_cycles + (cpu.initial_cycles_left - cpu.cycles_left) + partial_block_cycles)
+/* Clear bit28 (the transfer has started) and complete the channel
+ * once its words would have gone through.  The polling check
+ * (dma_check_pending) completes it inline when EFFECTIVE_CYCLES reaches
+ * the deadline; the scheduler is the fallback for IRQ-driven games that
+ * don't poll CHCR. */
+static void dma_defer_completion(int ch, uint32_t words)
+{
+  uint64_t delay = (uint64_t)words * dma_cycles_per_word[ch];
+  if (delay < DMA_MIN_CYCLES)
+    delay = DMA_MIN_CYCLES;
+  dma_channels[ch].chcr &= ~0x10000000;
+  dma_deadline[ch] = DMA_EFFECTIVE_CYCLES + delay;
+  dma_pending_mask |= 1u << ch;
+  dma_schedule();
+}
 
-/* Inline check for CHCR polling: complete DMA early if deadline reached,
- * cancel the scheduler event (which would be a no-op duplicate). */
-static inline void dma_check_pending(void)
+/* Inline check for CHCR polling: complete DMA early if deadline reached */
+static inline void dma_check_pending(int ch)
 {
-  if (dma_pending_channel >= 0 && DMA_EFFECTIVE_CYCLES >= dma_pending_deadline)
-  {
-    int ch = dma_pending_channel;
-    dma_pending_channel = -1;
-    Sched_Remove(SCHED_EVENT_DMA);
-    dma_complete_channel(ch);
-  }
+  if ((dma_pending_mask & (1u << ch)) && DMA_EFFECTIVE_CYCLES >= dma_deadline[ch])
+    dma_complete_due(DMA_EFFECTIVE_CYCLES);
+}
+
+/* Words moved by a block or burst transfer (SyncMode 0/1) */
+static uint32_t dma_block_words(uint32_t bcr, uint32_t sync_mode)
+{
+  uint32_t block_size = bcr & 0xFFFF;
+  uint32_t block_count = (bcr >> 16) & 0xFFFF;
+  if (sync_mode == 0)
+    return block_size ? block_size : 0x10000;
+  if (block_size == 0)
+    block_size = 1;
+  if (block_count == 0)
+    block_count = 1;
+  return block_size * block_count;
 }
 
 int DMA_IsPending(void)
 {
-  return dma_pending_channel >= 0;
+  return dma_pending_mask != 0;
+}
+
+void DMA_CompleteChannel(int ch)
+{
+  dma_complete_channel(ch);
 }
 
 static void CDROM_DMA3(uint32_t madr, uint32_t bcr, uint32_t chcr)
@@ -87,30 +158,56 @@ static void CDROM_DMA3(uint32_t madr, uint32_t bcr, uint32_t chcr)
   if (phys_addr + total_bytes > PSX_RAM_SIZE)
     total_bytes = PSX_RAM_SIZE - phys_addr;
 
-  CDROM_ReadDataFIFO(psx_ram + phys_addr, total_bytes);
+  /* A whole sector is read from the disc image straight into RAM */
+  total_bytes = CDROM_ReadDataFIFO(psx_ram + phys_addr, total_bytes);
 
-  /* Invalidate all pages touched by this DMA transfer */
-  for (uint32_t off = 0; off < total_bytes; off += 4096)
-    jit_invalidate_page(phys_addr + off);
+  /* Only blocks whose code the sector overwrote are dropped: pages
+   * without compiled code (pure data loads) cost one map test each */
   if (total_bytes > 0)
-    jit_invalidate_page(phys_addr + total_bytes - 1);
+    jit_smc_invalidate_range(phys_addr, phys_addr + total_bytes);
 }
 
+/* OTC: fill the ordering table straight into RAM, each slot linking to
+ * the one below it, then drop the compiled blocks the table overwrote
+ * with one range invalidation (WriteWord per slot did it per word). */
 static void GPU_DMA6(uint32_t madr, uint32_t bcr, uint32_t chcr)
 {
+  (void)chcr;
+  uint32_t *ram = (uint32_t *)psx_ram;
   uint32_t addr = madr & 0x1FFFFC;
-  uint32_t length = bcr;
+  uint32_t length = bcr & 0xFFFF;
   if (length == 0)
     length = 0x10000;
 
-  while (length > 0)
+  if (addr >= (length - 1) * 4)
+  {
+    /* Common case: no wrap below address 0 */
+    uint32_t *p = &ram[addr >> 2];
+    uint32_t link = addr - 4;
+    for (uint32_t i = 1; i < length; i++, link -= 4)
+      *p-- = link;
+    *p = 0xFFFFFF;
+  }
+  else
+  {
+    uint32_t a = addr;
+    for (uint32_t i = 1; i < length; i++)
+    {
+      uint32_t next_addr = (a - 4) & 0x1FFFFC;
+      ram[a >> 2] = next_addr;
+      a = next_addr;
+    }
+    ram[a >> 2] = 0xFFFFFF;
+  }
+
+  uint32_t lo = (addr - (length - 1) * 4) & 0x1FFFFC;
+  if (lo <= addr)
+    jit_smc_invalidate_range(lo, addr + 4);
+  else
   {
-    uint32_t next_addr = (addr - 4) & 0x1FFFFC;
-    WriteWord(addr, next_addr);
-    addr = next_addr;
-    length--;
+    jit_smc_invalidate_range(0, addr + 4);
+    jit_smc_invalidate_range(lo, PSX_RAM_SIZE);
   }
-  WriteWord((addr + 4) & 0x1FFFFC, 0xFFFFFF);
 }
 
 uint32_t DMA_Read(uint32_t addr)
@@ -130,12 +227,11 @@ uint32_t DMA_Read(uint32_t addr)
       case 1:
         return dma_channels[ch].bcr;
       case 2:
+        /* Check deferred DMA completion inline when polling CHCR */
+        dma_check_pending(ch);
         /* DMA6/OTC: bit 1 hardwired to 1, only bits 24,28,30 exposed */
         if (ch == 6)
           return (dma_channels[ch].chcr & 0x51000000) | 0x00000002;
-        /* Check deferred DMA completion inline when polling CHCR */
-        if (ch == dma_pending_channel)
-          dma_check_pending();
         return dma_channels[ch].chcr;
       default:
         return 0;
@@ -215,14 +311,23 @@ void DMA_Write(uint32_t addr, uint32_t data)
             break;
           }
 
+          /* A restart of a channel still completing: finish it first */
+          if (dma_pending_mask & (1u << ch))
+          {
+            dma_pending_mask &= ~(1u << ch);
+            dma_complete_channel(ch);
+            dma_channels[ch].chcr |= 0x01000000;
+            dma_schedule();
+          }
+
           /* Execute the actual data transfer */
           int dma_stalled = 0;
           if (ch == 0)
             MDEC_DMA0(dma_channels[ch].madr, dma_channels[ch].bcr,
                       dma_channels[ch].chcr);
           else if (ch == 1)
-            MDEC_DMA1(dma_channels[ch].madr, dma_channels[ch].bcr,
-                      dma_channels[ch].chcr);
+            dma_stalled = MDEC_DMA1(dma_channels[ch].madr, dma_channels[ch].bcr,
+                                    dma_channels[ch].chcr);
           else if (ch == 2)
             dma_stalled = GPU_DMA2(dma_channels[ch].madr, dma_channels[ch].bcr,
                                    dma_channels[ch].chcr);
@@ -230,43 +335,32 @@ void DMA_Write(uint32_t addr, uint32_t data)
             CDROM_DMA3(dma_channels[ch].madr, dma_channels[ch].bcr,
                        dma_channels[ch].chcr);
           else if (ch == 4)
+          {
             SPU_DMA4(dma_channels[ch].madr, dma_channels[ch].bcr,
                      dma_channels[ch].chcr);
+            /* SPU -> RAM: drop blocks compiled from the buffer */
+            if (!(dma_channels[ch].chcr & 1))
+            {
+              uint32_t lo = dma_channels[ch].madr & 0x1FFFFC;
+              jit_smc_invalidate_range(lo, lo + dma_block_words(dma_channels[ch].bcr, 1) * 4);
+            }
+          }
           else if (ch == 6)
             GPU_DMA6(dma_channels[ch].madr, dma_channels[ch].bcr,
                      dma_channels[ch].chcr);
 
-          if (ch == 4)
+          if (ch == 4 || (psx_config.dma_timing && (ch == 3 || ch == 6)))
           {
-            /* SPU DMA: defer completion so the transfer takes visible
-             * time.  The polling check (dma_check_pending) completes
-             * the DMA inline when EFFECTIVE_CYCLES reaches the
-             * deadline; the scheduler is a fallback for IRQ-based
-             * games that don't poll CHCR. */
-            uint32_t block_size = dma_channels[ch].bcr & 0xFFFF;
-            uint32_t block_count = (dma_channels[ch].bcr >> 16) & 0xFFFF;
-            if (block_size == 0)
-              block_size = 1;
-            if (block_count == 0)
-              block_count = 1;
-            uint32_t total_words = block_size * block_count;
-            uint64_t delay_cycles =
-                (uint64_t)total_words * SPU_DMA_CYCLES_PER_WORD;
-            if (delay_cycles < 32)
-              delay_cycles = 32;
-
-            dma_pending_channel = ch;
-            dma_pending_deadline = DMA_EFFECTIVE_CYCLES + delay_cycles;
-
-            /* Scheduler fallback for IRQ-based completion */
-            Sched_Add(SCHED_EVENT_DMA,
-                                    global_cycles + delay_cycles,
-                                    DMA_FireCompletion);
+            /* Completion takes the transfer's time on the bus */
+            dma_defer_completion(ch, dma_block_words(dma_channels[ch].bcr,
+                                                     sync_mode));
           }
           else if (dma_stalled)
           {
             /* Linked-list DMA stalled (loop detected) — leave bit24 set,
-             * the transfer never completes on real hardware either. */
+             * the transfer never completes on real hardware either.
+             * MDEC DMA1 queued for sliced decode: MDEC_DMA1_Complete
+             * clears it once the output is written. */
           }
           else
           {
@@ -314,3 +408,12 @@ void DMA_Write(uint32_t addr, uint32_t data)
     return;
   }
 }
+
+void DMA_State(StateIO *io)
+{
+  STATE_VAR(io, dma_channels);
+  STATE_VAR(io, dma_dpcr);
+  STATE_VAR(io, dma_dicr);
+  STATE_VAR(io, dma_pending_mask);
+  STATE_VAR(io, dma_deadline);
+}
@@ -13,9 +13,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <malloc.h>
-#ifdef PLATFORM_PSP
+#if defined(PLATFORM_PSP)
 #include <psputils.h> /* sceKernelDcacheWritebackAll, sceKernelIcacheInvalidateAll */
-#else
+#elif defined(PLATFORM_PS2)
 #include <kernel.h> /* FlushCache (PS2) */
 #endif
 #include "superpsx.h"
@@ -26,11 +26,31 @@
 /* ================================================================
  *  Constants
  * ================================================================ */
-#define CODE_BUFFER_SIZE (4 * 1024 * 1024)
-
-#define BLOCK_NODE_POOL_SIZE 32768
+#define CODE_BUFFER_DEFAULT_SIZE (4 * 1024 * 1024) /* code_buffer_size without a memory plan */
+#define CODE_TRAMPOLINE_WORDS 224 /* Trampolines in code_buffer[0..143], shared stubs and IRQ entry up to 223 */
+
+/* Block area is a ring of segments: when the current one fills, only the
+ * oldest segment is evicted instead of flushing the whole cache. */
+#define CODE_SEGMENT_COUNT 8
+#define CODE_SEGMENT_WORDS ((code_buffer_size / 4 - CODE_TRAMPOLINE_WORDS) / CODE_SEGMENT_COUNT)
+#define CODE_SEGMENT_HEADROOM 65536 /* Min free bytes in a segment before compiling */
+
+/* Cold stubs (memory slow paths, TLB backpatch stubs, overflow exits) of
+ * consecutive blocks share a chunk in the current segment, so the hot
+ * paths pack together in the I-cache.  Hot code more than
+ * COLD_CHUNK_REACH words past the chunk opens a new one: hot<->cold
+ * branches are 16-bit relative. */
+#define COLD_CHUNK_WORDS 4096
+#define COLD_CHUNK_REACH 24576
+#define COLD_STUB_MAX_WORDS 48 /* Upper bound per queued cold entry */
+
+#define BLOCK_NODE_POOL_SIZE 32768 /* BlockEntry pool capacity (freed nodes are recycled) */
 
 #define PATCH_SITE_MAX 8192
+#define LINK_SITE_MAX 32768 /* Resolved direct links, tracked for segment eviction */
+#define JIT_SPEC_QUEUE_SIZE 64 /* Uncompiled branch targets awaiting idle-time compile */
+#define JIT_IC_WAYS 4          /* Max inline cache entries per JR/JALR site (jit_inline_caches) */
+#define JIT_IC_SITE_MAX 2048   /* Inline cache sites live at once */
 
 #define SCAN_MAX_INSNS 64 /* Max instructions analyzed per block scan */
 #define DYN_SLOT_COUNT 8  /* Dynamic register slots: T0-T7 (dirty writeback to cpu.regs[]) */
@@ -38,33 +58,62 @@
 /* ================================================================
  *  Shared types
  * ================================================================ */
-typedef struct BlockEntry
+typedef struct __attribute__((aligned(64))) BlockEntry
 {
     uint32_t psx_pc;
     uint32_t *native;
     uint32_t instr_count;    /* Number of PSX instructions in this block */
-    uint32_t native_count;   /* Number of native R5900 instructions generated */
+    uint32_t native_count;   /* Native R5900 words of the hot path (cold stubs are in a cold chunk) */
     uint32_t cycle_count;    /* Weighted R3000A cycle count for this block */
     uint32_t is_idle;        /* 1 = unconditional idle, 2 = conditional idle, 3 = timeout loop (P-IDLE) */
-    struct BlockEntry *next; /* Collision chain pointer */
-    uint32_t code_hash;      /* XOR hash of PSX block opcodes (legacy, unused) */
+    struct BlockEntry *next; /* Free-list link while the node is unused */
+    uint32_t code_hash;      /* jit_block_hash of the PSX opcodes (SMC check, disk cache verify) */
     uint8_t page_gen;        /* Page generation at compile time (SMC fast check) */
     uint8_t timeout_reg;     /* P-IDLE: PSX register index being decremented (valid when is_idle == 3) */
-    uint8_t block_pattern;   /* 0=none, 1=zero-fill (P-ZERO) */
-    uint8_t pattern_base_reg;  /* P-ZERO: base pointer PSX register */
-    uint8_t pattern_limit_reg; /* P-ZERO: limit register for loop end */
+    uint8_t block_pattern;   /* Loop idiom (JIT_IDIOM_*), 0 = none */
+    uint8_t const_guard_words; /* Entry guard of a const-link block, skipped by agreeing links */
     uint16_t smc_epoch;       /* P28: page-table epoch at compile time */
+    uint8_t tier;             /* 0 = quick compile, 1 = full (+ tier-1 passes after a tier-up) */
+    uint8_t slot_entry_loaded; /* Dyn slots loaded by the entry LW sequence (bit i = slot i) */
+    int8_t slot_map[DYN_SLOT_COUNT]; /* PSX reg held in T0-T7 for this block (-1 = unused) */
+    uint16_t hot_count;       /* Dispatcher entries while at tier 0 (tier-up trigger) */
+    uint8_t disk_pending;     /* 1 = loaded from the disk cache, RAM not yet verified */
+    uint8_t const_sig_reg;    /* jit_const_links: PSX reg assumed const at entry (0 = none) */
+    uint32_t const_sig_val;   /* ... and its value, checked by the entry guard */
 #ifdef ENABLE_JIT_DUMP
     uint32_t exec_count;       /* Per-block execution counter for offline analysis */
+    uint32_t sample_count;     /* Host PC samples landing in this block (dynarec_sampler.c) */
 #endif
-} BlockEntry;
+} BlockEntry; /* One cache line per node */
 
 typedef struct
 {
     uint32_t *site_word; /* Address of the J instruction to overwrite */
     uint32_t target_psx_pc;
+    uint32_t const_val;  /* Address base held at this exit (jit_const_links) */
+    uint8_t const_reg;   /* ... in this PSX reg (0 = none) */
 } PatchSite;
 
+/* Inline cache at a JR/JALR exit (jit_inline_caches): `ways` compare
+ * entries starting at code, then the miss tail (emit_inline_cache).
+ * The slot stays put while its code lives: dump builds bake the counter
+ * addresses into the site. */
+typedef struct
+{
+    uint32_t *code;   /* First entry, NULL = free slot */
+    uint32_t psx_pc;  /* The JR/JALR */
+    uint8_t ways;     /* Entries emitted */
+    uint8_t used;     /* Entries filled */
+    uint8_t mega;     /* Saw more targets than ways: hash dispatch only */
+    uint8_t pad;
+    uint32_t target[JIT_IC_WAYS];
+#ifdef ENABLE_JIT_DUMP
+    uint32_t execs;   /* Times the site ran */
+    uint32_t hits[JIT_IC_WAYS];
+    uint32_t misses;  /* Exits to C through the miss tail */
+#endif
+} JitICSite;
+
 typedef struct
 {
     uint32_t value;    /* Current constant value if is_const is 1 */
@@ -77,6 +126,11 @@ typedef struct
 typedef struct
 {
     uint64_t dce_dead_mask;       /* bit i=1 → instruction[i] is dead (backward liveness) */
+    uint64_t store_run_mask;      /* bit i=1 → store i is followed by a store off the same base */
+    uint64_t gte_flag_dead_mask;  /* bit i=1 → COP2 command i: FLAG is reset by a later command before any read */
+    uint64_t gte_fuse_mask;       /* bit i=1 → RTPT i: the next non-NOP instruction is NCLIP */
+    uint64_t load_delay_mask;     /* bit i=1 → load i: the next instruction sees the old rt */
+    uint32_t gte_dead_out[SCAN_MAX_INSNS]; /* COP2 command i: bit r=1 → its cp2_data[r] output is never read */
     uint32_t pinned_written_mask; /* bit r=1 → pinned PSX reg r is written in this block */
     uint32_t regs_written_mask;   /* bit r=1 → PSX reg r is written (any) */
     uint32_t regs_read_mask;      /* bit r=1 → PSX reg r is read */
@@ -157,11 +211,21 @@ typedef int32_t (*block_func_t)(R3000CPU *cpu, uint8_t *ram, uint8_t *bios, int3
  *  Shared state — code buffer
  * ================================================================ */
 extern uint32_t *code_buffer;
+extern uint32_t code_buffer_size; /* bytes, from the memory plan (mem_budget.h) */
 extern uint32_t *code_ptr;
 extern uint32_t *abort_trampoline_addr;
+extern uint32_t *irq_entry_trampoline_addr; /* IRQ exits go on at the vector (jit_fast_irq) */
+uint32_t jit_irq_enter(void);
 extern uint32_t *call_c_trampoline_addr;
 extern uint32_t *call_c_trampoline_lite_addr;
 extern uint32_t *mem_slow_trampoline_addr;
+extern int code_seg_cur;        /* Ring segment code_ptr is currently filling */
+extern uint32_t *code_seg_end;  /* One past the last word of code_seg_cur */
+
+static inline uint32_t *code_segment_base(int seg)
+{
+    return code_buffer + CODE_TRAMPOLINE_WORDS + seg * CODE_SEGMENT_WORDS;
+}
 
 /* ================================================================
  *  Shared state — Page Table (Lookup)
@@ -188,9 +252,13 @@ extern uint8_t jit_page_gen[JIT_L1_RAM_PAGES];
  * so they pick up the check for the newly-populated code page. */
 extern uint16_t smc_page_epoch;
 
-/* P29: Per-page dirty flag — debounces inline SMC handler calls.
- * Checked inline in native code; set by handler, cleared on recompile. */
-extern uint8_t smc_page_dirty[JIT_L1_RAM_PAGES];
+/* Sub-page code map — bit i of smc_code_map[page] is set while 64-byte
+ * chunk i of the page holds opcodes of a valid compiled block.  Checked
+ * inline by const-address stores (replaces the P29 per-page dirty flag)
+ * so writes to data next to code never reach the SMC handler. */
+#define SMC_CHUNK_SHIFT 6
+extern uint64_t smc_code_map[JIT_L1_RAM_PAGES];
+void jit_code_map_mark(uint32_t psx_pc, uint32_t instr_count);
 
 static inline void jit_invalidate_page(uint32_t phys_addr)
 {
@@ -207,20 +275,53 @@ static inline uint8_t jit_get_page_gen(uint32_t phys_addr)
     return 0;
 }
 
-/* SMC handler: bumps page gen + flushes jit_ht for the affected page.
+/* SMC handler: invalidates the blocks overlapping the written word.
  * Called from the JIT const-address word-store fast path. */
 void jit_smc_handler(uint32_t phys_addr);
+void jit_smc_invalidate_range(uint32_t phys_lo, uint32_t phys_hi);
+
+/* Const-link entry guard failed (jit_const_links): called from JIT code,
+ * queues the block for an unspecialised recompile */
+void jit_const_guard_fail(uint32_t psx_pc);
+int jit_const_spec_denied(uint32_t psx_pc);
 
 extern BlockEntry *block_node_pool;
-extern int block_node_pool_idx;
+extern int block_node_pool_idx;   /* High-water: nodes ever carved from the pool */
+extern BlockEntry *block_node_free_list;
+extern int block_nodes_live;      /* Nodes currently mapped in the page table */
+
+static inline int block_pool_exhausted(void)
+{
+    return block_node_free_list == NULL && block_node_pool_idx >= BLOCK_NODE_POOL_SIZE;
+}
 
 /* ================================================================
  *  Shared state — direct block linking
  * ================================================================ */
 extern PatchSite patch_sites[PATCH_SITE_MAX];
 extern int patch_sites_count;
+extern PatchSite link_sites[LINK_SITE_MAX]; /* Already-linked J sites (unlinked on eviction) */
+extern int link_sites_count;
+extern JitICSite jit_ic_sites[JIT_IC_SITE_MAX];
+extern int jit_ic_sites_count; /* High-water mark of used slots */
+extern uint32_t jit_ic_miss[2]; /* Site (code) and target PC of the last miss, set by native code */
+extern uint32_t jit_spec_queue[JIT_SPEC_QUEUE_SIZE]; /* Ring of PSX PCs */
+extern uint32_t jit_spec_head, jit_spec_tail;
+extern int jit_spec_compiling; /* 1 while building a queued target (no re-queue) */
 #ifdef ENABLE_DYNAREC_STATS
 extern uint64_t stat_dbl_patches;
+extern uint64_t stat_dbl_fast_entries;
+extern uint64_t stat_spec_compiles;
+extern uint64_t stat_spec_dropped;
+extern uint64_t stat_lazy_exits;
+extern uint64_t stat_gte_batched;
+extern uint64_t stat_gte_noflag;
+extern uint64_t stat_gte_vfpu_reuse;
+extern uint64_t stat_gte_vu0_reuse;
+extern uint64_t stat_gte_vu0_async;
+extern uint64_t stat_gte_fused;
+extern uint64_t stat_ic_fills;
+extern uint64_t stat_ic_mega;
 #endif
 
 /* ================================================================
@@ -229,73 +330,103 @@ extern uint64_t stat_dbl_patches;
  *  Instead of exiting to C on every JR $ra, the JIT does an inline
  *  hash lookup in ~14 R5900 instructions.  Inspired by pcsx-rearmed.
  * ================================================================ */
-#define JIT_HT_SIZE 4096 /* Must be power of 2 */
-#define JIT_HT_MASK (JIT_HT_SIZE - 1)
+#define JIT_HT_DEFAULT_ENTRIES 8192 /* 4096 sets x 2 ways */
+#define JIT_HT_MIN_SETS 256
+#define JIT_HT_MAX_SETS 65536         /* Set index must fit the ANDI mask */
 
 typedef struct
 {
-    uint32_t psx_pc[2];  /* PSX virtual address — 2-way set associative */
-    uint32_t *native[2]; /* Pointer to compiled native code (past prologue) */
-} JitHTEntry;            /* 16 bytes: psx_pc[0], psx_pc[1], native[0], native[1] */
+    uint32_t psx_pc;  /* PSX virtual address (0xFFFFFFFF = empty) */
+    uint32_t *native; /* Pointer to compiled native code (past prologue) */
+} JitHTEntry;         /* 8 bytes; a set is jit_ht_ways consecutive entries, MRU first */
 
-extern JitHTEntry jit_ht[JIT_HT_SIZE];
+extern JitHTEntry *jit_ht;   /* jit_ht_sets * jit_ht_ways entries, sized at Init_Dynarec */
+extern uint32_t jit_ht_sets; /* Power of 2 */
+extern int jit_ht_ways;      /* 2 or 4 */
 extern uint32_t *jump_dispatch_trampoline_addr;
+#ifdef ENABLE_DYNAREC_STATS
+extern uint32_t stat_ht_hits;   /* Incremented by the asm dispatch trampoline */
+extern uint32_t stat_ht_misses;
+extern uint64_t stat_ht_evictions;
+#endif
 
-static inline uint32_t jit_ht_hash(uint32_t pc)
+static inline JitHTEntry *jit_ht_set(uint32_t pc)
 {
-    return ((pc >> 12) ^ pc) & JIT_HT_MASK;
+    return &jit_ht[(((pc >> 12) ^ pc) & (jit_ht_sets - 1)) * jit_ht_ways];
 }
 
+/* Insert or refresh a PC.  Replacement: the set is kept in insertion
+ * order, so a new PC goes to way 0 and the oldest way is evicted. */
 static inline void jit_ht_add(uint32_t psx_pc, uint32_t *native)
 {
-    uint32_t h = jit_ht_hash(psx_pc);
-    uint32_t *entry_native = native + DYNAREC_PROLOGUE_WORDS;
-    /* If already in slot 0, just update native pointer */
-    if (jit_ht[h].psx_pc[0] == psx_pc)
-    {
-        jit_ht[h].native[0] = entry_native;
-        return;
-    }
-    /* If already in slot 1, promote to slot 0 (MRU) */
-    if (jit_ht[h].psx_pc[1] == psx_pc)
-    {
-        jit_ht[h].psx_pc[1] = jit_ht[h].psx_pc[0];
-        jit_ht[h].native[1] = jit_ht[h].native[0];
-        jit_ht[h].psx_pc[0] = psx_pc;
-        jit_ht[h].native[0] = entry_native;
-        return;
-    }
-    /* New entry: shift slot 0 → slot 1, insert at slot 0 */
-    jit_ht[h].psx_pc[1] = jit_ht[h].psx_pc[0];
-    jit_ht[h].native[1] = jit_ht[h].native[0];
-    jit_ht[h].psx_pc[0] = psx_pc;
-    jit_ht[h].native[0] = entry_native;
+    JitHTEntry *set = jit_ht_set(psx_pc);
+    int w;
+    for (w = 0; w < jit_ht_ways - 1; w++)
+        if (set[w].psx_pc == psx_pc)
+            break;
+#ifdef ENABLE_DYNAREC_STATS
+    if (set[w].psx_pc != psx_pc && set[w].psx_pc != 0xFFFFFFFF)
+        stat_ht_evictions++;
+#endif
+    for (; w > 0; w--)
+        set[w] = set[w - 1];
+    set[0].psx_pc = psx_pc;
+    set[0].native = native + DYNAREC_PROLOGUE_WORDS;
 }
 
-/* Remove a specific PC from the hash table (both slots) */
+/* Remove a specific PC from the hash table (any way) */
 static inline void jit_ht_remove(uint32_t psx_pc)
 {
-    uint32_t h = jit_ht_hash(psx_pc);
-    if (jit_ht[h].psx_pc[0] == psx_pc)
-    {
-        /* Promote slot 1 → slot 0 */
-        jit_ht[h].psx_pc[0] = jit_ht[h].psx_pc[1];
-        jit_ht[h].native[0] = jit_ht[h].native[1];
-        jit_ht[h].psx_pc[1] = 0xFFFFFFFF;
-        jit_ht[h].native[1] = NULL;
-    }
-    else if (jit_ht[h].psx_pc[1] == psx_pc)
+    JitHTEntry *set = jit_ht_set(psx_pc);
+    for (int w = 0; w < jit_ht_ways; w++)
     {
-        jit_ht[h].psx_pc[1] = 0xFFFFFFFF;
-        jit_ht[h].native[1] = NULL;
+        if (set[w].psx_pc == psx_pc)
+        {
+            for (; w < jit_ht_ways - 1; w++)
+                set[w] = set[w + 1];
+            set[w].psx_pc = 0xFFFFFFFF;
+            set[w].native = NULL;
+            return;
+        }
     }
 }
 
+void jit_ht_flush(void); /* Set every entry to unmatchable */
+
+/* Return-address stack: JAL/JALR push (return PC, stub), where the stub
+ * is a direct link to the return block emitted after the call epilogue.
+ * JR $ra pops and jumps to the stub when the popped PC matches PSX $ra
+ * (REG_S5), otherwise it falls back to the jit_ht trampoline. */
+#define JIT_RAS_SIZE 16 /* Must be power of 2 */
+
+typedef struct
+{
+    uint32_t psx_pc; /* Return PC (0xFFFFFFFF = empty) */
+    uint32_t *stub;  /* J to the return block (or to the exit trampoline) */
+} JitRasEntry;
+
+typedef struct
+{
+    uint32_t top; /* Byte offset of the newest entry in e[] */
+    uint32_t pad;
+    JitRasEntry e[JIT_RAS_SIZE];
+} JitRas;
+
+extern JitRas jit_ras;
+void jit_ras_flush(void); /* Drop all entries (their stubs may be evicted) */
+
 /* ================================================================
  *  Shared state — compile-time
  * ================================================================ */
 extern uint32_t blocks_compiled;
-extern int jit_flush_pending; /* 1 = D/I-cache needs flush before execution */
+extern uint32_t jit_compile_total;
+extern int jit_flush_pending; /* JIT_FLUSH_*: host cache upkeep due before execution */
+extern int jit_compile_tier;  /* Tier for the next compile_block (0 = quick, 1 = full) */
+extern uint32_t block_entry_pc;      /* PSX PC of the block being compiled */
+extern uint32_t *block_entry_native; /* Native start of the block being compiled */
+extern int block_const_reg;          /* Entry const from agreeing links (0 = none) */
+extern uint32_t block_const_val;
+extern int block_const_guard_words;  /* Words of its entry guard after the prologue */
 void micro_cache_flush(void); /* M7: Invalidate 4-entry hot block micro-cache */
 extern uint32_t total_instructions;
 extern uint32_t block_cycle_count;
@@ -310,6 +441,9 @@ extern int block_full_calls;             /* # of emit_call_c calls in current bl
 extern uint32_t emit_current_psx_pc;
 extern int dynarec_load_defer;
 extern int dynarec_lwx_pending;
+extern uint32_t store_run_next;   /* Next opcode when it is a store off the same base, else 0 */
+extern int store_run_head;        /* 1 at the first store of a run with 2+ SWs */
+extern int16_t store_run_lo, store_run_hi; /* Run head: min/max SW offset of the run */
 extern RegStatus vregs[32];
 extern uint32_t dirty_const_mask; /* Bitmask of dirty const vregs */
 extern uint32_t smrv_known_ram;   /* SMRV: bit r=1 → PSX reg r is known RAM address */
@@ -347,11 +481,43 @@ extern uint64_t stat_total_cycles;
 extern uint64_t stat_total_native_instrs;
 extern uint64_t stat_total_psx_instrs;
 extern uint64_t stat_lui_scan_seeds;
+extern uint64_t stat_const_link_seeds;
+extern uint64_t stat_const_guard_fails;
+extern uint64_t stat_fast_irqs;
+extern uint64_t stat_tier_ups;
+extern uint64_t stat_trace_branches;
+extern uint64_t stat_seg_evictions;
+extern uint64_t stat_blocks_evicted;
+extern uint64_t stat_links_unlinked;
+extern uint64_t stat_smc_hits;
+extern uint64_t stat_smc_false_positives;
+extern uint64_t stat_smc_blocks_spared;
+extern uint64_t stat_sync_ranged;
+extern uint64_t stat_sync_full;
+#endif
+
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+/* Executions counted by the blocks themselves: each block body starts
+ * with an increment of a counter slot.  Every compile gets a fresh slot
+ * (jit_block_count_slot maps node -> slot), so code left behind by a
+ * recompile or a recycled node never bumps the new block's count; the
+ * last slot takes blocks that got no node or compiled after the slots ran
+ * out (until the next dynarec_flush_cache).  Folded into
+ * stat_blocks_executed and the instruction / cycle totals on demand, and
+ * when a node is freed or recompiled. */
+#define JIT_BLOCK_COUNT_SLOTS (BLOCK_NODE_POOL_SIZE * 2)
+extern uint32_t jit_block_counts[JIT_BLOCK_COUNT_SLOTS + 1];
+extern uint32_t jit_block_count_slot[BLOCK_NODE_POOL_SIZE];
+extern uint32_t jit_block_counts_next;
+uint32_t *jit_block_counter_new(BlockEntry *be);
+void jit_block_counts_fold(BlockEntry *be);
+void jit_block_counts_fold_all(void);
 #endif
 
 #ifdef ENABLE_HOST_LOG
 extern int host_log_fd;
 void host_log_printf(const char *fmt, ...);
+void host_log_write(const char *buf, int n); /* raw bytes to host_log_fd */
 void host_log_putc(char c);
 void host_log_flush(void);
 #endif
@@ -430,6 +596,10 @@ static inline void emit(uint32_t inst)
 /* PMINW(rd,rs,rt) = MIN(rs,rt)→rd.  Allegrex has native min (SPECIAL func 0x2D) */
 #define EMIT_PMINW(rd, rs, rt) emit(MK_R(0, (rs), (rt), (rd), 0, 0x2D))
 
+/* CLZ(rd,rs) = leading zeros of rs.  Allegrex native (SPECIAL func 0x16) */
+#define EMIT_CLZ(rd, rs) emit(MK_R(0, (rs), 0, (rd), 0, 0x16))
+#define EMIT_CLZ_BIAS 0
+
 #else /* PLATFORM_PS2 (R5900) */
 #define EMIT_MULT1(rs, rt) emit(MK_R(0x1C, (rs), (rt), 0, 0, 0x18))
 #define EMIT_MULTU1(rs, rt) emit(MK_R(0x1C, (rs), (rt), 0, 0, 0x19))
@@ -442,6 +612,10 @@ static inline void emit(uint32_t inst)
 #define EMIT_PMINW(rd, rs, rt) emit(MK_R(0x1C, (rs), (rt), (rd), 0x03, 0x28))
 #define EMIT_MTLO1(rs) emit(MK_R(0x1C, (rs), 0, 0, 0, 0x13))
 #define EMIT_MTHI1(rs) emit(MK_R(0x1C, (rs), 0, 0, 0, 0x11))
+/* PLZCW counts leading bits equal to the sign bit, minus 1: for rs >= 0
+ * that is clz(rs) - EMIT_CLZ_BIAS */
+#define EMIT_CLZ(rd, rs) emit(MK_R(0x1C, (rs), 0, (rd), 0, 0x04))
+#define EMIT_CLZ_BIAS 1
 #endif /* PLATFORM_PSP / PLATFORM_PS2 */
 
 /* COP1 FPU emitters (single-precision float) — used for GTE inline division.
@@ -642,6 +816,14 @@ void dyn_flush_verify_slots(void);
 extern uint32_t dyn_mismatch_count;
 void dyn_flush_one_slot(int r);
 void dyn_reload_one_slot(int r);
+int dyn_slots_match_entry(const int8_t *slot_map, uint8_t entry_loaded);
+
+/* Words emitted by dyn_load_slots() at block entry: a direct link whose
+ * slot mapping matches the target may jump past them (fast entry). */
+static inline uint32_t dyn_entry_load_words(uint8_t entry_loaded)
+{
+    return (uint32_t)__builtin_popcount(entry_loaded);
+}
 
 /* Compile-loop helpers: use AT instead of T8/T9 for non-GPR temporaries */
 void emit_cpu_field_to_psx_reg(int field_offset, int r);
@@ -696,21 +878,119 @@ static inline uint32_t *lookup_block_native(uint32_t psx_pc)
 }
 
 void emit_direct_link(uint32_t target_psx_pc);
+void jit_spec_enqueue(uint32_t target_psx_pc);
 void apply_pending_patches(uint32_t target_psx_pc, uint32_t *native_addr);
+void jit_relink_target(uint32_t target_psx_pc, uint32_t *native_addr);
+int emit_inline_cache(uint32_t jr_pc);
+void jit_ic_fill(uint32_t target_psx_pc, uint32_t *native_addr);
 uint32_t *get_psx_code_ptr(uint32_t psx_pc);
 BlockEntry *cache_block(uint32_t psx_pc, uint32_t *native);
+BlockEntry **jit_block_slot(uint32_t psx_pc, int alloc);
+void block_node_free(BlockEntry *be);
 void Free_PageTable(void);
+void jit_evict_code_range(uint32_t *lo, uint32_t *hi);
+void dynarec_evict_next_segment(void);
+void dynarec_flush_cache(void);
+
+/* Host cache upkeep for written native code.  jit_mark_dirty records
+ * [lo, hi) for jit_cache_sync, which only writes back / invalidates
+ * those lines; anything that sets jit_flush_pending = 1 directly gets
+ * both caches flushed whole.  Too many ranges or too many bytes fall
+ * back to the whole flush as well. */
+#define JIT_FLUSH_ALL 1
+#define JIT_FLUSH_RANGES 2
+#define JIT_DIRTY_RANGES 8
+#define JIT_DIRTY_MAX_BYTES (16 * 1024) /* the I-cache size: beyond it, a whole flush is cheaper */
+void jit_mark_dirty(uint32_t *lo, uint32_t *hi);
+void jit_cache_sync(void);
+
+/* Cold-stub arena: jit_cold_begin points code_ptr at room for max_words
+ * of cold code and returns it; jit_cold_end moves code_ptr back to where
+ * the next hot code goes.  Too big for a chunk, the cold code follows the
+ * block inline.  jit_cold_reset drops the open chunk (segment switch,
+ * flush, disk cache load). */
+uint32_t *jit_cold_begin(uint32_t max_words);
+void jit_cold_end(void);
+void jit_cold_reset(void);
+
+/* Interpreter fallback: block entry PCs the JIT never compiles and runs
+ * through run_interpreter_block instead (the per-game jit_interp list,
+ * plus blocks rewritten jit_interp_smc times by self-modifying code) */
+extern int jit_interp_count;
+int jit_interp_block(uint32_t psx_pc);
+void jit_interp_add(uint32_t psx_pc);
+void jit_interp_note_smc(uint32_t psx_pc);
+void jit_interp_reset(void); /* Clear, then load psx_config.jit_interp_pcs */
+
+/* djb2 hash over a block's PSX opcodes (BlockEntry::code_hash) */
+static inline uint32_t jit_code_hash(const uint32_t *opcodes, uint32_t n)
+{
+    uint32_t hash = 0;
+    for (uint32_t i = 0; i < n; i++)
+        hash = (hash << 5) + hash + opcodes[i];
+    return hash;
+}
+
+/* Words before psx_pc that the tier-1 LUI scan may read (kept inside
+ * RAM or BIOS; the IO code buffer is never scanned) */
+#define JIT_LUI_SCAN_BACK 8
+static inline uint32_t jit_lui_window(uint32_t psx_pc)
+{
+    uint32_t phys = psx_pc & 0x1FFFFFFF;
+    uint32_t off;
+
+    if (phys < PSX_RAM_SIZE)
+        off = phys;
+    else if (phys >= 0x1FC00000 && phys < 0x1FC00000 + PSX_BIOS_SIZE)
+        off = phys - 0x1FC00000;
+    else
+        return 0;
+    return off / 4 < JIT_LUI_SCAN_BACK ? off / 4 : JIT_LUI_SCAN_BACK;
+}
+
+/* BlockEntry::code_hash: the block's opcodes plus, for tier-1 blocks,
+ * the LUI scan window in front of it, so a rewritten LUI invalidates
+ * the constants it seeded.  Constants from const_link_seed need no
+ * cover here: the block's entry guard rechecks them on every run. */
+static inline uint32_t jit_block_hash(const BlockEntry *be, const uint32_t *opcodes)
+{
+    uint32_t back = be->tier ? jit_lui_window(be->psx_pc) : 0;
+    return jit_code_hash(opcodes - back, back + be->instr_count);
+}
+
+/* ================================================================
+ *  Function prototypes — dynarec_diskcache.c
+ * ================================================================ */
+void jit_diskcache_load(void);
+void jit_diskcache_save(void);
+uint32_t *jit_diskcache_verify(BlockEntry *be);
+
+/* ================================================================
+ *  Function prototypes — dynarec_idiom.c
+ *
+ *  Loop idioms stored in BlockEntry::block_pattern.
+ * ================================================================ */
+#define JIT_IDIOM_NONE  0
+#define JIT_IDIOM_FILL  1 /* P-FILL: SB/SH/SW of an invariant value ($zero = P-ZERO) */
+#define JIT_IDIOM_COPY  2 /* P-COPY: load + store of the same element, both pointers bumped */
+#define JIT_IDIOM_SUM   3 /* P-SUM: load + ADDU/XOR into an accumulator (checksums) */
+#define JIT_IDIOM_SCAN  4 /* P-SCAN: load + compare against a terminator (strlen, memchr) */
+#define JIT_IDIOM_COUNT 5
+int jit_idiom_detect(const uint32_t *code, uint32_t count);
+int jit_idiom_run(BlockEntry *be, uint32_t *bytes);
+const char *jit_idiom_name(int kind);
 
 /* ================================================================
  *  Function prototypes — dynarec_memory.c
  * ================================================================ */
 void emit_memory_read(int size, int rt_psx, int rs_psx, int16_t offset, int is_signed);
 void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset);
-void smc_batch_reset(void); /* Reset per-block SMC page-check batch tracker */
+void smc_batch_reset(void); /* Reset per-block SMC check batch tracker */
 void emit_memory_lwx(int is_left, int rt_psx, int rs_psx, int16_t offset, int use_load_delay);
 void emit_memory_swx(int is_left, int rt_psx, int rs_psx, int16_t offset);
 void cold_slow_reset(void);
 void cold_slow_emit_all(void);
+int cold_slow_pending(void);
 void cold_slow_push(uint32_t *branches[], int num_branches,
                     uint32_t *return_point, uint32_t func_addr,
                     uint32_t psx_pc, int16_t cycle_offset,
@@ -719,9 +999,27 @@ void cold_slow_push(uint32_t *branches[], int num_branches,
 /* P23: Overflow exception cold queue (dynarec_insn.c) */
 void overflow_cold_reset(void);
 void overflow_cold_emit_all(void);
+int overflow_cold_pending(void);
+uint32_t *mem_slow_stubs_init(uint32_t *p);
 void tlb_patch_emit_all(void);
+int tlb_patch_pending(void);
+void tlb_bp_push(uint32_t *addu_insn, uint32_t *fault_insn, uint32_t func_addr,
+                 uint8_t type, uint8_t size, uint8_t is_signed, int rt_psx);
 int TLB_Backpatch(uint32_t epc);
+uint32_t TLB_HandleFault(uint32_t *regs, uint32_t epc, uint32_t insn);
+void tlb_bp_evict_range(uint32_t lo, uint32_t hi);
 extern int tlb_bp_map_count;
+#ifdef ENABLE_MEM_PROFILE
+/* Memory site profiler: access classes counted per load/store PSX PC */
+#define MEMSITE_RAM 0
+#define MEMSITE_SCRATCH 1
+#define MEMSITE_BIOS 2
+#define MEMSITE_IO 3
+#define MEMSITE_CLASSES 4
+void mem_profile_hit(uint32_t addr);
+int mem_profile_site_class(uint32_t pc);
+void jit_mem_profile_dump(const char *filename);
+#endif
 
 /* ================================================================
  *  Function prototypes — dynarec_compile.c
@@ -745,24 +1043,90 @@ uint32_t *compile_block(uint32_t psx_pc);
  * ================================================================ */
 uint32_t *dynarec_ensure_block(uint32_t pc, BlockEntry **out_be);
 
+/* Compile up to budget queued branch targets; returns how many were built */
+int jit_spec_compile_pending(int budget);
+
 /* ================================================================
  *  Function prototypes — dynarec_insn.c / dynarec_gte.c
  * ================================================================ */
 int emit_instruction(uint32_t opcode, uint32_t psx_pc, int *mult_count);
 void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc);
+/* Batched GTE runs (gte_vu1_batch): call before each instruction; flushes
+ * the queue when the instruction can't sit inside a run */
+extern int gte_batch_queued; /* commands queued by the block being compiled */
+void emit_gte_batch_point(uint32_t opcode, const uint32_t *next, int in_delay_slot);
+void emit_gte_batch_flush(void);
+/* Deferred DIV/DIVU results (dynarec_insn.c): call before each
+ * instruction, flushes cpu.hi/cpu.lo when it can't see the pipe-1 result */
+extern int hilo_pending;
+void emit_hilo_point(uint32_t opcode, const uint32_t *next, int in_delay_slot);
+void emit_hilo_flush(void);
+/* Asynchronous VU0 micro MVMVA (dynarec_gte.c): call before each
+ * instruction, emits the poll and result stores when it can't overlap */
+#ifdef ENABLE_VU0_MICRO
+extern int vu0_micro_pending;
+void emit_vu0_micro_point(uint32_t opcode, const uint32_t *next, int in_delay_slot);
+void emit_vu0_micro_flush(void);
+#else
+#define vu0_micro_pending 0
+#define emit_vu0_micro_point(opcode, next, in_delay_slot) ((void)0)
+#define emit_vu0_micro_flush() ((void)0)
+#endif
+/* Lazy GTE flags (gte_lazy_flags): set by the compile loop while emitting a
+ * COP2 command whose FLAG result is dead (BlockScanResult.gte_flag_dead_mask) */
+extern int gte_flag_dead;
+/* Dead GTE outputs: cp2_data mask from BlockScanResult.gte_dead_out for the
+ * COP2 command being emitted; the inline RTPS/RTPT paths skip those stores */
+extern uint32_t gte_data_dead;
+/* RTPT+NCLIP fusion: gte_fuse_nclip is set by the compile loop from
+ * BlockScanResult.gte_fuse_mask; an inline RTPT that took it sets
+ * gte_nclip_fused and the NCLIP that follows emits nothing */
+extern int gte_fuse_nclip;
+extern int gte_nclip_fused;
+#ifdef PLATFORM_PSP
+/* Light/Color matrices left in VFPU slots by the block being compiled */
+extern int vfpu_light_resident;
+#endif
+#if !defined(ENABLE_VU0_MICRO) && defined(PLATFORM_PS2)
+/* RT/Light/Color matrices left in VU0 VF slots by the block being compiled */
+extern int vu0_mtx_resident;
+#endif
 void debug_mtc0_sr(uint32_t val);
 int BIOS_HLE_A(void);
 int BIOS_HLE_B(void);
 int BIOS_HLE_C(void);
 
+/* ================================================================
+ *  Function prototypes — bios_hle.c
+ * ================================================================ */
+uint32_t BIOS_HLE_Library(uint32_t table, uint32_t func);
+uint32_t BIOS_HLE_Syscall(uint32_t pc);
+void BIOS_HLE_KernelReady(void);
+
+/* ================================================================
+ *  Function prototypes — dynarec_cost.c
+ * ================================================================ */
+void jit_cost_init(void);
+int jit_calib_is_checkpoint(uint32_t psx_pc);
+void jit_calib_hit(uint32_t psx_pc);
+
 /* ================================================================
  *  Function prototypes — dynarec_run.c
  * ================================================================ */
 void dynarec_print_stats(void);
+void jit_ht_configure(void); /* jit_ht_sets / jit_ht_ways from config */
 void dynarec_print_jit_profile(void);
+extern uint32_t *poll_patched_addr; /* Block entry patched by poll detection (or NULL) */
+extern uint32_t poll_patched_saved[2]; /* Original words under the poll patch */
 
 #ifdef ENABLE_JIT_DUMP
 void jit_dump_blocks(const char *filename);
+
+/* dynarec_sampler.c — host PC sampling (psx_config.jit_sample_hz) */
+void jit_sampler_start(void);
+void jit_sampler_drain(void); /* once per frame: resolve queued samples */
+void jit_sampler_stop(void);
+void jit_sampler_write(FILE *f); /* JSMP trailer of the JIT dump */
 #endif
 
 #endif /* DYNAREC_H */
@@ -2,9 +2,12 @@
  * dynarec_cache.c - Block cache, direct linking, and PSX code resolution
  *
  * Manages the block hash table, overflow chaining, direct block linking
- * (back-patching), and PSX PC → host pointer resolution.
+ * (back-patching), code buffer segment eviction, and PSX PC → host
+ * pointer resolution.
  */
 #include "dynarec.h"
+#include "config.h"
+#include "platform.h"
 
 /* ---- Block cache storage ---- */
 /* ---- Page Table storage ---- */
@@ -17,69 +20,381 @@ uint8_t jit_page_gen[JIT_L1_RAM_PAGES];
 /* P28: Page-table epoch — bumped on every new L2 page allocation (RAM only) */
 uint16_t smc_page_epoch = 0;
 
-/* P29: Per-page dirty flag for SMC handler debounce.
- * Set to 1 by jit_smc_handler after processing; cleared by cache_block
- * when blocks are (re)compiled on the page.  Native inline code checks
- * this flag: if already dirty, skip the handler call entirely. */
-uint8_t smc_page_dirty[JIT_L1_RAM_PAGES];
+/* Sub-page code map: one bit per 64-byte chunk that holds live code */
+uint64_t smc_code_map[JIT_L1_RAM_PAGES];
+
+/* Chunk bits covering [lo, hi) — both within the same page, hi > lo */
+static inline uint64_t smc_chunk_bits(uint32_t lo, uint32_t hi)
+{
+    uint32_t first = (lo >> SMC_CHUNK_SHIFT) & 63;
+    uint32_t last = ((hi - 1) >> SMC_CHUNK_SHIFT) & 63;
+    uint64_t upto = (last == 63) ? ~0ULL : ((1ULL << (last + 1)) - 1);
+    return upto & ~((1ULL << first) - 1);
+}
 
 /*
- * SMC (Self-Modifying Code) handler for the JIT inline write fast path.
- * Called when a const-address word store writes to a RAM page.
- * Bumps the page generation counter AND removes stale jit_ht entries
- * for all blocks on the affected page.  Without the jit_ht removal,
- * the asm dispatch trampoline would bypass the C-side page_gen check
- * and execute stale compiled code.
+ * jit_code_map_mark: record that a valid block covers its opcodes.
+ * Called once the block's length is known (compile, disk cache verify,
+ * hash re-validation).  Like page_gen, only the block's start page is
+ * tracked.
  */
-void jit_smc_handler(uint32_t phys_addr)
+void jit_code_map_mark(uint32_t psx_pc, uint32_t instr_count)
 {
-    uint32_t page = phys_addr >> 12;
-    if (page >= JIT_L1_RAM_PAGES)
-        return;
-    /* P29: Debounce — skip if already handled since last recompile */
-    if (smc_page_dirty[page])
+    uint32_t phys = psx_pc & 0x1FFFFFFF;
+    if (phys >= PSX_RAM_SIZE || instr_count == 0)
         return;
-    jit_l2_t l2 = jit_l1_ram[page];
-    if (!l2)
+    uint32_t page = phys >> 12;
+    uint32_t end = phys + instr_count * 4;
+    if (end > ((page + 1) << 12))
+        end = (page + 1) << 12;
+    smc_code_map[page] |= smc_chunk_bits(phys, end);
+}
+
+/*
+ * SMC (Self-Modifying Code) invalidation for a written RAM range.
+ * Only blocks whose opcodes overlap [phys_lo, phys_hi) are affected:
+ * the page generation is bumped and every other block on the page is
+ * re-stamped with the new generation, so it keeps running without a
+ * hash re-check.  Overlapping blocks drop their jit_ht entries (the asm
+ * dispatch trampoline would otherwise bypass the C-side page_gen check)
+ * and leave the code map until re-validated or recompiled.
+ */
+void jit_smc_invalidate_range(uint32_t phys_lo, uint32_t phys_hi)
+{
+    int any_hit = 0;
+    if (phys_hi > PSX_RAM_SIZE)
+        phys_hi = PSX_RAM_SIZE;
+    for (uint32_t page = phys_lo >> 12; phys_lo < phys_hi && (page << 12) < phys_hi; page++)
+    {
+        jit_l2_t l2 = jit_l1_ram[page];
+        if (!l2 || !smc_code_map[page])
+            continue;
+        uint32_t base = page << 12;
+        uint32_t lo = phys_lo > base ? phys_lo : base;
+        uint32_t hi = phys_hi < base + 4096 ? phys_hi : base + 4096;
+        uint8_t old_gen = jit_page_gen[page];
+        uint8_t new_gen = (uint8_t)(old_gen + 1);
+        uint64_t map = 0;
+        int hits = 0, spared = 0;
+
+        BlockEntry **entries = *l2;
+        for (int i = 0; i < 1024; i++)
+        {
+            BlockEntry *be = entries[i];
+            if (!be || !be->native || be->page_gen != old_gen)
+                continue;
+            uint32_t b_lo = base | ((uint32_t)i << 2);
+            uint32_t b_hi = b_lo + be->instr_count * 4;
+            if (b_hi > base + 4096)
+                b_hi = base + 4096;
+            if (b_lo < hi && b_hi > lo)
+            {
+                jit_ht_remove(b_lo | 0x80000000u);
+                hits++;
+                continue;
+            }
+            be->page_gen = new_gen;
+            if (b_hi > b_lo)
+                map |= smc_chunk_bits(b_lo, b_hi);
+            spared++;
+        }
+        jit_page_gen[page] = new_gen;
+        smc_code_map[page] = map;
+        any_hit |= hits;
+#ifdef ENABLE_DYNAREC_STATS
+        stat_smc_hits++;
+        if (!hits)
+            stat_smc_false_positives++;
+        stat_smc_blocks_spared += spared;
+#else
+        (void)hits;
+        (void)spared;
+#endif
+    }
+    if (any_hit)
+    {
+        micro_cache_flush();
+        jit_ras_flush();
+    }
+}
+
+void jit_smc_handler(uint32_t phys_addr)
+{
+    phys_addr &= ~3u;
+    jit_smc_invalidate_range(phys_addr, phys_addr + 4);
+}
+
+/* ---- Const-link despecialisation ----
+ * A const-link block (jit_const_links) entered with another value in its
+ * guarded reg is recompiled without the seed.  The guard calls this from
+ * JIT code, so nothing is compiled here: the block is dropped from the
+ * hash table and made due for a tier-up, which recompiles it on the next
+ * dispatch and retargets its links.  PCs are remembered in a small hashed
+ * bitmap (a collision only costs another PC its seed). */
+#define JIT_CONST_DENY_BITS 4096
+static uint32_t jit_const_deny[JIT_CONST_DENY_BITS / 32];
+
+int jit_const_spec_denied(uint32_t psx_pc)
+{
+    uint32_t h = ((psx_pc >> 2) * 2654435761u) >> 20;
+    return (jit_const_deny[h >> 5] >> (h & 31)) & 1;
+}
+
+void jit_const_guard_fail(uint32_t psx_pc)
+{
+    uint32_t h = ((psx_pc >> 2) * 2654435761u) >> 20;
+    jit_const_deny[h >> 5] |= 1u << (h & 31);
+    cpu.pc = psx_pc;
+    BlockEntry *be = lookup_block(psx_pc);
+    if (be && be->native)
+    {
+        be->tier = 0;
+        be->hot_count = (uint16_t)psx_config.jit_tier_threshold;
+    }
+    jit_ht_remove(psx_pc);
+#ifdef ENABLE_DYNAREC_STATS
+    stat_const_guard_fails++;
+#endif
+}
+
+/* ---- Interpreter fallback set ----
+ * Open-addressed on the PC; an entry is pc | 1 so 0 can mean empty.
+ * Recompiles for changed opcodes are counted per PC in a small hashed
+ * table (collisions only make a block reach the threshold sooner). */
+#define JIT_INTERP_SLOTS 512 /* Must be power of 2 */
+#define JIT_SMC_STRIKE_SLOTS 1024
+static uint32_t jit_interp_set[JIT_INTERP_SLOTS];
+static uint8_t jit_smc_strikes[JIT_SMC_STRIKE_SLOTS];
+int jit_interp_count = 0;
+
+static inline uint32_t jit_interp_hash(uint32_t psx_pc)
+{
+    return (psx_pc >> 2) * 2654435761u;
+}
+
+int jit_interp_block(uint32_t psx_pc)
+{
+    uint32_t key = psx_pc | 1;
+    for (uint32_t i = jit_interp_hash(psx_pc) >> 23;; i = (i + 1) & (JIT_INTERP_SLOTS - 1))
+    {
+        if (jit_interp_set[i] == key)
+            return 1;
+        if (jit_interp_set[i] == 0)
+            return 0;
+    }
+}
+
+static int jit_interp_insert(uint32_t psx_pc)
+{
+    if (jit_interp_block(psx_pc) || jit_interp_count >= JIT_INTERP_SLOTS / 2)
+        return 0;
+    uint32_t i = jit_interp_hash(psx_pc) >> 23;
+    while (jit_interp_set[i] != 0)
+        i = (i + 1) & (JIT_INTERP_SLOTS - 1);
+    jit_interp_set[i] = psx_pc | 1;
+    jit_interp_count++;
+    return 1;
+}
+
+/*
+ * jit_interp_add: hand psx_pc to the interpreter.  A compiled block at
+ * the PC is dropped and every resolved link into it reverted to the exit
+ * trampoline (kept as a pending patch, like jit_evict_code_range), so
+ * all paths into the PC come back to run_jit_chain.
+ */
+void jit_interp_add(uint32_t psx_pc)
+{
+    if (!jit_interp_insert(psx_pc))
         return;
-    smc_page_dirty[page] = 1;
-    /* Bump generation so C-side check also detects staleness */
-    jit_page_gen[page]++;
-    /* Remove all jit_ht entries for blocks on this page */
-    uint32_t base_kseg0 = (page << 12) | 0x80000000u;
-    BlockEntry **entries = *l2;
-    for (int i = 0; i < 1024; i++)
-    {
-        if (entries[i] && entries[i]->native)
+
+    jit_ht_remove(psx_pc);
+    BlockEntry *be = lookup_block(psx_pc);
+    if (be && be->native)
+        block_node_free(be);
+
+    int j = 0;
+    for (int k = 0; k < link_sites_count; k++)
+    {
+        PatchSite *ls = &link_sites[k];
+        if (ls->target_psx_pc == psx_pc)
         {
-            uint32_t pc = base_kseg0 | ((uint32_t)i << 2);
-            jit_ht_remove(pc);
+            *ls->site_word = MK_J(2, (uint32_t)abort_trampoline_addr >> 2);
+            if (patch_sites_count < PATCH_SITE_MAX)
+                patch_sites[patch_sites_count++] = *ls;
+            continue;
         }
+        link_sites[j++] = *ls;
     }
+    link_sites_count = j;
     micro_cache_flush();
+    jit_ras_flush();
+    jit_flush_pending = 1;
+    printf("DYNAREC: block %08X left to the interpreter\n", (unsigned)psx_pc);
+}
+
+/* A block at psx_pc was recompiled because its opcodes changed */
+void jit_interp_note_smc(uint32_t psx_pc)
+{
+    if (psx_config.jit_interp_smc <= 0)
+        return;
+    uint8_t *s = &jit_smc_strikes[(jit_interp_hash(psx_pc) >> 22) & (JIT_SMC_STRIKE_SLOTS - 1)];
+    if (*s < 255)
+        (*s)++;
+    if (*s >= psx_config.jit_interp_smc)
+    {
+        *s = 0;
+        jit_interp_add(psx_pc);
+    }
+}
+
+void jit_interp_reset(void)
+{
+    memset(jit_interp_set, 0, sizeof(jit_interp_set));
+    memset(jit_smc_strikes, 0, sizeof(jit_smc_strikes));
+    jit_interp_count = 0;
+    /* Called before anything is compiled: nothing to unlink */
+    for (int i = 0; i < psx_config.jit_interp_count; i++)
+        jit_interp_insert(psx_config.jit_interp_pcs[i]);
 }
 
 BlockEntry *block_node_pool;
 int block_node_pool_idx = 0;
+BlockEntry *block_node_free_list = NULL;
+int block_nodes_live = 0;
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+uint32_t jit_block_counts[JIT_BLOCK_COUNT_SLOTS + 1];
+uint32_t jit_block_count_slot[BLOCK_NODE_POOL_SIZE];
+uint32_t jit_block_counts_next = 0;
+#endif
 
 /* ---- Direct block linking state ---- */
 PatchSite patch_sites[PATCH_SITE_MAX];
 int patch_sites_count = 0;
+
+/* Every J that already points into another block's native code.  Needed
+ * so that evicting a code segment can revert inbound links to the exit
+ * trampoline.  A link that cannot be recorded is never emitted. */
+PatchSite link_sites[LINK_SITE_MAX];
+int link_sites_count = 0;
+
+/* Inline caches at JR/JALR exits (jit_inline_caches) */
+JitICSite jit_ic_sites[JIT_IC_SITE_MAX];
+int jit_ic_sites_count = 0;
+uint32_t jit_ic_miss[2];
+
+/* Static branch targets of full-tier blocks that were not compiled yet.
+ * Drained by jit_spec_compile_pending() while the emulated CPU idles. */
+uint32_t jit_spec_queue[JIT_SPEC_QUEUE_SIZE];
+uint32_t jit_spec_head = 0, jit_spec_tail = 0;
+int jit_spec_compiling = 0;
+
+/* ---- Code buffer segment ring ---- */
+int code_seg_cur = 0;
+uint32_t *code_seg_end = NULL;
+
+/* ---- Cold-stub arena (open chunk in code_seg_cur) ---- */
+static uint32_t *cold_chunk_base = NULL;
+static uint32_t *cold_chunk_ptr = NULL;
+static uint32_t *cold_chunk_end = NULL;
+static uint32_t *cold_hot_resume = NULL; /* code_ptr after jit_cold_end, NULL = inline */
 #ifdef ENABLE_DYNAREC_STATS
 uint64_t stat_dbl_patches = 0;
+uint64_t stat_dbl_fast_entries = 0;
+uint64_t stat_spec_compiles = 0;
+uint64_t stat_spec_dropped = 0;
+uint64_t stat_lazy_exits = 0;
+uint64_t stat_gte_batched = 0;
+uint64_t stat_gte_noflag = 0;
+uint64_t stat_gte_vfpu_reuse = 0;
+uint64_t stat_gte_vu0_reuse = 0;
+uint64_t stat_gte_vu0_async = 0;
+uint64_t stat_gte_fused = 0;
+uint64_t stat_ic_fills = 0;
+uint64_t stat_ic_mega = 0;
 #endif
 
 /* ---- Temp buffer for IO code execution ---- */
 static uint32_t io_code_buffer[64];
 
+/* Address base a direct link carries into its target (jit_const_links):
+ * the GPR const at this exit most likely to be a LUI/ORI base, I/O and
+ * scratchpad first, then KSEG0/KSEG1 RAM.  $gp, $sp, $fp and $ra are
+ * left out: $ra in particular is const after every JAL. */
+static void link_site_const(PatchSite *s)
+{
+    int best = 0;
+    s->const_reg = 0;
+    s->const_val = 0;
+    if (!psx_config.jit_const_links)
+        return;
+    for (int r = 1; r < 28; r++)
+    {
+        if (!is_vreg_const(r))
+            continue;
+        uint32_t v = get_vreg_const(r);
+        uint32_t phys = v & 0x1FFFFFFF;
+        int rank = 0;
+        if (phys >= 0x1F800000 && phys < 0x1F803000)
+            rank = 2;
+        else if (phys < PSX_RAM_SIZE && (v >> 29) >= 4 && (v >> 29) <= 5 && (phys >> 16))
+            rank = 1;
+        if (rank > best)
+        {
+            best = rank;
+            s->const_reg = (uint8_t)r;
+            s->const_val = v;
+        }
+    }
+}
+
+/* A link may skip the target's const guard when its exit holds the value */
+static inline uint32_t link_guard_skip(const BlockEntry *be, const PatchSite *s)
+{
+    if (be && be->const_guard_words && s->const_reg == be->const_sig_reg &&
+        s->const_val == be->const_sig_val)
+        return be->const_guard_words;
+    return 0;
+}
+
 /*
  * emit_direct_link: at the end of a block epilogue, emit a J to the
  * native code of target_psx_pc.  If not compiled yet, emit a J to the
  * slow-path trampoline (code_buffer[0]) and record a patch site.
+ * When the target keeps the same PSX regs in T0-T7 (its BlockEntry
+ * slot_map, or the block being compiled for a self-loop), the J skips
+ * the target's entry slot loads.  Both skips need the exit to pass the
+ * target's const guard (jit_const_links), which sits in front of them.
  */
 void emit_direct_link(uint32_t target_psx_pc)
 {
+    if (target_psx_pc == block_entry_pc && link_sites_count < LINK_SITE_MAX)
+    {
+        uint32_t *entry = block_entry_native + DYNAREC_PROLOGUE_WORDS;
+        PatchSite *ls = &link_sites[link_sites_count++];
+        ls->site_word = code_ptr;
+        ls->target_psx_pc = target_psx_pc;
+        link_site_const(ls);
+        if (!block_const_reg ||
+            (ls->const_reg == block_const_reg && ls->const_val == block_const_val))
+        {
+            entry += block_const_guard_words;
+            if (dyn_slots_active && dyn_slot_entry_loaded &&
+                (dyn_slot_loaded_mask & dyn_slot_entry_loaded) == dyn_slot_entry_loaded)
+            {
+                entry += dyn_entry_load_words(dyn_slot_entry_loaded);
+#ifdef ENABLE_DYNAREC_STATS
+                stat_dbl_fast_entries++;
+#endif
+            }
+        }
+        EMIT_J_ABS((uint32_t)entry);
+        EMIT_NOP();
+        return;
+    }
+
     BlockEntry *be = lookup_block(target_psx_pc);
+    if (be && be->native != NULL && be->disk_pending && !jit_diskcache_verify(be))
+        be = NULL;
     if (be && be->native != NULL)
     {
         /* Two-tier SMC check: page_gen fast filter + hash fallback */
@@ -89,25 +404,41 @@ void emit_direct_link(uint32_t target_psx_pc)
             uint32_t *opcodes = get_psx_code_ptr(target_psx_pc);
             if (opcodes)
             {
-                uint32_t hash = 0;
-                for (uint32_t i = 0; i < be->instr_count; i++)
-                    hash = (hash << 5) + hash + opcodes[i];
+                uint32_t hash = jit_block_hash(be, opcodes);
                 if (hash != be->code_hash)
                 {
-                    be->native = NULL;
+                    jit_ht_remove(target_psx_pc);
+                    block_node_free(be);
                     be = NULL;
                 }
                 else
                 {
                     be->page_gen = jit_get_page_gen(phys);
+                    jit_code_map_mark(target_psx_pc, be->instr_count);
                 }
             }
         }
     }
-    if (be && be->native != NULL)
+    if (be && be->native != NULL && link_sites_count < LINK_SITE_MAX)
     {
         /* Block already exists and is valid. Link immediately! */
-        uint32_t native_addr = (uint32_t)(be->native + DYNAREC_PROLOGUE_WORDS);
+        uint32_t *entry = be->native + DYNAREC_PROLOGUE_WORDS;
+        PatchSite *ls = &link_sites[link_sites_count++];
+        ls->site_word = code_ptr;
+        ls->target_psx_pc = target_psx_pc;
+        link_site_const(ls);
+        if (!be->const_guard_words || link_guard_skip(be, ls))
+        {
+            entry += be->const_guard_words;
+            if (be->slot_entry_loaded && dyn_slots_match_entry(be->slot_map, be->slot_entry_loaded))
+            {
+                entry += dyn_entry_load_words(be->slot_entry_loaded);
+#ifdef ENABLE_DYNAREC_STATS
+                stat_dbl_fast_entries++;
+#endif
+            }
+        }
+        uint32_t native_addr = (uint32_t)entry;
         EMIT_J_ABS(native_addr);
         EMIT_NOP();
 #ifdef ENABLE_DYNAREC_STATS
@@ -122,23 +453,53 @@ void emit_direct_link(uint32_t target_psx_pc)
         PatchSite *ps = &patch_sites[patch_sites_count++];
         ps->site_word = code_ptr;
         ps->target_psx_pc = target_psx_pc;
+        link_site_const(ps);
     }
+    if (jit_compile_tier == 1 && !jit_spec_compiling && psx_config.jit_spec_compile > 0)
+        jit_spec_enqueue(target_psx_pc);
     /* J to JIT exit trampoline (abort_trampoline_addr) */
     EMIT_J_ABS((uint32_t)abort_trampoline_addr);
     EMIT_NOP();
 }
 
+/* jit_spec_enqueue: remember an uncompiled target; drops it when full. */
+void jit_spec_enqueue(uint32_t target_psx_pc)
+{
+    uint32_t i;
+    for (i = jit_spec_head; i != jit_spec_tail; i++)
+    {
+        if (jit_spec_queue[i & (JIT_SPEC_QUEUE_SIZE - 1)] == target_psx_pc)
+            return;
+    }
+    if (jit_spec_tail - jit_spec_head >= JIT_SPEC_QUEUE_SIZE)
+    {
+#ifdef ENABLE_DYNAREC_STATS
+        stat_spec_dropped++;
+#endif
+        return;
+    }
+    jit_spec_queue[jit_spec_tail++ & (JIT_SPEC_QUEUE_SIZE - 1)] = target_psx_pc;
+}
+
 /* apply_pending_patches: back-patch all J stubs waiting for target_psx_pc. */
 void apply_pending_patches(uint32_t target_psx_pc, uint32_t *native_addr)
 {
+    const BlockEntry *be = lookup_block(target_psx_pc);
     int i, j;
     for (i = 0, j = 0; i < patch_sites_count; i++)
     {
         PatchSite *ps = &patch_sites[i];
         if (ps->target_psx_pc == target_psx_pc)
         {
-            uint32_t j_target = ((uint32_t)(native_addr + DYNAREC_PROLOGUE_WORDS) >> 2) & 0x03FFFFFF;
+            /* Untracked links could not be undone on eviction: if the
+             * link table is full, leave the site exiting to C. */
+            if (link_sites_count >= LINK_SITE_MAX)
+                continue;
+            uint32_t *entry = native_addr + DYNAREC_PROLOGUE_WORDS + link_guard_skip(be, ps);
+            uint32_t j_target = ((uint32_t)entry >> 2) & 0x03FFFFFF;
             *ps->site_word = MK_J(2, j_target);
+            jit_mark_dirty(ps->site_word, ps->site_word + 1);
+            link_sites[link_sites_count++] = *ps;
 #ifdef ENABLE_DYNAREC_STATS
             stat_dbl_patches++;
 #endif
@@ -151,6 +512,263 @@ void apply_pending_patches(uint32_t target_psx_pc, uint32_t *native_addr)
     patch_sites_count = j;
 }
 
+/* jit_relink_target: retarget resolved links to target_psx_pc at a new
+ * native copy of the block (tier-up recompile leaves the old one dead). */
+void jit_relink_target(uint32_t target_psx_pc, uint32_t *native_addr)
+{
+    const BlockEntry *be = lookup_block(target_psx_pc);
+    for (int i = 0; i < link_sites_count; i++)
+    {
+        if (link_sites[i].target_psx_pc == target_psx_pc)
+        {
+            uint32_t *entry = native_addr + DYNAREC_PROLOGUE_WORDS + link_guard_skip(be, &link_sites[i]);
+            *link_sites[i].site_word = MK_J(2, ((uint32_t)entry >> 2) & 0x03FFFFFF);
+            jit_mark_dirty(link_sites[i].site_word, link_sites[i].site_word + 1);
+        }
+    }
+}
+
+/* ---- Inline caches (jit_inline_caches) ---- */
+#ifdef ENABLE_JIT_DUMP
+#define JIT_IC_ENTRY_WORDS 10
+#else
+#define JIT_IC_ENTRY_WORDS 6
+#endif
+
+#ifdef ENABLE_JIT_DUMP
+/* ++*counter, scratch T9/AT */
+static void emit_ic_count(uint32_t *counter)
+{
+    uint32_t addr = (uint32_t)counter;
+    EMIT_LUI(REG_T9, (addr + 0x8000) >> 16);
+    EMIT_LW(REG_AT, addr & 0xFFFF, REG_T9);
+    EMIT_ADDIU(REG_AT, REG_AT, 1);
+    EMIT_SW(REG_AT, addr & 0xFFFF, REG_T9);
+}
+#endif
+
+/*
+ * emit_inline_cache: exit of the JR/JALR at jr_pc, T8 = target PC
+ * (already in cpu.pc), cycles already deducted from S2.  Returns 0
+ * without emitting anything when inline caches are off or every site
+ * slot is taken; the caller then jumps to the hash dispatch.
+ * Layout:
+ *   BGTZ  s2, +3            → @ic
+ *   NOP
+ *   J     abort_trampoline
+ *   NOP
+ *  @ic, per entry (compares against -1 until jit_ic_fill sets it):
+ *   LUI   at, hi(pc)
+ *   ORI   at, at, lo(pc)
+ *   BNE   t8, at, @next
+ *   NOP
+ *   J     abort_trampoline  → target block once filled
+ *   NOP
+ *  @miss: jit_ic_miss = { @ic, t8 }, then out to C
+ *   LUI   at, hi(&jit_ic_miss)
+ *   ADDIU at, at, lo(&jit_ic_miss)
+ *   SW    t8, 4(at)
+ *   LUI   t9, hi(@ic)
+ *   ORI   t9, t9, lo(@ic)
+ *   J     abort_trampoline
+ *   SW    t9, 0(at)         (delay)
+ * Dump builds count the site's runs before @ic and each entry's hits
+ * before its J.
+ */
+int emit_inline_cache(uint32_t jr_pc)
+{
+    int ways = psx_config.jit_inline_caches;
+    int slot = -1;
+
+    if (ways <= 0)
+        return 0;
+    if (ways > JIT_IC_WAYS)
+        ways = JIT_IC_WAYS;
+    if (jit_ic_sites_count < JIT_IC_SITE_MAX)
+        slot = jit_ic_sites_count++;
+    else
+    {
+        for (int i = 0; i < JIT_IC_SITE_MAX; i++)
+        {
+            if (jit_ic_sites[i].code == NULL)
+            {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0)
+            return 0;
+    }
+    JitICSite *s = &jit_ic_sites[slot];
+    memset(s, 0, sizeof(*s));
+    s->psx_pc = jr_pc;
+    s->ways = (uint8_t)ways;
+
+    emit(MK_I(0x07, REG_S2, REG_ZERO, 3)); /* BGTZ s2, +3 → @ic */
+    EMIT_NOP();
+    EMIT_J_ABS((uint32_t)abort_trampoline_addr);
+    EMIT_NOP();
+#ifdef ENABLE_JIT_DUMP
+    emit_ic_count(&s->execs);
+#endif
+    s->code = code_ptr;
+    for (int w = 0; w < ways; w++)
+    {
+        EMIT_LUI(REG_AT, 0xFFFF);
+        EMIT_ORI(REG_AT, REG_AT, 0xFFFF);
+        EMIT_BNE(REG_T8, REG_AT, JIT_IC_ENTRY_WORDS - 3); /* → next entry */
+        EMIT_NOP();
+#ifdef ENABLE_JIT_DUMP
+        emit_ic_count(&s->hits[w]);
+#endif
+        EMIT_J_ABS((uint32_t)abort_trampoline_addr);
+        EMIT_NOP();
+    }
+
+    uint32_t miss = (uint32_t)jit_ic_miss;
+    uint32_t tag = (uint32_t)s->code;
+    EMIT_LUI(REG_AT, (miss + 0x8000) >> 16);
+    EMIT_ADDIU(REG_AT, REG_AT, miss & 0xFFFF);
+    EMIT_SW(REG_T8, 4, REG_AT);
+    EMIT_LUI(REG_T9, tag >> 16);
+    EMIT_ORI(REG_T9, REG_T9, tag & 0xFFFF);
+    EMIT_J_ABS((uint32_t)abort_trampoline_addr);
+    EMIT_SW(REG_T9, 0, REG_AT);
+    return 1;
+}
+
+/*
+ * jit_ic_fill: the chain exited through an inline cache miss and C
+ * dispatch has just produced the target's block.  The next free entry
+ * of that site gets the target PC and a direct link (tracked like any
+ * other, so eviction and tier-up retarget it); a site already full is
+ * demoted: its first entry becomes a jump to the hash dispatch.
+ */
+void jit_ic_fill(uint32_t target_psx_pc, uint32_t *native_addr)
+{
+    uint32_t *code = (uint32_t *)(uintptr_t)jit_ic_miss[0];
+    JitICSite *s = NULL;
+
+    jit_ic_miss[0] = 0;
+    if (!code || jit_ic_miss[1] != target_psx_pc)
+        return;
+    for (int i = 0; i < jit_ic_sites_count; i++)
+    {
+        if (jit_ic_sites[i].code == code)
+        {
+            s = &jit_ic_sites[i];
+            break;
+        }
+    }
+    if (!s || s->mega)
+        return;
+#ifdef ENABLE_JIT_DUMP
+    s->misses++;
+#endif
+
+    if (s->used >= s->ways)
+    {
+        code[0] = MK_J(2, (uint32_t)jump_dispatch_trampoline_addr >> 2);
+        code[1] = 0;
+        jit_mark_dirty(code, code + 2);
+        s->mega = 1;
+#ifdef ENABLE_DYNAREC_STATS
+        stat_ic_mega++;
+#endif
+        return;
+    }
+    /* Untracked links could not be undone on eviction */
+    if (link_sites_count >= LINK_SITE_MAX)
+        return;
+
+    uint32_t *e = code + s->used * JIT_IC_ENTRY_WORDS;
+    uint32_t *j = e + JIT_IC_ENTRY_WORDS - 2;
+    uint32_t *entry = native_addr + DYNAREC_PROLOGUE_WORDS;
+    e[0] = MK_I(0x0F, 0, REG_AT, target_psx_pc >> 16);
+    e[1] = MK_I(0x0D, REG_AT, REG_AT, target_psx_pc & 0xFFFF);
+    *j = MK_J(2, ((uint32_t)entry >> 2) & 0x03FFFFFF);
+    jit_mark_dirty(e, j + 1);
+
+    PatchSite *ls = &link_sites[link_sites_count++];
+    ls->site_word = j;
+    ls->target_psx_pc = target_psx_pc;
+    ls->const_val = 0;
+    ls->const_reg = 0;
+    s->target[s->used++] = target_psx_pc;
+#ifdef ENABLE_DYNAREC_STATS
+    stat_ic_fills++;
+#endif
+}
+
+/* ---- Host cache upkeep ---- */
+static uintptr_t jit_dirty_lo[JIT_DIRTY_RANGES];
+static uintptr_t jit_dirty_hi[JIT_DIRTY_RANGES];
+static int jit_dirty_count = 0;
+
+/* jit_mark_dirty: native words [lo, hi) were written.  Kept as whole
+ * 64-byte lines; a range touching an existing one is merged into it. */
+void jit_mark_dirty(uint32_t *lo, uint32_t *hi)
+{
+    uintptr_t a = (uintptr_t)lo & ~(uintptr_t)63;
+    uintptr_t b = ((uintptr_t)hi + 63) & ~(uintptr_t)63;
+
+    if (jit_flush_pending == JIT_FLUSH_ALL)
+        return;
+    if (jit_flush_pending == 0)
+        jit_dirty_count = 0; /* cleared by someone else's whole flush */
+    jit_flush_pending = JIT_FLUSH_RANGES;
+
+    for (int i = 0; i < jit_dirty_count; i++)
+    {
+        if (a <= jit_dirty_hi[i] && b >= jit_dirty_lo[i])
+        {
+            if (a < jit_dirty_lo[i])
+                jit_dirty_lo[i] = a;
+            if (b > jit_dirty_hi[i])
+                jit_dirty_hi[i] = b;
+            return;
+        }
+    }
+    if (jit_dirty_count == JIT_DIRTY_RANGES)
+    {
+        jit_flush_pending = JIT_FLUSH_ALL;
+        return;
+    }
+    jit_dirty_lo[jit_dirty_count] = a;
+    jit_dirty_hi[jit_dirty_count] = b;
+    jit_dirty_count++;
+}
+
+/* jit_cache_sync: make everything written since the last sync visible
+ * to instruction fetch */
+void jit_cache_sync(void)
+{
+    if (jit_flush_pending == JIT_FLUSH_RANGES)
+    {
+        uintptr_t bytes = 0;
+        for (int i = 0; i < jit_dirty_count; i++)
+            bytes += jit_dirty_hi[i] - jit_dirty_lo[i];
+        if (bytes <= JIT_DIRTY_MAX_BYTES)
+        {
+            for (int i = 0; i < jit_dirty_count; i++)
+                Platform_SyncCodeRange((void *)jit_dirty_lo[i], (void *)jit_dirty_hi[i]);
+#ifdef ENABLE_DYNAREC_STATS
+            stat_sync_ranged++;
+#endif
+            jit_dirty_count = 0;
+            jit_flush_pending = 0;
+            return;
+        }
+    }
+    Platform_FlushDCache(NULL, NULL);
+    Platform_FlushICache();
+#ifdef ENABLE_DYNAREC_STATS
+    stat_sync_full++;
+#endif
+    jit_dirty_count = 0;
+    jit_flush_pending = 0;
+}
+
 /* ---- Get pointer to PSX code in EE memory ---- */
 uint32_t *get_psx_code_ptr(uint32_t psx_pc)
 {
@@ -184,10 +802,14 @@ uint32_t *get_psx_code_ptr(uint32_t psx_pc)
     return NULL;
 }
 
-BlockEntry *cache_block(uint32_t psx_pc, uint32_t *native)
+/*
+ * jit_block_slot: page-table slot for psx_pc, allocating the L2 page when
+ * alloc is set.  NULL if the PC is outside RAM/BIOS or allocation failed.
+ */
+BlockEntry **jit_block_slot(uint32_t psx_pc, int alloc)
 {
     uint32_t phys = psx_pc & 0x1FFFFFFF;
-    uint32_t l1_idx, l2_idx;
+    uint32_t l1_idx;
     jit_l2_t *l1_table = NULL;
 
     if (phys < PSX_RAM_SIZE)
@@ -207,6 +829,8 @@ BlockEntry *cache_block(uint32_t psx_pc, uint32_t *native)
     /* Allocate L2 page if needed */
     if (l1_table[l1_idx] == NULL)
     {
+        if (!alloc)
+            return NULL;
         l1_table[l1_idx] = calloc(1, sizeof(BlockEntry *) * JIT_L2_ENTRIES);
         if (!l1_table[l1_idx])
             return NULL;
@@ -216,17 +840,107 @@ BlockEntry *cache_block(uint32_t psx_pc, uint32_t *native)
             smc_page_epoch++;
     }
 
-    l2_idx = (phys >> 2) & (JIT_L2_ENTRIES - 1);
+    return &(*l1_table[l1_idx])[(phys >> 2) & (JIT_L2_ENTRIES - 1)];
+}
+
+/* Pop a recycled node, or carve a new one below the high-water mark */
+static BlockEntry *block_node_alloc(void)
+{
+    BlockEntry *be = block_node_free_list;
+    if (be)
+    {
+        block_node_free_list = be->next;
+        memset(be, 0, sizeof(*be));
+    }
+    else if (block_node_pool_idx < BLOCK_NODE_POOL_SIZE)
+    {
+        be = &block_node_pool[block_node_pool_idx++];
+    }
+    if (be)
+    {
+        block_nodes_live++;
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+        jit_block_count_slot[be - block_node_pool] = JIT_BLOCK_COUNT_SLOTS;
+#endif
+    }
+    return be;
+}
+
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+/* Fold the node's old counter and hand its new code a slot no earlier
+ * code was bound to */
+uint32_t *jit_block_counter_new(BlockEntry *be)
+{
+    uint32_t idx = JIT_BLOCK_COUNT_SLOTS;
+
+    jit_block_counts_fold(be);
+    if (jit_block_counts_next < JIT_BLOCK_COUNT_SLOTS)
+    {
+        idx = jit_block_counts_next++;
+        jit_block_counts[idx] = 0;
+    }
+    jit_block_count_slot[be - block_node_pool] = idx;
+    return &jit_block_counts[idx];
+}
+
+void jit_block_counts_fold(BlockEntry *be)
+{
+    uint32_t idx = jit_block_count_slot[be - block_node_pool];
+    if (idx >= JIT_BLOCK_COUNT_SLOTS)
+        return;
+    uint32_t *slot = &jit_block_counts[idx];
+    uint64_t n = *slot;
+
+    stat_blocks_executed += n;
+    stat_total_cycles += n * be->cycle_count;
+    stat_total_native_instrs += n * be->native_count;
+    stat_total_psx_instrs += n * be->instr_count;
+    *slot = 0;
+}
+
+void jit_block_counts_fold_all(void)
+{
+    for (int i = 0; i < block_node_pool_idx; i++)
+        jit_block_counts_fold(&block_node_pool[i]);
+    jit_block_counts[JIT_BLOCK_COUNT_SLOTS] = 0;
+}
+#endif
+
+/*
+ * block_node_free: unmap an invalidated block from the page table and
+ * return its node to the free list.  Callers drop their jit_ht entry;
+ * the micro-cache may still hold the node and is flushed here.
+ */
+void block_node_free(BlockEntry *be)
+{
+    BlockEntry **slot = jit_block_slot(be->psx_pc, 0);
+    if (!slot || *slot != be)
+        return;
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+    jit_block_counts_fold(be);
+    jit_block_count_slot[be - block_node_pool] = JIT_BLOCK_COUNT_SLOTS;
+#endif
+    *slot = NULL;
+    be->native = NULL;
+    be->disk_pending = 0;
+    be->next = block_node_free_list;
+    block_node_free_list = be;
+    block_nodes_live--;
+    micro_cache_flush();
+}
+
+BlockEntry *cache_block(uint32_t psx_pc, uint32_t *native)
+{
+    BlockEntry **slot = jit_block_slot(psx_pc, 1);
+    if (!slot)
+        return NULL;
 
     /* Allocate or reuse BlockEntry */
-    BlockEntry *be = (*l1_table[l1_idx])[l2_idx];
+    BlockEntry *be = *slot;
     if (!be)
     {
-        if (block_node_pool_idx < BLOCK_NODE_POOL_SIZE)
-        {
-            be = &block_node_pool[block_node_pool_idx++];
-            (*l1_table[l1_idx])[l2_idx] = be;
-        }
+        be = block_node_alloc();
+        *slot = be;
     }
 
     if (be)
@@ -234,12 +948,9 @@ BlockEntry *cache_block(uint32_t psx_pc, uint32_t *native)
         be->psx_pc = psx_pc;
         be->native = native;
         be->next = NULL;
-        be->page_gen = jit_get_page_gen(phys);
+        be->page_gen = jit_get_page_gen(psx_pc & 0x1FFFFFFF);
         be->smc_epoch = smc_page_epoch;
     }
-    /* P29: Clear dirty flag so future stores trigger the handler again */
-    if (l1_table == jit_l1_ram)
-        smc_page_dirty[l1_idx] = 0;
     return be;
 }
 
@@ -263,3 +974,197 @@ void Free_PageTable(void)
         }
     }
 }
+
+/*
+ * jit_evict_code_range: forget every block whose native code lies in
+ * [lo, hi) so the range can be reused.  Besides the BlockEntry itself,
+ * anything that may still point into the range is unlinked:
+ *   - jit_ht slots and the micro-cache (dispatch)
+ *   - pending patch sites located inside the range
+ *   - resolved links *into* the range from surviving blocks: the J is
+ *     reverted to the exit trampoline and re-queued as a pending patch
+ *   - TLB backpatch map entries and the poll-detection patch
+ * The BlockEntry nodes themselves go back to the free list.
+ */
+void jit_evict_code_range(uint32_t *lo, uint32_t *hi)
+{
+    int i, j;
+    uint32_t evicted = 0;
+
+    for (i = 0; i < block_node_pool_idx; i++)
+    {
+        BlockEntry *be = &block_node_pool[i];
+        if (be->native >= lo && be->native < hi)
+        {
+            block_node_free(be);
+            evicted++;
+        }
+    }
+
+    /* Descending: jit_ht_remove() shifts the later ways of a set down */
+    for (i = (int)(jit_ht_sets * jit_ht_ways) - 1; i >= 0; i--)
+    {
+        if (jit_ht[i].native >= lo && jit_ht[i].native < hi)
+            jit_ht_remove(jit_ht[i].psx_pc);
+    }
+    micro_cache_flush();
+    jit_ras_flush();
+
+    /* Pending sites inside the range die with their block */
+    for (i = 0, j = 0; i < patch_sites_count; i++)
+    {
+        if (patch_sites[i].site_word >= lo && patch_sites[i].site_word < hi)
+            continue;
+        patch_sites[j++] = patch_sites[i];
+    }
+    patch_sites_count = j;
+
+    /* Resolved links: drop those inside the range, unlink those into it */
+    for (i = 0, j = 0; i < link_sites_count; i++)
+    {
+        PatchSite *ls = &link_sites[i];
+        if (ls->site_word >= lo && ls->site_word < hi)
+            continue;
+        uint32_t insn = *ls->site_word;
+        uint32_t target = ((uint32_t)ls->site_word & 0xF0000000) | ((insn & 0x03FFFFFF) << 2);
+        if (OP(insn) == 2 && target >= (uint32_t)lo && target < (uint32_t)hi)
+        {
+            *ls->site_word = MK_J(2, (uint32_t)abort_trampoline_addr >> 2);
+            jit_mark_dirty(ls->site_word, ls->site_word + 1);
+            if (patch_sites_count < PATCH_SITE_MAX)
+                patch_sites[patch_sites_count++] = *ls;
+#ifdef ENABLE_DYNAREC_STATS
+            stat_links_unlinked++;
+#endif
+            continue;
+        }
+        link_sites[j++] = *ls;
+    }
+    link_sites_count = j;
+
+    for (i = 0; i < jit_ic_sites_count; i++)
+    {
+        if (jit_ic_sites[i].code >= lo && jit_ic_sites[i].code < hi)
+            jit_ic_sites[i].code = NULL;
+    }
+
+    tlb_bp_evict_range((uint32_t)lo, (uint32_t)hi);
+
+    /* The poll patch lives inside an evicted block: never restore it */
+    if (poll_patched_addr >= lo && poll_patched_addr < hi)
+        poll_patched_addr = NULL;
+
+    blocks_compiled = (evicted < blocks_compiled) ? blocks_compiled - evicted : 0;
+#ifdef ENABLE_DYNAREC_STATS
+    stat_blocks_evicted += evicted;
+#endif
+    /* Surviving blocks' unlinked sites were marked dirty above; the
+     * evicted range itself is marked again as new blocks fill it */
+}
+
+/*
+ * dynarec_evict_next_segment: advance code_ptr to the next (oldest)
+ * segment of the code buffer ring, evicting only the blocks it holds.
+ */
+void dynarec_evict_next_segment(void)
+{
+    code_seg_cur = (code_seg_cur + 1) % CODE_SEGMENT_COUNT;
+    uint32_t *lo = code_segment_base(code_seg_cur);
+    uint32_t *hi = code_segment_base(code_seg_cur + 1);
+    DLOG("Evicting code segment %d (%p-%p)\n", code_seg_cur, lo, hi);
+    jit_evict_code_range(lo, hi);
+    code_ptr = lo;
+    code_seg_end = hi;
+    jit_cold_reset();
+#ifdef ENABLE_DYNAREC_STATS
+    stat_seg_evictions++;
+#endif
+}
+
+/*
+ * jit_cold_begin: called with code_ptr at the end of a block's hot path.
+ * The cold code goes to the open chunk when it fits and every branch
+ * into it stays in reach; otherwise a new chunk opens right here and the
+ * next block's hot code starts past it.  A chunk never spans segments,
+ * so segment eviction takes a block's hot and cold code together.
+ */
+uint32_t *jit_cold_begin(uint32_t max_words)
+{
+    uint32_t *hot_end = code_ptr;
+
+    cold_hot_resume = NULL;
+    if (max_words == 0)
+        return code_ptr;
+    if (cold_chunk_ptr && (uint32_t)(cold_chunk_end - cold_chunk_ptr) >= max_words &&
+        hot_end - cold_chunk_base < COLD_CHUNK_REACH)
+    {
+        cold_hot_resume = hot_end;
+        code_ptr = cold_chunk_ptr;
+    }
+    else if (max_words <= COLD_CHUNK_WORDS && code_seg_end - hot_end >= COLD_CHUNK_WORDS)
+    {
+        cold_chunk_base = cold_chunk_ptr = hot_end;
+        cold_chunk_end = hot_end + COLD_CHUNK_WORDS;
+        cold_hot_resume = cold_chunk_end;
+    }
+    /* else inline after the hot path, inside CODE_SEGMENT_HEADROOM */
+    return code_ptr;
+}
+
+void jit_cold_end(void)
+{
+    if (!cold_hot_resume)
+        return;
+    if (code_ptr > cold_chunk_end)
+        printf("[DYNAREC] ERROR: cold stubs overran their chunk by %d words\n",
+               (int)(code_ptr - cold_chunk_end));
+    cold_chunk_ptr = code_ptr;
+    code_ptr = cold_hot_resume;
+    cold_hot_resume = NULL;
+}
+
+void jit_cold_reset(void)
+{
+    cold_chunk_base = cold_chunk_ptr = cold_chunk_end = NULL;
+    cold_hot_resume = NULL;
+}
+
+/*
+ * dynarec_flush_cache: drop every compiled block and rewind the code
+ * buffer to segment 0.  Used when the block node pool is exhausted and
+ * by the playground between tests.
+ */
+void dynarec_flush_cache(void)
+{
+    code_seg_cur = 0;
+    code_ptr = code_segment_base(0);
+    code_seg_end = code_segment_base(1);
+    jit_cold_reset();
+    memset(code_ptr, 0, code_buffer_size - CODE_TRAMPOLINE_WORDS * sizeof(uint32_t));
+    Free_PageTable();
+    memset(smc_code_map, 0, sizeof(smc_code_map));
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+    jit_block_counts_fold_all();
+    /* No code is left to bump a retired slot */
+    memset(jit_block_counts, 0, sizeof(jit_block_counts));
+    jit_block_counts_next = 0;
+#endif
+    memset(block_node_pool, 0, BLOCK_NODE_POOL_SIZE * sizeof(BlockEntry));
+    block_node_pool_idx = 0;
+    block_node_free_list = NULL;
+    block_nodes_live = 0;
+    jit_spec_head = jit_spec_tail = 0;
+    patch_sites_count = 0;
+    link_sites_count = 0;
+    jit_ic_sites_count = 0;
+    jit_ic_miss[0] = 0;
+    blocks_compiled = 0;
+    tlb_bp_map_count = 0;
+    poll_patched_addr = NULL;
+    /* Clear hash table — all native pointers are now stale */
+    jit_ht_flush();
+    micro_cache_flush();
+    jit_ras_flush();
+    /* Full flush deferred: batch with next compile's flush */
+    jit_flush_pending = 1;
+}
@@ -7,6 +7,7 @@
  */
 #include "dynarec.h"
 #include "scheduler.h"
+#include "config.h"
 
 /* ---- JIT instruction category profiling ---- */
 enum
@@ -25,8 +26,12 @@ static const char *jcat_names[JCAT_NUM] = {
     "ALU", "MulDiv", "Load/Store", "Branch", "COP0", "COP2data", "GTE_cmd", "Other"};
 uint64_t jcat_psx_count[JCAT_NUM];    /* PSX instructions per category */
 uint64_t jcat_native_words[JCAT_NUM]; /* EE native words emitted per category */
-uint32_t jcat_cache_flushes;          /* code buffer full resets */
+uint32_t jcat_cache_flushes;          /* full cache resets (block pool exhausted) */
+uint32_t jcat_seg_evictions;          /* code buffer segments evicted */
 uint32_t jcat_peak_buffer_used;       /* high water mark (bytes) */
+uint64_t jcat_hot_words;              /* whole-block words: hot path, cold stubs */
+uint64_t jcat_cold_words;
+uint32_t jcat_blocks;                 /* compiles counted in jcat_hot/cold_words */
 
 static inline int classify_opcode(uint32_t op)
 {
@@ -82,10 +87,11 @@ void dynarec_print_jit_profile(void)
     if (total_psx == 0)
         return;
     uint32_t buf_used = (uint32_t)((uint8_t *)code_ptr - (uint8_t *)code_buffer);
-    printf("[JIT PROFILE] buf=%luKB/%luKB (%.0f%%) peak=%luKB flushes=%lu blocks=%lu\n",
-           (unsigned long)(buf_used / 1024), (unsigned long)(CODE_BUFFER_SIZE / 1024),
-           (double)buf_used * 100.0 / CODE_BUFFER_SIZE,
-           (unsigned long)(jcat_peak_buffer_used / 1024),
+    printf("[JIT PROFILE] buf=%luKB/%luKB (%.0f%%) peak=%luKB seg=%d evictions=%lu flushes=%lu blocks=%lu\n",
+           (unsigned long)(buf_used / 1024), (unsigned long)(code_buffer_size / 1024),
+           (double)buf_used * 100.0 / code_buffer_size,
+           (unsigned long)(jcat_peak_buffer_used / 1024), code_seg_cur,
+           (unsigned long)jcat_seg_evictions,
            (unsigned long)jcat_cache_flushes, (unsigned long)blocks_compiled);
     printf("[JIT INSNS]  ");
     for (int i = 0; i < JCAT_NUM; i++)
@@ -102,13 +108,25 @@ void dynarec_print_jit_profile(void)
     printf("\n[JIT TOTAL] %llu PSX → %llu EE (%.1fx avg)\n",
            (unsigned long long)total_psx, (unsigned long long)total_native,
            (double)total_native / total_psx);
+    if (jcat_blocks)
+        printf("[JIT BLOCKS] %.0f hot + %.0f cold EE words/block, %.1fx incl. overhead and cold (shared stubs %s)\n",
+               (double)jcat_hot_words / jcat_blocks, (double)jcat_cold_words / jcat_blocks,
+               (double)(jcat_hot_words + jcat_cold_words) / total_psx,
+               psx_config.jit_shared_stubs ? "on" : "off");
     fflush(stdout);
 #endif
 }
 
 /* ---- Compile-time state ---- */
 uint32_t blocks_compiled = 0;
+uint32_t jit_compile_total = 0; /* compiles since boot (blocks_compiled drops evictions) */
 int jit_flush_pending = 0;
+int jit_compile_tier = 1;
+uint32_t block_entry_pc = 0xFFFFFFFF;
+uint32_t *block_entry_native = NULL;
+int block_const_reg = 0;
+uint32_t block_const_val = 0;
+int block_const_guard_words = 0;
 uint32_t total_instructions = 0;
 uint32_t block_cycle_count = 0;
 uint32_t emit_cycle_offset = 0;
@@ -123,6 +141,118 @@ int block_full_calls = 0;    /* # of emit_call_c calls in current block */
 int dynarec_load_defer = 0;
 int dynarec_lwx_pending = 0;
 
+/* ---- Tiered compilation ----
+ * Tier 0 (quick) blocks skip the backwards LUI scan, constant-link
+ * seeding and super-block continuations: most code compiled while
+ * loading runs a handful of times.  The dispatcher recompiles a block at
+ * tier 1 once it proves hot (jit_tier_threshold), and those recompiles
+ * also run the tier-1 passes: DCE that counts loads as kills
+ * (block_scan_load_kills) and slot scoring over the whole super-block
+ * (scan_super_block_usage).
+ *
+ * Tier-0 conditional epilogues also bump a per-branch taken/not-taken
+ * counter.  At tier 1 a forward branch that is dominantly taken becomes
+ * a trace: compilation continues at the branch target and the
+ * fall-through turns into the deferred side exit.  Pinned regs and the
+ * dynamic slots stay live across what was a block boundary. */
+#define BRANCH_PROF_SIZE 1024 /* Must be power of 2 */
+#define BRANCH_PROF_MIN 16    /* Samples before a branch bias is trusted */
+
+static uint32_t branch_prof[BRANCH_PROF_SIZE][2]; /* [0] = not taken, [1] = taken */
+
+static inline uint32_t *branch_prof_slot(uint32_t branch_pc)
+{
+    return branch_prof[((branch_pc >> 2) ^ (branch_pc >> 12)) & (BRANCH_PROF_SIZE - 1)];
+}
+
+/* Tier 0: emit `branch_prof[pc][taken]++` (AT/T9 scratch, 4 words) */
+static void emit_branch_profile(uint32_t branch_pc, int taken)
+{
+    uint32_t addr = (uint32_t)&branch_prof_slot(branch_pc)[taken];
+    EMIT_LUI(REG_AT, (addr + 0x8000) >> 16);
+    EMIT_LW(REG_T9, (int16_t)(addr & 0xFFFF), REG_AT);
+    EMIT_ADDIU(REG_T9, REG_T9, 1);
+    EMIT_SW(REG_T9, (int16_t)(addr & 0xFFFF), REG_AT);
+}
+
+/* ---- Return-address stack (JitRas) ----
+ * Push at a call site: e[top+1] = { return_pc, stub }.  The stub address
+ * is not known until the call epilogue is emitted, so its LUI/ORI pair is
+ * returned for emit_ras_stub() to patch.  Uses AT/T9 scratch only. */
+static uint32_t *emit_ras_push(uint32_t return_pc)
+{
+    uint32_t ras = (uint32_t)&jit_ras;
+    EMIT_LUI(REG_AT, (ras + 0x8000) >> 16);
+    EMIT_ADDIU(REG_AT, REG_AT, (int16_t)(ras & 0xFFFF));
+    EMIT_LW(REG_T9, 0, REG_AT);                      /* top */
+    EMIT_ADDIU(REG_T9, REG_T9, 8);
+    EMIT_ANDI(REG_T9, REG_T9, JIT_RAS_SIZE * 8 - 1);
+    EMIT_SW(REG_T9, 0, REG_AT);                      /* top += 1 entry */
+    EMIT_ADDU(REG_AT, REG_AT, REG_T9);
+    EMIT_LUI(REG_T9, return_pc >> 16);
+    EMIT_ORI(REG_T9, REG_T9, return_pc & 0xFFFF);
+    EMIT_SW(REG_T9, 8, REG_AT);                      /* e[top].psx_pc */
+    uint32_t *stub_imm = code_ptr;
+    EMIT_LUI(REG_T9, 0);                             /* patched: hi(stub) */
+    EMIT_ORI(REG_T9, REG_T9, 0);                     /* patched: lo(stub) */
+    EMIT_SW(REG_T9, 12, REG_AT);                     /* e[top].stub */
+    reg_cache_invalidate();
+    return stub_imm;
+}
+
+/* Emit the stub (after the call epilogue, which never falls through) and
+ * patch its address into the push.  The callee's JR $ra enters the stub
+ * with T0-T7 holding the callee's slots, so the link must not use the
+ * return block's fast entry. */
+static void emit_ras_stub(uint32_t *stub_imm, uint32_t return_pc)
+{
+    uint32_t stub = (uint32_t)code_ptr;
+    stub_imm[0] = MK_I(0x0F, 0, REG_T9, stub >> 16);
+    stub_imm[1] = MK_I(0x0D, REG_T9, REG_T9, stub & 0xFFFF);
+    /* Nor may it claim this block's consts for the return block */
+    int saved_active = dyn_slots_active;
+    RegStatus saved_vregs[32];
+    memcpy(saved_vregs, vregs, sizeof(vregs));
+    for (int r = 1; r < 32; r++)
+        vregs[r].is_const = 0;
+    dyn_slots_active = 0;
+    emit_direct_link(return_pc);
+    dyn_slots_active = saved_active;
+    memcpy(vregs, saved_vregs, sizeof(vregs));
+}
+
+/* Pop at JR $ra (cycles already deducted from S2).  On a match with PSX
+ * $ra and cycles left, jump to the stub; otherwise fall through into the
+ * caller's J to the hash dispatch trampoline (which also handles the
+ * out-of-cycles abort).  V1 is free at a block exit. */
+static void emit_ras_pop(void)
+{
+    uint32_t ras = (uint32_t)&jit_ras;
+    EMIT_LUI(REG_AT, (ras + 0x8000) >> 16);
+    EMIT_ADDIU(REG_AT, REG_AT, (int16_t)(ras & 0xFFFF));
+    EMIT_LW(REG_T9, 0, REG_AT);                      /* top */
+    EMIT_ADDU(REG_V1, REG_AT, REG_T9);               /* v1 = &e[top] - 8 */
+    EMIT_ADDIU(REG_T9, REG_T9, -8);
+    EMIT_ANDI(REG_T9, REG_T9, JIT_RAS_SIZE * 8 - 1);
+    EMIT_SW(REG_T9, 0, REG_AT);                      /* top -= 1 entry */
+    EMIT_LW(REG_AT, 8, REG_V1);                      /* e[top].psx_pc */
+    EMIT_BNE(REG_AT, REG_S5, 5);                     /* mismatch → hash dispatch */
+    EMIT_LW(REG_AT, 12, REG_V1);                     /* delay: e[top].stub */
+    emit(MK_I(0x06, REG_S2, REG_ZERO, 3));           /* BLEZ s2 → hash dispatch */
+    EMIT_NOP();
+    EMIT_JR(REG_AT);
+    EMIT_NOP();
+    reg_cache_invalidate();
+}
+
+/* Tier 1: 1 if the branch was taken at least 3 times out of 4 */
+static int branch_prefers_taken(uint32_t branch_pc)
+{
+    uint32_t *c = branch_prof_slot(branch_pc);
+    uint32_t total = c[0] + c[1];
+    return total >= BRANCH_PROF_MIN && c[1] >= 3 * c[0];
+}
+
 /* ---- Super-block fall-through continuation ----
  * When a conditional branch is encountered, instead of emitting both
  * taken and not-taken epilogues, we continue compiling the fall-through
@@ -141,11 +271,144 @@ typedef struct
     RegStatus saved_vregs[32]; /* vreg state at branch point */
     uint32_t saved_dirty_mask; /* dirty_const_mask at branch point */
     uint8_t saved_dyn_dirty;   /* dyn_dirty_mask at branch point */
+    uint8_t saved_dyn_loaded;  /* dyn_slot_loaded_mask at branch point */
 } DeferredTakenEntry;
 
 static DeferredTakenEntry deferred_taken[MAX_CONTINUATIONS];
 static int deferred_taken_count = 0;
 
+/* ---- Lazy cycle checks (jit_lazy_cycles) ----
+ * A forward link (target above this block's entry) out of a block with
+ * no C calls skips the budget test: S2 is still charged exactly, only
+ * the BLEZ/abort pair is dropped.  Every cycle in the link graph has an
+ * edge back to a PC <= its source block's entry, and those back-edges,
+ * JR dispatch, RAS pops and IO-calling blocks keep the check, so the
+ * overshoot is bounded by one forward run and the chain still exits
+ * with an exact count for sched_cached_earliest. */
+static int lazy_cycle_exit(uint32_t target_pc)
+{
+    return psx_config.jit_lazy_cycles && block_lite_calls == 0 && block_full_calls == 0 &&
+           target_pc > block_entry_pc;
+}
+
+/* T8 = target, J target with cpu.pc = T8 in its delay slot (needed while
+ * the J still points at the exit trampoline, or after an unlink) */
+static void emit_lazy_link(uint32_t target_pc)
+{
+    emit_load_imm32(REG_T8, target_pc);
+    emit_direct_link(target_pc);
+    code_ptr--; /* Replace the link's delay-slot NOP */
+    EMIT_SW(REG_T8, CPU_PC, REG_S0);
+#ifdef ENABLE_DYNAREC_STATS
+    stat_lazy_exits++;
+#endif
+}
+
+/* ---- Shared block exit (jit_shared_stubs) ----
+ * Epilogue abort checks branch to one `j abort_trampoline` per block,
+ * emitted with the cold code, instead of each carrying its own J/NOP
+ * pair.  Sites past MAX_EXIT_SITES keep the inline layout. */
+#define MAX_EXIT_SITES 32
+
+static uint32_t *exit_sites[MAX_EXIT_SITES];
+static int exit_site_count = 0;
+
+static void emit_exit_branch(uint32_t insn)
+{
+    exit_sites[exit_site_count++] = code_ptr;
+    emit(insn); /* offset patched by emit_exit_stub */
+}
+
+/* ---- Fast interrupt entry (jit_fast_irq) ----
+ * Exits that abort for cycles or a pending IRQ jump to the IRQ entry
+ * trampoline instead: it still aborts when out of cycles, but takes an
+ * interrupt in place and continues the chain at the exception vector. */
+static inline uint32_t irq_exit_addr(void)
+{
+    return (uint32_t)(psx_config.jit_fast_irq ? irq_entry_trampoline_addr : abort_trampoline_addr);
+}
+
+static void emit_exit_stub(void)
+{
+    if (exit_site_count == 0)
+        return;
+    uint32_t *stub = code_ptr;
+    EMIT_J_ABS(irq_exit_addr()); /* Cycle-only exits get here out of cycles only */
+    EMIT_NOP();
+    for (int i = 0; i < exit_site_count; i++)
+    {
+        int32_t off = (int32_t)(stub - exit_sites[i] - 1);
+        *exit_sites[i] = (*exit_sites[i] & 0xFFFF0000) | ((uint32_t)off & 0xFFFF);
+    }
+    exit_site_count = 0;
+}
+
+/* Abort check and link of a block exit, T8 = target_pc (cycles already
+ * deducted from S2) */
+static void emit_exit_check(uint32_t target_pc)
+{
+    int shared = psx_config.jit_shared_stubs && exit_site_count <= MAX_EXIT_SITES - 2;
+
+    if (block_lite_calls == 0 && block_full_calls == 0)
+    {
+        /* Cycle-only abort: no inline C calls means irq_pending_fast
+         * cannot change during this block.  SW cpu.pc is folded into
+         * the BLEZ delay slot (always executes, both paths need it).
+         * Layout (6 words, 4 with a shared exit):
+         *   BLEZ  s2, +2          → NOP (@dbl delay = BLEZ target)
+         *   SW    t8, cpu.pc(s0)  (delay: always stores cpu.pc)
+         *   J     target_block    (direct_link)
+         *   NOP                   (delay of J / BLEZ target)
+         *   J     abort_trampoline
+         *   NOP                   (delay)
+         */
+        if (shared)
+        {
+            emit_exit_branch(MK_I(0x06, REG_S2, REG_ZERO, 0)); /* BLEZ s2, @exit */
+            EMIT_SW(REG_T8, CPU_PC, REG_S0);
+            emit_direct_link(target_pc);
+            return;
+        }
+        emit(MK_I(0x06, REG_S2, REG_ZERO, 2));          /* BLEZ s2, +2 → NOP/abort */
+        EMIT_SW(REG_T8, CPU_PC, REG_S0);                 /* delay: cpu.pc = target */
+        emit_direct_link(target_pc);                      /* J target + NOP */
+        EMIT_J_ABS((uint32_t)abort_trampoline_addr);
+        EMIT_NOP();
+    }
+    else
+    {
+        /* Full abort check with IRQ: block has inline C calls that could
+         * change irq_pending_fast at runtime.
+         * Layout (9 words, 7 with a shared exit):
+         *   SW    t8, cpu.pc(s0)
+         *   BLEZ  s2, +3          → J abort (cycles <= 0)
+         *   LW    AT, IRQ_FAST(S0) (delay: always loads irq_pending_fast)
+         *   BEQ   AT, ZERO, +3    → direct_link (no actionable IRQ)
+         *   NOP                   (delay)
+         *   J     abort_trampoline
+         *   NOP                   (J delay)
+         *   [direct_link]
+         */
+        EMIT_SW(REG_T8, CPU_PC, REG_S0);
+        if (shared)
+        {
+            emit_exit_branch(MK_I(0x06, REG_S2, REG_ZERO, 0)); /* BLEZ s2, @exit */
+            EMIT_LW(REG_AT, CPU_IRQ_PENDING_FAST, REG_S0);
+            emit_exit_branch(MK_I(0x05, REG_AT, REG_ZERO, 0)); /* BNE at, zero, @exit */
+            EMIT_NOP();
+            emit_direct_link(target_pc);
+            return;
+        }
+        emit(MK_I(0x06, REG_S2, REG_ZERO, 3));          /* BLEZ s2, +3 → J abort */
+        EMIT_LW(REG_AT, CPU_IRQ_PENDING_FAST, REG_S0);  /* delay: load irq_pending_fast */
+        EMIT_BEQ(REG_AT, REG_ZERO, 3);                  /* BEQ at, zero, +3 → direct_link */
+        EMIT_NOP();
+        EMIT_J_ABS(irq_exit_addr());
+        EMIT_NOP(); /* Delay slot */
+        emit_direct_link(target_pc);
+    }
+}
+
 /* Emit all deferred taken-path epilogues (cold code at end of super-block) */
 static void emit_deferred_taken_all(void)
 {
@@ -162,34 +425,19 @@ static void emit_deferred_taken_all(void)
         memcpy(vregs, e->saved_vregs, sizeof(vregs));
         dirty_const_mask = e->saved_dirty_mask;
         dyn_dirty_mask = e->saved_dyn_dirty;
+        dyn_slot_loaded_mask = e->saved_dyn_loaded;
 
         /* Emit standard branch epilogue inline.  Matches emit_branch_epilogue(). */
         flush_dirty_consts();
         dyn_flush_dirty_slots(); /* D: deferred taken — dirty-only */
         emit(MK_I(0x09, REG_S2, REG_S2, (int16_t)(-(int)e->cycle_count)));
-        emit_load_imm32(REG_T8, e->target_pc);
-
-        if (block_lite_calls == 0 && block_full_calls == 0)
+        if (lazy_cycle_exit(e->target_pc))
         {
-            /* Cycle-only abort: SW in BLEZ delay slot */
-            emit(MK_I(0x06, REG_S2, REG_ZERO, 2));
-            EMIT_SW(REG_T8, CPU_PC, REG_S0);
-            emit_direct_link(e->target_pc);
-            EMIT_J_ABS((uint32_t)abort_trampoline_addr);
-            EMIT_NOP();
-        }
-        else
-        {
-            /* Full abort check with IRQ */
-            EMIT_SW(REG_T8, CPU_PC, REG_S0);
-            emit(MK_I(0x06, REG_S2, REG_ZERO, 3));
-            EMIT_LW(REG_AT, CPU_IRQ_PENDING_FAST, REG_S0);
-            EMIT_BEQ(REG_AT, REG_ZERO, 3);
-            EMIT_NOP();
-            EMIT_J_ABS((uint32_t)abort_trampoline_addr);
-            EMIT_NOP();
-            emit_direct_link(e->target_pc);
+            emit_lazy_link(e->target_pc);
+            continue;
         }
+        emit_load_imm32(REG_T8, e->target_pc);
+        emit_exit_check(e->target_pc);
     }
     deferred_taken_count = 0;
 }
@@ -694,6 +942,73 @@ static uint32_t scan_write_mask(uint32_t opcode)
     return 0;
 }
 
+/* GTE data register (cp2_data) reads/writes of one instruction, for the
+ * GTE output liveness in block_scan.  Only the commands with inline paths
+ * worth trimming get exact sets; any other command reads everything.
+ * Returns 0 for instructions that don't touch cp2_data. */
+#define GTE_D(r) (1u << (r))
+#define GTE_D_RTP_OUT (GTE_D(8) | GTE_D(9) | GTE_D(10) | GTE_D(11) | GTE_D(12) | GTE_D(13) | GTE_D(14) | \
+                       GTE_D(16) | GTE_D(17) | GTE_D(18) | GTE_D(19) | GTE_D(24) | GTE_D(25) | GTE_D(26) | GTE_D(27))
+static int gte_data_access(uint32_t insn, uint32_t *rd_mask, uint32_t *wr_mask)
+{
+    int op = OP(insn);
+    int reg;
+    *rd_mask = 0;
+    *wr_mask = 0;
+    if (op == 0x12 && (insn & 0x02000000))
+    {
+        switch (insn & 0x3F)
+        {
+        case 0x01: /* RTPS: V0, pushes SZ/SXY FIFOs */
+            *rd_mask = GTE_D(0) | GTE_D(1) | GTE_D(13) | GTE_D(14) | GTE_D(17) | GTE_D(18) | GTE_D(19);
+            *wr_mask = GTE_D_RTP_OUT;
+            break;
+        case 0x30: /* RTPT: V0-V2, SZ0 = old SZ3 */
+            *rd_mask = 0x3Fu | GTE_D(19);
+            *wr_mask = GTE_D_RTP_OUT;
+            break;
+        case 0x06: /* NCLIP */
+            *rd_mask = GTE_D(12) | GTE_D(13) | GTE_D(14);
+            *wr_mask = GTE_D(24);
+            break;
+        case 0x2D: /* AVSZ3 */
+            *rd_mask = GTE_D(17) | GTE_D(18) | GTE_D(19);
+            *wr_mask = GTE_D(7) | GTE_D(24);
+            break;
+        case 0x2E: /* AVSZ4 */
+            *rd_mask = GTE_D(16) | GTE_D(17) | GTE_D(18) | GTE_D(19);
+            *wr_mask = GTE_D(7) | GTE_D(24);
+            break;
+        default:
+            *rd_mask = 0xFFFFFFFFu;
+            break;
+        }
+        return 1;
+    }
+    if (op == 0x12 && (RS(insn) == 0x00 || RS(insn) == 0x04))
+        reg = RD(insn); /* MFC2 / MTC2 */
+    else if (op == 0x32 || op == 0x3A)
+        reg = RT(insn); /* LWC2 / SWC2 */
+    else
+        return 0;
+    if (op == 0x12 ? RS(insn) == 0x00 : op == 0x3A)
+    {
+        /* SXYP mirrors SXY2; IRGB/ORGB are built from IR1-3 */
+        *rd_mask = GTE_D(reg);
+        if (reg == 15)
+            *rd_mask |= GTE_D(14);
+        else if (reg == 28 || reg == 29)
+            *rd_mask |= GTE_D(9) | GTE_D(10) | GTE_D(11);
+    }
+    else if (reg != 15 && reg < 28)
+        *wr_mask = GTE_D(reg); /* SXYP/IRGB/LZCS writes have side effects: kill nothing */
+    else
+        *rd_mask = 0xFFFFFFFFu;
+    return 1;
+}
+#undef GTE_D_RTP_OUT
+#undef GTE_D
+
 /* ================================================================
  *  Block Scan — Pass 1 of the 2-pass compilation pipeline.
  *
@@ -817,6 +1132,210 @@ void block_scan(const uint32_t *code, int max_insns, BlockScanResult *out)
             live |= dce_read_mask(insn);
         }
     }
+
+    /* Phase 4: store runs — bit i set when the SB/SH/SW at i is followed
+     * by another one off the same base register.  The const-address store
+     * path checks the run's SMC chunks once and pairs zero words. */
+    out->store_run_mask = 0;
+    for (int i = 0; i + 1 < count; i++)
+    {
+        int op = OP(code[i]), op_next = OP(code[i + 1]);
+        if ((op == 0x28 || op == 0x29 || op == 0x2B) &&
+            (op_next == 0x28 || op_next == 0x29 || op_next == 0x2B) &&
+            RS(code[i]) == RS(code[i + 1]))
+            out->store_run_mask |= (1ULL << i);
+    }
+
+    /* Phase 5: dead GTE flags — bit i set when the COP2 command at i is
+     * followed by another command (which resets FLAG) with no CFC2 $31,
+     * CTC2 $31 or control transfer in between. */
+    out->gte_flag_dead_mask = 0;
+    for (int i = 0; psx_config.gte_lazy_flags && i < count; i++)
+    {
+        if (OP(code[i]) != 0x12 || !(code[i] & 0x02000000))
+            continue;
+        for (int j = i + 1; j < count; j++)
+        {
+            uint32_t insn = code[j];
+            int op = OP(insn);
+            int func = (op == 0) ? FUNC(insn) : 0;
+            if (op == 0x12 && (insn & 0x02000000))
+            {
+                out->gte_flag_dead_mask |= (1ULL << i);
+                break;
+            }
+            if (op == 0x12 && (RS(insn) == 0x02 || RS(insn) == 0x06) && RD(insn) == 31)
+                break;
+            if (op == 0x02 || op == 0x03 || op == 0x01 || (op >= 0x04 && op <= 0x07) ||
+                (op == 0 && (func == 0x08 || func == 0x09 || func == 0x0C || func == 0x0D)))
+                break;
+        }
+    }
+
+    /* Phase 6: GTE output liveness — like phase 3 over cp2_data.  Every
+     * register is live at block exit; gte_dead_out[i] = outputs of the
+     * COP2 command at i that are overwritten before any read. */
+    {
+        uint32_t gte_live = 0xFFFFFFFFu;
+        for (int i = count - 1; i >= 0; i--)
+        {
+            uint32_t gr, gw;
+            out->gte_dead_out[i] = 0;
+            if (!gte_data_access(code[i], &gr, &gw))
+                continue;
+            if (OP(code[i]) == 0x12 && (code[i] & 0x02000000))
+                out->gte_dead_out[i] = gw & ~gte_live;
+            gte_live = (gte_live & ~gw) | gr;
+        }
+    }
+
+    /* Phase 7: RTPT+NCLIP — bit i set when the RTPT at i is followed by
+     * NCLIP with only NOPs in between.  NCLIP reads nothing but the SXY
+     * FIFO the RTPT just filled, so the RTPT emitter computes it too. */
+    out->gte_fuse_mask = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (OP(code[i]) != 0x12 || !(code[i] & 0x02000000) || (code[i] & 0x3F) != 0x30)
+            continue;
+        int j = i + 1;
+        while (j < count && code[j] == 0)
+            j++;
+        if (j < count && OP(code[j]) == 0x12 && (code[j] & 0x02000000) && (code[j] & 0x3F) == 0x06)
+            out->gte_fuse_mask |= (1ULL << i);
+    }
+
+    /* Phase 8: load delay slots — bit i set when the load at i needs the
+     * runtime delay (value parked in cpu.load_delay_val): the next
+     * instruction reads rt, or is a load of the same rt whose own delay
+     * is observable (it cancels this load, so the old rt must survive).
+     * Every other load writes rt directly.  The last load's successor
+     * lies outside the scan and is checked by the emit pass. */
+    out->load_delay_mask = 0;
+    for (int i = count - 2; i >= 0; i--)
+    {
+        int op = OP(code[i]), rt = RT(code[i]);
+        if (op < 0x20 || op > 0x26 || rt == 0)
+            continue;
+        uint32_t next = code[i + 1];
+        int op_next = OP(next);
+        if (instruction_reads_gpr(next, rt))
+            out->load_delay_mask |= (1ULL << i);
+        else if (op_next >= 0x20 && op_next <= 0x26 && RT(next) == rt &&
+                 (i + 2 >= count || ((out->load_delay_mask >> (i + 1)) & 1)))
+            out->load_delay_mask |= (1ULL << i);
+    }
+}
+
+/* ---- Tier-1 passes (tier-up recompiles only) ---- */
+
+/* Phase 3 again with loads as kills: a load whose delay slot doesn't
+ * read rt (load_delay_mask clear) overwrites it before anything can see
+ * the old value, so pure writes to rt above it are dead as well.  LWL /
+ * LWR merge with rt and the last load's successor is unknown, so those
+ * stay live.  The caller only runs this when the sub-block fits under
+ * the MAX_SUPER_INSNS cap, since a cut before the load would lose it. */
+static void block_scan_load_kills(const uint32_t *code, BlockScanResult *out)
+{
+    int count = out->insn_count;
+    uint32_t live = 0xFFFFFFFFu;
+    out->dce_dead_mask = 0;
+    for (int i = count - 1; i >= 0; i--)
+    {
+        uint32_t insn = code[i];
+        int op = OP(insn);
+        int dest = dce_dest_gpr(insn);
+
+        if (dest != 0 && !(live & (1u << dest)) && dce_is_pure(insn))
+        {
+            out->dce_dead_mask |= (1ULL << i);
+            continue;
+        }
+        if (dest != 0)
+            live &= ~(1u << dest);
+        else if (op >= 0x20 && op <= 0x25 && op != 0x22 && RT(insn) != 0 &&
+                 i + 1 < count && !((out->load_delay_mask >> i) & 1))
+            live &= ~(1u << RT(insn));
+        live |= dce_read_mask(insn);
+    }
+}
+
+/* Slot scoring over the whole super-block: follow the path compile_block
+ * takes at each conditional branch (fall-through, or the target of a
+ * trace) and add each sub-block's access counts and use span to the
+ * entry scan, so registers hot in continuations can win a slot.  Only
+ * dyn_assign_slots reads the result; slots are held for the whole block
+ * either way, so a misprediction costs speed, never correctness. */
+static void scan_super_block_usage(uint32_t psx_pc, const uint32_t *code, BlockScanResult *wide)
+{
+    BlockScanResult sub;
+    const BlockScanResult *cur = wide;
+    uint32_t pc = psx_pc;
+
+    for (int k = 0; k < MAX_CONTINUATIONS; k++)
+    {
+        int n = cur->insn_count;
+        if (n < 2)
+            break;
+        uint32_t br = code[((pc - psx_pc) >> 2) + n - 2];
+        int op = OP(br);
+        if (!(op == 0x01 || (op >= 0x04 && op <= 0x07)))
+            break;
+        uint32_t br_pc = pc + (uint32_t)(n - 2) * 4;
+        uint32_t target = br_pc + 4 + (uint32_t)(SIMM16(br) << 2);
+        uint32_t next_pc = pc + (uint32_t)n * 4;
+        if (target > next_pc && (target - psx_pc) < (MAX_SUPER_INSNS * 4) &&
+            (psx_pc & 0x1FFFFFFF) < PSX_RAM_SIZE && branch_prefers_taken(br_pc))
+            next_pc = target;
+        uint32_t base = (next_pc - psx_pc) >> 2;
+        if (base >= MAX_SUPER_INSNS)
+            break;
+
+        block_scan(code + base, SCAN_MAX_INSNS, &sub);
+        for (int r = 0; r < 32; r++)
+        {
+            if (!sub.reg_access_count[r])
+                continue;
+            uint32_t c = (uint32_t)wide->reg_access_count[r] + sub.reg_access_count[r];
+            wide->reg_access_count[r] = (uint8_t)(c < 255 ? c : 255);
+            uint32_t first = base + sub.reg_first_use[r];
+            uint32_t last = base + sub.reg_last_use[r];
+            if (wide->reg_first_use[r] == 0xFF)
+                wide->reg_first_use[r] = (uint8_t)(first < 255 ? first : 254);
+            wide->reg_last_use[r] = (uint8_t)(last < 255 ? last : 254);
+        }
+        pc = next_pc;
+        cur = &sub;
+    }
+}
+
+/* Fill the store-run hints for the store at code[0] (bit idx of mask set):
+ * the next opcode, and at a run head the span of the run's SW offsets. */
+static void store_run_describe(const uint32_t *code, int idx, uint64_t mask)
+{
+    store_run_next = code[1];
+    if (idx > 0 && ((mask >> (idx - 1)) & 1))
+        return;
+    int lo = 0x7FFF, hi = -0x8000, words = 0;
+    for (int k = 0; idx + k < SCAN_MAX_INSNS; k++)
+    {
+        if (OP(code[k]) == 0x2B)
+        {
+            int off = SIMM16(code[k]);
+            if (off < lo)
+                lo = off;
+            if (off > hi)
+                hi = off;
+            words++;
+        }
+        if (!((mask >> (idx + k)) & 1))
+            break;
+    }
+    if (words >= 2)
+    {
+        store_run_head = 1;
+        store_run_lo = (int16_t)lo;
+        store_run_hi = (int16_t)hi;
+    }
 }
 
 /* ---- Block prologue: save callee-saved regs, set up $s0-$s3, load pinned ---- */
@@ -888,51 +1407,15 @@ void emit_branch_epilogue(uint32_t target_pc)
     /* Calculate remaining cycles after this block */
     EMIT_ADDIU(REG_S2, REG_S2, -(int16_t)block_cycle_count);
 
-    /* Materialize target PC into T8 */
-    emit_load_imm32(REG_T8, target_pc);
-
-    if (block_lite_calls == 0 && block_full_calls == 0)
+    if (lazy_cycle_exit(target_pc))
     {
-        /* Cycle-only abort: no inline C calls means irq_pending_fast
-         * cannot change during this block.  SW cpu.pc is folded into
-         * the BLEZ delay slot (always executes, both paths need it).
-         * Layout (6 words):
-         *   BLEZ  s2, +2          → NOP (@dbl delay = BLEZ target)
-         *   SW    t8, cpu.pc(s0)  (delay: always stores cpu.pc)
-         *   J     target_block    (direct_link)
-         *   NOP                   (delay of J / BLEZ target)
-         *   J     abort_trampoline
-         *   NOP                   (delay)
-         */
-        emit(MK_I(0x06, REG_S2, REG_ZERO, 2));          /* BLEZ s2, +2 → NOP/abort */
-        EMIT_SW(REG_T8, CPU_PC, REG_S0);                 /* delay: cpu.pc = target */
-        emit_direct_link(target_pc);                      /* J target + NOP */
-        EMIT_J_ABS((uint32_t)abort_trampoline_addr);
-        EMIT_NOP();
-    }
-    else
-    {
-        /* Full abort check with IRQ: block has inline C calls that could
-         * change irq_pending_fast at runtime.
-         * Layout (9 words):
-         *   SW    t8, cpu.pc(s0)
-         *   BLEZ  s2, +3          → J abort (cycles <= 0)
-         *   LW    AT, IRQ_FAST(S0) (delay: always loads irq_pending_fast)
-         *   BEQ   AT, ZERO, +3    → direct_link (no actionable IRQ)
-         *   NOP                   (delay)
-         *   J     abort_trampoline
-         *   NOP                   (J delay)
-         *   [direct_link]
-         */
-        EMIT_SW(REG_T8, CPU_PC, REG_S0);
-        emit(MK_I(0x06, REG_S2, REG_ZERO, 3));          /* BLEZ s2, +3 → J abort */
-        EMIT_LW(REG_AT, CPU_IRQ_PENDING_FAST, REG_S0);  /* delay: load irq_pending_fast */
-        EMIT_BEQ(REG_AT, REG_ZERO, 3);                  /* BEQ at, zero, +3 → direct_link */
-        EMIT_NOP();
-        EMIT_J_ABS((uint32_t)abort_trampoline_addr);
-        EMIT_NOP(); /* Delay slot */
-        emit_direct_link(target_pc);
+        emit_lazy_link(target_pc);
+        return;
     }
+
+    /* Materialize target PC into T8 */
+    emit_load_imm32(REG_T8, target_pc);
+    emit_exit_check(target_pc);
 }
 
 /* ================================================================
@@ -963,27 +1446,7 @@ static void scan_backwards_for_lui(uint32_t psx_pc, const uint32_t *psx_code,
     /* Only scan if we have valid memory before the block.
      * psx_code points into psx_ram or psx_bios — we must not read
      * before the start of the underlying buffer. */
-    uint32_t phys = psx_pc & 0x1FFFFFFF;
-    int max_back = 8;
-
-    if (phys < PSX_RAM_SIZE)
-    {
-        /* RAM block — limit by distance to start of RAM */
-        if (phys < (uint32_t)(max_back * 4))
-            max_back = (int)(phys / 4);
-    }
-    else if (phys >= 0x1FC00000 && phys < 0x1FC00000 + PSX_BIOS_SIZE)
-    {
-        /* BIOS block — limit by distance to start of BIOS */
-        uint32_t bios_offset = phys - 0x1FC00000;
-        if (bios_offset < (uint32_t)(max_back * 4))
-            max_back = (int)(bios_offset / 4);
-    }
-    else
-    {
-        /* IO code buffer or unknown region — don't scan */
-        return;
-    }
+    int max_back = (int)jit_lui_window(psx_pc);
     if (max_back == 0)
         return;
 
@@ -1083,6 +1546,107 @@ static void scan_backwards_for_lui(uint32_t psx_pc, const uint32_t *psx_code,
     }
 }
 
+/* ================================================================
+ *  Const Links — Constant Bases Along Direct Links
+ *
+ *  The LUI scan only sees straight-line code in front of the block.  A
+ *  block entered through direct links records, at each link site, the
+ *  address base its exit holds (link_site_const).  When every known
+ *  link into the block carries the same reg and value, and the block
+ *  reads the reg before writing it, the reg is seeded as const, so its
+ *  loads and stores take the const-address paths.
+ *
+ *  Links compiled later, JR dispatch and exception returns may bring
+ *  another value, so the block starts with a guard after the prologue:
+ *  a mismatch calls jit_const_guard_fail, which has the dispatcher
+ *  recompile the block unseeded.  Links whose exit holds the value jump
+ *  past the guard (BlockEntry const_guard_words).
+ * ================================================================ */
+static void const_link_seed(uint32_t psx_pc, const BlockScanResult *scan)
+{
+    int reg = 0, n = 0;
+    uint32_t val = 0;
+    const PatchSite *sites[2] = {patch_sites, link_sites};
+    int counts[2] = {patch_sites_count, link_sites_count};
+
+    for (int t = 0; t < 2; t++)
+    {
+        for (int i = 0; i < counts[t]; i++)
+        {
+            const PatchSite *s = &sites[t][i];
+            if (s->target_psx_pc != psx_pc)
+                continue;
+            if (!s->const_reg || (n && (s->const_reg != reg || s->const_val != val)))
+                return;
+            reg = s->const_reg;
+            val = s->const_val;
+            n++;
+        }
+    }
+    if (!n || is_vreg_const(reg) || !(scan->regs_read_mask & (1u << reg)) ||
+        (scan->reg_write_before_read & (1u << reg)))
+        return;
+    block_const_reg = reg;
+    block_const_val = val;
+#ifdef ENABLE_DYNAREC_STATS
+    stat_const_link_seeds++;
+#endif
+}
+
+/* Entry guard, right after the prologue (ahead of the slot loads, which
+ * links skip only together with it) */
+static void emit_const_guard(uint32_t psx_pc)
+{
+    uint32_t *guard = code_ptr;
+    int hw = psx_pinned_reg[block_const_reg];
+    if (!hw)
+    {
+        EMIT_LW(REG_T8, CPU_REG(block_const_reg), REG_S0);
+        hw = REG_T8;
+    }
+    emit_load_imm32(REG_AT, block_const_val);
+    uint32_t *skip = code_ptr;
+    emit(MK_I(0x04, hw, REG_AT, 0)); /* beq → block body */
+    EMIT_NOP();
+    emit_load_imm32(REG_A0, psx_pc);
+    EMIT_SW(REG_S2, CPU_CYCLES_LEFT, REG_S0);
+    emit_load_imm32(REG_T8, (uint32_t)jit_const_guard_fail);
+    EMIT_JAL_ABS((uint32_t)call_c_trampoline_lite_addr);
+    EMIT_NOP();
+    EMIT_J_ABS((uint32_t)abort_trampoline_addr);
+    EMIT_NOP();
+    *skip = (*skip & 0xFFFF0000) | ((uint32_t)(code_ptr - skip - 1) & 0xFFFF);
+    block_const_guard_words = (int)(code_ptr - guard);
+    mark_vreg_const(block_const_reg, block_const_val);
+}
+
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+/* Execution counter at the head of the body, where every entry path
+ * (dispatcher, links past the guard, fast links past the slot loads)
+ * meets.  It starts out on the spare slot; block_counter_bind() points
+ * it at a fresh slot once cache_block() has picked the node. */
+static uint32_t *block_counter_site;
+
+static void emit_block_counter(void)
+{
+    uint32_t addr = (uint32_t)&jit_block_counts[JIT_BLOCK_COUNT_SLOTS];
+    block_counter_site = code_ptr;
+    EMIT_LUI(REG_AT, (addr + 0x8000) >> 16);
+    EMIT_LW(REG_T8, (int16_t)(addr & 0xFFFF), REG_AT);
+    EMIT_ADDIU(REG_T8, REG_T8, 1);
+    EMIT_SW(REG_T8, (int16_t)(addr & 0xFFFF), REG_AT);
+}
+
+static void block_counter_bind(BlockEntry *be)
+{
+    uint32_t addr = (uint32_t)jit_block_counter_new(be);
+    uint32_t *p = block_counter_site;
+    p[0] = (p[0] & 0xFFFF0000) | (((addr + 0x8000) >> 16) & 0xFFFF);
+    p[1] = (p[1] & 0xFFFF0000) | (addr & 0xFFFF);
+    p[3] = (p[3] & 0xFFFF0000) | (addr & 0xFFFF);
+}
+#endif
+
 /* ---- Compile a basic block ---- */
 uint32_t *compile_block(uint32_t psx_pc)
 {
@@ -1093,49 +1657,55 @@ uint32_t *compile_block(uint32_t psx_pc)
         return NULL;
     }
 
-    /* Check for code buffer overflow: reset if < 64KB remaining */
+    /* Check for code segment overflow: when < 64KB remain in the current
+     * ring segment, evict the oldest segment and continue there.  Evicted
+     * and invalidated blocks return their BlockEntry to the free list, so
+     * the pool only runs dry with that many blocks live at once — then
+     * fall back to a full flush. */
     uint32_t used = (uint32_t)((uint8_t *)code_ptr - (uint8_t *)code_buffer);
     if (used > jcat_peak_buffer_used)
         jcat_peak_buffer_used = used;
-    if (used > CODE_BUFFER_SIZE - 65536)
+    if (block_pool_exhausted())
     {
-        DLOG("Code buffer nearly full (%u/%u), flushing cache\n",
-             (unsigned)used, CODE_BUFFER_SIZE);
+        DLOG("Block node pool exhausted (%d live), flushing cache\n", block_nodes_live);
         jcat_cache_flushes++;
-        code_ptr = code_buffer + 144;
-        memset(code_buffer + 144, 0, CODE_BUFFER_SIZE - 144 * sizeof(uint32_t));
-        Free_PageTable();
-        memset(jit_l1_ram, 0, sizeof(jit_l1_ram));
-        memset(jit_l1_bios, 0, sizeof(jit_l1_bios));
-        memset(smc_page_dirty, 0, sizeof(smc_page_dirty));
-        memset(block_node_pool, 0, BLOCK_NODE_POOL_SIZE * sizeof(BlockEntry));
-        block_node_pool_idx = 0;
-        patch_sites_count = 0;
-        blocks_compiled = 0;
 #ifdef ENABLE_DYNAREC_STATS
         stat_cache_flushes++;
 #endif
-        tlb_bp_map_count = 0;
-        /* Clear hash table — all native pointers are now stale */
-        for (int i = 0; i < JIT_HT_SIZE; i++)
-        {
-            jit_ht[i].psx_pc[0] = 0xFFFFFFFF;
-            jit_ht[i].psx_pc[1] = 0xFFFFFFFF;
-            jit_ht[i].native[0] = NULL;
-            jit_ht[i].native[1] = NULL;
-        }
-        micro_cache_flush();
-        /* Full flush deferred: batch with next compile's flush */
-        jit_flush_pending = 1;
+        dynarec_flush_cache();
+    }
+    else if ((uint32_t)((uint8_t *)code_seg_end - (uint8_t *)code_ptr) < CODE_SEGMENT_HEADROOM)
+    {
+        jcat_seg_evictions++;
+        dynarec_evict_next_segment();
     }
 
     uint32_t *block_start = code_ptr;
+    block_entry_pc = psx_pc;
+    block_entry_native = block_start;
+    block_const_reg = 0;
+    block_const_val = 0;
+    block_const_guard_words = 0;
     uint32_t cur_pc = psx_pc;
     uint32_t sub_block_start_pc = psx_pc; /* Base PC for DCE indexing within current sub-block */
     int continuations = 0;                /* Fall-through continuations in this super-block */
     block_cycle_count = 0;
+    uint32_t block_cost_frac = 0; /* cycle_scale remainder, 1/256 cycles */
+    gte_batch_queued = 0;
+    hilo_pending = 0;
+    gte_nclip_fused = 0;
+#ifdef ENABLE_VU0_MICRO
+    vu0_micro_pending = 0;
+#endif
+#ifdef PLATFORM_PSP
+    vfpu_light_resident = 0;
+#endif
+#if !defined(ENABLE_VU0_MICRO) && defined(PLATFORM_PS2)
+    vu0_mtx_resident = 0;
+#endif
     emit_cycle_offset = 0;
     deferred_taken_count = 0;
+    exit_site_count = 0;
     block_lite_calls = 0;
     block_full_calls = 0;
     mem_host_base_psx = -1; /* reset host-base cache for new block */
@@ -1162,11 +1732,31 @@ uint32_t *compile_block(uint32_t psx_pc)
     overflow_cold_reset();
     BlockScanResult scan;
     block_scan(psx_code, SCAN_MAX_INSNS, &scan);
-    scan_backwards_for_lui(psx_pc, psx_code, &scan);
+    const int block_tier = jit_compile_tier;
+    /* Tier-up recompiles: with tiering off every block is tier 1 */
+    const int block_hot = block_tier > 0 && psx_config.jit_tier_threshold > 0;
+    if (block_tier > 0)
+        scan_backwards_for_lui(psx_pc, psx_code, &scan);
+    if (block_tier > 0 && psx_config.jit_const_links && !jit_const_spec_denied(psx_pc))
+        const_link_seed(psx_pc, &scan);
+    if (block_hot)
+        block_scan_load_kills(psx_code, &scan);
     block_pinned_dirty_mask = scan.pinned_written_mask;
     emit_block_prologue();
-    dyn_assign_slots(&scan);
+    if (block_const_reg)
+        emit_const_guard(psx_pc);
+    if (block_hot)
+    {
+        BlockScanResult wide = scan;
+        scan_super_block_usage(psx_pc, psx_code, &wide);
+        dyn_assign_slots(&wide);
+    }
+    else
+        dyn_assign_slots(&scan);
     dyn_load_slots(scan.reg_write_before_read);
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+    emit_block_counter();
+#endif
 
     /* ISC optimization: if block doesn't modify SR (no MTC0/RFE), cache the
      * IsC bit (SR bit 16) in stack slot SP+80 once at block entry.  Per-store
@@ -1239,16 +1829,27 @@ uint32_t *compile_block(uint32_t psx_pc)
         block_cu2_hoisted = 0;
     }
 
+    /* Calibration mode: report when a reference-trace checkpoint block is
+     * entered (also reached through direct links, so it lives here). */
+    if (__builtin_expect(psx_config.cycle_calib[0], 0) && jit_calib_is_checkpoint(psx_pc))
+    {
+        emit_load_imm32(REG_A0, psx_pc);
+        EMIT_SW(REG_S2, CPU_CYCLES_LEFT, REG_S0);
+        emit_load_imm32(REG_T8, (uint32_t)jit_calib_hit);
+        EMIT_JAL_ABS((uint32_t)call_c_trampoline_lite_addr);
+        EMIT_NOP();
+    }
+
     /* Inject BIOS HLE hooks natively so that DBL jumps do not bypass them.
-     * Charge a nominal 10 cycles for HLE overhead (the block's instructions
-     * haven't been compiled yet so block_cycle_count is still 0). */
+     * The hook returns the cycles to charge (0 = not handled); the block's
+     * instructions haven't been compiled yet so block_cycle_count is still 0. */
     uint32_t phys_pc = psx_pc & 0x1FFFFFFF;
     if (phys_pc == 0xA0)
     {
         emit_call_c((uint32_t)BIOS_HLE_A);
         EMIT_BEQ(REG_V0, REG_ZERO, 3);
         EMIT_NOP(); /* Delay slot */
-        EMIT_ADDIU(REG_S2, REG_S2, -10);
+        EMIT_SUBU(REG_S2, REG_S2, REG_V0);
         EMIT_J_ABS((uint32_t)abort_trampoline_addr);
         EMIT_NOP();
     }
@@ -1257,7 +1858,7 @@ uint32_t *compile_block(uint32_t psx_pc)
         emit_call_c((uint32_t)BIOS_HLE_B);
         EMIT_BEQ(REG_V0, REG_ZERO, 3);
         EMIT_NOP(); /* Delay slot */
-        EMIT_ADDIU(REG_S2, REG_S2, -10);
+        EMIT_SUBU(REG_S2, REG_S2, REG_V0);
         EMIT_J_ABS((uint32_t)abort_trampoline_addr);
         EMIT_NOP();
     }
@@ -1266,7 +1867,7 @@ uint32_t *compile_block(uint32_t psx_pc)
         emit_call_c((uint32_t)BIOS_HLE_C);
         EMIT_BEQ(REG_V0, REG_ZERO, 3);
         EMIT_NOP(); /* Delay slot */
-        EMIT_ADDIU(REG_S2, REG_S2, -10);
+        EMIT_SUBU(REG_S2, REG_S2, REG_V0);
         EMIT_J_ABS((uint32_t)abort_trampoline_addr);
         EMIT_NOP();
     }
@@ -1277,6 +1878,8 @@ uint32_t *compile_block(uint32_t psx_pc)
     int branch_type = 0; /* 0=none, 1=unconditional, 3=register, 4=conditional */
     uint32_t jr_predicted_pc = 0;
     int jr_has_prediction = 0;
+    uint32_t ras_return_pc = 0; /* JAL/JALR: return PC to push on the RAS */
+    int jr_is_return = 0;       /* JR $ra: pop the RAS */
 
     /* Load delay slot tracking */
     int pending_load_reg = 0;
@@ -1299,6 +1902,11 @@ uint32_t *compile_block(uint32_t psx_pc)
         uint32_t words_before_insn = (uint32_t)(code_ptr - block_start);
         uint32_t opcode = *psx_code++;
 
+        /* HI/LO first: a GTE batch flush is a C call */
+        emit_hilo_point(opcode, psx_code, in_delay_slot);
+        emit_vu0_micro_point(opcode, psx_code, in_delay_slot);
+        emit_gte_batch_point(opcode, psx_code, in_delay_slot);
+
         /* GTE stall model (PSX R3000A COP2 interlock):
          *
          * COP2 compute issues in 1 CPU cycle; the GTE pipeline runs in
@@ -1346,7 +1954,14 @@ uint32_t *compile_block(uint32_t psx_pc)
             }
         }
 
-        block_cycle_count += r3000a_cycle_cost(opcode);
+        {
+            /* Wait-state model / per-game scale (dynarec_cost.c); with
+             * both at their defaults this is r3000a_cycle_cost() */
+            int rs_known = is_vreg_const(RS(opcode));
+            uint32_t ea = rs_known ? get_vreg_const(RS(opcode)) + (uint32_t)(int32_t)SIMM16(opcode) : 0;
+            uint32_t cost = jit_cost_insn(opcode, cur_pc, rs_known, ea);
+            block_cycle_count += jit_cost_scaled(cost, &block_cost_frac);
+        }
         emit_cycle_offset = block_cycle_count;
 
         /* Decrement GTE pipeline countdown after EVERY instruction,
@@ -1404,37 +2019,64 @@ uint32_t *compile_block(uint32_t psx_pc)
 
             if (branch_type == 1)
             {
+                uint32_t *ras_imm = ras_return_pc ? emit_ras_push(ras_return_pc) : NULL;
                 emit_branch_epilogue(branch_target);
+                if (ras_imm)
+                    emit_ras_stub(ras_imm, ras_return_pc);
             }
             else if (branch_type == 4)
             {
                 /* Conditional branch: check if we can continue compiling
                  * the fall-through path inline (super-block continuation).
                  * The taken path is deferred to cold code at end of block. */
-                int can_continue = (continuations < MAX_CONTINUATIONS) &&
+                int can_continue = (block_tier > 0) &&
+                                   (continuations < MAX_CONTINUATIONS) &&
                                    ((cur_pc - psx_pc) < (MAX_SUPER_INSNS * 4)) &&
                                    (deferred_taken_count < MAX_CONTINUATIONS);
 
+                /* Trace: follow a dominantly-taken forward branch inline.
+                 * The [cur_pc, target) gap stays inside the hashed block
+                 * range, so SMC detection still covers the whole trace. */
+                int follow_taken = can_continue &&
+                                   branch_target > cur_pc &&
+                                   (branch_target - psx_pc) < (MAX_SUPER_INSNS * 4) &&
+                                   (psx_pc & 0x1FFFFFFF) < PSX_RAM_SIZE &&
+                                   branch_prefers_taken(cur_pc - 8);
+
                 if (can_continue)
                 {
-                    /* Emit BNE cond → @taken (forward ref, patched later) */
+                    /* Emit BNE cond → @taken (or BEQ cond → @fall-through
+                     * side exit for a trace; forward ref, patched later) */
                     EMIT_LW(REG_AT, 72, REG_SP);
                     DeferredTakenEntry *dt = &deferred_taken[deferred_taken_count++];
-                    dt->target_pc = branch_target;
+                    dt->target_pc = follow_taken ? cur_pc : branch_target;
                     dt->cycle_count = block_cycle_count;
                     memcpy(dt->saved_vregs, vregs, sizeof(vregs));
                     dt->saved_dirty_mask = dirty_const_mask;
                     dt->saved_dyn_dirty = dyn_dirty_mask;
+                    dt->saved_dyn_loaded = dyn_slot_loaded_mask;
                     dt->branch_insn = code_ptr;
-                    emit(MK_I(0x05, REG_AT, REG_ZERO, 0)); /* BNE at, zero, @taken */
+                    emit(MK_I(follow_taken ? 0x04 : 0x05, REG_AT, REG_ZERO, 0)); /* BEQ/BNE at, zero */
                     EMIT_NOP();
 
                     /* Slots intact (AT used for condition, not T0-T7) */
 
-                    /* Fall-through: continue compiling next sub-block.
-                     * vregs carry over — const propagation across fall-through. */
+                    if (follow_taken)
+                    {
+                        psx_code += (branch_target - cur_pc) >> 2;
+                        cur_pc = branch_target;
+#ifdef ENABLE_DYNAREC_STATS
+                        stat_trace_branches++;
+#endif
+                    }
+
+                    /* Fall-through (or trace target): continue compiling
+                     * next sub-block.  vregs carry over — const propagation. */
                     sub_block_start_pc = cur_pc;
                     block_scan(psx_code, SCAN_MAX_INSNS, &scan);
+                    if (block_hot &&
+                        (sub_block_start_pc - psx_pc) + 4 * (uint32_t)scan.insn_count <= MAX_SUPER_INSNS * 4)
+                        block_scan_load_kills(psx_code, &scan);
                     /* If continuation sub-block writes SR, invalidate ISC cache/skip */
                     if (scan.has_mtc0_sr)
                     {
@@ -1464,6 +2106,8 @@ uint32_t *compile_block(uint32_t psx_pc)
                     memcpy(saved_vregs, vregs, sizeof(vregs));
 
                     /* Not taken: fall through PC */
+                    if (block_tier == 0)
+                        emit_branch_profile(cur_pc - 8, 0);
                     emit_branch_epilogue(cur_pc);
 
                     /* Taken path target */
@@ -1474,6 +2118,8 @@ uint32_t *compile_block(uint32_t psx_pc)
                     memcpy(vregs, saved_vregs, sizeof(vregs));
                     dirty_const_mask = saved_dirty_mask;
                     dyn_dirty_mask = saved_dyn_dirty;
+                    if (block_tier == 0)
+                        emit_branch_profile(cur_pc - 8, 1);
                     emit_branch_epilogue(branch_target);
                 }
             }
@@ -1483,6 +2129,7 @@ uint32_t *compile_block(uint32_t psx_pc)
                  * T8 is required by jump_dispatch_trampoline (hash computation). */
                 flush_dirty_consts();
                 dyn_flush_dirty_slots(); /* G: JR/JALR dispatch — dirty-only */
+                uint32_t *ras_imm = ras_return_pc ? emit_ras_push(ras_return_pc) : NULL;
                 EMIT_LW(REG_T8, CPU_PC, REG_S0);
 
                 if (jr_has_prediction)
@@ -1513,7 +2160,7 @@ uint32_t *compile_block(uint32_t psx_pc)
                         EMIT_LW(REG_AT, CPU_IRQ_PENDING_FAST, REG_S0);  /* delay: irq_pending_fast */
                         EMIT_BEQ(REG_AT, REG_ZERO, 3);                  /* no IRQ fast → direct_link */
                         EMIT_NOP();
-                        EMIT_J_ABS((uint32_t)abort_trampoline_addr);
+                        EMIT_J_ABS(irq_exit_addr());
                         EMIT_NOP();
                         emit_direct_link(jr_predicted_pc);
                     }
@@ -1527,9 +2174,18 @@ uint32_t *compile_block(uint32_t psx_pc)
                 else
                 {
                     EMIT_ADDIU(REG_S2, REG_S2, -(int16_t)block_cycle_count);
-                    EMIT_J_ABS((uint32_t)jump_dispatch_trampoline_addr);
-                    EMIT_NOP();
+                    if (jr_is_return)
+                        emit_ras_pop();
+                    /* Returns already have the RAS; other sites may get
+                     * an inline cache in front of the hash dispatch */
+                    if (jr_is_return || !emit_inline_cache(cur_pc - 8))
+                    {
+                        EMIT_J_ABS((uint32_t)jump_dispatch_trampoline_addr);
+                        EMIT_NOP();
+                    }
                 }
+                if (ras_imm)
+                    emit_ras_stub(ras_imm, ras_return_pc);
             }
             block_ended = 1;
             break;
@@ -1544,6 +2200,7 @@ uint32_t *compile_block(uint32_t psx_pc)
             {
                 mark_vreg_const(31, cur_pc + 8);
                 emit_materialize_psx_imm(31, cur_pc + 8);
+                ras_return_pc = cur_pc + 8;
             }
             branch_target = ((cur_pc + 4) & 0xF0000000) | (TARGET(opcode) << 2);
             branch_type = 1;
@@ -1579,7 +2236,10 @@ uint32_t *compile_block(uint32_t psx_pc)
             {
                 mark_vreg_const(rd, cur_pc + 8);
                 emit_materialize_psx_imm(rd, cur_pc + 8);
+                if (rd == 31)
+                    ras_return_pc = cur_pc + 8;
             }
+            jr_is_return = (FUNC(opcode) == 0x08 && rs == 31);
             /* Guarded direct JR: when target register is a compile-time const,
              * record prediction for runtime validation at block epilogue.
              * JR only (not JALR) — JALR is a function call, target varies. */
@@ -1797,8 +2457,13 @@ uint32_t *compile_block(uint32_t psx_pc)
                 op_check == 0x23 || op_check == 0x24 || op_check == 0x25 ||
                 op_check == 0x26)
             {
+                int scan_idx = (int)((cur_pc - sub_block_start_pc) >> 2);
                 load_target = RT(opcode);
-                if (load_target != 0)
+                if (load_target != 0 && scan_idx + 1 < scan.insn_count)
+                {
+                    this_is_load = (scan.load_delay_mask >> scan_idx) & 1;
+                }
+                else if (load_target != 0)
                 {
                     uint32_t next_instr = *psx_code;
                     uint32_t next_op = OP(next_instr);
@@ -1852,10 +2517,30 @@ uint32_t *compile_block(uint32_t psx_pc)
                         dirty_const_mask &= ~(1u << dce_d);
                     }
                 }
-                else if (emit_instruction(opcode, cur_pc, &block_mult_count) < 0)
+                else
                 {
-                    block_ended = 1;
-                    break;
+                    if (dce_idx < SCAN_MAX_INSNS && (scan.store_run_mask >> dce_idx) & 1)
+                        store_run_describe(psx_code - 1, dce_idx, scan.store_run_mask);
+                    /* GTE scan results hold only if the length cap can't
+                     * end the block before the end of the sub-block */
+                    if (dce_idx < SCAN_MAX_INSNS && OP(opcode) == 0x12 &&
+                        (sub_block_start_pc - psx_pc) + 4 * (uint32_t)scan.insn_count <= MAX_SUPER_INSNS * 4)
+                    {
+                        gte_flag_dead = (scan.gte_flag_dead_mask >> dce_idx) & 1;
+                        gte_data_dead = scan.gte_dead_out[dce_idx];
+                        gte_fuse_nclip = (scan.gte_fuse_mask >> dce_idx) & 1;
+                    }
+                    int emitted = emit_instruction(opcode, cur_pc, &block_mult_count);
+                    gte_flag_dead = 0;
+                    gte_data_dead = 0;
+                    gte_fuse_nclip = 0;
+                    store_run_next = 0;
+                    store_run_head = 0;
+                    if (emitted < 0)
+                    {
+                        block_ended = 1;
+                        break;
+                    }
                 }
                 ACCOUNT_INSN(opcode);
             }
@@ -1890,6 +2575,12 @@ uint32_t *compile_block(uint32_t psx_pc)
                 emit_cpu_field_to_psx_reg(CPU_LOAD_DELAY_VAL, pending_load_reg);
                 pending_load_reg = 0;
             }
+            if (hilo_pending)
+                emit_hilo_flush();
+            if (vu0_micro_pending)
+                emit_vu0_micro_flush();
+            if (gte_batch_queued)
+                emit_gte_batch_flush();
             emit_branch_epilogue(cur_pc);
             block_ended = 1;
         }
@@ -1898,7 +2589,17 @@ uint32_t *compile_block(uint32_t psx_pc)
     /* Emit deferred taken-path epilogues (super-block continuations) */
     emit_deferred_taken_all();
 
-    /* Emit all deferred (cold) slow paths at the end of the block */
+    /* Cold code goes to the cold-stub arena, off the hot path.  Sized
+     * from the queues: entries plus the shared abort / overflow stubs */
+    uint32_t *hot_end = code_ptr;
+    int cold_entries = cold_slow_pending() + overflow_cold_pending() + tlb_patch_pending() +
+                       (exit_site_count > 0);
+    uint32_t *cold_start = jit_cold_begin(cold_entries ? (uint32_t)(cold_entries + 2) * COLD_STUB_MAX_WORDS : 0);
+
+    /* Shared `j abort_trampoline` for the exits of this block */
+    emit_exit_stub();
+
+    /* Emit all deferred (cold) slow paths */
     cold_slow_emit_all();
 
     /* P23: Emit deferred overflow exception cold entries + shared stub */
@@ -1908,14 +2609,28 @@ uint32_t *compile_block(uint32_t psx_pc)
     if (psx_tlb_base)
         tlb_patch_emit_all();
 
+    uint32_t *cold_stop = code_ptr;
+    jit_cold_end();
+    jcat_hot_words += (uint32_t)(hot_end - block_start);
+    jcat_cold_words += (uint32_t)(cold_stop - cold_start);
+    jcat_blocks++;
+
     /* M5: Post-compilation delay slot filler pass — REMOVED.
      * Caused rendering glitches (Naughty Dog logo in Crash Bandicoot).
      * The pass moved native instructions into delay slots but lacked
      * sufficient safety checks for all JIT-generated patterns. */
 
-    /* Cache flush done in run_jit_chain after apply_pending_patches. */
+    /* Cache upkeep done in run_jit_chain, batched with the patches */
+    if (cold_start == hot_end)
+        jit_mark_dirty(block_start, cold_stop);
+    else
+    {
+        jit_mark_dirty(block_start, hot_end);
+        jit_mark_dirty(cold_start, cold_stop);
+    }
 
     blocks_compiled++;
+    jit_compile_total++;
 
     /* Detect idle/polling loops */
     {
@@ -1985,67 +2700,49 @@ uint32_t *compile_block(uint32_t psx_pc)
             }
         }
 
-        /* P-ZERO: Detect zero-fill loop.
-         * Pattern: SW $zero, 0(base); ADDIU base, base, 4; BNE base, limit, loop; NOP
-         * Detected independently of idle (stores prevent idle marking).
-         * At runtime, the C handler uses memset for remaining iterations. */
-        uint8_t zfill_pattern = 0, zfill_base = 0, zfill_limit = 0;
-        if (branch_type == 4 && branch_target == psx_pc && is_idle == 0)
+        /* Loop idioms (dynarec_idiom.c): fill, copy, checksum and scan
+         * loops.  Their loads and pointer bumps would otherwise pass the
+         * idle scan above, yet every iteration makes progress, so an
+         * idiom block is never treated as idle. */
+        uint8_t idiom = JIT_IDIOM_NONE;
+        if (branch_type == 4 && branch_target == psx_pc &&
+            (is_idle == 0 || is_idle == 2))
         {
-            uint32_t bic = (cur_pc - psx_pc) / 4;
-            if (bic == 4)
-            {
-                uint32_t *zcode = get_psx_code_ptr(psx_pc);
-                if (zcode)
-                {
-                    uint32_t z0 = zcode[0], z1 = zcode[1], z2 = zcode[2], z3 = zcode[3];
-                    /* SW $zero, 0(base) */
-                    if (OP(z0) == 0x2B && RT(z0) == 0 && SIMM16(z0) == 0 &&
-                        /* ADDIU base, base, 4 */
-                        OP(z1) == 0x09 && RS(z1) == RS(z0) && RT(z1) == RS(z0) &&
-                        SIMM16(z1) == 4 &&
-                        /* BNE with one operand == base */
-                        OP(z2) == 0x05 && z3 == 0)
-                    {
-                        uint8_t base = RS(z0);
-                        uint8_t bne_rs = RS(z2), bne_rt = RT(z2);
-                        uint8_t limit = 0;
-                        if (bne_rs == base && bne_rt != 0)
-                            limit = bne_rt;
-                        else if (bne_rt == base && bne_rs != 0)
-                            limit = bne_rs;
-                        if (limit)
-                        {
-                            zfill_pattern = 1;
-                            zfill_base = base;
-                            zfill_limit = limit;
-                        }
-                    }
-                }
-            }
+            uint32_t *icode = get_psx_code_ptr(psx_pc);
+            if (icode)
+                idiom = (uint8_t)jit_idiom_detect(icode, (cur_pc - psx_pc) / 4);
+            if (idiom != JIT_IDIOM_NONE)
+                is_idle = 0;
         }
 
         BlockEntry *be = cache_block(psx_pc, block_start);
         if (be)
         {
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+            /* Before the fields change: a recompile folds the old count */
+            block_counter_bind(be);
+#endif
             uint32_t block_instr_count = (cur_pc - psx_pc) / 4;
             be->instr_count = block_instr_count;
-            be->native_count = (uint32_t)(code_ptr - block_start);
+            be->native_count = (uint32_t)(hot_end - block_start);
             be->cycle_count = block_cycle_count > 0 ? block_cycle_count : block_instr_count;
             be->is_idle = is_idle;
             be->timeout_reg = timeout_reg_idx;
-            be->block_pattern = zfill_pattern;
-            be->pattern_base_reg = zfill_base;
-            be->pattern_limit_reg = zfill_limit;
-            /* Hash all PSX opcodes for self-modifying code detection */
+            be->block_pattern = idiom;
+            be->tier = (uint8_t)block_tier;
+            be->hot_count = 0;
+            be->slot_entry_loaded = dyn_slots_active ? dyn_slot_entry_loaded : 0;
+            be->const_sig_reg = (uint8_t)block_const_reg;
+            be->const_sig_val = block_const_val;
+            be->const_guard_words = (uint8_t)block_const_guard_words;
+            for (int i = 0; i < DYN_SLOT_COUNT; i++)
+                be->slot_map[i] = (int8_t)dyn_slot_psx[i];
+            /* Hash all PSX opcodes read (incl. the LUI scan window)
+             * for self-modifying code detection */
             uint32_t *opcodes = get_psx_code_ptr(psx_pc);
-            uint32_t hash = 0;
-            if (opcodes)
-            {
-                for (uint32_t i = 0; i < block_instr_count; i++)
-                    hash = (hash << 5) + hash + opcodes[i]; /* djb2 */
-            }
-            be->code_hash = hash;
+            be->code_hash = opcodes ? jit_block_hash(be, opcodes) : 0;
+            be->disk_pending = 0;
+            jit_code_map_mark(psx_pc, block_instr_count);
         }
     }
 
@@ -0,0 +1,255 @@
+/*
+ * dynarec_cost.c - Wait-state cost model and timing calibration
+ *
+ * r3000a_cycle_cost() charges every load 2 cycles and every fetch 1,
+ * wherever the access goes.  With cycle_model = 1 the block cost also
+ * folds in the bus timing of the region each access hits, derived from
+ * the memory control delay/size registers (1F801008h-1F801020h, see
+ * psx-spx "Memory Control"): uncached opcode fetches from BIOS ROM,
+ * DRAM data reads, and SPU/CDROM/expansion port accesses.  The region
+ * comes from the constant address when the compiler knows it, RAM
+ * otherwise.
+ *
+ * cycle_scale applies a per-game correction on top (percent), and
+ * cycle_calib = <file> enables calibration mode: blocks starting at a
+ * checkpoint PC from the reference trace report the emulated cycle
+ * they were reached at, and the drift against the reference is
+ * printed together with the cycle_scale that would cancel it.
+ *
+ * Reference trace format, one checkpoint per line, in hit order:
+ *   <pc hex> <cycles decimal>      # e.g. 80012A40 15823104
+ * The cycle column is the reference emulator's cycle counter at the hit.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "dynarec.h"
+#include "config.h"
+#include "interpreter.h"
+#undef LOG_TAG
+#define LOG_TAG "DYNAREC"
+
+#define RAM_ACCESS_CYCLES   7 /* DRAM: 1 opcode cycle + 6 waitstates (psx-spx) */
+#define IO_ACCESS_CYCLES    3 /* On-chip I/O ports (DMA, timers, IRQ, GPU...) */
+#define CALIB_MAX_POINTS    256
+
+enum
+{
+    COST_RAM,
+    COST_SCRATCH,
+    COST_IO,
+    COST_BIOS,
+    COST_SPU,
+    COST_CDROM,
+    COST_EXP1,
+    COST_EXP2,
+    COST_REGION_COUNT
+};
+
+/* Full cycles for a byte / half / word access, per region */
+static uint8_t cost_access[COST_REGION_COUNT][3];
+
+uint32_t jit_cost_scale = 256;
+
+typedef struct
+{
+    uint32_t pc;
+    uint64_t ref_cycles;
+    uint64_t emu_cycles;
+} CalibPoint;
+
+static CalibPoint *calib_points;
+static int calib_count;
+static int calib_next;
+
+/* Access time from one delay/size register and COM_DELAY, following the
+ * formula in psx-spx; a 32-bit access on an 8-bit bus is 1ST + 3*SEQ. */
+static uint32_t memctrl_access_cycles(uint32_t ds, uint32_t com, int bytes)
+{
+    uint32_t com0 = com & 0xF, com2 = (com >> 8) & 0xF, com3 = (com >> 12) & 0xF;
+    uint32_t access = (ds >> 4) & 0xF;
+    uint32_t first = 0, seq = 0, min = 0;
+
+    if (ds & (1 << 8))
+    {
+        first += com0 - 1;
+        seq += com0 - 1;
+    }
+    if (ds & (1 << 10))
+    {
+        first += com2;
+        seq += com2;
+    }
+    if (ds & (1 << 11))
+        min = com3;
+    if (first < 6)
+        first++;
+    first += access + 2;
+    seq += access + 2;
+    if (first < min + 6)
+        first = min + 6;
+    if (seq < min + 2)
+        seq = min + 2;
+
+    int units = (ds & (1 << 12)) ? (bytes + 1) / 2 : bytes;
+    uint32_t total = first + seq * (uint32_t)(units - 1);
+    return total > 255 ? 255 : total;
+}
+
+/* Recompute the region table from the memory control registers
+ * (mem_ctrl[i] = word at 1F801000h + 4*i; NULL = reset values, all 0).
+ * Called at init and whenever the BIOS/game rewrites those registers;
+ * compiled blocks keep the costs they were built with until flushed. */
+void jit_cost_refresh(const uint32_t *mem_ctrl)
+{
+    static const uint8_t ports[][2] = {
+        /* region, word index of its delay/size register */
+        {COST_EXP1, 0x08 >> 2}, {COST_BIOS, 0x10 >> 2}, {COST_SPU, 0x14 >> 2},
+        {COST_CDROM, 0x18 >> 2}, {COST_EXP2, 0x1C >> 2},
+    };
+    static uint32_t last_sig;
+    uint32_t com = mem_ctrl ? mem_ctrl[0x20 >> 2] : 0;
+    uint32_t sig = com;
+
+    for (int w = 0; w < 3; w++)
+    {
+        cost_access[COST_RAM][w] = RAM_ACCESS_CYCLES;
+        cost_access[COST_SCRATCH][w] = 1;
+        cost_access[COST_IO][w] = IO_ACCESS_CYCLES;
+    }
+    for (unsigned i = 0; i < sizeof(ports) / sizeof(ports[0]); i++)
+    {
+        uint32_t ds = mem_ctrl ? mem_ctrl[ports[i][1]] : 0;
+        sig = sig * 31 + ds;
+        for (int w = 0; w < 3; w++)
+            cost_access[ports[i][0]][w] = (uint8_t)memctrl_access_cycles(ds, com, 1 << w);
+    }
+
+    /* New wait states: re-cost everything that is already compiled */
+    if (psx_config.cycle_model && sig != last_sig)
+    {
+        if (blocks_compiled)
+            jit_flush_pending = 1;
+        interpreter_flush_cache();
+    }
+    last_sig = sig;
+}
+
+static int cost_region(uint32_t addr)
+{
+    uint32_t phys = addr & 0x1FFFFFFF;
+    if (phys < 0x00800000)
+        return COST_RAM;
+    if (phys >= 0x1F800000 && phys < 0x1F800400)
+        return COST_SCRATCH;
+    if (phys >= 0x1FC00000 && phys < 0x1FC80000)
+        return COST_BIOS;
+    if (phys >= 0x1F801C00 && phys < 0x1F802000)
+        return COST_SPU;
+    if (phys >= 0x1F801800 && phys < 0x1F801804)
+        return COST_CDROM;
+    if (phys >= 0x1F802000 && phys < 0x1F804000)
+        return COST_EXP2;
+    if (phys >= 0x1F000000 && phys < 0x1F800000)
+        return COST_EXP1;
+    return COST_IO;
+}
+
+/*
+ * jit_cost_insn: cycles for one instruction under the wait-state model.
+ * addr_known/addr give the data address of a load/store when known.
+ * Falls back to r3000a_cycle_cost() when cycle_model is off.
+ */
+uint32_t jit_cost_insn(uint32_t opcode, uint32_t psx_pc, int addr_known, uint32_t addr)
+{
+    uint32_t cost = r3000a_cycle_cost(opcode);
+    if (!psx_config.cycle_model)
+        return cost;
+
+    /* KSEG1 fetches bypass the I-cache: one full bus access per opcode */
+    if ((psx_pc >> 29) == 5)
+        cost += cost_access[cost_region(psx_pc)][2] - 1;
+
+    uint32_t op = OP(opcode);
+    int is_load = (op >= 0x20 && op <= 0x26) || op == 0x32;
+    int is_store = (op >= 0x28 && op <= 0x2E) || op == 0x3A;
+    if (!is_load && !is_store)
+        return cost;
+
+    int region = addr_known ? cost_region(addr) : COST_RAM;
+    int w = (op == 0x20 || op == 0x24 || op == 0x28) ? 0 : (op == 0x21 || op == 0x25 || op == 0x29) ? 1 : 2;
+    uint32_t access = cost_access[region][w];
+    if (is_load)
+        return access > 2 ? cost - 2 + access : cost; /* Replaces the flat 2 */
+    /* RAM and scratchpad stores retire through the write queue */
+    if (region != COST_RAM && region != COST_SCRATCH)
+        cost += access - 1;
+    return cost;
+}
+
+/* ---- Calibration against a reference trace ---- */
+
+static void jit_calib_load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        printf("DYNAREC: cycle_calib trace '%s' not found\n", path);
+        return;
+    }
+    calib_points = (CalibPoint *)calloc(CALIB_MAX_POINTS, sizeof(CalibPoint));
+    char line[128];
+    while (calib_points && calib_count < CALIB_MAX_POINTS && fgets(line, sizeof(line), f))
+    {
+        unsigned long pc;
+        unsigned long long cyc;
+        if (line[0] == '#' || sscanf(line, "%lx %llu", &pc, &cyc) != 2)
+            continue;
+        calib_points[calib_count].pc = (uint32_t)pc;
+        calib_points[calib_count].ref_cycles = cyc;
+        calib_count++;
+    }
+    fclose(f);
+    printf("DYNAREC: calibration mode, %d checkpoints from %s\n", calib_count, path);
+}
+
+void jit_cost_init(void)
+{
+    int pct = psx_config.cycle_scale > 0 ? psx_config.cycle_scale : 100;
+    jit_cost_scale = (uint32_t)(pct * 256 + 50) / 100;
+    jit_cost_refresh(NULL);
+    if (psx_config.cycle_calib[0])
+        jit_calib_load(psx_config.cycle_calib);
+}
+
+int jit_calib_is_checkpoint(uint32_t psx_pc)
+{
+    for (int i = 0; i < calib_count; i++)
+        if (calib_points[i].pc == psx_pc)
+            return 1;
+    return 0;
+}
+
+/* Called from the entry of checkpoint blocks (lite trampoline, so only
+ * cpu.cycles_left is current).  Only the next expected checkpoint
+ * counts, which keeps repeated PCs in the trace in order. */
+void jit_calib_hit(uint32_t psx_pc)
+{
+    if (calib_next >= calib_count || calib_points[calib_next].pc != psx_pc)
+        return;
+    CalibPoint *p = &calib_points[calib_next];
+    p->emu_cycles = global_cycles + (uint64_t)(cpu.initial_cycles_left - cpu.cycles_left);
+    if (calib_next > 0)
+    {
+        uint64_t ref = p->ref_cycles - calib_points[0].ref_cycles;
+        uint64_t emu = p->emu_cycles - calib_points[0].emu_cycles;
+        if (emu && ref)
+        {
+            uint32_t cur = (jit_cost_scale * 100 + 128) / 256;
+            printf("[CALIB] #%d pc=%08X ref=%llu emu=%llu drift=%+.1f%% suggested cycle_scale=%u\n",
+                   calib_next, (unsigned)psx_pc, (unsigned long long)ref, (unsigned long long)emu,
+                   100.0 * ((double)emu / (double)ref - 1.0),
+                   (unsigned)((cur * ref + emu / 2) / emu));
+        }
+    }
+    calib_next++;
+}
@@ -0,0 +1,363 @@
+/*
+ * dynarec_diskcache.c - Persistent on-disk JIT block cache
+ *
+ * Snapshots the code buffer, the block node pool and the link/patch
+ * and inline cache metadata to a per-game file once the game has run for
+ * psx_config.jit_cache_frames frames, and restores it at the next boot
+ * so the BIOS and early game code do not have to be recompiled.
+ *
+ * Emitted code embeds absolute host addresses (cpu, helpers, trampolines,
+ * BlockEntry nodes), so a snapshot is only reused by an identical build
+ * whose buffers land at the same addresses; the header fingerprint
+ * rejects anything else.  Every restored block starts disk_pending and
+ * is checked against the opcodes in RAM (code_hash, which also covers
+ * the LUI scan window of tier-1 blocks) on first use.
+ */
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "dynarec.h"
+#include "config.h"
+#include "loader.h"
+
+#define DISKCACHE_MAGIC   0x4A505350u /* "PSPJ" */
+#define DISKCACHE_VERSION 10
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    /* Fingerprint: build + host layout + configuration */
+    uint32_t code_buffer;
+    uint32_t code_buffer_size; /* Segment layout */
+    uint32_t block_node_pool;
+    uint32_t jit_ht;
+    uint32_t psx_ram;
+    uint32_t psx_bios;
+    uint32_t cpu;
+    uint32_t compile_fn;
+    uint32_t entry_size;
+    uint32_t gte_vu0;
+    uint32_t codegen;         /* Other config baked into native code */
+    uint32_t bios_hash;
+    /* Payload sizes */
+    uint32_t code_words;
+    uint32_t block_count;
+    uint32_t patch_count;
+    uint32_t link_count;
+    uint32_t ic_count;
+    uint32_t seg_cur;
+    uint32_t code_ptr_words;
+} DiskCacheHeader;
+
+static int diskcache_saved = 0;
+
+static int diskcache_exe_hashed = 0;
+static uint32_t diskcache_exe_hash = 0;
+
+/* jitcache_<game ID>_<boot EXE hash>.bin ("exe" / "bios" without a disc
+ * ID).  The EXE is hashed once, at load, so the save never reads the disc. */
+static void diskcache_path(char *buf, size_t len)
+{
+    const char *id = "bios";
+    if (psx_config.game_id[0])
+        id = psx_config.game_id;
+    else if (psx_boot_mode == BOOT_MODE_ISO || (psx_exe_filename && psx_exe_filename[0]))
+        id = "exe";
+    if (!diskcache_exe_hashed)
+    {
+        diskcache_exe_hashed = 1;
+        if (Loader_HashBootEXE(&diskcache_exe_hash) < 0)
+            diskcache_exe_hash = 0;
+    }
+    snprintf(buf, len, "jitcache_%s_%08X.bin", id, (unsigned)diskcache_exe_hash);
+}
+
+static void diskcache_fingerprint(DiskCacheHeader *h)
+{
+    memset(h, 0, sizeof(*h));
+    h->magic = DISKCACHE_MAGIC;
+    h->version = DISKCACHE_VERSION;
+    h->code_buffer = (uint32_t)code_buffer;
+    h->code_buffer_size = code_buffer_size;
+    h->block_node_pool = (uint32_t)block_node_pool;
+    h->jit_ht = (uint32_t)jit_ht;
+    h->psx_ram = (uint32_t)psx_ram;
+    h->psx_bios = (uint32_t)psx_bios;
+    h->cpu = (uint32_t)&cpu;
+    h->compile_fn = (uint32_t)compile_block;
+    h->entry_size = sizeof(BlockEntry);
+    h->gte_vu0 = psx_config.gte_vu0;
+    h->codegen = (uint32_t)psx_config.gte_vu1_batch | ((uint32_t)psx_config.jit_lazy_cycles << 1) |
+                 ((uint32_t)psx_config.cycle_model << 2) | ((uint32_t)psx_config.bios_hle << 3) |
+                 ((uint32_t)psx_config.gte_lazy_flags << 4) |
+                 ((uint32_t)GTE_ConfigTier() << 5) |
+                 ((uint32_t)psx_config.cycle_scale << 8) |
+                 ((uint32_t)psx_config.jit_shared_stubs << 17) |
+                 ((uint32_t)psx_config.jit_const_links << 18) |
+                 ((uint32_t)psx_config.jit_fast_irq << 19) |
+                 ((uint32_t)psx_config.jit_inline_caches << 20) |
+                 ((uint32_t)psx_config.jit_gp0_fifo << 23);
+    h->bios_hash = jit_code_hash((const uint32_t *)psx_bios, PSX_BIOS_SIZE / 4);
+}
+
+static int diskcache_io(int fd, void *buf, size_t len, int is_write)
+{
+    uint8_t *p = (uint8_t *)buf;
+    while (len > 0)
+    {
+        ssize_t n = is_write ? write(fd, p, len) : read(fd, p, len);
+        if (n <= 0)
+            return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/*
+ * jit_diskcache_save: write the current cache state.  Called once from
+ * the frame path, between chains, so no native code is running.
+ */
+void jit_diskcache_save(void)
+{
+    DiskCacheHeader h;
+    char path[64];
+    int i;
+
+    if (diskcache_saved || psx_tlb_base != 0)
+        return;
+    diskcache_saved = 1;
+
+    /* Drop blocks a P28 epoch check would already reject */
+    uint32_t *code_base = code_segment_base(0);
+    uint32_t *code_end = code_ptr;
+    for (i = 0; i < block_node_pool_idx; i++)
+    {
+        BlockEntry *be = &block_node_pool[i];
+        if (be->native && be->smc_epoch != smc_page_epoch)
+            be->native = NULL;
+        if (be->native && be->native >= code_end)
+        {
+            /* Older segment of a wrapped ring: keep it whole */
+            int seg = (int)((be->native - code_base) / CODE_SEGMENT_WORDS);
+            code_end = code_segment_base(seg + 1);
+        }
+    }
+
+    diskcache_fingerprint(&h);
+    h.code_words = (uint32_t)(code_end - code_base);
+    h.block_count = (uint32_t)block_node_pool_idx;
+    h.patch_count = (uint32_t)patch_sites_count;
+    h.link_count = (uint32_t)link_sites_count;
+    h.ic_count = (uint32_t)jit_ic_sites_count;
+    h.seg_cur = (uint32_t)code_seg_cur;
+    h.code_ptr_words = (uint32_t)(code_ptr - code_base);
+
+    diskcache_path(path, sizeof(path));
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        printf("JITCACHE: cannot create %s\n", path);
+        return;
+    }
+
+    /* Store the unpatched words under an active poll patch */
+    uint32_t poll_words[2] = {0, 0};
+    if (poll_patched_addr)
+    {
+        poll_words[0] = poll_patched_addr[0];
+        poll_words[1] = poll_patched_addr[1];
+        poll_patched_addr[0] = poll_patched_saved[0];
+        poll_patched_addr[1] = poll_patched_saved[1];
+    }
+
+    int err = diskcache_io(fd, &h, sizeof(h), 1);
+    if (!err)
+        err = diskcache_io(fd, code_base, h.code_words * sizeof(uint32_t), 1);
+    if (!err)
+        err = diskcache_io(fd, block_node_pool, h.block_count * sizeof(BlockEntry), 1);
+    if (!err)
+        err = diskcache_io(fd, patch_sites, h.patch_count * sizeof(PatchSite), 1);
+    if (!err)
+        err = diskcache_io(fd, link_sites, h.link_count * sizeof(PatchSite), 1);
+    if (!err)
+        err = diskcache_io(fd, jit_ic_sites, h.ic_count * sizeof(JitICSite), 1);
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+    /* Restored code bumps the counter slots it was bound to */
+    if (!err)
+        err = diskcache_io(fd, jit_block_count_slot, h.block_count * sizeof(uint32_t), 1);
+    if (!err)
+        err = diskcache_io(fd, &jit_block_counts_next, sizeof(jit_block_counts_next), 1);
+#endif
+    close(fd);
+
+    if (poll_patched_addr)
+    {
+        poll_patched_addr[0] = poll_words[0];
+        poll_patched_addr[1] = poll_words[1];
+    }
+
+    if (err)
+    {
+        printf("JITCACHE: write to %s failed\n", path);
+        unlink(path);
+        return;
+    }
+    printf("JITCACHE: saved %u blocks, %u KB code to %s\n",
+           (unsigned)blocks_compiled, (unsigned)(h.code_words / 256), path);
+}
+
+/*
+ * jit_diskcache_load: restore a snapshot into the (empty) cache.  Nodes
+ * are restored at their pool index, so every BlockEntry lands at the
+ * address its code was compiled against; dead ones go to the free list.  Resolved links are reverted to pending
+ * patches: a link is only re-established once its target passes the
+ * RAM check in jit_diskcache_verify.
+ */
+void jit_diskcache_load(void)
+{
+    DiskCacheHeader h, want;
+    char path[64];
+    uint32_t i;
+
+    if (psx_tlb_base != 0)
+        return;
+
+    diskcache_path(path, sizeof(path));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    diskcache_fingerprint(&want);
+    if (diskcache_io(fd, &h, sizeof(h), 0) < 0 ||
+        memcmp(&h, &want, offsetof(DiskCacheHeader, code_words)) != 0 ||
+        h.code_words > (code_buffer_size / 4) - CODE_TRAMPOLINE_WORDS ||
+        h.code_ptr_words > h.code_words || h.seg_cur >= CODE_SEGMENT_COUNT ||
+        h.block_count > BLOCK_NODE_POOL_SIZE || h.patch_count > PATCH_SITE_MAX ||
+        h.link_count > LINK_SITE_MAX || h.ic_count > JIT_IC_SITE_MAX)
+    {
+        printf("JITCACHE: %s is stale, ignoring\n", path);
+        close(fd);
+        return;
+    }
+
+    uint32_t *code_base = code_segment_base(0);
+    int err = diskcache_io(fd, code_base, h.code_words * sizeof(uint32_t), 0);
+    for (i = 0; !err && i < h.block_count; i++)
+    {
+        BlockEntry rec;
+        err = diskcache_io(fd, &rec, sizeof(rec), 0);
+        if (err)
+            break;
+        BlockEntry *be = &block_node_pool[i];
+        rec.next = NULL;
+        rec.disk_pending = rec.native != NULL;
+        if (rec.native)
+        {
+            BlockEntry **slot = jit_block_slot(rec.psx_pc, 1);
+            if (!slot || *slot)
+            {
+                err = 1;
+                break;
+            }
+            *slot = be;
+            rec.page_gen = jit_get_page_gen(rec.psx_pc & 0x1FFFFFFF);
+            *be = rec;
+            block_nodes_live++;
+        }
+        else
+        {
+            /* Dead or recycled node: keep its index, hand it back */
+            rec.next = block_node_free_list;
+            *be = rec;
+            block_node_free_list = be;
+        }
+        block_node_pool_idx = (int)i + 1;
+    }
+    if (!err)
+        err = diskcache_io(fd, patch_sites, h.patch_count * sizeof(PatchSite), 0);
+    if (!err)
+        err = diskcache_io(fd, link_sites, h.link_count * sizeof(PatchSite), 0);
+    if (!err)
+        err = diskcache_io(fd, jit_ic_sites, h.ic_count * sizeof(JitICSite), 0);
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+    if (!err)
+        err = diskcache_io(fd, jit_block_count_slot, h.block_count * sizeof(uint32_t), 0);
+    if (!err)
+        err = diskcache_io(fd, &jit_block_counts_next, sizeof(jit_block_counts_next), 0);
+    if (!err && jit_block_counts_next > JIT_BLOCK_COUNT_SLOTS)
+        err = 1;
+#endif
+    close(fd);
+
+    if (err)
+    {
+        printf("JITCACHE: %s is truncated, ignoring\n", path);
+        dynarec_flush_cache();
+        return;
+    }
+
+    patch_sites_count = (int)h.patch_count;
+    for (i = 0; i < h.link_count; i++)
+    {
+        PatchSite *ls = &link_sites[i];
+        *ls->site_word = MK_J(2, (uint32_t)abort_trampoline_addr >> 2);
+        if (patch_sites_count < PATCH_SITE_MAX)
+            patch_sites[patch_sites_count++] = *ls;
+    }
+    link_sites_count = 0;
+
+    /* Inline cache sites keep their filled entries (now pending links) */
+    jit_ic_sites_count = (int)h.ic_count;
+    for (i = 0; i < h.ic_count; i++)
+    {
+        JitICSite *s = &jit_ic_sites[i];
+        if (s->code && s->code >= code_base + h.code_words)
+            s->code = NULL;
+#ifdef ENABLE_JIT_DUMP
+        s->execs = 0;
+        s->misses = 0;
+        memset(s->hits, 0, sizeof(s->hits));
+#endif
+    }
+
+    /* L2 pages allocated above bumped the epoch: restamp every block */
+    blocks_compiled = 0;
+    for (i = 0; i < h.block_count; i++)
+    {
+        block_node_pool[i].smc_epoch = smc_page_epoch;
+        if (block_node_pool[i].native)
+            blocks_compiled++;
+    }
+
+    code_seg_cur = (int)h.seg_cur;
+    code_ptr = code_base + h.code_ptr_words;
+    code_seg_end = code_segment_base(code_seg_cur + 1);
+    jit_cold_reset();
+    jit_flush_pending = 1;
+    printf("JITCACHE: loaded %u blocks from %s\n", (unsigned)blocks_compiled, path);
+}
+
+/*
+ * jit_diskcache_verify: first use of a restored block.  Returns its native
+ * code if the PSX opcodes still hash to code_hash (and links pending
+ * callers to it), otherwise drops the block so it is recompiled.
+ */
+uint32_t *jit_diskcache_verify(BlockEntry *be)
+{
+    uint32_t *opcodes = get_psx_code_ptr(be->psx_pc);
+    be->disk_pending = 0;
+    if (!opcodes || jit_block_hash(be, opcodes) != be->code_hash)
+    {
+        jit_ht_remove(be->psx_pc);
+        block_node_free(be);
+        if (blocks_compiled > 0)
+            blocks_compiled--;
+        return NULL;
+    }
+    jit_code_map_mark(be->psx_pc, be->instr_count);
+    apply_pending_patches(be->psx_pc, be->native);
+    return be->native;
+}
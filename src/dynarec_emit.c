@@ -87,9 +87,14 @@ static inline int dyn_slot_find(int r)
     return psx_to_slot[r];
 }
 
-/* Assign dynamic slots based on access-count scoring.
- * Registers with the most accesses get slots first, as each
- * slotted access avoids a LW/SW spill (1-2 EE words saved).
+/* Assign dynamic slots to the highest-scoring PSX registers.  Score is
+ * the access count from block_scan() (each slotted access avoids a LW/SW
+ * spill, 1-2 EE words) plus a use-density bonus: the count divided by the
+ * span [reg_first_use, reg_last_use], so loop counters and pointers used
+ * close together win over registers touched rarely across the block.
+ * This is a greedy scoring heuristic, not an allocator: every slot is held
+ * for the whole block and never reused, because cold paths emitted at
+ * block end flush with the final mapping.
  * Minimum 2 accesses required to justify slot overhead. */
 void dyn_assign_slots(BlockScanResult *scan)
 {
@@ -99,7 +104,7 @@ void dyn_assign_slots(BlockScanResult *scan)
         psx_to_slot[i] = -1;
     dyn_slots_active = 0;
 
-    /* Score = raw access count (each spill avoided saves 1-2 words) */
+    /* Score = access count, plus a bonus for a short use span */
     uint32_t scores[32];
     for (int r = 0; r < 32; r++)
     {
@@ -108,7 +113,11 @@ void dyn_assign_slots(BlockScanResult *scan)
             scores[r] = 0;
             continue;
         }
-        scores[r] = (uint32_t)scan->reg_access_count[r];
+        uint32_t count = scan->reg_access_count[r];
+        uint32_t span = 1;
+        if (scan->reg_last_use[r] >= scan->reg_first_use[r])
+            span += (uint32_t)(scan->reg_last_use[r] - scan->reg_first_use[r]);
+        scores[r] = count * 16 + (count * 16) / span;
     }
 
     int slot = 0;
@@ -276,6 +285,24 @@ void dyn_reload_one_slot(int r)
         EMIT_LW(dyn_slot_ee[si], CPU_REG(r), REG_S0);
 }
 
+/* 1 if every slot the target loads at entry already holds the same PSX
+ * register with a valid value here, so its entry LW sequence can be
+ * skipped.  Stores are still flushed at the epilogue: the target assumes
+ * cpu.regs[] is current for its non-dirty slots. */
+int dyn_slots_match_entry(const int8_t *slot_map, uint8_t entry_loaded)
+{
+    if (entry_loaded == 0)
+        return 1;
+    if (!dyn_slots_active || (dyn_slot_loaded_mask & entry_loaded) != entry_loaded)
+        return 0;
+    for (int i = 0; i < DYN_SLOT_COUNT; i++)
+    {
+        if ((entry_loaded & (1u << i)) && dyn_slot_psx[i] != slot_map[i])
+            return 0;
+    }
+    return 1;
+}
+
 void dyn_reset_slots(void)
 {
     for (int i = 0; i < DYN_SLOT_COUNT; i++)
@@ -5,32 +5,59 @@
  * dispatcher emit_gte_instruction().  Split from dynarec_insn.c for
  * maintainability.
  */
+#include <stddef.h>
 #include "dynarec.h"
+#include "config.h"
 #undef LOG_TAG
 #define LOG_TAG "DYNAREC"
 
 extern void emit_flush_partial_cycles(void);
 
-#ifdef PLATFORM_PS2
-extern uint8_t vu0_matrix_dirty;
+/* ---- Dead GTE output stores ----
+ * gte_data_dead is set by the compile loop from block_scan's GTE output
+ * liveness.  While an inline RTPS/RTPT is emitted, gte_skip_stores holds
+ * the cp2_data registers whose store may be dropped: MAC1/MAC2/IR3 and
+ * MAC0/IR0 (IR1/IR2/MAC3/SZ/SXY are read back by emit_rtps_project). */
+#define GTE_RTP_SKIPPABLE ((1u << 8) | (1u << 11) | (1u << 24) | (1u << 25) | (1u << 26))
+#define GTE_RTP_VERTEX_TEMP ((1u << 11) | (1u << 25) | (1u << 26)) /* RTPT vertex 0/1 */
+uint32_t gte_data_dead = 0;
+static uint32_t gte_skip_stores = 0;
+int gte_fuse_nclip = 0;
+int gte_nclip_fused = 0;
 
-/* Emit inline code to set VU0 matrix dirty bit for ctrl register rd5.
- * Clobbers T8, T9.  Emits 0 words (rd5 > 20) or 5 words. */
-static void emit_vu0_dirty_bit(int rd5)
+#if !defined(ENABLE_VU0_MICRO) && defined(PLATFORM_PS2)
+static void vu0_drop_resident(uint8_t bit);
+#endif
+
+static void emit_gte_data_sw(int rt, int reg)
 {
-    uint8_t bit;
-    if (rd5 <= 7)       bit = 0x01; /* RT */
-    else if (rd5 <= 12) bit = 0x02; /* LT */
-    else if (rd5 <= 15) bit = 0x04; /* BK */
-    else if (rd5 <= 20) bit = 0x08; /* LC */
-    else return; /* regs 21-31: no matrix */
-
-    emit_load_imm32(REG_T9, (uint32_t)(uintptr_t)&vu0_matrix_dirty);
-    EMIT_LBU(REG_T8, 0, REG_T9);
-    EMIT_ORI(REG_T8, REG_T8, bit);
-    EMIT_SB(REG_T8, 0, REG_T9);
+    if (!((gte_skip_stores >> reg) & 1))
+        EMIT_SW(rt, CPU_CP2_DATA(reg), REG_S0);
 }
+
+/* Emit inline code to mark the decoded matrix caches (C and VU0/VFPU
+ * lanes) dirty for ctrl register rd5.
+ * Clobbers T8, T9.  Emits 0 words (rd5 > 23) or 5 words. */
+static void emit_gte_matrix_dirty(int rd5)
+{
+    uint8_t bit = gte_ctrl_matrix_bit(rd5);
+    if (!bit)
+        return; /* regs 24-31: no matrix */
+
+#ifdef PLATFORM_PSP
+    if (bit & GTE_MTX_LL)
+        vfpu_light_resident &= ~1;
+    if (bit & (GTE_MTX_LC | GTE_MTX_BK))
+        vfpu_light_resident &= ~2;
+#endif
+#if !defined(ENABLE_VU0_MICRO) && defined(PLATFORM_PS2)
+    vu0_drop_resident(bit);
 #endif
+    emit_load_imm32(REG_T9, (uint32_t)(uintptr_t)&gte_matrix_dirty);
+    EMIT_LHU(REG_T8, 0, REG_T9);
+    EMIT_ORI(REG_T8, REG_T8, bit * 0x0101);
+    EMIT_SH(REG_T8, 0, REG_T9);
+}
 
 /* ================================================================
  * GTE inline helper emitters
@@ -90,6 +117,15 @@ static void emit_ir_sat_store(int lm)
      * Only lane 0 (lower 32 bits) matters; upper lanes are don't-care.
      * PMAXW/PMINW execute in 1 cycle each, replacing 4-word SLT+MOVN
      * per channel (saves 6 emitted words). */
+    if (!lm && gte_tier == GTE_TIER_ULTRA)
+    {
+        /* Ultra tier: lm=0 IR only leaves int16 range on overflow */
+        EMIT_SW(REG_V0, CPU_CP2_DATA(9), REG_S0);
+        EMIT_SW(REG_V1, CPU_CP2_DATA(10), REG_S0);
+        emit_gte_data_sw(REG_A0, 11);
+        EMIT_SW(REG_ZERO, CPU_CP2_CTRL(31), REG_S0);
+        return;
+    }
     EMIT_ORI(REG_T9, REG_ZERO, 0x7FFF);
     if (lm)
     {
@@ -115,7 +151,7 @@ static void emit_ir_sat_store(int lm)
 
     EMIT_SW(REG_V0, CPU_CP2_DATA(9), REG_S0);
     EMIT_SW(REG_V1, CPU_CP2_DATA(10), REG_S0);
-    EMIT_SW(REG_A0, CPU_CP2_DATA(11), REG_S0);
+    emit_gte_data_sw(REG_A0, 11);
     EMIT_SW(REG_ZERO, CPU_CP2_CTRL(31), REG_S0);
 }
 
@@ -211,12 +247,43 @@ static void emit_interpolate_color(int sf)
 #if !defined(ENABLE_VU0_MICRO) && defined(PLATFORM_PS2)
 static int vu0_preloaded[3] = {0, 0, 0};
 
+/* Resident slots: matrix mx lives in VF[VU0_SLOT_VF(mx)..+3] with the
+ * translation vu0_resident_cv[mx].  The C paths in gte.c only touch
+ * VF1-VF6, so the slots survive C calls; native code is only entered at
+ * the block start, so a slot stays valid until a CTC2 in the same block
+ * changes its matrix or translation.  Reset per block by the compile
+ * loop.  Bit mx of vu0_mtx_resident = slot mx valid. */
+#define VU0_SLOT_VF(mx) (11 + (mx) * 4)
+int vu0_mtx_resident = 0;
+static uint8_t vu0_resident_cv[3];
+
+static uint8_t vu0_cv_bit(int cv)
+{
+    if (cv == 0)
+        return GTE_MTX_RT; /* TR shares ctrl 5-7 with the RT group */
+    return cv == 1 ? GTE_MTX_BK : 0;
+}
+
+/* A CTC2 touched matrix group bit: drop the slots that depend on it. */
+static void vu0_drop_resident(uint8_t bit)
+{
+    static const uint8_t mtx_bit[3] = {GTE_MTX_RT, GTE_MTX_LL, GTE_MTX_LC};
+    for (int mx = 0; mx < 3; mx++)
+        if (bit & (mtx_bit[mx] | vu0_cv_bit(vu0_resident_cv[mx])))
+            vu0_mtx_resident &= ~(1 << mx);
+}
+
 /* Emit C call to refresh matrix cache + load into VF[vf_base..vf_base+3].
  * After call: vu0_jit_cache contains the matrix, VF regs loaded, T8 clobbered.
  * Emits 12 words. */
 static void emit_vu0_load_matrix(int mx, int cv, int vf_base)
 {
     uint32_t mx_cv = (uint32_t)(mx | (cv << 2));
+    if (mx < 3 && vf_base == VU0_SLOT_VF(mx))
+    {
+        vu0_mtx_resident |= 1 << mx;
+        vu0_resident_cv[mx] = (uint8_t)cv;
+    }
     EMIT_MOVE(REG_A0, REG_S0);
     EMIT_ORI(REG_A1, REG_ZERO, mx_cv);
     emit_call_c_lite((uint32_t)(uintptr_t)vu0_prepare_mvmva);
@@ -227,6 +294,24 @@ static void emit_vu0_load_matrix(int mx, int cv, int vf_base)
     EMIT_LQC2(vf_base + 3, 48, REG_T8); /* trans  */
 }
 
+/* Make matrix mx with translation cv available in its resident slot,
+ * loading it only when no earlier command in this block left it there.
+ * Returns the slot's first VF register; *t8_valid (if non-NULL) tells
+ * whether T8 still holds &vu0_jit_cache. */
+static int emit_vu0_resident_matrix(int mx, int cv, int *t8_valid)
+{
+    int loaded = !((vu0_mtx_resident >> mx) & 1) || vu0_resident_cv[mx] != cv;
+#ifdef ENABLE_DYNAREC_STATS
+    if (!loaded)
+        stat_gte_vu0_reuse++;
+#endif
+    if (loaded)
+        emit_vu0_load_matrix(mx, cv, VU0_SLOT_VF(mx));
+    if (t8_valid)
+        *t8_valid = loaded;
+    return VU0_SLOT_VF(mx);
+}
+
 /* Emit VU0 vertex multiply using pre-loaded matrix in VF[vf_col1..vf_col1+3].
  * If t8_valid=0, loads T8 = &vu0_jit_cache (2 extra words).
  * VF5 = vertex, VF6 = result.
@@ -281,8 +366,8 @@ static void emit_vu0_vertex_multiply(int v, int lm, int vf_col1, int t8_valid)
     EMIT_MFC1(REG_A0, 2);
 
     /* Store MAC1-3 + IR saturation + FLAG=0. */
-    EMIT_SW(REG_V0, CPU_CP2_DATA(25), REG_S0);
-    EMIT_SW(REG_V1, CPU_CP2_DATA(26), REG_S0);
+    emit_gte_data_sw(REG_V0, 25);
+    emit_gte_data_sw(REG_V1, 26);
     EMIT_SW(REG_A0, CPU_CP2_DATA(27), REG_S0);
     emit_ir_sat_store(lm);
 }
@@ -296,11 +381,19 @@ static void emit_vu0_vertex_multiply(int v, int lm, int vf_col1, int t8_valid)
  * Index: 0=RT, 1=Light, 2=Color. */
 static int vfpu_preloaded[3] = {0, 0, 0};
 
+/* Slots still holding what a lighting command loaded: bit 0 = Light
+ * (slot1, no TR), bit 1 = Color + BK (slot2).  Native code is only
+ * entered at the block start, so a slot stays valid until something in
+ * the same block overwrites it or a CTC2 changes LL/LC/BK.  Reset per
+ * block by the compile loop. */
+int vfpu_light_resident = 0;
+
 /* Emit C call + lv.q to preload a matrix into VFPU registers.
  * slot=1: M000(C000/C010/C020) + C200,  slot=2: M400(C400/C410/C420) + C600 */
 static void emit_vfpu_preload_matrix(int mx, int cv, int slot)
 {
     uint32_t mx_cv = (uint32_t)(mx | (cv << 2));
+    vfpu_light_resident &= ~slot; /* slot is about to be overwritten */
     EMIT_MOVE(REG_A0, REG_S0);
     EMIT_ORI(REG_A1, REG_ZERO, mx_cv);
     emit_call_c_lite((uint32_t)(uintptr_t)vu0_prepare_mvmva);
@@ -317,6 +410,35 @@ static void emit_vfpu_preload_matrix(int mx, int cv, int slot)
         EMIT_LV_Q(VFPU_C200, 48, REG_T8);
     }
 }
+
+/* Bracket a lighting command: slots = 3 for NC* (Light + Color), 2 for
+ * CC/CDP (Color only).  Loads the slots an earlier command in this
+ * block has not left resident, then lets emit_inline_mvmva use them. */
+static void emit_vfpu_light_begin(int slots)
+{
+    int missing = slots & ~vfpu_light_resident;
+#ifdef ENABLE_DYNAREC_STATS
+    if (!missing)
+        stat_gte_vfpu_reuse++;
+#endif
+    if (missing & 1)
+        emit_vfpu_preload_matrix(1, 3, 1);
+    if (missing & 2)
+        emit_vfpu_preload_matrix(2, 1, 2);
+    vfpu_light_resident |= slots;
+    if (slots & 1)
+        vfpu_preloaded[1] = 1;
+    vfpu_preloaded[2] = 2;
+}
+
+static void emit_vfpu_light_end(void)
+{
+    vfpu_preloaded[1] = 0;
+    vfpu_preloaded[2] = 0;
+}
+#else
+#define emit_vfpu_light_begin(slots) ((void)0)
+#define emit_vfpu_light_end() ((void)0)
 #endif /* PLATFORM_PSP */
 
 #ifdef ENABLE_VU0_MICRO
@@ -400,8 +522,8 @@ static void emit_vu0_micro_multiply(int v, int lm, int use_core)
     EMIT_LW(REG_A0, VU0_OFF_OUT_MAC + 8, REG_T8); /* MAC3 */
 
     /* Store MAC1-3 + IR saturation + FLAG=0 */
-    EMIT_SW(REG_V0, CPU_CP2_DATA(25), REG_S0);
-    EMIT_SW(REG_V1, CPU_CP2_DATA(26), REG_S0);
+    emit_gte_data_sw(REG_V0, 25);
+    emit_gte_data_sw(REG_V1, 26);
     EMIT_SW(REG_A0, CPU_CP2_DATA(27), REG_S0);
     emit_ir_sat_store(lm);
 }
@@ -447,11 +569,91 @@ static void emit_vu0_micro_poll_complete(int lm)
     EMIT_LW(REG_V0, VU0_OFF_OUT_MAC + 0, REG_T8);
     EMIT_LW(REG_V1, VU0_OFF_OUT_MAC + 4, REG_T8);
     EMIT_LW(REG_A0, VU0_OFF_OUT_MAC + 8, REG_T8);
-    EMIT_SW(REG_V0, CPU_CP2_DATA(25), REG_S0);
-    EMIT_SW(REG_V1, CPU_CP2_DATA(26), REG_S0);
+    emit_gte_data_sw(REG_V0, 25);
+    emit_gte_data_sw(REG_V1, 26);
     EMIT_SW(REG_A0, CPU_CP2_DATA(27), REG_S0);
     emit_ir_sat_store(lm);
 }
+
+/* ---- Asynchronous MVMVA ----
+ * An inline MVMVA followed by at least VU0_ASYNC_MIN_RUN instructions
+ * that don't touch the GTE only launches the micro program; the EE runs
+ * those instructions while VU0 computes, and the poll plus the MAC/IR
+ * stores are emitted right before the first instruction of any other
+ * kind (a COP2 op, a branch, a memory access that may call C, the block
+ * end).  Nothing in the run has an abort path or a C call, so no code
+ * can observe cpu.cp2_data before the results land. */
+#define VU0_ASYNC_MIN_RUN 2
+#define VU0_ASYNC_LOOKAHEAD 16
+
+int vu0_micro_pending = 0;     /* 0 = none, else lm + 1 of the launched MVMVA */
+static int vu0_micro_lazy = 0; /* the MVMVA being emitted may defer its poll */
+
+static int vu0_micro_spans(uint32_t opcode, int lookahead)
+{
+    switch (OP(opcode))
+    {
+    case 0x00:
+    {
+        uint32_t f = opcode & 0x3F;
+        return f == 0x00 || f == 0x02 || f == 0x03 || f == 0x04 || f == 0x06 || f == 0x07 ||
+               (f >= 0x10 && f <= 0x13) || (f >= 0x18 && f <= 0x1B) || f == 0x21 || f == 0x23 ||
+               (f >= 0x24 && f <= 0x27) || f == 0x2A || f == 0x2B;
+    }
+    case 0x09: /* ADDIU..LUI (no ADDI: it can trap) */
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+    case 0x0D:
+    case 0x0E:
+    case 0x0F:
+        return 1;
+    case 0x23: /* LW from RAM: inline, no slow path */
+        return lookahead || (smrv_is_known_ram(RS(opcode)) && align_is_known(RS(opcode)) &&
+                             (SIMM16(opcode) & 3) == 0);
+    }
+    return 0;
+}
+
+void emit_vu0_micro_flush(void)
+{
+    emit_vu0_micro_poll_complete(vu0_micro_pending - 1);
+    reg_cache_invalidate();
+    vu0_micro_pending = 0;
+}
+
+void emit_vu0_micro_point(uint32_t opcode, const uint32_t *next, int in_delay_slot)
+{
+    if (vu0_micro_pending && !vu0_micro_spans(opcode, 0))
+        emit_vu0_micro_flush();
+    vu0_micro_lazy = 0;
+    /* MVMVA, sf=1: the only inline command whose last step is the multiply */
+    if (in_delay_slot || OP(opcode) != 0x12 || !(opcode & 0x02000000) ||
+        (opcode & 0x3F) != 0x12 || !((opcode >> 19) & 1))
+        return;
+    int run = 0;
+    while (run < VU0_ASYNC_LOOKAHEAD && vu0_micro_spans(next[run], 1))
+        run++;
+    vu0_micro_lazy = run >= VU0_ASYNC_MIN_RUN;
+}
+
+/* Emit the MVMVA micro path up to the launch; the poll waits for
+ * emit_vu0_micro_flush */
+static void emit_vu0_micro_mvmva_async(int mx, int v, int cv, int lm)
+{
+    if (vu0_micro_preloaded[mx])
+        emit_vu0_micro_launch(v, 1);
+    else
+    {
+        emit_vu0_micro_prepare(mx, cv);
+        emit_vu0_micro_launch(v, 0);
+    }
+    vu0_micro_pending = lm + 1;
+    vu0_micro_lazy = 0;
+#ifdef ENABLE_DYNAREC_STATS
+    stat_gte_vu0_async++;
+#endif
+}
 #endif /* ENABLE_VU0_MICRO */
 
 /* Emit inline MVMVA: MAC = Matrix × Vector + Translation, then store MAC+IR.
@@ -501,10 +703,16 @@ static void emit_inline_mvmva(int mx, int v, int cv, int sf, int lm)
              * T8 was clobbered since matrix load → reload needed. */
             emit_vu0_vertex_multiply(v, lm, vf_base, 0);
         }
+        else if (mx < 3)
+        {
+            /* Standalone call: reuse the resident slot or load it.
+             * T8 still valid after a load → skip reload. */
+            int t8_valid;
+            vf_base = emit_vu0_resident_matrix(mx, cv, &t8_valid);
+            emit_vu0_vertex_multiply(v, lm, vf_base, t8_valid);
+        }
         else
         {
-            /* Standalone call: load matrix + compute.
-             * T8 still valid from emit_vu0_load_matrix → skip reload. */
             emit_vu0_load_matrix(mx, cv, 1);
             emit_vu0_vertex_multiply(v, lm, 1, 1);
         }
@@ -524,6 +732,7 @@ static void emit_inline_mvmva(int mx, int v, int cv, int sf, int lm)
             {
                 /* Standalone: C call to refresh cache + load into slot 1 */
                 uint32_t mx_cv = (uint32_t)(mx | (cv << 2));
+                vfpu_light_resident &= ~1;
                 EMIT_MOVE(REG_A0, REG_S0);
                 EMIT_ORI(REG_A1, REG_ZERO, mx_cv);
                 emit_call_c_lite((uint32_t)(uintptr_t)vu0_prepare_mvmva);
@@ -577,8 +786,8 @@ static void emit_inline_mvmva(int mx, int v, int cv, int sf, int lm)
             EMIT_MFV(REG_A0, VFPU_S302); /* MAC3 */
 
             /* Store MAC1-3 + IR saturation + FLAG=0 */
-            EMIT_SW(REG_V0, CPU_CP2_DATA(25), REG_S0);
-            EMIT_SW(REG_V1, CPU_CP2_DATA(26), REG_S0);
+            emit_gte_data_sw(REG_V0, 25);
+            emit_gte_data_sw(REG_V1, 26);
             EMIT_SW(REG_A0, CPU_CP2_DATA(27), REG_S0);
             emit_ir_sat_store(lm);
             return;
@@ -696,8 +905,8 @@ static void emit_inline_mvmva(int mx, int v, int cv, int sf, int lm)
     EMIT_MOVE(REG_A0, REG_A3);
 
     /* Store MAC1-3 */
-    EMIT_SW(REG_V0, CPU_CP2_DATA(25), REG_S0);
-    EMIT_SW(REG_V1, CPU_CP2_DATA(26), REG_S0);
+    emit_gte_data_sw(REG_V0, 25);
+    emit_gte_data_sw(REG_V1, 26);
     EMIT_SW(REG_A0, CPU_CP2_DATA(27), REG_S0);
 
     /* IR saturation + store IR1-3 */
@@ -830,7 +1039,7 @@ static void emit_ncds_post_lighting(int sf, int lm)
  *
  * Register plan (post-mvmva):
  *   T8/T9/AT = scratch, V0 = H, V1 = cond(h<sz3*2),
- *   A0 = n→div_result, A1 = z/scratch, A2 = u_val, A3 = table_base
+ *   A0 = n→div_result, A1 = z→d, A2 = table index→u→du
  *
  * MIPS encodings used (no EMIT_ macro):
  *   SLLV  rd,rt,rs: MK_R(0, rs, rt, rd, 0, 0x04)
@@ -843,6 +1052,67 @@ static void emit_ncds_post_lighting(int sf, int lm)
  */
 static void emit_rtps_project(int sf, int last);
 
+/* Emit the divide of gte_divide(): V0 = H, T8 = SZ3 → A0 = (n * du +
+ * 0x8000) >> 16 with n = H << z, d = SZ3 << z normalized.  du comes
+ * from gte_unr_recip[] when d has its low 4 bits clear (SZ3 < 0x1000,
+ * one load), otherwise from the two Newton steps on gte_unr_table[].
+ * Bit-exact before the 0x1FFFF clamp; SZ3 = 0 reads entry 0 and is
+ * discarded by the caller's h < sz3*2 check.
+ * Clobbers: T9, AT, A1, A2, HILO. */
+static void emit_unr_divide(void)
+{
+    EMIT_CLZ(REG_A1, REG_T8);
+    EMIT_ADDIU(REG_A1, REG_A1, EMIT_CLZ_BIAS - 16); /* A1 = z */
+    emit(MK_R(0, REG_A1, REG_V0, REG_A0, 0, 0x04)); /* SLLV A0, V0, A1: n */
+    emit(MK_R(0, REG_A1, REG_T8, REG_A1, 0, 0x04)); /* SLLV A1, T8, A1: d */
+    EMIT_ANDI(REG_AT, REG_A1, 0xF);
+    uint32_t *to_table = code_ptr;
+    EMIT_BEQ(REG_AT, REG_ZERO, 0);             /* low bits clear → table */
+    emit(MK_R(0, 0, REG_A1, REG_A2, 2, 0x02)); /* SRL A2, A1, 2 (delay) */
+
+    /* Newton: u = unr_table[(d - 0x7FC0) >> 7] + 0x101,
+     * du = (0x80 + u * ((0x2000080 - d * u) >> 8)) >> 8 */
+    EMIT_ADDIU(REG_A2, REG_A1, -0x7FC0);
+    emit(MK_R(0, 0, REG_A2, REG_A2, 7, 0x02)); /* SRL A2, A2, 7 */
+    emit_load_imm32(REG_AT, (uint32_t)(uintptr_t)gte_unr_table);
+    EMIT_ADDU(REG_A2, REG_A2, REG_AT);
+    EMIT_LBU(REG_A2, 0, REG_A2);
+    EMIT_ADDIU(REG_A2, REG_A2, 0x101); /* A2 = u */
+    EMIT_MULT(REG_A1, REG_A2);         /* d * u < 2^26 */
+    EMIT_MFLO(REG_T9);
+    emit_load_imm32(REG_AT, 0x2000080);
+    EMIT_SUBU(REG_T9, REG_AT, REG_T9);
+    emit(MK_R(0, 0, REG_T9, REG_T9, 8, 0x02)); /* SRL T9, T9, 8 */
+    EMIT_MULT(REG_T9, REG_A2);
+    EMIT_MFLO(REG_T9);
+    EMIT_ADDIU(REG_T9, REG_T9, 0x80);
+    uint32_t *to_done = code_ptr;
+    EMIT_BEQ(REG_ZERO, REG_ZERO, 0);
+    emit(MK_R(0, 0, REG_T9, REG_A2, 8, 0x02)); /* SRL A2, T9, 8 (delay): du */
+
+    /* Table: du = gte_unr_recip[(d >> 4) & 0x7FF], A2 = d >> 2 */
+    *to_table = (*to_table & 0xFFFF0000) |
+                ((uint32_t)(code_ptr - to_table - 1) & 0xFFFF);
+    EMIT_ANDI(REG_A2, REG_A2, (GTE_UNR_RECIP_SIZE - 1) << 2);
+    emit_load_imm32(REG_AT, (uint32_t)(uintptr_t)gte_unr_recip);
+    EMIT_ADDU(REG_A2, REG_A2, REG_AT);
+    EMIT_LW(REG_A2, 0, REG_A2);
+
+    /* n * du needs up to 34 bits: round across HI:LO */
+    *to_done = (*to_done & 0xFFFF0000) |
+               ((uint32_t)(code_ptr - to_done - 1) & 0xFFFF);
+    emit(MK_R(0, REG_A0, REG_A2, 0, 0, 0x19)); /* MULTU A0, A2 */
+    EMIT_MFLO(REG_T9);
+    EMIT_MFHI(REG_A1);
+    EMIT_ORI(REG_AT, REG_ZERO, 0x8000);
+    EMIT_ADDU(REG_T9, REG_T9, REG_AT);
+    emit(MK_R(0, REG_T9, REG_AT, REG_AT, 0, 0x2B)); /* SLTU AT, T9, AT: carry */
+    EMIT_ADDU(REG_A1, REG_A1, REG_AT);
+    emit(MK_R(0, 0, REG_T9, REG_T9, 16, 0x02)); /* SRL T9, T9, 16 */
+    EMIT_SLL(REG_A1, REG_A1, 16);
+    EMIT_OR(REG_A0, REG_T9, REG_A1); /* A0 = (n * du + 0x8000) >> 16 */
+}
+
 static void emit_rtps_core(int v, int sf, int lm, int last)
 {
     /* Step 1: RT × V + TR → MAC1-3, IR1-3 (inline matrix multiply) */
@@ -855,7 +1125,7 @@ static void emit_rtps_core(int v, int sf, int lm, int last)
 /* Emit RTPS Steps 2-6: SZ FIFO, perspective division, screen projection,
  * SXY FIFO push, depth cueing.  Assumes MAC1-3 and IR1-3 already stored
  * to cp2_data by the preceding matrix multiply.
- * Clobbers: T8, T9, AT, V0, V1, A0, FPU $f0-$f3, HILO. */
+ * Clobbers: T8, T9, AT, V0, V1, A0-A2, FPU $f0-$f2 (ultra), HILO. */
 static void emit_rtps_project(int sf, int last)
 {
     /* Step 2: Push SZ FIFO inline.
@@ -878,35 +1148,40 @@ static void emit_rtps_project(int sf, int last)
 
     /* Step 3: UNR perspective division — fully inline.
      * T8 = SZ3 (saturated).  Compute div_result → A0 */
+    int ultra = (gte_tier == GTE_TIER_ULTRA);
     EMIT_LH(REG_V0, CPU_CP2_CTRL(26), REG_S0); /* V0 = (int16)H */
     EMIT_ANDI(REG_V0, REG_V0, 0xFFFF);         /* V0 = (uint16)H */
 
-    /* Check h < sz3*2 */
-    EMIT_SLL(REG_T9, REG_T8, 1);                    /* T9 = sz3 * 2 */
-    emit(MK_R(0, REG_V0, REG_T9, REG_V1, 0, 0x2B)); /* SLTU V1, H, sz3*2 */
-
-    /* FPU DIV.S: compute (H * 65536.0f) / SZ3 → A0
-     * Uses COP1 single-precision float. Slight rounding difference vs
-     * PSX hardware UNR, but avoids complex CLZ+table path. */
-    EMIT_MTC1(REG_T8, 0);     /* $f0 = SZ3 (int bits) */
-    EMIT_CVT_S_W(0, 0);       /* $f0 = float(SZ3) */
-    EMIT_MTC1(REG_V0, 1);     /* $f1 = H (int bits) */
-    EMIT_CVT_S_W(1, 1);       /* $f1 = float(H) */
-    EMIT_LUI(REG_AT, 0x4780); /* AT = 0x47800000 = 65536.0f */
-    EMIT_MTC1(REG_AT, 2);     /* $f2 = 65536.0f */
-    EMIT_MUL_S(1, 1, 2);      /* $f1 = H * 65536.0 */
-    EMIT_DIV_S(1, 1, 0);      /* $f1 = (H*65536) / SZ3 */
-    EMIT_LUI(REG_AT, 0x3F00); /* AT = 0x3F000000 = 0.5f */
-    EMIT_MTC1(REG_AT, 3);     /* $f3 = 0.5f */
-    EMIT_ADD_S(1, 1, 3);      /* $f1 += 0.5 (round nearest) */
-    EMIT_CVT_W_S(1, 1);       /* $f1 = int(trunc toward 0) */
-    EMIT_MFC1(REG_A0, 1);     /* A0 = division result */
+    if (!ultra)
+    {
+        /* Check h < sz3*2, then the bit-exact table/Newton divide */
+        EMIT_SLL(REG_T9, REG_T8, 1);                    /* T9 = sz3 * 2 */
+        emit(MK_R(0, REG_V0, REG_T9, REG_V1, 0, 0x2B)); /* SLTU V1, H, sz3*2 */
+        emit_unr_divide();
+    }
+    else
+    {
+        /* Ultra tier: FPU DIV.S (H * 65536.0f) / SZ3 → A0, truncated.
+         * Off by one against the UNR result now and then, and no
+         * h >= sz3*2 check: only the 0x1FFFF clamp below. */
+        EMIT_MTC1(REG_T8, 0);     /* $f0 = SZ3 (int bits) */
+        EMIT_CVT_S_W(0, 0);       /* $f0 = float(SZ3) */
+        EMIT_MTC1(REG_V0, 1);     /* $f1 = H (int bits) */
+        EMIT_CVT_S_W(1, 1);       /* $f1 = float(H) */
+        EMIT_LUI(REG_AT, 0x4780); /* AT = 0x47800000 = 65536.0f */
+        EMIT_MTC1(REG_AT, 2);     /* $f2 = 65536.0f */
+        EMIT_MUL_S(1, 1, 2);      /* $f1 = H * 65536.0 */
+        EMIT_DIV_S(1, 1, 0);      /* $f1 = (H*65536) / SZ3 */
+        EMIT_CVT_W_S(1, 1);       /* $f1 = int(trunc toward 0) */
+        EMIT_MFC1(REG_A0, 1);     /* A0 = division result */
+    }
     /* Clamp to 0x1FFFF */
     emit_load_imm32(REG_T8, 0x1FFFF);               /* T8 = 0x1FFFF */
     emit(MK_R(0, REG_T8, REG_A0, REG_AT, 0, 0x2B)); /* SLTU AT, 0x1FFFF, A0 */
     EMIT_MOVN(REG_A0, REG_T8, REG_AT);              /* if exceeded: clamp */
     /* Handle h >= sz3*2: force 0x1FFFF (V1=0 means h>=sz3*2) */
-    EMIT_MOVZ(REG_A0, REG_T8, REG_V1); /* A0 = 0x1FFFF if !V1 */
+    if (!ultra)
+        EMIT_MOVZ(REG_A0, REG_T8, REG_V1); /* A0 = 0x1FFFF if !V1 */
 
     /* Step 4: Screen projection (32-bit).
      * SX = (div_result * IR1 + OFX) >> 16
@@ -943,8 +1218,8 @@ static void emit_rtps_project(int sf, int last)
     EMIT_OR(REG_V0, REG_V0, REG_V1);
     EMIT_SW(REG_V0, CPU_CP2_DATA(14), REG_S0); /* SXY2 */
 
-    /* Step 6: Depth cueing (last vertex only) */
-    if (last)
+    /* Step 6: Depth cueing (last vertex only, skipped when MAC0/IR0 are dead) */
+    if (last && (~gte_skip_stores & ((1u << 24) | (1u << 8))))
     {
         /* MAC0 = DQA * div_result + DQB */
         EMIT_LH(REG_T8, CPU_CP2_CTRL(27), REG_S0); /* T8 = DQA */
@@ -952,19 +1227,205 @@ static void emit_rtps_project(int sf, int last)
         EMIT_MFLO(REG_T8);
         EMIT_LW(REG_T9, CPU_CP2_CTRL(28), REG_S0); /* T9 = DQB */
         EMIT_ADDU(REG_T8, REG_T8, REG_T9);         /* T8 = MAC0 */
-        EMIT_SW(REG_T8, CPU_CP2_DATA(24), REG_S0); /* store MAC0 */
+        emit_gte_data_sw(REG_T8, 24); /* store MAC0 */
         /* IR0 = saturate(MAC0 >> 12, 0, 0x1000) — P19: PMAXW/PMINW */
         EMIT_SRA(REG_T9, REG_T8, 12);
         EMIT_PMAXW(REG_T9, REG_T9, REG_ZERO);
         EMIT_ORI(REG_T8, REG_ZERO, 0x1000);
         EMIT_PMINW(REG_T9, REG_T9, REG_T8);
-        EMIT_SW(REG_T9, CPU_CP2_DATA(8), REG_S0); /* store IR0 */
+        emit_gte_data_sw(REG_T9, 8); /* store IR0 */
     }
 
     /* FLAG=0 */
     EMIT_SW(REG_ZERO, CPU_CP2_CTRL(31), REG_S0);
 }
 
+#if defined(ENABLE_VU0_MICRO) || defined(PLATFORM_PS2) || defined(PLATFORM_PSP)
+/* Emit the NCLIP that follows an inline RTPT (gte_fuse_nclip), right
+ * after its last emit_rtps_project: SXY2 is still packed in V0, so only
+ * SXY0/SXY1 come back from cp2_data, and the RTPT's FLAG=0 stands.
+ * MAC0 = SX0*(SY1-SY2) + SX1*(SY2-SY0) + SX2*(SY0-SY1), as inline NCLIP.
+ * Clobbers: T8, T9, AT, V0, V1, A0-A2, HILO. */
+static void emit_rtpt_nclip(void)
+{
+    EMIT_LH(REG_T8, CPU_CP2_DATA(12) + 0, REG_S0); /* T8 = SX0 */
+    EMIT_LH(REG_A0, CPU_CP2_DATA(12) + 2, REG_S0); /* A0 = SY0 */
+    EMIT_LH(REG_T9, CPU_CP2_DATA(13) + 0, REG_S0); /* T9 = SX1 */
+    EMIT_LH(REG_A1, CPU_CP2_DATA(13) + 2, REG_S0); /* A1 = SY1 */
+    EMIT_SLL(REG_AT, REG_V0, 16);
+    EMIT_SRA(REG_AT, REG_AT, 16);                  /* AT = SX2 */
+    EMIT_SRA(REG_A2, REG_V0, 16);                  /* A2 = SY2 */
+
+    EMIT_SUBU(REG_V0, REG_A1, REG_A2); /* V0 = SY1-SY2 */
+    EMIT_SUBU(REG_V1, REG_A2, REG_A0); /* V1 = SY2-SY0 */
+    EMIT_SUBU(REG_A0, REG_A0, REG_A1); /* A0 = SY0-SY1 */
+    EMIT_MULT(REG_T8, REG_V0);
+    EMIT_MADD(REG_T9, REG_V1);
+    EMIT_MADD(REG_AT, REG_A0);
+    EMIT_MFLO(REG_V0);
+    EMIT_SW(REG_V0, CPU_CP2_DATA(24), REG_S0); /* MAC0 */
+    gte_nclip_fused = 1;
+#ifdef ENABLE_DYNAREC_STATS
+    stat_gte_fused++;
+#endif
+}
+#endif
+
+/* ================================================================
+ * Batched GTE runs (gte_vu1_batch)
+ * ================================================================
+ * RTPS/RTPT/NCDS/NCDT/NCCS/NCCT are queued into gte_batch[] with the
+ * V0-V2/RGBC inputs they read; GTE_BatchFlush replays the run (VU1 for
+ * the transforms) right before the first instruction that could see
+ * GTE state or leave the block.  Inside a run only ALU ops, MTC2/LWC2
+ * to V0-V2/RGBC and RAM word loads are allowed: none of them reads the
+ * GTE, and none has an abort path that would drop the queue.
+ */
+#define GTE_BATCH_LOOKAHEAD 32
+
+int gte_batch_queued = 0;
+static int gte_batch_open = 0; /* queue the COP2 command being emitted */
+
+static int gte_batch_cmd(uint32_t opcode)
+{
+    if (OP(opcode) != 0x12 || !(opcode & 0x02000000))
+        return 0;
+    switch (opcode & 0x3F)
+    {
+    case 0x01: /* RTPS */
+    case 0x30: /* RTPT */
+    case 0x13: /* NCDS */
+    case 0x16: /* NCDT */
+    case 0x1B: /* NCCS */
+    case 0x3F: /* NCCT */
+        return 1;
+    }
+    return 0;
+}
+
+/* Can opcode sit between two queued commands?  The lookahead has no
+ * SMRV state yet, so loads pass optimistically (the real check at
+ * emit time just ends the run early). */
+static int gte_batch_spans(uint32_t opcode, int lookahead)
+{
+    uint32_t op = OP(opcode);
+    switch (op)
+    {
+    case 0x00:
+    {
+        uint32_t f = opcode & 0x3F;
+        return f == 0x00 || f == 0x02 || f == 0x03 || f == 0x04 || f == 0x06 || f == 0x07 ||
+               (f >= 0x10 && f <= 0x13) || (f >= 0x18 && f <= 0x1B) || f == 0x21 || f == 0x23 ||
+               (f >= 0x24 && f <= 0x27) || f == 0x2A || f == 0x2B;
+    }
+    case 0x09: /* ADDIU..LUI (no ADDI: it can trap) */
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+    case 0x0D:
+    case 0x0E:
+    case 0x0F:
+        return 1;
+    case 0x12:
+        if (opcode & 0x02000000)
+            return gte_batch_cmd(opcode) && (lookahead || gte_batch_queued < GTE_BATCH_MAX);
+        return RS(opcode) == 0x04 && RD(opcode) <= 6; /* MTC2 to V0-V2/RGBC */
+    case 0x32: /* LWC2 */
+        if (RT(opcode) > 6)
+            return 0;
+        /* fall through */
+    case 0x23: /* LW */
+        return lookahead || (smrv_is_known_ram(RS(opcode)) && align_is_known(RS(opcode)) &&
+                             (SIMM16(opcode) & 3) == 0);
+    }
+    return 0;
+}
+
+void emit_gte_batch_flush(void)
+{
+    EMIT_MOVE(REG_A0, REG_S0);
+    emit_load_imm32(REG_A1, (uint32_t)gte_batch_queued);
+    emit_flush_partial_cycles();
+    emit_call_c_lite((uint32_t)GTE_BatchFlush);
+    gte_batch_queued = 0;
+}
+
+void emit_gte_batch_point(uint32_t opcode, const uint32_t *next, int in_delay_slot)
+{
+    if (gte_batch_queued && !gte_batch_spans(opcode, 0))
+        emit_gte_batch_flush();
+    gte_batch_open = 0;
+    if (!psx_config.gte_vu1_batch || gte_record_active || in_delay_slot || !gte_batch_cmd(opcode))
+        return;
+    if (gte_batch_queued)
+    {
+        gte_batch_open = 1;
+        return;
+    }
+    /* Only open a run when another command follows: a lone command is
+     * cheaper on its normal inline/C path */
+    for (int i = 0; i < GTE_BATCH_LOOKAHEAD; i++)
+    {
+        if (gte_batch_cmd(next[i]))
+        {
+            gte_batch_open = 1;
+            return;
+        }
+        if (!gte_batch_spans(next[i], 1))
+            return;
+    }
+}
+
+/* Emit: gte_batch[slot] = { opcode, the inputs this command reads }.
+ * Clobbers T8, T9. */
+static void emit_gte_batch_queue(uint32_t opcode)
+{
+    uint32_t func = opcode & 0x3F;
+    int triple = (func == 0x30 || func == 0x16 || func == 0x3F);
+    int rgbc = (func != 0x01 && func != 0x30);
+
+    emit_load_imm32(REG_T9, (uint32_t)(uintptr_t)&gte_batch[gte_batch_queued]);
+    emit_load_imm32(REG_T8, opcode);
+    EMIT_SW(REG_T8, offsetof(GTEBatchEntry, opcode), REG_T9);
+    for (int i = 0; i < (triple ? 6 : 2); i++)
+    {
+        EMIT_LW(REG_T8, CPU_CP2_DATA(i), REG_S0);
+        EMIT_SW(REG_T8, offsetof(GTEBatchEntry, in) + 4 * i, REG_T9);
+    }
+    if (rgbc)
+    {
+        EMIT_LW(REG_T8, CPU_CP2_DATA(6), REG_S0);
+        EMIT_SW(REG_T8, offsetof(GTEBatchEntry, in) + 4 * 6, REG_T9);
+    }
+    gte_batch_queued++;
+#ifdef ENABLE_DYNAREC_STATS
+    stat_gte_batched++;
+#endif
+}
+
+/* ================================================================
+ * Lazy GTE flags (gte_lazy_flags)
+ *
+ * The C-path wrappers compute the full FLAG register.  When block_scan
+ * proved the result dead (the next GTE command resets FLAG before any
+ * CFC2 $31), call GTE_Inline_NoFlag instead: A0 = cpu is already set
+ * up, A1 is reloaded with the raw opcode.
+ * ================================================================ */
+int gte_flag_dead = 0;
+
+static void emit_gte_cmd_call(uint32_t fn, uint32_t opcode)
+{
+    if (gte_flag_dead)
+    {
+        emit_load_imm32(REG_A1, opcode);
+        fn = (uint32_t)GTE_Inline_NoFlag;
+#ifdef ENABLE_DYNAREC_STATS
+        stat_gte_noflag++;
+#endif
+    }
+    emit_call_c_lite(fn);
+}
+
 /* ================================================================
  * emit_gte_instruction - COP2 (GTE) opcode dispatcher
  * ================================================================
@@ -1098,17 +1559,13 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit(MK_R(0, 0, REG_T8, REG_T8, 16, 0x00)); /* sll t8, 16 */
                 emit(MK_R(0, 0, REG_T8, REG_T8, 16, 0x03)); /* sra t8, 16 */
                 EMIT_SW(REG_T8, CPU_CP2_CTRL(rd5), REG_S0);
-#ifdef PLATFORM_PS2
-                emit_vu0_dirty_bit(rd5);
-#endif
+                emit_gte_matrix_dirty(rd5);
                 break;
             default:
                 /* Simple write: C(r) = val */
                 emit_load_psx_reg(REG_T8, rt);
                 EMIT_SW(REG_T8, CPU_CP2_CTRL(rd5), REG_S0);
-#ifdef PLATFORM_PS2
-                emit_vu0_dirty_bit(rd5);
-#endif
+                emit_gte_matrix_dirty(rd5);
                 break;
             }
         }
@@ -1123,12 +1580,29 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
         uint32_t gte_func = opcode & 0x3F;
         int gte_sf = (opcode >> 19) & 1;
         int gte_lm = (opcode >> 10) & 1;
+        int nclip_fused = gte_nclip_fused;
+        gte_nclip_fused = 0;
+        if (gte_batch_open)
+        {
+            gte_batch_open = 0;
+            emit_gte_batch_queue(opcode);
+            return;
+        }
+        if (gte_record_active)
+        {
+            /* gte_record: log opcode + input registers */
+            EMIT_MOVE(REG_A0, REG_S0);
+            emit_load_imm32(REG_A1, opcode);
+            emit_call_c_lite((uint32_t)GTE_Record);
+        }
         switch (gte_func)
         {
         case 0x01: /* RTPS */
             if (gte_use_vu0 && gte_sf)
             {
+                gte_skip_stores = gte_data_dead & GTE_RTP_SKIPPABLE;
                 emit_rtps_core(0, gte_sf, gte_lm, 1);
+                gte_skip_stores = 0;
             }
             else
             {
@@ -1136,10 +1610,12 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_RTPS);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_RTPS, opcode);
             }
             break;
         case 0x06: /* NCLIP */
+            if (nclip_fused)
+                break; /* computed by the RTPT before it (emit_rtpt_nclip) */
             if (gte_use_vu0)
             {
                 /* ---- Inline NCLIP (fast path) ----
@@ -1180,7 +1656,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 /* Exact C path — full 64-bit overflow detection */
                 EMIT_MOVE(REG_A0, REG_S0);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_NCLIP);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_NCLIP, opcode);
             }
             break;
         case 0x0C: /* OP */
@@ -1278,7 +1754,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_OP);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_OP, opcode);
             }
             break;
         case 0x10: /* DPCS */
@@ -1310,7 +1786,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_DPCS);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_DPCS, opcode);
             }
             break;
         case 0x11: /* INTPL */
@@ -1339,7 +1815,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_INTPL);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_INTPL, opcode);
             }
             break;
         case 0x12: /* MVMVA */
@@ -1350,6 +1826,13 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
             if (gte_use_vu0 && gte_sf && mx < 3 && cv != 2)
             {
                 /* Inline: mx=0(RT)/1(L)/2(LC), v=0-3, cv=0(TR)/1(BK)/3(none) */
+#ifdef ENABLE_VU0_MICRO
+                if (vu0_micro_lazy)
+                {
+                    emit_vu0_micro_mvmva_async(mx, v, cv, gte_lm);
+                    break;
+                }
+#endif
                 emit_inline_mvmva(mx, v, cv, gte_sf, gte_lm);
             }
             else
@@ -1359,14 +1842,16 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 EMIT_MOVE(REG_A0, REG_S0);
                 emit_load_imm32(REG_A1, packed);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_MVMVA);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_MVMVA, opcode);
             }
             break;
         }
         case 0x13: /* NCDS */
             if (gte_use_vu0 && gte_sf)
             {
+                emit_vfpu_light_begin(3);
                 emit_ncds_core(0, gte_sf, gte_lm);
+                emit_vfpu_light_end();
             }
             else
             {
@@ -1374,14 +1859,16 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_NCDS);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_NCDS, opcode);
             }
             break;
         case 0x14: /* CDP */
             if (gte_use_vu0 && gte_sf)
             {
                 /* BK + Color × IR → RGBC×IR<<4 → interpolate + push_color */
+                emit_vfpu_light_begin(2);
                 emit_inline_mvmva(2, 3, 1, gte_sf, gte_lm);
+                emit_vfpu_light_end();
                 emit_rgbc_times_ir_shl4();
                 emit_interpolate_color(gte_sf);
                 emit_push_color_inline();
@@ -1393,7 +1880,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_CDP);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_CDP, opcode);
             }
             break;
         case 0x16: /* NCDT */
@@ -1424,13 +1911,11 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_vu0_micro_multiply(3, gte_lm, 0);
                 emit_ncds_post_lighting(gte_sf, gte_lm);
 #elif defined(PLATFORM_PS2)
-                /* P18 macro: preload L(VF1-4) + LC(VF7-10) once. */
+                /* P18 macro: L + LC slots, loaded unless still resident. */
                 if (gte_sf)
                 {
-                    emit_vu0_load_matrix(1, 3, 1);
-                    emit_vu0_load_matrix(2, 1, 7);
-                    vu0_preloaded[1] = 1;
-                    vu0_preloaded[2] = 7;
+                    vu0_preloaded[1] = emit_vu0_resident_matrix(1, 3, NULL);
+                    vu0_preloaded[2] = emit_vu0_resident_matrix(2, 1, NULL);
                 }
                 emit_ncds_core(0, gte_sf, gte_lm);
                 emit_ncds_core(1, gte_sf, gte_lm);
@@ -1438,16 +1923,12 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 vu0_preloaded[1] = 0;
                 vu0_preloaded[2] = 0;
 #elif defined(PLATFORM_PSP)
-                /* P31: preload Light(slot1) + Color(slot2) once */
-                emit_vfpu_preload_matrix(1, 3, 1);
-                emit_vfpu_preload_matrix(2, 1, 2);
-                vfpu_preloaded[1] = 1;
-                vfpu_preloaded[2] = 2;
+                /* P31: Light(slot1) + Color(slot2), loaded once per run */
+                emit_vfpu_light_begin(3);
                 emit_ncds_core(0, gte_sf, gte_lm);
                 emit_ncds_core(1, gte_sf, gte_lm);
                 emit_ncds_core(2, gte_sf, gte_lm);
-                vfpu_preloaded[1] = 0;
-                vfpu_preloaded[2] = 0;
+                emit_vfpu_light_end();
 #endif
             }
             else
@@ -1456,13 +1937,15 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_NCDT);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_NCDT, opcode);
             }
             break;
         case 0x1B: /* NCCS */
             if (gte_use_vu0 && gte_sf)
             {
+                emit_vfpu_light_begin(3);
                 emit_nccs_core(0, gte_sf, gte_lm);
+                emit_vfpu_light_end();
             }
             else
             {
@@ -1470,14 +1953,16 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_NCCS);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_NCCS, opcode);
             }
             break;
         case 0x1C: /* CC */
             if (gte_use_vu0 && gte_sf)
             {
                 /* BK + Color × IR → RGBC×IR<<4 → store_mac_ir + push_color */
+                emit_vfpu_light_begin(2);
                 emit_inline_mvmva(2, 3, 1, gte_sf, gte_lm);
+                emit_vfpu_light_end();
                 emit_rgbc_times_ir_shl4();
                 emit_sf_mac_push_ir(gte_sf, gte_lm);
             }
@@ -1487,13 +1972,15 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_CC);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_CC, opcode);
             }
             break;
         case 0x1E: /* NCS */
             if (gte_use_vu0 && gte_sf)
             {
+                emit_vfpu_light_begin(3);
                 emit_ncs_core(0, gte_sf, gte_lm);
+                emit_vfpu_light_end();
             }
             else
             {
@@ -1501,7 +1988,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_NCS);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_NCS, opcode);
             }
             break;
         case 0x20: /* NCT */
@@ -1535,13 +2022,11 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_vu0_micro_multiply(3, gte_lm, 0);
                 emit_ncs_post_lighting();
 #elif defined(PLATFORM_PS2)
-                /* P18 macro: preload L(VF1-4) + LC(VF7-10) once. */
+                /* P18 macro: L + LC slots, loaded unless still resident. */
                 if (gte_sf)
                 {
-                    emit_vu0_load_matrix(1, 3, 1);
-                    emit_vu0_load_matrix(2, 1, 7);
-                    vu0_preloaded[1] = 1;
-                    vu0_preloaded[2] = 7;
+                    vu0_preloaded[1] = emit_vu0_resident_matrix(1, 3, NULL);
+                    vu0_preloaded[2] = emit_vu0_resident_matrix(2, 1, NULL);
                 }
                 emit_ncs_core(0, gte_sf, gte_lm);
                 emit_ncs_core(1, gte_sf, gte_lm);
@@ -1549,16 +2034,12 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 vu0_preloaded[1] = 0;
                 vu0_preloaded[2] = 0;
 #elif defined(PLATFORM_PSP)
-                /* P31: preload Light(slot1) + Color(slot2) once */
-                emit_vfpu_preload_matrix(1, 3, 1);
-                emit_vfpu_preload_matrix(2, 1, 2);
-                vfpu_preloaded[1] = 1;
-                vfpu_preloaded[2] = 2;
+                /* P31: Light(slot1) + Color(slot2), loaded once per run */
+                emit_vfpu_light_begin(3);
                 emit_ncs_core(0, gte_sf, gte_lm);
                 emit_ncs_core(1, gte_sf, gte_lm);
                 emit_ncs_core(2, gte_sf, gte_lm);
-                vfpu_preloaded[1] = 0;
-                vfpu_preloaded[2] = 0;
+                emit_vfpu_light_end();
 #endif
             }
             else
@@ -1567,7 +2048,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_NCT);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_NCT, opcode);
             }
             break;
         case 0x28: /* SQR */
@@ -1627,7 +2108,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_SQR);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_SQR, opcode);
             }
             break;
         case 0x29: /* DCPL */
@@ -1674,7 +2155,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_DCPL);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_DCPL, opcode);
             }
             break;
         case 0x2A: /* DPCT */
@@ -1712,7 +2193,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_DPCT);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_DPCT, opcode);
             }
             break;
         case 0x2D: /* AVSZ3 */
@@ -1756,7 +2237,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
             {
                 EMIT_MOVE(REG_A0, REG_S0);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_AVSZ3);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_AVSZ3, opcode);
             }
             break;
         case 0x2E: /* AVSZ4 */
@@ -1802,7 +2283,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
             {
                 EMIT_MOVE(REG_A0, REG_S0);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_AVSZ4);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_AVSZ4, opcode);
             }
             break;
         case 0x30: /* RTPT */
@@ -1811,6 +2292,8 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
 #ifdef ENABLE_VU0_MICRO
                 /* Overlapped VU0 micro: matrix once, overlap multiplies with projections */
                 emit_vu0_micro_prepare(0, 0);
+                /* V0/V1 MAC1-2 and IR3 are overwritten by V2 */
+                gte_skip_stores = GTE_RTP_VERTEX_TEMP;
                 /* V0: sync multiply (FULL — loads matrix into VF regs) */
                 emit_vu0_micro_multiply(0, gte_lm, 0);
                 /* Overlap: launch V1 on VU0 while EE projects V0 */
@@ -1822,23 +2305,36 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_vu0_micro_launch(2, 1);
                 emit_rtps_project(gte_sf, 0);
                 /* Poll V2 completion, store results */
+                gte_skip_stores = gte_data_dead & GTE_RTP_SKIPPABLE;
                 emit_vu0_micro_poll_complete(gte_lm);
                 emit_rtps_project(gte_sf, 1);
+                gte_skip_stores = 0;
+                if (gte_fuse_nclip && !gte_record_active)
+                    emit_rtpt_nclip();
 #elif defined(PLATFORM_PS2)
                 /* Macro mode: preload matrix once, reuse for all 3 */
-                emit_vu0_load_matrix(0, 0, 1);
-                vu0_preloaded[0] = 1;
+                vu0_preloaded[0] = emit_vu0_resident_matrix(0, 0, NULL);
+                gte_skip_stores = GTE_RTP_VERTEX_TEMP;
                 emit_rtps_core(0, gte_sf, gte_lm, 0);
                 emit_rtps_core(1, gte_sf, gte_lm, 0);
+                gte_skip_stores = gte_data_dead & GTE_RTP_SKIPPABLE;
                 emit_rtps_core(2, gte_sf, gte_lm, 1);
+                gte_skip_stores = 0;
+                if (gte_fuse_nclip && !gte_record_active)
+                    emit_rtpt_nclip();
                 vu0_preloaded[0] = 0;
 #elif defined(PLATFORM_PSP)
                 /* P31: preload RT matrix once */
                 emit_vfpu_preload_matrix(0, 0, 1);
                 vfpu_preloaded[0] = 1;
+                gte_skip_stores = GTE_RTP_VERTEX_TEMP;
                 emit_rtps_core(0, gte_sf, gte_lm, 0);
                 emit_rtps_core(1, gte_sf, gte_lm, 0);
+                gte_skip_stores = gte_data_dead & GTE_RTP_SKIPPABLE;
                 emit_rtps_core(2, gte_sf, gte_lm, 1);
+                gte_skip_stores = 0;
+                if (gte_fuse_nclip && !gte_record_active)
+                    emit_rtpt_nclip();
                 vfpu_preloaded[0] = 0;
 #endif
             }
@@ -1848,7 +2344,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_RTPT);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_RTPT, opcode);
             }
             break;
         case 0x3D: /* GPF */
@@ -1958,7 +2454,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_GPF);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_GPF, opcode);
             }
             break;
         case 0x3E: /* GPL */
@@ -2097,7 +2593,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_GPL);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_GPL, opcode);
             }
             break;
         case 0x3F: /* NCCT */
@@ -2128,13 +2624,11 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_vu0_micro_multiply(3, gte_lm, 0);
                 emit_nccs_post_lighting(gte_sf, gte_lm);
 #elif defined(PLATFORM_PS2)
-                /* P18 macro: preload L(VF1-4) + LC(VF7-10) once. */
+                /* P18 macro: L + LC slots, loaded unless still resident. */
                 if (gte_sf)
                 {
-                    emit_vu0_load_matrix(1, 3, 1);
-                    emit_vu0_load_matrix(2, 1, 7);
-                    vu0_preloaded[1] = 1;
-                    vu0_preloaded[2] = 7;
+                    vu0_preloaded[1] = emit_vu0_resident_matrix(1, 3, NULL);
+                    vu0_preloaded[2] = emit_vu0_resident_matrix(2, 1, NULL);
                 }
                 emit_nccs_core(0, gte_sf, gte_lm);
                 emit_nccs_core(1, gte_sf, gte_lm);
@@ -2142,16 +2636,12 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 vu0_preloaded[1] = 0;
                 vu0_preloaded[2] = 0;
 #elif defined(PLATFORM_PSP)
-                /* P31: preload Light(slot1) + Color(slot2) once */
-                emit_vfpu_preload_matrix(1, 3, 1);
-                emit_vfpu_preload_matrix(2, 1, 2);
-                vfpu_preloaded[1] = 1;
-                vfpu_preloaded[2] = 2;
+                /* P31: Light(slot1) + Color(slot2), loaded once per run */
+                emit_vfpu_light_begin(3);
                 emit_nccs_core(0, gte_sf, gte_lm);
                 emit_nccs_core(1, gte_sf, gte_lm);
                 emit_nccs_core(2, gte_sf, gte_lm);
-                vfpu_preloaded[1] = 0;
-                vfpu_preloaded[2] = 0;
+                emit_vfpu_light_end();
 #endif
             }
             else
@@ -2160,7 +2650,7 @@ void emit_gte_instruction(uint32_t opcode, uint32_t psx_pc)
                 emit_load_imm32(REG_A1, gte_sf);
                 emit_load_imm32(REG_A2, gte_lm);
                 emit_flush_partial_cycles();
-                emit_call_c_lite((uint32_t)GTE_Inline_NCCT);
+                emit_gte_cmd_call((uint32_t)GTE_Inline_NCCT, opcode);
             }
             break;
         default:
@@ -0,0 +1,482 @@
+/*
+ * dynarec_idiom.c - Loop idiom library (P-FILL, P-COPY, P-SUM, P-SCAN)
+ *
+ * Recognises single-block self-loops that walk memory with a pointer
+ * bump and completes them in C once the chain has self-looped into the
+ * dispatcher (see run_jit_chain).  compile_block() tags the block with
+ * the idiom kind in BlockEntry::block_pattern; the runtime re-decodes
+ * the loop from the PSX opcodes (guarded by code_hash), so no per-idiom
+ * operands have to live in the BlockEntry.
+ *
+ * Each idiom is one entry in idiom_table: a classifier over the decoded
+ * loop shape and a runner that performs the remaining iterations.
+ * Time is charged as iterations * be->cycle_count, exactly what the
+ * native loop would have cost.
+ */
+#include "dynarec.h"
+#include "fast_copy.h"
+#undef LOG_TAG
+#define LOG_TAG "DYNAREC"
+
+#define IDIOM_MIN_INSNS 4 /* load/store + bump + branch + delay slot */
+#define IDIOM_MAX_INSNS 8
+
+/* Decoded loop body.  Offsets are relative to the pointer value at the
+ * start of an iteration (a bump scheduled earlier is folded in). */
+typedef struct
+{
+    int has_load, has_store, has_acc;
+    uint8_t ld_base, ld_size, ld_signed, ld_rt;
+    uint8_t st_base, st_size, st_rt;
+    int32_t ld_off, st_off;
+    int ld_pos, st_pos;
+    uint8_t acc_rd, acc_src, acc_func; /* ADDU (0x21) / XOR (0x26) */
+    int acc_pos;
+    uint8_t bump_reg[2];
+    int32_t bump_imm[2];
+    int bump_pos[2];
+    int bumps;
+    uint32_t written; /* GPRs written by the body */
+    int br_op;        /* 0x04 BEQ / 0x05 BNE */
+    uint8_t br_rs, br_rt;
+    int br_pos;
+    /* Filled by the classifier */
+    uint8_t cmp_reg;   /* register tested by the branch */
+    uint8_t cmp_other; /* loop-invariant operand (limit / terminator) */
+} IdiomLoop;
+
+typedef struct
+{
+    const char *name;
+    int (*match)(IdiomLoop *lp);
+    int (*run)(const IdiomLoop *lp, uint32_t *iters, uint32_t *bytes);
+} IdiomDesc;
+
+static int idiom_load_size(int op)
+{
+    switch (op)
+    {
+    case 0x20: /* LB  */
+    case 0x24: /* LBU */
+        return 1;
+    case 0x21: /* LH  */
+    case 0x25: /* LHU */
+        return 2;
+    case 0x23: /* LW  */
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+static int idiom_store_size(int op)
+{
+    return op == 0x28 ? 1 : op == 0x29 ? 2 : op == 0x2B ? 4 : 0;
+}
+
+/* Bump of reg r already applied at body position pos */
+static int32_t idiom_bias(const IdiomLoop *lp, int r, int pos)
+{
+    for (int i = 0; i < lp->bumps; i++)
+        if (lp->bump_reg[i] == r && lp->bump_pos[i] < pos)
+            return lp->bump_imm[i];
+    return 0;
+}
+
+static int idiom_step(const IdiomLoop *lp, int r)
+{
+    for (int i = 0; i < lp->bumps; i++)
+        if (lp->bump_reg[i] == r)
+            return lp->bump_imm[i];
+    return 0;
+}
+
+static int idiom_decode(const uint32_t *code, uint32_t count, IdiomLoop *lp)
+{
+    if (count < IDIOM_MIN_INSNS || count > IDIOM_MAX_INSNS)
+        return 0;
+    memset(lp, 0, sizeof(*lp));
+    lp->br_pos = (int)count - 2;
+    uint32_t br = code[lp->br_pos];
+    lp->br_op = OP(br);
+    if (lp->br_op != 0x04 && lp->br_op != 0x05)
+        return 0;
+    lp->br_rs = RS(br);
+    lp->br_rt = RT(br);
+
+    for (int j = 0; j < (int)count; j++)
+    {
+        uint32_t insn = code[j];
+        int op = OP(insn);
+        if (j == lp->br_pos || insn == 0)
+            continue;
+        if (op == 0x09 && RS(insn) == RT(insn) && RT(insn) != 0)
+        {
+            if (lp->bumps == 2 || idiom_step(lp, RT(insn)))
+                return 0;
+            lp->bump_reg[lp->bumps] = RT(insn);
+            lp->bump_imm[lp->bumps] = SIMM16(insn);
+            lp->bump_pos[lp->bumps] = j;
+            lp->bumps++;
+            lp->written |= 1u << RT(insn);
+        }
+        else if (idiom_load_size(op) && RT(insn) != 0 && !lp->has_load)
+        {
+            /* The value is not visible to the next instruction (load
+             * delay), and must not leak into the next iteration's head */
+            uint32_t next = (j + 1 < (int)count) ? code[j + 1] : code[0];
+            if (instruction_reads_gpr(next, RT(insn)))
+                return 0;
+            lp->has_load = 1;
+            lp->ld_base = RS(insn);
+            lp->ld_size = (uint8_t)idiom_load_size(op);
+            lp->ld_signed = (op == 0x20 || op == 0x21);
+            lp->ld_rt = RT(insn);
+            lp->ld_off = SIMM16(insn);
+            lp->ld_pos = j;
+            lp->written |= 1u << RT(insn);
+        }
+        else if (idiom_store_size(op) && !lp->has_store)
+        {
+            lp->has_store = 1;
+            lp->st_base = RS(insn);
+            lp->st_size = (uint8_t)idiom_store_size(op);
+            lp->st_rt = RT(insn);
+            lp->st_off = SIMM16(insn);
+            lp->st_pos = j;
+        }
+        else if (op == 0x00 && (FUNC(insn) == 0x21 || FUNC(insn) == 0x26) &&
+                 RD(insn) != 0 && !lp->has_acc &&
+                 (RS(insn) == RD(insn) || RT(insn) == RD(insn)))
+        {
+            lp->has_acc = 1;
+            lp->acc_rd = RD(insn);
+            lp->acc_src = RS(insn) == RD(insn) ? RT(insn) : RS(insn);
+            lp->acc_func = FUNC(insn);
+            lp->acc_pos = j;
+            lp->written |= 1u << RD(insn);
+        }
+        else
+            return 0;
+    }
+
+    /* Every written register has exactly one role */
+    for (int i = 0; i < lp->bumps; i++)
+        if ((lp->has_load && lp->ld_rt == lp->bump_reg[i]) ||
+            (lp->has_acc && lp->acc_rd == lp->bump_reg[i]))
+            return 0;
+    if (lp->has_load && lp->has_acc && lp->acc_rd == lp->ld_rt)
+        return 0;
+
+    /* Pointer bumps must see the pre-bump value everywhere else */
+    if (lp->has_load)
+        lp->ld_off += idiom_bias(lp, lp->ld_base, lp->ld_pos);
+    if (lp->has_store)
+        lp->st_off += idiom_bias(lp, lp->st_base, lp->st_pos);
+    return 1;
+}
+
+/* Branch is BNE ptr,limit with a loop-invariant limit */
+static int idiom_match_limit(IdiomLoop *lp, int ptr_a, int ptr_b)
+{
+    if (lp->br_op != 0x05)
+        return 0;
+    int r = lp->br_rs, o = lp->br_rt;
+    if (r != ptr_a && r != ptr_b)
+    {
+        r = lp->br_rt;
+        o = lp->br_rs;
+    }
+    if ((r != ptr_a && r != ptr_b) || ((lp->written >> o) & 1))
+        return 0;
+    lp->cmp_reg = (uint8_t)r;
+    lp->cmp_other = (uint8_t)o;
+    return 1;
+}
+
+static int idiom_match_fill(IdiomLoop *lp)
+{
+    if (!lp->has_store || lp->has_load || lp->has_acc || lp->bumps != 1)
+        return 0;
+    if (idiom_step(lp, lp->st_base) != lp->st_size && idiom_step(lp, lp->st_base) != -lp->st_size)
+        return 0;
+    if ((lp->written >> lp->st_rt) & 1)
+        return 0;
+    return idiom_match_limit(lp, lp->st_base, lp->st_base);
+}
+
+static int idiom_match_copy(IdiomLoop *lp)
+{
+    if (!lp->has_load || !lp->has_store || lp->has_acc || lp->bumps != 2)
+        return 0;
+    int step = idiom_step(lp, lp->ld_base);
+    if (lp->ld_base == lp->st_base || lp->st_rt != lp->ld_rt || lp->st_size != lp->ld_size ||
+        lp->st_pos < lp->ld_pos || idiom_step(lp, lp->st_base) != step ||
+        (step != lp->ld_size && step != -lp->ld_size))
+        return 0;
+    return idiom_match_limit(lp, lp->ld_base, lp->st_base);
+}
+
+static int idiom_match_sum(IdiomLoop *lp)
+{
+    if (!lp->has_load || lp->has_store || !lp->has_acc || lp->bumps != 1)
+        return 0;
+    int step = idiom_step(lp, lp->ld_base);
+    if (lp->acc_src != lp->ld_rt || lp->acc_pos < lp->ld_pos || lp->acc_rd == lp->ld_base ||
+        (step != lp->ld_size && step != -lp->ld_size))
+        return 0;
+    return idiom_match_limit(lp, lp->ld_base, lp->ld_base);
+}
+
+static int idiom_match_scan(IdiomLoop *lp)
+{
+    if (!lp->has_load || lp->has_store || lp->has_acc || lp->bumps != 1)
+        return 0;
+    int step = idiom_step(lp, lp->ld_base);
+    if (step != lp->ld_size && step != -lp->ld_size)
+        return 0;
+    int o = lp->br_rs == lp->ld_rt ? lp->br_rt : lp->br_rs;
+    if ((lp->br_rs != lp->ld_rt && lp->br_rt != lp->ld_rt) || lp->ld_pos > lp->br_pos ||
+        o == lp->ld_rt || ((lp->written >> o) & 1))
+        return 0;
+    lp->cmp_reg = lp->ld_rt;
+    lp->cmp_other = (uint8_t)o;
+    return 1;
+}
+
+/* ---- Runtime helpers ---- */
+
+/* Remaining iterations of a BNE ptr,limit loop, 0 if it does not
+ * terminate within RAM */
+static uint32_t idiom_trip_count(const IdiomLoop *lp, int size)
+{
+    int32_t step = idiom_step(lp, lp->cmp_reg);
+    uint32_t at_branch = cpu.regs[lp->cmp_reg] + (uint32_t)idiom_bias(lp, lp->cmp_reg, lp->br_pos);
+    int32_t dist = (int32_t)(cpu.regs[lp->cmp_other] - at_branch);
+    if ((step > 0 && dist < 0) || (step < 0 && dist > 0) || dist % step != 0)
+        return 0;
+    uint32_t n = (uint32_t)(dist / step) + 1;
+    if ((uint64_t)n * size > PSX_RAM_SIZE)
+        return 0;
+    return n;
+}
+
+/* Host pointer to the lowest byte of n elements walked from base+off;
+ * NULL unless the whole span is aligned RAM */
+static uint8_t *idiom_span(uint32_t base, int32_t off, int32_t step, int size, uint32_t n)
+{
+    uint32_t first = base + (uint32_t)off;
+    uint32_t lo = step > 0 ? first : first - (n - 1) * (uint32_t)size;
+    uint32_t phys = lo & 0x1FFFFFFF;
+    if ((first & (size - 1)) || lo > first || (lo & 0xE0000000) != (first & 0xE0000000))
+        return NULL;
+    if (phys >= PSX_RAM_SIZE || (uint64_t)phys + (uint64_t)n * size > PSX_RAM_SIZE)
+        return NULL;
+    return psx_ram + phys;
+}
+
+static uint32_t idiom_load_elem(const uint8_t *p, int size, int is_signed)
+{
+    if (size == 4)
+        return *(const uint32_t *)p;
+    if (size == 2)
+        return is_signed ? (uint32_t)(int32_t) * (const int16_t *)p : *(const uint16_t *)p;
+    return is_signed ? (uint32_t)(int32_t) * (const int8_t *)p : *p;
+}
+
+static void idiom_bump_all(const IdiomLoop *lp, uint32_t n)
+{
+    for (int i = 0; i < lp->bumps; i++)
+        cpu.regs[lp->bump_reg[i]] += (uint32_t)lp->bump_imm[i] * n;
+}
+
+/* ---- Runners ---- */
+
+static int idiom_run_fill(const IdiomLoop *lp, uint32_t *iters, uint32_t *bytes)
+{
+    int size = lp->st_size;
+    uint32_t n = idiom_trip_count(lp, size);
+    uint8_t *dst = n ? idiom_span(cpu.regs[lp->st_base], lp->st_off,
+                                  idiom_step(lp, lp->st_base), size, n)
+                     : NULL;
+    if (!dst)
+        return 0;
+    uint32_t val = cpu.regs[lp->st_rt];
+    uint32_t len = n * size;
+    if (size == 1 || (size == 2 && (val & 0xFF) == ((val >> 8) & 0xFF)) ||
+        (size == 4 && val == (val & 0xFF) * 0x01010101u))
+        memset(dst, (int)(val & 0xFF), len);
+    else if (size == 2)
+        for (uint32_t i = 0; i < n; i++)
+            ((uint16_t *)dst)[i] = (uint16_t)val;
+    else
+        for (uint32_t i = 0; i < n; i++)
+            ((uint32_t *)dst)[i] = val;
+
+    uint32_t phys = (uint32_t)(dst - psx_ram);
+    jit_smc_invalidate_range(phys, phys + len);
+    idiom_bump_all(lp, n);
+    *iters = n;
+    *bytes = len;
+    return 1;
+}
+
+static int idiom_run_copy(const IdiomLoop *lp, uint32_t *iters, uint32_t *bytes)
+{
+    int size = lp->ld_size;
+    int32_t step = idiom_step(lp, lp->ld_base);
+    uint32_t n = idiom_trip_count(lp, size);
+    if (!n)
+        return 0;
+    uint8_t *src = idiom_span(cpu.regs[lp->ld_base], lp->ld_off, step, size, n);
+    uint8_t *dst = idiom_span(cpu.regs[lp->st_base], lp->st_off, step, size, n);
+    uint32_t len = n * size;
+    if (!src || !dst)
+        return 0;
+    /* Element order only matches memmove when the destination trails
+     * the source in the walk direction (or the spans are disjoint) */
+    if (step > 0 ? (dst > src && dst < src + len) : (dst < src && dst + len > src))
+        return 0;
+
+    /* Last element loaded, before the copy can touch it */
+    const uint8_t *last = step > 0 ? src + len - size : src;
+    uint32_t tmp = idiom_load_elem(last, size, lp->ld_signed);
+
+    uint32_t done = 0;
+    if ((((uintptr_t)src | (uintptr_t)dst) & 15) == 0 &&
+        (dst + len <= src || src + len <= dst))
+    {
+        for (; done + 128 <= len; done += 128)
+            fast_copy_128(dst + done, src + done,
+                          done + 256 <= len ? src + done + 128 : src + done);
+    }
+    memmove(dst + done, src + done, len - done);
+
+    uint32_t phys = (uint32_t)(dst - psx_ram);
+    jit_smc_invalidate_range(phys, phys + len);
+    cpu.regs[lp->ld_rt] = tmp;
+    idiom_bump_all(lp, n);
+    *iters = n;
+    *bytes = len;
+    return 1;
+}
+
+static int idiom_run_sum(const IdiomLoop *lp, uint32_t *iters, uint32_t *bytes)
+{
+    int size = lp->ld_size;
+    int32_t step = idiom_step(lp, lp->ld_base);
+    uint32_t n = idiom_trip_count(lp, size);
+    const uint8_t *src = n ? idiom_span(cpu.regs[lp->ld_base], lp->ld_off, step, size, n) : NULL;
+    if (!src)
+        return 0;
+    uint32_t acc = cpu.regs[lp->acc_rd], elem = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        elem = idiom_load_elem(src + i * size, size, lp->ld_signed);
+        acc = lp->acc_func == 0x21 ? acc + elem : acc ^ elem;
+    }
+    /* ADDU and XOR commute, so walking the span upwards is exact */
+    if (step < 0)
+        elem = idiom_load_elem(src, size, lp->ld_signed);
+    cpu.regs[lp->acc_rd] = acc;
+    cpu.regs[lp->ld_rt] = elem;
+    idiom_bump_all(lp, n);
+    *iters = n;
+    *bytes = n * size;
+    return 1;
+}
+
+static int idiom_run_scan(const IdiomLoop *lp, uint32_t *iters, uint32_t *bytes)
+{
+    int size = lp->ld_size;
+    int32_t step = idiom_step(lp, lp->ld_base);
+    uint32_t first = cpu.regs[lp->ld_base] + (uint32_t)lp->ld_off;
+    uint32_t phys = first & 0x1FFFFFFF;
+    uint32_t want = cpu.regs[lp->cmp_other];
+    int stop_on_equal = (lp->br_op == 0x05); /* BNE loops until equal */
+    uint32_t n = 0, elem = 0;
+
+    if ((first & (size - 1)) || phys >= PSX_RAM_SIZE)
+        return 0;
+    uint32_t avail = step > 0 ? (PSX_RAM_SIZE - phys) / size : phys / size + 1;
+
+    if (size == 1 && step > 0 && stop_on_equal && !lp->ld_signed)
+    {
+        /* strlen / memchr */
+        const uint8_t *hit = want <= 0xFF ? memchr(psx_ram + phys, (int)want, avail) : NULL;
+        if (!hit)
+            return 0;
+        n = (uint32_t)(hit - (psx_ram + phys)) + 1;
+        elem = want;
+    }
+    else
+    {
+        for (; n < avail; n++)
+        {
+            elem = idiom_load_elem(psx_ram + phys + (int32_t)n * step, size, lp->ld_signed);
+            if ((elem == want) == stop_on_equal)
+                break;
+        }
+        if (n == avail)
+            return 0;
+        n++;
+    }
+    cpu.regs[lp->ld_rt] = elem;
+    idiom_bump_all(lp, n);
+    *iters = n;
+    *bytes = n * size;
+    return 1;
+}
+
+static const IdiomDesc idiom_table[JIT_IDIOM_COUNT] = {
+    [JIT_IDIOM_FILL] = {"fill", idiom_match_fill, idiom_run_fill},
+    [JIT_IDIOM_COPY] = {"copy", idiom_match_copy, idiom_run_copy},
+    [JIT_IDIOM_SUM] = {"sum", idiom_match_sum, idiom_run_sum},
+    [JIT_IDIOM_SCAN] = {"scan", idiom_match_scan, idiom_run_scan},
+};
+
+/*
+ * jit_idiom_detect: classify the self-looping block body code[0..count)
+ * (ending in its backward branch + delay slot).  Returns JIT_IDIOM_*.
+ */
+int jit_idiom_detect(const uint32_t *code, uint32_t count)
+{
+    IdiomLoop lp;
+    if (!idiom_decode(code, count, &lp))
+        return JIT_IDIOM_NONE;
+    for (int k = JIT_IDIOM_NONE + 1; k < JIT_IDIOM_COUNT; k++)
+        if (idiom_table[k].match(&lp))
+            return k;
+    return JIT_IDIOM_NONE;
+}
+
+/*
+ * jit_idiom_run: finish the idiom loop of be from the current register
+ * state (cpu.pc at the loop head).  On success the GPRs hold their
+ * exit values, cpu.pc is the fall-through PC, global_cycles is charged
+ * for the skipped iterations, and *bytes is the memory span walked.
+ * Returns 0 (state untouched) when the loop must keep running natively.
+ */
+int jit_idiom_run(BlockEntry *be, uint32_t *bytes)
+{
+    IdiomLoop lp;
+    uint32_t iters = 0;
+    int kind = be->block_pattern;
+    const uint32_t *code = get_psx_code_ptr(be->psx_pc);
+
+    if (kind <= JIT_IDIOM_NONE || kind >= JIT_IDIOM_COUNT || !code ||
+        jit_block_hash(be, code) != be->code_hash ||
+        !idiom_decode(code, be->instr_count, &lp) || !idiom_table[kind].match(&lp))
+        return 0;
+    if (!idiom_table[kind].run(&lp, &iters, bytes))
+        return 0;
+
+    cpu.pc = be->psx_pc + be->instr_count * 4;
+    global_cycles += (uint64_t)iters * be->cycle_count;
+    return 1;
+}
+
+const char *jit_idiom_name(int kind)
+{
+    return (kind > JIT_IDIOM_NONE && kind < JIT_IDIOM_COUNT) ? idiom_table[kind].name : "none";
+}
@@ -10,6 +10,7 @@
 #undef LOG_TAG
 #define LOG_TAG "DYNAREC"
 #include "loader.h"
+#include "config.h"
 
 extern void emit_flush_partial_cycles(void);
 /* ---- Debug helpers ---- */
@@ -36,6 +37,8 @@ void debug_mtc0_sr(uint32_t val)
 }
 
 /*=== BIOS HLE (High Level Emulation) ===*/
+/* Each returns the cycles to charge for a handled call (cpu.pc = $ra),
+ * or 0 to run the ROM routine. */
 int BIOS_HLE_A(void)
 {
     uint32_t func = cpu.regs[9];
@@ -58,8 +61,10 @@ int BIOS_HLE_A(void)
 #endif
         cpu.regs[2] = cpu.regs[4];
         cpu.pc = cpu.regs[31];
-        return 1;
+        return 10;
     }
+    if (psx_config.bios_hle)
+        return (int)BIOS_HLE_Library(0xA0, func);
     return 0;
 }
 
@@ -85,7 +90,7 @@ int BIOS_HLE_B(void)
 #endif
         cpu.regs[2] = cpu.regs[4];
         cpu.pc = cpu.regs[31];
-        return 1;
+        return 10;
     }
     if (func == 0x3D)
     {
@@ -100,8 +105,10 @@ int BIOS_HLE_B(void)
 #endif
         cpu.regs[2] = 1;
         cpu.pc = cpu.regs[31];
-        return 1;
+        return 10;
     }
+    if (psx_config.bios_hle)
+        return (int)BIOS_HLE_Library(0xB0, func);
     return 0;
 }
 
@@ -117,6 +124,17 @@ int BIOS_HLE_C(void)
     return 0;
 }
 
+/* SYSCALL under bios_hle: critical sections run natively on the stock
+ * kernel, anything else raises the exception.  Returns the cycles to
+ * charge (0 when the exception was taken). */
+int Helper_Syscall_HLE(uint32_t pc)
+{
+    uint32_t cycles = BIOS_HLE_Syscall(pc);
+    if (!cycles)
+        Helper_Syscall_Exception(pc);
+    return (int)cycles;
+}
+
 /* ================================================================
  * P23: Overflow exception cold queue
  * ================================================================
@@ -139,6 +157,7 @@ static OverflowColdEntry overflow_cold[MAX_OVERFLOW_COLD];
 static int overflow_cold_count;
 
 void overflow_cold_reset(void) { overflow_cold_count = 0; }
+int overflow_cold_pending(void) { return overflow_cold_count; }
 
 void overflow_cold_emit_all(void)
 {
@@ -254,6 +273,99 @@ static void emit_cu_check(int cop_num, uint32_t psx_pc)
     *skip = (*skip & 0xFFFF0000) | ((uint32_t)(code_ptr - skip - 1) & 0xFFFF);
 }
 
+/* ---- Deferred HI/LO for DIV/DIVU ----
+ * A divide followed by at least HILO_MIN_RUN plain ALU ops issues on
+ * pipe 1 (DIV1/DIVU1 on the EE) and stashes rs/rt in the block frame;
+ * the result stays in HI1/LO1 while the ALU run overlaps the divider.
+ * emit_hilo_flush writes cpu.lo/cpu.hi, with the R3000A divide-by-zero
+ * results, right before the first instruction of any other kind: an
+ * HI/LO access, memory op, branch, C call or the block end.  The ALU
+ * ops allowed in the run have no abort path, so nothing can leave the
+ * block in between with stale fields. */
+#define HILO_MIN_RUN 2
+#define HILO_LOOKAHEAD 8
+#define HILO_STASH_RS 84 /* Free block frame words */
+#define HILO_STASH_RT 88
+
+int hilo_pending = 0;     /* 0 = none, else the divide's funct (0x1A/0x1B) */
+static int hilo_lazy = 0; /* the DIV/DIVU being emitted may defer */
+
+static int hilo_spans(uint32_t opcode)
+{
+    switch (OP(opcode))
+    {
+    case 0x00:
+    {
+        uint32_t f = opcode & 0x3F;
+        return f == 0x00 || f == 0x02 || f == 0x03 || f == 0x04 || f == 0x06 || f == 0x07 ||
+               f == 0x21 || f == 0x23 || (f >= 0x24 && f <= 0x27) || f == 0x2A || f == 0x2B;
+    }
+    case 0x09: /* ADDIU..LUI (no ADDI: it can trap) */
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+    case 0x0D:
+    case 0x0E:
+    case 0x0F:
+        return 1;
+    }
+    return 0;
+}
+
+void emit_hilo_flush(void)
+{
+    EMIT_MFLO1(REG_T8);                       /* T8 = quotient */
+    EMIT_LW(REG_T9, HILO_STASH_RT, REG_SP);   /* T9 = rt */
+    if (hilo_pending == 0x1A)
+    {
+        /* divz lo = (rs>=0)?-1:1 */
+        EMIT_LW(REG_AT, HILO_STASH_RS, REG_SP);
+        emit(MK_R(0, 0, REG_AT, REG_AT, 31, 0x03));       /* sra  AT, AT, 31  */
+        emit(MK_R(0, 0, REG_AT, REG_AT, 1, 0x00));        /* sll  AT, AT, 1   */
+        emit(MK_R(0, REG_AT, REG_ZERO, REG_AT, 0, 0x27)); /* nor  AT, AT, $0  */
+    }
+    else
+        EMIT_ADDIU(REG_AT, REG_ZERO, -1);
+    EMIT_MOVZ(REG_T8, REG_AT, REG_T9);
+    EMIT_SW(REG_T8, CPU_LO, REG_S0);
+    EMIT_MFHI1(REG_T8);                       /* T8 = remainder */
+#ifdef PLATFORM_PSP
+    if (hilo_pending == 0x1A)
+    {
+        /* INT_MIN / -1 remainder, as in the inline DIV */
+        EMIT_ADDIU(REG_AT, REG_T9, 1);
+        EMIT_MOVZ(REG_T8, REG_ZERO, REG_AT);
+    }
+#endif
+    EMIT_LW(REG_AT, HILO_STASH_RS, REG_SP);   /* divz hi = rs */
+    EMIT_MOVZ(REG_T8, REG_AT, REG_T9);
+    EMIT_SW(REG_T8, CPU_HI, REG_S0);
+    reg_cache_invalidate();
+    mem_host_base_psx = -1;
+    hilo_pending = 0;
+}
+
+void emit_hilo_point(uint32_t opcode, const uint32_t *next, int in_delay_slot)
+{
+    uint32_t f = opcode & 0x3F;
+    int writes_both = OP(opcode) == 0x00 && f >= 0x18 && f <= 0x1B; /* MULT..DIVU */
+
+    if (hilo_pending && !hilo_spans(opcode))
+    {
+        if (writes_both)
+            hilo_pending = 0; /* result overwritten unread */
+        else
+            emit_hilo_flush();
+    }
+    hilo_lazy = 0;
+    if (in_delay_slot || OP(opcode) != 0x00 || (f != 0x1A && f != 0x1B))
+        return;
+    int run = 0;
+    while (run < HILO_LOOKAHEAD && hilo_spans(next[run]))
+        run++;
+    hilo_lazy = run >= HILO_MIN_RUN;
+}
+
 /* ---- Main instruction emitter ---- */
 int emit_instruction(uint32_t opcode, uint32_t psx_pc, int *mult_count)
 {
@@ -353,7 +465,14 @@ int emit_instruction(uint32_t opcode, uint32_t psx_pc, int *mult_count)
         }
         case 0x0C: /* SYSCALL */
             emit_load_imm32(REG_A0, psx_pc);
-            emit_call_c((uint32_t)Helper_Syscall_Exception);
+            if (psx_config.bios_hle)
+            {
+                /* cpu.pc is past the SYSCALL or at the vector either way */
+                emit_call_c((uint32_t)Helper_Syscall_HLE);
+                EMIT_SUBU(REG_S2, REG_S2, REG_V0);
+            }
+            else
+                emit_call_c((uint32_t)Helper_Syscall_Exception);
             emit_block_epilogue();
             return -1;
         case 0x0D: /* BREAK */
@@ -422,6 +541,15 @@ int emit_instruction(uint32_t opcode, uint32_t psx_pc, int *mult_count)
             mem_host_base_psx = -1;
             int s1 = emit_use_reg(rs, REG_T8); /* s1 = EE reg holding rs */
             int s2 = emit_use_reg(rt, REG_T9); /* s2 = EE reg holding rt (divisor) */
+            if (hilo_lazy)
+            {
+                EMIT_DIV1(s1, s2);
+                EMIT_SW(s1, HILO_STASH_RS, REG_SP);
+                EMIT_SW(s2, HILO_STASH_RT, REG_SP);
+                hilo_pending = 0x1A;
+                hilo_lazy = 0;
+                break;
+            }
             emit(MK_R(0, s1, s2, 0, 0, 0x1A)); /* div s1, s2 */
             /* Fill div latency: compute divz lo = (rs>=0)?-1:1 */
             emit(MK_R(0, 0, s1, REG_AT, 31, 0x03));           /* sra  AT, s1, 31  */
@@ -457,6 +585,15 @@ int emit_instruction(uint32_t opcode, uint32_t psx_pc, int *mult_count)
             mem_host_base_psx = -1;
             int s1 = emit_use_reg(rs, REG_T8);    /* s1 = EE reg holding rs */
             int s2 = emit_use_reg(rt, REG_T9);    /* s2 = EE reg holding rt (divisor) */
+            if (hilo_lazy)
+            {
+                EMIT_DIVU1(s1, s2);
+                EMIT_SW(s1, HILO_STASH_RS, REG_SP);
+                EMIT_SW(s2, HILO_STASH_RT, REG_SP);
+                hilo_pending = 0x1B;
+                hilo_lazy = 0;
+                break;
+            }
             emit(MK_R(0, s1, s2, 0, 0, 0x1B));    /* divu s1, s2 */
             EMIT_ADDIU(REG_AT, REG_ZERO, -1);     /* AT = 0xFFFFFFFF (divz lo) */
             emit(MK_R(0, 0, 0, REG_T8, 0, 0x12)); /* mflo T8 = quotient */
@@ -1223,13 +1360,16 @@ int emit_instruction(uint32_t opcode, uint32_t psx_pc, int *mult_count)
                 emit(MK_I(0x05, REG_AT, REG_ZERO, 0));          /* bne at,zero,@skip   */
             }
             emit(MK_R(0, REG_T8, REG_S3, REG_AT, 0, 0x24)); /* and at,t8,s3 */
+            uint32_t *bp_addu = code_ptr;
             EMIT_ADDU(REG_AT, REG_AT, REG_S1);              /* addu at, at, s1     */
+            uint32_t *bp_fault = code_ptr;
             EMIT_SW(REG_T9, 0, REG_AT);                     /* store               */
             if (isc_skip_ptr)
             {
                 int32_t skip_off = (int32_t)(code_ptr - isc_skip_ptr - 1);
                 *isc_skip_ptr = (*isc_skip_ptr & 0xFFFF0000) | ((uint32_t)skip_off & 0xFFFF);
             }
+            tlb_bp_push(bp_addu, bp_fault, (uint32_t)WriteWord, 1, 4, 0, 0);
         }
         else
         {
@@ -1271,18 +1411,22 @@ int emit_instruction(uint32_t opcode, uint32_t psx_pc, int *mult_count)
                 emit(MK_R(0, REG_T8, REG_S3, REG_AT, 0, 0x24)); /* [delay] and at, t8, s3 */
             }
 
-            /* Range check: skip if SMRV proves base is RAM */
+            /* Range check: skip if SMRV proves base is RAM, or let the
+             * TLB miss and backpatch when it is active */
             uint32_t *range_swc2 = NULL;
-            if (!smrv_is_known_ram(rs))
+            if (!psx_tlb_base && !smrv_is_known_ram(rs))
             {
                 emit(MK_R(0, 0, REG_AT, REG_A0, 21, 0x02)); /* srl a0, at, 21 */
                 range_swc2 = code_ptr;
                 emit(MK_I(0x05, REG_A0, REG_ZERO, 0)); /* bne a0, zero, @cold */
             }
+            uint32_t *bp_addu = code_ptr;
             EMIT_ADDU(REG_AT, REG_AT, REG_S1); /* [delay/inline] host addr */
 
             /* Fast path: direct store */
+            uint32_t *bp_fault = code_ptr;
             EMIT_SW(REG_T9, 0, REG_AT);
+            tlb_bp_push(bp_addu, bp_fault, (uint32_t)WriteWord, 1, 4, 0, 0);
 
             /* Defer slow path to end of block via cold_queue (P7) */
             {
@@ -1294,10 +1438,11 @@ int emit_instruction(uint32_t opcode, uint32_t psx_pc, int *mult_count)
                     branches[nb++] = align_swc2;
                 if (range_swc2)
                     branches[nb++] = range_swc2;
-                cold_slow_push(branches, nb, code_ptr,
-                               (uint32_t)WriteWord, psx_pc,
-                               (int16_t)emit_cycle_offset, 4, 1, 1,
-                               dyn_dirty_mask);
+                if (nb)
+                    cold_slow_push(branches, nb, code_ptr,
+                                   (uint32_t)WriteWord, psx_pc,
+                                   (int16_t)emit_cycle_offset, 4, 1, 1,
+                                   dyn_dirty_mask);
             }
         }
         reg_cache_invalidate();
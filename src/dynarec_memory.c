@@ -6,9 +6,11 @@
  * for IO/BIOS/misaligned access.
  */
 #include "dynarec.h"
+#include "config.h"
 #include "platform.h"
 #include "scheduler.h"
 #include "psx_sio.h" /* SIO_Write/SIO_Read + extern sio_* vars */
+#include "psx_timers.h"
 
 /* gpu_state.h needed for const-address GPU_ReadStatus inline — silence LOG_TAG redef */
 #undef LOG_TAG
@@ -16,13 +18,107 @@
 #undef LOG_TAG
 #define LOG_TAG "DYNAREC"
 
-/* SMC batch tracking: pages already checked in the current block.
- * Consecutive const-address stores to the same page share one dirty check. */
+/* SMC batch tracking: words already checked in the current block.
+ * Repeated const-address stores to the same word share one code map check. */
 #define SMC_BATCH_MAX 4
-static uint32_t smc_batch_pages[SMC_BATCH_MAX];
+static uint32_t smc_batch_words[SMC_BATCH_MAX];
 static int smc_batch_count = 0;
+static uint32_t smc_range_lo = 0, smc_range_hi = 0; /* span covered by a store-run check */
+
+/* Store runs (BlockScanResult.store_run_mask): set by the compile loop
+ * before each store.  store_run_next is the following opcode when it is
+ * a store off the same base; at a run head store_run_lo/hi span the
+ * offsets of the run's SWs so one code map check covers all of them. */
+uint32_t store_run_next = 0;
+int store_run_head = 0;
+int16_t store_run_lo = 0, store_run_hi = 0;
+
+/* Const RAM stores leave their host address in T8; the next one reuses
+ * it when nothing was emitted in between.  const_store_skip is the word
+ * a paired SD already wrote for the following SW $zero. */
+static uint32_t *const_store_end = NULL;
+static uint32_t const_store_host = 0;
+static uint32_t const_store_skip = 0;
 
-void smc_batch_reset(void) { smc_batch_count = 0; }
+/* ================================================================
+ *  Shared slow-path stubs (jit_shared_stubs)
+ *
+ *  Built once by Init_Dynarec after the trampolines.  A cold slow path
+ *  only sets its own PSX PC and cycle offset and calls the stub of its
+ *  access function, which moves the arguments into place and tail-calls
+ *  the memory slow trampoline (that returns straight to the site):
+ *    site:  li at, psx_pc / jal stub / addiu a2, zero, cycle_offset
+ *    stub:  move a0, t8 / [move a1, t9|v0] / move t9, a2 /
+ *           lui t8, hi(func) / j mem_slow_trampoline / ori t8, lo(func)
+ *  SMC handler calls pass the phys word (or range) in A0 (A1) and call
+ *  smc_stub / smc_range_stub, which store S2 and tail-call the lite
+ *  trampoline.
+ * ================================================================ */
+#define MEM_SLOW_STUBS 10
+
+static uint32_t mem_stub_func[MEM_SLOW_STUBS];
+static uint8_t mem_stub_type[MEM_SLOW_STUBS]; /* ColdSlowEntry.type */
+static uint32_t *mem_stub_addr[MEM_SLOW_STUBS];
+static uint32_t *smc_stub = NULL, *smc_range_stub = NULL;
+
+static uint32_t *smc_stub_init(uint32_t *p, uint32_t func)
+{
+    *p++ = MK_I(0x2B, REG_S0, REG_S2, CPU_CYCLES_LEFT);                /* sw s2, cpu.cycles_left */
+    *p++ = MK_I(0x0F, 0, REG_T8, func >> 16);                          /* lui t8, hi(func) */
+    *p++ = MK_J(2, (uint32_t)call_c_trampoline_lite_addr >> 2);        /* j lite_tramp */
+    *p++ = MK_I(0x0D, REG_T8, REG_T8, func & 0xFFFF);                  /* (delay) ori t8, lo(func) */
+    return p;
+}
+
+/* Returns the first word past the stubs */
+uint32_t *mem_slow_stubs_init(uint32_t *p)
+{
+    const uint32_t funcs[MEM_SLOW_STUBS] = {
+        (uint32_t)ReadWord, (uint32_t)ReadHalf, (uint32_t)ReadByte,
+        (uint32_t)WriteWord, (uint32_t)WriteHalf, (uint32_t)WriteByte,
+        (uint32_t)Helper_LWL, (uint32_t)Helper_LWR, (uint32_t)Helper_SWL, (uint32_t)Helper_SWR};
+    const uint8_t types[MEM_SLOW_STUBS] = {0, 0, 0, 1, 1, 1, 2, 2, 3, 3};
+
+    for (int i = 0; i < MEM_SLOW_STUBS; i++)
+    {
+        uint32_t f = funcs[i];
+        mem_stub_func[i] = f;
+        mem_stub_type[i] = types[i];
+        mem_stub_addr[i] = p;
+        *p++ = MK_R(0, REG_T8, 0, REG_A0, 0, 0x21); /* move a0, t8 */
+        if (types[i] == 1 || types[i] == 3)
+            *p++ = MK_R(0, REG_T9, 0, REG_A1, 0, 0x21); /* move a1, t9 (data) */
+        else if (types[i] == 2)
+            *p++ = MK_R(0, REG_V0, 0, REG_A1, 0, 0x21); /* move a1, v0 (current RT) */
+        *p++ = MK_R(0, REG_A2, 0, REG_T9, 0, 0x21);  /* move t9, a2 (cycle offset) */
+        *p++ = MK_I(0x0F, 0, REG_T8, f >> 16);       /* lui t8, hi(func) */
+        *p++ = MK_J(2, (uint32_t)mem_slow_trampoline_addr >> 2);
+        *p++ = MK_I(0x0D, REG_T8, REG_T8, f & 0xFFFF); /* (delay) ori t8, lo(func) */
+    }
+    smc_stub = p;
+    p = smc_stub_init(p, (uint32_t)jit_smc_handler);
+    smc_range_stub = p;
+    p = smc_stub_init(p, (uint32_t)jit_smc_invalidate_range);
+    return p;
+}
+
+static uint32_t *mem_slow_stub(uint32_t func_addr, uint8_t type)
+{
+    if (!psx_config.jit_shared_stubs)
+        return NULL;
+    for (int i = 0; i < MEM_SLOW_STUBS; i++)
+        if (mem_stub_func[i] == func_addr && mem_stub_type[i] == type)
+            return mem_stub_addr[i];
+    return NULL;
+}
+
+void smc_batch_reset(void)
+{
+    smc_batch_count = 0;
+    smc_range_lo = smc_range_hi = 0;
+    const_store_end = NULL;
+    const_store_skip = 0;
+}
 
 /* GPU busy-until timestamp — when non-zero, GPU_ReadStatus needs to
  * fast-forward global_cycles.  JIT inline checks this for zero to
@@ -79,6 +175,7 @@ typedef struct
     uint8_t load_defer;       /* dynarec_load_defer at emission time */
     uint8_t saved_dirty_mask; /* dyn_dirty_mask at instruction point */
     int rt_psx;               /* PSX register for store result */
+    uint32_t sp_word;         /* Fast-path load/store replayed on scratchpad (0 = none) */
 } ColdSlowEntry;
 
 static ColdSlowEntry cold_queue[MAX_COLD_SLOW];
@@ -93,6 +190,16 @@ void cold_slow_reset(void)
     tlb_bp_count = 0;
 }
 
+int cold_slow_pending(void)
+{
+    return cold_count;
+}
+
+int tlb_patch_pending(void)
+{
+    return tlb_bp_count;
+}
+
 /* Push a cold slow path entry from external callers (e.g. SWC2 in dynarec_insn.c).
  * branches[] are the BNE/BEQ forward-references to patch.
  * func_addr is the C helper (e.g. WriteWord). */
@@ -117,50 +224,110 @@ void cold_slow_push(uint32_t *branches[], int num_branches,
     e->load_defer = 0;
     e->saved_dirty_mask = saved_dirty;
     e->rt_psx = 0;
+    e->sp_word = 0;
+}
+
+/*
+ * emit_scratchpad_replay: scratchpad fast path at the head of a slow stub.
+ * Scratchpad shares its 64KB page with I/O, so the RAM range check sends
+ * it to the stub; catch phys 0x1F800000-0x1F8003FF here and replay the
+ * fast path's host load/store (word) on scratchpad_buf instead of calling
+ * the C helper.  Expects T8 = PSX vaddr (and T9 = data / V0 = LWL/LWR merge
+ * value, as the fast path left them); uses A0/AT.  Loads land in V0.
+ * Misses (out of range, or misaligned for plain LH/LW/SH/SW) branch
+ * through miss[], returned count, which the caller points at the helper.
+ */
+static int emit_scratchpad_replay(uint32_t word, int type, int size, uint32_t **miss)
+{
+    uint32_t buf = (uint32_t)scratchpad_buf;
+    int16_t lo = (int16_t)(buf & 0xFFFF);
+    int n = 0;
+
+    emit(MK_R(0, REG_T8, REG_S3, REG_A0, 0, 0x24)); /* and   a0, t8, s3 (phys)  */
+    EMIT_LUI(REG_AT, 0x1F80);
+    EMIT_SUBU(REG_A0, REG_A0, REG_AT);              /* a0 = phys - 0x1F800000  */
+    emit(MK_I(0x0B, REG_A0, REG_AT, 0x400));        /* sltiu at, a0, 0x400     */
+    miss[n++] = code_ptr;
+    EMIT_BEQ(REG_AT, REG_ZERO, 0);                  /* beq   at, zero, @helper */
+    if ((type == 0 || type == 1) && size > 1)
+    {
+        EMIT_ANDI(REG_AT, REG_T8, size - 1);        /* [delay] alignment       */
+        miss[n++] = code_ptr;
+        EMIT_BNE(REG_AT, REG_ZERO, 0);              /* bne   at, zero, @helper */
+    }
+    EMIT_LUI(REG_AT, (buf - (uint32_t)(int32_t)lo) >> 16); /* [delay] harmless on miss */
+    EMIT_ADDU(REG_A0, REG_A0, REG_AT);
+
+    /* Same opcode, base A0 + lo(scratchpad_buf); loads retargeted to V0 */
+    word = (word & ~((0x1Fu << 21) | 0xFFFFu)) | ((uint32_t)REG_A0 << 21) | (uint16_t)lo;
+    if (type == 0 || type == 2)
+        word = (word & ~(0x1Fu << 16)) | ((uint32_t)REG_V0 << 16);
+    emit(word);
+    return n;
 }
 
 /* ================================================================
  *  TLB Backpatch Slots
  *
  *  When TLB is active, each memory access emits a 3-insn fast path
- *  (and, addu, lw/sw).  If a TLB miss occurs at runtime, we backpatch
- *  the 'addu' to branch to a cold stub that does a range check first.
+ *  (and, addu, op) with no range check: RAM and BIOS are TLB-mapped,
+ *  everything else misses.  On a miss TLB_HandleFault() emulates the
+ *  access and we backpatch the 'addu' to branch to a cold stub that
+ *  does a range check first.  Covers LB/LH/LW/LBU/LHU, SB/SH/SW,
+ *  LWL/LWR/SWL/SWR, and LWC2/SWC2 (emitted as a host LW/SW via V0/T9).
  *
  *  The stub tries the TLB fast path for RAM (range check pass) or
  *  falls through to the C helper for I/O.  Once patched, that JIT
  *  instruction never causes an exception again.
  *
  *  Layout of the global lookup table:
- *    tlb_bp_map[i].fault_insn  = EPC of the faulting lw/sw
+ *    tlb_bp_map[i].fault_insn  = EPC of the faulting load/store
  *    tlb_bp_map[i].addu_insn   = 'addu' to patch → 'b @stub'
  *    tlb_bp_map[i].stub        = address of the cold stub
  *
- *  The exception handler binary-searches this table by fault_insn.
+ *  The exception handler scans this table by fault_insn.
  * ================================================================ */
 
 /* Global lookup table (persists across blocks, grows monotonically
- * within the JIT code cache — reset when the cache is flushed). */
+ * within the JIT code cache — reset when the cache is flushed, pruned
+ * when a code segment is evicted). */
 #define MAX_TLB_BP_MAP 4096
 typedef struct
 {
     uint32_t fault_insn_addr; /* EPC: address of the lw/sw instruction */
     uint32_t addu_insn_addr;  /* address of the 'addu' to patch */
     uint32_t stub_addr;       /* address of the cold patch stub */
+    uint32_t psx_pc;          /* PSX PC of the access (cpu.current_pc) */
+    int16_t cycle_offset;     /* partial_block_cycles for the C helper */
 } TLBBPMapEntry;
 TLBBPMapEntry tlb_bp_map[MAX_TLB_BP_MAP];
 int tlb_bp_map_count = 0;
 
+/* Drop map entries whose JIT code lies in [lo, hi) (code segment evicted) */
+void tlb_bp_evict_range(uint32_t lo, uint32_t hi)
+{
+    int i, j;
+    for (i = 0, j = 0; i < tlb_bp_map_count; i++)
+    {
+        if (tlb_bp_map[i].fault_insn_addr >= lo && tlb_bp_map[i].fault_insn_addr < hi)
+            continue;
+        tlb_bp_map[j++] = tlb_bp_map[i];
+    }
+    tlb_bp_map_count = j;
+}
+
 /* Per-block queue of pending TLB backpatch entries (emitted at block end) */
 #define MAX_TLB_BP 256
 typedef struct
 {
     uint32_t *addu_insn;      /* Address of 'addu t1, t1, s1' in fast path */
-    uint32_t *fault_insn;     /* Address of lw/sw in fast path */
+    uint32_t *fault_insn;     /* Address of the load/store in fast path */
+    uint32_t fault_word;      /* That instruction, re-emitted by the stub */
     uint32_t *return_point;   /* Instruction after fast path store-result */
     uint32_t func_addr;       /* ReadWord/WriteWord/etc. */
     uint32_t psx_pc;          /* PSX PC for cycle tracking */
     int16_t cycle_offset;     /* emit_cycle_offset at emit time */
-    uint8_t type;             /* 0=read, 1=write */
+    uint8_t type;             /* 0=read, 1=write, 2=lwx, 3=swx (as ColdSlowEntry) */
     uint8_t size;             /* 1/2/4 */
     uint8_t is_signed;        /* Sign extension needed? */
     uint8_t load_defer;       /* dynarec_load_defer at emit time */
@@ -170,6 +337,34 @@ typedef struct
 static TLBBPEntry tlb_bp_queue[MAX_TLB_BP];
 static int tlb_bp_count = 0;
 
+/*
+ * tlb_bp_push: queue a backpatch stub for the 'addu host, phys, s1' +
+ * load/store pair just emitted.  The return point is the current
+ * code_ptr, so call it after the fast path has stored its result.
+ * Reads leave phys in T9; writes in AT with the data in T9.
+ */
+void tlb_bp_push(uint32_t *addu_insn, uint32_t *fault_insn, uint32_t func_addr,
+                 uint8_t type, uint8_t size, uint8_t is_signed, int rt_psx)
+{
+    if (!psx_tlb_base || tlb_bp_count >= MAX_TLB_BP)
+        return;
+    TLBBPEntry *p = &tlb_bp_queue[tlb_bp_count++];
+    int is_load = (type == 0 || type == 2);
+    p->addu_insn = addu_insn;
+    p->fault_insn = fault_insn;
+    p->fault_word = *fault_insn;
+    p->return_point = code_ptr;
+    p->func_addr = func_addr;
+    p->psx_pc = emit_current_psx_pc;
+    p->cycle_offset = (int16_t)emit_cycle_offset;
+    p->type = type;
+    p->size = size;
+    p->is_signed = is_signed;
+    p->load_defer = is_load ? (uint8_t)dynarec_load_defer : 0;
+    p->saved_dirty_mask = dyn_dirty_mask;
+    p->rt_psx = is_load ? rt_psx : 0;
+}
+
 void tlb_patch_emit_all(void)
 {
     int i;
@@ -189,51 +384,35 @@ void tlb_patch_emit_all(void)
             m->fault_insn_addr = (uint32_t)e->fault_insn;
             m->addu_insn_addr = (uint32_t)e->addu_insn;
             m->stub_addr = (uint32_t)stub_start;
+            m->psx_pc = e->psx_pc;
+            m->cycle_offset = e->cycle_offset;
         }
 
         /* --- Range-checked fast path (RAM via TLB) ---
          * Inline fast path registers:
          *   Reads:  T9 = phys (from 'and t9, t8, s3'), T8 = vaddr
+         *           (LWL/LWR: V0 = current rt, the merge target)
          *   Writes: AT = phys (from 'and at, t8, s3'), T8 = vaddr, T9 = data
          */
-        int phys_reg = (e->type == 0) ? REG_T9 : REG_AT;
+        int is_load = (e->type == 0 || e->type == 2);
+        int phys_reg = is_load ? REG_T9 : REG_AT;
 
         emit(MK_R(0, 0, phys_reg, REG_A0, 21, 0x02)); /* srl  a0, phys, 21    */
         uint32_t *io_branch = code_ptr;
         emit(MK_I(0x05, REG_A0, REG_ZERO, 0)); /* bne  a0, zero, @io   */
         EMIT_ADDU(phys_reg, phys_reg, REG_S1); /* [delay] addu phys,phys,s1 */
 
-        /* TLB RAM fast path: inline load/store */
-        if (e->type == 0) /* read */
+        /* TLB RAM fast path: the original load/store (base = phys_reg,
+         * offset 0); loads retargeted to V0 and stored like the fast path */
+        if (is_load)
         {
-            if (e->size == 4)
-                EMIT_LW(REG_V0, 0, phys_reg);
-            else if (e->size == 2)
-            {
-                if (e->is_signed)
-                    EMIT_LH(REG_V0, 0, phys_reg);
-                else
-                    EMIT_LHU(REG_V0, 0, phys_reg);
-            }
-            else
-            {
-                if (e->is_signed)
-                    EMIT_LB(REG_V0, 0, phys_reg);
-                else
-                    EMIT_LBU(REG_V0, 0, phys_reg);
-            }
-            /* Store result same as fast path */
+            emit((e->fault_word & ~(0x1Fu << 16)) | ((uint32_t)REG_V0 << 16));
             if (!e->load_defer)
                 emit_store_psx_reg(e->rt_psx, REG_V0);
         }
         else /* write: data in T9, pointer in AT */
         {
-            if (e->size == 4)
-                EMIT_SW(REG_T9, 0, phys_reg);
-            else if (e->size == 2)
-                EMIT_SH(REG_T9, 0, phys_reg);
-            else
-                EMIT_SB(REG_T9, 0, phys_reg);
+            emit(e->fault_word);
         }
 
         /* Branch back to return point (TLB RAM path doesn't clobber slots) */
@@ -243,15 +422,31 @@ void tlb_patch_emit_all(void)
             EMIT_NOP();
         }
 
-        /* --- I/O slow path: call C helper --- */
+        /* --- Scratchpad, then I/O slow path: call C helper --- */
         {
             int32_t io_off = (int32_t)(code_ptr - io_branch - 1);
             *io_branch = (*io_branch & 0xFFFF0000) | ((uint32_t)io_off & 0xFFFF);
         }
+        {
+            uint32_t *sp_miss[2];
+            int n = emit_scratchpad_replay(e->fault_word, e->type, e->size, sp_miss);
+            if (is_load && !e->load_defer)
+                emit_store_psx_reg(e->rt_psx, REG_V0);
+            int32_t ret_off = (int32_t)(e->return_point - code_ptr - 1);
+            emit(MK_I(0x04, REG_ZERO, REG_ZERO, (uint16_t)(ret_off & 0xFFFF)));
+            EMIT_NOP();
+            for (int j = 0; j < n; j++)
+            {
+                int32_t off = (int32_t)(code_ptr - sp_miss[j] - 1);
+                *sp_miss[j] = (*sp_miss[j] & 0xFFFF0000) | ((uint32_t)off & 0xFFFF);
+            }
+        }
 
         EMIT_MOVE(REG_A0, REG_T8);     /* a0 = PSX address (from T8) */
-        if (e->type == 1)              /* write */
+        if (e->type == 1 || e->type == 3)
             EMIT_MOVE(REG_A1, REG_T9); /* a1 = data (from T9) */
+        else if (e->type == 2)
+            EMIT_MOVE(REG_A1, REG_V0); /* a1 = current RT (LWX merge) */
 
         /* Set up trampoline args: T8=func_addr, T9=cycle_offset, AT=psx_pc */
         emit_load_imm32(REG_T8, e->func_addr);
@@ -271,7 +466,7 @@ void tlb_patch_emit_all(void)
             emit(MK_R(0, 0, REG_V0, REG_V0, shift, 0x03)); /* SRA */
         }
 
-        if (e->type == 0 && !e->load_defer)
+        if (is_load && !e->load_defer)
             emit_store_psx_reg(e->rt_psx, REG_V0);
 
         /* T0-T7 preserved by lite trampoline save/restore */
@@ -287,6 +482,63 @@ void tlb_patch_emit_all(void)
     tlb_bp_count = 0;
 }
 
+/*
+ * TLB_HandleFault: C side of TLB_Trampoline for a JIT access that missed
+ * the TLB (I/O, RAM mirrors, scratchpad, unmapped).  regs[] is the saved
+ * host GPR file indexed by register number; the faulting instruction is
+ * decoded from the opcode word, so it works for any fast-path register
+ * assignment.  Its base register only holds the masked physical address,
+ * so the helpers get the PSX virtual address from T8, where every TLB
+ * fast path computes it before the 'and' (KSEG1, cache isolation and
+ * BADVADDR need the unmasked address).  Loads write their result back
+ * into regs[rt].  Known sites are backpatched to their stub.  Returns the
+ * resume address (EPC + 4); fast-path loads/stores are never placed in
+ * branch delay slots.
+ */
+uint32_t __attribute__((used)) TLB_HandleFault(uint32_t *regs, uint32_t epc, uint32_t insn)
+{
+    uint32_t op = insn >> 26;
+    uint32_t rt = (insn >> 16) & 0x1F;
+    uint32_t addr = regs[REG_T8];
+    int i;
+
+    for (i = 0; i < tlb_bp_map_count; i++)
+        if (tlb_bp_map[i].fault_insn_addr == epc)
+            break;
+    if (i < tlb_bp_map_count)
+    {
+        cpu.current_pc = tlb_bp_map[i].psx_pc;
+        partial_block_cycles = (uint32_t)tlb_bp_map[i].cycle_offset;
+    }
+    cpu.cycles_left = regs[REG_S2];
+
+    switch (op)
+    {
+    case 0x20: regs[rt] = (uint32_t)(int32_t)(int8_t)ReadByte(addr); break;   /* LB  */
+    case 0x21: regs[rt] = (uint32_t)(int32_t)(int16_t)ReadHalf(addr); break;  /* LH  */
+    case 0x22: regs[rt] = Helper_LWL(addr, regs[rt]); break;                  /* LWL */
+    case 0x23: regs[rt] = ReadWord(addr); break;                              /* LW  */
+    case 0x24: regs[rt] = ReadByte(addr); break;                              /* LBU */
+    case 0x25: regs[rt] = ReadHalf(addr); break;                              /* LHU */
+    case 0x26: regs[rt] = Helper_LWR(addr, regs[rt]); break;                  /* LWR */
+    case 0x28: WriteByte(addr, (uint8_t)regs[rt]); break;                     /* SB  */
+    case 0x29: WriteHalf(addr, (uint16_t)regs[rt]); break;                    /* SH  */
+    case 0x2A: Helper_SWL(addr, regs[rt]); break;                             /* SWL */
+    case 0x2B: WriteWord(addr, regs[rt]); break;                              /* SW  */
+    case 0x2E: Helper_SWR(addr, regs[rt]); break;                             /* SWR */
+    default:
+        DLOG("TLB fault on unexpected opcode %08X at %08X\n", (unsigned)insn, (unsigned)epc);
+        break;
+    }
+    regs[0] = 0;
+    /* Reload S2: I/O helpers may cap cycles_left (same as mem_slow_trampoline) */
+    regs[REG_S2] = cpu.cycles_left;
+
+    if (i < tlb_bp_map_count)
+        TLB_Backpatch(epc);
+    return epc + 4;
+}
+
 /*
  * TLB_Backpatch: Called from the TLB trampoline after handling an I/O access.
  *
@@ -319,9 +571,9 @@ int __attribute__((used)) TLB_Backpatch(uint32_t epc)
             /* Patch fault insn → nop (becomes delay slot of the branch) */
             *fault_p = 0x00000000;
 
-            /* Flush caches so patched code takes effect */
-            Platform_FlushDCache(NULL, NULL);
-            Platform_FlushICache();
+            /* Sync just the two patched words so the code takes effect */
+            Platform_SyncCodeRange(addu_p, addu_p + 1);
+            Platform_SyncCodeRange(fault_p, fault_p + 1);
 
             return 1;
         }
@@ -371,21 +623,48 @@ void cold_slow_emit_all(void)
             *e->branches[j] = (*e->branches[j] & 0xFFFF0000) | ((uint32_t)off & 0xFFFF);
         }
 
+        if (e->sp_word)
+        {
+            uint32_t *sp_miss[2];
+            int n = emit_scratchpad_replay(e->sp_word, e->type, e->size, sp_miss);
+            if ((e->type == 0 || e->type == 2) && !e->load_defer)
+                emit_store_psx_reg(e->rt_psx, REG_V0);
+            int32_t ret_off = (int32_t)(e->return_point - code_ptr - 1);
+            emit(MK_I(0x04, REG_ZERO, REG_ZERO, (uint16_t)(ret_off & 0xFFFF)));
+            EMIT_NOP();
+            for (j = 0; j < n; j++)
+            {
+                int32_t off = (int32_t)(code_ptr - sp_miss[j] - 1);
+                *sp_miss[j] = (*sp_miss[j] & 0xFFFF0000) | ((uint32_t)off & 0xFFFF);
+            }
+        }
+
         /* Emit slow path: set up args and call mem_slow_trampoline.
          * Inline fast path now uses T8=address, T9=data.
          * Trampoline protocol: T8=func_addr, T9=cycle_offset, AT=psx_pc. */
-        EMIT_MOVE(REG_A0, REG_T8); /* a0 = PSX address (from T8) */
+        uint32_t *stub = mem_slow_stub(e->func_addr, e->type);
+        if (stub)
+        {
+            /* Shared stub moves the args and sets T8/T9 */
+            emit_load_imm32(REG_AT, e->psx_pc);
+            EMIT_JAL_ABS((uint32_t)stub);
+            EMIT_ADDIU(REG_A2, REG_ZERO, (int16_t)e->cycle_offset);
+        }
+        else
+        {
+            EMIT_MOVE(REG_A0, REG_T8); /* a0 = PSX address (from T8) */
 
-        if (e->type == 1 || e->type == 3)
-            EMIT_MOVE(REG_A1, REG_T9); /* a1 = data (writes/SWX from T9) */
-        else if (e->type == 2)
-            EMIT_MOVE(REG_A1, REG_V0); /* a1 = current RT (LWX merge) */
+            if (e->type == 1 || e->type == 3)
+                EMIT_MOVE(REG_A1, REG_T9); /* a1 = data (writes/SWX from T9) */
+            else if (e->type == 2)
+                EMIT_MOVE(REG_A1, REG_V0); /* a1 = current RT (LWX merge) */
 
-        emit_load_imm32(REG_T8, e->func_addr);
-        emit_load_imm32(REG_AT, e->psx_pc);
-        EMIT_ADDIU(REG_T9, REG_ZERO, (int16_t)e->cycle_offset);
-        EMIT_JAL_ABS((uint32_t)mem_slow_trampoline_addr);
-        EMIT_NOP();
+            emit_load_imm32(REG_T8, e->func_addr);
+            emit_load_imm32(REG_AT, e->psx_pc);
+            EMIT_ADDIU(REG_T9, REG_ZERO, (int16_t)e->cycle_offset);
+            EMIT_JAL_ABS((uint32_t)mem_slow_trampoline_addr);
+            EMIT_NOP();
+        }
 
         if (e->has_abort)
         {
@@ -465,6 +744,155 @@ void cold_slow_emit_all(void)
     cold_count = 0;
 }
 
+#ifdef ENABLE_MEM_PROFILE
+/* ================================================================
+ *  Memory Site Profiler (ENABLE_MEM_PROFILE)
+ *
+ *  Every non-const load/store site calls mem_profile_hit() through the
+ *  memory slow trampoline before its real access, which classifies the
+ *  address (RAM / scratchpad / BIOS / I/O) under the site's PSX PC.
+ *  Compiles that find a site with enough hits, all I/O, emit the C
+ *  helper call directly instead of a fast path that always misses.
+ *  jit_mem_profile_dump() writes the table for tools/jit_analyze.py.
+ * ================================================================ */
+
+#define MEM_PROFILE_SIZE 4096
+#define MEM_PROFILE_MASK (MEM_PROFILE_SIZE - 1)
+#define MEM_PROFILE_MIN_HITS 32 /* Hits before a site's class is trusted */
+
+typedef struct
+{
+    uint32_t pc;
+    uint32_t hits[MEMSITE_CLASSES];
+} MemSiteProfile;
+
+static MemSiteProfile mem_profile[MEM_PROFILE_SIZE];
+
+static MemSiteProfile *mem_profile_lookup(uint32_t pc, int create)
+{
+    MemSiteProfile *m = &mem_profile[((pc >> 2) ^ (pc >> 14)) & MEM_PROFILE_MASK];
+    if (m->pc == pc)
+        return m;
+    if (!create || m->pc != 0)
+        return NULL; /* On collision, silently drop — diagnostic use */
+    m->pc = pc;
+    return m;
+}
+
+/* Called from JIT code: A0 = PSX address, cpu.current_pc = site */
+void mem_profile_hit(uint32_t addr)
+{
+    MemSiteProfile *m = mem_profile_lookup(cpu.current_pc, 1);
+    if (!m)
+        return;
+    uint32_t phys = addr & 0x1FFFFFFF;
+    if (phys < 0x00800000)
+        m->hits[MEMSITE_RAM]++;
+    else if (phys >= 0x1F800000 && phys < 0x1F800400)
+        m->hits[MEMSITE_SCRATCH]++;
+    else if (phys >= 0x1FC00000 && phys < 0x1FC00000 + PSX_BIOS_SIZE)
+        m->hits[MEMSITE_BIOS]++;
+    else
+        m->hits[MEMSITE_IO]++;
+}
+
+/* Class every recorded access of the site fell in, or -1 (unknown/mixed) */
+int mem_profile_site_class(uint32_t pc)
+{
+    MemSiteProfile *m = mem_profile_lookup(pc, 0);
+    uint32_t total = 0;
+    int c, cls = -1;
+    if (!m)
+        return -1;
+    for (c = 0; c < MEMSITE_CLASSES; c++)
+    {
+        if (!m->hits[c])
+            continue;
+        if (cls >= 0)
+            return -1;
+        cls = c;
+        total = m->hits[c];
+    }
+    return total >= MEM_PROFILE_MIN_HITS ? cls : -1;
+}
+
+/*
+ * jit_mem_profile_dump: binary dump for offline analysis.
+ *   Header:   "JITM" (4 bytes) + site_count (uint32_t)
+ *   Per site: psx_pc, ram, scratch, bios, io (5 × uint32_t)
+ */
+void jit_mem_profile_dump(const char *filename)
+{
+    FILE *f = fopen(filename, "wb");
+    uint32_t count = 0;
+    int i;
+    if (!f)
+    {
+        printf("[MEM PROFILE] Failed to open %s for writing\n", filename);
+        return;
+    }
+    for (i = 0; i < MEM_PROFILE_SIZE; i++)
+        if (mem_profile[i].pc)
+            count++;
+    fwrite("JITM", 1, 4, f);
+    fwrite(&count, sizeof(uint32_t), 1, f);
+    for (i = 0; i < MEM_PROFILE_SIZE; i++)
+    {
+        if (!mem_profile[i].pc)
+            continue;
+        fwrite(&mem_profile[i].pc, sizeof(uint32_t), 1, f);
+        fwrite(mem_profile[i].hits, sizeof(uint32_t), MEMSITE_CLASSES, f);
+    }
+    fclose(f);
+    printf("[MEM PROFILE] Wrote %u sites to %s\n", (unsigned)count, filename);
+}
+
+/* Emit the probe: a0 = base + offset, call mem_profile_hit.  Clobbers
+ * A0/AT/T8/T9/V0 (T0-T7 and pinned regs survive the lite trampoline). */
+static void emit_mem_profile_probe(int rs_psx, int16_t offset)
+{
+    int base = emit_use_reg(rs_psx, REG_A0);
+    EMIT_ADDIU(REG_A0, base, offset);
+    emit_load_imm32(REG_T8, (uint32_t)mem_profile_hit);
+    emit_load_imm32(REG_AT, emit_current_psx_pc);
+    EMIT_ADDIU(REG_T9, REG_ZERO, (int16_t)emit_cycle_offset);
+    EMIT_JAL_ABS((uint32_t)mem_slow_trampoline_addr);
+    EMIT_NOP();
+    reg_cache_invalidate();
+    mem_host_base_psx = -1;
+}
+
+/* Profiled always-I/O site: T8 = address (T9 = data for writes); call the
+ * helper inline, same protocol and epilogue as a cold slow path entry. */
+static void emit_mem_direct_call(uint32_t func_addr, int type, int size,
+                                 int is_signed, int rt_psx)
+{
+    EMIT_MOVE(REG_A0, REG_T8);
+    if (type == 1)
+        EMIT_MOVE(REG_A1, REG_T9);
+    emit_load_imm32(REG_T8, func_addr);
+    emit_load_imm32(REG_AT, emit_current_psx_pc);
+    EMIT_ADDIU(REG_T9, REG_ZERO, (int16_t)emit_cycle_offset);
+    EMIT_JAL_ABS((uint32_t)mem_slow_trampoline_addr);
+    EMIT_NOP();
+    if (size >= 2)
+        emit_abort_check((uint32_t)emit_cycle_offset);
+    if (type == 0)
+    {
+        if (is_signed && size < 4)
+        {
+            int shift = (size == 1) ? 24 : 16;
+            emit(MK_R(0, 0, REG_V0, REG_V0, shift, 0x00)); /* SLL */
+            emit(MK_R(0, 0, REG_V0, REG_V0, shift, 0x03)); /* SRA */
+        }
+        if (!dynarec_load_defer)
+            emit_store_psx_reg(rt_psx, REG_V0);
+    }
+    reg_cache_invalidate();
+    mem_host_base_psx = -1;
+}
+#endif /* ENABLE_MEM_PROFILE */
+
 /*
  * emit_memory_read: Emit native code for LW/LH/LHU/LB/LBU.
  *
@@ -586,7 +1014,8 @@ void emit_memory_read(int size, int rt_psx, int rs_psx, int16_t offset, int is_s
          * GPU_ReadStatus fast-path (0x1F801814):
          * The hot path (GPU idle) is just  return gpu_stat | 0x14002000.
          * Only fall to the full C call when GPU is busy (gpu_busy_until != 0),
-         * which triggers scheduler fast-forward logic.
+         * which triggers scheduler fast-forward logic, or GP0 words wait
+         * in the write-combining FIFO.
          */
         if (phys == 0x1F801814 && size == 4)
         {
@@ -598,6 +1027,13 @@ void emit_memory_read(int size, int rt_psx, int rs_psx, int16_t offset, int is_s
             EMIT_LW(REG_T9, 0, REG_T8);      /* t9 = low 32 bits  */
             EMIT_LW(REG_T8, 4, REG_T8);      /* t8 = high 32 bits */
             EMIT_OR(REG_T9, REG_T9, REG_T8); /* t9 = low | high   */
+            if (psx_config.jit_gp0_fifo)
+            {
+                /* Buffered GP0 words: GPU_ReadStatus drains them first */
+                emit_load_imm32(REG_T8, (uint32_t)&gpu_gp0_fifo.count);
+                EMIT_LW(REG_T8, 0, REG_T8);
+                EMIT_OR(REG_T9, REG_T9, REG_T8);
+            }
             uint32_t *gbu_slow = code_ptr;
             EMIT_BNE(REG_T9, REG_ZERO, 0); /* bne t9, $0, @slow */
             EMIT_NOP();
@@ -639,6 +1075,93 @@ void emit_memory_read(int size, int rt_psx, int rs_psx, int16_t offset, int is_s
             return;
         }
 
+        /*
+         * Timer counter fast-path (0x1F801100/10/20):
+         * Free-running counters are value + elapsed / divider until the
+         * next target or overflow, which timer_fast[] publishes as a
+         * cycle window after each sync.  Inside it the read is computed
+         * inline from the same cycle count the trampoline would hand
+         * EFFECTIVE_CYCLES; outside it, a full Timers_Read.
+         */
+        if ((phys == 0x1F801100 || phys == 0x1F801110 || phys == 0x1F801120) &&
+            (size == 4 || size == 2))
+        {
+            flush_dirty_consts();
+            emit_load_imm32(REG_T8, (uint32_t)&timer_fast[(phys >> 4) & 3]);
+            emit_load_imm32(REG_AT, (uint32_t)&global_cycles);
+            EMIT_LW(REG_T9, 0, REG_AT); /* t9 = low 32 bits */
+            EMIT_LW(REG_AT, CPU_INITIAL_CYCLES_LEFT, REG_S0);
+            EMIT_ADDU(REG_T9, REG_T9, REG_AT);
+            EMIT_SUBU(REG_T9, REG_T9, REG_S2);
+            EMIT_ADDIU(REG_T9, REG_T9, (int16_t)emit_cycle_offset);
+            EMIT_LW(REG_AT, 0, REG_T8); /* base */
+            EMIT_SUBU(REG_T9, REG_T9, REG_AT);
+            EMIT_LW(REG_AT, 4, REG_T8);                             /* window */
+            emit(MK_R(0, REG_T9, REG_AT, REG_AT, 0, 0x2B));         /* sltu at, t9, at */
+            uint32_t *tmr_slow = code_ptr;
+            EMIT_BEQ(REG_AT, REG_ZERO, 0); /* beq at, $0, @slow */
+            EMIT_LW(REG_AT, 12, REG_T8);   /* (delay) shift */
+
+            /* Fast path: v0 = value + (elapsed >> shift), below 0x10000 */
+            emit(MK_R(0, REG_AT, REG_T9, REG_T9, 0, 0x06)); /* srlv t9, t9, at */
+            EMIT_LW(REG_V0, 8, REG_T8);
+            EMIT_ADDU(REG_V0, REG_V0, REG_T9);
+            EMIT_ADDIU(REG_S2, REG_S2, -1); /* I/O bus penalty */
+            if (size == 2 && is_signed)
+            {
+                emit(MK_R(0, 0, REG_V0, REG_V0, 16, 0x00)); /* SLL */
+                emit(MK_R(0, 0, REG_V0, REG_V0, 16, 0x03)); /* SRA */
+            }
+            if (!dynarec_load_defer)
+                emit_store_psx_reg(rt_psx, REG_V0);
+            uint32_t *fast_skip = code_ptr;
+            emit(MK_I(0x04, REG_ZERO, REG_ZERO, 0)); /* b @after */
+            EMIT_NOP();
+
+            /* Slow path: Timers_Read through the trampoline */
+            int32_t soff_tmr = (int32_t)(code_ptr - tmr_slow - 1);
+            *tmr_slow = (*tmr_slow & 0xFFFF0000) | ((uint32_t)soff_tmr & 0xFFFF);
+
+            emit_load_imm32(REG_A0, phys);
+            emit_load_imm32(REG_T8, (uint32_t)Timers_Read);
+            emit_load_imm32(REG_AT, emit_current_psx_pc);
+            EMIT_ADDIU(REG_T9, REG_ZERO, (int16_t)emit_cycle_offset);
+            EMIT_JAL_ABS((uint32_t)mem_slow_trampoline_addr);
+            EMIT_NOP();
+            EMIT_ADDIU(REG_S2, REG_S2, -1); /* I/O bus penalty */
+            if (size == 2 && is_signed)
+            {
+                emit(MK_R(0, 0, REG_V0, REG_V0, 16, 0x00)); /* SLL */
+                emit(MK_R(0, 0, REG_V0, REG_V0, 16, 0x03)); /* SRA */
+            }
+            if (!dynarec_load_defer)
+                emit_store_psx_reg(rt_psx, REG_V0);
+
+            /* Patch fast-path branch */
+            int32_t soff_fast = (int32_t)(code_ptr - fast_skip - 1);
+            *fast_skip = (*fast_skip & 0xFFFF0000) | ((uint32_t)soff_fast & 0xFFFF);
+            reg_cache_invalidate();
+            return;
+        }
+
+        /*
+         * SIO_DATA read fast-path (0x1F801040): the pad / memcard byte
+         * was latched by the SIO_DATA write, so reading it only returns
+         * sio_data and marks it consumed (0xFF, RX empty), as SIO_Read.
+         */
+        if (phys == 0x1F801040)
+        {
+            emit_load_imm32(REG_T8, (uint32_t)&sio_data);
+            EMIT_LW(REG_V0, 0, REG_T8);
+            EMIT_ORI(REG_T9, REG_ZERO, 0xFF);
+            EMIT_SW(REG_T9, 0, REG_T8); /* sio_data = 0xFF */
+            emit_load_imm32(REG_T8, (uint32_t)&sio_tx_pending);
+            EMIT_SW(REG_ZERO, 0, REG_T8); /* sio_tx_pending = 0 */
+            if (!dynarec_load_defer)
+                emit_store_psx_reg(rt_psx, REG_V0);
+            return;
+        }
+
         /*
          * SIO register read (0x1F801040-0x1F80105E):
          * Call SIO_Read directly, skipping ReadWord/ReadHalf → ReadHardware.
@@ -653,10 +1176,58 @@ void emit_memory_read(int size, int rt_psx, int rs_psx, int16_t offset, int is_s
                 emit_store_psx_reg(rt_psx, REG_V0);
             return;
         }
+
+        /*
+         * Other const-address I/O registers: call the register's handler
+         * from the hardware dispatch table, skipping ReadX → ReadHardware.
+         * Same trampoline as the cold path; deduct the 1-cycle bus penalty
+         * ReadHardware would have charged, then narrow like ReadByte/Half.
+         */
+        HwReadFn hw_rd = (phys % size == 0) ? hw_read_handler(phys) : NULL;
+        if (hw_rd)
+        {
+            emit_load_imm32(REG_A0, phys);
+            emit_load_imm32(REG_T8, (uint32_t)hw_rd);
+            emit_load_imm32(REG_AT, emit_current_psx_pc);
+            EMIT_ADDIU(REG_T9, REG_ZERO, (int16_t)emit_cycle_offset);
+            EMIT_JAL_ABS((uint32_t)mem_slow_trampoline_addr);
+            EMIT_NOP();
+            EMIT_ADDIU(REG_S2, REG_S2, -1); /* I/O bus penalty */
+            if (size < 4 && is_signed)
+            {
+                int shift = (size == 1) ? 24 : 16;
+                emit(MK_R(0, 0, REG_V0, REG_V0, shift, 0x00)); /* SLL */
+                emit(MK_R(0, 0, REG_V0, REG_V0, shift, 0x03)); /* SRA */
+            }
+            else if (size < 4)
+                EMIT_ANDI(REG_V0, REG_V0, (size == 1) ? 0xFF : 0xFFFF);
+            if (!dynarec_load_defer)
+                emit_store_psx_reg(rt_psx, REG_V0);
+            reg_cache_invalidate();
+            return;
+        }
     }
 
     /* Fallback to generic emitter if address is not constant or not in RAM/SP */
 
+#ifdef ENABLE_MEM_PROFILE
+    if (!is_const)
+    {
+        emit_mem_profile_probe(rs_psx, offset);
+        if (mem_profile_site_class(emit_current_psx_pc) == MEMSITE_IO)
+        {
+            int base = emit_use_reg(rs_psx, REG_T8);
+            EMIT_ADDIU(REG_T8, base, offset);
+            flush_dirty_consts();
+            emit_mem_direct_call((size == 4)   ? (uint32_t)ReadWord
+                                 : (size == 2) ? (uint32_t)ReadHalf
+                                               : (uint32_t)ReadByte,
+                                 0, size, is_signed, rt_psx);
+            return;
+        }
+    }
+#endif
+
     /*
      * SMRV+aligned fast path: fold the PSX offset into the native LW/LH/LB
      * immediate field, eliminating the ADDIU instruction.
@@ -758,9 +1329,10 @@ void emit_memory_read(int size, int rt_psx, int rs_psx, int16_t offset, int is_s
 
     /* Range check: non-RAM (phys >= 2MB) goes to cold path via C helpers.
      * Skip when SMRV proves the base register points to RAM (saves 2 insns).
-     * $sp (reg 29) is always marked; LUI/ADDIU-derived bases also qualify. */
+     * $sp (reg 29) is always marked; LUI/ADDIU-derived bases also qualify.
+     * With TLB active a non-RAM access misses and is backpatched instead. */
     uint32_t *range_branch = NULL;
-    if (!smrv_is_known_ram(rs_psx))
+    if (!psx_tlb_base && !smrv_is_known_ram(rs_psx))
     {
         emit(MK_R(0, 0, REG_T9, REG_AT, 21, 0x02)); /* srl  at, t9, 21      */
         range_branch = code_ptr;
@@ -793,24 +1365,11 @@ void emit_memory_read(int size, int rt_psx, int rs_psx, int16_t offset, int is_s
         emit_store_psx_reg(rt_psx, dst);
 
     /* Queue TLB backpatch entry when TLB is active (for runtime patching on miss) */
-    if (psx_tlb_base && tlb_bp_count < MAX_TLB_BP)
-    {
-        TLBBPEntry *p = &tlb_bp_queue[tlb_bp_count++];
-        p->addu_insn = bp_addu;
-        p->fault_insn = bp_fault;
-        p->return_point = code_ptr;
-        p->func_addr = (size == 4)   ? (uint32_t)ReadWord
-                       : (size == 2) ? (uint32_t)ReadHalf
-                                     : (uint32_t)ReadByte;
-        p->psx_pc = emit_current_psx_pc;
-        p->cycle_offset = (int16_t)emit_cycle_offset;
-        p->type = 0; /* read */
-        p->size = (uint8_t)size;
-        p->is_signed = (uint8_t)is_signed;
-        p->load_defer = (uint8_t)dynarec_load_defer;
-        p->saved_dirty_mask = dyn_dirty_mask;
-        p->rt_psx = rt_psx;
-    }
+    tlb_bp_push(bp_addu, bp_fault,
+                (size == 4)   ? (uint32_t)ReadWord
+                : (size == 2) ? (uint32_t)ReadHalf
+                              : (uint32_t)ReadByte,
+                0, (uint8_t)size, (uint8_t)is_signed, rt_psx);
 
     /* Defer slow path to end of block (alignment miss only when TLB active) */
     if (align_branch || range_branch)
@@ -834,12 +1393,65 @@ void emit_memory_read(int size, int rt_psx, int rs_psx, int16_t offset, int is_s
         e->load_defer = (uint8_t)dynarec_load_defer;
         e->saved_dirty_mask = dyn_dirty_mask;
         e->rt_psx = rt_psx;
+        e->sp_word = *bp_fault;
     }
     reg_cache_invalidate();
 }
 
 
 
+/*
+ * emit_smc_range_check: code map check for the word-aligned phys range
+ * [lo, hi) inside one RAM page.  Each 32-bit half of smc_code_map[page]
+ * the range touches gets one test; a hit calls jit_smc_invalidate_range
+ * for the whole range, which clears the bits so a second test falls
+ * through.  Clobbers T8/AT.
+ */
+static void emit_smc_range_check(uint32_t lo, uint32_t hi)
+{
+    uint32_t page = lo >> 12;
+    uint32_t c0 = (lo >> SMC_CHUNK_SHIFT) & 63;
+    uint32_t c1 = ((hi - 1) >> SMC_CHUNK_SHIFT) & 63;
+    for (uint32_t w = c0 >> 5; w <= (c1 >> 5); w++)
+    {
+        uint32_t first = (w << 5) > c0 ? 0 : (c0 & 31);
+        uint32_t last = ((w << 5) + 31) < c1 ? 31 : (c1 & 31);
+        uint32_t mask = (last == 31 ? 0xFFFFFFFFu : ((1u << (last + 1)) - 1)) & ~((1u << first) - 1);
+        uint32_t map_addr = (uint32_t)&smc_code_map[page] + (w << 2);
+        emit(MK_I(0x0F, 0, REG_T8, (map_addr + 0x8000) >> 16));      /* lui t8, hi(&map[page]) */
+        emit(MK_I(0x23, REG_T8, REG_T8, map_addr & 0xFFFF));         /* lw t8, lo(&map[page])(t8) */
+        if (mask <= 0xFFFF)
+            EMIT_ANDI(REG_T8, REG_T8, mask);
+        else
+        {
+            emit_load_imm32(REG_AT, mask);
+            EMIT_AND(REG_T8, REG_T8, REG_AT);
+        }
+        uint32_t *beq_ptr = code_ptr;
+        emit(MK_I(0x04, REG_T8, REG_ZERO, 0)); /* beq t8, zero, @done (placeholder) */
+        EMIT_NOP();
+
+        emit_load_imm32(REG_A0, lo);
+        if (psx_config.jit_shared_stubs)
+        {
+            EMIT_LUI(REG_A1, hi >> 16);
+            EMIT_JAL_ABS((uint32_t)smc_range_stub);
+            EMIT_ORI(REG_A1, REG_A1, hi & 0xFFFF);
+        }
+        else
+        {
+            emit_load_imm32(REG_A1, hi);
+            EMIT_SW(REG_S2, CPU_CYCLES_LEFT, REG_S0);
+            emit_load_imm32(REG_T8, (uint32_t)jit_smc_invalidate_range);
+            EMIT_JAL_ABS((uint32_t)call_c_trampoline_lite_addr);
+            EMIT_NOP();
+        }
+
+        int32_t skip = (int32_t)(code_ptr - beq_ptr - 1);
+        *beq_ptr = MK_I(0x04, REG_T8, REG_ZERO, skip & 0xFFFF);
+    }
+}
+
 void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset)
 {
     reg_cache_invalidate();
@@ -868,14 +1480,67 @@ void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset)
                            ((const_addr & 0xE0000000) != 0xA0000000);
         if ((phys < PSX_RAM_SIZE) && (phys % size == 0) && !isc_eligible)
         {
-            emit_load_psx_reg(REG_T9, rt_psx);
-            emit_load_imm32(REG_T8, (uint32_t)psx_ram + phys);
-            if (size == 4)
-                EMIT_SW(REG_T9, 0, REG_T8);
-            else if (size == 2)
-                EMIT_SH(REG_T9, 0, REG_T8);
-            else
-                EMIT_SB(REG_T9, 0, REG_T8);
+            uint32_t host = (uint32_t)psx_ram + phys;
+            int32_t delta = (int32_t)(host - const_store_host);
+            int reuse = (code_ptr == const_store_end && delta >= -32768 && delta <= 32767);
+            int smc_live = (size == 4 && jit_l1_ram[phys >> 12] != NULL);
+            int skip_store = (size == 4 && rt_psx == 0 && phys == const_store_skip);
+            int pair = 0;
+            const_store_skip = 0;
+
+            /* Run head: one code map check for every SW of the run, ahead
+             * of the stores so T8 survives for the rest of the run. */
+            if (smc_live && store_run_head)
+            {
+                uint32_t base = const_addr - (uint32_t)offset;
+                uint32_t lo = (base + (uint32_t)(int32_t)store_run_lo) & 0x1FFFFFFF;
+                uint32_t hi = ((base + (uint32_t)(int32_t)store_run_hi) & 0x1FFFFFFF) + 4;
+                if (lo <= phys && phys < hi && ((hi - 1) >> 12) == (lo >> 12))
+                {
+                    flush_dirty_consts();
+                    emit_smc_range_check(lo, hi);
+                    smc_range_lo = lo;
+                    smc_range_hi = hi;
+                    reuse = 0;
+                }
+            }
+
+#ifdef PLATFORM_PS2
+            /* SW $zero,x / SW $zero,x+4 on an 8-byte boundary: one SD
+             * (memset-style init).  The second SW is then dropped. */
+            if (size == 4 && rt_psx == 0 && !skip_store && (host & 7) == 0 &&
+                OP(store_run_next) == 0x2B && RT(store_run_next) == 0 &&
+                SIMM16(store_run_next) == offset + 4)
+                pair = 1;
+#endif
+
+            if (!skip_store)
+            {
+                int src = REG_ZERO;
+                if (rt_psx != 0)
+                {
+                    emit_load_psx_reg(REG_T9, rt_psx);
+                    src = REG_T9;
+                }
+                if (!reuse)
+                {
+                    emit_load_imm32(REG_T8, host);
+                    const_store_host = host;
+                    delta = 0;
+                }
+                if (pair)
+                {
+                    emit(MK_I(0x3F, REG_T8, REG_ZERO, delta & 0xFFFF)); /* sd zero, delta(t8) */
+                    const_store_skip = phys + 4;
+                }
+                else if (size == 4)
+                    EMIT_SW(src, delta, REG_T8);
+                else if (size == 2)
+                    EMIT_SH(src, delta, REG_T8);
+                else
+                    EMIT_SB(src, delta, REG_T8);
+            }
+            const_store_end = (skip_store && !reuse) ? NULL : code_ptr;
 
             /* SMC detection for const-address word stores to RAM.
              *
@@ -884,45 +1549,58 @@ void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset)
              * if code is later compiled on the page, smc_page_epoch bumps
              * and run_jit_chain invalidates this block for recompilation.
              *
-             * P29: Debounce via smc_page_dirty[page].  Instead of always
-             * calling the handler when the page has code, check the dirty
-             * flag first.  The handler sets dirty=1 on first call; native
-             * code skips subsequent calls until blocks are recompiled
-             * (cache_block clears dirty=0).  Reduces 70K C calls to ~1
-             * per recompilation cycle for hot counter-increment patterns. */
-            if (size == 4 && jit_l1_ram[phys >> 12] != NULL)
+             * Sub-page filter via smc_code_map[page]: the handler is only
+             * called when the written 64-byte chunk holds live code.  The
+             * handler clears chunks whose blocks it invalidates and
+             * compiles set them again, so a hot counter next to code
+             * never leaves native code (this replaces the P29 page-wide
+             * dirty flag). */
+            if (smc_live)
             {
                 uint32_t page = phys >> 12;
-                /* SMC batching: skip if this page was already checked in this block */
-                int already = 0;
-                for (int i = 0; i < smc_batch_count; i++)
-                    if (smc_batch_pages[i] == page) { already = 1; break; }
+                /* SMC batching: skip if this word was already checked in this block */
+                int already = (phys >= smc_range_lo && phys < smc_range_hi);
+                for (int i = 0; !already && i < smc_batch_count; i++)
+                    if (smc_batch_words[i] == phys) { already = 1; break; }
                 if (!already)
                 {
-                    uint32_t dirty_addr = (uint32_t)&smc_page_dirty[page];
-                    uint16_t dirty_hi = (dirty_addr + 0x8000) >> 16;
-                    int16_t dirty_lo = (int16_t)(dirty_addr & 0xFFFF);
+                    uint32_t chunk = (phys >> SMC_CHUNK_SHIFT) & 63;
+                    uint32_t map_addr = (uint32_t)&smc_code_map[page] + ((chunk >> 5) << 2);
+                    uint16_t map_hi = (map_addr + 0x8000) >> 16;
+                    int16_t map_lo = (int16_t)(map_addr & 0xFFFF);
                     flush_dirty_consts();
-                    emit(MK_I(0x0F, 0, REG_T8, dirty_hi));           /* lui t8, hi(&dirty[page]) */
-                    emit(MK_I(0x24, REG_T8, REG_T8, dirty_lo));      /* lbu t8, lo(&dirty[page])(t8) */
-                    uint32_t *bne_ptr = code_ptr;
-                    emit(MK_I(0x05, REG_T8, REG_ZERO, 0));           /* bne t8, zero, @done (placeholder) */
+                    emit(MK_I(0x0F, 0, REG_T8, map_hi));             /* lui t8, hi(&map[page]) */
+                    emit(MK_I(0x23, REG_T8, REG_T8, map_lo));        /* lw t8, lo(&map[page])(t8) */
+                    emit(MK_R(0, 0, REG_T8, REG_T8, chunk & 31, 0x02)); /* srl t8, t8, chunk */
+                    EMIT_ANDI(REG_T8, REG_T8, 1);
+                    uint32_t *beq_ptr = code_ptr;
+                    emit(MK_I(0x04, REG_T8, REG_ZERO, 0));           /* beq t8, zero, @done (placeholder) */
                     EMIT_NOP();
 
-                    /* Not yet dirty — call handler (sets dirty=1, bumps gen, removes HT) */
-                    emit_load_imm32(REG_A0, phys);
-                    EMIT_SW(REG_S2, CPU_CYCLES_LEFT, REG_S0);
-                    emit_load_imm32(REG_T8, (uint32_t)jit_smc_handler);
-                    EMIT_JAL_ABS((uint32_t)call_c_trampoline_lite_addr);
-                    EMIT_NOP();
+                    /* Chunk holds code — call handler (invalidates overlapping blocks) */
+                    if (psx_config.jit_shared_stubs)
+                    {
+                        EMIT_LUI(REG_A0, phys >> 16);
+                        EMIT_JAL_ABS((uint32_t)smc_stub);
+                        EMIT_ORI(REG_A0, REG_A0, phys & 0xFFFF);
+                    }
+                    else
+                    {
+                        emit_load_imm32(REG_A0, phys);
+                        EMIT_SW(REG_S2, CPU_CYCLES_LEFT, REG_S0);
+                        emit_load_imm32(REG_T8, (uint32_t)jit_smc_handler);
+                        EMIT_JAL_ABS((uint32_t)call_c_trampoline_lite_addr);
+                        EMIT_NOP();
+                    }
                     /* T0-T7 preserved by lite trampoline save/restore */
 
-                    /* Fixup BNE target to skip the handler call */
-                    int32_t skip = (int32_t)(code_ptr - bne_ptr - 1);
-                    *bne_ptr = MK_I(0x05, REG_T8, REG_ZERO, skip & 0xFFFF);
+                    /* Fixup BEQ target to skip the handler call */
+                    int32_t skip = (int32_t)(code_ptr - beq_ptr - 1);
+                    *beq_ptr = MK_I(0x04, REG_T8, REG_ZERO, skip & 0xFFFF);
 
                     if (smc_batch_count < SMC_BATCH_MAX)
-                        smc_batch_pages[smc_batch_count++] = page;
+                        smc_batch_words[smc_batch_count++] = phys;
+                    const_store_end = NULL; /* T8 clobbered */
                 }
             }
             return;
@@ -1046,7 +1724,85 @@ void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset)
             EMIT_LW(REG_S2, CPU_CYCLES_LEFT, REG_S0);
             return;
         }
+
+        /*
+         * GP0 port write (0x1F801810, jit_gp0_fifo): append the word to
+         * the write-combining FIFO.  Only a store that fills it calls C,
+         * to hand the whole FIFO to GPU_ProcessDmaBlock.
+         *   t8 = &fifo; at = ++fifo.count; fifo.words[at - 1] = data
+         *   if (at == GPU_GP0_FIFO_WORDS) GPU_GP0FifoDrain()
+         */
+        if (phys == 0x1F801810 && size == 4 && psx_config.jit_gp0_fifo && !isc_eligible)
+        {
+            flush_dirty_consts();
+            int data_reg = emit_use_reg(rt_psx, REG_T9);
+            emit_load_imm32(REG_T8, (uint32_t)&gpu_gp0_fifo);
+            EMIT_LW(REG_AT, 0, REG_T8);
+            EMIT_ADDIU(REG_AT, REG_AT, 1);
+            EMIT_SW(REG_AT, 0, REG_T8);
+            EMIT_SLL(REG_AT, REG_AT, 2);
+            EMIT_ADDU(REG_T8, REG_T8, REG_AT); /* t8 = &words[count - 1] */
+            EMIT_SW(data_reg, 0, REG_T8);
+            emit(MK_I(0x0E, REG_AT, REG_AT, GPU_GP0_FIFO_WORDS * 4)); /* xori at: 0 when full */
+            uint32_t *fifo_room = code_ptr;
+            EMIT_BNE(REG_AT, REG_ZERO, 0); /* bne at, zero, @done */
+            EMIT_NOP();
+
+            emit_flush_partial_cycles();
+            emit_call_c_lite((uint32_t)GPU_GP0FifoDrain);
+
+            int32_t roff = (int32_t)(code_ptr - fifo_room - 1);
+            *fifo_room = (*fifo_room & 0xFFFF0000) | ((uint32_t)roff & 0xFFFF);
+            return;
+        }
+
+        /*
+         * Other const-address I/O registers: call the register's write
+         * handler directly (the mem_slow trampoline reloads S2, which
+         * I_STAT/I_MASK writes may cap).  Data is narrowed as WriteByte/
+         * WriteHalf would; ISC-eligible stores keep the generic path.
+         */
+        HwWriteFn hw_wr = (phys % size == 0 && !isc_eligible) ? hw_write_handler(phys) : NULL;
+        if (hw_wr)
+        {
+            emit_load_imm32(REG_A0, phys);
+            {
+                int data_reg = emit_use_reg(rt_psx, REG_A1);
+                if (size < 4)
+                    EMIT_ANDI(REG_A1, data_reg, (size == 1) ? 0xFF : 0xFFFF);
+                else if (data_reg != REG_A1)
+                    EMIT_MOVE(REG_A1, data_reg);
+            }
+            EMIT_ADDIU(REG_A2, REG_ZERO, size);
+            emit_load_imm32(REG_T8, (uint32_t)hw_wr);
+            emit_load_imm32(REG_AT, emit_current_psx_pc);
+            EMIT_ADDIU(REG_T9, REG_ZERO, (int16_t)emit_cycle_offset);
+            EMIT_JAL_ABS((uint32_t)mem_slow_trampoline_addr);
+            EMIT_NOP();
+            reg_cache_invalidate();
+            mem_host_base_psx = -1;
+            return;
+        }
+    }
+
+#ifdef ENABLE_MEM_PROFILE
+    if (!is_const)
+    {
+        emit_mem_profile_probe(rs_psx, offset);
+        if (mem_profile_site_class(emit_current_psx_pc) == MEMSITE_IO)
+        {
+            int base = emit_use_reg(rs_psx, REG_T8);
+            EMIT_ADDIU(REG_T8, base, offset);
+            emit_load_psx_reg(REG_T9, rt_psx);
+            flush_dirty_consts();
+            emit_mem_direct_call((size == 4)   ? (uint32_t)WriteWord
+                                 : (size == 2) ? (uint32_t)WriteHalf
+                                               : (uint32_t)WriteByte,
+                                 1, size, 0, 0);
+            return;
+        }
     }
+#endif
 
     /*
      * SMRV+aligned fast-path store with offset folding.
@@ -1182,24 +1938,11 @@ void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset)
         }
 
         /* TLB backpatch (if active) */
-        if (psx_tlb_base && tlb_bp_count < MAX_TLB_BP)
-        {
-            TLBBPEntry *p = &tlb_bp_queue[tlb_bp_count++];
-            p->addu_insn = bp_addu_w;
-            p->fault_insn = bp_fault_w;
-            p->return_point = code_ptr;
-            p->func_addr = (size == 4)   ? (uint32_t)WriteWord
-                           : (size == 2) ? (uint32_t)WriteHalf
-                                         : (uint32_t)WriteByte;
-            p->psx_pc = emit_current_psx_pc;
-            p->cycle_offset = (int16_t)emit_cycle_offset;
-            p->type = 1;
-            p->size = (uint8_t)size;
-            p->is_signed = 0;
-            p->load_defer = 0;
-            p->saved_dirty_mask = dyn_dirty_mask;
-            p->rt_psx = 0;
-        }
+        tlb_bp_push(bp_addu_w, bp_fault_w,
+                    (size == 4)   ? (uint32_t)WriteWord
+                    : (size == 2) ? (uint32_t)WriteHalf
+                                  : (uint32_t)WriteByte,
+                    1, (uint8_t)size, 0, 0);
 
         /* No cold entry needed — ISC handled inline */
         reg_cache_invalidate();
@@ -1259,9 +2002,10 @@ void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset)
 
     /* Range check: non-RAM goes to cold path (WriteWord).
      * Skip when SMRV proves the base register points to RAM (saves 2 insns).
-     * $sp (reg 29) is always marked; LUI/ADDIU-derived bases also qualify. */
+     * $sp (reg 29) is always marked; LUI/ADDIU-derived bases also qualify.
+     * With TLB active a non-RAM access misses and is backpatched instead. */
     uint32_t *range_branch = NULL;
-    if (!smrv_is_known_ram(rs_psx))
+    if (!psx_tlb_base && !smrv_is_known_ram(rs_psx))
     {
         emit(MK_R(0, 0, REG_AT, REG_A0, 21, 0x02)); /* srl  a0, at, 21      */
         range_branch = code_ptr;
@@ -1280,26 +2024,14 @@ void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset)
     /* Fast path falls through — no b @done needed */
 
     /* Queue TLB backpatch entry when TLB is active */
-    if (psx_tlb_base && tlb_bp_count < MAX_TLB_BP)
-    {
-        TLBBPEntry *p = &tlb_bp_queue[tlb_bp_count++];
-        p->addu_insn = bp_addu_w;
-        p->fault_insn = bp_fault_w;
-        p->return_point = code_ptr;
-        p->func_addr = (size == 4)   ? (uint32_t)WriteWord
-                       : (size == 2) ? (uint32_t)WriteHalf
-                                     : (uint32_t)WriteByte;
-        p->psx_pc = emit_current_psx_pc;
-        p->cycle_offset = (int16_t)emit_cycle_offset;
-        p->type = 1; /* write */
-        p->size = (uint8_t)size;
-        p->is_signed = 0;
-        p->load_defer = 0;
-        p->saved_dirty_mask = dyn_dirty_mask;
-        p->rt_psx = 0;
-    }
+    tlb_bp_push(bp_addu_w, bp_fault_w,
+                (size == 4)   ? (uint32_t)WriteWord
+                : (size == 2) ? (uint32_t)WriteHalf
+                              : (uint32_t)WriteByte,
+                1, (uint8_t)size, 0, 0);
 
     /* Defer slow path to end of block */
+    if (isc_branch || align_branch || range_branch)
     {
         ColdSlowEntry *e = &cold_queue[cold_count++];
         e->num_branches = 0;
@@ -1322,6 +2054,7 @@ void emit_memory_write(int size, int rt_psx, int rs_psx, int16_t offset)
         e->load_defer = 0;
         e->saved_dirty_mask = dyn_dirty_mask;
         e->rt_psx = 0;
+        e->sp_word = isc_branch ? 0 : *bp_fault_w; /* ISC writes are dropped */
     }
     reg_cache_invalidate();
 }
@@ -1339,6 +2072,9 @@ void emit_memory_lwx(int is_left, int rt_psx, int rs_psx, int16_t offset, int us
 {
     reg_cache_invalidate();
     mem_host_base_psx = -1;
+#ifdef ENABLE_MEM_PROFILE
+    emit_mem_profile_probe(rs_psx, offset);
+#endif
     /* Load current rt value (merge target) */
     if (use_load_delay)
         EMIT_LW(REG_V0, CPU_LOAD_DELAY_VAL, REG_S0);
@@ -1355,14 +2091,17 @@ void emit_memory_lwx(int is_left, int rt_psx, int rs_psx, int16_t offset, int us
     /* Direct address fast path: S3 = 0x1FFFFFFF, S1 = TLB base or psx_ram */
     emit(MK_R(0, REG_T8, REG_S3, REG_T9, 0, 0x24)); /* and  t9, t8, s3 (phys) */
     uint32_t *range_branch = NULL;
+    if (!psx_tlb_base)
     {
         emit(MK_R(0, 0, REG_T9, REG_AT, 21, 0x02)); /* srl  at, t9, 21 (range) */
         range_branch = code_ptr;
         emit(MK_I(0x05, REG_AT, REG_ZERO, 0)); /* bne  at, zero, @cold */
     }
+    uint32_t *bp_addu = code_ptr;
     EMIT_ADDU(REG_T9, REG_T9, REG_S1); /* [delay/inline] addu t9, t9, s1 */
 
     /* Fast path: native lwl/lwr on host address */
+    uint32_t *bp_fault = code_ptr;
     if (is_left)
         EMIT_LWL(REG_V0, 0, REG_T9);
     else
@@ -1376,6 +2115,9 @@ void emit_memory_lwx(int is_left, int rt_psx, int rs_psx, int16_t offset, int us
         emit_store_psx_reg(rt_psx, REG_V0);
     }
 
+    tlb_bp_push(bp_addu, bp_fault, is_left ? (uint32_t)Helper_LWL : (uint32_t)Helper_LWR,
+                2, 4, 0, rt_psx);
+
     /* Defer slow path to end of block (only if range check exists) */
     if (range_branch)
     {
@@ -1393,6 +2135,7 @@ void emit_memory_lwx(int is_left, int rt_psx, int rs_psx, int16_t offset, int us
         e->load_defer = (uint8_t)dynarec_load_defer;
         e->saved_dirty_mask = dyn_dirty_mask;
         e->rt_psx = rt_psx;
+        e->sp_word = *bp_fault;
     }
     reg_cache_invalidate();
 }
@@ -1409,6 +2152,9 @@ void emit_memory_swx(int is_left, int rt_psx, int rs_psx, int16_t offset)
 {
     reg_cache_invalidate();
     mem_host_base_psx = -1;
+#ifdef ENABLE_MEM_PROFILE
+    emit_mem_profile_probe(rs_psx, offset);
+#endif
     /* Compute effective address into T8, data into T9 */
     emit_load_psx_reg(REG_T8, rs_psx);
     EMIT_ADDIU(REG_T8, REG_T8, offset);
@@ -1429,7 +2175,9 @@ void emit_memory_swx(int is_left, int rt_psx, int rs_psx, int16_t offset)
             emit(MK_I(0x05, REG_AT, REG_ZERO, 0));          /* bne at,zero,@skip   */
         }
         emit(MK_R(0, REG_T8, REG_S3, REG_AT, 0, 0x24)); /* and at,t8,s3 */
+        uint32_t *bp_addu = code_ptr;
         EMIT_ADDU(REG_AT, REG_AT, REG_S1);              /* addu at, at, s1     */
+        uint32_t *bp_fault = code_ptr;
         if (is_left)
             EMIT_SWL(REG_T9, 0, REG_AT);
         else
@@ -1441,6 +2189,9 @@ void emit_memory_swx(int is_left, int rt_psx, int rs_psx, int16_t offset)
             *isc_skip = (*isc_skip & 0xFFFF0000) | ((uint32_t)skip_off & 0xFFFF);
         }
 
+        tlb_bp_push(bp_addu, bp_fault, is_left ? (uint32_t)Helper_SWL : (uint32_t)Helper_SWR,
+                    3, 4, 0, 0);
+
         reg_cache_invalidate();
         return;
     }
@@ -1473,23 +2224,28 @@ void emit_memory_swx(int is_left, int rt_psx, int rs_psx, int16_t offset)
     /* Direct address fast path (S3 = 0x1FFFFFFF, S1 = TLB base or psx_ram) */
     emit(MK_R(0, REG_T8, REG_S3, REG_AT, 0, 0x24)); /* and  at, t8, s3 (phys) */
     uint32_t *range_branch = NULL;
-    if (!smrv_is_known_ram(rs_psx))
+    if (!psx_tlb_base && !smrv_is_known_ram(rs_psx))
     {
         emit(MK_R(0, 0, REG_AT, REG_A0, 21, 0x02)); /* srl  a0, at, 21 (range) */
         range_branch = code_ptr;
         emit(MK_I(0x05, REG_A0, REG_ZERO, 0)); /* bne  a0, zero, @cold */
     }
+    uint32_t *bp_addu = code_ptr;
     EMIT_ADDU(REG_AT, REG_AT, REG_S1); /* [delay/inline] addu at, at, s1 */
 
     /* Fast path: native swl/swr on host address */
+    uint32_t *bp_fault = code_ptr;
     if (is_left)
         EMIT_SWL(REG_T9, 0, REG_AT);
     else
         EMIT_SWR(REG_T9, 0, REG_AT);
 
     /* Fast path falls through — no b @done needed */
+    tlb_bp_push(bp_addu, bp_fault, is_left ? (uint32_t)Helper_SWL : (uint32_t)Helper_SWR,
+                3, 4, 0, 0);
 
     /* Defer slow path to end of block */
+    if (isc_branch || range_branch)
     {
         ColdSlowEntry *e = &cold_queue[cold_count++];
         e->num_branches = 0;
@@ -1508,6 +2264,7 @@ void emit_memory_swx(int is_left, int rt_psx, int rs_psx, int16_t offset)
         e->load_defer = 0;
         e->saved_dirty_mask = dyn_dirty_mask;
         e->rt_psx = 0;
+        e->sp_word = isc_branch ? 0 : *bp_fault;
     }
     reg_cache_invalidate();
 }
@@ -5,6 +5,7 @@
  * scheduler callbacks (HBlank/VBlank), performance reporting, and
  * all runtime variable definitions for the dynarec subsystem.
  */
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,8 +17,10 @@
 #include "dynarec.h"
 #include "platform.h"
 #include "gpu_backend.h"
+#include "iso_image.h"
 #ifdef ENABLE_VU0_MICRO
 #include "vu0_micro_ps2.h"
+#include "vu1_micro_ps2.h"
 #endif
 #include "spu.h"
 #include "scheduler.h"
@@ -30,6 +33,14 @@
 #include "config.h"
 #include "profiler.h"
 #include "interpreter.h"
+#include "memorycard.h"
+#include "psx_sio.h"
+#include "savestate.h"
+#include "benchmark.h"
+#include "log_ring.h"
+#include "mem_budget.h"
+
+extern uint64_t gpu_busy_until;
 
 /* ================================================================
  *  Constants and Result Codes
@@ -46,6 +57,7 @@
 #include "gpu_backend.h"
 #ifdef ENABLE_VU0_MICRO
 #include "vu0_micro_ps2.h"
+#include "vu1_micro_ps2.h"
 #endif
 #include "spu.h"
 #include "scheduler.h"
@@ -58,15 +70,20 @@
 
 /* Code buffer / Memory (owned by this module) */
 uint32_t *code_buffer;
+uint32_t code_buffer_size = CODE_BUFFER_DEFAULT_SIZE;
 uint32_t *code_ptr;
 uint32_t *abort_trampoline_addr;
+uint32_t *irq_entry_trampoline_addr = NULL;
 uint32_t *call_c_trampoline_addr = NULL;
 uint32_t *call_c_trampoline_lite_addr = NULL;
 uint32_t *mem_slow_trampoline_addr = NULL;
 
-/* Hash table for fast JR/JALR dispatch */
-JitHTEntry jit_ht[JIT_HT_SIZE] __attribute__((aligned(64)));
+/* Hash table for fast JR/JALR dispatch (allocated by Init_Dynarec) */
+JitHTEntry *jit_ht = NULL;
+uint32_t jit_ht_sets = 0;
+int jit_ht_ways = 2;
 uint32_t *jump_dispatch_trampoline_addr = NULL;
+JitRas jit_ras __attribute__((aligned(64)));
 
 /* M7: Hot block micro-cache — 4-entry direct-mapped cache checked before
  * the full two-level page table lookup.  Saves 1-2 cache misses per dispatch
@@ -85,6 +102,26 @@ void micro_cache_flush(void)
         micro_cache[i].pc = 0xFFFFFFFF;
 }
 
+void jit_ras_flush(void)
+{
+    jit_ras.top = 0;
+    for (int i = 0; i < JIT_RAS_SIZE; i++)
+    {
+        jit_ras.e[i].psx_pc = 0xFFFFFFFF;
+        jit_ras.e[i].stub = jump_dispatch_trampoline_addr;
+    }
+}
+
+void jit_ht_flush(void)
+{
+    uint32_t n = jit_ht_sets * (uint32_t)jit_ht_ways;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        jit_ht[i].psx_pc = 0xFFFFFFFF;
+        jit_ht[i].native = NULL;
+    }
+}
+
 /* Host log */
 #ifdef ENABLE_HOST_LOG
 int host_log_fd = -1;
@@ -95,33 +132,48 @@ int host_log_fd = -1;
 #include <unistd.h>
 #include <string.h>
 
+void host_log_write(const char *buf, int n)
+{
+    ssize_t written = 0;
+    if (host_log_fd < 0)
+        return;
+    while (written < n)
+    {
+        ssize_t w = write(host_log_fd, buf + written, n - written);
+        if (w <= 0)
+            break;
+        written += w;
+    }
+}
+
 void host_log_printf(const char *fmt, ...)
 {
     if (host_log_fd < 0)
         return;
-    char buf[1024];
     va_list ap;
     va_start(ap, fmt);
+#ifdef ENABLE_LOG_RING
+    log_ring_vprintf(LOG_DEST_HOST, fmt, ap);
+#else
+    char buf[1024];
     int n = vsnprintf(buf, sizeof(buf), fmt, ap);
-    va_end(ap);
+    if (n > (int)sizeof(buf) - 1)
+        n = (int)sizeof(buf) - 1;
     if (n > 0)
-    {
-        ssize_t written = 0;
-        while (written < n)
-        {
-            ssize_t w = write(host_log_fd, buf + written, n - written);
-            if (w <= 0)
-                break;
-            written += w;
-        }
-    }
+        host_log_write(buf, n);
+#endif
+    va_end(ap);
 }
 
 void host_log_putc(char c)
 {
     if (host_log_fd < 0)
         return;
-    write(host_log_fd, &c, 1);
+#ifdef ENABLE_LOG_RING
+    log_ring_printf(LOG_DEST_HOST, "%c", c);
+#else
+    host_log_write(&c, 1);
+#endif
 }
 
 void host_log_flush(void)
@@ -141,21 +193,62 @@ uint64_t stat_total_cycles = 0;
 uint64_t stat_total_native_instrs = 0;
 uint64_t stat_total_psx_instrs = 0;
 uint64_t stat_lui_scan_seeds = 0;
+uint64_t stat_const_link_seeds = 0;
+uint64_t stat_const_guard_fails = 0;
+uint64_t stat_fast_irqs = 0;
+uint64_t stat_tier_ups = 0;
+uint64_t stat_trace_branches = 0;
+uint64_t stat_seg_evictions = 0;
+uint64_t stat_blocks_evicted = 0;
+uint64_t stat_links_unlinked = 0;
+uint64_t stat_smc_hits = 0;
+uint64_t stat_smc_false_positives = 0;
+uint64_t stat_smc_blocks_spared = 0;
+uint64_t stat_sync_ranged = 0;
+uint64_t stat_sync_full = 0;
+uint32_t stat_ht_hits = 0;
+uint32_t stat_ht_misses = 0;
+uint64_t stat_ht_evictions = 0;
 #endif
 
 /* Scheduler and Performance state */
 static uint32_t hblank_scanline = 0;
 static uint64_t hblank_ideal_deadline = 0;
+static uint32_t hblank_batch = HBLANK_BATCH_SIZE; /* scanlines per HBlank event; a whole frame with hblank_lazy */
 static uint64_t perf_frame_count = 0;
 static uint32_t cycles_per_hblank_runtime = CYCLES_PER_HBLANK_NTSC; /* Set at init based on region */
 uint64_t hblank_frame_start_cycle = 0;                              /* Cycle at which current frame started (VBlank reset) */
 
+/* Save state: position in the frame.  perf_frame_count stays out so
+ * snapshot_replay keeps counting forward across loads. */
+void Dynarec_State(StateIO *io)
+{
+    STATE_VAR(io, hblank_scanline);
+    STATE_VAR(io, hblank_ideal_deadline);
+    STATE_VAR(io, hblank_batch);
+    STATE_VAR(io, cycles_per_hblank_runtime);
+    STATE_VAR(io, hblank_frame_start_cycle);
+    STATE_VAR(io, gpu_busy_until);
+}
+
 /* Frame limiter: wall-clock target for next VBlank */
 #ifndef PLATFORM_PSP
 static uint32_t frame_limit_next_ms = 0;
+#endif
+/* Set at VBlank: the dispatch loop builds queued speculative targets
+ * (jit_spec_compile_pending) once the callback has returned.  The
+ * frame limiter's target is absolute, so that time comes off the next
+ * frame's wait. */
+static int spec_compile_due = 0;
+
 static const uint32_t FRAME_TIME_NTSC_US = 16667; /* 1000000 / 60 */
 static const uint32_t FRAME_TIME_PAL_US = 20000;  /* 1000000 / 50 */
-#endif
+
+/* Auto frameskip: clock() when the current frame's emulation started
+ * (after the limiter / audio wait), and frames skipped in a row */
+static clock_t frameskip_start = 0;
+static int frameskip_run = 0;
+static uint32_t frameskip_underruns = 0; /* audio output underruns seen so far */
 
 static uint64_t perf_last_report_cycle = 0;
 static uint32_t perf_last_report_tick = 0;
@@ -191,6 +284,9 @@ static uint32_t get_wall_ms(void)
 void dynarec_print_stats(void)
 {
 #ifdef ENABLE_DYNAREC_STATS
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+    jit_block_counts_fold_all();
+#endif
     uint64_t total_lookups = stat_cache_hits + stat_cache_misses;
     printf("[DYNAREC STATS]\n");
     printf("  Blocks executed : %llu\n", (unsigned long long)stat_blocks_executed);
@@ -205,17 +301,58 @@ void dynarec_print_stats(void)
            total_lookups ? (double)stat_cache_hits * 100.0 / total_lookups : 0.0);
     printf("  Cache misses    : %llu (compiles)\n", (unsigned long long)stat_cache_misses);
     printf("  Cache flushes   : %llu\n", (unsigned long long)stat_cache_flushes);
+    printf("  Block nodes     : %d live / %d high-water / %d\n",
+           block_nodes_live, block_node_pool_idx, BLOCK_NODE_POOL_SIZE);
+    printf("  Tier-ups        : %llu\n", (unsigned long long)stat_tier_ups);
+    printf("  Trace branches  : %llu (taken side compiled inline)\n",
+           (unsigned long long)stat_trace_branches);
+    printf("  Seg evictions   : %llu (%llu blocks, %llu links undone)\n",
+           (unsigned long long)stat_seg_evictions,
+           (unsigned long long)stat_blocks_evicted,
+           (unsigned long long)stat_links_unlinked);
+    printf("  SMC writes      : %llu (%llu false positive, %llu blocks spared)\n",
+           (unsigned long long)stat_smc_hits,
+           (unsigned long long)stat_smc_false_positives,
+           (unsigned long long)stat_smc_blocks_spared);
     printf("  Cache collisions: %llu\n", (unsigned long long)stat_cache_collisions);
+    printf("  Host cache syncs: %llu ranged, %llu full\n",
+           (unsigned long long)stat_sync_ranged, (unsigned long long)stat_sync_full);
+    printf("  HT geometry     : %u sets x %d ways\n", (unsigned)jit_ht_sets, jit_ht_ways);
+    printf("  HT hits         : %u (%.1f%%)\n", (unsigned)stat_ht_hits,
+           (stat_ht_hits + stat_ht_misses)
+               ? (double)stat_ht_hits * 100.0 / (double)(stat_ht_hits + stat_ht_misses)
+               : 0.0);
+    printf("  HT misses       : %u\n", (unsigned)stat_ht_misses);
+    printf("  HT evictions    : %llu\n", (unsigned long long)stat_ht_evictions);
+    printf("  Inline caches   : %llu fills, %llu sites megamorphic\n",
+           (unsigned long long)stat_ic_fills, (unsigned long long)stat_ic_mega);
     printf("  PSX cycles      : %llu\n", (unsigned long long)stat_total_cycles);
     printf("  LUI scan seeds  : %llu\n", (unsigned long long)stat_lui_scan_seeds);
+    printf("  Const links     : %llu seeded, %llu guard fails\n",
+           (unsigned long long)stat_const_link_seeds, (unsigned long long)stat_const_guard_fails);
+    printf("  Fast IRQ entries: %llu\n", (unsigned long long)stat_fast_irqs);
     printf("  DBL patches     : %llu\n", (unsigned long long)stat_dbl_patches);
+    printf("  DBL fast entries: %llu (slot loads skipped)\n", (unsigned long long)stat_dbl_fast_entries);
+    printf("  Spec compiles   : %llu (%llu dropped, queue full)\n",
+           (unsigned long long)stat_spec_compiles, (unsigned long long)stat_spec_dropped);
+    printf("  Lazy exits      : %llu (forward links without budget check)\n", (unsigned long long)stat_lazy_exits);
+    printf("  GTE batched     : %llu (commands queued for a batch flush)\n", (unsigned long long)stat_gte_batched);
+    printf("  GTE flag-free   : %llu (commands emitted without FLAG bookkeeping)\n", (unsigned long long)stat_gte_noflag);
+    printf("  GTE VFPU reuse  : %llu (lighting commands with resident VFPU matrices)\n", (unsigned long long)stat_gte_vfpu_reuse);
+    printf("  GTE VU0 reuse   : %llu (matrix loads skipped, slot still resident)\n", (unsigned long long)stat_gte_vu0_reuse);
+    printf("  GTE VU0 async   : %llu (MVMVAs polled after independent instructions)\n", (unsigned long long)stat_gte_vu0_async);
+    printf("  GTE fused       : %llu (NCLIPs computed by the RTPT before them)\n", (unsigned long long)stat_gte_fused);
     printf("  DBL pending     : %d\n", patch_sites_count);
     fflush(stdout);
 #endif
 #ifdef ENABLE_JIT_DUMP
+    jit_sampler_stop();
     if (blocks_compiled > 500)
         jit_dump_blocks("jitdump.bin");
 #endif
+#ifdef ENABLE_MEM_PROFILE
+    jit_mem_profile_dump("memprof.bin");
+#endif
 }
 
 /* ================================================================
@@ -231,6 +368,11 @@ void dynarec_print_stats(void)
  *      exec_count   (uint32_t)
  *      psx_code     (N × uint32_t)
  *      native_code  (M × uint32_t)
+ *    Trailer: "JSMP" + PC sampler totals + one sample count per block
+ *    (see jit_sampler_write)
+ *    Trailer: "JICS" + site_count (uint32_t), per inline cache site:
+ *      jr_pc, ways, used | mega << 8, execs  (4 × uint32_t)
+ *      targets, hits (JIT_IC_WAYS × uint32_t each), misses (uint32_t)
  * ================================================================ */
 #ifdef ENABLE_JIT_DUMP
 void jit_dump_blocks(const char *filename)
@@ -286,6 +428,28 @@ void jit_dump_blocks(const char *filename)
         /* Native EE code */
         fwrite(be->native, sizeof(uint32_t), be->native_count, f);
     }
+    jit_sampler_write(f);
+
+    /* Inline cache sites of live blocks */
+    uint32_t ic_count = 0;
+    for (int i = 0; i < jit_ic_sites_count; i++)
+    {
+        if (jit_ic_sites[i].code != NULL)
+            ic_count++;
+    }
+    fwrite("JICS", 1, 4, f);
+    fwrite(&ic_count, sizeof(uint32_t), 1, f);
+    for (int i = 0; i < jit_ic_sites_count; i++)
+    {
+        const JitICSite *s = &jit_ic_sites[i];
+        if (s->code == NULL)
+            continue;
+        uint32_t rec[4] = {s->psx_pc, s->ways, s->used | ((uint32_t)s->mega << 8), s->execs};
+        fwrite(rec, sizeof(uint32_t), 4, f);
+        fwrite(s->target, sizeof(uint32_t), JIT_IC_WAYS, f);
+        fwrite(s->hits, sizeof(uint32_t), JIT_IC_WAYS, f);
+        fwrite(&s->misses, sizeof(uint32_t), 1, f);
+    }
 
     fclose(f);
     printf("[JIT DUMP] Wrote %u blocks to %s\n", valid_count, filename);
@@ -296,38 +460,62 @@ void jit_dump_blocks(const char *filename)
  *  Dynarec Core Life Cycle
  * ================================================================ */
 
+/* Dispatch hash table geometry from config: power-of-2 set count */
+void jit_ht_configure(void)
+{
+    jit_ht_ways = (psx_config.jit_ht_ways == 4) ? 4 : 2;
+    uint32_t ht_entries = psx_config.jit_ht_entries > 0 ? (uint32_t)psx_config.jit_ht_entries
+                                                        : JIT_HT_DEFAULT_ENTRIES;
+    jit_ht_sets = JIT_HT_MIN_SETS;
+    while (jit_ht_sets < JIT_HT_MAX_SETS && jit_ht_sets * jit_ht_ways < ht_entries)
+        jit_ht_sets <<= 1;
+}
+
 void Init_Dynarec(void)
 {
     printf("Initializing Dynarec...\n");
 
-    /* Allocate buffers */
-    code_buffer = (uint32_t *)memalign(64, CODE_BUFFER_SIZE);
-    block_node_pool = (BlockEntry *)memalign(64, BLOCK_NODE_POOL_SIZE * sizeof(BlockEntry));
-
-    if (!code_buffer || !block_node_pool)
+    jit_ht_configure();
+
+    /* Cycle cost model: cycle_scale, wait-state table, calibration trace */
+    jit_cost_init();
+
+    /* Allocate buffers from the JIT pool (mem_budget.h), or straight
+     * from the heap when the plan found no room for them */
+    uint32_t ht_bytes = jit_ht_sets * jit_ht_ways * sizeof(JitHTEntry);
+    code_buffer_size = MemBudget_CodeBufferSize();
+    MemPool_Reset(MEM_POOL_JIT);
+    code_buffer = (uint32_t *)MemPool_Alloc(MEM_POOL_JIT, code_buffer_size, 64);
+    block_node_pool = (BlockEntry *)MemPool_Alloc(MEM_POOL_JIT, BLOCK_NODE_POOL_SIZE * sizeof(BlockEntry), 64);
+    jit_ht = (JitHTEntry *)MemPool_Alloc(MEM_POOL_JIT, ht_bytes, 64);
+    if (!code_buffer)
+        code_buffer = (uint32_t *)memalign(64, code_buffer_size);
+    if (!block_node_pool)
+        block_node_pool = (BlockEntry *)memalign(64, BLOCK_NODE_POOL_SIZE * sizeof(BlockEntry));
+    if (!jit_ht)
+        jit_ht = (JitHTEntry *)memalign(64, ht_bytes);
+
+    if (!code_buffer || !block_node_pool || !jit_ht)
     {
         printf("  ERROR: Failed to allocate dynarec buffers!\n");
         return;
     }
 
     code_ptr = code_buffer;
-    memset(code_buffer, 0, CODE_BUFFER_SIZE);
+    memset(code_buffer, 0, code_buffer_size);
     memset(block_node_pool, 0, BLOCK_NODE_POOL_SIZE * sizeof(BlockEntry));
     memset(jit_l1_ram, 0, sizeof(jit_l1_ram));
     memset(jit_l1_bios, 0, sizeof(jit_l1_bios));
     memset(jit_page_gen, 0, sizeof(jit_page_gen));
 
     /* Clear hash table — set all entries to unmatchable */
-    for (int i = 0; i < JIT_HT_SIZE; i++)
-    {
-        jit_ht[i].psx_pc[0] = 0xFFFFFFFF;
-        jit_ht[i].psx_pc[1] = 0xFFFFFFFF;
-        jit_ht[i].native[0] = NULL;
-        jit_ht[i].native[1] = NULL;
-    }
+    jit_ht_flush();
     micro_cache_flush();
+    jit_interp_reset();
 
     block_node_pool_idx = 0;
+    block_node_free_list = NULL;
+    block_nodes_live = 0;
     blocks_compiled = 0;
     total_instructions = 0;
 
@@ -458,35 +646,52 @@ void Init_Dynarec(void)
         int32_t cyc_off = (int32_t)(cyc_ok - cyc_branch - 1);
         *cyc_branch = (*cyc_branch & 0xFFFF0000) | ((uint32_t)cyc_off & 0xFFFF);
 
-        /* 2. Compute hash: t9 = ((t8 >> 12) ^ t8) & JIT_HT_MASK
+        /* 2. Compute set index: t9 = ((t8 >> 12) ^ t8) & (sets - 1)
          *    SRL already done in BGTZ delay slot above (P9) */
-        *p++ = MK_R(0, REG_T9, REG_T8, REG_T9, 0, 0x26); /* xor  t9, t9, t8 */
-        *p++ = MK_I(0x0C, REG_T9, REG_T9, JIT_HT_MASK);  /* andi t9, t9, MASK */
+        *p++ = MK_R(0, REG_T9, REG_T8, REG_T9, 0, 0x26);              /* xor  t9, t9, t8 */
+        *p++ = MK_I(0x0C, REG_T9, REG_T9, (jit_ht_sets - 1) & 0xFFFF); /* andi t9, t9, MASK */
 
-        /* 3. Scale to byte offset: t9 <<= 4 (sizeof(JitHTEntry) = 16, 2-way) */
-        *p++ = MK_R(0, 0, REG_T9, REG_T9, 4, 0x00); /* sll  t9, t9, 4 */
+        /* 3. Scale to byte offset: t9 <<= log2(ways * sizeof(JitHTEntry)) */
+        *p++ = MK_R(0, 0, REG_T9, REG_T9, jit_ht_ways == 4 ? 5 : 4, 0x00); /* sll t9, t9, 4|5 */
 
-        /* 4-5. Index into table: t9 = &jit_ht[hash]
+        /* 4-5. Index into table: t9 = &jit_ht[set * ways]
          *       FP already holds &jit_ht (P5: loaded in prologue) */
         *p++ = MK_R(0, REG_T9, REG_FP, REG_T9, 0, 0x21); /* addu t9, t9, fp */
 
-        /* 6. Check slot 0: at = psx_pc[0], compare with t8 */
-        *p++ = MK_I(0x23, REG_T9, REG_AT, 0); /* lw at, 0(t9) = psx_pc[0] */
-        *p++ = MK_I(0x04, REG_AT, REG_T8, 0); /* beq at, t8, @hit (patched) */
-        uint32_t *hit0_branch = p - 1;
-        *p++ = MK_I(0x23, REG_T9, REG_AT, 8); /* (delay) lw at, 8(t9) = native[0] */
-
-        /* 7. Slot 0 miss — check slot 1 */
-        *p++ = MK_I(0x23, REG_T9, REG_AT, 4); /* lw at, 4(t9) = psx_pc[1] */
-        *p++ = MK_I(0x05, REG_AT, REG_T8, 0); /* bne at, t8, @miss (patched) */
-        uint32_t *miss_branch = p - 1;
-        *p++ = MK_I(0x23, REG_T9, REG_AT, 12); /* (delay) lw at, 12(t9) = native[1] */
+        /* 6-7. Probe ways in MRU order: at = psx_pc[w], compare with t8.
+         *      The delay slot loads native[w], so every hit lands on @hit
+         *      with the native pointer already in at. */
+        uint32_t *hit_branch[4];
+        uint32_t *miss_branch = NULL;
+        for (int w = 0; w < jit_ht_ways; w++)
+        {
+            int last = (w == jit_ht_ways - 1);
+            *p++ = MK_I(0x23, REG_T9, REG_AT, w * 8);               /* lw at, psx_pc[w] */
+            *p++ = MK_I(last ? 0x05 : 0x04, REG_AT, REG_T8, 0);     /* beq @hit / bne @miss (patched) */
+            if (last)
+                miss_branch = p - 1;
+            else
+                hit_branch[w] = p - 1;
+            *p++ = MK_I(0x23, REG_T9, REG_AT, w * 8 + 4);           /* (delay) lw at, native[w] */
+        }
 
-        /* 8. @hit: jump to native block — at has native[0] or native[1] */
+        /* 8. @hit: jump to native block — at has native[w] */
         uint32_t *hit_target = p;
-        int32_t hit0_off = (int32_t)(hit_target - hit0_branch - 1);
-        *hit0_branch = (*hit0_branch & 0xFFFF0000) | ((uint32_t)hit0_off & 0xFFFF);
-
+        for (int w = 0; w < jit_ht_ways - 1; w++)
+        {
+            int32_t hit_off = (int32_t)(hit_target - hit_branch[w] - 1);
+            *hit_branch[w] = (*hit_branch[w] & 0xFFFF0000) | ((uint32_t)hit_off & 0xFFFF);
+        }
+#ifdef ENABLE_DYNAREC_STATS
+        /* t8/t9 are dead past the probe: count the hit */
+        {
+            uint32_t cnt = (uint32_t)&stat_ht_hits;
+            *p++ = MK_I(0x0F, 0, REG_T9, (cnt + 0x8000) >> 16);      /* lui   t9, hi(&hits) */
+            *p++ = MK_I(0x23, REG_T9, REG_T8, (int16_t)(cnt & 0xFFFF)); /* lw  t8, lo(t9) */
+            *p++ = MK_I(0x09, REG_T8, REG_T8, 1);                     /* addiu t8, t8, 1 */
+            *p++ = MK_I(0x2B, REG_T9, REG_T8, (int16_t)(cnt & 0xFFFF)); /* sw  t8, lo(t9) */
+        }
+#endif
         *p++ = MK_R(0, REG_AT, 0, 0, 0, 0x08); /* jr at */
         *p++ = 0;                              /* delay: nop */
 
@@ -494,10 +699,24 @@ void Init_Dynarec(void)
         uint32_t *miss_target = p;
         int32_t miss_off = (int32_t)(miss_target - miss_branch - 1);
         *miss_branch = (*miss_branch & 0xFFFF0000) | ((uint32_t)miss_off & 0xFFFF);
+#ifdef ENABLE_DYNAREC_STATS
+        {
+            uint32_t cnt = (uint32_t)&stat_ht_misses;
+            *p++ = MK_I(0x0F, 0, REG_T9, (cnt + 0x8000) >> 16);      /* lui   t9, hi(&misses) */
+            *p++ = MK_I(0x23, REG_T9, REG_AT, (int16_t)(cnt & 0xFFFF)); /* lw  at, lo(t9) */
+            *p++ = MK_I(0x09, REG_AT, REG_AT, 1);                     /* addiu at, at, 1 */
+            *p++ = MK_I(0x2B, REG_T9, REG_AT, (int16_t)(cnt & 0xFFFF)); /* sw  at, lo(t9) */
+        }
+#endif
         *p++ = MK_J(2, (uint32_t)abort_trampoline_addr >> 2); /* j abort */
         *p++ = 0;                                              /* delay: nop */
+        /* 4-way + stats fills code_buffer[96..127] exactly */
+        if (p > &code_buffer[128])
+            printf("  ERROR: dispatch trampoline overflows into code_buffer[128]\n");
     }
 
+    jit_ras_flush();
+
     /* ---- Memory slow-path trampoline at code_buffer[128] ----
      * Shared by all non-const memory reads/writes.
      * Entry: A0 = addr (reads) or A0 = addr, A1 = data (writes)
@@ -525,18 +744,63 @@ void Init_Dynarec(void)
         *p++ = 0;                                                   /* delay: nop */
     }
 
-    code_ptr = code_buffer + 144;
+    /* ---- Shared slow-path stubs at code_buffer[144] (jit_shared_stubs) ---- */
+    {
+        uint32_t *end = mem_slow_stubs_init(&code_buffer[144]);
+
+        /* ---- Interrupt entry after the stubs (jit_fast_irq) ----
+         * Block exits that would abort for an IRQ come here instead.
+         * Entry: cpu.pc = next PC, S2 = cycles_left.  Out of cycles, or
+         * no interrupt to take: abort as before.  Otherwise jit_irq_enter
+         * has done the exception entry (EPC, Cause, SR) and the chain goes
+         * on at the vector through the hash dispatch. */
+        irq_entry_trampoline_addr = end;
+        {
+            uint32_t *p = end;
+            uint32_t f = (uint32_t)jit_irq_enter;
+            uint32_t *to_abort[2];
+            to_abort[0] = p;
+            *p++ = MK_I(0x06, REG_S2, REG_ZERO, 0);                     /* blez s2, @abort */
+            *p++ = MK_I(0x2B, REG_S0, REG_S2, CPU_CYCLES_LEFT);         /* (delay) sw s2, cpu.cycles_left */
+            *p++ = MK_I(0x0F, 0, REG_T8, f >> 16);                      /* lui t8, hi(jit_irq_enter) */
+            *p++ = MK_J(3, (uint32_t)call_c_trampoline_lite_addr >> 2); /* jal lite_tramp */
+            *p++ = MK_I(0x0D, REG_T8, REG_T8, f & 0xFFFF);              /* (delay) ori t8, lo(jit_irq_enter) */
+            *p++ = MK_I(0x23, REG_S0, REG_S2, CPU_CYCLES_LEFT);         /* lw s2, cpu.cycles_left */
+            to_abort[1] = p;
+            *p++ = MK_I(0x04, REG_V0, REG_ZERO, 0);                     /* beq v0, zero, @abort */
+            *p++ = MK_I(0x23, REG_S0, REG_T8, CPU_PC);                  /* (delay) lw t8, cpu.pc */
+            *p++ = MK_J(2, (uint32_t)jump_dispatch_trampoline_addr >> 2); /* j dispatch */
+            *p++ = 0;                                                   /* delay: nop */
+            for (int i = 0; i < 2; i++)
+                *to_abort[i] = (*to_abort[i] & 0xFFFF0000) | ((uint32_t)(p - to_abort[i] - 1) & 0xFFFF);
+            *p++ = MK_J(2, (uint32_t)abort_trampoline_addr >> 2); /* @abort: j abort */
+            *p++ = 0;                                              /* delay: nop */
+            end = p;
+        }
+        if (end > code_buffer + CODE_TRAMPOLINE_WORDS)
+            printf("  ERROR: shared stubs overrun the trampoline area by %d words\n",
+                   (int)(end - (code_buffer + CODE_TRAMPOLINE_WORDS)));
+    }
+
+    code_seg_cur = 0;
+    code_ptr = code_segment_base(0);
+    code_seg_end = code_segment_base(1);
+    jit_cold_reset();
 
 #ifdef ENABLE_VU0_MICRO
     vu0_micro_init();
-    printf("  VU0 micro programs uploaded\n");
+    vu1_micro_init();
+    printf("  VU0/VU1 micro programs uploaded\n");
 #endif
 
-    printf("  Code buffer at %p (%u KB)\n", code_buffer, CODE_BUFFER_SIZE / 1024);
+    printf("  Code buffer at %p (%u KB)\n", code_buffer, code_buffer_size / 1024);
     printf("  Page Table (L1) initialized: %u + %u entries\n", JIT_L1_RAM_PAGES, JIT_L1_BIOS_PAGES);
 
     Platform_FlushDCache(NULL, NULL);
     Platform_FlushICache();
+#ifdef ENABLE_JIT_DUMP
+    jit_sampler_start();
+#endif
 }
 
 /* ================================================================
@@ -553,7 +817,7 @@ static inline void check_profiling_exit(uint64_t frame_count)
 
 static inline void update_dynarec_stats(BlockEntry *be, uint32_t cycles_taken)
 {
-#ifdef ENABLE_DYNAREC_STATS
+#if defined(ENABLE_DYNAREC_STATS) && !defined(ENABLE_JIT_BLOCK_COUNTERS)
     stat_blocks_executed++;
     stat_total_cycles += cycles_taken;
     stat_total_native_instrs += be->native_count;
@@ -562,6 +826,8 @@ static inline void update_dynarec_stats(BlockEntry *be, uint32_t cycles_taken)
 #ifdef ENABLE_JIT_DUMP
     be->exec_count++;
 #endif
+    (void)be;
+    (void)cycles_taken;
 }
 
 /* ---- JIT chain hotspot tracker ----
@@ -581,27 +847,114 @@ static uint32_t hotspot_idle_skips = 0;
 static uint64_t hotspot_idle_cycles_skipped = 0;
 static uint32_t hotspot_pidle_skips = 0;    /* P-IDLE: timeout loop skips */
 static uint64_t hotspot_pidle_cycles = 0;   /* P-IDLE: cycles skipped */
-static uint32_t hotspot_pzero_skips = 0;    /* P-ZERO: zero-fill skips */
-static uint64_t hotspot_pzero_bytes = 0;    /* P-ZERO: bytes zeroed */
+static uint32_t hotspot_idiom_runs[JIT_IDIOM_COUNT];  /* Loop idioms completed in C */
+static uint64_t hotspot_idiom_bytes[JIT_IDIOM_COUNT]; /* Bytes walked by those loops */
+static uint32_t hotspot_wait_skips = 0;     /* Multi-block wait-for-value skips */
+static uint32_t hotspot_learned_skips = 0;  /* Skips on arrival at a learned wait loop */
 
-static inline void hotspot_record(uint32_t pc, uint32_t cycles)
+static void hotspot_insert(uint32_t pc, uint64_t cycles, uint32_t count)
 {
     int idx = ((pc >> 2) ^ (pc >> 14)) & HOTSPOT_MASK;
     if (hotspot_table[idx].pc == pc || hotspot_table[idx].count == 0)
     {
         hotspot_table[idx].pc = pc;
         hotspot_table[idx].total_cycles += cycles;
-        hotspot_table[idx].count++;
+        hotspot_table[idx].count += count;
     }
     /* On collision, silently drop — acceptable for diagnostic use */
 }
 
+static inline void hotspot_record(uint32_t pc, uint32_t cycles)
+{
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+    /* Filled from the block counters at dump time */
+    (void)pc;
+    (void)cycles;
+#else
+    hotspot_insert(pc, cycles, 1);
+#endif
+}
+
+#define HOTSPOT_CHAIN_MAX 16
+#define ICACHE_LINE_SHIFT 6 /* 64-byte lines on both EE and Allegrex */
+
+/* Host I-cache lines the hot code of the chain entered at pc spans: the
+ * entry block plus blocks reached through linked J sites, breadth first
+ * up to HOTSPOT_CHAIN_MAX blocks.  Cold stubs don't count; lines shared
+ * by neighbouring blocks count once. */
+static uint32_t hotspot_chain_lines(uint32_t pc, int *nblocks)
+{
+    BlockEntry *chain[HOTSPOT_CHAIN_MAX];
+    BlockEntry *be = lookup_block(pc);
+    int n = 0, i, k;
+
+    if (be && be->native)
+        chain[n++] = be;
+    for (i = 0; i < n && n < HOTSPOT_CHAIN_MAX; i++)
+    {
+        const uint32_t *lo = chain[i]->native, *hi = lo + chain[i]->native_count;
+        for (int s = 0; s < link_sites_count && n < HOTSPOT_CHAIN_MAX; s++)
+        {
+            if (link_sites[s].site_word < lo || link_sites[s].site_word >= hi)
+                continue;
+            BlockEntry *t = lookup_block(link_sites[s].target_psx_pc);
+            if (!t || !t->native)
+                continue;
+            for (k = 0; k < n && chain[k] != t; k++)
+                ;
+            if (k == n)
+                chain[n++] = t;
+        }
+    }
+
+    /* By native address, then count the union of line ranges */
+    for (i = 1; i < n; i++)
+        for (k = i; k > 0 && chain[k - 1]->native > chain[k]->native; k--)
+        {
+            BlockEntry *t = chain[k];
+            chain[k] = chain[k - 1];
+            chain[k - 1] = t;
+        }
+    uint32_t lines = 0;
+    uintptr_t last = 0;
+    for (i = 0; i < n; i++)
+    {
+        if (!chain[i]->native_count)
+            continue;
+        uintptr_t l0 = (uintptr_t)chain[i]->native >> ICACHE_LINE_SHIFT;
+        uintptr_t l1 = (uintptr_t)(chain[i]->native + chain[i]->native_count - 1) >> ICACHE_LINE_SHIFT;
+        if (lines && l0 <= last)
+            l0 = last + 1;
+        if (l1 >= l0)
+        {
+            lines += (uint32_t)(l1 - l0 + 1);
+            last = l1;
+        }
+    }
+    *nblocks = n;
+    return lines;
+}
+
 void jit_hotspot_dump_and_reset(FILE *out)
 {
     /* Sort by total_cycles (simple selection of top 15) */
     int top_idx[15];
     uint64_t top_cycles[15];
     int i, j;
+
+#ifdef ENABLE_JIT_BLOCK_COUNTERS
+    /* Per block rather than per chain entry: the counts since the last
+     * dump, at each block's weighted cycle count */
+    for (i = 0; i < block_node_pool_idx; i++)
+    {
+        const BlockEntry *be = &block_node_pool[i];
+        uint32_t idx = jit_block_count_slot[i];
+        uint32_t n = idx < JIT_BLOCK_COUNT_SLOTS ? jit_block_counts[idx] : 0;
+        if (n && be->native)
+            hotspot_insert(be->psx_pc, (uint64_t)n * be->cycle_count, n);
+    }
+    jit_block_counts_fold_all();
+#endif
     for (i = 0; i < 15; i++)
     {
         top_idx[i] = -1;
@@ -629,25 +982,31 @@ void jit_hotspot_dump_and_reset(FILE *out)
         }
     }
 
-    fprintf(out, "\nJIT Chain Hotspots (entry PC → total cycles, count):\n");
+    fprintf(out, "\nJIT Chain Hotspots (entry PC → total cycles, count, hot I-cache lines):\n");
     fprintf(out, "  Idle skips: %u  (cycles skipped: %llu)\n",
             (unsigned)hotspot_idle_skips,
             (unsigned long long)hotspot_idle_cycles_skipped);
     fprintf(out, "  P-IDLE (timeout): %u skips  (%llu cycles)\n",
             (unsigned)hotspot_pidle_skips,
             (unsigned long long)hotspot_pidle_cycles);
-    fprintf(out, "  P-ZERO (zerofill): %u skips  (%llu bytes zeroed)\n",
-            (unsigned)hotspot_pzero_skips,
-            (unsigned long long)hotspot_pzero_bytes);
+    for (i = JIT_IDIOM_NONE + 1; i < JIT_IDIOM_COUNT; i++)
+        fprintf(out, "  Idiom %-4s: %u runs  (%llu bytes)\n", jit_idiom_name(i),
+                (unsigned)hotspot_idiom_runs[i],
+                (unsigned long long)hotspot_idiom_bytes[i]);
+    fprintf(out, "  Wait loops: %u skips (%u at learned heads)\n", (unsigned)hotspot_wait_skips,
+            (unsigned)hotspot_learned_skips);
     for (i = 0; i < 15 && top_idx[i] >= 0; i++)
     {
         int idx = top_idx[i];
-        fprintf(out, "  %2d. PC=%08X  cycles=%10llu  count=%6u  avg=%u\n",
+        int nblocks;
+        uint32_t lines = hotspot_chain_lines(hotspot_table[idx].pc, &nblocks);
+        fprintf(out, "  %2d. PC=%08X  cycles=%10llu  count=%6u  avg=%u  I$=%u lines/%u blocks\n",
                 i + 1,
                 (unsigned)hotspot_table[idx].pc,
                 (unsigned long long)hotspot_table[idx].total_cycles,
                 (unsigned)hotspot_table[idx].count,
-                hotspot_table[idx].count ? (unsigned)(hotspot_table[idx].total_cycles / hotspot_table[idx].count) : 0);
+                hotspot_table[idx].count ? (unsigned)(hotspot_table[idx].total_cycles / hotspot_table[idx].count) : 0,
+                (unsigned)lines, (unsigned)nblocks);
     }
 
     memset(hotspot_table, 0, sizeof(hotspot_table));
@@ -655,8 +1014,10 @@ void jit_hotspot_dump_and_reset(FILE *out)
     hotspot_idle_cycles_skipped = 0;
     hotspot_pidle_skips = 0;
     hotspot_pidle_cycles = 0;
-    hotspot_pzero_skips = 0;
-    hotspot_pzero_bytes = 0;
+    memset(hotspot_idiom_runs, 0, sizeof(hotspot_idiom_runs));
+    memset(hotspot_idiom_bytes, 0, sizeof(hotspot_idiom_bytes));
+    hotspot_wait_skips = 0;
+    hotspot_learned_skips = 0;
 }
 #else
 static inline void hotspot_record(uint32_t pc, uint32_t cycles)
@@ -719,7 +1080,7 @@ static inline void handle_performance_report(void)
             uint32_t speed_pct = (uint32_t)((cycles_per_sec * 100ULL) / PSX_CPU_FREQ);
             uint32_t emu_fps = (uint32_t)((perf_frame_count > 60 ? 60U : (uint32_t)perf_frame_count) * 1000U / elapsed_ms);
 
-            printf("[EMU] Speed: %lu%% | %.1f MHz | ~%lu eFPS | %llu cycles in %lu ms\n",
+            printf("[EMU] Speed: %" PRIu32 "%% | %.1f MHz | ~%" PRIu32 " eFPS | %llu cycles in %" PRIu32 " ms\n",
                    speed_pct, (double)cycles_per_sec / 1000000.0, emu_fps,
                    (unsigned long long)elapsed_cycles, elapsed_ms);
         }
@@ -752,12 +1113,46 @@ void sync_hardware_and_interrupts(void)
     }
 }
 
+/* Interrupt entry from a block exit (irq_entry_trampoline, jit_fast_irq):
+ * the same delivery as sync_hardware_and_interrupts, but the chain keeps
+ * running, so PSX_Exception must not flag a block abort.  Returns 0 when
+ * nothing was taken; the exit then aborts and Run_CPU handles the rest. */
+uint32_t jit_irq_enter(void)
+{
+    uint32_t sr = cpu.cop0[PSX_COP0_SR];
+    uint32_t next_pc = cpu.pc;
+
+    if (!CheckInterrupts() || !(sr & 1) || !(sr & (1 << 10)))
+        return 0;
+    cpu.cop0[PSX_COP0_CAUSE] |= (1 << 10);
+    cpu.irq_pending = 0;
+    cpu.irq_pending_fast = 0;
+    int in_block = psx_block_exception;
+    psx_block_exception = 0;
+    PSX_Exception(0);
+    psx_block_exception = in_block;
+    if (cpu.pc == next_pc)
+        return 0; /* No handler installed: PSX_Exception backed out */
+    sched_interrupt_chain = 0;
+#ifdef ENABLE_DYNAREC_STATS
+    stat_fast_irqs++;
+#endif
+    return 1;
+}
+
+static int boot_snapshot_loaded = 0;
+
 static inline bool handle_bios_boot_hook(uint32_t pc)
 {
     if (__builtin_expect(pc == 0x80030000 || (pc >= 0x001A45A0 && pc <= 0x001A4620), 0))
     {
         DLOG("Reached BIOS Idle Loop (PC=%08X). Loading binary...\n", (unsigned)pc);
         int success = 0;
+        BIOS_HLE_KernelReady();
+        /* The machine as the BIOS left it, for the next boot to start from */
+        if (psx_config.boot_snapshot && !boot_snapshot_loaded &&
+            (psx_boot_mode == BOOT_MODE_ISO || (psx_exe_filename && psx_exe_filename[0] != '\0')))
+            BootSnapshot_Save();
         if (psx_boot_mode == BOOT_MODE_ISO)
             success = (Load_PSX_EXE_FromISO(&cpu) == 0);
         else if (psx_exe_filename && psx_exe_filename[0] != '\0')
@@ -795,25 +1190,29 @@ static void Sched_HBlank_Callback(int ticks_late)
 {
     (void)ticks_late;
     uint32_t remaining = SCANLINES_PER_FRAME - hblank_scanline;
-    uint32_t batch = (remaining < HBLANK_BATCH_SIZE) ? remaining : HBLANK_BATCH_SIZE;
+    uint32_t batch = (remaining < hblank_batch) ? remaining : hblank_batch;
 
     hblank_scanline += batch;
 
     if (hblank_scanline >= SCANLINES_PER_FRAME)
     {
         hblank_scanline = 0;
+        clock_t frame_end = clock();
 
         /* Subsystem profiler: compute PSX cycles for this frame BEFORE resetting */
         uint64_t frame_psx_cycles = global_cycles - hblank_frame_start_cycle;
 
         hblank_frame_start_cycle = global_cycles;
+        GPU_OSDVBlank();
         GPU_Backend_VBlank();
         GTE_VBlankUpdate();
         gpu_pending_vblank_flush = 1;
         SignalInterrupt(0);
+        SIO_VBlank();
         Timer_ScheduleAll();   /* Reschedule timers after VBlank reset */
         SPU_GenerateSamples(); /* Generate remaining audio + submit to audio hw */
         SPU_FrameStart();      /* Reset SPU frame cycle for catch-up */  
+        spec_compile_due = 1;
 
         /* Frame pacing: audio-driven sync via blocking Audio_Backend_Play()
          * in SPU_FlushAudio() above.  The audio hardware clock (44100 Hz)
@@ -822,7 +1221,7 @@ static void Sched_HBlank_Callback(int ticks_late)
          * Legacy busy-wait frame limiter kept as fallback for when audio
          * is disabled or init fails (frame_limit config option). */
 #ifndef PLATFORM_PSP
-        if (psx_config.frame_limit && !SPU_IsInitialized())
+        if (psx_config.frame_limit && !SPU_IsInitialized() && !sched_unlimited_speed)
         {
             uint32_t frame_us = psx_config.region_pal ? FRAME_TIME_PAL_US : FRAME_TIME_NTSC_US;
             uint32_t now_us = (uint32_t)clock();
@@ -831,7 +1230,9 @@ static void Sched_HBlank_Callback(int ticks_late)
             else
             {
                 while ((int32_t)(frame_limit_next_ms - (uint32_t)clock()) > 0)
-                    ; /* busy-wait */
+                {
+                    /* busy-wait */
+                }
                 now_us = (uint32_t)clock();
                 /* If we overshot by more than 2 frames, resync to avoid catch-up burst */
                 if ((int32_t)(now_us - frame_limit_next_ms) > (int32_t)(frame_us * 2))
@@ -842,7 +1243,67 @@ static void Sched_HBlank_Callback(int ticks_late)
         }
 #endif
 
+        /* Threaded audio output: the ring fill replaces the blocking audio
+         * call as the pacing clock.  Anything queued beyond the latency
+         * target is waited out; a short ring lets the frame run at once. */
+        if (psx_config.frame_limit && psx_config.audio_latency && !sched_unlimited_speed)
+        {
+            int rate = SPU_OutputRate();
+            int excess = SPU_OutputQueued() - psx_config.audio_latency * rate / 1000;
+            if (excess > 0)
+            {
+                clock_t until = clock() + (clock_t)((uint64_t)excess * CLOCKS_PER_SEC / rate);
+                while ((int32_t)(until - clock()) > 0)
+                    ;
+            }
+        }
+
+        /* Auto frameskip: a frame that took longer than its VBlank budget
+         * (waiting time excluded), or an audio underrun, gets the next
+         * one's drawing skipped */
+        if (sched_unlimited_speed)
+        {
+            /* Fast-forward: draw one frame in N, paced by nothing */
+            frameskip_run = (frameskip_run + 1 < sched_unlimited_speed) ? frameskip_run + 1 : 0;
+            GPU_SetFrameSkip(frameskip_run != 0);
+            frameskip_start = 0;
+        }
+        else if (psx_config.frameskip)
+        {
+            uint32_t frame_us = psx_config.region_pal ? FRAME_TIME_PAL_US : FRAME_TIME_NTSC_US;
+            clock_t budget = (clock_t)((uint64_t)frame_us * CLOCKS_PER_SEC / 1000000);
+            uint32_t underruns = SPU_OutputUnderruns();
+            int slow = (frameskip_start && frame_end - frameskip_start > budget) ||
+                       underruns != frameskip_underruns;
+            int skip = slow && frameskip_run < psx_config.frameskip;
+            frameskip_underruns = underruns;
+            frameskip_run = skip ? frameskip_run + 1 : 0;
+            GPU_SetFrameSkip(skip);
+            frameskip_start = clock();
+        }
+
         perf_frame_count++;
+        if (psx_config.jit_cache_frames && perf_frame_count == (uint64_t)psx_config.jit_cache_frames)
+            jit_diskcache_save();
+        if (psx_config.cdrom_preload)
+            ISO_PreloadFrame();
+        MCD_Frame();
+        if (psx_config.snapshot_frame)
+        {
+            uint64_t since = perf_frame_count - (uint64_t)psx_config.snapshot_frame;
+            if (since == 0)
+                Snapshot_RequestSave(0);
+            else if (psx_config.snapshot_replay && perf_frame_count > (uint64_t)psx_config.snapshot_frame &&
+                     since % (uint64_t)psx_config.snapshot_replay == 0)
+                Snapshot_RequestLoad(0);
+        }
+        Rewind_Frame();
+        Bench_Frame();
+#ifdef ENABLE_JIT_DUMP
+        jit_sampler_drain();
+#endif
+        timeline_frame();
+        log_ring_drain();
         check_profiling_exit(perf_frame_count);
         handle_performance_report();
 
@@ -851,7 +1312,7 @@ static void Sched_HBlank_Callback(int ticks_late)
 
     /* Re-schedule HBlank */
     uint32_t next_remaining = SCANLINES_PER_FRAME - hblank_scanline;
-    uint32_t next_batch = (next_remaining < HBLANK_BATCH_SIZE) ? next_remaining : HBLANK_BATCH_SIZE;
+    uint32_t next_batch = (next_remaining < hblank_batch) ? next_remaining : hblank_batch;
     hblank_ideal_deadline += (uint64_t)next_batch * cycles_per_hblank_runtime;
 
     if (hblank_ideal_deadline <= global_cycles)
@@ -864,6 +1325,36 @@ static void Sched_HBlank_Callback(int ticks_late)
  *  The JIT Core
  * ================================================================ */
 
+/* Tier-up: recompile a hot tier-0 block at tier 1, with the tier-1
+ * passes, and retarget direct links that still jump into the tier-0
+ * version.  The old code stays in its segment until that segment is
+ * evicted. */
+static uint32_t *dynarec_tier_up(uint32_t pc, BlockEntry *be)
+{
+    be->native = NULL;
+    jit_ht_remove(pc);
+    jit_compile_tier = 1;
+    PROF_PUSH(PROF_JIT_COMPILE);
+    uint32_t *block = compile_block(pc);
+    PROF_POP(PROF_JIT_COMPILE);
+    PROF_COUNT_COMPILE();
+    if (block)
+    {
+        apply_pending_patches(pc, block);
+        jit_relink_target(pc, block);
+        jit_ht_add(pc, block);
+#ifdef ENABLE_DYNAREC_STATS
+        stat_tier_ups++;
+#endif
+    }
+    return block;
+}
+
+static inline int dynarec_block_is_hot(BlockEntry *be)
+{
+    return be->tier == 0 && ++be->hot_count >= psx_config.jit_tier_threshold;
+}
+
 /* Shared dispatch primitive: ensure a compiled block exists for pc.
  * Does: lookup → compile (if miss) → patch → HT populate.
  * Both the emulator's run_jit_chain and the playground's pg_run_jit
@@ -878,9 +1369,14 @@ uint32_t *dynarec_ensure_block(uint32_t pc, BlockEntry **out_be)
         BlockEntry *be = micro_cache[mc_idx].be;
         if (__builtin_expect(be != NULL && be->native != NULL, 1))
         {
+            if (__builtin_expect(dynarec_block_is_hot(be), 0))
+            {
+                uint32_t *hot = dynarec_tier_up(pc, be);
+                if (out_be) *out_be = hot ? be : NULL;
+                return hot;
+            }
             /* Ensure HT is populated for JR/JALR dispatch */
-            uint32_t h = jit_ht_hash(pc);
-            if (jit_ht[h].psx_pc[0] != pc)
+            if (jit_ht_set(pc)[0].psx_pc != pc)
                 jit_ht_add(pc, be->native);
             if (out_be) *out_be = be;
             return be->native;
@@ -890,16 +1386,30 @@ uint32_t *dynarec_ensure_block(uint32_t pc, BlockEntry **out_be)
     BlockEntry *be = lookup_block(pc);
     uint32_t *block = be ? be->native : NULL;
 
+    /* Disk-cached block: first use checks it against RAM */
+    if (block && __builtin_expect(be->disk_pending, 0))
+        block = jit_diskcache_verify(be);
+
+    if (block && __builtin_expect(dynarec_block_is_hot(be), 0))
+        block = dynarec_tier_up(pc, be);
+
     /* Ensure the block is in the hash table for fast JR/JALR dispatch */
     if (block)
     {
-        uint32_t h = jit_ht_hash(pc);
-        if (jit_ht[h].psx_pc[0] != pc)
+        if (jit_ht_set(pc)[0].psx_pc != pc)
             jit_ht_add(pc, block);
     }
 
+    if (!block && jit_interp_count && jit_interp_block(pc))
+    {
+        if (out_be)
+            *out_be = NULL;
+        return NULL; /* Interpreter fallback, see run_jit_chain */
+    }
+
     if (!block)
     {
+        jit_compile_tier = psx_config.jit_tier_threshold > 0 ? 0 : 1;
         PROF_PUSH(PROF_JIT_COMPILE);
         block = compile_block(pc);
         PROF_POP(PROF_JIT_COMPILE);
@@ -909,7 +1419,6 @@ uint32_t *dynarec_ensure_block(uint32_t pc, BlockEntry **out_be)
             be = lookup_block(pc);
             apply_pending_patches(pc, block);
             jit_ht_add(pc, block);
-            jit_flush_pending = 1; /* Deferred: batch with buffer-reset / SMC recompile */
         }
     }
 
@@ -925,6 +1434,385 @@ uint32_t *dynarec_ensure_block(uint32_t pc, BlockEntry **out_be)
     return block;
 }
 
+/* Speculative compile: build branch targets queued by emit_direct_link()
+ * while the PSX is idle, so a new code path does not stall mid-frame on
+ * its first pass.  Targets of these blocks are not queued in turn. */
+int jit_spec_compile_pending(int budget)
+{
+    int built = 0;
+    int saved_tier = jit_compile_tier;
+    while (built < budget && jit_spec_head != jit_spec_tail)
+    {
+        uint32_t pc = jit_spec_queue[jit_spec_head++ & (JIT_SPEC_QUEUE_SIZE - 1)];
+        if (lookup_block_native(pc) || !get_psx_code_ptr(pc) ||
+            (jit_interp_count && jit_interp_block(pc)))
+            continue;
+        jit_compile_tier = psx_config.jit_tier_threshold > 0 ? 0 : 1;
+        jit_spec_compiling = 1;
+        PROF_PUSH(PROF_JIT_COMPILE);
+        uint32_t *block = compile_block(pc);
+        PROF_POP(PROF_JIT_COMPILE);
+        PROF_COUNT_COMPILE();
+        jit_spec_compiling = 0;
+        if (!block)
+            continue;
+        apply_pending_patches(pc, block);
+        jit_ht_add(pc, block);
+        built++;
+#ifdef ENABLE_DYNAREC_STATS
+        stat_spec_compiles++;
+#endif
+    }
+    jit_compile_tier = saved_tier;
+    return built;
+}
+
+/* ================================================================
+ *  Wait-for-value loop detection
+ *
+ *  The block-local idle patterns (is_idle, P-IDLE, the self-loop
+ *  poll_detect_pc skip) only see loops that fit in one block.  Polls of
+ *  GPUSTAT, I_STAT or a RAM flag written by an IRQ handler usually span
+ *  a few blocks (a call to a status getter, a mask, a compare).
+ *
+ *  wait_loop_probe() interprets one iteration starting at a loop head on
+ *  a copy of the register file, reading only inputs that can change at a
+ *  scheduler event: RAM, scratchpad, BIOS, and shadows of I_STAT, I_MASK
+ *  and an idle GPUSTAT (the value the JIT fast path returns).  Timers,
+ *  stores, HI/LO writes and coprocessor ops reject the loop.  If the
+ *  iteration returns to the head with every GPR unchanged, the loop is
+ *  at a fixed point and will spin until the next event.
+ * ================================================================ */
+#define WAIT_LOOP_MAX_INSNS 64
+
+static uint32_t wait_loop_pc = 0;
+
+static int wait_loop_read(uint32_t addr, int size, uint32_t *out)
+{
+    if ((addr & (size - 1)) || addr >= 0xC0000000)
+        return 0;
+    uint32_t phys = addr & 0x1FFFFFFF;
+    const uint8_t *p;
+    uint32_t word;
+
+    if (phys < 0x00800000)
+        p = psx_ram + (phys & (PSX_RAM_SIZE - 1));
+    else if (phys >= 0x1F800000 && phys < 0x1F800400)
+        p = scratchpad_buf + (phys - 0x1F800000);
+    else if (phys >= 0x1FC00000 && phys < 0x1FC00000 + PSX_BIOS_SIZE)
+        p = psx_bios + (phys - 0x1FC00000);
+    else
+    {
+        switch (phys & ~3u)
+        {
+        case 0x1F801070: /* I_STAT */
+            word = cpu.i_stat;
+            break;
+        case 0x1F801074: /* I_MASK */
+            word = cpu.i_mask;
+            break;
+        case 0x1F801814: /* GPUSTAT: only while idle (busy ends on time, not an event) */
+            if (gpu_busy_until || gpu_gp0_fifo.count)
+                return 0;
+            word = gpu_stat | 0x14002000;
+            if ((word >> 29) & 3)
+                word |= 0x02000000;
+            break;
+        default:
+            return 0;
+        }
+        word >>= (phys & 3) * 8;
+        *out = size == 4 ? word : size == 2 ? (word & 0xFFFF) : (word & 0xFF);
+        return 1;
+    }
+
+    if (size == 4)
+        *out = *(const uint32_t *)p;
+    else if (size == 2)
+        *out = *(const uint16_t *)p;
+    else
+        *out = *p;
+    return 1;
+}
+
+static int wait_loop_probe(uint32_t head)
+{
+    uint32_t r[32];
+    uint32_t pc = head;
+    uint32_t branch_to = 0;
+    int in_delay = 0;
+    int n;
+
+    memcpy(r, cpu.regs, sizeof(r));
+    for (n = 0; n < WAIT_LOOP_MAX_INSNS; n++)
+    {
+        uint32_t phys = pc & 0x1FFFFFFF;
+        uint32_t op;
+        if (phys < PSX_RAM_SIZE)
+            op = *(const uint32_t *)(psx_ram + phys);
+        else if (phys >= 0x1FC00000 && phys < 0x1FC00000 + PSX_BIOS_SIZE)
+            op = *(const uint32_t *)(psx_bios + (phys - 0x1FC00000));
+        else
+            return 0;
+
+        int rs = RS(op), rt = RT(op), rd = RD(op);
+        uint32_t a = r[rs], b = r[rt];
+        uint32_t imm = (uint32_t)(int32_t)SIMM16(op);
+        int dst = 0, is_branch = 0, taken = 0;
+        uint32_t val = 0, target = 0;
+
+        switch (OP(op))
+        {
+        case 0x00:
+            dst = rd;
+            switch (FUNC(op))
+            {
+            case 0x00: val = b << SA(op); break;
+            case 0x02: val = b >> SA(op); break;
+            case 0x03: val = (uint32_t)((int32_t)b >> SA(op)); break;
+            case 0x04: val = b << (a & 31); break;
+            case 0x06: val = b >> (a & 31); break;
+            case 0x07: val = (uint32_t)((int32_t)b >> (a & 31)); break;
+            case 0x08: /* JR */
+                dst = 0;
+                is_branch = taken = 1;
+                target = a;
+                break;
+            case 0x09: /* JALR */
+                val = pc + 8;
+                is_branch = taken = 1;
+                target = a;
+                break;
+            case 0x10: val = cpu.hi; break;
+            case 0x12: val = cpu.lo; break;
+            case 0x20: /* ADD: an overflow trap is not a spin */
+                val = a + b;
+                if (~(a ^ b) & (a ^ val) & 0x80000000)
+                    return 0;
+                break;
+            case 0x21: val = a + b; break;
+            case 0x22:
+                val = a - b;
+                if ((a ^ b) & (a ^ val) & 0x80000000)
+                    return 0;
+                break;
+            case 0x23: val = a - b; break;
+            case 0x24: val = a & b; break;
+            case 0x25: val = a | b; break;
+            case 0x26: val = a ^ b; break;
+            case 0x27: val = ~(a | b); break;
+            case 0x2A: val = (int32_t)a < (int32_t)b; break;
+            case 0x2B: val = a < b; break;
+            default:
+                return 0; /* SYSCALL, BREAK, MULT/DIV, MTHI/MTLO */
+            }
+            break;
+        case 0x01: /* REGIMM */
+            if ((rt & 0x1E) != 0 && (rt & 0x1E) != 0x10)
+                return 0;
+            is_branch = 1;
+            taken = (rt & 1) ? (int32_t)a >= 0 : (int32_t)a < 0;
+            target = pc + 4 + (imm << 2);
+            if (rt & 0x10)
+            {
+                dst = 31;
+                val = pc + 8;
+            }
+            break;
+        case 0x02:
+        case 0x03:
+            is_branch = taken = 1;
+            target = ((pc + 4) & 0xF0000000) | (TARGET(op) << 2);
+            if (OP(op) == 0x03)
+            {
+                dst = 31;
+                val = pc + 8;
+            }
+            break;
+        case 0x04: is_branch = 1; taken = a == b; target = pc + 4 + (imm << 2); break;
+        case 0x05: is_branch = 1; taken = a != b; target = pc + 4 + (imm << 2); break;
+        case 0x06: is_branch = 1; taken = (int32_t)a <= 0; target = pc + 4 + (imm << 2); break;
+        case 0x07: is_branch = 1; taken = (int32_t)a > 0; target = pc + 4 + (imm << 2); break;
+        case 0x08:
+            val = a + imm;
+            if (~(a ^ imm) & (a ^ val) & 0x80000000)
+                return 0;
+            dst = rt;
+            break;
+        case 0x09: dst = rt; val = a + imm; break;
+        case 0x0A: dst = rt; val = (int32_t)a < (int32_t)imm; break;
+        case 0x0B: dst = rt; val = a < imm; break;
+        case 0x0C: dst = rt; val = a & IMM16(op); break;
+        case 0x0D: dst = rt; val = a | IMM16(op); break;
+        case 0x0E: dst = rt; val = a ^ IMM16(op); break;
+        case 0x0F: dst = rt; val = IMM16(op) << 16; break;
+        case 0x20: /* LB */
+        case 0x21: /* LH */
+        case 0x23: /* LW */
+        case 0x24: /* LBU */
+        case 0x25: /* LHU */
+        {
+            int size = (OP(op) & 3) == 3 ? 4 : (OP(op) & 1) ? 2 : 1;
+            if (!wait_loop_read(a + imm, size, &val))
+                return 0;
+            if (OP(op) == 0x20)
+                val = (uint32_t)(int32_t)(int8_t)val;
+            else if (OP(op) == 0x21)
+                val = (uint32_t)(int32_t)(int16_t)val;
+            dst = rt;
+            break;
+        }
+        default:
+            return 0; /* stores, LWL/LWR, COPz */
+        }
+
+        if (is_branch && in_delay)
+            return 0;
+        if (dst)
+            r[dst] = val;
+
+        if (in_delay)
+        {
+            pc = branch_to;
+            in_delay = 0;
+        }
+        else if (is_branch)
+        {
+            branch_to = taken ? target : pc + 8;
+            in_delay = 1;
+            pc += 4;
+            continue;
+        }
+        else
+            pc += 4;
+
+        if (pc == head)
+            return memcmp(r, cpu.regs, sizeof(r)) == 0;
+    }
+    return 0;
+}
+
+/* ================================================================
+ *  Learned idle loops (jit_idle_learn)
+ *
+ *  wait_loop_pc only catches a wait loop once a chain has spun in it
+ *  for a whole budget, and games come back into their VSync, CD and pad
+ *  waits through native links every frame.  A head found that way
+ *  jit_idle_learn times is learned: it joins the interpreter set, so
+ *  every path into it returns to run_jit_chain, which probes it first
+ *  and skips to the next event while the loop still waits.  A pass that
+ *  does make progress costs one interpreted basic block.  Learned heads
+ *  are saved per game and loaded before the first frame of the next boot.
+ * ================================================================ */
+#define IDLE_LEARN_MAX 32
+#define IDLE_LEARN_CANDIDATES 16
+
+static uint32_t idle_learned_pcs[IDLE_LEARN_MAX];
+static int idle_learned_count = 0;
+static struct
+{
+    uint32_t pc;
+    uint32_t hits;
+} idle_candidates[IDLE_LEARN_CANDIDATES];
+
+static void idle_learn_path(char *buf, size_t len)
+{
+    if (psx_config.game_id[0])
+    {
+        snprintf(buf, len, "idle_%s.txt", psx_config.game_id);
+        return;
+    }
+    const char *name = (psx_exe_filename && psx_exe_filename[0]) ? psx_exe_filename : "bios";
+    uint32_t hash = 5381;
+    while (*name)
+        hash = (hash << 5) + hash + (uint8_t)*name++;
+    snprintf(buf, len, "idle_%08X.txt", (unsigned)hash);
+}
+
+static int idle_learned(uint32_t pc)
+{
+    for (int i = 0; i < idle_learned_count; i++)
+        if (idle_learned_pcs[i] == pc)
+            return 1;
+    return 0;
+}
+
+static void idle_learn_save(void)
+{
+    char path[64];
+    idle_learn_path(path, sizeof(path));
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        printf("JITIDLE: cannot create %s\n", path);
+        return;
+    }
+    for (int i = 0; i < idle_learned_count; i++)
+        fprintf(f, "%08X\n", (unsigned)idle_learned_pcs[i]);
+    fclose(f);
+}
+
+static int idle_learn_add(uint32_t pc)
+{
+    if (idle_learned_count >= IDLE_LEARN_MAX || (pc & 3) || idle_learned(pc))
+        return 0;
+    idle_learned_pcs[idle_learned_count++] = pc;
+    jit_interp_add(pc);
+    return 1;
+}
+
+/* A chain spent its budget in the wait loop at pc */
+static void idle_learn_note(uint32_t pc)
+{
+    int slot = 0;
+    if (idle_learned(pc))
+        return;
+    for (int i = 0; i < IDLE_LEARN_CANDIDATES; i++)
+    {
+        if (idle_candidates[i].pc == pc)
+        {
+            slot = i;
+            break;
+        }
+        if (idle_candidates[i].hits < idle_candidates[slot].hits)
+            slot = i;
+    }
+    if (idle_candidates[slot].pc != pc)
+    {
+        idle_candidates[slot].pc = pc;
+        idle_candidates[slot].hits = 0;
+    }
+    if (++idle_candidates[slot].hits < (uint32_t)psx_config.jit_idle_learn)
+        return;
+    idle_candidates[slot].pc = 0;
+    idle_candidates[slot].hits = 0;
+    if (idle_learn_add(pc))
+    {
+        printf("JITIDLE: learned wait loop at %08X\n", (unsigned)pc);
+        idle_learn_save();
+    }
+}
+
+static void idle_learn_load(void)
+{
+    char path[64], line[32];
+    int n = 0;
+
+    idle_learn_path(path, sizeof(path));
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return;
+    while (fgets(line, sizeof(line), f))
+    {
+        char *end;
+        unsigned long pc = strtoul(line, &end, 16);
+        if (end != line)
+            n += idle_learn_add((uint32_t)pc);
+    }
+    fclose(f);
+    printf("JITIDLE: %d wait loops from %s\n", n, path);
+}
+
 int run_jit_chain(uint64_t deadline)
 {
     uint32_t pc = cpu.pc;
@@ -942,8 +1830,8 @@ int run_jit_chain(uint64_t deadline)
         {
             poll_patched_addr[0] = poll_patched_saved[0];
             poll_patched_addr[1] = poll_patched_saved[1];
+            jit_mark_dirty(poll_patched_addr, poll_patched_addr + 2);
             poll_patched_addr = NULL;
-            jit_flush_pending = 1;
         }
         poll_detect_pc = 0;
         /* Clamp skip to nearest scheduler event so we never leap
@@ -962,6 +1850,29 @@ int run_jit_chain(uint64_t deadline)
         return RUN_RES_BREAK;
     }
 
+    /* Wait-for-value skip: re-probe the loop found on the last exit.  As
+     * long as one iteration still reaches its fixed point, the inputs
+     * have not changed and no native pass is needed to see that. */
+    if (__builtin_expect(pc == wait_loop_pc, 0))
+    {
+        if (!DMA_IsPending() && wait_loop_probe(pc))
+        {
+            uint64_t skip_target = deadline;
+            if (sched_cached_earliest < skip_target)
+                skip_target = sched_cached_earliest;
+            if (skip_target > global_cycles)
+            {
+#ifdef ENABLE_SUBSYSTEM_PROFILER
+                hotspot_wait_skips++;
+                hotspot_idle_cycles_skipped += (skip_target - global_cycles);
+#endif
+                global_cycles = skip_target;
+            }
+            return RUN_RES_BREAK;
+        }
+        wait_loop_pc = 0;
+    }
+
     /* Address Error on misaligned PC (AdEL — instruction fetch from bad addr).
      * cpu.current_pc holds the JR/JALR source instruction address. */
     if (__builtin_expect(pc & 3, 0))
@@ -993,13 +1904,7 @@ int run_jit_chain(uint64_t deadline)
             static uint16_t smc_ht_flushed_epoch = 0;
             if (smc_ht_flushed_epoch != smc_page_epoch)
             {
-                for (int i = 0; i < JIT_HT_SIZE; i++)
-                {
-                    jit_ht[i].psx_pc[0] = 0xFFFFFFFF;
-                    jit_ht[i].psx_pc[1] = 0xFFFFFFFF;
-                    jit_ht[i].native[0] = NULL;
-                    jit_ht[i].native[1] = NULL;
-                }
+                jit_ht_flush();
                 micro_cache_flush();
                 smc_ht_flushed_epoch = smc_page_epoch;
             }
@@ -1017,17 +1922,16 @@ int run_jit_chain(uint64_t deadline)
             uint32_t *opcodes = get_psx_code_ptr(pc);
             if (opcodes)
             {
-                uint32_t hash = 0;
-                for (uint32_t i = 0; i < be->instr_count; i++)
-                    hash = (hash << 5) + hash + opcodes[i];
+                uint32_t hash = jit_block_hash(be, opcodes);
                 if (hash != be->code_hash)
                 {
-                    be->native = NULL;
                     /* Clear stale hash table entry to prevent dispatch
                      * trampoline from jumping to invalidated code */
                     jit_ht_remove(pc);
+                    block_node_free(be);
                     block = NULL;
                     be = NULL;
+                    jit_interp_note_smc(pc);
                     /* Recompile via shared primitive */
                     block = dynarec_ensure_block(pc, &be);
                 }
@@ -1035,11 +1939,41 @@ int run_jit_chain(uint64_t deadline)
                 {
                     /* Code unchanged — update page_gen to skip future hashes */
                     be->page_gen = jit_get_page_gen(phys);
+                    jit_code_map_mark(pc, be->instr_count);
                 }
             }
         }
     }
 
+    if (!block && jit_interp_count && jit_interp_block(pc))
+    {
+        /* Learned wait loop still at its fixed point: skip to the event */
+        if (idle_learned_count && idle_learned(pc) && !DMA_IsPending() && wait_loop_probe(pc))
+        {
+            uint64_t skip_target = deadline;
+            if (sched_cached_earliest < skip_target)
+                skip_target = sched_cached_earliest;
+            if (skip_target > global_cycles)
+            {
+#ifdef ENABLE_SUBSYSTEM_PROFILER
+                hotspot_learned_skips++;
+                hotspot_idle_cycles_skipped += (skip_target - global_cycles);
+#endif
+                global_cycles = skip_target;
+            }
+            return RUN_RES_BREAK;
+        }
+        /* Left to the interpreter: one basic block, then back to native
+         * dispatch.  No chain is running, so EFFECTIVE_CYCLES must not
+         * see a stale chain budget. */
+        cpu.initial_cycles_left = 0;
+        cpu.cycles_left = 0;
+        partial_block_cycles = 0;
+        run_interpreter_block();
+        run_iterations++;
+        return RUN_RES_NORMAL;
+    }
+
     if (!block)
     {
         DLOG("IBE at %08X\n", (unsigned)pc);
@@ -1048,6 +1982,10 @@ int run_jit_chain(uint64_t deadline)
         return RUN_RES_NORMAL;
     }
 
+    /* The last chain left through an inline cache miss: fill the site */
+    if (__builtin_expect(jit_ic_miss[0] != 0, 0))
+        jit_ic_fill(pc, block);
+
     /* Execute block / chain */
     int32_t cycles_left = (int32_t)(deadline - global_cycles);
     if (cycles_left < 0)
@@ -1056,16 +1994,12 @@ int run_jit_chain(uint64_t deadline)
     cpu.initial_cycles_left = cycles_left;
     cpu.cycles_left = cycles_left;
     cpu.cycles_left_correction = 0;
-    /* Batch FlushCache: flush D-cache + invalidate I-cache once before
-     * executing any recently compiled/patched code.  This batches the
-     * buffer-reset flush with the first compile, and deduplicates
+    /* Batch cache upkeep: write back D-cache + invalidate I-cache once
+     * before executing any recently compiled/patched code.  This batches
+     * the buffer-reset flush with the first compile, and deduplicates
      * flushes when SMC triggers a recompile in the same chain call. */
     if (__builtin_expect(jit_flush_pending, 0))
-    {
-        Platform_FlushDCache(NULL, NULL);
-        Platform_FlushICache();
-        jit_flush_pending = 0;
-    }
+        jit_cache_sync();
 
     psx_block_exception = 1;
     PROF_PUSH(PROF_JIT_EXEC);
@@ -1098,6 +2032,9 @@ int run_jit_chain(uint64_t deadline)
     global_cycles += cycles_taken;
     partial_block_cycles = 0; /* Reset mid-block cycle offset */
 
+    /* GP0 port words still buffered by the chain (jit_gp0_fifo) */
+    GPU_GP0FifoSync();
+
     hotspot_record(pc, cycles_taken);
 
     if (be)
@@ -1200,9 +2137,14 @@ int run_jit_chain(uint64_t deadline)
                 {
                     poll_patched_addr[0] = poll_patched_saved[0];
                     poll_patched_addr[1] = poll_patched_saved[1];
+                    jit_mark_dirty(poll_patched_addr, poll_patched_addr + 2);
                     poll_patched_addr = NULL;
-                    jit_flush_pending = 1;
                 }
+                /* Host time the skip freed up: pre-build queued targets
+                 * and translate queued GP0 chains (gpu_queue) */
+                jit_spec_compile_pending(psx_config.jit_spec_compile);
+                if (gpu_queue_pending)
+                    GPU_Backend_QueueDrain();
                 idle_skip_count = 0;
                 return RUN_RES_BREAK;
             }
@@ -1213,40 +2155,24 @@ int run_jit_chain(uint64_t deadline)
         idle_skip_count = 0;
     }
 
-    /* P-ZERO: Zero-fill pattern optimization.
-     * If the block is a SW $zero loop that self-looped, complete the
-     * remaining zeroing with memset and advance time mathematically.
-     * Must run BEFORE poll detection to prevent the zero-fill loop
-     * from being mistakenly patched as a polling loop. */
-    if (__builtin_expect(be && be->block_pattern == 1 && cpu.pc == pc && !DMA_IsPending(), 0))
+    /* Loop idioms (P-FILL/P-COPY/P-SUM/P-SCAN, dynarec_idiom.c).
+     * If the block is an idiom loop that self-looped, finish the
+     * remaining iterations in C and charge their cycles.
+     * Must run BEFORE poll detection to prevent the loop from being
+     * mistakenly patched as a polling loop. */
+    if (__builtin_expect(be && be->block_pattern && cpu.pc == pc && !DMA_IsPending(), 0))
     {
-        uint32_t base = cpu.regs[be->pattern_base_reg];
-        uint32_t limit = cpu.regs[be->pattern_limit_reg];
-        uint32_t phys_base = base & 0x1FFFFFFF;
-        uint32_t phys_limit = limit & 0x1FFFFFFF;
-        /* Validate: both in RAM, base < limit, reasonable size */
-        if (phys_base < PSX_RAM_SIZE && phys_limit <= PSX_RAM_SIZE &&
-            phys_base < phys_limit && (phys_limit - phys_base) <= PSX_RAM_SIZE)
+        uint64_t cycles_before = global_cycles;
+        uint32_t bytes = 0;
+        if (jit_idiom_run(be, &bytes))
         {
-            uint32_t size = phys_limit - phys_base;
-            memset(psx_ram + phys_base, 0, size);
-            /* SMC notification: bump page generation for affected pages */
-            uint32_t page_start = phys_base >> 12;
-            uint32_t page_end = (phys_limit - 1) >> 12;
-            for (uint32_t pg = page_start; pg <= page_end; pg++)
-                jit_smc_handler(pg << 12);
-            /* Update registers: base = limit (loop completed) */
-            cpu.regs[be->pattern_base_reg] = limit;
-            cpu.pc = pc + be->instr_count * 4;
-            /* Account for cycles */
-            uint32_t words = size / 4;
-            global_cycles += (uint64_t)words * be->cycle_count;
 #ifdef ENABLE_SUBSYSTEM_PROFILER
             hotspot_idle_skips++;
-            hotspot_idle_cycles_skipped += (uint64_t)words * be->cycle_count;
-            hotspot_pzero_skips++;
-            hotspot_pzero_bytes += size;
+            hotspot_idle_cycles_skipped += global_cycles - cycles_before;
+            hotspot_idiom_runs[be->block_pattern]++;
+            hotspot_idiom_bytes[be->block_pattern] += bytes;
 #endif
+            (void)cycles_before;
             return RUN_RES_BREAK;
         }
         /* Validation failed: fall through to normal poll detection */
@@ -1271,11 +2197,15 @@ int run_jit_chain(uint64_t deadline)
          * DBL, it will immediately exit instead of executing the loop. */
         if (!poll_patched_addr && be && be->native)
         {
-            uint32_t *entry = be->native + DYNAREC_PROLOGUE_WORDS;
+            /* Patch past the const guard and slot loads: fast-entry
+             * links land there */
+            uint32_t *entry = be->native + DYNAREC_PROLOGUE_WORDS + be->const_guard_words +
+                              dyn_entry_load_words(be->slot_entry_loaded);
             poll_patched_saved[0] = entry[0];
             poll_patched_saved[1] = entry[1];
             entry[0] = MK_J(2, (uint32_t)abort_trampoline_addr >> 2);
             entry[1] = 0; /* NOP in delay slot */
+            jit_mark_dirty(entry, entry + 2);
             poll_patched_addr = entry;
         }
     }
@@ -1286,11 +2216,22 @@ int run_jit_chain(uint64_t deadline)
         {
             poll_patched_addr[0] = poll_patched_saved[0];
             poll_patched_addr[1] = poll_patched_saved[1];
+            jit_mark_dirty(poll_patched_addr, poll_patched_addr + 2);
             poll_patched_addr = NULL;
         }
         poll_detect_pc = 0;
     }
 
+    /* A chain that used its whole budget and stopped somewhere else may
+     * be spinning in a multi-block wait loop: probe the PC it stopped at. */
+    if (__builtin_expect(remaining <= 0 && cpu.pc != pc, 0) && !DMA_IsPending() &&
+        wait_loop_probe(cpu.pc))
+    {
+        wait_loop_pc = cpu.pc;
+        if (psx_config.jit_idle_learn)
+            idle_learn_note(cpu.pc);
+    }
+
     return RUN_RES_NORMAL;
 }
 
@@ -1315,7 +2256,11 @@ void Run_CPU(void)
     perf_last_report_tick = get_wall_ms();
     cycles_per_hblank_runtime = psx_config.region_pal ? CYCLES_PER_HBLANK_PAL : CYCLES_PER_HBLANK_NTSC;
     hblank_frame_start_cycle = global_cycles;
-    hblank_ideal_deadline = global_cycles + HBLANK_BATCH_SIZE * cycles_per_hblank_runtime;
+    /* Only the VBlank at the end of the frame does work; the timers derive
+     * HBlank counts and phases from hblank_frame_start_cycle, so lazy mode
+     * drops the mid-frame events */
+    hblank_batch = psx_config.hblank_lazy ? SCANLINES_PER_FRAME : HBLANK_BATCH_SIZE;
+    hblank_ideal_deadline = global_cycles + hblank_batch * cycles_per_hblank_runtime;
     Sched_Add(SCHED_EVENT_HBLANK, hblank_ideal_deadline, Sched_HBlank_Callback);
 
     Timer_ScheduleAll();
@@ -1325,6 +2270,13 @@ void Run_CPU(void)
     prof_disable_gpu_render = psx_config.disable_gpu;
     profiler_init();
 
+    GTE_VBlankUpdate(); /* GTE tier for the first frame's blocks */
+    if (psx_config.jit_cache_frames)
+        jit_diskcache_load();
+    /* After the disk cache: learning a head drops any block loaded there */
+    if (psx_config.jit_idle_learn)
+        idle_learn_load();
+
     binary_loaded = 0;
     static uint32_t bios_trace_count = 0;
     static uint32_t bios_last_pc = 0;
@@ -1338,6 +2290,11 @@ void Run_CPU(void)
      * within one chain latency.
      * ================================================================ */
 
+    /* Boot snapshot: resume at the exe-load hook, where the snapshot was
+     * taken, so the loop below goes straight to loading the binary */
+    if (psx_config.boot_snapshot && !psx_config.boot_bios_only && BootSnapshot_Load() == 0)
+        boot_snapshot_loaded = 1;
+
     printf("DYNAREC: Phase 1 - BIOS Booting...\n");
     while (!binary_loaded)
     {
@@ -1382,6 +2339,11 @@ void Run_CPU(void)
         sync_hardware_and_interrupts();
     }
 
+    if (psx_config.snapshot_frame)
+        Snapshot_Init(1);
+    if (psx_config.rewind_buffer)
+        Rewind_Init((uint32_t)psx_config.rewind_buffer << 20);
+
     printf("DYNAREC: Phase 2 - Main Execution...\n");
     while (true)
     {
@@ -1403,5 +2365,13 @@ void Run_CPU(void)
 
         sched_interrupt_chain = 0;
         sync_hardware_and_interrupts();
+        if (spec_compile_due)
+        {
+            spec_compile_due = 0;
+            if (!psx_config.interpreter)
+                jit_spec_compile_pending(psx_config.jit_spec_compile);
+        }
+        if (snapshot_pending)
+            Snapshot_Service();
     }
 }
@@ -0,0 +1,174 @@
+/*
+ * dynarec_sampler.c - Statistical PC sampler for JIT code
+ *
+ * hotspot_record() credits a whole linked chain to the block that
+ * entered it.  This samples the host PC instead: a platform timer
+ * interrupt (Platform_SampleStart) pushes the interrupted EPC into a
+ * ring, and jit_sampler_drain() maps each one back to the BlockEntry
+ * whose native code contains it, counting into be->sample_count.  The
+ * counts go out with the JIT dump (jit_dump_blocks), so
+ * tools/jit_deep_analyze.py can print a flat profile of emulated code.
+ *
+ * Native addresses are resolved through an owner table with one slot
+ * per SAMPLE_GRANULE words of the code buffer, holding the block that
+ * starts last among those touching the granule.  A PC in front of that
+ * block belongs to the one covering the granule before.  The table is
+ * rebuilt from the node pool whenever a lookup misses, so compiles,
+ * evictions and disk cache loads need no hooks; every hit is checked
+ * against the block's live range.
+ */
+#include "dynarec.h"
+#include "config.h"
+#include "platform.h"
+
+#ifdef ENABLE_JIT_DUMP
+
+#define SAMPLE_RING_SIZE 1024 /* power of 2 */
+#define SAMPLE_GRANULE_SHIFT 4 /* 16 words */
+#define SAMPLE_GRANULES ((code_buffer_size / 4) >> SAMPLE_GRANULE_SHIFT)
+
+static volatile uint32_t sample_ring[SAMPLE_RING_SIZE];
+static volatile uint32_t sample_head, sample_tail;
+static volatile uint32_t sample_dropped; /* Ring full at interrupt time */
+
+static BlockEntry **sample_owner;
+static uint32_t sample_owner_built = 0xFFFFFFFF; /* jit_compile_total at last rebuild */
+
+/* Totals since jit_sampler_start */
+static uint32_t sample_total, sample_host, sample_tramp, sample_lost;
+
+/* Interrupt context: no allocation, nothing TLB-mapped */
+static void sampler_irq(uintptr_t pc)
+{
+    uint32_t h = sample_head;
+    if (h - sample_tail >= SAMPLE_RING_SIZE)
+    {
+        sample_dropped++;
+        return;
+    }
+    sample_ring[h & (SAMPLE_RING_SIZE - 1)] = (uint32_t)pc;
+    sample_head = h + 1;
+}
+
+static void sampler_build_owner(void)
+{
+    memset(sample_owner, 0, SAMPLE_GRANULES * sizeof(BlockEntry *));
+    for (int i = 0; i < block_node_pool_idx; i++)
+    {
+        BlockEntry *be = &block_node_pool[i];
+        if (!be->native || !be->native_count)
+            continue;
+        uint32_t g0 = (uint32_t)(be->native - code_buffer) >> SAMPLE_GRANULE_SHIFT;
+        uint32_t g1 = (uint32_t)(be->native + be->native_count - 1 - code_buffer) >> SAMPLE_GRANULE_SHIFT;
+        for (uint32_t g = g0; g <= g1 && g < SAMPLE_GRANULES; g++)
+            if (!sample_owner[g] || sample_owner[g]->native < be->native)
+                sample_owner[g] = be;
+    }
+    sample_owner_built = jit_compile_total;
+}
+
+static inline int sampler_covers(const BlockEntry *be, const uint32_t *p)
+{
+    return be && be->native && p >= be->native && p < be->native + be->native_count;
+}
+
+static BlockEntry *sampler_lookup(const uint32_t *p)
+{
+    uint32_t g = (uint32_t)(p - code_buffer) >> SAMPLE_GRANULE_SHIFT;
+    if (sampler_covers(sample_owner[g], p))
+        return sample_owner[g];
+    if (g > 0 && sampler_covers(sample_owner[g - 1], p))
+        return sample_owner[g - 1];
+    return NULL;
+}
+
+void jit_sampler_start(void)
+{
+    if (psx_config.jit_sample_hz <= 0 || sample_owner)
+        return;
+    sample_owner = (BlockEntry **)malloc(SAMPLE_GRANULES * sizeof(BlockEntry *));
+    if (!sample_owner)
+    {
+        printf("[JIT SAMPLE] Out of memory for the owner table\n");
+        return;
+    }
+    memset(sample_owner, 0, SAMPLE_GRANULES * sizeof(BlockEntry *));
+    if (Platform_SampleStart((uint32_t)psx_config.jit_sample_hz, sampler_irq) < 0)
+    {
+        printf("[JIT SAMPLE] No sampling timer on this platform\n");
+        free(sample_owner);
+        sample_owner = NULL;
+        return;
+    }
+    printf("[JIT SAMPLE] Sampling host PC at %d Hz\n", psx_config.jit_sample_hz);
+}
+
+void jit_sampler_drain(void)
+{
+    if (!sample_owner)
+        return;
+    uint32_t t = sample_tail, h = sample_head;
+    const uint32_t *code_end = code_buffer + code_buffer_size / 4;
+
+    for (; t != h; t++)
+    {
+        const uint32_t *p = (const uint32_t *)(uintptr_t)sample_ring[t & (SAMPLE_RING_SIZE - 1)];
+        sample_total++;
+        if (p < code_buffer || p >= code_end)
+        {
+            sample_host++; /* C code: interpreter, GPU, SPU, scheduler... */
+            continue;
+        }
+        if (p < code_buffer + CODE_TRAMPOLINE_WORDS)
+        {
+            sample_tramp++;
+            continue;
+        }
+        BlockEntry *be = sampler_lookup(p);
+        if (!be && sample_owner_built != jit_compile_total)
+        {
+            sampler_build_owner();
+            be = sampler_lookup(p);
+        }
+        if (be)
+            be->sample_count++;
+        else
+            sample_lost++; /* Block evicted since, or beyond the owner table's reach */
+    }
+    sample_tail = t;
+}
+
+void jit_sampler_stop(void)
+{
+    if (!sample_owner)
+        return;
+    Platform_SampleStop();
+    jit_sampler_drain();
+    free(sample_owner);
+    sample_owner = NULL;
+}
+
+/* Appended to the JIT dump after the blocks: "JSMP", then the totals,
+ * then one sample count per block in dump order */
+void jit_sampler_write(FILE *f)
+{
+    uint32_t hdr[5] = {sample_total, sample_host, sample_tramp, sample_lost, sample_dropped};
+
+    fwrite("JSMP", 1, 4, f);
+    fwrite(hdr, sizeof(uint32_t), 5, f);
+    for (int i = 0; i < block_node_pool_idx; i++)
+    {
+        BlockEntry *be = &block_node_pool[i];
+        if (be->native != NULL)
+            fwrite(&be->sample_count, sizeof(uint32_t), 1, f);
+    }
+    if (sample_total)
+        printf("[JIT SAMPLE] %u samples: %.1f%% JIT blocks, %.1f%% host C, %.1f%% trampolines,"
+               " %u unresolved, %u dropped\n",
+               (unsigned)sample_total,
+               (sample_total - sample_host - sample_tramp - sample_lost) * 100.0 / sample_total,
+               sample_host * 100.0 / sample_total, sample_tramp * 100.0 / sample_total,
+               (unsigned)sample_lost, (unsigned)sample_dropped);
+}
+
+#endif /* ENABLE_JIT_DUMP */
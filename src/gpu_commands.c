@@ -13,6 +13,8 @@
 #include "gpu_trace.h"
 #include "osd.h"
 #include "config.h"
+#include "scheduler.h"
+#include "savestate.h"
 #include <time.h>
 
 /* ── Command size lookup table (256 entries, O(1)) ───────────────── */
@@ -349,39 +351,416 @@ void clear_gpu_param_cache(void)
     cache_gp1_08 = 0xFFFFFFFF;
 }
 
+/* A GP0(E1h) that only toggles dithering needs no GS state reset and
+ * no batch flush: dithering is a per sub-PRIM attribute on PS2 */
+int GPU_E1DitherOnly(uint32_t data)
+{
+    return (data ^ cache_e1) == 0x200;
+}
+
+/* ── Frameskip ───────────────────────────────────────────────────── */
+/* While gpu_skip_frame is set, polygons / rectangles / lines are dropped
+ * after their state side effects; FillRect, transfers and copies still
+ * run so VRAM contents stay correct.  A display flip issued in a skipped
+ * frame would show a half-stale buffer, so GP1(05) is held back until the
+ * next drawn frame flips again (or ends without flipping). */
+int gpu_skip_frame = 0;
+static int skip_disp_pending = 0;
+static uint32_t skip_disp_data;
+
+static void gpu_display_start(uint32_t data)
+{
+    if (data != cache_gp1_05)
+    {
+        cache_gp1_05 = data;
+        uint32_t x = data & 0x3FF;
+        uint32_t y = (data >> 10) & 0x1FF;
+        display_start_x = x;
+        display_start_y = y;
+#ifdef TEX_DEBUG_OVERLAY
+        printf("[DISP] GP1(05) display_start=(%u,%u)\n", x, y);
+#endif
+
+        GPU_Backend_SetDisplayFB(x, y);
+    }
+}
+
+void GPU_SetFrameSkip(int skip)
+{
+    /* A drawn frame ended without a flip of its own: show the one held back */
+    if (!gpu_skip_frame && skip_disp_pending)
+    {
+        skip_disp_pending = 0;
+        gpu_display_start(skip_disp_data);
+    }
+    gpu_skip_frame = skip;
+    if (skip)
+        gpu_frame_stats.skipped_frames++;
+}
+
+/* ── Save state ──────────────────────────────────────────────────── */
+/* VRAM goes through the shadow: a save reads back the tiles the GS drew
+ * since the last readback, a load uploads the whole shadow and drops
+ * every cache derived from the old contents, then re-applies the
+ * display and drawing environment from the restored registers. */
+void GPU_State(StateIO *io)
+{
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
+    if (gpu_readback_pending)
+        GPU_Backend_VRAMReadbackResolve();
+    if (!io->load && io->buf && psx_vram_shadow)
+    {
+        GPU_Backend_VRAMReadback(0, 0, PSX_VRAM_WIDTH, PSX_VRAM_HEIGHT);
+        GPU_Backend_VRAMReadbackResolve();
+    }
+
+    STATE_VAR(io, gpu_stat);
+    STATE_VAR(io, gpu_read);
+    STATE_VAR(io, gpu_pending_vblank_flush);
+    STATE_VAR(io, gpu_estimated_pixels);
+    STATE_VAR(io, draw_offset_x);
+    STATE_VAR(io, draw_offset_y);
+    STATE_VAR(io, draw_clip_x1);
+    STATE_VAR(io, draw_clip_y1);
+    STATE_VAR(io, draw_clip_x2);
+    STATE_VAR(io, draw_clip_y2);
+    STATE_VAR(io, disp_range_y1);
+    STATE_VAR(io, disp_range_y2);
+    STATE_VAR(io, display_start_x);
+    STATE_VAR(io, display_start_y);
+    STATE_VAR(io, tex_page_x);
+    STATE_VAR(io, tex_page_y);
+    STATE_VAR(io, tex_page_format);
+    STATE_VAR(io, semi_trans_mode);
+    STATE_VAR(io, dither_enabled);
+    STATE_VAR(io, vram_tx_x);
+    STATE_VAR(io, vram_tx_y);
+    STATE_VAR(io, vram_tx_w);
+    STATE_VAR(io, vram_tx_h);
+    STATE_VAR(io, vram_tx_pixel);
+    STATE_VAR(io, vram_read_x);
+    STATE_VAR(io, vram_read_y);
+    STATE_VAR(io, vram_read_w);
+    STATE_VAR(io, vram_read_h);
+    STATE_VAR(io, vram_read_remaining);
+    STATE_VAR(io, vram_read_pixel);
+    STATE_VAR(io, polyline_active);
+    STATE_VAR(io, polyline_shaded);
+    STATE_VAR(io, polyline_semi_trans);
+    STATE_VAR(io, polyline_prev_color);
+    STATE_VAR(io, polyline_next_color);
+    STATE_VAR(io, polyline_prev_x);
+    STATE_VAR(io, polyline_prev_y);
+    STATE_VAR(io, polyline_expect_color);
+    STATE_VAR(io, tex_flip_x);
+    STATE_VAR(io, tex_flip_y);
+    STATE_VAR(io, mask_set_bit);
+    STATE_VAR(io, mask_check_bit);
+    STATE_VAR(io, cached_base_test);
+    STATE_VAR(io, gp1_allow_2mb);
+    STATE_VAR(io, tex_win_mask_x);
+    STATE_VAR(io, tex_win_mask_y);
+    STATE_VAR(io, tex_win_off_x);
+    STATE_VAR(io, tex_win_off_y);
+    STATE_VAR(io, raw_tex_window);
+    STATE_VAR(io, raw_draw_area_tl);
+    STATE_VAR(io, raw_draw_area_br);
+    STATE_VAR(io, raw_draw_offset);
+    STATE_VAR(io, gpu_cmd_remaining);
+    STATE_VAR(io, gpu_cmd_buffer);
+    STATE_VAR(io, gpu_cmd_ptr);
+    STATE_VAR(io, gpu_transfer_words);
+    STATE_VAR(io, gpu_transfer_total);
+    STATE_VAR(io, skip_disp_pending);
+    STATE_VAR(io, skip_disp_data);
+
+    /* Saved in 64-pixel row segments, the GS readback tile width */
+    if (!io->load)
+    {
+        static uint16_t vram_none[64];
+        for (int i = 0; i < PSX_VRAM_WIDTH * PSX_VRAM_HEIGHT; i += 64)
+            state_io(io, psx_vram_shadow ? psx_vram_shadow + i : vram_none, 128);
+        return;
+    }
+    uint8_t *vram = state_ptr(io, PSX_VRAM_WIDTH * PSX_VRAM_HEIGHT * 2);
+    if (!vram || !psx_vram_shadow)
+        return;
+
+    memcpy(psx_vram_shadow, vram, PSX_VRAM_WIDTH * PSX_VRAM_HEIGHT * 2);
+    GPU_Backend_Flush();
+    GPU_Backend_UploadShadowVRAM(0, 0, PSX_VRAM_WIDTH, PSX_VRAM_HEIGHT);
+    vram_gen_counter++;
+    Prim_InvalidateTexCache();
+    GPU_Backend_InvalidateState();
+    clear_gpu_param_cache();
+
+    GPU_Backend_SetDisplayFB(display_start_x, display_start_y);
+    GPU_Backend_SetScissor(draw_clip_x1, draw_clip_y1, draw_clip_x2, draw_clip_y2);
+    GPU_Backend_SetMaskBit(mask_set_bit, mask_check_bit);
+    GPU_Backend_SetResolution(disp_interlace, disp_pal ? 3 : 2);
+    GPU_Backend_UpdateDisplay();
+
+    extern void Timer0_RefreshDividerCache(void);
+    Timer0_RefreshDividerCache();
+}
+
+/* Texpage bits a textured polygon carries in its V1 UV word */
+static void draw_apply_tpage(uint32_t tpage)
+{
+    tex_page_x = (tpage & 0xF) * 64;
+    tex_page_y = ((tpage >> 4) & 0x1) * 256;
+    tex_page_format = (tpage >> 7) & 3;
+    semi_trans_mode = (tpage >> 5) & 3;
+    gpu_stat = (gpu_stat & ~0x81FF) | (tpage & 0x1FF);
+    if (gp1_allow_2mb)
+        gpu_stat = (gpu_stat & ~0x8000) | (((tpage >> 11) & 1) << 15);
+}
+
+/* Drop one fixed-size polygon / rectangle / line (0x20-0x7F).  Keeps the
+ * texpage side effect of textured polygons and a rough pixel estimate
+ * for GPU busy timing.  Returns 0 for anything that must still run. */
+int GPU_SkipDraw(const uint32_t *cmd)
+{
+    uint32_t op = cmd[0] >> 24;
+    uint32_t w, h;
+
+    if (op < 0x20 || (op & 0xE8) == 0x48) /* FillRect / env, polylines */
+        return 0;
+
+    if ((op & 0xE0) == 0x20)
+    {
+        int is_quad = (op & 0x08) != 0;
+        int is_textured = (op & 0x04) != 0;
+        int stride = 1 + is_textured + ((op & 0x10) != 0);
+        int16_t x1 = 0x7FFF, y1 = 0x7FFF, x2 = -0x8000, y2 = -0x8000;
+        for (int v = 0, idx = 1; v < (is_quad ? 4 : 3); v++, idx += stride)
+        {
+            int16_t px = (int16_t)((int32_t)((cmd[idx] & 0xFFFF) << 21) >> 21);
+            int16_t py = (int16_t)((int32_t)((cmd[idx] >> 16) << 21) >> 21);
+            if (px < x1) x1 = px;
+            if (px > x2) x2 = px;
+            if (py < y1) y1 = py;
+            if (py > y2) y2 = py;
+        }
+        if (is_textured)
+            draw_apply_tpage(cmd[2 + stride] >> 16); /* V1 UV upper half */
+        w = (uint32_t)(x2 - x1 + 1);
+        h = (uint32_t)(y2 - y1 + 1);
+        gpu_estimated_pixels += (is_quad ? w * h : w * h / 2);
+    }
+    else if ((op & 0xE0) == 0x60)
+    {
+        switch (op & 0x18)
+        {
+        case 0x00: /* variable size: W/H in the last word */
+        {
+            uint32_t wh = cmd[(op & 0x04) ? 3 : 2];
+            w = wh & 0x3FF;
+            h = (wh >> 16) & 0x1FF;
+            break;
+        }
+        case 0x08: w = h = 1; break;
+        case 0x10: w = h = 8; break;
+        default:   w = h = 16; break;
+        }
+        gpu_estimated_pixels += w * h;
+    }
+    gpu_frame_stats.skipped_prims++;
+    return 1;
+}
+
+/* Twice the signed area of a triangle, from 11-bit vertex words */
+static inline int32_t cull_tri_area2(uint32_t a, uint32_t b, uint32_t c)
+{
+    int32_t ax = (int32_t)((a & 0xFFFF) << 21) >> 21, ay = (int32_t)((a >> 16) << 21) >> 21;
+    int32_t bx = (int32_t)((b & 0xFFFF) << 21) >> 21, by = (int32_t)((b >> 16) << 21) >> 21;
+    int32_t cx = (int32_t)((c & 0xFFFF) << 21) >> 21, cy = (int32_t)((c >> 16) << 21) >> 21;
+    return ax * (by - cy) + bx * (cy - ay) + cx * (ay - by);
+}
+
+/* Drop one polygon / rectangle (0x20-0x3F, 0x60-0x7F) that can't draw
+ * a pixel: zero area, or a bounding box entirely outside the drawing
+ * area.  E4h is taken as inclusive here, so nothing either reading of
+ * it would draw is lost.  Keeps the texpage side effect, and charges
+ * the pixel estimate the renderer would have, so GPU busy timing is the
+ * same as if it had been drawn.  Returns 0 for anything that must run. */
+int GPU_CullDraw(const uint32_t *cmd)
+{
+    uint32_t op = cmd[0] >> 24;
+
+    if ((op & 0xE0) == 0x20)
+    {
+        int is_quad = (op & 0x08) != 0;
+        int is_textured = (op & 0x04) != 0;
+        int stride = 1 + is_textured + ((op & 0x10) != 0);
+        const uint32_t *v0 = &cmd[1], *v1 = v0 + stride, *v2 = v1 + stride, *v3 = v2 + stride;
+        int32_t a = cull_tri_area2(*v0, *v1, *v2);
+        int32_t b = is_quad ? cull_tri_area2(*v1, *v3, *v2) : 0;
+        uint32_t area = (uint32_t)((a < 0 ? -a : a) >> 1) + (uint32_t)((b < 0 ? -b : b) >> 1);
+
+        if (a || b)
+        {
+            int x1 = 0x7FFF, y1 = 0x7FFF, x2 = -0x8000, y2 = -0x8000;
+            for (int v = 0; v < (is_quad ? 4 : 3); v++)
+            {
+                int px = (int32_t)((v0[v * stride] & 0xFFFF) << 21) >> 21;
+                int py = (int32_t)((v0[v * stride] >> 16) << 21) >> 21;
+                if (px < x1) x1 = px;
+                if (px > x2) x2 = px;
+                if (py < y1) y1 = py;
+                if (py > y2) y2 = py;
+            }
+            if (x2 + draw_offset_x >= draw_clip_x1 && x1 + draw_offset_x <= draw_clip_x2 &&
+                y2 + draw_offset_y >= draw_clip_y1 && y1 + draw_offset_y <= draw_clip_y2)
+                return 0;
+            gpu_frame_stats.culled_offscreen++;
+        }
+        else
+            gpu_frame_stats.culled_degenerate++;
+
+        if (is_textured)
+            draw_apply_tpage(v1[1] >> 16);
+        gpu_estimated_pixels += area;
+        return 1;
+    }
+    if ((op & 0xE0) == 0x60)
+    {
+        int x = draw_offset_x + ((int32_t)((cmd[1] & 0xFFFF) << 21) >> 21);
+        int y = draw_offset_y + ((int32_t)((cmd[1] >> 16) << 21) >> 21);
+        uint32_t w, h;
+        switch (op & 0x18)
+        {
+        case 0x00:
+        {
+            uint32_t wh = cmd[(op & 0x04) ? 3 : 2];
+            w = wh & 0x3FF;
+            h = (wh >> 16) & 0x1FF;
+            break;
+        }
+        case 0x08: w = h = 1; break;
+        case 0x10: w = h = 8; break;
+        default:   w = h = 16; break;
+        }
+        if (!w || !h)
+            gpu_frame_stats.culled_degenerate++;
+        else if (x + (int)w > draw_clip_x1 && x <= draw_clip_x2 &&
+                 y + (int)h > draw_clip_y1 && y <= draw_clip_y2)
+            return 0;
+        else
+            gpu_frame_stats.culled_offscreen++;
+        gpu_estimated_pixels += w * h;
+        return 1;
+    }
+    return 0;
+}
+
 /* ── Frame counter state ─────────────────────────────────────────── */
 static uint32_t frame_count = 0;
-static uint32_t fps_display = 0;
-static uint32_t speed_display = 0;
 static clock_t fps_clock_start = 0;
+static char fps_text[32] = "";
+
+/* Called at each emulated VBlank, before the backend's: counts the
+ * frames the game drew into, and once a second measures the rate and
+ * formats the OSD text GPU_WriteGP0 shows (cached by the OSD until it
+ * changes). */
+void GPU_OSDVBlank(void)
+{
+    if (!psx_config.show_fps)
+        return;
+    if (!gpu_pending_vblank_flush) /* a GP0 write consumed the last one */
+        frame_count++;
+
+    clock_t now = clock();
+    if (now - fps_clock_start < CLOCKS_PER_SEC)
+        return;
+
+    /* Speed %: vblanks/sec relative to target (60 NTSC, 50 PAL) */
+    uint32_t target = psx_config.region_pal ? 50 : 60;
+    uint32_t vblanks = osd_vblank_count;
+    osd_vblank_count = 0;
+    uint32_t speed = (vblanks * 100 + target / 2) / target;
+    if (sched_unlimited_speed) /* emulated frames per second */
+        snprintf(fps_text, sizeof(fps_text), "FF %luFPS %lu%%  ",
+                 (unsigned long)vblanks, (unsigned long)speed);
+    else
+        snprintf(fps_text, sizeof(fps_text), "%luFPS %lu%%  ",
+                 (unsigned long)frame_count, (unsigned long)speed);
+    frame_count = 0;
+    fps_clock_start = now;
+}
 
 /* ── GP0 Write ───────────────────────────────────────────────────── */
 
+/* Last data word of a GP0(A0h) transfer */
+static void gpu_transfer_done(void)
+{
+    GPU_Backend_VRAMFlush(); /* pad and flush remaining VRAM words */
+    GPU_Backend_Flush();     /* sync for VRAM-to-CPU readback */
+
+    if (vram_tx_x + vram_tx_w > 1024)
+    {
+        int wrap_w = (vram_tx_x + vram_tx_w) - 1024;
+        GPU_Backend_UploadShadowVRAM(0, vram_tx_y, wrap_w, vram_tx_h);
+    }
+}
+
+/* Up to count data words of the current GP0(A0h) transfer at once: the
+ * shadow takes whole row runs and the backend packs the words in one
+ * call.  Same result as feeding them to GPU_WriteGP0; returns 0 (caller
+ * goes word by word) when the mask bits or VRAM wrap need the per-pixel
+ * path. */
+static uint32_t gpu_vram_write_burst(const uint32_t *data, uint32_t count)
+{
+    if (mask_set_bit || mask_check_bit || vram_tx_w <= 0 ||
+        vram_tx_x + vram_tx_w > 1024 || vram_tx_y + vram_tx_h > 512)
+        return 0;
+
+    uint32_t n = count < (uint32_t)gpu_transfer_words ? count : (uint32_t)gpu_transfer_words;
+    if (psx_vram_shadow)
+    {
+        const uint16_t *src = (const uint16_t *)data;
+        int total_pixels = vram_tx_w * vram_tx_h;
+        int pixels = (int)n * 2;
+        if (vram_tx_pixel + pixels > total_pixels)
+            pixels = total_pixels - vram_tx_pixel; /* odd-sized image pad */
+        while (pixels > 0)
+        {
+            int col = vram_tx_pixel % vram_tx_w;
+            int row = vram_tx_pixel / vram_tx_w;
+            int run = vram_tx_w - col;
+            if (run > pixels)
+                run = pixels;
+            memcpy(&psx_vram_shadow[(vram_tx_y + row) * 1024 + vram_tx_x + col], src,
+                   (size_t)run * 2);
+            src += run;
+            pixels -= run;
+            vram_tx_pixel += run;
+        }
+        vram_tx_pixel = (vram_tx_pixel + 1) & ~1; /* even, as word by word */
+    }
+
+    GPU_Backend_VRAMWriteBlock(data, n);
+    gpu_transfer_words -= (int)n;
+    if (gpu_transfer_words == 0)
+        gpu_transfer_done();
+    return n;
+}
+
 void GPU_WriteGP0(uint32_t data)
 {
+    GPU_GP0FifoSync(); /* words the JIT buffered come first */
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
+    if (gpu_readback_pending)
+        GPU_Backend_VRAMReadbackResolve();
+
     // Deferred flush from VBlank ISR
     if (gpu_pending_vblank_flush)
     {
         if (psx_config.show_fps)
-        {
-            frame_count++;
-            clock_t now = clock();
-            if (now - fps_clock_start >= CLOCKS_PER_SEC)
-            {
-                fps_display = frame_count;
-                /* Speed %: vblanks/sec relative to target (60 NTSC, 50 PAL) */
-                uint32_t target = psx_config.region_pal ? 50 : 60;
-                uint32_t vblanks = osd_vblank_count;
-                osd_vblank_count = 0;
-                speed_display = (vblanks * 100 + target / 2) / target;
-                frame_count = 0;
-                fps_clock_start = now;
-            }
             osd_printf(display_start_x + 4, display_start_y + 4,
-                       OSD_COLOR_WHITE, "%luFPS %lu%%  ",
-                       (unsigned long)fps_display,
-                       (unsigned long)speed_display);
-        }
+                       OSD_COLOR_WHITE, "%s", fps_text);
         osd_draw(); /* render OSD overlay — stays in current GE list */
         gpu_pending_vblank_flush = 0;
     }
@@ -434,16 +813,7 @@ void GPU_WriteGP0(uint32_t data)
 
         gpu_transfer_words--;
         if (gpu_transfer_words == 0)
-        {
-            GPU_Backend_VRAMFlush(); /* pad and flush remaining VRAM words */
-            GPU_Backend_Flush();     /* sync for VRAM-to-CPU readback */
-
-            if (vram_tx_x + vram_tx_w > 1024)
-            {
-                int wrap_w = (vram_tx_x + vram_tx_w) - 1024;
-                GPU_Backend_UploadShadowVRAM(0, vram_tx_y, wrap_w, vram_tx_h);
-            }
-        }
+            gpu_transfer_done();
         return;
     }
 
@@ -573,74 +943,85 @@ void GPU_WriteGP0(uint32_t data)
                     Tex_Cache_DirtyRegion(dx, dy, w, h);
                     gpu_frame_stats.vram_copy++;
 
+                    /* Let the backend copy inside its own VRAM when it
+                     * can (no pixel data crosses the bus).  Otherwise
+                     * upload the destination region from shadow VRAM:
+                     *  - Correct for ALL overlap cases (shadow already copied)
+                     *  - Applies STP fixup (Upload_Shadow_VRAM_Region does it)
+                     *  - No BUSDIR readback (fragile on real PS2 hardware)
+                     *  - No Flush_GIF_Sync stall
+                     * The re-upload needs the shadow source current. */
+                    int local = GPU_Backend_VRAMCopyLocal(sx, sy, dx, dy, w, h);
+                    if (!local)
+                        GPU_Backend_ShadowSync(sx, sy, w, h);
+
                     /* Copy in shadow VRAM (handles all overlap cases
                      * correctly with PSX pixel-by-pixel semantics).
                      * PSX copies left→right, top→bottom, wrapping at
                      * 1024×512.  Overlapping src/dst produces well-defined
-                     * results due to the fixed copy order. */
-                    if (sx + w <= 1024 && dx + w <= 1024 &&
-                        sy + h <= 512 && dy + h <= 512)
+                     * results due to the fixed copy order.  Skipped when
+                     * the backend left the destination stale. */
+                    if (local != 2)
                     {
-                        if (sy == dy && !(sx >= dx + w || dx >= sx + w))
+                        if (sx + w <= 1024 && dx + w <= 1024 &&
+                            sy + h <= 512 && dy + h <= 512)
                         {
-                            /* Same row, horizontal overlap → memmove */
-                            for (int row = 0; row < h; row++)
+                            if (sy == dy && !(sx >= dx + w || dx >= sx + w))
                             {
-                                memmove(&psx_vram_shadow[(dy + row) * 1024 + dx],
-                                        &psx_vram_shadow[(sy + row) * 1024 + sx],
-                                        w * sizeof(uint16_t));
+                                /* Same row, horizontal overlap → memmove */
+                                for (int row = 0; row < h; row++)
+                                {
+                                    memmove(&psx_vram_shadow[(dy + row) * 1024 + dx],
+                                            &psx_vram_shadow[(sy + row) * 1024 + sx],
+                                            w * sizeof(uint16_t));
+                                }
                             }
-                        }
-                        else if (dy > sy && dy < sy + h)
-                        {
-                            /* Downward overlap → copy bottom-to-top */
-                            for (int row = h - 1; row >= 0; row--)
+                            else if (dy > sy && dy < sy + h)
                             {
-                                memcpy(&psx_vram_shadow[(dy + row) * 1024 + dx],
-                                       &psx_vram_shadow[(sy + row) * 1024 + sx],
-                                       w * sizeof(uint16_t));
+                                /* Downward overlap → copy bottom-to-top */
+                                for (int row = h - 1; row >= 0; row--)
+                                {
+                                    memcpy(&psx_vram_shadow[(dy + row) * 1024 + dx],
+                                           &psx_vram_shadow[(sy + row) * 1024 + sx],
+                                           w * sizeof(uint16_t));
+                                }
                             }
-                        }
-                        else
-                        {
-                            /* No overlap or upward overlap → simple memcpy */
-                            for (int row = 0; row < h; row++)
+                            else
                             {
-                                memcpy(&psx_vram_shadow[(dy + row) * 1024 + dx],
-                                       &psx_vram_shadow[(sy + row) * 1024 + sx],
-                                       w * sizeof(uint16_t));
+                                /* No overlap or upward overlap → simple memcpy */
+                                for (int row = 0; row < h; row++)
+                                {
+                                    memcpy(&psx_vram_shadow[(dy + row) * 1024 + dx],
+                                           &psx_vram_shadow[(sy + row) * 1024 + sx],
+                                           w * sizeof(uint16_t));
+                                }
                             }
                         }
-                    }
-                    else
-                    {
-                        /* Wrapping path: pixel-by-pixel (rare) */
-                        for (int row = 0; row < h; row++)
+                        else
                         {
-                            for (int col = 0; col < w; col++)
+                            /* Wrapping path: pixel-by-pixel (rare) */
+                            for (int row = 0; row < h; row++)
                             {
-                                int src_px = ((sy + row) & 0x1FF) * 1024 + ((sx + col) & 0x3FF);
-                                int dst_px = ((dy + row) & 0x1FF) * 1024 + ((dx + col) & 0x3FF);
-                                psx_vram_shadow[dst_px] = psx_vram_shadow[src_px];
+                                for (int col = 0; col < w; col++)
+                                {
+                                    int src_px = ((sy + row) & 0x1FF) * 1024 + ((sx + col) & 0x3FF);
+                                    int dst_px = ((dy + row) & 0x1FF) * 1024 + ((dx + col) & 0x3FF);
+                                    psx_vram_shadow[dst_px] = psx_vram_shadow[src_px];
+                                }
                             }
                         }
                     }
 
-                    /* Upload the destination region from shadow VRAM to GS.
-                     * This replaces both the GS Local→Local copy and the
-                     * BUSDIR readback path.  Benefits:
-                     *  - Correct for ALL overlap cases (shadow already copied)
-                     *  - Applies STP fixup (Upload_Shadow_VRAM_Region does it)
-                     *  - No BUSDIR readback (fragile on real PS2 hardware)
-                     *  - No Flush_GIF_Sync stall
-                     *  - Eliminates 1MB vram_copy_readback buffer */
-                    GPU_Backend_UploadShadowVRAM(dx, dy, w, h);
+                    if (!local)
+                        GPU_Backend_UploadShadowVRAM(dx, dy, w, h);
                 }
             }
             else
             {
                 /* Try platform-specific fast path first, fall back to generic */
-                if (!GPU_Backend_TryFastPoly(gpu_cmd_buffer))
+                if (!(gpu_skip_frame && GPU_SkipDraw(gpu_cmd_buffer)) &&
+                    !GPU_CullDraw(gpu_cmd_buffer) &&
+                    !GPU_Backend_TryFastPoly(gpu_cmd_buffer))
                 {
                     Translate_GP0_to_GS(gpu_cmd_buffer);
                 }
@@ -693,7 +1074,15 @@ void GPU_WriteGP0(uint32_t data)
     {
     case 0xE1: // Draw Mode
     {
-        if (data != cache_e1)
+        if (GPU_E1DitherOnly(data))
+        {
+            /* Only bit 9 changed: DTHE follows use_dither lazily per
+             * primitive, the rest of the GS state stays valid */
+            cache_e1 = data;
+            gpu_stat = (gpu_stat & ~0x200) | (data & 0x200);
+            dither_enabled = ((data >> 9) & 1) && !psx_config.gpu_dither_off;
+        }
+        else if (data != cache_e1)
         {
             cache_e1 = data;
 
@@ -717,7 +1106,7 @@ void GPU_WriteGP0(uint32_t data)
                 gpu_stat = (gpu_stat & ~0x87FF) | (data & 0x7FF);
 
             uint32_t dither_enable = (data >> 9) & 1;
-            dither_enabled = dither_enable;
+            dither_enabled = dither_enable && !psx_config.gpu_dither_off;
 
             /* G5: No GIF writes here — TEX0/TEXFLUSH/DTHE/ALPHA_1 are
              * always re-emitted by the next primitive via lazy gs_state
@@ -844,6 +1233,11 @@ void GPU_WriteGP0(uint32_t data)
 void GPU_WriteGP1(uint32_t data)
 {
     uint32_t cmd = (data >> 24) & 0xFF;
+    GPU_GP0FifoSync();
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
+    if (gpu_readback_pending)
+        GPU_Backend_VRAMReadbackResolve();
     switch (cmd)
     {
     case 0x00: // Reset GPU
@@ -918,22 +1312,16 @@ void GPU_WriteGP1(uint32_t data)
         gpu_stat = (gpu_stat & ~0x60000000) | ((data & 3) << 29);
         break;
     case 0x05: // Display Start
-    {
-        if (data != cache_gp1_05)
+        if (gpu_skip_frame)
         {
-            cache_gp1_05 = data;
-            uint32_t x = data & 0x3FF;
-            uint32_t y = (data >> 10) & 0x1FF;
-            display_start_x = x;
-            display_start_y = y;
-#ifdef TEX_DEBUG_OVERLAY
-            printf("[DISP] GP1(05) display_start=(%u,%u)\n", x, y);
-#endif
-
-            GPU_Backend_SetDisplayFB(x, y);
+            /* Skipped frame: keep showing the last fully drawn buffer */
+            skip_disp_data = data;
+            skip_disp_pending = (data != cache_gp1_05);
+            break;
         }
-    }
-    break;
+        skip_disp_pending = 0;
+        gpu_display_start(data);
+        break;
     case 0x06: // Horizontal Display Range
     {
         if (data != cache_gp1_06)
@@ -1029,6 +1417,24 @@ void GPU_WriteGP1(uint32_t data)
     }
 }
 
+/* ── GP0 write-combining FIFO (jit_gp0_fifo) ─────────────────────── */
+
+gpu_gp0_fifo_t gpu_gp0_fifo;
+
+/* Emptied first: the words are processed in place, and any GPU entry
+ * point reached from here must not drain them again.  Queued chains
+ * were sent before these words, so they are drawn first. */
+void GPU_GP0FifoDrain(void)
+{
+    uint32_t n = gpu_gp0_fifo.count;
+    gpu_gp0_fifo.count = 0;
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
+    if (gpu_readback_pending)
+        GPU_Backend_VRAMReadbackResolve();
+    GPU_ProcessDmaBlock(gpu_gp0_fifo.words, n);
+}
+
 void GPU_ProcessDmaBlock(uint32_t *data_ptr, uint32_t word_count)
 {
     uint32_t i = 0;
@@ -1039,6 +1445,17 @@ void GPU_ProcessDmaBlock(uint32_t *data_ptr, uint32_t word_count)
     /* ── Drain any in-progress state from prior calls ── */
     while (i < word_count && (gpu_transfer_words > 0 || gpu_cmd_remaining > 0 || polyline_active))
     {
+        /* LoadImage data after a header sent through the GP0 port (libgpu
+         * LoadImage, every MDEC frame strip): take it in one burst */
+        if (gpu_transfer_words > 0 && gpu_cmd_remaining == 0)
+        {
+            uint32_t n = gpu_vram_write_burst(&data_ptr[i], word_count - i);
+            if (n)
+            {
+                i += n;
+                continue;
+            }
+        }
         GPU_WriteGP0(data_ptr[i]);
         i++;
     }
@@ -1097,6 +1514,12 @@ void GPU_ProcessDmaBlock(uint32_t *data_ptr, uint32_t word_count)
         /* ── Draw commands: polys, rects, lines, fill-rect (0x02-0x7F) ── */
         if (cmd_byte <= 0x7F)
         {
+            if (i + cmd_size <= word_count &&
+                ((gpu_skip_frame && GPU_SkipDraw(cmd_ptr)) || GPU_CullDraw(cmd_ptr)))
+            {
+                i += cmd_size;
+                continue;
+            }
             int size = GPU_TryFastEmit(cmd_ptr);
             if (size <= 0)
             {
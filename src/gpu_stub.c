@@ -9,12 +9,16 @@
 
 #include "gpu_state.h"
 #include "audio_backend.h"
+#include "savestate.h"
 
 /* ── Global variable definitions (externed in gpu_state.h) ──────────── */
 
 uint32_t gpu_stat = 0x1C000000; /* GPU ready, display on */
 uint32_t gpu_read = 0;
 volatile int gpu_pending_vblank_flush = 0;
+int gpu_readback_pending = 0;
+int gpu_queue_pending = 0;
+int gpu_skip_frame = 0;
 
 uint64_t gpu_estimated_pixels = 0;
 
@@ -96,6 +100,7 @@ uint32_t GPU_Read(void) { return 0; }
 uint32_t GPU_ReadStatus(void) { return 0x1C000000; }
 
 void GPU_VBlank(void) {}
+void GPU_OSDVBlank(void) {}
 void GPU_Flush(void) {}
 
 int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr)
@@ -106,6 +111,9 @@ int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr)
     return 0;
 }
 
+/* No GPU state to keep headless */
+void GPU_State(StateIO *io) { (void)io; }
+
 /* ── gpu_core.c interface ───────────────────────────────────────────── */
 
 void Update_GS_Display(void) {}
@@ -246,6 +254,30 @@ void GPU_ProcessDmaBlock(uint32_t *data_ptr, uint32_t word_count)
     (void)word_count;
 }
 
+gpu_gp0_fifo_t gpu_gp0_fifo;
+
+void GPU_GP0FifoDrain(void)
+{
+    gpu_gp0_fifo.count = 0;
+}
+
+int GPU_SkipDraw(const uint32_t *cmd)
+{
+    (void)cmd;
+    return 0;
+}
+
+int GPU_CullDraw(const uint32_t *cmd)
+{
+    (void)cmd;
+    return 0;
+}
+
+void GPU_SetFrameSkip(int skip)
+{
+    (void)skip;
+}
+
 /* ── GPU_Backend_* stubs (gpu_backend.h) ────────────────────────────── */
 
 #include "gpu_backend.h"
@@ -270,11 +302,19 @@ void GPU_Backend_UploadRegionFast(uint32_t coords, uint32_t dims,
 void GPU_Backend_VRAMCopy(int sx, int sy, int dx, int dy, int w, int h)
 { (void)sx; (void)sy; (void)dx; (void)dy; (void)w; (void)h; }
 
+int GPU_Backend_VRAMCopyLocal(int sx, int sy, int dx, int dy, int w, int h)
+{ (void)sx; (void)sy; (void)dx; (void)dy; (void)w; (void)h; return 0; }
+void GPU_Backend_ShadowSync(int x, int y, int w, int h)
+{ (void)x; (void)y; (void)w; (void)h; }
 void GPU_Backend_VRAMWrite(uint32_t word) { (void)word; }
+void GPU_Backend_VRAMWriteBlock(const uint32_t *words, uint32_t count)
+{ (void)words; (void)count; }
 void GPU_Backend_VRAMFlush(void) {}
 
 void GPU_Backend_VRAMReadback(int x, int y, int w, int h)
 { (void)x; (void)y; (void)w; (void)h; }
+void GPU_Backend_VRAMReadbackResolve(void) {}
+void GPU_Backend_QueueDrain(void) {}
 
 void GPU_Backend_SetScissor(int x1, int y1, int x2, int y2)
 { (void)x1; (void)y1; (void)x2; (void)y2; }
@@ -2,14 +2,18 @@
  * gpu_trace.c — GPU command stream ring buffer implementation
  *
  * Records raw GP0 DMA words into a 60-frame circular buffer.
- * On trigger, writes the buffer to a binary file (oldest frame first).
+ * On trigger, the next frame boundary snapshots VRAM and the drawing
+ * environment; GPU_TRACE_FRAMES frames later the ring holds exactly
+ * the frames since, and is written out (oldest frame first).
  *
- * Memory cost: ~3.8 MB BSS (60 × 16384 × 4 bytes).
+ * Memory cost: ~4.8 MB BSS (60 × 16384 × 4 bytes + the VRAM snapshot).
  */
 #include "gpu_trace.h"
 
 #ifdef ENABLE_GPU_TRACE
 
+#include "gpu_state.h"
+#include "gpu_backend.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -20,14 +24,20 @@ static uint32_t trace_frame_id[GPU_TRACE_FRAMES]; /* global frame number */
 static int      trace_pos = 0;                    /* current write slot */
 static uint32_t trace_global_frame = 0;
 static int      trace_dump_pending = 0;
+static int      trace_capture_left = 0;           /* frames until the dump */
 static const char *trace_dump_path = NULL;
 
+/* Capture start: VRAM and the E1-E6 words that restore the environment */
+static uint16_t trace_vram[PSX_VRAM_WIDTH * PSX_VRAM_HEIGHT];
+static uint32_t trace_prelude[GPU_TRACE_PRELUDE_WORDS];
+
 void gpu_trace_init(void)
 {
     memset(trace_count, 0, sizeof(trace_count));
     trace_pos = 0;
     trace_global_frame = 0;
     trace_dump_pending = 0;
+    trace_capture_left = 0;
     trace_dump_path = NULL;
 }
 
@@ -43,55 +53,95 @@ void gpu_trace_record(const uint32_t *data, uint32_t word_count)
     }
 }
 
+static void trace_snapshot(void)
+{
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
+    if (psx_vram_shadow) {
+        GPU_Backend_VRAMReadback(0, 0, PSX_VRAM_WIDTH, PSX_VRAM_HEIGHT);
+        GPU_Backend_VRAMReadbackResolve();
+        memcpy(trace_vram, psx_vram_shadow, sizeof(trace_vram));
+    } else {
+        memset(trace_vram, 0, sizeof(trace_vram));
+    }
+
+    /* GPUSTAT keeps E1 bits 0-10 (bit 11 as GPUSTAT.15) and E6 as bits 11-12 */
+    trace_prelude[0] = 0xE1000000 | (gpu_stat & 0x7FF) | (((gpu_stat >> 15) & 1) << 11) |
+                       ((uint32_t)tex_flip_x << 12) | ((uint32_t)tex_flip_y << 13);
+    trace_prelude[1] = 0xE2000000 | raw_tex_window;
+    trace_prelude[2] = 0xE3000000 | raw_draw_area_tl;
+    trace_prelude[3] = 0xE4000000 | raw_draw_area_br;
+    trace_prelude[4] = 0xE5000000 | raw_draw_offset;
+    trace_prelude[5] = 0xE6000000 | ((gpu_stat >> 11) & 3);
+}
+
+static void trace_write(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        printf("[GPU_TRACE] cannot open %s\n", path);
+        return;
+    }
+
+    /* Write header */
+    uint32_t header[4];
+    header[0] = GPU_TRACE_MAGIC;
+    header[1] = GPU_TRACE_VERSION;
+    header[2] = GPU_TRACE_FRAMES;
+    header[3] = GPU_TRACE_MAX_WORDS;
+    fwrite(header, sizeof(uint32_t), 4, f);
+
+    uint32_t n = GPU_TRACE_PRELUDE_WORDS;
+    fwrite(&n, sizeof(uint32_t), 1, f);
+    fwrite(trace_prelude, sizeof(uint32_t), n, f);
+    fwrite(trace_vram, sizeof(uint16_t), PSX_VRAM_WIDTH * PSX_VRAM_HEIGHT, f);
+
+    /* Write frames oldest-first (trace_pos is the newest, just finalized) */
+    for (int i = 1; i <= GPU_TRACE_FRAMES; i++) {
+        int idx = (trace_pos + i) % GPU_TRACE_FRAMES;
+        fwrite(&trace_frame_id[idx], sizeof(uint32_t), 1, f);
+        fwrite(&trace_count[idx], sizeof(uint32_t), 1, f);
+        if (trace_count[idx] > 0) {
+            fwrite(trace_buf[idx], sizeof(uint32_t), trace_count[idx], f);
+        }
+    }
+
+    fclose(f);
+    printf("[GPU_TRACE] dumped %d frames (%lu-%lu) to %s\n",
+           GPU_TRACE_FRAMES,
+           (unsigned long)trace_frame_id[(trace_pos + 1) % GPU_TRACE_FRAMES],
+           (unsigned long)trace_frame_id[trace_pos],
+           path);
+}
+
 void gpu_trace_frame_end(void)
 {
     /* Finalize current frame */
     trace_frame_id[trace_pos] = trace_global_frame++;
+
+    /* Capture complete: the ring is exactly the frames since the snapshot */
+    if (trace_capture_left > 0 && --trace_capture_left == 0)
+        trace_write(trace_dump_path);
+
     trace_pos = (trace_pos + 1) % GPU_TRACE_FRAMES;
     trace_count[trace_pos] = 0; /* clear next slot for new frame */
 
-    /* Deferred dump: write after frame boundary so we capture complete frames */
+    /* Deferred start: snapshot at the frame boundary, so replaying the
+     * frames that follow from it is exact */
     if (trace_dump_pending && trace_dump_path) {
         trace_dump_pending = 0;
-
-        FILE *f = fopen(trace_dump_path, "wb");
-        if (!f) {
-            printf("[GPU_TRACE] cannot open %s\n", trace_dump_path);
-            return;
-        }
-
-        /* Write header */
-        uint32_t header[4];
-        header[0] = GPU_TRACE_MAGIC;
-        header[1] = GPU_TRACE_VERSION;
-        header[2] = GPU_TRACE_FRAMES;
-        header[3] = GPU_TRACE_MAX_WORDS;
-        fwrite(header, sizeof(uint32_t), 4, f);
-
-        /* Write frames oldest-first (slot after trace_pos is oldest) */
-        for (int i = 0; i < GPU_TRACE_FRAMES; i++) {
-            int idx = (trace_pos + i) % GPU_TRACE_FRAMES;
-            fwrite(&trace_frame_id[idx], sizeof(uint32_t), 1, f);
-            fwrite(&trace_count[idx], sizeof(uint32_t), 1, f);
-            if (trace_count[idx] > 0) {
-                fwrite(trace_buf[idx], sizeof(uint32_t), trace_count[idx], f);
-            }
-        }
-
-        fclose(f);
-        printf("[GPU_TRACE] dumped %d frames (%lu-%lu) to %s\n",
-               GPU_TRACE_FRAMES,
-               (unsigned long)trace_frame_id[(trace_pos) % GPU_TRACE_FRAMES],
-               (unsigned long)trace_frame_id[(trace_pos + GPU_TRACE_FRAMES - 1) % GPU_TRACE_FRAMES],
-               trace_dump_path);
+        trace_snapshot();
+        trace_capture_left = GPU_TRACE_FRAMES;
     }
 }
 
 void gpu_trace_trigger_dump(const char *path)
 {
+    if (trace_dump_pending || trace_capture_left > 0)
+        return; /* button still held, or a capture already running */
     trace_dump_path = path;
     trace_dump_pending = 1;
-    printf("[GPU_TRACE] dump requested → %s\n", path);
+    printf("[GPU_TRACE] capture requested → %s (%d frames)\n", path, GPU_TRACE_FRAMES);
 }
 
 #endif /* ENABLE_GPU_TRACE */
@@ -0,0 +1,252 @@
+/**
+ * gpu_trace_bench.c — Replay a GPU trace capture as a renderer benchmark
+ *
+ * gpu_trace_bench = <file> loads a GPTD capture (gpu_trace.h), restores
+ * the VRAM snapshot and drawing environment through GP0, and feeds each
+ * recorded frame to GPU_ProcessDmaBlock as its own DMA block, flushing
+ * and presenting at every frame boundary.  No CPU, SPU or CD-ROM runs,
+ * so the frame times are the GPU translation and backend alone.  The
+ * capture is replayed gpu_trace_bench_loops times; the best loop's
+ * times and the counters of the last go into bench_gpu.json.
+ *
+ * GP0 port writes and GP1 aren't part of a trace, and version 1 files
+ * have no snapshot, so those replay over whatever VRAM holds at boot.
+ * In a HEADLESS build the GPU is the stub: only the file is measured.
+ */
+#include "benchmark.h"
+#include "config.h"
+#include "gpu_backend.h"
+#include "gpu_trace.h"
+#undef LOG_TAG
+#include "gpu_state.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TRACE_BENCH_REPORT "bench_gpu.json"
+#define TRACE_BENCH_PRELUDE_MAX 16
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t count;
+    uint32_t *words;
+} TraceFrame;
+
+static TraceFrame *tb_frames = NULL;
+static uint32_t tb_frame_count = 0;
+static uint32_t tb_version = 0;
+static uint32_t tb_prelude[TRACE_BENCH_PRELUDE_MAX];
+static uint32_t tb_prelude_count = 0;
+/* GP0(A0h) header for a full-VRAM load, followed by the snapshot */
+static uint32_t *tb_vram_load = NULL;
+
+static int read_u32(FILE *f, uint32_t *v)
+{
+    return fread(v, sizeof(uint32_t), 1, f) == 1;
+}
+
+static int trace_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    uint32_t hdr[4];
+
+    if (!f)
+    {
+        printf("[BENCH] Can't open GPU trace %s\n", path);
+        return 0;
+    }
+    if (fread(hdr, sizeof(uint32_t), 4, f) != 4 || hdr[0] != GPU_TRACE_MAGIC ||
+        hdr[1] < 1 || hdr[1] > GPU_TRACE_VERSION || hdr[2] == 0)
+    {
+        printf("[BENCH] %s is not a GPU trace\n", path);
+        fclose(f);
+        return 0;
+    }
+    tb_version = hdr[1];
+
+    if (tb_version >= 2)
+    {
+        uint32_t vram_words = PSX_VRAM_WIDTH * PSX_VRAM_HEIGHT / 2;
+        if (!read_u32(f, &tb_prelude_count) || tb_prelude_count > TRACE_BENCH_PRELUDE_MAX ||
+            fread(tb_prelude, sizeof(uint32_t), tb_prelude_count, f) != tb_prelude_count)
+            goto bad;
+        tb_vram_load = (uint32_t *)malloc((3 + vram_words) * sizeof(uint32_t));
+        if (!tb_vram_load)
+            goto oom;
+        tb_vram_load[0] = 0xA0000000;
+        tb_vram_load[1] = 0;
+        tb_vram_load[2] = (PSX_VRAM_HEIGHT << 16) | PSX_VRAM_WIDTH;
+        if (fread(tb_vram_load + 3, sizeof(uint32_t), vram_words, f) != vram_words)
+            goto bad;
+    }
+    else
+        printf("[BENCH] Version 1 GPU trace: no VRAM snapshot, replaying over boot VRAM\n");
+
+    tb_frames = (TraceFrame *)calloc(hdr[2], sizeof(TraceFrame));
+    if (!tb_frames)
+        goto oom;
+    for (uint32_t i = 0; i < hdr[2]; i++)
+    {
+        TraceFrame *fr = &tb_frames[i];
+        if (!read_u32(f, &fr->id) || !read_u32(f, &fr->count) || fr->count > hdr[3])
+            goto bad;
+        if (fr->count)
+        {
+            fr->words = (uint32_t *)malloc(fr->count * sizeof(uint32_t));
+            if (!fr->words)
+                goto oom;
+            if (fread(fr->words, sizeof(uint32_t), fr->count, f) != fr->count)
+                goto bad;
+        }
+        tb_frame_count++;
+    }
+    fclose(f);
+    return 1;
+
+oom:
+    printf("[BENCH] Out of memory loading %s\n", path);
+    fclose(f);
+    return 0;
+bad:
+    printf("[BENCH] %s is truncated or corrupt\n", path);
+    fclose(f);
+    return 0;
+}
+
+/* Back to the state at capture start: nothing half-received, the
+ * snapshot loaded with the mask bits off, then the captured E1-E6 */
+static void trace_restore(void)
+{
+    static uint32_t mask_off = 0xE6000000;
+
+    GPU_WriteGP1(0x01000000); /* reset the command buffer */
+    if (tb_vram_load)
+    {
+        GPU_ProcessDmaBlock(&mask_off, 1);
+        GPU_ProcessDmaBlock(tb_vram_load, 3 + PSX_VRAM_WIDTH * PSX_VRAM_HEIGHT / 2);
+    }
+    if (tb_prelude_count)
+    {
+        uint32_t env[TRACE_BENCH_PRELUDE_MAX];
+        memcpy(env, tb_prelude, tb_prelude_count * sizeof(uint32_t));
+        GPU_ProcessDmaBlock(env, tb_prelude_count);
+    }
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
+    GPU_Backend_FlushSync();
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void Bench_GpuTrace(const char *path)
+{
+    int loops = psx_config.gpu_trace_bench_loops;
+    uint32_t max_words = 0;
+
+    if (!trace_load(path))
+        exit(1);
+    for (uint32_t i = 0; i < tb_frame_count; i++)
+        if (tb_frames[i].count > max_words)
+            max_words = tb_frames[i].count;
+
+    /* The backend may translate commands in place: each frame is
+     * replayed from a copy */
+    uint32_t *scratch = (uint32_t *)malloc((max_words ? max_words : 1) * sizeof(uint32_t));
+    uint32_t *us = (uint32_t *)malloc(tb_frame_count * sizeof(uint32_t));
+    uint32_t *best_us = (uint32_t *)malloc(tb_frame_count * sizeof(uint32_t));
+    if (!scratch || !us || !best_us)
+    {
+        printf("[BENCH] Out of memory for the GPU trace replay\n");
+        exit(1);
+    }
+    printf("[BENCH] Replaying GPU trace %s: %u frames x %d loops\n",
+           path, (unsigned)tb_frame_count, loops);
+
+    uint64_t best_total = UINT64_MAX;
+    uint64_t words = 0;
+    for (int loop = 0; loop < loops; loop++)
+    {
+        uint64_t total = 0;
+
+        trace_restore();
+        memset(&gpu_frame_stats, 0, sizeof(gpu_frame_stats));
+        words = 0;
+        for (uint32_t i = 0; i < tb_frame_count; i++)
+        {
+            const TraceFrame *fr = &tb_frames[i];
+            memcpy(scratch, fr->words, fr->count * sizeof(uint32_t));
+
+            clock_t t0 = clock();
+            if (fr->count)
+                GPU_ProcessDmaBlock(scratch, fr->count);
+            if (gpu_queue_pending)
+                GPU_Backend_QueueDrain();
+            GPU_Backend_Flush();
+            GPU_Backend_VBlank();
+            GPU_Backend_FlushSync();
+            us[i] = (uint32_t)((uint64_t)(clock() - t0) * 1000000 / CLOCKS_PER_SEC);
+
+            total += us[i];
+            words += fr->count;
+        }
+        printf("[BENCH]   loop %d: %.1f ms\n", loop + 1, total / 1000.0);
+        if (total < best_total)
+        {
+            best_total = total;
+            memcpy(best_us, us, tb_frame_count * sizeof(uint32_t));
+        }
+    }
+
+    const gpu_frame_stats_t *s = &gpu_frame_stats;
+    uint32_t prims = s->poly_tex + s->poly_flat + s->rect_tex + s->rect_flat + s->line + s->fill;
+    uint32_t n = tb_frame_count;
+    double ms = best_total / 1000.0;
+    qsort(best_us, n, sizeof(uint32_t), cmp_u32);
+
+    FILE *f = fopen(TRACE_BENCH_REPORT, "w");
+    if (!f)
+    {
+        printf("[BENCH] Can't write %s\n", TRACE_BENCH_REPORT);
+        exit(1);
+    }
+    fprintf(f, "{\n");
+    fprintf(f, "  \"trace\": \"%s\",\n", path);
+    fprintf(f, "  \"trace_version\": %u,\n", (unsigned)tb_version);
+    fprintf(f, "  \"frames\": %u,\n", (unsigned)n);
+    fprintf(f, "  \"loops\": %d,\n", loops);
+    fprintf(f, "  \"gp0_words\": %lu,\n", (unsigned long)words);
+    fprintf(f, "  \"best_ms\": %.1f,\n", ms);
+    fprintf(f, "  \"frame_ms\": {\"min\": %.3f, \"avg\": %.3f, \"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+            best_us[0] / 1000.0, ms / n, best_us[n / 2] / 1000.0,
+            best_us[(uint32_t)((uint64_t)n * 99 / 100)] / 1000.0, best_us[n - 1] / 1000.0);
+    fprintf(f, "  \"prims\": %u,\n", (unsigned)prims);
+    fprintf(f, "  \"prims_per_sec\": %.0f,\n", ms > 0 ? prims * 1000.0 / ms : 0.0);
+    fprintf(f, "  \"prim_counts\": {\"poly_tex\": %u, \"poly_flat\": %u, \"rect_tex\": %u,"
+               " \"rect_flat\": %u, \"line\": %u, \"fill\": %u},\n",
+            (unsigned)s->poly_tex, (unsigned)s->poly_flat, (unsigned)s->rect_tex,
+            (unsigned)s->rect_flat, (unsigned)s->line, (unsigned)s->fill);
+    fprintf(f, "  \"culled\": {\"degenerate\": %u, \"offscreen\": %u},\n",
+            (unsigned)s->culled_degenerate, (unsigned)s->culled_offscreen);
+    fprintf(f, "  \"vram\": {\"load\": %u, \"store\": %u, \"copy\": %u, \"readbacks\": %u},\n",
+            (unsigned)s->vram_load, (unsigned)s->vram_store, (unsigned)s->vram_copy,
+            (unsigned)s->vram_readbacks);
+    fprintf(f, "  \"texcache\": {\"hit\": %u, \"miss\": %u, \"upload_rows\": %u},\n",
+            (unsigned)s->texcache_hit, (unsigned)s->texcache_miss, (unsigned)s->tex_upload_rows);
+    fprintf(f, "  \"state_changes\": {\"clut\": %u, \"tex_key\": %u, \"vbatch_flushes\": %u},\n",
+            (unsigned)s->clut_change, (unsigned)s->tex_key_change, (unsigned)s->vbatch_flushes);
+    fprintf(f, "  \"gif_qwords\": %u\n", (unsigned)s->gif_qwords);
+    fprintf(f, "}\n");
+    fclose(f);
+
+    printf("[BENCH] GPU trace: best %.1f ms for %u frames (%.3f ms/frame, %.0f prims/s), report in %s\n",
+           ms, (unsigned)n, ms / n, ms > 0 ? prims * 1000.0 / ms : 0.0, TRACE_BENCH_REPORT);
+    printf("=== Benchmark Ended ===\n");
+    fflush(stdout);
+    exit(0);
+}
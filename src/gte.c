@@ -12,8 +12,10 @@
 #include "superpsx.h"
 #include "config.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "dynarec.h"
+#include "savestate.h"
 
 /* ================================================================
  * VU0 Fast Path — Config-driven (gte_vu0 in superpsx.ini)
@@ -24,26 +26,38 @@
  * normal game values.
  *
  * Set gte_vu0 = 0 in superpsx.ini for exact GTE flag behavior
- * (required by the GTE test suite).
+ * (required by the GTE test suite).  gte_accuracy = exact/fast/ultra
+ * overrides it, globally or per game (GTE_TIER_*).
  * ================================================================ */
 int gte_flag_read_count = 0;
 int gte_use_vu0 = 0; /* 0=exact C path, 1=VU0 fast path */
+int gte_tier = GTE_TIER_EXACT;
 
 #ifdef PLATFORM_PSP
 #include "gte_vfpu.h"
 int gte_use_vfpu = 0; /* 0=exact C path, 1=VFPU fast path */
 #endif
 
+/* gte_accuracy (global or per game) wins; otherwise gte_vu0 picks
+ * between exact and fast */
+int GTE_ConfigTier(void)
+{
+    if (psx_config.gte_accuracy >= 0)
+        return psx_config.gte_accuracy;
+    return psx_config.gte_vu0 ? GTE_TIER_FAST : GTE_TIER_EXACT;
+}
+
 void GTE_VBlankUpdate(void)
 {
+    gte_tier = GTE_ConfigTier();
 #ifdef PLATFORM_PSP
     /* PSP: set gte_use_vfpu for C-level VFPU paths, and also
      * gte_use_vu0 for JIT inline paths — the JIT uses #ifdef PLATFORM_PSP
      * guards to emit VFPU instructions instead of VU0. */
-    gte_use_vfpu = psx_config.gte_vu0;
-    gte_use_vu0 = psx_config.gte_vu0;
+    gte_use_vfpu = gte_tier >= GTE_TIER_FAST;
+    gte_use_vu0 = gte_tier >= GTE_TIER_FAST;
 #else
-    gte_use_vu0 = psx_config.gte_vu0;
+    gte_use_vu0 = gte_tier >= GTE_TIER_FAST;
 #endif
 }
 
@@ -58,6 +72,87 @@ void GTE_VBlankUpdate(void)
 #define DBG(...)
 #endif
 
+/* ================================================================
+ * Command-stream recording (gte_record in superpsx.ini)
+ *
+ * The interpreter calls GTE_Record before each command; the JIT emits
+ * the call ahead of every command it compiles (batching off, disk cache
+ * off).  The file is closed after gte_record_max commands.
+ * ================================================================ */
+int gte_record_active = 0;
+static FILE *gte_record_file;
+static int gte_record_count;
+
+void GTE_RecordInit(void)
+{
+    GTEStreamHeader h = {GTE_STREAM_MAGIC, GTE_STREAM_VERSION, sizeof(GTEStreamRecord), 0};
+
+    if (!psx_config.gte_record[0])
+        return;
+    gte_record_file = fopen(psx_config.gte_record, "wb");
+    if (!gte_record_file || fwrite(&h, sizeof(h), 1, gte_record_file) != 1)
+    {
+        printf("GTE: cannot write command stream '%s'\n", psx_config.gte_record);
+        if (gte_record_file)
+            fclose(gte_record_file);
+        gte_record_file = NULL;
+        return;
+    }
+    gte_record_active = 1;
+    printf("GTE: recording up to %d commands to %s\n", psx_config.gte_record_max,
+           psx_config.gte_record);
+}
+
+void GTE_Record(R3000CPU *cpu, uint32_t opcode)
+{
+    GTEStreamRecord r;
+
+    if (!gte_record_file)
+        return;
+    r.opcode = opcode;
+    memcpy(r.data, cpu->cp2_data, sizeof(r.data));
+    memcpy(r.ctrl, cpu->cp2_ctrl, sizeof(r.ctrl));
+    fwrite(&r, sizeof(r), 1, gte_record_file);
+    if ((++gte_record_count & 255) == 0)
+        fflush(gte_record_file);
+    if (gte_record_count >= psx_config.gte_record_max)
+    {
+        fclose(gte_record_file);
+        gte_record_file = NULL;
+        gte_record_active = 0;
+        printf("GTE: recorded %d commands to %s\n", gte_record_count, psx_config.gte_record);
+    }
+}
+
+/* Read a gte_record file; returns a malloc'd array (NULL on error) */
+GTEStreamRecord *GTE_StreamLoad(const char *path, int *count)
+{
+    GTEStreamHeader h;
+    GTEStreamRecord *recs = NULL;
+    FILE *f = fopen(path, "rb");
+    long size;
+
+    *count = 0;
+    if (!f)
+        return NULL;
+    if (fread(&h, sizeof(h), 1, f) != 1 || h.magic != GTE_STREAM_MAGIC ||
+        h.version != GTE_STREAM_VERSION || h.record_size != sizeof(GTEStreamRecord))
+    {
+        printf("GTE: %s is not a version %d command stream\n", path, GTE_STREAM_VERSION);
+        fclose(f);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f) - (long)sizeof(h);
+    fseek(f, sizeof(h), SEEK_SET);
+    if (size >= (long)sizeof(GTEStreamRecord))
+        recs = (GTEStreamRecord *)malloc((size_t)size);
+    if (recs)
+        *count = (int)fread(recs, sizeof(GTEStreamRecord), (size_t)size / sizeof(GTEStreamRecord), f);
+    fclose(f);
+    return recs;
+}
+
 /* ================================================================
  * UNR Division Table (for RTPS/RTPT)
  * Generated as: unr_table[i] = min(0, (0x40000/(i+0x100)+1)/2 - 0x101)
@@ -82,6 +177,273 @@ const uint8_t gte_unr_table[0x101] = {
     0x00 /* extra entry for index 0x100 */
 };
 
+/* ================================================================
+ * UNR Reciprocal Table (fast path for SZ3 < 0x1000)
+ * gte_unr_recip[i] = reciprocal the two UNR Newton steps above produce
+ * for the normalized divisor d = 0x8000 + (i << 4).  Divisors below
+ * 0x1000 normalize to a d with the low 4 bits clear, so the common
+ * near/mid depth range skips the Newton steps; any other d falls back
+ * to them.  Entries are 0x10000..0x20000.
+ * ================================================================ */
+const uint32_t gte_unr_recip[GTE_UNR_RECIP_SIZE] = {
+    0x20000, 0x1FFC0, 0x1FF80, 0x1FF40, 0x1FF01, 0x1FEC1, 0x1FE81, 0x1FE42,
+    0x1FE02, 0x1FDC2, 0x1FD82, 0x1FD43, 0x1FD04, 0x1FCC4, 0x1FC87, 0x1FC47,
+    0x1FC08, 0x1FBC8, 0x1FB8B, 0x1FB4B, 0x1FB0D, 0x1FACE, 0x1FA8E, 0x1FA51,
+    0x1FA12, 0x1F9D3, 0x1F995, 0x1F956, 0x1F918, 0x1F8DB, 0x1F89C, 0x1F85F,
+    0x1F820, 0x1F7E2, 0x1F7A3, 0x1F766, 0x1F728, 0x1F6E9, 0x1F6AD, 0x1F66E,
+    0x1F631, 0x1F5F4, 0x1F5B5, 0x1F579, 0x1F53A, 0x1F4FE, 0x1F4C1, 0x1F483,
+    0x1F446, 0x1F40A, 0x1F3CD, 0x1F38F, 0x1F352, 0x1F314, 0x1F2D8, 0x1F29C,
+    0x1F25F, 0x1F223, 0x1F1E7, 0x1F1AA, 0x1F16C, 0x1F130, 0x1F0F4, 0x1F0B8,
+    0x1F07C, 0x1F040, 0x1F004, 0x1EFC8, 0x1EF8B, 0x1EF4F, 0x1EF13, 0x1EED7,
+    0x1EE9D, 0x1EE61, 0x1EE26, 0x1EDEA, 0x1EDAD, 0x1ED72, 0x1ED38, 0x1ECFC,
+    0x1ECC0, 0x1EC85, 0x1EC49, 0x1EC0F, 0x1EBD3, 0x1EB99, 0x1EB5E, 0x1EB23,
+    0x1EAE9, 0x1EAAE, 0x1EA72, 0x1EA37, 0x1E9FC, 0x1E9C3, 0x1E988, 0x1E94E,
+    0x1E913, 0x1E8D8, 0x1E89F, 0x1E863, 0x1E829, 0x1E7F0, 0x1E7B5, 0x1E77C,
+    0x1E743, 0x1E708, 0x1E6CF, 0x1E694, 0x1E659, 0x1E620, 0x1E5E7, 0x1E5AC,
+    0x1E574, 0x1E53B, 0x1E500, 0x1E4C7, 0x1E48E, 0x1E455, 0x1E41C, 0x1E3E2,
+    0x1E3A9, 0x1E370, 0x1E338, 0x1E2FD, 0x1E2C6, 0x1E28B, 0x1E253, 0x1E21A,
+    0x1E1E2, 0x1E1A9, 0x1E171, 0x1E138, 0x1E0FF, 0x1E0C7, 0x1E08F, 0x1E056,
+    0x1E01E, 0x1DFE6, 0x1DFAE, 0x1DF75, 0x1DF3D, 0x1DF05, 0x1DECD, 0x1DE95,
+    0x1DE5D, 0x1DE25, 0x1DDED, 0x1DDB5, 0x1DD7F, 0x1DD47, 0x1DD0F, 0x1DCD7,
+    0x1DCA1, 0x1DC69, 0x1DC31, 0x1DBF9, 0x1DBC3, 0x1DB8B, 0x1DB53, 0x1DB1E,
+    0x1DAE6, 0x1DAAE, 0x1DA79, 0x1DA41, 0x1DA0A, 0x1D9D3, 0x1D99D, 0x1D966,
+    0x1D930, 0x1D8F9, 0x1D8C1, 0x1D88C, 0x1D854, 0x1D81D, 0x1D7E8, 0x1D7B1,
+    0x1D77B, 0x1D746, 0x1D70F, 0x1D6D9, 0x1D6A3, 0x1D66C, 0x1D637, 0x1D600,
+    0x1D5CB, 0x1D596, 0x1D55E, 0x1D529, 0x1D4F3, 0x1D4BE, 0x1D489, 0x1D452,
+    0x1D41D, 0x1D3E8, 0x1D3B3, 0x1D37C, 0x1D348, 0x1D311, 0x1D2DC, 0x1D2A7,
+    0x1D273, 0x1D23E, 0x1D209, 0x1D1D4, 0x1D19E, 0x1D169, 0x1D135, 0x1D100,
+    0x1D0CB, 0x1D097, 0x1D062, 0x1D02D, 0x1CFF8, 0x1CFC3, 0x1CF8F, 0x1CF5A,
+    0x1CF28, 0x1CEF3, 0x1CEBF, 0x1CE8A, 0x1CE57, 0x1CE22, 0x1CDEE, 0x1CDBA,
+    0x1CD85, 0x1CD51, 0x1CD1D, 0x1CCE8, 0x1CCB5, 0x1CC81, 0x1CC4F, 0x1CC1B,
+    0x1CBE7, 0x1CBB3, 0x1CB80, 0x1CB4C, 0x1CB19, 0x1CAE5, 0x1CAB1, 0x1CA7F,
+    0x1CA4B, 0x1CA17, 0x1C9E5, 0x1C9B1, 0x1C97F, 0x1C94B, 0x1C919, 0x1C8E5,
+    0x1C8B3, 0x1C87F, 0x1C84C, 0x1C81A, 0x1C7E7, 0x1C7B4, 0x1C782, 0x1C74E,
+    0x1C71C, 0x1C6EB, 0x1C6B7, 0x1C685, 0x1C653, 0x1C620, 0x1C5EE, 0x1C5BB,
+    0x1C589, 0x1C558, 0x1C524, 0x1C4F2, 0x1C4C0, 0x1C48F, 0x1C45E, 0x1C42A,
+    0x1C3F9, 0x1C3C8, 0x1C396, 0x1C363, 0x1C332, 0x1C2FF, 0x1C2CE, 0x1C29C,
+    0x1C26B, 0x1C23A, 0x1C209, 0x1C1D8, 0x1C1A5, 0x1C174, 0x1C143, 0x1C112,
+    0x1C0E0, 0x1C0AF, 0x1C07E, 0x1C04D, 0x1C01B, 0x1BFEA, 0x1BFB9, 0x1BF88,
+    0x1BF59, 0x1BF28, 0x1BEF7, 0x1BEC6, 0x1BE96, 0x1BE65, 0x1BE34, 0x1BE03,
+    0x1BDD3, 0x1BDA2, 0x1BD71, 0x1BD40, 0x1BD10, 0x1BCE0, 0x1BCB1, 0x1BC80,
+    0x1BC50, 0x1BC1F, 0x1BBF0, 0x1BBC0, 0x1BB90, 0x1BB5F, 0x1BB2F, 0x1BB00,
+    0x1BAD0, 0x1BA9F, 0x1BA70, 0x1BA40, 0x1BA10, 0x1B9E0, 0x1B9B1, 0x1B981,
+    0x1B953, 0x1B922, 0x1B8F2, 0x1B8C4, 0x1B894, 0x1B865, 0x1B835, 0x1B807,
+    0x1B7D7, 0x1B7A8, 0x1B778, 0x1B74A, 0x1B71A, 0x1B6EA, 0x1B6BC, 0x1B68C,
+    0x1B65E, 0x1B630, 0x1B600, 0x1B5D2, 0x1B5A2, 0x1B574, 0x1B546, 0x1B516,
+    0x1B4E8, 0x1B4BA, 0x1B48A, 0x1B45C, 0x1B42D, 0x1B3FF, 0x1B3D1, 0x1B3A3,
+    0x1B375, 0x1B346, 0x1B318, 0x1B2EA, 0x1B2BC, 0x1B28D, 0x1B25F, 0x1B231,
+    0x1B203, 0x1B1D6, 0x1B1A8, 0x1B17A, 0x1B14C, 0x1B11E, 0x1B0F1, 0x1B0C3,
+    0x1B095, 0x1B066, 0x1B038, 0x1B00B, 0x1AFDE, 0x1AFB1, 0x1AF83, 0x1AF56,
+    0x1AF28, 0x1AEFB, 0x1AECD, 0x1AEA0, 0x1AE74, 0x1AE47, 0x1AE19, 0x1ADEC,
+    0x1ADBE, 0x1AD91, 0x1AD64, 0x1AD36, 0x1AD0A, 0x1ACDD, 0x1ACB1, 0x1AC84,
+    0x1AC57, 0x1AC2A, 0x1ABFE, 0x1ABD1, 0x1ABA3, 0x1AB78, 0x1AB4B, 0x1AB1E,
+    0x1AAF3, 0x1AAC6, 0x1AA99, 0x1AA6C, 0x1AA41, 0x1AA14, 0x1A9E7, 0x1A9BC,
+    0x1A98F, 0x1A962, 0x1A937, 0x1A90A, 0x1A8DE, 0x1A8B3, 0x1A886, 0x1A85B,
+    0x1A82E, 0x1A803, 0x1A7D7, 0x1A7AC, 0x1A77F, 0x1A753, 0x1A728, 0x1A6FB,
+    0x1A6D0, 0x1A6A5, 0x1A679, 0x1A64E, 0x1A621, 0x1A5F5, 0x1A5CA, 0x1A5A0,
+    0x1A575, 0x1A548, 0x1A51E, 0x1A4F3, 0x1A4C7, 0x1A49C, 0x1A471, 0x1A445,
+    0x1A41A, 0x1A3F0, 0x1A3C5, 0x1A399, 0x1A36E, 0x1A343, 0x1A319, 0x1A2EE,
+    0x1A2C3, 0x1A297, 0x1A26D, 0x1A242, 0x1A217, 0x1A1EC, 0x1A1C2, 0x1A197,
+    0x1A16D, 0x1A143, 0x1A118, 0x1A0EE, 0x1A0C3, 0x1A099, 0x1A06F, 0x1A044,
+    0x1A01A, 0x19FF0, 0x19FC6, 0x19F9B, 0x19F71, 0x19F47, 0x19F1D, 0x19EF3,
+    0x19EC9, 0x19E9F, 0x19E75, 0x19E4A, 0x19E21, 0x19DF7, 0x19DCD, 0x19DA3,
+    0x19D7B, 0x19D51, 0x19D27, 0x19CFD, 0x19CD3, 0x19CA9, 0x19C81, 0x19C57,
+    0x19C2D, 0x19C03, 0x19BDB, 0x19BB1, 0x19B87, 0x19B5F, 0x19B35, 0x19B0B,
+    0x19AE3, 0x19AB9, 0x19A90, 0x19A66, 0x19A3E, 0x19A15, 0x199EB, 0x199C3,
+    0x1999A, 0x19970, 0x19948, 0x1991E, 0x198F5, 0x198CE, 0x198A4, 0x1987C,
+    0x19853, 0x1982B, 0x19802, 0x197DA, 0x197B0, 0x19787, 0x1975F, 0x19736,
+    0x1970E, 0x196E7, 0x196BD, 0x19695, 0x1966D, 0x19644, 0x1961D, 0x195F3,
+    0x195CC, 0x195A4, 0x1957B, 0x19553, 0x1952B, 0x19503, 0x194DC, 0x194B2,
+    0x1948B, 0x19463, 0x1943A, 0x19413, 0x193EB, 0x193C3, 0x1939C, 0x19374,
+    0x1934D, 0x19324, 0x192FD, 0x192D5, 0x192AE, 0x19285, 0x1925E, 0x19237,
+    0x19210, 0x191E8, 0x191C1, 0x1919A, 0x19172, 0x1914B, 0x19124, 0x190FD,
+    0x190D6, 0x190AD, 0x19086, 0x1905F, 0x19038, 0x19011, 0x18FEA, 0x18FC3,
+    0x18F9C, 0x18F75, 0x18F4E, 0x18F27, 0x18F01, 0x18EDA, 0x18EB3, 0x18E8C,
+    0x18E65, 0x18E3E, 0x18E17, 0x18DF0, 0x18DCA, 0x18DA3, 0x18D7E, 0x18D57,
+    0x18D30, 0x18D09, 0x18CE3, 0x18CBD, 0x18C96, 0x18C6F, 0x18C4A, 0x18C24,
+    0x18BFD, 0x18BD6, 0x18BB1, 0x18B8A, 0x18B64, 0x18B3E, 0x18B17, 0x18AF2,
+    0x18ACC, 0x18AA5, 0x18A80, 0x18A59, 0x18A34, 0x18A0E, 0x189E7, 0x189C2,
+    0x1899C, 0x18975, 0x18951, 0x1892A, 0x18904, 0x188E0, 0x188B9, 0x18895,
+    0x1886E, 0x1884A, 0x18823, 0x187FE, 0x187D7, 0x187B3, 0x1878D, 0x18768,
+    0x18743, 0x1871D, 0x186F8, 0x186D2, 0x186AE, 0x18688, 0x18663, 0x1863D,
+    0x18618, 0x185F4, 0x185CE, 0x185A9, 0x18584, 0x1855E, 0x1853A, 0x18515,
+    0x184F1, 0x184CB, 0x184A6, 0x18482, 0x1845C, 0x18438, 0x18414, 0x183EE,
+    0x183C9, 0x183A5, 0x18381, 0x1835B, 0x18336, 0x18312, 0x182EE, 0x182CA,
+    0x182A5, 0x18280, 0x1825B, 0x18237, 0x18214, 0x181EE, 0x181CA, 0x181A6,
+    0x18181, 0x1815D, 0x18139, 0x18115, 0x180F0, 0x180CC, 0x180A8, 0x18084,
+    0x18060, 0x1803C, 0x18018, 0x17FF4, 0x17FD0, 0x17FAC, 0x17F88, 0x17F64,
+    0x17F40, 0x17F1C, 0x17EF9, 0x17ED5, 0x17EB2, 0x17E8E, 0x17E6A, 0x17E46,
+    0x17E22, 0x17DFF, 0x17DDB, 0x17DB7, 0x17D93, 0x17D70, 0x17D4D, 0x17D2A,
+    0x17D06, 0x17CE2, 0x17CBF, 0x17C9C, 0x17C78, 0x17C55, 0x17C32, 0x17C0F,
+    0x17BEB, 0x17BC8, 0x17BA5, 0x17B82, 0x17B5F, 0x17B3B, 0x17B18, 0x17AF6,
+    0x17AD2, 0x17AAF, 0x17A8D, 0x17A69, 0x17A47, 0x17A23, 0x17A00, 0x179DE,
+    0x179BB, 0x17997, 0x17975, 0x17952, 0x1792F, 0x1790D, 0x178EA, 0x178C8,
+    0x178A5, 0x17881, 0x1785F, 0x1783C, 0x1781A, 0x177F9, 0x177D5, 0x177B4,
+    0x17790, 0x1776F, 0x1774B, 0x1772A, 0x17707, 0x176E4, 0x176C2, 0x1769F,
+    0x1767E, 0x1765C, 0x17639, 0x17617, 0x175F5, 0x175D2, 0x175B0, 0x1758F,
+    0x1756D, 0x1754A, 0x17529, 0x17507, 0x174E4, 0x174C3, 0x174A1, 0x1747E,
+    0x1745D, 0x1743C, 0x1741A, 0x173F7, 0x173D5, 0x173B4, 0x17392, 0x17371,
+    0x17350, 0x1732D, 0x1730C, 0x172EA, 0x172C9, 0x172A6, 0x17285, 0x17264,
+    0x17242, 0x17221, 0x17200, 0x171DF, 0x171BD, 0x1719C, 0x1717B, 0x17159,
+    0x17138, 0x17116, 0x170F4, 0x170D3, 0x170B2, 0x17091, 0x17070, 0x1704F,
+    0x1702E, 0x1700D, 0x16FEC, 0x16FCB, 0x16FA9, 0x16F88, 0x16F67, 0x16F46,
+    0x16F27, 0x16F06, 0x16EE5, 0x16EC4, 0x16EA3, 0x16E82, 0x16E61, 0x16E40,
+    0x16E1F, 0x16DFF, 0x16DDE, 0x16DBD, 0x16D9D, 0x16D7C, 0x16D5B, 0x16D3A,
+    0x16D1B, 0x16CFA, 0x16CDA, 0x16CB9, 0x16C98, 0x16C77, 0x16C58, 0x16C37,
+    0x16C17, 0x16BF6, 0x16BD7, 0x16BB6, 0x16B95, 0x16B76, 0x16B55, 0x16B34,
+    0x16B15, 0x16AF5, 0x16AD4, 0x16AB3, 0x16A94, 0x16A74, 0x16A53, 0x16A34,
+    0x16A14, 0x169F3, 0x169D4, 0x169B4, 0x16994, 0x16974, 0x16955, 0x16934,
+    0x16915, 0x168F5, 0x168D4, 0x168B5, 0x16895, 0x16876, 0x16856, 0x16837,
+    0x16817, 0x167F8, 0x167D7, 0x167B8, 0x16797, 0x16779, 0x16758, 0x16739,
+    0x1671B, 0x166FA, 0x166DC, 0x166BB, 0x1669D, 0x1667C, 0x1665E, 0x1663E,
+    0x1661F, 0x16600, 0x165E0, 0x165C1, 0x165A2, 0x16582, 0x16563, 0x16544,
+    0x16526, 0x16506, 0x164E7, 0x164C8, 0x164A8, 0x1648A, 0x1646B, 0x1644B,
+    0x1642D, 0x1640E, 0x163EF, 0x163CF, 0x163B0, 0x16392, 0x16373, 0x16355,
+    0x16336, 0x16316, 0x162F8, 0x162D9, 0x162BB, 0x1629B, 0x1627C, 0x1625E,
+    0x16240, 0x16221, 0x16203, 0x161E4, 0x161C5, 0x161A7, 0x16189, 0x1616A,
+    0x1614C, 0x1612C, 0x1610E, 0x160EF, 0x160D1, 0x160B3, 0x16095, 0x16076,
+    0x16058, 0x1603A, 0x1601C, 0x15FFD, 0x15FDE, 0x15FC0, 0x15FA2, 0x15F84,
+    0x15F67, 0x15F49, 0x15F2B, 0x15F0C, 0x15EEE, 0x15ED0, 0x15EB2, 0x15E94,
+    0x15E76, 0x15E58, 0x15E39, 0x15E1B, 0x15DFF, 0x15DE1, 0x15DC2, 0x15DA4,
+    0x15D86, 0x15D68, 0x15D4A, 0x15D2C, 0x15D0F, 0x15CF1, 0x15CD4, 0x15CB6,
+    0x15C98, 0x15C7A, 0x15C5C, 0x15C40, 0x15C22, 0x15C04, 0x15BE8, 0x15BCA,
+    0x15BAC, 0x15B8E, 0x15B71, 0x15B53, 0x15B36, 0x15B18, 0x15AFB, 0x15ADE,
+    0x15AC0, 0x15AA2, 0x15A86, 0x15A68, 0x15A4C, 0x15A2E, 0x15A10, 0x159F4,
+    0x159D6, 0x159B8, 0x1599C, 0x1597E, 0x15961, 0x15945, 0x15927, 0x1590B,
+    0x158ED, 0x158CF, 0x158B3, 0x15896, 0x15879, 0x1585D, 0x1583F, 0x15823,
+    0x15805, 0x157E9, 0x157CC, 0x157AF, 0x15792, 0x15775, 0x15758, 0x1573B,
+    0x1571F, 0x15703, 0x156E5, 0x156C9, 0x156AC, 0x1568F, 0x15673, 0x15656,
+    0x15639, 0x1561D, 0x15600, 0x155E4, 0x155C6, 0x155AB, 0x1558F, 0x15571,
+    0x15555, 0x15539, 0x1551C, 0x15500, 0x154E3, 0x154C7, 0x154AB, 0x1548E,
+    0x15472, 0x15456, 0x1543A, 0x1541D, 0x15401, 0x153E5, 0x153CA, 0x153AC,
+    0x15390, 0x15375, 0x15359, 0x1533B, 0x15320, 0x15304, 0x152E8, 0x152CC,
+    0x152B1, 0x15293, 0x15278, 0x1525C, 0x15241, 0x15224, 0x15208, 0x151EC,
+    0x151D0, 0x151B5, 0x15199, 0x1517D, 0x15161, 0x15146, 0x1512A, 0x1510E,
+    0x150F3, 0x150D6, 0x150BA, 0x1509F, 0x15083, 0x15068, 0x1504C, 0x15031,
+    0x15015, 0x14FF9, 0x14FDE, 0x14FC2, 0x14FA6, 0x14F8B, 0x14F6F, 0x14F54,
+    0x14F3A, 0x14F1E, 0x14F03, 0x14EE7, 0x14ECC, 0x14EB0, 0x14E95, 0x14E79,
+    0x14E5E, 0x14E43, 0x14E27, 0x14E0C, 0x14DF2, 0x14DD6, 0x14DBB, 0x14D9F,
+    0x14D84, 0x14D69, 0x14D4D, 0x14D32, 0x14D17, 0x14CFC, 0x14CE2, 0x14CC7,
+    0x14CAB, 0x14C90, 0x14C75, 0x14C5B, 0x14C40, 0x14C24, 0x14C0A, 0x14BEF,
+    0x14BD4, 0x14BB9, 0x14B9F, 0x14B84, 0x14B69, 0x14B4E, 0x14B32, 0x14B19,
+    0x14AFD, 0x14AE2, 0x14AC8, 0x14AAD, 0x14A93, 0x14A78, 0x14A5D, 0x14A43,
+    0x14A28, 0x14A0D, 0x149F3, 0x149D8, 0x149BD, 0x149A3, 0x14988, 0x1496F,
+    0x14954, 0x14939, 0x1491F, 0x14904, 0x148EA, 0x148CF, 0x148B5, 0x1489A,
+    0x14881, 0x14866, 0x1484B, 0x14831, 0x14817, 0x147FD, 0x147E3, 0x147C9,
+    0x147AE, 0x14794, 0x14779, 0x14760, 0x14745, 0x1472B, 0x14711, 0x146F7,
+    0x146DE, 0x146C3, 0x146A9, 0x1468E, 0x14675, 0x1465A, 0x14641, 0x14626,
+    0x1460D, 0x145F3, 0x145D9, 0x145BF, 0x145A5, 0x1458A, 0x14571, 0x14558,
+    0x1453E, 0x14524, 0x1450A, 0x144F1, 0x144D6, 0x144BD, 0x144A3, 0x14489,
+    0x1446F, 0x14456, 0x1443D, 0x14422, 0x14409, 0x143F0, 0x143D6, 0x143BC,
+    0x143A2, 0x14389, 0x14370, 0x14355, 0x1433D, 0x14323, 0x14309, 0x142F0,
+    0x142D6, 0x142BD, 0x142A4, 0x14289, 0x14271, 0x14257, 0x1423E, 0x14224,
+    0x1420B, 0x141F2, 0x141D9, 0x141C0, 0x141A6, 0x1418C, 0x14173, 0x1415A,
+    0x14141, 0x14128, 0x1410F, 0x140F6, 0x140DC, 0x140C3, 0x140AA, 0x14091,
+    0x14078, 0x1405F, 0x14046, 0x1402D, 0x14014, 0x13FFB, 0x13FE2, 0x13FC9,
+    0x13FB0, 0x13F97, 0x13F7E, 0x13F65, 0x13F4C, 0x13F33, 0x13F1A, 0x13F01,
+    0x13EEA, 0x13ED1, 0x13EB8, 0x13E9F, 0x13E86, 0x13E6D, 0x13E54, 0x13E3C,
+    0x13E23, 0x13E0A, 0x13DF1, 0x13DD8, 0x13DC0, 0x13DA7, 0x13D8E, 0x13D76,
+    0x13D5E, 0x13D45, 0x13D2D, 0x13D14, 0x13CFB, 0x13CE2, 0x13CCB, 0x13CB2,
+    0x13C99, 0x13C80, 0x13C68, 0x13C50, 0x13C38, 0x13C1F, 0x13C07, 0x13BEF,
+    0x13BD6, 0x13BBD, 0x13BA6, 0x13B8D, 0x13B75, 0x13B5C, 0x13B44, 0x13B2C,
+    0x13B14, 0x13AFB, 0x13AE4, 0x13ACB, 0x13AB3, 0x13A9B, 0x13A82, 0x13A6B,
+    0x13A52, 0x13A3A, 0x13A22, 0x13A0A, 0x139F3, 0x139DA, 0x139C1, 0x139AA,
+    0x13992, 0x13979, 0x13962, 0x13949, 0x13932, 0x1391A, 0x13902, 0x138EA,
+    0x138D3, 0x138BA, 0x138A2, 0x1388B, 0x13873, 0x1385B, 0x13843, 0x1382C,
+    0x13814, 0x137FC, 0x137E4, 0x137CD, 0x137B4, 0x1379D, 0x13784, 0x1376D,
+    0x13756, 0x1373E, 0x13727, 0x1370F, 0x136F7, 0x136DF, 0x136C8, 0x136B0,
+    0x13699, 0x13682, 0x13669, 0x13652, 0x1363B, 0x13623, 0x1360C, 0x135F4,
+    0x135DD, 0x135C6, 0x135AE, 0x13597, 0x1357F, 0x13568, 0x13551, 0x13539,
+    0x13522, 0x1350B, 0x134F3, 0x134DC, 0x134C4, 0x134AD, 0x13496, 0x1347E,
+    0x13467, 0x13451, 0x1343A, 0x13422, 0x1340B, 0x133F4, 0x133DD, 0x133C5,
+    0x133AE, 0x13397, 0x13380, 0x13368, 0x13352, 0x1333B, 0x13324, 0x1330D,
+    0x132F6, 0x132DE, 0x132C8, 0x132B1, 0x1329A, 0x13282, 0x1326C, 0x13255,
+    0x1323E, 0x13227, 0x13211, 0x131FA, 0x131E3, 0x131CB, 0x131B5, 0x1319E,
+    0x13187, 0x13171, 0x1315A, 0x13143, 0x1312C, 0x13115, 0x130FF, 0x130E8,
+    0x130D2, 0x130BB, 0x130A4, 0x1308E, 0x13077, 0x13060, 0x1304A, 0x13033,
+    0x1301D, 0x13006, 0x12FEF, 0x12FD9, 0x12FC2, 0x12FAC, 0x12F95, 0x12F7F,
+    0x12F68, 0x12F52, 0x12F3B, 0x12F25, 0x12F0E, 0x12EF8, 0x12EE1, 0x12ECB,
+    0x12EB5, 0x12E9F, 0x12E88, 0x12E72, 0x12E5C, 0x12E46, 0x12E2F, 0x12E19,
+    0x12E02, 0x12DEC, 0x12DD6, 0x12DBF, 0x12DA9, 0x12D93, 0x12D7D, 0x12D66,
+    0x12D51, 0x12D3B, 0x12D24, 0x12D0E, 0x12CF8, 0x12CE1, 0x12CCC, 0x12CB6,
+    0x12CA0, 0x12C89, 0x12C73, 0x12C5E, 0x12C47, 0x12C31, 0x12C1C, 0x12C06,
+    0x12BF0, 0x12BD9, 0x12BC4, 0x12BAE, 0x12B98, 0x12B82, 0x12B6B, 0x12B56,
+    0x12B40, 0x12B2A, 0x12B15, 0x12AFF, 0x12AE9, 0x12AD4, 0x12ABD, 0x12AA7,
+    0x12A92, 0x12A7C, 0x12A66, 0x12A50, 0x12A3B, 0x12A25, 0x12A0F, 0x129FA,
+    0x129E4, 0x129CE, 0x129B9, 0x129A3, 0x1298E, 0x12977, 0x12963, 0x1294D,
+    0x12938, 0x12922, 0x1290C, 0x128F7, 0x128E1, 0x128CC, 0x128B6, 0x128A1,
+    0x1288B, 0x12875, 0x12860, 0x1284A, 0x12835, 0x12820, 0x1280A, 0x127F6,
+    0x127E0, 0x127CB, 0x127B5, 0x127A0, 0x1278A, 0x12774, 0x12760, 0x1274A,
+    0x12735, 0x12720, 0x1270A, 0x126F6, 0x126E0, 0x126CB, 0x126B5, 0x126A0,
+    0x1268C, 0x12676, 0x12661, 0x1264B, 0x12637, 0x12621, 0x1260D, 0x125F7,
+    0x125E2, 0x125CD, 0x125B8, 0x125A3, 0x1258E, 0x12578, 0x12564, 0x1254F,
+    0x1253A, 0x12525, 0x12510, 0x124FB, 0x124E6, 0x124D1, 0x124BC, 0x124A7,
+    0x12492, 0x1247E, 0x12468, 0x12453, 0x1243F, 0x1242A, 0x12416, 0x12400,
+    0x123EB, 0x123D7, 0x123C2, 0x123AD, 0x12398, 0x12384, 0x1236E, 0x1235A,
+    0x12345, 0x12331, 0x1231C, 0x12307, 0x122F2, 0x122DE, 0x122C9, 0x122B5,
+    0x122A1, 0x1228B, 0x12276, 0x12262, 0x1224E, 0x12239, 0x12224, 0x12210,
+    0x121FB, 0x121E7, 0x121D3, 0x121BE, 0x121A9, 0x12195, 0x12181, 0x1216C,
+    0x12158, 0x12143, 0x1212E, 0x1211A, 0x12106, 0x120F1, 0x120DD, 0x120C9,
+    0x120B4, 0x120A0, 0x1208C, 0x12077, 0x12063, 0x1204F, 0x1203B, 0x12026,
+    0x12012, 0x11FFE, 0x11FEA, 0x11FD5, 0x11FC1, 0x11FAD, 0x11F98, 0x11F84,
+    0x11F70, 0x11F5C, 0x11F48, 0x11F34, 0x11F1F, 0x11F0B, 0x11EF7, 0x11EE3,
+    0x11ED0, 0x11EBC, 0x11EA7, 0x11E93, 0x11E7F, 0x11E6B, 0x11E57, 0x11E43,
+    0x11E2F, 0x11E1B, 0x11E07, 0x11DF3, 0x11DE0, 0x11DCB, 0x11DB7, 0x11DA3,
+    0x11D8F, 0x11D7B, 0x11D67, 0x11D53, 0x11D3F, 0x11D2B, 0x11D18, 0x11D04,
+    0x11CF0, 0x11CDC, 0x11CC8, 0x11CB5, 0x11CA1, 0x11C8D, 0x11C7A, 0x11C66,
+    0x11C52, 0x11C3E, 0x11C2B, 0x11C17, 0x11C03, 0x11BEF, 0x11BDD, 0x11BC9,
+    0x11BB5, 0x11BA1, 0x11B8E, 0x11B7A, 0x11B66, 0x11B53, 0x11B3F, 0x11B2B,
+    0x11B18, 0x11B04, 0x11AF1, 0x11ADD, 0x11ACA, 0x11AB6, 0x11AA2, 0x11A8F,
+    0x11A7B, 0x11A68, 0x11A55, 0x11A41, 0x11A2E, 0x11A1A, 0x11A07, 0x119F4,
+    0x119E0, 0x119CC, 0x119BA, 0x119A6, 0x11992, 0x1197F, 0x1196C, 0x11959,
+    0x11945, 0x11931, 0x1191F, 0x1190B, 0x118F8, 0x118E5, 0x118D2, 0x118BE,
+    0x118AB, 0x11898, 0x11884, 0x11871, 0x1185E, 0x1184B, 0x11838, 0x11825,
+    0x11812, 0x117FF, 0x117EB, 0x117D9, 0x117C4, 0x117B2, 0x1179E, 0x1178C,
+    0x11779, 0x11765, 0x11753, 0x1173F, 0x1172D, 0x11719, 0x11707, 0x116F3,
+    0x116E0, 0x116CE, 0x116BA, 0x116A8, 0x11695, 0x11681, 0x1166F, 0x1165B,
+    0x11649, 0x11636, 0x11623, 0x11610, 0x115FE, 0x115EA, 0x115D8, 0x115C4,
+    0x115B2, 0x1159F, 0x1158C, 0x11579, 0x11567, 0x11553, 0x11541, 0x1152F,
+    0x1151C, 0x11509, 0x114F6, 0x114E4, 0x114D0, 0x114BE, 0x114AC, 0x11498,
+    0x11486, 0x11473, 0x11460, 0x1144D, 0x1143B, 0x11429, 0x11417, 0x11403,
+    0x113F1, 0x113DF, 0x113CC, 0x113B9, 0x113A7, 0x11394, 0x11381, 0x1136F,
+    0x1135C, 0x1134A, 0x11338, 0x11325, 0x11312, 0x11300, 0x112EE, 0x112DB,
+    0x112C9, 0x112B6, 0x112A4, 0x11291, 0x1127F, 0x1126C, 0x1125A, 0x11248,
+    0x11236, 0x11223, 0x11211, 0x111FF, 0x111ED, 0x111D9, 0x111C7, 0x111B5,
+    0x111A3, 0x11191, 0x1117E, 0x1116C, 0x1115A, 0x11147, 0x11135, 0x11123,
+    0x11111, 0x110FF, 0x110ED, 0x110DB, 0x110C8, 0x110B6, 0x110A4, 0x11092,
+    0x11080, 0x1106D, 0x1105B, 0x11049, 0x11037, 0x11025, 0x11013, 0x11001,
+    0x10FEF, 0x10FDD, 0x10FCB, 0x10FB9, 0x10FA6, 0x10F94, 0x10F82, 0x10F70,
+    0x10F5F, 0x10F4D, 0x10F3B, 0x10F29, 0x10F17, 0x10F05, 0x10EF3, 0x10EE1,
+    0x10ECF, 0x10EBD, 0x10EAB, 0x10E99, 0x10E88, 0x10E76, 0x10E64, 0x10E52,
+    0x10E40, 0x10E2E, 0x10E1C, 0x10E0B, 0x10DFA, 0x10DE8, 0x10DD6, 0x10DC4,
+    0x10DB2, 0x10DA0, 0x10D8E, 0x10D7C, 0x10D6B, 0x10D59, 0x10D47, 0x10D36,
+    0x10D25, 0x10D13, 0x10D01, 0x10CEF, 0x10CDD, 0x10CCB, 0x10CBB, 0x10CA9,
+    0x10C97, 0x10C85, 0x10C73, 0x10C62, 0x10C51, 0x10C3F, 0x10C2E, 0x10C1C,
+    0x10C0A, 0x10BF9, 0x10BE8, 0x10BD6, 0x10BC4, 0x10BB2, 0x10BA1, 0x10B90,
+    0x10B7E, 0x10B6C, 0x10B5C, 0x10B4A, 0x10B38, 0x10B28, 0x10B16, 0x10B04,
+    0x10AF3, 0x10AE2, 0x10AD0, 0x10ABE, 0x10AAE, 0x10A9C, 0x10A8A, 0x10A7A,
+    0x10A68, 0x10A56, 0x10A46, 0x10A34, 0x10A23, 0x10A12, 0x10A00, 0x109EF,
+    0x109DE, 0x109CC, 0x109BB, 0x109AA, 0x10998, 0x10988, 0x10976, 0x10965,
+    0x10954, 0x10942, 0x10932, 0x10920, 0x10910, 0x108FE, 0x108ED, 0x108DC,
+    0x108CB, 0x108BA, 0x108A8, 0x10897, 0x10886, 0x10876, 0x10864, 0x10854,
+    0x10842, 0x10832, 0x10820, 0x1080F, 0x107FE, 0x107ED, 0x107DC, 0x107CB,
+    0x107BA, 0x107A9, 0x10798, 0x10787, 0x10776, 0x10765, 0x10754, 0x10743,
+    0x10732, 0x10722, 0x10710, 0x10700, 0x106EF, 0x106DE, 0x106CD, 0x106BC,
+    0x106AC, 0x1069A, 0x1068A, 0x10678, 0x10668, 0x10657, 0x10647, 0x10635,
+    0x10625, 0x10614, 0x10603, 0x105F3, 0x105E2, 0x105D1, 0x105C1, 0x105AF,
+    0x1059F, 0x1058E, 0x1057D, 0x1056D, 0x1055C, 0x1054B, 0x1053B, 0x1052A,
+    0x10519, 0x10509, 0x104F8, 0x104E8, 0x104D7, 0x104C6, 0x104B6, 0x104A5,
+    0x10495, 0x10484, 0x10473, 0x10463, 0x10452, 0x10442, 0x10432, 0x10421,
+    0x10410, 0x10400, 0x103F0, 0x103DE, 0x103CE, 0x103BE, 0x103AE, 0x1039C,
+    0x1038C, 0x1037C, 0x1036C, 0x1035A, 0x1034B, 0x1033B, 0x10329, 0x10319,
+    0x10309, 0x102F9, 0x102E9, 0x102D8, 0x102C7, 0x102B7, 0x102A7, 0x10297,
+    0x10287, 0x10275, 0x10265, 0x10255, 0x10246, 0x10234, 0x10224, 0x10214,
+    0x10204, 0x101F4, 0x101E4, 0x101D4, 0x101C4, 0x101B2, 0x101A2, 0x10192,
+    0x10182, 0x10172, 0x10162, 0x10152, 0x10141, 0x10131, 0x10121, 0x10111,
+    0x10101, 0x100F1, 0x100E1, 0x100D1, 0x100C1, 0x100B1, 0x100A1, 0x10091,
+    0x10081, 0x1006F, 0x1005F, 0x1004F, 0x1003F, 0x1002F, 0x1001F, 0x1000F
+};
+
 /* ================================================================
  * GTE State  (all fields accessed via cpu->cp2_data / cpu->cp2_ctrl)
  *
@@ -171,6 +533,7 @@ enum
  * FLAG register helpers
  * ================================================================ */
 static uint32_t gte_flag;
+static int gte_flag_skip; /* 1 = FLAG is dead, skip the MAC overflow checks */
 
 static inline void flag_reset(void) { gte_flag = 0; }
 static inline void flag_set(int bit) { gte_flag |= (1u << bit); }
@@ -190,6 +553,8 @@ static inline void flag_update_bit31(void)
 static inline int64_t check_mac_overflow(int64_t val, int n)
 {
     /* n=1,2,3 -> flag bits 30,29,28 (positive), 27,26,25 (negative) */
+    if (gte_flag_skip)
+        return val;
     if (val > 0x7FFFFFFFFFFll)
         flag_set(30 + 1 - n);
     if (val < -0x80000000000ll)
@@ -206,6 +571,8 @@ static inline int64_t wrap44(int64_t val)
 /* Check MAC0 overflow (32-bit signed) */
 static inline int64_t check_mac0_overflow(int64_t val)
 {
+    if (gte_flag_skip)
+        return val;
     if (val > 0x7FFFFFFFll)
         flag_set(16);
     if (val < -0x80000000ll)
@@ -328,73 +695,104 @@ static inline uint8_t saturate_color(int ch, int32_t val)
 static inline int16_t lo16(uint32_t v) { return (int16_t)(v & 0xFFFF); }
 static inline int16_t hi16(uint32_t v) { return (int16_t)(v >> 16); }
 
+/* ================================================================
+ * Decoded matrix cache (see GTEMatrixCache in superpsx.h)
+ * ================================================================ */
+GTEMatrixDirty gte_matrix_dirty = {GTE_MTX_DIRTY_ALL}; /* all dirty at startup */
+static GTEMatrixCache gte_mtx;
+
+/* GTE registers live in R3000CPU (CPU_State); the decoded matrices are
+ * rebuilt from them on first use after a load */
+void GTE_State(StateIO *io)
+{
+    STATE_VAR(io, gte_flag);
+    if (io->load)
+        gte_matrix_dirty.all = GTE_MTX_DIRTY_ALL;
+}
+
+/* Unpack a 3x3 matrix stored as 16-bit pairs in ctrl[base..base+4]:
+ * element i (row*3 + col) is ctrl[base + i/2], lo half if i is even */
+static void gte_mtx_decode(R3000CPU *cpu, int16_t *m, int base)
+{
+    for (int i = 0; i < 9; i++)
+    {
+        uint32_t w = C(base + i / 2);
+        m[i] = (i & 1) ? hi16(w) : lo16(w);
+    }
+}
+
+static void gte_mtx_refresh(R3000CPU *cpu)
+{
+    uint8_t dirty = gte_matrix_dirty.lane[0];
+    if (dirty & GTE_MTX_RT)
+    {
+        gte_mtx_decode(cpu, gte_mtx.m[0], c_RT11RT12);
+        for (int i = 0; i < 3; i++)
+            gte_mtx.tr[0][i] = (int32_t)C(c_TRX + i);
+    }
+    if (dirty & GTE_MTX_LL)
+        gte_mtx_decode(cpu, gte_mtx.m[1], c_L11L12);
+    if (dirty & GTE_MTX_LC)
+        gte_mtx_decode(cpu, gte_mtx.m[2], c_LR1LR2);
+    if (dirty & GTE_MTX_BK)
+        for (int i = 0; i < 3; i++)
+            gte_mtx.tr[1][i] = (int32_t)C(c_RBK + i);
+    if (dirty & GTE_MTX_FC)
+        for (int i = 0; i < 3; i++)
+            gte_mtx.tr[2][i] = (int32_t)C(c_RFC + i);
+    gte_matrix_dirty.lane[0] = 0;
+}
+
+static inline const GTEMatrixCache *gte_matrices(R3000CPU *cpu)
+{
+    if (gte_matrix_dirty.lane[0])
+        gte_mtx_refresh(cpu);
+    return &gte_mtx;
+}
+
+const GTEMatrixCache *GTE_Matrices(R3000CPU *cpu)
+{
+    return gte_matrices(cpu);
+}
+
 /* ================================================================
  * Matrix / Vector accessors
  * ================================================================ */
 
 static int16_t get_matrix(R3000CPU *cpu, int mx, int row, int col)
 {
-    int base;
-    switch (mx)
+    if (mx < 3)
+        return gte_matrices(cpu)->m[mx][row * 3 + col];
+
+    /* mx=3: garbage matrix
+     * Row 0: -(R<<4), R<<4, IR0  (R = RGBC red byte)
+     * Row 1: R13, R13, R13       (R13 = lo16 of ctrl 1)
+     * Row 2: R22, R22, R22       (R22 = lo16 of ctrl 2) */
+    switch (row * 3 + col)
     {
     case 0:
-        base = 0;
-        break; /* Rotation (RT) */
+    {
+        int16_t r = (int16_t)(cpu->cp2_data[d_RGBC] & 0xFF);
+        return -(r << 4);
+    }
     case 1:
-        base = 8;
-        break; /* Light (L) */
-    case 2:
-        base = 16;
-        break; /* Color (LCM) */
-    default:
     {
-        /* mx=3: garbage matrix
-         * Row 0: -(R<<4), R<<4, IR0  (R = RGBC red byte)
-         * Row 1: R13, R13, R13       (R13 = lo16 of ctrl 1)
-         * Row 2: R22, R22, R22       (R22 = lo16 of ctrl 2) */
-        int idx = row * 3 + col;
-        switch (idx)
-        {
-        case 0:
-        {
-            int16_t r = (int16_t)(cpu->cp2_data[d_RGBC] & 0xFF);
-            return -(r << 4);
-        }
-        case 1:
-        {
-            int16_t r = (int16_t)(cpu->cp2_data[d_RGBC] & 0xFF);
-            return r << 4;
-        }
-        case 2:
-            return (int16_t)(int32_t)cpu->cp2_data[d_IR0];
-        case 3:
-            return lo16(cpu->cp2_ctrl[c_RT13RT21]);
-        case 4:
-            return lo16(cpu->cp2_ctrl[c_RT13RT21]);
-        case 5:
-            return lo16(cpu->cp2_ctrl[c_RT13RT21]);
-        case 6:
-            return lo16(cpu->cp2_ctrl[c_RT22RT23]);
-        case 7:
-            return lo16(cpu->cp2_ctrl[c_RT22RT23]);
-        case 8:
-            return lo16(cpu->cp2_ctrl[c_RT22RT23]);
-        default:
-            return 0;
-        }
+        int16_t r = (int16_t)(cpu->cp2_data[d_RGBC] & 0xFF);
+        return r << 4;
     }
+    case 2:
+        return (int16_t)(int32_t)cpu->cp2_data[d_IR0];
+    case 3:
+    case 4:
+    case 5:
+        return lo16(cpu->cp2_ctrl[c_RT13RT21]);
+    case 6:
+    case 7:
+    case 8:
+        return lo16(cpu->cp2_ctrl[c_RT22RT23]);
+    default:
+        return 0;
     }
-    /* Matrix layout in ctrl regs:
-     * row 0: base+0 lo=m11, base+0 hi=m12, base+1 lo=m13
-     * row 1: base+1 hi=m21, base+2 lo=m22, base+2 hi=m23
-     * row 2: base+3 lo=m31, base+3 hi=m32, base+4 lo=m33
-     * linear: i = row*3 + col, reg = base + i/2, lo if i even, hi if i odd */
-    int i = row * 3 + col;
-    int reg = base + i / 2;
-    if (i & 1)
-        return hi16(cpu->cp2_ctrl[reg]);
-    else
-        return lo16(cpu->cp2_ctrl[reg]);
 }
 
 /* Get vector element [comp] for vector v (0=V0, 1=V1, 2=V2, 3=IR) */
@@ -434,19 +832,9 @@ static int16_t get_vector(R3000CPU *cpu, int v, int comp)
 /* Get translation vector for cv: 0=TR, 1=BK, 2=FC (bugged), 3=None */
 static int32_t get_translation(R3000CPU *cpu, int cv, int comp)
 {
-    switch (cv)
-    {
-    case 0:
-        return (int32_t)cpu->cp2_ctrl[c_TRX + comp];
-    case 1:
-        return (int32_t)cpu->cp2_ctrl[c_RBK + comp];
-    case 2:
-        return (int32_t)cpu->cp2_ctrl[c_RFC + comp];
-    case 3:
-        return 0;
-    default:
-        return 0;
-    }
+    if (cv < 3)
+        return gte_matrices(cpu)->tr[cv][comp];
+    return 0;
 }
 
 /* ================================================================
@@ -492,22 +880,22 @@ static uint32_t gte_divide(uint16_t h, uint16_t sz3)
 {
     if (h < sz3 * 2)
     {
-        int z = 0;
-        uint16_t d = sz3;
-        while (z < 16 && !(d & 0x8000))
+        int z = __builtin_clz(sz3) - 16; /* sz3 != 0 here */
+        uint32_t n = (uint32_t)h << z;
+        uint32_t d = (uint32_t)sz3 << z;
+        uint32_t du;
+        if (!(d & 0xF))
+            du = gte_unr_recip[(d >> 4) & (GTE_UNR_RECIP_SIZE - 1)];
+        else
         {
-            z++;
-            d <<= 1;
+            uint32_t u_val = gte_unr_table[((d - 0x7FC0) >> 7)] + 0x101;
+            du = ((0x2000080u - (d * u_val)) >> 8);
+            du = ((0x0000080u + (du * u_val)) >> 8);
         }
-        uint64_t n = (uint64_t)h << z;
-        uint32_t du = d;
-        uint32_t u_val = gte_unr_table[((du - 0x7FC0) >> 7)] + 0x101;
-        du = ((0x2000080u - (du * u_val)) >> 8);
-        du = ((0x0000080u + (du * u_val)) >> 8);
-        n = ((n * du) + 0x8000) >> 16;
-        if (n > 0x1FFFF)
-            n = 0x1FFFF;
-        return (uint32_t)n;
+        uint64_t q = (((uint64_t)n * du) + 0x8000) >> 16;
+        if (q > 0x1FFFF)
+            q = 0x1FFFF;
+        return (uint32_t)q;
     }
     else
     {
@@ -696,10 +1084,12 @@ static void gte_rtps_core(R3000CPU *cpu, int v, int sf, int lm, int last)
     int16_t vx = get_vector(cpu, v, 0);
     int16_t vy = get_vector(cpu, v, 1);
     int16_t vz = get_vector(cpu, v, 2);
+    const GTEMatrixCache *mc = gte_matrices(cpu);
+    const int16_t *rt = mc->m[0];
 
-    int64_t tx = (int64_t)(int32_t)C(c_TRX) << 12;
-    int64_t ty = (int64_t)(int32_t)C(c_TRY) << 12;
-    int64_t tz = (int64_t)(int32_t)C(c_TRZ) << 12;
+    int64_t tx = (int64_t)mc->tr[0][0] << 12;
+    int64_t ty = (int64_t)mc->tr[0][1] << 12;
+    int64_t tz = (int64_t)mc->tr[0][2] << 12;
 
     /* Per-step 44-bit accumulator wrapping (same as MVMVA) */
 #define RTPS_STEP(acc_m, acc_hw, prod, ch)      \
@@ -713,21 +1103,21 @@ static void gte_rtps_core(R3000CPU *cpu, int v, int sf, int lm, int last)
 
     int64_t m1 = tx, hw1 = wrap44(tx);
     check_mac_overflow(tx, 1);
-    RTPS_STEP(m1, hw1, mul16(lo16(C(c_RT11RT12)), vx), 1);
-    RTPS_STEP(m1, hw1, mul16(hi16(C(c_RT11RT12)), vy), 1);
-    RTPS_STEP(m1, hw1, mul16(lo16(C(c_RT13RT21)), vz), 1);
+    RTPS_STEP(m1, hw1, mul16(rt[0], vx), 1);
+    RTPS_STEP(m1, hw1, mul16(rt[1], vy), 1);
+    RTPS_STEP(m1, hw1, mul16(rt[2], vz), 1);
 
     int64_t m2 = ty, hw2 = wrap44(ty);
     check_mac_overflow(ty, 2);
-    RTPS_STEP(m2, hw2, mul16(hi16(C(c_RT13RT21)), vx), 2);
-    RTPS_STEP(m2, hw2, mul16(lo16(C(c_RT22RT23)), vy), 2);
-    RTPS_STEP(m2, hw2, mul16(hi16(C(c_RT22RT23)), vz), 2);
+    RTPS_STEP(m2, hw2, mul16(rt[3], vx), 2);
+    RTPS_STEP(m2, hw2, mul16(rt[4], vy), 2);
+    RTPS_STEP(m2, hw2, mul16(rt[5], vz), 2);
 
     int64_t m3 = tz, hw3 = wrap44(tz);
     check_mac_overflow(tz, 3);
-    RTPS_STEP(m3, hw3, mul16(lo16(C(c_RT31RT32)), vx), 3);
-    RTPS_STEP(m3, hw3, mul16(hi16(C(c_RT31RT32)), vy), 3);
-    RTPS_STEP(m3, hw3, mul16(lo16(C(c_RT33)), vz), 3);
+    RTPS_STEP(m3, hw3, mul16(rt[6], vx), 3);
+    RTPS_STEP(m3, hw3, mul16(rt[7], vy), 3);
+    RTPS_STEP(m3, hw3, mul16(rt[8], vz), 3);
 
 #undef RTPS_STEP
 
@@ -833,9 +1223,10 @@ static void gte_cmd_avsz4(R3000CPU *cpu)
  * ================================================================ */
 static void gte_cmd_op(R3000CPU *cpu, int sf, int lm)
 {
-    int16_t d1 = lo16(C(c_RT11RT12));
-    int16_t d2 = lo16(C(c_RT22RT23));
-    int16_t d3 = lo16(C(c_RT33));
+    const int16_t *rt = gte_matrices(cpu)->m[0];
+    int16_t d1 = rt[0]; /* RT11 */
+    int16_t d2 = rt[4]; /* RT22 */
+    int16_t d3 = rt[8]; /* RT33 */
     int16_t ir1 = (int16_t)(int32_t)D(d_IR1);
     int16_t ir2 = (int16_t)(int32_t)D(d_IR2);
     int16_t ir3 = (int16_t)(int32_t)D(d_IR3);
@@ -1277,10 +1668,6 @@ uint32_t GTE_ReadCtrl(R3000CPU *cpu, int reg)
     return C(reg);
 }
 
-#ifdef _EE
-extern uint8_t vu0_matrix_dirty;
-#endif
-
 void GTE_WriteCtrl(R3000CPU *cpu, int reg, uint32_t val)
 {
     switch (reg)
@@ -1306,13 +1693,8 @@ void GTE_WriteCtrl(R3000CPU *cpu, int reg, uint32_t val)
         break;
     }
 
-    /* Mark VU0 matrix dirty for ctrl regs 0-20 */
-#ifdef _EE
-    if (reg <= 7)       vu0_matrix_dirty |= 0x01; /* RT */
-    else if (reg <= 12) vu0_matrix_dirty |= 0x02; /* LT */
-    else if (reg <= 15) vu0_matrix_dirty |= 0x04; /* BK */
-    else if (reg <= 20) vu0_matrix_dirty |= 0x08; /* LC */
-#endif
+    /* Mark the decoded matrix dirty in both cache lanes (ctrl regs 0-23) */
+    gte_matrix_dirty.all |= (uint16_t)(gte_ctrl_matrix_bit(reg) * 0x0101);
 }
 
 /* ================================================================
@@ -1425,17 +1807,15 @@ void GTE_Execute(uint32_t opcode, R3000CPU *cpu)
 #ifdef _EE /* PS2 EE target only */
 
 /* ---- VU0 matrix dirty bitmask ----
- * Bit 0: RT (ctrl 0-7), Bit 1: LT (ctrl 8-12),
- * Bit 2: BK (ctrl 13-15), Bit 3: LC (ctrl 16-20).
+ * vu0_matrix_dirty is lane 1 of gte_matrix_dirty (GTE_MTX_* bits).
  * Set at CTC2 write time, cleared at refresh time.
  * Replaces per-matrix snapshot comparison loops. */
-uint8_t vu0_matrix_dirty = 0x0F; /* all dirty at startup */
 
 /* Inline dirty checks — avoid function call overhead (~40 cycles/call with -pg) */
-#define VU0_RT_IS_DIRTY() (vu0_matrix_dirty & 0x01)
-#define VU0_LT_IS_DIRTY() (vu0_matrix_dirty & 0x02)
-#define VU0_BK_IS_DIRTY() (vu0_matrix_dirty & 0x04)
-#define VU0_LC_IS_DIRTY() (vu0_matrix_dirty & 0x08)
+#define VU0_RT_IS_DIRTY() (vu0_matrix_dirty & GTE_MTX_RT)
+#define VU0_LT_IS_DIRTY() (vu0_matrix_dirty & GTE_MTX_LL)
+#define VU0_BK_IS_DIRTY() (vu0_matrix_dirty & GTE_MTX_BK)
+#define VU0_LC_IS_DIRTY() (vu0_matrix_dirty & GTE_MTX_LC)
 
 /* Aligned float buffers for VU0 register loads */
 float vu0_rt_col1[4] __attribute__((aligned(16)));
@@ -1453,33 +1833,16 @@ void vu0_refresh_rt_matrix(R3000CPU *cpu)
     int32_t icol3[4] __attribute__((aligned(16)));
     int32_t itrans[4] __attribute__((aligned(16)));
 
-    uint32_t c0 = C(c_RT11RT12), c1 = C(c_RT13RT21);
-    uint32_t c2 = C(c_RT22RT23), c3 = C(c_RT31RT32);
-    uint32_t c4 = C(c_RT33);
-
-    /* Column 1: {R11, R21, R31, 0} */
-    icol1[0] = (int16_t)c0;        /* R11 = lo16(c0) */
-    icol1[1] = (int16_t)(c1 >> 16); /* R21 = hi16(c1) */
-    icol1[2] = (int16_t)c3;        /* R31 = lo16(c3) */
-    icol1[3] = 0;
-
-    /* Column 2: {R12, R22, R32, 0} */
-    icol2[0] = (int16_t)(c0 >> 16); /* R12 = hi16(c0) */
-    icol2[1] = (int16_t)c2;        /* R22 = lo16(c2) */
-    icol2[2] = (int16_t)(c3 >> 16); /* R32 = hi16(c3) */
-    icol2[3] = 0;
-
-    /* Column 3: {R13, R23, R33, 0} */
-    icol3[0] = (int16_t)c1;        /* R13 = lo16(c1) */
-    icol3[1] = (int16_t)(c2 >> 16); /* R23 = hi16(c2) */
-    icol3[2] = (int16_t)c4;        /* R33 = lo16(c4) */
-    icol3[3] = 0;
-
-    /* Translation: {TRX, TRY, TRZ, 0} — no scaling */
-    itrans[0] = (int32_t)C(c_TRX);
-    itrans[1] = (int32_t)C(c_TRY);
-    itrans[2] = (int32_t)C(c_TRZ);
-    itrans[3] = 0;
+    const GTEMatrixCache *mc = gte_matrices(cpu);
+    const int16_t *m = mc->m[0]; /* columns {R1n, R2n, R3n} */
+    for (int i = 0; i < 3; i++)
+    {
+        icol1[i] = m[i * 3 + 0];
+        icol2[i] = m[i * 3 + 1];
+        icol3[i] = m[i * 3 + 2];
+        itrans[i] = mc->tr[0][i]; /* Translation: {TRX, TRY, TRZ, 0} — no scaling */
+    }
+    icol1[3] = icol2[3] = icol3[3] = itrans[3] = 0;
 
     /* VU0 VITOF12: int32 → float / 4096  (rotation)
      * VU0 VITOF0:  int32 → float          (translation) */
@@ -1503,15 +1866,17 @@ void vu0_refresh_rt_matrix(R3000CPU *cpu)
         : "memory"
     );
 
-    vu0_matrix_dirty &= ~0x01; /* RT clean */
+    vu0_matrix_dirty &= ~GTE_MTX_RT; /* RT clean */
 }
 
 int vu0_rt_is_dirty(R3000CPU *cpu)
 {
     (void)cpu;
-    return (vu0_matrix_dirty & 0x01) != 0;
+    return (vu0_matrix_dirty & GTE_MTX_RT) != 0;
 }
 
+static void gte_rtps_finish(R3000CPU *cpu, int32_t mac1, int32_t mac2, int32_t mac3, int lm, int last);
+
 /* VU0 RTPS core: single vertex transform (sf=1 only)
  * Matrix already loaded in VF1-VF4 by caller. */
 static void gte_rtps_core_vu0(R3000CPU *cpu, int v, int lm, int last)
@@ -1543,10 +1908,13 @@ static void gte_rtps_core_vu0(R3000CPU *cpu, int v, int lm, int last)
         : "memory");
 
     /* Float → int32 MAC values (C compiler emits trunc.w.s or cvt.w.s) */
-    int32_t mac1 = (int32_t)result[0];
-    int32_t mac2 = (int32_t)result[1];
-    int32_t mac3 = (int32_t)result[2];
+    gte_rtps_finish(cpu, (int32_t)result[0], (int32_t)result[1], (int32_t)result[2], lm, last);
+}
 
+/* RTPS tail after the sf=1 matrix multiply: IR saturation, SZ push,
+ * UNR division, screen projection and depth cueing (exact integer). */
+static void gte_rtps_finish(R3000CPU *cpu, int32_t mac1, int32_t mac2, int32_t mac3, int lm, int last)
+{
     D(d_MAC1) = (uint32_t)mac1;
     D(d_MAC2) = (uint32_t)mac2;
     D(d_MAC3) = (uint32_t)mac3;
@@ -1646,24 +2014,14 @@ void vu0_refresh_lt_matrix(R3000CPU *cpu)
     int32_t icol2[4] __attribute__((aligned(16)));
     int32_t icol3[4] __attribute__((aligned(16)));
 
-    uint32_t c0 = C(c_L11L12), c1 = C(c_L13L21);
-    uint32_t c2 = C(c_L22L23), c3 = C(c_L31L32);
-    uint32_t c4 = C(c_L33);
-
-    icol1[0] = (int16_t)c0;         /* L11 */
-    icol1[1] = (int16_t)(c1 >> 16); /* L21 */
-    icol1[2] = (int16_t)c3;         /* L31 */
-    icol1[3] = 0;
-
-    icol2[0] = (int16_t)(c0 >> 16); /* L12 */
-    icol2[1] = (int16_t)c2;         /* L22 */
-    icol2[2] = (int16_t)(c3 >> 16); /* L32 */
-    icol2[3] = 0;
-
-    icol3[0] = (int16_t)c1;         /* L13 */
-    icol3[1] = (int16_t)(c2 >> 16); /* L23 */
-    icol3[2] = (int16_t)c4;         /* L33 */
-    icol3[3] = 0;
+    const int16_t *m = gte_matrices(cpu)->m[1]; /* columns {L1n, L2n, L3n} */
+    for (int i = 0; i < 3; i++)
+    {
+        icol1[i] = m[i * 3 + 0];
+        icol2[i] = m[i * 3 + 1];
+        icol3[i] = m[i * 3 + 2];
+    }
+    icol1[3] = icol2[3] = icol3[3] = 0;
 
     __asm__ __volatile__(
         "lqc2    $vf1, 0(%[ic1])\n\t"
@@ -1681,13 +2039,13 @@ void vu0_refresh_lt_matrix(R3000CPU *cpu)
         : "memory"
     );
 
-    vu0_matrix_dirty &= ~0x02; /* LT clean */
+    vu0_matrix_dirty &= ~GTE_MTX_LL; /* LT clean */
 }
 
 int vu0_lt_is_dirty(R3000CPU *cpu)
 {
     (void)cpu;
-    return (vu0_matrix_dirty & 0x02) != 0;
+    return (vu0_matrix_dirty & GTE_MTX_LL) != 0;
 }
 
 /* Color matrix cached float columns (mx=2, ctrl[16..20]) */
@@ -1701,24 +2059,14 @@ void vu0_refresh_lc_matrix(R3000CPU *cpu)
     int32_t icol2[4] __attribute__((aligned(16)));
     int32_t icol3[4] __attribute__((aligned(16)));
 
-    uint32_t c0 = C(c_LR1LR2), c1 = C(c_LR3LG1);
-    uint32_t c2 = C(c_LG2LG3), c3 = C(c_LB1LB2);
-    uint32_t c4 = C(c_LB3);
-
-    icol1[0] = (int16_t)c0;         /* LR1 */
-    icol1[1] = (int16_t)(c1 >> 16); /* LG1 */
-    icol1[2] = (int16_t)c3;         /* LB1 */
-    icol1[3] = 0;
-
-    icol2[0] = (int16_t)(c0 >> 16); /* LR2 */
-    icol2[1] = (int16_t)c2;         /* LG2 */
-    icol2[2] = (int16_t)(c3 >> 16); /* LB2 */
-    icol2[3] = 0;
-
-    icol3[0] = (int16_t)c1;         /* LR3 */
-    icol3[1] = (int16_t)(c2 >> 16); /* LG3 */
-    icol3[2] = (int16_t)c4;         /* LB3 */
-    icol3[3] = 0;
+    const int16_t *m = gte_matrices(cpu)->m[2]; /* columns {LRn, LGn, LBn} */
+    for (int i = 0; i < 3; i++)
+    {
+        icol1[i] = m[i * 3 + 0];
+        icol2[i] = m[i * 3 + 1];
+        icol3[i] = m[i * 3 + 2];
+    }
+    icol1[3] = icol2[3] = icol3[3] = 0;
 
     __asm__ __volatile__(
         "lqc2    $vf1, 0(%[ic1])\n\t"
@@ -1736,13 +2084,13 @@ void vu0_refresh_lc_matrix(R3000CPU *cpu)
         : "memory"
     );
 
-    vu0_matrix_dirty &= ~0x08; /* LC clean */
+    vu0_matrix_dirty &= ~GTE_MTX_LC; /* LC clean */
 }
 
 int vu0_lc_is_dirty(R3000CPU *cpu)
 {
     (void)cpu;
-    return (vu0_matrix_dirty & 0x08) != 0;
+    return (vu0_matrix_dirty & GTE_MTX_LC) != 0;
 }
 
 /* BK translation cached float (cv=1, ctrl[13..15]) */
@@ -1751,9 +2099,10 @@ float vu0_bk_trans[4] __attribute__((aligned(16)));
 void vu0_refresh_bk_trans(R3000CPU *cpu)
 {
     int32_t ibk[4] __attribute__((aligned(16)));
-    ibk[0] = (int32_t)C(c_RBK);
-    ibk[1] = (int32_t)C(c_GBK);
-    ibk[2] = (int32_t)C(c_BBK);
+    const int32_t *bk = gte_matrices(cpu)->tr[1];
+    ibk[0] = bk[0];
+    ibk[1] = bk[1];
+    ibk[2] = bk[2];
     ibk[3] = 0;
 
     __asm__ __volatile__(
@@ -1765,13 +2114,13 @@ void vu0_refresh_bk_trans(R3000CPU *cpu)
         : "memory"
     );
 
-    vu0_matrix_dirty &= ~0x04; /* BK clean */
+    vu0_matrix_dirty &= ~GTE_MTX_BK; /* BK clean */
 }
 
 int vu0_bk_is_dirty(R3000CPU *cpu)
 {
     (void)cpu;
-    return (vu0_matrix_dirty & 0x04) != 0;
+    return (vu0_matrix_dirty & GTE_MTX_BK) != 0;
 }
 
 /* Zero translation for cv=3 (None) */
@@ -2263,3 +2612,142 @@ void GTE_Inline_NCCT(R3000CPU *cpu, int sf, int lm)
     flag_update_bit31();
     C(c_FLAG) = gte_flag;
 }
+
+/* Flag-free variant (gte_lazy_flags): the JIT calls this for C-path
+ * commands whose FLAG result is overwritten by a later command before
+ * any CFC2 $31 can read it.  MAC/IR saturation still clamps; only the
+ * overflow bookkeeping is skipped, so the stored FLAG is partial. */
+void GTE_Inline_NoFlag(R3000CPU *cpu, uint32_t opcode)
+{
+    int sf = (opcode >> 19) & 1;
+    int lm = (opcode >> 10) & 1;
+    gte_flag_skip = 1;
+    switch (opcode & 0x3F)
+    {
+    case 0x01:
+        GTE_Inline_RTPS(cpu, sf, lm);
+        break;
+    case 0x30:
+        GTE_Inline_RTPT(cpu, sf, lm);
+        break;
+    default:
+        GTE_Execute(opcode, cpu);
+        break;
+    }
+    gte_flag_skip = 0;
+}
+
+/* ================================================================
+ * Batched Command Runs (gte_vu1_batch)
+ *
+ * The JIT queues runs of RTPS/RTPT/NCDS/NCDT/NCCS/NCCT that have no
+ * GTE reads in between into gte_batch[], each entry with a copy of the
+ * V0-V2/RGBC inputs it saw, and flushes the run with one call when the
+ * first MFC2/CFC2/SWC2 (or any other boundary) is reached.  Commands
+ * replay in order, so FIFOs, FLAG and IR0 end up exactly as if they
+ * had run one at a time.
+ *
+ * On PS2 with gte_vu0, the sf=1 RTPS/RTPT matrix multiplies of the
+ * whole run go to VU1 in one kick (rtps_batch.vsm, same float math as
+ * the VU0 path); the EE then only does the per-vertex tail.
+ * ================================================================ */
+GTEBatchEntry gte_batch[GTE_BATCH_MAX];
+
+#if defined(_EE) && defined(ENABLE_VU0_MICRO)
+#include "vu1_micro_ps2.h"
+
+static int gte_batch_is_rtp(uint32_t opcode)
+{
+    uint32_t func = opcode & 0x3F;
+    return (func == 0x01 || func == 0x30) && ((opcode >> 19) & 1);
+}
+
+/* Transform every sf=1 RTPS/RTPT vertex of the run on VU1.
+ * Returns the number of vertices in mac[] (0 = nothing worth a kick). */
+static int gte_batch_transform_vu1(R3000CPU *cpu, int count, int32_t (*mac)[4])
+{
+    static int32_t vert[GTE_BATCH_MAX * 3][4] __attribute__((aligned(16)));
+    int n = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        const GTEBatchEntry *e = &gte_batch[i];
+        if (!gte_batch_is_rtp(e->opcode))
+            continue;
+        int nv = ((e->opcode & 0x3F) == 0x01) ? 1 : 3;
+        for (int v = 0; v < nv; v++)
+        {
+            vert[n][0] = lo16(e->in[v * 2]);
+            vert[n][1] = hi16(e->in[v * 2]);
+            vert[n][2] = lo16(e->in[v * 2 + 1]);
+            vert[n][3] = 0;
+            n++;
+        }
+    }
+    if (n < 2)
+        return 0;
+
+    if (VU0_RT_IS_DIRTY())
+        vu0_refresh_rt_matrix(cpu);
+    vu1_micro_rtps_batch(vu0_rt_col1, vu0_rt_col2, vu0_rt_col3, vu0_rt_trans,
+                         (const int32_t (*)[4])vert, n, mac);
+    return n;
+}
+#endif
+
+void GTE_BatchFlush(R3000CPU *cpu, int count)
+{
+    uint32_t live[7];
+    memcpy(live, cpu->cp2_data, sizeof(live));
+
+#if defined(_EE) && defined(ENABLE_VU0_MICRO)
+    static int32_t mac[GTE_BATCH_MAX * 3][4] __attribute__((aligned(16)));
+    int nmac = gte_use_vu0 ? gte_batch_transform_vu1(cpu, count, mac) : 0;
+    int next = 0;
+#endif
+
+    for (int i = 0; i < count; i++)
+    {
+        const GTEBatchEntry *e = &gte_batch[i];
+        int sf = (e->opcode >> 19) & 1;
+        int lm = (e->opcode >> 10) & 1;
+        memcpy(cpu->cp2_data, e->in, sizeof(e->in));
+
+#if defined(_EE) && defined(ENABLE_VU0_MICRO)
+        if (nmac && gte_batch_is_rtp(e->opcode))
+        {
+            int nv = ((e->opcode & 0x3F) == 0x01) ? 1 : 3;
+            flag_reset();
+            for (int v = 0; v < nv; v++, next++)
+                gte_rtps_finish(cpu, mac[next][0], mac[next][1], mac[next][2], lm, v == nv - 1);
+            flag_update_bit31();
+            C(c_FLAG) = gte_flag;
+            continue;
+        }
+#endif
+        switch (e->opcode & 0x3F)
+        {
+        case 0x01:
+            GTE_Inline_RTPS(cpu, sf, lm);
+            break;
+        case 0x30:
+            GTE_Inline_RTPT(cpu, sf, lm);
+            break;
+        case 0x13:
+            GTE_Inline_NCDS(cpu, sf, lm);
+            break;
+        case 0x16:
+            GTE_Inline_NCDT(cpu, sf, lm);
+            break;
+        case 0x1B:
+            GTE_Inline_NCCS(cpu, sf, lm);
+            break;
+        case 0x3F:
+            GTE_Inline_NCCT(cpu, sf, lm);
+            break;
+        }
+    }
+
+    /* V0-V2/RGBC may have been rewritten after the last queued command */
+    memcpy(cpu->cp2_data, live, sizeof(live));
+}
@@ -9,6 +9,7 @@
 #include "gpu_state.h"
 #include "mdec.h"
 #include "config.h"
+#include "savestate.h"
 
 #ifdef LOG_TAG
 #undef LOG_TAG
@@ -67,6 +68,12 @@ static inline int handle_sio_irq_ack(uint32_t data)
 static uint32_t mem_ctrl[9];           /* 0x1F801000-0x1F801020 */
 static uint32_t ram_size = 0x00000B88; /* 0x1F801060 */
 
+void Hardware_State(StateIO *io)
+{
+    STATE_VAR(io, mem_ctrl);
+    STATE_VAR(io, ram_size);
+}
+
 void Init_Interrupts(void)
 {
     printf("PS2 VBlank Interrupt DISABLED (using cycle-accurate scheduler for PSX VBlank).\n");
@@ -92,85 +99,299 @@ void SignalInterrupt(uint32_t irq)
     }
 }
 
-uint32_t ReadHardware(uint32_t phys)
+/* ================================================================
+ *  I/O register dispatch table
+ *
+ *  0x1F801000-0x1F801FFF is split into 256 16-byte granules, indexed by
+ *  (phys - 0x1F801000) >> 4.  Each granule holds a read and a write
+ *  handler; handlers whose granule covers several registers decode the
+ *  exact address themselves.  Expansion 2 (0x1F802000+) stays inline.
+ * ================================================================ */
+
+#define HW_TABLE_SIZE 256
+
+static HwReadFn hw_read_table[HW_TABLE_SIZE];
+static HwWriteFn hw_write_table[HW_TABLE_SIZE];
+
+static uint32_t hw_read_none(uint32_t phys)
 {
-    /*
-     * Two-level dispatch: switch on 256-byte block for O(1) coarse routing,
-     * then fine-grained checks within each block.  The compiler generates a
-     * compact jump table for the outer switch (32 entries max).
-     */
-    uint32_t off = phys - PSX_MEM_CTRL_BASE; /* 0x0000-0x1FFF */
-    uint32_t result = 0;
+    (void)phys;
+    return 0;
+}
+
+static void hw_write_none(uint32_t phys, uint32_t data, int size)
+{
+    (void)phys;
+    (void)data;
+    (void)size;
+}
+
+/* ---- 0x1F801000-0x1F80102F: memory control ---- */
+static uint32_t hw_read_memctrl(uint32_t phys)
+{
+    return (phys < PSX_MEM_CTRL_END) ? mem_ctrl[(phys - PSX_MEM_CTRL_BASE) >> 2] : 0;
+}
+
+static void hw_write_memctrl(uint32_t phys, uint32_t data, int size)
+{
+    (void)size;
+    if (phys < PSX_MEM_CTRL_END)
+    {
+        mem_ctrl[(phys - PSX_MEM_CTRL_BASE) >> 2] = data;
+        if (psx_config.cycle_model && phys >= 0x1F801008)
+            jit_cost_refresh(mem_ctrl); /* Delay/size or COM_DELAY changed */
+    }
+}
+
+/* ---- 0x1F801040-0x1F80105F: SIO ---- */
+static void hw_write_sio(uint32_t phys, uint32_t data, int size)
+{
+    (void)size;
+    SIO_Write(phys, data);
+}
 
-    switch (off >> 8)
+/* ---- 0x1F801060: RAM size ---- */
+static uint32_t hw_read_ram_size(uint32_t phys)
+{
+    return (phys == PSX_RAM_SIZE_REG) ? ram_size : 0;
+}
+
+static void hw_write_ram_size(uint32_t phys, uint32_t data, int size)
+{
+    (void)size;
+    if (phys == PSX_RAM_SIZE_REG)
+        ram_size = data;
+}
+
+/* ---- 0x1F801070/74: interrupt controller ---- */
+static uint32_t hw_read_irq(uint32_t phys)
+{
+    if (phys == PSX_I_STAT)
+        return cpu.i_stat;
+    if (phys == PSX_I_MASK)
+        return cpu.i_mask;
+    return 0;
+}
+
+static void hw_write_irq(uint32_t phys, uint32_t data, int size)
+{
+    (void)size;
+    if (phys == PSX_I_STAT)
     {
-    case 0x00: /* 0x1F801000-0x1F8010FF: memctrl, SIO, IRQ, DMA */
-        if (phys == PSX_I_STAT)
-            result = cpu.i_stat;
-        else if (phys == PSX_I_MASK)
-            result = cpu.i_mask;
-        else if (phys < PSX_MEM_CTRL_END)
-            result = mem_ctrl[(phys - PSX_MEM_CTRL_BASE) >> 2];
-        else if (phys >= PSX_SIO_BASE && phys <= PSX_SIO_END)
-            result = SIO_Read(phys);
-        else if (phys == PSX_RAM_SIZE_REG)
-            result = ram_size;
-        else if (phys >= PSX_DMA_BASE)
-            result = DMA_Read(phys);
-        break;
-
-    case 0x01: /* 0x1F801100-0x1F8011FF: Timers */
-        result = Timers_Read(phys);
-        break;
-
-    case 0x08: /* 0x1F801800-0x1F8018FF: CDROM, GPU, MDEC */
-        if (phys <= 0x1F801803)
+        cpu.i_stat &= data;
+        /* CD-ROM level-triggered re-assertion: if the game acknowledged
+         * bit 2 but the CD-ROM IRQ condition is still active, re-set it
+         * immediately (replaces per-loop polling). */
+        if (cdrom_irq_active && !(cpu.i_stat & (1 << 2)))
+            cpu.i_stat |= (1 << 2);
+        if (handle_sio_irq_ack(data))
+            return;           /* SignalInterrupt already updates irq_pending + irq_pending_fast */
+        cpu.irq_pending = (cpu.i_stat & cpu.i_mask & PSX_IRQ_VALID_MASK) != 0;
+        cpu.irq_pending_fast = cpu.irq_pending & (cpu.cop0[PSX_COP0_SR] & 1);
+        if (cpu.irq_pending)
         {
-            uint32_t byte_val = CDROM_Read(phys) & 0xFF;
-            result = byte_val | (byte_val << 8) | (byte_val << 16) | (byte_val << 24);
+            sched_interrupt_chain = 1;
+            cap_cycles_for_irq();
         }
-        else if (phys == 0x1F801810)
-            result = GPU_Read();
-        else if (phys == 0x1F801814)
-            result = GPU_ReadStatus();
-        else if (phys == 0x1F801820)
-            result = MDEC_ReadData();
-        else if (phys == 0x1F801824)
-            result = MDEC_ReadStatus();
-        break;
-
-    case 0x0C: /* 0x1F801C00-0x1F801CFF: SPU (low half) */
-    case 0x0D: /* 0x1F801D00-0x1F801DFF: SPU (high half) */
+        return;
+    }
+    if (phys == PSX_I_MASK)
     {
-        uint32_t sreg = spu_register_offset(phys);
-        uint32_t lo = SPU_ReadReg(sreg);
-        uint32_t hi = ((phys + 2) < PSX_SPU_END) ? SPU_ReadReg(sreg + 1) : 0;
-        result = lo | (hi << 16);
-        break;
+        cpu.i_mask = data & PSX_I_MASK_VALID;
+        cpu.irq_pending = (cpu.i_stat & cpu.i_mask & PSX_IRQ_VALID_MASK) != 0;
+        cpu.irq_pending_fast = cpu.irq_pending & (cpu.cop0[PSX_COP0_SR] & 1);
+        if (cpu.irq_pending)
+        {
+            sched_interrupt_chain = 1;
+            cap_cycles_for_irq();
+        }
+        DLOG("I_MASK = %08X (VSync=%d CD=%d Timer0=%d Timer1=%d Timer2=%d)\n",
+             (unsigned)cpu.i_mask, (int)(cpu.i_mask & 1), (int)((cpu.i_mask >> 2) & 1),
+             (int)((cpu.i_mask >> 4) & 1), (int)((cpu.i_mask >> 5) & 1), (int)((cpu.i_mask >> 6) & 1));
     }
+}
 
-    case 0x10:
-    case 0x11:
-    case 0x12:
-    case 0x13: /* Expansion 2 */
-    case 0x14:
-    case 0x15:
-    case 0x16:
-    case 0x17:
-    case 0x18:
-    case 0x19:
-    case 0x1A:
-    case 0x1B:
-    case 0x1C:
-    case 0x1D:
-    case 0x1E:
-    case 0x1F:
-        result = 0xFFFFFFFF;
-        break;
+/* ---- 0x1F801080-0x1F8010FF: DMA ---- */
+static void hw_write_dma(uint32_t phys, uint32_t data, int size)
+{
+#ifdef ENABLE_VRAM_DUMP
+    if (phys >= 0x1F801090 && phys <= 0x1F80109F) {
+        static int ch1_log = 0;
+        if (ch1_log < 30) {
+            printf("[HW] DMA ch1 write: phys=%08X data=%08X size=%d\n",
+                   (unsigned)phys, (unsigned)data, size);
+            ch1_log++;
+        }
+    }
+#endif
+    (void)size;
+    DMA_Write(phys, data);
+}
+
+/* ---- 0x1F801100-0x1F8011FF: timers ---- */
+static void hw_write_timers(uint32_t phys, uint32_t data, int size)
+{
+    (void)size;
+    Timers_Write(phys, data);
+}
+
+/* ---- 0x1F801800-0x1F801803: CD-ROM (byte registers) ---- */
+static uint32_t hw_read_cdrom(uint32_t phys)
+{
+    if (phys > 0x1F801803)
+        return 0;
+    uint32_t byte_val = CDROM_Read(phys) & 0xFF;
+    return byte_val | (byte_val << 8) | (byte_val << 16) | (byte_val << 24);
+}
+
+static void hw_write_cdrom(uint32_t phys, uint32_t data, int size)
+{
+    (void)size;
+    if (phys <= 0x1F801803)
+        CDROM_Write(phys, data);
+}
 
-    default:
-        break;
+/* ---- 0x1F801810/14: GPU ---- */
+static uint32_t hw_read_gpu_data(uint32_t phys)
+{
+    (void)phys;
+    return GPU_Read();
+}
+
+static uint32_t hw_read_gpu_stat(uint32_t phys)
+{
+    (void)phys;
+    return GPU_ReadStatus();
+}
+
+static uint32_t hw_read_gpu(uint32_t phys)
+{
+    if (phys == 0x1F801810)
+        return GPU_Read();
+    if (phys == 0x1F801814)
+        return GPU_ReadStatus();
+    return 0;
+}
+
+static void hw_write_gpu(uint32_t phys, uint32_t data, int size)
+{
+    (void)size;
+    if (phys == 0x1F801810)
+        GPU_WriteGP0(data);
+    else if (phys == 0x1F801814)
+        GPU_WriteGP1(data);
+}
+
+/* ---- 0x1F801820/24: MDEC ---- */
+static uint32_t hw_read_mdec_data(uint32_t phys)
+{
+    (void)phys;
+    return MDEC_ReadData();
+}
+
+static uint32_t hw_read_mdec_stat(uint32_t phys)
+{
+    (void)phys;
+    return MDEC_ReadStatus();
+}
+
+static uint32_t hw_read_mdec(uint32_t phys)
+{
+    if (phys == 0x1F801820)
+        return MDEC_ReadData();
+    if (phys == 0x1F801824)
+        return MDEC_ReadStatus();
+    return 0;
+}
+
+static void hw_write_mdec(uint32_t phys, uint32_t data, int size)
+{
+    (void)size;
+    if (phys == 0x1F801820)
+        MDEC_WriteCommand(data);
+    else if (phys == 0x1F801824)
+        MDEC_WriteControl(data);
+}
+
+/* ---- 0x1F801C00-0x1F801DFF: SPU ---- */
+static uint32_t hw_read_spu(uint32_t phys)
+{
+    uint32_t sreg = spu_register_offset(phys);
+    uint32_t lo = SPU_ReadReg(sreg);
+    uint32_t hi = ((phys + 2) < PSX_SPU_END) ? SPU_ReadReg(sreg + 1) : 0;
+    return lo | (hi << 16);
+}
+
+static void hw_write_spu(uint32_t phys, uint32_t data, int size)
+{
+    uint32_t soff = spu_register_offset(phys);
+    SPU_WriteReg(soff, (uint16_t)data);
+    /* For 32-bit word writes, always write the upper halfword too even if
+     * it is zero (a zero upper halfword is a valid register value). */
+    if (size == 4 && (phys + 2) < PSX_SPU_END)
+        SPU_WriteReg(soff + 1, (uint16_t)(data >> 16));
+}
+
+static void hw_map(uint32_t first, uint32_t last, HwReadFn rd, HwWriteFn wr)
+{
+    uint32_t g;
+    for (g = (first - PSX_MEM_CTRL_BASE) >> 4; g <= (last - PSX_MEM_CTRL_BASE) >> 4; g++)
+    {
+        hw_read_table[g] = rd;
+        hw_write_table[g] = wr;
     }
+}
+
+void Init_HardwareTable(void)
+{
+    hw_map(0x1F801000, 0x1F801FFF, hw_read_none, hw_write_none);
+    hw_map(0x1F801000, 0x1F80102F, hw_read_memctrl, hw_write_memctrl);
+    hw_map(PSX_SIO_BASE, PSX_SIO_END, SIO_Read, hw_write_sio);
+    hw_map(PSX_RAM_SIZE_REG, PSX_RAM_SIZE_REG, hw_read_ram_size, hw_write_ram_size);
+    hw_map(PSX_I_STAT, PSX_I_MASK, hw_read_irq, hw_write_irq);
+    hw_map(PSX_DMA_BASE, 0x1F8010FF, DMA_Read, hw_write_dma);
+    hw_map(0x1F801100, 0x1F8011FF, Timers_Read, hw_write_timers);
+    hw_map(0x1F801800, 0x1F801803, hw_read_cdrom, hw_write_cdrom);
+    hw_map(0x1F801810, 0x1F801814, hw_read_gpu, hw_write_gpu);
+    hw_map(0x1F801820, 0x1F801824, hw_read_mdec, hw_write_mdec);
+    hw_map(PSX_SPU_BASE, PSX_SPU_END - 1, hw_read_spu, hw_write_spu);
+}
+
+/*
+ * hw_read_handler / hw_write_handler: handler for a known register, for
+ * the dynarec's const-address I/O accesses (called with the phys address).
+ * Reads of single-register devices return the exact register's handler,
+ * skipping the in-granule decode.  No bus penalty: the caller deducts it.
+ */
+HwReadFn hw_read_handler(uint32_t phys)
+{
+    switch (phys)
+    {
+    case 0x1F801810: return hw_read_gpu_data;
+    case 0x1F801814: return hw_read_gpu_stat;
+    case 0x1F801820: return hw_read_mdec_data;
+    case 0x1F801824: return hw_read_mdec_stat;
+    default: break;
+    }
+    uint32_t off = phys - PSX_MEM_CTRL_BASE;
+    return (off < 0x1000) ? hw_read_table[off >> 4] : NULL;
+}
+
+HwWriteFn hw_write_handler(uint32_t phys)
+{
+    uint32_t off = phys - PSX_MEM_CTRL_BASE;
+    return (off < 0x1000) ? hw_write_table[off >> 4] : NULL;
+}
+
+uint32_t ReadHardware(uint32_t phys)
+{
+    uint32_t off = phys - PSX_MEM_CTRL_BASE; /* 0x0000-0x1FFF */
+    uint32_t result = 0;
+
+    if (off < 0x1000)
+        result = hw_read_table[off >> 4](phys);
+    else if (off < 0x2000) /* Expansion 2 */
+        result = 0xFFFFFFFF;
 
     /* PSX I/O bus penalty: hardware register reads are slower than RAM due
      * to bus wait states (COM_DELAY register).  Deduct from cpu.cycles_left
@@ -189,141 +410,10 @@ void WriteHardware(uint32_t phys, uint32_t data, int size)
 {
     uint32_t off = phys - PSX_MEM_CTRL_BASE;
 
-    switch (off >> 8)
-    {
-    case 0x00: /* 0x1F801000-0x1F8010FF: memctrl, SIO, IRQ, DMA */
-        if (phys < PSX_MEM_CTRL_END)
-        {
-            mem_ctrl[(phys - PSX_MEM_CTRL_BASE) >> 2] = data;
-            return;
-        }
-        if (phys >= PSX_SIO_BASE && phys <= PSX_SIO_END)
-        {
-            SIO_Write(phys, data);
-            return;
-        }
-        if (phys == PSX_RAM_SIZE_REG)
-        {
-            ram_size = data;
-            return;
-        }
-        if (phys == PSX_I_STAT)
-        {
-            cpu.i_stat &= data;
-            /* CD-ROM level-triggered re-assertion: if the game acknowledged
-             * bit 2 but the CD-ROM IRQ condition is still active, re-set it
-             * immediately (replaces per-loop polling). */
-            if (cdrom_irq_active && !(cpu.i_stat & (1 << 2)))
-                cpu.i_stat |= (1 << 2);
-            if (handle_sio_irq_ack(data))
-                return;           /* SignalInterrupt already updates irq_pending + irq_pending_fast */
-            cpu.irq_pending = (cpu.i_stat & cpu.i_mask & PSX_IRQ_VALID_MASK) != 0;
-            cpu.irq_pending_fast = cpu.irq_pending & (cpu.cop0[PSX_COP0_SR] & 1);
-            if (cpu.irq_pending)
-            {
-                sched_interrupt_chain = 1;
-                cap_cycles_for_irq();
-            }
-            return;
-        }
-        if (phys == PSX_I_MASK)
-        {
-            cpu.i_mask = data & PSX_I_MASK_VALID;
-            cpu.irq_pending = (cpu.i_stat & cpu.i_mask & PSX_IRQ_VALID_MASK) != 0;
-            cpu.irq_pending_fast = cpu.irq_pending & (cpu.cop0[PSX_COP0_SR] & 1);
-            if (cpu.irq_pending)
-            {
-                sched_interrupt_chain = 1;
-                cap_cycles_for_irq();
-            }
-            DLOG("I_MASK = %08X (VSync=%d CD=%d Timer0=%d Timer1=%d Timer2=%d)\n",
-                 (unsigned)cpu.i_mask, (int)(cpu.i_mask & 1), (int)((cpu.i_mask >> 2) & 1),
-                 (int)((cpu.i_mask >> 4) & 1), (int)((cpu.i_mask >> 5) & 1), (int)((cpu.i_mask >> 6) & 1));
-            return;
-        }
-        if (phys >= PSX_DMA_BASE)
-        {
-#ifdef ENABLE_VRAM_DUMP
-            if (phys >= 0x1F801090 && phys <= 0x1F80109F) {
-                static int ch1_log = 0;
-                if (ch1_log < 30) {
-                    printf("[HW] DMA ch1 write: phys=%08X data=%08X size=%d\n",
-                           (unsigned)phys, (unsigned)data, size);
-                    ch1_log++;
-                }
-            }
-#endif
-            DMA_Write(phys, data);
-            return;
-        }
-        return;
-
-    case 0x01: /* 0x1F801100-0x1F8011FF: Timers */
-        Timers_Write(phys, data);
-        return;
-
-    case 0x08: /* 0x1F801800-0x1F8018FF: CDROM, GPU, MDEC */
-        if (phys <= 0x1F801803)
-        {
-            CDROM_Write(phys, data);
-            return;
-        }
-        if (phys == 0x1F801810)
-        {
-            GPU_WriteGP0(data);
-            return;
-        }
-        if (phys == 0x1F801814)
-        {
-            GPU_WriteGP1(data);
-            return;
-        }
-        /* MDEC writes */
-        if (phys == 0x1F801820) {
-            MDEC_WriteCommand(data);
-            return;
-        }
-        if (phys == 0x1F801824) {
-            MDEC_WriteControl(data);
-            return;
-        }
-        return;
-
-    case 0x0C: /* 0x1F801C00-0x1F801CFF: SPU (low half) */
-    case 0x0D: /* 0x1F801D00-0x1F801DFF: SPU (high half) */
-    {
-        uint32_t soff = spu_register_offset(phys);
-        SPU_WriteReg(soff, (uint16_t)data);
-        /* For 32-bit word writes, always write the upper halfword too even if
-         * it is zero (a zero upper halfword is a valid register value). */
-        if (size == 4 && (phys + 2) < PSX_SPU_END)
-            SPU_WriteReg(soff + 1, (uint16_t)(data >> 16));
-        return;
-    }
-
-    case 0x10:
-    case 0x11:
-    case 0x12:
-    case 0x13: /* Expansion 2 */
-    case 0x14:
-    case 0x15:
-    case 0x16:
-    case 0x17:
-    case 0x18:
-    case 0x19:
-    case 0x1A:
-    case 0x1B:
-    case 0x1C:
-    case 0x1D:
-    case 0x1E:
-    case 0x1F:
-        if (phys == 0x1F802002)
-            printf("%c", (char)data);
-        return;
-
-    default:
-        return;
-    }
+    if (off < 0x1000)
+        hw_write_table[off >> 4](phys, data, size);
+    else if (phys == 0x1F802002) /* Expansion 2: TTY */
+        printf("%c", (char)data);
 }
 
 void UpdateTimers(uint32_t cycles)
@@ -15,6 +15,9 @@
 #include "osd.h"
 #include "mdec.h"
 #include "memorycard.h"
+#include "scheduler.h"
+#include "benchmark.h"
+#include "mem_budget.h"
 
 /* Provided by the platform-specific main_*.c */
 extern char psx_exe_filename_buf[];
@@ -32,7 +35,8 @@ static int has_disc_extension(const char *filename)
     const char *ext = filename + len - 4;
     return (strcasecmp(ext, ".iso") == 0 ||
             strcasecmp(ext, ".bin") == 0 ||
-            strcasecmp(ext, ".cue") == 0);
+            strcasecmp(ext, ".cue") == 0 ||
+            strcasecmp(ext, ".pbp") == 0);
 }
 
 static int has_cue_extension(const char *filename)
@@ -43,11 +47,30 @@ static int has_cue_extension(const char *filename)
     return strcasecmp(filename + len - 4, ".cue") == 0;
 }
 
+/* Game ID = boot file name from SYSTEM.CNF without path and ";1",
+ * e.g. "cdrom:\SLUS_005.94;1" -> "SLUS_005.94" */
+static void boot_path_game_id(const char *boot_path, char *id, size_t len)
+{
+    const char *name = boot_path;
+    for (const char *p = boot_path; *p; p++)
+        if (*p == '\\' || *p == '/' || *p == ':')
+            name = p + 1;
+    size_t n = 0;
+    while (name[n] && name[n] != ';' && n + 1 < len)
+    {
+        id[n] = name[n];
+        n++;
+    }
+    id[n] = '\0';
+}
+
 void Init_SuperPSX(void)
 {
     printf("=== SuperPSX Initializing ===\n");
     fflush(stdout);
 
+    /* Before any large allocation, so the plan sees the whole heap */
+    MemBudget_Init();
     GPU_Backend_Init();
     gpu_trace_init();
     osd_boot_log("SuperPSX v0.2 - Native Dynarec");
@@ -94,7 +117,13 @@ void Init_SuperPSX(void)
             {
                 char boot_path[256];
                 if (ISOFS_ReadBootPath(boot_path, sizeof(boot_path)) == 0)
+                {
+                    char game_id[32];
                     osd_boot_log("Boot: %s", boot_path);
+                    boot_path_game_id(boot_path, game_id, sizeof(game_id));
+                    if (config_apply_game(game_id))
+                        osd_boot_log("Game settings: %s", game_id);
+                }
                 else
                     osd_boot_log("WARNING: No SYSTEM.CNF boot path");
             }
@@ -146,12 +175,20 @@ void Init_SuperPSX(void)
     osd_boot_log("BIOS loaded OK");
 
     Init_CPU();
+    GTE_RecordInit();
+    sched_unlimited_speed = psx_config.fast_forward;
+    Bench_Init();
     Init_Dynarec();
 
+    /* The budget the memory plan set aside for it */
+    if (psx_config.cdrom_preload)
+        ISO_PreloadStart(MemPool_Avail(MEM_POOL_CDROM));
+
     osd_boot_log("Starting execution...");
     fflush(stdout);
 
     Run_CPU();
+    MCD_Flush();
 
     printf("=== Execution Ended ===\n");
     fflush(stdout);
@@ -1,4 +1,5 @@
 #include "superpsx.h"
+#include "config.h"
 #include "interpreter.h"
 #include "scheduler.h"
 #include "loader.h"
@@ -83,13 +84,295 @@
 #define RT_BLTZAL  0x10
 #define RT_BGEZAL  0x11
 
-static inline int instruction_is_load(uint32_t opcode) {
-    uint32_t op = opcode >> 26;
-    return (op >= 0x20 && op <= 0x26);
+
+/*
+ * Decoded-instruction cache
+ *
+ * Each executed PC gets an entry with its handler, operand fields, the
+ * branch/jump target and the cycle cost, so the hot loop only fetches the
+ * opcode word and compares it with the entry.  Direct-mapped on the PC.
+ * The opcode compare (not jit_page_gen) is what invalidates: the page
+ * generation only moves for pages holding compiled blocks and never for
+ * byte/halfword stores, and the compare costs one load the fetch needs
+ * anyway.
+ */
+#define INTERP_CACHE_BITS 13
+#define INTERP_CACHE_SIZE (1 << INTERP_CACHE_BITS)
+#define INTERP_NO_PC      1 /* never a valid (aligned) PC */
+
+typedef struct InterpInsn InterpInsn;
+/* Returns nonzero when the instruction took an exception and the chain
+ * must stop */
+typedef int (*InterpFn)(const InterpInsn *d);
+
+struct InterpInsn {
+    InterpFn fn;
+    uint32_t pc;
+    uint32_t opcode;
+    int32_t imm;     /* sign-extended immediate (zero-extended for logic ops) */
+    uint32_t target; /* branch / jump destination */
+    uint8_t rs, rt, rd, shamt;
+    uint16_t cost;   /* jit_cost_insn() with a RAM data address */
+    uint8_t dest;    /* GPR written, 0 = none (load-delay cancel) */
+    uint8_t flags;   /* INSN_* */
+};
+
+#define INSN_LOAD   1 /* LB..LWR: does not suppress a pending load */
+#define INSN_BRANCH 2 /* branch or jump, taken or not */
+
+static InterpInsn interp_cache[INTERP_CACHE_SIZE];
+static int interp_cache_ready = 0;
+
+void interpreter_flush_cache(void) {
+    for (int i = 0; i < INTERP_CACHE_SIZE; i++)
+        interp_cache[i].pc = INTERP_NO_PC;
+    interp_cache_ready = 1;
+}
+
+static uint32_t branch_target = 0;
+static int branch_state = 0; /* 0=no branch, 1=in delay slot, 2=execute branch */
+
+static void do_branch(uint32_t target) {
+    branch_target = target;
+    branch_state = 1;
+}
+
+void interpreter_reset_state(void) {
+    branch_state = 0;
+    branch_target = 0;
+}
+
+#define R(n) cpu.regs[n]
+
+static int address_error(uint32_t addr, int code) {
+    cpu.cop0[PSX_COP0_BADVADDR] = addr;
+    cpu.pc = cpu.current_pc;
+    PSX_Exception(code); /* 4 = AdEL, 5 = AdES */
+    return 1;
+}
+
+static int load_delay(uint32_t rt, uint32_t val) {
+    cpu.load_delay_reg = rt;
+    cpu.load_delay_val = val;
+    return 0;
+}
+
+/* LWL/LWR merge with the pending commit value when it targets rt */
+static uint32_t lwx_base(uint32_t rt) {
+    if (cpu.load_commit_reg == rt && rt != 0)
+        return cpu.load_commit_val;
+    return cpu.regs[rt];
+}
+
+/* ---- SPECIAL ---- */
+static int op_sll(const InterpInsn *d)  { R(d->rd) = R(d->rt) << d->shamt; return 0; }
+static int op_srl(const InterpInsn *d)  { R(d->rd) = R(d->rt) >> d->shamt; return 0; }
+static int op_sra(const InterpInsn *d)  { R(d->rd) = (int32_t)R(d->rt) >> d->shamt; return 0; }
+static int op_sllv(const InterpInsn *d) { R(d->rd) = R(d->rt) << (R(d->rs) & 31); return 0; }
+static int op_srlv(const InterpInsn *d) { R(d->rd) = R(d->rt) >> (R(d->rs) & 31); return 0; }
+static int op_srav(const InterpInsn *d) { R(d->rd) = (int32_t)R(d->rt) >> (R(d->rs) & 31); return 0; }
+static int op_jr(const InterpInsn *d)   { do_branch(R(d->rs)); return 0; }
+static int op_jalr(const InterpInsn *d) {
+    uint32_t ret = d->pc + 8;
+    do_branch(R(d->rs));
+    if (d->rd) R(d->rd) = ret;
+    return 0;
 }
+static int op_syscall(const InterpInsn *d) {
+    if (psx_config.bios_hle)
+        global_cycles += (uint32_t)Helper_Syscall_HLE(d->pc);
+    else
+        Helper_Syscall_Exception(d->pc);
+    return 1;
+}
+static int op_break(const InterpInsn *d)   { Helper_Break_Exception(d->pc); return 1; }
+static int op_mfhi(const InterpInsn *d) { R(d->rd) = cpu.hi; return 0; }
+static int op_mthi(const InterpInsn *d) { cpu.hi = R(d->rs); return 0; }
+static int op_mflo(const InterpInsn *d) { R(d->rd) = cpu.lo; return 0; }
+static int op_mtlo(const InterpInsn *d) { cpu.lo = R(d->rs); return 0; }
+static int op_mult(const InterpInsn *d) {
+    int64_t val = (int64_t)(int32_t)R(d->rs) * (int64_t)(int32_t)R(d->rt);
+    cpu.hi = (uint32_t)(val >> 32);
+    cpu.lo = (uint32_t)val;
+    return 0;
+}
+static int op_multu(const InterpInsn *d) {
+    uint64_t val = (uint64_t)R(d->rs) * (uint64_t)R(d->rt);
+    cpu.hi = (uint32_t)(val >> 32);
+    cpu.lo = (uint32_t)val;
+    return 0;
+}
+static int op_div(const InterpInsn *d)  { Helper_DIV(R(d->rs), R(d->rt), &cpu.lo, &cpu.hi); return 0; }
+static int op_divu(const InterpInsn *d) { Helper_DIVU(R(d->rs), R(d->rt), &cpu.lo, &cpu.hi); return 0; }
+static int op_add(const InterpInsn *d)  { Helper_ADD(R(d->rs), R(d->rt), d->rd, d->pc); return 0; }
+static int op_addu(const InterpInsn *d) { R(d->rd) = R(d->rs) + R(d->rt); return 0; }
+static int op_sub(const InterpInsn *d)  { Helper_SUB(R(d->rs), R(d->rt), d->rd, d->pc); return 0; }
+static int op_subu(const InterpInsn *d) { R(d->rd) = R(d->rs) - R(d->rt); return 0; }
+static int op_and(const InterpInsn *d)  { R(d->rd) = R(d->rs) & R(d->rt); return 0; }
+static int op_or(const InterpInsn *d)   { R(d->rd) = R(d->rs) | R(d->rt); return 0; }
+static int op_xor(const InterpInsn *d)  { R(d->rd) = R(d->rs) ^ R(d->rt); return 0; }
+static int op_nor(const InterpInsn *d)  { R(d->rd) = ~(R(d->rs) | R(d->rt)); return 0; }
+static int op_slt(const InterpInsn *d)  { R(d->rd) = ((int32_t)R(d->rs) < (int32_t)R(d->rt)) ? 1 : 0; return 0; }
+static int op_sltu(const InterpInsn *d) { R(d->rd) = (R(d->rs) < R(d->rt)) ? 1 : 0; return 0; }
+static int op_nop(const InterpInsn *d)  { (void)d; return 0; }
+
+/* ---- Branches and jumps (target precomputed at decode) ---- */
+static int op_bltz(const InterpInsn *d) { if ((int32_t)R(d->rs) < 0) do_branch(d->target); return 0; }
+static int op_bgez(const InterpInsn *d) { if ((int32_t)R(d->rs) >= 0) do_branch(d->target); return 0; }
+static int op_bltzal(const InterpInsn *d) {
+    if ((int32_t)R(d->rs) < 0) do_branch(d->target);
+    R(31) = d->pc + 8;
+    return 0;
+}
+static int op_bgezal(const InterpInsn *d) {
+    if ((int32_t)R(d->rs) >= 0) do_branch(d->target);
+    R(31) = d->pc + 8;
+    return 0;
+}
+static int op_j(const InterpInsn *d)    { do_branch(d->target); return 0; }
+static int op_jal(const InterpInsn *d)  { do_branch(d->target); R(31) = d->pc + 8; return 0; }
+static int op_beq(const InterpInsn *d)  { if (R(d->rs) == R(d->rt)) do_branch(d->target); return 0; }
+static int op_bne(const InterpInsn *d)  { if (R(d->rs) != R(d->rt)) do_branch(d->target); return 0; }
+static int op_blez(const InterpInsn *d) { if ((int32_t)R(d->rs) <= 0) do_branch(d->target); return 0; }
+static int op_bgtz(const InterpInsn *d) { if ((int32_t)R(d->rs) > 0) do_branch(d->target); return 0; }
 
-static inline int instruction_writes_gpr(uint32_t opcode, int reg) {
-    if (reg == 0) return 0;
+/* ---- Immediate ALU ---- */
+static int op_addi(const InterpInsn *d)  { Helper_ADDI(R(d->rs), d->imm, d->rt, d->pc); return 0; }
+static int op_addiu(const InterpInsn *d) { R(d->rt) = R(d->rs) + d->imm; return 0; }
+static int op_slti(const InterpInsn *d)  { R(d->rt) = ((int32_t)R(d->rs) < d->imm) ? 1 : 0; return 0; }
+static int op_sltiu(const InterpInsn *d) { R(d->rt) = (R(d->rs) < (uint32_t)d->imm) ? 1 : 0; return 0; }
+static int op_andi(const InterpInsn *d)  { R(d->rt) = R(d->rs) & (uint32_t)d->imm; return 0; }
+static int op_ori(const InterpInsn *d)   { R(d->rt) = R(d->rs) | (uint32_t)d->imm; return 0; }
+static int op_xori(const InterpInsn *d)  { R(d->rt) = R(d->rs) ^ (uint32_t)d->imm; return 0; }
+static int op_lui(const InterpInsn *d)   { R(d->rt) = (uint32_t)d->imm << 16; return 0; }
+
+/* ---- Coprocessors ---- */
+static int op_mfc0(const InterpInsn *d) { return load_delay(d->rt, cpu.cop0[d->rd]); }
+static int op_mtc0(const InterpInsn *d) {
+    cpu.cop0[d->rd] = R(d->rt);
+    if (d->rd == PSX_COP0_SR)
+        cpu.irq_pending_fast = cpu.irq_pending & (R(d->rt) & 1);
+    return 0;
+}
+static int op_rfe(const InterpInsn *d) {
+    uint32_t sr = cpu.cop0[PSX_COP0_SR];
+    uint32_t mode = sr & 0x3F;
+    uint32_t new_mode = ((mode >> 2) & 0x0F) | (mode & 0x30);
+    (void)d;
+    cpu.cop0[PSX_COP0_SR] = (sr & ~0x3F) | new_mode;
+    cpu.irq_pending_fast = cpu.irq_pending & (cpu.cop0[PSX_COP0_SR] & 1);
+    return 0;
+}
+/* Coprocessor number in bits 26-27 of the opcode */
+static int op_cu(const InterpInsn *d) { Helper_CU_Exception(d->pc, (d->opcode >> 26) & 3); return 1; }
+static int op_mfc2(const InterpInsn *d) { R(d->rt) = GTE_ReadData(&cpu, d->rd); return 0; }
+static int op_cfc2(const InterpInsn *d) { R(d->rt) = GTE_ReadCtrl(&cpu, d->rd); return 0; }
+static int op_mtc2(const InterpInsn *d) { GTE_WriteData(&cpu, d->rd, R(d->rt)); return 0; }
+static int op_ctc2(const InterpInsn *d) { GTE_WriteCtrl(&cpu, d->rd, R(d->rt)); return 0; }
+static int op_gte(const InterpInsn *d) {
+    if (gte_record_active)
+        GTE_Record(&cpu, d->opcode);
+    GTE_Execute(d->opcode, &cpu);
+    return 0;
+}
+
+/* ---- Loads (rt == 0 decodes to op_nop for the plain ones) ---- */
+static int op_lb(const InterpInsn *d) {
+    return load_delay(d->rt, (int32_t)(int8_t)ReadByte(R(d->rs) + d->imm));
+}
+static int op_lbu(const InterpInsn *d) { return load_delay(d->rt, ReadByte(R(d->rs) + d->imm)); }
+static int op_lh(const InterpInsn *d) {
+    uint32_t addr = R(d->rs) + d->imm;
+    if (__builtin_expect(addr & 1, 0)) return address_error(addr, 4);
+    if (d->rt) load_delay(d->rt, (int32_t)(int16_t)ReadHalf(addr));
+    return 0;
+}
+static int op_lhu(const InterpInsn *d) {
+    uint32_t addr = R(d->rs) + d->imm;
+    if (__builtin_expect(addr & 1, 0)) return address_error(addr, 4);
+    if (d->rt) load_delay(d->rt, ReadHalf(addr));
+    return 0;
+}
+static int op_lw(const InterpInsn *d) {
+    uint32_t addr = R(d->rs) + d->imm;
+    if (__builtin_expect(addr & 3, 0)) return address_error(addr, 4);
+    if (d->rt) load_delay(d->rt, ReadWord(addr));
+    return 0;
+}
+static int op_lwl(const InterpInsn *d) {
+    return load_delay(d->rt, Helper_LWL(R(d->rs) + d->imm, lwx_base(d->rt)));
+}
+static int op_lwr(const InterpInsn *d) {
+    return load_delay(d->rt, Helper_LWR(R(d->rs) + d->imm, lwx_base(d->rt)));
+}
+static int op_lwc2(const InterpInsn *d) { /* Load Word to COP2 (GTE data register) */
+    uint32_t addr = R(d->rs) + d->imm;
+    if (__builtin_expect(addr & 3, 0)) return address_error(addr, 4);
+    GTE_WriteData(&cpu, d->rt, ReadWord(addr));
+    return 0;
+}
+
+/* ---- Stores ---- */
+static int op_sb(const InterpInsn *d) { WriteByte(R(d->rs) + d->imm, R(d->rt)); return 0; }
+static int op_sh(const InterpInsn *d) {
+    uint32_t addr = R(d->rs) + d->imm;
+    if (__builtin_expect(addr & 1, 0)) return address_error(addr, 5);
+    WriteHalf(addr, R(d->rt));
+    return 0;
+}
+static int op_sw(const InterpInsn *d) {
+    uint32_t addr = R(d->rs) + d->imm;
+    if (__builtin_expect(addr & 3, 0)) return address_error(addr, 5);
+    WriteWord(addr, R(d->rt));
+    return 0;
+}
+static int op_swl(const InterpInsn *d) { Helper_SWL(R(d->rs) + d->imm, R(d->rt)); return 0; }
+static int op_swr(const InterpInsn *d) { Helper_SWR(R(d->rs) + d->imm, R(d->rt)); return 0; }
+static int op_swc2(const InterpInsn *d) { /* Store Word from COP2 (GTE data register) */
+    uint32_t addr = R(d->rs) + d->imm;
+    if (__builtin_expect(addr & 3, 0)) return address_error(addr, 5);
+    WriteWord(addr, GTE_ReadData(&cpu, d->rt));
+    return 0;
+}
+
+static const InterpFn special_fn[64] = {
+    [FUNCT_SLL] = op_sll,     [FUNCT_SRL] = op_srl,       [FUNCT_SRA] = op_sra,
+    [FUNCT_SLLV] = op_sllv,   [FUNCT_SRLV] = op_srlv,     [FUNCT_SRAV] = op_srav,
+    [FUNCT_JR] = op_jr,       [FUNCT_JALR] = op_jalr,
+    [FUNCT_SYSCALL] = op_syscall, [FUNCT_BREAK] = op_break,
+    [FUNCT_MFHI] = op_mfhi,   [FUNCT_MTHI] = op_mthi,     [FUNCT_MFLO] = op_mflo,
+    [FUNCT_MTLO] = op_mtlo,   [FUNCT_MULT] = op_mult,     [FUNCT_MULTU] = op_multu,
+    [FUNCT_DIV] = op_div,     [FUNCT_DIVU] = op_divu,     [FUNCT_ADD] = op_add,
+    [FUNCT_ADDU] = op_addu,   [FUNCT_SUB] = op_sub,       [FUNCT_SUBU] = op_subu,
+    [FUNCT_AND] = op_and,     [FUNCT_OR] = op_or,         [FUNCT_XOR] = op_xor,
+    [FUNCT_NOR] = op_nor,     [FUNCT_SLT] = op_slt,       [FUNCT_SLTU] = op_sltu,
+};
+
+static const InterpFn primary_fn[64] = {
+    [OP_J] = op_j,         [OP_JAL] = op_jal,     [OP_BEQ] = op_beq,     [OP_BNE] = op_bne,
+    [OP_BLEZ] = op_blez,   [OP_BGTZ] = op_bgtz,   [OP_ADDI] = op_addi,   [OP_ADDIU] = op_addiu,
+    [OP_SLTI] = op_slti,   [OP_SLTIU] = op_sltiu, [OP_ANDI] = op_andi,   [OP_ORI] = op_ori,
+    [OP_XORI] = op_xori,   [OP_LUI] = op_lui,     [OP_COP1] = op_cu,     [OP_COP3] = op_cu,
+    [OP_LB] = op_lb,       [OP_LH] = op_lh,       [OP_LWL] = op_lwl,     [OP_LW] = op_lw,
+    [OP_LBU] = op_lbu,     [OP_LHU] = op_lhu,     [OP_LWR] = op_lwr,     [OP_SB] = op_sb,
+    [OP_SH] = op_sh,       [OP_SWL] = op_swl,     [OP_SW] = op_sw,       [OP_SWR] = op_swr,
+    [OP_LWC0] = op_cu,     [OP_LWC1] = op_cu,     [OP_LWC2] = op_lwc2,   [OP_LWC3] = op_cu,
+    [OP_SWC0] = op_cu,     [OP_SWC1] = op_cu,     [OP_SWC2] = op_swc2,   [OP_SWC3] = op_cu,
+};
+
+/* SPECIAL functs whose only effect is writing rd */
+static int special_rd_only(uint32_t funct) {
+    switch (funct) {
+        case FUNCT_JR: case FUNCT_JALR: case FUNCT_SYSCALL: case FUNCT_BREAK:
+        case FUNCT_MTHI: case FUNCT_MTLO: case FUNCT_MULT: case FUNCT_MULTU:
+        case FUNCT_DIV: case FUNCT_DIVU: case FUNCT_ADD: case FUNCT_SUB:
+            return 0;
+    }
+    return 1;
+}
+
+/* GPR an instruction writes (for cancelling a pending load), 0 = none */
+static uint32_t instruction_dest_gpr(uint32_t opcode) {
     uint32_t op = opcode >> 26;
     if (op == 0x00) {
         uint32_t func = opcode & 0x3F;
@@ -97,39 +380,110 @@ static inline int instruction_writes_gpr(uint32_t opcode, int reg) {
         if (func == 0x08) return 0; /* JR */
         if (func == 0x11 || func == 0x13) return 0; /* MTHI/MTLO */
         if (func == 0x0C || func == 0x0D) return 0; /* SYSCALL/BREAK */
-        return (((opcode >> 11) & 0x1F) == reg); /* RD */
+        return (opcode >> 11) & 0x1F; /* RD */
     }
-    if (op >= 0x08 && op <= 0x0F) return (((opcode >> 16) & 0x1F) == reg);
-    if (op >= 0x20 && op <= 0x26) return (((opcode >> 16) & 0x1F) == reg);
-    if (op == 0x03) return reg == 31;
-    if (op == 0x00 && (opcode & 0x3F) == 0x09) return (((opcode >> 11) & 0x1F) == reg);
-    if (op == 0x12) { /* COP2 */
-        if (((opcode >> 21) & 0x1F) == 0x00 || ((opcode >> 21) & 0x1F) == 0x02) { /* MFC2 / CFC2 */
-            return (((opcode >> 16) & 0x1F) == reg);
-        }
-    }
-    if (op == 0x10) { /* COP0 */
-        if (((opcode >> 21) & 0x1F) == 0x00) { /* MFC0 */
-            return (((opcode >> 16) & 0x1F) == reg);
-        }
+    if (op >= 0x08 && op <= 0x0F) return (opcode >> 16) & 0x1F;
+    if (op >= 0x20 && op <= 0x26) return (opcode >> 16) & 0x1F;
+    if (op == 0x03) return 31;
+    if (op == 0x12 || op == 0x10) { /* MFC2 / CFC2, MFC0 */
+        uint32_t sub = (opcode >> 21) & 0x1F;
+        if (sub == 0x00 || (op == 0x12 && sub == 0x02))
+            return (opcode >> 16) & 0x1F;
     }
     return 0;
 }
 
-static uint32_t branch_target = 0;
-static int branch_state = 0; /* 0=no branch, 1=in delay slot, 2=execute branch */
+static void interp_decode(InterpInsn *d, uint32_t pc, uint32_t opcode) {
+    uint32_t op = opcode >> 26;
+    uint32_t rs = (opcode >> 21) & 31;
+    uint32_t rt = (opcode >> 16) & 31;
+    uint32_t rd = (opcode >> 11) & 31;
+    InterpFn fn;
 
-static void do_branch(uint32_t target) {
-    branch_target = target;
-    branch_state = 1;
+    d->pc = pc;
+    d->opcode = opcode;
+    d->rs = rs;
+    d->rt = rt;
+    d->rd = rd;
+    d->shamt = (opcode >> 6) & 31;
+    d->imm = (int32_t)(int16_t)(opcode & 0xFFFF);
+    d->target = pc + 4 + ((uint32_t)d->imm << 2);
+    d->cost = (uint16_t)jit_cost_insn(opcode, pc, 0, 0);
+    d->dest = (uint8_t)instruction_dest_gpr(opcode);
+    d->flags = (op >= 0x20 && op <= 0x26) ? INSN_LOAD : 0;
+    if ((op >= OP_REGIMM && op <= OP_BGTZ) ||
+        (op == OP_SPECIAL && ((opcode & 63) == FUNCT_JR || (opcode & 63) == FUNCT_JALR)))
+        d->flags |= INSN_BRANCH;
+
+    switch (op) {
+        case OP_SPECIAL:
+            fn = special_fn[opcode & 63];
+            if (!fn)
+                fn = op_break; /* Invalid instruction */
+            else if (rd == 0 && special_rd_only(opcode & 63))
+                fn = op_nop; /* writes only $zero */
+            break;
+        case OP_REGIMM:
+            /* R3000A undocumented: only bit[0] matters for direction.
+             * Link only for exactly 0x10/0x11. */
+            if (rt == RT_BLTZAL)      fn = op_bltzal;
+            else if (rt == RT_BGEZAL) fn = op_bgezal;
+            else                      fn = (rt & 1) ? op_bgez : op_bltz;
+            break;
+        case OP_COP0:
+            if (rs == 0x00)      fn = rt ? op_mfc0 : op_nop;
+            else if (rs == 0x04) fn = op_mtc0;
+            else if (rs == 0x10) fn = op_rfe;
+            else                 fn = op_nop;
+            break;
+        case OP_COP2: /* GTE */
+            if (rs == 0x00)      fn = rt ? op_mfc2 : op_nop;
+            else if (rs == 0x02) fn = rt ? op_cfc2 : op_nop;
+            else if (rs == 0x04) fn = op_mtc2;
+            else if (rs == 0x06) fn = op_ctc2;
+            else                 fn = op_gte;
+            break;
+        default:
+            fn = primary_fn[op];
+            if (!fn)
+                fn = op_break;
+            else if (op == OP_J || op == OP_JAL)
+                d->target = ((pc + 4) & 0xF0000000) | ((opcode & 0x3FFFFFF) << 2);
+            else if (op >= OP_ANDI && op <= OP_LUI)
+                d->imm = (int32_t)(opcode & 0xFFFF);
+            if (rt == 0 && ((op >= OP_ADDIU && op <= OP_LUI) || op == OP_LB ||
+                            op == OP_LBU || op == OP_LWL || op == OP_LWR))
+                fn = op_nop; /* writes only $zero, no side effect */
+            break;
+    }
+    d->fn = fn;
 }
 
-void interpreter_reset_state(void) {
-    branch_state = 0;
-    branch_target = 0;
+/* Entry for pc, decoding on a miss.  Code outside RAM and BIOS (I/O,
+ * scratchpad) is fetched through ReadWord and decoded into a scratch
+ * entry every time. */
+static const InterpInsn *interp_fetch(uint32_t pc) {
+    static InterpInsn scratch;
+    uint8_t *host = mem_host(pc);
+
+    if (__builtin_expect(host == NULL, 0)) {
+        interp_decode(&scratch, pc, ReadWord(pc));
+        return &scratch;
+    }
+    uint32_t opcode = *(uint32_t *)host;
+    InterpInsn *d = &interp_cache[(pc >> 2) & (INTERP_CACHE_SIZE - 1)];
+    if (__builtin_expect(d->pc != pc || d->opcode != opcode, 0))
+        interp_decode(d, pc, opcode);
+    return d;
 }
 
-int run_interpreter_chain(uint64_t deadline) {
+/* Longest one_block run without a branch (the JIT's block limit is similar) */
+#define INTERP_BLOCK_MAX 256
+
+/* one_block: stop after the delay slot of the first branch, taken or
+ * not, an HLE call or an exception, ignoring the deadline.
+ * Used by run_interpreter_block for the JIT's fallback blocks. */
+static int interp_run(uint64_t deadline, int one_block) {
     /* branch_state/branch_target are NOT reset on entry — the function
      * may be re-entered after a deadline-triggered return.  However,
      * we guarantee we NEVER return with branch_state != 0: the outer
@@ -139,7 +493,12 @@ int run_interpreter_chain(uint64_t deadline) {
 
     extern int binary_loaded;
 
-    while (global_cycles < deadline || branch_state != 0) {
+    int count = 0, in_delay_slot = 0;
+
+    if (__builtin_expect(!interp_cache_ready, 0))
+        interpreter_flush_cache();
+
+    while (global_cycles < deadline || branch_state != 0 || one_block) {
         /* BIOS boot hook: the outer loop only checks between calls,
          * but the interpreter runs many instructions per call.
          * Check the idle-loop PCs so Phase 1 can detect them. */
@@ -151,7 +510,7 @@ int run_interpreter_chain(uint64_t deadline) {
         /* BIOS HLE hooks: intercept PSX BIOS call vectors A(xx), B(xx), C(xx).
          * The JIT injects these at compile time; the interpreter must do it at
          * runtime.  The functions are called with cpu.regs[9] = function number.
-         * Return value 1 = handled (abort and return to caller). */
+         * A nonzero return = handled (cycles to charge, cpu.pc = $ra). */
         {
             uint32_t phys = cpu.pc & 0x1FFFFFFF;
             if (__builtin_expect(phys == 0xA0 || phys == 0xB0 || phys == 0xC0, 0)) {
@@ -165,7 +524,9 @@ int run_interpreter_chain(uint64_t deadline) {
                 if (handled) {
                     /* HLE handled it — return to caller via $ra */
                     cpu.pc = cpu.regs[31];
-                    global_cycles += 10;
+                    global_cycles += (uint32_t)handled;
+                    if (one_block)
+                        return 0;
                     continue;
                 }
             }
@@ -180,10 +541,10 @@ int run_interpreter_chain(uint64_t deadline) {
         }
 
         cpu.current_pc = cpu.pc;
-        uint32_t opcode = ReadWord(cpu.pc);
-        
+        const InterpInsn *d = interp_fetch(cpu.pc);
+
         cpu.pc += 4; /* Advance PC */
-        
+
         /* Apply load delay pipeline */
         if (cpu.load_commit_reg) {
             /* If a new load targets the same register, the older commit is cancelled */
@@ -198,243 +559,23 @@ int run_interpreter_chain(uint64_t deadline) {
             cpu.load_commit_val = cpu.load_delay_val;
             cpu.load_delay_reg = 0;
         }
-        
-        uint32_t op = opcode >> 26;
-        uint32_t rs = (opcode >> 21) & 31;
-        uint32_t rt = (opcode >> 16) & 31;
-        uint32_t rd = (opcode >> 11) & 31;
-        uint32_t shamt = (opcode >> 6) & 31;
-        uint32_t funct = opcode & 63;
-        uint16_t imm = opcode & 0xFFFF;
-        int32_t imm_se = (int32_t)(int16_t)imm;
-        uint32_t target = opcode & 0x3FFFFFF;
 
         /* Execute instruction */
-        switch (op) {
-            case OP_SPECIAL:
-                switch (funct) {
-                    case FUNCT_SLL:  if (rd) cpu.regs[rd] = cpu.regs[rt] << shamt; break;
-                    case FUNCT_SRL:  if (rd) cpu.regs[rd] = cpu.regs[rt] >> shamt; break;
-                    case FUNCT_SRA:  if (rd) cpu.regs[rd] = (int32_t)cpu.regs[rt] >> shamt; break;
-                    case FUNCT_SLLV: if (rd) cpu.regs[rd] = cpu.regs[rt] << (cpu.regs[rs] & 31); break;
-                    case FUNCT_SRLV: if (rd) cpu.regs[rd] = cpu.regs[rt] >> (cpu.regs[rs] & 31); break;
-                    case FUNCT_SRAV: if (rd) cpu.regs[rd] = (int32_t)cpu.regs[rt] >> (cpu.regs[rs] & 31); break;
-                    case FUNCT_JR:   do_branch(cpu.regs[rs]); break;
-                    case FUNCT_JALR: {
-                        uint32_t ret = cpu.pc + 4;
-                        do_branch(cpu.regs[rs]);
-                        if (rd) cpu.regs[rd] = ret;
-                        break;
-                    }
-                    case FUNCT_SYSCALL: Helper_Syscall_Exception(cpu.current_pc); branch_state = 0; return 0;
-                    case FUNCT_BREAK:   Helper_Break_Exception(cpu.current_pc); branch_state = 0; return 0;
-                    case FUNCT_MFHI: if (rd) cpu.regs[rd] = cpu.hi; break;
-                    case FUNCT_MTHI: cpu.hi = cpu.regs[rs]; break;
-                    case FUNCT_MFLO: if (rd) cpu.regs[rd] = cpu.lo; break;
-                    case FUNCT_MTLO: cpu.lo = cpu.regs[rs]; break;
-                    case FUNCT_MULT: {
-                        int64_t val = (int64_t)(int32_t)cpu.regs[rs] * (int64_t)(int32_t)cpu.regs[rt];
-                        cpu.hi = (uint32_t)(val >> 32);
-                        cpu.lo = (uint32_t)val;
-                        break;
-                    }
-                    case FUNCT_MULTU: {
-                        uint64_t val = (uint64_t)cpu.regs[rs] * (uint64_t)cpu.regs[rt];
-                        cpu.hi = (uint32_t)(val >> 32);
-                        cpu.lo = (uint32_t)val;
-                        break;
-                    }
-                    case FUNCT_DIV:  Helper_DIV(cpu.regs[rs], cpu.regs[rt], &cpu.lo, &cpu.hi); break;
-                    case FUNCT_DIVU: Helper_DIVU(cpu.regs[rs], cpu.regs[rt], &cpu.lo, &cpu.hi); break;
-                    case FUNCT_ADD:  Helper_ADD(cpu.regs[rs], cpu.regs[rt], rd, cpu.current_pc); break;
-                    case FUNCT_ADDU: if (rd) cpu.regs[rd] = cpu.regs[rs] + cpu.regs[rt]; break;
-                    case FUNCT_SUB:  Helper_SUB(cpu.regs[rs], cpu.regs[rt], rd, cpu.current_pc); break;
-                    case FUNCT_SUBU: if (rd) cpu.regs[rd] = cpu.regs[rs] - cpu.regs[rt]; break;
-                    case FUNCT_AND:  if (rd) cpu.regs[rd] = cpu.regs[rs] & cpu.regs[rt]; break;
-                    case FUNCT_OR:   if (rd) cpu.regs[rd] = cpu.regs[rs] | cpu.regs[rt]; break;
-                    case FUNCT_XOR:  if (rd) cpu.regs[rd] = cpu.regs[rs] ^ cpu.regs[rt]; break;
-                    case FUNCT_NOR:  if (rd) cpu.regs[rd] = ~(cpu.regs[rs] | cpu.regs[rt]); break;
-                    case FUNCT_SLT:  if (rd) cpu.regs[rd] = ((int32_t)cpu.regs[rs] < (int32_t)cpu.regs[rt]) ? 1 : 0; break;
-                    case FUNCT_SLTU: if (rd) cpu.regs[rd] = (cpu.regs[rs] < cpu.regs[rt]) ? 1 : 0; break;
-                    default:
-                        Helper_Break_Exception(cpu.current_pc); /* Invalid instruction */
-                        branch_state = 0;
-                        return 0;
-                }
-                break;
-            case OP_REGIMM:
-                switch (rt) {
-                    case RT_BLTZ:   if ((int32_t)cpu.regs[rs] < 0) do_branch(cpu.pc + (imm_se << 2)); break;
-                    case RT_BGEZ:   if ((int32_t)cpu.regs[rs] >= 0) do_branch(cpu.pc + (imm_se << 2)); break;
-                    case RT_BLTZAL: {
-                        uint32_t ret = cpu.pc + 4;
-                        if ((int32_t)cpu.regs[rs] < 0) do_branch(cpu.pc + (imm_se << 2));
-                        cpu.regs[31] = ret;
-                        break;
-                    }
-                    case RT_BGEZAL: {
-                        uint32_t ret = cpu.pc + 4;
-                        if ((int32_t)cpu.regs[rs] >= 0) do_branch(cpu.pc + (imm_se << 2));
-                        cpu.regs[31] = ret;
-                        break;
-                    }
-                    default: {
-                        /* R3000A undocumented: only bit[0] matters for direction.
-                         * Link only for exactly 0x10/0x11 (handled above). */
-                        if (rt & 1) {
-                            if ((int32_t)cpu.regs[rs] >= 0) do_branch(cpu.pc + (imm_se << 2));
-                        } else {
-                            if ((int32_t)cpu.regs[rs] < 0) do_branch(cpu.pc + (imm_se << 2));
-                        }
-                        break;
-                    }
-                }
-                break;
-            case OP_J:   do_branch((cpu.pc & 0xF0000000) | (target << 2)); break;
-            case OP_JAL: {
-                uint32_t ret = cpu.pc + 4;
-                do_branch((cpu.pc & 0xF0000000) | (target << 2));
-                cpu.regs[31] = ret;
-                break;
-            }
-            case OP_BEQ:  if (cpu.regs[rs] == cpu.regs[rt]) do_branch(cpu.pc + (imm_se << 2)); break;
-            case OP_BNE:  if (cpu.regs[rs] != cpu.regs[rt]) do_branch(cpu.pc + (imm_se << 2)); break;
-            case OP_BLEZ: if ((int32_t)cpu.regs[rs] <= 0) do_branch(cpu.pc + (imm_se << 2)); break;
-            case OP_BGTZ: if ((int32_t)cpu.regs[rs] > 0) do_branch(cpu.pc + (imm_se << 2)); break;
-            case OP_ADDI: Helper_ADDI(cpu.regs[rs], imm_se, rt, cpu.current_pc); break;
-            case OP_ADDIU: if (rt) cpu.regs[rt] = cpu.regs[rs] + imm_se; break;
-            case OP_SLTI:  if (rt) cpu.regs[rt] = ((int32_t)cpu.regs[rs] < imm_se) ? 1 : 0; break;
-            case OP_SLTIU: if (rt) cpu.regs[rt] = (cpu.regs[rs] < (uint32_t)imm_se) ? 1 : 0; break;
-            case OP_ANDI:  if (rt) cpu.regs[rt] = cpu.regs[rs] & imm; break;
-            case OP_ORI:   if (rt) cpu.regs[rt] = cpu.regs[rs] | imm; break;
-            case OP_XORI:  if (rt) cpu.regs[rt] = cpu.regs[rs] ^ imm; break;
-            case OP_LUI:   if (rt) cpu.regs[rt] = imm << 16; break;
-            case OP_COP0:
-                switch (rs) {
-                    case 0x00: /* MFC0 */
-                        if (rt) {
-                            cpu.load_delay_reg = rt;
-                            cpu.load_delay_val = cpu.cop0[rd];
-                        }
-                        break;
-                    case 0x04: /* MTC0 */
-                        cpu.cop0[rd] = cpu.regs[rt];
-                        if (rd == PSX_COP0_SR)
-                            cpu.irq_pending_fast = cpu.irq_pending & (cpu.regs[rt] & 1);
-                        break;
-                    case 0x10: /* RFE */ {
-                        uint32_t sr = cpu.cop0[PSX_COP0_SR];
-                        uint32_t mode = sr & 0x3F;
-                        uint32_t new_mode = ((mode >> 2) & 0x0F) | (mode & 0x30);
-                        cpu.cop0[PSX_COP0_SR] = (sr & ~0x3F) | new_mode;
-                        cpu.irq_pending_fast = cpu.irq_pending & (cpu.cop0[PSX_COP0_SR] & 1);
-                        break;
-                    }
-                }
-                break;
-            case OP_COP1: /* Unused */ Helper_CU_Exception(cpu.current_pc, 1); branch_state = 0; return 0;
-            case OP_COP2: /* GTE */
-                if (rs == 0x00) { /* MFC2 */
-                    if (rt) { cpu.regs[rt] = GTE_ReadData(&cpu, rd); }
-                } else if (rs == 0x02) { /* CFC2 */
-                    if (rt) { cpu.regs[rt] = GTE_ReadCtrl(&cpu, rd); }
-                } else if (rs == 0x04) { /* MTC2 */
-                    GTE_WriteData(&cpu, rd, cpu.regs[rt]);
-                } else if (rs == 0x06) { /* CTC2 */
-                    GTE_WriteCtrl(&cpu, rd, cpu.regs[rt]);
-                } else {
-                    GTE_Execute(opcode, &cpu);
-                }
-                break;
-            case OP_COP3: /* Unused */ Helper_CU_Exception(cpu.current_pc, 3); branch_state = 0; return 0;
-            case OP_LB:  if (rt) { cpu.load_delay_reg = rt; cpu.load_delay_val = (int32_t)(int8_t)ReadByte(cpu.regs[rs] + imm_se); } break;
-            case OP_LH: {
-                uint32_t addr = cpu.regs[rs] + imm_se;
-                if (__builtin_expect(addr & 1, 0)) { cpu.cop0[PSX_COP0_BADVADDR] = addr; cpu.pc = cpu.current_pc; PSX_Exception(4); branch_state = 0; return 0; }
-                if (rt) { cpu.load_delay_reg = rt; cpu.load_delay_val = (int32_t)(int16_t)ReadHalf(addr); }
-                break;
-            }
-            case OP_LWL: {
-                uint32_t base_val = cpu.regs[rt];
-                /* Pipeline forward: use pending commit value if targeting same reg */
-                if (cpu.load_commit_reg == (uint32_t)rt && rt != 0)
-                    base_val = cpu.load_commit_val;
-                if (rt) { cpu.load_delay_reg = rt; cpu.load_delay_val = Helper_LWL(cpu.regs[rs] + imm_se, base_val); }
-                break;
-            }
-            case OP_LW: {
-                uint32_t addr = cpu.regs[rs] + imm_se;
-                if (__builtin_expect(addr & 3, 0)) { cpu.cop0[PSX_COP0_BADVADDR] = addr; cpu.pc = cpu.current_pc; PSX_Exception(4); branch_state = 0; return 0; }
-                if (rt) { cpu.load_delay_reg = rt; cpu.load_delay_val = ReadWord(addr); }
-                break;
-            }
-            case OP_LBU: if (rt) { cpu.load_delay_reg = rt; cpu.load_delay_val = ReadByte(cpu.regs[rs] + imm_se); } break;
-            case OP_LHU: {
-                uint32_t addr = cpu.regs[rs] + imm_se;
-                if (__builtin_expect(addr & 1, 0)) { cpu.cop0[PSX_COP0_BADVADDR] = addr; cpu.pc = cpu.current_pc; PSX_Exception(4); branch_state = 0; return 0; }
-                if (rt) { cpu.load_delay_reg = rt; cpu.load_delay_val = ReadHalf(addr); }
-                break;
-            }
-            case OP_LWR: {
-                uint32_t base_val = cpu.regs[rt];
-                /* Pipeline forward: use pending commit value if targeting same reg */
-                if (cpu.load_commit_reg == (uint32_t)rt && rt != 0)
-                    base_val = cpu.load_commit_val;
-                if (rt) { cpu.load_delay_reg = rt; cpu.load_delay_val = Helper_LWR(cpu.regs[rs] + imm_se, base_val); }
-                break;
-            }
-            case OP_SB:  WriteByte(cpu.regs[rs] + imm_se, cpu.regs[rt]); break;
-            case OP_SH: {
-                uint32_t addr = cpu.regs[rs] + imm_se;
-                if (__builtin_expect(addr & 1, 0)) { cpu.cop0[PSX_COP0_BADVADDR] = addr; cpu.pc = cpu.current_pc; PSX_Exception(5); branch_state = 0; return 0; }
-                WriteHalf(addr, cpu.regs[rt]);
-                break;
-            }
-            case OP_SWL: Helper_SWL(cpu.regs[rs] + imm_se, cpu.regs[rt]); break;
-            case OP_SW: {
-                uint32_t addr = cpu.regs[rs] + imm_se;
-                if (__builtin_expect(addr & 3, 0)) { cpu.cop0[PSX_COP0_BADVADDR] = addr; cpu.pc = cpu.current_pc; PSX_Exception(5); branch_state = 0; return 0; }
-                WriteWord(addr, cpu.regs[rt]);
-                break;
-            }
-            case OP_SWR: Helper_SWR(cpu.regs[rs] + imm_se, cpu.regs[rt]); break;
-            /* LWC/SWC mappings for COP0/COP2 are not valid in PSX except for GTE data, but standard doesn't use LWC2 usually.
-             * But for safety, intercept COP exceptions. */
-            case OP_LWC0: Helper_CU_Exception(cpu.current_pc, 0); branch_state = 0; return 0;
-            case OP_LWC1: Helper_CU_Exception(cpu.current_pc, 1); branch_state = 0; return 0;
-            case OP_LWC2: { /* Load Word to COP2 (GTE data register) */
-                uint32_t addr = cpu.regs[rs] + imm_se;
-                if (__builtin_expect(addr & 3, 0)) { cpu.cop0[PSX_COP0_BADVADDR] = addr; cpu.pc = cpu.current_pc; PSX_Exception(4); branch_state = 0; return 0; }
-                uint32_t val = ReadWord(addr);
-                GTE_WriteData(&cpu, rt, val);
-                break;
-            }
-            case OP_LWC3: Helper_CU_Exception(cpu.current_pc, 3); branch_state = 0; return 0;
-            case OP_SWC0: Helper_CU_Exception(cpu.current_pc, 0); branch_state = 0; return 0;
-            case OP_SWC1: Helper_CU_Exception(cpu.current_pc, 1); branch_state = 0; return 0;
-            case OP_SWC2: { /* Store Word from COP2 (GTE data register) */
-                uint32_t addr = cpu.regs[rs] + imm_se;
-                if (__builtin_expect(addr & 3, 0)) { cpu.cop0[PSX_COP0_BADVADDR] = addr; cpu.pc = cpu.current_pc; PSX_Exception(5); branch_state = 0; return 0; }
-                uint32_t val = GTE_ReadData(&cpu, rt);
-                WriteWord(addr, val);
-                break;
-            }
-            case OP_SWC3: Helper_CU_Exception(cpu.current_pc, 3); branch_state = 0; return 0;
-            default:
-                Helper_Break_Exception(cpu.current_pc);
-                branch_state = 0;
-                return 0;
+        if (__builtin_expect(d->fn(d), 0)) {
+            branch_state = 0;
+            return 0;
         }
 
         /* Cancel delayed load if this instruction overwrites its destination.
          * Note: hardware suppresses the load entirely if the overwriting
          * instruction is NOT a load itself. */
-        if (cpu.load_commit_reg && !instruction_is_load(opcode) &&
-            instruction_writes_gpr(opcode, cpu.load_commit_reg)) {
+        if (cpu.load_commit_reg && !(d->flags & INSN_LOAD) && d->dest == cpu.load_commit_reg) {
             cpu.load_commit_reg = 0;
         }
 
         /* Branches are executed after the delay slot (this instruction) */
+        int block_end = in_delay_slot;
+        in_delay_slot = d->flags & INSN_BRANCH;
         if (branch_state == 2) {
             cpu.pc = branch_target;
             branch_state = 0;
@@ -442,8 +583,10 @@ int run_interpreter_chain(uint64_t deadline) {
             branch_state = 2;
         }
 
-        { extern uint32_t r3000a_cycle_cost(uint32_t);
-          global_cycles += r3000a_cycle_cost(opcode); }
+        /* Data addresses aren't tracked here, so loads/stores are costed
+         * as RAM under cycle_model (the DRC's default for unknown bases) */
+        { static uint32_t cost_frac;
+          global_cycles += jit_cost_scaled(d->cost, &cost_frac); }
 
         /* Interrupt check is NOT done here.  The Phase-2 outer loop's
          * sync_hardware_and_interrupts() handles interrupt delivery at
@@ -460,9 +603,31 @@ int run_interpreter_chain(uint64_t deadline) {
             return 0;
         }
 
+        if (one_block) {
+            if (block_end || (++count >= INTERP_BLOCK_MAX && branch_state == 0))
+                return 0;
+            continue;
+        }
+
         if (global_cycles >= sched_cached_earliest && branch_state == 0) {
             return 0;
         }
     }
     return 0; /* RUN_RES_NORMAL — guaranteed branch_state == 0 */
 }
+
+int run_interpreter_chain(uint64_t deadline) {
+    return interp_run(deadline, 0);
+}
+
+void run_interpreter_block(void) {
+    interp_run(0, 1);
+    /* Compiled code has no load delay pipeline: land pending loads now */
+    if (cpu.load_commit_reg)
+        cpu.regs[cpu.load_commit_reg] = cpu.load_commit_val;
+    if (cpu.load_delay_reg)
+        cpu.regs[cpu.load_delay_reg] = cpu.load_delay_val;
+    cpu.regs[0] = 0;
+    cpu.load_commit_reg = 0;
+    cpu.load_delay_reg = 0;
+}
@@ -20,12 +20,38 @@
 
 #define LOG_TAG "ISOFS"
 
+/* ---- Directory index ----
+ *
+ * Built once by ISOFS_Init: every file and directory on the disc, keyed by
+ * its normalized path ("DIR/GAME.EXE" - uppercase, no ";1" version, no
+ * trailing '.').  Lookups hash the path and need no disc reads.
+ */
+#define ISOFS_INDEX_SLOTS 4096 /* power of two */
+#define ISOFS_NAME_POOL   (64 * 1024)
+#define ISOFS_MAX_DIRS    1024
+#define ISOFS_PATH_MAX    256
+
+typedef struct
+{
+    uint32_t hash;
+    uint32_t name; /* offset in isofs_names, 0 = free slot */
+    uint32_t lba;
+    uint32_t size;
+    uint8_t is_dir;
+} IsoIndexEntry;
+
+static IsoIndexEntry isofs_index[ISOFS_INDEX_SLOTS];
+static char isofs_names[ISOFS_NAME_POOL];
+static uint32_t isofs_names_used;
+static uint32_t isofs_index_count;
+
 /* ---- Internal state ---- */
 static struct
 {
     uint32_t root_dir_lba;  /* LBA of root directory extent */
     uint32_t root_dir_size; /* Size of root directory in bytes */
     int initialized;        /* 1 if PVD has been parsed */
+    int index_complete;     /* 1 if the whole tree fit in the index */
 } isofs_state;
 
 /* ---- ISO 9660 helpers ---- */
@@ -70,77 +96,190 @@ static int iso_name_match(const char *iso_name, int iso_name_len, const char *ta
     return 1; /* Match */
 }
 
-/* ---- Public API ---- */
+/* FNV-1a */
+static uint32_t path_hash(const char *path)
+{
+    uint32_t h = 2166136261u;
+    while (*path)
+        h = (h ^ (uint8_t)*path++) * 16777619u;
+    return h;
+}
 
-int ISOFS_Init(void)
+/*
+ * Normalize one name component into out: uppercase, drop the ";N" version
+ * and a trailing '.' (some discs have "FILE." for "FILE").  Returns the new
+ * length of out, or -1 if it would not fit.
+ */
+static int append_component(char *out, int out_len, const char *name, int name_len)
 {
-    uint8_t sector[ISO_SECTOR_SIZE];
+    const char *semi = memchr(name, ';', (size_t)name_len);
+    if (semi)
+        name_len = (int)(semi - name);
+    if (name_len > 0 && name[name_len - 1] == '.')
+        name_len--;
 
-    memset(&isofs_state, 0, sizeof(isofs_state));
+    if (out_len + (out_len ? 1 : 0) + name_len >= ISOFS_PATH_MAX)
+        return -1;
+    if (out_len)
+        out[out_len++] = '/';
+    for (int i = 0; i < name_len; i++)
+        out[out_len++] = (char)toupper((unsigned char)name[i]);
+    out[out_len] = '\0';
+    return out_len;
+}
 
-    if (!ISO_IsLoaded())
+/* Normalize a lookup path: '\\' or '/' separated, optional leading separator */
+static int normalize_path(char *out, const char *path)
+{
+    int len = 0;
+    out[0] = '\0';
+    while (*path)
     {
-        printf("[ISOFS] ERROR: No ISO image mounted\n");
-        return -1;
+        while (*path == '/' || *path == '\\')
+            path++;
+        const char *start = path;
+        while (*path && *path != '/' && *path != '\\')
+            path++;
+        if (path > start && (len = append_component(out, len, start, (int)(path - start))) < 0)
+            return -1;
     }
+    return len;
+}
 
-    /* Read Primary Volume Descriptor at LBA 16 */
-    if (ISO_ReadSector(16, sector) < 0)
+static const IsoIndexEntry *index_lookup(const char *path)
+{
+    uint32_t h = path_hash(path);
+    for (uint32_t i = 0; i < ISOFS_INDEX_SLOTS; i++)
     {
-        printf("[ISOFS] ERROR: Failed to read PVD at LBA 16\n");
-        return -2;
+        const IsoIndexEntry *e = &isofs_index[(h + i) & (ISOFS_INDEX_SLOTS - 1)];
+        if (!e->name)
+            return NULL;
+        if (e->hash == h && strcmp(&isofs_names[e->name], path) == 0)
+            return e;
     }
+    return NULL;
+}
 
-    /* Validate PVD */
-    if (sector[0] != 0x01)
+/* Returns the pool offset of the stored path, 0 if the index is full */
+static uint32_t index_insert(const char *path, int path_len, uint32_t lba, uint32_t size, int is_dir)
+{
+    if (isofs_index_count >= ISOFS_INDEX_SLOTS * 3 / 4 ||
+        isofs_names_used + (uint32_t)path_len + 1 > ISOFS_NAME_POOL)
+        return 0;
+
+    uint32_t h = path_hash(path);
+    IsoIndexEntry *e = &isofs_index[h & (ISOFS_INDEX_SLOTS - 1)];
+    for (uint32_t i = 1; e->name; i++)
     {
-        printf("[ISOFS] ERROR: PVD type byte is 0x%02X, expected 0x01\n", sector[0]);
-        return -3;
+        if (e->hash == h && strcmp(&isofs_names[e->name], path) == 0)
+            return e->name; /* duplicate record (multi-extent file) */
+        e = &isofs_index[(h + i) & (ISOFS_INDEX_SLOTS - 1)];
     }
 
-    if (memcmp(&sector[1], "CD001", 5) != 0)
+    e->hash = h;
+    e->name = isofs_names_used;
+    e->lba = lba;
+    e->size = size;
+    e->is_dir = (uint8_t)is_dir;
+    memcpy(&isofs_names[isofs_names_used], path, (size_t)path_len + 1);
+    isofs_names_used += (uint32_t)path_len + 1;
+    isofs_index_count++;
+    return e->name;
+}
+
+/*
+ * Walk the directory tree breadth-first (the order mastering tools lay the
+ * extents out in) and index every record.  Returns 1 if everything fit.
+ */
+static int build_index(void)
+{
+    static struct
     {
-        printf("[ISOFS] ERROR: PVD signature mismatch (expected 'CD001')\n");
-        return -3;
-    }
+        uint32_t lba, size, path; /* path: pool offset of the directory name */
+    } dirs[ISOFS_MAX_DIRS];
+    uint8_t sector[ISO_SECTOR_SIZE];
+    char path[ISOFS_PATH_MAX];
+    int complete = 1;
 
-    printf("[ISOFS] Primary Volume Descriptor found at LBA 16\n");
+    memset(isofs_index, 0, sizeof(isofs_index));
+    isofs_names[0] = '\0';  /* offset 0: the root, and the free-slot marker */
+    isofs_names_used = 1;
+    isofs_index_count = 0;
 
-    /* Volume identifier (bytes 40-71, 32 chars, padded with spaces) */
-    char vol_id[33];
-    memcpy(vol_id, &sector[40], 32);
-    vol_id[32] = '\0';
-    /* Trim trailing spaces */
-    for (int i = 31; i >= 0 && vol_id[i] == ' '; i--)
-        vol_id[i] = '\0';
-    printf("[ISOFS] Volume ID: \"%s\"\n", vol_id);
+    uint32_t ndirs = 1;
+    dirs[0].lba = isofs_state.root_dir_lba;
+    dirs[0].size = isofs_state.root_dir_size;
+    dirs[0].path = 0;
 
-    /* Root directory record starts at PVD offset 156, length 34 bytes */
-    const uint8_t *root_record = &sector[156];
+    for (uint32_t d = 0; d < ndirs; d++)
+    {
+        uint32_t sectors = (dirs[d].size + ISO_SECTOR_SIZE - 1) / ISO_SECTOR_SIZE;
 
-    /* Extract root directory extent LBA (offset 2 within record, little-endian) */
-    isofs_state.root_dir_lba = read_le32(&root_record[2]);
+        for (uint32_t s = 0; s < sectors; s++)
+        {
+            if (ISO_ReadSector(dirs[d].lba + s, sector) < 0)
+            {
+                DLOG("Index: failed to read directory sector at LBA %" PRIu32 "\n", dirs[d].lba + s);
+                complete = 0;
+                break;
+            }
 
-    /* Extract root directory data length (offset 10, little-endian) */
-    isofs_state.root_dir_size = read_le32(&root_record[10]);
+            uint32_t pos = 0;
+            while (pos < ISO_SECTOR_SIZE)
+            {
+                uint8_t record_len = sector[pos];
+                if (record_len == 0)
+                    break;
+                if (record_len < 33 || pos + record_len > ISO_SECTOR_SIZE)
+                    break;
+
+                uint8_t name_len = sector[pos + 32];
+                const char *file_name = (const char *)&sector[pos + 33];
+                int is_dir = (sector[pos + 25] & 0x02) != 0;
+
+                /* Skip the "." and ".." records */
+                if (name_len == 1 && (uint8_t)file_name[0] <= 1)
+                {
+                    pos += record_len;
+                    continue;
+                }
 
-    printf("[ISOFS] Root directory: LBA %" PRIu32 ", size %" PRIu32 " bytes\n",
-           isofs_state.root_dir_lba, isofs_state.root_dir_size);
+                /* The parent's name is stored in the pool, rebuild "PARENT/NAME" */
+                int len = (int)strlen(&isofs_names[dirs[d].path]);
+                memcpy(path, &isofs_names[dirs[d].path], (size_t)len + 1);
+                len = append_component(path, len, file_name, name_len);
 
-    isofs_state.initialized = 1;
-    return 0;
+                uint32_t lba = read_le32(&sector[pos + 2]);
+                uint32_t size = read_le32(&sector[pos + 10]);
+                uint32_t name = (len > 0) ? index_insert(path, len, lba, size, is_dir) : 0;
+
+                if (!name)
+                    complete = 0;
+                else if (is_dir && ndirs < ISOFS_MAX_DIRS)
+                {
+                    dirs[ndirs].lba = lba;
+                    dirs[ndirs].size = size;
+                    dirs[ndirs].path = name;
+                    ndirs++;
+                }
+                else if (is_dir)
+                    complete = 0;
+
+                pos += record_len;
+            }
+        }
+    }
+
+    printf("[ISOFS] Indexed %" PRIu32 " entries in %" PRIu32 " directories%s\n",
+           isofs_index_count, ndirs, complete ? "" : " (incomplete)");
+    return complete;
 }
 
-int ISOFS_FindFile(const char *name, uint32_t *lba_out, uint32_t *size_out)
+/* Linear search of the root directory, for when the index overflowed */
+static int scan_root(const char *name, uint32_t *lba_out, uint32_t *size_out)
 {
     uint8_t sector[ISO_SECTOR_SIZE];
 
-    if (!isofs_state.initialized)
-    {
-        printf("[ISOFS] ERROR: Filesystem not initialized\n");
-        return -1;
-    }
-
     uint32_t dir_lba = isofs_state.root_dir_lba;
     uint32_t remaining = isofs_state.root_dir_size;
     uint32_t sectors = (remaining + ISO_SECTOR_SIZE - 1) / ISO_SECTOR_SIZE;
@@ -193,6 +332,97 @@ int ISOFS_FindFile(const char *name, uint32_t *lba_out, uint32_t *size_out)
     return -1;
 }
 
+/* ---- Public API ---- */
+
+int ISOFS_Init(void)
+{
+    uint8_t sector[ISO_SECTOR_SIZE];
+
+    memset(&isofs_state, 0, sizeof(isofs_state));
+
+    if (!ISO_IsLoaded())
+    {
+        printf("[ISOFS] ERROR: No ISO image mounted\n");
+        return -1;
+    }
+
+    /* Read Primary Volume Descriptor at LBA 16 */
+    if (ISO_ReadSector(16, sector) < 0)
+    {
+        printf("[ISOFS] ERROR: Failed to read PVD at LBA 16\n");
+        return -2;
+    }
+
+    /* Validate PVD */
+    if (sector[0] != 0x01)
+    {
+        printf("[ISOFS] ERROR: PVD type byte is 0x%02X, expected 0x01\n", sector[0]);
+        return -3;
+    }
+
+    if (memcmp(&sector[1], "CD001", 5) != 0)
+    {
+        printf("[ISOFS] ERROR: PVD signature mismatch (expected 'CD001')\n");
+        return -3;
+    }
+
+    printf("[ISOFS] Primary Volume Descriptor found at LBA 16\n");
+
+    /* Volume identifier (bytes 40-71, 32 chars, padded with spaces) */
+    char vol_id[33];
+    memcpy(vol_id, &sector[40], 32);
+    vol_id[32] = '\0';
+    /* Trim trailing spaces */
+    for (int i = 31; i >= 0 && vol_id[i] == ' '; i--)
+        vol_id[i] = '\0';
+    printf("[ISOFS] Volume ID: \"%s\"\n", vol_id);
+
+    /* Root directory record starts at PVD offset 156, length 34 bytes */
+    const uint8_t *root_record = &sector[156];
+
+    /* Extract root directory extent LBA (offset 2 within record, little-endian) */
+    isofs_state.root_dir_lba = read_le32(&root_record[2]);
+
+    /* Extract root directory data length (offset 10, little-endian) */
+    isofs_state.root_dir_size = read_le32(&root_record[10]);
+
+    printf("[ISOFS] Root directory: LBA %" PRIu32 ", size %" PRIu32 " bytes\n",
+           isofs_state.root_dir_lba, isofs_state.root_dir_size);
+
+    isofs_state.initialized = 1;
+    isofs_state.index_complete = build_index();
+    return 0;
+}
+
+int ISOFS_FindFile(const char *name, uint32_t *lba_out, uint32_t *size_out)
+{
+    char path[ISOFS_PATH_MAX];
+
+    if (!isofs_state.initialized)
+    {
+        printf("[ISOFS] ERROR: Filesystem not initialized\n");
+        return -1;
+    }
+
+    if (normalize_path(path, name) > 0)
+    {
+        const IsoIndexEntry *e = index_lookup(path);
+        if (e && !e->is_dir)
+        {
+            *lba_out = e->lba;
+            *size_out = e->size;
+            DLOG("Found \"%s\" at LBA %" PRIu32 ", size %" PRIu32 "\n", name, *lba_out, *size_out);
+            return 0;
+        }
+    }
+    if (isofs_state.index_complete)
+    {
+        DLOG("File \"%s\" not found\n", name);
+        return -1;
+    }
+    return scan_root(name, lba_out, size_out);
+}
+
 int ISOFS_ReadBootPath(char *boot_path, size_t max_len)
 {
     uint32_t cnf_lba, cnf_size;
@@ -311,25 +541,27 @@ int ISOFS_ReadFile(uint32_t file_lba, uint32_t file_size,
     if (bytes_to_read > buf_size)
         bytes_to_read = buf_size;
 
-    uint32_t sectors = (bytes_to_read + ISO_SECTOR_SIZE - 1) / ISO_SECTOR_SIZE;
-    uint32_t total_read = 0;
+    /* Whole sectors straight into buf, the tail through a bounce sector */
+    uint32_t full = bytes_to_read / ISO_SECTOR_SIZE;
+    int got = ISO_ReadSectors(file_lba, full, buf);
+    uint32_t total_read = (uint32_t)got * ISO_SECTOR_SIZE;
 
-    for (uint32_t s = 0; s < sectors; s++)
+    if ((uint32_t)got < full)
+    {
+        DLOG("ReadFile: Failed to read sector at LBA %" PRIu32 "\n", file_lba + got);
+        return (total_read > 0) ? (int)total_read : -1;
+    }
+    if (total_read < bytes_to_read)
     {
         uint8_t sector_buf[ISO_SECTOR_SIZE];
 
-        if (ISO_ReadSector(file_lba + s, sector_buf) < 0)
+        if (ISO_ReadSector(file_lba + full, sector_buf) < 0)
         {
-            DLOG("ReadFile: Failed to read sector at LBA %" PRIu32 "\n", file_lba + s);
+            DLOG("ReadFile: Failed to read sector at LBA %" PRIu32 "\n", file_lba + full);
             return (total_read > 0) ? (int)total_read : -1;
         }
-
-        uint32_t chunk = bytes_to_read - total_read;
-        if (chunk > ISO_SECTOR_SIZE)
-            chunk = ISO_SECTOR_SIZE;
-
-        memcpy(buf + total_read, sector_buf, chunk);
-        total_read += chunk;
+        memcpy(buf + total_read, sector_buf, bytes_to_read - total_read);
+        total_read = bytes_to_read;
     }
 
     DLOG("ReadFile: Read %" PRIu32 " bytes from LBA %" PRIu32 "\n", total_read, file_lba);
@@ -15,6 +15,9 @@
 #include <errno.h>
 #include "superpsx.h"
 #include "iso_image.h"
+#include "iso_pbp.h"
+#include "platform.h"
+#include "mem_budget.h"
 
 #define LOG_TAG "ISO"
 
@@ -26,8 +29,361 @@ static struct
     uint32_t sector_size;   /* 2048 or 2352 */
     uint32_t data_offset;   /* Offset to user data within each raw sector */
     int loaded;             /* 1 if image is mounted */
+    int pbp;                /* 1 = PBP image, chunks are its blocks */
+    uint32_t path_hash;     /* names the access map file */
 } iso_state;
 
+/* ---- Track table ----
+ * A track's audio is found through its INDEX 01: sector in its file,
+ * and limit, the file sector where its data stops (the next track's
+ * INDEX 01 in the same file, else the end of the file).  Image LBAs
+ * between limit and the next track come from the next file's INDEX 00
+ * sectors, or are a PREGAP nothing in any file holds. */
+#define ISO_PATH_POOL 8192
+
+typedef struct
+{
+    const char *path;     /* in iso_path_pool */
+    uint32_t sector_size; /* 2048 (MODE1/2048 track) or 2352 */
+    uint32_t sectors;
+} IsoFile;
+
+typedef struct
+{
+    int file;
+    uint32_t sector; /* file sector of INDEX 01 */
+    uint32_t limit;
+} IsoTrackSrc;
+
+static IsoTrack iso_tracks[ISO_MAX_TRACKS];
+static IsoTrackSrc iso_track_src[ISO_MAX_TRACKS];
+static int iso_track_count;
+static uint32_t iso_disc_end;
+static IsoFile iso_files[ISO_MAX_TRACKS];
+static char iso_path_pool[ISO_PATH_POOL];
+static int iso_audio_fd = -1; /* ISO_ReadAudio's own view of iso_files[iso_audio_file] */
+static int iso_audio_file = -1;
+
+static void iso_audio_close(void)
+{
+    if (iso_audio_fd >= 0)
+        close(iso_audio_fd);
+    iso_audio_fd = -1;
+    iso_audio_file = -1;
+}
+
+/* The whole image as one data track */
+static void iso_single_track(void)
+{
+    iso_audio_close();
+    iso_track_count = 1;
+    iso_tracks[0].start = 0;
+    iso_tracks[0].length = iso_state.total_sectors;
+    iso_tracks[0].audio = 0;
+    iso_disc_end = iso_state.total_sectors;
+}
+
+/* ---- Read-ahead cache ----
+ * Sectors are read ISO_CHUNK_SECTORS at a time into chunks aligned on
+ * that many LBAs (32 KB of user data), one lseek + read per chunk.  A
+ * few chunks are kept, least recently used replaced, so a CD stream and
+ * the occasional directory / file lookup don't evict each other. */
+#define ISO_CHUNK_SECTORS 16
+#define ISO_CHUNKS        4
+
+#if ISO_CHUNK_SECTORS != PBP_BLOCK_SECTORS
+#error "A PBP block must fill exactly one cache chunk"
+#endif
+
+typedef struct
+{
+    uint32_t base;  /* first LBA, 0xFFFFFFFF = empty */
+    uint32_t count; /* sectors held (short at the end of the image) */
+    uint32_t used;  /* LRU stamp */
+    uint8_t data[ISO_CHUNK_SECTORS * RAW_SECTOR_SIZE];
+} IsoChunk;
+
+static IsoChunk iso_chunks[ISO_CHUNKS];
+static uint32_t iso_chunk_clock;
+IsoCacheStats iso_cache_stats;
+
+/* Held around the fd and the cache once a reader thread exists */
+static int iso_lock = -1;
+
+void ISO_EnableThreadedAccess(void)
+{
+    if (iso_lock < 0)
+        iso_lock = Platform_SemaCreate(1, 1);
+}
+
+static inline void iso_lock_take(void)
+{
+    if (iso_lock >= 0)
+        Platform_SemaWait(iso_lock);
+}
+
+static inline void iso_lock_give(void)
+{
+    if (iso_lock >= 0)
+        Platform_SemaSignal(iso_lock);
+}
+
+static void iso_cache_clear(void)
+{
+    for (int i = 0; i < ISO_CHUNKS; i++)
+        iso_chunks[i].base = 0xFFFFFFFF;
+}
+
+/* Sectors in the chunk starting at base (short at the end of the image) */
+static uint32_t iso_chunk_count(uint32_t base)
+{
+    uint32_t count = iso_state.total_sectors - base;
+    return (count > ISO_CHUNK_SECTORS) ? ISO_CHUNK_SECTORS : count;
+}
+
+/* Read the chunk at base from the file into dst; returns the bytes of it
+ * that arrived, <= 0 on error.  Caller holds the lock. */
+static ssize_t iso_read_chunk(uint32_t base, uint8_t *dst)
+{
+    size_t bytes = (size_t)iso_chunk_count(base) * iso_state.sector_size;
+    ssize_t got;
+
+    if (iso_state.pbp)
+    {
+        uint32_t file_bytes;
+        got = PBP_ReadBlock(iso_state.fd, base / PBP_BLOCK_SECTORS, dst, &file_bytes);
+        iso_cache_stats.bytes_read += file_bytes;
+    }
+    else
+    {
+        if (lseek(iso_state.fd, (off_t)base * iso_state.sector_size, SEEK_SET) < 0)
+            return -1;
+        got = read(iso_state.fd, dst, bytes);
+        if (got > 0)
+            iso_cache_stats.bytes_read += (uint32_t)got;
+    }
+    return ((size_t)got > bytes && got > 0) ? (ssize_t)bytes : got;
+}
+
+/* ---- RAM preload (cdrom_preload) ----
+ * While a game runs, iso_map counts how often each chunk is entered and
+ * is saved per image.  At the next boot ISO_PreloadStart picks the most
+ * used chunks that fit the budget (every chunk, if the whole image fits)
+ * and a worker reads them in LBA order into RAM.  A chunk is published in
+ * iso_preload_slot only once its data is in place; until then it is read
+ * from the file as usual. */
+#define ISO_MAP_MAGIC   0x4D585350u /* "PSXM" */
+#define ISO_MAP_VERSION 1
+#define ISO_MAP_SAVE_FRAMES 3600    /* ~1 min between map writes */
+#define ISO_PRELOAD_STACK   (16 * 1024)
+
+#define ISO_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static uint8_t *iso_map;                     /* per chunk, saturating count */
+static uint32_t iso_map_chunks;
+static int iso_map_dirty;
+static uint32_t iso_map_last = 0xFFFFFFFF;   /* chunk of the previous read */
+static volatile uint16_t *iso_preload_slot; /* per chunk: slot + 1, 0 = not in RAM */
+static uint8_t *iso_preload_data;
+static int iso_preload_thread = -1;
+
+static void iso_map_note(uint32_t chunk)
+{
+    if (!iso_map || chunk == iso_map_last)
+        return;
+    iso_map_last = chunk;
+    if (iso_map[chunk] < 255)
+    {
+        iso_map[chunk]++;
+        iso_map_dirty = 1;
+    }
+}
+
+static const uint8_t *iso_preload_sector(uint32_t lba)
+{
+    uint16_t slot = iso_preload_slot ? iso_preload_slot[lba / ISO_CHUNK_SECTORS] : 0;
+    if (!slot)
+        return NULL;
+    ISO_BARRIER();
+    size_t chunk_bytes = (size_t)ISO_CHUNK_SECTORS * iso_state.sector_size;
+    return iso_preload_data + (size_t)(slot - 1) * chunk_bytes +
+           (size_t)(lba % ISO_CHUNK_SECTORS) * iso_state.sector_size;
+}
+
+/* Raw file bytes of sector lba (sector_size of them), or NULL on error */
+static const uint8_t *iso_cache_sector(uint32_t lba)
+{
+    uint32_t base = lba & ~(uint32_t)(ISO_CHUNK_SECTORS - 1);
+    IsoChunk *c = NULL, *victim = &iso_chunks[0];
+
+    iso_map_note(base / ISO_CHUNK_SECTORS);
+    const uint8_t *pre = iso_preload_sector(lba);
+    if (pre)
+    {
+        iso_cache_stats.hits++;
+        return pre;
+    }
+
+    for (int i = 0; i < ISO_CHUNKS; i++)
+    {
+        if (iso_chunks[i].base == base)
+        {
+            c = &iso_chunks[i];
+            break;
+        }
+        if (iso_chunks[i].used < victim->used)
+            victim = &iso_chunks[i];
+    }
+
+    if (c && lba - base < c->count)
+    {
+        iso_cache_stats.hits++;
+    }
+    else
+    {
+        if (!c)
+            c = victim;
+        iso_cache_stats.misses++;
+        c->base = 0xFFFFFFFF;
+        ssize_t got = iso_read_chunk(base, c->data);
+        if (got <= 0)
+            return NULL;
+        c->base = base;
+        c->count = (uint32_t)got / iso_state.sector_size; /* whole sectors only */
+        if (lba - base >= c->count)
+        {
+            DLOG("ReadSector: Short read at LBA %" PRIu32 ": got %zd bytes\n", lba, got);
+            return NULL;
+        }
+    }
+    c->used = ++iso_chunk_clock;
+    return c->data + (size_t)(lba - base) * iso_state.sector_size;
+}
+
+/* PBP (PS1 EBOOT): raw sectors behind a block index, see iso_pbp.c */
+static int iso_open_pbp(void)
+{
+    uint32_t sectors;
+    if (PBP_Open(iso_state.fd, &sectors) < 0)
+    {
+        printf("[ISO] ERROR: Unreadable PBP image (or built without ENABLE_PBP)\n");
+        close(iso_state.fd);
+        iso_state.fd = -1;
+        return -4;
+    }
+    iso_state.pbp = 1;
+    iso_state.sector_size = RAW_SECTOR_SIZE;
+    iso_state.total_sectors = sectors;
+    iso_cache_clear();
+
+    /* Mode byte of the first sector picks the user data offset */
+    const uint8_t *sec = iso_cache_sector(0);
+    iso_state.data_offset = (sec && sec[15] == 2) ? RAW_DATA_OFFSET : RAW_MODE1_OFFSET;
+
+    iso_state.loaded = 1;
+    iso_single_track();
+    printf("[ISO] PBP image mounted: %" PRIu32 " sectors (mode %d)\n",
+           iso_state.total_sectors, sec ? sec[15] : 0);
+    return 0;
+}
+
+/* ---- Access map / preload worker ---- */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_sectors;
+} IsoMapHeader;
+
+static uint32_t *iso_preload_list; /* chunks to load, in LBA order */
+static uint32_t iso_preload_count;
+static int iso_preload_park = -1;
+static volatile int iso_preload_busy;
+
+static void iso_map_path(char *buf, size_t len)
+{
+    snprintf(buf, len, "cdmap_%08X.bin", (unsigned)iso_state.path_hash);
+}
+
+/* Merge the counts saved by an earlier run; returns 1 if there were any */
+static int iso_map_load(void)
+{
+    IsoMapHeader h;
+    char path[32];
+
+    iso_map_path(path, sizeof(path));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    int ok = read(fd, &h, sizeof(h)) == (ssize_t)sizeof(h) && h.magic == ISO_MAP_MAGIC &&
+             h.version == ISO_MAP_VERSION && h.total_sectors == iso_state.total_sectors &&
+             read(fd, iso_map, iso_map_chunks) == (ssize_t)iso_map_chunks;
+    close(fd);
+    if (!ok)
+    {
+        printf("[ISO] %s does not match this image, ignoring\n", path);
+        memset(iso_map, 0, iso_map_chunks);
+    }
+    return ok;
+}
+
+static void iso_map_save(void)
+{
+    IsoMapHeader h = {ISO_MAP_MAGIC, ISO_MAP_VERSION, iso_state.total_sectors};
+    char path[32];
+
+    if (!iso_map || !iso_map_dirty)
+        return;
+    iso_map_dirty = 0;
+    iso_map_path(path, sizeof(path));
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        printf("[ISO] Cannot create %s\n", path);
+        return;
+    }
+    int ok = write(fd, &h, sizeof(h)) == (ssize_t)sizeof(h) &&
+             write(fd, iso_map, iso_map_chunks) == (ssize_t)iso_map_chunks;
+    close(fd);
+    if (!ok)
+    {
+        printf("[ISO] Write to %s failed\n", path);
+        unlink(path);
+    }
+}
+
+static void iso_preload_run(void)
+{
+    size_t chunk_bytes = (size_t)ISO_CHUNK_SECTORS * iso_state.sector_size;
+    uint32_t loaded = 0;
+
+    for (uint32_t i = 0; i < iso_preload_count; i++)
+    {
+        uint32_t base = iso_preload_list[i] * ISO_CHUNK_SECTORS;
+        uint8_t *dst = iso_preload_data + (size_t)i * chunk_bytes;
+
+        iso_lock_take();
+        ssize_t got = iso_read_chunk(base, dst);
+        iso_lock_give();
+        if (got != (ssize_t)(iso_chunk_count(base) * iso_state.sector_size))
+            continue;
+        ISO_BARRIER();
+        iso_preload_slot[iso_preload_list[i]] = (uint16_t)(i + 1);
+        loaded++;
+    }
+    printf("[ISO] Preloaded %" PRIu32 " of %" PRIu32 " chunks (%" PRIu32 " KB)\n",
+           loaded, iso_preload_count, (uint32_t)(loaded * chunk_bytes / 1024));
+    iso_preload_busy = 0;
+}
+
+static void iso_preload_worker(void *arg)
+{
+    (void)arg;
+    iso_preload_run();
+    for (;;)
+        Platform_SemaWait(iso_preload_park); /* done: never signalled */
+}
+
 /* ---- Public API ---- */
 
 int ISO_Open(const char *path)
@@ -40,6 +396,10 @@ int ISO_Open(const char *path)
 
     printf("[ISO] Opening image: %s\n", path);
 
+    iso_state.path_hash = 5381;
+    for (const char *p = path; *p; p++)
+        iso_state.path_hash = (iso_state.path_hash << 5) + iso_state.path_hash + (uint8_t)*p;
+
     iso_state.fd = open(path, O_RDONLY);
     if (iso_state.fd < 0)
     {
@@ -58,6 +418,9 @@ int ISO_Open(const char *path)
     }
     long file_size = (long)st.st_size;
 
+    if (PBP_Detect(iso_state.fd))
+        return iso_open_pbp();
+
     /* Detect format: 2048-byte ISO vs 2352-byte raw/BIN */
     if ((file_size % RAW_SECTOR_SIZE) == 0)
     {
@@ -120,7 +483,10 @@ int ISO_Open(const char *path)
         printf("[ISO] Detected ISO format: %" PRIu32 " sectors\n", iso_state.total_sectors);
     }
 
+    iso_cache_clear();
     iso_state.loaded = 1;
+    iso_single_track(); /* until a CUE sheet says otherwise */
+
     printf("[ISO] Image mounted: %" PRIu32 " sectors, %" PRIu32 " bytes/sector\n",
            iso_state.total_sectors, iso_state.sector_size);
     return 0;
@@ -138,23 +504,185 @@ int ISO_ReadSector(uint32_t lba, uint8_t *buf)
         return -1;
     }
 
-    /* Calculate file offset */
-    off_t offset = (off_t)lba * iso_state.sector_size + iso_state.data_offset;
-    if (lseek(iso_state.fd, offset, SEEK_SET) < 0)
-        return -1;
-    ssize_t got = read(iso_state.fd, buf, ISO_SECTOR_SIZE);
-    if (got != ISO_SECTOR_SIZE)
+    iso_lock_take();
+    const uint8_t *sec = iso_cache_sector(lba);
+    if (sec)
+        memcpy(buf, sec + iso_state.data_offset, ISO_SECTOR_SIZE);
+    iso_lock_give();
+    if (!sec)
     {
-        DLOG("ReadSector: Short read at LBA %" PRIu32 ": got %zd bytes\n", lba, got);
-        if (got > 0 && got < ISO_SECTOR_SIZE)
-            memset(buf + got, 0, ISO_SECTOR_SIZE - got);
+        memset(buf, 0, ISO_SECTOR_SIZE);
         return -1;
     }
+    return 0;
+}
+
+int ISO_ReadSectors(uint32_t lba, uint32_t count, uint8_t *buf)
+{
+    for (uint32_t s = 0; s < count; s++)
+    {
+        if (ISO_ReadSector(lba + s, buf + (size_t)s * ISO_SECTOR_SIZE) < 0)
+            return (int)s;
+    }
+    return (int)count;
+}
 
+int ISO_ReadSectorRaw(uint32_t lba, uint8_t *buf)
+{
+    if (!iso_state.loaded || iso_state.fd < 0 || iso_state.data_offset != RAW_DATA_OFFSET)
+        return -1;
+    if (lba >= iso_state.total_sectors)
+        return -1;
+
+    /* Skip sync(12) + header(4): subheader and form 1/2 payload follow */
+    iso_lock_take();
+    const uint8_t *sec = iso_cache_sector(lba);
+    if (sec)
+        memcpy(buf, sec + RAW_MODE1_OFFSET, ISO_MODE2_SIZE);
+    iso_lock_give();
+    if (!sec)
+    {
+        DLOG("ReadSectorRaw: Short read at LBA %" PRIu32 "\n", lba);
+        return -1;
+    }
     return 0;
 }
 
+/* ---- CD-DA reads ---- */
+
+/* File and sector behind image LBA lba (in track t), and how many
+ * sectors from there stay in that file; -1: nothing behind it */
+static int iso_audio_map(int t, uint32_t lba, uint32_t *sector, uint32_t *run)
+{
+    const IsoTrack *tr = &iso_tracks[t - 1];
+    const IsoTrackSrc *a = &iso_track_src[t - 1];
+    uint32_t left = tr->start + tr->length - lba;
+    uint32_t fs = a->sector + (lba - tr->start);
+
+    if (fs < a->limit)
+    {
+        *sector = fs;
+        *run = (a->limit - fs < left) ? a->limit - fs : left;
+        return a->file;
+    }
+    /* Past this track's data: the next track's INDEX 00, if its own file
+     * holds it */
+    if (t < iso_track_count && iso_track_src[t].file != a->file)
+    {
+        const IsoTrackSrc *b = &iso_track_src[t];
+        if (b->sector >= left)
+        {
+            *sector = b->sector - left;
+            *run = left;
+            return b->file;
+        }
+        left -= b->sector;
+    }
+    *run = left;
+    return -1;
+}
+
+int ISO_ReadAudio(uint32_t lba, uint32_t count, uint8_t *buf)
+{
+    int t = ISO_TrackAt(lba);
+    if (!t || count == 0)
+        return -1;
+
+    uint32_t sector = 0, run;
+    int file = iso_audio_map(t, lba, &sector, &run);
+    if (count > run)
+        count = run;
+    if (file < 0 || !iso_tracks[t - 1].audio || iso_files[file].sector_size != RAW_SECTOR_SIZE)
+    {
+        memset(buf, 0, (size_t)count * RAW_SECTOR_SIZE);
+        return (int)count;
+    }
+
+    if (iso_audio_file != file)
+    {
+        iso_audio_close();
+        iso_audio_fd = open(iso_files[file].path, O_RDONLY);
+        if (iso_audio_fd < 0)
+        {
+            printf("[ISO] ERROR: Cannot open audio file: %s (%s)\n", iso_files[file].path,
+                   strerror(errno));
+            return -1;
+        }
+        iso_audio_file = file;
+    }
+    if (lseek(iso_audio_fd, (off_t)sector * RAW_SECTOR_SIZE, SEEK_SET) < 0)
+        return -1;
+    ssize_t got = read(iso_audio_fd, buf, (size_t)count * RAW_SECTOR_SIZE);
+    if (got < RAW_SECTOR_SIZE)
+        return -1;
+    return (int)(got / RAW_SECTOR_SIZE);
+}
+
 /* ---- CUE sheet parser ---- */
+typedef struct
+{
+    int file;
+    uint32_t index01; /* file sector */
+    uint32_t pregap;  /* PREGAP sectors, not in the file */
+    uint8_t audio;
+} CueTrack;
+
+/* Next word of a CUE line, "quoted" or bare.  Returns 0 at the end of
+ * the line. */
+static int cue_word(char **pp, char *out, size_t len)
+{
+    char *p = *pp, *end;
+
+    while (*p == ' ' || *p == '\t')
+        p++;
+    if (*p == '\0' || *p == '\r')
+        return 0;
+    if (*p == '"')
+    {
+        p++;
+        end = strchr(p, '"');
+        if (!end)
+            end = p + strlen(p);
+    }
+    else
+    {
+        end = p;
+        while (*end && *end != ' ' && *end != '\t' && *end != '\r')
+            end++;
+    }
+    size_t n = (size_t)(end - p);
+    if (n >= len)
+        n = len - 1;
+    memcpy(out, p, n);
+    out[n] = '\0';
+    *pp = (*end == '"') ? end + 1 : end;
+    return 1;
+}
+
+/* "mm:ss:ff" to sectors */
+static uint32_t cue_msf(const char *s)
+{
+    unsigned mm = 0, ss = 0, ff = 0;
+    sscanf(s, "%u:%u:%u", &mm, &ss, &ff);
+    return (mm * 60 + ss) * 75 + ff;
+}
+
+/* BIN path relative to the CUE file's directory, into iso_path_pool */
+static const char *cue_resolve(const char *cue_path, const char *name, size_t *pool_used)
+{
+    const char *last_sep = strrchr(cue_path, '/');
+    size_t dir_len = last_sep ? (size_t)(last_sep - cue_path + 1) : 0;
+    size_t len = dir_len + strlen(name) + 1;
+
+    if (len > 512 || *pool_used + len > sizeof(iso_path_pool))
+        return NULL;
+    char *path = iso_path_pool + *pool_used;
+    memcpy(path, cue_path, dir_len);
+    strcpy(path + dir_len, name);
+    *pool_used += len;
+    return path;
+}
+
 int ISO_OpenCue(const char *cue_path)
 {
     int cue_fd = open(cue_path, O_RDONLY);
@@ -190,7 +718,12 @@ int ISO_OpenCue(const char *cue_path)
     }
     cue_buf[r] = '\0';
 
-    char bin_filename[256] = {0};
+    CueTrack cue[ISO_MAX_TRACKS];
+    IsoFile files[ISO_MAX_TRACKS];
+    int ntracks = 0, nfiles = 0;
+    size_t pool_used = 0;
+    char word[256];
+
     char *line = cue_buf;
     while (line && *line)
     {
@@ -199,40 +732,48 @@ int ISO_OpenCue(const char *cue_path)
             *next = '\0';
 
         char *p = line;
-        while (*p == ' ' || *p == '\t')
-            p++;
+        if (!cue_word(&p, word, sizeof(word)))
+            word[0] = '\0';
 
-        if (strncasecmp(p, "FILE", 4) == 0 && (p[4] == ' ' || p[4] == '\t'))
+        if (strcasecmp(word, "FILE") == 0 && cue_word(&p, word, sizeof(word)))
         {
-            p += 4;
-            while (*p == ' ' || *p == '\t')
-                p++;
-
-            if (*p == '"')
-            {
-                p++;
-                char *end = strchr(p, '"');
-                if (end)
-                {
-                    size_t len = (size_t)(end - p);
-                    if (len >= sizeof(bin_filename))
-                        len = sizeof(bin_filename) - 1;
-                    memcpy(bin_filename, p, len);
-                    bin_filename[len] = '\0';
-                }
-            }
-            else
+            if (nfiles == ISO_MAX_TRACKS)
+                break;
+            const char *path = cue_resolve(cue_path, word, &pool_used);
+            if (!path)
             {
-                char *end = p;
-                while (*end && *end != ' ' && *end != '\t' && *end != '\r' && *end != '\n')
-                    end++;
-                size_t len = (size_t)(end - p);
-                if (len >= sizeof(bin_filename))
-                    len = sizeof(bin_filename) - 1;
-                memcpy(bin_filename, p, len);
-                bin_filename[len] = '\0';
+                printf("[ISO] ERROR: BIN path too long\n");
+                return -3;
             }
-            break;
+            printf("[ISO] CUE references BIN file: %s\n", word);
+            files[nfiles].path = path;
+            files[nfiles].sector_size = RAW_SECTOR_SIZE;
+            files[nfiles].sectors = 0;
+            nfiles++;
+        }
+        else if (strcasecmp(word, "TRACK") == 0 && nfiles > 0 && cue_word(&p, word, sizeof(word)) &&
+                 cue_word(&p, word, sizeof(word)))
+        {
+            if (ntracks == ISO_MAX_TRACKS)
+                break;
+            CueTrack *c = &cue[ntracks++];
+            c->file = nfiles - 1;
+            c->index01 = 0;
+            c->pregap = 0;
+            c->audio = strcasecmp(word, "AUDIO") == 0;
+            /* The first track of a file tells its sector size */
+            if (ntracks == 1 || cue[ntracks - 2].file != c->file)
+                files[c->file].sector_size = strstr(word, "/2048") ? ISO_SECTOR_SIZE : RAW_SECTOR_SIZE;
+        }
+        else if (strcasecmp(word, "INDEX") == 0 && ntracks > 0 && cue_word(&p, word, sizeof(word)))
+        {
+            int number = atoi(word);
+            if (number == 1 && cue_word(&p, word, sizeof(word)))
+                cue[ntracks - 1].index01 = cue_msf(word);
+        }
+        else if (strcasecmp(word, "PREGAP") == 0 && ntracks > 0 && cue_word(&p, word, sizeof(word)))
+        {
+            cue[ntracks - 1].pregap = cue_msf(word);
         }
 
         if (!next)
@@ -242,37 +783,86 @@ int ISO_OpenCue(const char *cue_path)
 
     /* cue_buf is stack-allocated */
 
-    if (bin_filename[0] == '\0')
+    if (nfiles == 0)
     {
         printf("[ISO] ERROR: No FILE directive found in CUE sheet\n");
         return -2;
     }
 
-    printf("[ISO] CUE references BIN file: %s\n", bin_filename);
-
-    /* Resolve BIN path relative to the CUE file's directory */
-    char bin_path[512];
-    const char *last_sep = strrchr(cue_path, '/');
-    if (last_sep)
+    for (int i = 0; i < nfiles; i++)
     {
-        size_t dir_len = (size_t)(last_sep - cue_path + 1);
-        if (dir_len + strlen(bin_filename) >= sizeof(bin_path))
-        {
-            printf("[ISO] ERROR: BIN path too long\n");
-            return -3;
-        }
-        memcpy(bin_path, cue_path, dir_len);
-        strcpy(bin_path + dir_len, bin_filename);
+        int fd = open(files[i].path, O_RDONLY);
+        if (fd >= 0 && fstat(fd, &st) == 0)
+            files[i].sectors = (uint32_t)(st.st_size / files[i].sector_size);
+        else
+            printf("[ISO] WARNING: Cannot open %s, its tracks play as silence\n", files[i].path);
+        if (fd >= 0)
+            close(fd);
     }
-    else
+
+    printf("[ISO] Opening BIN file: %s\n", files[0].path);
+    int ret = ISO_Open(files[0].path);
+    if (ret < 0 || ntracks == 0 || iso_state.pbp)
+        return ret;
+
+    /* Lay the tracks out: each starts where the previous one's file data
+     * ends, plus its PREGAP, plus its INDEX 00 sectors when it opens a
+     * new file.  Track 1 starts at its INDEX 01 (the image LBA of the
+     * data reads through iso_state.fd). */
+    uint32_t end = 0, audio = 0;
+    for (int t = 0; t < ntracks; t++)
     {
-        /* CUE is in current directory */
-        strncpy(bin_path, bin_filename, sizeof(bin_path) - 1);
-        bin_path[sizeof(bin_path) - 1] = '\0';
+        const CueTrack *c = &cue[t];
+        IsoTrackSrc *src = &iso_track_src[t];
+        int new_file = t == 0 || cue[t - 1].file != c->file;
+
+        src->file = c->file;
+        src->sector = c->index01;
+        src->limit = (t + 1 < ntracks && cue[t + 1].file == c->file) ? cue[t + 1].index01
+                                                                     : files[c->file].sectors;
+        if (src->limit < src->sector)
+            src->limit = src->sector;
+        iso_tracks[t].start = (t == 0) ? c->index01 : end + c->pregap + (new_file ? c->index01 : 0);
+        iso_tracks[t].audio = c->audio;
+        end = iso_tracks[t].start + (src->limit - src->sector);
+        if (t > 0)
+            iso_tracks[t - 1].length = iso_tracks[t].start - iso_tracks[t - 1].start;
+        audio += c->audio;
     }
+    iso_tracks[ntracks - 1].length = end - iso_tracks[ntracks - 1].start;
+    memcpy(iso_files, files, sizeof(IsoFile) * (size_t)nfiles);
+    iso_track_count = ntracks;
+    iso_disc_end = end;
+    printf("[ISO] CUE: %d tracks (%" PRIu32 " audio) in %d files, lead-out at LBA %" PRIu32 "\n",
+           ntracks, audio, nfiles, end);
+    return 0;
+}
+
+int ISO_GetTrackCount(void)
+{
+    return iso_state.loaded ? iso_track_count : 0;
+}
+
+const IsoTrack *ISO_GetTrack(int track)
+{
+    if (track < 1 || track > ISO_GetTrackCount())
+        return NULL;
+    return &iso_tracks[track - 1];
+}
+
+int ISO_TrackAt(uint32_t lba)
+{
+    int t = ISO_GetTrackCount();
+    if (lba >= iso_disc_end)
+        return 0;
+    while (t > 1 && iso_tracks[t - 1].start > lba)
+        t--;
+    return t;
+}
 
-    printf("[ISO] Opening BIN file: %s\n", bin_path);
-    return ISO_Open(bin_path);
+uint32_t ISO_GetDiscEnd(void)
+{
+    return iso_disc_end;
 }
 
 int ISO_IsLoaded(void)
@@ -285,14 +875,119 @@ uint32_t ISO_GetSectorCount(void)
     return iso_state.total_sectors;
 }
 
+void ISO_PreloadStart(uint32_t budget)
+{
+    if (!iso_state.loaded || budget == 0 || iso_map)
+        return;
+
+    iso_map_chunks = (iso_state.total_sectors + ISO_CHUNK_SECTORS - 1) / ISO_CHUNK_SECTORS;
+    iso_map = calloc(iso_map_chunks, 1);
+    if (!iso_map)
+        return;
+    int have_map = iso_map_load();
+
+    size_t chunk_bytes = (size_t)ISO_CHUNK_SECTORS * iso_state.sector_size;
+    uint32_t slots = (uint32_t)(budget / chunk_bytes);
+    if (slots > 0xFFFF)
+        slots = 0xFFFF;
+
+    /* Whole image if it fits, else the chunks with the highest counts:
+     * everything above count t, then count t ones while room is left */
+    int t = 0;
+    if (iso_map_chunks > slots)
+    {
+        if (!have_map)
+        {
+            printf("[ISO] Recording disc access map, preload from the next boot\n");
+            return;
+        }
+        uint32_t hist[256] = {0}, n = 0;
+        for (uint32_t c = 0; c < iso_map_chunks; c++)
+            hist[iso_map[c]]++;
+        for (t = 255; t > 0 && n + hist[t] <= slots; t--)
+            n += hist[t];
+        if (t == 0 && n == 0)
+            return;
+    }
+
+    iso_preload_list = malloc((size_t)(iso_map_chunks < slots ? iso_map_chunks : slots) * sizeof(uint32_t));
+    iso_preload_slot = calloc(iso_map_chunks, sizeof(uint16_t));
+    if (!iso_preload_list || !iso_preload_slot)
+        goto fail;
+    for (uint32_t c = 0; c < iso_map_chunks && iso_preload_count < slots; c++)
+    {
+        if (iso_map_chunks <= slots || iso_map[c] > t || (t > 0 && iso_map[c] == t))
+            iso_preload_list[iso_preload_count++] = c;
+    }
+
+    /* Halve until the pool can take it */
+    while (iso_preload_count &&
+           !(iso_preload_data = MemPool_Alloc(MEM_POOL_CDROM, iso_preload_count * chunk_bytes, 64)))
+        iso_preload_count /= 2;
+    if (!iso_preload_data)
+        goto fail;
+
+    printf("[ISO] Preloading %" PRIu32 " chunks (%" PRIu32 " KB%s)\n", iso_preload_count,
+           (uint32_t)(iso_preload_count * chunk_bytes / 1024),
+           iso_map_chunks <= slots ? ", whole image" : "");
+    iso_preload_busy = 1;
+    ISO_EnableThreadedAccess();
+    iso_preload_park = Platform_SemaCreate(0, 1);
+    if (iso_preload_park < 0 ||
+        (iso_preload_thread = Platform_ThreadStart("iso_preload", iso_preload_worker, NULL,
+                                                  ISO_PRELOAD_STACK)) < 0)
+        iso_preload_run(); /* no thread: load now */
+    return;
+
+fail:
+    free(iso_preload_list);
+    free((void *)iso_preload_slot);
+    iso_preload_list = NULL;
+    iso_preload_slot = NULL;
+    iso_preload_count = 0;
+}
+
+void ISO_PreloadFrame(void)
+{
+    static uint32_t frames;
+    if (iso_map && ++frames >= ISO_MAP_SAVE_FRAMES)
+    {
+        frames = 0;
+        iso_map_save();
+    }
+}
+
 void ISO_Close(void)
 {
+    iso_map_save();
     if (iso_state.fd >= 0)
     {
         close(iso_state.fd);
         iso_state.fd = -1;
     }
+    if (iso_state.pbp)
+        PBP_Close();
+    iso_state.pbp = 0;
     iso_state.loaded = 0;
     iso_state.total_sectors = 0;
+    iso_cache_clear();
+    iso_audio_close();
+    iso_track_count = 0;
+    iso_disc_end = 0;
+
+    /* The worker reads through iso_state: keep its buffers if it still runs */
+    free(iso_map);
+    iso_map = NULL;
+    iso_map_last = 0xFFFFFFFF;
+    if (!iso_preload_busy)
+    {
+        free((void *)iso_preload_slot);
+        free(iso_preload_list);
+        MemPool_Reset(MEM_POOL_CDROM);
+        iso_preload_slot = NULL;
+        iso_preload_data = NULL;
+        iso_preload_list = NULL;
+        iso_preload_count = 0;
+    }
     DLOG("Image closed\n");
 }
@@ -0,0 +1,212 @@
+/*
+ * SuperPSX – PBP (PS1 EBOOT) Image Backend
+ *
+ * Layout: the PBP header points at DATA.PSAR, which starts with
+ * "PSISOIMG0000" (one disc) or "PSTITLEIMG000000" (a disc table at
+ * +0x200).  From the PSISOIMG header:
+ *   +0x800     TOC, 10-byte entries (the third holds the lead-out MSF)
+ *   +0x4000    block index, 32-byte entries: offset from +0x100000 first
+ *   +0x100000  blocks of 16 raw sectors, raw deflate unless 0x9300 long
+ * A block's length is the distance to the next index entry.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include "superpsx.h"
+#include "iso_image.h"
+#include "iso_pbp.h"
+
+#define LOG_TAG "PBP"
+
+#ifdef ENABLE_PBP
+
+#include <zlib.h>
+
+#define PBP_BLOCK_BYTES  (PBP_BLOCK_SECTORS * RAW_SECTOR_SIZE)
+#define PBP_INDEX_OFFSET 0x4000
+#define PBP_DATA_OFFSET  0x100000
+#define PBP_INDEX_MAX    ((PBP_DATA_OFFSET - PBP_INDEX_OFFSET) / 32)
+
+static uint32_t *pbp_index; /* file offset of each block, plus an end entry */
+static uint32_t pbp_blocks;
+static uint8_t pbp_zbuf[PBP_BLOCK_BYTES];
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int bcd(uint8_t v)
+{
+    return (v >> 4) * 10 + (v & 0x0F);
+}
+
+static int read_at(int fd, uint32_t offset, void *buf, size_t len)
+{
+    if (lseek(fd, (off_t)offset, SEEK_SET) < 0)
+        return -1;
+    return read(fd, buf, len) == (ssize_t)len ? 0 : -1;
+}
+
+int PBP_Detect(int fd)
+{
+    uint8_t magic[4];
+    return read_at(fd, 0, magic, 4) == 0 && memcmp(magic, "\0PBP", 4) == 0;
+}
+
+int PBP_Open(int fd, uint32_t *total_sectors)
+{
+    uint8_t hdr[40], sig[16];
+
+    PBP_Close();
+    if (read_at(fd, 0, hdr, sizeof(hdr)) < 0)
+        return -1;
+    uint32_t iso = rd32(hdr + 36); /* DATA.PSAR */
+
+    if (read_at(fd, iso, sig, sizeof(sig)) < 0)
+        return -1;
+    if (memcmp(sig, "PSTITLEIMG", 10) == 0)
+    {
+        uint8_t disc[4];
+        if (read_at(fd, iso + 0x200, disc, 4) < 0)
+            return -1;
+        printf("[PBP] Multi-disc image, using disc 1\n");
+        iso += rd32(disc);
+        if (read_at(fd, iso, sig, sizeof(sig)) < 0)
+            return -1;
+    }
+    if (memcmp(sig, "PSISOIMG", 8) != 0)
+    {
+        printf("[PBP] ERROR: No PSISOIMG header in DATA.PSAR\n");
+        return -2;
+    }
+
+    /* Lead-out from the TOC, when present */
+    uint8_t toc[30];
+    uint32_t leadout = 0;
+    if (read_at(fd, iso + 0x800, toc, sizeof(toc)) == 0)
+        leadout = (uint32_t)((bcd(toc[27]) * 60 + bcd(toc[28])) * 75 + bcd(toc[29]));
+
+    uint8_t *raw = malloc((size_t)PBP_INDEX_MAX * 32);
+    pbp_index = malloc((size_t)(PBP_INDEX_MAX + 1) * sizeof(uint32_t));
+    if (!raw || !pbp_index || read_at(fd, iso + PBP_INDEX_OFFSET, raw, (size_t)PBP_INDEX_MAX * 32) < 0)
+    {
+        free(raw);
+        PBP_Close();
+        return -3;
+    }
+    uint32_t n = 0;
+    for (; n < PBP_INDEX_MAX; n++)
+    {
+        uint32_t off = rd32(raw + n * 32);
+        if (off == 0 && n != 0)
+            break;
+        pbp_index[n] = iso + PBP_DATA_OFFSET + off;
+    }
+    /* End of the last block: the entry after it (0 once past the end)
+     * gives no length; one stored block is the most it can take */
+    pbp_index[n] = pbp_index[n - 1] + PBP_BLOCK_BYTES;
+    pbp_blocks = n;
+    free(raw);
+
+    *total_sectors = pbp_blocks * PBP_BLOCK_SECTORS;
+    if (leadout > 150 && leadout - 150 < *total_sectors)
+        *total_sectors = leadout - 150;
+    printf("[PBP] %" PRIu32 " blocks, %" PRIu32 " sectors\n", pbp_blocks, *total_sectors);
+    return 0;
+}
+
+/* Raw deflate stream to dst; returns the bytes decoded or -1 */
+static int pbp_inflate(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, -15) != Z_OK)
+        return -1;
+    z.next_in = (Bytef *)src;
+    z.avail_in = len;
+    z.next_out = dst;
+    z.avail_out = PBP_BLOCK_BYTES;
+    int ret = inflate(&z, Z_FINISH);
+    uint32_t out = PBP_BLOCK_BYTES - z.avail_out;
+    inflateEnd(&z);
+    return (ret == Z_STREAM_END) ? (int)out : -1;
+}
+
+int PBP_ReadBlock(int fd, uint32_t block, uint8_t *dst, uint32_t *file_bytes)
+{
+    *file_bytes = 0;
+    if (block >= pbp_blocks)
+        return -1;
+
+    uint32_t start = pbp_index[block];
+    uint32_t len = pbp_index[block + 1] - start;
+    int last = block + 1 == pbp_blocks; /* length unknown, see PBP_Open */
+    if (len > PBP_BLOCK_BYTES)
+        len = PBP_BLOCK_BYTES;
+    if (lseek(fd, (off_t)start, SEEK_SET) < 0)
+        return -1;
+
+    if (len == PBP_BLOCK_BYTES && !last)
+    {
+        /* Stored block */
+        if (read(fd, dst, len) != (ssize_t)len)
+            return -1;
+        *file_bytes = len;
+        return (int)len;
+    }
+
+    ssize_t got = read(fd, pbp_zbuf, len);
+    if (got <= 0)
+        return -1;
+    *file_bytes = (uint32_t)got;
+    int out = pbp_inflate(pbp_zbuf, (uint32_t)got, dst);
+    if (out < 0 && got == PBP_BLOCK_BYTES) /* stored last block */
+    {
+        memcpy(dst, pbp_zbuf, PBP_BLOCK_BYTES);
+        out = PBP_BLOCK_BYTES;
+    }
+    if (out < 0)
+        DLOG("Block %" PRIu32 ": bad deflate data\n", block);
+    return out;
+}
+
+void PBP_Close(void)
+{
+    free(pbp_index);
+    pbp_index = NULL;
+    pbp_blocks = 0;
+}
+
+#else /* !ENABLE_PBP */
+
+int PBP_Detect(int fd)
+{
+    (void)fd;
+    return 0;
+}
+
+int PBP_Open(int fd, uint32_t *total_sectors)
+{
+    (void)fd;
+    (void)total_sectors;
+    return -1;
+}
+
+int PBP_ReadBlock(int fd, uint32_t block, uint8_t *dst, uint32_t *file_bytes)
+{
+    (void)fd;
+    (void)block;
+    (void)dst;
+    *file_bytes = 0;
+    return -1;
+}
+
+void PBP_Close(void)
+{
+}
+
+#endif /* ENABLE_PBP */
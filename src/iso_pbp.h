@@ -0,0 +1,31 @@
+#ifndef ISO_PBP_H
+#define ISO_PBP_H
+
+#include <stdint.h>
+
+/*
+ * PBP (PS1 EBOOT) disc images for iso_image.c
+ *
+ * The PSAR holds the disc as 2352-byte raw sectors in blocks of
+ * PBP_BLOCK_SECTORS, each raw-deflated unless it is stored whole, with a
+ * block index in front.  Only the first disc of a multi-disc image is
+ * used.
+ */
+
+#define PBP_BLOCK_SECTORS 16
+
+/* 1 if the file at fd starts with the PBP magic */
+int PBP_Detect(int fd);
+
+/* Parse the PSAR and load the block index.  *total_sectors gets the
+ * number of raw sectors.  Returns 0 on success, < 0 on error. */
+int PBP_Open(int fd, uint32_t *total_sectors);
+
+/* Decode block into dst (PBP_BLOCK_SECTORS * 2352 bytes).  *file_bytes
+ * gets what was read from the file.  Returns the number of bytes
+ * decoded, < 0 on error. */
+int PBP_ReadBlock(int fd, uint32_t block, uint8_t *dst, uint32_t *file_bytes);
+
+void PBP_Close(void);
+
+#endif /* ISO_PBP_H */
@@ -156,27 +156,35 @@ void PSX_SetArgs(const char **args, int argLen)
     *(uint32_t *)(scratchpad_buf + 0) = (uint32_t)i;
 }
 
-int Load_PSX_EXE_FromISO(R3000CPU *cpu)
+/* Boot EXE named by SYSTEM.CNF: -1 = no boot path, -2 = not on the disc */
+static int iso_find_boot_exe(char *boot_path, size_t len, uint32_t *lba, uint32_t *size)
 {
-    char boot_path[256];
-
-    printf("LOADER: Loading executable from ISO...\n");
-
-    /* Read boot path from SYSTEM.CNF */
-    if (ISOFS_ReadBootPath(boot_path, sizeof(boot_path)) < 0)
-    {
-        printf("LOADER: Failed to read boot path from SYSTEM.CNF\n");
+    if (ISOFS_ReadBootPath(boot_path, len) < 0)
         return -1;
-    }
 
     /* Strip ";1" version suffix if present (for searching in ISO) */
     size_t bplen = strlen(boot_path);
     if (bplen >= 2 && boot_path[bplen - 1] == '1' && boot_path[bplen - 2] == ';')
         boot_path[bplen - 2] = '\0';
 
+    return ISOFS_FindFile(boot_path, lba, size) < 0 ? -2 : 0;
+}
+
+int Load_PSX_EXE_FromISO(R3000CPU *cpu)
+{
+    char boot_path[256];
+
+    printf("LOADER: Loading executable from ISO...\n");
+
     /* Find the EXE file on the disc */
     uint32_t exe_lba, exe_size;
-    if (ISOFS_FindFile(boot_path, &exe_lba, &exe_size) < 0)
+    int found = iso_find_boot_exe(boot_path, sizeof(boot_path), &exe_lba, &exe_size);
+    if (found == -1)
+    {
+        printf("LOADER: Failed to read boot path from SYSTEM.CNF\n");
+        return -1;
+    }
+    if (found < 0)
     {
         printf("LOADER: Boot executable \"%s\" not found on disc\n", boot_path);
         return -2;
@@ -276,3 +284,43 @@ int Load_PSX_EXE_FromISO(R3000CPU *cpu)
 
     return 0;
 }
+
+int Loader_HashBootEXE(uint32_t *hash_out)
+{
+    uint32_t hash = 5381;
+    uint8_t buf[ISO_SECTOR_SIZE];
+
+    if (psx_boot_mode == BOOT_MODE_ISO)
+    {
+        char boot_path[256];
+        uint32_t lba, size;
+        if (iso_find_boot_exe(boot_path, sizeof(boot_path), &lba, &size) < 0)
+            return -1;
+        for (uint32_t done = 0; done < size; lba++)
+        {
+            if (ISO_ReadSector(lba, buf) < 0)
+                return -1;
+            uint32_t n = size - done < ISO_SECTOR_SIZE ? size - done : ISO_SECTOR_SIZE;
+            for (uint32_t i = 0; i < n; i++)
+                hash = (hash << 5) + hash + buf[i];
+            done += n;
+        }
+    }
+    else if (psx_exe_filename && psx_exe_filename[0])
+    {
+        int fd = open(psx_exe_filename, O_RDONLY);
+        if (fd < 0)
+            return -1;
+        int r;
+        while ((r = read(fd, buf, sizeof(buf))) > 0)
+            for (int i = 0; i < r; i++)
+                hash = (hash << 5) + hash + buf[i];
+        close(fd);
+    }
+    else
+    {
+        return -1;
+    }
+    *hash_out = hash;
+    return 0;
+}
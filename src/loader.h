@@ -39,4 +39,11 @@ int Load_PSX_EXE(const char *filename, R3000CPU *cpu);
  */
 int Load_PSX_EXE_FromISO(R3000CPU *cpu);
 
+/*
+ * djb2 hash of the whole boot executable (the disc's SYSTEM.CNF boot
+ * file, or psx_exe_filename), read without loading it into RAM.
+ * Returns 0 on success, < 0 when there is no boot executable.
+ */
+int Loader_HashBootEXE(uint32_t *hash_out);
+
 #endif /* LOADER_H */
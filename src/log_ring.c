@@ -0,0 +1,394 @@
+/**
+ * log_ring.c — Binary log ring and its formatter
+ *
+ * Records are laid out back to back in a byte ring: a LogRecord header,
+ * then the arguments in format order (4-byte ints, 8-byte long longs
+ * and doubles, NUL-terminated strings), unaligned, read back with
+ * memcpy.  A record that doesn't fit before the end of the ring leaves
+ * a pad record (fmt NULL) and starts over at 0.  When the ring is full
+ * the record is dropped and counted.
+ *
+ * Producers are the emulator thread and, on error paths, the CD/ISO
+ * read-ahead workers.  Those run one priority above the emulator and
+ * never yield inside log_ring_vprintf, so a producer can only be
+ * preempted, never interleaved.  log_busy marks a producer between
+ * reserve and publish; one that preempts it formats and writes its own
+ * record at once.  The drain runs on the emulator thread and only moves
+ * log_tail.
+ */
+#include "log_ring.h"
+
+#ifdef ENABLE_LOG_RING
+
+#include "dynarec.h" /* host_log_write */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_RING_SIZE (1 << 17) /* bytes, power of 2 */
+#define LOG_REC_MAX 256         /* largest record */
+#define LOG_STR_MAX 64          /* a %s argument keeps at most this many bytes, NUL included */
+#define LOG_OUT_MAX 1024        /* one formatted record */
+
+#define LOG_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+typedef struct
+{
+    const char *fmt; /* NULL: pad to the end of the ring */
+    uint16_t size;   /* whole record, multiple of sizeof(LogRecord) */
+    uint16_t dest;   /* LOG_DEST_* */
+} LogRecord;
+
+enum {
+    LOG_ARG_NONE, /* %% */
+    LOG_ARG_INT,
+    LOG_ARG_I64,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STR,
+    LOG_ARG_PTR,
+    LOG_ARG_BAD /* %n, wide or unknown: stop at it */
+};
+
+static uint8_t log_ring[LOG_RING_SIZE] __attribute__((aligned(16)));
+static volatile uint32_t log_head, log_tail; /* free-running byte counts */
+static volatile int log_busy;
+static uint32_t log_dropped;
+static int log_atexit_done;
+
+/* Parse the conversion after a '%': returns its length up to and
+ * including the conversion character, its argument kind and the number
+ * of '*' fields (int arguments in front of it) */
+static int log_spec(const char *s, int *kind, int *stars)
+{
+    const char *p = s;
+    int longs = 0, size_t_len = 0;
+
+    *stars = 0;
+    while (*p && strchr("-+ #0", *p))
+        p++;
+    for (int field = 0; field < 2; field++)
+    {
+        if (field && *p != '.')
+            break;
+        if (field)
+            p++;
+        if (*p == '*')
+        {
+            (*stars)++;
+            p++;
+        }
+        else
+            while (*p >= '0' && *p <= '9')
+                p++;
+    }
+    for (;; p++)
+    {
+        if (*p == 'h')
+            continue;
+        if (*p == 'l')
+            longs++;
+        else if (*p == 'q' || *p == 'j')
+            longs = 2;
+        else if (*p == 'z' || *p == 't')
+            size_t_len = 1;
+        else if (*p == 'L')
+            longs = 3;
+        else
+            break;
+    }
+
+    switch (*p)
+    {
+    case '%':
+        *kind = LOG_ARG_NONE;
+        break;
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+        if (longs == 3)
+            *kind = LOG_ARG_BAD;
+        else if (longs >= 2 || (longs == 1 && sizeof(long) == 8) || (size_t_len && sizeof(size_t) == 8))
+            *kind = LOG_ARG_I64;
+        else
+            *kind = LOG_ARG_INT;
+        break;
+    case 'c':
+        *kind = longs ? LOG_ARG_BAD : LOG_ARG_INT;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        *kind = longs == 3 ? LOG_ARG_BAD : LOG_ARG_DOUBLE;
+        break;
+    case 's':
+        *kind = longs ? LOG_ARG_BAD : LOG_ARG_STR;
+        break;
+    case 'p':
+        *kind = LOG_ARG_PTR;
+        break;
+    default:
+        *kind = LOG_ARG_BAD;
+        return (int)(p - s);
+    }
+    return (int)(p - s) + 1;
+}
+
+static uint32_t log_arg_size(int kind)
+{
+    switch (kind)
+    {
+    case LOG_ARG_INT:
+        return sizeof(int);
+    case LOG_ARG_I64:
+        return sizeof(long long);
+    case LOG_ARG_DOUBLE:
+        return sizeof(double);
+    case LOG_ARG_PTR:
+        return sizeof(void *);
+    case LOG_ARG_STR:
+        return 1; /* at least the NUL */
+    }
+    return 0;
+}
+
+static void log_write(int dest, const char *buf, int n)
+{
+    if (dest == LOG_DEST_STDOUT)
+        fwrite(buf, 1, (size_t)n, stdout);
+#ifdef ENABLE_HOST_LOG
+    else
+        host_log_write(buf, n);
+#endif
+}
+
+/* Format a record the way printf would have and write it out */
+static void log_emit(const LogRecord *r)
+{
+    char out[LOG_OUT_MAX];
+    int o = 0;
+    const uint8_t *a = (const uint8_t *)(r + 1);
+    const uint8_t *end = (const uint8_t *)r + r->size;
+    const char *p = r->fmt;
+
+    while (*p && o < LOG_OUT_MAX - 1)
+    {
+        if (*p != '%')
+        {
+            out[o++] = *p++;
+            continue;
+        }
+        int kind, stars, len = log_spec(p + 1, &kind, &stars);
+        uint32_t need = (uint32_t)stars * sizeof(int) + log_arg_size(kind);
+        if (kind == LOG_ARG_BAD || len > 24 || a + need > end)
+            break; /* the producer stopped here too: the rest goes out as it stands */
+        if (kind == LOG_ARG_STR && !memchr(a + stars * sizeof(int), '\0', (size_t)(end - a) - stars * sizeof(int)))
+            break;
+
+        /* The spec with its '*' fields resolved */
+        char spec[48];
+        int sl = 0;
+        for (int i = 0; i <= len; i++)
+        {
+            if (p[i] == '*')
+            {
+                int v;
+                memcpy(&v, a, sizeof(v));
+                a += sizeof(v);
+                sl += snprintf(spec + sl, sizeof(spec) - sl, "%d", v);
+            }
+            else
+                spec[sl++] = p[i];
+        }
+        spec[sl] = '\0';
+        p += len + 1;
+
+        int room = LOG_OUT_MAX - o, n = 0;
+        switch (kind)
+        {
+        case LOG_ARG_NONE:
+            n = snprintf(out + o, room, "%%");
+            break;
+        case LOG_ARG_INT:
+        {
+            int v;
+            memcpy(&v, a, sizeof(v));
+            n = snprintf(out + o, room, spec, v);
+            break;
+        }
+        case LOG_ARG_I64:
+        {
+            long long v;
+            memcpy(&v, a, sizeof(v));
+            n = snprintf(out + o, room, spec, v);
+            break;
+        }
+        case LOG_ARG_DOUBLE:
+        {
+            double v;
+            memcpy(&v, a, sizeof(v));
+            n = snprintf(out + o, room, spec, v);
+            break;
+        }
+        case LOG_ARG_PTR:
+        {
+            void *v;
+            memcpy(&v, a, sizeof(v));
+            n = snprintf(out + o, room, spec, v);
+            break;
+        }
+        case LOG_ARG_STR:
+            n = snprintf(out + o, room, spec, (const char *)a);
+            a += strlen((const char *)a) + 1;
+            break;
+        }
+        if (kind != LOG_ARG_STR)
+            a += log_arg_size(kind);
+        o += n < 0 ? 0 : (n < room ? n : room - 1);
+    }
+    while (*p && o < LOG_OUT_MAX - 1)
+        out[o++] = *p++;
+    log_write(r->dest, out, o);
+}
+
+void log_ring_vprintf(int dest, const char *fmt, va_list ap)
+{
+    union
+    {
+        LogRecord hdr;
+        uint8_t bytes[LOG_REC_MAX];
+    } rec;
+    uint32_t n = sizeof(LogRecord);
+
+    /* Arguments in format order; a record that would overflow stops at
+     * the last whole argument and log_emit prints the rest verbatim */
+    for (const char *p = fmt; *p; p++)
+    {
+        if (*p != '%')
+            continue;
+        int kind, stars, len = log_spec(p + 1, &kind, &stars);
+        if (kind == LOG_ARG_BAD)
+            break;
+        uint32_t need = (uint32_t)stars * sizeof(int) + log_arg_size(kind);
+        if (n + need > LOG_REC_MAX)
+            break;
+        for (; stars > 0; stars--)
+        {
+            int v = va_arg(ap, int);
+            memcpy(rec.bytes + n, &v, sizeof(v));
+            n += sizeof(v);
+        }
+        switch (kind)
+        {
+        case LOG_ARG_INT:
+        {
+            int v = va_arg(ap, int);
+            memcpy(rec.bytes + n, &v, sizeof(v));
+            break;
+        }
+        case LOG_ARG_I64:
+        {
+            long long v = va_arg(ap, long long);
+            memcpy(rec.bytes + n, &v, sizeof(v));
+            break;
+        }
+        case LOG_ARG_DOUBLE:
+        {
+            double v = va_arg(ap, double);
+            memcpy(rec.bytes + n, &v, sizeof(v));
+            break;
+        }
+        case LOG_ARG_PTR:
+        {
+            void *v = va_arg(ap, void *);
+            memcpy(rec.bytes + n, &v, sizeof(v));
+            break;
+        }
+        case LOG_ARG_STR:
+        {
+            const char *s = va_arg(ap, const char *);
+            uint32_t room = LOG_REC_MAX - n;
+            uint32_t sl = 0;
+            if (!s)
+                s = "(null)";
+            if (room > LOG_STR_MAX)
+                room = LOG_STR_MAX;
+            while (sl + 1 < room && s[sl])
+                sl++;
+            memcpy(rec.bytes + n, s, sl);
+            rec.bytes[n + sl] = '\0';
+            n += sl + 1;
+            break;
+        }
+        }
+        if (kind != LOG_ARG_STR)
+            n += log_arg_size(kind);
+        p += len;
+    }
+
+    uint32_t size = (n + sizeof(LogRecord) - 1) & ~(uint32_t)(sizeof(LogRecord) - 1);
+    rec.hdr.fmt = fmt;
+    rec.hdr.size = (uint16_t)size;
+    rec.hdr.dest = (uint16_t)dest;
+
+    if (log_busy)
+    {
+        log_emit(&rec.hdr); /* preempted another producer */
+        return;
+    }
+    log_busy = 1;
+    if (!log_atexit_done)
+    {
+        log_atexit_done = 1;
+        atexit(log_ring_drain);
+    }
+    uint32_t head = log_head;
+    uint32_t pos = head & (LOG_RING_SIZE - 1);
+    uint32_t pad = LOG_RING_SIZE - pos < size ? LOG_RING_SIZE - pos : 0;
+    if (head + pad + size - log_tail > LOG_RING_SIZE)
+    {
+        log_dropped++;
+        log_busy = 0;
+        return;
+    }
+    if (pad)
+    {
+        LogRecord *r = (LogRecord *)(log_ring + pos);
+        r->fmt = NULL;
+        r->size = (uint16_t)pad;
+        head += pad;
+        pos = 0;
+    }
+    memcpy(log_ring + pos, rec.bytes, size);
+    LOG_BARRIER();
+    log_head = head + size;
+    log_busy = 0;
+}
+
+void log_ring_printf(int dest, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    log_ring_vprintf(dest, fmt, ap);
+    va_end(ap);
+}
+
+void log_ring_drain(void)
+{
+    uint32_t tail = log_tail;
+
+    while (tail != log_head)
+    {
+        LOG_BARRIER();
+        const LogRecord *r = (const LogRecord *)(log_ring + (tail & (LOG_RING_SIZE - 1)));
+        if (r->fmt)
+            log_emit(r);
+        tail += r->size;
+        LOG_BARRIER();
+        log_tail = tail; /* frees the space for producers as it goes */
+    }
+    if (log_dropped)
+    {
+        printf("[LOG] %u records dropped (ring full)\n", (unsigned)log_dropped);
+        log_dropped = 0;
+    }
+    fflush(stdout);
+}
+
+#endif /* ENABLE_LOG_RING */
@@ -8,9 +8,13 @@
  */
 
 #include "mdec.h"
+#include "mdec_kernels.h"
 #include "superpsx.h"
 #include "scheduler.h"
-#include "dynarec.h" /* jit_invalidate_page */
+#include "psx_dma.h"
+#include "config.h"
+#include "dynarec.h" /* jit_smc_invalidate_range */
+#include "savestate.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -33,22 +37,11 @@
 #define RLE_VAL(hw)  (((int)(hw) << (sizeof(int)*8 - 10)) >> (sizeof(int)*8 - 10))
 
 /* Fixed-point IDCT */
-#define AAN_CONST_BITS       12
 #define AAN_PRESCALE_BITS    16
-#define AAN_CONST_SIZE       24
-#define AAN_CONST_SCALE      (AAN_CONST_SIZE - AAN_CONST_BITS)
 #define AAN_PRESCALE_SIZE    20
 #define AAN_PRESCALE_SCALE   (AAN_PRESCALE_SIZE - AAN_PRESCALE_BITS)
 #define AAN_EXTRA            12
-
-#define SCALE(x, n)    ((x) >> (n))
-#define SCALER(x, n)   (((x) + ((1 << (n)) >> 1)) >> (n))
-#define MULS(var, c)   (SCALE((var) * (c), AAN_CONST_BITS))
-
-#define FIX_1_082392200  SCALER(18159528, AAN_CONST_SCALE)
-#define FIX_1_414213562  SCALER(23726566, AAN_CONST_SCALE)
-#define FIX_1_847759065  SCALER(31000253, AAN_CONST_SCALE)
-#define FIX_2_613125930  SCALER(43840978, AAN_CONST_SCALE)
+/* AAN_CONST_BITS, SCALE, SCALER: mdec_kernels.h */
 
 #define MDEC_END_OF_DATA 0xFE00
 
@@ -134,10 +127,21 @@ static struct {
     int scale_pos;                /* Halfwords written so far */
 } mdec;
 
+/* DMA1 transfer being decoded in slices (mdec_async) */
+static struct {
+    int active;
+    uint32_t adr;      /* next byte of the DMA1 destination (physical) */
+    uint32_t size;     /* bytes still to write */
+} mdec_job;
+
+static void mdec_job_drain(void);
+static int mdec_dma1_run(uint32_t adr, uint32_t bcr, uint32_t chcr, int allow_async);
+
 static int iq_y[DSIZE2];         /* Combined quant+scale for luminance */
 static int iq_uv[DSIZE2];        /* Combined quant+scale for chrominance */
 static int aan_only[DSIZE2];     /* AAN prescale without quant (for q_scale=0) */
 static int16_t scale_table[DSIZE2]; /* IDCT scale table (stored transposed) */
+static const MdecKernels *mdec_k = &mdec_kernels_c; /* IDCT / YUV→RGB kernels */
 
 #ifdef ENABLE_MDEC_IPU
 /* Raw quant tables for IPU path */
@@ -193,106 +197,6 @@ static void real_idct_core(int *blk) {
     }
 }
 
-static void idct(int *blk, int used_col) {
-    int tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
-    int z5, z10, z11, z12, z13;
-    int *ptr;
-
-    /* All-DC shortcut */
-    if (used_col == -1) {
-        int v = blk[0];
-        for (int i = 0; i < DSIZE2; i++)
-            blk[i] = v;
-        return;
-    }
-
-    /* Column pass */
-    ptr = blk;
-    for (int i = 0; i < DSIZE; i++, ptr++) {
-        if ((used_col & (1 << i)) == 0) {
-            if (ptr[DSIZE * 0]) {
-                int v = ptr[0];
-                for (int j = 0; j < DSIZE; j++)
-                    ptr[DSIZE * j] = v;
-                used_col |= (1 << i);
-            }
-            continue;
-        }
-
-        z10 = ptr[DSIZE * 0] + ptr[DSIZE * 4];
-        z11 = ptr[DSIZE * 0] - ptr[DSIZE * 4];
-        z13 = ptr[DSIZE * 2] + ptr[DSIZE * 6];
-        z12 = MULS(ptr[DSIZE * 2] - ptr[DSIZE * 6], FIX_1_414213562) - z13;
-
-        tmp0 = z10 + z13;
-        tmp3 = z10 - z13;
-        tmp1 = z11 + z12;
-        tmp2 = z11 - z12;
-
-        z13 = ptr[DSIZE * 3] + ptr[DSIZE * 5];
-        z10 = ptr[DSIZE * 3] - ptr[DSIZE * 5];
-        z11 = ptr[DSIZE * 1] + ptr[DSIZE * 7];
-        z12 = ptr[DSIZE * 1] - ptr[DSIZE * 7];
-
-        tmp7 = z11 + z13;
-        z5 = (z12 - z10) * FIX_1_847759065;
-        tmp6 = SCALE(z10 * FIX_2_613125930 + z5, AAN_CONST_BITS) - tmp7;
-        tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
-        tmp4 = SCALE(z12 * FIX_1_082392200 - z5, AAN_CONST_BITS) + tmp5;
-
-        ptr[DSIZE * 0] = tmp0 + tmp7;
-        ptr[DSIZE * 7] = tmp0 - tmp7;
-        ptr[DSIZE * 1] = tmp1 + tmp6;
-        ptr[DSIZE * 6] = tmp1 - tmp6;
-        ptr[DSIZE * 2] = tmp2 + tmp5;
-        ptr[DSIZE * 5] = tmp2 - tmp5;
-        ptr[DSIZE * 4] = tmp3 + tmp4;
-        ptr[DSIZE * 3] = tmp3 - tmp4;
-    }
-
-    /* Row pass */
-    ptr = blk;
-    if (used_col == 1) {
-        /* Only column 0 was non-zero — fill each row from its first element */
-        for (int i = 0; i < DSIZE; i++, ptr += DSIZE) {
-            int v = ptr[0];
-            ptr[1] = ptr[2] = ptr[3] = ptr[4] = ptr[5] = ptr[6] = ptr[7] = v;
-        }
-    } else {
-    for (int i = 0; i < DSIZE; i++, ptr += DSIZE) {
-        z10 = ptr[0] + ptr[4];
-        z11 = ptr[0] - ptr[4];
-        z13 = ptr[2] + ptr[6];
-        z12 = MULS(ptr[2] - ptr[6], FIX_1_414213562) - z13;
-
-        tmp0 = z10 + z13;
-        tmp3 = z10 - z13;
-        tmp1 = z11 + z12;
-        tmp2 = z11 - z12;
-
-        z13 = ptr[3] + ptr[5];
-        z10 = ptr[3] - ptr[5];
-        z11 = ptr[1] + ptr[7];
-        z12 = ptr[1] - ptr[7];
-
-        tmp7 = z11 + z13;
-        z5 = (z12 - z10) * FIX_1_847759065;
-        tmp6 = SCALE(z10 * FIX_2_613125930 + z5, AAN_CONST_BITS) - tmp7;
-        tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
-        tmp4 = SCALE(z12 * FIX_1_082392200 - z5, AAN_CONST_BITS) + tmp5;
-
-        ptr[0] = tmp0 + tmp7;
-        ptr[7] = tmp0 - tmp7;
-        ptr[1] = tmp1 + tmp6;
-        ptr[6] = tmp1 - tmp6;
-        ptr[2] = tmp2 + tmp5;
-        ptr[5] = tmp2 - tmp5;
-        ptr[4] = tmp3 + tmp4;
-        ptr[3] = tmp3 - tmp4;
-    }
-    } /* else (full row pass) */
-}
-
 /* ---------- RLE → blocks ---------- */
 
 static const uint16_t *rl2blk(int *blk, const uint16_t *rl) {
@@ -350,7 +254,7 @@ static const uint16_t *rl2blk(int *blk, const uint16_t *rl) {
         if (q_scale > 0) {
             if (k == 0) used_col = -1;
             /* IDCT this block (AAN fast path) */
-            idct(blk, used_col);
+            mdec_k->idct(blk, used_col);
         }
         blk += DSIZE2;
     }
@@ -405,7 +309,7 @@ static const uint16_t *rl2blk_mono(int *blk, const uint16_t *rl) {
     }
     if (q_scale > 0) {
         if (k == 0) used_col = -1;
-        idct(blk, used_col);
+        mdec_k->idct(blk, used_col);
     }
     return rl;
 }
@@ -431,130 +335,9 @@ static void y_to_mono4(int *blk, uint8_t *image, int signed_out) {
     }
 }
 
-/* ---------- YUV→RGB (15-bit / 24-bit) ---------- */
-
-/* Color coefficients (fixed-point, matching PCSX-ReARMed) */
-#define MULR(a)    ((1434 * (a)))
-#define MULB(a)    ((1807 * (a)))
-#define MULG(a)    ((-351 * (a)))
-#define MULG2(a,b) ((-351 * (a) - 728 * (b)))
-#define MULY(a)    ((a) << 10)
-
-#define SCALE8(c)  SCALER(c, 20)
-#define SCALE5(c)  SCALER(c, 23)
-
-static inline int clamp5(int v) {
-    v += 16;
-    return v < 0 ? 0 : (v > 31 ? 31 : v);
-}
-
-static inline int clamp8(int v) {
-    v += 128;
-    return v < 0 ? 0 : (v > 255 ? 255 : v);
-}
+/* ---------- YUV→RGB (15-bit / 24-bit): mdec_kernels.c ---------- */
 
-#define CLAMP_SCALE5(a) clamp5(SCALE5(a))
-#define CLAMP_SCALE8(a) clamp8(SCALE8(a))
-#define MAKERGB15(r,g,b,a) ((uint16_t)((a)|((b)<<10)|((g)<<5)|(r)))
-
-static void yuv2rgb15(int *blk, uint16_t *image) {
-    int *Yblk  = blk + DSIZE2 * 2;
-    int *Crblk = blk;
-    int *Cbblk = blk + DSIZE2;
-    uint16_t stp = (mdec.reg0 & MDEC0_STP) ? 0x8000 : 0;
-
-    for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 24) {
-        if (y == 8) Yblk += DSIZE2;
-        for (int x = 0; x < 4; x++, image += 2, Crblk++, Cbblk++, Yblk += 2) {
-            int R, G, B, Y;
-
-            /* Left half (Y1/Y3 block) */
-            R = MULR(*Crblk);
-            G = MULG2(*Cbblk, *Crblk);
-            B = MULB(*Cbblk);
-
-            Y = MULY(Yblk[0]);
-            image[0] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
-            Y = MULY(Yblk[1]);
-            image[1] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
-            Y = MULY(Yblk[8]);
-            image[16] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
-            Y = MULY(Yblk[9]);
-            image[17] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
-
-            /* Right half (Y2/Y4 block) */
-            R = MULR(*(Crblk + 4));
-            G = MULG2(*(Cbblk + 4), *(Crblk + 4));
-            B = MULB(*(Cbblk + 4));
-
-            Y = MULY(Yblk[DSIZE2]);
-            image[8] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
-            Y = MULY(Yblk[DSIZE2 + 1]);
-            image[9] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
-            Y = MULY(Yblk[DSIZE2 + 8]);
-            image[24] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
-            Y = MULY(Yblk[DSIZE2 + 9]);
-            image[25] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
-        }
-    }
-}
-
-static void yuv2rgb24(int *blk, uint8_t *image) {
-    int *Yblk  = blk + DSIZE2 * 2;
-    int *Crblk = blk;
-    int *Cbblk = blk + DSIZE2;
-
-    for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 8 * 3 * 3) {
-        if (y == 8) Yblk += DSIZE2;
-        for (int x = 0; x < 4; x++, image += 6, Crblk++, Cbblk++, Yblk += 2) {
-            int R, G, B, Y;
-
-            /* Left half */
-            R = MULR(*Crblk);
-            G = MULG2(*Cbblk, *Crblk);
-            B = MULB(*Cbblk);
-
-            Y = MULY(Yblk[0]);
-            image[0] = CLAMP_SCALE8(Y + R);
-            image[1] = CLAMP_SCALE8(Y + G);
-            image[2] = CLAMP_SCALE8(Y + B);
-            Y = MULY(Yblk[1]);
-            image[3] = CLAMP_SCALE8(Y + R);
-            image[4] = CLAMP_SCALE8(Y + G);
-            image[5] = CLAMP_SCALE8(Y + B);
-            Y = MULY(Yblk[8]);
-            image[16 * 3 + 0] = CLAMP_SCALE8(Y + R);
-            image[16 * 3 + 1] = CLAMP_SCALE8(Y + G);
-            image[16 * 3 + 2] = CLAMP_SCALE8(Y + B);
-            Y = MULY(Yblk[9]);
-            image[17 * 3 + 0] = CLAMP_SCALE8(Y + R);
-            image[17 * 3 + 1] = CLAMP_SCALE8(Y + G);
-            image[17 * 3 + 2] = CLAMP_SCALE8(Y + B);
-
-            /* Right half */
-            R = MULR(*(Crblk + 4));
-            G = MULG2(*(Cbblk + 4), *(Crblk + 4));
-            B = MULB(*(Cbblk + 4));
-
-            Y = MULY(Yblk[DSIZE2]);
-            image[8 * 3 + 0] = CLAMP_SCALE8(Y + R);
-            image[8 * 3 + 1] = CLAMP_SCALE8(Y + G);
-            image[8 * 3 + 2] = CLAMP_SCALE8(Y + B);
-            Y = MULY(Yblk[DSIZE2 + 1]);
-            image[9 * 3 + 0] = CLAMP_SCALE8(Y + R);
-            image[9 * 3 + 1] = CLAMP_SCALE8(Y + G);
-            image[9 * 3 + 2] = CLAMP_SCALE8(Y + B);
-            Y = MULY(Yblk[DSIZE2 + 8]);
-            image[24 * 3 + 0] = CLAMP_SCALE8(Y + R);
-            image[24 * 3 + 1] = CLAMP_SCALE8(Y + G);
-            image[24 * 3 + 2] = CLAMP_SCALE8(Y + B);
-            Y = MULY(Yblk[DSIZE2 + 9]);
-            image[25 * 3 + 0] = CLAMP_SCALE8(Y + R);
-            image[25 * 3 + 1] = CLAMP_SCALE8(Y + G);
-            image[25 * 3 + 2] = CLAMP_SCALE8(Y + B);
-        }
-    }
-}
+#define MDEC_STP_BIT() ((uint16_t)((mdec.reg0 & MDEC0_STP) ? 0x8000 : 0))
 
 /* ---------- Public API ---------- */
 
@@ -563,12 +346,31 @@ void MDEC_Init(void) {
     memset(iq_y, 0, sizeof(iq_y));
     memset(iq_uv, 0, sizeof(iq_uv));
     aan_only_init();
+    mdec_k = MDEC_KernelsSelect();
+    printf("[MDEC] %s kernels\n", mdec_k->name);
     mdec.fifo_state = MDEC_STATE_IDLE;
 #ifdef ENABLE_MDEC_IPU
     MDEC_IPU_Init();
 #endif
 }
 
+/* RLE pointers into RAM / mdec_in_buf stay valid: snapshots are in-process */
+void MDEC_State(StateIO *io) {
+    STATE_VAR(io, mdec);
+    STATE_VAR(io, mdec_job);
+    STATE_VAR(io, iq_y);
+    STATE_VAR(io, iq_uv);
+    STATE_VAR(io, scale_table);
+    STATE_VAR(io, mdec_in_buf);
+    STATE_VAR(io, mdec_in_write_idx);
+#ifdef ENABLE_MDEC_IPU
+    STATE_VAR(io, raw_qt_y);
+    STATE_VAR(io, raw_qt_uv);
+    if (io->load)
+        MDEC_IPU_LoadQuantTable(raw_qt_y, raw_qt_uv);
+#endif
+}
+
 void MDEC_WriteCommand(uint32_t data) {
     /* If we're in a FIFO-receiving state, this write is parameter data */
     if (mdec.fifo_state == MDEC_STATE_RECV_DATA) {
@@ -690,7 +492,7 @@ static void raster_to_block_15(uint16_t *buf) {
 
 /* Decode one macroblock into the non-DMA output FIFO */
 static void mdec_decode_out_block(void) {
-    int blk[DSIZE2 * 6];
+    int blk[DSIZE2 * 6] __attribute__((aligned(16)));
     int depth = (mdec.reg0 >> 27) & 3;
     int signed_out = (mdec.reg0 >> 26) & 1;
 
@@ -713,12 +515,12 @@ static void mdec_decode_out_block(void) {
         break;
     case 2:
         mdec.rl = rl2blk(blk, mdec.rl);
-        yuv2rgb24(blk, mdec.block_buffer);
+        mdec_k->yuv2rgb24(blk, mdec.block_buffer);
         mdec.out_end = SIZE_OF_24B_BLOCK;
         break;
     default:
         mdec.rl = rl2blk(blk, mdec.rl);
-        yuv2rgb15(blk, (uint16_t *)mdec.block_buffer);
+        mdec_k->yuv2rgb15(blk, (uint16_t *)mdec.block_buffer, MDEC_STP_BIT());
         /* Register reads output block order (Y1,Y2,Y3,Y4) like real hardware */
         raster_to_block_15((uint16_t *)mdec.block_buffer);
         mdec.out_end = SIZE_OF_16B_BLOCK;
@@ -752,6 +554,10 @@ uint32_t MDEC_ReadData(void) {
 
 void MDEC_WriteControl(uint32_t data) {
     if (data & MDEC1_RESET) {
+        if (mdec_job.active) {
+            Sched_Remove(SCHED_EVENT_MDEC);
+            MDEC_DMA1_Complete();
+        }
         mdec.reg0 = 0;
         mdec.reg1 = 0;
         mdec.rl = NULL;
@@ -858,6 +664,7 @@ void MDEC_DMA0(uint32_t adr, uint32_t bcr, uint32_t chcr) {
 
     switch ((cmd >> 29) & 7) {
     case 1: { /* Decode macroblocks */
+        mdec_job_drain();  /* previous output still in flight */
         mdec.reg1 |= MDEC1_BUSY;
         mdec.rl = (const uint16_t *)mem;
         mdec.rl_end = mdec.rl + total_words * 2;
@@ -886,8 +693,8 @@ void MDEC_DMA0(uint32_t adr, uint32_t bcr, uint32_t chcr) {
 
         /* If a DMA1 request was pending, process it now */
         if (mdec.pending_dma1.adr) {
-            MDEC_DMA1(mdec.pending_dma1.adr, mdec.pending_dma1.bcr,
-                       mdec.pending_dma1.chcr);
+            mdec_dma1_run(mdec.pending_dma1.adr, mdec.pending_dma1.bcr,
+                          mdec.pending_dma1.chcr, 0);
         }
         mdec.pending_dma1.adr = 0;
         break;
@@ -922,7 +729,147 @@ void MDEC_DMA0(uint32_t adr, uint32_t bcr, uint32_t chcr) {
 
 /* ---------- DMA1: MDEC → RAM (decoded output) ---------- */
 
-void MDEC_DMA1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
+static uint32_t mdec_block_bytes(int depth) {
+    switch (depth) {
+    case 0:  return SIZE_OF_4B_BLOCK;
+    case 1:  return SIZE_OF_8B_BLOCK;
+    case 2:  return SIZE_OF_24B_BLOCK;
+    default: return SIZE_OF_16B_BLOCK;
+    }
+}
+
+/* Decode up to max_blocks whole macroblocks into image.  Advances image
+ * and *size past what was written. */
+static uint8_t *mdec_decode_blocks(uint8_t *image, uint32_t *size, uint32_t max_blocks) {
+    int blk[DSIZE2 * 6] __attribute__((aligned(16)));
+    int depth = (mdec.reg0 >> 27) & 3;
+    int signed_out = (mdec.reg0 >> 26) & 1;
+    uint32_t block_bytes = mdec_block_bytes(depth);
+    uint32_t limit = *size;
+
+    if (max_blocks && limit / block_bytes > max_blocks)
+        limit = max_blocks * block_bytes;
+
+#ifdef ENABLE_MDEC_IPU
+    /* Try IPU hardware path for colored modes (15-bit, 24-bit) */
+    if (depth >= 2) {
+        int stp_bit = (mdec.reg0 & MDEC0_STP) ? 1 : 0;
+        int ret = MDEC_IPU_DecodeDMA1(&mdec.rl, mdec.rl_end,
+                                       image, limit,
+                                       depth, signed_out, stp_bit);
+        if (ret >= 0) {
+            *size -= ret;
+            return image + ret;
+        }
+        /* ret < 0: IPU unavailable, fall through to software path */
+    }
+#endif
+    while (limit >= block_bytes && mdec.rl < mdec.rl_end) {
+        if (depth <= 1) {
+            mdec.rl = rl2blk_mono(blk, mdec.rl);
+            if (depth == 0)
+                y_to_mono4(blk, image, signed_out);
+            else
+                y_to_mono8(blk, image, signed_out);
+        } else if (depth == 2) {
+            mdec.rl = rl2blk(blk, mdec.rl);
+            mdec_k->yuv2rgb24(blk, image);
+        } else {
+            mdec.rl = rl2blk(blk, mdec.rl);
+            mdec_k->yuv2rgb15(blk, (uint16_t *)image, MDEC_STP_BIT());
+        }
+        image += block_bytes;
+        limit -= block_bytes;
+        *size -= block_bytes;
+    }
+    return image;
+}
+
+/* Fill the last size (< one block) bytes of a DMA1 from a fresh block,
+ * keeping the rest in block_buffer for the next DMA1 */
+static void mdec_decode_partial(uint8_t *image, uint32_t size) {
+    int blk[DSIZE2 * 6] __attribute__((aligned(16)));
+    int depth = (mdec.reg0 >> 27) & 3;
+    int signed_out = (mdec.reg0 >> 26) & 1;
+
+    if (size == 0 || mdec.rl >= mdec.rl_end)
+        return;
+    if (depth <= 1) {
+        mdec.rl = rl2blk_mono(blk, mdec.rl);
+        if (depth == 0)
+            y_to_mono4(blk, mdec.block_buffer, signed_out);
+        else
+            y_to_mono8(blk, mdec.block_buffer, signed_out);
+    } else if (depth == 2) {
+        mdec.rl = rl2blk(blk, mdec.rl);
+        mdec_k->yuv2rgb24(blk, mdec.block_buffer);
+    } else {
+        mdec.rl = rl2blk(blk, mdec.rl);
+        mdec_k->yuv2rgb15(blk, (uint16_t *)mdec.block_buffer, MDEC_STP_BIT());
+    }
+    memcpy(image, mdec.block_buffer, size);
+    mdec.block_buffer_pos = mdec.block_buffer + size;
+}
+
+static void mdec_invalidate(uint32_t adr, uint32_t size) {
+    if (size == 0)
+        return;
+    jit_smc_invalidate_range(adr, adr + size);
+}
+
+/* Pipelined decode (mdec_async = 1): DMA1 only records the transfer;
+ * SCHED_EVENT_MDEC then decodes MDEC_SLICE_BLOCKS macroblocks at a time,
+ * each slice landing when the MDEC would have produced it (MDEC_BIAS
+ * cycles per output word), and MDEC_DMA1_Complete ends the transfer.
+ * The CPU runs between slices, so a 320x240 frame no longer decodes in
+ * one go inside the CHCR write. */
+#define MDEC_SLICE_BLOCKS 8
+
+static uint64_t mdec_slice_cycles(uint32_t bytes) {
+    uint64_t c = (uint64_t)(bytes / 4) * MDEC_BIAS;
+    return c < 32 ? 32 : c;
+}
+
+/* Decode the next slice.  Returns 1 when the transfer is complete. */
+static int mdec_job_slice(uint32_t max_blocks) {
+    uint8_t *image = &psx_ram[mdec_job.adr];
+    uint32_t before = mdec_job.size;
+    uint32_t block_bytes = mdec_block_bytes((mdec.reg0 >> 27) & 3);
+
+    image = mdec_decode_blocks(image, &mdec_job.size, max_blocks);
+    int done = mdec_job.size < block_bytes || mdec.rl >= mdec.rl_end;
+    if (done) {
+        mdec_decode_partial(image, mdec_job.size);
+        mdec_job.size = 0;
+    }
+    mdec_invalidate(mdec_job.adr, before - mdec_job.size);
+    mdec_job.adr += before - mdec_job.size;
+    return done;
+}
+
+static void MDEC_EventCallback(int ticks_late) {
+    (void)ticks_late;
+    if (!mdec_job.active)
+        return;
+    uint32_t before = mdec_job.size;
+    if (mdec_job_slice(MDEC_SLICE_BLOCKS)) {
+        MDEC_DMA1_Complete();
+        return;
+    }
+    Sched_Add(SCHED_EVENT_MDEC, global_cycles + mdec_slice_cycles(before - mdec_job.size),
+              MDEC_EventCallback);
+}
+
+/* Finish an in-flight transfer now (new input, reset) */
+static void mdec_job_drain(void) {
+    if (!mdec_job.active)
+        return;
+    Sched_Remove(SCHED_EVENT_MDEC);
+    mdec_job_slice(0);
+    MDEC_DMA1_Complete();
+}
+
+static int mdec_dma1_run(uint32_t adr, uint32_t bcr, uint32_t chcr, int allow_async) {
     uint32_t block_size  = bcr & 0xFFFF;
     uint32_t block_count = (bcr >> 16) & 0xFFFF;
     if (block_count == 0) block_count = 1;
@@ -931,7 +878,7 @@ void MDEC_DMA1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
 
     if (chcr != 0x01000200) {
         printf("[MDEC] DMA1: unexpected chcr %08X\n", (unsigned)chcr);
-        return;
+        return 0;
     }
 
 #ifdef ENABLE_VRAM_DUMP
@@ -945,7 +892,7 @@ void MDEC_DMA1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
         mdec.pending_dma1.adr = adr;
         mdec.pending_dma1.bcr = bcr;
         mdec.pending_dma1.chcr = chcr;
-        return;
+        return 0;
     }
 
     adr &= 0x1FFFFC;
@@ -953,22 +900,11 @@ void MDEC_DMA1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
 
     if (adr + size > PSX_RAM_SIZE) {
         printf("[MDEC] DMA1: bad madr %08X size %u\n", (unsigned)adr, (unsigned)size);
-        return;
+        return 0;
     }
 
     uint8_t *image = &psx_ram[adr];
-    int blk[DSIZE2 * 6];
-    int depth = (mdec.reg0 >> 27) & 3;
-    int signed_out = (mdec.reg0 >> 26) & 1;
-
-    /* Select block size and decode function based on depth */
-    uint32_t block_bytes;
-    switch (depth) {
-    case 0:  block_bytes = SIZE_OF_4B_BLOCK;  break;
-    case 1:  block_bytes = SIZE_OF_8B_BLOCK;  break;
-    case 2:  block_bytes = SIZE_OF_24B_BLOCK; break;
-    default: block_bytes = SIZE_OF_16B_BLOCK; break;
-    }
+    uint32_t block_bytes = mdec_block_bytes((mdec.reg0 >> 27) & 3);
 
     /* Flush partial block from previous DMA1 */
     if (mdec.block_buffer_pos != 0) {
@@ -980,76 +916,40 @@ void MDEC_DMA1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
         mdec.block_buffer_pos = 0;
     }
 
-    /* Decode macroblocks */
-#ifdef ENABLE_MDEC_IPU
-    /* Try IPU hardware path for colored modes (15-bit, 24-bit) */
-    if (depth >= 2) {
-        int stp_bit = (mdec.reg0 & MDEC0_STP) ? 1 : 0;
-        int ret = MDEC_IPU_DecodeDMA1(&mdec.rl, mdec.rl_end,
-                                       image, size,
-                                       depth, signed_out, stp_bit);
-        if (ret >= 0) {
-            image += ret;
-            size  -= ret;
-            goto dma1_partial; /* handle any remaining partial block via software */
-        }
-        /* ret < 0: IPU unavailable, fall through to software path */
-    }
-#endif
-    while (size >= block_bytes && mdec.rl < mdec.rl_end) {
-        if (depth <= 1) {
-            mdec.rl = rl2blk_mono(blk, mdec.rl);
-            if (depth == 0)
-                y_to_mono4(blk, image, signed_out);
-            else
-                y_to_mono8(blk, image, signed_out);
-        } else if (depth == 2) {
-            mdec.rl = rl2blk(blk, mdec.rl);
-            yuv2rgb24(blk, image);
-        } else {
-            mdec.rl = rl2blk(blk, mdec.rl);
-            yuv2rgb15(blk, (uint16_t *)image);
-        }
-        image += block_bytes;
-        size -= block_bytes;
+    if (allow_async && psx_config.mdec_async && size >= block_bytes) {
+        mdec_invalidate(adr, total_words * 4 - size);
+        mdec_job.active = 1;
+        mdec_job.adr = adr + (total_words * 4 - size);
+        mdec_job.size = size;
+        uint32_t first = size < MDEC_SLICE_BLOCKS * block_bytes ? size : MDEC_SLICE_BLOCKS * block_bytes;
+        Sched_Add(SCHED_EVENT_MDEC, global_cycles + mdec_slice_cycles(first),
+                  MDEC_EventCallback);
+        return 1;
     }
 
-    /* Handle partial block at end of DMA */
-#ifdef ENABLE_MDEC_IPU
-dma1_partial:
-#endif
-    if (size != 0 && mdec.rl < mdec.rl_end) {
-        if (depth <= 1) {
-            mdec.rl = rl2blk_mono(blk, mdec.rl);
-            if (depth == 0)
-                y_to_mono4(blk, mdec.block_buffer, signed_out);
-            else
-                y_to_mono8(blk, mdec.block_buffer, signed_out);
-        } else if (depth == 2) {
-            mdec.rl = rl2blk(blk, mdec.rl);
-            yuv2rgb24(blk, mdec.block_buffer);
-        } else {
-            mdec.rl = rl2blk(blk, mdec.rl);
-            yuv2rgb15(blk, (uint16_t *)mdec.block_buffer);
-        }
-        memcpy(image, mdec.block_buffer, size);
-        mdec.block_buffer_pos = mdec.block_buffer + size;
-    }
+    image = mdec_decode_blocks(image, &size, 0);
+    mdec_decode_partial(image, size);
 
     /* Invalidate JIT pages that were written */
-    uint32_t start_page = (adr >> 12);
-    uint32_t end_page   = ((adr + total_words * 4 - 1) >> 12);
-    for (uint32_t p = start_page; p <= end_page && p < (PSX_RAM_SIZE >> 12); p++)
-        jit_invalidate_page(p);
+    mdec_invalidate(adr, total_words * 4);
 
     /* Clear busy only when all RLE data has been consumed */
     if (!mdec.rl || mdec.rl >= mdec.rl_end)
         mdec.reg1 &= ~MDEC1_BUSY;
+    return 0;
+}
 
-    /* Timing: defer completion for realistic bus timing */
-    /* For now, complete immediately — timing refinement in Phase 2 */
+int MDEC_DMA1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
+    return mdec_dma1_run(adr, bcr, chcr, 1);
 }
 
 void MDEC_DMA1_Complete(void) {
-    /* Placeholder for scheduler-based deferred completion */
+    if (!mdec_job.active)
+        return;
+    mdec_job.active = 0;
+    mdec_job.size = 0;
+    /* Clear busy only when all RLE data has been consumed */
+    if (!mdec.rl || mdec.rl >= mdec.rl_end)
+        mdec.reg1 &= ~MDEC1_BUSY;
+    DMA_CompleteChannel(1);
 }
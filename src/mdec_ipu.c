@@ -14,6 +14,8 @@
  *   - IDP=2 in IPU_CTRL (10-bit DC precision, pred=512)
  *   - DC: F[0] = (512 + dc_diff) << 1 = (512 + dc_diff) * 2
  *   - BitWriter byte-swaps for big-endian bitstream (IPU convention)
+ *   - A DMA1 is sent as slices of up to IPU_BATCH_MB macroblocks, one
+ *     IDEC each, double-buffered so encode / convert overlap the IPU
  *
  * Reference: PCSX2 IPU_MultiISA.cpp, ps2sdk libmpeg_core.c
  */
@@ -172,12 +174,22 @@ static inline void encode_ac_escape(BitWriter *bw, int run, int level) {
 
 /* ── Aligned DMA buffers ─────────────────────────────────────────── */
 
-/* Max VLC bitstream: ~24 bits/coeff × 64 coeffs × 6 blocks ≈ 1152 bytes
- * Plus headers/EOBs/padding. 4096 bytes is generous. */
-static uint32_t ipu_vlc_buf[1024] __attribute__((aligned(64)));
+/* Macroblocks per IPU stream.  A DMA1 is cut into batches of this many
+ * macroblocks; each batch is one IDEC slice, and two sets of buffers let
+ * the CPU encode batch N+1 and convert batch N-1 while the IPU decodes
+ * batch N. */
+#define IPU_BATCH_MB 16
 
-/* IPU RGB32 output: 16×16×4 = 1024 bytes = 64 QW */
-static uint32_t ipu_rgb_buf[256]  __attribute__((aligned(64)));
+/* Worst-case VLC per macroblock: 1 (type) + 1 (MBA) + 6 × (9 DC size +
+ * 11 DC diff + 63 × 24 escape + 2 EOB) bits ≈ 288 words.  Plus the slice
+ * termination and quadword padding. */
+#define IPU_MB_VLC_WORDS 288
+#define IPU_VLC_WORDS    (IPU_BATCH_MB * IPU_MB_VLC_WORDS + 16)
+
+static uint32_t ipu_vlc_buf[2][IPU_VLC_WORDS] __attribute__((aligned(64)));
+
+/* IPU RGB32 output: 16×16×4 = 1024 bytes = 64 QW per macroblock */
+static uint32_t ipu_rgb_buf[2][IPU_BATCH_MB * 256] __attribute__((aligned(64)));
 
 /* Raw MDEC quant tables (stored in zigzag order, as received from PSX) */
 static uint8_t  ipu_qt_y[64]  __attribute__((aligned(16)));
@@ -261,17 +273,22 @@ static inline int clip_1024(int v) {
 }
 
 /*
- * Decode one macroblock via IPU IDEC.
+ * Encode one macroblock into the batch bitstream.
  *
- * Parses 6 MDEC blocks (Cr, Cb, Y1-Y4), dequants in software,
- * re-encodes as MPEG-2 intra VLC, feeds to IPU for IDCT + CSC.
+ * Parses 6 MDEC blocks (Cr, Cb, Y1-Y4), dequants in software and
+ * re-encodes them as MPEG-2 intra VLC.  dc_pred carries the DC
+ * predictors across the macroblocks of one slice; first = 1 for the
+ * slice's first macroblock, the others are preceded by a macroblock
+ * address increment of 1.
  *
  * Returns: pointer past consumed RLE data.
  */
-static const uint16_t *ipu_decode_macroblock(const uint16_t *rl,
+static const uint16_t *ipu_encode_macroblock(BitWriter *bw,
+                                              const uint16_t *rl,
                                               const uint8_t *qt_y,
                                               const uint8_t *qt_uv,
-                                              int signed_out)
+                                              int signed_out,
+                                              int *dc_pred, int first)
 {
     /* ── Step 1: Parse all 6 blocks in MDEC order, dequant ──────── */
     struct {
@@ -320,24 +337,23 @@ static const uint16_t *ipu_decode_macroblock(const uint16_t *rl,
 
     /* ── Step 2: Encode as MPEG-2 VLC bitstream ─────────────────── */
 
-    BitWriter bw;
-    bw_init(&bw, ipu_vlc_buf);
+    /* macroblock_address_increment = 1 ('1') between macroblocks of
+     * the slice; the first one's address comes from the slice start */
+    if (!first)
+        bw_put(bw, 0x80000000u, 1);
 
     /*
      * MPEG-2 I-type macroblock header:
      *   macroblock_type = '1' (1 bit) → MACROBLOCK_INTRA, no quant override
      *   No dct_type bit because DTD=0 in IDEC → frame_pred_frame_dct=1
      */
-    bw_put(&bw, 0x80000000u, 1);  /* '1' = MACROBLOCK_INTRA */
+    bw_put(bw, 0x80000000u, 1);  /* '1' = MACROBLOCK_INTRA */
 
     /* Block order: MPEG = Y1(2), Y2(3), Y3(4), Y4(5), Cb(1), Cr(0) */
     static const int mpeg_order[6] = { 2, 3, 4, 5, 1, 0 };
     /* DC predictor component index: 0=Y, 1=Cb, 2=Cr */
     static const int dc_cc[6] = { 0, 0, 0, 0, 1, 2 };
 
-    /* DC predictors: init = 128 << IDP = 128 << 2 = 512 */
-    int dc_pred[3] = { 512, 512, 512 };
-
     for (int idx = 0; idx < 6; idx++) {
         int bi = mpeg_order[idx];
         int cc = dc_cc[idx];
@@ -357,22 +373,45 @@ static const uint16_t *ipu_decode_macroblock(const uint16_t *rl,
             dc_target += 1024;  /* shift to unsigned range for IPU */
         int dc_half = (dc_target >= 0) ? (dc_target / 2) : -(((-dc_target) + 1) / 2);
         int dc_diff = dc_half - dc_pred[cc];
-        dc_pred[cc] = dc_half;  /* Update predictor */
 
         /* Clamp dc_diff to encodable range (size ≤ 11 → ±2047) */
         if (dc_diff > 2047) dc_diff = 2047;
         if (dc_diff < -2047) dc_diff = -2047;
+        dc_pred[cc] += dc_diff;  /* what the IPU's predictor now holds */
 
-        encode_dc(&bw, dc_diff, is_chroma);
+        encode_dc(bw, dc_diff, is_chroma);
 
         /* AC coefficients — all as 24-bit escape codes */
         for (int j = 0; j < blocks[bi].n_ac; j++) {
-            encode_ac_escape(&bw, blocks[bi].ac[j].run,
+            encode_ac_escape(bw, blocks[bi].ac[j].run,
                               blocks[bi].ac[j].level_dequant);
         }
 
         /* EOB */
-        bw_put(&bw, VLC_EOB_CODE << 30, VLC_EOB_BITS);
+        bw_put(bw, VLC_EOB_CODE << 30, VLC_EOB_BITS);
+    }
+
+    return p;
+}
+
+/*
+ * Encode up to max_mb macroblocks as one slice into vlc.
+ * Returns the macroblock count; *qwc receives the stream length.
+ */
+static int ipu_encode_batch(uint32_t *vlc, const uint16_t **rl,
+                            const uint16_t *rl_end, int max_mb,
+                            int signed_out, int *qwc)
+{
+    BitWriter bw;
+    /* DC predictors: init = 128 << IDP = 128 << 2 = 512 */
+    int dc_pred[3] = { 512, 512, 512 };
+    int n = 0;
+
+    bw_init(&bw, vlc);
+    while (n < max_mb && *rl < rl_end) {
+        *rl = ipu_encode_macroblock(&bw, *rl, ipu_qt_y, ipu_qt_uv,
+                                    signed_out, dc_pred, n == 0);
+        n++;
     }
 
     /*
@@ -386,21 +425,25 @@ static const uint16_t *ipu_decode_macroblock(const uint16_t *rl,
     /* Flush current word */
     bw_flush(&bw);
     /* Zero padding words (for MBA fail: need ≥16 zero bits) */
-    ipu_vlc_buf[bw.words++] = 0;  /* 32 zero bits */
+    vlc[bw.words++] = 0;  /* 32 zero bits */
     /* 0xFF marker byte at MSB (big-endian: 0xFF000000 after bswap → byte 0xFF) */
-    ipu_vlc_buf[bw.words++] = __builtin_bswap32(0xFF000000u);
+    vlc[bw.words++] = __builtin_bswap32(0xFF000000u);
     /* 32-bit pad for ipuRegs.top read */
-    ipu_vlc_buf[bw.words++] = 0;
+    vlc[bw.words++] = 0;
 
     /* Pad to quadword boundary (16 bytes) */
     while (bw.words & 3)
-        ipu_vlc_buf[bw.words++] = 0;
-
-    int vlc_qwc = bw.words / 4;
+        vlc[bw.words++] = 0;
 
-    /* ── Step 3: Feed VLC to IPU via DMA ch4, output via DMA ch3 ── */
-    FlushCache(0);
+    *qwc = bw.words / 4;
+    return n;
+}
 
+/* Start IDEC on an encoded batch: VLC in via DMA ch4, RGB32 out via ch3.
+ * The caller has written the VLC back (FlushCache) already. */
+static void ipu_kick(const uint32_t *vlc, int qwc, uint32_t *rgb, int n_mb,
+                     int signed_out)
+{
     /* BCLR: clear input FIFO */
     *R_EE_IPU_CMD = IPU_CMD_BCLR;
     while (*R_EE_IPU_CTRL & IPU_CTRL_BUSY);
@@ -411,24 +454,29 @@ static const uint16_t *ipu_decode_macroblock(const uint16_t *rl,
                       | (2u << 16);
     *R_EE_IPU_CMD = idec_cmd;
 
-    /* Start DMA ch3 (fromIPU): receive RGB32 output (64 QW) */
-    *R_EE_D3_MADR = (uint32_t)(uintptr_t)ipu_rgb_buf;
-    *R_EE_D3_QWC  = 64;
+    /* Start DMA ch3 (fromIPU): receive RGB32 output (64 QW per MB) */
+    *R_EE_D3_MADR = (uint32_t)(uintptr_t)rgb;
+    *R_EE_D3_QWC  = 64 * n_mb;
     *R_EE_D3_CHCR = 0x100;  /* DIR=to_MEM, normal, STR */
 
     /* Start DMA ch4 (toIPU): feed VLC data from memory to IPU FIFO */
-    *R_EE_D4_MADR = (uint32_t)(uintptr_t)ipu_vlc_buf;
-    *R_EE_D4_QWC  = vlc_qwc;
+    *R_EE_D4_MADR = (uint32_t)(uintptr_t)vlc;
+    *R_EE_D4_QWC  = qwc;
     *R_EE_D4_CHCR = 0x101;  /* DIR=from_MEM, normal, STR */
+}
 
-    /* Wait for DMA ch3 (output received = IDEC decoded the macroblock) */
+/* Wait for a kicked batch and return the IPU to a state ready for the
+ * next IDEC */
+static void ipu_finish(void)
+{
+    /* Wait for DMA ch3 (output received = IDEC decoded the slice) */
     wait_d3();
 
     /* Stop DMA ch4 if still running (termination data may keep it alive) */
     *R_EE_D4_CHCR = 0;
 
     /* Force-reset IPU to abort the IDEC command cleanly.
-     * After D3 completes, IDEC has decoded the macroblock but is still
+     * After D3 completes, IDEC has decoded the slice but is still
      * parsing MBA/finish — it stalls waiting for FIFO data.  RST aborts it. */
     *R_EE_IPU_CTRL = (1u << 30);  /* RST bit */
     while (*R_EE_IPU_CTRL & (1u << 30));  /* wait RST to self-clear */
@@ -436,10 +484,6 @@ static const uint16_t *ipu_decode_macroblock(const uint16_t *rl,
     /* Restore IPU state lost by RST: IDP=2, identity quant table */
     *R_EE_IPU_CTRL = IPU_CTRL_IDP_10BIT;
     ipu_load_qt(ipu_identity_qt, 0);
-
-    FlushCache(0);
-
-    return p;
 }
 
 /* ── Format converters ───────────────────────────────────────────── */
@@ -447,17 +491,63 @@ static const uint16_t *ipu_decode_macroblock(const uint16_t *rl,
 /*
  * IPU RGB32 pixel layout: R(7:0), G(15:8), B(23:16), A(31:24)
  * PSX 15-bit: R(4:0), G(9:5), B(14:10), STP(15)
+ *
+ * MMI: per 32-bit lane, (px >> 3) & 0x1F | (px >> 6) & 0x3E0 |
+ * (px >> 9) & 0x7C00 | stp, then PPACH packs two quadwords of lanes into
+ * eight halfwords — 8 pixels per iteration.  Unaligned destinations go
+ * through an aligned bounce buffer (sq needs 16-byte alignment).
  */
+static const uint32_t mmi_mask_r[4] __attribute__((aligned(16))) = { 0x001F, 0x001F, 0x001F, 0x001F };
+static const uint32_t mmi_mask_g[4] __attribute__((aligned(16))) = { 0x03E0, 0x03E0, 0x03E0, 0x03E0 };
+static const uint32_t mmi_mask_b[4] __attribute__((aligned(16))) = { 0x7C00, 0x7C00, 0x7C00, 0x7C00 };
+static uint32_t       mmi_stp[4]    __attribute__((aligned(16)));
+
 static void rgb32_to_rgb15(const uint32_t *rgb32, uint16_t *rgb15,
                            int stp_bit) {
-    uint16_t stp = stp_bit ? 0x8000 : 0;
-    for (int i = 0; i < 256; i++) {
-        uint32_t px = rgb32[i];
-        uint8_t r = (px >>  0) & 0xFF;
-        uint8_t g = (px >>  8) & 0xFF;
-        uint8_t b = (px >> 16) & 0xFF;
-        rgb15[i] = ((r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10)) | stp;
+    uint16_t tmp[256] __attribute__((aligned(16)));
+    uint16_t *dst = ((uintptr_t)rgb15 & 15) ? tmp : rgb15;
+    uint32_t stp = stp_bit ? 0x8000 : 0;
+
+    mmi_stp[0] = mmi_stp[1] = mmi_stp[2] = mmi_stp[3] = stp;
+    for (int i = 0; i < 256; i += 8) {
+        __asm__ volatile(
+            "lq    $12, 0(%2)\n"
+            "lq    $13, 0(%3)\n"
+            "lq    $14, 0(%4)\n"
+            "lq    $15, 0(%5)\n"
+            "lq    $8, 0(%0)\n"
+            "lq    $9, 16(%0)\n"
+            /* lanes 0-3 */
+            "psrlw $10, $8, 3\n"
+            "pand  $10, $10, $12\n"
+            "psrlw $11, $8, 6\n"
+            "pand  $11, $11, $13\n"
+            "por   $10, $10, $11\n"
+            "psrlw $11, $8, 9\n"
+            "pand  $11, $11, $14\n"
+            "por   $10, $10, $11\n"
+            "por   $8, $10, $15\n"
+            /* lanes 4-7 */
+            "psrlw $10, $9, 3\n"
+            "pand  $10, $10, $12\n"
+            "psrlw $11, $9, 6\n"
+            "pand  $11, $11, $13\n"
+            "por   $10, $10, $11\n"
+            "psrlw $11, $9, 9\n"
+            "pand  $11, $11, $14\n"
+            "por   $10, $10, $11\n"
+            "por   $9, $10, $15\n"
+            /* upper halfwords from lanes 4-7, lower from 0-3 */
+            "ppach $10, $9, $8\n"
+            "sq    $10, 0(%1)\n"
+            :
+            : "r"(&rgb32[i]), "r"(&dst[i]), "r"(mmi_mask_r), "r"(mmi_mask_g),
+              "r"(mmi_mask_b), "r"(mmi_stp)
+            : "$8", "$9", "$10", "$11", "$12", "$13", "$14", "$15", "memory"
+        );
     }
+    if (dst != rgb15)
+        memcpy(rgb15, tmp, sizeof(tmp));
 }
 
 static void rgb32_to_rgb24(const uint32_t *rgb32, uint8_t *rgb24) {
@@ -506,32 +596,71 @@ int MDEC_IPU_DecodeDMA1(const uint16_t **rl, const uint16_t *rl_end,
 {
     if (depth < 2) return -1;  /* only 15-bit and 24-bit modes */
     if (!ipu_qt_loaded) {
-        printf("[MDEC-IPU] quant not loaded, fallback\n");
+        DLOG("quant not loaded, fallback\n");
         return -1;
     }
 
-    printf("[MDEC-IPU] DecodeDMA1 enter: depth=%d size=%u\n", depth, (unsigned)size);
-
     uint32_t block_bytes = (depth == 2) ? (16*16*3) : (16*16*2);
+    uint32_t total = size / block_bytes;  /* whole macroblocks wanted */
     uint32_t written = 0;
-    int mb_count = 0;
+    int qwc[2], n_mb[2];
+    int cur = 0;
+
+    if (total == 0 || *rl >= rl_end)
+        return 0;
 
-    while (size >= block_bytes && *rl < rl_end) {
-        *rl = ipu_decode_macroblock(*rl, ipu_qt_y, ipu_qt_uv, signed_out);
+    /* Prime the pipeline: batch 0 decoding, batch 1 encoded behind it */
+    n_mb[0] = ipu_encode_batch(ipu_vlc_buf[0], rl, rl_end,
+                               total < IPU_BATCH_MB ? (int)total : IPU_BATCH_MB,
+                               signed_out, &qwc[0]);
+    total -= n_mb[0];
+    FlushCache(0);
+    ipu_kick(ipu_vlc_buf[0], qwc[0], ipu_rgb_buf[0], n_mb[0], signed_out);
+
+    n_mb[1] = 0;
+    if (total && *rl < rl_end) {
+        n_mb[1] = ipu_encode_batch(ipu_vlc_buf[1], rl, rl_end,
+                                   total < IPU_BATCH_MB ? (int)total : IPU_BATCH_MB,
+                                   signed_out, &qwc[1]);
+        total -= n_mb[1];
+    }
 
-        if (depth == 2)
-            rgb32_to_rgb24(ipu_rgb_buf, image);
-        else
-            rgb32_to_rgb15(ipu_rgb_buf, (uint16_t *)image, stp_bit);
+    for (;;) {
+        int next = cur ^ 1;
+
+        ipu_finish();
+        /* Writes the next batch's VLC back and drops stale RGB lines */
+        FlushCache(0);
+        if (n_mb[next])
+            ipu_kick(ipu_vlc_buf[next], qwc[next], ipu_rgb_buf[next],
+                     n_mb[next], signed_out);
+
+        /* Convert this batch while the IPU works on the next one */
+        for (int m = 0; m < n_mb[cur]; m++) {
+            const uint32_t *src = &ipu_rgb_buf[cur][m * 256];
+            if (depth == 2)
+                rgb32_to_rgb24(src, image);
+            else
+                rgb32_to_rgb15(src, (uint16_t *)image, stp_bit);
+            image   += block_bytes;
+            written += block_bytes;
+        }
 
-        image   += block_bytes;
-        size    -= block_bytes;
-        written += block_bytes;
-        mb_count++;
+        if (!n_mb[next])
+            break;
+
+        /* Refill this batch's VLC buffer (its DMA ch4 input is done) */
+        n_mb[cur] = 0;
+        if (total && *rl < rl_end) {
+            n_mb[cur] = ipu_encode_batch(ipu_vlc_buf[cur], rl, rl_end,
+                                         total < IPU_BATCH_MB ? (int)total : IPU_BATCH_MB,
+                                         signed_out, &qwc[cur]);
+            total -= n_mb[cur];
+        }
+        cur = next;
     }
 
-    printf("[MDEC-IPU] Decoded %d macroblocks, %u bytes written\n",
-           mb_count, (unsigned)written);
+    DLOG("Decoded %u bytes\n", (unsigned)written);
     return (int)written;
 }
 
@@ -0,0 +1,739 @@
+/*
+ * mdec_kernels.c — MDEC IDCT and YUV→RGB kernels
+ *
+ * The scalar kernels are the reference (PCSX-ReARMed AAN IDCT and colour
+ * conversion).  The MMI (EE) and SSE2 (host) kernels run the same integer
+ * arithmetic four 32-bit lanes at a time:
+ *   - IDCT: the column pass works on four columns per vector (rows are
+ *     contiguous), the row pass on the transposed block.  Zero columns
+ *     and DC-only blocks take the scalar shortcuts' results, which the
+ *     full AAN reproduces exactly, so output matches bit for bit.
+ *   - YUV→RGB: the chroma terms are computed once per chroma sample and
+ *     widened to one entry per pixel column; each 8-pixel luma run is
+ *     then add / round / clamp / pack in vectors.
+ * Lane wrap-around equals the 32-bit wrap of the scalar code, so even
+ * saturated input gives identical results.
+ *
+ * PSP: the VFPU only has float lanes, which cannot reproduce the 32-bit
+ * fixed-point rounding, so the PSP uses the scalar table.
+ */
+#include "mdec_kernels.h"
+#include <string.h>
+
+#define DSIZE   8
+#define DSIZE2  (DSIZE * DSIZE)
+
+#define AAN_CONST_SIZE  24
+#define AAN_CONST_SCALE (AAN_CONST_SIZE - AAN_CONST_BITS)
+#define MULS(var, c)    (SCALE((var) * (c), AAN_CONST_BITS))
+
+#define FIX_1_082392200  SCALER(18159528, AAN_CONST_SCALE)
+#define FIX_1_414213562  SCALER(23726566, AAN_CONST_SCALE)
+#define FIX_1_847759065  SCALER(31000253, AAN_CONST_SCALE)
+#define FIX_2_613125930  SCALER(43840978, AAN_CONST_SCALE)
+
+/* Color coefficients (fixed-point, matching PCSX-ReARMed) */
+#define MULR(a)    ((1434 * (a)))
+#define MULB(a)    ((1807 * (a)))
+#define MULG2(a,b) ((-351 * (a) - 728 * (b)))
+#define MULY(a)    ((a) << 10)
+
+#define SCALE8(c)  SCALER(c, 20)
+#define SCALE5(c)  SCALER(c, 23)
+
+/* ---------- Scalar reference ---------- */
+
+static void idct_c(int *blk, int used_col) {
+    int tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+    int z5, z10, z11, z12, z13;
+    int *ptr;
+
+    /* All-DC shortcut */
+    if (used_col == -1) {
+        int v = blk[0];
+        for (int i = 0; i < DSIZE2; i++)
+            blk[i] = v;
+        return;
+    }
+
+    /* Column pass */
+    ptr = blk;
+    for (int i = 0; i < DSIZE; i++, ptr++) {
+        if ((used_col & (1 << i)) == 0) {
+            if (ptr[DSIZE * 0]) {
+                int v = ptr[0];
+                for (int j = 0; j < DSIZE; j++)
+                    ptr[DSIZE * j] = v;
+                used_col |= (1 << i);
+            }
+            continue;
+        }
+
+        z10 = ptr[DSIZE * 0] + ptr[DSIZE * 4];
+        z11 = ptr[DSIZE * 0] - ptr[DSIZE * 4];
+        z13 = ptr[DSIZE * 2] + ptr[DSIZE * 6];
+        z12 = MULS(ptr[DSIZE * 2] - ptr[DSIZE * 6], FIX_1_414213562) - z13;
+
+        tmp0 = z10 + z13;
+        tmp3 = z10 - z13;
+        tmp1 = z11 + z12;
+        tmp2 = z11 - z12;
+
+        z13 = ptr[DSIZE * 3] + ptr[DSIZE * 5];
+        z10 = ptr[DSIZE * 3] - ptr[DSIZE * 5];
+        z11 = ptr[DSIZE * 1] + ptr[DSIZE * 7];
+        z12 = ptr[DSIZE * 1] - ptr[DSIZE * 7];
+
+        tmp7 = z11 + z13;
+        z5 = (z12 - z10) * FIX_1_847759065;
+        tmp6 = SCALE(z10 * FIX_2_613125930 + z5, AAN_CONST_BITS) - tmp7;
+        tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
+        tmp4 = SCALE(z12 * FIX_1_082392200 - z5, AAN_CONST_BITS) + tmp5;
+
+        ptr[DSIZE * 0] = tmp0 + tmp7;
+        ptr[DSIZE * 7] = tmp0 - tmp7;
+        ptr[DSIZE * 1] = tmp1 + tmp6;
+        ptr[DSIZE * 6] = tmp1 - tmp6;
+        ptr[DSIZE * 2] = tmp2 + tmp5;
+        ptr[DSIZE * 5] = tmp2 - tmp5;
+        ptr[DSIZE * 4] = tmp3 + tmp4;
+        ptr[DSIZE * 3] = tmp3 - tmp4;
+    }
+
+    /* Row pass */
+    ptr = blk;
+    if (used_col == 1) {
+        /* Only column 0 was non-zero — fill each row from its first element */
+        for (int i = 0; i < DSIZE; i++, ptr += DSIZE) {
+            int v = ptr[0];
+            ptr[1] = ptr[2] = ptr[3] = ptr[4] = ptr[5] = ptr[6] = ptr[7] = v;
+        }
+    } else {
+    for (int i = 0; i < DSIZE; i++, ptr += DSIZE) {
+        z10 = ptr[0] + ptr[4];
+        z11 = ptr[0] - ptr[4];
+        z13 = ptr[2] + ptr[6];
+        z12 = MULS(ptr[2] - ptr[6], FIX_1_414213562) - z13;
+
+        tmp0 = z10 + z13;
+        tmp3 = z10 - z13;
+        tmp1 = z11 + z12;
+        tmp2 = z11 - z12;
+
+        z13 = ptr[3] + ptr[5];
+        z10 = ptr[3] - ptr[5];
+        z11 = ptr[1] + ptr[7];
+        z12 = ptr[1] - ptr[7];
+
+        tmp7 = z11 + z13;
+        z5 = (z12 - z10) * FIX_1_847759065;
+        tmp6 = SCALE(z10 * FIX_2_613125930 + z5, AAN_CONST_BITS) - tmp7;
+        tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
+        tmp4 = SCALE(z12 * FIX_1_082392200 - z5, AAN_CONST_BITS) + tmp5;
+
+        ptr[0] = tmp0 + tmp7;
+        ptr[7] = tmp0 - tmp7;
+        ptr[1] = tmp1 + tmp6;
+        ptr[6] = tmp1 - tmp6;
+        ptr[2] = tmp2 + tmp5;
+        ptr[5] = tmp2 - tmp5;
+        ptr[4] = tmp3 + tmp4;
+        ptr[3] = tmp3 - tmp4;
+    }
+    } /* else (full row pass) */
+}
+
+static inline int clamp5(int v) {
+    v += 16;
+    return v < 0 ? 0 : (v > 31 ? 31 : v);
+}
+
+static inline int clamp8(int v) {
+    v += 128;
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+#define CLAMP_SCALE5(a) clamp5(SCALE5(a))
+#define CLAMP_SCALE8(a) clamp8(SCALE8(a))
+#define MAKERGB15(r,g,b,a) ((uint16_t)((a)|((b)<<10)|((g)<<5)|(r)))
+
+static void yuv2rgb15_c(const int *blk, uint16_t *image, uint16_t stp) {
+    const int *Yblk  = blk + DSIZE2 * 2;
+    const int *Crblk = blk;
+    const int *Cbblk = blk + DSIZE2;
+
+    for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 24) {
+        if (y == 8) Yblk += DSIZE2;
+        for (int x = 0; x < 4; x++, image += 2, Crblk++, Cbblk++, Yblk += 2) {
+            int R, G, B, Y;
+
+            /* Left half (Y1/Y3 block) */
+            R = MULR(*Crblk);
+            G = MULG2(*Cbblk, *Crblk);
+            B = MULB(*Cbblk);
+
+            Y = MULY(Yblk[0]);
+            image[0] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
+            Y = MULY(Yblk[1]);
+            image[1] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
+            Y = MULY(Yblk[8]);
+            image[16] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
+            Y = MULY(Yblk[9]);
+            image[17] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
+
+            /* Right half (Y2/Y4 block) */
+            R = MULR(*(Crblk + 4));
+            G = MULG2(*(Cbblk + 4), *(Crblk + 4));
+            B = MULB(*(Cbblk + 4));
+
+            Y = MULY(Yblk[DSIZE2]);
+            image[8] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
+            Y = MULY(Yblk[DSIZE2 + 1]);
+            image[9] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
+            Y = MULY(Yblk[DSIZE2 + 8]);
+            image[24] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
+            Y = MULY(Yblk[DSIZE2 + 9]);
+            image[25] = MAKERGB15(CLAMP_SCALE5(Y+R), CLAMP_SCALE5(Y+G), CLAMP_SCALE5(Y+B), stp);
+        }
+    }
+}
+
+static void yuv2rgb24_c(const int *blk, uint8_t *image) {
+    const int *Yblk  = blk + DSIZE2 * 2;
+    const int *Crblk = blk;
+    const int *Cbblk = blk + DSIZE2;
+
+    for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 8 * 3 * 3) {
+        if (y == 8) Yblk += DSIZE2;
+        for (int x = 0; x < 4; x++, image += 6, Crblk++, Cbblk++, Yblk += 2) {
+            int R, G, B, Y;
+
+            /* Left half */
+            R = MULR(*Crblk);
+            G = MULG2(*Cbblk, *Crblk);
+            B = MULB(*Cbblk);
+
+            Y = MULY(Yblk[0]);
+            image[0] = CLAMP_SCALE8(Y + R);
+            image[1] = CLAMP_SCALE8(Y + G);
+            image[2] = CLAMP_SCALE8(Y + B);
+            Y = MULY(Yblk[1]);
+            image[3] = CLAMP_SCALE8(Y + R);
+            image[4] = CLAMP_SCALE8(Y + G);
+            image[5] = CLAMP_SCALE8(Y + B);
+            Y = MULY(Yblk[8]);
+            image[16 * 3 + 0] = CLAMP_SCALE8(Y + R);
+            image[16 * 3 + 1] = CLAMP_SCALE8(Y + G);
+            image[16 * 3 + 2] = CLAMP_SCALE8(Y + B);
+            Y = MULY(Yblk[9]);
+            image[17 * 3 + 0] = CLAMP_SCALE8(Y + R);
+            image[17 * 3 + 1] = CLAMP_SCALE8(Y + G);
+            image[17 * 3 + 2] = CLAMP_SCALE8(Y + B);
+
+            /* Right half */
+            R = MULR(*(Crblk + 4));
+            G = MULG2(*(Cbblk + 4), *(Crblk + 4));
+            B = MULB(*(Cbblk + 4));
+
+            Y = MULY(Yblk[DSIZE2]);
+            image[8 * 3 + 0] = CLAMP_SCALE8(Y + R);
+            image[8 * 3 + 1] = CLAMP_SCALE8(Y + G);
+            image[8 * 3 + 2] = CLAMP_SCALE8(Y + B);
+            Y = MULY(Yblk[DSIZE2 + 1]);
+            image[9 * 3 + 0] = CLAMP_SCALE8(Y + R);
+            image[9 * 3 + 1] = CLAMP_SCALE8(Y + G);
+            image[9 * 3 + 2] = CLAMP_SCALE8(Y + B);
+            Y = MULY(Yblk[DSIZE2 + 8]);
+            image[24 * 3 + 0] = CLAMP_SCALE8(Y + R);
+            image[24 * 3 + 1] = CLAMP_SCALE8(Y + G);
+            image[24 * 3 + 2] = CLAMP_SCALE8(Y + B);
+            Y = MULY(Yblk[DSIZE2 + 9]);
+            image[25 * 3 + 0] = CLAMP_SCALE8(Y + R);
+            image[25 * 3 + 1] = CLAMP_SCALE8(Y + G);
+            image[25 * 3 + 2] = CLAMP_SCALE8(Y + B);
+        }
+    }
+}
+
+const MdecKernels mdec_kernels_c = { "C", idct_c, yuv2rgb15_c, yuv2rgb24_c };
+
+/* ---------- Shared by the vector kernels ---------- */
+
+#if defined(_EE) || defined(MDEC_KERNEL_CHECK) || defined(__SSE2__)
+
+/* Chroma terms of one chroma row, one entry per pixel column */
+typedef struct {
+    int32_t r[16], g[16], b[16];
+} ChromaRow;
+
+static void chroma_rows(const int *blk, ChromaRow *rows) {
+    const int *Cr = blk, *Cb = blk + DSIZE2;
+    for (int i = 0; i < DSIZE2; i++) {
+        ChromaRow *row = &rows[i >> 3];
+        int x = (i & 7) * 2;
+        int32_t r = MULR(Cr[i]), g = MULG2(Cb[i], Cr[i]), b = MULB(Cb[i]);
+        row->r[x] = row->r[x + 1] = r;
+        row->g[x] = row->g[x + 1] = g;
+        row->b[x] = row->b[x + 1] = b;
+    }
+}
+
+/* Luma run for pixel row py, left (h = 0) or right (h = 1) half */
+static inline const int *luma_run(const int *blk, int py, int h) {
+    return blk + DSIZE2 * (2 + (py >> 3) * 2 + h) + (py & 7) * DSIZE;
+}
+
+/* Column transform of the block vs. the shortcuts in idct_c: a column
+ * outside used_col holds at most a DC term, which the AAN spreads down
+ * the column unchanged.  Returns the used_col idct_c ends up with. */
+static int idct_used_cols(const int *blk, int used_col) {
+    for (int i = 0; i < DSIZE; i++)
+        if (blk[i])
+            used_col |= 1 << i;
+    return used_col;
+}
+
+static void idct_dc_only(int *blk) {
+    int v = blk[0];
+    for (int i = 0; i < DSIZE2; i++)
+        blk[i] = v;
+}
+
+static void idct_fill_rows(int *blk) {
+    for (int i = 0; i < DSIZE2; i += DSIZE) {
+        int v = blk[i];
+        blk[i + 1] = blk[i + 2] = blk[i + 3] = blk[i + 4] =
+            blk[i + 5] = blk[i + 6] = blk[i + 7] = v;
+    }
+}
+
+/* pass4(p): AAN over 8 rows (32 bytes apart) of 4 lanes at p.
+ * tr4(src, dst): transpose a 4x4 tile, rows 32 bytes apart. */
+static inline void idct_vec(int *blk, int used_col,
+                            void (*pass4)(int *), void (*tr4)(const int *, int *)) {
+    int t[DSIZE2] __attribute__((aligned(16)));
+
+    if (used_col == -1) {
+        idct_dc_only(blk);
+        return;
+    }
+    used_col = idct_used_cols(blk, used_col);
+
+    /* Column pass; an all-zero half stays zero */
+    if (used_col & 0x0F)
+        pass4(blk);
+    if (used_col & 0xF0)
+        pass4(blk + 4);
+
+    /* Row pass */
+    if (used_col == 1) {
+        idct_fill_rows(blk);
+        return;
+    }
+    tr4(blk, t);
+    tr4(blk + 4, t + 32);
+    tr4(blk + 32, t + 4);
+    tr4(blk + 36, t + 36);
+    pass4(t);
+    pass4(t + 4);
+    tr4(t, blk);
+    tr4(t + 4, blk + 32);
+    tr4(t + 32, blk + 4);
+    tr4(t + 36, blk + 36);
+}
+
+static const int32_t aan_fix[4][4] __attribute__((aligned(16))) = {
+    { FIX_1_414213562, FIX_1_414213562, FIX_1_414213562, FIX_1_414213562 },
+    { FIX_1_847759065, FIX_1_847759065, FIX_1_847759065, FIX_1_847759065 },
+    { FIX_2_613125930, FIX_2_613125930, FIX_2_613125930, FIX_2_613125930 },
+    { FIX_1_082392200, FIX_1_082392200, FIX_1_082392200, FIX_1_082392200 },
+};
+
+/* RGB15 constants: rounding, +16, clamp max, STP (filled per call) */
+typedef struct {
+    int32_t rnd[4], bias[4], max[4], stp[4];
+} RgbConst;
+
+#endif
+
+/* ---------- MMI (EE) ---------- */
+
+#if defined(_EE) || defined(MDEC_KERNEL_CHECK)
+
+/* Each block takes four pointer operands %0-%3 and may use $8-$21 and
+ * $24.  The check tool runs the same templates through an MMI
+ * interpreter (mmi_exec). */
+#ifdef MDEC_KERNEL_CHECK
+void mmi_exec(const char *tmpl, const void *p0, const void *p1,
+              const void *p2, const void *p3);
+#define MMI_BLOCK(tmpl, a, b, c, d) mmi_exec(tmpl, a, b, c, d)
+#else
+#define MMI_BLOCK(tmpl, a, b, c, d)                                        \
+    __asm__ volatile(tmpl : : "r"(a), "r"(b), "r"(c), "r"(d)               \
+                     : "$8", "$9", "$10", "$11", "$12", "$13", "$14",       \
+                       "$15", "$16", "$17", "$18", "$19", "$20", "$21",     \
+                       "$24", "hi", "lo", "memory")
+#endif
+
+/* d = low 32 bits of x * c per lane.  PMULTW multiplies words 0 and 2;
+ * PEXCW + PEXTUW move words 1 and 3 there, PPACW + PEXCW merge the two
+ * halves back in lane order.  Uses $20, $21. */
+#define MMI_MULW(d, x, c)               \
+    "pmultw $20, " x ", " c "\n"        \
+    "pexcw  $21, " x "\n"               \
+    "pextuw $21, $21, $21\n"            \
+    "pmultw $21, $21, " c "\n"          \
+    "ppacw  " d ", $21, $20\n"          \
+    "pexcw  " d ", " d "\n"
+
+/* %0 = 8 rows of 4 lanes (32 bytes apart), %1 = aan_fix */
+#define MMI_AAN_PASS                                            \
+    "lq     $8, 0(%0)\n"                                        \
+    "lq     $9, 32(%0)\n"                                       \
+    "lq     $10, 64(%0)\n"                                      \
+    "lq     $11, 96(%0)\n"                                      \
+    "lq     $12, 128(%0)\n"                                     \
+    "lq     $13, 160(%0)\n"                                     \
+    "lq     $14, 192(%0)\n"                                     \
+    "lq     $15, 224(%0)\n"                                     \
+    /* even part: z10, z11, z13, z12 */                         \
+    "paddw  $16, $8, $12\n"                                     \
+    "psubw  $17, $8, $12\n"                                     \
+    "paddw  $18, $10, $14\n"                                    \
+    "psubw  $19, $10, $14\n"                                    \
+    "lq     $24, 0(%1)\n"                                       \
+    MMI_MULW("$19", "$19", "$24")                               \
+    "psraw  $19, $19, 12\n"                                     \
+    "psubw  $19, $19, $18\n"                                    \
+    /* tmp0 $8, tmp3 $12, tmp1 $10, tmp2 $14 */                 \
+    "paddw  $8, $16, $18\n"                                     \
+    "psubw  $12, $16, $18\n"                                    \
+    "paddw  $10, $17, $19\n"                                    \
+    "psubw  $14, $17, $19\n"                                    \
+    /* odd part: z13 $16, z10 $17, z11 $18, z12 $19 */          \
+    "paddw  $16, $11, $13\n"                                    \
+    "psubw  $17, $11, $13\n"                                    \
+    "paddw  $18, $9, $15\n"                                     \
+    "psubw  $19, $9, $15\n"                                     \
+    "paddw  $9, $18, $16\n"             /* tmp7 */              \
+    "psubw  $11, $19, $17\n"                                    \
+    "lq     $24, 16(%1)\n"                                      \
+    MMI_MULW("$11", "$11", "$24")       /* z5 */                \
+    "lq     $24, 32(%1)\n"                                      \
+    MMI_MULW("$13", "$17", "$24")                               \
+    "paddw  $13, $13, $11\n"                                    \
+    "psraw  $13, $13, 12\n"                                     \
+    "psubw  $13, $13, $9\n"             /* tmp6 */              \
+    "psubw  $15, $18, $16\n"                                    \
+    "lq     $24, 0(%1)\n"                                       \
+    MMI_MULW("$15", "$15", "$24")                               \
+    "psraw  $15, $15, 12\n"                                     \
+    "psubw  $15, $15, $13\n"            /* tmp5 */              \
+    "lq     $24, 48(%1)\n"                                      \
+    MMI_MULW("$17", "$19", "$24")                               \
+    "psubw  $17, $17, $11\n"                                    \
+    "psraw  $17, $17, 12\n"                                     \
+    "paddw  $17, $17, $15\n"            /* tmp4 */              \
+    "paddw  $16, $8, $9\n"                                      \
+    "sq     $16, 0(%0)\n"                                       \
+    "psubw  $16, $8, $9\n"                                      \
+    "sq     $16, 224(%0)\n"                                     \
+    "paddw  $16, $10, $13\n"                                    \
+    "sq     $16, 32(%0)\n"                                      \
+    "psubw  $16, $10, $13\n"                                    \
+    "sq     $16, 192(%0)\n"                                     \
+    "paddw  $16, $14, $15\n"                                    \
+    "sq     $16, 64(%0)\n"                                      \
+    "psubw  $16, $14, $15\n"                                    \
+    "sq     $16, 160(%0)\n"                                     \
+    "paddw  $16, $12, $17\n"                                    \
+    "sq     $16, 128(%0)\n"                                     \
+    "psubw  $16, $12, $17\n"                                    \
+    "sq     $16, 96(%0)\n"
+
+/* %0 = source tile, %1 = destination tile (rows 32 bytes apart) */
+#define MMI_TRANSPOSE4                                          \
+    "lq     $8, 0(%0)\n"                                        \
+    "lq     $9, 32(%0)\n"                                       \
+    "lq     $10, 64(%0)\n"                                      \
+    "lq     $11, 96(%0)\n"                                      \
+    "pextlw $12, $9, $8\n"                                      \
+    "pextuw $13, $9, $8\n"                                      \
+    "pextlw $14, $11, $10\n"                                    \
+    "pextuw $15, $11, $10\n"                                    \
+    "pcpyld $8, $14, $12\n"                                     \
+    "pcpyud $9, $12, $14\n"                                     \
+    "pcpyld $10, $15, $13\n"                                    \
+    "pcpyud $11, $13, $15\n"                                    \
+    "sq     $8, 0(%1)\n"                                        \
+    "sq     $9, 32(%1)\n"                                       \
+    "sq     $10, 64(%1)\n"                                      \
+    "sq     $11, 96(%1)\n"
+
+/* One colour component of 4 pixels: dst = clamp(((Y' + C) >> sh) + bias)
+ * with Y' = (Y << 10) + rnd already in $8 */
+#define MMI_RGB_COMP(dst, coff, sh)                             \
+    "lq     " dst ", " coff "(%1)\n"                            \
+    "paddw  " dst ", " dst ", $8\n"                             \
+    "psraw  " dst ", " dst ", " sh "\n"                         \
+    "paddw  " dst ", " dst ", $17\n"                            \
+    "pmaxw  " dst ", " dst ", $0\n"                             \
+    "pminw  " dst ", " dst ", $18\n"
+
+#define MMI_RGB15_QUAD(q, oy, oc)                               \
+    "lq     $8, " oy "(%0)\n"                                   \
+    "psllw  $8, $8, 10\n"                                       \
+    "paddw  $8, $8, $16\n"                                      \
+    MMI_RGB_COMP("$9", oc, "23")                                \
+    MMI_RGB_COMP("$10", "64+" oc, "23")                         \
+    MMI_RGB_COMP("$11", "128+" oc, "23")                        \
+    "psllw  $10, $10, 5\n"                                      \
+    "psllw  $11, $11, 10\n"                                     \
+    "por    $9, $9, $10\n"                                      \
+    "por    $9, $9, $11\n"                                      \
+    "por    " q ", $9, $19\n"
+
+/* %0 = 8 luma, %1 = ChromaRow r[] for those pixels, %2 = 8 RGB15 out,
+ * %3 = RgbConst */
+#define MMI_RGB15_8PX                                           \
+    "lq     $16, 0(%3)\n"                                       \
+    "lq     $17, 16(%3)\n"                                      \
+    "lq     $18, 32(%3)\n"                                      \
+    "lq     $19, 48(%3)\n"                                      \
+    MMI_RGB15_QUAD("$12", "0", "0")                             \
+    MMI_RGB15_QUAD("$13", "16", "16")                           \
+    "ppach  $14, $13, $12\n"                                    \
+    "sq     $14, 0(%2)\n"
+
+#define MMI_RGB24_QUAD(oy, oc, od)                              \
+    "lq     $8, " oy "(%0)\n"                                   \
+    "psllw  $8, $8, 10\n"                                       \
+    "paddw  $8, $8, $16\n"                                      \
+    MMI_RGB_COMP("$9", oc, "20")                                \
+    MMI_RGB_COMP("$10", "64+" oc, "20")                         \
+    MMI_RGB_COMP("$11", "128+" oc, "20")                        \
+    "psllw  $10, $10, 8\n"                                      \
+    "psllw  $11, $11, 16\n"                                     \
+    "por    $9, $9, $10\n"                                      \
+    "por    $9, $9, $11\n"                                      \
+    "sq     $9, " od "(%2)\n"
+
+/* As MMI_RGB15_8PX, %2 = 8 words 0x00BBGGRR */
+#define MMI_RGB24_8PX                                           \
+    "lq     $16, 0(%3)\n"                                       \
+    "lq     $17, 16(%3)\n"                                      \
+    "lq     $18, 32(%3)\n"                                      \
+    MMI_RGB24_QUAD("0", "0", "0")                               \
+    MMI_RGB24_QUAD("16", "16", "16")
+
+static void aan_pass4_mmi(int *p) {
+    MMI_BLOCK(MMI_AAN_PASS, p, aan_fix, 0, 0);
+}
+
+static void transpose4_mmi(const int *src, int *dst) {
+    MMI_BLOCK(MMI_TRANSPOSE4, src, dst, 0, 0);
+}
+
+static void idct_mmi(int *blk, int used_col) {
+    idct_vec(blk, used_col, aan_pass4_mmi, transpose4_mmi);
+}
+
+static void yuv2rgb15_mmi(const int *blk, uint16_t *image, uint16_t stp) {
+    ChromaRow rows[8] __attribute__((aligned(16)));
+    RgbConst k __attribute__((aligned(16)));
+    uint16_t tmp[256] __attribute__((aligned(16)));
+    uint16_t *dst = ((uintptr_t)image & 15) ? tmp : image;  /* sq needs 16-byte alignment */
+
+    for (int i = 0; i < 4; i++) {
+        k.rnd[i] = 1 << 22;
+        k.bias[i] = 16;
+        k.max[i] = 31;
+        k.stp[i] = stp;
+    }
+    chroma_rows(blk, rows);
+    for (int py = 0; py < 16; py++) {
+        const ChromaRow *c = &rows[py >> 1];
+        MMI_BLOCK(MMI_RGB15_8PX, luma_run(blk, py, 0), &c->r[0], dst + py * 16, &k);
+        MMI_BLOCK(MMI_RGB15_8PX, luma_run(blk, py, 1), &c->r[8], dst + py * 16 + 8, &k);
+    }
+    if (dst != image)
+        memcpy(image, tmp, sizeof(tmp));
+}
+
+static void yuv2rgb24_mmi(const int *blk, uint8_t *image) {
+    ChromaRow rows[8] __attribute__((aligned(16)));
+    RgbConst k __attribute__((aligned(16)));
+    uint32_t px[16] __attribute__((aligned(16)));
+
+    for (int i = 0; i < 4; i++) {
+        k.rnd[i] = 1 << 19;
+        k.bias[i] = 128;
+        k.max[i] = 255;
+        k.stp[i] = 0;
+    }
+    chroma_rows(blk, rows);
+    for (int py = 0; py < 16; py++, image += 16 * 3) {
+        const ChromaRow *c = &rows[py >> 1];
+        MMI_BLOCK(MMI_RGB24_8PX, luma_run(blk, py, 0), &c->r[0], px, &k);
+        MMI_BLOCK(MMI_RGB24_8PX, luma_run(blk, py, 1), &c->r[8], px + 8, &k);
+        for (int x = 0; x < 16; x++) {
+            image[x * 3 + 0] = (uint8_t)px[x];
+            image[x * 3 + 1] = (uint8_t)(px[x] >> 8);
+            image[x * 3 + 2] = (uint8_t)(px[x] >> 16);
+        }
+    }
+}
+
+const MdecKernels mdec_kernels_mmi = { "MMI", idct_mmi, yuv2rgb15_mmi, yuv2rgb24_mmi };
+
+#endif /* _EE || MDEC_KERNEL_CHECK */
+
+/* ---------- SSE2 (host builds, offline comparisons) ---------- */
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+/* Low 32 bits of the lane products (SSE2 has no PMULLD) */
+static inline __m128i mullo_sse2(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128i clamp_sse2(__m128i v, __m128i max) {
+    v = _mm_andnot_si128(_mm_srai_epi32(v, 31), v);
+    __m128i over = _mm_cmpgt_epi32(v, max);
+    return _mm_or_si128(_mm_andnot_si128(over, v), _mm_and_si128(over, max));
+}
+
+#define LD(p, i) _mm_load_si128((const __m128i *)(p) + (i))
+#define ST(p, i, v) _mm_store_si128((__m128i *)(p) + (i), v)
+
+static void aan_pass4_sse2(int *p) {
+    __m128i f1414 = LD(aan_fix[0], 0), f1847 = LD(aan_fix[1], 0);
+    __m128i f2613 = LD(aan_fix[2], 0), f1082 = LD(aan_fix[3], 0);
+    __m128i r0 = LD(p, 0), r1 = LD(p, 2), r2 = LD(p, 4), r3 = LD(p, 6);
+    __m128i r4 = LD(p, 8), r5 = LD(p, 10), r6 = LD(p, 12), r7 = LD(p, 14);
+
+    __m128i z10 = _mm_add_epi32(r0, r4);
+    __m128i z11 = _mm_sub_epi32(r0, r4);
+    __m128i z13 = _mm_add_epi32(r2, r6);
+    __m128i z12 = _mm_sub_epi32(_mm_srai_epi32(mullo_sse2(_mm_sub_epi32(r2, r6), f1414), 12), z13);
+
+    __m128i t0 = _mm_add_epi32(z10, z13);
+    __m128i t3 = _mm_sub_epi32(z10, z13);
+    __m128i t1 = _mm_add_epi32(z11, z12);
+    __m128i t2 = _mm_sub_epi32(z11, z12);
+
+    z13 = _mm_add_epi32(r3, r5);
+    z10 = _mm_sub_epi32(r3, r5);
+    z11 = _mm_add_epi32(r1, r7);
+    z12 = _mm_sub_epi32(r1, r7);
+
+    __m128i t7 = _mm_add_epi32(z11, z13);
+    __m128i z5 = mullo_sse2(_mm_sub_epi32(z12, z10), f1847);
+    __m128i t6 = _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(mullo_sse2(z10, f2613), z5), 12), t7);
+    __m128i t5 = _mm_sub_epi32(_mm_srai_epi32(mullo_sse2(_mm_sub_epi32(z11, z13), f1414), 12), t6);
+    __m128i t4 = _mm_add_epi32(_mm_srai_epi32(_mm_sub_epi32(mullo_sse2(z12, f1082), z5), 12), t5);
+
+    ST(p, 0,  _mm_add_epi32(t0, t7));
+    ST(p, 14, _mm_sub_epi32(t0, t7));
+    ST(p, 2,  _mm_add_epi32(t1, t6));
+    ST(p, 12, _mm_sub_epi32(t1, t6));
+    ST(p, 4,  _mm_add_epi32(t2, t5));
+    ST(p, 10, _mm_sub_epi32(t2, t5));
+    ST(p, 8,  _mm_add_epi32(t3, t4));
+    ST(p, 6,  _mm_sub_epi32(t3, t4));
+}
+
+static void transpose4_sse2(const int *src, int *dst) {
+    __m128i a = LD(src, 0), b = LD(src, 2), c = LD(src, 4), d = LD(src, 6);
+    __m128i ab_lo = _mm_unpacklo_epi32(a, b), ab_hi = _mm_unpackhi_epi32(a, b);
+    __m128i cd_lo = _mm_unpacklo_epi32(c, d), cd_hi = _mm_unpackhi_epi32(c, d);
+    ST(dst, 0, _mm_unpacklo_epi64(ab_lo, cd_lo));
+    ST(dst, 2, _mm_unpackhi_epi64(ab_lo, cd_lo));
+    ST(dst, 4, _mm_unpacklo_epi64(ab_hi, cd_hi));
+    ST(dst, 6, _mm_unpackhi_epi64(ab_hi, cd_hi));
+}
+
+static void idct_sse2(int *blk, int used_col) {
+    idct_vec(blk, used_col, aan_pass4_sse2, transpose4_sse2);
+}
+
+/* One component of 4 pixels, y = (Y << 10) + rnd */
+static inline __m128i rgb_comp_sse2(__m128i y, const int32_t *c, int sh,
+                                    __m128i bias, __m128i max) {
+    __m128i v = _mm_add_epi32(_mm_loadu_si128((const __m128i *)c), y);
+    v = sh == 23 ? _mm_srai_epi32(v, 23) : _mm_srai_epi32(v, 20);
+    return clamp_sse2(_mm_add_epi32(v, bias), max);
+}
+
+static void yuv2rgb15_sse2(const int *blk, uint16_t *image, uint16_t stp) {
+    ChromaRow rows[8] __attribute__((aligned(16)));
+    __m128i rnd = _mm_set1_epi32(1 << 22), bias = _mm_set1_epi32(16);
+    __m128i max = _mm_set1_epi32(31), vstp = _mm_set1_epi32(stp);
+
+    chroma_rows(blk, rows);
+    for (int py = 0; py < 16; py++) {
+        const ChromaRow *c = &rows[py >> 1];
+        for (int x = 0; x < 16; x += 8) {
+            const int *y = luma_run(blk, py, x >> 3);
+            __m128i q[2];
+            for (int h = 0; h < 2; h++) {
+                __m128i yv = _mm_add_epi32(_mm_slli_epi32(LD(y, h), 10), rnd);
+                __m128i r = rgb_comp_sse2(yv, &c->r[x + h * 4], 23, bias, max);
+                __m128i g = rgb_comp_sse2(yv, &c->g[x + h * 4], 23, bias, max);
+                __m128i b = rgb_comp_sse2(yv, &c->b[x + h * 4], 23, bias, max);
+                __m128i v = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 5)),
+                                         _mm_or_si128(_mm_slli_epi32(b, 10), vstp));
+                /* Sign-extend the low halfword so PACKSSDW keeps it */
+                q[h] = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+            }
+            _mm_storeu_si128((__m128i *)(image + py * 16 + x), _mm_packs_epi32(q[0], q[1]));
+        }
+    }
+}
+
+static void yuv2rgb24_sse2(const int *blk, uint8_t *image) {
+    ChromaRow rows[8] __attribute__((aligned(16)));
+    __m128i rnd = _mm_set1_epi32(1 << 19), bias = _mm_set1_epi32(128);
+    __m128i max = _mm_set1_epi32(255);
+    uint32_t px[16] __attribute__((aligned(16)));
+
+    chroma_rows(blk, rows);
+    for (int py = 0; py < 16; py++, image += 16 * 3) {
+        const ChromaRow *c = &rows[py >> 1];
+        for (int x = 0; x < 16; x += 4) {
+            const int *y = luma_run(blk, py, x >> 3) + (x & 7);
+            __m128i yv = _mm_add_epi32(_mm_slli_epi32(LD(y, 0), 10), rnd);
+            __m128i r = rgb_comp_sse2(yv, &c->r[x], 20, bias, max);
+            __m128i g = rgb_comp_sse2(yv, &c->g[x], 20, bias, max);
+            __m128i b = rgb_comp_sse2(yv, &c->b[x], 20, bias, max);
+            ST(px + x, 0, _mm_or_si128(r, _mm_or_si128(_mm_slli_epi32(g, 8),
+                                                       _mm_slli_epi32(b, 16))));
+        }
+        for (int x = 0; x < 16; x++) {
+            image[x * 3 + 0] = (uint8_t)px[x];
+            image[x * 3 + 1] = (uint8_t)(px[x] >> 8);
+            image[x * 3 + 2] = (uint8_t)(px[x] >> 16);
+        }
+    }
+}
+
+#undef LD
+#undef ST
+
+const MdecKernels mdec_kernels_sse2 = { "SSE2", idct_sse2, yuv2rgb15_sse2, yuv2rgb24_sse2 };
+
+#endif /* __SSE2__ */
+
+const MdecKernels *MDEC_KernelsSelect(void) {
+#if defined(_EE)
+    return &mdec_kernels_mmi;
+#elif defined(__SSE2__)
+    return &mdec_kernels_sse2;
+#else
+    return &mdec_kernels_c;
+#endif
+}
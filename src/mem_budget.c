@@ -0,0 +1,162 @@
+/**
+ * mem_budget.c — Startup memory plan and per-subsystem arenas
+ *
+ * The heap is measured by the largest block malloc hands out at boot,
+ * before anything big is allocated.  Pools are planned in priority
+ * order, each from what the previous ones left, then allocated as one
+ * 64-byte aligned block apiece.  Whatever isn't planned stays with
+ * malloc.
+ */
+#include "mem_budget.h"
+#include "config.h"
+#include "dynarec.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MEM_MB (1024u * 1024u)
+#define MEM_PROBE_MAX (32 * MEM_MB)
+#define MEM_PROBE_STEP (256 * 1024)
+#define MEM_HEAP_RESERVE (6 * MEM_MB) /* Left to malloc in every plan */
+#define MEM_CODE_MIN (1 * MEM_MB)
+#define MEM_POOL_ALIGN 64
+
+#ifdef PLATFORM_PSP
+#define MEM_TEXCACHE_MAX (4 * MEM_MB) /* 64 slots of 64 KB (gpu_psp_texture.c) */
+#define MEM_TEXCACHE_MIN (1 * MEM_MB)
+#else
+#define MEM_TEXCACHE_MAX 0 /* Texture pages live in GS VRAM */
+#define MEM_TEXCACHE_MIN 0
+#endif
+
+typedef struct
+{
+    const char *name;
+    uint8_t *base;
+    uint32_t size;
+    uint32_t used;
+} MemPool;
+
+static MemPool mem_pools[MEM_POOL_COUNT] = {
+    {"jit", NULL, 0, 0},
+    {"texcache", NULL, 0, 0},
+    {"state", NULL, 0, 0},
+    {"cdrom", NULL, 0, 0},
+};
+static int mem_planned = 0;
+static uint32_t mem_code_size = CODE_BUFFER_DEFAULT_SIZE;
+
+static uint32_t mem_probe(void)
+{
+    for (uint32_t size = MEM_PROBE_MAX; size >= MEM_PROBE_STEP; size -= MEM_PROBE_STEP)
+    {
+        void *p = malloc(size);
+        if (p)
+        {
+            free(p);
+            return size;
+        }
+    }
+    return 0;
+}
+
+/* Fixed size, or twice the default when everything else asked for
+ * still fits beside it, halved while the JIT alone doesn't fit */
+static uint32_t plan_code_size(uint32_t left, uint32_t tables, uint32_t others)
+{
+    uint32_t size = CODE_BUFFER_DEFAULT_SIZE;
+
+    if (psx_config.jit_code_buffer)
+        return (uint32_t)psx_config.jit_code_buffer * MEM_MB;
+    if (left >= 2 * size + tables + others)
+        size *= 2;
+    while (size > MEM_CODE_MIN && size + tables > left)
+        size /= 2;
+    return size;
+}
+
+static uint32_t take(uint32_t *left, uint32_t want)
+{
+    if (want > *left)
+        want = *left;
+    *left -= want;
+    return want;
+}
+
+void MemBudget_Init(void)
+{
+    if (mem_planned)
+        return;
+    mem_planned = 1;
+
+    uint32_t heap = mem_probe();
+    uint32_t left = heap > MEM_HEAP_RESERVE ? heap - MEM_HEAP_RESERVE : 0;
+    uint32_t rewind = (uint32_t)psx_config.rewind_buffer * MEM_MB;
+    uint32_t preload = (uint32_t)psx_config.cdrom_preload * MEM_MB;
+
+    jit_ht_configure();
+    uint32_t tables = BLOCK_NODE_POOL_SIZE * sizeof(BlockEntry) +
+                      jit_ht_sets * jit_ht_ways * sizeof(JitHTEntry) + 3 * MEM_POOL_ALIGN;
+    mem_code_size = plan_code_size(left, tables, MEM_TEXCACHE_MAX + rewind + preload);
+    mem_pools[MEM_POOL_JIT].size = take(&left, mem_code_size + tables);
+
+    uint32_t tex = MEM_TEXCACHE_MAX;
+    while (tex > MEM_TEXCACHE_MIN && tex > left)
+        tex /= 2;
+    mem_pools[MEM_POOL_TEXCACHE].size = tex <= left ? take(&left, tex) : 0;
+    mem_pools[MEM_POOL_STATE].size = take(&left, rewind);
+    mem_pools[MEM_POOL_CDROM].size = take(&left, preload);
+
+    uint32_t planned = 0;
+    for (int i = 0; i < MEM_POOL_COUNT; i++)
+    {
+        MemPool *p = &mem_pools[i];
+        if (p->size && !(p->base = (uint8_t *)memalign(MEM_POOL_ALIGN, p->size)))
+            p->size = 0;
+        planned += p->size;
+    }
+
+    printf("[MEM] Heap %u KB at boot, %u KB left to malloc\n", (unsigned)(heap >> 10),
+           (unsigned)((heap - planned) >> 10));
+    for (int i = 0; i < MEM_POOL_COUNT; i++)
+    {
+        const MemPool *p = &mem_pools[i];
+        printf("[MEM]   %-9s %p %6u KB", p->name, (void *)p->base, (unsigned)(p->size >> 10));
+        if (i == MEM_POOL_JIT)
+            printf("  (code %u KB, %d blocks, %u dispatch entries)", (unsigned)(mem_code_size >> 10),
+                   BLOCK_NODE_POOL_SIZE, (unsigned)(jit_ht_sets * jit_ht_ways));
+        printf("\n");
+    }
+}
+
+uint32_t MemBudget_CodeBufferSize(void)
+{
+    MemBudget_Init();
+    return mem_code_size;
+}
+
+void *MemPool_Alloc(MemPoolId pool, uint32_t size, uint32_t align)
+{
+    MemPool *p = &mem_pools[pool];
+
+    MemBudget_Init();
+    if (!p->base)
+        return NULL;
+    uintptr_t at = ((uintptr_t)p->base + p->used + align - 1) & ~(uintptr_t)(align - 1);
+    uint32_t off = (uint32_t)(at - (uintptr_t)p->base);
+    if (off > p->size || size > p->size - off)
+        return NULL;
+    p->used = off + size;
+    return (void *)at;
+}
+
+uint32_t MemPool_Avail(MemPoolId pool)
+{
+    MemBudget_Init();
+    return mem_pools[pool].size - mem_pools[pool].used;
+}
+
+void MemPool_Reset(MemPoolId pool)
+{
+    mem_pools[pool].used = 0;
+}
@@ -5,8 +5,10 @@
 #include <malloc.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 #include "superpsx.h"
 #include "psx_sio.h"
+#include "savestate.h"
 
 #undef LOG_TAG
 #define LOG_TAG "MEM"
@@ -27,69 +29,39 @@ uint8_t *psx_bios;
 uint8_t scratchpad_buf[1024] __attribute__((aligned(8192)));
 
 /*
- * Memory LUT: 64KB virtual address pages.
- * 65536 entries × 4 bytes = 256KB.
- * Each entry is a host pointer to the start of the mapped 64KB region,
- * or NULL for IO/unmapped pages that require the slow C helper path.
- * Indexed by (virtual_address >> 16).
- * Dynamically allocated to avoid BSS mapping issues on PS2.
+ * Memory map (mem_host): a region index per 4 MB of physical space.
+ * Replaces a 256 KB table of 64 KB page pointers whose entries the
+ * interpreter's fetch missed the 8 KB D-cache on; the map is two lines.
  */
-uint8_t **mem_lut;
+uint8_t mem_region_map[MEM_REGION_SLOTS] __attribute__((aligned(64)));
+MemRegion mem_regions[3];
 
 void Init_MemoryLUT(void)
 {
-    int page;
-    mem_lut = (uint8_t **)memalign(128, MEM_LUT_SIZE * sizeof(uint8_t *));
-    if (!mem_lut)
-    {
-        printf("  ERROR: Failed to allocate mem_lut!\n");
-        return;
-    }
-    memset(mem_lut, 0, MEM_LUT_SIZE * sizeof(uint8_t *));
-
-    /* RAM pages: 32 × 64KB = 2MB */
-    for (page = 0; page < 0x20; page++)
-    {
-        uint8_t *base = psx_ram + page * 0x10000;
-        /* kuseg: 0x00000000-0x001FFFFF */
-        mem_lut[0x0000 + page] = base;
-        /* kseg0: 0x80000000-0x801FFFFF */
-        mem_lut[0x8000 + page] = base;
-        /* kseg1: 0xA0000000-0xA01FFFFF */
-        mem_lut[0xA000 + page] = base;
-        /* kuseg RAM mirrors (2-8MB) */
-        mem_lut[0x0020 + page] = base;
-        mem_lut[0x0040 + page] = base;
-        mem_lut[0x0060 + page] = base;
-        /* kseg0 RAM mirrors */
-        mem_lut[0x8020 + page] = base;
-        mem_lut[0x8040 + page] = base;
-        mem_lut[0x8060 + page] = base;
-        /* kseg1 RAM mirrors */
-        mem_lut[0xA020 + page] = base;
-        mem_lut[0xA040 + page] = base;
-        mem_lut[0xA060 + page] = base;
-    }
-
-    /* BIOS pages: 8 × 64KB = 512KB */
-    for (page = 0; page < 8; page++)
-    {
-        uint8_t *base = psx_bios + page * 0x10000;
-        /* kuseg: 0x1FC00000-0x1FC7FFFF */
-        mem_lut[0x1FC0 + page] = base;
-        /* kseg0: 0x9FC00000-0x9FC7FFFF */
-        mem_lut[0x9FC0 + page] = base;
-        /* kseg1: 0xBFC00000-0xBFC7FFFF */
-        mem_lut[0xBFC0 + page] = base;
-    }
-
-    /* Note: scratchpad (0x1F800000) and IO regs (0x1F801000) share
-     * the same 64KB page, so it stays NULL → slow path via C helpers. */
-
-    printf("  Memory LUT at %p (65536 entries, %u KB)\n",
-           (void *)mem_lut, (unsigned)(MEM_LUT_SIZE * sizeof(uint8_t *) / 1024));
-    printf("  LUT[0x8000]=%p LUT[0xBFC0]=%p\n",
-           (void *)mem_lut[0x8000], (void *)mem_lut[0xBFC0]);
+    memset(mem_region_map, 0, sizeof(mem_region_map));
+    memset(&mem_regions[0], 0, sizeof(mem_regions[0])); /* unmapped */
+
+    /* RAM: 2 MB mirrored over 0x00000000-0x007FFFFF */
+    mem_regions[1].base = psx_ram;
+    mem_regions[1].mask = PSX_RAM_SIZE - 1;
+    mem_regions[1].limit = 1u << MEM_REGION_SHIFT;
+    mem_region_map[0x00000000 >> MEM_REGION_SHIFT] = 1;
+    mem_region_map[0x00400000 >> MEM_REGION_SHIFT] = 1;
+
+    /* BIOS: 0x1FC00000-0x1FC7FFFF; the rest of its slot (cache
+     * control at 0x1FFE0130) stays unmapped */
+    mem_regions[2].base = psx_bios;
+    mem_regions[2].mask = PSX_BIOS_SIZE - 1;
+    mem_regions[2].limit = PSX_BIOS_SIZE;
+    mem_region_map[0x1FC00000 >> MEM_REGION_SHIFT] = 2;
+
+    /* Scratchpad (0x1F800000) and IO regs (0x1F801000) stay NULL → slow
+     * path via C helpers.  The JIT doesn't use this map: its slow stubs
+     * test for scratchpad first and access scratchpad_buf directly (see
+     * emit_scratchpad_replay). */
+    printf("  Memory map at %p (%u slots), RAM=%p BIOS=%p\n",
+           (void *)mem_region_map, (unsigned)MEM_REGION_SLOTS,
+           (void *)mem_host(0x80000000), (void *)mem_host(0xBFC00000));
 }
 
 /* Memory control regs the BIOS writes during init */
@@ -98,6 +70,30 @@ static uint32_t mem_ctrl[16];
 /* static uint32_t ram_size_reg = 0x00000B88; */
 static uint32_t cache_ctrl = 0;
 
+/* Save state: RAM goes page by page, and a load only rewrites (and
+ * invalidates compiled code on) the pages that differ, so restoring a
+ * recent snapshot leaves most blocks valid */
+void Memory_State(StateIO *io)
+{
+    for (uint32_t page = 0; page < PSX_RAM_SIZE; page += 4096)
+    {
+        if (!io->load)
+        {
+            state_io(io, psx_ram + page, 4096);
+            continue;
+        }
+        uint8_t *p = state_ptr(io, 4096);
+        if (p && memcmp(p, psx_ram + page, 4096) != 0)
+        {
+            memcpy(psx_ram + page, p, 4096);
+            jit_smc_invalidate_range(page, page + 4096);
+        }
+    }
+    state_io(io, scratchpad_buf, PSX_SCRATCHPAD_SIZE);
+    STATE_VAR(io, mem_ctrl);
+    STATE_VAR(io, cache_ctrl);
+}
+
 void Init_Memory(void)
 {
     printf("Initializing Memory Map...\n");
@@ -123,6 +119,7 @@ void Init_Memory(void)
     printf("  BIOS: %p (512KB)\n", psx_bios);
 
     Init_MemoryLUT();
+    Init_HardwareTable();
 
     /* Set up TLB mapping for JIT fast-path (psx_ram @ VA 0x20000000) */
     Setup_PSX_TLB();
@@ -26,9 +26,21 @@
 #include "memorycard.h"
 #include "superpsx.h"
 #include "config.h"
+#include "platform.h"
+#include "savestate.h"
 
 #define LOG_TAG "MCD"
 
+/* ---- Write-back ----
+ * Committed sectors only set a dirty bit; the card file is written once
+ * the card has gone mcd_flush_frames VBlanks without a write (or has
+ * stayed dirty MCD_FLUSH_MAX_AGE times that long), each run of adjacent
+ * dirty sectors in one fwrite, from a worker thread when one starts. */
+#define MCD_DIRTY_WORDS (MCD_NUM_SECTORS / 32)
+#define MCD_FLUSH_MAX_AGE 8
+#define MCD_FLUSH_STACK (8 * 1024)
+#define MCD_BARRIER() __asm__ __volatile__("" ::: "memory")
+
 /* ---- State machine phases ---- */
 typedef enum {
     MCD_IDLE,       /* Waiting for 0x81 access byte */
@@ -74,8 +86,25 @@ static struct {
     int byte_count;     /* Byte counter within data phase */
     uint8_t wr_buf[MCD_SECTOR_SIZE]; /* Write staging buffer */
     int loaded;         /* 1 = card data loaded from file */
+    uint32_t dirty[MCD_DIRTY_WORDS]; /* sectors not yet in the card file */
+    int idle_frames;    /* VBlanks since the last sector write */
+    int dirty_frames;   /* VBlanks since the oldest unflushed write */
 } cards[2];
 
+/* ---- Flush job: the dirty runs of one card, copied out so the worker
+ * never reads card data the game is writing ---- */
+static struct {
+    int slot;
+    int count;                      /* runs */
+    uint16_t start[MCD_NUM_SECTORS / 2];
+    uint16_t len[MCD_NUM_SECTORS / 2];
+    uint8_t data[MCD_SIZE];         /* run data, back to back */
+} mcd_job;
+static volatile int mcd_job_busy = 0;
+static volatile int mcd_job_failed = 0;
+static int mcd_thread = -1;
+static int mcd_wake = -1;
+
 /* ---- Format a blank memory card ---- */
 static void mcd_format(int slot)
 {
@@ -167,12 +196,117 @@ static void mcd_format(int slot)
     memset(&cards[slot].data[63 * MCD_SECTOR_SIZE], 0x00, MCD_SECTOR_SIZE);
 }
 
-/* ---- Save a single sector to file ---- */
+static const char *mcd_path(int slot)
+{
+    return (slot == 0) ? psx_config.mcd1_path : psx_config.mcd2_path;
+}
+
+/* ---- Write the job's runs to its card file ---- */
+static void mcd_job_write(void)
+{
+    const char *path = mcd_path(mcd_job.slot);
+    const uint8_t *src = mcd_job.data;
+
+    /* A whole-card job (re)creates the file */
+    int whole = mcd_job.count == 1 && mcd_job.len[0] == MCD_NUM_SECTORS;
+    FILE *f = fopen(path, whole ? "wb" : "r+b");
+    if (!f) {
+        mcd_job_failed = 1;
+        return;
+    }
+    for (int i = 0; i < mcd_job.count; i++) {
+        size_t n = (size_t)mcd_job.len[i] * MCD_SECTOR_SIZE;
+        fseek(f, (long)mcd_job.start[i] * MCD_SECTOR_SIZE, SEEK_SET);
+        fwrite(src, 1, n, f);
+        src += n;
+    }
+    fclose(f);
+}
+
+static void mcd_flush_worker(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        Platform_SemaWait(mcd_wake);
+        mcd_job_write();
+        MCD_BARRIER();
+        mcd_job_busy = 0;
+    }
+}
+
+static void mcd_mark_all_dirty(int slot)
+{
+    memset(cards[slot].dirty, 0xFF, sizeof(cards[slot].dirty));
+}
+
+/* ---- Hand the card's dirty runs to the worker (or write them here
+ * when there is none, or sync is set).  Returns 0 while the worker is
+ * still busy with an earlier job. ---- */
+static int mcd_flush_card(int slot, int sync)
+{
+    if (mcd_job_busy)
+        return 0;
+    MCD_BARRIER();
+    if (mcd_job_failed) {
+        /* File gone: the next job rewrites the whole card */
+        mcd_job_failed = 0;
+        mcd_mark_all_dirty(mcd_job.slot);
+    }
+
+    uint32_t *dirty = cards[slot].dirty;
+    uint8_t *dst = mcd_job.data;
+    mcd_job.slot = slot;
+    mcd_job.count = 0;
+    for (int sec = 0; sec < MCD_NUM_SECTORS;) {
+        if (!(dirty[sec >> 5] >> (sec & 31) & 1)) {
+            sec++;
+            continue;
+        }
+        int first = sec;
+        while (sec < MCD_NUM_SECTORS && (dirty[sec >> 5] >> (sec & 31) & 1))
+            sec++;
+        size_t n = (size_t)(sec - first) * MCD_SECTOR_SIZE;
+        memcpy(dst, &cards[slot].data[first * MCD_SECTOR_SIZE], n);
+        dst += n;
+        mcd_job.start[mcd_job.count] = (uint16_t)first;
+        mcd_job.len[mcd_job.count] = (uint16_t)(sec - first);
+        mcd_job.count++;
+    }
+    memset(dirty, 0, sizeof(cards[slot].dirty));
+    cards[slot].dirty_frames = 0;
+    if (!mcd_job.count)
+        return 1;
+
+    if (sync || mcd_thread < 0) {
+        mcd_job_write();
+        return 1;
+    }
+    mcd_job_busy = 1;
+    MCD_BARRIER();
+    Platform_SemaSignal(mcd_wake);
+    return 1;
+}
+
+static int mcd_is_dirty(int slot)
+{
+    for (int i = 0; i < MCD_DIRTY_WORDS; i++)
+        if (cards[slot].dirty[i])
+            return 1;
+    return 0;
+}
+
+/* ---- Save a single sector to file (write-through, mcd_flush_frames = 0) ---- */
 static void mcd_save_sector(int slot, uint16_t sector)
 {
-    const char *path = (slot == 0) ? psx_config.mcd1_path : psx_config.mcd2_path;
+    const char *path = mcd_path(slot);
     if (!path || !path[0]) return;
 
+    if (psx_config.mcd_flush_frames > 0) {
+        cards[slot].dirty[sector >> 5] |= 1u << (sector & 31);
+        cards[slot].idle_frames = 0;
+        return;
+    }
+
     FILE *f = fopen(path, "r+b");
     if (!f) {
         /* File doesn't exist, create it with full card data */
@@ -187,15 +321,54 @@ static void mcd_save_sector(int slot, uint16_t sector)
     fclose(f);
 }
 
+/* ---- Public: Per-VBlank flush policy ---- */
+void MCD_Frame(void)
+{
+    int idle = psx_config.mcd_flush_frames;
+    if (idle <= 0)
+        return;
+    for (int slot = 0; slot < 2; slot++) {
+        if (!mcd_is_dirty(slot))
+            continue;
+        cards[slot].idle_frames++;
+        cards[slot].dirty_frames++;
+        if (cards[slot].idle_frames >= idle ||
+            cards[slot].dirty_frames >= idle * MCD_FLUSH_MAX_AGE)
+            mcd_flush_card(slot, 0);
+    }
+}
+
+/* ---- Public: Write every dirty sector now (exit) ---- */
+void MCD_Flush(void)
+{
+    for (int slot = 0; slot < 2; slot++) {
+        while (!mcd_flush_card(slot, 1))
+            Platform_Sleep(1);
+        if (mcd_job_failed)
+            mcd_flush_card(slot, 1); /* retry as a whole-card write */
+    }
+}
+
 /* ---- Public: Initialize both memory card slots ---- */
 void MCD_Init(void)
 {
+    if (psx_config.mcd_flush_frames > 0 && mcd_thread < 0) {
+        mcd_wake = Platform_SemaCreate(0, 1);
+        if (mcd_wake >= 0)
+            mcd_thread = Platform_ThreadStart("mcd_flush", mcd_flush_worker, NULL,
+                                              MCD_FLUSH_STACK);
+    }
+
     for (int i = 0; i < 2; i++) {
         cards[i].phase = MCD_IDLE;
         cards[i].flag = 0x08; /* Bit3=1: directory not read yet */
         cards[i].loaded = 0;
 
-        const char *path = (i == 0) ? psx_config.mcd1_path : psx_config.mcd2_path;
+        memset(cards[i].dirty, 0, sizeof(cards[i].dirty));
+        cards[i].idle_frames = 0;
+        cards[i].dirty_frames = 0;
+
+        const char *path = mcd_path(i);
         if (!path || !path[0]) {
             DLOG("Slot %d: no path configured\n", i + 1);
             continue;
@@ -229,6 +402,35 @@ void MCD_Init(void)
     }
 }
 
+/* ---- Public: Save state.  Card data is compared per sector on load;
+ * sectors the snapshot changes go through the normal save path, so
+ * the card file follows the restored card. ---- */
+void MCD_State(StateIO *io)
+{
+    for (int slot = 0; slot < 2; slot++) {
+        STATE_VAR(io, cards[slot].phase);
+        STATE_VAR(io, cards[slot].cmd);
+        STATE_VAR(io, cards[slot].flag);
+        STATE_VAR(io, cards[slot].sector);
+        STATE_VAR(io, cards[slot].checksum);
+        STATE_VAR(io, cards[slot].byte_count);
+        STATE_VAR(io, cards[slot].wr_buf);
+        STATE_VAR(io, cards[slot].loaded);
+        for (int sec = 0; sec < MCD_NUM_SECTORS; sec++) {
+            uint8_t *live = &cards[slot].data[sec * MCD_SECTOR_SIZE];
+            if (!io->load) {
+                state_io(io, live, MCD_SECTOR_SIZE);
+                continue;
+            }
+            uint8_t *p = state_ptr(io, MCD_SECTOR_SIZE);
+            if (p && memcmp(p, live, MCD_SECTOR_SIZE) != 0) {
+                memcpy(live, p, MCD_SECTOR_SIZE);
+                mcd_save_sector(slot, (uint16_t)sec);
+            }
+        }
+    }
+}
+
 /* ---- Public: Reset state machine when port is deselected ---- */
 void MCD_Reset(int slot)
 {
@@ -0,0 +1,48 @@
+/**
+ * audio_host_backend.c — Audio_Backend_* for the host build
+ *
+ * Samples are dropped.  Play never blocks, so nothing paces the
+ * emulator to real time and benchmark runs go at host speed.
+ */
+#include "audio_backend.h"
+
+int Audio_Backend_Init(void)
+{
+    return 0;
+}
+
+int Audio_Backend_Configure(int sample_rate, int bits, int channels, int volume)
+{
+    (void)sample_rate;
+    (void)bits;
+    (void)channels;
+    (void)volume;
+    return 0;
+}
+
+void Audio_Backend_Play(const int16_t *buffer, int size_bytes)
+{
+    (void)buffer;
+    (void)size_bytes;
+}
+
+int Audio_Backend_StartThread(int latency_frames)
+{
+    (void)latency_frames;
+    return -1;
+}
+
+int Audio_Backend_Queued(void)
+{
+    return -1;
+}
+
+void Audio_Backend_GetStats(uint32_t *underruns, uint32_t *overruns)
+{
+    *underruns = 0;
+    *overruns = 0;
+}
+
+void Audio_Backend_Shutdown(void)
+{
+}
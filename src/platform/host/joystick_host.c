@@ -0,0 +1,36 @@
+/**
+ * joystick_host.c — Joystick_* for the host build
+ *
+ * One digital pad on port 1 with nothing pressed.  Benchmark runs drive
+ * it from an input_play recording (benchmark.c), which replaces the
+ * responses in the SIO exchange.
+ */
+#include "joystick.h"
+
+void Joystick_Init(void)
+{
+}
+
+void Joystick_Shutdown(void)
+{
+}
+
+int Joystick_HasMultitap(int port)
+{
+    (void)port;
+    return 0;
+}
+
+int Joystick_IsConnected(int port, int slot)
+{
+    return port == 0 && slot == 0;
+}
+
+void Joystick_GetPSXDigitalResponse(int port, int slot, uint8_t response[3])
+{
+    (void)port;
+    (void)slot;
+    response[0] = 0x41; /* Digital pad ID */
+    response[1] = 0xFF; /* All buttons released */
+    response[2] = 0xFF;
+}
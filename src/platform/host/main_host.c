@@ -0,0 +1,101 @@
+/**
+ * main_host.c — Host entry point (headless, interpreter only)
+ *
+ *   superpsx <exe|bios> [disc image] [psx args...]
+ *
+ * superpsx.ini, memory cards and bench.json are read and written in the
+ * working directory, so parallel runs each get a directory of their own.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include "superpsx.h"
+#include "config.h"
+#include "joystick.h"
+#include "spu.h"
+#include "platform.h"
+
+#ifndef PSX_EXE_PATH_MAX
+#define PSX_EXE_PATH_MAX 512
+#endif
+
+char psx_exe_filename_buf[PSX_EXE_PATH_MAX] = "";
+const char *psx_exe_filename = psx_exe_filename_buf;
+
+/* Host-provided PSX argv */
+const char **psx_host_args = NULL;
+int psx_host_argc = 0;
+
+/* Boot mode: 0 = EXE, 1 = disc */
+int psx_boot_mode = 0;
+
+/* Optional disc image path (second argument) */
+char disc_image_path[PSX_EXE_PATH_MAX] = "";
+
+static int has_disc_extension(const char *filename)
+{
+    size_t len = strlen(filename);
+    if (len < 4)
+        return 0;
+    const char *ext = filename + len - 4;
+    return (strcasecmp(ext, ".iso") == 0 ||
+            strcasecmp(ext, ".bin") == 0 ||
+            strcasecmp(ext, ".cue") == 0 ||
+            strcasecmp(ext, ".pbp") == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    Platform_Init();
+    load_config_file();
+
+    if (argc > 1)
+    {
+        strncpy(psx_exe_filename_buf, argv[1], PSX_EXE_PATH_MAX - 1);
+        psx_exe_filename_buf[PSX_EXE_PATH_MAX - 1] = '\0';
+        printf("Using PSX exe from argv: %s\n", psx_exe_filename);
+
+        if (argc > 2 && has_disc_extension(argv[2]))
+        {
+            strncpy(disc_image_path, argv[2], PSX_EXE_PATH_MAX - 1);
+            disc_image_path[PSX_EXE_PATH_MAX - 1] = '\0';
+            printf("Disc image from argv: %s\n", disc_image_path);
+            if (argc > 3)
+            {
+                psx_host_argc = argc - 3;
+                psx_host_args = (const char **)&argv[3];
+            }
+        }
+        else if (argc > 2)
+        {
+            psx_host_argc = argc - 2;
+            psx_host_args = (const char **)&argv[2];
+        }
+    }
+
+    printf("SuperPSX v0.2 - Interpreter (host, headless)\n");
+    printf("CONFIG: boot=%s bios=%s audio=%s controllers=%s region=%s\n",
+           psx_config.boot_bios_only ? "bios" : "rom",
+           psx_config.bios_path,
+           psx_config.audio_enabled ? "enabled" : "disabled",
+           psx_config.controllers_enabled ? "enabled" : "disabled",
+           psx_config.region_pal ? "pal" : "ntsc");
+
+    if (!psx_config.boot_bios_only && psx_exe_filename_buf[0] == '\0')
+    {
+        printf("No ROM specified via argument or config file.\n");
+        printf("Usage: %s <exe|disc image> [disc image] [args...]\n", argv[0]);
+        return 1;
+    }
+
+    /* Always: the BIOS waits on SPU voice state (see main_psp.c) */
+    SPU_Init();
+    Joystick_Init();
+
+    Init_SuperPSX();
+
+    printf("SuperPSX finished.\n");
+    SPU_Shutdown();
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * platform_host.c — Host (Linux/POSIX) platform implementation
+ *
+ * The host build only interprets (no code generator for the host CPU),
+ * so the cache calls have nothing to do.  It also runs single-threaded:
+ * the worker handoffs in the core (cdrom_io.c, pad_snapshot.h,
+ * log_ring.c) rely on a single CPU where a worker preempts the emulator
+ * thread, never runs beside it.  Platform_ThreadStart fails and every
+ * worker falls back to its synchronous path, which also keeps benchmark
+ * runs deterministic.
+ */
+#include "platform.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+void Platform_Init(void)
+{
+}
+
+void Platform_Halt(void)
+{
+    exit(0);
+}
+
+void Platform_FlushDCache(void *start, void *end)
+{
+    (void)start;
+    (void)end;
+}
+
+void Platform_FlushICache(void)
+{
+}
+
+void Platform_SyncCodeRange(void *start, void *end)
+{
+    (void)start;
+    (void)end;
+}
+
+/* Monotonic nanoseconds */
+uint64_t Platform_GetCycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void Platform_Sleep(uint32_t ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+/* No compiled code to attribute samples to */
+int Platform_SampleStart(uint32_t hz, void (*cb)(uintptr_t pc))
+{
+    (void)hz;
+    (void)cb;
+    return -1;
+}
+
+void Platform_SampleStop(void)
+{
+}
+
+int Platform_ThreadStart(const char *name, void (*entry)(void *), void *arg,
+                         int stack_size)
+{
+    (void)name;
+    (void)entry;
+    (void)arg;
+    (void)stack_size;
+    return -1;
+}
+
+int Platform_SemaCreate(int init_count, int max_count)
+{
+    (void)init_count;
+    (void)max_count;
+    return -1;
+}
+
+void Platform_SemaWait(int sema)
+{
+    (void)sema;
+}
+
+void Platform_SemaSignal(int sema)
+{
+    (void)sema;
+}
+
+/* No TLB fastmem on the host */
+uint32_t psx_tlb_base = 0;
+void Setup_PSX_TLB(void) {}
@@ -2,12 +2,45 @@
  * audio_ps2_backend.c — Audio_Backend_* implementation for PS2
  *
  * Bridges audio_backend.h to PS2 audsrv/IOP audio driver.
+ *
+ * Threaded mode (Audio_Backend_StartThread): Play copies into an AudioRing
+ * and wakes an EE thread one priority above the emulator, which sleeps in
+ * audsrv_wait_audio instead of the emulator doing so.
  */
 #include "audio_backend.h"
+#include "audio_ring.h"
 #include <audsrv.h>
+#include <kernel.h>
 #include <ps2_audio_driver.h>
 #include <stdio.h>
 
+#define OUT_BLOCK_FRAMES 512
+#define OUT_STACK_SIZE   (16 * 1024)
+
+extern void *_gp;
+
+static AudioRing out_ring;
+static int out_thread = -1;
+static int out_sema = -1;
+static int out_primed;
+static uint8_t out_stack[OUT_STACK_SIZE] __attribute__((aligned(16)));
+static int16_t out_block[OUT_BLOCK_FRAMES * 2] __attribute__((aligned(64)));
+
+static void audio_out_thread(void *arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        WaitSema(out_sema);
+        int n;
+        while ((n = AudioRing_Read(&out_ring, out_block, OUT_BLOCK_FRAMES)) > 0)
+        {
+            audsrv_wait_audio(n * 4);
+            audsrv_play_audio((char *)out_block, n * 4);
+        }
+    }
+}
+
 int Audio_Backend_Init(void)
 {
     return init_audio_driver();
@@ -30,6 +63,17 @@ int Audio_Backend_Configure(int sample_rate, int bits, int channels, int volume)
 
 void Audio_Backend_Play(const int16_t *buffer, int size_bytes)
 {
+    if (out_thread >= 0)
+    {
+        /* Nothing left in the ring or the IOP since the last frame */
+        if (out_primed && Audio_Backend_Queued() == 0)
+            out_ring.underruns++;
+        AudioRing_Write(&out_ring, buffer, size_bytes / 4);
+        out_primed = 1;
+        SignalSema(out_sema);
+        return;
+    }
+
     /* Blocking wait: sleep until the IOP ring buffer has enough space.
      * This naturally paces the emulator to real-time via the audio
      * hardware clock, replacing the busy-wait frame limiter with
@@ -38,7 +82,67 @@ void Audio_Backend_Play(const int16_t *buffer, int size_bytes)
     audsrv_play_audio((char *)buffer, size_bytes);
 }
 
+int Audio_Backend_StartThread(int latency_frames)
+{
+    ee_thread_t th;
+    ee_thread_status_t self;
+    ee_sema_t sema;
+
+    if (out_thread >= 0)
+        return 0;
+    if (AudioRing_Init(&out_ring, (uint32_t)latency_frames * 2) != 0)
+        return -1;
+
+    sema.init_count = 0;
+    sema.max_count = 1;
+    sema.option = 0;
+    out_sema = CreateSema(&sema);
+
+    ReferThreadStatus(GetThreadId(), &self);
+    th.func = (void *)audio_out_thread;
+    th.stack = out_stack;
+    th.stack_size = OUT_STACK_SIZE;
+    th.gp_reg = &_gp;
+    th.initial_priority = self.current_priority > 1 ? self.current_priority - 1 : 1;
+    th.attr = 0;
+    th.option = 0;
+    out_thread = out_sema >= 0 ? CreateThread(&th) : -1;
+    if (out_thread < 0 || StartThread(out_thread, NULL) < 0)
+    {
+        if (out_thread >= 0)
+            DeleteThread(out_thread);
+        if (out_sema >= 0)
+            DeleteSema(out_sema);
+        out_thread = out_sema = -1;
+        AudioRing_Free(&out_ring);
+        return -1;
+    }
+    out_primed = 0;
+    return 0;
+}
+
+int Audio_Backend_Queued(void)
+{
+    if (out_thread < 0)
+        return -1;
+    return (int)AudioRing_Fill(&out_ring) + audsrv_queued() / 4;
+}
+
+void Audio_Backend_GetStats(uint32_t *underruns, uint32_t *overruns)
+{
+    *underruns = out_ring.underruns;
+    *overruns = out_ring.overruns;
+}
+
 void Audio_Backend_Shutdown(void)
 {
+    if (out_thread >= 0)
+    {
+        TerminateThread(out_thread);
+        DeleteThread(out_thread);
+        DeleteSema(out_sema);
+        out_thread = out_sema = -1;
+        AudioRing_Free(&out_ring);
+    }
     deinit_audio_driver();
 }
@@ -7,6 +7,7 @@
 #include "gpu_backend.h"
 #include "gpu_ps2_state.h"
 #include "gpu_trace.h"
+#include "config.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <malloc.h>
@@ -34,7 +35,18 @@ void GPU_Backend_Flush(void)           { Flush_GIF(); }
 void GPU_Backend_FlushSync(void)       { Flush_GIF_Sync(); }
 void GPU_Backend_SetupEnvironment(void){ Setup_GS_Environment(); }
 void GPU_Backend_UpdateDisplay(void)   { Update_GS_Display(); }
-void GPU_Backend_VBlank(void)          { GPU_VBlank(); gpu_trace_frame_end(); }
+
+static void display_24bit_update(void);
+static void field_render_update(void);
+void GPU_Backend_VBlank(void)
+{
+    GPU_Backend_QueueDrain();
+    display_24bit_update();
+    GPU_ReplayFrameEnd();
+    GPU_VBlank();
+    field_render_update();
+    gpu_trace_frame_end();
+}
 
 /* ── VRAM write streaming (STP bit + qword packing for GS IMAGE) ── */
 
@@ -81,6 +93,37 @@ void GPU_Backend_VRAMWrite(uint32_t word)
     }
 }
 
+void GPU_Backend_VRAMWriteBlock(const uint32_t *words, uint32_t count)
+{
+    /* Finish a partly filled qword word by word, then pack whole qwords */
+    while (count && _vram_pending_cnt)
+    {
+        GPU_Backend_VRAMWrite(*words++);
+        count--;
+    }
+    while (count >= 4)
+    {
+        uint32_t q[4];
+        for (int k = 0; k < 4; k++)
+        {
+            uint32_t w = words[k];
+            /* STP on each non-zero halfword, as GPU_Backend_VRAMWrite */
+            uint32_t lo = (w & 0xFFFF) ? 0x8000 : 0;
+            uint32_t hi = (w >> 16) ? 0x80000000u : 0;
+            q[k] = w | lo | hi;
+        }
+        _vram_buf[_vram_buf_ptr++] =
+            (unsigned __int128)((uint64_t)q[0] | ((uint64_t)q[1] << 32)) |
+            ((unsigned __int128)((uint64_t)q[2] | ((uint64_t)q[3] << 32)) << 64);
+        if (_vram_buf_ptr >= 1000)
+            _vram_flush_partial(0);
+        words += 4;
+        count -= 4;
+    }
+    while (count--)
+        GPU_Backend_VRAMWrite(*words++);
+}
+
 void GPU_Backend_VRAMFlush(void)
 {
     /* Pad last qword */
@@ -110,15 +153,103 @@ void GPU_Backend_VRAMFlush(void)
 
 /* ── VRAM readback ───────────────────────────────────────────────── */
 
-void GPU_Backend_VRAMReadback(int x, int y, int w, int h)
+/* Coherency between GS local memory and psx_vram_shadow, per 64×16
+ * tile (the texture cache's dirty grid).  CPU uploads write the shadow
+ * themselves and leave the tiles they cover clean; GS rendering, and
+ * fill-rects and VRAM copies away from texture pages, leave it stale.
+ * Rendering is tracked coarsely: whenever packets were sent
+ * since the last check, the current drawing area counts as GS-written.
+ * A readback only fetches the GS-written tiles of its region, and
+ * waits until the data is actually needed (first GPUREAD, or the next
+ * GP0/GP1 write or GPU DMA).  Other shadow readers (texture page
+ * uploads, shadow-side VRAM copies) fetch theirs through RB_SyncRegion
+ * first, so a game that never reads those tiles never pays for them. */
+#define RB_COLS 16 /* 1024 / 64 */
+#define RB_ROWS 32 /* 512 / 16 */
+#define RB_ROW_SHIFT 4
+#define RB_ALL_COLS 0xFFFF
+
+static uint16_t rb_gs_dirty[RB_ROWS] = {
+    [0 ... RB_ROWS - 1] = RB_ALL_COLS /* unknown at boot */
+};
+static int rb_area_x1 = 0, rb_area_y1 = 0;
+static int rb_area_x2 = PSX_VRAM_WIDTH, rb_area_y2 = PSX_VRAM_HEIGHT;
+static uint32_t rb_area_seq = ~0u; /* gif_flush_count when the area was last marked */
+static int rb_x, rb_y, rb_w, rb_h; /* deferred readback */
+
+static void rb_mark_gs(int x1, int y1, int x2, int y2)
 {
-    if (!psx_vram_shadow || w <= 0 || h <= 0)
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > PSX_VRAM_WIDTH) x2 = PSX_VRAM_WIDTH;
+    if (y2 > PSX_VRAM_HEIGHT) y2 = PSX_VRAM_HEIGHT;
+    if (x2 <= x1 || y2 <= y1)
+        return;
+    int c0 = x1 >> 6, c1 = (x2 - 1) >> 6;
+    uint16_t cols = (uint16_t)(((2u << c1) - 1) & ~((1u << c0) - 1));
+    for (int r = y1 >> RB_ROW_SHIFT; r <= (y2 - 1) >> RB_ROW_SHIFT; r++)
+        rb_gs_dirty[r] |= cols;
+}
+
+/* Tiles of a non-wrapping region that hold GS-written pixels */
+static int rb_tiles_dirty(int x1, int y1, int x2, int y2)
+{
+    int c0 = x1 >> 6, c1 = (x2 - 1) >> 6;
+    uint16_t cols = (uint16_t)(((2u << c1) - 1) & ~((1u << c0) - 1));
+    for (int r = y1 >> RB_ROW_SHIFT; r <= (y2 - 1) >> RB_ROW_SHIFT; r++)
+        if (rb_gs_dirty[r] & cols)
+            return 1;
+    return 0;
+}
+
+/* Tiles entirely inside a non-wrapping region become clean; edge tiles
+ * stay as they are */
+static void rb_clean_inner(int x, int y, int w, int h)
+{
+    int cx1 = (x + 63) >> 6, cx2 = (x + w) >> 6;
+    int ry1 = (y + (1 << RB_ROW_SHIFT) - 1) >> RB_ROW_SHIFT, ry2 = (y + h) >> RB_ROW_SHIFT;
+    if (cx2 <= cx1)
         return;
+    uint16_t inner = (uint16_t)(((1u << cx2) - 1) & ~((1u << cx1) - 1));
+    for (int r = ry1; r < ry2; r++)
+        rb_gs_dirty[r] &= (uint16_t)~inner;
+}
 
-    /* Flush any pending GIF packets so GS VRAM is up-to-date */
-    if (fast_gif_ptr != (gif_qword_t *)&gif_packet_buf[current_buffer][0])
-        Flush_GIF();
+/* A replayed chain (gpu_ps2_replay.c) may have drawn anywhere */
+void RB_MarkAllDrawn(void)
+{
+    rb_mark_gs(0, 0, PSX_VRAM_WIDTH, PSX_VRAM_HEIGHT);
+}
 
+/* A fill-rect left only in GS memory (shadow not written) */
+void RB_MarkRegionDrawn(int x, int y, int w, int h)
+{
+    rb_mark_gs(x, y, x + w, y + h);
+}
+
+/* Anything queued or sent since the last mark may have drawn into the
+ * current drawing area */
+static void rb_mark_draw_area(void)
+{
+    if (fast_gif_ptr == gif_buffer_start && gif_flush_count == rb_area_seq)
+        return;
+    rb_mark_gs(rb_area_x1, rb_area_y1, rb_area_x2, rb_area_y2);
+    rb_area_seq = gif_flush_count;
+}
+
+/* The GS copy of a region was just overwritten from the shadow (or with
+ * the data just written to it): draws sent before no longer count */
+void RB_MarkRegionClean(int x, int y, int w, int h)
+{
+    if (w <= 0 || h <= 0 || x + w > PSX_VRAM_WIDTH || y + h > PSX_VRAM_HEIGHT)
+        return;
+    rb_mark_draw_area();
+    rb_clean_inner(x, y, w, h);
+}
+
+/* Read one rectangle back from the GS into psx_vram_shadow */
+static void rb_read_rect(int x, int y, int w, int h)
+{
     int w_aligned = (w + 7) & ~7;
     int total_pixels = w_aligned * h;
     int buf_bytes = total_pixels * 2; /* 16bpp */
@@ -154,10 +285,102 @@ void GPU_Backend_VRAMReadback(int x, int y, int w, int h)
     free(rb_buf);
 }
 
+void GPU_Backend_VRAMReadback(int x, int y, int w, int h)
+{
+    if (!psx_vram_shadow || w <= 0 || h <= 0)
+        return;
+    if (gpu_readback_pending)
+        GPU_Backend_VRAMReadbackResolve();
+    rb_x = x;
+    rb_y = y;
+    rb_w = w;
+    rb_h = h;
+    gpu_readback_pending = 1;
+}
+
+/* Read back the GS-written tiles of a region into psx_vram_shadow */
+static void rb_sync_rect(int x, int y, int w, int h)
+{
+    /* Wrapping regions: read the whole thing, tracking untouched */
+    if (x + w > PSX_VRAM_WIDTH || y + h > PSX_VRAM_HEIGHT)
+    {
+        rb_read_rect(x, y, w, h);
+        gpu_frame_stats.vram_readbacks++;
+        return;
+    }
+
+    int c0 = x >> 6, c1 = (x + w - 1) >> 6;
+    uint16_t cols = (uint16_t)(((2u << c1) - 1) & ~((1u << c0) - 1));
+    int r0 = y >> RB_ROW_SHIFT, r1 = (y + h - 1) >> RB_ROW_SHIFT;
+
+    /* One GS transfer per run of tile rows with the same dirty columns */
+    for (int r = r0; r <= r1;)
+    {
+        uint16_t mask = rb_gs_dirty[r] & cols;
+        int rn = r + 1;
+        while (rn <= r1 && (rb_gs_dirty[rn] & cols) == mask)
+            rn++;
+        if (mask)
+        {
+            int lo = __builtin_ctz(mask), hi = 31 - __builtin_clz(mask);
+            int rx1 = lo << 6, rx2 = (hi + 1) << 6;
+            int ry1 = r << RB_ROW_SHIFT, ry2 = rn << RB_ROW_SHIFT;
+            if (rx1 < x) rx1 = x;
+            if (ry1 < y) ry1 = y;
+            if (rx2 > x + w) rx2 = x + w;
+            if (ry2 > y + h) ry2 = y + h;
+            rb_read_rect(rx1, ry1, rx2 - rx1, ry2 - ry1);
+            gpu_frame_stats.vram_readbacks++;
+        }
+        r = rn;
+    }
+    rb_clean_inner(x, y, w, h);
+    /* GS_ReadbackRegion drained the ring: nothing is outstanding */
+    rb_area_seq = gif_flush_count;
+}
+
+void GPU_Backend_VRAMReadbackResolve(void)
+{
+    gpu_readback_pending = 0;
+    rb_mark_draw_area();
+    GPU_ReplayInvalidate(); /* the shadow now holds GS-rendered pixels */
+    rb_sync_rect(rb_x, rb_y, rb_w, rb_h);
+}
+
+/* Bring psx_vram_shadow up to date over a region before reading it.
+ * Returns at once when none of its tiles was written by the GS alone. */
+void RB_SyncRegion(int x, int y, int w, int h)
+{
+    if (!psx_vram_shadow || w <= 0 || h <= 0)
+        return;
+    rb_mark_draw_area();
+    int x2 = x + w > PSX_VRAM_WIDTH ? PSX_VRAM_WIDTH : x + w;
+    int y2 = y + h > PSX_VRAM_HEIGHT ? PSX_VRAM_HEIGHT : y + h;
+    if (!rb_tiles_dirty(x, y, x2, y2) &&
+        (x + w <= PSX_VRAM_WIDTH || !rb_tiles_dirty(0, y, x + w - PSX_VRAM_WIDTH, y2)) &&
+        (y + h <= PSX_VRAM_HEIGHT || !rb_tiles_dirty(0, 0, PSX_VRAM_WIDTH, y + h - PSX_VRAM_HEIGHT)))
+        return;
+    GPU_ReplayInvalidate();
+    rb_sync_rect(x, y, w, h);
+}
+
+void GPU_Backend_ShadowSync(int x, int y, int w, int h)
+{
+    if (gpu_readback_pending)
+        GPU_Backend_VRAMReadbackResolve();
+    RB_SyncRegion(x, y, w, h);
+}
+
 /* ── Drawing environment ─────────────────────────────────────────── */
 
 void GPU_Backend_SetScissor(int x1, int y1, int x2, int y2)
 {
+    rb_mark_draw_area(); /* earlier packets drew into the old area */
+    rb_area_x1 = x1;
+    rb_area_y1 = y1;
+    rb_area_x2 = x2;
+    rb_area_y2 = y2;
+
     Push_GIF_Tag(GIF_TAG_LO(1, 1, 0, 0, 0, 1), GIF_REG_AD);
     uint64_t scax1 = (x2 > 0) ? (x2 - 1) : 0;
     uint64_t scay1 = (y2 > 0) ? (y2 - 1) : 0;
@@ -166,8 +389,74 @@ void GPU_Backend_SetScissor(int x1, int y1, int x2, int y2)
 
 #define DEBUG_SHOW_FULL_VRAM 0  /* Set to 1 to show full 1024x512 PSX VRAM */
 
+/* ── 24-bit display (MDEC movies) ────────────────────────────────── */
+
+/* The CT16S VRAM mirror holds STP-fixed halfwords in a layout a CT24
+ * read can't reinterpret, so a 24-bit display is scanned out from its
+ * own CT24 buffer instead, in borrowed 8BPP texture slot memory.  It is
+ * refilled once per VBlank straight from the shadow (GS_UploadRGB24),
+ * and only when the shadow may have changed under it. */
+static int disp24_on;
+static int disp24_x, disp24_y, disp24_w, disp24_h;
+static uint32_t disp24_gen;
+
+static void display_24bit_update(void)
+{
+    if (!disp_24bit)
+    {
+        if (disp24_on)
+        {
+            disp24_on = 0;
+            GPU_Backend_SetDisplayFB(display_start_x, display_start_y);
+        }
+        return;
+    }
+
+    int w, h = (disp_range_y2 - disp_range_y1) * (disp_vres + 1);
+    if (disp_hres368)
+        w = 368;
+    else
+    {
+        static const int widths[] = {256, 320, 512, 640};
+        w = widths[disp_hres & 3];
+    }
+    if (h <= 0)
+        return;
+    if (h > PSX_VRAM_HEIGHT)
+        h = PSX_VRAM_HEIGHT;
+
+    int x = display_start_x, y = display_start_y;
+    int hw = (w * 3 + 1) / 2; /* halfwords per line */
+    int fbw = (w + 63) / 64;
+    int blocks = fbw * ((h + 31) / 32) * 32; /* 2 KB pages of 64x32 */
+    int reclaimed;
+    int tbp = Tex_Cache_Borrow8(x, y, blocks, &reclaimed);
+    int x2 = x + hw > PSX_VRAM_WIDTH ? PSX_VRAM_WIDTH : x + hw;
+    int y2 = y + h > PSX_VRAM_HEIGHT ? PSX_VRAM_HEIGHT : y + h;
+
+    if (disp24_on && !reclaimed && disp24_gen == vram_gen_counter && disp24_x == x &&
+        disp24_y == y && disp24_w == w && disp24_h == h && !rb_tiles_dirty(x, y, x2, y2))
+        return;
+
+    GPU_Backend_ShadowSync(x, y, hw, h);
+    GS_UploadRGB24(x, y, w, h, tbp, fbw);
+    disp24_x = x;
+    disp24_y = y;
+    disp24_w = w;
+    disp24_h = h;
+    disp24_gen = vram_gen_counter;
+    disp24_on = 1;
+
+    uint64_t dispfb = (uint64_t)(tbp / 32) | ((uint64_t)fbw << 9) | ((uint64_t)GS_PSM_24 << 15);
+    *((volatile uint64_t *)0x12000070) = dispfb; /* DISPFB1 */
+    *((volatile uint64_t *)0x12000090) = dispfb; /* DISPFB2 */
+}
+
 void GPU_Backend_SetDisplayFB(int x, int y)
 {
+    if (disp24_on && disp_24bit)
+        return; /* display_24bit_update follows the new start at VBlank */
+
     uint64_t dispfb = 0;
     dispfb |= (uint64_t)PSX_VRAM_FBW << 9;
     dispfb |= (uint64_t)PSX_VRAM_PSM << 15;
@@ -185,6 +474,31 @@ void GPU_Backend_SetDisplayFB(int x, int y)
 void GPU_Backend_SetResolution(int interlace, int mode)
 {
     SetGsCrt(interlace, mode, 0);
+    field_render_update();
+}
+
+/* ── Single-field rendering (gpu_field_render) ───────────────────── */
+
+/* In 480i the GS shows VRAM in field mode, one line parity per field,
+ * so lines of the field on screen now are redrawn before they are seen
+ * again.  SCANMSK drops them, as the PSX GPU itself does with GPUSTAT.10
+ * clear, halving fill.  Runs after the GPUSTAT.31 flip at each VBlank. */
+static int field_scanmsk; /* last SCANMSK written: 0, 2 (draw even) or 3 (draw odd) */
+
+static void field_render_update(void)
+{
+    int want = 0;
+    if (psx_config.gpu_field_render && disp_interlace && disp_vres)
+    {
+        /* Field mode reads lines DISPFB.DBY + 2k + field */
+        int shown_odd = (display_start_y + (gpu_stat >> 31)) & 1;
+        want = shown_odd ? 2 : 3;
+    }
+    if (want == field_scanmsk)
+        return;
+    Push_GIF_Tag(GIF_TAG_LO(1, 1, 0, 0, 0, 1), GIF_REG_AD);
+    Push_GIF_Data((uint64_t)want, GS_REG_SCANMSK);
+    field_scanmsk = want;
 }
 
 void GPU_Backend_SetMaskBit(int set, int check)
@@ -242,7 +556,55 @@ void GPU_Backend_UploadRegionFast(uint32_t coords, uint32_t dims,
 void GPU_Backend_VRAMCopy(int sx, int sy, int dx, int dy, int w, int h)
 {
     (void)sx; (void)sy; (void)dx; (void)dy; (void)w; (void)h;
-    /* VRAM-to-VRAM copy handled via shadow VRAM + re-upload for now */
+    /* VRAM-to-VRAM copy handled via shadow VRAM + GPU_Backend_VRAMCopyLocal */
+}
+
+/* GS local→local transfer (TRXDIR=2).  The GS copies the 16-bit words
+ * as stored, so the destination keeps the source's STP encoding, just
+ * as if the game had drawn it there.  Falls back to the shadow
+ * re-upload for:
+ *  - mask bits (GP0 E6h): need a per-pixel test / set of bit 15
+ *  - overlap: the PSX left→right, top→bottom order is observable
+ *  - 1024×512 wrap: would need several transfers */
+int GPU_Backend_VRAMCopyLocal(int sx, int sy, int dx, int dy, int w, int h)
+{
+    if (mask_set_bit || mask_check_bit)
+        return 0;
+    if (sx + w > PSX_VRAM_WIDTH || dx + w > PSX_VRAM_WIDTH ||
+        sy + h > PSX_VRAM_HEIGHT || dy + h > PSX_VRAM_HEIGHT)
+        return 0;
+    if (sx < dx + w && dx < sx + w && sy < dy + h && dy < sy + h)
+        return 0;
+
+    Push_GIF_Tag(GIF_TAG_LO(5, 1, 0, 0, 0, 1), GIF_REG_AD);
+    Push_GIF_Data(GS_SET_BITBLTBUF(0, PSX_VRAM_FBW, PSX_VRAM_PSM, 0, PSX_VRAM_FBW, PSX_VRAM_PSM),
+                  GS_REG_BITBLTBUF);
+    Push_GIF_Data(GS_SET_TRXPOS(sx, sy, dx, dy, 0), GS_REG_TRXPOS);
+    Push_GIF_Data(GS_SET_TRXREG(w, h), GS_REG_TRXREG);
+    Push_GIF_Data(GS_SET_TRXDIR(2), GS_REG_TRXDIR); // Local -> Local
+    Push_GIF_Data(GS_SET_TEXFLUSH(0), GS_REG_TEXFLUSH);
+
+    /* Away from uploaded texture pages the shadow copy is skipped, as
+     * for fill-rects: its next reader fetches the region from the GS */
+    rb_mark_draw_area();
+    if (!gpu_readback_pending && !Tex_Cache_RegionCached(dx, dy, w, h))
+    {
+        rb_mark_gs(dx, dy, dx + w, dy + h);
+        return 2;
+    }
+
+    /* The shadow copy is exact only if the source was coherent */
+    int c0 = sx >> 6, c1 = (sx + w - 1) >> 6;
+    uint16_t cols = (uint16_t)(((2u << c1) - 1) & ~((1u << c0) - 1));
+    for (int r = sy >> RB_ROW_SHIFT; r <= (sy + h - 1) >> RB_ROW_SHIFT; r++)
+    {
+        if (rb_gs_dirty[r] & cols)
+        {
+            rb_mark_gs(dx, dy, dx + w, dy + h);
+            break;
+        }
+    }
+    return 1;
 }
 
 /* ── State management ────────────────────────────────────────────── */
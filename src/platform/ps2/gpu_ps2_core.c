@@ -7,6 +7,7 @@
  * GPU_Flush, and Update_GS_Display.
  */
 #include "gpu_ps2_state.h"
+#include "gpu_backend.h"
 #include "osd.h"
 #include "scheduler.h"
 
@@ -31,10 +32,10 @@ int fb_height = 448;
 int fb_psm = PSX_VRAM_PSM;
 
 /* GIF double-buffered packet buffers */
-unsigned __int128 gif_packet_buf[2][GIF_BUFFER_SIZE] __attribute__((aligned(128)));
+unsigned __int128 gif_packet_buf[GIF_RING_SEGMENTS][GIF_BUFFER_SIZE] __attribute__((aligned(128)));
 gif_qword_t *fast_gif_ptr = NULL;
+gif_qword_t *gif_buffer_start = NULL;
 gif_qword_t *gif_buffer_end_safe = NULL;
-int current_buffer = 0;
 
 /* GS shadow drawing state */
 int draw_offset_x = 0;
@@ -63,6 +64,7 @@ int dither_enabled = 0;
 uint16_t *psx_vram_shadow = NULL;
 
 volatile int gpu_pending_vblank_flush = 0;
+int gpu_readback_pending = 0;
 
 /* Debug log file */
 
@@ -123,9 +125,14 @@ int buf_image_ptr = 0;
 
 uint32_t GPU_Read(void)
 {
+    GPU_GP0FifoSync();
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
     /* If VRAM read transfer is active (GP0 C0h) */
     if (vram_read_remaining > 0)
     {
+        if (gpu_readback_pending)
+            GPU_Backend_VRAMReadbackResolve();
         uint16_t p0 = 0, p1 = 0;
         if (psx_vram_shadow && vram_read_w > 0)
         {
@@ -174,6 +181,13 @@ uint32_t GPU_ReadStatus(void)
      * the CPU idling while the GPU works, but much faster to emulate. */
     extern uint64_t gpu_busy_until;
 
+    /* Buffered GP0 words can change GPUSTAT and start a busy period */
+    GPU_GP0FifoSync();
+
+    /* Queued chains set GPUSTAT bits and the busy estimate */
+    if (gpu_queue_pending)
+        GPU_Backend_QueueDrain();
+
     if (gpu_busy_until)
     {
         if (global_cycles < gpu_busy_until)
@@ -6,9 +6,12 @@
  * PSX games to submit display lists).
  */
 #include "gpu_ps2_state.h"
+#include "config.h"
+#include "gpu_backend.h"
 #include "gpu_trace.h"
 #include "scheduler.h"
 #include "profiler.h"
+#include <string.h>
 
 /* ── GPU rendering busy tracking ─────────────────────────────────────── */
 /* gpu_busy_until: global_cycles value until which the GPU is "busy".
@@ -26,6 +29,253 @@ uint64_t gpu_busy_until = 0;
  * We use a uniform ~2 CPU cycles per pixel as a rough average.             */
 #define GPU_CYCLES_PER_PIXEL 2
 
+/* ── One linked-list packet ──────────────────────────────────────── */
+/* Table-driven dispatch of count GP0 words (a packet never wraps the
+ * end of RAM in practice; commands are read linearly as before). */
+static void dma_packet(uint32_t *p, uint32_t count, int reorder)
+{
+    /* Record raw GP0 words for offline trace analysis */
+    gpu_trace_record(p, count);
+
+    /* ── Polyline-active: rare slow path, word-by-word ── */
+    if (polyline_active)
+    {
+        GPU_ReorderFlush();
+        Prim_FlushBatch();
+        for (uint32_t i = 0; i < count; i++)
+            GPU_WriteGP0(p[i]);
+        return;
+    }
+
+    /* ── Fast inner loop: table-driven dispatch ── */
+    for (uint32_t i = 0; i < count;)
+    {
+        uint32_t *cmd_ptr = &p[i];
+        uint32_t cmd_word = cmd_ptr[0];
+        uint32_t cmd_byte = cmd_word >> 24;
+        uint8_t cmd_size = gpu_cmd_size[cmd_byte];
+
+        /* ── Variable-length commands (polylines, LoadImage, StoreImage) ── */
+        if (cmd_size == 0)
+        {
+            GPU_ReorderFlush();
+            Prim_FlushBatch();
+            if (cmd_byte == 0xA0)
+            {
+                /* LoadImage: fast path if entire block fits in packet */
+                uint32_t dims = cmd_ptr[2];
+                uint32_t image_words = ((dims & 0xFFFF) * (dims >> 16)) / 2;
+                if (3 + image_words <= count - i)
+                {
+                    PROF_PUSH(PROF_GPU_UPLOAD);
+                    GS_UploadRegionFast(cmd_ptr[1], dims, &cmd_ptr[3], image_words);
+                    PROF_POP(PROF_GPU_UPLOAD);
+                    i += 3 + image_words;
+                    continue;
+                }
+            }
+            /* Polylines / fragmented LoadImage / StoreImage → word-by-word */
+            while (i < count)
+            {
+                GPU_WriteGP0(p[i]);
+                i++;
+                if (gpu_cmd_remaining == 0 && gpu_transfer_words == 0 && !polyline_active)
+                    break;
+            }
+            continue;
+        }
+
+        /* ── Draw commands: polys, rects, lines, fill-rect (0x02-0x7F) ── */
+        if (cmd_byte <= 0x7F)
+        {
+            int size;
+            if (gpu_skip_frame && i + cmd_size <= count)
+            {
+                GPU_ReorderFlush();
+                if (GPU_SkipDraw(cmd_ptr))
+                {
+                    i += cmd_size;
+                    continue;
+                }
+            }
+            if (reorder && i + cmd_size <= count && GPU_ReorderAdd(cmd_ptr))
+                size = cmd_size;
+            else
+            {
+                GPU_ReorderFlush();
+                size = Prim_DrawCommand(cmd_ptr);
+            }
+            i += size;
+            continue;
+        }
+
+        /* ── VRAM-to-VRAM copy (0x80-0x9F): 4 words ── */
+        if ((cmd_byte & 0xE0) == 0x80)
+        {
+            GPU_ReorderFlush();
+            Prim_FlushBatch();
+            if (i + 4 <= count)
+            {
+                GPU_WriteGP0(cmd_ptr[0]);
+                GPU_WriteGP0(cmd_ptr[1]);
+                GPU_WriteGP0(cmd_ptr[2]);
+                GPU_WriteGP0(cmd_ptr[3]);
+                i += 4;
+            }
+            else
+            {
+                GPU_WriteGP0(cmd_word);
+                i++;
+            }
+            continue;
+        }
+
+        /* ── E1-E6 env commands, NOP, etc. ── */
+        GPU_ReorderFlush();
+        if (!(cmd_byte == 0xE1 && GPU_E1DitherOnly(cmd_word)))
+            Prim_FlushBatch();
+        GPU_WriteGP0(cmd_word);
+        i++;
+    }
+}
+
+/* ── GP0 command queue (gpu_queue = 1) ───────────────────────────── */
+/* Linked-list packets are copied here at DMA time (the game may reuse
+ * its ordering table as soon as the DMA completes) and translated at
+ * the next point that can observe the GPU: GPUSTAT / GPUREAD, GP0 /
+ * GP1 port writes, a non-chain DMA, VBlank, or a dynarec idle skip.
+ * Entries are [count][count words], in stream order. */
+#define GPUQ_WORDS (128 * 1024)
+
+int gpu_queue_pending = 0;
+static uint32_t __attribute__((aligned(64))) gpuq_buf[GPUQ_WORDS];
+static uint32_t gpuq_len;
+static uint64_t gpuq_dma_end; /* global_cycles at the end of the last queued DMA */
+
+void GPU_Backend_QueueDrain(void)
+{
+    if (!gpu_queue_pending)
+        return;
+    gpu_queue_pending = 0; /* GP0 writes below must not re-enter */
+
+    PROF_PUSH(PROF_GPU_DMA);
+    int reorder = psx_config.gpu_reorder;
+    gpu_estimated_pixels = 0;
+    if (fast_gif_ptr != gif_buffer_start)
+        Flush_GIF();
+    for (uint32_t q = 0; q < gpuq_len; q += 1 + gpuq_buf[q])
+        dma_packet(&gpuq_buf[q + 1], gpuq_buf[q], reorder);
+    gpuq_len = 0;
+
+    GPU_ReorderFlush();
+    Prim_FlushBatch();
+    if (fast_gif_ptr != gif_buffer_start)
+        Flush_GIF();
+
+    /* Rendering cost counts from the last queued DMA, as if drawn then */
+    uint64_t busy = gpuq_dma_end + gpu_estimated_pixels * GPU_CYCLES_PER_PIXEL;
+    gpu_estimated_pixels = 0;
+    if (busy > global_cycles)
+        gpu_busy_until = busy;
+    PROF_POP(PROF_GPU_DMA);
+}
+
+static void gpuq_push(const uint32_t *words, uint32_t count)
+{
+    if (gpuq_len + 1 + count > GPUQ_WORDS)
+        GPU_Backend_QueueDrain();
+    gpuq_buf[gpuq_len] = count;
+    memcpy(&gpuq_buf[gpuq_len + 1], words, count * sizeof(uint32_t));
+    gpuq_len += 1 + count;
+    gpu_queue_pending = 1;
+}
+
+/* ── Empty ordering-table slots ──────────────────────────────────── */
+/* DMA6 links every OT slot to the word below it, and most slots of a
+ * 3D game's table are still empty when it is sent.  A run of them is
+ * walked as a descending scan (one compare per slot, the next cache
+ * line prefetched) instead of a header-by-header pointer chase.
+ * Returns the number of empty slots from addr; stops before the chain
+ * would loop back to start_addr. */
+static inline uint32_t ot_empty_run(uint32_t addr, uint32_t start_addr, uint32_t max)
+{
+    const uint32_t *ram = (const uint32_t *)psx_ram;
+    uint32_t n = 0;
+    while (n < max)
+    {
+        uint32_t below = (addr - 4) & 0x1FFFFC;
+        if (ram[addr >> 2] != below || below == start_addr)
+            break;
+        if (!(addr & 63))
+            __builtin_prefetch(&ram[((addr - 64) & 0x1FFFFC) >> 2], 0, 3);
+        addr = below;
+        n++;
+    }
+    return n;
+}
+
+/* ── Chain pre-walk for gpu_replay ───────────────────────────────── */
+/* Follows the chain like GPU_DMA2, hashing every packet and charging
+ * the same words / packets.  Returns 1 if the chain completes and holds
+ * only commands gpu_ps2_replay.c can replay (NOP, FillRect, fixed-size
+ * draws, E1-E6), none of them split across packets. */
+static int chain_prewalk(uint32_t addr, uint32_t hash[2], uint32_t *words, int *npackets)
+{
+    const uint32_t start_addr = addr;
+    uint32_t h0 = 2166136261u, h1 = 0x9E3779B9u;
+    uint32_t total = 0;
+    int packets = 0;
+
+    while (packets < 20000)
+    {
+        uint32_t run = ot_empty_run(addr, start_addr, (uint32_t)(20000 - packets));
+        if (run)
+        {
+            packets += run;
+            total += run;
+            addr = (addr - run * 4) & 0x1FFFFC;
+            continue;
+        }
+
+        uint32_t header = *(uint32_t *)&psx_ram[addr];
+        uint32_t count = header >> 24;
+        uint32_t next = header & 0xFFFFFF;
+        const uint32_t *p = (const uint32_t *)&psx_ram[(addr + 4) & 0x1FFFFC];
+        if (count > 256)
+            return 0;
+        total += count + 1;
+        h0 = (h0 ^ count) * 16777619u;
+        for (uint32_t i = 0; i < count;)
+        {
+            uint32_t cmd = p[i] >> 24;
+            uint32_t size = gpu_cmd_size[cmd];
+            if (!size || i + size > count ||
+                !(cmd == 0x00 || cmd == 0x02 || (cmd >= 0x20 && cmd <= 0x7F) ||
+                  (cmd >= 0xE1 && cmd <= 0xE6)))
+                return 0;
+            for (uint32_t end = i + size; i < end; i++)
+            {
+                h0 = (h0 ^ p[i]) * 16777619u;
+                h1 = ((h1 << 5) | (h1 >> 27)) + p[i];
+            }
+        }
+        packets++;
+
+        if (next == 0xFFFFFF)
+        {
+            hash[0] = h0;
+            hash[1] = h1;
+            *words = total;
+            *npackets = packets;
+            return 1;
+        }
+        if (next == addr || (next & 0x1FFFFC) == start_addr || (next & 0x3))
+            return 0;
+        addr = next & 0x1FFFFC;
+    }
+    return 0;
+}
+
 /* ── DMA Channel 2 entry point ───────────────────────────────────── */
 /* Returns 0 if transfer completed normally, 1 if stalled (e.g. linked list loop). */
 int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr)
@@ -34,15 +284,28 @@ int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr)
     if ((chcr & 0x01000000) == 0)
         return 0;
 
+    uint32_t sync_mode = (chcr >> 9) & 3;
+    uint32_t direction = chcr & 1;
+    int queue = psx_config.gpu_queue && sync_mode == 2;
+
+    /* GP0 port words the JIT buffered were written before this DMA */
+    GPU_GP0FifoSync();
+
+    /* Anything but another chain sees the queued packets drawn first */
+    if (gpu_queue_pending && !queue)
+        GPU_Backend_QueueDrain();
+
     PROF_PUSH(PROF_GPU_DMA);
 
     /* Reset pixel accumulator for this DMA batch */
     gpu_estimated_pixels = 0;
-    uint32_t sync_mode = (chcr >> 9) & 3;
-    uint32_t direction = chcr & 1;
+
+    /* A deferred GP0(C0h) readback must see VRAM as it was before this DMA */
+    if (gpu_readback_pending)
+        GPU_Backend_VRAMReadbackResolve();
 
     // Flush any pending GIF data from direct GP0 writes before starting DMA
-    if (fast_gif_ptr != (gif_qword_t *)&gif_packet_buf[current_buffer][0])
+    if (fast_gif_ptr != gif_buffer_start)
         Flush_GIF();
 
     // Sync Mode 0 (Continuous) and 1 (Block/Request): CPU -> GPU transfer
@@ -136,9 +399,44 @@ int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr)
         uint32_t total_dma_words = 0; /* track total data words for cycle cost */
         int chain_completed = 0; /* set to 1 when 0xFFFFFF terminator reached */
         uint32_t start_addr = addr; /* for loop detection */
+        int reorder = psx_config.gpu_reorder;
+
+        /* Repeated chain: push its captured GS packets instead */
+        int capture = 0;
+        if (psx_config.gpu_replay && !queue)
+        {
+            uint32_t hash[2], run_words;
+            int run_packets;
+            uint64_t pixels;
+            if (!polyline_active && !gpu_cmd_remaining && !gpu_transfer_words &&
+                chain_prewalk(addr, hash, &run_words, &run_packets))
+            {
+                if (GPU_ReplayLookup(hash, &pixels))
+                {
+                    total_dma_words = run_words;
+                    packets = run_packets;
+                    gpu_estimated_pixels = pixels;
+                    chain_completed = 1;
+                    goto chain_cost;
+                }
+                capture = gpu_replay_capturing;
+            }
+            else
+                GPU_ReplayLookup(NULL, &pixels);
+        }
 
         while (packets < max_packets)
         {
+            /* Untouched OT slots: bulk skip, charged as before */
+            uint32_t run = ot_empty_run(addr, start_addr, (uint32_t)(max_packets - packets));
+            if (run)
+            {
+                packets += run;
+                total_dma_words += run;
+                addr = (addr - run * 4) & 0x1FFFFC;
+                continue;
+            }
+
             uint32_t packet_addr = addr;
             uint32_t header = *(uint32_t *)&psx_ram[addr];
             uint32_t count = header >> 24;
@@ -159,117 +457,13 @@ int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr)
                 break;
             }
 
-            /* Record raw GP0 words for offline trace analysis */
             if (count > 0)
-                gpu_trace_record((uint32_t *)&psx_ram[(addr + 4) & 0x1FFFFC], count);
-
-            addr = (addr + 4) & 0x1FFFFC;
-
-            /* ── Polyline-active: rare slow path, word-by-word ── */
-            if (polyline_active)
             {
-                Prim_FlushBatch();
-                for (uint32_t i = 0; i < count; i++)
-                {
-                    GPU_WriteGP0(*(uint32_t *)&psx_ram[addr]);
-                    addr = (addr + 4) & 0x1FFFFC;
-                }
-            }
-            else
-            {
-                /* ── Fast inner loop: table-driven dispatch ── */
-                for (uint32_t i = 0; i < count;)
-                {
-                    uint32_t *cmd_ptr = (uint32_t *)&psx_ram[addr];
-                    uint32_t cmd_word = cmd_ptr[0];
-                    uint32_t cmd_byte = cmd_word >> 24;
-                    uint8_t cmd_size = gpu_cmd_size[cmd_byte];
-
-                    /* ── Variable-length commands (polylines, LoadImage, StoreImage) ── */
-                    if (cmd_size == 0)
-                    {
-                        Prim_FlushBatch();
-                        if (cmd_byte == 0xA0)
-                        {
-                            /* LoadImage: fast path if entire block fits in packet */
-                            uint32_t dims = cmd_ptr[2];
-                            uint32_t image_words = ((dims & 0xFFFF) * (dims >> 16)) / 2;
-                            if (3 + image_words <= count - i)
-                            {
-                                PROF_PUSH(PROF_GPU_UPLOAD);
-                                GS_UploadRegionFast(cmd_ptr[1], dims,
-                                                    (uint32_t *)(psx_ram + ((addr + 12) & 0x1FFFFC)),
-                                                    image_words);
-                                PROF_POP(PROF_GPU_UPLOAD);
-                                uint32_t skip = 3 + image_words;
-                                i += skip;
-                                addr = (addr + skip * 4) & 0x1FFFFC;
-                                continue;
-                            }
-                        }
-                        /* Polylines / fragmented LoadImage / StoreImage → word-by-word */
-                        while (i < count)
-                        {
-                            GPU_WriteGP0(*(uint32_t *)&psx_ram[addr]);
-                            i++;
-                            addr = (addr + 4) & 0x1FFFFC;
-                            if (gpu_cmd_remaining == 0 && gpu_transfer_words == 0 && !polyline_active)
-                                break;
-                        }
-                        continue;
-                    }
-
-                    /* ── Draw commands: polys, rects, lines, fill-rect (0x02-0x7F) ── */
-                    if (cmd_byte <= 0x7F)
-                    {
-                        int size = GPU_TryBatchAdd(cmd_ptr);
-                        if (size > 0)
-                        {
-                            i += size;
-                            addr = (addr + size * 4) & 0x1FFFFC;
-                            continue;
-                        }
-                        Prim_FlushBatch();
-                        size = GPU_TryFastEmit(cmd_ptr);
-                        if (size <= 0)
-                        {
-                            PROF_PUSH(PROF_GPU_PRIM);
-                            size = Translate_GP0_to_GS(cmd_ptr);
-                            PROF_POP(PROF_GPU_PRIM);
-                        }
-                        i += size;
-                        addr = (addr + size * 4) & 0x1FFFFC;
-                        continue;
-                    }
-
-                    /* ── VRAM-to-VRAM copy (0x80-0x9F): 4 words ── */
-                    if ((cmd_byte & 0xE0) == 0x80)
-                    {
-                        Prim_FlushBatch();
-                        if (i + 4 <= count)
-                        {
-                            GPU_WriteGP0(cmd_ptr[0]);
-                            GPU_WriteGP0(cmd_ptr[1]);
-                            GPU_WriteGP0(cmd_ptr[2]);
-                            GPU_WriteGP0(cmd_ptr[3]);
-                            i += 4;
-                            addr = (addr + 16) & 0x1FFFFC;
-                        }
-                        else
-                        {
-                            GPU_WriteGP0(cmd_word);
-                            i++;
-                            addr = (addr + 4) & 0x1FFFFC;
-                        }
-                        continue;
-                    }
-
-                    /* ── E1-E6 env commands, NOP, etc. ── */
-                    Prim_FlushBatch();
-                    GPU_WriteGP0(cmd_word);
-                    i++;
-                    addr = (addr + 4) & 0x1FFFFC;
-                }
+                uint32_t *words = (uint32_t *)&psx_ram[(addr + 4) & 0x1FFFFC];
+                if (queue)
+                    gpuq_push(words, count);
+                else
+                    dma_packet(words, count, reorder);
             }
 
             packets++;
@@ -294,18 +488,28 @@ int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr)
             addr = next & 0x1FFFFC;
         }
 
-        Prim_FlushBatch();
+        if (!queue)
+        {
+            GPU_ReorderFlush();
+            Prim_FlushBatch();
 
-        if (fast_gif_ptr != (gif_qword_t *)&gif_packet_buf[current_buffer][0])
-            Flush_GIF();
+            if (fast_gif_ptr != gif_buffer_start)
+                Flush_GIF();
+        }
+        if (capture)
+            GPU_ReplayCaptureEnd(gpu_estimated_pixels);
 
+    chain_cost:
         /* ── DMA bus + GPU processing cycle cost for linked-list ── */
         {
             uint64_t dma_cost = (uint64_t)total_dma_words * DMA_CYCLES_PER_WORD + (uint64_t)packets * DMA_CYCLES_PER_PACKET;
             uint64_t gpu_cost = gpu_estimated_pixels * GPU_CYCLES_PER_PIXEL;
             gpu_estimated_pixels = 0;
             global_cycles += dma_cost;
-            gpu_busy_until = global_cycles + gpu_cost;
+            if (queue)
+                gpuq_dma_end = global_cycles; /* cost added when drained */
+            else
+                gpu_busy_until = global_cycles + gpu_cost;
 
             DLOG("DMA2 linked-list: %d packets, %lu words, %llu pixels, dma=%llu gpu=%llu\n",
                  packets, (unsigned long)total_dma_words,
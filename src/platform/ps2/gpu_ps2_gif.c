@@ -1,8 +1,8 @@
 /**
  * gpu_gif.c — GIF buffer management and GS environment setup
  *
- * Handles the double-buffered GIF packet system that batches PSX GPU
- * commands into PS2 GS DMA transfers.  Also contains the one-time
+ * Handles the GIF packet ring that batches PSX GPU commands into PS2 GS
+ * source-chain DMA transfers.  Also contains the one-time
  * GS register initialisation (Setup_GS_Environment).
  */
 #include "gpu_ps2_state.h"
@@ -18,21 +18,86 @@ uint64_t cached_base_test = 0;
 
 /* ── GIF buffer management ───────────────────────────────────────── */
 
+/* Segment ring.  The counters only ever increase; a segment's slot is
+ * (counter % GIF_RING_SEGMENTS).
+ *   [gif_tail, gif_kick)  in flight: part of the chain the DMAC is running
+ *   [gif_kick, gif_head)  flushed, waiting for the channel to go idle
+ *   gif_head              being filled by the CPU
+ * A running chain cannot safely be extended (the DMAC may already have
+ * read its END tag), so pending segments are chained and sent whenever
+ * a flush finds the channel idle.  The CPU only waits when every
+ * segment is in use.
+ *
+ * A segment is a run of packet qwords under its head tag, unless
+ * GIF_PushRef() split it: each REF tag then closes the run before it
+ * (whose tag becomes CNT) and opens a new one, and gif_seg_run[] points
+ * at the last run's tag, which the kick links to the next segment. */
+#define GIF_TAG_ID_CNT 1
+#define GIF_TAG_ID_NEXT 2
+#define GIF_TAG_ID_REF 3
+#define GIF_TAG_ID_END 7
+#define GIF_CHCR_STR 0x100
+
+uint32_t gif_flush_count = 0;
+
+static uint32_t gif_head, gif_kick, gif_tail;
+static uint16_t gif_seg_qwc[GIF_RING_SEGMENTS];   /* qwords in the last run */
+static gif_qword_t *gif_seg_run[GIF_RING_SEGMENTS]; /* tag of the last run */
+static gif_qword_t *gif_run_tag;                    /* same, for gif_head */
+
+static inline gif_qword_t *gif_segment(uint32_t n)
+{
+    return (gif_qword_t *)&gif_packet_buf[n % GIF_RING_SEGMENTS][0];
+}
+
+static void gif_ring_open(void)
+{
+    gif_run_tag = gif_segment(gif_head);
+    gif_buffer_start = gif_run_tag + 1;
+    fast_gif_ptr = gif_buffer_start;
+    gif_buffer_end_safe = gif_segment(gif_head) + (GIF_BUFFER_SIZE - 1024);
+}
+
+/* Start the pending segments as one source chain if the channel is idle.
+ * Returns 1 if the channel was idle (everything before gif_kick done). */
+static int gif_ring_kick(void)
+{
+    if (*D2_CHCR & GIF_CHCR_STR)
+        return 0;
+    gif_tail = gif_kick;
+    if (gif_kick == gif_head)
+        return 1;
+
+    for (uint32_t n = gif_kick; n != gif_head; n++)
+    {
+        gif_qword_t *tag = gif_seg_run[n % GIF_RING_SEGMENTS];
+        uint64_t id = (n + 1 == gif_head) ? GIF_TAG_ID_END : GIF_TAG_ID_NEXT;
+        uint64_t next = (uintptr_t)gif_segment(n + 1) & 0x0FFFFFFF;
+        tag->d0 = gif_seg_qwc[n % GIF_RING_SEGMENTS] | (id << 28) | (next << 32);
+        tag->d1 = 0;
+        SyncDCache(tag, tag + 1);
+    }
+    dma_channel_send_chain(DMA_CHANNEL_GIF, gif_segment(gif_kick), 0, 0, 0);
+    gif_kick = gif_head;
+    return 1;
+}
+
 void Flush_GIF(void)
 {
-    gif_qword_t *base = (gif_qword_t *)&gif_packet_buf[current_buffer][0];
-    int qwc = fast_gif_ptr - base;
+    int qwc = fast_gif_ptr - gif_buffer_start;
 
     if (qwc > 0)
     {
-        /* When GPU rendering is disabled, discard the buffer contents
-         * without sending to GS.  Still swap buffers to keep the
-         * double-buffer state consistent. */
+        gpu_frame_stats.gif_qwords += (uint32_t)qwc;
+        if (gpu_replay_capturing)
+            GPU_ReplayCaptureSegment(gif_buffer_start, qwc);
+
+        /* When GPU rendering is disabled, discard the segment contents
+         * without sending to GS. */
         if (prof_disable_gpu_render)
         {
-            current_buffer ^= 1;
-            fast_gif_ptr = (gif_qword_t *)&gif_packet_buf[current_buffer][0];
-            gif_buffer_end_safe = fast_gif_ptr + (GIF_BUFFER_SIZE - 1024);
+            gif_run_tag = gif_buffer_start - 1;
+            fast_gif_ptr = gif_buffer_start;
             return;
         }
 
@@ -41,31 +106,62 @@ void Flush_GIF(void)
          * FlushCache(0) would invalidate the ENTIRE 8KB L1 dcache,
          * destroying hot JIT data (cpu struct, psx_ram, LUT) and
          * causing ~300+ cycles of dcache misses per call.
-         * SyncDCache writes back only dirty lines in the range. */
-        SyncDCache(base, (void *)((uintptr_t)base + (uint32_t)qwc * 16));
-
-        /* Async double-buffer: wait for PREVIOUS DMA to finish, then
-         * start THIS buffer's DMA and swap immediately.  The CPU can
-         * fill the other buffer while this DMA runs in parallel.
-         * On the first call the channel is idle → dma_wait_fast returns
-         * instantly.  Saves ~85K×500 cycles/sec of idle CPU stalls. */
-        dma_wait_fast();
-        dma_channel_send_normal(DMA_CHANNEL_GIF, base, qwc, 0, 0);
+         * SyncDCache writes back only dirty lines in the range, from
+         * the head tag on in case GIF_PushRef() made it a CNT. */
+        SyncDCache(gif_buffer_start - 1, (void *)((uintptr_t)gif_buffer_start + (uint32_t)qwc * 16));
+
+        /* Queue this segment and move on to the next one.  The DMA of
+         * earlier segments keeps running while the CPU fills it. */
+        gif_seg_qwc[gif_head % GIF_RING_SEGMENTS] = (uint16_t)(fast_gif_ptr - (gif_run_tag + 1));
+        gif_seg_run[gif_head % GIF_RING_SEGMENTS] = gif_run_tag;
+        gif_head++;
+        gif_flush_count++;
+        gif_ring_kick();
+
+        /* Backpressure: the next segment to fill is still in flight */
+        while (gif_head - gif_tail >= GIF_RING_SEGMENTS)
+        {
+            dma_wait_fast();
+            gif_ring_kick();
+        }
 
-        // Swap to other buffer — safe because dma_wait ensured it's done
-        current_buffer ^= 1;
-        fast_gif_ptr = (gif_qword_t *)&gif_packet_buf[current_buffer][0];
-        gif_buffer_end_safe = fast_gif_ptr + (GIF_BUFFER_SIZE - 1024);
+        gif_ring_open();
         PROF_POP(PROF_GPU_FLUSH);
     }
 }
 
-/* Synchronous flush: drain GIF buffer AND wait for DMA completion.
+/* Send qwc qwords at src to the GIF in place, between the packet
+ * qwords before and after it, without copying them into the ring.
+ * src must be 16-byte aligned, qwc <= 0xFFFF, and the memory must stay
+ * unchanged until the DMA has passed it (Flush_GIF_Sync).  Not for use
+ * while gpu_replay_capturing: the capture would store the tags. */
+void GIF_PushRef(const void *src, uint32_t qwc)
+{
+    gif_qword_t *ref = fast_gif_ptr;
+
+    gif_run_tag->d0 = (uint64_t)(ref - (gif_run_tag + 1)) | ((uint64_t)GIF_TAG_ID_CNT << 28);
+    gif_run_tag->d1 = 0;
+    ref->d0 = qwc | ((uint64_t)GIF_TAG_ID_REF << 28) |
+              ((uint64_t)((uintptr_t)src & 0x0FFFFFFF) << 32);
+    ref->d1 = 0;
+    SyncDCache((void *)src, (void *)((uintptr_t)src + qwc * 16));
+
+    gpu_frame_stats.gif_qwords += qwc;
+    gif_run_tag = ref + 1;
+    fast_gif_ptr = ref + 2;
+}
+
+/* Synchronous flush: drain the GIF ring AND wait for DMA completion.
  * Required before directly using the GIF DMA channel (e.g. VRAM readback)
  * or when GS must have processed all prior commands. */
 void Flush_GIF_Sync(void)
 {
     Flush_GIF();
+    while (gif_tail != gif_head)
+    {
+        dma_wait_fast();
+        gif_ring_kick();
+    }
     dma_wait_fast();
 }
 
@@ -74,8 +170,7 @@ void Flush_GIF_Sync(void)
 void Setup_GS_Environment(void)
 {
     // Setup GIF pointer initially
-    fast_gif_ptr = (gif_qword_t *)&gif_packet_buf[current_buffer][0];
-    gif_buffer_end_safe = fast_gif_ptr + (GIF_BUFFER_SIZE - 1024);
+    gif_ring_open();
 
     // Setup GS registers like draw_setup_environment does
     // This mimics what libdraw does
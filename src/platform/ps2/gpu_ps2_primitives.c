@@ -94,6 +94,50 @@ static inline uint64_t Compute_TexWin_Clamp(void)
     return GS_SET_CLAMP(3, 3, minu, maxu, minv, maxv); /* REGION_REPEAT */
 }
 
+/* PSX dithering (E1h bit 9) applies to gouraud and texture-modulated
+ * polygons only; DIMX holds the PSX 4x4 matrix from GS init on */
+static inline int prim_use_dither(int is_shaded, int is_textured, int is_raw_tex)
+{
+    return dither_enabled && (is_shaded || (is_textured && !is_raw_tex));
+}
+
+/* A+D PRIM, preceded by DTHE when gs_state holds the other value.
+ * DTHE is not part of the command keys, so the fast paths and batch
+ * sub-PRIMs switch it here instead of going cold.  want_dthe < 0
+ * leaves it as it is. */
+static inline void emit_prim_dthe(uint64_t prim_packed, int want_dthe)
+{
+    if (want_dthe >= 0 && gs_state.dthe != want_dthe)
+    {
+        Push_GIF_Tag(GIF_TAG_LO(2, 0, 0, 0, 0, 1), GIF_REG_AD);
+        Push_GIF_Data((uint64_t)want_dthe, GS_REG_DTHE);
+        gs_state.dthe = want_dthe;
+        gpu_frame_stats.gs_state_written++;
+    }
+    else
+        Push_GIF_Tag(GIF_TAG_LO(1, 0, 0, 0, 0, 1), GIF_REG_AD);
+    Push_GIF_Data(prim_packed, GS_REG_PRIM);
+}
+
+/* 15BPP under a texture window: sample the VRAM mirror through a TEX0
+ * based at the texture page (64×64 CT16S pages, TBP0 in 256-byte blocks)
+ * with page-relative U/V, so REGION_REPEAT applies the window per texel
+ * instead of only at the vertices.  A page closer than 256 halfwords to
+ * the right edge of VRAM would run past TBW, so those keep the absolute
+ * view and the per-vertex Apply_Tex_Window. */
+static inline int Tex15_PageView(int page_x)
+{
+    return (tex_win_mask_x != 0 || tex_win_mask_y != 0) &&
+           page_x <= PSX_VRAM_WIDTH - 256;
+}
+
+static inline uint64_t Tex15_PageTex0(int page_x, int page_y, int is_raw)
+{
+    int tbp0 = ((page_y / 64) * PSX_VRAM_FBW + page_x / 64) * 32;
+    return GS_SET_TEX0(tbp0, PSX_VRAM_FBW, PSX_VRAM_PSM, 8, 8,
+                       1, (is_raw ? 1 : 0), 0, 0, 0, 0, 0);
+}
+
 /* Invalidate primitive texture cache (called on VRAM writes) */
 void Prim_InvalidateTexCache(void)
 {
@@ -386,7 +430,7 @@ static void emit_poly_state_and_verts(
     int is_textured = (cmd & 0x04) != 0;
     int is_semi_trans = (cmd & 0x02) != 0;
     int is_raw_tex = is_textured && (cmd & 0x01);
-    int use_dither = dither_enabled && (is_shaded || (is_textured && !is_raw_tex));
+    int use_dither = prim_use_dither(is_shaded, is_textured, is_raw_tex);
 
     uint64_t prim_reg = gs_prim_type;
     if (is_shaded)
@@ -405,6 +449,7 @@ static void emit_poly_state_and_verts(
     int cache_hit = 0;
     int csm = 0;
     int clut_x = 0, clut_y = 0;
+    int tex15_page = 0;
 
     if (is_textured)
     {
@@ -446,16 +491,18 @@ static void emit_poly_state_and_verts(
         {
             clut_decoded = 1;
         }
+        tex15_page = !clut_decoded && Tex15_PageView(poly_tex_page_x);
     }
 
     /* ── Deferred State: fast-path when cmd attributes + cache unchanged ── */
-    int cmd_key = is_raw_tex | (use_dither << 1) | (is_semi_trans << 2) | (semi_trans_mode << 3) | (is_textured << 5);
+    int cmd_key = is_raw_tex | (is_semi_trans << 2) | (semi_trans_mode << 3) | (is_textured << 5);
     int state_fast = 0;
     if (gs_state.valid && cmd_key == gs_state.last_cmd_key)
     {
         if (!is_textured)
-            state_fast = 1; /* untextured: dthe+alpha fully determined by cmd_key */
-        else if (cache_hit && prim_tex_cache_last == gs_state.last_cache_slot)
+            state_fast = 1; /* untextured: alpha fully determined by cmd_key */
+        else if (cache_hit && prim_tex_cache_last == gs_state.last_cache_slot &&
+                 gs_state.tex_window == raw_tex_window)
         {
             /* CSM2: page-only cache means same slot can serve different CLUTs.
              * Must also verify TEXCLUT hasn't changed. */
@@ -473,12 +520,16 @@ static void emit_poly_state_and_verts(
     }
 
     int state_qws = 0;
+    /* State registers an eager emitter would write for this command */
+    int state_regs = 1 + is_semi_trans +
+                     (is_textured ? 2 + (hw_clut || !clut_decoded) + (hw_clut && csm) : 0);
 
     if (state_fast)
     {
-        /* All state registers match gs_state → emit only PRIM (1 QW) */
-        Push_GIF_Tag(GIF_TAG_LO(1, 0, 0, 0, 0, 1), GIF_REG_AD);
-        Push_GIF_Data(GS_PACK_PRIM_FROM_INT(prim_reg), GS_REG_PRIM);
+        /* All state registers but DTHE match gs_state → emit PRIM (1 QW),
+         * plus DTHE if dithering changed */
+        gpu_frame_stats.gs_state_skipped += state_regs - (gs_state.dthe != use_dither);
+        emit_prim_dthe(GS_PACK_PRIM_FROM_INT(prim_reg), use_dither);
     }
     else
     {
@@ -527,6 +578,11 @@ static void emit_poly_state_and_verts(
                 }
                 need_texflush = !cache_hit;
             }
+            else if (tex15_page)
+            {
+                want_tex0 = Tex15_PageTex0(poly_tex_page_x, poly_tex_page_y, is_raw_tex);
+                want_clamp = Compute_TexWin_Clamp();
+            }
             else
             {
                 /* Non-CLUT 15BPP: default VRAM view */
@@ -540,7 +596,10 @@ static void emit_poly_state_and_verts(
         int emit_alpha = (is_semi_trans && (!gs_state.valid || gs_state.alpha != want_alpha));
         int emit_tex0 = (is_textured && (!gs_state.valid || gs_state.tex0 != want_tex0 || need_texflush));
         int emit_test = (is_textured && (!gs_state.valid || gs_state.test != want_test));
-        int emit_clamp = (is_textured && hw_clut && (!gs_state.valid || gs_state.clamp != want_clamp));
+        /* 15BPP sets CLAMP too: a REGION_REPEAT left by a CLUT page would
+         * otherwise apply to the absolute VRAM view */
+        int track_clamp = hw_clut || !clut_decoded;
+        int emit_clamp = (is_textured && track_clamp && (!gs_state.valid || gs_state.clamp != want_clamp));
         int emit_texclut = (is_textured && hw_clut && csm &&
                             (!gs_state.valid || gs_state.texclut != want_texclut));
 
@@ -552,6 +611,8 @@ static void emit_poly_state_and_verts(
             emit_tex0 = 1;
 
         state_qws = emit_dthe + emit_alpha + emit_tex0 + (emit_tex0 && need_texflush) + emit_test + emit_clamp + emit_texclut;
+        gpu_frame_stats.gs_state_written += state_qws;
+        gpu_frame_stats.gs_state_skipped += state_regs - (state_qws - (emit_tex0 && need_texflush));
 
         /* ── A+D tag: State + PRIM (EOP=0) ── */
         Push_GIF_Tag(GIF_TAG_LO(state_qws + 1, 0, 0, 0, 0, 1), GIF_REG_AD);
@@ -593,12 +654,10 @@ static void emit_poly_state_and_verts(
         {
             gs_state.tex0 = want_tex0;
             gs_state.test = want_test;
-            if (hw_clut)
-            {
+            if (track_clamp)
                 gs_state.clamp = want_clamp;
-                if (csm)
-                    gs_state.texclut = want_texclut;
-            }
+            if (hw_clut && csm)
+                gs_state.texclut = want_texclut;
         }
         gs_state.valid = 1;
 
@@ -607,7 +666,10 @@ static void emit_poly_state_and_verts(
     /* Update deferred-state keys for next fast-path check */
     gs_state.last_cmd_key = cmd_key;
     if (is_textured)
+    {
         gs_state.last_cache_slot = prim_tex_cache_last;
+        gs_state.tex_window = raw_tex_window;
+    }
 
     /* ── REGLIST vertex packet: FLG=1, no PRE ── */
     {
@@ -642,6 +704,11 @@ static void emit_poly_state_and_verts(
                     u = (verts[i].uv & 0xFF) + uv_off_u;
                     v_coord = ((verts[i].uv >> 8) & 0xFF) + uv_off_v;
                 }
+                else if (tex15_page)
+                {
+                    u = verts[i].uv & 0xFF;
+                    v_coord = (verts[i].uv >> 8) & 0xFF;
+                }
                 else
                 {
                     u = Apply_Tex_Window_U(verts[i].uv & 0xFF) + poly_tex_page_x;
@@ -692,36 +759,51 @@ static void emit_poly_state_and_verts(
 }
 
 /* ═══════════════════════════════════════════════════════════════════
- *  Triangle Batch Accumulator
+ *  Primitive Batch Accumulator
  *
- *  Collects consecutive triangles with the same vertex format and
- *  emits them as REGLIST GIF tags.  Allows cross-type batching:
- *  GP0.34h (opaque tex) ↔ GP0.36h (semi-trans tex) share the same
- *  vertex format — only PRIM.ABE differs.  PRIM switch points are
- *  recorded and emitted as separate PRIM+REGLIST pairs at flush time.
+ *  Collects consecutive primitives of one kind with the same vertex
+ *  format and emits them as REGLIST GIF tags:
+ *    polygons  (GP0 0x20-0x3F) — TRIANGLE, quads split into 2 triangles
+ *    lines     (GP0 0x40-0x47, 0x50-0x57) — LINE
+ *    rectangles (GP0 0x60-0x7F) — SPRITE
+ *  PRIM differences inside a batch (e.g. GP0.34h opaque tex ↔ GP0.36h
+ *  semi-trans tex, or flat ↔ shaded lines) don't break it: PRIM switch
+ *  points are recorded and emitted as separate PRIM+REGLIST pairs at
+ *  flush time.
  *
- *  Only handles non-quad polygons (GP0 0x20-0x3F without bit 3).
- *  Quads use TRISTRIP mode which can't stack without PRIM reset.
+ *  Quads are split rather than sent as TRISTRIP: consecutive strips
+ *  can't stack without a PRIM reset, and (v0,v1,v2)+(v1,v2,v3) is what
+ *  the GS rasterises for a 4-vertex strip anyway.
  * ═══════════════════════════════════════════════════════════════════ */
 #define BATCH_MAX_TRIS 128
 #define BATCH_MAX_SUBS 32
+#define BATCH_MAX_REGS (BATCH_MAX_TRIS * 3 * 3) /* 3 regs/vert × 3 verts × N tris */
+
+enum
+{
+    BATCH_KIND_POLY,
+    BATCH_KIND_LINE,
+    BATCH_KIND_SPRITE,
+};
 
 typedef struct {
     int vert_start;        /* first vertex index for this sub-batch */
     int reg_start;         /* first index in data[] */
     uint64_t prim_packed;  /* PRIM register value */
+    int dthe;              /* DTHE for this sub-batch, -1 = leave as set */
 } BatchSub;
 
 static struct {
-    uint64_t data[BATCH_MAX_TRIS * 3 * 3]; /* max 3 regs/vert × 3 verts × N tris */
+    uint64_t data[BATCH_MAX_REGS];
     BatchSub subs[BATCH_MAX_SUBS];
     int sub_count;
     int reg_count;
     int vert_count;
-    int tri_count;
+    int prim_count;
     int nreg;
     uint64_t regs_field;
     uint32_t pixels;
+    uint8_t kind;
     uint8_t cmd_byte;
     uint8_t active;
     /* Cached state for quick continuation match (format key, ignoring semi-trans) */
@@ -734,19 +816,76 @@ static struct {
     int32_t ox, oy;
 } batch;
 
-static int batch_add_tri(uint32_t *psx_cmd, uint32_t cmd)
+static void batch_begin(int kind, uint32_t cmd, int nreg, uint64_t regs_field,
+                        uint64_t prim_packed, int dthe)
+{
+    batch.kind = (uint8_t)kind;
+    batch.nreg = nreg;
+    batch.regs_field = regs_field;
+    batch.cmd_byte = cmd;
+    batch.active = 1;
+    batch.reg_count = 0;
+    batch.vert_count = 0;
+    batch.prim_count = 0;
+    batch.pixels = 0;
+    batch.sub_count = 1;
+    batch.subs[0].vert_start = 0;
+    batch.subs[0].reg_start = 0;
+    batch.subs[0].prim_packed = prim_packed;
+    batch.subs[0].dthe = dthe;
+    batch.ox = draw_offset_x + 2048;
+    batch.oy = draw_offset_y + 2048;
+}
+
+/* Start a new PRIM sub-batch at the current vertex.  Returns 0 when
+ * the sub-batch table is full (caller flushes). */
+static int batch_new_sub(uint64_t prim_packed, int dthe)
+{
+    if (batch.sub_count >= BATCH_MAX_SUBS)
+        return 0;
+    batch.subs[batch.sub_count].vert_start = batch.vert_count;
+    batch.subs[batch.sub_count].reg_start  = batch.reg_count;
+    batch.subs[batch.sub_count].prim_packed = prim_packed;
+    batch.subs[batch.sub_count].dthe = dthe;
+    batch.sub_count++;
+    return 1;
+}
+
+static inline uint64_t batch_poly_prim(uint32_t cmd)
+{
+    uint64_t prim_reg = 3; /* TRIANGLE */
+    if (cmd & 0x10)  prim_reg |= (1 << 3);
+    if (cmd & 0x04) { prim_reg |= (1 << 4); prim_reg |= (1 << 8); }
+    if (cmd & 0x02)  prim_reg |= (1 << 6);
+    return GS_PACK_PRIM_FROM_INT(prim_reg);
+}
+
+static inline uint64_t batch_sprite_prim(uint32_t cmd)
+{
+    uint64_t prim_reg = 6; /* SPRITE */
+    if (cmd & 0x04) { prim_reg |= (1 << 4); prim_reg |= (1 << 8); }
+    if (cmd & 0x02)  prim_reg |= (1 << 6);
+    return GS_PACK_PRIM_FROM_INT(prim_reg);
+}
+
+static int batch_add_poly(uint32_t *psx_cmd, uint32_t cmd)
 {
+    int is_quad     = (cmd & 0x08) != 0;
     int is_shaded   = (cmd & 0x10) != 0;
     int is_textured = (cmd & 0x04) != 0;
+    int num_verts   = is_quad ? 4 : 3;
+    int nreg        = batch.nreg;
 
     uint32_t color = psx_cmd[0] & 0xFFFFFF;
     uint64_t flat_rgbaq = 0;
     if (!is_shaded)
         flat_rgbaq = GS_SET_RGBAQ(color & 0xFF, (color >> 8) & 0xFF,
                                   (color >> 16) & 0xFF, 0x80, 0x3F800000);
+    uint64_t vdata[12]; /* max 4 verts × 3 regs */
+    int vc = 0;
     int idx = 1;
 
-    for (int v = 0; v < 3; v++) {
+    for (int v = 0; v < num_verts; v++) {
         uint32_t c;
         if (v == 0)
             c = color;
@@ -761,28 +900,35 @@ static int batch_add_tri(uint32_t *psx_cmd, uint32_t cmd)
 
         if (is_textured) {
             uint32_t uv_word = psx_cmd[idx++];
-            uint32_t u, vc;
+            uint32_t u, vcoord;
             if (batch.clut_decoded) {
                 u = (uv_word & 0xFF) + batch.uv_off_u;
-                vc = ((uv_word >> 8) & 0xFF) + batch.uv_off_v;
+                vcoord = ((uv_word >> 8) & 0xFF) + batch.uv_off_v;
             } else {
                 u = Apply_Tex_Window_U(uv_word & 0xFF) + batch.batch_tex_page_x;
-                vc = Apply_Tex_Window_V((uv_word >> 8) & 0xFF) + batch.batch_tex_page_y;
+                vcoord = Apply_Tex_Window_V((uv_word >> 8) & 0xFF) + batch.batch_tex_page_y;
             }
-            batch.data[batch.reg_count++] = GS_SET_XYZ(u << 4, vc << 4, 0);
+            vdata[vc++] = GS_SET_XYZ(u << 4, vcoord << 4, 0);
         }
 
-        batch.data[batch.reg_count++] = is_shaded
+        vdata[vc++] = is_shaded
             ? GS_SET_RGBAQ(c & 0xFF, (c >> 8) & 0xFF, (c >> 16) & 0xFF, 0x80, 0x3F800000)
             : flat_rgbaq;
 
-        batch.data[batch.reg_count++] = GS_SET_XYZ(
+        vdata[vc++] = GS_SET_XYZ(
             ((int32_t)px + batch.ox) << 4,
             ((int32_t)py + batch.oy) << 4, 0);
     }
 
-    batch.vert_count += 3;
-    batch.tri_count++;
+    /* Triangle (v0,v1,v2), then (v1,v2,v3) for quads */
+    for (int i = 0; i < 3 * nreg; i++)
+        batch.data[batch.reg_count++] = vdata[i];
+    if (is_quad)
+        for (int i = nreg; i < 4 * nreg; i++)
+            batch.data[batch.reg_count++] = vdata[i];
+
+    batch.vert_count += is_quad ? 6 : 3;
+    batch.prim_count++;
 
     /* Pixel area estimation */
     {
@@ -797,6 +943,13 @@ static int batch_add_tri(uint32_t *psx_cmd, uint32_t cmd)
         int16_t x2 = (int16_t)((int32_t)((psx_cmd[v2_idx] & 0xFFFF) << 21) >> 21);
         int16_t y2 = (int16_t)((int32_t)((psx_cmd[v2_idx] >> 16) << 21) >> 21);
         batch.pixels += tri_area_abs(x0, y0, x1, y1, x2, y2);
+        if (is_quad) {
+            int v3_idx = v2_idx + 1 + (is_textured ? 1 : 0);
+            if (is_shaded) v3_idx++;
+            int16_t x3 = (int16_t)((int32_t)((psx_cmd[v3_idx] & 0xFFFF) << 21) >> 21);
+            int16_t y3 = (int16_t)((int32_t)((psx_cmd[v3_idx] >> 16) << 21) >> 21);
+            batch.pixels += tri_area_abs(x1, y1, x3, y3, x2, y2);
+        }
     }
 
     /* Frame stats */
@@ -810,7 +963,7 @@ static int batch_add_tri(uint32_t *psx_cmd, uint32_t cmd)
 
 void Prim_FlushBatch(void)
 {
-    if (!batch.active || batch.tri_count == 0) return;
+    if (!batch.active || batch.prim_count == 0) return;
 
     /* Emit each sub-batch as PRIM + REGLIST */
     for (int s = 0; s < batch.sub_count; s++) {
@@ -828,13 +981,12 @@ void Prim_FlushBatch(void)
         int r_count = r_end - r_start;
 
         int data_qwords = (r_count + 1) / 2;
-        int total_need = 3 + data_qwords;
+        int total_need = 4 + data_qwords;
 
         if (fast_gif_ptr + total_need >= gif_buffer_end_safe)
             Flush_GIF();
 
-        Push_GIF_Tag(GIF_TAG_LO(1, 0, 0, 0, 0, 1), GIF_REG_AD);
-        Push_GIF_Data(batch.subs[s].prim_packed, GS_REG_PRIM);
+        emit_prim_dthe(batch.subs[s].prim_packed, batch.subs[s].dthe);
 
         Push_GIF_Tag(GIF_TAG_LO(v_count, 1, 0, 0, 1, batch.nreg),
                      batch.regs_field);
@@ -850,36 +1002,30 @@ void Prim_FlushBatch(void)
     batch.active = 0;
     batch.reg_count = 0;
     batch.vert_count = 0;
-    batch.tri_count = 0;
+    batch.prim_count = 0;
     batch.pixels = 0;
 }
 
-int GPU_TryBatchAdd(uint32_t *psx_cmd)
+static int batch_try_poly(uint32_t *psx_cmd, uint32_t cmd)
 {
-    uint32_t cmd_word = psx_cmd[0];
-    uint32_t cmd = (cmd_word >> 24) & 0xFF;
-
-    /* Only batch non-quad triangles (GP0 0x20-0x3F, bit3=0) */
-    if ((cmd & 0xE0) != 0x20 || (cmd & 0x08))
-        return 0;
-
     int is_shaded     = (cmd & 0x10) != 0;
     int is_textured   = (cmd & 0x04) != 0;
     int is_semi_trans  = (cmd & 0x02) != 0;
     int is_raw_tex    = is_textured && (cmd & 0x01);
-    int use_dither    = dither_enabled && (is_shaded || (is_textured && !is_raw_tex));
-    int cmd_key = is_raw_tex | (use_dither << 1) | (is_semi_trans << 2) |
+    int use_dither    = prim_use_dither(is_shaded, is_textured, is_raw_tex);
+    int cmd_key = is_raw_tex | (is_semi_trans << 2) |
                   (semi_trans_mode << 3) | (is_textured << 5);
     /* Format key: cmd_key without the semi-transparency enable bit (bit 2).
      * Commands differing only in ABE have the same vertex layout. */
     int fmt_key = cmd_key & ~0x04;
 
-    /* ── Continuation: relaxed match (allow ABE to differ) ── */
+    /* ── Continuation: relaxed match (allow ABE and tri/quad to differ) ── */
     if (batch.active) {
-        /* Hard break: different vertex format, texpage, or buffer full */
-        if (((cmd ^ batch.cmd_byte) & 0xFD) != 0 ||
+        /* Hard break: different kind, vertex format, texpage, or buffer full */
+        if (batch.kind != BATCH_KIND_POLY ||
+            ((cmd ^ batch.cmd_byte) & 0xF5) != 0 ||
             fmt_key != batch.fmt_key ||
-            batch.tri_count >= BATCH_MAX_TRIS) {
+            batch.reg_count + 6 * batch.nreg > BATCH_MAX_REGS) {
             Prim_FlushBatch();
             goto start_new;
         }
@@ -916,26 +1062,17 @@ int GPU_TryBatchAdd(uint32_t *psx_cmd)
                 gpu_stat &= ~0x8000;
         }
 
-        /* ABE changed? → start new sub-batch (not a full flush) */
-        if ((cmd & 0x02) != (batch.cmd_byte & 0x02)) {
-            if (batch.sub_count >= BATCH_MAX_SUBS) {
+        /* ABE or dithering changed? → start new sub-batch (not a full flush) */
+        if ((cmd & 0x02) != (batch.cmd_byte & 0x02) ||
+            use_dither != batch.subs[batch.sub_count - 1].dthe) {
+            if (!batch_new_sub(batch_poly_prim(cmd), use_dither)) {
                 Prim_FlushBatch();
                 goto start_new;
             }
-            /* Build new PRIM with updated ABE */
-            uint64_t prim_reg = 3; /* TRIANGLE */
-            if (is_shaded)    prim_reg |= (1 << 3);
-            if (is_textured) { prim_reg |= (1 << 4); prim_reg |= (1 << 8); }
-            if (is_semi_trans) prim_reg |= (1 << 6);
-
-            batch.subs[batch.sub_count].vert_start = batch.vert_count;
-            batch.subs[batch.sub_count].reg_start  = batch.reg_count;
-            batch.subs[batch.sub_count].prim_packed = GS_PACK_PRIM_FROM_INT(prim_reg);
-            batch.sub_count++;
             batch.cmd_byte = cmd;
         }
 
-        return batch_add_tri(psx_cmd, cmd);
+        return batch_add_poly(psx_cmd, cmd);
     }
 
 start_new:
@@ -975,6 +1112,10 @@ start_new:
                                                    clut_x / 16, clut_y);
             if (gs_state.texclut != this_texclut) return 0;
         }
+        if (gs_state.tex_window != raw_tex_window)
+            return 0;
+        if (PTCACHE.result == 0 && Tex15_PageView(poly_tex_page_x))
+            return 0; /* windowed 15BPP: per-page TEX0, cold path */
 
         gpu_frame_stats.texcache_hit++;
         int result = PTCACHE.result;
@@ -1008,32 +1149,258 @@ start_new:
         batch.uv_off_v = uv_off_v;
     }
 
-    /* Build PRIM register */
-    uint64_t prim_reg = 3; /* TRIANGLE */
-    if (is_shaded)    prim_reg |= (1 << 3);
-    if (is_textured) { prim_reg |= (1 << 4); prim_reg |= (1 << 8); }
+    batch_begin(BATCH_KIND_POLY, cmd, is_textured ? 3 : 2,
+                is_textured
+                    ? ((uint64_t)GIF_REG_UV | ((uint64_t)GIF_REG_RGBAQ << 4) |
+                       ((uint64_t)GIF_REG_XYZ2 << 8))
+                    : ((uint64_t)GIF_REG_RGBAQ | ((uint64_t)GIF_REG_XYZ2 << 4)),
+                batch_poly_prim(cmd), use_dither);
+    batch.fmt_key = fmt_key;
+
+    return batch_add_poly(psx_cmd, cmd);
+}
+
+/* Lines: same vertex order rules as Emit_Line_Segment_AD.  Polylines
+ * stay on the GP0 word path.  Semi-transparent lines only batch once
+ * ALPHA_1 already holds the current mode (the fast path sets it). */
+static int batch_try_line(uint32_t *psx_cmd, uint32_t cmd)
+{
+    if (cmd & 0x08)
+        return 0;
+
+    int is_shaded     = (cmd & 0x10) != 0;
+    int is_semi_trans  = (cmd & 0x02) != 0;
+
+    if (is_semi_trans && gs_state.alpha != Get_Alpha_Reg(semi_trans_mode))
+        return 0;
+
+    uint64_t prim_reg = 1; /* LINE */
+    if (is_shaded)     prim_reg |= (1 << 3);
     if (is_semi_trans) prim_reg |= (1 << 6);
+    uint64_t prim_packed = GS_PACK_PRIM_FROM_INT(prim_reg);
+
+    if (batch.active &&
+        (batch.kind != BATCH_KIND_LINE || batch.reg_count + 4 > BATCH_MAX_REGS))
+        Prim_FlushBatch();
+    if (!batch.active) {
+        batch_begin(BATCH_KIND_LINE, cmd, 2,
+                    (uint64_t)GIF_REG_RGBAQ | ((uint64_t)GIF_REG_XYZ2 << 4),
+                    prim_packed, -1);
+    } else if (prim_packed != batch.subs[batch.sub_count - 1].prim_packed &&
+               !batch_new_sub(prim_packed, -1)) {
+        Prim_FlushBatch();
+        batch_begin(BATCH_KIND_LINE, cmd, 2,
+                    (uint64_t)GIF_REG_RGBAQ | ((uint64_t)GIF_REG_XYZ2 << 4),
+                    prim_packed, -1);
+    }
 
-    batch.nreg = is_textured ? 3 : 2;
-    batch.regs_field = is_textured
-        ? ((uint64_t)GIF_REG_UV | ((uint64_t)GIF_REG_RGBAQ << 4) |
-           ((uint64_t)GIF_REG_XYZ2 << 8))
-        : ((uint64_t)GIF_REG_RGBAQ | ((uint64_t)GIF_REG_XYZ2 << 4));
-    batch.cmd_byte = cmd;
-    batch.fmt_key = fmt_key;
-    batch.active = 1;
-    batch.reg_count = 0;
-    batch.vert_count = 0;
-    batch.tri_count = 0;
-    batch.pixels = 0;
-    batch.sub_count = 1;
-    batch.subs[0].vert_start = 0;
-    batch.subs[0].reg_start = 0;
-    batch.subs[0].prim_packed = GS_PACK_PRIM_FROM_INT(prim_reg);
-    batch.ox = draw_offset_x + 2048;
-    batch.oy = draw_offset_y + 2048;
+    uint32_t color0 = psx_cmd[0] & 0xFFFFFF;
+    int idx = 1;
+    uint32_t xy0 = psx_cmd[idx++];
+    uint32_t color1 = color0;
+    if (is_shaded)
+        color1 = psx_cmd[idx++] & 0xFFFFFF;
+    uint32_t xy1 = psx_cmd[idx++];
+    int16_t x0 = (int16_t)(xy0 & 0xFFFF), y0 = (int16_t)(xy0 >> 16);
+    int16_t x1 = (int16_t)(xy1 & 0xFFFF), y1 = (int16_t)(xy1 >> 16);
+
+    /* GS V0 = PSX start (lower Y, then lower X); the end pixel is not drawn */
+    if (y0 > y1 || (y0 == y1 && x0 > x1)) {
+        int16_t tx = x0; x0 = x1; x1 = tx;
+        int16_t ty = y0; y0 = y1; y1 = ty;
+        uint32_t tc = color0; color0 = color1; color1 = tc;
+    }
+
+    batch.data[batch.reg_count++] = GS_SET_RGBAQ(color0 & 0xFF, (color0 >> 8) & 0xFF,
+                                                 (color0 >> 16) & 0xFF, 0x80, 0x3F800000);
+    batch.data[batch.reg_count++] = GS_SET_XYZ(((int32_t)x0 + batch.ox) << 4,
+                                               ((int32_t)y0 + batch.oy) << 4, 0);
+    batch.data[batch.reg_count++] = GS_SET_RGBAQ(color1 & 0xFF, (color1 >> 8) & 0xFF,
+                                                 (color1 >> 16) & 0xFF, 0x80, 0x3F800000);
+    batch.data[batch.reg_count++] = GS_SET_XYZ(((int32_t)x1 + batch.ox) << 4,
+                                               ((int32_t)y1 + batch.oy) << 4, 0);
+    batch.vert_count += 2;
+    batch.prim_count++;
+
+    gpu_frame_stats.line++;
+    return idx;
+}
+
+static int batch_add_sprite(uint32_t *psx_cmd, uint32_t cmd)
+{
+    int is_textured = (cmd & 0x04) != 0;
+    int size_mode   = (cmd >> 3) & 3;
+
+    uint32_t color = psx_cmd[0] & 0xFFFFFF;
+    int idx = 1;
+
+    uint32_t xy = psx_cmd[idx++];
+    int16_t x = (int16_t)((int32_t)((xy & 0xFFFF) << 21) >> 21);
+    int16_t y = (int16_t)((int32_t)((xy >> 16) << 21) >> 21);
+
+    uint32_t uv_clut = 0;
+    if (is_textured)
+        uv_clut = psx_cmd[idx++];
+
+    int w, h;
+    if (size_mode == 0)
+    {
+        uint32_t wh = psx_cmd[idx++];
+        w = wh & 0x3FF;
+        h = (wh >> 16) & 0x1FF;
+    }
+    else
+    {
+        if (size_mode == 1) { w = 1; h = 1; }
+        else if (size_mode == 2) { w = 8; h = 8; }
+        else { w = 16; h = 16; }
+    }
+
+    uint64_t rgbaq = GS_SET_RGBAQ(color & 0xFF, (color >> 8) & 0xFF, (color >> 16) & 0xFF, 0x80, 0x3F800000);
+    int32_t gx0 = ((int32_t)x + batch.ox) << 4;
+    int32_t gy0 = ((int32_t)y + batch.oy) << 4;
+    int32_t gx1 = ((int32_t)(x + w) + batch.ox) << 4;
+    int32_t gy1 = ((int32_t)(y + h) + batch.oy) << 4;
 
-    return batch_add_tri(psx_cmd, cmd);
+    if (is_textured)
+    {
+        uint32_t u0_cmd = uv_clut & 0xFF;
+        uint32_t v0_cmd = (uv_clut >> 8) & 0xFF;
+        uint32_t u0_gs, v0_gs;
+        if (batch.clut_decoded)
+        {
+            u0_gs = batch.uv_off_u + u0_cmd;
+            v0_gs = batch.uv_off_v + v0_cmd;
+        }
+        else
+        {
+            u0_gs = Apply_Tex_Window_U(u0_cmd) + batch.batch_tex_page_x;
+            v0_gs = Apply_Tex_Window_V(v0_cmd) + batch.batch_tex_page_y;
+        }
+        batch.data[batch.reg_count++] = GS_SET_XYZ(u0_gs << 4, v0_gs << 4, 0);
+        batch.data[batch.reg_count++] = rgbaq;
+        batch.data[batch.reg_count++] = GS_SET_XYZ(gx0, gy0, 0);
+        batch.data[batch.reg_count++] = GS_SET_XYZ((u0_gs + w) << 4, (v0_gs + h) << 4, 0);
+        gpu_frame_stats.rect_tex++;
+    }
+    else
+    {
+        batch.data[batch.reg_count++] = rgbaq;
+        batch.data[batch.reg_count++] = GS_SET_XYZ(gx0, gy0, 0);
+        gpu_frame_stats.rect_flat++;
+    }
+    batch.data[batch.reg_count++] = rgbaq;
+    batch.data[batch.reg_count++] = GS_SET_XYZ(gx1, gy1, 0);
+
+    batch.vert_count += 2;
+    batch.prim_count++;
+    batch.pixels += (uint32_t)w * (uint32_t)h;
+    return idx;
+}
+
+/* Rectangles: start conditions match the GPU_TryFastEmit rectangle path
+ * (the cold path has set up the GS state for this command key). */
+static int batch_try_sprite(uint32_t *psx_cmd, uint32_t cmd)
+{
+    int is_textured   = (cmd & 0x04) != 0;
+    int is_semi_trans  = (cmd & 0x02) != 0;
+    int is_raw_tex    = is_textured && (cmd & 0x01);
+    uint32_t uv_clut  = is_textured ? psx_cmd[2] : 0;
+    int clut_x = ((uv_clut >> 16) & 0x3F) * 16;
+    int clut_y = (uv_clut >> 22) & 0x1FF;
+
+    if (batch.active) {
+        /* Same command (modulo ABE) and CLUT; the texpage is GP0 E1h
+         * state, which flushes the batch when written */
+        if (batch.kind != BATCH_KIND_SPRITE ||
+            ((cmd ^ batch.cmd_byte) & 0xFD) != 0 ||
+            batch.reg_count + 2 * batch.nreg > BATCH_MAX_REGS ||
+            (is_textured && (clut_x != batch.batch_clut_x || clut_y != batch.batch_clut_y))) {
+            Prim_FlushBatch();
+            goto start_new;
+        }
+
+        if ((cmd & 0x02) != (batch.cmd_byte & 0x02)) {
+            if (!batch_new_sub(batch_sprite_prim(cmd), 0)) {
+                Prim_FlushBatch();
+                goto start_new;
+            }
+            batch.cmd_byte = cmd;
+        }
+
+        return batch_add_sprite(psx_cmd, cmd);
+    }
+
+start_new:
+    if (!gs_state.valid)
+        return 0;
+
+    int cmd_key = is_raw_tex | (is_semi_trans << 2) | (semi_trans_mode << 3) |
+                  (is_textured << 5);
+    if (cmd_key != gs_state.last_cmd_key)
+        return 0;
+
+    if (is_textured) {
+        /* Flips need STQ float math, 15BPP direct goes cold (see GPU_TryFastEmit) */
+        if (tex_flip_x || tex_flip_y)
+            return 0;
+        int need_perpixel = (tex_win_mask_x != 0 || tex_win_mask_y != 0) ||
+                            (tex_page_format == 0 || tex_page_format == 1);
+        if (!need_perpixel)
+            return 0;
+
+        if (!prim_tex_cache_lookup(tex_page_format, tex_page_x, tex_page_y,
+                                   clut_x, clut_y))
+            return 0;
+        if (prim_tex_cache_last != gs_state.last_cache_slot)
+            return 0;
+        if (PTCACHE.csm) {
+            uint64_t this_texclut = GS_SET_TEXCLUT(PSX_VRAM_FBW, clut_x / 16, clut_y);
+            if (gs_state.texclut != this_texclut)
+                return 0;
+        }
+        if (gs_state.tex_window != raw_tex_window)
+            return 0;
+        if (PTCACHE.result == 0 && Tex15_PageView(tex_page_x))
+            return 0; /* windowed 15BPP: per-page TEX0, cold path */
+
+        gpu_frame_stats.texcache_hit++;
+        int result = PTCACHE.result;
+        int hw_clut = (result == 2 || result == 3);
+        batch.clut_decoded = (result == 1 || hw_clut);
+        batch.uv_off_u = hw_clut ? 0 : PTCACHE.hw_tbp0;
+        batch.uv_off_v = hw_clut ? 0 : PTCACHE.hw_cbp;
+        batch.batch_tex_page_x = tex_page_x;
+        batch.batch_tex_page_y = tex_page_y;
+        batch.batch_clut_x = clut_x;
+        batch.batch_clut_y = clut_y;
+        batch.batch_cache_slot = prim_tex_cache_last;
+    }
+
+    batch_begin(BATCH_KIND_SPRITE, cmd, is_textured ? 3 : 2,
+                is_textured
+                    ? ((uint64_t)GIF_REG_UV | ((uint64_t)GIF_REG_RGBAQ << 4) |
+                       ((uint64_t)GIF_REG_XYZ2 << 8))
+                    : ((uint64_t)GIF_REG_RGBAQ | ((uint64_t)GIF_REG_XYZ2 << 4)),
+                batch_sprite_prim(cmd), 0);
+
+    return batch_add_sprite(psx_cmd, cmd);
+}
+
+int GPU_TryBatchAdd(uint32_t *psx_cmd)
+{
+    uint32_t cmd = (psx_cmd[0] >> 24) & 0xFF;
+
+    switch (cmd & 0xE0)
+    {
+    case 0x20:
+        return batch_try_poly(psx_cmd, cmd);
+    case 0x40:
+        return batch_try_line(psx_cmd, cmd);
+    case 0x60:
+        return batch_try_sprite(psx_cmd, cmd);
+    }
+    return 0;
 }
 
 /* ═══════════════════════════════════════════════════════════════════
@@ -1063,10 +1430,10 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
         int is_textured = (cmd & 0x04) != 0;
         int is_semi_trans = (cmd & 0x02) != 0;
         int is_raw_tex  = is_textured && (cmd & 0x01);
-        int use_dither  = dither_enabled && (is_shaded || (is_textured && !is_raw_tex));
+        int use_dither  = prim_use_dither(is_shaded, is_textured, is_raw_tex);
 
         /* Build state key (must match emit_poly_state_and_verts) */
-        int cmd_key = is_raw_tex | (use_dither << 1) | (is_semi_trans << 2) |
+        int cmd_key = is_raw_tex | (is_semi_trans << 2) |
                       (semi_trans_mode << 3) | (is_textured << 5);
 
         if (!gs_state.valid || cmd_key != gs_state.last_cmd_key)
@@ -1120,6 +1487,12 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
                     return 0; /* CLUT changed → cold path */
             }
 
+            /* CLAMP and the 15BPP TEX0 view follow the texture window */
+            if (gs_state.tex_window != raw_tex_window)
+                return 0;
+            if (PTCACHE.result == 0 && Tex15_PageView(poly_tex_page_x))
+                return 0; /* windowed 15BPP: per-page TEX0 → cold path */
+
             gpu_frame_stats.texcache_hit++;
             int result = PTCACHE.result;
             uv_off_u = PTCACHE.hw_tbp0;
@@ -1150,14 +1523,13 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
                 gpu_stat &= ~0x8000;
         }
 
-        /* ── State is valid + key matches → emit PRIM only ── */
+        /* ── State is valid + key matches → emit PRIM (and DTHE) only ── */
         uint64_t prim_reg = is_quad ? 4 : 3; /* TRISTRIP or TRIANGLE */
         if (is_shaded)    prim_reg |= (1 << 3); /* IIP */
         if (is_textured) { prim_reg |= (1 << 4); prim_reg |= (1 << 8); } /* TME + FST */
         if (is_semi_trans) prim_reg |= (1 << 6); /* ABE */
 
-        Push_GIF_Tag(GIF_TAG_LO(1, 0, 0, 0, 0, 1), GIF_REG_AD);
-        Push_GIF_Data(GS_PACK_PRIM_FROM_INT(prim_reg), GS_REG_PRIM);
+        emit_prim_dthe(GS_PACK_PRIM_FROM_INT(prim_reg), use_dither);
 
         /* ── Parse vertices + emit REGLIST ── */
         int num_verts = is_quad ? 4 : 3;
@@ -1319,8 +1691,8 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
             if (!cache_hit)
                 return 0; /* cache miss → cold path for full decode */
 
-            /* Build state key for rect: raw_tex | dthe=0 | semi_trans | trans_mode | textured */
-            int cmd_key = is_raw_tex | (0 << 1) | (is_semi_trans << 2) |
+            /* Build state key for rect: raw_tex | semi_trans | trans_mode | textured */
+            int cmd_key = is_raw_tex | (is_semi_trans << 2) |
                           (semi_trans_mode << 3) | (1 << 5);
 
             /* Check if state matches (rect uses its own key pattern, so check last_cmd_key
@@ -1348,6 +1720,11 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
                     return 0;
             }
 
+            if (gs_state.tex_window != raw_tex_window)
+                return 0;
+            if (PTCACHE.result == 0 && Tex15_PageView(tex_page_x))
+                return 0; /* windowed 15BPP: per-page TEX0 → cold path */
+
             gpu_frame_stats.texcache_hit++;
             gpu_frame_stats.rect_tex++;
 
@@ -1387,8 +1764,7 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
             if (is_semi_trans)
                 prim_reg |= (1 << 6); /* ABE */
 
-            Push_GIF_Tag(GIF_TAG_LO(1, 0, 0, 0, 0, 1), GIF_REG_AD);
-            Push_GIF_Data(GS_PACK_PRIM_FROM_INT(prim_reg), GS_REG_PRIM);
+            emit_prim_dthe(GS_PACK_PRIM_FROM_INT(prim_reg), 0); /* SPRITE: no dither */
 
             int32_t sgx0 = ((int32_t)x + draw_offset_x + 2048) << 4;
             int32_t sgy0 = ((int32_t)y + draw_offset_y + 2048) << 4;
@@ -1412,7 +1788,7 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
         else
         {
             /* Flat (untextured) rectangle */
-            int cmd_key_flat = (0 /*raw*/) | (0 << 1 /*dthe*/) | (is_semi_trans << 2) |
+            int cmd_key_flat = (0 /*raw*/) | (is_semi_trans << 2) |
                                (semi_trans_mode << 3) | (0 << 5 /*not textured*/);
 
             if (cmd_key_flat != gs_state.last_cmd_key)
@@ -1426,8 +1802,7 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
             if (is_semi_trans)
                 prim_reg |= (1 << 6);
 
-            Push_GIF_Tag(GIF_TAG_LO(1, 0, 0, 0, 0, 1), GIF_REG_AD);
-            Push_GIF_Data(GS_PACK_PRIM_FROM_INT(prim_reg), GS_REG_PRIM);
+            emit_prim_dthe(GS_PACK_PRIM_FROM_INT(prim_reg), 0); /* SPRITE: no dither */
 
             int32_t gx0 = ((int32_t)x + draw_offset_x + 2048) << 4;
             int32_t gy0 = ((int32_t)y + draw_offset_y + 2048) << 4;
@@ -1874,6 +2249,16 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
                     u1_gs = tmp;
                 }
 
+                /* Windowed 15BPP: page-relative UVs, window in CLAMP_1 */
+                int rect_tex15_page = !clut_decoded && Tex15_PageView(tex_page_x);
+                if (rect_tex15_page)
+                {
+                    u0_gs = u0_cmd;
+                    u1_gs = u0_cmd + w;
+                    v0_gs = v0_cmd;
+                    v1_gs = v0_cmd + h;
+                }
+
                 /* ── Lazy GS state for SPRITE ── */
                 int want_dthe_r = 0; /* SPRITE: always disable dithering */
                 uint64_t want_alpha_r = is_semi_trans ? Get_Alpha_Reg(semi_trans_mode) : 0;
@@ -1882,50 +2267,55 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
                 uint64_t want_clamp_r = 0;
                 uint64_t want_texclut_r = 0;
                 int need_texflush_r = 0;
-                if (clut_decoded || is_raw_texture)
+                if (rect_hw_clut)
                 {
-                    if (rect_hw_clut)
-                    {
-                        int psm = (tex_page_format == 0) ? GS_PSM_4 : GS_PSM_8;
-                        if (rect_csm)
-                        {
-                            /* CSM2: TCC=1+TEXA for transparency, CLD=1 unconditional */
-                            want_tex0_r = GS_SET_TEX0(rect_hw_tbp0, 4, psm, 8, 8,
-                                                      1 /*TCC*/, (is_raw_texture ? 1 : 0),
-                                                      0 /*CBA*/, PSX_VRAM_PSM, 1 /*CSM2*/, 0, 1 /*CLD*/);
-                            want_texclut_r = GS_SET_TEXCLUT(PSX_VRAM_FBW,
-                                                            rect_clut_x / 16, rect_clut_y);
-                        }
-                        else
-                        {
-                            /* CSM1: CLD=1 always reload */
-                            want_tex0_r = GS_SET_TEX0(rect_hw_tbp0, 4, psm, 8, 8,
-                                                      1 /*TCC*/, (is_raw_texture ? 1 : 0),
-                                                      rect_hw_cbp, GS_PSM_16,
-                                                      0 /*CSM1*/, 0, 1 /*CLD*/);
-                        }
-                        /* GS CLAMP_1 handles PSX texture window via REGION_REPEAT */
-                        want_clamp_r = Compute_TexWin_Clamp();
-                    }
-                    else if (clut_decoded)
+                    int psm = (tex_page_format == 0) ? GS_PSM_4 : GS_PSM_8;
+                    if (rect_csm)
                     {
-                        want_tex0_r = GS_SET_TEX0(4096, PSX_VRAM_FBW, PSX_VRAM_PSM, 10, 10,
-                                                  1, (is_raw_texture ? 1 : 0), 0, 0, 0, 0, 0);
+                        /* CSM2: TCC=1+TEXA for transparency, CLD=1 unconditional */
+                        want_tex0_r = GS_SET_TEX0(rect_hw_tbp0, 4, psm, 8, 8,
+                                                  1 /*TCC*/, (is_raw_texture ? 1 : 0),
+                                                  0 /*CBA*/, PSX_VRAM_PSM, 1 /*CSM2*/, 0, 1 /*CLD*/);
+                        want_texclut_r = GS_SET_TEXCLUT(PSX_VRAM_FBW,
+                                                        rect_clut_x / 16, rect_clut_y);
                     }
                     else
                     {
-                        want_tex0_r = GS_SET_TEX0(0, PSX_VRAM_FBW, PSX_VRAM_PSM, 10, 9,
-                                                  1, (is_raw_texture ? 1 : 0), 0, 0, 0, 0, 0);
+                        /* CSM1: CLD=1 always reload */
+                        want_tex0_r = GS_SET_TEX0(rect_hw_tbp0, 4, psm, 8, 8,
+                                                  1 /*TCC*/, (is_raw_texture ? 1 : 0),
+                                                  rect_hw_cbp, GS_PSM_16,
+                                                  0 /*CSM1*/, 0, 1 /*CLD*/);
                     }
-                    need_texflush_r = !rect_tex_cache_hit;
+                    /* GS CLAMP_1 handles PSX texture window via REGION_REPEAT */
+                    want_clamp_r = Compute_TexWin_Clamp();
+                }
+                else if (clut_decoded)
+                {
+                    want_tex0_r = GS_SET_TEX0(4096, PSX_VRAM_FBW, PSX_VRAM_PSM, 10, 10,
+                                              1, (is_raw_texture ? 1 : 0), 0, 0, 0, 0, 0);
                 }
+                else if (rect_tex15_page)
+                {
+                    want_tex0_r = Tex15_PageTex0(tex_page_x, tex_page_y, is_raw_texture);
+                    want_clamp_r = Compute_TexWin_Clamp();
+                }
+                else
+                {
+                    want_tex0_r = GS_SET_TEX0(0, PSX_VRAM_FBW, PSX_VRAM_PSM, 10, 9,
+                                              1, (is_raw_texture ? 1 : 0), 0, 0, 0, 0, 0);
+                }
+                /* TEXFLUSH on a page-cache miss; modulated 15BPP outside a window skips it */
+                need_texflush_r = (clut_decoded || is_raw_texture || rect_tex15_page) &&
+                                  !rect_tex_cache_hit;
 
                 int emit_dthe_r = (!gs_state.valid || gs_state.dthe != want_dthe_r);
                 int emit_alpha_r = (is_semi_trans && (!gs_state.valid || gs_state.alpha != want_alpha_r));
-                int emit_tex0_r = ((clut_decoded || is_raw_texture) &&
-                                   (!gs_state.valid || gs_state.tex0 != want_tex0_r || need_texflush_r));
+                /* 15BPP sets CLAMP too (see the polygon path) */
+                int rect_track_clamp = rect_hw_clut || !clut_decoded;
+                int emit_tex0_r = (!gs_state.valid || gs_state.tex0 != want_tex0_r || need_texflush_r);
                 int emit_test_r = (!gs_state.valid || gs_state.test != want_test_r);
-                int emit_clamp_r = (rect_hw_clut && (!gs_state.valid || gs_state.clamp != want_clamp_r));
+                int emit_clamp_r = (rect_track_clamp && (!gs_state.valid || gs_state.clamp != want_clamp_r));
                 int emit_texclut_r = (rect_hw_clut && rect_csm &&
                                       (!gs_state.valid || gs_state.texclut != want_texclut_r));
 
@@ -1934,6 +2324,9 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
                     emit_tex0_r = 1;
 
                 int state_qws_r = emit_dthe_r + emit_alpha_r + emit_tex0_r + (emit_tex0_r && need_texflush_r) + emit_test_r + emit_clamp_r + emit_texclut_r;
+                gpu_frame_stats.gs_state_written += state_qws_r;
+                gpu_frame_stats.gs_state_skipped += 3 + is_semi_trans + rect_track_clamp + (rect_hw_clut && rect_csm) -
+                                                    (state_qws_r - (emit_tex0_r && need_texflush_r));
 
                 /* G4: State+PRIM in A+D, vertices in REGLIST */
                 Push_GIF_Tag(GIF_TAG_LO(state_qws_r + 1, 0, 0, 0, 0, 1), GIF_REG_AD);
@@ -1961,23 +2354,17 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
                 {
                     if (!is_semi_trans)
                         gs_state.alpha = ~0ULL;
-                    if (!(clut_decoded || is_raw_texture))
-                    {
-                        gs_state.tex0 = ~0ULL;
+                    if (!rect_track_clamp)
                         gs_state.clamp = ~0ULL;
-                    }
                 }
                 gs_state.dthe = want_dthe_r;
                 if (is_semi_trans)
                     gs_state.alpha = want_alpha_r;
-                if (clut_decoded || is_raw_texture)
-                    gs_state.tex0 = want_tex0_r;
-                if (rect_hw_clut)
-                {
+                gs_state.tex0 = want_tex0_r;
+                if (rect_track_clamp)
                     gs_state.clamp = want_clamp_r;
-                    if (rect_csm)
-                        gs_state.texclut = want_texclut_r;
-                }
+                if (rect_hw_clut && rect_csm)
+                    gs_state.texclut = want_texclut_r;
                 gs_state.test = want_test_r;
                 gs_state.valid = 1;
                 gs_state.last_cmd_key = -1;
@@ -2115,19 +2502,23 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
             Push_GIF_Data(GS_SET_SCISSOR(draw_clip_x1, sc_x2, draw_clip_y1, sc_y2), GS_REG_SCISSOR_1);
         }
 
-        // Update shadow VRAM for filled area
-        if (psx_vram_shadow)
+        /* Shadow VRAM for the filled area.
+         * The sprite above already puts the fill in the GS copy of PSX
+         * VRAM, which is where 15BPP textures, CLUTs (CSM2) and readbacks
+         * come from.  The shadow only feeds the 4BPP / 8BPP page slots,
+         * so it is written only when an uploaded page overlaps the fill;
+         * otherwise the area is marked GS-written and a later readback
+         * fetches it.  The common screen clear then costs no CPU stores.
+         *
+         * A fill over an uploaded page dirties just that region so the
+         * page re-uploads (unchanged blocks are skipped by the content
+         * hash); clears away from texture pages invalidate nothing. */
+        if (psx_vram_shadow && !gpu_readback_pending && !Tex_Cache_RegionCached(x, y, w, h))
+        {
+            RB_MarkRegionDrawn(x, y, w, h);
+        }
+        else if (psx_vram_shadow)
         {
-            /* FillRect writes to the GS framebuffer (FBP) via a sprite
-             * draw.  Texture pages live at separate GS VRAM locations
-             * (TBP0), so the fill does NOT modify texture data in the GS.
-             * Skipping Tex_Cache_DirtyRegion here avoids false texture
-             * invalidation that would otherwise cause 60+ redundant
-             * full-page re-uploads per frame on screen clears.
-             *
-             * DMA uploads (GP0.A0h / GS_UploadRegionFast) and VRAM-to-VRAM
-             * copies (GP0.80h) still dirty-track normally because they
-             * actually modify texture data. */
             uint16_t psx_color = ((r >> 3) & 0x1F) | (((g >> 3) & 0x1F) << 5) | (((b >> 3) & 0x1F) << 10);
             uint32_t fill32 = (uint32_t)psx_color | ((uint32_t)psx_color << 16);
             uint64_t fill64 = (uint64_t)fill32 | ((uint64_t)fill32 << 32);
@@ -2146,6 +2537,8 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
                 for (; col < fill_w; col++)
                     row_ptr[col] = psx_color;
             }
+            vram_gen_counter++;
+            Tex_Cache_DirtyRegion(x, y, fill_w, end_y - y);
         }
     fillrect_done:
         return 3;
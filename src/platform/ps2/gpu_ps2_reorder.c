@@ -0,0 +1,231 @@
+/**
+ * gpu_ps2_reorder.c — Draw-list state sorting (gpu_reorder = 1)
+ *
+ * PSX ordering tables often alternate between texture pages / CLUTs,
+ * which breaks triangle batches and re-emits TEX0/CLAMP/ALPHA for every
+ * primitive.  Polygons from GP0 DMA are held back in a small group and
+ * binned by state key (command byte, texpage, CLUT); the bins are then
+ * emitted one after another so same-state polygons reach the batcher
+ * back to back.
+ *
+ * Moving a polygon into its bin makes it jump ahead of every polygon in
+ * the bins opened after that one, so this is only allowed when its
+ * bounding box overlaps none of them.  Non-overlapping primitives don't
+ * interact, whatever their blending or the mask bits, so semi-transparent
+ * geometry that does overlap keeps its order.  A group is also closed
+ * before a polygon that would draw over a texture / CLUT area that the
+ * group reads, or texture from an area the group draws into.  Anything
+ * that is not a polygon (lines, rectangles, env commands, transfers)
+ * closes the group first.
+ */
+#include "gpu_ps2_state.h"
+#include "profiler.h"
+
+#define REORDER_MAX_PRIMS 64
+#define REORDER_MAX_BINS 8
+
+typedef struct
+{
+    int16_t x1, y1, x2, y2; /* inclusive, 0x7FFF/-0x8000 when empty */
+} ReorderBox;
+
+typedef struct
+{
+    uint32_t key;
+    ReorderBox box; /* union of the bin's polygons */
+    uint8_t first;  /* first prim index, then linked through next[] */
+    uint8_t last;
+} ReorderBin;
+
+static struct
+{
+    uint32_t *cmd[REORDER_MAX_PRIMS];
+    uint8_t next[REORDER_MAX_PRIMS];
+    ReorderBin bins[REORDER_MAX_BINS];
+    int count;
+    int bin_count;
+    ReorderBox draw; /* VRAM area the group draws into */
+    ReorderBox read; /* VRAM area the group textures from */
+    int has_tpage;
+    uint32_t last_tpage; /* texpage of the last textured polygon, stream order */
+} rq;
+
+static inline void box_empty(ReorderBox *b)
+{
+    b->x1 = b->y1 = 0x7FFF;
+    b->x2 = b->y2 = -0x8000;
+}
+
+static inline void box_add(ReorderBox *b, const ReorderBox *o)
+{
+    if (o->x1 < b->x1) b->x1 = o->x1;
+    if (o->y1 < b->y1) b->y1 = o->y1;
+    if (o->x2 > b->x2) b->x2 = o->x2;
+    if (o->y2 > b->y2) b->y2 = o->y2;
+}
+
+static inline int box_overlap(const ReorderBox *a, const ReorderBox *b)
+{
+    return a->x1 <= b->x2 && b->x1 <= a->x2 && a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+/* Texpage side effects of a textured polygon (as in the fast paths) */
+static void reorder_apply_tpage(uint32_t tpage)
+{
+    tex_page_x = (tpage & 0xF) * 64;
+    tex_page_y = ((tpage >> 4) & 0x1) * 256;
+    tex_page_format = (tpage >> 7) & 3;
+    semi_trans_mode = (tpage >> 5) & 3;
+    gpu_stat = (gpu_stat & ~0x81FF) | (tpage & 0x1FF);
+    if (gp1_allow_2mb)
+        gpu_stat = (gpu_stat & ~0x8000) | (((tpage >> 11) & 1) << 15);
+    else
+        gpu_stat &= ~0x8000;
+}
+
+/* One draw command through culling → batcher → fast path → translator.
+ * Returns the PSX words consumed. */
+int Prim_DrawCommand(uint32_t *cmd_ptr)
+{
+    if (GPU_CullDraw(cmd_ptr))
+        return gpu_cmd_size[cmd_ptr[0] >> 24];
+    int size = GPU_TryBatchAdd(cmd_ptr);
+    if (size > 0)
+        return size;
+    Prim_FlushBatch();
+    size = GPU_TryFastEmit(cmd_ptr);
+    if (size <= 0)
+    {
+        PROF_PUSH(PROF_GPU_PRIM);
+        size = Translate_GP0_to_GS(cmd_ptr);
+        PROF_POP(PROF_GPU_PRIM);
+    }
+    return size;
+}
+
+void GPU_ReorderFlush(void)
+{
+    if (!rq.count)
+        return;
+    for (int b = 0; b < rq.bin_count; b++)
+    {
+        int i = rq.bins[b].first;
+        for (;;)
+        {
+            Prim_DrawCommand(rq.cmd[i]);
+            if (i == rq.bins[b].last)
+                break;
+            i = rq.next[i];
+        }
+    }
+    /* Leave the texpage state as the original order would have */
+    if (rq.has_tpage)
+        reorder_apply_tpage(rq.last_tpage);
+    rq.count = 0;
+    rq.bin_count = 0;
+    rq.has_tpage = 0;
+}
+
+int GPU_ReorderAdd(uint32_t *cmd_ptr)
+{
+    uint32_t cmd = cmd_ptr[0] >> 24;
+    if ((cmd & 0xE0) != 0x20)
+        return 0;
+
+    int is_quad     = (cmd & 0x08) != 0;
+    int is_shaded   = (cmd & 0x10) != 0;
+    int is_textured = (cmd & 0x04) != 0;
+    int stride = 1 + is_textured + is_shaded; /* words per vertex after V0 */
+
+    /* Screen-space bounding box */
+    ReorderBox box;
+    box_empty(&box);
+    for (int v = 0, idx = 1; v < (is_quad ? 4 : 3); v++)
+    {
+        uint32_t xy = cmd_ptr[idx];
+        int16_t px = (int16_t)((int32_t)((xy & 0xFFFF) << 21) >> 21);
+        int16_t py = (int16_t)((int32_t)((xy >> 16) << 21) >> 21);
+        ReorderBox p = {px, py, px, py};
+        box_add(&box, &p);
+        idx += stride;
+    }
+    ReorderBox vram = {(int16_t)(box.x1 + draw_offset_x), (int16_t)(box.y1 + draw_offset_y),
+                       (int16_t)(box.x2 + draw_offset_x), (int16_t)(box.y2 + draw_offset_y)};
+
+    /* State key + texture source area (whole page and CLUT row, conservatively) */
+    uint32_t key = cmd & 0xF5; /* ABE and tri/quad don't break a batch */
+    uint32_t tpage = 0;
+    ReorderBox page, clut;
+    box_empty(&page);
+    box_empty(&clut);
+    if (is_textured)
+    {
+        uint32_t uv0 = cmd_ptr[2];
+        tpage = cmd_ptr[2 + stride] >> 16; /* V1 UV upper half */
+        key |= ((tpage & 0x1FF) << 8) | ((uv0 >> 16) << 17);
+        int tx = (tpage & 0xF) * 64, ty = ((tpage >> 4) & 0x1) * 256;
+        int cx = ((uv0 >> 16) & 0x3F) * 16, cy = (uv0 >> 22) & 0x1FF;
+        page = (ReorderBox){(int16_t)tx, (int16_t)ty, (int16_t)(tx + 255), (int16_t)(ty + 255)};
+        clut = (ReorderBox){(int16_t)cx, (int16_t)cy, (int16_t)(cx + 255), (int16_t)cy};
+    }
+
+    /* Render-to-texture inside the group: keep stream order */
+    if (rq.count &&
+        (box_overlap(&vram, &rq.read) ||
+         (is_textured && (box_overlap(&page, &rq.draw) || box_overlap(&clut, &rq.draw)))))
+        GPU_ReorderFlush();
+
+    int b = 0;
+    while (b < rq.bin_count && rq.bins[b].key != key)
+        b++;
+    if (b < rq.bin_count)
+    {
+        /* Jumping ahead of the later bins: must not touch them */
+        for (int j = b + 1; j < rq.bin_count; j++)
+        {
+            if (box_overlap(&box, &rq.bins[j].box))
+            {
+                GPU_ReorderFlush();
+                b = 0;
+                break;
+            }
+        }
+    }
+    if (rq.count == REORDER_MAX_PRIMS || (b == rq.bin_count && b == REORDER_MAX_BINS))
+    {
+        GPU_ReorderFlush();
+        b = 0;
+    }
+
+    if (!rq.count)
+    {
+        box_empty(&rq.draw);
+        box_empty(&rq.read);
+    }
+
+    int i = rq.count++;
+    rq.cmd[i] = cmd_ptr;
+    if (b == rq.bin_count)
+    {
+        rq.bin_count++;
+        rq.bins[b].key = key;
+        rq.bins[b].box = box;
+        rq.bins[b].first = (uint8_t)i;
+    }
+    else
+    {
+        box_add(&rq.bins[b].box, &box);
+        rq.next[rq.bins[b].last] = (uint8_t)i;
+    }
+    rq.bins[b].last = (uint8_t)i;
+
+    box_add(&rq.draw, &vram);
+    if (is_textured)
+    {
+        box_add(&rq.read, &page);
+        box_add(&rq.read, &clut);
+        rq.has_tpage = 1;
+        rq.last_tpage = tpage;
+    }
+    return 1;
+}
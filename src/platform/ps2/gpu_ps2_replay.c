@@ -0,0 +1,240 @@
+/**
+ * gpu_ps2_replay.c — Repeated DMA2 chains served from captured GIF output
+ *                    (gpu_replay = 1)
+ *
+ * Menus, pause screens and static backgrounds send the same linked-list
+ * stream every frame.  GPU_DMA2 hashes each chain before walking it (see
+ * chain_prewalk); a chain seen twice in a row is translated once more
+ * with its GIF output captured, and from then on the captured packets
+ * are pushed to the ring instead of re-running the translator.
+ *
+ * Only chains of draw, FillRect and E1-E6 commands qualify: they do not
+ * write psx_vram_shadow except through FillRect, which a repeat writes
+ * identically.  A capture is reused while
+ *   - the drawing environment at chain start matches (snapshot below),
+ *   - vram_gen_counter is unchanged (no CPU upload / VRAM copy since,
+ *     so texture uploads in the capture still carry current data),
+ *   - no GS readback happened since (it rewrites the shadow).
+ * The capture starts from an invalidated GS state cache, so it sets every
+ * register it depends on; after a replay the environment the chain left
+ * behind is restored and the GS state cache invalidated again.
+ */
+#include "gpu_ps2_state.h"
+#include "gpu_backend.h"
+
+#define REPLAY_ENTRIES 4
+#define REPLAY_MAX_QWC (16 * 1024) /* 256 KB of GIF packets per chain */
+
+#define GPUSTAT_ENV_MASK 0x9FFF /* E1 texpage bits, E6 mask bits, bit 15 */
+
+/* Drawing environment a chain reads and writes (memcmp-compared) */
+typedef struct
+{
+    uint64_t base_test;
+    uint32_t gpu_stat;
+    int32_t draw_offset_x, draw_offset_y;
+    int32_t clip_x1, clip_y1, clip_x2, clip_y2;
+    int32_t tex_page_x, tex_page_y, tex_page_format;
+    int32_t semi_trans_mode, dither_enabled;
+    int32_t tex_flip_x, tex_flip_y;
+    int32_t mask_set_bit, mask_check_bit, allow_2mb;
+    uint32_t tex_win_mask_x, tex_win_mask_y, tex_win_off_x, tex_win_off_y;
+    uint32_t raw_tex_window, raw_draw_area_tl, raw_draw_area_br, raw_draw_offset;
+} ReplayEnv;
+
+typedef struct
+{
+    uint32_t hash[2];
+    int captured;      /* 0 = seen once, 1 = data valid */
+    uint32_t vram_gen; /* vram_gen_counter when captured */
+    uint32_t lru;
+    ReplayEnv start, end;
+    uint64_t pixels; /* gpu_estimated_pixels of the capture */
+    uint32_t len;    /* qwords in data, as [qwc][qwords]... segments */
+    gif_qword_t *data;
+} ReplayEntry;
+
+int gpu_replay_capturing = 0;
+
+static ReplayEntry replay[REPLAY_ENTRIES];
+static ReplayEntry *capture;
+static int capture_overflow;
+static uint32_t replay_tick;
+static uint32_t frame_chains, frame_hits;
+
+static void env_save(ReplayEnv *e)
+{
+    memset(e, 0, sizeof(*e));
+    e->base_test = cached_base_test;
+    e->gpu_stat = gpu_stat & GPUSTAT_ENV_MASK;
+    e->draw_offset_x = draw_offset_x;
+    e->draw_offset_y = draw_offset_y;
+    e->clip_x1 = draw_clip_x1;
+    e->clip_y1 = draw_clip_y1;
+    e->clip_x2 = draw_clip_x2;
+    e->clip_y2 = draw_clip_y2;
+    e->tex_page_x = tex_page_x;
+    e->tex_page_y = tex_page_y;
+    e->tex_page_format = tex_page_format;
+    e->semi_trans_mode = semi_trans_mode;
+    e->dither_enabled = dither_enabled;
+    e->tex_flip_x = tex_flip_x;
+    e->tex_flip_y = tex_flip_y;
+    e->mask_set_bit = mask_set_bit;
+    e->mask_check_bit = mask_check_bit;
+    e->allow_2mb = gp1_allow_2mb;
+    e->tex_win_mask_x = tex_win_mask_x;
+    e->tex_win_mask_y = tex_win_mask_y;
+    e->tex_win_off_x = tex_win_off_x;
+    e->tex_win_off_y = tex_win_off_y;
+    e->raw_tex_window = raw_tex_window;
+    e->raw_draw_area_tl = raw_draw_area_tl;
+    e->raw_draw_area_br = raw_draw_area_br;
+    e->raw_draw_offset = raw_draw_offset;
+}
+
+static void env_restore(const ReplayEnv *e)
+{
+    cached_base_test = e->base_test;
+    gpu_stat = (gpu_stat & ~GPUSTAT_ENV_MASK) | e->gpu_stat;
+    draw_offset_x = e->draw_offset_x;
+    draw_offset_y = e->draw_offset_y;
+    draw_clip_x1 = e->clip_x1;
+    draw_clip_y1 = e->clip_y1;
+    draw_clip_x2 = e->clip_x2;
+    draw_clip_y2 = e->clip_y2;
+    tex_page_x = e->tex_page_x;
+    tex_page_y = e->tex_page_y;
+    tex_page_format = e->tex_page_format;
+    semi_trans_mode = e->semi_trans_mode;
+    dither_enabled = e->dither_enabled;
+    tex_flip_x = e->tex_flip_x;
+    tex_flip_y = e->tex_flip_y;
+    mask_set_bit = e->mask_set_bit;
+    mask_check_bit = e->mask_check_bit;
+    tex_win_mask_x = e->tex_win_mask_x;
+    tex_win_mask_y = e->tex_win_mask_y;
+    tex_win_off_x = e->tex_win_off_x;
+    tex_win_off_y = e->tex_win_off_y;
+    raw_tex_window = e->raw_tex_window;
+    raw_draw_area_tl = e->raw_draw_area_tl;
+    raw_draw_area_br = e->raw_draw_area_br;
+    raw_draw_offset = e->raw_draw_offset;
+}
+
+static void replay_push(const ReplayEntry *r)
+{
+    for (uint32_t q = 0; q < r->len;)
+    {
+        uint32_t qwc = (uint32_t)r->data[q].d0;
+        memcpy(fast_gif_ptr, &r->data[q + 1], qwc * sizeof(gif_qword_t));
+        fast_gif_ptr += qwc;
+        Flush_GIF();
+        q += 1 + qwc;
+    }
+}
+
+int GPU_ReplayLookup(const uint32_t hash[2], uint64_t *pixels)
+{
+    ReplayEntry *victim = &replay[0];
+    ReplayEnv env;
+
+    frame_chains++;
+    if (!hash) /* chain does not qualify; counted for the frame total */
+        return 0;
+    for (int i = 0; i < REPLAY_ENTRIES; i++)
+    {
+        ReplayEntry *r = &replay[i];
+        if (r->hash[0] != hash[0] || r->hash[1] != hash[1] || !r->lru)
+        {
+            if (r->lru < victim->lru)
+                victim = r;
+            continue;
+        }
+        r->lru = ++replay_tick;
+        env_save(&env);
+        if (r->captured && r->vram_gen == vram_gen_counter &&
+            memcmp(&env, &r->start, sizeof(env)) == 0)
+        {
+            replay_push(r);
+            env_restore(&r->end);
+            /* Keep the drawing area the readback tracking knows in step,
+             * and count everything the chain may have drawn as GS-written */
+            GPU_Backend_SetScissor(draw_clip_x1, draw_clip_y1, draw_clip_x2, draw_clip_y2);
+            RB_MarkAllDrawn();
+            Prim_InvalidateGSState();
+            *pixels = r->pixels;
+            frame_hits++;
+            gpu_frame_stats.replay_chains++;
+            return 1;
+        }
+
+        /* Seen before: translate once more, capturing the output */
+        if (!r->data)
+            r->data = (gif_qword_t *)memalign(64, REPLAY_MAX_QWC * sizeof(gif_qword_t));
+        if (!r->data)
+            return 0;
+        r->captured = 0;
+        r->start = env;
+        r->vram_gen = vram_gen_counter;
+        r->len = 0;
+        capture = r;
+        capture_overflow = 0;
+        gpu_replay_capturing = 1;
+        Prim_InvalidateGSState();
+        return 0;
+    }
+
+    /* First sighting: remember the hash only */
+    victim->hash[0] = hash[0];
+    victim->hash[1] = hash[1];
+    victim->captured = 0;
+    victim->lru = ++replay_tick;
+    return 0;
+}
+
+void GPU_ReplayCaptureSegment(const gif_qword_t *qw, int qwc)
+{
+    if (capture_overflow)
+        return;
+    if (capture->len + 1 + (uint32_t)qwc > REPLAY_MAX_QWC)
+    {
+        capture_overflow = 1;
+        return;
+    }
+    capture->data[capture->len].d0 = (uint64_t)qwc;
+    capture->data[capture->len].d1 = 0;
+    memcpy(&capture->data[capture->len + 1], qw, (size_t)qwc * sizeof(gif_qword_t));
+    capture->len += 1 + (uint32_t)qwc;
+}
+
+void GPU_ReplayCaptureEnd(uint64_t pixels)
+{
+    if (!gpu_replay_capturing)
+        return;
+    gpu_replay_capturing = 0;
+    if (capture_overflow || vram_gen_counter != capture->vram_gen)
+    {
+        capture->lru = 0; /* too big or not repeatable: forget it */
+        return;
+    }
+    env_save(&capture->end);
+    capture->pixels = pixels;
+    capture->captured = 1;
+    gpu_frame_stats.replay_captures++;
+}
+
+void GPU_ReplayInvalidate(void)
+{
+    gpu_replay_capturing = 0;
+    for (int i = 0; i < REPLAY_ENTRIES; i++)
+        replay[i].captured = 0;
+}
+
+void GPU_ReplayFrameEnd(void)
+{
+    if (frame_chains && frame_hits == frame_chains)
+        gpu_frame_stats.replay_frames++;
+    frame_chains = 0;
+    frame_hits = 0;
+}
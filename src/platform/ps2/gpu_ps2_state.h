@@ -24,11 +24,17 @@
 #define D1_MADR ((volatile uint32_t *)0x10009010)
 #define D1_QWC ((volatile uint32_t *)0x10009020)
 
+/* ── DMA Channel 2 (GIF) registers ──────────────────────────────── */
+#define D2_CHCR ((volatile uint32_t *)0x1000A000)
+
 /* ── GS pixel storage mode for PSX VRAM ──────────────────────────── */
 #define PSX_VRAM_PSM GS_PSM_16S
 
-/* ── GIF packet buffer ───────────────────────────────────────────── */
-#define GIF_BUFFER_SIZE 16384
+/* ── GIF packet ring ─────────────────────────────────────────────── */
+/* GIF_RING_SEGMENTS segments of GIF_BUFFER_SIZE qwords.  Qword 0 of each
+ * segment is its source-chain DMA tag, packets start at qword 1. */
+#define GIF_RING_SEGMENTS 8
+#define GIF_BUFFER_SIZE 4096
 
 /* ── GIF Tag structure ───────────────────────────────────────────── */
 typedef struct
@@ -49,23 +55,46 @@ typedef struct __attribute__((aligned(16)))
     uint64_t d1;
 } gif_qword_t;
 
-/* ── GIF double-buffered packet buffers ──────────────────────────── */
-extern unsigned __int128 gif_packet_buf[2][GIF_BUFFER_SIZE];
+/* ── GIF packet ring buffers ─────────────────────────────────────── */
+extern unsigned __int128 gif_packet_buf[GIF_RING_SEGMENTS][GIF_BUFFER_SIZE];
 extern gif_qword_t *fast_gif_ptr;
+extern gif_qword_t *gif_buffer_start;    /* First packet qword of the segment being filled */
 extern gif_qword_t *gif_buffer_end_safe;
-extern int current_buffer;
 
 /* ── IMAGE transfer buffer ───────────────────────────────────────── */
 extern unsigned __int128 buf_image[1024];
 extern int buf_image_ptr;
 
 /* ── GIF buffer management (gpu_gif.c) ───────────────────────────── */
+extern uint32_t gif_flush_count; /* Flush_GIF calls that sent data to the GS */
 void Flush_GIF(void);
 void Flush_GIF_Sync(void);
+void GIF_PushRef(const void *src, uint32_t qwc);
 
 /* ── Polygon batch accumulator (gpu_primitives.c) ────────────────── */
 int GPU_TryBatchAdd(uint32_t *psx_cmd);
 
+/* ── Draw-list state sorting (gpu_reorder.c) ─────────────────────── */
+int Prim_DrawCommand(uint32_t *cmd_ptr);
+int GPU_ReorderAdd(uint32_t *cmd_ptr);
+void GPU_ReorderFlush(void);
+
+/* ── Repeated-chain replay (gpu_replay.c) ────────────────────────── */
+extern int gpu_replay_capturing; /* Flush_GIF hands segments to the capture */
+int GPU_ReplayLookup(const uint32_t hash[2], uint64_t *pixels);
+void GPU_ReplayCaptureSegment(const gif_qword_t *qw, int qwc);
+void GPU_ReplayCaptureEnd(uint64_t pixels);
+void GPU_ReplayInvalidate(void);
+void GPU_ReplayFrameEnd(void);
+void RB_MarkAllDrawn(void);
+void RB_MarkRegionDrawn(int x, int y, int w, int h);
+void RB_MarkRegionClean(int x, int y, int w, int h);
+void RB_SyncRegion(int x, int y, int w, int h);
+
+/* ── Texture page cache (gpu_texture.c) ──────────────────────────── */
+int Tex_Cache_RegionCached(int x, int y, int w, int h);
+int Tex_Cache_Borrow8(int x, int y, int blocks, int *reclaimed);
+
 #define GIF_TAG_LO(nloop, eop, pre, prim, flg, nreg) \
     (((uint64_t)(nloop) & 0x7FFF) |                  \
      (((uint64_t)(eop) & 1) << 15) |                 \
@@ -131,6 +160,7 @@ typedef struct
     int valid;
     int last_cmd_key;
     int last_cache_slot;
+    uint32_t tex_window; /* E2 word CLAMP_1 / the 15BPP view were set for */
 } gs_state_t;
 
 extern gs_state_t gs_state;
@@ -142,6 +172,7 @@ uint16_t *GS_ReadbackRegion(int x, int y, int w_aligned, int h,
                             void *buf, int buf_qwc);
 void GS_UploadRegion(int x, int y, int w, int h, const uint16_t *pixels);
 void GS_UploadRegionFast(uint32_t coords, uint32_t dims, uint32_t *data_ptr, uint32_t word_count);
+void GS_UploadRGB24(int x, int y, int w, int h, int dbp, int dbw);
 void DumpVRAM(const char *filename);
 
 /* ── Display update (gpu_core.c) ─────────────────────────────────── */
@@ -8,12 +8,14 @@
  *    via TEXCLUT register — zero CLUT upload, zero CPU swizzle.
  *    Texture windows are handled by GS CLAMP_1 REGION_REPEAT mode.
  *
- * 2. SW decode (fallback): Full 256×256 CPU decode to CT16S.
- *    Only used for 15BPP (direct color, no CLUT) textures.
+ * 2. 15BPP (direct color): no decode or upload.  The GS samples the
+ *    PSX VRAM mirror itself; under a texture window through a TEX0 based
+ *    at the page, so REGION_REPEAT applies the window per texel.
  *
- * Page-Level Cache: 16 entries with LRU eviction, keyed by
- * (format, page, clut, texwindow, vram_gen).  Per-VRAM-page dirty
- * tracking avoids false invalidations.
+ * Page-Level Cache: one GS-resident slot per page and format
+ * (see the layout below).  Per-VRAM-block dirty tracking avoids false
+ * invalidations, and a content hash per 64×16 block-row skips the
+ * upload when a dirty block-row was rewritten with the same data.
  */
 #include "gpu_ps2_state.h"
 #include "fast_copy.h"
@@ -146,16 +148,46 @@ static inline int page_tbp0(int page_id, int tex_format)
  * No format field needed — format is implicit in the slot index. */
 static uint32_t page_gen[PAGE_SLOTS];
 
+/* ── Per-block content hashes ─────────────────────────────────────── */
+/* Streamed textures are often re-sent unchanged (same LoadImage every
+ * frame), which bumps the gen without changing a byte.  Each slot keeps
+ * a 64-bit hash of each of its 64×16 dirty blocks (16 block-rows × 1
+ * column for 4BPP, × 2 for 8BPP) as last uploaded; a dirty block whose
+ * data still hashes the same is not re-sent.  Hashing reads the block
+ * once (2 KB), far cheaper than the GIF transfer.
+ * Only meaningful while page_gen[slot] != 0. */
+#define PAGE_BLOCK_ROWS 16
+#define PAGE_BLOCK_COLS 2
+static uint64_t page_hash[PAGE_SLOTS][PAGE_BLOCK_COLS][PAGE_BLOCK_ROWS];
+
+static uint64_t hash_block(int block_x, int tex_page_y, int block_row)
+{
+    uint32_t a = 2166136261u, b = 0x9E3779B9u;
+    for (int line = 0; line < 16; line++)
+    {
+        const uint32_t *p = (const uint32_t *)&psx_vram_shadow[(tex_page_y + block_row * 16 + line) * 1024 + block_x];
+        for (int i = 0; i < 32; i += 2) /* 64 halfwords */
+        {
+            a = (a ^ p[i]) * 16777619u;
+            b = ((b << 5) | (b >> 27)) ^ (p[i + 1] + a);
+        }
+    }
+    return ((uint64_t)a << 32) | b;
+}
+
 /* ── Statistics ───────────────────────────────────────────────────── */
 static struct
 {
     uint32_t total_requests;
     uint32_t page_hits;       /* page data already in GS VRAM (no re-upload) */
+    uint32_t hash_hits;       /* dirty page, but every dirty block-row hashed unchanged */
     uint32_t page_uploads;    /* page data re-uploaded (dirty) */
     uint32_t partial_uploads; /* page re-uploaded (partial rows only) */
     uint32_t full_uploads;    /* page re-uploaded (full 256 rows) */
     uint32_t rect_fallbacks;
     uint64_t pixels_saved;
+    uint64_t bytes_uploaded;  /* index data sent to the GS */
+    uint64_t bytes_hash_saved; /* dirty block-rows skipped by the content hash */
     uint32_t vram_gen_at_start;
 } tex_stats;
 
@@ -202,35 +234,43 @@ static void Upload_Indexed_8BPP(int tbp0, int tex_page_x, int tex_page_y)
     }
 }
 
-/* Upload a contiguous range of rows of an 8BPP page to GS VRAM.
- * Partial upload: only rows [start_row, start_row+num_rows) are sent.
- * DY offset ensures data lands at the correct row within the GS texture page. */
+/* Upload a rectangle of an 8BPP page to GS VRAM: rows
+ * [start_row, start_row+num_rows) of the 64-halfword dirty-block column
+ * `half` (0 = pixels 0-127, 1 = pixels 128-255), or of both (half < 0).
+ * DSAX/DSAY place the data at the same spot within the GS texture page. */
 static void Upload_Indexed_8BPP_Partial(int tbp0, int tex_page_x, int tex_page_y,
-                                        int start_row, int num_rows)
+                                        int half, int start_row, int num_rows)
 {
+    int x_hw = (half > 0) ? 64 : 0;
+    int w_px = (half < 0) ? 256 : 128;
+    int row_qws = w_px / 16;
+
     Push_GIF_Tag(GIF_TAG_LO(4, 1, 0, 0, 0, 1), GIF_REG_AD);
     Push_GIF_Data(GS_SET_BITBLTBUF(0,0,0, tbp0, 4, GS_PSM_8), GS_REG_BITBLTBUF);
-    Push_GIF_Data(GS_SET_TRXPOS(0,0, 0, start_row, 0), GS_REG_TRXPOS);
-    Push_GIF_Data(GS_SET_TRXREG(256, num_rows), GS_REG_TRXREG);
+    Push_GIF_Data(GS_SET_TRXPOS(0,0, x_hw * 2, start_row, 0), GS_REG_TRXPOS);
+    Push_GIF_Data(GS_SET_TRXREG(w_px, num_rows), GS_REG_TRXREG);
     Push_GIF_Data(GS_SET_TRXDIR(0), GS_REG_TRXDIR);
 
-    /* 16 QWs per row (256 bytes).  Split into chunks of up to 1024 QWs. */
-    int total_qws = num_rows * 16;
+    /* 16 or 8 QWs per row.  Split into chunks of up to 1024 QWs. */
+    int total_qws = num_rows * row_qws;
     int qws_sent = 0;
     int row = start_row;
     while (qws_sent < total_qws)
     {
         int chunk_qws = total_qws - qws_sent;
         if (chunk_qws > 1024) chunk_qws = 1024;
-        int chunk_rows = chunk_qws / 16;
+        int chunk_rows = chunk_qws / row_qws;
         int eop = (qws_sent + chunk_qws >= total_qws) ? 1 : 0;
         Push_GIF_Tag(GIF_TAG_LO(chunk_qws, eop, 0, 0, 2, 0), 0);
         for (int r = 0; r < chunk_rows; r++, row++)
         {
-            const void *src = (const uint8_t *)&psx_vram_shadow[(tex_page_y + row) * 1024 + tex_page_x];
-            const void *next = (const uint8_t *)&psx_vram_shadow[(tex_page_y + row + 1) * 1024 + tex_page_x];
-            fast_copy_256(fast_gif_ptr, src, next);
-            fast_gif_ptr += 16;
+            const void *src = (const uint8_t *)&psx_vram_shadow[(tex_page_y + row) * 1024 + tex_page_x + x_hw];
+            const void *next = (const uint8_t *)&psx_vram_shadow[(tex_page_y + row + 1) * 1024 + tex_page_x + x_hw];
+            if (row_qws == 16)
+                fast_copy_256(fast_gif_ptr, src, next);
+            else
+                fast_copy_128(fast_gif_ptr, src, next);
+            fast_gif_ptr += row_qws;
         }
         qws_sent += chunk_qws;
     }
@@ -343,39 +383,73 @@ int Decode_TexPage_Cached(int tex_format,
     if (page_dirty)
     {
         uint32_t old_gen = page_gen[slot];
+        int ncols = tex_hw_w >> 6; /* dirty-block columns: 1 (4BPP) or 2 (8BPP) */
+        int block_bytes = 64 * 2 * 16;
 
-        /* Determine which block-rows within the page are dirty.
-         * Each block-row covers 16 scanlines.  A page has 16 block-rows.
+        /* Determine which 64×16 blocks of the page are dirty: one mask per
+         * block column, bit i = block-row i (16 scanlines).  Each block
+         * is compared against the page gen at the last upload, so a block
+         * modified since then has a higher gen.
          * If page was never uploaded (old_gen==0), upload everything. */
         int use_partial = (old_gen != 0);
-        uint16_t dirty_mask = 0; /* bit i = block-row i is dirty */
+        uint16_t dirty_mask[PAGE_BLOCK_COLS] = {0xFFFF, (ncols > 1) ? 0xFFFF : 0};
+
+        /* The blocks are hashed and uploaded from the shadow: fetch what
+         * only the GS has written there (fills, copies, rendering) */
+        RB_SyncRegion(tex_page_x, tex_page_y, tex_hw_w, 256);
 
         if (use_partial)
         {
-            unsigned int col_start = (unsigned)tex_page_x >> 6;
-            unsigned int col_end   = (unsigned)(tex_page_x + tex_hw_w - 1) >> 6;
-            unsigned int row_base  = (unsigned)tex_page_y >> VRAM_DIRTY_ROW_SHIFT;
-            if (col_end >= VRAM_DIRTY_COLS) col_end = VRAM_DIRTY_COLS - 1;
+            unsigned int col_base = (unsigned)tex_page_x >> 6;
+            unsigned int row_base = (unsigned)tex_page_y >> VRAM_DIRTY_ROW_SHIFT;
+
+            for (int c = 0; c < ncols; c++)
+            {
+                dirty_mask[c] = 0;
+                unsigned int gc = col_base + c;
+                if (gc >= VRAM_DIRTY_COLS) break;
+                for (int br = 0; br < PAGE_BLOCK_ROWS; br++)
+                {
+                    unsigned int gr = row_base + br;
+                    if (gr >= VRAM_DIRTY_ROWS) break;
+                    if (vram_page_gen[gr * VRAM_DIRTY_COLS + gc] > old_gen)
+                        dirty_mask[c] |= (1 << br);
+                }
+            }
+        }
 
-            for (int br = 0; br < 16; br++)
+        /* Drop dirty blocks whose contents didn't change; refresh the
+         * hash of the rest (they are about to be uploaded). */
+        int dirty_blocks = 0;
+        for (int c = 0; c < ncols; c++)
+        {
+            for (int br = 0; br < PAGE_BLOCK_ROWS; br++)
             {
-                unsigned int gr = row_base + br;
-                if (gr >= VRAM_DIRTY_ROWS) break;
-                for (unsigned int c = col_start; c <= col_end; c++)
+                if (!(dirty_mask[c] & (1 << br)))
+                    continue;
+                uint64_t h = hash_block(tex_page_x + c * 64, tex_page_y, br);
+                if (use_partial && h == page_hash[slot][c][br])
                 {
-                    if (vram_page_gen[gr * VRAM_DIRTY_COLS + c] > old_gen)
-                    {
-                        dirty_mask |= (1 << br);
-                        break; /* this block-row is dirty, no need to check more cols */
-                    }
+                    dirty_mask[c] &= ~(1 << br);
+                    tex_stats.bytes_hash_saved += block_bytes;
+                    continue;
                 }
+                page_hash[slot][c][br] = h;
+                dirty_blocks++;
             }
-            /* If all 16 block-rows dirty, fall back to full upload (no benefit) */
-            if (dirty_mask == 0xFFFF)
-                use_partial = 0;
         }
+        tex_stats.bytes_uploaded += (uint64_t)dirty_blocks * block_bytes;
 
-        if (!use_partial)
+        /* If every block is dirty, fall back to full upload (no benefit) */
+        if (dirty_blocks == ncols * PAGE_BLOCK_ROWS)
+            use_partial = 0;
+
+        if (dirty_blocks == 0)
+        {
+            /* Same data as the GS copy: nothing to send */
+            tex_stats.hash_hits++;
+        }
+        else if (!use_partial)
         {
             /* Full page upload */
             tex_stats.full_uploads++;
@@ -398,27 +472,36 @@ int Decode_TexPage_Cached(int tex_format,
             if (tex_format == 1) gpu_frame_stats.tex_upload_8bpp++;
             else                 gpu_frame_stats.tex_upload_4bpp++;
 #endif
-            /* Partial upload: emit one transfer per contiguous dirty range */
-            int br = 0;
-            while (br < 16)
+            /* Partial upload: one transfer per contiguous run of dirty
+             * block-rows.  8BPP runs dirty in both columns go out full
+             * width, the rest as single 128-pixel columns. */
+            uint16_t both = dirty_mask[0] & dirty_mask[1];
+            uint16_t runs[3] = {both, dirty_mask[0] & ~both, dirty_mask[1] & ~both};
+            for (int k = 0; k < 3; k++)
             {
-                if (!(dirty_mask & (1 << br))) { br++; continue; }
-                int start = br;
-                while (br < 16 && (dirty_mask & (1 << br))) br++;
-                int start_row = start * 16;
-                int num_rows  = (br - start) * 16;
+                int br = 0;
+                while (br < 16)
+                {
+                    if (!(runs[k] & (1 << br))) { br++; continue; }
+                    int start = br;
+                    while (br < 16 && (runs[k] & (1 << br))) br++;
+                    int start_row = start * 16;
+                    int num_rows  = (br - start) * 16;
 #ifdef ENABLE_SUBSYSTEM_PROFILER
-                gpu_frame_stats.tex_upload_rows += num_rows;
+                    gpu_frame_stats.tex_upload_rows += num_rows;
 #endif
-                if (tex_format == 1)
-                    Upload_Indexed_8BPP_Partial(tbp0, tex_page_x, tex_page_y, start_row, num_rows);
-                else
-                    Upload_Indexed_4BPP_Partial(tbp0, tex_page_x, tex_page_y, start_row, num_rows);
+                    if (tex_format == 1)
+                        Upload_Indexed_8BPP_Partial(tbp0, tex_page_x, tex_page_y,
+                                                    k - 1, start_row, num_rows);
+                    else
+                        Upload_Indexed_4BPP_Partial(tbp0, tex_page_x, tex_page_y, start_row, num_rows);
+                }
             }
         }
 
         page_gen[slot] = current_page_gen;
-        tex_stats.page_uploads++;
+        if (dirty_blocks)
+            tex_stats.page_uploads++;
         /* Invalidate prim_tex_cache entries referencing this page.
          * With dual-format slots, only THIS format's entry is affected,
          * but we invalidate all formats for safety (3 array writes). */
@@ -456,6 +539,50 @@ int Decode_TexPage_Cached(int tex_format,
     return 3;
 }
 
+/* Does any uploaded 4BPP / 8BPP page slot hold data from this region?
+ * (15BPP textures and CLUTs are read from the GS VRAM mirror itself.) */
+int Tex_Cache_RegionCached(int x, int y, int w, int h)
+{
+    for (int slot = 0; slot < PAGE_SLOTS; slot++)
+    {
+        if (!page_gen[slot])
+            continue;
+        int page_id = slot % PAGE_LOCS;
+        int px = (page_id & 15) * 64, py = (page_id >> 4) * 256;
+        int pw = (slot < PAGE_LOCS) ? 64 : 128; /* halfword width of page data */
+        if (x < px + pw && px < x + w && y < py + 256 && py < y + h)
+            return 1;
+    }
+    return 0;
+}
+
+/* Lend blocks of 8BPP slot memory, starting at the slot of the page at
+ * (x, y) or lower when that runs past the region, to a buffer outside
+ * the cache (the 24-bit display, gpu_ps2_backend.c).  The slots it
+ * overlaps are forgotten, so a page that is used again is re-uploaded;
+ * *reclaimed is set when one was live (it may have been written over
+ * the buffer).  Returns the first block, page (32 block) aligned. */
+int Tex_Cache_Borrow8(int x, int y, int blocks, int *reclaimed)
+{
+    int end = PAGE8_TBP_BASE + PAGE_LOCS * PAGE8_TBP_STRIDE;
+    int tbp = page_tbp0(compute_page_id(x & ~63, y & ~255), 1);
+    if (tbp + blocks > end)
+        tbp = (end - blocks) & ~31;
+
+    *reclaimed = 0;
+    for (int id = 0; id < PAGE_LOCS; id++)
+    {
+        int slot = page_slot(id, 1), t = page_tbp0(id, 1);
+        if (page_gen[slot] && t < tbp + blocks && tbp < t + PAGE8_TBP_STRIDE)
+        {
+            page_gen[slot] = 0;
+            *reclaimed = 1;
+            Prim_InvalidateTexCache_Page((id & 15) * 64, (id >> 4) * 256);
+        }
+    }
+    return tbp;
+}
+
 /* ── Statistics dump (called on triangle button press) ────────────── */
 
 void Tex_Cache_DumpStats(void)
@@ -475,6 +602,9 @@ void Tex_Cache_DumpStats(void)
     printf("\n");
     printf("  Full uploads:     %lu\n", (unsigned long)tex_stats.full_uploads);
     printf("  Partial uploads:  %lu\n", (unsigned long)tex_stats.partial_uploads);
+    printf("Hash hits (skip):   %lu\n", (unsigned long)tex_stats.hash_hits);
+    printf("Bytes uploaded:     %llu\n", (unsigned long long)tex_stats.bytes_uploaded);
+    printf("Bytes hash-skipped: %llu\n", (unsigned long long)tex_stats.bytes_hash_saved);
     printf("Rect fallbacks:     %lu\n", (unsigned long)tex_stats.rect_fallbacks);
     printf("Pixels saved:       %llu\n", (unsigned long long)tex_stats.pixels_saved);
     printf("VRAM gen counter:   %lu (delta=%lu)\n",
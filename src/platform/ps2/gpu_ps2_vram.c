@@ -5,6 +5,7 @@
  * readback for CLUT decode, and the full-VRAM dump used by tests.
  */
 #include "gpu_ps2_state.h"
+#include "fast_copy.h"
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -30,12 +31,25 @@ void Start_VRAM_Transfer(int x, int y, int w, int h)
     Push_GIF_Data(GS_SET_TRXDIR(0), GS_REG_TRXDIR);
 }
 
+/* Send buf_image as one IMAGE chunk (EOP=0: more data follows) */
+static void image_buf_push(void)
+{
+    Push_GIF_Tag(GIF_TAG_LO(buf_image_ptr, 0, 0, 0, 2, 0), 0);
+    for (int i = 0; i < buf_image_ptr; i++)
+    {
+        uint64_t *pp = (uint64_t *)&buf_image[i];
+        Push_GIF_Data(pp[0], pp[1]);
+    }
+    buf_image_ptr = 0;
+}
+
 /* ── Upload a region from shadow VRAM to GS VRAM ────────────────── */
 
 void Upload_Shadow_VRAM_Region(int x, int y, int w, int h)
 {
     if (!psx_vram_shadow || w <= 0 || h <= 0)
         return;
+    RB_MarkRegionClean(x, y, w, h);
 
     // Set up GS IMAGE transfer for the region
     Push_GIF_Tag(GIF_TAG_LO(4, 1, 0, 0, 0, 1), GIF_REG_AD);
@@ -53,6 +67,26 @@ void Upload_Shadow_VRAM_Region(int x, int y, int w, int h)
         uint32_t pending[4];
         int pc = 0;
 
+        /* QW-aligned row without X wrap: 8 pixels per STP kernel step */
+        if (!((x | w) & 7) && x + w <= 1024)
+        {
+            const uint16_t *src = &psx_vram_shadow[sy * 1024 + x];
+            int qwc = w >> 3;
+            while (qwc > 0)
+            {
+                int n = 1000 - buf_image_ptr;
+                if (n > qwc)
+                    n = qwc;
+                fast_stp_qw(&buf_image[buf_image_ptr], src, n);
+                buf_image_ptr += n;
+                src += n * 8;
+                qwc -= n;
+                if (buf_image_ptr >= 1000)
+                    image_buf_push();
+            }
+            continue;
+        }
+
         for (uint32_t col = 0; col < (uint32_t)w; col += 2)
         {
             int sx = x + col;
@@ -222,6 +256,9 @@ void GS_UploadRegion(int x, int y, int w, int h, const uint16_t *pixels)
     }
 }
 
+/* Smallest upload (in QWs) worth a REF transfer and the wait for it */
+#define VRAM_REF_MIN_QWC 256
+
 void GS_UploadRegionFast(uint32_t coords, uint32_t dims, uint32_t *data_ptr, uint32_t word_count)
 {
     int x = coords & 0x3FF;
@@ -239,6 +276,40 @@ void GS_UploadRegionFast(uint32_t coords, uint32_t dims, uint32_t *data_ptr, uin
     /* Track dirty region for texture cache invalidation */
     vram_gen_counter++;
     Tex_Cache_DirtyRegion(x, y, w, h);
+    RB_MarkRegionClean(x, y, w, h);
+
+    /* Large blocks the STP fixup would leave as they are (every pixel 0
+     * or with bit 15 set, e.g. decoded movie frames) are sent from where
+     * they lie, by REF tags in the GIF chain, instead of being packed.
+     * The shadow is still written now, a memcpy per row: games refill
+     * the source buffer right after the DMA, which is also why the
+     * upload is waited for before returning. */
+    uint32_t qwc = word_count / 4;
+    if (qwc >= VRAM_REF_MIN_QWC && !(word_count & 3) && !((uintptr_t)data_ptr & 15) &&
+        (uint32_t)w * h == word_count * 2 && !gpu_replay_capturing &&
+        fast_stp_clean(data_ptr, (int)qwc))
+    {
+        const uint8_t *src = (const uint8_t *)data_ptr;
+
+        if (psx_vram_shadow)
+        {
+            int cw = x + w > 1024 ? 1024 - x : w;
+            for (int r = 0; r < h && y + r < 512; r++)
+                memcpy(&psx_vram_shadow[(y + r) * 1024 + x], src + r * w * 2, cw * 2);
+        }
+
+        Start_VRAM_Transfer(x, y, w, h);
+        while (qwc)
+        {
+            uint32_t n = qwc > 0x7FFF ? 0x7FFF : qwc; /* NLOOP limit */
+            qwc -= n;
+            Push_GIF_Tag(GIF_TAG_LO(n, qwc == 0, 0, 0, 2, 0), 0); // IMAGE mode
+            GIF_PushRef(src, n);
+            src += n * 16;
+        }
+        Flush_GIF_Sync();
+        return;
+    }
 
     // Single-pass: shadow VRAM update + STP fixup + GIF IMAGE pack
     Push_GIF_Tag(GIF_TAG_LO(4, 1, 0, 0, 0, 1), GIF_REG_AD);
@@ -327,6 +398,65 @@ void GS_UploadRegionFast(uint32_t coords, uint32_t dims, uint32_t *data_ptr, uin
     Flush_GIF();
 }
 
+/* ── 24-bit display upload (MDEC movies) ──────────────────────────── */
+
+/* A 24-bit PSX line is R, G, B bytes back to back from halfword x, the
+ * very stream a PSMCT24 host transfer takes, so the w x h pixels at
+ * (x, y) go from the shadow to the CT24 buffer at block dbp unconverted.
+ * Rows that start on a qword and don't wrap are sent where they lie by
+ * REF tags; others are copied through buf_image.  w is a multiple of 16
+ * (every PSX display width is), so each row is whole qwords. */
+void GS_UploadRGB24(int x, int y, int w, int h, int dbp, int dbw)
+{
+    int row_qwc = w * 3 / 16;
+    int row_hw = row_qwc * 8;
+
+    if (!psx_vram_shadow || row_qwc <= 0 || h <= 0)
+        return;
+
+    Push_GIF_Tag(GIF_TAG_LO(4, 1, 0, 0, 0, 1), GIF_REG_AD);
+    Push_GIF_Data(GS_SET_BITBLTBUF(0, 0, 0, dbp, dbw, GS_PSM_24), GS_REG_BITBLTBUF);
+    Push_GIF_Data(GS_SET_TRXPOS(0, 0, 0, 0, 0), GS_REG_TRXPOS);
+    Push_GIF_Data(GS_SET_TRXREG(w, h), GS_REG_TRXREG);
+    Push_GIF_Data(GS_SET_TRXDIR(0), GS_REG_TRXDIR); // Host -> Local
+
+    int ref = !gpu_replay_capturing && x + row_hw <= 1024 &&
+              !((uintptr_t)&psx_vram_shadow[x] & 15);
+    buf_image_ptr = 0;
+    for (int row = 0; row < h; row++)
+    {
+        const uint16_t *src = &psx_vram_shadow[((y + row) & 511) * 1024];
+        int last = row == h - 1;
+
+        if (ref)
+        {
+            Push_GIF_Tag(GIF_TAG_LO(row_qwc, last, 0, 0, 2, 0), 0); // IMAGE mode
+            GIF_PushRef(src + x, row_qwc);
+            continue;
+        }
+
+        if (buf_image_ptr + row_qwc > 1000)
+            image_buf_push();
+        uint16_t *dst = (uint16_t *)&buf_image[buf_image_ptr];
+        int first = x + row_hw > 1024 ? 1024 - x : row_hw;
+        memcpy(dst, src + x, first * 2);
+        memcpy(dst + first, src, (row_hw - first) * 2);
+        buf_image_ptr += row_qwc;
+    }
+
+    if (buf_image_ptr > 0)
+    {
+        Push_GIF_Tag(GIF_TAG_LO(buf_image_ptr, 1, 0, 0, 2, 0), 0);
+        for (int i = 0; i < buf_image_ptr; i++)
+        {
+            uint64_t *pp = (uint64_t *)&buf_image[i];
+            Push_GIF_Data(pp[0], pp[1]);
+        }
+        buf_image_ptr = 0;
+    }
+    Flush_GIF_Sync(); /* the REF'd rows are read by the DMA */
+}
+
 /* ── Full VRAM dump to file (for testing / debugging) ─────────────── */
 
 void DumpVRAM(const char *filename)
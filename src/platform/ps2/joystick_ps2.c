@@ -1,13 +1,17 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <kernel.h>
 #include <libpad.h>
 #include <libmtap.h>
 #include <ps2_joystick_driver.h>
 
 #include "joystick.h"
+#include "config.h"
 #include "gpu_state.h"
 #include "gpu_trace.h"
+#include "pad_snapshot.h"
+#include "platform.h"
 
 #define PS2_MAX_PORT 2 /* each ps2 has 2 ports */
 #define PS2_MAX_SLOT 4 /* maximum - 4 slots in one multitap */
@@ -47,6 +51,15 @@ static uint8_t enabled_pads;
  * Updated once at init; status doesn't change during gameplay. */
 static int multitap_cached[PS2_MAX_PORT] = {0, 0};
 
+/* pad_thread: libpad is only touched by the poll worker, woken by the
+ * host VBlank interrupt; the SIO side reads pad_snap */
+#define PAD_POLL_STACK (8 * 1024)
+
+static PadSnapshot pad_snap;
+static int pad_thread = -1;
+static int pad_wake = -1;
+static int pad_vblank_handler = -1;
+
 /* ---- Internal helpers ---- */
 
 static struct JoyInfo *getJoyInfoByPortSlot(int port, int slot)
@@ -82,6 +95,57 @@ static uint32_t pollJoyInfo(struct JoyInfo *info)
     return data;
 }
 
+static int pad_vblank_intr(int cause)
+{
+    (void)cause;
+    iSignalSema(pad_wake);
+    ExitHandler();
+    return 0;
+}
+
+static void pad_poll_worker(void *arg)
+{
+    uint16_t buttons[PAD_SNAPSHOT_MAX];
+
+    (void)arg;
+    for (;;)
+    {
+        for (int i = 0; i < PAD_SNAPSHOT_MAX; i++)
+            buttons[i] = i < enabled_pads ? (uint16_t)pollJoyInfo(&joyInfo[i]) : 0;
+        pad_snapshot_publish(&pad_snap, buttons);
+        WaitSema(pad_wake);
+    }
+}
+
+static void pad_thread_start(void)
+{
+    pad_wake = Platform_SemaCreate(0, 1);
+    if (pad_wake < 0)
+        return;
+    pad_thread = Platform_ThreadStart("pad_poll", pad_poll_worker, NULL, PAD_POLL_STACK);
+    if (pad_thread < 0)
+    {
+        DeleteSema(pad_wake);
+        pad_wake = -1;
+        printf("[PAD] Poll thread failed, pads are read on the emulator thread\n");
+        return;
+    }
+    pad_vblank_handler = AddIntcHandler(INTC_VBLANK_S, pad_vblank_intr, 0);
+    EnableIntc(INTC_VBLANK_S);
+    printf("[PAD] Poll thread started (host VBlank rate)\n");
+}
+
+/* Buttons of info's pad: the worker's last poll while it runs */
+static uint32_t pad_buttons(struct JoyInfo *info)
+{
+    if (pad_thread < 0 || info == NULL)
+        return pollJoyInfo(info);
+
+    uint16_t buttons[PAD_SNAPSHOT_MAX];
+    pad_snapshot_read(&pad_snap, buttons);
+    return buttons[info - joyInfo];
+}
+
 /* ---- Public API ---- */
 
 void Joystick_Init(void)
@@ -133,12 +197,25 @@ void Joystick_Init(void)
     {
         multitap_cached[port] = (mtapGetConnection(port) == 1) ? 1 : 0;
     }
+
+    if (psx_config.pad_thread)
+        pad_thread_start();
 }
 
 void Joystick_Shutdown(void)
 {
     uint32_t i = 0;
 
+    if (pad_thread >= 0)
+    {
+        if (pad_vblank_handler >= 0)
+            RemoveIntcHandler(INTC_VBLANK_S, pad_vblank_handler);
+        TerminateThread(pad_thread);
+        DeleteThread(pad_thread);
+        DeleteSema(pad_wake);
+        pad_thread = pad_wake = pad_vblank_handler = -1;
+    }
+
     for (i = 0; i < MAX_CONTROLLERS; i++)
     {
         struct JoyInfo *info = &joyInfo[i];
@@ -172,7 +249,7 @@ int Joystick_IsConnected(int port, int slot)
 // This function fills a 3-byte buffer with the PSX controller response
 void Joystick_GetPSXDigitalResponse(int port, int slot, uint8_t response[3])
 {
-    uint32_t ps2 = pollJoyInfo(getJoyInfoByPortSlot(port, slot));
+    uint32_t ps2 = pad_buttons(getJoyInfoByPortSlot(port, slot));
     response[0] = 0x41; // Digital pad ID
     response[1] = 0xFF;
     response[2] = 0xFF;
@@ -207,8 +284,7 @@ void Joystick_GetPSXDigitalResponse(int port, int slot, uint8_t response[3])
         response[2] &= ~0x08;
     if (ps2 & PAD_TRIANGLE)
     {
-        gpu_trace_trigger_dump("host:gpu_trace.bin");
-        gpu_trace_frame_end(); /* flush pending dump immediately */
+        gpu_trace_trigger_dump("host:gpu_trace.bin"); /* written 60 frames later */
         // exit(0); /* Triangle button exit is handled directly in Joystick_Poll() (joystick_ps2.c) */
         response[2] &= ~0x10;
     }
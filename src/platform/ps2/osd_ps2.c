@@ -5,6 +5,11 @@
  * No GS VRAM font texture needed — font pixels are rendered in
  * EE RAM and uploaded to the framebuffer via BITBLTBUF.
  * This avoids conflicts with the texture cache (which uses 100% of GS VRAM).
+ *
+ * osd_draw keeps the rendered pixels of the first OSD_CACHE_LINES lines
+ * and only renders a line again when its text, color or position
+ * changes.  Unchanged lines are sent each frame by reference
+ * (GIF_PushRef), so a steady overlay costs a few tags per line.
  */
 #include "osd.h"
 #include "gpu_ps2_state.h"
@@ -17,6 +22,7 @@
 #define OSD_MAX_ENTRIES 32
 #define OSD_MAX_TEXT    128
 #define OSD_LINE_MAX    80   /* max rendered chars per line */
+#define OSD_CACHE_LINES 8    /* lines whose rendered pixels are kept */
 
 /* ── Queued text entry ───────────────────────────────────────────── */
 typedef struct {
@@ -37,6 +43,18 @@ volatile uint32_t osd_vblank_count = 0;
 static uint16_t osd_line_buf[OSD_LINE_MAX * OSD_CHAR_W * OSD_CHAR_H]
     __attribute__((aligned(64)));
 
+/* ── Rendered line cache ─────────────────────────────────────────── */
+typedef struct __attribute__((aligned(64))) {
+    uint16_t pix[OSD_LINE_MAX * OSD_CHAR_W * OSD_CHAR_H]; /* DMA source, kept aligned */
+    char text[OSD_LINE_MAX];
+    int nchars;         /* 0 = empty slot */
+    int x, y;
+    uint16_t fg;
+    int pw, ph;         /* rendered size, after clamping */
+} osd_cached_line_t;
+
+static osd_cached_line_t osd_cache[OSD_CACHE_LINES];
+
 /* ── Classic 8×8 bitmap font (ASCII 0x20 – 0x7F) ────────────────── */
 /* Each char: 8 bytes, MSB = leftmost pixel.  96 glyphs. */
 static const uint8_t font_8x8[96][8] = {
@@ -148,13 +166,15 @@ static inline uint16_t color32_to_16s(uint32_t c)
     return (uint16_t)((r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10));
 }
 
-/* ── Upload one rendered text line to VRAM via IMAGE transfer ────── */
+/* ── Render one text line into a pixel buffer ────────────────────── */
 
-static void osd_upload_line(int vram_x, int vram_y,
-                            const char *text, int nchars,
-                            uint16_t fg, uint16_t bg)
+/* Clamps the line to PSX VRAM; returns 0 (nothing to draw) or 1 with
+ * the rendered size in *out_pw, *out_ph. */
+static int osd_render_line(uint16_t *buf, int vram_x, int vram_y,
+                           const char *text, int nchars,
+                           uint16_t fg, uint16_t bg, int *out_pw, int *out_ph)
 {
-    if (nchars <= 0) return;
+    if (nchars <= 0) return 0;
     if (nchars > OSD_LINE_MAX) nchars = OSD_LINE_MAX;
 
     int pw = nchars * OSD_CHAR_W;
@@ -163,7 +183,7 @@ static void osd_upload_line(int vram_x, int vram_y,
     /* Clamp to PSX VRAM bounds */
     if (vram_x + pw > PSX_VRAM_WIDTH) pw = PSX_VRAM_WIDTH - vram_x;
     if (vram_y + ph > PSX_VRAM_HEIGHT) ph = PSX_VRAM_HEIGHT - vram_y;
-    if (pw <= 0 || ph <= 0) return;
+    if (pw <= 0 || ph <= 0) return 0;
 
     /* Render font pixels into line buffer */
     for (int c = 0; c < nchars; c++)
@@ -177,15 +197,27 @@ static void osd_upload_line(int vram_x, int vram_y,
             {
                 int idx = py * pw + c * OSD_CHAR_W + px;
                 if (c * OSD_CHAR_W + px < pw)
-                    osd_line_buf[idx] = (bits & (0x80 >> px)) ? fg : bg;
+                    buf[idx] = (bits & (0x80 >> px)) ? fg : bg;
             }
         }
     }
 
     /* DCache sync before GIF IMAGE transfer */
     int nbytes = pw * ph * (int)sizeof(uint16_t);
-    SyncDCache(osd_line_buf, (void *)((uintptr_t)osd_line_buf + nbytes));
+    SyncDCache(buf, (void *)((uintptr_t)buf + nbytes));
+
+    *out_pw = pw;
+    *out_ph = ph;
+    return 1;
+}
 
+/* ── Upload a rendered line to VRAM via IMAGE transfer ───────────── */
+
+/* ref: send buf in place (it must stay unchanged until the DMA has
+ * passed it) instead of copying it into the GIF ring */
+static void osd_push_line(const uint16_t *buf, int vram_x, int vram_y,
+                          int pw, int ph, int ref)
+{
     /* BITBLTBUF → TRXPOS → TRXREG → TRXDIR (A+D mode) */
     Push_GIF_Tag(GIF_TAG_LO(4, 0, 0, 0, 0, 1), GIF_REG_AD);
     Push_GIF_Data(GS_SET_BITBLTBUF(0, 0, 0, 0, PSX_VRAM_FBW, PSX_VRAM_PSM),
@@ -195,17 +227,66 @@ static void osd_upload_line(int vram_x, int vram_y,
     Push_GIF_Data(GS_SET_TRXDIR(0), GS_REG_TRXDIR); /* host → local */
 
     /* IMAGE data: CT16S pixels, padded to QW boundary */
+    int nbytes = pw * ph * (int)sizeof(uint16_t);
     int nqw = (nbytes + 15) / 16;
     Push_GIF_Tag(GIF_TAG_LO(nqw, 0, 0, 0, 2, 0), 0); /* FLG=2 IMAGE, EOP=0 */
 
-    const gif_qword_t *src = (const gif_qword_t *)osd_line_buf;
+    if (ref)
+    {
+        GIF_PushRef(buf, nqw);
+        return;
+    }
+    const gif_qword_t *src = (const gif_qword_t *)buf;
     for (int i = 0; i < nqw; i++)
         Push_GIF_Data(src[i].d0, src[i].d1);
 }
 
+static void osd_upload_line(int vram_x, int vram_y,
+                            const char *text, int nchars,
+                            uint16_t fg, uint16_t bg)
+{
+    int pw, ph;
+    if (osd_render_line(osd_line_buf, vram_x, vram_y, text, nchars,
+                        fg, bg, &pw, &ph))
+        osd_push_line(osd_line_buf, vram_x, vram_y, pw, ph, 0);
+}
+
+/* Draw line number `slot` of this frame from the cache, rendering it
+ * again if it changed.  *synced: the DMA was already drained this frame. */
+static void osd_draw_cached_line(int slot, int vram_x, int vram_y,
+                                 const char *text, int nchars,
+                                 uint16_t fg, uint16_t bg, int *synced)
+{
+    osd_cached_line_t *l = &osd_cache[slot];
+    if (nchars > OSD_LINE_MAX) nchars = OSD_LINE_MAX;
+
+    if (l->nchars != nchars || l->x != vram_x || l->y != vram_y ||
+        l->fg != fg || memcmp(l->text, text, nchars) != 0)
+    {
+        /* Last frame's reference to these pixels may still be queued */
+        if (!*synced)
+        {
+            Flush_GIF_Sync();
+            *synced = 1;
+        }
+        l->nchars = 0;
+        if (!osd_render_line(l->pix, vram_x, vram_y, text, nchars,
+                             fg, bg, &l->pw, &l->ph))
+            return;
+        memcpy(l->text, text, nchars);
+        l->nchars = nchars;
+        l->x = vram_x;
+        l->y = vram_y;
+        l->fg = fg;
+    }
+    osd_push_line(l->pix, vram_x, vram_y, l->pw, l->ph, !gpu_replay_capturing);
+}
+
 /* ── Render one text entry ───────────────────────────────────────── */
 
-static void osd_draw_entry(const osd_entry_t *e)
+/* *line counts the lines drawn this frame, the first OSD_CACHE_LINES
+ * of which come from the cache */
+static void osd_draw_entry(const osd_entry_t *e, int *line, int *synced)
 {
     uint16_t fg = color32_to_16s(e->color);
     uint16_t bg = 0x0000; /* black background */
@@ -226,7 +307,13 @@ static void osd_draw_entry(const osd_entry_t *e)
         }
 
         if (nchars > 0)
-            osd_upload_line(vx, vy, s, nchars, fg, bg);
+        {
+            if (*line < OSD_CACHE_LINES)
+                osd_draw_cached_line(*line, vx, vy, s, nchars, fg, bg, synced);
+            else
+                osd_upload_line(vx, vy, s, nchars, fg, bg);
+            (*line)++;
+        }
 
         s = eol;
         if (*s == '\n') { s++; vy += OSD_CHAR_H; }
@@ -309,8 +396,9 @@ void osd_draw(void)
         return;
     }
 
+    int line = 0, synced = 0;
     for (int i = 0; i < osd_entry_count; i++)
-        osd_draw_entry(&osd_entries[i]);
+        osd_draw_entry(&osd_entries[i], &line, &synced);
 
     osd_entry_count = 0;
 }
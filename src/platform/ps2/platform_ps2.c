@@ -10,6 +10,10 @@
 #include <iopcontrol.h>
 #include <sbv_patches.h>
 #include <ps2_filesystem_driver.h>
+#include <malloc.h>
+#include <stdlib.h>
+
+extern void *_gp;
 
 void Platform_Init(void)
 {
@@ -43,13 +47,137 @@ void Platform_FlushICache(void)
     FlushCache(2); /* invalidate entire I-cache */
 }
 
+void Platform_SyncCodeRange(void *start, void *end)
+{
+    uintptr_t p = (uintptr_t)start & ~(uintptr_t)63; /* 64-byte lines */
+
+    SyncDCache(start, end);
+    for (; p < (uintptr_t)end; p += 64)
+        __asm__ volatile("cache 0x0B, 0(%0)" : : "r"(p)); /* IHIN: I-cache hit invalidate */
+    __asm__ volatile("sync.p");
+}
+
+/* COP0 Count (294.912 MHz) widened to 64 bits; needs a call at least
+ * every ~14.5 s to see each wrap */
 uint64_t Platform_GetCycles(void)
 {
-    /* PS2 COP0 Count register — stub for now */
-    return 0;
+    static uint32_t last;
+    static uint64_t high;
+    uint32_t c;
+
+    __asm__ volatile("mfc0 %0, $9" : "=r"(c));
+    if (c < last)
+        high += 1ull << 32;
+    last = c;
+    return high | c;
 }
 
 void Platform_Sleep(uint32_t ms)
 {
     (void)ms;
 }
+
+/* EE timer 0 on BUSCLK/256 (576 kHz), compare interrupt with
+ * clear-on-compare.  The kernel's INTC dispatch leaves EPC as the
+ * interrupted PC. */
+#define EE_T0_COUNT ((volatile uint32_t *)0x10000000)
+#define EE_T0_MODE  ((volatile uint32_t *)0x10000010)
+#define EE_T0_COMP  ((volatile uint32_t *)0x10000020)
+#define EE_T_MODE_RUN 0x0DC2 /* CLKS=256, ZRET, CUE, CMPE, clear EQUF/OVFF */
+#define EE_T0_HZ 576000
+
+static void (*sample_cb)(uintptr_t pc);
+static int sample_handler = -1;
+
+static int sample_intr(int cause)
+{
+    uint32_t epc;
+
+    (void)cause;
+    __asm__ volatile("mfc0 %0, $14" : "=r"(epc));
+    sample_cb(epc);
+    *EE_T0_MODE = EE_T_MODE_RUN; /* acknowledge EQUF */
+    ExitHandler();
+    return 0;
+}
+
+int Platform_SampleStart(uint32_t hz, void (*cb)(uintptr_t pc))
+{
+    uint32_t comp;
+
+    if (sample_handler >= 0 || hz == 0)
+        return -1;
+    comp = EE_T0_HZ / hz;
+    if (comp < 1)
+        comp = 1;
+    if (comp > 0xFFFF)
+        comp = 0xFFFF;
+    sample_cb = cb;
+    sample_handler = AddIntcHandler(INTC_TIM0, sample_intr, 0);
+    if (sample_handler < 0)
+        return -1;
+    *EE_T0_MODE = 0;
+    *EE_T0_COUNT = 0;
+    *EE_T0_COMP = comp;
+    *EE_T0_MODE = EE_T_MODE_RUN;
+    EnableIntc(INTC_TIM0);
+    return 0;
+}
+
+void Platform_SampleStop(void)
+{
+    if (sample_handler < 0)
+        return;
+    DisableIntc(INTC_TIM0);
+    *EE_T0_MODE = 0;
+    RemoveIntcHandler(INTC_TIM0, sample_handler);
+    sample_handler = -1;
+}
+
+int Platform_ThreadStart(const char *name, void (*entry)(void *), void *arg,
+                         int stack_size)
+{
+    ee_thread_t th;
+    ee_thread_status_t self;
+    void *stack = memalign(16, stack_size);
+
+    (void)name;
+    if (!stack)
+        return -1;
+    ReferThreadStatus(GetThreadId(), &self);
+    th.func = (void *)entry;
+    th.stack = stack;
+    th.stack_size = stack_size;
+    th.gp_reg = &_gp;
+    th.initial_priority = self.current_priority > 1 ? self.current_priority - 1 : 1;
+    th.attr = 0;
+    th.option = 0;
+    int id = CreateThread(&th);
+    if (id < 0 || StartThread(id, arg) < 0)
+    {
+        if (id >= 0)
+            DeleteThread(id);
+        free(stack);
+        return -1;
+    }
+    return id;
+}
+
+int Platform_SemaCreate(int init_count, int max_count)
+{
+    ee_sema_t sema;
+    sema.init_count = init_count;
+    sema.max_count = max_count;
+    sema.option = 0;
+    return CreateSema(&sema);
+}
+
+void Platform_SemaWait(int sema)
+{
+    WaitSema(sema);
+}
+
+void Platform_SemaSignal(int sema)
+{
+    SignalSema(sema);
+}
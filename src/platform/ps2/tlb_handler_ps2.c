@@ -3,18 +3,20 @@
  *
  * Maps the PSX memory space using hardware TLB entries:
  *   - psx_ram      at VA 0x20000000 (1MB pages, 2MB, 1 TLB entry)
- *   - scratchpad   at VA 0x3F800000 (4KB page, 1KB used, 1 TLB entry)
  *   - psx_bios     at VA 0x3FC00000 (256KB pages, 512KB, 1 TLB entry)
- *   - HW I/O at VA 0x3F801000+: INVALID page → TLB miss → exception → C helpers
+ *   - everything else (I/O, scratchpad, RAM mirrors) is unmapped
  *
  * JIT memory accesses use VA = (psx_addr & 0x1FFFFFFF) + 0x20000000.
- * RAM/scratchpad/BIOS accesses hit the TLB → zero-overhead direct access.
- * Hardware I/O accesses miss → exception handler → trampoline → ReadWord/WriteWord.
+ * RAM/BIOS accesses hit the TLB → zero-overhead direct access.
+ * Other accesses miss → refill handler → trampoline → TLB_HandleFault(),
+ * which performs the access in C and backpatches the JIT site to its
+ * range-checked stub so it never faults again.
  */
 
 #include <kernel.h>
 #include <string.h>
 #include "superpsx.h"
+#include "config.h"
 
 /* VA base for TLB-mapped PSX RAM */
 #define PSX_TLB_BASE       0x20000000
@@ -35,22 +37,23 @@ uint32_t psx_tlb_base = 0;
 /* Buffer for the original TLB refill handler code (copied from 0x80000000) */
 static uint32_t orig_handler_copy[32] __attribute__((aligned(64)));
 
-/* Memory helpers declared in superpsx.h */
+/* Fault decoding and backpatching live in dynarec_memory.c */
+uint32_t TLB_HandleFault(uint32_t *regs, uint32_t epc, uint32_t insn);
 
 /* ================================================================
  *  TLB trampoline: jumped to via ERET from the exception handler.
- *  All JIT registers are intact:
- *    T0 ($8)  = PSX address
- *    T2 ($10) = write value (for stores)
- *    V0 ($2)  = load destination
+ *  All JIT registers are intact.
  *
  *  Scratchpad has:
  *    [SP_FAULT_EPC]  = EPC of faulting instruction
  *    [SP_FAULT_INSN] = faulting instruction word
  *
- *  The trampoline saves caller-saved registers, calls the appropriate
- *  C helper, restores registers (with V0 = read result for loads),
- *  and jumps to EPC+4 (the instruction after the fault).
+ *  The trampoline saves the whole GPR file as regs[0..31] on the
+ *  stack and calls TLB_HandleFault(regs, epc, insn), which decodes the
+ *  load/store, runs the C memory helper and writes a load's result
+ *  into regs[rt].  Every register is then restored except $at, which
+ *  carries the resume address: the JIT only uses $at as a scratch
+ *  register that is dead after a memory access.
  * ================================================================ */
 asm(
     ".section .text\n"
@@ -62,168 +65,78 @@ asm(
     ".set noreorder\n"
     ".set noat\n"
 
-    /* Save caller-saved registers */
-    "addiu $sp, $sp, -80\n"
-    "sw $ra,  0($sp)\n"
-    "sw $4,   4($sp)\n"    /* a0 */
-    "sw $5,   8($sp)\n"    /* a1 */
-    "sw $2,  12($sp)\n"    /* v0 */
-    "sw $3,  16($sp)\n"    /* v1 */
-    "sw $8,  20($sp)\n"    /* t0 */
-    "sw $9,  24($sp)\n"    /* t1 */
-    "sw $10, 28($sp)\n"    /* t2 */
-    "sw $11, 32($sp)\n"    /* t3 */
-    "sw $12, 36($sp)\n"    /* t4 */
-    "sw $13, 40($sp)\n"    /* t5 */
-    "sw $14, 44($sp)\n"    /* t6 */
-    "sw $15, 48($sp)\n"    /* t7 */
-    "sw $24, 52($sp)\n"    /* t8 */
-    "sw $25, 56($sp)\n"    /* t9 */
-    "sw $1,  60($sp)\n"    /* at */
-    "sw $28, 64($sp)\n"    /* gp */
-
-    /* Read faulting instruction opcode from scratchpad */
+    /* regs[r] at 16+r*4($sp), above a 16-byte outgoing argument area;
+     * k0/k1 are not saved */
+    "addiu $sp, $sp, -144\n"
+    "sw $0,   16($sp)\n"
+    "sw $1,   20($sp)\n"
+    "sw $2,   24($sp)\n"
+    "sw $3,   28($sp)\n"
+    "sw $4,   32($sp)\n"
+    "sw $5,   36($sp)\n"
+    "sw $6,   40($sp)\n"
+    "sw $7,   44($sp)\n"
+    "sw $8,   48($sp)\n"
+    "sw $9,   52($sp)\n"
+    "sw $10,  56($sp)\n"
+    "sw $11,  60($sp)\n"
+    "sw $12,  64($sp)\n"
+    "sw $13,  68($sp)\n"
+    "sw $14,  72($sp)\n"
+    "sw $15,  76($sp)\n"
+    "sw $16,  80($sp)\n"
+    "sw $17,  84($sp)\n"
+    "sw $18,  88($sp)\n"
+    "sw $19,  92($sp)\n"
+    "sw $20,  96($sp)\n"
+    "sw $21, 100($sp)\n"
+    "sw $22, 104($sp)\n"
+    "sw $23, 108($sp)\n"
+    "sw $24, 112($sp)\n"
+    "sw $25, 116($sp)\n"
+    "sw $28, 128($sp)\n"
+    "sw $30, 136($sp)\n"
+    "sw $31, 140($sp)\n"
+    "addiu $1, $sp, 144\n"
+    "sw $1,  132($sp)\n"              /* regs[29] = JIT $sp */
+
+    "addiu $4, $sp, 16\n"             /* a0 = regs */
     "lui  $9, 0x7000\n"
-    "lw   $11, 0x3FE4($9)\n"    /* t3 = insn word */
-    "srl  $12, $11, 26\n"       /* t4 = opcode */
-
-    /* a0 = PSX address (from saved $8 / t0) */
-    "lw   $4, 20($sp)\n"
-
-    /* Store or Load? (opcode >= 0x28 -> store) */
-    "sltiu $1, $12, 0x28\n"
-    "beqz  $1, .Ltlb_write\n"
-    "nop\n"
-
-    /* ---- READ PATH ---- */
-    "addiu $1, $12, -0x23\n"   /* LW? */
-    "beqz  $1, .Ltlb_lw\n"
-    "nop\n"
-    "addiu $1, $12, -0x25\n"   /* LHU? */
-    "beqz  $1, .Ltlb_lhu\n"
-    "nop\n"
-    "addiu $1, $12, -0x24\n"   /* LBU? */
-    "beqz  $1, .Ltlb_lbu\n"
-    "nop\n"
-    "addiu $1, $12, -0x21\n"   /* LH? */
-    "beqz  $1, .Ltlb_lh\n"
-    "nop\n"
-    "addiu $1, $12, -0x20\n"   /* LB? */
-    "beqz  $1, .Ltlb_lb\n"
-    "nop\n"
-    /* Default: treat as LW */
-    "j .Ltlb_lw\n"
-    "nop\n"
-
-    ".Ltlb_lw:\n"
-    "jal ReadWord\n"
-    "nop\n"
-    "j .Ltlb_read_done\n"
-    "nop\n"
-
-    ".Ltlb_lhu:\n"
-    "jal ReadHalf\n"
-    "nop\n"
-    /* zero-extend: ReadHalf returns uint16_t, already correct */
-    "j .Ltlb_read_done\n"
-    "nop\n"
-
-    ".Ltlb_lbu:\n"
-    "jal ReadByte\n"
-    "nop\n"
-    "j .Ltlb_read_done\n"
-    "nop\n"
-
-    ".Ltlb_lh:\n"
-    "jal ReadHalf\n"
-    "nop\n"
-    "sll $2, $2, 16\n"
-    "sra $2, $2, 16\n"
-    "j .Ltlb_read_done\n"
-    "nop\n"
-
-    ".Ltlb_lb:\n"
-    "jal ReadByte\n"
-    "nop\n"
-    "sll $2, $2, 24\n"
-    "sra $2, $2, 24\n"
-    "j .Ltlb_read_done\n"
-    "nop\n"
-
-    ".Ltlb_read_done:\n"
-    "sw $2, 12($sp)\n"
-    "j .Ltlb_exit\n"
-    "nop\n"
-
-    /* ---- WRITE PATH ---- */
-    ".Ltlb_write:\n"
-    "lw $5, 28($sp)\n"         /* a1 = saved t2 = write value */
-
-    "addiu $1, $12, -0x2B\n"   /* SW? */
-    "beqz  $1, .Ltlb_sw\n"
-    "nop\n"
-    "addiu $1, $12, -0x29\n"   /* SH? */
-    "beqz  $1, .Ltlb_sh\n"
-    "nop\n"
-    "addiu $1, $12, -0x28\n"   /* SB? */
-    "beqz  $1, .Ltlb_sb\n"
-    "nop\n"
-    /* Default: treat as SW */
-    "j .Ltlb_sw\n"
-    "nop\n"
-
-    ".Ltlb_sw:\n"
-    "jal WriteWord\n"
-    "nop\n"
-    "j .Ltlb_exit\n"
-    "nop\n"
-
-    ".Ltlb_sh:\n"
-    "jal WriteHalf\n"
-    "nop\n"
-    "j .Ltlb_exit\n"
-    "nop\n"
-
-    ".Ltlb_sb:\n"
-    "jal WriteByte\n"
-    "nop\n"
-
-    /* ---- COMMON EXIT ---- */
-    ".Ltlb_exit:\n"
-    /* Backpatch: patch faulting JIT code so this access never misses again */
-    "lui  $9, 0x7000\n"
-    "lw   $4, 0x3FE0($9)\n"       /* a0 = saved EPC (fault_insn_addr) */
-    "jal  TLB_Backpatch\n"
-    "nop\n"
-
-    /* Compute return address = saved EPC + 4 */
-    "lui  $9, 0x7000\n"
-    "lw   $9, 0x3FE0($9)\n"    /* t1 = saved EPC */
-    "addiu $9, $9, 4\n"        /* next insn */
-    "sw   $9, 24($sp)\n"       /* overwrite saved t1 */
-
-    /* Restore registers */
-    "lw $ra,  0($sp)\n"
-    "lw $4,   4($sp)\n"
-    "lw $5,   8($sp)\n"
-    "lw $2,  12($sp)\n"        /* v0 = read result */
-    "lw $3,  16($sp)\n"
-    "lw $8,  20($sp)\n"
-    "lw $9,  24($sp)\n"        /* t1 = return address */
-    "lw $10, 28($sp)\n"
-    "lw $11, 32($sp)\n"
-    "lw $12, 36($sp)\n"
-    "lw $13, 40($sp)\n"
-    "lw $14, 44($sp)\n"
-    "lw $15, 48($sp)\n"
-    "lw $24, 52($sp)\n"
-    "lw $25, 56($sp)\n"
-    "lw $1,  60($sp)\n"
-    "lw $28, 64($sp)\n"
-    "addiu $sp, $sp, 80\n"
-
-    /* Jump to instruction after fault (t1 = $9) */
-    "jr $9\n"
+    "lw   $5, 0x3FE0($9)\n"          /* a1 = saved EPC */
+    "jal  TLB_HandleFault\n"
+    "lw   $6, 0x3FE4($9)\n"          /* (delay) a2 = faulting insn */
+    "move $1, $2\n"                  /* at = resume address */
+
+    "lw $2,   24($sp)\n"
+    "lw $3,   28($sp)\n"
+    "lw $4,   32($sp)\n"
+    "lw $5,   36($sp)\n"
+    "lw $6,   40($sp)\n"
+    "lw $7,   44($sp)\n"
+    "lw $8,   48($sp)\n"
+    "lw $9,   52($sp)\n"
+    "lw $10,  56($sp)\n"
+    "lw $11,  60($sp)\n"
+    "lw $12,  64($sp)\n"
+    "lw $13,  68($sp)\n"
+    "lw $14,  72($sp)\n"
+    "lw $15,  76($sp)\n"
+    "lw $16,  80($sp)\n"
+    "lw $17,  84($sp)\n"
+    "lw $18,  88($sp)\n"
+    "lw $19,  92($sp)\n"
+    "lw $20,  96($sp)\n"
+    "lw $21, 100($sp)\n"
+    "lw $22, 104($sp)\n"
+    "lw $23, 108($sp)\n"
+    "lw $24, 112($sp)\n"
+    "lw $25, 116($sp)\n"
+    "lw $28, 128($sp)\n"
+    "lw $30, 136($sp)\n"
+    "lw $31, 140($sp)\n"
+    "addiu $sp, $sp, 144\n"
+
+    "jr $1\n"
     "nop\n"
 
     ".set pop\n"
@@ -365,6 +278,12 @@ void Setup_PSX_TLB(void)
     printf("TLB disabled (build without ENABLE_PSX_TLB)\n");
     return;
 #else
+    if (!psx_config.psx_tlb)
+    {
+        psx_tlb_base = 0;
+        printf("TLB disabled (psx_tlb = 0)\n");
+        return;
+    }
     printf("Setting up PSX TLB mapping...\n");
 
     /* ---- 1. RAM: VA 0x20000000, 1MB pages (1 entry = 2MB) ---- */
@@ -404,43 +323,13 @@ void Setup_PSX_TLB(void)
         printf("  RAM  TLB: verified OK\n");
     }
 
-    /* ---- 2. Scratchpad: VA 0x3F800000, 4KB pages ---- */
-    /* After mask+add: physical 0x1F800000 + 0x20000000 = VA 0x3F800000      */
-    /* Even page (0x3F800000): scratchpad_buf, V=1, D=1, C=3, G=1            */
-    /* Odd  page (0x3F801000): INVALID (V=0) — HW I/O, let it miss to trap   */
-    {
-        uint32_t sp_phys   = (uint32_t)scratchpad_buf & 0x1FFFFFFF;
-        uint32_t sp_va     = PSX_TLB_BASE + 0x1F800000; /* 0x3F800000 */
-        uint32_t page_mask = 0x00000000;   /* 4KB pages */
-        uint32_t entry_hi  = sp_va;        /* VPN2 */
-        uint32_t pfn0      = sp_phys >> 12;
-        /* Even: PFN | C=3 | D=1 | V=1 | G=1 */
-        uint32_t entry_lo0 = (pfn0 << 6) | (3 << 3) | (1 << 2) | (1 << 1) | 1;
-        /* Odd: INVALID (V=0, G=1 to keep global) — forces TLB miss for HW I/O */
-        uint32_t entry_lo1 = 1; /* G=1 only */
-
-        int idx = PutTLBEntry(page_mask, entry_hi, entry_lo0, entry_lo1);
-        printf("  SP   TLB[%d]: VA 0x%08lX -> PA 0x%08lX (4KB, cacheable)\n",
-               idx, (unsigned long)sp_va, (unsigned long)sp_phys);
-        printf("            : VA 0x%08lX INVALID (HW I/O trap)\n",
-               (unsigned long)(sp_va + 0x1000));
-
-        /* Verify */
-        scratchpad_buf[0] = 0xAB;
-        FlushCache(0);
-        volatile uint8_t *sp_test = (volatile uint8_t *)sp_va;
-        if (*sp_test == 0xAB)
-        {
-            printf("  SP   TLB: verified OK\n");
-            scratchpad_buf[0] = 0;
-        }
-        else
-        {
-            printf("  WARNING: SP TLB verification failed (read 0x%02X)\n", *sp_test);
-        }
-    }
+    /* Scratchpad is left unmapped: a 4KB pair entry would also cover the
+     * I/O page at 0x3F801000, and an invalid (V=0) half raises a TLB
+     * invalid exception on the general vector, not a refill.  Register-
+     * based scratchpad accesses miss once, then run through their stub;
+     * const-address ones are compiled as direct host accesses anyway. */
 
-    /* ---- 3. BIOS: VA 0x3FC00000, 256KB pages (1 entry = 512KB) ---- */
+    /* ---- 2. BIOS: VA 0x3FC00000, 256KB pages (1 entry = 512KB) ---- */
     /* After mask+add: physical 0x1FC00000 + 0x20000000 = VA 0x3FC00000       */
     {
         uint32_t bios_phys = (uint32_t)psx_bios & 0x1FFFFFFF;
@@ -465,6 +354,6 @@ void Setup_PSX_TLB(void)
     psx_tlb_base = PSX_TLB_BASE;
 
     printf("  TLB fast-path active: JIT S1 = 0x%08lX\n", (unsigned long)psx_tlb_base);
-    printf("  TLB entries used: 3 of 48 (RAM + Scratchpad + BIOS)\n");
+    printf("  TLB entries used: 2 of 48 (RAM + BIOS)\n");
 #endif /* ENABLE_PSX_TLB */
 }
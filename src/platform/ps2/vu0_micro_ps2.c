@@ -53,12 +53,11 @@ extern float vu0_lt_col1[4], vu0_lt_col2[4], vu0_lt_col3[4];
 extern float vu0_lc_col1[4], vu0_lc_col2[4], vu0_lc_col3[4];
 extern float vu0_bk_trans[4], vu0_zero_trans[4];
 
-/* Dirty check functions from gte.c */
-extern uint8_t vu0_matrix_dirty;
-#define VU0_RT_IS_DIRTY() (vu0_matrix_dirty & 0x01)
-#define VU0_LT_IS_DIRTY() (vu0_matrix_dirty & 0x02)
-#define VU0_BK_IS_DIRTY() (vu0_matrix_dirty & 0x04)
-#define VU0_LC_IS_DIRTY() (vu0_matrix_dirty & 0x08)
+/* Dirty checks on the VU0 lane of gte_matrix_dirty (superpsx.h) */
+#define VU0_RT_IS_DIRTY() (vu0_matrix_dirty & GTE_MTX_RT)
+#define VU0_LT_IS_DIRTY() (vu0_matrix_dirty & GTE_MTX_LL)
+#define VU0_BK_IS_DIRTY() (vu0_matrix_dirty & GTE_MTX_BK)
+#define VU0_LC_IS_DIRTY() (vu0_matrix_dirty & GTE_MTX_LC)
 extern void vu0_refresh_rt_matrix(R3000CPU *cpu);
 extern void vu0_refresh_lt_matrix(R3000CPU *cpu);
 extern void vu0_refresh_lc_matrix(R3000CPU *cpu);
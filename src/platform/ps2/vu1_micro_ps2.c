@@ -0,0 +1,65 @@
+/*
+ * vu1_micro.c — VU1 Micro Program for batched GTE transforms
+ *
+ * Assembled from vu1/rtps_batch.vsm via dvp-as and linked into the ELF
+ * as .vudata, like the VU0 programs.  Started from the EE by writing
+ * CMSAR1; data goes through VU1 data memory (0x1100C000).
+ */
+#include "vu1_micro_ps2.h"
+
+#if defined(_EE) && defined(ENABLE_VU0_MICRO)
+
+#include <string.h>
+
+extern unsigned char vu1_rtps_batch     __attribute__((section(".vudata")));
+extern unsigned char vu1_rtps_batch_end __attribute__((section(".vudata")));
+
+void vu1_micro_init(void)
+{
+    volatile uint8_t *micro_mem = (volatile uint8_t *)VU1_MICRO_MEM;
+    unsigned int size = &vu1_rtps_batch_end - &vu1_rtps_batch;
+
+    memcpy((void *)(micro_mem + VU1_PROG_RTPS_BATCH), &vu1_rtps_batch, size);
+    __asm__ __volatile__("sync.l" ::: "memory");
+}
+
+void vu1_micro_rtps_batch(const float *col1, const float *col2, const float *col3,
+                          const float *trans, const int32_t (*vert)[4], int n,
+                          int32_t (*mac)[4])
+{
+    volatile float *mf = (volatile float *)VU1_DATA_MEM;
+    volatile int32_t *mi = (volatile int32_t *)VU1_DATA_MEM;
+    uint32_t stat;
+
+    if (n > VU1_BATCH_MAX_VERTS)
+        n = VU1_BATCH_MAX_VERTS;
+
+    for (int i = 0; i < 4; i++)
+    {
+        mf[VU1_QW_RT_COL1 * 4 + i] = col1[i];
+        mf[VU1_QW_RT_COL2 * 4 + i] = col2[i];
+        mf[VU1_QW_RT_COL3 * 4 + i] = col3[i];
+        mf[VU1_QW_RT_TRANS * 4 + i] = trans[i];
+    }
+    for (int v = 0; v < n; v++)
+        for (int i = 0; i < 4; i++)
+            mi[(VU1_QW_VERTS + v) * 4 + i] = vert[v][i];
+    mi[VU1_QW_COUNT * 4] = n;
+    __asm__ __volatile__("sync.l" ::: "memory");
+
+    /* CMSAR1 write starts VU1; VPU-STAT bit 8 (VBS1) = busy */
+    __asm__ __volatile__("ctc2 %0, $31" ::"r"(VU1_PROG_RTPS_BATCH >> 3));
+    do
+    {
+        __asm__ __volatile__("cfc2 %0, $29" : "=r"(stat));
+    } while (stat & 0x100);
+
+    for (int v = 0; v < n; v++)
+    {
+        mac[v][0] = mi[(VU1_QW_OUT_MAC + v) * 4 + 0];
+        mac[v][1] = mi[(VU1_QW_OUT_MAC + v) * 4 + 1];
+        mac[v][2] = mi[(VU1_QW_OUT_MAC + v) * 4 + 2];
+    }
+}
+
+#endif /* _EE && ENABLE_VU0_MICRO */
@@ -0,0 +1,50 @@
+/*
+ * vu1_micro.h — VU1 Micro Mode batched GTE transforms
+ *
+ * VU1 runs the RT matrix × vertex + TR step of a whole run of queued
+ * RTPS/RTPT commands in one kick (gte_vu1_batch).  VU1 is otherwise
+ * idle here: the GS backend feeds GIF PATH3 directly.
+ *
+ * Compile-time flag: ENABLE_VU0_MICRO  (same .vsm pipeline as VU0)
+ * Runtime flag:      gte_vu1_batch     (superpsx.ini, 0/1)
+ */
+#ifndef VU1_MICRO_H
+#define VU1_MICRO_H
+
+#include <stdint.h>
+
+#ifdef _EE
+#include "superpsx.h"
+
+/* ====================================================================
+ * VU1 Memory Map (EE-accessible addresses)
+ * ==================================================================== */
+#define VU1_MICRO_MEM   0x11008000u   /* 16KB micro/instruction memory */
+#define VU1_DATA_MEM    0x1100C000u   /* 16KB data memory (1024 QWs)   */
+
+/* ====================================================================
+ * VU1 Data Memory Layout (QW index), see vu1/rtps_batch.vsm
+ * ==================================================================== */
+#define VU1_QW_COUNT        0   /* .x = vertex count */
+#define VU1_QW_RT_COL1      1   /* RT matrix (float, /4096) */
+#define VU1_QW_RT_COL2      2
+#define VU1_QW_RT_COL3      3
+#define VU1_QW_RT_TRANS     4
+#define VU1_QW_VERTS       16   /* int32 x, y, z, 0 per vertex */
+#define VU1_QW_OUT_MAC     64   /* MAC1, MAC2, MAC3, - per vertex */
+#define VU1_BATCH_MAX_VERTS (VU1_QW_OUT_MAC - VU1_QW_VERTS)
+
+/* Micro program entry points (byte offsets in VU1 micro memory) */
+#define VU1_PROG_RTPS_BATCH 0x000
+
+/* Upload the VU1 programs.  Call ONCE at dynarec init time. */
+void vu1_micro_init(void);
+
+/* mac[i] = col * vert[i] + trans for n vertices (n <= VU1_BATCH_MAX_VERTS),
+ * as int32 MAC1-3.  Blocks until VU1 finishes. */
+void vu1_micro_rtps_batch(const float *col1, const float *col2, const float *col3,
+                          const float *trans, const int32_t (*vert)[4], int n,
+                          int32_t (*mac)[4]);
+
+#endif /* _EE */
+#endif /* VU1_MICRO_H */
@@ -1,17 +1,64 @@
 /**
  * audio_psp_backend.c — PSP audio output via sceAudio
+ *
+ * Threaded mode (Audio_Backend_StartThread): Play copies into an AudioRing;
+ * an output thread sends 512-frame blocks with sceAudioOutputBlocking and
+ * pads with silence (counted as an underrun) when the ring runs short.
+ *
+ * Rates other than 44100 (audio_rate) go through the SRC output channel,
+ * which resamples in hardware.
  */
 #include "audio_backend.h"
+#include "audio_ring.h"
 #include <pspaudio.h>
+#include <pspthreadman.h>
 #include <string.h>
 
 static int audio_channel = -1;
+static int audio_src = 0; /* 1 = SRC channel (sample rate != 44100) */
 static int audio_volume = PSP_AUDIO_VOLUME_MAX;
 
 #define PSP_AUDIO_BLOCK_SAMPLES 512
 static int16_t audio_internal_buf[2048 * 2] __attribute__((aligned(64)));
 static int audio_buf_samples = 0;
 
+static void audio_output_blocking(const int16_t *buf) {
+    if (audio_src)
+        sceAudioSRCOutputBlocking(audio_volume, (void *)buf);
+    else
+        sceAudioOutputBlocking(audio_channel, audio_volume, (void *)buf);
+}
+
+static void audio_release_channel(void) {
+    if (audio_channel < 0) return;
+    if (audio_src)
+        sceAudioSRCChRelease();
+    else
+        sceAudioChRelease(audio_channel);
+    audio_channel = -1;
+    audio_src = 0;
+}
+
+static AudioRing out_ring;
+static SceUID out_thread = -1;
+static volatile int out_quit;
+static int out_primed;
+static int16_t out_block[PSP_AUDIO_BLOCK_SAMPLES * 2] __attribute__((aligned(64)));
+
+static int audio_out_thread(SceSize args, void *argp) {
+    (void)args; (void)argp;
+    while (!out_quit) {
+        int n = AudioRing_Read(&out_ring, out_block, PSP_AUDIO_BLOCK_SAMPLES);
+        if (n < PSP_AUDIO_BLOCK_SAMPLES) {
+            memset(&out_block[n * 2], 0, (PSP_AUDIO_BLOCK_SAMPLES - n) * 2 * sizeof(int16_t));
+            if (out_primed)
+                out_ring.underruns++;
+        }
+        audio_output_blocking(out_block);
+    }
+    return 0;
+}
+
 int Audio_Backend_Init(void) {
     audio_buf_samples = 0;
     return 0; /* Channel allocated on first configure */
@@ -21,10 +68,7 @@ int Audio_Backend_Configure(int sample_rate, int bits, int channels, int volume)
     (void)bits; /* PSP audio is always 16-bit */
 
     /* Release previous channel if any */
-    if (audio_channel >= 0) {
-        sceAudioChRelease(audio_channel);
-        audio_channel = -1;
-    }
+    audio_release_channel();
 
     /* PSP audio works in fixed-size sample blocks.
      * sceAudioChReserve(channel, samplecount, format)
@@ -32,21 +76,33 @@ int Audio_Backend_Configure(int sample_rate, int bits, int channels, int volume)
     int format = (channels == 1) ? PSP_AUDIO_FORMAT_MONO : PSP_AUDIO_FORMAT_STEREO;
     
     /* We use a fixed block size of 512 samples for stability */
-    audio_channel = sceAudioChReserve(PSP_AUDIO_NEXT_CHANNEL, PSP_AUDIO_BLOCK_SAMPLES, format);
-    if (audio_channel < 0) return -1;
+    if (sample_rate != 44100) {
+        /* SRC channel: hardware resampling from 22050 / 32000 */
+        if (sceAudioSRCChReserve(PSP_AUDIO_BLOCK_SAMPLES, sample_rate, channels) < 0) return -1;
+        audio_channel = 0;
+        audio_src = 1;
+    } else {
+        audio_channel = sceAudioChReserve(PSP_AUDIO_NEXT_CHANNEL, PSP_AUDIO_BLOCK_SAMPLES, format);
+        if (audio_channel < 0) return -1;
+    }
 
     audio_volume = (volume * PSP_AUDIO_VOLUME_MAX) / 100;
     if (audio_volume > PSP_AUDIO_VOLUME_MAX) audio_volume = PSP_AUDIO_VOLUME_MAX;
 
     audio_buf_samples = 0;
 
-    (void)sample_rate; /* PSP outputs at 44100 — resampling needed if different */
     return 0;
 }
 
 void Audio_Backend_Play(const int16_t *buffer, int size_bytes) {
     if (audio_channel < 0 || !buffer || size_bytes <= 0) return;
 
+    if (out_thread >= 0) {
+        AudioRing_Write(&out_ring, buffer, size_bytes / (2 * sizeof(int16_t)));
+        out_primed = 1;
+        return;
+    }
+
     int incoming_samples = size_bytes / (2 * sizeof(int16_t)); /* Assuming stereo */
     int samples_processed = 0;
 
@@ -67,16 +123,47 @@ void Audio_Backend_Play(const int16_t *buffer, int size_bytes) {
              * This naturally paces the emulator to real-time via the audio
              * hardware clock (44100 Hz crystal), replacing timer-based frame
              * limiting with jitter-free audio-driven sync. */
-            sceAudioOutputBlocking(audio_channel, audio_volume, audio_internal_buf);
+            audio_output_blocking(audio_internal_buf);
             audio_buf_samples = 0;
         }
     }
 }
 
+int Audio_Backend_StartThread(int latency_frames) {
+    if (out_thread >= 0) return 0;
+    if (audio_channel < 0) return -1;
+    if (AudioRing_Init(&out_ring, (uint32_t)latency_frames * 2) != 0) return -1;
+
+    out_quit = 0;
+    out_primed = 0;
+    out_thread = sceKernelCreateThread("audio_out", audio_out_thread, 0x10, 0x1000, 0, 0);
+    if (out_thread < 0 || sceKernelStartThread(out_thread, 0, 0) < 0) {
+        if (out_thread >= 0) sceKernelDeleteThread(out_thread);
+        out_thread = -1;
+        AudioRing_Free(&out_ring);
+        return -1;
+    }
+    return 0;
+}
+
+int Audio_Backend_Queued(void) {
+    if (out_thread < 0) return -1;
+    return (int)AudioRing_Fill(&out_ring);
+}
+
+void Audio_Backend_GetStats(uint32_t *underruns, uint32_t *overruns) {
+    *underruns = out_ring.underruns;
+    *overruns = out_ring.overruns;
+}
+
 void Audio_Backend_Shutdown(void) {
-    if (audio_channel >= 0) {
-        sceAudioChRelease(audio_channel);
-        audio_channel = -1;
+    if (out_thread >= 0) {
+        out_quit = 1;
+        sceKernelWaitThreadEnd(out_thread, NULL);
+        sceKernelDeleteThread(out_thread);
+        out_thread = -1;
+        AudioRing_Free(&out_ring);
     }
+    audio_release_channel();
     audio_buf_samples = 0;
 }
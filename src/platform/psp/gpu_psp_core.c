@@ -28,6 +28,8 @@
 uint32_t gpu_stat = 0x1C000000;
 uint32_t gpu_read = 0;
 volatile int gpu_pending_vblank_flush = 0;
+int gpu_readback_pending = 0; /* never set: PSP reads back synchronously */
+int gpu_queue_pending = 0;    /* never set: PSP translates GP0 DMA at once */
 uint64_t gpu_estimated_pixels = 0;
 
 int fb_address = 0;
@@ -118,13 +120,70 @@ static struct
 /* Track which FB is the current back buffer for merged display blit */
 static int back_fb_offset = PSP_FB0_OFFSET;
 
-unsigned int __attribute__((aligned(16))) display_list[2][262144];
+unsigned int __attribute__((aligned(16))) display_list[PSP_DL_COUNT][PSP_DL_WORDS];
 
 /* ── Vertex Pool (for GU_SEND mode) ─────────────────────────────── */
-uint8_t __attribute__((aligned(64))) vpool_buf[2][VPOOL_SIZE];
+uint8_t __attribute__((aligned(64))) vpool_buf[PSP_DL_COUNT][VPOOL_SIZE];
 int vpool_offset;
 int dl_active = 0;
-int sync_id[2] = {0, 0};
+int sync_id[PSP_DL_COUNT];
+
+/* In-flight tracking: every submission ends in FINISH with the next
+ * 16-bit sequence number, and the finish callback records the last one
+ * the GE reached.  Lists run in order, so a list+pool pair is free once
+ * ge_done_seq reaches the seq it was last sent with; only then can it
+ * be reused without sceGeListSync. */
+static uint16_t dl_seq[PSP_DL_COUNT];
+static uint16_t ge_sent_seq;
+static volatile uint16_t ge_done_seq;
+
+static void ge_finish_cb(int id)
+{
+    ge_done_seq = (uint16_t)id;
+}
+
+static int dl_busy(int dl)
+{
+    return (int16_t)(ge_done_seq - dl_seq[dl]) < 0;
+}
+
+/* Early kicks (gpu_psp_kick): the list is sent in chunks, each one
+ * starting where the previous sceGuFinish ended.  vpool_kick is the
+ * vertex pool offset already written back for the GE. */
+#define KICK_MIN_BYTES (16 * 1024)
+static unsigned int *dl_chunk = display_list[0];
+static int vpool_kick;
+
+static void vpool_writeback(void)
+{
+    if (vpool_offset >= vpool_kick)
+        sceKernelDcacheWritebackRange(vpool_buf[dl_active] + vpool_kick, vpool_offset - vpool_kick);
+    else /* pool wrapped since the last kick */
+        sceKernelDcacheWritebackRange(vpool_buf[dl_active], VPOOL_SIZE);
+}
+
+/* Close and send the list built since dl_chunk.  Returns the bytes the
+ * list used (sceGuFinishId). */
+static int dl_submit(void)
+{
+    vpool_writeback();
+    dl_seq[dl_active] = ++ge_sent_seq;
+    int size = sceGuFinishId(dl_seq[dl_active]);
+    sync_id[dl_active] = sceGuSendList(GU_TAIL, dl_chunk, NULL);
+    return size;
+}
+
+/* Build on in the next list+pool pair of the ring, waiting only if the
+ * GE may still read it from its previous submission */
+static void dl_advance(void)
+{
+    dl_active = (dl_active + 1) % PSP_DL_COUNT;
+    if (dl_busy(dl_active))
+        sceGeListSync(sync_id[dl_active], 0);
+    vpool_offset = 0;
+    vpool_kick = 0;
+    dl_chunk = display_list[dl_active];
+}
 
 /* ── GPU Core Implementation ────────────────────────────────────── */
 
@@ -138,8 +197,10 @@ void GPU_Backend_Init(void)
         if (psx_vram_shadow)
             memset(psx_vram_shadow, 0, 1024 * 512 * sizeof(uint16_t));
     }
+    Prim_InitTexCache();
 
     sceGuInit();
+    sceGuSetCallback(GU_CALLBACK_FINISH, ge_finish_cb);
     sceGuStart(GU_DIRECT, display_list[0]);
 
     /* Double-buffer: draw→FB0, display→FB1.
@@ -179,8 +240,10 @@ void GPU_Backend_Init(void)
      * GU_SEND builds the list offline (no per-command stall updates).
      * Submitted as one batch via sceGuSendList at frame end / Flush. */
     vpool_offset = 0;
+    vpool_kick = 0;
     dl_active = 0;
-    sceGuStart(GU_SEND, display_list[dl_active]);
+    dl_chunk = display_list[dl_active];
+    sceGuStart(GU_SEND, dl_chunk);
     sceGuDrawBufferList(GU_PSM_5551, (void *)PSP_VRAM_OFFSET, 1024);
     sceGuScissor(0, 0, 1024, 512);
     sceGuEnable(GU_SCISSOR_TEST);
@@ -197,35 +260,59 @@ void GPU_Backend_Init(void)
 void GPU_Backend_Flush(void)
 {
     Prim_FlushBatch();
-    sceKernelDcacheWritebackRange(vpool_buf[dl_active], vpool_offset);
-    sceGuFinish();
-
-    sync_id[dl_active] = sceGuSendList(GU_TAIL, display_list[dl_active], NULL);
-    /* We must sync here because most callers of Flush() follow with CPU VRAM access */
+    dl_submit();
+    /* We must sync here because most callers of Flush() follow with CPU VRAM access.
+     * Lists run in order, so this also covers every earlier kick and
+     * every other list of the ring. */
     sceGeListSync(sync_id[dl_active], 0);
 
     vpool_offset = 0;
-    sceGuStart(GU_SEND, display_list[dl_active]);
+    vpool_kick = 0;
+    dl_chunk = display_list[dl_active];
+    sceGuStart(GU_SEND, dl_chunk);
     sceGuDrawBufferList(GU_PSM_5551, (void *)PSP_VRAM_OFFSET, 1024);
     Prim_InvalidateGSState();
 }
 
+/* The list just sent is the last one queued, so waiting on it alone
+ * also covers the GE copies (readbacks) queued before it */
 void GPU_Backend_FlushSync(void)
 {
-    Prim_FlushBatch();
-    sceKernelDcacheWritebackRange(vpool_buf[dl_active], vpool_offset);
-    sceGuFinish();
-    sceGuSendList(GU_TAIL, display_list[dl_active], NULL);
-    sceGuSync(0, 0);
-    vpool_offset = 0;
-    sceGuStart(GU_SEND, display_list[dl_active]);
-    sceGuDrawBufferList(GU_PSM_5551, (void *)PSP_VRAM_OFFSET, 1024);
-    Prim_InvalidateGSState();
+    GPU_Backend_Flush();
 }
 
 void GPU_Backend_SetupEnvironment(void)
 {
-    sceGuStart(GU_SEND, display_list[dl_active]);
+    dl_chunk = display_list[dl_active];
+    sceGuStart(GU_SEND, dl_chunk);
+}
+
+void GPU_Backend_KickList(void)
+{
+    int used = sceGuCheckList(); /* bytes queued since the last start */
+    if (used < KICK_MIN_BYTES)
+        return;
+
+    Prim_FlushBatch();
+    /* No sync: the GE draws this chunk while the CPU keeps going */
+    int size = dl_submit();
+
+    /* Near the end of the list or the vertex pool: go on in the next
+     * pair of the ring.  The pool must not wrap over vertices the GE
+     * may still be reading. */
+    int dl_words = (int)(dl_chunk - display_list[dl_active]) + size / 4;
+    if (dl_words > PSP_DL_WORDS * 3 / 4 || vpool_offset > VPOOL_SIZE * 3 / 4)
+    {
+        dl_advance();
+    }
+    else
+    {
+        vpool_kick = vpool_offset;
+        dl_chunk += ((size + 15) & ~15) / 4;
+    }
+    sceGuStart(GU_SEND, dl_chunk);
+    sceGuDrawBufferList(GU_PSM_5551, (void *)PSP_VRAM_OFFSET, 1024);
+    Prim_InvalidateGSState();
 }
 
 void GPU_Backend_UpdateDisplay(void)
@@ -399,28 +486,17 @@ void GPU_Backend_UpdateDisplay(void)
     }
 #endif /* DEBUG_SHOW_FULL_VRAM */
 
-    sceKernelDcacheWritebackRange(vpool_buf[dl_active], vpool_offset);
-    sceGuFinish();
-
-    sync_id[dl_active] = sceGuSendList(GU_TAIL, display_list[dl_active], NULL);
+    dl_submit();
     /* NO SYNC HERE — GE processes blit while CPU starts next frame.
-     * We will check for sync_id[new_dl] when we restart the list below. */
+     * dl_advance below waits only if the next pair is still in flight. */
     sceGuSwapBuffers();
 
     /* Toggle back buffer for next frame */
     back_fb_offset = (back_fb_offset == PSP_FB0_OFFSET) ? PSP_FB1_OFFSET : PSP_FB0_OFFSET;
 
-    /* ── Switch to other DL+vpool ────── */
-    dl_active ^= 1;
-
-    /* Only wait if the other buffer is STILL active in the GE (rare at 333MHz) */
-    if (sync_id[dl_active] != 0)
-    {
-        sceGeListSync(sync_id[dl_active], 0);
-    }
-
-    vpool_offset = 0;
-    sceGuStart(GU_SEND, display_list[dl_active]);
+    /* ── Switch to the next DL+vpool ────── */
+    dl_advance();
+    sceGuStart(GU_SEND, dl_chunk);
     sceGuDrawBufferList(GU_PSM_5551, (void *)PSP_VRAM_OFFSET, 1024);
     sceGuScissor(draw_clip_x1, draw_clip_y1,
                  draw_clip_x2 - draw_clip_x1 + 1, draw_clip_y2 - draw_clip_y1 + 1);
@@ -538,6 +614,7 @@ int GPU_Backend_TryFastPoly(uint32_t *cmd_buffer)
 
 uint32_t GPU_Read(void)
 {
+    GPU_GP0FifoSync();
     if (vram_read_remaining > 0)
     {
         uint16_t p0 = 0, p1 = 0;
@@ -568,6 +645,9 @@ uint32_t GPU_ReadStatus(void)
     extern uint64_t sched_cached_earliest;
     extern void Sched_Tick(uint64_t now);
 
+    /* Buffered GP0 words can change GPUSTAT and start a busy period */
+    GPU_GP0FifoSync();
+
     if (global_cycles < gpu_busy_until)
     {
         global_cycles = gpu_busy_until;
@@ -6,6 +6,7 @@
 #include "gpu_state.h"
 #include "gpu_psp_state.h"
 #include "profiler.h"
+#include "config.h"
 
 extern uint8_t *psx_ram;
 
@@ -18,6 +19,9 @@ int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr) {
     uint32_t sync_mode = (chcr >> 9) & 3;
     uint32_t direction = chcr & 1;
 
+    /* GP0 port words the JIT buffered were written before this DMA */
+    GPU_GP0FifoSync();
+
     PROF_PUSH(PROF_GPU_DMA);
 
     if (sync_mode == 0 || sync_mode == 1) {
@@ -54,6 +58,10 @@ int GPU_DMA2(uint32_t madr, uint32_t bcr, uint32_t chcr) {
             addr = next & 0x1FFFFC;
             packets++;
         }
+
+        /* End of an ordering table: let the GE start on it */
+        if (psx_config.gpu_psp_kick)
+            GPU_Backend_KickList();
     }
 
     PROF_POP(PROF_GPU_DMA);
@@ -47,7 +47,12 @@ static inline uint32_t PSX_to_ABGR_texblend(uint32_t c)
 /* ── State Management ───────────────────────────────────────────── */
 
 /* ── Vertex Batch ────────────────────────────────────────────────── */
-#define VBATCH_MAX 256  /* max verts per batch */
+/* Vertices are written in place at the head of the vertex pool; the
+ * flush only claims the bytes used and appends the index list.  A batch
+ * grows until a state change, VBATCH_MAX vertices or the end of the
+ * pool, so one sceGuDrawArray covers as much of the frame as possible. */
+#define VBATCH_MAX 4096 /* max verts per batch */
+#define VBATCH_MIN_ROOM 4096 /* pool bytes below which a new batch wraps the pool */
 
 /* Index buffer for quad→triangle decomposition: 4 unique verts + 6 indices
  * per quad instead of 6 duplicated verts.  Used when prim == GU_TRIANGLES. */
@@ -55,12 +60,14 @@ static inline uint32_t PSX_to_ABGR_texblend(uint32_t c)
 
 static struct {
     union {
-        PspVertFlat flat[VBATCH_MAX];
-        PspVertTex  tex[VBATCH_MAX];
-    } v;
+        PspVertFlat *flat;
+        PspVertTex  *tex;
+        uint8_t     *base;
+    } v;         /* batch start in vpool_buf[dl_active] */
     uint16_t idx[IBATCH_MAX];
     int count;   /* unique vertices */
     int icount;  /* index count (0 = non-indexed) */
+    int cap;     /* vertices that fit before the pool end */
     int vsize;   /* sizeof per vertex */
     int vfmt;    /* GU format flags (without GU_TRANSFORM_2D) */
     int prim;    /* GU_TRIANGLES, GU_LINES, GU_SPRITES */
@@ -77,6 +84,7 @@ static int cached_blend_mode = -1; /* semi_trans_mode 0-3 */
 static int cached_dither_on = -1;  /* 0=off, 1=on */
 static int cached_tex_on = -1;     /* 0=off, 1=on */
 static int cached_alpha_test_on = -1; /* 0=off, 1=alpha test(T4/T8), 2=color test(T16) */
+static int cached_stp_stencil = -1; /* 1 = stencil forces mask bit 0 (STP single pass) */
 
 static inline void vbatch_draw(int prim, int vfmt, int count, int icount,
                                void *vdst, void *idst)
@@ -99,9 +107,9 @@ static void vbatch_flush(void)
     if (vbatch.count == 0) return;
     gpu_frame_stats.vbatch_flushes++;
     gpu_frame_stats.vbatch_verts += vbatch.count;
-    int vbytes = vbatch.count * vbatch.vsize;
-    void *vdst = vpool_alloc(vbytes);
-    memcpy(vdst, &vbatch.v, vbytes);
+    /* Claim the vertices already written at the pool head */
+    void *vdst = vbatch.v.base;
+    vpool_offset += (vbatch.count * vbatch.vsize + 3) & ~3;
 
     void *idst = NULL;
     int ibytes = 0;
@@ -115,7 +123,8 @@ static void vbatch_flush(void)
         sceGuScissor(0, 0, 1024, 512);
 
     if (vbatch.stp_two_pass) {
-        /* Stencil-based STP 3-pass for textured semi-transparent T4/T8.
+        /* Stencil-based STP 3-pass for textured semi-transparent T4/T8
+         * in the modes the single pass can't express (apply_blend_tex).
          *
          * CLUT 8888 alpha: 0x00=transparent, 0x80=STP0, 0xFF=STP1.
          * After modulate: 0x00, 0x7F, 0xFE.
@@ -173,6 +182,19 @@ static void vbatch_flush(void)
     vbatch.stp_two_pass = 0;
 }
 
+/* Start a batch at the pool head.  Room is left for the index list,
+ * which the flush appends after the vertices. */
+static void vbatch_open(int vsize)
+{
+    if (VPOOL_SIZE - vpool_offset < VBATCH_MIN_ROOM)
+        vpool_offset = 0; /* wrap, as vpool_alloc does */
+    int room = VPOOL_SIZE - vpool_offset;
+    int cap = room / (vsize + 3); /* vertex + up to 1.5 indices of 2 bytes */
+    vbatch.cap = (cap < VBATCH_MAX) ? cap : VBATCH_MAX;
+    vbatch.v.base = &vpool_buf[dl_active][vpool_offset];
+    vbatch.vsize = vsize;
+}
+
 /* Ensure batch is compatible; flush if not.
  * nverts = unique vertices to add, nidx = indices to add (0 for non-indexed). */
 static inline void vbatch_prepare_idx(int prim, int vfmt, int vsize,
@@ -181,12 +203,13 @@ static inline void vbatch_prepare_idx(int prim, int vfmt, int vsize,
     if (vbatch.count > 0 &&
         (vbatch.prim != prim || vbatch.vfmt != vfmt ||
          vbatch.full_scissor != 0 || vbatch.stp_two_pass != 0 ||
-         vbatch.count + nverts > VBATCH_MAX ||
+         vbatch.count + nverts > vbatch.cap ||
          vbatch.icount + nidx > IBATCH_MAX))
         vbatch_flush();
+    if (vbatch.count == 0)
+        vbatch_open(vsize);
     vbatch.prim = prim;
     vbatch.vfmt = vfmt;
-    vbatch.vsize = vsize;
 }
 
 static inline void vbatch_prepare(int prim, int vfmt, int vsize, int nverts)
@@ -201,11 +224,12 @@ static inline void vbatch_prepare(int prim, int vfmt, int vsize, int nverts)
 static inline void vbatch_prepare_idx_stp(int prim, int vfmt, int vsize,
                                           int nverts, int nidx)
 {
+    (void)nverts; (void)nidx;
     if (vbatch.count > 0)
         vbatch_flush();
+    vbatch_open(vsize);
     vbatch.prim = prim;
     vbatch.vfmt = vfmt;
-    vbatch.vsize = vsize;
     vbatch.stp_two_pass = 1;
 }
 
@@ -223,14 +247,123 @@ static inline void vbatch_prepare_fill(int nverts)
     if (vbatch.count > 0 &&
         (vbatch.prim != prim || vbatch.vfmt != vfmt ||
          vbatch.full_scissor != 1 || vbatch.stp_two_pass != 0 ||
-         vbatch.count + nverts > VBATCH_MAX))
+         vbatch.count + nverts > vbatch.cap))
         vbatch_flush();
+    if (vbatch.count == 0)
+        vbatch_open(vsize);
     vbatch.prim = prim;
     vbatch.vfmt = vfmt;
-    vbatch.vsize = vsize;
     vbatch.full_scissor = 1;
 }
 
+/* Rectangles join an open triangle batch of the same vertex format as an
+ * indexed quad instead of flushing it to start a GU_SPRITES batch. */
+static inline int vbatch_join_tris(int vfmt)
+{
+    return vbatch.count > 0 && vbatch.prim == GU_TRIANGLES && vbatch.vfmt == vfmt &&
+           !vbatch.full_scissor && !vbatch.stp_two_pass &&
+           vbatch.count + 4 <= vbatch.cap && vbatch.icount + 6 <= IBATCH_MAX;
+}
+
+/* Indices for the 4 vertices just added (TL, TR, BL, BR) */
+static inline void vbatch_quad_idx(void)
+{
+    uint16_t base = (uint16_t)(vbatch.count - 4);
+    uint16_t *ix = &vbatch.idx[vbatch.icount];
+    ix[0] = base; ix[1] = base+1; ix[2] = base+2;
+    ix[3] = base+2; ix[4] = base+1; ix[5] = base+3;
+    vbatch.icount += 6;
+}
+
+static void emit_rect_flat(int16_t x0, int16_t y0, int16_t w, int16_t h, uint32_t color)
+{
+    int vfmt = GU_COLOR_8888 | GU_VERTEX_16BIT;
+    if (vbatch_join_tris(vfmt)) {
+        PspVertFlat *v = &vbatch.v.flat[vbatch.count];
+        v[0].color = color; v[0].x = x0;     v[0].y = y0;     v[0].z = 0;
+        v[1].color = color; v[1].x = x0 + w; v[1].y = y0;     v[1].z = 0;
+        v[2].color = color; v[2].x = x0;     v[2].y = y0 + h; v[2].z = 0;
+        v[3].color = color; v[3].x = x0 + w; v[3].y = y0 + h; v[3].z = 0;
+        vbatch.count += 4;
+        vbatch_quad_idx();
+        return;
+    }
+    vbatch_prepare(GU_SPRITES, vfmt, sizeof(PspVertFlat), 2);
+    PspVertFlat *v = &vbatch.v.flat[vbatch.count];
+    v[0].color = color; v[0].x = x0;     v[0].y = y0;     v[0].z = 0;
+    v[1].color = color; v[1].x = x0 + w; v[1].y = y0 + h; v[1].z = 0;
+    vbatch.count += 2;
+}
+
+/* Rect straight from EDRAM (Tex_DirectRowScale): one sprite per PSX row
+ * with V at the centre of the texture row that holds it */
+static void emit_rect_rows(int16_t x0, int16_t y0, int16_t w, int16_t h,
+                           uint8_t u0, uint8_t v0, uint32_t color,
+                           uint32_t clut_word, int is_raw, int scale)
+{
+    int vfmt = GU_TEXTURE_32BITF | GU_COLOR_8888 | GU_VERTEX_16BIT;
+    float fu0 = (float)u0;
+    float fu1 = (float)(u0 + w);
+    int band_rows = scale == 4 ? 128 : 256;
+    int band = -1;
+
+    for (int r = 0; r < h; r++) {
+        int tv = (v0 + r) & 0xFF;
+        if (tv / band_rows != band) {
+            band = tv / band_rows;
+            Tex_SetupDirect(clut_word, band);
+            if (is_raw)
+                Tex_ApplyFuncReplace();
+        }
+        float fv = (float)((tv % band_rows) * scale) + 0.5f;
+        vbatch_prepare(GU_SPRITES, vfmt, sizeof(PspVertTex), 2);
+        PspVertTex *v = &vbatch.v.tex[vbatch.count];
+        v[0].u = fu0; v[0].v = fv; v[0].color = color; v[0].x = x0;     v[0].y = y0 + r;     v[0].z = 0;
+        v[1].u = fu1; v[1].v = fv; v[1].color = color; v[1].x = x0 + w; v[1].y = y0 + r + 1; v[1].z = 0;
+        vbatch.count += 2;
+    }
+}
+
+/* stp = textured semi-trans T4/T8 (STP two-pass, never merged).
+ * Binds the texture itself: direct from EDRAM or through the tcache. */
+static void emit_rect_tex(int16_t x0, int16_t y0, int16_t w, int16_t h,
+                          uint8_t u0, uint8_t v0, uint32_t color,
+                          uint32_t clut_word, int is_raw, int stp)
+{
+    int scale = Tex_DirectRowScale(stp);
+    if (scale) {
+        emit_rect_rows(x0, y0, w, h, u0, v0, color, clut_word, is_raw, scale);
+        return;
+    }
+    Tex_SetupIfChanged(clut_word);
+    if (is_raw)
+        Tex_ApplyFuncReplace();
+
+    int vfmt = GU_TEXTURE_32BITF | GU_COLOR_8888 | GU_VERTEX_16BIT;
+    float fu0 = (float)Apply_Tex_Window_U(u0);
+    float fu1 = (float)Apply_Tex_Window_U(u0 + w);
+    float fv0 = (float)Apply_Tex_Window_V(v0);
+    float fv1 = (float)Apply_Tex_Window_V(v0 + h);
+    if (!stp && vbatch_join_tris(vfmt)) {
+        PspVertTex *v = &vbatch.v.tex[vbatch.count];
+        v[0].u = fu0; v[0].v = fv0; v[0].color = color; v[0].x = x0;     v[0].y = y0;     v[0].z = 0;
+        v[1].u = fu1; v[1].v = fv0; v[1].color = color; v[1].x = x0 + w; v[1].y = y0;     v[1].z = 0;
+        v[2].u = fu0; v[2].v = fv1; v[2].color = color; v[2].x = x0;     v[2].y = y0 + h; v[2].z = 0;
+        v[3].u = fu1; v[3].v = fv1; v[3].color = color; v[3].x = x0 + w; v[3].y = y0 + h; v[3].z = 0;
+        vbatch.count += 4;
+        vbatch_quad_idx();
+        return;
+    }
+    if (stp)
+        vbatch_prepare_stp(GU_SPRITES, vfmt, sizeof(PspVertTex), 2);
+    else
+        vbatch_prepare(GU_SPRITES, vfmt, sizeof(PspVertTex), 2);
+    PspVertTex *v = &vbatch.v.tex[vbatch.count];
+    v[0].u = fu0; v[0].v = fv0; v[0].color = color; v[0].x = x0;     v[0].y = y0;     v[0].z = 0;
+    v[1].u = fu1; v[1].v = fv1; v[1].color = color; v[1].x = x0 + w; v[1].y = y0 + h; v[1].z = 0;
+    vbatch.count += 2;
+}
+
 void Prim_FlushBatch(void) { vbatch_flush(); }
 
 static void apply_dither(int is_shaded, int is_textured, int is_raw_tex)
@@ -244,8 +377,19 @@ static void apply_dither(int is_shaded, int is_textured, int is_raw_tex)
     }
 }
 
+/* Mask bit back to what GP0(E6h) asked for after an STP single pass */
+static void restore_stp_stencil(void)
+{
+    if (cached_stp_stencil != 0) {
+        vbatch_flush();
+        GPU_Backend_SetMaskBit(mask_set_bit, mask_check_bit);
+        cached_stp_stencil = 0;
+    }
+}
+
 static void apply_blend(int is_semi_trans)
 {
+    restore_stp_stencil();
     if (is_semi_trans)
     {
         if (cached_blend_on != 1) {
@@ -283,6 +427,59 @@ static void apply_blend(int is_semi_trans)
     }
 }
 
+/* GE blend factor 7, 2·(1 − As); pspgu.h doesn't name it */
+#define GE_BLEND_DOUBLE_ONE_MINUS_SRC_ALPHA 7
+
+/* Textured semi-trans T4/T8: only STP=1 texels blend.  Modes 0 and 1 go
+ * in one pass with the CLUT alpha swapped (TEX_CLUT_STP_BLEND: STP=0 →
+ * 1.0, STP=1 → 0.5) and factors taken from it:
+ *   mode 0  F·As + B·(1 − As)     STP=0: F    STP=1: F/2 + B/2
+ *   mode 1  F    + B·2(1 − As)    STP=0: F    STP=1: F + B
+ * B − F and B + F/4 can't be derived from As and keep the stencil
+ * two-pass.  With no GP0(E6h) mask state the stencil writes bit 15 as 0
+ * over the primitive, as the two-pass leaves it (the swapped alpha would
+ * write it inverted); mask set / check stay in force.
+ * Returns STP_* for the caller to pick the CLUT and batch. */
+#define STP_NONE     0
+#define STP_BLEND    1 /* single pass, clut_word | TEX_CLUT_STP_BLEND */
+#define STP_TWO_PASS 2 /* vbatch_prepare*_stp */
+
+static int apply_blend_tex(int is_semi_trans)
+{
+    if (!is_semi_trans || tex_page_format >= 2) {
+        apply_blend(is_semi_trans);
+        return STP_NONE;
+    }
+    if (semi_trans_mode > 1) {
+        apply_blend(1);
+        return STP_TWO_PASS;
+    }
+
+    int mode = 4 + semi_trans_mode; /* apart from the GU_FIX modes */
+    if (cached_blend_on != 1) {
+        vbatch_flush();
+        sceGuEnable(GU_BLEND);
+        cached_blend_on = 1;
+    }
+    if (cached_blend_mode != mode) {
+        vbatch_flush();
+        if (semi_trans_mode == 0)
+            sceGuBlendFunc(GU_ADD, GU_SRC_ALPHA, GU_ONE_MINUS_SRC_ALPHA, 0, 0);
+        else
+            sceGuBlendFunc(GU_ADD, GU_FIX, GE_BLEND_DOUBLE_ONE_MINUS_SRC_ALPHA,
+                           0xFFFFFFFF, 0);
+        cached_blend_mode = mode;
+    }
+    if (cached_stp_stencil != 1 && !mask_set_bit && !mask_check_bit) {
+        vbatch_flush();
+        sceGuEnable(GU_STENCIL_TEST);
+        sceGuStencilFunc(GU_ALWAYS, 0, 0xFF);
+        sceGuStencilOp(GU_REPLACE, GU_REPLACE, GU_REPLACE);
+        cached_stp_stencil = 1;
+    }
+    return STP_BLEND;
+}
+
 static inline void gu_enable_texture(void)
 {
     if (cached_tex_on != 1) {
@@ -355,6 +552,7 @@ void Prim_InvalidateGSState(void)
     cached_dither_on = -1;
     cached_tex_on = -1;
     cached_alpha_test_on = -1;
+    cached_stp_stencil = -1;
     Tex_InvalidateState();
 }
 
@@ -391,12 +589,15 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
             if (tx != tex_page_x || ty != tex_page_y || fmt != tex_page_format)
                 return 0;
 
-            /* STP two-pass: never fast-path T4/T8 semi-trans */
+            /* T4/T8 semi-trans: only in the single pass, and with the
+             * blend mode the last one set up */
             int is_semi = (cmd & 0x02) != 0;
-            if (is_semi && fmt < 2)
-                return 0;
-
             uint32_t clut_word = psx_cmd[2] & 0xFFFF0000;
+            if (is_semi && fmt < 2) {
+                if (((tpage >> 5) & 3) != semi_trans_mode || semi_trans_mode > 1)
+                    return 0;
+                clut_word |= TEX_CLUT_STP_BLEND;
+            }
             if (clut_word != gs_state.last_clut_word)
                 return 0;
 
@@ -423,11 +624,7 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
                 p++;
                 uint32_t uv_clut = psx_cmd[p++];
                 dst[i].u = (float)Apply_Tex_Window_U(uv_clut & 0xFF);
-#ifdef ENABLE_PSP_STRIDE_HACK
-                dst[i].v = (float)Apply_Tex_Window_V((uv_clut >> 8) & 0xFF) * tex_v_scale;
-#else
                 dst[i].v = (float)Apply_Tex_Window_V((uv_clut >> 8) & 0xFF);
-#endif
                 dst[i].color = color; dst[i].x = x; dst[i].y = y; dst[i].z = 0;
             }
             vbatch.count += nv;
@@ -519,33 +716,11 @@ int GPU_TryFastEmit(uint32_t *psx_cmd)
         }
 
         if (is_textured) {
-            vbatch_prepare(GU_SPRITES,
-                       GU_TEXTURE_32BITF | GU_COLOR_8888 | GU_VERTEX_16BIT,
-                       sizeof(PspVertTex), 2);
-            PspVertTex *v = &vbatch.v.tex[vbatch.count];
-            v[0].u = (float)Apply_Tex_Window_U(u0);
-#ifdef ENABLE_PSP_STRIDE_HACK
-            v[0].v = (float)Apply_Tex_Window_V(v0_coord) * tex_v_scale;
-#else
-            v[0].v = (float)Apply_Tex_Window_V(v0_coord);
-#endif
-            v[0].color = color; v[0].x = x0;     v[0].y = y0;     v[0].z = 0;
-            v[1].u = (float)Apply_Tex_Window_U(u0 + w);
-#ifdef ENABLE_PSP_STRIDE_HACK
-            v[1].v = (float)Apply_Tex_Window_V(v0_coord + h) * tex_v_scale;
-#else
-            v[1].v = (float)Apply_Tex_Window_V(v0_coord + h);
-#endif
-            v[1].color = color; v[1].x = x0 + w; v[1].y = y0 + h; v[1].z = 0;
-            vbatch.count += 2;
+            emit_rect_tex(x0, y0, w, h, u0, v0_coord, color,
+                          psx_cmd[2] & 0xFFFF0000, is_raw_rect, 0);
             gpu_frame_stats.rect_tex++;
         } else {
-            vbatch_prepare(GU_SPRITES, GU_COLOR_8888 | GU_VERTEX_16BIT,
-                           sizeof(PspVertFlat), 2);
-            PspVertFlat *v = &vbatch.v.flat[vbatch.count];
-            v[0].color = color; v[0].x = x0;     v[0].y = y0;     v[0].z = 0;
-            v[1].color = color; v[1].x = x0 + w; v[1].y = y0 + h; v[1].z = 0;
-            vbatch.count += 2;
+            emit_rect_flat(x0, y0, w, h, color);
             gpu_frame_stats.rect_flat++;
         }
         return p;
@@ -617,11 +792,11 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
         int is_raw_tex = is_textured && (cmd & 0x01);
         int nv = is_quad ? 4 : 3;
 
-        apply_blend(is_semi);
         apply_dither(is_shaded, is_textured, is_raw_tex);
 
         if (!is_textured)
         {
+            apply_blend(is_semi);
             gu_disable_texture();
             gu_disable_color_test();
             /* Quads: 4 unique verts + 6 indices.  Tris: 3 verts + 3 indices. */
@@ -670,8 +845,12 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
                 semi_trans_mode = (tpage >> 5) & 3;
             }
             gu_enable_color_test();
+            /* After the texpage: the blend depends on its mode and format */
+            int stp = apply_blend_tex(is_semi);
             int clut_src_p = 2;
             uint32_t clut_word = psx_cmd[clut_src_p] & 0xFFFF0000;
+            if (stp == STP_BLEND)
+                clut_word |= TEX_CLUT_STP_BLEND;
             Tex_SetupIfChanged(clut_word);
 
             if (is_raw_tex)
@@ -679,7 +858,7 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
 
             int unique_nv = nv;
             int nidx = is_quad ? 6 : 3;
-            if (is_semi && tex_page_format < 2)
+            if (stp == STP_TWO_PASS)
                 vbatch_prepare_idx_stp(GU_TRIANGLES,
                            GU_TEXTURE_32BITF | GU_COLOR_8888 | GU_VERTEX_16BIT,
                            sizeof(PspVertTex), unique_nv, nidx);
@@ -704,11 +883,7 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
                 p++;
                 uint32_t uv_clut = psx_cmd[p++];
                 dst[i].u = (float)Apply_Tex_Window_U(uv_clut & 0xFF);
-#ifdef ENABLE_PSP_STRIDE_HACK
-                dst[i].v = (float)Apply_Tex_Window_V((uv_clut >> 8) & 0xFF) * tex_v_scale;
-#else
                 dst[i].v = (float)Apply_Tex_Window_V((uv_clut >> 8) & 0xFF);
-#endif
                 dst[i].color = color; dst[i].x = x; dst[i].y = y; dst[i].z = 0;
             }
             vbatch.count += unique_nv;
@@ -792,54 +967,25 @@ int Translate_GP0_to_GS(uint32_t *psx_cmd)
             w = sz[size_code]; h = sz[size_code];
         }
 
-        apply_blend(is_semi);
         apply_dither(0, is_textured, is_raw_rect);
 
         if (!is_textured)
         {
+            apply_blend(is_semi);
             gu_disable_texture();
             gu_disable_color_test();
-            vbatch_prepare(GU_SPRITES, GU_COLOR_8888 | GU_VERTEX_16BIT,
-                           sizeof(PspVertFlat), 2);
-            PspVertFlat *v = &vbatch.v.flat[vbatch.count];
-            v[0].color = color; v[0].x = x0;     v[0].y = y0;     v[0].z = 0;
-            v[1].color = color; v[1].x = x0 + w; v[1].y = y0 + h; v[1].z = 0;
-            vbatch.count += 2;
+            emit_rect_flat(x0, y0, w, h, color);
             gpu_frame_stats.rect_flat++;
         }
         else
         {
+            int stp = apply_blend_tex(is_semi);
+            if (stp == STP_BLEND)
+                clut_word |= TEX_CLUT_STP_BLEND;
             gu_enable_texture();
             gu_enable_color_test();
-            Tex_SetupIfChanged(clut_word);
-
-            if (is_raw_rect)
-                Tex_ApplyFuncReplace();
-
-            if (is_semi && tex_page_format < 2)
-                vbatch_prepare_stp(GU_SPRITES,
-                       GU_TEXTURE_32BITF | GU_COLOR_8888 | GU_VERTEX_16BIT,
-                       sizeof(PspVertTex), 2);
-            else
-                vbatch_prepare(GU_SPRITES,
-                       GU_TEXTURE_32BITF | GU_COLOR_8888 | GU_VERTEX_16BIT,
-                       sizeof(PspVertTex), 2);
-            PspVertTex *v = &vbatch.v.tex[vbatch.count];
-            v[0].u = (float)Apply_Tex_Window_U(u0);
-#ifdef ENABLE_PSP_STRIDE_HACK
-            v[0].v = (float)Apply_Tex_Window_V(v0) * tex_v_scale;
-#else
-            v[0].v = (float)Apply_Tex_Window_V(v0);
-#endif
-            v[0].color = color; v[0].x = x0;     v[0].y = y0;     v[0].z = 0;
-            v[1].u = (float)Apply_Tex_Window_U(u0 + w);
-#ifdef ENABLE_PSP_STRIDE_HACK
-            v[1].v = (float)Apply_Tex_Window_V(v0 + h) * tex_v_scale;
-#else
-            v[1].v = (float)Apply_Tex_Window_V(v0 + h);
-#endif
-            v[1].color = color; v[1].x = x0 + w; v[1].y = y0 + h; v[1].z = 0;
-            vbatch.count += 2;
+            emit_rect_tex(x0, y0, w, h, u0, v0, color, clut_word, is_raw_rect,
+                          stp == STP_TWO_PASS);
             gpu_frame_stats.rect_tex++;
         }
         gs_state.valid = 1;
@@ -68,30 +68,43 @@ typedef struct {
     int16_t x, y, z;
 } PspVertTex;
 
-/* ── Vertex pool for GU_SEND mode ──────────────────────────────── */
+/* ── Display lists + vertex pools for GU_SEND mode ─────────────── */
+/* A ring of PSP_DL_COUNT list+pool pairs: the CPU builds into
+ * [dl_active] while the GE may still be drawing the others.  A pair is
+ * only waited on when the ring comes back round to it (gpu_psp_core.c). */
+#define PSP_DL_COUNT 3
+#define PSP_DL_WORDS (192 * 1024)
+
 /* Replaces sceGuGetMemory (which doesn't work in non-DIRECT mode).
- * CPU writes to cached pool, one dcache writeback before sceGuSendList.
- * Double-buffered: CPU writes to [dl_active], GE reads from [1-dl_active]. */
+ * CPU writes to cached pool, one dcache writeback before sceGuSendList. */
 #define VPOOL_SIZE (256 * 1024)
-extern uint8_t vpool_buf[2][VPOOL_SIZE];
+extern uint8_t vpool_buf[PSP_DL_COUNT][VPOOL_SIZE];
 extern int vpool_offset;
 extern int dl_active;
-extern int sync_id[2];
+extern int sync_id[PSP_DL_COUNT];
 
 /* Forward declare flush — implemented in gpu_psp_core.c */
 void GPU_Backend_Flush(void);
+/* Send the list built so far without waiting (gpu_psp_kick) */
+void GPU_Backend_KickList(void);
 
-/* Display list (defined in gpu_psp_core.c, used by vram.c too)
- * Double-buffered: indexed by dl_active. */
-extern unsigned int display_list[2][262144];
+/* Display list (defined in gpu_psp_core.c, used by vram.c too),
+ * indexed by dl_active */
+extern unsigned int display_list[PSP_DL_COUNT][PSP_DL_WORDS];
 
-/* Texture API (implemented in gpu_psp_texture.c) */
+/* Texture API (implemented in gpu_psp_texture.c).
+ * clut_word is the CLUT half of a UV word (low 16 bits zero), or'ed with
+ * TEX_CLUT_STP_BLEND for the single-pass STP alpha encoding. */
+#define TEX_CLUT_STP_BLEND 0x1u
 void Tex_SetupIfChanged(uint32_t clut_word);
 void Tex_ApplyFuncReplace(void);
 void Tex_InvalidateState(void);
-#ifdef ENABLE_PSP_STRIDE_HACK
-extern float tex_v_scale;  /* V coordinate multiplier for stride hack (1.0, 2.0, 4.0) */
-#endif
+void Prim_InitTexCache(void);
+/* Direct rect sampling: texture rows per PSX row (4 = T4, 2 = T8) for a
+ * rect to draw row by row from EDRAM after Tex_SetupDirect, 0 = use
+ * Tex_SetupIfChanged.  band = v >> 7 for T4, 0 for T8. */
+int Tex_DirectRowScale(int stp);
+void Tex_SetupDirect(uint32_t clut_word, int band);
 
 static inline void *vpool_alloc(int size) {
     size = (size + 3) & ~3;  /* 4-byte align */
@@ -111,9 +124,8 @@ static inline void *vpool_alloc(int size) {
 typedef struct { uint64_t lo, hi; } gif_qword_t;
 #define GIF_BUFFER_SIZE 1
 
-extern unsigned char gif_packet_buf[2][16]; /* minimal stub */
 extern gif_qword_t *fast_gif_ptr;
+extern gif_qword_t *gif_buffer_start;
 extern gif_qword_t *gif_buffer_end_safe;
-extern int current_buffer;
 
 #endif /* GPU_PSP_STATE_H */
@@ -2,21 +2,26 @@
  * gpu_psp_texture.c — PSP texture / CLUT cache
  *
  * Page-level software texture cache with LRU eviction (T4/T8 in main RAM),
- * plus CLUT transform cache keyed by (clut_word, content_hash).
+ * plus CLUT transform cache keyed by content hash, shared by every CLUT
+ * position holding the same palette.
  * 15bpp textures bypass the cache — GE reads directly from EDRAM VRAM.
  *
  * Equivalent to gpu_ps2_texture.c on the PS2 platform.
  */
 #include "gpu_state.h"
 #include "gpu_psp_state.h"
+#include "config.h"
 #include <pspgu.h>
 #include <pspge.h>
 #include <psputils.h>
 #include <string.h>
 #include <stdio.h>
+#include <malloc.h>
+#include "mem_budget.h"
 
 /* ── EDRAM Texture Page Cache ────────────────────────────────────
- *  64 slots × 64KB in main RAM (static array).  GE reads from uncached
+ *  Up to 64 slots × 64KB in main RAM, from the memory plan's texcache
+ *  pool (mem_budget.h): fewer when RAM is short.  GE reads from uncached
  *  main memory via TexImage.  Avoids PPSSPP EDRAM framebuffer tracking
  *  issues with sceGuCopyImage in SEND mode.
  *  15bpp reads directly from the PSX VRAM mirror (TBW=1024, no cache).
@@ -24,12 +29,12 @@
 #define TCACHE_SLOTS     64
 #define TCACHE_SLOT_SIZE 0x10000  /* 64KB — fits T8 (64KB) or T4 (32KB) */
 
-static uint8_t __attribute__((aligned(64)))
-    tcache_data[TCACHE_SLOTS][TCACHE_SLOT_SIZE];
+static uint8_t *tcache_data;
+static int tcache_slots = 0;
 
 static struct {
     int tpx, tpy, fmt;   /* page key (-1 = empty) */
-    int lru;              /* higher = more recent */
+    int lru;              /* higher = more recent, 0 = empty */
 } tcache[TCACHE_SLOTS];
 
 static int tcache_lru_tick = 0;
@@ -37,18 +42,25 @@ static int tcache_lru_tick = 0;
 static uint32_t cached_clut_word = 0xFFFFFFFF;
 
 /* ── CLUT Transform Cache ─────────────────────────────────────── */
+/* Keyed by (entry count, content hash) only, so a palette copied to
+ * several CLUT positions (one per texture page is common) is converted
+ * once and shares one GE CLUT pointer — switching between those pages
+ * then needs no sceGuClutLoad.  4-way set associative, round-robin
+ * within a set. */
 #define CLUT_CACHE_SIZE 256
+#define CLUT_CACHE_WAYS 4
+#define CLUT_CACHE_SETS (CLUT_CACHE_SIZE / CLUT_CACHE_WAYS)
 
 static struct {
-    uint32_t clut_word;
     uint32_t src_hash;
+    int count;             /* 16 or 256 (| CLUT_KEY_STP_BLEND), 0 = empty */
     uint32_t __attribute__((aligned(16))) data[256];
 } clut_cache[CLUT_CACHE_SIZE];
-static int clut_cache_rr = 0;
+static uint8_t clut_cache_rr[CLUT_CACHE_SETS];
 
 static uint32_t clut_fast_hash(const uint16_t *src, int count)
 {
-    uint32_t h = 2166136261u;
+    uint32_t h = 2166136261u ^ (uint32_t)count;
     for (int i = 0; i < count; i++) {
         h ^= src[i];
         h *= 16777619u;
@@ -61,8 +73,10 @@ static uint32_t clut_fast_hash(const uint16_t *src, int count)
  *   non-zero STP=0  → alpha=0x80 (drawn opaque in STP two-pass)
  *   STP=1           → alpha=0xFF (drawn with blend in STP two-pass)
  * Using 0x80 (not 0x01) for STP=0 so alpha survives TFX_MODULATE
- * truncation: (0x80 * 0xFF) >> 8 = 0x7F, still passes GEQUAL 0x40. */
-static inline uint32_t clut16_to_8888(uint16_t c)
+ * truncation: (0x80 * 0xFF) >> 8 = 0x7F, still passes GEQUAL 0x40.
+ * stp_blend (TEX_CLUT_STP_BLEND) swaps the two: STP=0 → 0xFF, STP=1 →
+ * 0x80, the alpha the single-pass STP blend factors expect. */
+static inline uint32_t clut16_to_8888(uint16_t c, int stp_blend)
 {
     if (c == 0) return 0;
     uint32_t r5 = (c & 0x1F);
@@ -72,25 +86,28 @@ static inline uint32_t clut16_to_8888(uint16_t c)
     uint32_t r = (r5 << 3) | (r5 >> 2);
     uint32_t g = (g5 << 3) | (g5 >> 2);
     uint32_t b = (b5 << 3) | (b5 >> 2);
-    uint32_t a = (c & 0x8000) ? 0xFF : 0x80;
+    uint32_t a = ((c & 0x8000) != 0) != (stp_blend != 0) ? 0xFF : 0x80;
     return r | (g << 8) | (b << 16) | (a << 24);
 }
 
-static uint32_t *clut_cache_get(uint32_t cword, const uint16_t *src,
-                                int count, int *hit)
+/* key = entry count, | CLUT_KEY_STP_BLEND for the swapped-alpha variant */
+#define CLUT_KEY_STP_BLEND 0x1000
+
+static uint32_t *clut_cache_get(const uint16_t *src, int count, int key, int *hit)
 {
-    uint32_t hash = clut_fast_hash(src, count);
-    for (int i = 0; i < CLUT_CACHE_SIZE; i++) {
-        if (clut_cache[i].clut_word == cword &&
-            clut_cache[i].src_hash == hash) {
+    uint32_t hash = clut_fast_hash(src, count) ^ (uint32_t)key;
+    int set = (hash ^ (hash >> 16)) & (CLUT_CACHE_SETS - 1);
+    int base = set * CLUT_CACHE_WAYS;
+    for (int i = base; i < base + CLUT_CACHE_WAYS; i++) {
+        if (clut_cache[i].src_hash == hash && clut_cache[i].count == key) {
             *hit = 1;
             return clut_cache[i].data;
         }
     }
-    int slot = clut_cache_rr;
-    clut_cache_rr = (clut_cache_rr + 1) & (CLUT_CACHE_SIZE - 1);
-    clut_cache[slot].clut_word = cword;
+    int slot = base + clut_cache_rr[set];
+    clut_cache_rr[set] = (clut_cache_rr[set] + 1) & (CLUT_CACHE_WAYS - 1);
     clut_cache[slot].src_hash = hash;
+    clut_cache[slot].count = key;
     *hit = 0;
     return clut_cache[slot].data;
 }
@@ -102,10 +119,6 @@ static int cached_tex_func = -1;   /* 0=MODULATE, 1=REPLACE */
 static int cached_tex_const = 0;
 static int cached_ge_tex_mode = -1;
 static const uint32_t *cached_ge_clut_ptr = NULL;
-#ifdef ENABLE_PSP_STRIDE_HACK
-float tex_v_scale = 1.0f;  /* V multiplier for stride hack (extern in state.h) */
-static float cached_tex_v_scale = -1.0f;
-#endif
 
 /* Texture key — skip setup when unchanged */
 static int cached_tex_tpx = -1, cached_tex_tpy = -1, cached_tex_fmt = -1;
@@ -115,20 +128,31 @@ static uint32_t cached_tex_clut_key = 0xFFFFFFFF;
 
 static inline void *tcache_slot_ptr(int slot)
 {
-    return (void *)tcache_data[slot];
+    return (void *)(tcache_data + (size_t)slot * TCACHE_SLOT_SIZE);
+}
+
+/* Misses take an empty (invalidated) slot before evicting the least
+ * recently used page: invalidated slots keep lru = 0. */
+static int tcache_find(int tpx, int tpy, int fmt)
+{
+    for (int i = 0; i < tcache_slots; i++)
+        if (tcache[i].tpx == tpx && tcache[i].tpy == tpy &&
+            tcache[i].fmt == fmt)
+            return i;
+    return -1;
 }
 
 static int tcache_lookup(int tpx, int tpy, int fmt, int *hit)
 {
     int best = 0, best_lru = tcache[0].lru;
 
-    for (int i = 0; i < TCACHE_SLOTS; i++) {
-        if (tcache[i].tpx == tpx && tcache[i].tpy == tpy &&
-            tcache[i].fmt == fmt) {
-            tcache[i].lru = ++tcache_lru_tick;
-            *hit = 1;
-            return i;
-        }
+    int found = tcache_find(tpx, tpy, fmt);
+    if (found >= 0) {
+        tcache[found].lru = ++tcache_lru_tick;
+        *hit = 1;
+        return found;
+    }
+    for (int i = 1; i < tcache_slots; i++) {
         if (tcache[i].lru < best_lru) {
             best_lru = tcache[i].lru;
             best = i;
@@ -145,6 +169,60 @@ static int tcache_lookup(int tpx, int tpy, int fmt, int *hit)
 
 /* ── Texture Setup — configure GE from PSX VRAM ────────────────── */
 
+/* CLUT of a T4 (16 entries) or T8 (256) page, converted through the
+ * shared CLUT cache and loaded into the GE when it changed */
+static void setup_clut(uint32_t clut_word, int entries)
+{
+    if (clut_word != cached_clut_word) {
+        int stp_blend = (clut_word & TEX_CLUT_STP_BLEND) != 0;
+        int clut_x = ((clut_word >> 16) & 0x3F) * 16;
+        int clut_y = (clut_word >> 22) & 0x1FF;
+        uint16_t *csrc = &psx_vram_shadow[clut_y * 1024 + clut_x];
+        gpu_frame_stats.clut_change++;
+        int clut_hit;
+        uint32_t *cd = clut_cache_get(csrc, entries,
+                                      entries | (stp_blend ? CLUT_KEY_STP_BLEND : 0),
+                                      &clut_hit);
+        if (clut_hit) gpu_frame_stats.clut_cache_hit++;
+        else          gpu_frame_stats.clut_cache_miss++;
+        if (!clut_hit) {
+            for (int i = 0; i < entries; i++)
+                cd[i] = clut16_to_8888(csrc[i], stp_blend);
+        }
+        sceKernelDcacheWritebackRange(cd, entries * 4);
+        active_clut_ptr = cd;
+        cached_clut_word = clut_word;
+    }
+
+    if (cached_ge_clut_ptr != active_clut_ptr) {
+        sceGuClutMode(GU_PSM_8888, 0, entries - 1, 0);
+        sceGuClutLoad(entries / 8, active_clut_ptr);
+        cached_ge_clut_ptr = active_clut_ptr;
+    }
+}
+
+static void setup_tex_mode(int mode)
+{
+    if (cached_ge_tex_mode != mode) {
+        sceGuTexMode(mode, 0, 0, 0);
+        cached_ge_tex_mode = mode;
+    }
+}
+
+static void setup_tex_func(void)
+{
+    if (cached_tex_func != 0) {
+        sceGuTexFunc(GU_TFX_MODULATE, GU_TCC_RGBA);
+        cached_tex_func = 0;
+    }
+    if (!cached_tex_const) {
+        sceGuTexFilter(GU_NEAREST, GU_NEAREST);
+        sceGuTexScale(1.0f, 1.0f);
+        sceGuTexOffset(0.0f, 0.0f);
+        cached_tex_const = 1;
+    }
+}
+
 static void setup_psx_texture(uint32_t clut_word)
 {
     int tpx = tex_page_x;
@@ -153,13 +231,6 @@ static void setup_psx_texture(uint32_t clut_word)
 
     if (tex_page_format == 0)
     {
-#ifdef ENABLE_PSP_STRIDE_HACK
-        /* 4bpp T4 — zero-copy from EDRAM VRAM with stride hack (V×4) */
-        uint8_t *edram = (uint8_t *)sceGeEdramGetAddr() + PSP_VRAM_OFFSET;
-        const void *tex_ptr = edram + (tpy * 1024 + tpx) * 2;
-        if (tex_ptr != cached_tex_base)
-            need_flush = 1;
-#else
         /* 4bpp T4 — copy texpage to main RAM tcache (256×256, tbw=256) */
         int hit;
         int slot = tcache_lookup(tpx, tpy, 0, &hit);
@@ -185,55 +256,15 @@ static void setup_psx_texture(uint32_t clut_word)
         } else if (slot_ptr != cached_tex_base) {
             need_flush = 1;
         }
-#endif
-
-        if (clut_word != cached_clut_word) {
-            int clut_x = ((clut_word >> 16) & 0x3F) * 16;
-            int clut_y = (clut_word >> 22) & 0x1FF;
-            uint16_t *csrc = &psx_vram_shadow[clut_y * 1024 + clut_x];
-            gpu_frame_stats.clut_change++;
-            int clut_hit;
-            uint32_t *cd = clut_cache_get(clut_word, csrc, 16, &clut_hit);
-            if (clut_hit) gpu_frame_stats.clut_cache_hit++;
-            else          gpu_frame_stats.clut_cache_miss++;
-            if (!clut_hit) {
-                for (int i = 0; i < 16; i++)
-                    cd[i] = clut16_to_8888(csrc[i]);
-            }
-            sceKernelDcacheWritebackRange(cd, 64);
-            active_clut_ptr = cd;
-            cached_clut_word = clut_word;
-        }
 
-        if (cached_ge_clut_ptr != active_clut_ptr) {
-            sceGuClutMode(GU_PSM_8888, 0, 0x0F, 0);
-            sceGuClutLoad(2, active_clut_ptr);
-            cached_ge_clut_ptr = active_clut_ptr;
-        }
+        setup_clut(clut_word, 16);
         if (need_flush) sceGuTexFlush();
-        if (cached_ge_tex_mode != GU_PSM_T4) {
-            sceGuTexMode(GU_PSM_T4, 0, 0, 0);
-            cached_ge_tex_mode = GU_PSM_T4;
-        }
-#ifdef ENABLE_PSP_STRIDE_HACK
-        /* Height 1024 is needed for T4 (V*4) to reach all 256 PSX rows */
-        sceGuTexImage(0, 256, 1024, 1024, tex_ptr);
-        cached_tex_base = tex_ptr;
-        tex_v_scale = 4.0f;
-#else
+        setup_tex_mode(GU_PSM_T4);
         sceGuTexImage(0, 256, 256, 256, slot_ptr);
         cached_tex_base = slot_ptr;
-#endif
     }
     else if (tex_page_format == 1)
     {
-#ifdef ENABLE_PSP_STRIDE_HACK
-        /* 8bpp T8 — zero-copy from EDRAM VRAM with stride hack (V×2) */
-        uint8_t *edram = (uint8_t *)sceGeEdramGetAddr() + PSP_VRAM_OFFSET;
-        const void *tex_ptr = edram + (tpy * 1024 + tpx) * 2;
-        if (tex_ptr != cached_tex_base)
-            need_flush = 1;
-#else
         /* 8bpp T8 — copy texpage to main RAM tcache (256×256, tbw=256) */
         int hit;
         int slot = tcache_lookup(tpx, tpy, 1, &hit);
@@ -259,44 +290,12 @@ static void setup_psx_texture(uint32_t clut_word)
         } else if (slot_ptr != cached_tex_base) {
             need_flush = 1;
         }
-#endif
-
-        if (clut_word != cached_clut_word) {
-            int clut_x = ((clut_word >> 16) & 0x3F) * 16;
-            int clut_y = (clut_word >> 22) & 0x1FF;
-            uint16_t *csrc = &psx_vram_shadow[clut_y * 1024 + clut_x];
-            gpu_frame_stats.clut_change++;
-            int clut_hit;
-            uint32_t *cd = clut_cache_get(clut_word, csrc, 256, &clut_hit);
-            if (clut_hit) gpu_frame_stats.clut_cache_hit++;
-            else          gpu_frame_stats.clut_cache_miss++;
-            if (!clut_hit) {
-                for (int i = 0; i < 256; i++)
-                    cd[i] = clut16_to_8888(csrc[i]);
-            }
-            sceKernelDcacheWritebackRange(cd, 1024);
-            active_clut_ptr = cd;
-            cached_clut_word = clut_word;
-        }
 
-        if (cached_ge_clut_ptr != active_clut_ptr) {
-            sceGuClutMode(GU_PSM_8888, 0, 0xFF, 0);
-            sceGuClutLoad(32, active_clut_ptr);
-            cached_ge_clut_ptr = active_clut_ptr;
-        }
+        setup_clut(clut_word, 256);
         if (need_flush) sceGuTexFlush();
-        if (cached_ge_tex_mode != GU_PSM_T8) {
-            sceGuTexMode(GU_PSM_T8, 0, 0, 0);
-            cached_ge_tex_mode = GU_PSM_T8;
-        }
-#ifdef ENABLE_PSP_STRIDE_HACK
-        sceGuTexImage(0, 256, 512, 1024, tex_ptr);
-        cached_tex_base = tex_ptr;
-        tex_v_scale = 2.0f;
-#else
+        setup_tex_mode(GU_PSM_T8);
         sceGuTexImage(0, 256, 256, 256, slot_ptr);
         cached_tex_base = slot_ptr;
-#endif
     }
     else
     {
@@ -308,34 +307,71 @@ static void setup_psx_texture(uint32_t clut_word)
             sceGuTexFlush();
             cached_tex_base = tex_ptr;
         }
-        if (cached_ge_tex_mode != GU_PSM_5551) {
-            sceGuTexMode(GU_PSM_5551, 0, 0, 0);
-            cached_ge_tex_mode = GU_PSM_5551;
-        }
+        setup_tex_mode(GU_PSM_5551);
         cached_ge_clut_ptr = NULL;
         sceGuTexImage(0, 256, 256, 1024, tex_ptr);
-#ifdef ENABLE_PSP_STRIDE_HACK
-        tex_v_scale = 1.0f;
-#endif
     }
 
-    if (cached_tex_func != 0) {
-        sceGuTexFunc(GU_TFX_MODULATE, GU_TCC_RGBA);
-        cached_tex_func = 0;
-    }
-    if (!cached_tex_const
-#ifdef ENABLE_PSP_STRIDE_HACK
-        || cached_tex_v_scale != tex_v_scale
-#endif
-    ) {
-        sceGuTexFilter(GU_NEAREST, GU_NEAREST);
-        sceGuTexScale(1.0f, 1.0f);
-        sceGuTexOffset(0.0f, 0.0f);
-        cached_tex_const = 1;
-#ifdef ENABLE_PSP_STRIDE_HACK
-        cached_tex_v_scale = tex_v_scale;
-#endif
+    setup_tex_func();
+}
+
+/* ── Direct T4/T8 Sampling (gpu_psp_direct_tex) ─────────────────
+ *  The GE reads a 4/8-bit page in place from the EDRAM VRAM mirror with
+ *  TBW = 1024 texels: PSX row v is texture row 4v (T4) or 2v (T8), the
+ *  rows in between hold texels further right.  That is exact only for
+ *  a V that doesn't vary across the primitive, so rectangles are drawn
+ *  one sprite per row (gpu_psp_primitives.c) and polygons keep the
+ *  tcache.  Textures are at most 512 rows high: a T4 page is bound as
+ *  two bands of 128 PSX rows.
+ *
+ *  Only pages the tcache doesn't hold go direct, so a page that is
+ *  resident keeps its one-sprite rects and a rect-only page (fonts,
+ *  2D backgrounds, streamed sprites) never costs a 32/64 KB copy and
+ *  writeback.  The tcache also takes STP two-pass rects (every row
+ *  would flush), T8 pages that wrap past x = 1023 and texture windows.
+ * ─────────────────────────────────────────────────────────────────── */
+static int cached_tex_band = -1; /* bound direct band, -1 = tcache / 15bpp */
+
+int Tex_DirectRowScale(int stp)
+{
+    if (!psx_config.gpu_psp_direct_tex || tex_page_format > 1 ||
+        tcache_find(tex_page_x, tex_page_y, tex_page_format) >= 0)
+        return 0;
+    if (stp || tex_win_mask_x || tex_win_mask_y ||
+        (tex_page_format == 1 && tex_page_x + 128 > 1024)) {
+        gpu_frame_stats.tex_direct_fallback++;
+        return 0;
     }
+    gpu_frame_stats.tex_direct++;
+    return tex_page_format == 0 ? 4 : 2;
+}
+
+void Tex_SetupDirect(uint32_t clut_word, int band)
+{
+    if (band == cached_tex_band && tex_page_x == cached_tex_tpx &&
+        tex_page_y == cached_tex_tpy && tex_page_format == cached_tex_fmt &&
+        clut_word == cached_tex_clut_key)
+        return;
+
+    gpu_frame_stats.tex_key_change++;
+    Prim_FlushBatch();
+
+    int t4 = tex_page_format == 0;
+    uint8_t *edram = (uint8_t *)sceGeEdramGetAddr() + PSP_VRAM_OFFSET;
+    const void *tex_ptr = edram + (tex_page_y + band * 128) * 2048 + tex_page_x * 2;
+    if (tex_ptr != cached_tex_base || cached_tex_band < 0)
+        sceGuTexFlush();
+    setup_clut(clut_word, t4 ? 16 : 256);
+    setup_tex_mode(t4 ? GU_PSM_T4 : GU_PSM_T8);
+    sceGuTexImage(0, 256, 512, 1024, tex_ptr);
+    cached_tex_base = tex_ptr;
+    setup_tex_func();
+
+    cached_tex_band = band;
+    cached_tex_tpx = tex_page_x;
+    cached_tex_tpy = tex_page_y;
+    cached_tex_fmt = tex_page_format;
+    cached_tex_clut_key = clut_word;
 }
 
 /* ── Public Texture API (called from primitives.c) ─────────────── */
@@ -343,10 +379,12 @@ static void setup_psx_texture(uint32_t clut_word)
 void Tex_SetupIfChanged(uint32_t clut_word)
 {
     if (tex_page_x != cached_tex_tpx || tex_page_y != cached_tex_tpy ||
-        tex_page_format != cached_tex_fmt || clut_word != cached_tex_clut_key) {
+        tex_page_format != cached_tex_fmt || clut_word != cached_tex_clut_key ||
+        cached_tex_band >= 0) {
         gpu_frame_stats.tex_key_change++;
         Prim_FlushBatch();
         setup_psx_texture(clut_word);
+        cached_tex_band = -1;
 
         cached_tex_tpx = tex_page_x;
         cached_tex_tpy = tex_page_y;
@@ -371,10 +409,7 @@ void Tex_InvalidateState(void)
     cached_tex_base = NULL;
     cached_tex_func = -1;
     cached_tex_const = 0;
-#ifdef ENABLE_PSP_STRIDE_HACK
-    cached_tex_v_scale = -1.0f;
-    tex_v_scale = 1.0f;
-#endif
+    cached_tex_band = -1;
     cached_tex_tpx = -1;
     cached_tex_tpy = -1;
     cached_tex_fmt = -1;
@@ -385,13 +420,39 @@ void Tex_InvalidateState(void)
     active_clut_ptr = NULL;
 }
 
+/* ── Cache Setup ───────────────────────────────────────────────── */
+
+/* As many slots as the pool holds, halved until the heap can take them
+ * when the plan had no room.  Once per boot. */
+void Prim_InitTexCache(void)
+{
+    if (tcache_data)
+        return;
+    int slots = (int)(MemPool_Avail(MEM_POOL_TEXCACHE) / TCACHE_SLOT_SIZE);
+    if (slots > TCACHE_SLOTS) slots = TCACHE_SLOTS;
+    if (slots > 0)
+        tcache_data = (uint8_t *)MemPool_Alloc(MEM_POOL_TEXCACHE, slots * TCACHE_SLOT_SIZE, 64);
+    for (slots = tcache_data ? slots : TCACHE_SLOTS; !tcache_data && slots > 1; slots /= 2)
+        tcache_data = (uint8_t *)memalign(64, slots * TCACHE_SLOT_SIZE);
+    if (!tcache_data)
+        tcache_data = (uint8_t *)memalign(64, TCACHE_SLOT_SIZE);
+    tcache_slots = tcache_data ? slots : 0;
+    for (int i = 0; i < tcache_slots; i++) {
+        tcache[i].tpx = -1;
+        tcache[i].lru = 0;
+    }
+    printf("[GPU] Texture cache: %d x %d KB\n", tcache_slots, TCACHE_SLOT_SIZE >> 10);
+}
+
 /* ── Cache Invalidation ────────────────────────────────────────── */
 
 void Prim_InvalidateTexCache(void)
 {
     Prim_FlushBatch();
-    for (int i = 0; i < TCACHE_SLOTS; i++)
+    for (int i = 0; i < tcache_slots; i++) {
         tcache[i].tpx = -1;
+        tcache[i].lru = 0;
+    }
     cached_clut_word = 0xFFFFFFFF;
     cached_tex_base = NULL;
     cached_tex_tpx = -1;
@@ -400,9 +461,11 @@ void Prim_InvalidateTexCache(void)
 
 void Prim_InvalidateTexCache_Page(int tpx, int tpy)
 {
-    for (int i = 0; i < TCACHE_SLOTS; i++)
-        if (tcache[i].tpx == tpx && tcache[i].tpy == tpy)
+    for (int i = 0; i < tcache_slots; i++)
+        if (tcache[i].tpx == tpx && tcache[i].tpy == tpy) {
             tcache[i].tpx = -1;
+            tcache[i].lru = 0;
+        }
     gs_state.valid = 0;
 }
 
@@ -410,13 +473,15 @@ void Prim_InvalidateTexCache_Region(int rx, int ry, int rw, int rh)
 {
     Prim_FlushBatch();
     int rx2 = rx + rw, ry2 = ry + rh;
-    for (int i = 0; i < TCACHE_SLOTS; i++) {
+    for (int i = 0; i < tcache_slots; i++) {
         if (tcache[i].tpx < 0) continue;
         int pw = (tcache[i].fmt == 0) ? 64 : 128;
         int px1 = tcache[i].tpx, py1 = tcache[i].tpy;
         int px2 = px1 + pw, py2 = py1 + 256;
-        if (rx < px2 && rx2 > px1 && ry < py2 && ry2 > py1)
+        if (rx < px2 && rx2 > px1 && ry < py2 && ry2 > py1) {
             tcache[i].tpx = -1;
+            tcache[i].lru = 0;
+        }
     }
     cached_clut_word = 0xFFFFFFFF;
     cached_tex_base = NULL;
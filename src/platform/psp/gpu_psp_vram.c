@@ -115,11 +115,27 @@ void GPU_Backend_VRAMCopy(int sx, int sy, int dx, int dy, int w, int h) {
     Prim_InvalidateTexCache_Region(dx, dy, w, h);
 }
 
+/* GP0(80h) keeps using the shadow re-upload on PSP */
+int GPU_Backend_VRAMCopyLocal(int sx, int sy, int dx, int dy, int w, int h) {
+    (void)sx; (void)sy; (void)dx; (void)dy; (void)w; (void)h;
+    return 0;
+}
+
+/* No tile tracking on PSP: only GPU_Backend_VRAMReadback fetches */
+void GPU_Backend_ShadowSync(int x, int y, int w, int h) {
+    (void)x; (void)y; (void)w; (void)h;
+}
+
 void GPU_Backend_VRAMWrite(uint32_t word) {
     /* No-op: handled by gpu_commands.c + VRAMFlush */
     (void)word;
 }
 
+void GPU_Backend_VRAMWriteBlock(const uint32_t *words, uint32_t count) {
+    (void)words;
+    (void)count;
+}
+
 void GPU_Backend_VRAMFlush(void) {
     if (!psx_vram_shadow || vram_tx_w <= 0 || vram_tx_h <= 0) return;
 
@@ -173,5 +189,11 @@ void GPU_Backend_VRAMReadback(int x, int y, int w, int h) {
     sceKernelDcacheInvalidateRange(&psx_vram_shadow[(y & 511) * 1024 + x1], aligned_w * 2 + (h - 1) * 1024 * 2);
 }
 
+/* Readbacks complete synchronously above; nothing is ever deferred */
+void GPU_Backend_VRAMReadbackResolve(void) {}
+
+/* GP0 DMA is translated as it arrives; nothing is ever queued */
+void GPU_Backend_QueueDrain(void) {}
+
 void DumpVRAM(const char *filename) { (void)filename; }
 void DumpShadowVRAM(const char *filename) { (void)filename; }
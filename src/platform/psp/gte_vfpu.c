@@ -26,7 +26,6 @@
 
 /* ---- Short names for GTE registers (matching gte.c) ---- */
 #define D(n) cpu->cp2_data[(n)]
-#define C(n) cpu->cp2_ctrl[(n)]
 
 /* Data register indices */
 enum {
@@ -36,18 +35,6 @@ enum {
     vd_MAC1 = 25, vd_MAC2 = 26, vd_MAC3 = 27,
 };
 
-/* Control register indices */
-enum {
-    vc_RT11RT12 = 0, vc_RT13RT21 = 1, vc_RT22RT23 = 2,
-    vc_RT31RT32 = 3, vc_RT33 = 4,
-    vc_TRX = 5, vc_TRY = 6, vc_TRZ = 7,
-    vc_L11L12 = 8, vc_L13L21 = 9, vc_L22L23 = 10,
-    vc_L31L32 = 11, vc_L33 = 12,
-    vc_RBK = 13, vc_GBK = 14, vc_BBK = 15,
-    vc_LR1LR2 = 16, vc_LR3LG1 = 17, vc_LG2LG3 = 18,
-    vc_LB1LB2 = 19, vc_LB3 = 20,
-};
-
 static inline int16_t lo16v(uint32_t v) { return (int16_t)(v & 0xFFFF); }
 static inline int16_t hi16v(uint32_t v) { return (int16_t)(v >> 16); }
 
@@ -85,155 +72,99 @@ static inline int32_t vfpu_saturate_ir(int32_t val, int n, int lm)
  * Pre-scaled by 1/4096 so float result = MAC value (for sf=1).
  * ================================================================ */
 
+/* Fill three VFPU rows from a decoded int16 matrix (GTE_Matrices) */
+static void vfpu_load_rows(const int16_t *m, float *row1, float *row2, float *row3)
+{
+    const float s = 1.0f / 4096.0f;
+    float *rows[3] = {row1, row2, row3};
+    for (int r = 0; r < 3; r++)
+    {
+        rows[r][0] = (float)m[r * 3 + 0] * s;
+        rows[r][1] = (float)m[r * 3 + 1] * s;
+        rows[r][2] = (float)m[r * 3 + 2] * s;
+        rows[r][3] = 0.0f;
+    }
+}
+
+static void vfpu_load_trans(const int32_t *tr, float *trans)
+{
+    trans[0] = (float)tr[0];
+    trans[1] = (float)tr[1];
+    trans[2] = (float)tr[2];
+    trans[3] = 0.0f;
+}
+
+/* Dirty state is lane 1 of gte_matrix_dirty (vu0_matrix_dirty), set by
+ * every CTC2 that touches the matrix, and cleared here on refresh. */
+
 /* RT matrix: ctrl[0..4], translation: ctrl[5..7] */
 /* row[i] holds GTE matrix row i: {ri1/s, ri2/s, ri3/s, 0} */
 float vfpu_rt_row1[4] __attribute__((aligned(16)));
 float vfpu_rt_row2[4] __attribute__((aligned(16)));
 float vfpu_rt_row3[4] __attribute__((aligned(16)));
 float vfpu_rt_trans[4] __attribute__((aligned(16)));
-static uint32_t vfpu_rt_snap[8];
 
 void vfpu_refresh_rt_matrix(R3000CPU *cpu)
 {
-    int16_t r11 = lo16v(C(vc_RT11RT12)), r12 = hi16v(C(vc_RT11RT12));
-    int16_t r13 = lo16v(C(vc_RT13RT21)), r21 = hi16v(C(vc_RT13RT21));
-    int16_t r22 = lo16v(C(vc_RT22RT23)), r23 = hi16v(C(vc_RT22RT23));
-    int16_t r31 = lo16v(C(vc_RT31RT32)), r32 = hi16v(C(vc_RT31RT32));
-    int16_t r33 = lo16v(C(vc_RT33));
-
-    const float s = 1.0f / 4096.0f;
-    /* Row-major: row[i] = { ri1/s, ri2/s, ri3/s, 0 } */
-    vfpu_rt_row1[0] = (float)r11 * s;
-    vfpu_rt_row1[1] = (float)r12 * s;
-    vfpu_rt_row1[2] = (float)r13 * s;
-    vfpu_rt_row1[3] = 0.0f;
-    vfpu_rt_row2[0] = (float)r21 * s;
-    vfpu_rt_row2[1] = (float)r22 * s;
-    vfpu_rt_row2[2] = (float)r23 * s;
-    vfpu_rt_row2[3] = 0.0f;
-    vfpu_rt_row3[0] = (float)r31 * s;
-    vfpu_rt_row3[1] = (float)r32 * s;
-    vfpu_rt_row3[2] = (float)r33 * s;
-    vfpu_rt_row3[3] = 0.0f;
-
-    vfpu_rt_trans[0] = (float)(int32_t)C(vc_TRX);
-    vfpu_rt_trans[1] = (float)(int32_t)C(vc_TRY);
-    vfpu_rt_trans[2] = (float)(int32_t)C(vc_TRZ);
-    vfpu_rt_trans[3] = 0.0f;
-
-    for (int i = 0; i < 8; i++)
-        vfpu_rt_snap[i] = C(i);
+    const GTEMatrixCache *mc = GTE_Matrices(cpu);
+    vfpu_load_rows(mc->m[0], vfpu_rt_row1, vfpu_rt_row2, vfpu_rt_row3);
+    vfpu_load_trans(mc->tr[0], vfpu_rt_trans);
+    vu0_matrix_dirty &= ~GTE_MTX_RT;
 }
 
 int vfpu_rt_is_dirty(R3000CPU *cpu)
 {
-    for (int i = 0; i < 8; i++)
-        if (vfpu_rt_snap[i] != C(i))
-            return 1;
-    return 0;
+    (void)cpu;
+    return (vu0_matrix_dirty & GTE_MTX_RT) != 0;
 }
 
 /* Light matrix: ctrl[8..12] */
 float vfpu_lt_row1[4] __attribute__((aligned(16)));
 float vfpu_lt_row2[4] __attribute__((aligned(16)));
 float vfpu_lt_row3[4] __attribute__((aligned(16)));
-static uint32_t vfpu_lt_snap[5];
 
 void vfpu_refresh_lt_matrix(R3000CPU *cpu)
 {
-    int16_t l11 = lo16v(C(vc_L11L12)), l12 = hi16v(C(vc_L11L12));
-    int16_t l13 = lo16v(C(vc_L13L21)), l21 = hi16v(C(vc_L13L21));
-    int16_t l22 = lo16v(C(vc_L22L23)), l23 = hi16v(C(vc_L22L23));
-    int16_t l31 = lo16v(C(vc_L31L32)), l32 = hi16v(C(vc_L31L32));
-    int16_t l33 = lo16v(C(vc_L33));
-
-    const float s = 1.0f / 4096.0f;
-    vfpu_lt_row1[0] = (float)l11 * s;
-    vfpu_lt_row1[1] = (float)l12 * s;
-    vfpu_lt_row1[2] = (float)l13 * s;
-    vfpu_lt_row1[3] = 0.0f;
-    vfpu_lt_row2[0] = (float)l21 * s;
-    vfpu_lt_row2[1] = (float)l22 * s;
-    vfpu_lt_row2[2] = (float)l23 * s;
-    vfpu_lt_row2[3] = 0.0f;
-    vfpu_lt_row3[0] = (float)l31 * s;
-    vfpu_lt_row3[1] = (float)l32 * s;
-    vfpu_lt_row3[2] = (float)l33 * s;
-    vfpu_lt_row3[3] = 0.0f;
-
-    for (int i = 0; i < 5; i++)
-        vfpu_lt_snap[i] = C(8 + i);
+    vfpu_load_rows(GTE_Matrices(cpu)->m[1], vfpu_lt_row1, vfpu_lt_row2, vfpu_lt_row3);
+    vu0_matrix_dirty &= ~GTE_MTX_LL;
 }
 
 int vfpu_lt_is_dirty(R3000CPU *cpu)
 {
-    for (int i = 0; i < 5; i++)
-        if (vfpu_lt_snap[i] != C(8 + i))
-            return 1;
-    return 0;
+    (void)cpu;
+    return (vu0_matrix_dirty & GTE_MTX_LL) != 0;
 }
 
 /* Color matrix: ctrl[16..20] */
 float vfpu_lc_row1[4] __attribute__((aligned(16)));
 float vfpu_lc_row2[4] __attribute__((aligned(16)));
 float vfpu_lc_row3[4] __attribute__((aligned(16)));
-static uint32_t vfpu_lc_snap[5];
 
 void vfpu_refresh_lc_matrix(R3000CPU *cpu)
 {
-    int16_t lr1 = lo16v(C(vc_LR1LR2)), lr2 = hi16v(C(vc_LR1LR2));
-    int16_t lr3 = lo16v(C(vc_LR3LG1)), lg1 = hi16v(C(vc_LR3LG1));
-    int16_t lg2 = lo16v(C(vc_LG2LG3)), lg3 = hi16v(C(vc_LG2LG3));
-    int16_t lb1 = lo16v(C(vc_LB1LB2)), lb2 = hi16v(C(vc_LB1LB2));
-    int16_t lb3 = lo16v(C(vc_LB3));
-
-    const float s = 1.0f / 4096.0f;
-    vfpu_lc_row1[0] = (float)lr1 * s;
-    vfpu_lc_row1[1] = (float)lr2 * s;
-    vfpu_lc_row1[2] = (float)lr3 * s;
-    vfpu_lc_row1[3] = 0.0f;
-    vfpu_lc_row2[0] = (float)lg1 * s;
-    vfpu_lc_row2[1] = (float)lg2 * s;
-    vfpu_lc_row2[2] = (float)lg3 * s;
-    vfpu_lc_row2[3] = 0.0f;
-    vfpu_lc_row3[0] = (float)lb1 * s;
-    vfpu_lc_row3[1] = (float)lb2 * s;
-    vfpu_lc_row3[2] = (float)lb3 * s;
-    vfpu_lc_row3[3] = 0.0f;
-
-    for (int i = 0; i < 5; i++)
-        vfpu_lc_snap[i] = C(16 + i);
+    vfpu_load_rows(GTE_Matrices(cpu)->m[2], vfpu_lc_row1, vfpu_lc_row2, vfpu_lc_row3);
+    vu0_matrix_dirty &= ~GTE_MTX_LC;
 }
 
 int vfpu_lc_is_dirty(R3000CPU *cpu)
 {
-    for (int i = 0; i < 5; i++)
-        if (vfpu_lc_snap[i] != C(16 + i))
-            return 1;
-    return 0;
+    (void)cpu;
+    return (vu0_matrix_dirty & GTE_MTX_LC) != 0;
 }
 
 /* BK translation: ctrl[13..15] */
 float vfpu_bk_trans[4] __attribute__((aligned(16)));
-static uint32_t vfpu_bk_snap[3];
 
 void vfpu_refresh_bk_trans(R3000CPU *cpu)
 {
-    vfpu_bk_trans[0] = (float)(int32_t)C(vc_RBK);
-    vfpu_bk_trans[1] = (float)(int32_t)C(vc_GBK);
-    vfpu_bk_trans[2] = (float)(int32_t)C(vc_BBK);
-    vfpu_bk_trans[3] = 0.0f;
-
-    for (int i = 0; i < 3; i++)
-        vfpu_bk_snap[i] = C(vc_RBK + i);
+    vfpu_load_trans(GTE_Matrices(cpu)->tr[1], vfpu_bk_trans);
+    vu0_matrix_dirty &= ~GTE_MTX_BK;
 }
 
 int vfpu_bk_is_dirty(R3000CPU *cpu)
 {
-    for (int i = 0; i < 3; i++)
-        if (vfpu_bk_snap[i] != C(vc_RBK + i))
-            return 1;
-    return 0;
+    (void)cpu;
+    return (vu0_matrix_dirty & GTE_MTX_BK) != 0;
 }
 
 /* Zero translation for cv=3 (None) */
@@ -284,33 +215,19 @@ void gte_mvmva_vfpu(R3000CPU *cpu, int lm, int mx, int v, int cv)
      * integer arithmetic.  The VFPU matrix infrastructure is kept for potential
      * future optimizations (batch projection, etc.). */
 
-    /* Get matrix elements */
-    int16_t m[3][3];
-    int base;
-    switch (mx) {
-    case 0: base = 0; break;     /* RT: ctrl[0..4] */
-    case 1: base = 8; break;     /* LT: ctrl[8..12] */
-    default: base = 16; break;   /* LC: ctrl[16..20] */
-    }
-    m[0][0] = lo16v(C(base));       m[0][1] = hi16v(C(base));
-    m[0][2] = lo16v(C(base + 1));   m[1][0] = hi16v(C(base + 1));
-    m[1][1] = lo16v(C(base + 2));   m[1][2] = hi16v(C(base + 2));
-    m[2][0] = lo16v(C(base + 3));   m[2][1] = hi16v(C(base + 3));
-    m[2][2] = lo16v(C(base + 4));
+    /* Decoded matrix / translation from the shared cache */
+    const GTEMatrixCache *mc = GTE_Matrices(cpu);
+    const int16_t *m = mc->m[mx < 2 ? mx : 2]; /* RT, LT, LC */
 
     /* Get translation (shifted by <<12 as per PSX GTE hardware) */
     int64_t tx1, tx2, tx3;
     if (cv == 3) {
         tx1 = tx2 = tx3 = 0;
     } else {
-        int tb;
-        switch (cv) {
-        case 0: tb = 5; break;   /* TR: ctrl[5..7] */
-        default: tb = 13; break; /* BK: ctrl[13..15] */
-        }
-        tx1 = (int64_t)(int32_t)C(tb)     << 12;
-        tx2 = (int64_t)(int32_t)C(tb + 1) << 12;
-        tx3 = (int64_t)(int32_t)C(tb + 2) << 12;
+        const int32_t *tr = mc->tr[cv == 0 ? 0 : 1]; /* TR or BK */
+        tx1 = (int64_t)tr[0] << 12;
+        tx2 = (int64_t)tr[1] << 12;
+        tx3 = (int64_t)tr[2] << 12;
     }
 
     /* Get vertex */
@@ -319,9 +236,9 @@ void gte_mvmva_vfpu(R3000CPU *cpu, int lm, int mx, int v, int cv)
     int16_t vz = get_vector_vfpu(cpu, v, 2);
 
     /* Integer multiply-accumulate (sf=1: shift >>12 at end) */
-    int64_t mac1 = tx1 + (int64_t)m[0][0] * vx + (int64_t)m[0][1] * vy + (int64_t)m[0][2] * vz;
-    int64_t mac2 = tx2 + (int64_t)m[1][0] * vx + (int64_t)m[1][1] * vy + (int64_t)m[1][2] * vz;
-    int64_t mac3 = tx3 + (int64_t)m[2][0] * vx + (int64_t)m[2][1] * vy + (int64_t)m[2][2] * vz;
+    int64_t mac1 = tx1 + (int64_t)m[0] * vx + (int64_t)m[1] * vy + (int64_t)m[2] * vz;
+    int64_t mac2 = tx2 + (int64_t)m[3] * vx + (int64_t)m[4] * vy + (int64_t)m[5] * vz;
+    int64_t mac3 = tx3 + (int64_t)m[6] * vx + (int64_t)m[7] * vy + (int64_t)m[8] * vz;
 
     /* sf=1: shift >>12 (caller guarantees sf=1) */
     int32_t r1 = (int32_t)(mac1 >> 12);
@@ -346,21 +263,17 @@ void gte_mvmva_vfpu(R3000CPU *cpu, int lm, int mx, int v, int cv)
 void vfpu_rt_multiply(R3000CPU *cpu, int v, int32_t *out_mac1, int32_t *out_mac2, int32_t *out_mac3)
 {
     /* Integer MADD: RT matrix × vertex + TR  (sf=1 → >>12) */
-    int16_t r11 = lo16v(C(vc_RT11RT12)), r12 = hi16v(C(vc_RT11RT12));
-    int16_t r13 = lo16v(C(vc_RT13RT21)), r21 = hi16v(C(vc_RT13RT21));
-    int16_t r22 = lo16v(C(vc_RT22RT23)), r23 = hi16v(C(vc_RT22RT23));
-    int16_t r31 = lo16v(C(vc_RT31RT32)), r32 = hi16v(C(vc_RT31RT32));
-    int16_t r33 = lo16v(C(vc_RT33));
-
-    int64_t tx = (int64_t)(int32_t)C(vc_TRX) << 12;
-    int64_t ty = (int64_t)(int32_t)C(vc_TRY) << 12;
-    int64_t tz = (int64_t)(int32_t)C(vc_TRZ) << 12;
+    const GTEMatrixCache *mc = GTE_Matrices(cpu);
+    const int16_t *r = mc->m[0];
+    int64_t tx = (int64_t)mc->tr[0][0] << 12;
+    int64_t ty = (int64_t)mc->tr[0][1] << 12;
+    int64_t tz = (int64_t)mc->tr[0][2] << 12;
 
     int16_t vx = get_vector_vfpu(cpu, v, 0);
     int16_t vy = get_vector_vfpu(cpu, v, 1);
     int16_t vz = get_vector_vfpu(cpu, v, 2);
 
-    *out_mac1 = (int32_t)((tx + (int64_t)r11 * vx + (int64_t)r12 * vy + (int64_t)r13 * vz) >> 12);
-    *out_mac2 = (int32_t)((ty + (int64_t)r21 * vx + (int64_t)r22 * vy + (int64_t)r23 * vz) >> 12);
-    *out_mac3 = (int32_t)((tz + (int64_t)r31 * vx + (int64_t)r32 * vy + (int64_t)r33 * vz) >> 12);
+    *out_mac1 = (int32_t)((tx + (int64_t)r[0] * vx + (int64_t)r[1] * vy + (int64_t)r[2] * vz) >> 12);
+    *out_mac2 = (int32_t)((ty + (int64_t)r[3] * vx + (int64_t)r[4] * vy + (int64_t)r[5] * vz) >> 12);
+    *out_mac3 = (int32_t)((tz + (int64_t)r[6] * vx + (int64_t)r[7] * vy + (int64_t)r[8] * vz) >> 12);
 }
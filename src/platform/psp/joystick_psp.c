@@ -5,18 +5,59 @@
  * PSP has a single controller with no multitap support.
  */
 #include "joystick.h"
+#include "config.h"
+#include "pad_snapshot.h"
+#include "platform.h"
 #include <pspctrl.h>
+#include <pspdisplay.h>
+#include <pspthreadman.h>
+#include <stdio.h>
 #include <string.h>
 
+#define PAD_POLL_STACK (8 * 1024)
+
 static int pad_initialized = 0;
 
+/* pad_thread: sceCtrl is read by the poll worker once per host VBlank */
+static PadSnapshot pad_snap;
+static int pad_thread = -1;
+static volatile int pad_stop = 0;
+
+static uint32_t read_psp_pad(void);
+
+static void pad_poll_worker(void *arg) {
+    uint16_t buttons[PAD_SNAPSHOT_MAX] = {0};
+
+    (void)arg;
+    while (!pad_stop) {
+        buttons[0] = (uint16_t)read_psp_pad();
+        pad_snapshot_publish(&pad_snap, buttons);
+        sceDisplayWaitVblankStart();
+    }
+}
+
 void Joystick_Init(void) {
     sceCtrlSetSamplingCycle(0);
     sceCtrlSetSamplingMode(PSP_CTRL_MODE_DIGITAL);
     pad_initialized = 1;
+
+    if (psx_config.pad_thread && pad_thread < 0) {
+        pad_stop = 0;
+        pad_thread = Platform_ThreadStart("pad_poll", pad_poll_worker, NULL, PAD_POLL_STACK);
+        if (pad_thread < 0)
+            printf("[PAD] Poll thread failed, the pad is read on the emulator thread\n");
+        else
+            printf("[PAD] Poll thread started (host VBlank rate)\n");
+    }
 }
 
 void Joystick_Shutdown(void) {
+    if (pad_thread >= 0) {
+        pad_stop = 1;
+        sceKernelWaitThreadEnd(pad_thread, NULL);
+        sceKernelDeleteThread(pad_thread);
+        pad_thread = -1;
+    }
     pad_initialized = 0;
 }
 
@@ -55,14 +96,23 @@ static uint32_t read_psp_pad(void) {
     return ((uint32_t)hi << 8) | lo;
 }
 
+/* The worker's last poll while it runs */
+static uint32_t psp_pad_buttons(void) {
+    if (pad_thread < 0) return read_psp_pad();
+
+    uint16_t buttons[PAD_SNAPSHOT_MAX];
+    pad_snapshot_read(&pad_snap, buttons);
+    return buttons[0];
+}
+
 uint32_t Joystick_Poll(void) {
     if (!pad_initialized) return 0xFFFF;
-    return read_psp_pad();
+    return psp_pad_buttons();
 }
 
 uint32_t Joystick_PollPort(int port) {
     if (port != 0 || !pad_initialized) return 0xFFFF;
-    return read_psp_pad();
+    return psp_pad_buttons();
 }
 
 int Joystick_HasMultitap(int port) {
@@ -83,7 +133,7 @@ void Joystick_GetPSXDigitalResponse(int port, int slot, uint8_t response[3]) {
         response[2] = 0xFF;
         return;
     }
-    uint32_t buttons = read_psp_pad();
+    uint32_t buttons = psp_pad_buttons();
     response[0] = 0x41; /* Digital pad ID */
     response[1] = (uint8_t)(buttons & 0xFF);        /* Low byte */
     response[2] = (uint8_t)((buttons >> 8) & 0xFF);  /* High byte */
@@ -28,6 +28,12 @@ void Platform_FlushICache(void) {
     sceKernelIcacheInvalidateAll();
 }
 
+void Platform_SyncCodeRange(void *start, void *end) {
+    unsigned int size = (uintptr_t)end - (uintptr_t)start;
+    sceKernelDcacheWritebackRange(start, size);
+    sceKernelIcacheInvalidateRange(start, size);
+}
+
 uint64_t Platform_GetCycles(void) {
     return (uint64_t)sceKernelGetSystemTimeLow();
 }
@@ -36,6 +42,54 @@ void Platform_Sleep(uint32_t ms) {
     sceKernelDelayThread(ms * 1000);
 }
 
+/* User-mode code can't see the interrupted PC */
+int Platform_SampleStart(uint32_t hz, void (*cb)(uintptr_t pc)) {
+    (void)hz;
+    (void)cb;
+    return -1;
+}
+
+void Platform_SampleStop(void) {
+}
+
+typedef struct {
+    void (*entry)(void *);
+    void *arg;
+} PspThreadArgs;
+
+static int psp_thread_entry(SceSize args, void *argp) {
+    (void)args;
+    PspThreadArgs *a = (PspThreadArgs *)argp; /* copy on the new stack */
+    a->entry(a->arg);
+    return 0;
+}
+
+int Platform_ThreadStart(const char *name, void (*entry)(void *), void *arg,
+                         int stack_size) {
+    PspThreadArgs a = { entry, arg };
+    int prio = sceKernelGetThreadCurrentPriority() - 1;
+    int id = sceKernelCreateThread(name, psp_thread_entry, prio > 8 ? prio : 8,
+                                   stack_size, PSP_THREAD_ATTR_USER, NULL);
+    if (id < 0) return -1;
+    if (sceKernelStartThread(id, sizeof(a), &a) < 0) {
+        sceKernelDeleteThread(id);
+        return -1;
+    }
+    return id;
+}
+
+int Platform_SemaCreate(int init_count, int max_count) {
+    return sceKernelCreateSema("platform", 0, init_count, max_count, NULL);
+}
+
+void Platform_SemaWait(int sema) {
+    sceKernelWaitSema(sema, 1, NULL);
+}
+
+void Platform_SemaSignal(int sema) {
+    sceKernelSignalSema(sema, 1);
+}
+
 /* PSP has no hardware TLB — provide stubs */
 uint32_t psx_tlb_base = 0;
 void Setup_PSX_TLB(void) {}
@@ -7,6 +7,7 @@
  */
 #include "profiler.h"
 #include "gpu_state.h"
+#include "iso_image.h"
 #include <stdio.h>
 
 /* From dynarec_run.c — hotspot tracker */
@@ -42,9 +43,11 @@ static uint32_t prof_report_num = 0;
 static uint64_t prof_total_frames = 0;
 
 /* Grand totals across all reports */
-static clock_t prof_grand_ticks[PROF_NUM];
+static uint64_t prof_grand_ticks[PROF_NUM];
 static uint32_t prof_grand_calls[PROF_NUM];
-static clock_t prof_grand_wall = 0;
+static uint64_t prof_grand_imiss[PROF_NUM];
+static uint64_t prof_grand_dmiss[PROF_NUM];
+static uint64_t prof_grand_wall = 0;
 static uint32_t prof_grand_frames = 0;
 static uint64_t prof_grand_psx_cycles = 0;
 static uint32_t prof_grand_jit_blocks = 0;
@@ -76,6 +79,35 @@ static void write_gpu_commands(FILE *out, const gpu_frame_stats_t *s, uint32_t n
             s->tex_upload_full / nf, s->tex_upload_partial / nf,
             s->tex_upload_4bpp / nf, s->tex_upload_8bpp / nf,
             s->tex_upload_rows / nf);
+    if (s->tex_direct || s->tex_direct_fallback)
+        fprintf(out, "  Direct T4/T8 rects: %.1f (fallback to tcache %.1f)\n",
+                s->tex_direct / nf, s->tex_direct_fallback / nf);
+    if (s->replay_chains || s->replay_captures)
+        fprintf(out, "  Replay: chains=%.1f captures=%.1f, %lu frames from cache\n",
+                s->replay_chains / nf, s->replay_captures / nf,
+                (unsigned long)s->replay_frames);
+    if (s->skipped_frames)
+        fprintf(out, "  Frameskip: %lu frames skipped, %.1f prims dropped/frame\n",
+                (unsigned long)s->skipped_frames, s->skipped_prims / nf);
+    if (s->culled_degenerate || s->culled_offscreen)
+        fprintf(out, "  Culled: degenerate=%.1f offscreen=%.1f\n",
+                s->culled_degenerate / nf, s->culled_offscreen / nf);
+    if (s->gif_qwords)
+        fprintf(out, "  GIF: %.0f qwords/frame (%.1f KB)\n",
+                s->gif_qwords / nf, s->gif_qwords * 16 / 1024.0 / nf);
+    if (s->gs_state_written || s->gs_state_skipped)
+        fprintf(out, "  GS state: %.1f regs written/frame, %.1f elided\n",
+                s->gs_state_written / nf, s->gs_state_skipped / nf);
+}
+
+static void write_cdrom_cache(FILE *out, const IsoCacheStats *s, uint32_t nframes)
+{
+    uint32_t lookups = s->hits + s->misses;
+    if (!lookups)
+        return;
+    fprintf(out, "CDROM read-ahead: hit=%.1f miss=%.1f (%.1f%% hit rate) read=%.1f KB/frame\n",
+            (double)s->hits / nframes, (double)s->misses / nframes,
+            100.0 * s->hits / lookups, s->bytes_read / 1024.0 / nframes);
 }
 
 static void accumulate_gpu_stats(gpu_frame_stats_t *dst, const gpu_frame_stats_t *src)
@@ -100,55 +132,79 @@ static void accumulate_gpu_stats(gpu_frame_stats_t *dst, const gpu_frame_stats_t
     dst->clut_cache_hit += src->clut_cache_hit;
     dst->clut_cache_miss += src->clut_cache_miss;
     dst->tex_key_change += src->tex_key_change;
+    dst->tex_direct += src->tex_direct;
+    dst->tex_direct_fallback += src->tex_direct_fallback;
     dst->vbatch_flushes += src->vbatch_flushes;
     dst->vbatch_verts += src->vbatch_verts;
     dst->vram_readbacks += src->vram_readbacks;
+    dst->replay_chains += src->replay_chains;
+    dst->replay_captures += src->replay_captures;
+    dst->replay_frames += src->replay_frames;
+    dst->skipped_prims += src->skipped_prims;
+    dst->skipped_frames += src->skipped_frames;
+    dst->culled_degenerate += src->culled_degenerate;
+    dst->culled_offscreen += src->culled_offscreen;
+    dst->gif_qwords += src->gif_qwords;
 }
 
 /* ── Internal: write a formatted report table ────────────────────── */
 static void write_report(FILE *out,
-                         uint32_t nframes, clock_t total_wall,
-                         clock_t *ticks, uint32_t *calls,
+                         uint32_t nframes, uint64_t total_wall,
+                         const uint64_t *ticks, const uint32_t *calls,
+                         const uint64_t *imiss, const uint64_t *dmiss,
                          uint64_t psx_cycles, uint32_t jit_blocks,
                          uint32_t jit_compiles, uint64_t gpu_pixels)
 {
     if (nframes == 0 || total_wall == 0)
         return;
 
-    double total_ms = (double)total_wall * 1000.0 / CLOCKS_PER_SEC;
+    double total_ms = (double)total_wall * 1000.0 / PROF_TICKS_PER_SEC;
     double avg_ms = total_ms / nframes;
     double speed_pct = (avg_ms > 0) ? (16.667 / avg_ms * 100.0) : 0;
 
     fprintf(out, "Frame budget : 16.67ms (60fps NTSC)\n");
     fprintf(out, "Avg frame    : %.2f ms (%.1f%% speed)\n", avg_ms, speed_pct);
-    fprintf(out, "CLOCKS_PER_SEC: %d\n\n", (int)CLOCKS_PER_SEC);
+    fprintf(out, "Ticks/sec    : %.0f\n\n", PROF_TICKS_PER_SEC);
 
-    clock_t accounted = 0;
+    uint64_t accounted = 0;
     for (int i = 0; i < PROF_NUM; i++)
         accounted += ticks[i];
-    clock_t other = (total_wall > accounted) ? (total_wall - accounted) : 0;
-
+    uint64_t other = (total_wall > accounted) ? (total_wall - accounted) : 0;
+
+#ifdef PROF_HAVE_CACHE_COUNTERS
+    fprintf(out, "%-20s %9s %7s %9s %9s %9s %9s\n",
+            "Category", "Time(ms)", "%Total", "Calls/f", "Avg(us)", "I$miss/f", "D$miss/f");
+#else
+    (void)imiss;
+    (void)dmiss;
     fprintf(out, "%-20s %9s %7s %9s %9s\n",
             "Category", "Time(ms)", "%Total", "Calls/f", "Avg(us)");
+#endif
     fprintf(out, "--------------------------------------------------------------\n");
 
     for (int i = 0; i < PROF_NUM; i++)
     {
-        double ms = (double)ticks[i] * 1000.0 / CLOCKS_PER_SEC;
+        double ms = (double)ticks[i] * 1000.0 / PROF_TICKS_PER_SEC;
         double pct = (double)ticks[i] * 100.0 / total_wall;
         double cpf = (double)calls[i] / nframes;
         double avg = (calls[i] > 0) ? (ms * 1000.0 / calls[i]) : 0;
 
         if (ticks[i] > 0 || calls[i] > 0)
         {
+#ifdef PROF_HAVE_CACHE_COUNTERS
+            fprintf(out, "%-20s %9.1f %6.1f%% %9.1f %9.1f %9.0f %9.0f\n",
+                    prof_category_names[i], ms, pct, cpf, avg,
+                    (double)imiss[i] / nframes, (double)dmiss[i] / nframes);
+#else
             fprintf(out, "%-20s %9.1f %6.1f%% %9.1f %9.1f\n",
                     prof_category_names[i], ms, pct, cpf, avg);
+#endif
         }
     }
 
     /* Other / Unaccounted */
     {
-        double ms = (double)other * 1000.0 / CLOCKS_PER_SEC;
+        double ms = (double)other * 1000.0 / PROF_TICKS_PER_SEC;
         double pct = (double)other * 100.0 / total_wall;
         fprintf(out, "%-20s %9.1f %6.1f%%       -         -\n",
                 "Other/Unaccounted", ms, pct);
@@ -168,6 +224,48 @@ static void write_report(FILE *out,
             (double)gpu_pixels / nframes);
 }
 
+/* ── Internal: hardware counters ─────────────────────────────────── */
+
+/* (Re)start the EE performance counters: PCR0 on I$ misses, PCR1 on
+ * D$ misses, counting in every mode.  The counters raise an exception
+ * once bit 31 sets, so they're zeroed at every report rather than left
+ * to run. */
+static void prof_counters_start(void)
+{
+#ifdef PROF_HAVE_CACHE_COUNTERS
+    const uint32_t pccr = (1u << 31)                  /* CTE             */
+                          | (6u << 15) | (0xFu << 11) /* EVENT1: D$ miss */
+                          | (6u << 5) | (0xFu << 1);  /* EVENT0: I$ miss */
+    __asm__ volatile("mtps %0, 0\n"
+                     "sync.p\n"
+                     "mtpc $0, 0\n"
+                     "mtpc $0, 1\n"
+                     "sync.p\n" ::"r"(pccr));
+#endif
+}
+
+/* Time empty push/pop pairs nested in an outer category to find what
+ * the profiler charges for itself.  Borrows the SIO and scheduler
+ * slots, which are cleared again before the first frame. */
+static void prof_calibrate(void)
+{
+    enum { N = 1024 };
+    prof.overhead_self = prof.overhead_outer = 0;
+    prof_push(PROF_SCHEDULER);
+    for (int i = 0; i < N; i++)
+    {
+        prof_push(PROF_SIO);
+        prof_pop(PROF_SIO);
+    }
+    prof_pop(PROF_SCHEDULER);
+    prof.overhead_self = (prof_tick_t)(prof.ticks[PROF_SIO] / N);
+    prof.overhead_outer = (prof_tick_t)(prof.ticks[PROF_SCHEDULER] / (N + 1));
+    memset(prof.ticks, 0, sizeof(prof.ticks));
+    memset(prof.calls, 0, sizeof(prof.calls));
+    memset(prof.icache_miss, 0, sizeof(prof.icache_miss));
+    memset(prof.dcache_miss, 0, sizeof(prof.dcache_miss));
+}
+
 /* ── Public API ──────────────────────────────────────────────────── */
 
 void profiler_init(void)
@@ -175,6 +273,8 @@ void profiler_init(void)
     memset(&prof, 0, sizeof(prof));
     memset(prof_grand_ticks, 0, sizeof(prof_grand_ticks));
     memset(prof_grand_calls, 0, sizeof(prof_grand_calls));
+    memset(prof_grand_imiss, 0, sizeof(prof_grand_imiss));
+    memset(prof_grand_dmiss, 0, sizeof(prof_grand_dmiss));
     prof_grand_wall = 0;
     prof_grand_frames = 0;
     prof_grand_psx_cycles = 0;
@@ -185,26 +285,37 @@ void profiler_init(void)
     prof_report_num = 0;
     prof_total_frames = 0;
 
+    prof_counters_start();
+    prof_calibrate();
+
     prof_log_file = fopen("profile.log", "w");
     if (prof_log_file)
     {
         fprintf(prof_log_file,
                 "SuperPSX Subsystem Profiler Log\n"
                 "===============================\n"
-                "CLOCKS_PER_SEC: %d\n"
+                "Ticks/sec: %.0f  |  Overhead/pair: %u self, %u outer ticks\n"
                 "Disable SPU: %d  |  Disable GPU render: %d\n\n",
-                (int)CLOCKS_PER_SEC,
+                PROF_TICKS_PER_SEC,
+                (unsigned)prof.overhead_self, (unsigned)prof.overhead_outer,
                 prof_disable_spu, prof_disable_gpu_render);
         fflush(prof_log_file);
     }
 
-    prof.frame_start_tick = clock();
+    prof.frame_start_tick = prof_now();
+}
+
+void profiler_get_totals(double ms[PROF_NUM])
+{
+    for (int i = 0; i < PROF_NUM; i++)
+        ms[i] = (double)(prof_grand_ticks[i] + prof.ticks[i]) * 1000.0 / PROF_TICKS_PER_SEC;
 }
 
 void profiler_frame_end(uint64_t psx_cycles_this_frame)
 {
-    clock_t now = clock();
-    clock_t frame_wall = now - prof.frame_start_tick;
+    prof_mark_t now;
+    prof_mark(&now);
+    prof_tick_t frame_wall = now.t - prof.frame_start_tick;
 
     /* Snapshot the topmost stack entry only.
      *
@@ -222,7 +333,7 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
     {
         int top = prof.stack_depth - 1;
         int cat = prof.stack[top];
-        prof.ticks[cat] += now - prof.stack_enter[top];
+        prof_charge(cat, &prof.stack_enter[top], &now, 0);
         prof.stack_enter[top] = now;
     }
 
@@ -232,7 +343,7 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
     prof_total_frames++;
 
     /* Reset frame start for next frame */
-    prof.frame_start_tick = clock();
+    prof.frame_start_tick = prof_now();
 
     /* ── Report every N frames ── */
     if (prof.frames >= PROF_REPORT_INTERVAL)
@@ -244,6 +355,8 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
         {
             prof_grand_ticks[i] += prof.ticks[i];
             prof_grand_calls[i] += prof.calls[i];
+            prof_grand_imiss[i] += prof.icache_miss[i];
+            prof_grand_dmiss[i] += prof.dcache_miss[i];
         }
         prof_grand_wall += prof.total_wall_ticks;
         prof_grand_frames += prof.frames;
@@ -254,7 +367,7 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
 
         /* ---- Console summary (one-liner) ---- */
         {
-            double total_ms = (double)prof.total_wall_ticks * 1000.0 / CLOCKS_PER_SEC;
+            double total_ms = (double)prof.total_wall_ticks * 1000.0 / PROF_TICKS_PER_SEC;
             double avg_ms = total_ms / prof.frames;
             double speed = (avg_ms > 0) ? (16.667 / avg_ms * 100.0) : 0;
 
@@ -267,10 +380,10 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
                     printf(" %s=%.1f%%", prof_category_names[i], pct);
                 }
             }
-            clock_t acc = 0;
+            uint64_t acc = 0;
             for (int i = 0; i < PROF_NUM; i++)
                 acc += prof.ticks[i];
-            clock_t oth = (prof.total_wall_ticks > acc)
+            uint64_t oth = (prof.total_wall_ticks > acc)
                               ? (prof.total_wall_ticks - acc)
                               : 0;
             if (oth > 0)
@@ -286,7 +399,7 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
                 double nf = (double)prof.frames;
                 printf("[GPU ] tex=%.0f flat=%.0f rect_t=%.0f rect_f=%.0f fill=%.0f"
                        " | tc h/m=%.0f/%.0f clut h/m=%.0f/%.0f"
-                       " | key=%.0f batch=%.0f verts=%.0f\n",
+                       " | direct=%.0f/%.0f key=%.0f batch=%.0f verts=%.0f\n",
                        gpu_frame_stats.poly_tex / nf,
                        gpu_frame_stats.poly_flat / nf,
                        gpu_frame_stats.rect_tex / nf,
@@ -296,6 +409,8 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
                        gpu_frame_stats.texcache_miss / nf,
                        gpu_frame_stats.clut_cache_hit / nf,
                        gpu_frame_stats.clut_cache_miss / nf,
+                       gpu_frame_stats.tex_direct / nf,
+                       gpu_frame_stats.tex_direct_fallback / nf,
                        gpu_frame_stats.tex_key_change / nf,
                        gpu_frame_stats.vbatch_flushes / nf,
                        gpu_frame_stats.vbatch_verts / nf);
@@ -319,12 +434,14 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
             write_report(prof_log_file,
                          prof.frames, prof.total_wall_ticks,
                          prof.ticks, prof.calls,
+                         prof.icache_miss, prof.dcache_miss,
                          prof.psx_cycles, prof.jit_blocks,
                          prof.jit_compiles, prof.gpu_pixels);
 
             /* ── Per-frame GPU command breakdown ── */
             write_gpu_commands(prof_log_file, &gpu_frame_stats, prof.frames);
             accumulate_gpu_stats(&prof_grand_gpu_stats, &gpu_frame_stats);
+            write_cdrom_cache(prof_log_file, &iso_cache_stats, prof.frames);
             fprintf(prof_log_file, "\n");
 
             /* Grand totals every 5 reports */
@@ -337,6 +454,7 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
                 write_report(prof_log_file,
                              prof_grand_frames, prof_grand_wall,
                              prof_grand_ticks, prof_grand_calls,
+                             prof_grand_imiss, prof_grand_dmiss,
                              prof_grand_psx_cycles, prof_grand_jit_blocks,
                              prof_grand_jit_compiles, prof_grand_gpu_pixels);
                 write_gpu_commands(prof_log_file, &prof_grand_gpu_stats, prof_grand_frames);
@@ -352,6 +470,8 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
         /* ---- Reset accumulators for next interval ---- */
         memset(prof.ticks, 0, sizeof(prof.ticks));
         memset(prof.calls, 0, sizeof(prof.calls));
+        memset(prof.icache_miss, 0, sizeof(prof.icache_miss));
+        memset(prof.dcache_miss, 0, sizeof(prof.dcache_miss));
         prof.total_wall_ticks = 0;
         prof.frames = 0;
         prof.psx_cycles = 0;
@@ -359,11 +479,14 @@ void profiler_frame_end(uint64_t psx_cycles_this_frame)
         prof.jit_compiles = 0;
         prof.gpu_pixels = 0;
         memset(&gpu_frame_stats, 0, sizeof(gpu_frame_stats));
+        memset(&iso_cache_stats, 0, sizeof(iso_cache_stats));
         /* Keep stack intact — callers still have pending PROF_POP.
          * Reset all entry times to prevent old-interval time
          * from bleeding into the new accumulator period. */
         {
-            clock_t rst = clock();
+            prof_mark_t rst;
+            prof_counters_start();
+            prof_mark(&rst);
             for (int i = 0; i < prof.stack_depth; i++)
                 prof.stack_enter[i] = rst;
         }
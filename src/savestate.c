@@ -0,0 +1,457 @@
+/**
+ * savestate.c — In-memory save state slots and rewind
+ *
+ * Walks every subsystem's X_State() section in one fixed order.  The
+ * arena size is measured once with a dry pass, so each slot is a single
+ * allocation made at Snapshot_Init and reused by every save.
+ */
+#include "savestate.h"
+#include "superpsx.h"
+#include "config.h"
+#include "psx_sio.h"
+#include "mem_budget.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SNAPSHOT_MAX_SLOTS 4
+
+static uint8_t *snap_buf[SNAPSHOT_MAX_SLOTS];
+static int snap_valid[SNAPSHOT_MAX_SLOTS];
+static int snap_slots = 0;
+static uint32_t snap_size = 0;
+
+volatile int snapshot_pending = 0;
+static int snap_req_save = -1;
+static int snap_req_load = -1;
+static int snap_req_rewind = 0; /* 1 = capture a point, 2 = step back */
+
+/* Load order matters where a section re-derives host state: memory
+ * before anything reading RAM, timers before the GPU refreshes the
+ * dotclock divider cache */
+static void snapshot_walk(StateIO *io)
+{
+    CPU_State(io);
+    GTE_State(io);
+    Memory_State(io);
+    Hardware_State(io);
+    Sched_State(io);
+    Dynarec_State(io);
+    Timers_State(io);
+    DMA_State(io);
+    CDROM_State(io);
+    CDXA_State(io);
+    SPU_State(io);
+    MDEC_State(io);
+    SIO_State(io);
+    MCD_State(io);
+    GPU_State(io);
+    HLE_State(io);
+}
+
+static uint32_t snapshot_measure(void)
+{
+    if (!snap_size)
+    {
+        StateIO io = {NULL, 0, 0, 0, 0};
+        snapshot_walk(&io);
+        snap_size = io.pos;
+    }
+    return snap_size;
+}
+
+int Snapshot_Init(int slots)
+{
+    if (snap_slots)
+        return 0;
+    if (slots < 1)
+        slots = 1;
+    if (slots > SNAPSHOT_MAX_SLOTS)
+        slots = SNAPSHOT_MAX_SLOTS;
+
+    snapshot_measure();
+
+    for (int i = 0; i < slots; i++)
+    {
+        snap_buf[i] = (uint8_t *)malloc(snap_size);
+        if (!snap_buf[i])
+        {
+            printf("[STATE] Out of memory for slot %d (%u bytes)\n", i, (unsigned)snap_size);
+            while (--i >= 0)
+            {
+                free(snap_buf[i]);
+                snap_buf[i] = NULL;
+            }
+            return -1;
+        }
+        snap_valid[i] = 0;
+    }
+    snap_slots = slots;
+    printf("[STATE] %d slot(s) of %u KB\n", slots, (unsigned)(snap_size >> 10));
+    return 0;
+}
+
+int Snapshot_Save(int slot)
+{
+    if (slot < 0 || slot >= snap_slots)
+        return -1;
+    clock_t t0 = clock();
+    StateIO io = {snap_buf[slot], 0, snap_size, 0, 0};
+    snapshot_walk(&io);
+    snap_valid[slot] = 1;
+    printf("[STATE] Saved slot %d in %.2f ms\n", slot,
+           (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC);
+    return 0;
+}
+
+int Snapshot_Load(int slot)
+{
+    if (slot < 0 || slot >= snap_slots || !snap_valid[slot])
+        return -1;
+    clock_t t0 = clock();
+    StateIO io = {snap_buf[slot], 0, snap_size, 1, 0};
+    snapshot_walk(&io);
+    printf("[STATE] Loaded slot %d in %.2f ms\n", slot,
+           (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC);
+    return 0;
+}
+
+/* ---- Boot snapshot ---- */
+#define BOOTSNAP_MAGIC 0x504E5342u /* "BSNP" */
+#define BOOTSNAP_VERSION 1
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;      /* snapshot_measure() */
+    uint32_t build;     /* Code and heap layout: host pointers in the sections */
+    uint32_t psx_ram;
+    uint32_t bios_hash;
+    uint32_t config;    /* Options that change what the BIOS init leaves behind */
+} BootSnapHeader;
+
+static void bootsnap_header(BootSnapHeader *h)
+{
+    uint32_t hash = 5381;
+    const uint32_t *w = (const uint32_t *)psx_bios;
+    for (uint32_t i = 0; i < PSX_BIOS_SIZE / 4; i++)
+        hash = (hash << 5) + hash + w[i];
+
+    memset(h, 0, sizeof(*h));
+    h->magic = BOOTSNAP_MAGIC;
+    h->version = BOOTSNAP_VERSION;
+    h->size = snapshot_measure();
+    h->build = (uint32_t)(uintptr_t)Snapshot_Init;
+    h->psx_ram = (uint32_t)(uintptr_t)psx_ram;
+    h->bios_hash = hash;
+    h->config = (uint32_t)psx_config.bios_hle | ((uint32_t)psx_config.cycle_model << 1) |
+                ((uint32_t)psx_config.hblank_lazy << 2) | ((uint32_t)psx_config.dma_timing << 3) |
+                ((uint32_t)psx_config.cycle_scale << 8);
+}
+
+static void bootsnap_path(char *buf, size_t len, const BootSnapHeader *h)
+{
+    snprintf(buf, len, "bootsnap_%08X.bin", (unsigned)h->bios_hash);
+}
+
+int BootSnapshot_Save(void)
+{
+    BootSnapHeader h;
+    char path[64];
+
+    bootsnap_header(&h);
+    uint8_t *buf = (uint8_t *)malloc(h.size);
+    if (!buf)
+    {
+        printf("[STATE] Out of memory for the boot snapshot (%u bytes)\n", (unsigned)h.size);
+        return -1;
+    }
+    StateIO io = {buf, 0, h.size, 0, 0};
+    snapshot_walk(&io);
+
+    bootsnap_path(path, sizeof(path), &h);
+    FILE *f = fopen(path, "wb");
+    int ok = f && fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(buf, 1, h.size, f) == h.size;
+    if (f && fclose(f) != 0)
+        ok = 0;
+    free(buf);
+    if (!ok)
+    {
+        printf("[STATE] Can't write boot snapshot %s\n", path);
+        remove(path);
+        return -1;
+    }
+    printf("[STATE] Boot snapshot saved to %s (%u KB)\n", path, (unsigned)(h.size >> 10));
+    return 0;
+}
+
+int BootSnapshot_Load(void)
+{
+    BootSnapHeader want, h;
+    char path[64];
+
+    bootsnap_header(&want);
+    bootsnap_path(path, sizeof(path), &want);
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return -1;
+    if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(&h, &want, sizeof(h)) != 0)
+    {
+        printf("[STATE] Boot snapshot %s is from another build or config, ignored\n", path);
+        fclose(f);
+        return -1;
+    }
+    uint8_t *buf = (uint8_t *)malloc(h.size);
+    if (!buf || fread(buf, 1, h.size, f) != h.size)
+    {
+        printf("[STATE] Can't read boot snapshot %s\n", path);
+        free(buf);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+
+    clock_t t0 = clock();
+    StateIO io = {buf, 0, h.size, 1, 0};
+    snapshot_walk(&io);
+    free(buf);
+    printf("[STATE] Boot snapshot %s loaded in %.2f ms\n", path,
+           (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC);
+    return 0;
+}
+
+/* ---- Rewind ----
+ * rw_image holds the newest point.  Capturing the next one is a delta
+ * save into it: every span that differs is overwritten after its old
+ * bytes go to the ring as a record {pos, len, bytes}, so each ring
+ * entry turns the image back into the point before it.  Adjacent spans
+ * are merged into one record.  The oldest entries are dropped to make
+ * room; an entry bigger than the whole ring clears the history. */
+#define REWIND_MAX_POINTS 1024
+#define REWIND_STEP_FRAMES 4     /* frames between steps while held */
+#define REWIND_HOTKEY 0x0101     /* Select + L2 */
+
+static uint8_t *rw_image = NULL;
+static int rw_image_valid = 0;
+static uint8_t *rw_ring = NULL;
+static uint32_t rw_cap, rw_head, rw_used;
+static struct
+{
+    uint32_t start, len;
+} rw_entry[REWIND_MAX_POINTS];
+static int rw_first, rw_count;
+static uint32_t rw_cur_start, rw_cur_len; /* entry being logged */
+static uint32_t rw_rec_hdr, rw_rec_end;   /* last record: header offset, image end */
+static int rw_overflow;
+static int rw_frames;
+
+static void rw_ring_write(uint32_t at, const void *src, uint32_t n)
+{
+    uint32_t first = rw_cap - at;
+    if (first > n)
+        first = n;
+    memcpy(rw_ring + at, src, first);
+    memcpy(rw_ring, (const uint8_t *)src + first, n - first);
+}
+
+static void rw_ring_read(uint32_t at, void *dst, uint32_t n)
+{
+    uint32_t first = rw_cap - at;
+    if (first > n)
+        first = n;
+    memcpy(dst, rw_ring + at, first);
+    memcpy((uint8_t *)dst + first, rw_ring, n - first);
+}
+
+static void rw_drop_oldest(void)
+{
+    rw_used -= rw_entry[rw_first].len;
+    rw_first = (rw_first + 1) % REWIND_MAX_POINTS;
+    rw_count--;
+}
+
+/* Append n bytes to the entry being logged, evicting old entries */
+static int rw_put(const void *src, uint32_t n)
+{
+    while (rw_used + n > rw_cap)
+    {
+        if (!rw_count)
+            return -1;
+        rw_drop_oldest();
+    }
+    rw_ring_write(rw_head, src, n);
+    rw_head = (rw_head + n) % rw_cap;
+    rw_used += n;
+    rw_cur_len += n;
+    return 0;
+}
+
+void state_undo(StateIO *io, uint32_t pos, uint32_t n)
+{
+    if (rw_overflow)
+        return;
+    if (rw_cur_len && pos == rw_rec_end)
+    {
+        /* Continues the last record: grow its length in place */
+        uint32_t hdr[2];
+        rw_ring_read(rw_rec_hdr, hdr, sizeof(hdr));
+        hdr[1] += n;
+        if (rw_put(io->buf + pos, n) < 0)
+        {
+            rw_overflow = 1;
+            return;
+        }
+        rw_ring_write(rw_rec_hdr, hdr, sizeof(hdr));
+    }
+    else
+    {
+        uint32_t hdr[2] = {pos, n};
+        uint32_t at = rw_head;
+        if (rw_put(hdr, sizeof(hdr)) < 0 || rw_put(io->buf + pos, n) < 0)
+        {
+            rw_overflow = 1;
+            return;
+        }
+        rw_rec_hdr = at;
+    }
+    rw_rec_end = pos + n;
+}
+
+int Rewind_Init(uint32_t ring_bytes)
+{
+    if (rw_ring)
+        return 0;
+    snapshot_measure();
+    /* The ring is whatever the memory plan kept for it, at most this */
+    if (ring_bytes > MemPool_Avail(MEM_POOL_STATE))
+        ring_bytes = MemPool_Avail(MEM_POOL_STATE);
+    rw_image = (uint8_t *)malloc(snap_size);
+    rw_ring = (uint8_t *)MemPool_Alloc(MEM_POOL_STATE, ring_bytes, 64);
+    if (!rw_image || !rw_ring || ring_bytes < 4096)
+    {
+        printf("[STATE] Out of memory for rewind (%u + %u bytes)\n",
+               (unsigned)snap_size, (unsigned)ring_bytes);
+        free(rw_image);
+        MemPool_Reset(MEM_POOL_STATE);
+        rw_image = rw_ring = NULL;
+        return -1;
+    }
+    rw_cap = ring_bytes;
+    rw_head = rw_used = 0;
+    rw_first = rw_count = 0;
+    rw_image_valid = 0;
+    printf("[STATE] Rewind: %u KB image + %u KB ring\n",
+           (unsigned)(snap_size >> 10), (unsigned)(ring_bytes >> 10));
+    return 0;
+}
+
+static void rewind_capture(void)
+{
+    StateIO io = {rw_image, 0, snap_size, 0, rw_image_valid};
+
+    if (!rw_image_valid)
+    {
+        snapshot_walk(&io);
+        rw_image_valid = 1;
+        return;
+    }
+    if (rw_count == REWIND_MAX_POINTS)
+        rw_drop_oldest();
+    rw_cur_start = rw_head;
+    rw_cur_len = 0;
+    rw_overflow = 0;
+    snapshot_walk(&io);
+
+    if (rw_overflow)
+    {
+        /* The image is the new point either way; nothing before it is left */
+        rw_head = rw_used = 0;
+        rw_first = rw_count = 0;
+        return;
+    }
+    int e = (rw_first + rw_count) % REWIND_MAX_POINTS;
+    rw_entry[e].start = rw_cur_start;
+    rw_entry[e].len = rw_cur_len;
+    rw_count++;
+}
+
+static void rewind_step(void)
+{
+    if (!rw_image_valid)
+        return;
+    if (rw_count)
+    {
+        int e = (rw_first + rw_count - 1) % REWIND_MAX_POINTS;
+        uint32_t at = rw_entry[e].start, left = rw_entry[e].len;
+        while (left >= 8)
+        {
+            uint32_t hdr[2];
+            rw_ring_read(at, hdr, sizeof(hdr));
+            at = (at + 8) % rw_cap;
+            rw_ring_read(at, rw_image + hdr[0], hdr[1]);
+            at = (at + hdr[1]) % rw_cap;
+            left -= 8 + hdr[1];
+        }
+        rw_head = rw_entry[e].start;
+        rw_used -= rw_entry[e].len;
+        rw_count--;
+    }
+    StateIO io = {rw_image, 0, snap_size, 1, 0};
+    snapshot_walk(&io);
+}
+
+void Rewind_Frame(void)
+{
+    if (!rw_ring)
+        return;
+    rw_frames++;
+    if ((sio_host_buttons & REWIND_HOTKEY) == REWIND_HOTKEY)
+    {
+        if (rw_frames >= REWIND_STEP_FRAMES)
+        {
+            rw_frames = 0;
+            snap_req_rewind = 2;
+            snapshot_pending = 1;
+        }
+    }
+    else if (rw_frames >= psx_config.rewind_interval)
+    {
+        rw_frames = 0;
+        snap_req_rewind = 1;
+        snapshot_pending = 1;
+    }
+}
+
+void Snapshot_RequestSave(int slot)
+{
+    snap_req_save = slot;
+    snapshot_pending = 1;
+}
+
+void Snapshot_RequestLoad(int slot)
+{
+    snap_req_load = slot;
+    snapshot_pending = 1;
+}
+
+/* A save requested together with a load runs first, so "save then
+ * rewind" from one callback round-trips */
+void Snapshot_Service(void)
+{
+    int save = snap_req_save, load = snap_req_load, rewind = snap_req_rewind;
+
+    snapshot_pending = 0;
+    snap_req_save = -1;
+    snap_req_load = -1;
+    snap_req_rewind = 0;
+    if (save >= 0)
+        Snapshot_Save(save);
+    if (load >= 0)
+        Snapshot_Load(load);
+    if (rewind == 1)
+        rewind_capture();
+    else if (rewind == 2)
+        rewind_step();
+}
@@ -5,18 +5,23 @@
 
 #define LOG_TAG "SCHED"
 #include "superpsx.h"
+#include "savestate.h"
 
 /*
  * SuperPSX Event-Driven Scheduler
  *
  * All hot-path functions (Schedule, Remove, Dispatch) are static inline
- * in scheduler.h.  Only Init and global definitions live here.
+ * in scheduler.h, on a binary min-heap of the active events.  Only Init
+ * and global definitions live here.
  */
 
 /* ---- Shared state (accessed by inline functions in scheduler.h) ---- */
 int sched_active[SCHED_EVENT_COUNT];
 uint64_t sched_deadline[SCHED_EVENT_COUNT];
 sched_callback_t sched_callback[SCHED_EVENT_COUNT];
+uint8_t sched_heap[SCHED_EVENT_COUNT];
+uint8_t sched_heap_pos[SCHED_EVENT_COUNT];
+int sched_heap_size;
 
 uint64_t global_cycles = 0;
 uint32_t partial_block_cycles = 0;
@@ -31,6 +36,7 @@ void Sched_Init(void)
     memset(sched_active, 0, sizeof(sched_active));
     memset(sched_deadline, 0, sizeof(sched_deadline));
     memset(sched_callback, 0, sizeof(sched_callback));
+    sched_heap_size = 0;
     global_cycles = 0;
     partial_block_cycles = 0;
     sched_cached_earliest = UINT64_MAX;
@@ -38,3 +44,19 @@ void Sched_Init(void)
     sched_interrupt_chain = 0;
     printf("Scheduler initialized (%d event slots)\n", SCHED_EVENT_COUNT);
 }
+
+/* ---- Save state: the heap as it stands (callbacks are in-process
+ * function pointers, valid for in-memory snapshots) ---- */
+void Sched_State(StateIO *io)
+{
+    STATE_VAR(io, sched_active);
+    STATE_VAR(io, sched_deadline);
+    STATE_VAR(io, sched_callback);
+    STATE_VAR(io, sched_heap);
+    STATE_VAR(io, sched_heap_pos);
+    STATE_VAR(io, sched_heap_size);
+    STATE_VAR(io, global_cycles);
+    STATE_VAR(io, partial_block_cycles);
+    STATE_VAR(io, sched_cached_earliest);
+    STATE_VAR(io, sched_earliest_id);
+}
@@ -6,6 +6,8 @@
 #include "psx_sio.h"
 #include "memorycard.h"
 #include "profiler.h"
+#include "savestate.h"
+#include "benchmark.h"
 
 #define LOG_TAG "SIO"
 
@@ -42,7 +44,14 @@ static inline void sio_flush_deferred_vblank(void)
     }
 }
 
-static uint8_t sio_response[20]; /* Pre-built response buffer */
+/* Pad transactions: each port's whole response (header + every multitap
+ * slot) is built from one controller poll per frame, the first time the
+ * game selects the pad after SIO_VBlank, then served byte by byte */
+static uint8_t sio_pad_resp[2][20];
+static int sio_pad_len[2];
+static int sio_pad_valid[2];
+uint16_t sio_host_buttons = 0; /* pad 1 buttons held, PSX bit order, 1 = pressed */
+static const uint8_t *sio_response = sio_pad_resp[0]; /* current exchange */
 int sio_response_len = 0;        /* Number of valid bytes in sio_response */
 int sio_selected = 0;            /* 1 = JOY SELECT is asserted */
 static int sio_port = 0;         /* 0 = PSX port 1, 1 = PSX port 2 */
@@ -125,6 +134,98 @@ static inline void sio_cancel_irq(void)
     Sched_Remove(SCHED_EVENT_SIO_IRQ);
 }
 
+static void sio_pad_build(int port)
+{
+    uint8_t *r = sio_pad_resp[port];
+
+    if (Bench_PadReplay(port, r, &sio_pad_len[port]))
+    {
+        sio_pad_valid[port] = 1;
+        return;
+    }
+    if (Joystick_HasMultitap(port))
+    {
+        int slot;
+        r[0] = 0xFF;
+        r[1] = 0x80;
+        r[2] = 0x5A;
+        for (slot = 0; slot < 4; slot++)
+        {
+            int base = 3 + slot * 4;
+            if (Joystick_IsConnected(port, slot))
+            {
+                uint8_t pad[3];
+                Joystick_GetPSXDigitalResponse(port, slot, pad);
+                r[base] = pad[0];
+                r[base + 1] = 0x5A;
+                r[base + 2] = pad[1];
+                r[base + 3] = pad[2];
+            }
+            else
+            {
+                r[base] = 0xFF;
+                r[base + 1] = 0xFF;
+                r[base + 2] = 0xFF;
+                r[base + 3] = 0xFF;
+            }
+        }
+        sio_pad_len[port] = 19;
+    }
+    else
+    {
+        uint8_t pad[3];
+        Joystick_GetPSXDigitalResponse(port, 0, pad);
+        r[0] = 0xFF;
+        r[1] = pad[0];
+        r[2] = 0x5A;
+        r[3] = pad[1];
+        r[4] = pad[2];
+        sio_pad_len[port] = 5;
+    }
+    if (port == 0)
+    {
+        const uint8_t *b = (sio_pad_len[0] == 19) ? &r[5] : &r[3]; /* slot A */
+        sio_host_buttons = (uint16_t)~(b[0] | b[1] << 8);
+    }
+    Bench_PadRecord(port, r, sio_pad_len[port]);
+    sio_pad_valid[port] = 1;
+}
+
+/* New frame: the next pad exchange on either port polls again */
+void SIO_VBlank(void)
+{
+    sio_pad_valid[0] = 0;
+    sio_pad_valid[1] = 0;
+}
+
+/* Pad snapshots are state too: a load inside an exchange must finish
+ * it with the bytes the game already started reading */
+void SIO_State(StateIO *io)
+{
+    STATE_VAR(io, sio_data);
+    STATE_VAR(io, sio_stat);
+    STATE_VAR(io, sio_mode);
+    STATE_VAR(io, sio_ctrl);
+    STATE_VAR(io, sio_baud);
+    STATE_VAR(io, sio_tx_pending);
+    STATE_VAR(io, sio_state);
+    STATE_VAR(io, sio_deferred_vblank);
+    STATE_VAR(io, sio_pad_resp);
+    STATE_VAR(io, sio_pad_len);
+    STATE_VAR(io, sio_pad_valid);
+    STATE_VAR(io, sio_response);
+    STATE_VAR(io, sio_response_len);
+    STATE_VAR(io, sio_selected);
+    STATE_VAR(io, sio_port);
+    STATE_VAR(io, sio_device);
+    STATE_VAR(io, serial_mode);
+    STATE_VAR(io, serial_ctrl);
+    STATE_VAR(io, serial_baud);
+    STATE_VAR(io, sio_irq_delay_cycle);
+    STATE_VAR(io, sio_irq_pending);
+    STATE_VAR(io, sio_ack_latch);
+}
+
 static inline uint32_t SIO_Read_Inner(uint32_t phys)
 {
     switch (phys - 0x1F801040)
@@ -215,45 +316,10 @@ static inline void SIO_Write_Inner(uint32_t phys, uint32_t data)
             if (tx == 0x01)
             {
                 sio_device = 1; /* pad */
-                if (Joystick_HasMultitap(sio_port))
-                {
-                    int slot;
-                    sio_response[0] = 0xFF;
-                    sio_response[1] = 0x80;
-                    sio_response[2] = 0x5A;
-                    for (slot = 0; slot < 4; slot++)
-                    {
-                        int base = 3 + slot * 4;
-                        if (Joystick_IsConnected(sio_port, slot))
-                        {
-                            uint8_t pad[3];
-                            Joystick_GetPSXDigitalResponse(sio_port, slot, pad);
-                            sio_response[base] = pad[0];
-                            sio_response[base + 1] = 0x5A;
-                            sio_response[base + 2] = pad[1];
-                            sio_response[base + 3] = pad[2];
-                        }
-                        else
-                        {
-                            sio_response[base] = 0xFF;
-                            sio_response[base + 1] = 0xFF;
-                            sio_response[base + 2] = 0xFF;
-                            sio_response[base + 3] = 0xFF;
-                        }
-                    }
-                    sio_response_len = 19;
-                }
-                else
-                {
-                    uint8_t pad[3];
-                    Joystick_GetPSXDigitalResponse(sio_port, 0, pad);
-                    sio_response[0] = 0xFF;
-                    sio_response[1] = pad[0];
-                    sio_response[2] = 0x5A;
-                    sio_response[3] = pad[1];
-                    sio_response[4] = pad[2];
-                    sio_response_len = 5;
-                }
+                if (!sio_pad_valid[sio_port])
+                    sio_pad_build(sio_port);
+                sio_response = sio_pad_resp[sio_port];
+                sio_response_len = sio_pad_len[sio_port];
                 sio_data = sio_response[0];
                 sio_state = 1;
                 sio_tx_pending = 1;
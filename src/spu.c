@@ -8,6 +8,10 @@
 #include "spu.h"
 #include "scheduler.h"
 #include "profiler.h"
+#include "config.h"
+#include "savestate.h"
+#include "benchmark.h"
+#include "fast_copy.h"
 
 #define LOG_TAG "SPU"
 
@@ -85,6 +89,50 @@ static uint32_t pending_kon;   /* 24-bit mask of channels awaiting KON */
 /* Reverb / noise / misc registers — stored but not processed */
 static uint16_t spu_reg_store[256];
 
+/* ---- Decoded ADPCM block cache ----
+ * Looped instrument samples cross the same blocks over and over, and
+ * several voices often play one instrument.  A block's PCM depends only
+ * on its 16 bytes and the two history samples it starts from, so entries
+ * are keyed by block address, shift/filter header and incoming history
+ * (at a loop restart that is the loop end's, so it repeats too; filter 0
+ * ignores it).  Direct-mapped; SPU RAM writes through the data port and
+ * DMA4 drop the blocks they touch.  Blocks from the lowest mBASE reverb
+ * has run with upwards are never cached (reverb rewrites them). */
+#define ADPCM_CACHE_ENTRIES 1024
+#define ADPCM_BLOCKS (SPU_RAM_SIZE >> 4)
+
+typedef struct
+{
+    uint16_t block;  /* SPU RAM address >> 4 */
+    uint8_t header;  /* shift / filter byte */
+    uint8_t valid;
+    int16_t hist[2]; /* prev[0], prev[1] the block was decoded from */
+    int16_t pcm[28];
+} AdpcmCacheEntry; /* 64 bytes */
+
+static AdpcmCacheEntry adpcm_cache[ADPCM_CACHE_ENTRIES] __attribute__((aligned(64)));
+static uint32_t adpcm_cache_limit = ADPCM_BLOCKS; /* first uncached block */
+
+static void adpcm_cache_invalidate(uint32_t addr, uint32_t bytes)
+{
+    uint32_t first = (addr & (SPU_RAM_SIZE - 1)) >> 4;
+    uint32_t count = (((addr & 15) + bytes + 15) >> 4);
+
+    if (count >= ADPCM_CACHE_ENTRIES)
+    {
+        for (int i = 0; i < ADPCM_CACHE_ENTRIES; i++)
+            adpcm_cache[i].valid = 0;
+        return;
+    }
+    for (uint32_t n = 0; n < count; n++)
+    {
+        uint32_t b = (first + n) & (ADPCM_BLOCKS - 1);
+        AdpcmCacheEntry *e = &adpcm_cache[b & (ADPCM_CACHE_ENTRIES - 1)];
+        if (e->block == b)
+            e->valid = 0;
+    }
+}
+
 /* ---- SPU IRQ9 (address match interrupt) ---- */
 static uint32_t spu_irq_addr;   /* Byte address in SPU RAM (IRQ address reg × 8) */
 static int      spu_irq_enabled; /* Cached SPUCNT bit 6 */
@@ -108,6 +156,17 @@ static const int32_t adpcm_filter[5][2] = {
 static int16_t mix_buffer[SPU_MIX_BUF_SIZE * 2] __attribute__((aligned(16))); /* Interleaved L/R */
 static int32_t mix_buf_l[SPU_MIX_BUF_SIZE] __attribute__((aligned(16)));
 static int32_t mix_buf_r[SPU_MIX_BUF_SIZE] __attribute__((aligned(16)));
+/* One voice's resampled PCM, indexed like mix_buf_l/r so a span of it
+ * shares their 16-byte alignment (see spu_mix_span) */
+static int16_t voice_pcm[SPU_MIX_BUF_SIZE] __attribute__((aligned(16)));
+/* Reverb input: the mix of voices with their EON bit set */
+static int32_t rev_buf_l[SPU_MIX_BUF_SIZE] __attribute__((aligned(16)));
+static int32_t rev_buf_r[SPU_MIX_BUF_SIZE] __attribute__((aligned(16)));
+static uint32_t rev_addr;            /* reverb buffer address, in halfwords */
+static uint32_t rev_phase;           /* position within a 22.05 kHz tick, 16.16 */
+static int rev_count;                /* output samples summed into rev_in_l/r */
+static int32_t rev_in_l, rev_in_r;   /* input summed over the current tick */
+static int32_t rev_out_l, rev_out_r; /* held output of the last tick */
 static int spu_initialized = 0;
 int spu_samples_generated = 0; /* Incremental: how many samples generated this frame */
 static uint64_t spu_frame_start_cycle = 0;
@@ -115,6 +174,28 @@ static uint64_t spu_frame_start_cycle = 0;
 /* CPU cycles per SPU sample: 33868800 / 44100 ≈ 768 */
 #define CYCLES_PER_SAMPLE 768
 
+/* Output rate (audio_rate).  The SPU itself runs at 44.1 kHz; at a lower
+ * rate every output sample stands for spu_tick_q12 / 4096 SPU ticks, so
+ * voice pitch and ADSR counters advance by that many ticks and fewer
+ * samples are mixed per frame. */
+static int spu_out_rate = SPU_SAMPLE_RATE;
+static int spu_frame_samples = SAMPLES_PER_FRAME;
+static uint32_t spu_cycles_per_sample = CYCLES_PER_SAMPLE;
+static uint32_t spu_tick_q12 = 4096;  /* 44.1 kHz ticks per output sample */
+static uint32_t spu_rev_step = 32768; /* 22.05 kHz reverb ticks per output sample, 16.16 */
+
+/* Samples mixed per SCHED_EVENT_SPU event.  Register accesses only catch
+ * up when the mixer can see the change (KON/KOFF, voice pitch / volume,
+ * ENDX, ENVX reads, IRQ9 setup, DMA into SPU RAM); anything else waits
+ * for the next block. */
+#define SPU_EVENT_SAMPLES 32
+
+/* SPU ticks from the start of the frame to output sample k */
+static inline uint32_t spu_ticks_to(int k)
+{
+    return ((uint32_t)k * spu_tick_q12) >> 12;
+}
+
 /* ---- ADSR envelope implementation ----
  *
  * PSX SPU ADSR algorithm (from psx-spx nocash documentation):
@@ -327,6 +408,8 @@ static inline int32_t get_effective_volume(int16_t raw)
 void SPU_Init(void)
 {
     memset(spu_ram, 0, sizeof(spu_ram));
+    memset(adpcm_cache, 0, sizeof(adpcm_cache));
+    adpcm_cache_limit = ADPCM_BLOCKS;
     memset(voices, 0, sizeof(voices));
     memset(spu_reg_store, 0, sizeof(spu_reg_store));
     main_vol_l = 0;
@@ -342,6 +425,19 @@ void SPU_Init(void)
     spu_irq_addr = 0;
     spu_irq_enabled = 0;
     spu_irq_fired = 0;
+    rev_addr = 0;
+    rev_phase = 0;
+    rev_count = 0;
+    rev_in_l = rev_in_r = 0;
+    rev_out_l = rev_out_r = 0;
+
+    spu_out_rate = psx_config.audio_rate;
+    spu_frame_samples = spu_out_rate / 60;
+    spu_cycles_per_sample = 33868800u / (uint32_t)spu_out_rate;
+    spu_tick_q12 = (uint32_t)(((SPU_SAMPLE_RATE << 12) + spu_out_rate / 2) / spu_out_rate);
+    spu_rev_step = (uint32_t)(((uint64_t)(SPU_SAMPLE_RATE / 2) << 16) / (uint32_t)spu_out_rate);
+    CDXA_SetOutputRate(spu_out_rate);
+    CDDA_SetOutputRate(spu_out_rate);
 
     int audio_ret = Audio_Backend_Init();
     if (audio_ret < 0)
@@ -350,15 +446,24 @@ void SPU_Init(void)
         return;
     }
 
-    int ret = Audio_Backend_Configure(SPU_SAMPLE_RATE, 16, 2, SPU_MAX_VOLUME);
+    int ret = Audio_Backend_Configure(spu_out_rate, 16, 2, SPU_MAX_VOLUME);
     if (ret != 0)
     {
         printf("[SPU] Audio_Backend_Configure failed: %d\n", ret);
         return;
     }
 
+    if (psx_config.audio_latency)
+    {
+        int frames = psx_config.audio_latency * spu_out_rate / 1000;
+        if (Audio_Backend_StartThread(frames) == 0)
+            printf("[SPU] Threaded output, %d ms latency target\n", psx_config.audio_latency);
+        else
+            printf("[SPU] Audio_Backend_StartThread failed, output stays synchronous\n");
+    }
+
     spu_initialized = 1;
-    printf("[SPU] Initialized: %d Hz, 16-bit, stereo\n", SPU_SAMPLE_RATE);
+    printf("[SPU] Initialized: %d Hz, 16-bit, stereo\n", spu_out_rate);
 }
 
 int SPU_IsInitialized(void)
@@ -366,6 +471,24 @@ int SPU_IsInitialized(void)
     return spu_initialized;
 }
 
+int SPU_OutputRate(void)
+{
+    return spu_out_rate;
+}
+
+int SPU_OutputQueued(void)
+{
+    return spu_initialized ? Audio_Backend_Queued() : -1;
+}
+
+uint32_t SPU_OutputUnderruns(void)
+{
+    uint32_t under = 0, over = 0;
+    if (spu_initialized && Audio_Backend_Queued() >= 0)
+        Audio_Backend_GetStats(&under, &over);
+    return under;
+}
+
 void SPU_Shutdown(void)
 {
     if (spu_initialized)
@@ -391,58 +514,78 @@ static inline __attribute__((always_inline)) void decode_adpcm_block(SPU_Voice *
     if (filter > 4)
         filter = 4;
 
-    /* ---- Pass 1: Extract all 28 nibbles and pre-shift (branch-free) ---- */
-    int16_t shifted[28];
-    int i;
-    for (i = 0; i < 14; i++)
-    {
-        uint8_t byte = block[2 + i];
-        /* Low nibble (even sample): sign-extend 4-bit */
-        int32_t lo = (int32_t)(int8_t)((byte & 0x0F) << 4) >> 4;
-        /* High nibble (odd sample): sign-extend 4-bit */
-        int32_t hi = (int32_t)(int8_t)(byte & 0xF0) >> 4;
-        shifted[i * 2] = (int16_t)((lo << 12) >> shift);
-        shifted[i * 2 + 1] = (int16_t)((hi << 12) >> shift);
-    }
-
-    int16_t s_1, s_2;
+    uint32_t blk = (addr & (SPU_RAM_SIZE - 1)) >> 4;
+    AdpcmCacheEntry *ce = &adpcm_cache[blk & (ADPCM_CACHE_ENTRIES - 1)];
+    int cacheable = blk < adpcm_cache_limit;
 
-    if (filter == 0)
+    if (cacheable && ce->valid && ce->block == blk && ce->header == shift_filter &&
+        (filter == 0 || (ce->hist[0] == v->prev[0] && ce->hist[1] == v->prev[1])))
     {
-        /* ---- Fast path: no prediction (f0=f1=0) ---- */
-        /* (s_1*0 + s_2*0 + 32) >> 6 == 0, so sample = shifted[i].
-         * Pre-shifted values fit in int16_t (nibble −8..7, <<12 >>shift). */
-        memcpy(v->decoded, shifted, sizeof(shifted));
-        s_1 = shifted[27];
-        s_2 = shifted[26];
+        memcpy(v->decoded, ce->pcm, sizeof(ce->pcm));
     }
     else
     {
-        /* ---- Pass 2: IIR filter with serial dependency ---- */
-        int32_t f0 = adpcm_filter[filter][0];
-        int32_t f1 = adpcm_filter[filter][1];
+        int16_t hist0 = v->prev[0], hist1 = v->prev[1];
 
-        s_1 = v->prev[0];
-        s_2 = v->prev[1];
+        /* ---- Pass 1: Extract all 28 nibbles and pre-shift (branch-free) ---- */
+        int16_t shifted[28];
+        int i;
+        for (i = 0; i < 14; i++)
+        {
+            uint8_t byte = block[2 + i];
+            /* Low nibble (even sample): sign-extend 4-bit */
+            int32_t lo = (int32_t)(int8_t)((byte & 0x0F) << 4) >> 4;
+            /* High nibble (odd sample): sign-extend 4-bit */
+            int32_t hi = (int32_t)(int8_t)(byte & 0xF0) >> 4;
+            shifted[i * 2] = (int16_t)((lo << 12) >> shift);
+            shifted[i * 2 + 1] = (int16_t)((hi << 12) >> shift);
+        }
 
-        for (i = 0; i < 28; i++)
+        if (filter == 0)
+        {
+            /* ---- Fast path: no prediction (f0=f1=0) ---- */
+            /* (s_1*0 + s_2*0 + 32) >> 6 == 0, so sample = shifted[i].
+             * Pre-shifted values fit in int16_t (nibble −8..7, <<12 >>shift). */
+            memcpy(v->decoded, shifted, sizeof(shifted));
+        }
+        else
         {
-            int32_t sample = (int32_t)shifted[i] + ((s_1 * f0 + s_2 * f1 + 32) >> 6);
+            /* ---- Pass 2: IIR filter with serial dependency ---- */
+            int32_t f0 = adpcm_filter[filter][0];
+            int32_t f1 = adpcm_filter[filter][1];
+
+            int16_t s_1 = hist0;
+            int16_t s_2 = hist1;
+
+            for (i = 0; i < 28; i++)
+            {
+                int32_t sample = (int32_t)shifted[i] + ((s_1 * f0 + s_2 * f1 + 32) >> 6);
 
-            /* Clamp to 16-bit (overflow is rare → hint branch predictor) */
-            if (__builtin_expect(sample > 32767, 0))
-                sample = 32767;
-            if (__builtin_expect(sample < -32768, 0))
-                sample = -32768;
+                /* Clamp to 16-bit (overflow is rare → hint branch predictor) */
+                if (__builtin_expect(sample > 32767, 0))
+                    sample = 32767;
+                if (__builtin_expect(sample < -32768, 0))
+                    sample = -32768;
 
-            v->decoded[i] = (int16_t)sample;
-            s_2 = s_1;
-            s_1 = (int16_t)sample;
+                v->decoded[i] = (int16_t)sample;
+                s_2 = s_1;
+                s_1 = (int16_t)sample;
+            }
+        }
+
+        if (cacheable)
+        {
+            ce->block = (uint16_t)blk;
+            ce->header = shift_filter;
+            ce->valid = 1;
+            ce->hist[0] = hist0;
+            ce->hist[1] = hist1;
+            memcpy(ce->pcm, v->decoded, sizeof(ce->pcm));
         }
     }
 
-    v->prev[0] = s_1;
-    v->prev[1] = s_2;
+    v->prev[0] = v->decoded[27];
+    v->prev[1] = v->decoded[26];
     v->block_decoded = 1;
 
     /* Handle loop flags */
@@ -550,13 +693,20 @@ void SPU_WriteReg(uint32_t offset, uint16_t value)
             SPU_Voice *v = &voices[voice];
             switch (reg)
             {
+            /* Volume / pitch: mix up to now with the old value first */
             case 0:
+                if (v->active && (uint16_t)v->vol_l != value)
+                    SPU_CatchUp();
                 v->vol_l = (int16_t)value;
                 break;
             case 1:
+                if (v->active && (uint16_t)v->vol_r != value)
+                    SPU_CatchUp();
                 v->vol_r = (int16_t)value;
                 break;
             case 2:
+                if (v->active && v->pitch != value)
+                    SPU_CatchUp();
                 v->pitch = value;
                 break;
             case 3:
@@ -642,6 +792,8 @@ void SPU_WriteReg(uint32_t offset, uint16_t value)
 
     /* Sound RAM IRQ Address (0x1F801DA4) */
     case 0xD2:
+        if (spu_irq_enabled)
+            SPU_CatchUp(); /* samples so far were checked against the old address */
         spu_reg_store[0xD2] = value;
         spu_irq_addr = (uint32_t)value << 3; /* Convert from 8-byte units to byte address */
         break;
@@ -659,6 +811,7 @@ void SPU_WriteReg(uint32_t offset, uint16_t value)
         {
             spu_ram[transfer_ptr] = (uint8_t)(value & 0xFF);
             spu_ram[transfer_ptr + 1] = (uint8_t)(value >> 8);
+            adpcm_cache_invalidate(transfer_ptr, 2);
             /* Check IRQ9 address match on FIFO write */
             if (spu_irq_enabled && !spu_irq_fired &&
                 (transfer_ptr & ~0xF) == spu_irq_addr)
@@ -674,6 +827,8 @@ void SPU_WriteReg(uint32_t offset, uint16_t value)
 
     /* SPUCNT (0x1F801DAA) */
     case 0xD5:
+        if (value != spu_cnt)
+            SPU_CatchUp(); /* IRQ9 enable, CD input and reverb bits affect mixing */
         spu_cnt = value;
         /* SPUSTAT bits 0-5 mirror SPUCNT bits 0-5 directly.
          * Bit 6 = IRQ9 flag (preserved). */
@@ -772,6 +927,21 @@ uint16_t SPU_ReadReg(uint32_t offset)
 }
 
 /* ---- DMA Channel 4: CPU RAM ↔ SPU RAM ---- */
+/* SPU IRQ9 on a DMA transfer: fires if the run [ptr, ptr + bytes)
+ * touches the 16-byte line at the IRQ address (per halfword moved, the
+ * check was (ptr & ~0xF) == spu_irq_addr) */
+static void spu_dma_irq_check(uint32_t ptr, uint32_t bytes)
+{
+    if (!spu_irq_enabled || spu_irq_fired || (spu_irq_addr & 0xF))
+        return;
+    if (spu_irq_addr >= (ptr & ~0xFu) && spu_irq_addr <= ((ptr + bytes - 2) & ~0xFu))
+    {
+        spu_stat |= 0x0040;
+        spu_irq_fired = 1;
+        SignalInterrupt(9);
+    }
+}
+
 void SPU_DMA4(uint32_t madr, uint32_t bcr, uint32_t chcr)
 {
     /* Catch up SPU before modifying SPU RAM — voices reading from
@@ -791,62 +961,209 @@ void SPU_DMA4(uint32_t madr, uint32_t bcr, uint32_t chcr)
 
     int direction = (chcr & 1); /* 0 = to main RAM, 1 = from main RAM (to SPU) */
 
+    /* The copy stops at the end of main RAM; SPU RAM wraps, so it goes
+     * in runs up to the wrap point */
+    if (total_bytes > PSX_RAM_SIZE - src_addr)
+        total_bytes = PSX_RAM_SIZE - src_addr;
+
     if (direction)
     {
         /* CPU RAM → SPU RAM */
         DLOG("DMA4 Write: CPU 0x%06" PRIX32 " -> SPU 0x%05" PRIX32 ", %" PRIu32 " words\n",
              src_addr, transfer_ptr, total_words);
-
-        uint32_t i;
-        for (i = 0; i < total_bytes; i += 2)
-        {
-            if (src_addr + i + 1 < PSX_RAM_SIZE && transfer_ptr < SPU_RAM_SIZE - 1)
-            {
-                spu_ram[transfer_ptr] = psx_ram[src_addr + i];
-                spu_ram[transfer_ptr + 1] = psx_ram[src_addr + i + 1];
-                /* SPU IRQ9: check if DMA write touches IRQ address */
-                if (spu_irq_enabled && !spu_irq_fired &&
-                    (transfer_ptr & ~0xF) == spu_irq_addr)
-                {
-                    spu_stat |= 0x0040;
-                    spu_irq_fired = 1;
-                    SignalInterrupt(9);
-                }
-                transfer_ptr += 2;
-                transfer_ptr &= (SPU_RAM_SIZE - 1);
-            }
-        }
+        adpcm_cache_invalidate(transfer_ptr, total_bytes);
     }
     else
     {
         /* SPU RAM → CPU RAM */
         DLOG("DMA4 Read: SPU 0x%05" PRIX32 " -> CPU 0x%06" PRIX32 ", %" PRIu32 " words\n",
              transfer_ptr, src_addr, total_words);
+    }
 
-        uint32_t i;
-        for (i = 0; i < total_bytes; i += 2)
-        {
-            if (src_addr + i + 1 < PSX_RAM_SIZE && transfer_ptr < SPU_RAM_SIZE - 1)
-            {
-                psx_ram[src_addr + i] = spu_ram[transfer_ptr];
-                psx_ram[src_addr + i + 1] = spu_ram[transfer_ptr + 1];
-                /* SPU IRQ9: check if DMA read touches IRQ address */
-                if (spu_irq_enabled && !spu_irq_fired &&
-                    (transfer_ptr & ~0xF) == spu_irq_addr)
-                {
-                    spu_stat |= 0x0040;
-                    spu_irq_fired = 1;
-                    SignalInterrupt(9);
-                }
-                transfer_ptr += 2;
-                transfer_ptr &= (SPU_RAM_SIZE - 1);
-            }
-        }
+    uint32_t done = 0;
+    while (done < total_bytes)
+    {
+        uint32_t run = SPU_RAM_SIZE - transfer_ptr;
+        if (run > total_bytes - done)
+            run = total_bytes - done;
+        spu_dma_irq_check(transfer_ptr, run);
+        if (direction)
+            fast_copy_bulk(&spu_ram[transfer_ptr], &psx_ram[src_addr + done], run);
+        else
+            fast_copy_bulk(&psx_ram[src_addr + done], &spu_ram[transfer_ptr], run);
+        transfer_ptr = (transfer_ptr + run) & (SPU_RAM_SIZE - 1);
+        done += run;
     }
 
     (void)chcr;
 }
 
+/* ---- Reverb ----
+ *
+ * PSX reverb (psx-spx "SPU Reverb Formula"), run at 22050 Hz on a work
+ * area in SPU RAM from mBASE to the end of RAM.  Register set at
+ * 1F801DC0h-1F801DFFh (dAPF1..vRIN), mBASE at 1F801DA2h, vLOUT/vROUT at
+ * 1F801D84h/86h, EON at 1F801D98h; processing needs SPUCNT bit 7.
+ * Addresses are in 8-byte units relative to the current buffer address,
+ * which advances one halfword per tick and wraps inside the work area.
+ *
+ * spu_reverb = 2 runs the full formula; 1 drops the 3rd/4th comb taps
+ * (their gains folded into the 1st/2nd) and the second all-pass stage,
+ * roughly halving the SPU RAM traffic.  Input is the average of the two
+ * 44.1 kHz samples of a tick and the output is held for both; it is added
+ * straight into the dry mix ahead of SPU_Mix_And_Clamp. */
+enum
+{
+    REV_dAPF1, REV_dAPF2, REV_vIIR, REV_vCOMB1, REV_vCOMB2, REV_vCOMB3, REV_vCOMB4,
+    REV_vWALL, REV_vAPF1, REV_vAPF2, REV_mLSAME, REV_mRSAME, REV_mLCOMB1, REV_mRCOMB1,
+    REV_mLCOMB2, REV_mRCOMB2, REV_dLSAME, REV_dRSAME, REV_mLDIFF, REV_mRDIFF,
+    REV_mLCOMB3, REV_mRCOMB3, REV_mLCOMB4, REV_mRCOMB4, REV_dLDIFF, REV_dRDIFF,
+    REV_mLAPF1, REV_mRAPF1, REV_mLAPF2, REV_mRAPF2, REV_vLIN, REV_vRIN,
+    REV_NUM_REGS
+};
+#define REV_REG_BASE 0xE0 /* 1F801DC0h as a halfword offset */
+
+static inline int32_t rev_clamp(int32_t v)
+{
+    return (v > 32767) ? 32767 : (v < -32768) ? -32768 : v;
+}
+
+static inline int32_t rev_mul(int32_t a, int32_t b)
+{
+    return (a * b) >> 15;
+}
+
+/* Work-area halfword index of buffer-relative offset off (halfwords,
+ * may be slightly negative for the [m-2] / [m-dAPF] taps) */
+static inline uint32_t rev_index(uint32_t base, uint32_t size, int32_t off)
+{
+    int32_t a = (int32_t)(rev_addr - base) + off;
+    if (a >= (int32_t)size)
+    {
+        a -= (int32_t)size;
+        if (a >= (int32_t)size)
+            a %= (int32_t)size;
+    }
+    else if (a < 0)
+    {
+        a += (int32_t)size;
+        if (a < 0)
+            a = (int32_t)size - 1 - ((-a - 1) % (int32_t)size);
+    }
+    return base + (uint32_t)a;
+}
+
+#define REV_RD(off) ((int32_t)ram16[rev_index(base, size, (off))])
+#define REV_WR(off, v) (ram16[rev_index(base, size, (off))] = (int16_t)rev_clamp(v))
+
+/* One 22050 Hz tick: in_l/in_r → rev_out_l/rev_out_r */
+static void reverb_tick(const int16_t *r, int32_t in_l, int32_t in_r, int full)
+{
+    int16_t *ram16 = (int16_t *)spu_ram;
+    uint32_t base = (uint32_t)(uint16_t)spu_reg_store[0xD1] * 4; /* mBASE, halfwords */
+    uint32_t size = SPU_RAM_SIZE / 2 - base;
+    if (size == 0)
+        return;
+    if ((base >> 3) < adpcm_cache_limit) /* work area grew down into cached blocks */
+    {
+        adpcm_cache_invalidate(base * 2, (adpcm_cache_limit << 4) - base * 2);
+        adpcm_cache_limit = base >> 3;
+    }
+    if (rev_addr < base) /* mBASE moved up */
+        rev_addr = base;
+#define RA(reg) ((int32_t)(uint16_t)r[reg] * 4) /* 8-byte units → halfwords */
+
+    int32_t lin = rev_mul(rev_clamp(in_l), r[REV_vLIN]);
+    int32_t rin = rev_mul(rev_clamp(in_r), r[REV_vRIN]);
+    int32_t wall = r[REV_vWALL], iir = r[REV_vIIR];
+
+    /* Same-side and cross-side reflections (sums clamped before the
+     * IIR multiply so the product stays in 32 bits) */
+    int32_t ls1 = REV_RD(RA(REV_mLSAME) - 1), rs1 = REV_RD(RA(REV_mRSAME) - 1);
+    int32_t ld1 = REV_RD(RA(REV_mLDIFF) - 1), rd1 = REV_RD(RA(REV_mRDIFF) - 1);
+    REV_WR(RA(REV_mLSAME), rev_mul(rev_clamp(lin + rev_mul(REV_RD(RA(REV_dLSAME)), wall) - ls1), iir) + ls1);
+    REV_WR(RA(REV_mRSAME), rev_mul(rev_clamp(rin + rev_mul(REV_RD(RA(REV_dRSAME)), wall) - rs1), iir) + rs1);
+    REV_WR(RA(REV_mLDIFF), rev_mul(rev_clamp(lin + rev_mul(REV_RD(RA(REV_dRDIFF)), wall) - ld1), iir) + ld1);
+    REV_WR(RA(REV_mRDIFF), rev_mul(rev_clamp(rin + rev_mul(REV_RD(RA(REV_dLDIFF)), wall) - rd1), iir) + rd1);
+
+    /* Early echo (comb filters) */
+    int32_t lout, rout;
+    if (full)
+    {
+        lout = rev_mul(r[REV_vCOMB1], REV_RD(RA(REV_mLCOMB1))) + rev_mul(r[REV_vCOMB2], REV_RD(RA(REV_mLCOMB2))) +
+               rev_mul(r[REV_vCOMB3], REV_RD(RA(REV_mLCOMB3))) + rev_mul(r[REV_vCOMB4], REV_RD(RA(REV_mLCOMB4)));
+        rout = rev_mul(r[REV_vCOMB1], REV_RD(RA(REV_mRCOMB1))) + rev_mul(r[REV_vCOMB2], REV_RD(RA(REV_mRCOMB2))) +
+               rev_mul(r[REV_vCOMB3], REV_RD(RA(REV_mRCOMB3))) + rev_mul(r[REV_vCOMB4], REV_RD(RA(REV_mRCOMB4)));
+    }
+    else
+    {
+        int32_t c13 = r[REV_vCOMB1] + r[REV_vCOMB3], c24 = r[REV_vCOMB2] + r[REV_vCOMB4];
+        lout = rev_mul(c13, REV_RD(RA(REV_mLCOMB1))) + rev_mul(c24, REV_RD(RA(REV_mLCOMB2)));
+        rout = rev_mul(c13, REV_RD(RA(REV_mRCOMB1))) + rev_mul(c24, REV_RD(RA(REV_mRCOMB2)));
+    }
+
+    /* Late reverb (all-pass filters) */
+    int32_t apf1 = r[REV_vAPF1];
+    int32_t la = REV_RD(RA(REV_mLAPF1) - RA(REV_dAPF1)), ra = REV_RD(RA(REV_mRAPF1) - RA(REV_dAPF1));
+    lout = rev_clamp(lout - rev_mul(apf1, la));
+    rout = rev_clamp(rout - rev_mul(apf1, ra));
+    REV_WR(RA(REV_mLAPF1), lout);
+    REV_WR(RA(REV_mRAPF1), rout);
+    lout = rev_mul(lout, apf1) + la;
+    rout = rev_mul(rout, apf1) + ra;
+    if (full)
+    {
+        int32_t apf2 = r[REV_vAPF2];
+        la = REV_RD(RA(REV_mLAPF2) - RA(REV_dAPF2));
+        ra = REV_RD(RA(REV_mRAPF2) - RA(REV_dAPF2));
+        lout = rev_clamp(lout - rev_mul(apf2, la));
+        rout = rev_clamp(rout - rev_mul(apf2, ra));
+        REV_WR(RA(REV_mLAPF2), lout);
+        REV_WR(RA(REV_mRAPF2), rout);
+        lout = rev_mul(lout, apf2) + la;
+        rout = rev_mul(rout, apf2) + ra;
+    }
+#undef RA
+
+    rev_out_l = rev_mul(rev_clamp(lout), (int16_t)spu_reg_store[0xC2]); /* vLOUT */
+    rev_out_r = rev_mul(rev_clamp(rout), (int16_t)spu_reg_store[0xC3]); /* vROUT */
+
+    rev_addr++;
+    if (rev_addr >= SPU_RAM_SIZE / 2)
+        rev_addr = base;
+}
+
+#undef REV_RD
+#undef REV_WR
+
+/* Run the reverb over a frame's mix: ml/mr += reverb(rl/rr) */
+static void SPU_Reverb(int32_t *__restrict__ ml, int32_t *__restrict__ mr,
+                       const int32_t *__restrict__ rl, const int32_t *__restrict__ rr,
+                       int num_samples)
+{
+    const int16_t *regs = (const int16_t *)&spu_reg_store[REV_REG_BASE];
+    int full = psx_config.spu_reverb >= 2;
+
+    /* One tick per 22.05 kHz period on the averaged input (two samples at
+     * 44.1 kHz, one or two at 32 kHz, one at 22.05 kHz); output held */
+    for (int i = 0; i < num_samples; i++)
+    {
+        rev_in_l += rl[i];
+        rev_in_r += rr[i];
+        rev_count++;
+        rev_phase += spu_rev_step;
+        if (rev_phase >= 0x10000)
+        {
+            rev_phase -= 0x10000;
+            reverb_tick(regs, rev_in_l >> (rev_count - 1), rev_in_r >> (rev_count - 1), full);
+            rev_in_l = rev_in_r = 0;
+            rev_count = 0;
+        }
+        ml[i] += rev_out_l;
+        mr[i] += rev_out_r;
+    }
+}
+
 /* ---- Audio mixing and clamping ---- */
 /* restrict: ml/mr/out never alias; branchless ternary clamp → conditional moves */
 static void SPU_Mix_And_Clamp(int32_t *__restrict__ ml, int32_t *__restrict__ mr,
@@ -870,6 +1187,69 @@ static void SPU_Mix_And_Clamp(int32_t *__restrict__ ml, int32_t *__restrict__ mr
     }
 }
 
+/* ---- Constant-volume voice mix: ml/mr[i] += (voice_pcm[i] * vol) >> 15 ----
+ * for i in [start, start+n); ml/mr are mix_buf_* or rev_buf_*.  On the EE, whole 8-sample groups go through
+ * MMI: PMULTH gives the even products in rd and all eight in HI/LO, PMFHL.UW
+ * fetches the odd ones, PEXTLW/PEXTUW restore sample order.  Bit-exact
+ * with the scalar form (vol <= 0x7FFF fits a signed halfword). */
+static inline void spu_mix_span(int32_t *ml, int32_t *mr, int start, int n, int32_t vol_l, int32_t vol_r)
+{
+    int i = start, end = start + n;
+
+#ifdef _EE
+    for (; i < end && (i & 7); i++)
+    {
+        ml[i] += ((int32_t)voice_pcm[i] * vol_l) >> 15;
+        mr[i] += ((int32_t)voice_pcm[i] * vol_r) >> 15;
+    }
+    /* Each volume broadcast to 8 halfwords ($12 / $13) */
+    uint64_t vl = (uint64_t)(uint32_t)vol_l * 0x0001000100010001ull;
+    uint64_t vr = (uint64_t)(uint32_t)vol_r * 0x0001000100010001ull;
+    for (; i + 8 <= end; i += 8)
+    {
+        __asm__ volatile(
+            "pcpyld  $12, %[vl], %[vl]\n"
+            "pcpyld  $13, %[vr], %[vr]\n"
+            "lq      $8, 0(%[p])\n"
+            /* left: even products, odd products, back in sample order */
+            "pmulth  $9, $8, $12\n"
+            "pmfhl.uw $10\n"
+            "pextlw  $11, $10, $9\n"
+            "pextuw  $9, $10, $9\n"
+            "psraw   $11, $11, 15\n"
+            "psraw   $9, $9, 15\n"
+            "lq      $10, 0(%[l])\n"
+            "paddw   $11, $11, $10\n"
+            "lq      $10, 16(%[l])\n"
+            "paddw   $9, $9, $10\n"
+            "sq      $11, 0(%[l])\n"
+            "sq      $9, 16(%[l])\n"
+            /* right */
+            "pmulth  $9, $8, $13\n"
+            "pmfhl.uw $10\n"
+            "pextlw  $11, $10, $9\n"
+            "pextuw  $9, $10, $9\n"
+            "psraw   $11, $11, 15\n"
+            "psraw   $9, $9, 15\n"
+            "lq      $10, 0(%[r])\n"
+            "paddw   $11, $11, $10\n"
+            "lq      $10, 16(%[r])\n"
+            "paddw   $9, $9, $10\n"
+            "sq      $11, 0(%[r])\n"
+            "sq      $9, 16(%[r])\n"
+            :
+            : [p] "r"(&voice_pcm[i]), [l] "r"(&ml[i]), [r] "r"(&mr[i]),
+              [vl] "r"(vl), [vr] "r"(vr)
+            : "$8", "$9", "$10", "$11", "$12", "$13", "hi", "lo", "memory");
+    }
+#endif
+    for (; i < end; i++)
+    {
+        ml[i] += ((int32_t)voice_pcm[i] * vol_l) >> 15;
+        mr[i] += ((int32_t)voice_pcm[i] * vol_r) >> 15;
+    }
+}
+
 /* ---- Audio mixing: generate a chunk of samples into the mix buffers ---- */
 /* Called incrementally during HBlank batches to spread CPU load.           */
 void SPU_GenerateChunk(int num_samples)
@@ -880,8 +1260,8 @@ void SPU_GenerateChunk(int num_samples)
     PROF_PUSH(PROF_SPU_MIX);
 
     int offset = spu_samples_generated;
-    if (offset + num_samples > SAMPLES_PER_FRAME)
-        num_samples = SAMPLES_PER_FRAME - offset;
+    if (offset + num_samples > spu_frame_samples)
+        num_samples = spu_frame_samples - offset;
     if (num_samples <= 0)
     {
         PROF_POP(PROF_SPU_MIX);
@@ -891,6 +1271,16 @@ void SPU_GenerateChunk(int num_samples)
     /* Clear the chunk region in mix buffers */
     memset(&mix_buf_l[offset], 0, num_samples * sizeof(int32_t));
     memset(&mix_buf_r[offset], 0, num_samples * sizeof(int32_t));
+    /* Fast-forward: voices, ADSR and IRQ9 still advance, nothing is mixed
+     * (benchmarks mix as usual, only the output is dropped) */
+    int mute = sched_unlimited_speed && !bench_active;
+    uint32_t eon = 0;
+    if (psx_config.spu_reverb && !mute)
+    {
+        eon = (uint32_t)spu_reg_store[0xCC] | ((uint32_t)spu_reg_store[0xCD] << 16);
+        memset(&rev_buf_l[offset], 0, num_samples * sizeof(int32_t));
+        memset(&rev_buf_r[offset], 0, num_samples * sizeof(int32_t));
+    }
 
     for (int i = 0; i < SPU_NUM_VOICES; i++)
     {
@@ -900,12 +1290,13 @@ void SPU_GenerateChunk(int num_samples)
 
         int32_t v_vol_l = get_effective_volume(v->vol_l);
         int32_t v_vol_r = get_effective_volume(v->vol_r);
-        uint32_t v_pitch = v->pitch;
+        uint32_t v_pitch = (v->pitch * spu_tick_q12) >> 12;
 
         /* Skip entirely silent voices (zero volume on both channels) */
         if (__builtin_expect(v_vol_l == 0 && v_vol_r == 0, 0))
             continue;
 
+        int to_reverb = (eon >> i) & 1;
         int32_t last_adsr_vol = v->adsr_vol;
         int32_t comb_vol_l = (v_vol_l * last_adsr_vol) >> 15;
         int32_t comb_vol_r = (v_vol_r * last_adsr_vol) >> 15;
@@ -935,10 +1326,17 @@ void SPU_GenerateChunk(int num_samples)
             if (ci <= 0)
                 ci = 1;
 
-            /* Samples before ADSR counter overflows (volume stays constant) */
-            int batch = (v->adsr_counter < 0x8000)
+            /* Samples before ADSR counter overflows (volume stays constant).
+             * A sustain phase already clamped at its limit ticks every
+             * sample but never moves again: no limit then. */
+            int saturated = v->adsr_phase == ADSR_SUSTAIN &&
+                            (v->adsr_inc ? v->adsr_vol >= 0x7FFF : v->adsr_vol <= 0);
+            int batch = saturated ? num_samples
+                        : (v->adsr_counter < 0x8000)
                             ? ((0x7FFF - v->adsr_counter) / ci)
                             : 0;
+            if (!saturated && spu_tick_q12 != 4096)
+                batch = (int)(((uint32_t)batch << 12) / spu_tick_q12); /* ticks → samples */
 
             /* Limit by decoded ADPCM block boundary */
             if (v_pitch > 0)
@@ -953,17 +1351,32 @@ void SPU_GenerateChunk(int num_samples)
             if (batch > remain)
                 batch = remain;
 
-            /* ---- Tight batch loop: constant volume, no ADSR tick ---- */
-            for (int b = 0; b < batch; b++)
+            /* ---- Tight batch loop: constant volume, no ADSR tick ----
+             * Resample into voice_pcm, then mix the span in one go */
+            int batch_ticks = (int)(spu_ticks_to(offset + s + batch) - spu_ticks_to(offset + s));
+            if (batch > 0 && mute)
             {
-                uint32_t si = v->sample_pos >> 12;
-                int16_t pcm = v->decoded[si];
-                mix_buf_l[offset + s] += ((int32_t)pcm * comb_vol_l) >> 15;
-                mix_buf_r[offset + s] += ((int32_t)pcm * comb_vol_r) >> 15;
-                v->sample_pos += v_pitch;
-                s++;
+                v->sample_pos += v_pitch * (uint32_t)batch;
+                s += batch;
+            }
+            else if (batch > 0)
+            {
+                int16_t *pcm_out = &voice_pcm[offset + s];
+                uint32_t pos = v->sample_pos;
+                for (int b = 0; b < batch; b++)
+                {
+                    pcm_out[b] = v->decoded[pos >> 12];
+                    pos += v_pitch;
+                }
+                v->sample_pos = pos;
+                spu_mix_span(mix_buf_l, mix_buf_r, offset + s, batch, comb_vol_l, comb_vol_r);
+                if (to_reverb)
+                    spu_mix_span(rev_buf_l, rev_buf_r, offset + s, batch, comb_vol_l, comb_vol_r);
+                s += batch;
             }
-            v->adsr_counter += ci * batch;
+            v->adsr_counter += ci * batch_ticks;
+            if (saturated)
+                v->adsr_counter &= 0x7FFF; /* same overflow phase as per-sample ticks */
 
             /* Handle ADPCM block boundary */
             if (__builtin_expect((v->sample_pos >> 12) >= 28, 0))
@@ -1004,7 +1417,10 @@ void SPU_GenerateChunk(int num_samples)
                     break;
             }
 
-            adsr_tick(v);
+            int ticks = (int)(spu_ticks_to(offset + s + 1) - spu_ticks_to(offset + s));
+            do
+                adsr_tick(v);
+            while (--ticks > 0 && v->adsr_phase != ADSR_OFF);
             if (v->adsr_phase == ADSR_OFF)
             {
                 v->active = 0;
@@ -1018,14 +1434,20 @@ void SPU_GenerateChunk(int num_samples)
                 comb_vol_r = (v_vol_r * last_adsr_vol) >> 15;
             }
 
+            if (!mute)
             {
                 uint32_t si = v->sample_pos >> 12;
                 int16_t pcm = v->decoded[si];
                 mix_buf_l[offset + s] += ((int32_t)pcm * comb_vol_l) >> 15;
                 mix_buf_r[offset + s] += ((int32_t)pcm * comb_vol_r) >> 15;
-                v->sample_pos += v_pitch;
-                s++;
+                if (to_reverb)
+                {
+                    rev_buf_l[offset + s] += ((int32_t)pcm * comb_vol_l) >> 15;
+                    rev_buf_r[offset + s] += ((int32_t)pcm * comb_vol_r) >> 15;
+                }
             }
+            v->sample_pos += v_pitch;
+            s++;
 
             if (__builtin_expect((v->sample_pos >> 12) >= 28, 0))
             {
@@ -1048,6 +1470,15 @@ void SPU_GenerateChunk(int num_samples)
         }
     }
 
+    /* CD input (XA-ADPCM, CD-DA), SPUCNT bit 0; CD volume at 1F801DB0h.
+     * CD-DA keeps playing while the input is off, only silent. */
+    if (spu_cnt & 1)
+        CDXA_Mix(&mix_buf_l[offset], &mix_buf_r[offset], num_samples,
+                 (int16_t)spu_reg_store[0xD8], (int16_t)spu_reg_store[0xD9]);
+    CDDA_Mix(&mix_buf_l[offset], &mix_buf_r[offset], num_samples,
+             (spu_cnt & 1) ? (int16_t)spu_reg_store[0xD8] : 0,
+             (spu_cnt & 1) ? (int16_t)spu_reg_store[0xD9] : 0);
+
     spu_samples_generated += num_samples;
     PROF_POP(PROF_SPU_MIX);
 }
@@ -1068,20 +1499,30 @@ void SPU_FlushAudio(void)
         return;
     }
 
+    /* Fast-forward: samples are dropped before the driver, which would otherwise pace us */
+    if (sched_unlimited_speed && !bench_active)
+    {
+        spu_samples_generated = 0;
+        PROF_POP(PROF_SPU_FLUSH);
+        return;
+    }
+
     /* Apply main volume and clamp */
     int32_t eff_vol_l = get_effective_volume(main_vol_l);
     int32_t eff_vol_r = get_effective_volume(main_vol_r);
 
+    if (psx_config.spu_reverb && (spu_cnt & 0x0080))
+        SPU_Reverb(mix_buf_l, mix_buf_r, rev_buf_l, rev_buf_r, total);
+
     SPU_Mix_And_Clamp(mix_buf_l, mix_buf_r, mix_buffer, total, eff_vol_l, eff_vol_r);
 
-    /* Output to audsrv — non-blocking: IOP-side play_audio copies
-     * whatever fits into the ring buffer (MIN(size, available)) and
-     * returns immediately.  Removing the blocking wait_audio() saves
-     * ~3ms/frame that was spent sleeping on the IOP queue semaphore.
-     * If the ring buffer is momentarily full, samples are silently
-     * dropped — acceptable trade-off for emulation speed. */
+    /* Output to the audio backend.  Synchronous by default (PS2/PSP wait
+     * for room in the driver queue, which paces the emulator); with
+     * audio_latency set this only copies into the backend's output ring
+     * and the frame limiter paces on its fill level instead. */
     int size = total * 2 * sizeof(int16_t);
-    Audio_Backend_Play(mix_buffer, size);
+    if (!bench_active)
+        Audio_Backend_Play(mix_buffer, size);
 
     spu_samples_generated = 0;
     PROF_POP(PROF_SPU_FLUSH);
@@ -1097,21 +1538,21 @@ void SPU_CatchUp(void)
     if (now <= spu_frame_start_cycle)
         return;
 
-    int target = (int)((now - spu_frame_start_cycle) / CYCLES_PER_SAMPLE);
+    int target = (int)((now - spu_frame_start_cycle) / spu_cycles_per_sample);
 
     /* If the current frame's audio is fully generated but more cycles have
      * elapsed (e.g. KON arriving during a long ISR after VBlank), flush the
      * completed frame and advance spu_frame_start_cycle so new voices can
      * produce samples immediately instead of waiting for VBlank. */
-    if (target > SAMPLES_PER_FRAME && spu_samples_generated >= SAMPLES_PER_FRAME)
+    if (target > spu_frame_samples && spu_samples_generated >= spu_frame_samples)
     {
         SPU_FlushAudio(); /* sends current frame to audio backend + resets gen=0 */
-        spu_frame_start_cycle += (uint64_t)SAMPLES_PER_FRAME * CYCLES_PER_SAMPLE;
-        target = (int)((now - spu_frame_start_cycle) / CYCLES_PER_SAMPLE);
+        spu_frame_start_cycle += (uint64_t)spu_frame_samples * spu_cycles_per_sample;
+        target = (int)((now - spu_frame_start_cycle) / spu_cycles_per_sample);
     }
 
-    if (target > SAMPLES_PER_FRAME)
-        target = SAMPLES_PER_FRAME;
+    if (target > spu_frame_samples)
+        target = spu_frame_samples;
 
     int pending = target - spu_samples_generated;
     if (pending > 0) {
@@ -1120,10 +1561,72 @@ void SPU_CatchUp(void)
     }
 }
 
+/* ---- Save state: registers, voices, RAM and the part of the frame
+ * already mixed.  The ADPCM cache is rebuilt from the restored RAM. ---- */
+void SPU_State(StateIO *io)
+{
+    for (uint32_t a = 0; a < SPU_RAM_SIZE; a += 1024) /* reverb only dirties its area */
+        state_io(io, spu_ram + a, 1024);
+    STATE_VAR(io, voices);
+    STATE_VAR(io, main_vol_l);
+    STATE_VAR(io, main_vol_r);
+    STATE_VAR(io, key_on_lo);
+    STATE_VAR(io, key_on_hi);
+    STATE_VAR(io, endx);
+    STATE_VAR(io, spu_cnt);
+    STATE_VAR(io, spu_stat);
+    STATE_VAR(io, transfer_addr);
+    STATE_VAR(io, transfer_ptr);
+    STATE_VAR(io, data_fifo);
+    STATE_VAR(io, pending_kon);
+    STATE_VAR(io, spu_reg_store);
+    STATE_VAR(io, spu_irq_addr);
+    STATE_VAR(io, spu_irq_enabled);
+    STATE_VAR(io, spu_irq_fired);
+    STATE_VAR(io, rev_addr);
+    STATE_VAR(io, rev_phase);
+    STATE_VAR(io, rev_count);
+    STATE_VAR(io, rev_in_l);
+    STATE_VAR(io, rev_in_r);
+    STATE_VAR(io, rev_out_l);
+    STATE_VAR(io, rev_out_r);
+    STATE_VAR(io, mix_buf_l);
+    STATE_VAR(io, mix_buf_r);
+    STATE_VAR(io, rev_buf_l);
+    STATE_VAR(io, rev_buf_r);
+    STATE_VAR(io, spu_samples_generated);
+    STATE_VAR(io, spu_frame_start_cycle);
+    if (io->load)
+        adpcm_cache_invalidate(0, SPU_RAM_SIZE);
+}
+
+/* ---- Block event: mix in fixed SPU_EVENT_SAMPLES steps between the
+ * catch-ups that register accesses force ---- */
+static void SPU_EventCallback(int ticks_late);
+
+static void spu_schedule_event(void)
+{
+    if (prof_disable_spu || !spu_initialized)
+        return;
+    uint64_t next = spu_frame_start_cycle +
+                    (uint64_t)(spu_samples_generated + SPU_EVENT_SAMPLES) * spu_cycles_per_sample;
+    if (next <= global_cycles)
+        next = global_cycles + spu_cycles_per_sample;
+    Sched_Add(SCHED_EVENT_SPU, next, SPU_EventCallback);
+}
+
+static void SPU_EventCallback(int ticks_late)
+{
+    (void)ticks_late;
+    SPU_CatchUp();
+    spu_schedule_event();
+}
+
 /* ---- Frame start: reset cycle tracker for catch-up ---- */
 void SPU_FrameStart(void)
 {
     spu_frame_start_cycle = global_cycles;
+    spu_schedule_event();
 }
 
 /* ---- Generate remaining samples for frame and flush to audio hw ---- */
@@ -1138,7 +1641,7 @@ void SPU_GenerateSamples(void)
 
     /* Generate any remaining samples for this frame */
     flush_pending_kon();
-    int remaining = SAMPLES_PER_FRAME - spu_samples_generated;
+    int remaining = spu_frame_samples - spu_samples_generated;
     if (remaining > 0)
         SPU_GenerateChunk(remaining);
     SPU_FlushAudio();
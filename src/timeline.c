@@ -0,0 +1,131 @@
+/**
+ * timeline.c — Timeline ring buffer and Chrome-trace export
+ *
+ * The ring only holds raw 8-byte events; all formatting happens at dump
+ * time.  Timestamps are 32-bit ticks, unwrapped while walking the ring
+ * oldest first.  Profiler categories go on one track and scheduler
+ * callbacks on a second, so each track nests on its own.  End events
+ * whose begin fell off the back of the ring are dropped.
+ */
+#include "timeline.h"
+
+#ifdef ENABLE_TIMELINE_TRACE
+
+#include "profiler.h"
+#include "scheduler.h"
+#include "psx_sio.h"
+#include <stdio.h>
+
+#define TIMELINE_HOTKEY 0x0201 /* Select + R2 */
+
+#if defined(PLATFORM_PS2)
+#define TIMELINE_DUMP_PATH "host:timeline.json"
+#elif defined(PLATFORM_PSP)
+#define TIMELINE_DUMP_PATH "ms0:/timeline.json"
+#else
+#define TIMELINE_DUMP_PATH "timeline.json"
+#endif
+
+TimelineEvent timeline_buf[TIMELINE_EVENTS];
+uint32_t timeline_pos = 0;
+
+static uint32_t timeline_frame_num = 0;
+static int timeline_hotkey_prev = 0;
+static const char *timeline_dump_path = NULL;
+
+static const char *const sched_event_names[SCHED_EVENT_COUNT] = {
+    "Timer0", "Timer1", "Timer2", "SIO IRQ",
+    "CDROM", "CDROM deferred", "CDROM IRQ", "CDROM pending",
+    "HBlank", "DMA", "SPU", "MDEC"};
+
+void timeline_sched(int type, int id)
+{
+    timeline_record(type, id, prof_now());
+}
+
+void timeline_trigger_dump(const char *path)
+{
+    timeline_dump_path = path;
+    printf("[TIMELINE] dump requested → %s\n", path);
+}
+
+static void timeline_dump(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        printf("[TIMELINE] cannot open %s\n", path);
+        return;
+    }
+
+    uint32_t count = timeline_pos < TIMELINE_EVENTS ? timeline_pos : TIMELINE_EVENTS;
+    uint32_t first = timeline_pos - count;
+    uint64_t t = 0;
+    uint32_t prev_ts = count ? timeline_buf[first & (TIMELINE_EVENTS - 1)].ts : 0;
+    int depth[2] = {0, 0};
+    int written = 0;
+
+    fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    fprintf(f, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"Subsystems\"}},\n");
+    fprintf(f, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, \"args\": {\"name\": \"Scheduler\"}}");
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const TimelineEvent *e = &timeline_buf[(first + i) & (TIMELINE_EVENTS - 1)];
+        t += (uint32_t)(e->ts - prev_ts);
+        prev_ts = e->ts;
+        double us = (double)t * 1000000.0 / PROF_TICKS_PER_SEC;
+
+        switch (e->type)
+        {
+        case TL_BEGIN:
+        case TL_END:
+        case TL_SCHED_BEGIN:
+        case TL_SCHED_END:
+        {
+            int sched = e->type >= TL_SCHED_BEGIN;
+            int begin = e->type == TL_BEGIN || e->type == TL_SCHED_BEGIN;
+            if (sched ? e->id >= SCHED_EVENT_COUNT : e->id >= PROF_NUM)
+                continue;
+            if (!begin && depth[sched] == 0)
+                continue; /* began before the oldest event kept */
+            depth[sched] += begin ? 1 : -1;
+            fprintf(f, ",\n{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %d}",
+                    sched ? sched_event_names[e->id] : prof_category_names[e->id],
+                    begin ? 'B' : 'E', us, sched ? 2 : 1);
+            break;
+        }
+        case TL_VBLANK:
+            fprintf(f, ",\n{\"name\": \"VBlank\", \"ph\": \"i\", \"s\": \"g\", \"ts\": %.3f,"
+                       " \"pid\": 1, \"tid\": 1, \"args\": {\"frame\": %u}}",
+                    us, (unsigned)e->id);
+            break;
+        default:
+            continue;
+        }
+        written++;
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    printf("[TIMELINE] wrote %d events (%.1f ms) to %s\n", written,
+           (double)t * 1000.0 / PROF_TICKS_PER_SEC, path);
+}
+
+void timeline_frame(void)
+{
+    timeline_record(TL_VBLANK, (int)(timeline_frame_num++ & 0xFFFF), prof_now());
+
+    int hotkey = (sio_host_buttons & TIMELINE_HOTKEY) == TIMELINE_HOTKEY;
+    if (hotkey && !timeline_hotkey_prev)
+        timeline_trigger_dump(TIMELINE_DUMP_PATH);
+    timeline_hotkey_prev = hotkey;
+
+    /* Written at the frame boundary so the last frame is complete */
+    if (timeline_dump_path)
+    {
+        const char *path = timeline_dump_path;
+        timeline_dump_path = NULL;
+        timeline_dump(path);
+    }
+}
+
+#endif /* ENABLE_TIMELINE_TRACE */
@@ -6,6 +6,7 @@
 #include "gpu_state.h"
 
 #include "config.h"
+#include "savestate.h"
 
 #ifdef LOG_TAG
 #undef LOG_TAG
@@ -57,6 +58,54 @@ static uint32_t hblank_visible_cycles = 1630;
 /* Mode 3 one-shot flag: set when first HBlank/VBlank occurs after mode write. */
 static uint8_t timer_sync_mode3_freed[3] = {0, 0, 0};
 
+/* ---- Scanline / frame division ----
+ * Sync modes take the phase relative to hblank_frame_start_cycle on every
+ * synced read.  A 64-bit divide is a libgcc call on the EE; offsets that
+ * fit 32 bits (over two minutes of frames) multiply by a reciprocal
+ * precomputed per region instead. */
+typedef struct
+{
+    uint32_t d;
+    uint32_t recip; /* 0xFFFFFFFF / d */
+} TimerDiv;
+
+static TimerDiv div_scanline, div_frame;
+static int div_region = -1;
+
+static inline void timer_div_refresh(void)
+{
+    if (div_region == psx_config.region_pal)
+        return;
+    div_region = psx_config.region_pal;
+    uint32_t cps = psx_config.region_pal ? CYCLES_PER_HBLANK_PAL : CYCLES_PER_HBLANK_NTSC;
+    uint32_t lines = psx_config.region_pal ? SCANLINES_PER_FRAME_PAL : SCANLINES_PER_FRAME;
+    div_scanline.d = cps;
+    div_scanline.recip = 0xFFFFFFFFu / cps;
+    div_frame.d = cps * lines;
+    div_frame.recip = 0xFFFFFFFFu / div_frame.d;
+}
+
+/* off / dv->d, remainder in *rem.  The reciprocal estimate is at most two
+ * short of the quotient, the loop tops it up. */
+static inline uint64_t timer_divmod(uint64_t off, const TimerDiv *dv, uint32_t *rem)
+{
+    if (off >> 32)
+    {
+        *rem = (uint32_t)(off % dv->d);
+        return off / dv->d;
+    }
+    uint32_t x = (uint32_t)off;
+    uint32_t q = (uint32_t)(((uint64_t)x * dv->recip) >> 32);
+    uint32_t r = x - q * dv->d;
+    while (r >= dv->d)
+    {
+        q++;
+        r -= dv->d;
+    }
+    *rem = r;
+    return q;
+}
+
 /* Count "active" (visible, non-HBlank) CPU cycles in the range [from, to).
  * Returns the number of CPU cycles where the scanline phase < vis. */
 static uint32_t count_active_cycles_hblank(uint64_t from, uint64_t to)
@@ -68,7 +117,9 @@ static uint32_t count_active_cycles_hblank(uint64_t from, uint64_t to)
     if (elapsed == 0 || cps == 0)
         return 0;
 
-    uint32_t phase = (uint32_t)((from - hblank_frame_start_cycle) % cps);
+    uint32_t phase;
+    timer_div_refresh();
+    timer_divmod(from - hblank_frame_start_cycle, &div_scanline, &phase);
     uint32_t remaining = (uint32_t)elapsed;
     uint32_t active = 0;
 
@@ -88,9 +139,10 @@ static uint32_t count_active_cycles_hblank(uint64_t from, uint64_t to)
     remaining -= scanline_remaining;
 
     /* Full scanlines */
-    uint32_t full_scanlines = remaining / cps;
+    uint32_t rest;
+    uint32_t full_scanlines = (uint32_t)timer_divmod(remaining, &div_scanline, &rest);
     active += full_scanlines * vis;
-    remaining -= full_scanlines * cps;
+    remaining = rest;
 
     /* Final partial scanline (starts at phase 0 → visible) */
     active += (remaining < vis) ? remaining : vis;
@@ -187,7 +239,37 @@ static void timer_update_stopped_cache(int t)
     timer_stopped_cache[t] = 0;
 }
 
-static void Timer_SyncValue(int t)
+TimerFast timer_fast[3];
+
+/* Republish timer_fast[t] from the synced state (see psx_timers.h) */
+static void timer_fast_update(int t)
+{
+    uint32_t mode = timers[t].mode;
+    uint32_t divider = timer_divider_cache[t];
+    uint32_t val = timers[t].value;
+    uint32_t target = timers[t].target & 0xFFFF;
+    uint32_t limit;
+
+    timer_fast[t].window = 0;
+    if (timer_stopped_cache[t] || (mode & 1) || (divider != 1 && divider != 8) ||
+        (t == 0 && timer0_dotclock_num > 0) || val > 0xFFFF)
+        return;
+
+    /* First value at which a sync would do more than add ticks */
+    if (target > 0 && val < target)
+        limit = target;
+    else if ((mode & (1 << 3)) && target > 0)
+        return; /* at target or in the dead-0 phase */
+    else
+        limit = 0x10000;
+
+    timer_fast[t].base = (uint32_t)timers[t].last_sync_cycle;
+    timer_fast[t].value = val;
+    timer_fast[t].shift = (divider == 8) ? 3 : 0;
+    timer_fast[t].window = (limit - val) * divider;
+}
+
+static void timer_sync(int t)
 {
     if (t < 0 || t > 2)
         return;
@@ -202,6 +284,7 @@ static void Timer_SyncValue(int t)
     uint32_t divider = timer_divider_cache[t];
     uint64_t elapsed = now - timers[t].last_sync_cycle;
     uint32_t mode = timers[t].mode;
+    timer_div_refresh();
 
     /* ---- Sync mode pre-processing for Timer 0 (HBlank) ---- */
     if ((mode & 1) && t == 0)
@@ -212,10 +295,9 @@ static void Timer_SyncValue(int t)
         uint32_t vis = hblank_visible_cycles;
         uint64_t frame_offs_from = timers[t].last_sync_cycle - hblank_frame_start_cycle;
         uint64_t frame_offs_to = now - hblank_frame_start_cycle;
-        uint32_t phase_from = (uint32_t)(frame_offs_from % cps);
-        uint32_t phase_to = (uint32_t)(frame_offs_to % cps);
-        uint32_t scan_from = (uint32_t)(frame_offs_from / cps);
-        uint32_t scan_to = (uint32_t)(frame_offs_to / cps);
+        uint32_t phase_from, phase_to;
+        uint32_t scan_from = (uint32_t)timer_divmod(frame_offs_from, &div_scanline, &phase_from);
+        uint32_t scan_to = (uint32_t)timer_divmod(frame_offs_to, &div_scanline, &phase_to);
         int hblank_crossed = (scan_to > scan_from) ||
                              (scan_to == scan_from && phase_from < vis && phase_to >= vis);
 
@@ -307,7 +389,8 @@ static void Timer_SyncValue(int t)
                                                    : SCANLINES_PER_FRAME;
         uint32_t cpf = scanlines * cps;
         uint64_t frame_offset = now - hblank_frame_start_cycle;
-        uint32_t frame_phase = (uint32_t)(frame_offset % cpf);
+        uint32_t frame_phase;
+        uint64_t frames_elapsed = timer_divmod(frame_offset, &div_frame, &frame_phase);
         uint32_t vblank_start_cycle = vblank_sl * cps;
         int in_vblank = (frame_phase >= vblank_start_cycle);
 
@@ -324,7 +407,8 @@ static void Timer_SyncValue(int t)
         case 1: /* Reset at VBlanks — check if VBlank boundary crossed */
         {
             uint64_t from_frame = (timers[t].last_sync_cycle - hblank_frame_start_cycle);
-            uint32_t from_phase = (uint32_t)(from_frame % cpf);
+            uint32_t from_phase;
+            timer_divmod(from_frame, &div_frame, &from_phase);
             int vblank_crossed = 0;
             if (elapsed >= cpf)
                 vblank_crossed = 1;
@@ -337,7 +421,6 @@ static void Timer_SyncValue(int t)
             {
                 timers[t].value = 0;
                 /* Count from most recent VBlank start */
-                uint64_t frames_elapsed = frame_offset / cpf;
                 uint64_t vb_start = hblank_frame_start_cycle +
                                     frames_elapsed * cpf + vblank_start_cycle;
                 if (vb_start > now)
@@ -466,6 +549,14 @@ static void Timer_SyncValue(int t)
     }
 }
 
+static void Timer_SyncValue(int t)
+{
+    if (t < 0 || t > 2)
+        return;
+    timer_sync(t);
+    timer_fast_update(t);
+}
+
 static void Timer_ScheduleOne(int t)
 {
     if (t < 0 || t > 2)
@@ -594,9 +685,29 @@ void Timers_Write(uint32_t addr, uint32_t data)
     Timer_ScheduleOne(t);
 }
 
-void Timer_RefreshDividerCache(void) { timer_update_divider_cache(0); }
+void Timer_RefreshDividerCache(void)
+{
+    timer_update_divider_cache(0);
+    timer_fast_update(0);
+}
 void Timer_ScheduleAll(void)
 {
     for (int t = 0; t < 3; t++)
         Timer_ScheduleOne(t);
 }
+
+/* Save state: the counters plus every cache derived from them; their
+ * scheduler events come back with Sched_State */
+void Timers_State(StateIO *io)
+{
+    STATE_VAR(io, timers);
+    STATE_VAR(io, timer_stopped_cache);
+    STATE_VAR(io, timer_divider_cache);
+    STATE_VAR(io, timer_irq_fired);
+    STATE_VAR(io, timer_mode_set_cycle);
+    STATE_VAR(io, timer0_dotclock_num);
+    STATE_VAR(io, timer0_dotclock_residue);
+    STATE_VAR(io, hblank_visible_cycles);
+    STATE_VAR(io, timer_sync_mode3_freed);
+    STATE_VAR(io, timer_fast);
+}
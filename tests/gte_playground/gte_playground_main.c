@@ -11,6 +11,10 @@
  *   4. Full GTE commands: RTPS, RTPT, NCS, NCT, NCDS
  *   5. Edge cases: large values, zero matrix, identity
  *   6. Random fuzz (seed-based reproducible)
+ *   7. UNR divide: reciprocal table and test-all RTPS/RTPT bit-exact
+ *   8. Stream replay: times C vs VFPU over a gte_record command stream
+ *      (REPLAY_STREAM, skipped when absent).  The JIT backends are timed
+ *      on the same stream by the JIT playground (gte_replay=<file>).
  *
  * Each test: set GTE registers → run C path (copy1) → run VFPU path
  * (copy2) → compare MAC1/2/3, IR1/2/3 with tolerance.
@@ -29,6 +33,7 @@ PSP_MAIN_THREAD_ATTR(THREAD_ATTR_USER | THREAD_ATTR_VFPU);
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 
 /* ---- Access to GTE internals ---- */
 extern void GTE_Execute(uint32_t opcode, R3000CPU *cpu);
@@ -654,6 +659,122 @@ static void test_all_comparison(void)
     printf(", max_delta=%d\n", ta_max_delta);
 }
 
+/* ================================================================
+ * UNR divide: gte_unr_recip[] vs the Newton steps, and every
+ * RTPS/RTPT case of test-all through the table-driven C divide
+ * ================================================================ */
+static void test_unr_divide(void)
+{
+    printf("=== UNR divide (reciprocal table + test-all RTPS/RTPT) ===\n");
+
+    int bad = 0;
+    for (int i = 0; i < GTE_UNR_RECIP_SIZE; i++) {
+        uint32_t d = 0x8000 + ((uint32_t)i << 4);
+        uint32_t u = gte_unr_table[(d - 0x7FC0) >> 7] + 0x101;
+        uint32_t du = (0x2000080u - d * u) >> 8;
+        du = (0x80u + du * u) >> 8;
+        if (gte_unr_recip[i] != du) {
+            if (bad < 4)
+                printf("  FAIL recip[%d]=0x%05lx expected 0x%05lx\n", i,
+                       (unsigned long)gte_unr_recip[i], (unsigned long)du);
+            bad++;
+        }
+    }
+
+    int cases = 0, exact = 0;
+    gte_use_vfpu = 0;
+    for (int t = 0; t < TEST_COUNT; t++) {
+        const struct test_t *tc = &tests[t];
+        uint32_t func = tc->opcode & 0x3F;
+        if (tc->opcode == 0xffffffff || (func != 0x01 && func != 0x30))
+            continue;
+        memset(&cpu_c, 0, sizeof(cpu_c));
+        load_all_regs(&cpu_c, tc->input);
+        GTE_Execute(tc->opcode, &cpu_c);
+        uint32_t out[64];
+        read_all_regs(&cpu_c, out);
+        cases++;
+        if (!memcmp(out, tc->output, sizeof(out)))
+            exact++;
+        else if (cases - exact <= 4)
+            printf("  FAIL %s (op=0x%08lx)\n", tc->name, (unsigned long)tc->opcode);
+    }
+
+    int ok = (bad == 0) + (exact == cases);
+    total_tests += 2;
+    total_pass += ok;
+    total_fail += 2 - ok;
+    printf("  recip table: %d/%d exact, RTPS/RTPT: %d/%d exact\n",
+           GTE_UNR_RECIP_SIZE - bad, GTE_UNR_RECIP_SIZE, exact, cases);
+}
+
+/* ================================================================
+ * Stream replay: every recorded command through C and through VFPU.
+ * Control registers are reloaded only when they change between
+ * records.  Report only (not counted in the results).
+ * ================================================================ */
+#define REPLAY_STREAM "gte_stream.bin"
+
+static void replay_load(R3000CPU *cpu, const GTEStreamRecord *recs, int i)
+{
+    memcpy(cpu->cp2_data, recs[i].data, sizeof(recs[i].data));
+    cpu->cp2_ctrl[31] = recs[i].ctrl[31];
+    if (i == 0 || memcmp(recs[i - 1].ctrl, recs[i].ctrl, 31 * sizeof(uint32_t))) {
+        memcpy(cpu->cp2_ctrl, recs[i].ctrl, 31 * sizeof(uint32_t));
+        gte_matrix_dirty.all = GTE_MTX_DIRTY_ALL;
+    }
+}
+
+static double replay_pass(GTEStreamRecord *recs, int count, int vfpu)
+{
+    gte_use_vfpu = vfpu;
+    memset(&cpu_c, 0, sizeof(cpu_c));
+    clock_t t0 = clock();
+    for (int i = 0; i < count; i++) {
+        replay_load(&cpu_c, recs, i);
+        GTE_Execute(recs[i].opcode, &cpu_c);
+    }
+    double secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    return secs > 0.0 ? (double)count / secs : 0.0;
+}
+
+static void test_stream_replay(void)
+{
+    int count;
+    GTEStreamRecord *recs = GTE_StreamLoad(REPLAY_STREAM, &count);
+    if (!recs || !count) {
+        free(recs);
+        return;
+    }
+    printf("=== Stream replay: %s, %d commands ===\n", REPLAY_STREAM, count);
+
+    double c_ops = replay_pass(recs, count, 0);
+    double v_ops = replay_pass(recs, count, 1);
+
+    /* Data registers that differ between the two paths (FLAG aside) */
+    int differ = 0;
+    memset(&cpu_c, 0, sizeof(cpu_c));
+    memset(&cpu_v, 0, sizeof(cpu_v));
+    for (int i = 0; i < count; i++) {
+        replay_load(&cpu_c, recs, i);
+        replay_load(&cpu_v, recs, i);
+        gte_use_vfpu = 0;
+        GTE_Execute(recs[i].opcode, &cpu_c);
+        gte_use_vfpu = 1;
+        GTE_Execute(recs[i].opcode, &cpu_v);
+        if (memcmp(cpu_c.cp2_data, cpu_v.cp2_data, sizeof(cpu_c.cp2_data)))
+            differ++;
+    }
+    gte_use_vfpu = 0;
+
+    printf("  C    %10.0f ops/sec\n", c_ops);
+    printf("  VFPU %10.0f ops/sec", v_ops);
+    if (c_ops > 0.0)
+        printf("  (%.2fx C)", v_ops / c_ops);
+    printf(", %d/%d commands differ\n", differ, count);
+    free(recs);
+}
+
 /* ================================================================
  * Main entry point
  * ================================================================ */
@@ -686,7 +807,9 @@ int main(void)
     test_fuzz_mvmva();
     test_fuzz_mvmva_extreme();
     test_fuzz_full_cmds();
+    test_unr_divide();
     test_all_comparison();
+    test_stream_replay();
 
     printf("\n========================================\n");
     printf("Results: %d/%d passed", total_pass, total_tests);
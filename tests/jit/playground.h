@@ -13,12 +13,9 @@
 #include <string.h>
 #include <stdint.h>
 
-#ifdef _EE
-extern uint8_t vu0_matrix_dirty;
-#define PG_MARK_VU0_DIRTY() do { vu0_matrix_dirty = 0x0F; } while(0)
-#else
-#define PG_MARK_VU0_DIRTY() ((void)0)
-#endif
+/* Tests poke cp2_ctrl directly, bypassing CTC2: drop every decoded
+ * matrix cache (C and VU0/VFPU) before each case. */
+#define PG_MARK_VU0_DIRTY() do { gte_matrix_dirty.all = GTE_MTX_DIRTY_ALL; } while(0)
 
 /* ---- pull in MK_R / MK_I / MK_J from the dynarec header ---- */
 #include "dynarec.h"
@@ -276,6 +273,15 @@ extern int pg_dump_next_block;
 /* Full cache flush + page table reset (between tests) */
 void pg_reset_jit_cache(void);
 
+/* ReadHardware/WriteHardware stub log (playground_main.c) */
+void pg_reset_hw_log(void);
+void pg_set_hw_read_value(uint32_t val);
+int pg_get_hw_read_count(void);
+int pg_get_hw_write_count(void);
+uint32_t pg_get_hw_read_addr(int idx);
+uint32_t pg_get_hw_write_addr(int idx);
+uint32_t pg_get_hw_write_data(int idx);
+
 /* ---- Test context ---- */
 
 /* Base PSX address where test code is placed.
@@ -484,6 +490,14 @@ void pg_run_gte_tests(void);      /* test_gte.c    */
 void pg_run_expansion_tests(void); /* test_expansion.c */
 void pg_run_vu0_micro_tests(void); /* test_vu0_micro.c */
 void pg_run_gte_compare_tests(void); /* test_gte_compare.c */
+void pg_run_gte_bench(void);      /* test_gte_bench.c */
+extern int pg_gte_bench;          /* gte_bench=1 in superpsx.ini */
+void pg_run_gte_replay(void);     /* test_gte_replay.c */
+extern char pg_gte_replay[256];   /* gte_replay=<gte_record file> in superpsx.ini */
+void pg_run_sched_bench(void);    /* test_sched_bench.c */
+extern int pg_sched_bench;        /* sched_bench=1 in superpsx.ini */
+void pg_run_jit_bench(void);      /* test_jit_bench.c */
+extern int pg_jit_bench;          /* jit_bench=1 in superpsx.ini */
 void pg_run_sio_tests(void);      /* test_sio.c    */
 
 /* Master runner — calls all category runners above */
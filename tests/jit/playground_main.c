@@ -90,6 +90,12 @@ void WriteHardware(uint32_t addr,
         hw_write_log[hw_write_count++] = data;
     }
 }
+/* Dispatch table: every register routes to the logging stubs above */
+static uint32_t pg_hw_read(uint32_t addr) { return ReadHardware(addr); }
+static void pg_hw_write(uint32_t addr, uint32_t data, int width) { WriteHardware(addr, data, width); }
+void Init_HardwareTable(void) {}
+HwReadFn hw_read_handler(uint32_t phys) { return (phys - 0x1F801000 < 0x1000) ? pg_hw_read : NULL; }
+HwWriteFn hw_write_handler(uint32_t phys) { return (phys - 0x1F801000 < 0x1000) ? pg_hw_write : NULL; }
 void SignalInterrupt(uint32_t irq) { (void)irq; }
 
 /* --- GPU --- */
@@ -108,6 +114,9 @@ void GPU_DMA_Write(uint32_t a, int n)
 void GPU_Write_GP0(uint32_t v) { (void)v; }
 void GPU_Write_GP1(uint32_t v) { (void)v; }
 uint32_t GPU_Read_GPUREAD(void) { return 0; }
+/* gpu_gp0_fifo_t (gpu_state.h): count, then GPU_GP0_FIFO_WORDS words */
+struct { uint32_t count; uint32_t words[64]; } gpu_gp0_fifo;
+void GPU_GP0FifoDrain(void) { gpu_gp0_fifo.count = 0; }
 void DumpVRAM(void) {}
 
 /* --- SPU --- */
@@ -173,6 +182,11 @@ int Load_PSX_EXE_FromISO(const char *p, uint32_t *pc)
     (void)pc;
     return -1;
 }
+int Loader_HashBootEXE(uint32_t *hash_out)
+{
+    (void)hash_out;
+    return -1;
+}
 
 /* --- DMA --- */
 void DMA_WriteReg(uint32_t a, uint32_t v)
@@ -224,7 +238,7 @@ extern int patch_sites_count;
 extern uint32_t blocks_compiled;
 extern uint32_t total_instructions;
 extern int tlb_bp_map_count;
-extern JitHTEntry jit_ht[];
+extern JitHTEntry *jit_ht;
 extern jit_l2_t jit_l1_ram[];
 extern jit_l2_t jit_l1_bios[];
 extern uint8_t jit_page_gen[];
@@ -243,31 +257,9 @@ extern uint64_t global_cycles;
 
 void pg_reset_jit_cache(void)
 {
-    /* Reset code pointer past trampolines */
-    code_ptr = code_buffer + 144;
-
-    /* Clear page tables */
-    Free_PageTable();
-    memset(jit_l1_ram, 0, sizeof(jit_l1_ram[0]) * 512);
-    memset(jit_l1_bios, 0, sizeof(jit_l1_bios[0]) * 128);
-
-    /* Clear block pool */
-    block_node_pool_idx = 0;
-    patch_sites_count = 0;
-    blocks_compiled = 0;
-    tlb_bp_map_count = 0;
-
-    /* Clear hash table */
-    for (int i = 0; i < JIT_HT_SIZE; i++)
-    {
-        jit_ht[i].psx_pc[0] = 0xFFFFFFFF;
-        jit_ht[i].psx_pc[1] = 0xFFFFFFFF;
-        jit_ht[i].native[0] = NULL;
-        jit_ht[i].native[1] = NULL;
-    }
-    micro_cache_flush();
-
-    jit_flush_pending = 1; /* Deferred: will flush before next block execution */
+    /* Drop all blocks, rewind code buffer to segment 0.
+     * Deferred: will flush caches before next block execution. */
+    dynarec_flush_cache();
 }
 
 int pg_dump_next_block = 0; /* set to 1 to dump next compiled block */
@@ -358,7 +350,7 @@ int main(int argc, char *argv[])
     printf("   JIT Playground — SuperPSX\n");
     printf("========================================\n\n");
 
-    /* 1. Initialise memory (allocates psx_ram, psx_bios, mem_lut) */
+    /* 1. Initialise memory (allocates psx_ram, psx_bios; memory map) */
     Init_Memory();
     Init_MemoryLUT();
 
@@ -369,6 +361,14 @@ int main(int argc, char *argv[])
         while (fgets(line, sizeof(line), f)) {
             if (strncmp(line, "interpreter=", 12) == 0) {
                 psx_config.interpreter = atoi(line + 12);
+            } else if (strncmp(line, "gte_bench=", 10) == 0) {
+                pg_gte_bench = atoi(line + 10);
+            } else if (strncmp(line, "sched_bench=", 12) == 0) {
+                pg_sched_bench = atoi(line + 12);
+            } else if (strncmp(line, "jit_bench=", 10) == 0) {
+                pg_jit_bench = atoi(line + 10);
+            } else if (strncmp(line, "gte_replay=", 11) == 0) {
+                sscanf(line + 11, "%255s", pg_gte_replay);
             }
         }
         fclose(f);
@@ -378,6 +378,7 @@ int main(int argc, char *argv[])
     Init_CPU();
 
     /* 2b. Enable GTE fast paths (gte_use_vu0) for inline GTE tests */
+    psx_config.gte_accuracy = -1; /* tier follows gte_vu0 */
 #ifdef PLATFORM_PS2
     psx_config.gte_vu0 = 1;
     gte_use_vu0 = 1;
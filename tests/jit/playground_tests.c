@@ -25,9 +25,20 @@ void pg_run_all_tests(void)
     /* pg_run_sio_tests(); — test_sio.c not yet implemented */
 #ifdef PLATFORM_PS2
     pg_run_vu0_micro_tests();
+#endif
+#if defined(PLATFORM_PS2) || defined(PLATFORM_PSP)
     pg_run_gte_compare_tests();
 #endif
 
     /* Expansion ratio report (compile-only, no pass/fail) */
     pg_run_expansion_tests();
+
+    /* GTE tier benchmark (report only, gte_bench=1) */
+    pg_run_gte_bench();
+    /* GTE command-stream replay (report only, gte_replay=<file>) */
+    pg_run_gte_replay();
+    /* Scheduler heap vs linear scan (report only, sched_bench=1) */
+    pg_run_sched_bench();
+    /* Dynarec kernels: compile time, expansion, run cycles (report only, jit_bench=1) */
+    pg_run_jit_bench();
 }
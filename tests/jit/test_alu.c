@@ -2,7 +2,7 @@
  * JIT Playground — ALU Tests
  *
  * Covers: ALU basic, shifts, multiply/divide, comparisons, HI/LO.
- * 21 tests total.
+ * 23 tests total.
  */
 #include "playground.h"
 
@@ -232,6 +232,47 @@ static void test_divu_basic(void)
     END_TEST();
 }
 
+/* DIV + ALU run: result parked on pipe 1 and written at MFLO; the run
+ * overwrites the operands, so the fixups must use the stashed copies */
+static void test_div_deferred(void)
+{
+    BEGIN_TEST("div_deferred");
+    SET_REG(R_V0, (uint32_t)(-100));
+    SET_REG(R_V1, 7);
+    EMIT(PSX_DIV(R_V0, R_V1));
+    EMIT(PSX_ADDU(R_V0, R_V1, R_V1));
+    EMIT(PSX_ADDIU(R_V1, R_ZERO, 0));
+    EMIT(PSX_MFLO(R_A0));
+    EMIT(PSX_MFHI(R_A1));
+    RUN(5000);
+    EXPECT_REG(R_A0, (uint32_t)(-14));
+    EXPECT_REG(R_A1, (uint32_t)(-2));
+    EXPECT_REG(R_V0, 14);
+    END_TEST();
+}
+
+static void test_div_deferred_by_zero(void)
+{
+    BEGIN_TEST("div_deferred_by_zero");
+    SET_REG(R_V0, (uint32_t)(-5));
+    SET_REG(R_V1, 0);
+    EMIT(PSX_DIV(R_V0, R_V1));
+    EMIT(PSX_ADDIU(R_V0, R_ZERO, 1));
+    EMIT(PSX_ADDIU(R_V1, R_ZERO, 1));
+    EMIT(PSX_MFLO(R_A0));
+    EMIT(PSX_MFHI(R_A1));
+    EMIT(PSX_DIVU(R_V0, R_ZERO));
+    EMIT(PSX_ADDU(R_A2, R_V0, R_V1));
+    EMIT(PSX_ADDU(R_A3, R_A2, R_V1));
+    RUN(5000);
+    EXPECT_REG(R_A0, 1);
+    EXPECT_REG(R_A1, (uint32_t)(-5));
+    EXPECT_REG(R_A3, 3);
+    EXPECT_HI(1);
+    EXPECT_LO(0xFFFFFFFF);
+    END_TEST();
+}
+
 static void test_mult_signed_negative(void)
 {
     BEGIN_TEST("mult_signed_neg");
@@ -339,6 +380,8 @@ void pg_run_alu_tests(void)
     test_multu_basic();
     test_div_basic();
     test_divu_basic();
+    test_div_deferred();
+    test_div_deferred_by_zero();
     test_mult_signed_negative();
 
     printf("\n--- Comparisons ---\n");
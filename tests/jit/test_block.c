@@ -3,11 +3,13 @@
  *
  * Covers: store-load forwarding, loops, JAL/JR chains,
  *         cross-block register persistence (pinned + non-pinned),
- *         multi-block chains, super-blocks, nested calls, conditional paths,
+ *         multi-block chains, code segment eviction, tier-up, traces,
+ *         super-blocks, nested calls, conditional paths,
  *         all-32-regs comprehensive test, dynamic allocator stress.
- * 21 tests total.
+ * 35 tests total.
  */
 #include "playground.h"
+#include "config.h"
 
 /* ================================================================
  *  Instruction Interactions
@@ -234,6 +236,312 @@ static void test_multi_block_chain(void)
     END_TEST();
 }
 
+static void test_segment_eviction_unlinks(void)
+{
+    /* Block B is compiled into code segment 0, block A into segment 1
+     * with a direct link to B.  Evicting segment 0 must revert A's link
+     * so a re-run of A recompiles B instead of jumping into stale code. */
+    BEGIN_TEST("segment_eviction_unlinks");
+    uint32_t block_b = PG_CODE_BASE + 8 * 4;
+
+    /* Block A */
+    EMIT(PSX_ADDIU(R_A0, R_V0, 1));       /* a0 = v0 + 1 */
+    EMIT(PSX_J((block_b >> 2) & 0x03FFFFFF));
+    EMIT(PSX_NOP());
+    for (int i = 3; i < 8; i++) EMIT(PSX_NOP());
+
+    /* Block B */
+    EMIT(PSX_ADDIU(R_A1, R_A0, 2));       /* a1 = a0 + 2 */
+    EMIT(PSX_JR(R_RA));
+    EMIT(PSX_NOP());
+
+    pg_run_jit(block_b, 2000);            /* B → segment 0 */
+    dynarec_evict_next_segment();          /* continue in segment 1 */
+    SET_REG(R_V0, 10);
+    RUN(10000);                            /* A → segment 1, linked to B */
+    EXPECT_REG(R_A1, 13);
+
+    for (int i = 1; i < CODE_SEGMENT_COUNT; i++)
+        dynarec_evict_next_segment();      /* wraps around: evicts segment 0 */
+
+    SET_REG(R_V0, 20);
+    cpu.regs[R_RA] = PG_HALT_BASE;
+    RUN(10000);
+    EXPECT_REG(R_A0, 21);
+    EXPECT_REG(R_A1, 23);
+    END_TEST();
+}
+
+static void test_tier_up_recompile(void)
+{
+    /* With a tier threshold set, the first compile is quick (tier 0).
+     * Once dispatched that many times, the block is recompiled with the
+     * full optimizer and must still produce identical results. */
+    BEGIN_TEST("tier_up_recompile");
+    psx_config.jit_tier_threshold = 2;
+    EMIT(PSX_ADDIU(R_A0, R_A0, 1));
+    EMIT(PSX_ADDIU(R_A1, R_A0, 2));
+    RUN(2000);
+    BlockEntry *be = lookup_block(PG_CODE_BASE);
+    if (!be || be->tier != 0)
+    {
+        printf("  [FAIL] %s: first compile not at tier 0\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        cpu.regs[R_RA] = PG_HALT_BASE;
+        pg_run_jit(PG_CODE_BASE, 2000);
+    }
+    be = lookup_block(PG_CODE_BASE);
+    if (!be || be->tier != 1)
+    {
+        printf("  [FAIL] %s: block not re-optimized\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    psx_config.jit_tier_threshold = 0;
+    EXPECT_REG(R_A0, 3);
+    EXPECT_REG(R_A1, 5);
+    END_TEST();
+}
+
+static void test_tier_up_load_kill(void)
+{
+    /* Tier-up DCE counts loads as kills: the ADDIU to t0 is dead once
+     * the LW overwrites it, while the ADDIU to t1 stays because the
+     * next instruction reads t1 in the load delay slot. */
+    BEGIN_TEST("tier_up_load_kill");
+    psx_config.jit_tier_threshold = 2;
+    SET_MEM32(PG_DATA_OFFSET, 0x1234);
+    SET_MEM32(PG_DATA_OFFSET + 4, 0x5678);
+    EMIT(PSX_LUI(R_A0, PG_DATA_BASE >> 16));
+    EMIT(PSX_ADDIU(R_T0, R_ZERO, 5));
+    EMIT(PSX_LW(R_T0, 0, R_A0));
+    EMIT(PSX_NOP());
+    EMIT(PSX_ADDU(R_V0, R_T0, R_ZERO));
+    EMIT(PSX_ADDIU(R_T1, R_ZERO, 7));
+    EMIT(PSX_LW(R_T1, 4, R_A0));
+    EMIT(PSX_ADDU(R_V1, R_T1, R_ZERO));
+    EMIT(PSX_ADDU(R_A1, R_T1, R_ZERO));
+    RUN(2000);
+    for (int i = 0; i < 2; i++)
+    {
+        cpu.regs[R_RA] = PG_HALT_BASE;
+        pg_run_jit(PG_CODE_BASE, 2000);
+    }
+    BlockEntry *be = lookup_block(PG_CODE_BASE);
+    if (!be || be->tier != 1)
+    {
+        printf("  [FAIL] %s: block not re-optimized\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    psx_config.jit_tier_threshold = 0;
+    EXPECT_REG(R_V0, 0x1234);
+    EXPECT_REG(R_V1, 7);      /* delay slot: old t1 */
+    EXPECT_REG(R_A1, 0x5678);
+    END_TEST();
+}
+
+static void test_ht_set_replacement(void)
+{
+    /* Filling a dispatch set past its ways evicts the oldest PC; removing
+     * a PC keeps the remaining ways probe-able in MRU order. */
+    BEGIN_TEST("ht_set_replacement");
+    uint32_t pcs[5];
+    int n = 0;
+    JitHTEntry *set = jit_ht_set(PG_CODE_BASE);
+    for (uint32_t pc = PG_CODE_BASE; n <= jit_ht_ways && pc < PG_CODE_BASE + 0x100000; pc += 4)
+        if (jit_ht_set(pc) == set)
+            pcs[n++] = pc;
+    for (int i = 0; i < n; i++)
+        jit_ht_add(pcs[i], code_buffer + 4096 + i * 16);
+    if (n != jit_ht_ways + 1 || set[0].psx_pc != pcs[n - 1] ||
+        set[jit_ht_ways - 1].psx_pc != pcs[1])
+    {
+        printf("  [FAIL] %s: oldest way not evicted\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    jit_ht_remove(pcs[n - 1]);
+    if (set[0].psx_pc != pcs[n - 2] || set[jit_ht_ways - 1].psx_pc != 0xFFFFFFFF)
+    {
+        printf("  [FAIL] %s: remove did not compact the set\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    jit_ht_flush();
+    END_TEST();
+}
+
+static void test_block_node_recycle(void)
+{
+    /* Freeing an invalidated block unmaps its PC and hands the node to
+     * the next compile instead of carving a new one from the pool. */
+    BEGIN_TEST("block_node_recycle");
+    EMIT(PSX_ADDIU(R_A0, R_A0, 1));
+    RUN(2000);
+    BlockEntry *be = lookup_block(PG_CODE_BASE);
+    int high = block_node_pool_idx;
+    int live = block_nodes_live;
+    if (!be)
+    {
+        printf("  [FAIL] %s: block not cached\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    else
+    {
+        jit_ht_remove(PG_CODE_BASE);
+        block_node_free(be);
+        if (lookup_block(PG_CODE_BASE) || block_node_free_list != be ||
+            block_nodes_live != live - 1)
+        {
+            printf("  [FAIL] %s: node not returned to free list\n", pg_ctx.name);
+            pg_ctx.fail_count++;
+        }
+        if (cache_block(PG_CODE_BASE + 0x40, code_buffer + 4096) != be ||
+            block_node_pool_idx != high || block_node_free_list == be)
+        {
+            printf("  [FAIL] %s: freed node not reused\n", pg_ctx.name);
+            pg_ctx.fail_count++;
+        }
+    }
+    EXPECT_REG(R_A0, 1);
+    END_TEST();
+}
+
+static void test_spec_compile_queue(void)
+{
+    /* The not-taken side of a branch is queued when its block compiles
+     * and built by the idle-time drain without being executed. */
+    BEGIN_TEST("spec_compile_queue");
+    psx_config.jit_spec_compile = 4;
+    uint32_t target = PG_CODE_BASE + 5 * 4;
+    SET_REG(R_V0, 7);
+    SET_REG(R_V1, 8);
+    EMIT(PSX_BEQ(R_V0, R_V1, 4));         /* 0: BEQ not taken */
+    EMIT(PSX_NOP());                       /* 1: delay */
+    EMIT(PSX_ADDIU(R_A0, R_ZERO, 1));     /* 2: fall-through value */
+    EMIT(PSX_JR(R_RA));                    /* 3: exit fall-through */
+    EMIT(PSX_NOP());                       /* 4: delay */
+    EMIT(PSX_ADDIU(R_A0, R_ZERO, 2));     /* 5: taken target (not reached) */
+    RUN(5000);
+    EXPECT_REG(R_A0, 1);
+    int queued = 0;
+    for (uint32_t i = jit_spec_head; i != jit_spec_tail; i++)
+        if (jit_spec_queue[i & (JIT_SPEC_QUEUE_SIZE - 1)] == target)
+            queued = 1;
+    if (!queued || lookup_block_native(target))
+    {
+        printf("  [FAIL] %s: untaken target not queued\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    jit_spec_compile_pending(JIT_SPEC_QUEUE_SIZE);
+    if (!lookup_block_native(target) || jit_spec_head != jit_spec_tail)
+    {
+        printf("  [FAIL] %s: queued target not compiled\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    psx_config.jit_spec_compile = 4;
+    END_TEST();
+}
+
+static void test_ras_call_return(void)
+{
+    /* JAL pushes the return PC on the return-address stack; the callee's
+     * JR $ra pops it and returns through the caller's stub.  A second
+     * run takes the stub once the return block has been linked. */
+    BEGIN_TEST("ras_call_return");
+    EMIT(PSX_JAL((PG_CODE_BASE + 8 * 4) >> 2));    /* 0: call func */
+    EMIT(PSX_NOP());                               /* 1 */
+    EMIT(PSX_ADDIU(R_A1, R_A0, 1));                /* 2: return PC */
+    EMIT(PSX_LUI(R_RA, PG_HALT_BASE >> 16));       /* 3 */
+    EMIT(PSX_JR(R_RA));                            /* 4 */
+    EMIT(PSX_NOP());                               /* 5 */
+    EMIT(PSX_NOP());                               /* 6 */
+    EMIT(PSX_NOP());                               /* 7 */
+    EMIT(PSX_ADDIU(R_A0, R_A0, 5));                /* 8: func */
+    EMIT(PSX_JR(R_RA));                            /* 9 */
+    EMIT(PSX_NOP());                               /* 10 */
+    RUN(5000);
+    EXPECT_REG(R_A0, 5);
+    EXPECT_REG(R_A1, 6);
+    EXPECT_REG(R_RA, PG_HALT_BASE);
+
+    cpu.regs[R_A0] = 10;
+    cpu.regs[R_A1] = 0;
+    pg_run_jit(PG_CODE_BASE, 5000);
+    EXPECT_REG(R_A0, 15);
+    EXPECT_REG(R_A1, 16);
+    END_TEST();
+}
+
+static void test_disk_cache_verify(void)
+{
+    /* A block restored from the disk cache is checked against RAM on
+     * first dispatch: unchanged code is reused as-is, changed code is
+     * dropped and recompiled. */
+    BEGIN_TEST("disk_cache_verify");
+    EMIT(PSX_ADDIU(R_A0, R_A0, 1));
+    RUN(2000);
+    BlockEntry *be = lookup_block(PG_CODE_BASE);
+    uint32_t *native = be ? be->native : NULL;
+
+    be->disk_pending = 1;
+    micro_cache_flush();
+    cpu.regs[R_RA] = PG_HALT_BASE;
+    pg_run_jit(PG_CODE_BASE, 2000);
+    if (be->disk_pending || be->native != native)
+    {
+        printf("  [FAIL] %s: unchanged block not reused\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    EXPECT_REG(R_A0, 2);
+
+    pg_ctx.code[0] = PSX_ADDIU(R_A0, R_A0, 5); /* no SMC store: page_gen unchanged */
+    be->disk_pending = 1;
+    micro_cache_flush();
+    cpu.regs[R_RA] = PG_HALT_BASE;
+    pg_run_jit(PG_CODE_BASE, 2000);
+    EXPECT_REG(R_A0, 7);
+    END_TEST();
+}
+
+static void test_trace_taken_side_exit(void)
+{
+    /* A forward BNE that is always taken while profiled at tier 0 gets
+     * compiled as a trace at tier 1.  Taking the fall-through side exit
+     * afterwards must still execute the skipped instruction. */
+    BEGIN_TEST("trace_taken_side_exit");
+    psx_config.jit_tier_threshold = 20;
+    EMIT(PSX_ADDIU(R_A0, R_A0, 1));                /* 0 */
+    EMIT(PSX_BNE(R_A0, R_ZERO, 2));                /* 1: → insn 4 */
+    EMIT(PSX_NOP());                               /* 2 */
+    EMIT(PSX_ADDIU(R_A1, R_ZERO, 99));             /* 3: fall-through only */
+    EMIT(PSX_ADDIU(R_A2, R_A0, 10));               /* 4 */
+    RUN(2000);
+    for (int i = 0; i < 20; i++)
+    {
+        cpu.regs[R_RA] = PG_HALT_BASE;
+        pg_run_jit(PG_CODE_BASE, 2000);
+    }
+    EXPECT_REG(R_A1, 0);
+    EXPECT_REG(R_A2, 21 + 10);
+
+    /* Not taken now: a0 = -1 + 1 = 0 → side exit through insn 3 */
+    SET_REG(R_A0, 0xFFFFFFFFu);
+    cpu.regs[R_RA] = PG_HALT_BASE;
+    pg_run_jit(PG_CODE_BASE, 2000);
+    psx_config.jit_tier_threshold = 0;
+    BlockEntry *be = lookup_block(PG_CODE_BASE);
+    if (!be || be->tier != 1)
+    {
+        printf("  [FAIL] %s: block not re-optimized\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    EXPECT_REG(R_A0, 0);
+    EXPECT_REG(R_A1, 99);
+    EXPECT_REG(R_A2, 10);
+    END_TEST();
+}
+
 static void test_super_block_fallthrough(void)
 {
     /* BEQ not taken → super-block fall-through.
@@ -398,6 +706,179 @@ static void test_loop_accumulate_memory(void)
     END_TEST();
 }
 
+/* Word copy loop with the destination bump in the delay slot: tagged as
+ * P-COPY at compile time, and jit_idiom_run finishes it from the loop
+ * head with the same memory, registers and exit PC as the native loop */
+static void test_idiom_copy_loop(void)
+{
+    BEGIN_TEST("idiom_copy_loop");
+    for (int i = 0; i < 16; i++)
+    {
+        SET_MEM32(PG_DATA_OFFSET + i * 4, 0x1000 + i);
+        SET_MEM32(PG_DATA_OFFSET + 0x100 + i * 4, 0);
+    }
+    SET_REG(R_T0, PG_DATA_BASE);
+    SET_REG(R_T1, PG_DATA_BASE + 0x100);
+    SET_REG(R_T2, PG_DATA_BASE + 64);
+    EMIT(PSX_LW(R_T3, 0, R_T0));
+    EMIT(PSX_ADDIU(R_T0, R_T0, 4));
+    EMIT(PSX_SW(R_T3, 0, R_T1));
+    EMIT(PSX_BNE(R_T0, R_T2, (uint16_t)(-4)));
+    EMIT(PSX_ADDIU(R_T1, R_T1, 4));
+    RUN(50000);
+    EXPECT_MEM32(PG_DATA_OFFSET + 0x100 + 15 * 4, 0x100F);
+
+    BlockEntry *be = lookup_block(PG_CODE_BASE);
+    if (!be || be->block_pattern != JIT_IDIOM_COPY)
+    {
+        printf("  [FAIL] %s: loop not tagged as copy (pattern=%d)\n", pg_ctx.name,
+               be ? be->block_pattern : -1);
+        pg_ctx.fail_count++;
+        END_TEST();
+        return;
+    }
+
+    for (int i = 0; i < 16; i++)
+        SET_MEM32(PG_DATA_OFFSET + 0x100 + i * 4, 0);
+    SET_REG(R_T0, PG_DATA_BASE + 8); /* two iterations already done */
+    SET_REG(R_T1, PG_DATA_BASE + 0x108);
+    SET_REG(R_T3, 0);
+    cpu.pc = PG_CODE_BASE;
+    uint64_t before = global_cycles;
+    uint32_t bytes = 0;
+    if (!jit_idiom_run(be, &bytes) || bytes != 56 ||
+        global_cycles - before != 14ull * be->cycle_count)
+    {
+        printf("  [FAIL] %s: idiom run bytes=%u cycles=%llu\n", pg_ctx.name, (unsigned)bytes,
+               (unsigned long long)(global_cycles - before));
+        pg_ctx.fail_count++;
+    }
+    EXPECT_REG(R_T0, PG_DATA_BASE + 64);
+    EXPECT_REG(R_T1, PG_DATA_BASE + 0x140);
+    EXPECT_REG(R_T3, 0x100F);
+    EXPECT_MEM32(PG_DATA_OFFSET + 0x100, 0);
+    EXPECT_MEM32(PG_DATA_OFFSET + 0x108, 0x1002);
+    EXPECT_MEM32(PG_DATA_OFFSET + 0x13C, 0x100F);
+    if (cpu.pc != PG_CODE_BASE + 20)
+    {
+        printf("  [FAIL] %s: exit pc=0x%08X\n", pg_ctx.name, (unsigned)cpu.pc);
+        pg_ctx.fail_count++;
+    }
+    END_TEST();
+}
+
+/* Classifier coverage for the other idioms, plus a strlen run through a
+ * hand-built BlockEntry (jit_idiom_run only needs the opcodes in RAM) */
+static void test_idiom_detect_kinds(void)
+{
+    BEGIN_TEST("idiom_detect_kinds");
+    const uint32_t fill[] = {PSX_SW(R_ZERO, 0, R_T0), PSX_ADDIU(R_T0, R_T0, 4),
+                             PSX_BNE(R_T0, R_T2, (uint16_t)(-3)), PSX_NOP()};
+    const uint32_t sum[] = {PSX_LBU(R_T3, 0, R_T0), PSX_ADDIU(R_T0, R_T0, 1),
+                            PSX_ADDU(R_V0, R_V0, R_T3), PSX_BNE(R_T0, R_T2, (uint16_t)(-4)),
+                            PSX_NOP()};
+    const uint32_t strlen_loop[] = {PSX_LBU(R_T3, 0, R_T0), PSX_ADDIU(R_T0, R_T0, 1),
+                                    PSX_BNE(R_T3, R_ZERO, (uint16_t)(-3)), PSX_NOP()};
+    /* Load-delay hazard: the branch would see the previous byte */
+    const uint32_t hazard[] = {PSX_ADDIU(R_T0, R_T0, 1), PSX_LBU(R_T3, 0, R_T0),
+                               PSX_BNE(R_T3, R_ZERO, (uint16_t)(-3)), PSX_NOP()};
+    int k_fill = jit_idiom_detect(fill, 4), k_sum = jit_idiom_detect(sum, 5);
+    int k_scan = jit_idiom_detect(strlen_loop, 4), k_bad = jit_idiom_detect(hazard, 4);
+    if (k_fill != JIT_IDIOM_FILL || k_sum != JIT_IDIOM_SUM || k_scan != JIT_IDIOM_SCAN ||
+        k_bad != JIT_IDIOM_NONE)
+    {
+        printf("  [FAIL] %s: fill=%d sum=%d scan=%d hazard=%d\n", pg_ctx.name,
+               k_fill, k_sum, k_scan, k_bad);
+        pg_ctx.fail_count++;
+    }
+
+    BlockEntry be;
+    memset(&be, 0, sizeof(be));
+    memcpy(psx_ram + PG_CODE_OFFSET + 0x400, strlen_loop, sizeof(strlen_loop));
+    memcpy(psx_ram + PG_DATA_OFFSET, "idiom\0", 6);
+    be.psx_pc = PG_CODE_BASE + 0x400;
+    be.instr_count = 4;
+    be.code_hash = jit_code_hash(strlen_loop, 4);
+    be.cycle_count = 4;
+    be.block_pattern = JIT_IDIOM_SCAN;
+    SET_REG(R_T0, PG_DATA_BASE);
+    uint32_t bytes = 0;
+    if (!jit_idiom_run(&be, &bytes) || bytes != 6)
+    {
+        printf("  [FAIL] %s: strlen run failed (bytes=%u)\n", pg_ctx.name, (unsigned)bytes);
+        pg_ctx.fail_count++;
+    }
+    EXPECT_REG(R_T0, PG_DATA_BASE + 6);
+    EXPECT_REG(R_T3, 0);
+    END_TEST();
+}
+
+/* cycle_model: BIOS-ROM loads and uncached KSEG1 fetches pay the bus
+ * timing from the (reset-zero) delay registers, scratchpad keeps the
+ * flat cost; cycle_scale carries its fraction across instructions */
+static void test_cost_model_wait_states(void)
+{
+    BEGIN_TEST("cost_model_wait_states");
+    psx_config.cycle_model = 1;
+    jit_cost_refresh(NULL);
+    /* Delay/size = 0, 8-bit bus: 1ST = 6 (minimum), SEQ = 2 -> word = 6 + 3*2 */
+    uint32_t bios_lw = jit_cost_insn(PSX_LW(R_T0, 0, R_T1), PG_CODE_BASE, 1, 0xBFC00000);
+    uint32_t spad_lw = jit_cost_insn(PSX_LW(R_T0, 0, R_T1), PG_CODE_BASE, 1, 0x1F800000);
+    uint32_t ram_sw = jit_cost_insn(PSX_SW(R_T0, 0, R_T1), PG_CODE_BASE, 0, 0);
+    uint32_t rom_nop = jit_cost_insn(PSX_NOP(), 0xBFC00100, 0, 0);
+    psx_config.cycle_model = 0;
+    uint32_t flat_lw = jit_cost_insn(PSX_LW(R_T0, 0, R_T1), PG_CODE_BASE, 1, 0xBFC00000);
+
+    uint32_t saved_scale = jit_cost_scale, frac = 0;
+    jit_cost_scale = 384; /* 150% */
+    uint32_t s1 = jit_cost_scaled(1, &frac);
+    uint32_t s2 = jit_cost_scaled(1, &frac);
+    jit_cost_scale = saved_scale;
+
+    if (bios_lw != 12 || spad_lw != 2 || ram_sw != 1 || rom_nop != 12 || flat_lw != 2 ||
+        s1 + s2 != 3)
+    {
+        printf("  [FAIL] %s: bios_lw=%u spad_lw=%u ram_sw=%u rom_nop=%u flat=%u scaled=%u+%u\n",
+               pg_ctx.name, (unsigned)bios_lw, (unsigned)spad_lw, (unsigned)ram_sw,
+               (unsigned)rom_nop, (unsigned)flat_lw, (unsigned)s1, (unsigned)s2);
+        pg_ctx.fail_count++;
+    }
+    END_TEST();
+}
+
+static void test_lazy_cycle_chain(void)
+{
+    /* A -> B -> C forward chain.  Once everything is linked, a budget
+     * that runs out inside A must not stop at the A->B or B->C link in
+     * lazy mode: the whole chain runs in a single dispatch. */
+    BEGIN_TEST("lazy_cycle_chain");
+    psx_config.jit_lazy_cycles = 1;
+    SET_REG(R_V0, 10);
+    uint32_t block_b = PG_CODE_BASE + 8 * 4;
+    uint32_t block_c = PG_CODE_BASE + 16 * 4;
+
+    EMIT(PSX_ADDIU(R_A0, R_V0, 1));       /* a0 = 11 */
+    EMIT(PSX_J((block_b >> 2) & 0x03FFFFFF));
+    EMIT(PSX_NOP());
+    for (int i = 3; i < 8; i++) EMIT(PSX_NOP());
+
+    EMIT(PSX_ADDIU(R_A1, R_A0, 2));       /* a1 = 13 */
+    EMIT(PSX_J((block_c >> 2) & 0x03FFFFFF));
+    EMIT(PSX_NOP());
+    for (int i = 11; i < 16; i++) EMIT(PSX_NOP());
+
+    EMIT(PSX_ADDIU(R_A2, R_A1, 3));       /* a2 = 16 */
+
+    RUN(10000); /* Compile and link all three */
+    SET_REG(R_A0, 0);
+    SET_REG(R_A1, 0);
+    SET_REG(R_A2, 0);
+    pg_run_jit(PG_CODE_BASE, 2);
+    psx_config.jit_lazy_cycles = 0;
+    EXPECT_REG(R_A2, 16);
+    END_TEST();
+}
+
 static void test_conditional_both_paths(void)
 {
     /* Run the same code with two different initial conditions.
@@ -555,10 +1036,11 @@ static void test_dynamic_survives_smc(void)
     /* Compute a3 = t0 + t1 BEFORE the SMC write */
     EMIT(PSX_ADDU(R_A3, R_T0, R_T1));          /* a3 = 0xBBDE0021 */
 
-    /* Write to code page → triggers SMC detection → lite trampoline
+    /* Write to the code chunk → triggers SMC detection → lite trampoline
      * saves T0-T7, calls jit_smc_handler, restores T0-T7.
-     * Writing at offset 0x100 avoids overwriting our own JR $ra exit. */
-    EMIT(PSX_SW(R_S2, 0x100, R_T3));           /* SW to 0x80010100 */
+     * Offset 0x30 shares this block's 64-byte chunk but lies past its
+     * JR $ra exit, so the block itself is not overwritten. */
+    EMIT(PSX_SW(R_S2, 0x30, R_T3));            /* SW to 0x80010030 */
 
     /* After trampoline returns, dynamic slots must still be correct.
      * Compute a3 += t2 using values that must survive the trampoline. */
@@ -575,6 +1057,33 @@ static void test_dynamic_survives_smc(void)
     END_TEST();
 }
 
+static void test_smc_subpage_spares_block(void)
+{
+    /* A const-address store into the code page but outside every code
+     * chunk must not invalidate the block that sits on the same page. */
+    BEGIN_TEST("smc_subpage_spares_block");
+    SET_REG(R_S2, 0x12345678);
+    EMIT(PSX_LUI(R_T3, 0x8001));               /* t3 = 0x80010000 (code page) */
+    EMIT(PSX_ADDIU(R_A0, R_A0, 1));
+    EMIT(PSX_SW(R_S2, 0x800, R_T3));           /* data word, chunk 32 */
+    RUN(2000);
+    BlockEntry *be = lookup_block(PG_CODE_BASE);
+    uint32_t page = PG_CODE_OFFSET >> 12;
+    if (!be || be->page_gen != jit_page_gen[page] ||
+        !(smc_code_map[page] & 1) || (smc_code_map[page] & (1ULL << 32)))
+    {
+        printf("  [FAIL] %s: data store invalidated neighbouring code\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    EXPECT_REG(R_A0, 1);
+    if (GET_MEM32(PG_CODE_OFFSET + 0x800) != 0x12345678u)
+    {
+        printf("  [FAIL] %s: store not performed\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    END_TEST();
+}
+
 /* Two blocks with different dominant non-pinned regs.
  * Block 1: heavy use of t0-t3 (get dynamic slots T0-T2).
  * Block 2: heavy use of s2-s5 (different dynamic slot assignment).
@@ -630,6 +1139,41 @@ static void test_dynamic_cross_block_alloc(void)
  *  Pinned callee-saved: s0→S6, s1→S7, gp→FP, sp→S4, ra→S5
  * ================================================================ */
 
+/* Block A links directly to an already-compiled block B that keeps the
+ * same PSX regs in the same dynamic slots, so the link enters B past its
+ * slot loads.  Values carried in T0-T7 across the link must be right. */
+static void test_dynamic_fast_entry_link(void)
+{
+    BEGIN_TEST("dynamic_fast_entry_link");
+    uint32_t block_b = PG_CODE_BASE + 8 * 4;
+
+    /* Block A: t0 += 2, t1 += 2 + t0 */
+    EMIT(PSX_ADDIU(R_T0, R_T0, 1));
+    EMIT(PSX_ADDIU(R_T0, R_T0, 1));
+    EMIT(PSX_ADDIU(R_T1, R_T1, 2));
+    EMIT(PSX_ADDU(R_T1, R_T1, R_T0));
+    EMIT(PSX_J((block_b >> 2) & 0x03FFFFFF));
+    EMIT(PSX_NOP());
+    for (int i = 6; i < 8; i++) EMIT(PSX_NOP());
+
+    /* Block B: same slot mapping (t0 → slot 0, t1 → slot 1) */
+    EMIT(PSX_ADDIU(R_T0, R_T0, 1));
+    EMIT(PSX_ADDIU(R_T0, R_T0, 1));
+    EMIT(PSX_ADDIU(R_T1, R_T1, 1));
+    EMIT(PSX_ADDU(R_T1, R_T1, R_T0));
+    EMIT(PSX_JR(R_RA));
+    EMIT(PSX_NOP());
+
+    pg_run_jit(block_b, 2000);            /* compile B first */
+    SET_REG(R_T0, 10);
+    SET_REG(R_T1, 100);
+    cpu.regs[R_RA] = PG_HALT_BASE;
+    RUN(10000);                            /* A links to compiled B */
+    EXPECT_REG(R_T0, 14);                  /* 10 + 2 + 2 */
+    EXPECT_REG(R_T1, 129);                 /* (100 + 2 + 12) + 1 + 14 */
+    END_TEST();
+}
+
 /* Block only uses v0 (caller-saved pin). All callee-saved pins
  * (s0, s1, gp, sp) must be preserved untouched.
  * ra is set by BEGIN_TEST to PG_HALT_BASE, so we check it separately. */
@@ -785,17 +1329,32 @@ void pg_run_block_tests(void)
     test_nonpinned_regs_cross_block();
     test_reg_write_cross_block();
     test_multi_block_chain();
+    test_segment_eviction_unlinks();
+    test_tier_up_recompile();
+    test_tier_up_load_kill();
+    test_disk_cache_verify();
+    test_ras_call_return();
+    test_ht_set_replacement();
+    test_block_node_recycle();
+    test_spec_compile_queue();
+    test_trace_taken_side_exit();
     test_super_block_fallthrough();
     test_super_block_taken();
     test_nested_jal();
     test_loop_accumulate_memory();
+    test_idiom_copy_loop();
+    test_idiom_detect_kinds();
+    test_cost_model_wait_states();
+    test_lazy_cycle_chain();
     test_conditional_both_paths();
     test_all_32_regs();
 
     printf("\n--- Dynamic Allocator Stress ---\n");
     test_many_dynamic_regs();
     test_dynamic_survives_smc();
+    test_smc_subpage_spares_block();
     test_dynamic_cross_block_alloc();
+    test_dynamic_fast_entry_link();
 
     printf("\n--- Prologue / Register Pin ---\n");
     test_prologue_only_caller_pins();
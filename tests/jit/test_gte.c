@@ -15,6 +15,7 @@
  * GTE operations intact.
  */
 #include "playground.h"
+#include "config.h"
 
 /* ---- Helper: enable COP2 in SR ---- */
 static void gte_enable_cop2(void)
@@ -1373,6 +1374,322 @@ static void test_gte_rtpt(void)
 }
 
 
+/* ================================================================
+ * Test 33: Batched RTPS run (gte_vu1_batch)
+ *
+ * RTPS; MTC2 VXY0; ADDIU; RTPS; MTC2 VXY0; MFC2 SXY1; MFC2 SXY2
+ * The two RTPS are queued and replayed at the first MFC2.  Results
+ * must match the unbatched run, the second RTPS must see the first
+ * MTC2 value, and VXY0 must end up with the second one.
+ * ================================================================ */
+static void gte_batch_emit_program(void)
+{
+    gte_enable_cop2();
+    gte_set_identity();
+    cpu.cp2_ctrl[GTE_TRZ] = 200;
+    cpu.cp2_ctrl[GTE_H]   = 100;
+    cpu.cp2_data[GTE_VXY0] = PACK_VXY(0, 0);
+    cpu.cp2_data[GTE_VZ0]  = 0;
+    SET_REG(R_T0, PACK_VXY(100, -40));
+    SET_REG(R_T2, PACK_VXY(7, 7));
+
+    EMIT(GTE_CMD_RTPS(1, 0));
+    EMIT(PSX_MTC2(R_T0, GTE_VXY0));
+    EMIT(PSX_ADDIU(R_T1, R_ZERO, 5));
+    EMIT(GTE_CMD_RTPS(1, 0));
+    EMIT(PSX_MTC2(R_T2, GTE_VXY0));
+    EMIT(PSX_MFC2(R_T3, GTE_SXY1));
+    EMIT(PSX_MFC2(R_T4, GTE_SXY2));
+}
+
+static void test_gte_batch_rtps_run(void)
+{
+    static const int regs[] = {GTE_SXY0, GTE_SXY1, GTE_SXY2, GTE_SZ1, GTE_SZ2, GTE_SZ3,
+                               GTE_MAC0, GTE_IR0, GTE_VXY0};
+    uint32_t ref[9], ref_t3, ref_t4;
+
+    BEGIN_TEST("gte_batch_ref");
+    psx_config.gte_vu1_batch = 0;
+    gte_batch_emit_program();
+    RUN(500);
+    for (int i = 0; i < 9; i++)
+        ref[i] = cpu.cp2_data[regs[i]];
+    ref_t3 = cpu.regs[R_T3];
+    ref_t4 = cpu.regs[R_T4];
+    EXPECT_CP2_DATA(GTE_VXY0, PACK_VXY(7, 7));
+    END_TEST();
+
+    BEGIN_TEST("gte_batch_rtps_run");
+    psx_config.gte_vu1_batch = 1;
+    gte_batch[1].opcode = 0;
+    gte_batch_emit_program();
+    RUN(500);
+    psx_config.gte_vu1_batch = 0;
+    if (gte_batch[1].opcode != GTE_CMD_RTPS(1, 0) || gte_batch[1].in[0] != PACK_VXY(100, -40))
+    {
+        printf("  [FAIL] %s: second RTPS not queued (op=%08X in0=%08X)\n", pg_ctx.name,
+               (unsigned)gte_batch[1].opcode, (unsigned)gte_batch[1].in[0]);
+        pg_ctx.fail_count++;
+    }
+    for (int i = 0; i < 9; i++)
+        EXPECT_CP2_DATA(regs[i], ref[i]);
+    EXPECT_REG(R_T3, ref_t3);
+    EXPECT_REG(R_T4, ref_t4);
+    END_TEST();
+}
+
+
+/* ================================================================
+ * Test 34: Lazy GTE flags (gte_lazy_flags)
+ *
+ * RTPS; CFC2 $31; RTPS; NCLIP; CFC2 $31 on the exact C path, with IR
+ * saturating.  The first RTPS flag is read and the second is reset by
+ * NCLIP unread, so only the second RTPS runs flag-free.  Every result
+ * must match the full-flag run.
+ * ================================================================ */
+static void gte_lazy_flag_emit_program(void)
+{
+    gte_enable_cop2();
+    gte_set_identity();
+    SET_REG(R_T0, PACK_VXY(100, -40));
+    SET_REG(R_T1, 50);
+    EMIT(PSX_MTC2(R_T0, GTE_VXY0));
+    EMIT(PSX_MTC2(R_T1, GTE_VZ0));
+    EMIT(GTE_CMD_RTPS(0, 0));
+    EMIT(PSX_CFC2(R_T2, GTE_FLAG_CTRL));
+    EMIT(GTE_CMD_RTPS(0, 0));
+    EMIT(GTE_CMD_NCLIP);
+    EMIT(PSX_CFC2(R_T3, GTE_FLAG_CTRL));
+}
+
+static void test_gte_lazy_flags(void)
+{
+    static const int regs[] = {GTE_SXY2, GTE_SZ3, GTE_IR1, GTE_IR2, GTE_IR3, GTE_MAC0, GTE_IR0};
+    uint32_t ref[7], ref_t2, ref_t3;
+    int saved_vu0 = gte_use_vu0;
+
+    BEGIN_TEST("gte_lazy_flags_ref");
+    gte_use_vu0 = 0;
+    psx_config.gte_lazy_flags = 0;
+    gte_lazy_flag_emit_program();
+    RUN(500);
+    for (int i = 0; i < 7; i++)
+        ref[i] = cpu.cp2_data[regs[i]];
+    ref_t2 = cpu.regs[R_T2];
+    ref_t3 = cpu.regs[R_T3];
+    if (ref_t2 == 0)
+    {
+        printf("  [FAIL] %s: RTPS sf=0 did not saturate IR (FLAG=0)\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+    END_TEST();
+
+    BEGIN_TEST("gte_lazy_flags");
+    gte_use_vu0 = 0;
+    psx_config.gte_lazy_flags = 1;
+    gte_lazy_flag_emit_program();
+    RUN(500);
+    psx_config.gte_lazy_flags = 0;
+    for (int i = 0; i < 7; i++)
+        EXPECT_CP2_DATA(regs[i], ref[i]);
+    EXPECT_REG(R_T2, ref_t2);
+    EXPECT_REG(R_T3, ref_t3);
+    END_TEST();
+    gte_use_vu0 = saved_vu0;
+}
+
+/* ================================================================
+ * Test 35: Dead GTE output stores
+ *
+ * RTPT; MFC2 IR0; CTC2 DQB; MTC2 VXY0/VXY2; RTPT; MFC2 SXY0
+ * MAC0/MAC1-2/IR3 of the first RTPT are overwritten unread, IR0 is
+ * read in between.  The read must see the first IR0 and every output
+ * of the second RTPT must be stored.
+ * ================================================================ */
+static void test_gte_dead_outputs(void)
+{
+    BEGIN_TEST("gte_dead_outputs");
+    gte_enable_cop2();
+    gte_set_identity();
+    cpu.cp2_ctrl[GTE_TRZ] = 200;
+    cpu.cp2_ctrl[GTE_H]   = 100;
+    cpu.cp2_ctrl[GTE_DQB] = 0x1000000;
+    for (int i = GTE_VXY0; i <= GTE_VZ2; i++)
+        cpu.cp2_data[i] = 0;
+    SET_REG(R_T0, PACK_VXY(50, 0));
+    SET_REG(R_T1, PACK_VXY(20, 0));
+    SET_REG(R_T2, 0x800000);
+
+    EMIT(GTE_CMD_RTPT(1, 1));
+    EMIT(PSX_MFC2(R_T5, GTE_IR0));
+    EMIT(PSX_CTC2(R_T2, GTE_DQB));
+    EMIT(PSX_MTC2(R_T0, GTE_VXY0));
+    EMIT(PSX_MTC2(R_T1, GTE_VXY2));
+    EMIT(GTE_CMD_RTPT(1, 1));
+    EMIT(PSX_MFC2(R_T3, GTE_SXY0));
+    RUN(500);
+
+    EXPECT_REG(R_T5, 0x1000);
+    EXPECT_REG(R_T3, PACK_SXY(185, 120));
+    EXPECT_CP2_DATA(GTE_SXY2, PACK_SXY(170, 120));
+    EXPECT_CP2_DATA(GTE_MAC0, 0x800000);
+    EXPECT_CP2_DATA(GTE_IR0, 0x800);
+    EXPECT_CP2_DATA(GTE_MAC1, 20);
+    EXPECT_CP2_DATA(GTE_IR1, 20);
+    EXPECT_CP2_DATA(GTE_MAC2, 0);
+    EXPECT_CP2_DATA(GTE_IR3, 200);
+    END_TEST();
+}
+
+/* ================================================================
+ *  Matrix cache (36)
+ *  CTC2 to RT / TR between two RTPS must invalidate the decoded
+ *  matrix cache; the second RTPS sees the new rotation and TRX.
+ * ================================================================ */
+static void test_gte_matrix_cache(void)
+{
+    BEGIN_TEST("gte_matrix_cache");
+    gte_enable_cop2();
+    gte_set_identity();
+    cpu.cp2_ctrl[GTE_TRZ] = 200;
+    cpu.cp2_ctrl[GTE_H]   = 100;
+    SET_REG(R_T0, PACK_VXY(50, 0));
+    SET_REG(R_T1, 0x2000); /* RT11 = 2.0, RT12 = 0 */
+    SET_REG(R_T2, 7);
+
+    EMIT(PSX_MTC2(R_T0, GTE_VXY0));
+    EMIT(PSX_MTC2(R_ZERO, GTE_VZ0));
+    EMIT(GTE_CMD_RTPS(1, 0));
+    EMIT(PSX_MFC2(R_T3, GTE_MAC1));
+    EMIT(PSX_CTC2(R_T1, GTE_RT11RT12));
+    EMIT(PSX_CTC2(R_T2, GTE_TRX));
+    EMIT(GTE_CMD_RTPS(1, 0));
+    EMIT(PSX_MFC2(R_T4, GTE_MAC1));
+    RUN(500);
+
+    EXPECT_REG(R_T3, 50);
+    EXPECT_REG(R_T4, 107);
+    EXPECT_CP2_DATA(GTE_IR1, 107);
+    END_TEST();
+}
+
+/* ================================================================
+ *  UNR divide (37)
+ *  MAC0 = DQA * div + DQB with DQA=1, DQB=0 exposes the divide result.
+ *  H=0x200: SZ3=0x404 takes the reciprocal table, SZ3=0x1236 the
+ *  Newton steps (both differ from a rounded float divide by one), and
+ *  SZ3=0x100 overflows (H >= 2*SZ3).
+ * ================================================================ */
+static void test_gte_unr_divide(void)
+{
+    BEGIN_TEST("gte_unr_divide");
+    gte_enable_cop2();
+    gte_set_identity();
+    cpu.cp2_ctrl[GTE_H]   = 0x200;
+    cpu.cp2_ctrl[GTE_DQA] = 1;
+    cpu.cp2_ctrl[GTE_DQB] = 0;
+    cpu.cp2_data[GTE_VXY0] = PACK_VXY(0, 0);
+    SET_REG(R_T0, 0x404);
+    SET_REG(R_T1, 0x1236);
+    SET_REG(R_T2, 0x100);
+
+    EMIT(PSX_MTC2(R_T0, GTE_VZ0));
+    EMIT(GTE_CMD_RTPS(1, 1));
+    EMIT(PSX_MFC2(R_T3, GTE_MAC0));
+    EMIT(PSX_MTC2(R_T1, GTE_VZ0));
+    EMIT(GTE_CMD_RTPS(1, 1));
+    EMIT(PSX_MFC2(R_T4, GTE_MAC0));
+    EMIT(PSX_MTC2(R_T2, GTE_VZ0));
+    EMIT(GTE_CMD_RTPS(1, 1));
+    EMIT(PSX_MFC2(R_T5, GTE_MAC0));
+    RUN(500);
+
+    EXPECT_REG(R_T3, 32641);
+    EXPECT_REG(R_T4, 7198);
+    EXPECT_REG(R_T5, 0x1FFFF);
+    END_TEST();
+}
+
+/* ================================================================
+ * Test 38: MVMVA followed by independent ALU ops
+ *
+ * With ENABLE_VU0_MICRO the ALU run sits between the VU0 launch and
+ * the poll, and the MFC2 is the first instruction that waits for it.
+ * Same matrix and vector as test 22: MAC1-3 = (110, 220, 330).
+ * ================================================================ */
+static void test_gte_mvmva_async(void)
+{
+    BEGIN_TEST("gte_mvmva_async");
+    gte_enable_cop2();
+
+    cpu.cp2_ctrl[GTE_RT11RT12] = (0 << 16) | (4096 & 0xFFFF);
+    cpu.cp2_ctrl[GTE_RT13RT21] = 0;
+    cpu.cp2_ctrl[GTE_RT22RT23] = (0 << 16) | (4096 & 0xFFFF);
+    cpu.cp2_ctrl[GTE_RT31RT32] = 0;
+    cpu.cp2_ctrl[GTE_RT33]     = 4096;
+    cpu.cp2_ctrl[GTE_TRX] = 100;
+    cpu.cp2_ctrl[GTE_TRY] = 200;
+    cpu.cp2_ctrl[GTE_TRZ] = 300;
+
+    cpu.cp2_data[GTE_VXY0] = PACK_VXY(10, 20);
+    cpu.cp2_data[GTE_VZ0]  = 30;
+    SET_REG(R_T0, 5);
+    SET_REG(R_T1, 7);
+
+    EMIT(GTE_CMD_MVMVA(1, 0, 0, 0, 0));
+    EMIT(PSX_ADDU(R_T2, R_T0, R_T1));
+    EMIT(PSX_SLL(R_T2, R_T2, 2));
+    EMIT(PSX_XORI(R_T3, R_T0, 0xFF));
+    EMIT(PSX_MFC2(R_T4, GTE_MAC1));
+    EMIT(PSX_MFC2(R_T5, GTE_IR3));
+
+    RUN(300);
+
+    EXPECT_REG(R_T2, 48);
+    EXPECT_REG(R_T3, 0xFA);
+    EXPECT_REG(R_T4, 110);
+    EXPECT_REG(R_T5, 330);
+    EXPECT_CP2_DATA(GTE_MAC2, 220);
+    EXPECT_CP2_CTRL(GTE_FLAG_CTRL, 0);
+    END_TEST();
+}
+
+/* ================================================================
+ * Test 39: RTPT; NOP; NCLIP fused
+ *
+ * The NCLIP is computed by the RTPT emitter from SXY2 in a register.
+ * V0-V2 = (0,0), (40,0), (0,40) at Z 200 project to (160,120),
+ * (180,120), (160,140): MAC0 = 400, and IR0 from the RTPT's depth cue
+ * still holds.
+ * ================================================================ */
+static void test_gte_rtpt_nclip(void)
+{
+    BEGIN_TEST("gte_rtpt_nclip");
+    gte_enable_cop2();
+    gte_set_identity();
+    cpu.cp2_ctrl[GTE_TRZ] = 200;
+    cpu.cp2_ctrl[GTE_H]   = 100;
+    cpu.cp2_ctrl[GTE_DQA] = 0;
+    cpu.cp2_ctrl[GTE_DQB] = 0x1000000;
+    for (int i = GTE_VXY0; i <= GTE_VZ2; i++)
+        cpu.cp2_data[i] = 0;
+    cpu.cp2_data[GTE_VXY1] = PACK_VXY(40, 0);
+    cpu.cp2_data[GTE_VXY2] = PACK_VXY(0, 40);
+
+    EMIT(GTE_CMD_RTPT(1, 1));
+    EMIT(PSX_NOP());
+    EMIT(GTE_CMD_NCLIP);
+    EMIT(PSX_MFC2(R_T3, GTE_MAC0));
+    RUN(300);
+
+    EXPECT_REG(R_T3, 400);
+    EXPECT_CP2_DATA(GTE_SXY0, PACK_SXY(160, 120));
+    EXPECT_CP2_DATA(GTE_SXY2, PACK_SXY(160, 140));
+    EXPECT_CP2_DATA(GTE_IR0, 0x1000);
+    EXPECT_CP2_CTRL(GTE_FLAG_CTRL, 0);
+    END_TEST();
+}
+
 /* ================================================================
  *  Category runner
  * ================================================================ */
@@ -1420,4 +1737,18 @@ void pg_run_gte_tests(void)
     /* Perspective transform (31-32) */
     test_gte_rtps_center();
     test_gte_rtpt();
+    /* Batched runs (33) */
+    test_gte_batch_rtps_run();
+    /* Lazy flags (34) */
+    test_gte_lazy_flags();
+    /* Dead output stores (35) */
+    test_gte_dead_outputs();
+    /* Matrix cache (36) */
+    test_gte_matrix_cache();
+    /* UNR divide (37) */
+    test_gte_unr_divide();
+    /* VU0 overlap (38) */
+    test_gte_mvmva_async();
+    /* RTPT+NCLIP fusion (39) */
+    test_gte_rtpt_nclip();
 }
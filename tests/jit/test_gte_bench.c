@@ -0,0 +1,87 @@
+/*
+ * JIT Playground — GTE Accuracy Tier Benchmark
+ *
+ * Compiles one block of RTPS + NCDS pairs per GTE tier (exact / fast /
+ * ultra), re-runs it from the block cache and reports GTE commands per
+ * second.  Report only (no pass/fail); enabled with gte_bench=1 in the
+ * playground's superpsx.ini.
+ *
+ * The figure includes the per-run dispatch overhead, identical for all
+ * tiers, so compare tiers against each other rather than against real
+ * hardware.
+ */
+#include "playground.h"
+#include <time.h>
+
+#define BENCH_PAIRS  60   /* RTPS + NCDS pairs: 120 insns + JR + NOP */
+#define BENCH_ROUNDS 2000 /* block re-runs per tier */
+
+int pg_gte_bench = 0;
+
+static void bench_gte_state(void)
+{
+    cpu.cop0[PSX_COP0_SR_IDX] = (1u << 30) | (1u << 28);
+    cpu.cp2_ctrl[GTE_RT11RT12] = 0x1000;
+    cpu.cp2_ctrl[GTE_RT22RT23] = 0x1000;
+    cpu.cp2_ctrl[GTE_RT33]     = 0x1000;
+    cpu.cp2_ctrl[GTE_TRZ]      = 1000;
+    cpu.cp2_ctrl[GTE_L11L12]   = 0x0C00;
+    cpu.cp2_ctrl[GTE_L33]      = 0x0800;
+    cpu.cp2_ctrl[GTE_LR1LR2]   = 0x1000;
+    cpu.cp2_ctrl[GTE_LG2LG3]   = 0x1000;
+    cpu.cp2_ctrl[GTE_LB3]      = 0x1000;
+    cpu.cp2_ctrl[GTE_OFX]      = 160 << 16;
+    cpu.cp2_ctrl[GTE_OFY]      = 120 << 16;
+    cpu.cp2_ctrl[GTE_H]        = 256;
+    cpu.cp2_ctrl[GTE_DQA]      = (uint32_t)(int32_t)(-0x40);
+    cpu.cp2_ctrl[GTE_DQB]      = 0x1400000;
+    cpu.cp2_data[GTE_VXY0]     = PACK_VXY(100, -50);
+    cpu.cp2_data[GTE_VZ0]      = 300;
+    cpu.cp2_data[GTE_RGBC]     = 0x00808080;
+}
+
+/* Returns commands per second for the current gte_tier */
+static double bench_gte_tier(void)
+{
+    BEGIN_TEST("gte_bench");
+    bench_gte_state();
+    for (int i = 0; i < BENCH_PAIRS; i++)
+    {
+        EMIT(GTE_CMD_RTPS(1, 1));
+        EMIT(GTE_CMD_NCDS(1, 1));
+    }
+    RUN(5000); /* compile + first run */
+
+    clock_t t0 = clock();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        pg_run_jit(PG_CODE_BASE, 1); /* one pass, no halt-loop spin */
+    double secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    if (secs <= 0.0)
+        return 0.0;
+    return (double)BENCH_ROUNDS * BENCH_PAIRS * 2 / secs;
+}
+
+void pg_run_gte_bench(void)
+{
+    static const char *names[] = {"exact", "fast", "ultra"};
+    int saved_tier = gte_tier, saved_vu0 = gte_use_vu0;
+    double ops[3];
+
+    if (!pg_gte_bench)
+        return;
+    printf("--- GTE Tier Benchmark (RTPS+NCDS, %d commands x %d runs) ---\n",
+           BENCH_PAIRS * 2, BENCH_ROUNDS);
+    for (int t = GTE_TIER_EXACT; t <= GTE_TIER_ULTRA; t++)
+    {
+        gte_tier = t;
+        gte_use_vu0 = (t >= GTE_TIER_FAST);
+        ops[t] = bench_gte_tier();
+        printf("  %-6s %12.0f ops/sec", names[t], ops[t]);
+        if (t > GTE_TIER_EXACT && ops[GTE_TIER_EXACT] > 0.0)
+            printf("  (%.2fx exact)", ops[t] / ops[GTE_TIER_EXACT]);
+        printf("\n");
+    }
+    gte_tier = saved_tier;
+    gte_use_vu0 = saved_vu0;
+    printf("\n");
+}
@@ -1,7 +1,8 @@
 /*
- * test_gte_compare.c — GTE VU0 vs C Reference Comparison Tests
+ * test_gte_compare.c — GTE VU0/VFPU vs C Reference Comparison Tests
  *
- * For each GTE command that uses VU0 micro in the JIT (sf=1 path),
+ * For each GTE command that uses VU0 micro (PS2) or the VFPU (PSP) in
+ * the JIT (sf=1 path),
  * we run the C reference (gte_use_vu0=0) and the JIT (gte_use_vu0=1)
  * with the same input state, then compare output registers.
  *
@@ -48,6 +49,7 @@ static void snapshot_restore(const GTESnapshot *snap)
 {
     memcpy(cpu.cp2_data, snap->data, sizeof(snap->data));
     memcpy(cpu.cp2_ctrl, snap->ctrl, sizeof(snap->ctrl));
+    PG_MARK_VU0_DIRTY(); /* cp2_ctrl rewritten behind CTC2's back */
 }
 
 /* ================================================================
@@ -394,6 +396,61 @@ static void test_cmp_cdp(void)
                      GTE_Inline_CDP, 1, 1);
 }
 
+/* ================================================================
+ * Lighting runs: one block, several lighting commands.  On PSP the
+ * Light/Color matrices stay resident in VFPU slots across the run;
+ * a CTC2 to the light matrix in the middle must reload them.
+ * ================================================================ */
+static void run_compare_light_run(const char *name, int ctc2_light)
+{
+    BEGIN_TEST(name);
+    setup_full_state();
+    snapshot_save(&saved_input);
+
+    /* C reference: the same sequence, with MTC2/CTC2 done by hand */
+    int saved_vu0 = gte_use_vu0;
+    gte_use_vu0 = 0;
+    GTE_Inline_NCDS(&cpu, 1, 1);
+    cpu.cp2_data[GTE_VXY0] = PACK_VXY(-300, 150);
+    cpu.cp2_data[GTE_VZ0]  = 700;
+    if (ctc2_light)
+        GTE_WriteCtrl(&cpu, GTE_L11L12, 0x08000800);
+    GTE_Inline_NCCS(&cpu, 1, 1);
+    GTE_Inline_CC(&cpu, 1, 1);
+    GTE_Inline_NCS(&cpu, 1, 1);
+    gte_use_vu0 = saved_vu0;
+    snapshot_save(&ref_output);
+
+    snapshot_restore(&saved_input);
+    gte_use_vu0 = 1;
+    SET_REG(R_T0, PACK_VXY(-300, 150));
+    SET_REG(R_T1, 700);
+    SET_REG(R_T2, 0x08000800);
+    EMIT(GTE_CMD_NCDS(1, 1));
+    EMIT(PSX_MTC2(R_T0, GTE_VXY0));
+    EMIT(PSX_MTC2(R_T1, GTE_VZ0));
+    if (ctc2_light)
+        EMIT(PSX_CTC2(R_T2, GTE_L11L12));
+    EMIT(GTE_CMD_NCCS(1, 1));
+    EMIT(GTE_CMD_CC(1, 1));
+    EMIT(GTE_CMD_NCS(1, 1));
+    RUN(500);
+    gte_use_vu0 = saved_vu0;
+
+    pg_ctx.fail_count = compare_gte_output(name);
+    END_TEST();
+}
+
+static void test_cmp_light_run(void)
+{
+    run_compare_light_run("cmp_light_run", 0);
+}
+
+static void test_cmp_light_run_ctc2(void)
+{
+    run_compare_light_run("cmp_light_run_ctc2_LL", 1);
+}
+
 /* ================================================================
  * Edge case: large vertex values (stress near-overflow)
  * ================================================================ */
@@ -513,6 +570,8 @@ void pg_run_gte_compare_tests(void)
     test_cmp_ncct();
     test_cmp_cc();
     test_cmp_cdp();
+    test_cmp_light_run();
+    test_cmp_light_run_ctc2();
 
     /* Edge cases */
     test_cmp_rtps_large();
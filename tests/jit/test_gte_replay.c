@@ -0,0 +1,208 @@
+/*
+ * JIT Playground — GTE Command-Stream Replay Benchmark
+ *
+ * Replays a gte_record stream (gte_replay=<file> in the playground's
+ * superpsx.ini) through every GTE backend of this build and reports
+ * commands per second, plus how many commands leave different data
+ * registers than the interpreter (FLAG is not compared: the fast paths
+ * leave it 0).
+ *
+ *   interp     GTE_Execute, exact C
+ *   jit-c      compiled, exact tier (C wrappers)
+ *   vu0-macro  compiled, fast tier — PS2 build
+ *   vu0-micro  compiled, fast tier — PS2 build with ENABLE_VU0_MICRO
+ *   vfpu       compiled, fast tier — PSP build
+ *   ultra      compiled, ultra tier
+ *
+ * Every distinct opcode gets a one-command block.  The control
+ * registers are reloaded (and the matrix caches dirtied) only when they
+ * change between records, as they would in the game.  JIT rows include
+ * one block dispatch per command.
+ */
+#include "playground.h"
+#include <stdlib.h>
+#include <time.h>
+
+#define REPLAY_MAX_OPS 64 /* distinct opcodes, one 4-word block each */
+
+#if defined(PLATFORM_PSP)
+#define REPLAY_FAST_NAME "vfpu"
+#elif defined(ENABLE_VU0_MICRO)
+#define REPLAY_FAST_NAME "vu0-micro"
+#else
+#define REPLAY_FAST_NAME "vu0-macro"
+#endif
+
+char pg_gte_replay[256] = "";
+
+static GTEStreamRecord *replay_recs;
+static int replay_count;
+static uint8_t *replay_block; /* record → block index */
+static uint32_t *replay_ref;  /* interpreter data-register hash per record */
+
+static void replay_set_tier(int tier)
+{
+    gte_tier = tier;
+    gte_use_vu0 = (tier >= GTE_TIER_FAST);
+#ifdef PLATFORM_PSP
+    gte_use_vfpu = gte_use_vu0;
+#endif
+}
+
+/* Fresh JIT cache + one block per distinct opcode: op; JR $ra; NOP */
+static int replay_install(void)
+{
+    uint32_t ops[REPLAY_MAX_OPS];
+    int nops = 0;
+
+    BEGIN_TEST("gte_replay");
+    cpu.cop0[PSX_COP0_SR_IDX] = (1u << 30) | (1u << 28);
+    for (int i = 0; i < replay_count; i++)
+    {
+        uint32_t op = replay_recs[i].opcode;
+        int b = 0;
+        while (b < nops && ops[b] != op)
+            b++;
+        if (b == nops)
+        {
+            if (nops == REPLAY_MAX_OPS)
+                return 0;
+            ops[nops++] = op;
+            pg_ctx.code[b * 4 + 0] = op;
+            pg_ctx.code[b * 4 + 1] = PSX_JR(R_RA);
+            pg_ctx.code[b * 4 + 2] = PSX_NOP();
+            pg_ctx.code[b * 4 + 3] = PSX_NOP();
+        }
+        replay_block[i] = (uint8_t)b;
+    }
+    return nops;
+}
+
+static void replay_load(int i)
+{
+    const GTEStreamRecord *r = &replay_recs[i];
+
+    memcpy(cpu.cp2_data, r->data, sizeof(r->data));
+    cpu.cp2_ctrl[31] = r->ctrl[31];
+    if (i == 0 || memcmp(replay_recs[i - 1].ctrl, r->ctrl, 31 * sizeof(uint32_t)))
+    {
+        memcpy(cpu.cp2_ctrl, r->ctrl, 31 * sizeof(uint32_t));
+        PG_MARK_VU0_DIRTY();
+    }
+}
+
+static void replay_exec(int jit, int i)
+{
+    if (jit)
+        pg_run_jit(PG_CODE_BASE + replay_block[i] * 16, 1);
+    else
+        GTE_Execute(replay_recs[i].opcode, &cpu);
+}
+
+static uint32_t replay_hash(void)
+{
+    uint32_t h = 2166136261u;
+    for (int r = 0; r < 32; r++)
+        h = (h ^ cpu.cp2_data[r]) * 16777619u;
+    return h;
+}
+
+/* Timed pass, then an untimed pass against the interpreter hashes.
+ * Returns commands per second. */
+static double replay_backend(int jit, int tier, int *diffs)
+{
+    replay_set_tier(tier);
+    if (jit)
+    {
+        replay_install();
+        for (int i = 0; i < replay_count; i++) /* compile every block */
+        {
+            replay_load(i);
+            replay_exec(1, i);
+        }
+    }
+
+    clock_t t0 = clock();
+    for (int i = 0; i < replay_count; i++)
+    {
+        replay_load(i);
+        replay_exec(jit, i);
+    }
+    double secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    *diffs = 0;
+    for (int i = 0; i < replay_count; i++)
+    {
+        replay_load(i);
+        replay_exec(jit, i);
+        if (!jit && tier == GTE_TIER_EXACT)
+            replay_ref[i] = replay_hash();
+        else if (replay_hash() != replay_ref[i])
+            (*diffs)++;
+    }
+    return secs > 0.0 ? (double)replay_count / secs : 0.0;
+}
+
+void pg_run_gte_replay(void)
+{
+    static const struct
+    {
+        const char *name;
+        int jit;
+        int tier;
+    } rows[] = {
+        {"interp", 0, GTE_TIER_EXACT},
+        {"jit-c", 1, GTE_TIER_EXACT},
+        {REPLAY_FAST_NAME, 1, GTE_TIER_FAST},
+        {"ultra", 1, GTE_TIER_ULTRA},
+    };
+    int saved_tier = gte_tier, saved_vu0 = gte_use_vu0;
+#ifdef PLATFORM_PSP
+    int saved_vfpu = gte_use_vfpu;
+#endif
+    double base = 0.0;
+
+    if (!pg_gte_replay[0])
+        return;
+    replay_recs = GTE_StreamLoad(pg_gte_replay, &replay_count);
+    if (!replay_recs || !replay_count)
+    {
+        printf("--- GTE Replay: no commands in %s ---\n\n", pg_gte_replay);
+        free(replay_recs);
+        return;
+    }
+    replay_block = (uint8_t *)malloc((size_t)replay_count);
+    replay_ref = (uint32_t *)malloc((size_t)replay_count * sizeof(uint32_t));
+    if (!replay_block || !replay_ref || !replay_install())
+    {
+        printf("--- GTE Replay: out of memory or more than %d opcodes ---\n", REPLAY_MAX_OPS);
+        goto out;
+    }
+
+    printf("--- GTE Replay (%s, %d commands) ---\n", pg_gte_replay, replay_count);
+    for (unsigned r = 0; r < sizeof(rows) / sizeof(rows[0]); r++)
+    {
+        int diffs;
+        double ops = replay_backend(rows[r].jit, rows[r].tier, &diffs);
+        if (r == 0)
+            base = ops;
+        printf("  %-9s %12.0f ops/sec", rows[r].name, ops);
+        if (r > 0 && base > 0.0)
+            printf("  (%.2fx interp, %d differ)", ops / base, diffs);
+        printf("\n");
+    }
+
+out:
+    gte_tier = saved_tier;
+    gte_use_vu0 = saved_vu0;
+#ifdef PLATFORM_PSP
+    gte_use_vfpu = saved_vfpu;
+#endif
+    free(replay_ref);
+    free(replay_block);
+    free(replay_recs);
+    replay_ref = NULL;
+    replay_block = NULL;
+    replay_recs = NULL;
+    printf("\n");
+}
@@ -0,0 +1,450 @@
+/*
+ * JIT Playground — Dynarec Microbenchmark Suite
+ *
+ * Compiles and runs a few canonical PSX code kernels through the real
+ * dynarec and reports, per kernel: blocks compiled, host time per block
+ * compile, native words per PSX instruction, and PSX cycles and host
+ * time per run.  Report only (no pass/fail, apart from a result check
+ * that catches a kernel the JIT got wrong); enabled with jit_bench=1 in
+ * the playground's superpsx.ini.
+ *
+ * Kernels return to BENCH_EXIT, outside RAM: the jump dispatch misses
+ * there and aborts to bench_run, so the halt loop's spin isn't counted
+ * in the run cycles.  Compile times are tier 0 (quick compile) of the
+ * blocks the first run compiled; run times are measured after that
+ * first run, with the blocks linked.
+ */
+#include "playground.h"
+#include "platform.h"
+#include <time.h>
+
+/* ---- Externs from dynarec ---- */
+extern uint32_t *dynarec_ensure_block(uint32_t pc, BlockEntry **out_be);
+extern BlockEntry *block_node_pool;
+extern int block_node_pool_idx;
+extern volatile uint32_t psx_abort_pc;
+extern uint64_t global_cycles;
+
+#define BENCH_EXIT          0x9F000000u /* phys 0x1F000000: beyond RAM */
+#define BENCH_BUDGET        0x40000000  /* cycles_left per run: never the limit */
+#define BENCH_RUNS          50
+#define BENCH_COMPILE_ROUNDS 200
+#define BENCH_MAX_BLOCKS    64
+
+int pg_jit_bench = 0;
+
+/* ---- Kernel emitter: labels are word pointers into PSX RAM ---- */
+static uint32_t *bp; /* next instruction */
+
+#define HERE() (bp)
+/* Branch offset from the instruction about to be emitted to label t */
+#define OFF(t) ((uint16_t)((int32_t)((t) - (bp + 1)) & 0xFFFF))
+/* Patch the branch at b (emitted with offset 0) to land here */
+#define PATCH(b) (*(b) |= (uint16_t)((int32_t)(bp - ((b) + 1)) & 0xFFFF))
+#define PSX_ADDR(ptr) (0x80000000u | (uint32_t)((uint8_t *)(ptr) - psx_ram))
+#define J_TO(ptr) PSX_J((PSX_ADDR(ptr) >> 2) & 0x03FFFFFFu)
+#define JAL_TO(ptr) PSX_JAL((PSX_ADDR(ptr) >> 2) & 0x03FFFFFFu)
+
+/* A function, so OFF() in the argument reads bp before the store */
+static void put(uint32_t op)
+{
+    *bp++ = op;
+}
+
+#define DATA(off) ((uint32_t *)(psx_ram + PG_DATA_OFFSET + (off)))
+#define DATA_ADDR(off) (PG_DATA_BASE + (off))
+
+typedef struct
+{
+    const char *name;
+    void (*emit)(void); /* code at PG_CODE_BASE */
+    void (*setup)(void); /* registers and data, before every run */
+    int (*check)(void); /* 1 = result as expected */
+} BenchKernel;
+
+/* ================================================================
+ *  memcpy: 1024 words, LW/SW with post-increment
+ * ================================================================ */
+#define MEMCPY_WORDS 1024
+
+static void memcpy_emit(void)
+{
+    uint32_t *loop = HERE();
+    put(PSX_LW(R_T0, 0, R_A0));
+    put(PSX_ADDIU(R_A0, R_A0, 4));
+    put(PSX_SW(R_T0, 0, R_A1));
+    put(PSX_ADDIU(R_A2, R_A2, -1));
+    put(PSX_BNE(R_A2, R_ZERO, OFF(loop)));
+    put(PSX_ADDIU(R_A1, R_A1, 4));
+    put(PSX_JR(R_RA));
+    put(PSX_NOP());
+}
+
+static void memcpy_setup(void)
+{
+    for (int i = 0; i < MEMCPY_WORDS; i++)
+    {
+        DATA(0)[i] = 0x9E3779B9u * (uint32_t)(i + 1);
+        DATA(0x4000)[i] = 0;
+    }
+    cpu.regs[R_A0] = DATA_ADDR(0);
+    cpu.regs[R_A1] = DATA_ADDR(0x4000);
+    cpu.regs[R_A2] = MEMCPY_WORDS;
+}
+
+static int memcpy_check(void)
+{
+    return memcmp(DATA(0), DATA(0x4000), MEMCPY_WORDS * 4) == 0;
+}
+
+/* ================================================================
+ *  GTE transform: 256 vertices, LWC2 / RTPS / SWC2
+ * ================================================================ */
+#define GTE_VERTS 256
+
+static void gte_emit(void)
+{
+    uint32_t *loop = HERE();
+    put(PSX_LWC2(GTE_VXY0, 0, R_A0));
+    put(PSX_LWC2(GTE_VZ0, 4, R_A0));
+    put(GTE_CMD_RTPS(1, 0));
+    put(PSX_ADDIU(R_A0, R_A0, 8));
+    put(PSX_SWC2(GTE_SXY2, 0, R_A1));
+    put(PSX_ADDIU(R_A2, R_A2, -1));
+    put(PSX_BNE(R_A2, R_ZERO, OFF(loop)));
+    put(PSX_ADDIU(R_A1, R_A1, 4));
+    put(PSX_JR(R_RA));
+    put(PSX_NOP());
+}
+
+static void gte_setup(void)
+{
+    cpu.cop0[PSX_COP0_SR_IDX] = (1u << 30) | (1u << 28);
+    cpu.cp2_ctrl[GTE_RT11RT12] = 0x1000;
+    cpu.cp2_ctrl[GTE_RT22RT23] = 0x1000;
+    cpu.cp2_ctrl[GTE_RT33]     = 0x1000;
+    cpu.cp2_ctrl[GTE_TRZ]      = 1000;
+    cpu.cp2_ctrl[GTE_OFX]      = 160 << 16;
+    cpu.cp2_ctrl[GTE_OFY]      = 120 << 16;
+    cpu.cp2_ctrl[GTE_H]        = 256;
+    PG_MARK_VU0_DIRTY();
+    for (int i = 0; i < GTE_VERTS; i++)
+    {
+        DATA(0)[i * 2]     = PACK_VXY(i - 128, 64 - (i & 127));
+        DATA(0)[i * 2 + 1] = (uint32_t)(200 + i);
+        DATA(0x4000)[i]    = 0;
+    }
+    cpu.regs[R_A0] = DATA_ADDR(0);
+    cpu.regs[R_A1] = DATA_ADDR(0x4000);
+    cpu.regs[R_A2] = GTE_VERTS;
+}
+
+static int gte_check(void)
+{
+    /* x=0, z=328 sits on the screen centre in X */
+    return (DATA(0x4000)[128] & 0xFFFF) == 160;
+}
+
+/* ================================================================
+ *  switch dispatch: 2048 iterations of a jump table over 8 cases
+ * ================================================================ */
+#define SWITCH_ITERS 2048
+#define SWITCH_TABLE 0x8000
+
+static void switch_emit(void)
+{
+    uint32_t *loop = HERE();
+    put(PSX_ANDI(R_T0, R_A0, 7));
+    put(PSX_SLL(R_T0, R_T0, 2));
+    put(PSX_ADDU(R_T0, R_T0, R_A1));
+    put(PSX_LW(R_T0, 0, R_T0));
+    put(PSX_NOP());
+    put(PSX_JR(R_T0));
+    put(PSX_NOP());
+
+    uint32_t *tail_jump[8];
+    for (int k = 0; k < 8; k++)
+    {
+        DATA(SWITCH_TABLE)[k] = PSX_ADDR(HERE());
+        put(PSX_ADDIU(R_V0, R_V0, k + 1));
+        tail_jump[k] = HERE();
+        put(PSX_NOP()); /* J tail, patched below */
+        put(PSX_XORI(R_V1, R_V1, k)); /* delay slot */
+    }
+    uint32_t *tail = HERE();
+    for (int k = 0; k < 8; k++)
+        *tail_jump[k] = J_TO(tail);
+    put(PSX_ADDIU(R_A0, R_A0, -1));
+    put(PSX_BNE(R_A0, R_ZERO, OFF(loop)));
+    put(PSX_NOP());
+    put(PSX_JR(R_RA));
+    put(PSX_NOP());
+}
+
+static void switch_setup(void)
+{
+    cpu.regs[R_A0] = SWITCH_ITERS;
+    cpu.regs[R_A1] = DATA_ADDR(SWITCH_TABLE);
+    cpu.regs[R_V0] = 0;
+    cpu.regs[R_V1] = 0;
+}
+
+static int switch_check(void)
+{
+    /* Each of the 8 cases runs SWITCH_ITERS / 8 times */
+    return cpu.regs[R_V0] == (SWITCH_ITERS / 8) * 36;
+}
+
+/* ================================================================
+ *  call-heavy recursion: fib(15), 1973 calls
+ * ================================================================ */
+#define FIB_N 15
+
+static void fib_emit(void)
+{
+    uint32_t *fib = HERE();
+    put(PSX_ADDIU(R_SP, R_SP, -12));
+    put(PSX_SW(R_RA, 0, R_SP));
+    put(PSX_SW(R_S0, 4, R_SP));
+    put(PSX_SW(R_A0, 8, R_SP));
+    put(PSX_SLTI(R_T0, R_A0, 2));
+    uint32_t *to_rec = HERE();
+    put(PSX_BEQ(R_T0, R_ZERO, 0));
+    put(PSX_NOP());
+    put(PSX_ADDU(R_V0, R_A0, R_ZERO));
+    uint32_t *to_out = HERE();
+    put(PSX_BEQ(R_ZERO, R_ZERO, 0));
+    put(PSX_NOP());
+
+    PATCH(to_rec);
+    put(PSX_ADDIU(R_A0, R_A0, -1));
+    put(JAL_TO(fib));
+    put(PSX_NOP());
+    put(PSX_ADDU(R_S0, R_V0, R_ZERO));
+    put(PSX_LW(R_A0, 8, R_SP));
+    put(PSX_NOP());
+    put(PSX_ADDIU(R_A0, R_A0, -2));
+    put(JAL_TO(fib));
+    put(PSX_NOP());
+    put(PSX_ADDU(R_V0, R_V0, R_S0));
+
+    PATCH(to_out);
+    put(PSX_LW(R_RA, 0, R_SP));
+    put(PSX_LW(R_S0, 4, R_SP));
+    put(PSX_ADDIU(R_SP, R_SP, 12));
+    put(PSX_JR(R_RA));
+    put(PSX_NOP());
+}
+
+static void fib_setup(void)
+{
+    cpu.regs[R_A0] = FIB_N;
+    cpu.regs[R_V0] = 0;
+}
+
+static int fib_check(void)
+{
+    return cpu.regs[R_V0] == 610;
+}
+
+/* ================================================================
+ *  OT build: ClearOTagR-style chain of 1024 entries, then 2048
+ *  primitives linked in by Z
+ * ================================================================ */
+#define OT_LEN   1024
+#define OT_PRIMS 2048
+#define OT_BASE  0x0000
+#define OT_PRIM  0x2000 /* 16 bytes: tag, z * 4, 2 words payload */
+
+static void ot_emit(void)
+{
+    /* t2 = 0x00FFFFFF; ot[0] = end marker, ot[i] = &ot[i - 1] */
+    put(PSX_LUI(R_T2, 0x00FF));
+    put(PSX_ORI(R_T2, R_T2, 0xFFFF));
+    put(PSX_SW(R_T2, 0, R_A0));
+    put(PSX_ADDIU(R_A1, R_A1, -1));
+    uint32_t *clear = HERE();
+    put(PSX_AND(R_T1, R_A0, R_T2));
+    put(PSX_SW(R_T1, 4, R_A0));
+    put(PSX_ADDIU(R_A1, R_A1, -1));
+    put(PSX_BNE(R_A1, R_ZERO, OFF(clear)));
+    put(PSX_ADDIU(R_A0, R_A0, 4));
+
+    /* prim->tag = len 3 | *slot; *slot = prim */
+    put(PSX_LUI(R_T6, 0x0300));
+    uint32_t *insert = HERE();
+    put(PSX_LW(R_T4, 4, R_A2));
+    put(PSX_NOP());
+    put(PSX_ADDU(R_T4, R_T4, R_A3));
+    put(PSX_LW(R_T5, 0, R_T4));
+    put(PSX_NOP());
+    put(PSX_AND(R_T5, R_T5, R_T2));
+    put(PSX_OR(R_T5, R_T5, R_T6));
+    put(PSX_SW(R_T5, 0, R_A2));
+    put(PSX_AND(R_T7, R_A2, R_T2));
+    put(PSX_SW(R_T7, 0, R_T4));
+    put(PSX_ADDIU(R_T3, R_T3, -1));
+    put(PSX_BNE(R_T3, R_ZERO, OFF(insert)));
+    put(PSX_ADDIU(R_A2, R_A2, 16));
+    put(PSX_JR(R_RA));
+    put(PSX_NOP());
+}
+
+static void ot_setup(void)
+{
+    for (int i = 0; i < OT_PRIMS; i++)
+    {
+        uint32_t *p = DATA(OT_PRIM) + i * 4;
+        p[0] = 0;
+        p[1] = (uint32_t)((i * 37) % OT_LEN) * 4;
+    }
+    cpu.regs[R_A0] = DATA_ADDR(OT_BASE);
+    cpu.regs[R_A1] = OT_LEN;
+    cpu.regs[R_A2] = DATA_ADDR(OT_PRIM);
+    cpu.regs[R_A3] = DATA_ADDR(OT_BASE);
+    cpu.regs[R_T3] = OT_PRIMS;
+}
+
+static int ot_check(void)
+{
+    /* The last prim at z = 0 heads ot[0]'s chain, ending at the marker */
+    uint32_t last = 0;
+    for (int i = 0; i < OT_PRIMS; i++)
+        if ((i * 37) % OT_LEN == 0)
+            last = (uint32_t)i;
+    return DATA(OT_BASE)[0] == (DATA_ADDR(OT_PRIM + last * 16) & 0x00FFFFFF) &&
+           (DATA(OT_PRIM)[0] & 0x00FFFFFF) == 0x00FFFFFF;
+}
+
+static const BenchKernel bench_kernels[] = {
+    {"memcpy", memcpy_emit, memcpy_setup, memcpy_check},
+    {"gte_xform", gte_emit, gte_setup, gte_check},
+    {"switch", switch_emit, switch_setup, switch_check},
+    {"fib_calls", fib_emit, fib_setup, fib_check},
+    {"ot_build", ot_emit, ot_setup, ot_check},
+};
+
+/* ================================================================
+ *  Runner
+ * ================================================================ */
+
+static void bench_reset_cpu(const BenchKernel *k)
+{
+    memset(&cpu, 0, sizeof(cpu));
+    cpu.regs[R_SP] = 0x801FFF00u;
+    cpu.regs[R_RA] = BENCH_EXIT;
+    cpu.cop0[PSX_COP0_SR_IDX] = (1u << 28);
+    k->setup();
+}
+
+/* Like pg_run_jit, but stops when the kernel returns to BENCH_EXIT
+ * and returns the PSX cycles it took */
+static uint32_t bench_run(void)
+{
+    cpu.cycles_left = BENCH_BUDGET;
+    cpu.initial_cycles_left = BENCH_BUDGET;
+    cpu.block_aborted = 0;
+    cpu.pc = PG_CODE_BASE;
+    global_cycles = 0;
+
+    while (cpu.cycles_left > 0 && (cpu.pc & 0x1FFFFFFF) < PSX_RAM_SIZE)
+    {
+        BlockEntry *be;
+        uint32_t *block = dynarec_ensure_block(cpu.pc, &be);
+        if (!block)
+            break;
+        if (jit_flush_pending)
+        {
+            Platform_FlushDCache(NULL, NULL);
+            Platform_FlushICache();
+            jit_flush_pending = 0;
+        }
+
+        int32_t remaining = ((block_func_t)block)(&cpu, psx_ram, psx_bios, cpu.cycles_left);
+        global_cycles += (uint32_t)(cpu.cycles_left - remaining);
+        cpu.cycles_left = remaining;
+
+        if (global_cycles >= sched_cached_earliest)
+            Sched_Tick(global_cycles);
+        if (cpu.block_aborted)
+        {
+            cpu.pc = psx_abort_pc;
+            cpu.block_aborted = 0;
+        }
+    }
+    return (uint32_t)global_cycles;
+}
+
+static void bench_kernel(const BenchKernel *k)
+{
+    uint32_t pcs[BENCH_MAX_BLOCKS];
+    int blocks = 0;
+    uint32_t psx_insns = 0, native_words = 0;
+
+    pg_reset_jit_cache();
+    memset(psx_ram + PG_CODE_OFFSET, 0, 0x1000);
+    bp = (uint32_t *)(psx_ram + PG_CODE_OFFSET);
+    k->emit();
+
+    /* Cold run: compiles every block the kernel reaches */
+    bench_reset_cpu(k);
+    bench_run();
+    int ok = k->check();
+    for (int i = 0; i < block_node_pool_idx && blocks < BENCH_MAX_BLOCKS; i++)
+    {
+        const BlockEntry *be = &block_node_pool[i];
+        if (!be->native)
+            continue;
+        pcs[blocks++] = be->psx_pc;
+        psx_insns += be->instr_count;
+        native_words += be->native_count;
+    }
+
+    /* Warm runs */
+    uint64_t cycles = 0;
+    clock_t t0 = clock();
+    for (int r = 0; r < BENCH_RUNS; r++)
+    {
+        bench_reset_cpu(k);
+        cycles += bench_run();
+    }
+    double run_secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    ok &= k->check();
+
+    /* Compile only: the same blocks, from an empty cache each round */
+    t0 = clock();
+    for (int r = 0; r < BENCH_COMPILE_ROUNDS; r++)
+    {
+        pg_reset_jit_cache();
+        for (int b = 0; b < blocks; b++)
+        {
+            BlockEntry *be;
+            dynarec_ensure_block(pcs[b], &be);
+        }
+    }
+    double compile_secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    double run_us = run_secs * 1e6 / BENCH_RUNS;
+    double psx_us = (double)cycles / BENCH_RUNS / 33.8688; /* real R3000A time */
+    printf("  %-10s %3d blk %7.2f us/blk %5.2fx %9lu cyc %9.1f us %6.2fx rt%s\n",
+           k->name, blocks,
+           blocks ? compile_secs * 1e6 / ((double)BENCH_COMPILE_ROUNDS * blocks) : 0.0,
+           psx_insns ? (double)native_words / psx_insns : 0.0,
+           (unsigned long)(cycles / BENCH_RUNS), run_us,
+           run_us > 0.0 ? psx_us / run_us : 0.0,
+           ok ? "" : "  [WRONG RESULT]");
+}
+
+void pg_run_jit_bench(void)
+{
+    if (!pg_jit_bench)
+        return;
+    printf("--- Dynarec Microbenchmarks (%d runs, %d compile rounds) ---\n",
+           BENCH_RUNS, BENCH_COMPILE_ROUNDS);
+    printf("  %-10s %7s %13s %6s %13s %12s %8s\n",
+           "kernel", "blocks", "compile", "expand", "cycles/run", "host/run", "speed");
+    for (size_t i = 0; i < sizeof(bench_kernels) / sizeof(bench_kernels[0]); i++)
+        bench_kernel(&bench_kernels[i]);
+    pg_reset_jit_cache();
+    printf("\n");
+}
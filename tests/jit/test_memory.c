@@ -1,8 +1,8 @@
 /*
  * JIT Playground — Memory Tests
  *
- * Covers: LW/SW, LB/SB, LH/SH, LWL/LWR, SWL/SWR, ISC.
- * 13 tests total.
+ * Covers: LW/SW, LB/SB, LH/SH, LWL/LWR, SWL/SWR, scratchpad, const I/O, ISC.
+ * 17 tests total.
  */
 #include "playground.h"
 
@@ -91,6 +91,180 @@ static void test_swl_swr(void)
     END_TEST();
 }
 
+/* Register-based scratchpad access: the base is not a block constant, so
+ * the RAM range check misses and the slow stub's scratchpad path runs */
+static void test_scratchpad_reg_base(void)
+{
+    BEGIN_TEST("scratchpad_reg_base");
+    memset(scratchpad_buf + 0x100, 0, 8);
+    SET_REG(R_T0, 0x1F800100);
+    SET_REG(R_V0, 0x8899AABB);
+    SET_REG(R_V1, 0x1234);
+    EMIT(PSX_SW(R_V0, 0, R_T0));
+    EMIT(PSX_SH(R_V1, 4, R_T0));
+    EMIT(PSX_LW(R_A0, 0, R_T0));
+    EMIT(PSX_LB(R_A1, 1, R_T0));
+    EMIT(PSX_LHU(R_A2, 4, R_T0));
+    RUN(2000);
+    EXPECT_REG(R_A0, 0x8899AABB);
+    EXPECT_REG(R_A1, 0xFFFFFFAA);
+    EXPECT_REG(R_A2, 0x1234);
+    if (*(uint32_t *)(scratchpad_buf + 0x100) != 0x8899AABB)
+    {
+        printf("  [FAIL] %s: scratchpad word = 0x%08X\n", pg_ctx.name,
+               (unsigned)*(uint32_t *)(scratchpad_buf + 0x100));
+        pg_ctx.fail_count++;
+    }
+    END_TEST();
+}
+
+/* Run of const-address stores off one base: the host base is shared,
+ * aligned SW $zero pairs become one SD on the EE, and the unpaired and
+ * narrow stores in between still land */
+static void test_const_store_run(void)
+{
+    BEGIN_TEST("const_store_run");
+    for (int i = 0; i < 8; i++)
+        SET_MEM32(PG_DATA_OFFSET + i * 4, 0xFFFFFFFF);
+    EMIT(PSX_LUI(R_T0, 0x8002));
+    SET_REG(R_V0, 0x13579BDF);
+    EMIT(PSX_SW(R_ZERO, 0, R_T0));
+    EMIT(PSX_SW(R_ZERO, 4, R_T0));
+    EMIT(PSX_SW(R_V0, 8, R_T0));
+    EMIT(PSX_SH(R_V0, 14, R_T0));
+    EMIT(PSX_SW(R_ZERO, 20, R_T0));
+    EMIT(PSX_SW(R_ZERO, 24, R_T0));
+    EMIT(PSX_SW(R_ZERO, 16, R_T0));
+    RUN(2000);
+    EXPECT_MEM32(PG_DATA_OFFSET + 0, 0);
+    EXPECT_MEM32(PG_DATA_OFFSET + 4, 0);
+    EXPECT_MEM32(PG_DATA_OFFSET + 8, 0x13579BDF);
+    EXPECT_MEM32(PG_DATA_OFFSET + 12, 0x9BDFFFFF);
+    EXPECT_MEM32(PG_DATA_OFFSET + 16, 0);
+    EXPECT_MEM32(PG_DATA_OFFSET + 20, 0);
+    EXPECT_MEM32(PG_DATA_OFFSET + 24, 0);
+    EXPECT_MEM32(PG_DATA_OFFSET + 28, 0xFFFFFFFF);
+    END_TEST();
+}
+
+/* Const-address I/O goes straight to the register's dispatch-table
+ * handler: reads are narrowed like ReadHalf, halfword data is masked */
+static void test_const_io_handler(void)
+{
+    BEGIN_TEST("const_io_handler");
+    pg_reset_hw_log();
+    pg_set_hw_read_value(0xABCD1234);
+    SET_REG(R_V0, 0x12345678);
+    EMIT(PSX_LUI(R_T0, 0x1F80));
+    EMIT(PSX_LHU(R_A0, 0x1100, R_T0));
+    EMIT(PSX_LW(R_A1, 0x1104, R_T0));
+    EMIT(PSX_SH(R_V0, 0x1108, R_T0));
+    RUN(2000);
+    EXPECT_REG(R_A0, 0x1234);
+    EXPECT_REG(R_A1, 0xABCD1234);
+    if (pg_get_hw_read_count() != 2 || pg_get_hw_read_addr(0) != 0x1F801100 ||
+        pg_get_hw_write_count() != 1 || pg_get_hw_write_addr(0) != 0x1F801108 ||
+        pg_get_hw_write_data(0) != 0x5678)
+    {
+        printf("  [FAIL] %s: hw log reads=%d writes=%d data=0x%08X\n", pg_ctx.name,
+               pg_get_hw_read_count(), pg_get_hw_write_count(),
+               (unsigned)pg_get_hw_write_data(0));
+        pg_ctx.fail_count++;
+    }
+    pg_reset_hw_log();
+    END_TEST();
+}
+
+/* BIOS library HLE: memcpy through the A0 table, then an InitHeap /
+ * malloc / free / malloc round trip reusing the freed block */
+static void test_bios_hle_library(void)
+{
+    BEGIN_TEST("bios_hle_library");
+    for (int i = 0; i < 8; i++)
+        SET_MEM32(PG_DATA_OFFSET + i * 4, 0xA5000000u + i);
+    SET_REG(R_A0, PG_DATA_BASE + 0x100);
+    SET_REG(R_A1, PG_DATA_BASE);
+    SET_REG(R_A2, 32);
+    SET_REG(R_RA, PG_HALT_BASE);
+    uint32_t cyc = BIOS_HLE_Library(0xA0, 0x2A);
+    if (cyc < 32 * 100 || cpu.pc != PG_HALT_BASE)
+    {
+        printf("  [FAIL] %s: memcpy cycles=%u pc=0x%08X\n", pg_ctx.name, (unsigned)cyc,
+               (unsigned)cpu.pc);
+        pg_ctx.fail_count++;
+    }
+    EXPECT_REG(R_V0, PG_DATA_BASE + 0x100);
+    EXPECT_MEM32(PG_DATA_OFFSET + 0x11C, 0xA5000007u);
+
+    SET_REG(R_A0, PG_DATA_BASE + 0x1000);
+    SET_REG(R_A1, 0x1000);
+    BIOS_HLE_Library(0xA0, 0x39); /* InitHeap */
+    SET_REG(R_A0, 10);
+    BIOS_HLE_Library(0xA0, 0x33); /* malloc(10) -> 12 bytes */
+    uint32_t first = cpu.regs[R_V0];
+    SET_REG(R_A0, 16);
+    BIOS_HLE_Library(0xA0, 0x33);
+    uint32_t second = cpu.regs[R_V0];
+    SET_REG(R_A0, first);
+    BIOS_HLE_Library(0xA0, 0x34); /* free(first) */
+    SET_REG(R_A0, 8);
+    BIOS_HLE_Library(0xA0, 0x33);
+    if (first != PG_DATA_BASE + 0x1004 || second != first + 16 || cpu.regs[R_V0] != first)
+    {
+        printf("  [FAIL] %s: heap first=0x%08X second=0x%08X reuse=0x%08X\n", pg_ctx.name,
+               (unsigned)first, (unsigned)second, (unsigned)cpu.regs[R_V0]);
+        pg_ctx.fail_count++;
+    }
+    END_TEST();
+}
+
+/* Critical sections through SYSCALL: handled on the handler hashed by
+ * BIOS_HLE_KernelReady, handed back to the exception once it changes */
+static void test_bios_hle_syscall(void)
+{
+    BEGIN_TEST("bios_hle_syscall");
+    uint32_t save[4 + 64];
+    memcpy(save, psx_ram + 0x80, 16);
+    memcpy(save + 4, psx_ram + 0xC80, 256);
+    SET_MEM32(0x80, 0x3C1A0000); /* lui   k0, 0 */
+    SET_MEM32(0x84, 0x275A0C80); /* addiu k0, k0, 0x0C80 */
+    SET_MEM32(0x88, 0x03400008); /* jr    k0 */
+    SET_MEM32(0x8C, 0x00000000);
+    for (int i = 0; i < 64; i++)
+        SET_MEM32(0xC80 + i * 4, 0x24000000u + i);
+    BIOS_HLE_KernelReady();
+
+    SET_MEM32(PG_CODE_OFFSET, 0x00000000); /* nop before the SYSCALL */
+    SET_COP0(PSX_COP0_SR, 0x00000401);
+    SET_REG(R_A0, 1);
+    uint32_t cyc = BIOS_HLE_Syscall(PG_CODE_BASE + 4);
+    EXPECT_REG(R_V0, 1);
+    if (!cyc || cpu.pc != PG_CODE_BASE + 8 || GET_COP0(PSX_COP0_SR) != 0)
+    {
+        printf("  [FAIL] %s: enter cycles=%u pc=0x%08X sr=0x%08X\n", pg_ctx.name,
+               (unsigned)cyc, (unsigned)cpu.pc, (unsigned)GET_COP0(PSX_COP0_SR));
+        pg_ctx.fail_count++;
+    }
+    SET_REG(R_A0, 2);
+    BIOS_HLE_Syscall(PG_CODE_BASE + 4);
+    if (GET_COP0(PSX_COP0_SR) != 0x00000401)
+    {
+        printf("  [FAIL] %s: exit sr=0x%08X\n", pg_ctx.name, (unsigned)GET_COP0(PSX_COP0_SR));
+        pg_ctx.fail_count++;
+    }
+    SET_MEM32(0xC80, 0x08000000); /* patched kernel */
+    if (BIOS_HLE_Syscall(PG_CODE_BASE + 4) != 0)
+    {
+        printf("  [FAIL] %s: patched handler still handled\n", pg_ctx.name);
+        pg_ctx.fail_count++;
+    }
+
+    memcpy(psx_ram + 0x80, save, 16);
+    memcpy(psx_ram + 0xC80, save + 4, 256);
+    BIOS_HLE_KernelReady();
+    END_TEST();
+}
+
 /* ================================================================
  *  ISC (Cache Isolation) Tests
  *
@@ -257,6 +431,11 @@ void pg_run_memory_tests(void)
     test_sw_lw_offset();
     test_lwl_lwr();
     test_swl_swr();
+    test_scratchpad_reg_base();
+    test_const_store_run();
+    test_const_io_handler();
+    test_bios_hle_library();
+    test_bios_hle_syscall();
 
     printf("\n--- ISC (Cache Isolation) ---\n");
     test_mfc0_read_sr();
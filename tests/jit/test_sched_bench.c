@@ -0,0 +1,201 @@
+/*
+ * JIT Playground — Scheduler Benchmark
+ *
+ * Drives the heap scheduler in scheduler.h and a copy of the linear-scan
+ * scheduler it replaced with the same event mix: every slot periodic
+ * (timers, HBlank, SPU...), plus a remove / re-add every few dispatches
+ * like a cancelled CD-ROM or DMA event.  Reports dispatches per second
+ * for both and checks that they fire events in the same order.  Report
+ * only (no pass/fail); enabled with sched_bench=1 in the playground's
+ * superpsx.ini.
+ */
+#include "playground.h"
+#include <time.h>
+
+#define BENCH_DISPATCHES 2000000
+
+int pg_sched_bench = 0;
+
+/* ---- Linear-scan reference (the previous scheduler.h) ---- */
+static int lin_active[SCHED_EVENT_COUNT];
+static uint64_t lin_deadline[SCHED_EVENT_COUNT];
+static sched_callback_t lin_callback[SCHED_EVENT_COUNT];
+static uint64_t lin_cached_earliest = UINT64_MAX;
+static int lin_earliest_id = -1;
+
+static void lin_recompute_cached(void)
+{
+    uint64_t earliest = UINT64_MAX;
+    int earliest_id = -1;
+    for (int i = 0; i < SCHED_EVENT_COUNT; i++)
+    {
+        if (lin_active[i] && lin_deadline[i] < earliest)
+        {
+            earliest = lin_deadline[i];
+            earliest_id = i;
+        }
+    }
+    lin_cached_earliest = earliest;
+    lin_earliest_id = earliest_id;
+}
+
+static void lin_add(int event_id, uint64_t absolute_cycle, sched_callback_t cb)
+{
+    int was_earliest = (event_id == lin_earliest_id);
+
+    lin_active[event_id] = 1;
+    lin_deadline[event_id] = absolute_cycle;
+    lin_callback[event_id] = cb;
+
+    if (absolute_cycle <= lin_cached_earliest)
+    {
+        lin_cached_earliest = absolute_cycle;
+        lin_earliest_id = event_id;
+    }
+    else if (was_earliest)
+        lin_recompute_cached();
+}
+
+static void lin_remove(int event_id)
+{
+    int was_earliest = (event_id == lin_earliest_id);
+    lin_active[event_id] = 0;
+    if (was_earliest)
+        lin_recompute_cached();
+}
+
+static void lin_tick(uint64_t current_cycle)
+{
+    int needed_recompute = 0;
+    for (int i = 0; i < SCHED_EVENT_COUNT; i++)
+    {
+        if (lin_active[i] && lin_deadline[i] <= current_cycle)
+        {
+            if (i == lin_earliest_id)
+                needed_recompute = 1;
+            int ticks_late = (int)(current_cycle - lin_deadline[i]);
+            lin_active[i] = 0;
+            if (lin_callback[i])
+                lin_callback[i](ticks_late);
+        }
+    }
+    if (needed_recompute)
+        lin_recompute_cached();
+}
+
+/* ---- Heap scheduler, behind the same interface ---- */
+static void heap_add(int event_id, uint64_t absolute_cycle, sched_callback_t cb)
+{
+    Sched_Add(event_id, absolute_cycle, cb);
+}
+
+static void heap_remove(int event_id)
+{
+    Sched_Remove(event_id);
+}
+
+/* ---- Workload ---- */
+static void (*bench_add)(int, uint64_t, sched_callback_t);
+static void (*bench_remove)(int);
+static uint64_t bench_now;
+static uint32_t bench_period[SCHED_EVENT_COUNT];
+static uint32_t bench_fired;
+static uint32_t bench_order; /* hash of the dispatch sequence */
+static uint32_t bench_rng;
+static sched_callback_t bench_cb[32];
+
+static uint32_t bench_rand(void)
+{
+    bench_rng = bench_rng * 1103515245u + 12345u;
+    return bench_rng >> 8;
+}
+
+static void bench_fire(int id)
+{
+    bench_fired++;
+    bench_order = (bench_order ^ (uint32_t)id) * 16777619u;
+    bench_add(id, bench_now + bench_period[id], bench_cb[id]);
+    if ((bench_fired & 7) == 0)
+    {
+        int other = (int)(bench_rand() % SCHED_EVENT_COUNT);
+        if (other != id)
+        {
+            bench_remove(other);
+            bench_add(other, bench_now + 1 + bench_rand() % 4096, bench_cb[other]);
+        }
+    }
+}
+
+#define BENCH_CB(n) static void bench_cb_##n(int late) { (void)late; bench_fire(n); }
+BENCH_CB(0)  BENCH_CB(1)  BENCH_CB(2)  BENCH_CB(3)  BENCH_CB(4)  BENCH_CB(5)
+BENCH_CB(6)  BENCH_CB(7)  BENCH_CB(8)  BENCH_CB(9)  BENCH_CB(10) BENCH_CB(11)
+BENCH_CB(12) BENCH_CB(13) BENCH_CB(14) BENCH_CB(15) BENCH_CB(16) BENCH_CB(17)
+BENCH_CB(18) BENCH_CB(19) BENCH_CB(20) BENCH_CB(21) BENCH_CB(22) BENCH_CB(23)
+BENCH_CB(24) BENCH_CB(25) BENCH_CB(26) BENCH_CB(27) BENCH_CB(28) BENCH_CB(29)
+BENCH_CB(30) BENCH_CB(31)
+
+#if SCHED_EVENT_COUNT > 32
+#error "test_sched_bench.c: add BENCH_CB stubs for the new event slots"
+#endif
+
+/* Returns dispatches per second; *order gets the sequence hash */
+static double bench_run(int heap, uint32_t *order)
+{
+    static sched_callback_t cbs[32] = {
+        bench_cb_0,  bench_cb_1,  bench_cb_2,  bench_cb_3,  bench_cb_4,  bench_cb_5,
+        bench_cb_6,  bench_cb_7,  bench_cb_8,  bench_cb_9,  bench_cb_10, bench_cb_11,
+        bench_cb_12, bench_cb_13, bench_cb_14, bench_cb_15, bench_cb_16, bench_cb_17,
+        bench_cb_18, bench_cb_19, bench_cb_20, bench_cb_21, bench_cb_22, bench_cb_23,
+        bench_cb_24, bench_cb_25, bench_cb_26, bench_cb_27, bench_cb_28, bench_cb_29,
+        bench_cb_30, bench_cb_31};
+
+    memcpy(bench_cb, cbs, sizeof(bench_cb));
+    Sched_Init();
+    memset(lin_active, 0, sizeof(lin_active));
+    lin_cached_earliest = UINT64_MAX;
+    lin_earliest_id = -1;
+
+    bench_add = heap ? heap_add : lin_add;
+    bench_remove = heap ? heap_remove : lin_remove;
+    bench_now = 0;
+    bench_fired = 0;
+    bench_order = 2166136261u;
+    bench_rng = 1;
+    for (int i = 0; i < SCHED_EVENT_COUNT; i++)
+    {
+        bench_period[i] = 500 + bench_rand() % 50000;
+        bench_add(i, bench_period[i], bench_cb[i]);
+    }
+
+    clock_t t0 = clock();
+    while (bench_fired < BENCH_DISPATCHES)
+    {
+        bench_now = heap ? sched_cached_earliest : lin_cached_earliest;
+        if (heap)
+            Sched_Tick(bench_now);
+        else
+            lin_tick(bench_now);
+    }
+    double secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    Sched_Init();
+    *order = bench_order;
+    return (secs > 0.0) ? (double)bench_fired / secs : 0.0;
+}
+
+void pg_run_sched_bench(void)
+{
+    uint32_t lin_order, heap_order;
+
+    if (!pg_sched_bench)
+        return;
+    printf("--- Scheduler Benchmark (%d slots, %d dispatches) ---\n",
+           SCHED_EVENT_COUNT, BENCH_DISPATCHES);
+    double lin = bench_run(0, &lin_order);
+    double heap = bench_run(1, &heap_order);
+    printf("  linear %12.0f dispatches/sec\n", lin);
+    printf("  heap   %12.0f dispatches/sec", heap);
+    if (lin > 0.0)
+        printf("  (%.2fx linear)", heap / lin);
+    printf("\n  dispatch order %s\n\n", lin_order == heap_order ? "matches" : "DIFFERS");
+}
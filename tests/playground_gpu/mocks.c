@@ -23,10 +23,10 @@ int fb_width = 640;
 int fb_height = 448;
 int fb_psm = 2; // GS_PSM_16S
 
-unsigned __int128 gif_packet_buf[2][GIF_BUFFER_SIZE];
+unsigned __int128 gif_packet_buf[GIF_RING_SEGMENTS][GIF_BUFFER_SIZE];
 gif_qword_t *fast_gif_ptr = NULL;
+gif_qword_t *gif_buffer_start = NULL;
 gif_qword_t *gif_buffer_end_safe = NULL;
-int current_buffer = 0;
 
 /* Real buffer for mock GIF writes (avoids MMIO writes to VIF0 FIFO) */
 static unsigned __int128 mock_gif_storage[GIF_BUFFER_SIZE];
@@ -105,6 +105,9 @@ int sched_earliest_id = 0;
 int sched_active[SCHED_EVENT_COUNT];
 uint64_t sched_deadline[SCHED_EVENT_COUNT];
 sched_callback_t sched_callback[SCHED_EVENT_COUNT];
+uint8_t sched_heap[SCHED_EVENT_COUNT];
+uint8_t sched_heap_pos[SCHED_EVENT_COUNT];
+int sched_heap_size = 0;
 
 /* --- MOCKS --- */
 
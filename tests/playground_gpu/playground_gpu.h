@@ -215,6 +215,7 @@ void gp_run_vram_tests(void);
 void gp_run_dma_block_tests(void);
 void gp_run_deferred_tests(void);
 void gp_run_texcache_tests(void);
+void gp_run_bench_tests(void);
 
 /* ================================================================
  *  GIF Capture Validation Macros
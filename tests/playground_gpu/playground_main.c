@@ -29,7 +29,7 @@ void gp_reset_state(void)
     gpu_stat = 0x14802000;
     gpu_read = 0;
     
-    current_buffer = 0;
+    gif_buffer_start = MOCK_GIF_BUFFER_START;
     fast_gif_ptr = MOCK_GIF_BUFFER_START;
     gif_buffer_end_safe = (gif_qword_t *)(MOCK_GIF_BUFFER_START + 2000);
 
@@ -82,6 +82,7 @@ int main(void)
     gp_run_dma_block_tests();
     gp_run_deferred_tests();
     gp_run_texcache_tests();
+    gp_run_bench_tests();
 
     printf("\n====================================================================\n");
     printf("Test Results: %d passed, %d failed (Total %d)\n",
@@ -0,0 +1,195 @@
+/*
+ * GPU Playground — Backend Benchmark Suite
+ *
+ * Feeds a few canonical frame shapes through GPU_ProcessDmaBlock and
+ * reports, per scenario: GIF qwords per primitive, GS state registers
+ * written and elided by the lazy gs_state, texture cache hit rate, and
+ * EE time per primitive.  Report only; a scenario fails just when its
+ * measured pass neither queued GIF data nor loaded VRAM.
+ *
+ * Each scenario is built once into bench_words and played twice: the
+ * first pass uploads its texture pages, the second (measured) pass is
+ * the next frame with the page cache warm, as a game would see it.
+ * The measured time includes the mock Flush_GIF, so it is an upper
+ * bound on the translation cost.
+ */
+#include "playground_gpu.h"
+#include <string.h>
+
+extern uint32_t vram_gen_counter;
+extern void Tex_Cache_Init(void);
+
+#define BENCH_EE_MHZ     294.912f
+#define BENCH_MAX_WORDS  40000 /* FMV: 38400 pixel words + 3 */
+
+#define BENCH_SPRITES    1000
+#define BENCH_TRIS       3000
+#define BENCH_TRI_PAGES  8
+#define BENCH_CLUT_QUADS 1000
+#define BENCH_CLUT_ROWS  32
+
+#define BENCH_FMV_W      320
+#define BENCH_FMV_H      240
+
+static uint32_t bench_words[BENCH_MAX_WORDS];
+static int bench_count;
+
+static void put(uint32_t w)
+{
+    bench_words[bench_count++] = w;
+}
+
+#define XY(x, y) (((uint32_t)(x) & 0xFFFF) | ((uint32_t)(y) << 16))
+#define UV(u, v) (((uint32_t)(u) & 0xFF) | (((uint32_t)(v) & 0xFF) << 8))
+#define CLUT_W(cx, cy) ((((cx) / 16) & 0x3F) | (((cy) & 0x1FF) << 6))
+#define TPAGE_W(tx, fmt) (((tx) & 0xF) | ((fmt) << 7))
+
+/* 4BPP pages at tx * 64 on the top row, CLUT rows from y = 480 */
+static void bench_setup_pages(int first_tx, int pages)
+{
+    for (int row = 0; row < BENCH_CLUT_ROWS; row++)
+        for (int i = 0; i < 16; i++)
+            psx_vram_shadow[(480 + row) * 1024 + i] = (uint16_t)(0x0400 * row + i + 1);
+    for (int p = 0; p < pages; p++)
+    {
+        int px = (first_tx + p) * 64;
+        for (int y = 0; y < 256; y++)
+            for (int x = 0; x < 64; x++)
+                psx_vram_shadow[y * 1024 + px + x] = (uint16_t)(x * 3 + y + p);
+    }
+    vram_gen_counter++;
+    Tex_Cache_DirtyRegion(0, 0, 1024, 512);
+}
+
+/* ================================================================
+ *  Scenarios
+ * ================================================================ */
+
+/* 2D frame: background fill, then 16x16 sprites from a tile page and
+ * a font page, switching every 100 sprites */
+static int build_sprites(void)
+{
+    bench_setup_pages(5, 2);
+    put(0x02000000);
+    put(XY(0, 0));
+    put(XY(320, 240));
+    for (int i = 0; i < BENCH_SPRITES; i++)
+    {
+        if (i % 100 == 0)
+            put(0xE1000000 | TPAGE_W(5 + (i / 100) % 2, 0));
+        put(0x7C808080);
+        put(XY((i * 16) % 320, ((i / 20) * 16) % 240));
+        put(UV((i % 16) * 16, ((i / 16) % 16) * 16) | (CLUT_W(0, 480) << 16));
+    }
+    return BENCH_SPRITES + 1;
+}
+
+/* 3D frame: gouraud textured triangles over 8 pages, drawn in runs of
+ * 25 per page the way a sorted ordering table would leave them */
+static int build_tris(void)
+{
+    bench_setup_pages(5, BENCH_TRI_PAGES);
+    for (int i = 0; i < BENCH_TRIS; i++)
+    {
+        int page = 5 + (i / 25) % BENCH_TRI_PAGES;
+        int x = (i * 7) % 280, y = (i * 13) % 200;
+        put(0x34000000 | (0x404040 + (i & 0x3F)));
+        put(XY(x, y));
+        put(UV(0, 0) | (CLUT_W(0, 480 + (i / 25) % 4) << 16));
+        put(0x606060);
+        put(XY(x + 40, y + 4));
+        put(UV(63, 0) | (TPAGE_W(page, 0) << 16));
+        put(0x808080);
+        put(XY(x + 8, y + 36));
+        put(UV(0, 63));
+    }
+    return BENCH_TRIS;
+}
+
+/* FMV: a full 320x240 15BPP frame through GP0(A0), as MDEC output is */
+static int build_fmv(void)
+{
+    put(0xA0000000);
+    put(XY(0, 0));
+    put(XY(BENCH_FMV_W, BENCH_FMV_H));
+    for (int i = 0; i < BENCH_FMV_W * BENCH_FMV_H / 2; i++)
+        put(0x7FFF0000u ^ (uint32_t)(i * 0x00010001u));
+    return 1;
+}
+
+/* CLUT thrash: one 4BPP page, palette changed on every quad */
+static int build_clut_thrash(void)
+{
+    bench_setup_pages(5, 1);
+    for (int i = 0; i < BENCH_CLUT_QUADS; i++)
+    {
+        int x = (i * 16) % 304, y = ((i / 19) * 16) % 224;
+        put(0x2C808080);
+        put(XY(x, y));
+        put(UV(0, 0) | (CLUT_W(0, 480 + i % BENCH_CLUT_ROWS) << 16));
+        put(XY(x + 16, y));
+        put(UV(15, 0) | (TPAGE_W(5, 0) << 16));
+        put(XY(x, y + 16));
+        put(UV(0, 15));
+        put(XY(x + 16, y + 16));
+        put(UV(15, 15));
+    }
+    return BENCH_CLUT_QUADS;
+}
+
+/* ================================================================
+ *  Runner
+ * ================================================================ */
+
+static void bench_run(const char *name, int (*build)(void))
+{
+    BEGIN_GPU_TEST(name);
+    Tex_Cache_Init();
+    bench_count = 0;
+    int prims = build();
+
+    /* Pass 1: cold page cache, not measured */
+    GPU_ProcessDmaBlock(bench_words, bench_count);
+    Prim_FlushBatch();
+    Flush_GIF();
+    gp_gif_reset_counter();
+    memset(&gpu_frame_stats, 0, sizeof(gpu_frame_stats));
+
+    /* Pass 2: the next frame */
+    uint32_t cycles, insns;
+    perf_start();
+    GPU_ProcessDmaBlock(bench_words, bench_count);
+    Prim_FlushBatch();
+    Flush_GIF();
+    perf_stop(&cycles, &insns);
+
+    uint32_t qw = gp_ctx.qwords_generated;
+    uint32_t hits = gpu_frame_stats.texcache_hit;
+    uint32_t lookups = hits + gpu_frame_stats.texcache_miss;
+    uint32_t written = gpu_frame_stats.gs_state_written;
+    uint32_t skipped = gpu_frame_stats.gs_state_skipped;
+
+    printf("  %-12s %5d %8.2f %7u %7u %6.1f%% %9.1f\n",
+           name, prims, (float)qw / prims, (unsigned)written, (unsigned)skipped,
+           lookups ? 100.0f * hits / lookups : 0.0f,
+           (float)cycles * 1000.0f / BENCH_EE_MHZ / prims);
+
+    if (qw == 0 && gpu_frame_stats.vram_load == 0)
+    {
+        printf("  [FAIL] %-16s: no GIF output or VRAM load\n", name);
+        gp_ctx.fail_count++;
+    }
+    END_GPU_TEST();
+}
+
+void gp_run_bench_tests(void)
+{
+    printf("--- GPU Backend Benchmarks (warm pass) ---\n");
+    printf("  %-12s %5s %8s %7s %7s %7s %9s\n",
+           "scenario", "prims", "qw/prim", "st_wr", "st_skip", "tc_hit", "ns/prim");
+    bench_run("sprites_2d", build_sprites);
+    bench_run("tris_8page", build_tris);
+    bench_run("fmv_upload", build_fmv);
+    bench_run("clut_thrash", build_clut_thrash);
+    printf("\n");
+}
@@ -14,6 +14,7 @@
 #include "playground_gpu.h"
 #include <string.h>
 #include <gs_gp.h>
+#include "fast_copy.h"
 
 extern uint32_t vram_gen_counter;
 extern void Tex_Cache_Init(void);
@@ -37,6 +38,18 @@ static void setup_page(int format, int page_px, int page_py,
             psx_vram_shadow[(page_py + y) * 1024 + page_px + x] = (uint16_t)(x + y);
 }
 
+/* Overwrite rows of page data (new contents) and dirty them, as a
+ * LoadImage would.  Rows with unchanged contents are skipped by the
+ * content hash, so the partial-upload tests really change the data. */
+static void rewrite_rows(int page_px, int y, int hw, int h)
+{
+    for (int r = y; r < y + h; r++)
+        for (int x = 0; x < hw; x++)
+            psx_vram_shadow[r * 1024 + page_px + x] ^= 0x5A5A;
+    vram_gen_counter++;
+    Tex_Cache_DirtyRegion(page_px, y, hw, h);
+}
+
 /* Emit texpage E1 + textured quad (0x2C) at the given page/clut.
  * page_tx is in 64-halfword page units (page_px / 64). */
 static void tc_emit_textured_quad(int format, int page_tx, int page_ty,
@@ -85,8 +98,7 @@ static void test_partial_4bpp_small(void)
     gp_gif_reset_counter();
 
     /* Dirty only 16 rows at top of page (1 block-row) */
-    vram_gen_counter++;
-    Tex_Cache_DirtyRegion(page_px, 0, 64, 16);
+    rewrite_rows(page_px, 0, 64, 16);
 
     /* 2nd draw: should detect partial dirty → upload only 16 rows */
     tc_emit_textured_quad(0, page_tx, 0, 0, 480);
@@ -131,8 +143,7 @@ static void test_partial_8bpp_small(void)
     gp_gif_reset_counter();
 
     /* Dirty only 16 rows at bottom of page */
-    vram_gen_counter++;
-    Tex_Cache_DirtyRegion(page_px, 240, 128, 16);
+    rewrite_rows(page_px, 240, 128, 16);
 
     /* 2nd draw: partial upload */
     tc_emit_textured_quad(1, page_tx, 0, 0, 480);
@@ -257,8 +268,7 @@ static void test_dma_overlap(void)
     gp_gif_reset_counter();
 
     /* Simulate DMA upload that overlaps page at (0,0) */
-    vram_gen_counter++;
-    Tex_Cache_DirtyRegion(0, 0, 64, 16);
+    rewrite_rows(0, 0, 64, 16);
 
     /* 2nd draw: MISS expected → TEXFLUSH present */
     tc_emit_textured_quad(0, page_tx, 0, 0, 480);
@@ -293,10 +303,8 @@ static void test_partial_multi_range(void)
     gp_gif_reset_counter();
 
     /* Dirty 2 non-contiguous ranges: rows 0-15 and 240-255 */
-    vram_gen_counter++;
-    Tex_Cache_DirtyRegion(page_px, 0, 64, 16);
-    vram_gen_counter++;
-    Tex_Cache_DirtyRegion(page_px, 240, 64, 16);
+    rewrite_rows(page_px, 0, 64, 16);
+    rewrite_rows(page_px, 240, 64, 16);
 
     /* 2nd draw: partial upload of 2 ranges (32 rows out of 256) */
     tc_emit_textured_quad(0, page_tx, 0, 0, 480);
@@ -442,6 +450,146 @@ static void test_other_page_write(void)
     END_GPU_TEST();
 }
 
+/* ================================================================
+ *  TC10: Page rewritten with identical contents → no re-upload
+ *
+ *  Streamed textures are often re-sent unchanged.  The page is
+ *  dirtied without changing a byte; the content hash must skip the
+ *  upload (only the primitive itself is emitted).
+ * ================================================================ */
+static void test_same_content_rewrite(void)
+{
+    BEGIN_GPU_TEST("tc10_same_data");
+
+    Tex_Cache_Init();
+    int page_tx = 5;
+    int page_px = page_tx * 64;
+
+    setup_page(0, page_px, 0, 0, 480);
+    vram_gen_counter++;
+    Tex_Cache_DirtyRegion(page_px, 0, 64, 256);
+
+    tc_emit_textured_quad(0, page_tx, 0, 0, 480);
+    Flush_GIF();
+    uint32_t full_qws = gp_ctx.qwords_generated;
+    gp_gif_reset_counter();
+
+    /* Whole page dirtied, same data */
+    setup_page(0, page_px, 0, 0, 480);
+    vram_gen_counter++;
+    Tex_Cache_DirtyRegion(page_px, 0, 64, 256);
+
+    tc_emit_textured_quad(0, page_tx, 0, 0, 480);
+    Flush_GIF();
+    uint32_t same_qws = gp_ctx.qwords_generated;
+
+    /* A 16-row partial upload alone is ~134 QWs */
+    if (same_qws > 0 && same_qws < 100) {
+        printf("    %-16s: same=%u full=%u OK\n",
+               gp_ctx.name, (unsigned)same_qws, (unsigned)full_qws);
+    } else {
+        printf("  [FAIL] %-16s: same=%u NOT < 100 (full=%u)\n",
+               gp_ctx.name, (unsigned)same_qws, (unsigned)full_qws);
+        gp_ctx.fail_count++;
+    }
+
+    END_GPU_TEST();
+}
+
+/* ================================================================
+ *  TC11: 8BPP glyph write in one dirty-block column → half-width upload
+ *
+ *  Only the right 64-halfword column of one block-row changes.
+ *  16 rows × 128 pixels = 128 QWs, vs 256 QWs for the full width.
+ * ================================================================ */
+static void test_partial_8bpp_column(void)
+{
+    BEGIN_GPU_TEST("tc11_8bp_col");
+
+    Tex_Cache_Init();
+    int page_tx = 5;
+    int page_px = page_tx * 64;
+
+    setup_page(1, page_px, 0, 0, 480);
+    vram_gen_counter++;
+    Tex_Cache_DirtyRegion(page_px, 0, 128, 256);
+
+    tc_emit_textured_quad(1, page_tx, 0, 0, 480);
+    Flush_GIF();
+    gp_gif_reset_counter();
+
+    rewrite_rows(page_px + 64, 32, 8, 16);
+
+    tc_emit_textured_quad(1, page_tx, 0, 0, 480);
+    Flush_GIF();
+    uint32_t col_qws = gp_ctx.qwords_generated;
+
+    if (col_qws > 128 && col_qws < 256) {
+        printf("    %-16s: column=%u OK\n", gp_ctx.name, (unsigned)col_qws);
+    } else {
+        printf("  [FAIL] %-16s: column=%u NOT in (128, 256)\n",
+               gp_ctx.name, (unsigned)col_qws);
+        gp_ctx.fail_count++;
+    }
+
+    END_GPU_TEST();
+}
+
+/* ================================================================
+ *  TC12: 15BPP STP kernel — bit-exact vs scalar, MB/s
+ *
+ *  fast_stp_qw (MMI) must match the scalar fixup used by the
+ *  unaligned upload paths for every pixel class: 0, STP-only,
+ *  opaque colours and STP+colour.
+ * ================================================================ */
+#define STP_TEST_PIXELS 4096
+#define EE_CLOCK_MHZ 294.912f
+
+static void test_stp_kernel(void)
+{
+    static uint16_t src[STP_TEST_PIXELS] __attribute__((aligned(16)));
+    static uint16_t vec[STP_TEST_PIXELS] __attribute__((aligned(16)));
+    static uint16_t ref[STP_TEST_PIXELS] __attribute__((aligned(16)));
+    static const uint16_t fixed[4] = {0x0000, 0x8000, 0x7FFF, 0x0001};
+    uint32_t cycles, insns, seed = 12345;
+
+    BEGIN_GPU_TEST("tc12_stp_simd");
+
+    for (int i = 0; i < STP_TEST_PIXELS; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        src[i] = (i & 3) ? (uint16_t)(seed >> 16) : fixed[(i >> 2) & 3];
+    }
+
+    perf_start();
+    for (int i = 0; i < STP_TEST_PIXELS; i++)
+        ref[i] = src[i] | ((-(src[i] != 0)) & 0x8000);
+    perf_stop(&cycles, &insns);
+    uint32_t scalar_cycles = cycles;
+
+    perf_start();
+    fast_stp_qw(vec, src, STP_TEST_PIXELS / 8);
+    perf_stop(&cycles, &insns);
+
+    int mismatches = 0;
+    for (int i = 0; i < STP_TEST_PIXELS; i++)
+        if (vec[i] != ref[i])
+            mismatches++;
+
+    float bytes = STP_TEST_PIXELS * 2.0f;
+    if (mismatches == 0) {
+        printf("    %-16s: exact, %.0f MB/s (scalar %.0f MB/s)\n", gp_ctx.name,
+               cycles ? bytes * EE_CLOCK_MHZ / cycles : 0.0f,
+               scalar_cycles ? bytes * EE_CLOCK_MHZ / scalar_cycles : 0.0f);
+    } else {
+        printf("  [FAIL] %-16s: %d of %d pixels differ\n",
+               gp_ctx.name, mismatches, STP_TEST_PIXELS);
+        gp_ctx.fail_count++;
+    }
+
+    END_GPU_TEST();
+}
+
 /* ================================================================
  *  Runner
  * ================================================================ */
@@ -458,4 +606,7 @@ void gp_run_texcache_tests(void)
     test_multipage_no_thrash();      /* TC7 — 12 pages, no FIFO eviction */
     test_global_gen_fastpath();      /* TC8 — O(1) fast path */
     test_other_page_write();         /* TC9 — write to other page → HIT */
+    test_same_content_rewrite();     /* TC10 — identical rewrite → hash HIT */
+    test_partial_8bpp_column();      /* TC11 — one 8BPP block column only */
+    test_stp_kernel();               /* TC12 — 15BPP STP kernel exact + MB/s */
 }
@@ -30,6 +30,9 @@
 int sched_active[SCHED_EVENT_COUNT];
 uint64_t sched_deadline[SCHED_EVENT_COUNT];
 sched_callback_t sched_callback[SCHED_EVENT_COUNT];
+uint8_t sched_heap[SCHED_EVENT_COUNT];
+uint8_t sched_heap_pos[SCHED_EVENT_COUNT];
+int sched_heap_size = 0;
 uint64_t global_cycles = 0;
 uint32_t partial_block_cycles = 0;
 volatile uint32_t chain_cycles_acc = 0;
@@ -37,6 +40,7 @@ int sched_unlimited_speed = 0;
 uint64_t sched_cached_earliest = UINT64_MAX;
 int sched_earliest_id = -1;
 uint64_t hblank_frame_start_cycle = 0;
+volatile int sched_interrupt_chain = 0;
 
 /* ---- Stub: CPU state ---- */
 #include "superpsx.h"
@@ -44,7 +48,8 @@ uint64_t hblank_frame_start_cycle = 0;
 R3000CPU cpu;
 static uint8_t _psx_ram_buf[2 * 1024 * 1024];
 uint8_t *psx_ram = _psx_ram_buf;
-uint32_t psx_abort_pc = 0;
+volatile uint32_t psx_abort_pc = 0;
+volatile int psx_block_exception = 0;
 
 /* ---- Stub: SignalInterrupt tracking ---- */
 static int irq7_count = 0;
@@ -65,6 +70,21 @@ void Joystick_GetPSXDigitalResponse(int port, int slot, uint8_t response[3]) {
     response[0] = 0xFF; response[1] = 0xFF; response[2] = 0xFF;
 }
 
+/* ---- Stub: Platform (memory card write-back flushes synchronously) ---- */
+int Platform_ThreadStart(const char *name, void (*entry)(void *), void *arg,
+                         int stack_size)
+{ (void)name; (void)entry; (void)arg; (void)stack_size; return -1; }
+int Platform_SemaCreate(int init_count, int max_count)
+{ (void)init_count; (void)max_count; return -1; }
+void Platform_SemaWait(int sema) { (void)sema; }
+void Platform_SemaSignal(int sema) { (void)sema; }
+void Platform_Sleep(uint32_t ms) { (void)ms; }
+#include "savestate.h"
+void state_undo(StateIO *io, uint32_t pos, uint32_t n) { (void)io; (void)pos; (void)n; }
+#include "benchmark.h"
+int Bench_PadReplay(int port, uint8_t *resp, int *len) { (void)port; (void)resp; (void)len; return 0; }
+void Bench_PadRecord(int port, const uint8_t *resp, int len) { (void)port; (void)resp; (void)len; }
+
 /* ---- Stub: PSXConfig ---- */
 PSXConfig psx_config = {
     .mcd1_path = "/tmp/test_cc_mcd1.mcr",
@@ -73,6 +93,7 @@ PSXConfig psx_config = {
 
 /* ---- Include the actual implementations ---- */
 #include "../../src/memorycard.c"
+#undef LOG_TAG /* memorycard.c and sio.c each define their own */
 #include "../../src/sio.c"
 
 /* ---- Helper: advance global_cycles and dispatch scheduler ---- */
@@ -89,6 +110,8 @@ static void full_reset(void)
     memset(_psx_ram_buf, 0, sizeof(_psx_ram_buf));
     global_cycles = 1000000;
     partial_block_cycles = 0;
+    memset(sched_active, 0, sizeof(sched_active));
+    sched_heap_size = 0;
     sched_cached_earliest = UINT64_MAX;
     sched_earliest_id = -1;
     irq7_count = 0;
@@ -439,11 +462,11 @@ static void test_double_write_no_double_cap(void)
 }
 
 /* ================================================================== */
-/* TEST 10: Pad SIO write does NOT cap cycles_left                    */
+/* TEST 10: Pad SIO write caps cycles_left at SIO_IRQ_DELAY + 200    */
 /* ================================================================== */
-static void test_pad_no_cap(void)
+static void test_pad_cap(void)
 {
-    TEST_BEGIN("pad_no_cap");
+    TEST_BEGIN("pad_cap");
     int _saved_fails = tests_failed;
 
     full_reset();
@@ -454,16 +477,17 @@ static void test_pad_no_cap(void)
     cpu.initial_cycles_left = 5000;
     cpu.cycles_left_correction = 0;
 
+    /* Pad ACK: 500 + 200 = 700 left, the 4300 cut go to the correction */
     SIO_Write(0x1F801040, 0x01);    /* Pad device */
-    CHECK_EQ(cpu.cycles_left, 5000, "pad: cycles_left unchanged");
-    CHECK_EQ(cpu.cycles_left_correction, 0, "pad: no correction");
+    CHECK_EQ(cpu.cycles_left, 700, "pad: cycles_left capped");
+    CHECK_EQ(cpu.cycles_left_correction, 4300, "pad: correction");
 
-    /* Continue pad exchange */
+    /* Continue pad exchange: already at the target, no further cap */
     SIO_Write(0x1F801040, 0x42);    /* byte 2 */
-    CHECK_EQ(cpu.cycles_left, 5000, "pad byte2: cycles_left unchanged");
-    CHECK_EQ(cpu.cycles_left_correction, 0, "pad byte2: no correction");
+    CHECK_EQ(cpu.cycles_left, 700, "pad byte2: cycles_left unchanged");
+    CHECK_EQ(cpu.cycles_left_correction, 4300, "pad byte2: correction unchanged");
 
-    TEST_END("pad_no_cap");
+    TEST_END("pad_cap");
 }
 
 /* ================================================================== */
@@ -709,7 +733,7 @@ int main(void)
     test_correction_clamp_to_one();
     test_scheduler_fires_on_time();
     test_double_write_no_double_cap();
-    test_pad_no_cap();
+    test_pad_cap();
     test_end_to_end_sio_block();
     test_zero_cycles_taken_bumped();
     test_correction_resets_between_blocks();
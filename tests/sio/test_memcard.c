@@ -20,6 +20,17 @@
 #include "superpsx.h"
 PSXConfig psx_config;
 void SignalInterrupt(uint32_t irq) { (void)irq; }
+/* No worker thread: write-back flushes run synchronously */
+int Platform_ThreadStart(const char *name, void (*entry)(void *), void *arg,
+                         int stack_size)
+{ (void)name; (void)entry; (void)arg; (void)stack_size; return -1; }
+int Platform_SemaCreate(int init_count, int max_count)
+{ (void)init_count; (void)max_count; return -1; }
+void Platform_SemaWait(int sema) { (void)sema; }
+void Platform_SemaSignal(int sema) { (void)sema; }
+void Platform_Sleep(uint32_t ms) { (void)ms; }
+#include "savestate.h"
+void state_undo(StateIO *io, uint32_t pos, uint32_t n) { (void)io; (void)pos; (void)n; }
 
 /* Include the actual implementation */
 #include "../../src/memorycard.c"
@@ -468,6 +479,81 @@ static void test_write_read_roundtrip(void)
     PASS("test_write_read_roundtrip");
 }
 
+/* ---- Helper: write one sector, every byte = fill ---- */
+static uint8_t write_sector(int slot, uint16_t sector, uint8_t fill)
+{
+    tick(slot, 0x81);
+    tick(slot, 0x57);
+    tick(slot, 0x00);
+    tick(slot, 0x00);
+    tick(slot, (uint8_t)(sector >> 8));
+    tick(slot, (uint8_t)sector);
+    uint8_t checksum = (uint8_t)(sector >> 8) ^ (uint8_t)sector;
+    for (int i = 0; i < 128; i++) {
+        tick(slot, fill);
+        checksum ^= fill;
+    }
+    tick(slot, checksum);
+    tick(slot, 0x00);
+    tick(slot, 0x00);
+    return tick(slot, 0x00);
+}
+
+static uint8_t file_byte(const char *path, long off)
+{
+    uint8_t b = 0;
+    FILE *f = fopen(path, "rb");
+    if (f) {
+        fseek(f, off, SEEK_SET);
+        if (fread(&b, 1, 1, f) != 1)
+            b = 0;
+        fclose(f);
+    }
+    return b;
+}
+
+/* ============================================================ */
+/* TEST: Write-back — sectors reach the file after the idle delay */
+/* ============================================================ */
+static void test_writeback_deferred(void)
+{
+    const char *path = "test_memcard_wb.mcd";
+    remove(path);
+    memset(psx_config.mcd2_path, 0, sizeof(psx_config.mcd2_path));
+    strcpy(psx_config.mcd1_path, path);
+    psx_config.mcd_flush_frames = 3;
+    MCD_Init(); /* creates the formatted file */
+
+    ASSERT_EQ(write_sector(0, 100, 0x5A), 0x47, "writeback: end byte 100");
+    ASSERT_EQ(write_sector(0, 101, 0x6B), 0x47, "writeback: end byte 101");
+    ASSERT_EQ(file_byte(path, 100 * 128), 0x00, "writeback: not written yet");
+
+    MCD_Frame();
+    MCD_Frame();
+    ASSERT_EQ(file_byte(path, 101 * 128), 0x00, "writeback: still idle-waiting");
+    MCD_Frame();
+    ASSERT_EQ(file_byte(path, 100 * 128), 0x5A, "writeback: sector 100 flushed");
+    ASSERT_EQ(file_byte(path, 101 * 128 + 127), 0x6B, "writeback: sector 101 flushed");
+
+    /* Exit flush does not wait for the idle delay */
+    ASSERT_EQ(write_sector(0, 7, 0x11), 0x47, "writeback: end byte 7");
+    MCD_Flush();
+    ASSERT_EQ(file_byte(path, 7 * 128), 0x11, "writeback: flushed on exit");
+
+    /* File deleted behind our back: recreated whole */
+    remove(path);
+    ASSERT_EQ(write_sector(0, 8, 0x22), 0x47, "writeback: end byte 8");
+    MCD_Flush();
+    ASSERT_EQ(file_byte(path, 0), 'M', "writeback: recreated header");
+    ASSERT_EQ(file_byte(path, 100 * 128), 0x5A, "writeback: recreated data");
+    ASSERT_EQ(file_byte(path, 8 * 128), 0x22, "writeback: recreated new sector");
+
+    remove(path);
+    psx_config.mcd_flush_frames = 0;
+    memset(psx_config.mcd1_path, 0, sizeof(psx_config.mcd1_path));
+    PASS("test_writeback_deferred");
+}
+
 /* ============================================================ */
 /* TEST: Invalid command returns 0xFF and goes idle */
 /* ============================================================ */
@@ -612,6 +698,7 @@ int main(void)
     test_slot1_independent();
     test_read_out_of_range();
     test_formatted_header();
+    test_writeback_deferred();
 
     printf("\n=== Results: %d passed, %d failed ===\n",
            tests_passed, tests_failed);
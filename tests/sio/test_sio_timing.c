@@ -30,6 +30,9 @@
 int sched_active[SCHED_EVENT_COUNT];
 uint64_t sched_deadline[SCHED_EVENT_COUNT];
 sched_callback_t sched_callback[SCHED_EVENT_COUNT];
+uint8_t sched_heap[SCHED_EVENT_COUNT];
+uint8_t sched_heap_pos[SCHED_EVENT_COUNT];
+int sched_heap_size = 0;
 uint64_t global_cycles = 0;
 uint32_t partial_block_cycles = 0;
 volatile uint32_t chain_cycles_acc = 0;
@@ -37,6 +40,7 @@ int sched_unlimited_speed = 0;
 uint64_t sched_cached_earliest = UINT64_MAX;
 int sched_earliest_id = -1;
 uint64_t hblank_frame_start_cycle = 0;
+volatile int sched_interrupt_chain = 0;
 
 /* ---- Stub: CPU state ---- */
 /* superpsx.h defines `cpu` as R3000CPU and psx_ram as uint8_t* */
@@ -45,7 +49,8 @@ uint64_t hblank_frame_start_cycle = 0;
 R3000CPU cpu;
 static uint8_t _psx_ram_buf[2 * 1024 * 1024];
 uint8_t *psx_ram = _psx_ram_buf;
-uint32_t psx_abort_pc = 0;
+volatile uint32_t psx_abort_pc = 0;
+volatile int psx_block_exception = 0;
 
 /* ---- Stub: SignalInterrupt tracking ---- */
 static int irq7_fired = 0;
@@ -68,6 +73,21 @@ void Joystick_GetPSXDigitalResponse(int port, int slot, uint8_t response[3]) {
     response[0] = 0xFF; response[1] = 0xFF; response[2] = 0xFF;
 }
 
+/* ---- Stub: Platform (memory card write-back flushes synchronously) ---- */
+int Platform_ThreadStart(const char *name, void (*entry)(void *), void *arg,
+                         int stack_size)
+{ (void)name; (void)entry; (void)arg; (void)stack_size; return -1; }
+int Platform_SemaCreate(int init_count, int max_count)
+{ (void)init_count; (void)max_count; return -1; }
+void Platform_SemaWait(int sema) { (void)sema; }
+void Platform_SemaSignal(int sema) { (void)sema; }
+void Platform_Sleep(uint32_t ms) { (void)ms; }
+#include "savestate.h"
+void state_undo(StateIO *io, uint32_t pos, uint32_t n) { (void)io; (void)pos; (void)n; }
+#include "benchmark.h"
+int Bench_PadReplay(int port, uint8_t *resp, int *len) { (void)port; (void)resp; (void)len; return 0; }
+void Bench_PadRecord(int port, const uint8_t *resp, int len) { (void)port; (void)resp; (void)len; }
+
 /* ---- Stub: PSXConfig ---- */
 PSXConfig psx_config = {
     .mcd1_path = "/tmp/test_sio_mcd1.mcr",
@@ -76,6 +96,7 @@ PSXConfig psx_config = {
 
 /* ---- Include the actual implementations ---- */
 #include "../../src/memorycard.c"
+#undef LOG_TAG /* memorycard.c and sio.c each define their own */
 #include "../../src/sio.c"
 
 /* ---- Helper: advance global_cycles and dispatch scheduler ---- */
@@ -190,6 +211,7 @@ static void full_reset(void)
     /* Reset scheduler */
     for (int i = 0; i < SCHED_EVENT_COUNT; i++)
         sched_active[i] = 0;
+    sched_heap_size = 0;
     sched_cached_earliest = UINT64_MAX;
     sched_earliest_id = -1;
     global_cycles = 1000000; /* Start at some nonzero cycle */
@@ -7,6 +7,7 @@ and produces command histograms, state change analysis, and batching metrics.
 
 Binary format:
   Header:  magic("GPTD") | version(u32) | frame_count(u32) | max_words(u32)
+  v2 only: prelude_count(u32) | prelude[prelude_count] | VRAM (1024x512 u16)
   Per frame: frame_id(u32) | word_count(u32) | gp0_data[word_count]
 
 Usage:
@@ -131,11 +132,15 @@ def parse_trace(path):
     if magic != 0x44545047:
         print(f"ERROR: bad magic 0x{magic:08X} (expected GPTD/0x44545047)")
         sys.exit(1)
-    if version != 1:
+    if version not in (1, 2):
         print(f"WARNING: unknown version {version}")
 
     frames = []
     offset = 16
+    if version >= 2:
+        # Capture-start environment and VRAM snapshot (used by replay only)
+        (prelude_count,) = struct.unpack_from("<I", data, offset)
+        offset += 4 + prelude_count * 4 + 1024 * 512 * 2
     for i in range(frame_count):
         frame_id, word_count = struct.unpack_from("<II", data, offset)
         offset += 8
@@ -7,9 +7,12 @@ Reads binary dump produced by ENABLE_JIT_DUMP and generates:
   2. Per-block expansion ratios and instruction category breakdown
   3. Call graph edges (JAL/J targets) with weighted execution counts
   4. Summary statistics
+  5. Per-site memory region profile (--memprof, from ENABLE_MEM_PROFILE)
+  6. Inline cache hit rates per JR/JALR site (jit_inline_caches)
 
 Usage:
     python3 tools/jit_analyze.py build/jitdump.bin [--top N] [--graph out.dot] [--callees 0x80XXXXXX]
+                                 [--memprof build/memprof.bin]
 """
 
 import struct
@@ -230,6 +233,67 @@ def parse_dump(path):
     return blocks
 
 
+IC_WAYS = 4  # JIT_IC_WAYS
+
+
+def parse_ic_sites(path):
+    """Return the inline cache sites of the JICS trailer ([] if absent)."""
+    with open(path, "rb") as f:
+        f.read(4)
+        (block_count,) = struct.unpack("<I", f.read(4))
+        for _ in range(block_count):
+            hdr = f.read(20)
+            if len(hdr) < 20:
+                return []
+            _, instr_count, native_count, _, _ = struct.unpack("<5I", hdr)
+            f.seek((instr_count + native_count) * 4, 1)
+
+        tag = f.read(4)
+        if tag == b"JSMP":
+            f.seek(20 + block_count * 4, 1)
+            tag = f.read(4)
+        if tag != b"JICS":
+            return []
+
+        (site_count,) = struct.unpack("<I", f.read(4))
+        sites = []
+        rec_size = (4 + 2 * IC_WAYS + 1) * 4
+        for _ in range(site_count):
+            rec = f.read(rec_size)
+            if len(rec) < rec_size:
+                break
+            w = struct.unpack(f"<{4 + 2 * IC_WAYS + 1}I", rec)
+            sites.append({
+                "pc": w[0], "ways": w[1], "used": w[2] & 0xFF, "mega": bool(w[2] >> 8),
+                "execs": w[3], "targets": list(w[4:4 + IC_WAYS]),
+                "hits": list(w[4 + IC_WAYS:4 + 2 * IC_WAYS]), "misses": w[-1],
+            })
+    return sites
+
+
+MEMSITE_CLASSES = ["RAM", "Scratch", "BIOS", "IO"]
+
+
+def parse_memprof(path):
+    """Parse memprof.bin and return list of site dicts."""
+    with open(path, "rb") as f:
+        magic = f.read(4)
+        if magic != b"JITM":
+            print(f"Error: bad magic {magic!r}, expected b'JITM'", file=sys.stderr)
+            sys.exit(1)
+        (site_count,) = struct.unpack("<I", f.read(4))
+
+        sites = []
+        for _ in range(site_count):
+            rec = f.read(20)
+            if len(rec) < 20:
+                break
+            pc, ram, scratch, bios, io = struct.unpack("<5I", rec)
+            sites.append({"pc": pc, "hits": [ram, scratch, bios, io]})
+
+    return sites
+
+
 # --- Analysis functions ---
 
 def extract_edges(block):
@@ -480,6 +544,64 @@ def print_callee_analysis(blocks, target_pc):
 
 # --- Main ---
 
+def print_memprof(sites, blocks, top_n=30):
+    """Print the hottest load/store sites and the region(s) they touched."""
+    # PSX opcode per PC, taken from the block dump
+    opcodes = {}
+    for b in blocks:
+        for i, w in enumerate(b["psx_code"]):
+            opcodes[b["pc"] + i * 4] = w
+
+    for s in sites:
+        s["total"] = sum(s["hits"])
+        used = [c for c, n in zip(MEMSITE_CLASSES, s["hits"]) if n]
+        s["verdict"] = used[0] if len(used) == 1 else "mixed"
+
+    ranked = sorted(sites, key=lambda s: s["total"], reverse=True)
+    total = sum(s["total"] for s in sites)
+
+    print(f"\n{'='*80}")
+    print(f" MEMORY SITES — Top {top_n} by accesses ({len(sites)} sites, {total:,} accesses)")
+    print(f"{'='*80}")
+    print(f" {'PC':>10} {'Total':>10} {'RAM':>10} {'Scratch':>9} {'BIOS':>8} {'IO':>9}  {'Class':<7} Insn")
+    for s in ranked[:top_n]:
+        ram, scratch, bios, io = s["hits"]
+        insn = disasm_psx(opcodes[s["pc"]], s["pc"]) if s["pc"] in opcodes else "?"
+        print(f" 0x{s['pc']:08X} {s['total']:>10,} {ram:>10,} {scratch:>9,} {bios:>8,} {io:>9,}  {s['verdict']:<7} {insn}")
+
+    by_class = defaultdict(int)
+    for s in sites:
+        by_class[s["verdict"]] += 1
+    print("\n Sites by class: " + ", ".join(f"{c}: {n}" for c, n in sorted(by_class.items())))
+    print(" (IO-only sites with enough hits are compiled as direct helper calls)")
+    print()
+
+
+def print_ic_sites(sites, top_n=30):
+    """Print the busiest inline cache sites with hits per entry."""
+    for s in sites:
+        s["hit_total"] = sum(s["hits"][:s["used"]])
+    ranked = sorted(sites, key=lambda s: s["execs"], reverse=True)
+    execs = sum(s["execs"] for s in sites)
+    hits = sum(s["hit_total"] for s in sites)
+
+    print(f"\n{'='*80}")
+    print(f" INLINE CACHES — Top {top_n} by runs ({len(sites)} sites, "
+          f"{hits * 100.0 / max(execs, 1):.1f}% of {execs:,} runs hit)")
+    print(f"{'='*80}")
+    print(f" {'Site':>10} {'Runs':>10} {'Hit%':>6} {'Misses':>7} {'Ways':>5}  Entries (target: hits)")
+    for s in ranked[:top_n]:
+        rate = s["hit_total"] * 100.0 / max(s["execs"], 1)
+        ways = f"{s['used']}/{s['ways']}" + ("M" if s["mega"] else "")
+        entries = "  ".join(f"0x{t:08X}:{n:,}" for t, n in zip(s["targets"][:s["used"]], s["hits"]))
+        print(f" 0x{s['pc']:08X} {s['execs']:>10,} {rate:>5.1f}% {s['misses']:>7,} {ways:>5}  {entries}")
+
+    mega = sum(1 for s in sites if s["mega"])
+    mono = sum(1 for s in sites if s["used"] == 1 and not s["mega"])
+    print(f"\n Monomorphic: {mono}, megamorphic (M, demoted to the hash dispatch): {mega}")
+    print()
+
+
 def main():
     parser = argparse.ArgumentParser(description="Analyze SuperPSX JIT block dumps")
     parser.add_argument("dumpfile", help="Path to jitdump.bin")
@@ -488,6 +610,7 @@ def main():
     parser.add_argument("--detail", type=str, help="Show detailed disassembly for block at given hex PC")
     parser.add_argument("--callees", type=str, help="Show callers of given hex PC")
     parser.add_argument("--histogram", action="store_true", help="Show expansion ratio histogram")
+    parser.add_argument("--memprof", type=str, help="Memory site profile (memprof.bin) to report")
     args = parser.parse_args()
 
     blocks = parse_dump(args.dumpfile)
@@ -518,6 +641,13 @@ def main():
     if args.graph:
         write_call_graph(blocks, args.graph)
 
+    if args.memprof:
+        print_memprof(parse_memprof(args.memprof), blocks, args.top)
+
+    ic_sites = parse_ic_sites(args.dumpfile)
+    if ic_sites:
+        print_ic_sites(ic_sites, args.top)
+
     # Summary
     total_blocks = len(blocks)
     executed = [b for b in blocks if b["exec_count"] > 0]
@@ -16,6 +16,8 @@ from collections import defaultdict
 # --- Re-use dump parser from jit_analyze.py ---
 
 def parse_dump(path):
+    """Returns (blocks, sample_totals).  sample_totals is None unless the
+    dump carries the PC sampler's JSMP trailer (jit_sample_hz)."""
     with open(path, "rb") as f:
         magic = f.read(4)
         assert magic == b"JITD", f"Bad magic: {magic!r}"
@@ -32,9 +34,17 @@ def parse_dump(path):
                 "pc": psx_pc, "instr_count": instr_count,
                 "native_count": native_count, "cycle_count": cycle_count,
                 "exec_count": exec_count, "psx_code": psx_code,
-                "native_code": native_code,
+                "native_code": native_code, "samples": 0,
             })
-    return blocks
+        totals = None
+        if f.read(4) == b"JSMP":
+            total, host, tramp, lost, dropped = struct.unpack("<5I", f.read(20))
+            totals = {"total": total, "host": host, "tramp": tramp,
+                      "lost": lost, "dropped": dropped}
+            counts = f.read(len(blocks) * 4)
+            for b, (n,) in zip(blocks, struct.iter_unpack("<I", counts)):
+                b["samples"] = n
+    return blocks, totals
 
 
 REG_NAMES = [
@@ -703,6 +713,39 @@ def analyze_native_overhead(blocks):
     return weighted, total_pp
 
 
+# ===================================================================
+#  ANALYSIS 0: Sampled Flat Profile (host PC samples per block)
+# ===================================================================
+
+def analyze_sampled_profile(blocks, totals):
+    """Time actually spent in each block's native code, from the PC
+    sampler, next to what exec_count x native_count would predict.
+    Unlike the chain hotspot table, time inside a linked chain lands on
+    the block executing, not on the one that entered the chain."""
+    print("\n" + "=" * 70)
+    print(" ANALYSIS 0: SAMPLED FLAT PROFILE")
+    print("=" * 70)
+
+    total = totals["total"]
+    in_blocks = sum(b["samples"] for b in blocks)
+    print(f"\n Samples: {total:,}  (dropped: {totals['dropped']:,})")
+    for name, n in (("JIT blocks", in_blocks), ("Host C code", totals["host"]),
+                    ("Trampolines", totals["tramp"]), ("Unresolved", totals["lost"])):
+        print(f"   {name:<12} {n:>10,}  {n * 100.0 / max(total, 1):5.1f}%")
+
+    impact_total = sum(b["exec_count"] * b["native_count"] for b in blocks)
+    hot = sorted((b for b in blocks if b["samples"]), key=lambda b: -b["samples"])[:30]
+    print(f"\n {'PSX PC':>10} {'Samples':>8} {'%JIT':>6} {'Cum%':>6} {'Est%':>6} {'Exec':>10} {'Words':>6}")
+    cum = 0
+    for b in hot:
+        cum += b["samples"]
+        est = b["exec_count"] * b["native_count"] * 100.0 / max(impact_total, 1)
+        print(f" 0x{b['pc']:08X} {b['samples']:>8,} {b['samples'] * 100.0 / max(in_blocks, 1):5.1f}%"
+              f" {cum * 100.0 / max(in_blocks, 1):5.1f}% {est:5.1f}% {b['exec_count']:>10,} {b['native_count']:>6}")
+    print("\n Est% = share of exec_count x native_count; a block far above it")
+    print(" stalls (cache misses, slow-path memory calls) more than its size says.")
+
+
 # ===================================================================
 #  ANALYSIS 8: Optimization Recommendations (corrected)
 # ===================================================================
@@ -854,13 +897,15 @@ def main():
         print(f"Usage: {sys.argv[0]} <jitdump.bin>")
         sys.exit(1)
 
-    blocks = parse_dump(sys.argv[1])
+    blocks, sample_totals = parse_dump(sys.argv[1])
     print(f"Loaded {len(blocks)} blocks")
 
     for b in blocks:
         b["ee_impact"] = b["exec_count"] * b["native_count"]
         b["ratio"] = b["native_count"] / max(b["instr_count"], 1)
 
+    if sample_totals and sample_totals["total"]:
+        analyze_sampled_profile(blocks, sample_totals)
     analyze_prologue_overhead(blocks)
     detect_block_patterns(blocks)
     analyze_superblock_candidates(blocks)
@@ -0,0 +1,261 @@
+/*
+ * mdec_kernel_check.c — host bit-exactness check of the MDEC kernels
+ *
+ * Runs the SSE2 kernels and the MMI kernels (through a small interpreter
+ * of the MMI asm templates) against the scalar reference on random
+ * blocks shaped like rl2blk output.
+ *
+ *   cc -O2 -fwrapv -DMDEC_KERNEL_CHECK -Iinclude \
+ *      tools/mdec_kernel_check.c src/mdec_kernels.c -o mdec_kernel_check
+ *   ./mdec_kernel_check [iterations]
+ */
+#include "mdec_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* ---------- MMI interpreter ---------- */
+
+typedef union {
+    uint32_t w[4];
+    uint16_t h[8];
+    uint64_t d[2];
+} Reg128;
+
+static Reg128 R[32];
+
+static void die(const char *what, const char *line) {
+    fprintf(stderr, "mmi_exec: %s: %s\n", what, line);
+    exit(2);
+}
+
+static int parse_reg(const char *s, const char *line) {
+    while (isspace((unsigned char)*s)) s++;
+    if (*s != '$') die("expected register", line);
+    return atoi(s + 1);
+}
+
+/* "off(%N)" with off a sum of decimal terms */
+static uint8_t *parse_mem(const char *s, const void *const *ops, const char *line) {
+    long off = 0;
+    while (isspace((unsigned char)*s)) s++;
+    while (*s && *s != '(') {
+        off += strtol(s, (char **)&s, 10);
+        if (*s == '+') s++;
+    }
+    if (s[0] != '(' || s[1] != '%') die("bad memory operand", line);
+    uint8_t *p = (uint8_t *)ops[s[2] - '0'] + off;
+    if ((uintptr_t)p & 15) die("unaligned quadword access", line);
+    return p;
+}
+
+static void set(int rd, const Reg128 *v, const char *line) {
+    if (!((rd >= 8 && rd <= 21) || rd == 24 || rd == 0))
+        die("register outside the clobber list", line);
+    if (rd)
+        R[rd] = *v;
+}
+
+void mmi_exec(const char *tmpl, const void *p0, const void *p1,
+              const void *p2, const void *p3) {
+    const void *ops[4] = { p0, p1, p2, p3 };
+    char line[128];
+
+    memset(&R[0], 0, sizeof(R[0]));
+    while (*tmpl) {
+        size_t n = strcspn(tmpl, "\n");
+        if (n >= sizeof(line)) die("line too long", tmpl);
+        memcpy(line, tmpl, n);
+        line[n] = 0;
+        tmpl += n + (tmpl[n] == '\n');
+
+        char op[16], *a = line;
+        while (isspace((unsigned char)*a)) a++;
+        if (!*a) continue;
+        if (sscanf(a, "%15s", op) != 1) continue;
+        a += strlen(op);
+
+        char *arg[3] = { a, NULL, NULL };
+        for (int i = 1; i < 3; i++) {
+            char *c = strchr(arg[i - 1], ',');
+            if (!c) break;
+            *c = 0;
+            arg[i] = c + 1;
+        }
+
+        Reg128 v, s, t;
+        if (!strcmp(op, "lq") || !strcmp(op, "sq")) {
+            int rt = parse_reg(arg[0], line);
+            uint8_t *p = parse_mem(arg[1], ops, line);
+            if (op[0] == 'l') {
+                memcpy(&v, p, 16);
+                set(rt, &v, line);
+            } else {
+                memcpy(p, &R[rt], 16);
+            }
+            continue;
+        }
+        int rd = parse_reg(arg[0], line);
+        if (!strcmp(op, "psllw") || !strcmp(op, "psraw")) {
+            t = R[parse_reg(arg[1], line)];
+            int sa = atoi(arg[2]);
+            for (int i = 0; i < 4; i++)
+                v.w[i] = op[3] == 'l' ? t.w[i] << sa : (uint32_t)((int32_t)t.w[i] >> sa);
+            set(rd, &v, line);
+            continue;
+        }
+        if (!strcmp(op, "pexcw")) {
+            t = R[parse_reg(arg[1], line)];
+            v.w[0] = t.w[0]; v.w[1] = t.w[2]; v.w[2] = t.w[1]; v.w[3] = t.w[3];
+            set(rd, &v, line);
+            continue;
+        }
+        s = R[parse_reg(arg[1], line)];
+        t = R[parse_reg(arg[2], line)];
+        if (!strcmp(op, "paddw") || !strcmp(op, "psubw") || !strcmp(op, "por")) {
+            for (int i = 0; i < 4; i++)
+                v.w[i] = op[1] == 'o' ? (s.w[i] | t.w[i])
+                       : op[1] == 'a' ? s.w[i] + t.w[i] : s.w[i] - t.w[i];
+        } else if (!strcmp(op, "pmaxw") || !strcmp(op, "pminw")) {
+            for (int i = 0; i < 4; i++) {
+                int32_t x = (int32_t)s.w[i], y = (int32_t)t.w[i];
+                v.w[i] = (uint32_t)(op[2] == 'a' ? (x > y ? x : y) : (x < y ? x : y));
+            }
+        } else if (!strcmp(op, "pmultw")) {
+            for (int i = 0; i < 2; i++) {
+                int64_t prod = (int64_t)(int32_t)s.w[i * 2] * (int32_t)t.w[i * 2];
+                v.d[i] = (uint64_t)prod;
+            }
+        } else if (!strcmp(op, "pextlw")) {
+            v.w[0] = t.w[0]; v.w[1] = s.w[0]; v.w[2] = t.w[1]; v.w[3] = s.w[1];
+        } else if (!strcmp(op, "pextuw")) {
+            v.w[0] = t.w[2]; v.w[1] = s.w[2]; v.w[2] = t.w[3]; v.w[3] = s.w[3];
+        } else if (!strcmp(op, "ppacw")) {
+            v.w[0] = t.w[0]; v.w[1] = t.w[2]; v.w[2] = s.w[0]; v.w[3] = s.w[2];
+        } else if (!strcmp(op, "ppach")) {
+            for (int i = 0; i < 4; i++) {
+                v.h[i] = t.h[i * 2];
+                v.h[i + 4] = s.h[i * 2];
+            }
+        } else if (!strcmp(op, "pcpyld")) {
+            v.d[0] = t.d[0]; v.d[1] = s.d[0];
+        } else if (!strcmp(op, "pcpyud")) {
+            v.d[0] = s.d[1]; v.d[1] = t.d[1];
+        } else {
+            die("unknown instruction", line);
+        }
+        set(rd, &v, line);
+    }
+}
+
+/* ---------- Test data ---------- */
+
+static const int zscan[64] = {
+    0,  1,  8, 16,  9,  2,  3, 10,
+   17, 24, 32, 25, 18, 11,  4,  5,
+   12, 19, 26, 33, 40, 48, 41, 34,
+   27, 20, 13,  6,  7, 14, 21, 28,
+   35, 42, 49, 56, 57, 50, 43, 36,
+   29, 22, 15, 23, 30, 37, 44, 51,
+   58, 59, 52, 45, 38, 31, 39, 46,
+   53, 60, 61, 54, 47, 55, 62, 63
+};
+
+static uint32_t rng = 0x12345678;
+static uint32_t rnd32(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* Mostly dequantised-coefficient magnitudes, sometimes extreme */
+static int rnd_coef(void) {
+    int bits = (rnd32() % 64 == 0) ? 30 : 12 + (int)(rnd32() % 12);
+    return (int)(rnd32() & ((1u << bits) - 1)) - (1 << (bits - 1));
+}
+
+/* A block as rl2blk leaves it before the IDCT; returns used_col */
+static int make_block(int *blk) {
+    int used_col = 0, k = 0;
+    int density = 1 + (int)(rnd32() % 24);
+
+    memset(blk, 0, 64 * sizeof(int));
+    blk[0] = (rnd32() & 3) ? rnd_coef() : 0;
+    while (k < 63) {
+        k += 1 + (int)(rnd32() % density);
+        if (k >= 64)
+            break;
+        blk[zscan[k]] = rnd_coef();
+        used_col |= (zscan[k] > 7) ? 1 << (zscan[k] & 7) : 0;
+    }
+    if (rnd32() % 8 == 0) { /* no AC terms: rl2blk passes -1 */
+        memset(blk + 1, 0, 63 * sizeof(int));
+        return -1;
+    }
+    return used_col;
+}
+
+static int check_idct(const MdecKernels *k, int iters) {
+    int ref[64] __attribute__((aligned(16)));
+    int out[64] __attribute__((aligned(16)));
+    for (int n = 0; n < iters; n++) {
+        int used_col = make_block(ref);
+        memcpy(out, ref, sizeof(ref));
+        mdec_kernels_c.idct(ref, used_col);
+        k->idct(out, used_col);
+        if (memcmp(ref, out, sizeof(ref))) {
+            printf("%s idct mismatch (iteration %d, used_col %d)\n", k->name, n, used_col);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_rgb(const MdecKernels *k, int iters) {
+    int blk[384] __attribute__((aligned(16)));
+    uint16_t ref15[256 + 8] __attribute__((aligned(16)));
+    uint16_t out15[256 + 8] __attribute__((aligned(16)));
+    uint8_t ref24[768], out24[768];
+
+    for (int n = 0; n < iters; n++) {
+        int range = (rnd32() % 16 == 0) ? 30 : 17 + (int)(rnd32() % 3);
+        for (int i = 0; i < 384; i++)
+            blk[i] = (int)(rnd32() & ((1u << range) - 1)) - (1 << (range - 1));
+        uint16_t stp = (n & 1) ? 0x8000 : 0;
+        int skew = (n & 2) ? 2 : 0; /* unaligned destination */
+
+        mdec_kernels_c.yuv2rgb15(blk, ref15 + skew, stp);
+        k->yuv2rgb15(blk, out15 + skew, stp);
+        if (memcmp(ref15 + skew, out15 + skew, 512)) {
+            printf("%s yuv2rgb15 mismatch (iteration %d)\n", k->name, n);
+            return 1;
+        }
+        mdec_kernels_c.yuv2rgb24(blk, ref24);
+        k->yuv2rgb24(blk, out24);
+        if (memcmp(ref24, out24, sizeof(ref24))) {
+            printf("%s yuv2rgb24 mismatch (iteration %d)\n", k->name, n);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int iters = argc > 1 ? atoi(argv[1]) : 100000;
+    const MdecKernels *tables[] = {
+        &mdec_kernels_mmi,
+#ifdef __SSE2__
+        &mdec_kernels_sse2,
+#endif
+    };
+    int fail = 0;
+
+    for (size_t i = 0; i < sizeof(tables) / sizeof(tables[0]); i++) {
+        int f = check_idct(tables[i], iters) | check_rgb(tables[i], iters / 10);
+        printf("%-5s %s\n", tables[i]->name, f ? "FAIL" : "ok");
+        fail |= f;
+    }
+    return fail;
+}